@@ -41,13 +41,15 @@
  */
 
 #include "Application.h"
+#include "AsyncLogger.h"
 #include "BuildConfig.h"
 
 #include "DataMigrationTask.h"
+#include "minecraft/mod/InstanceModIndex.h"
 #include "net/PasteUpload.h"
-#include "pathmatcher/MultiMatcher.h"
-#include "pathmatcher/SimplePrefixMatcher.h"
+#include "pathmatcher/PathRuleMatcher.h"
 #include "settings/INIFile.h"
+#include "tasks/TaskTrace.h"
 #include "ui/MainWindow.h"
 #include "ui/InstanceWindow.h"
 
@@ -63,6 +65,8 @@
 #include "ui/pages/global/ExternalToolsPage.h"
 #include "ui/pages/global/AccountListPage.h"
 #include "ui/pages/global/APIPage.h"
+#include "ui/pages/global/NetworkDiagnosticsPage.h"
+#include "ui/pages/global/MemoryPage.h"
 #include "ui/pages/global/CustomCommandsPage.h"
 
 #include "ui/setupwizard/SetupWizard.h"
@@ -80,7 +84,6 @@
 #include "ApplicationMessage.h"
 
 #include <iostream>
-#include <mutex>
 
 #include <QFileOpenEvent>
 #include <QAccessible>
@@ -96,18 +99,32 @@
 #include <QStyleFactory>
 #include <QWindow>
 #include <QIcon>
+#include <QTimer>
+#include <QStatusBar>
 
+#include "DiskUsage.h"
+#include "launch/BatchLaunch.h"
 #include "InstanceList.h"
 #include "MTPixmapCache.h"
+#include "ImageCache.h"
+#include "MemoryAccounting.h"
+#include "StringPool.h"
 
 #include <minecraft/auth/AccountList.h>
 #include "icons/IconList.h"
 #include "net/HttpMetaCache.h"
+#include "net/HostPool.h"
 
 #include "java/JavaUtils.h"
+#include "java/JavaProbeCache.h"
+#include "SystemProbe.h"
+#include "StartupPhases.h"
+#include "HeadlessRunner.h"
 
 #include "updater/ExternalUpdater.h"
 
+#include "tools/AsyncProfiler.h"
+#include "tools/FlightRecorder.h"
 #include "tools/JProfiler.h"
 #include "tools/JVisualVM.h"
 #include "tools/MCEditTool.h"
@@ -117,6 +134,14 @@
 
 #include "translations/TranslationsModel.h"
 #include "meta/Index.h"
+#include "minecraft/VersionPrefetcher.h"
+#include "minecraft/launch/SpareJavaPool.h"
+#include "minecraft/CacheCleanupTask.h"
+#include "minecraft/PrefetchScheduler.h"
+#include "net/ConnectionWarmer.h"
+#include "net/MirrorList.h"
+#include "net/PeerCache.h"
+#include "net/Diagnostics.h"
 
 #include <FileSystem.h>
 #include <DesktopServices.h>
@@ -155,16 +180,14 @@ namespace {
 /** This is used so that we can output to the log file in addition to the CLI. */
 void appDebugOutput(QtMsgType type, const QMessageLogContext &context, const QString &msg)
 {
-    static std::mutex loggerMutex;
-    const std::lock_guard<std::mutex> lock(loggerMutex); // synchronized, QFile logFile is not thread-safe
+    auto logger = APPLICATION->logger.get();
+    // the process is aborted right after this returns, so everything has to be out by then
+    if (type == QtFatalMsg)
+        logger->stop();
 
     QString out = qFormatLogMessage(type, context, msg);
     out += QChar::LineFeed;
-
-    APPLICATION->logFile->write(out.toUtf8());
-    APPLICATION->logFile->flush();
-    QTextStream(stderr) << out.toLocal8Bit();
-    fflush(stderr);
+    logger->log(type, context.category, out);
 }
 
 }
@@ -212,24 +235,44 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
 
     parser.addOptions({
         {{"d", "dir"}, "Use a custom path as application root (use '.' for current directory)", "directory"},
-        {{"l", "launch"}, "Launch the specified instance (by instance ID)", "instance"},
+        {{"l", "launch"}, "Launch the specified instance (by instance ID, can be repeated to launch several one after the other)", "instance"},
         {{"s", "server"}, "Join the specified server on launch (only valid in combination with --launch)", "address"},
         {{"a", "profile"}, "Use the account specified by its profile name (only valid in combination with --launch)", "profile"},
         {"alive", "Write a small '" + liveCheckFile + "' file after the launcher starts"},
         {{"I", "import"}, "Import instance from specified zip (local path or URL)", "file"},
-        {"show", "Opens the window for the specified instance (by instance ID)", "show"}
+        {"show", "Opens the window for the specified instance (by instance ID)", "show"},
+        {"update", "Download everything the specified instances need to launch, getting the files they share only once (by instance ID, can be repeated)", "instance"},
+        {"headless", "Do what the other options ask for without any windows, print the progress and exit once done"},
+        {"create", "Create a Minecraft instance, given as <name>:<Minecraft version> (can be repeated, only valid in combination with --headless)", "instance"},
+        {"verify", "Check that the specified instances load and have all their files, without downloading anything (by instance ID, can be repeated, only valid in combination with --headless)", "instance"},
+        {"verify-files", "Hash the files of the specified instances, download the missing or damaged ones again and print a report (by instance ID, can be repeated, only valid in combination with --headless)", "instance"},
+        {"find-mod", "Print the instances that have a mod, by its ID, name, file name, project ID or file hash (can be repeated, only valid in combination with --headless)", "mod"},
+        {"export-bundle", "Put the instances given with --update, and all they need to launch, in a bundle for machines without network (only valid in combination with --headless)", "file"},
+        {"import-bundle", "Import the instances of a bundle and all they need to launch, before anything else (can be repeated, only valid in combination with --headless)", "file"}
     });
     parser.addHelpOption();
     parser.addVersionOption();
 
     parser.process(arguments());
 
-    m_instanceIdToLaunch = parser.value("launch");
+    m_instanceIdsToLaunch = parser.values("launch");
     m_serverToJoin = parser.value("server");
     m_profileToUse = parser.value("profile");
     m_liveCheck = parser.isSet("alive");
 
     m_instanceIdToShowWindowOf = parser.value("show");
+    m_instanceIdsToUpdate = parser.values("update");
+    m_headless = parser.isSet("headless");
+    m_instancesToCreate = parser.values("create");
+    m_instanceIdsToVerify = parser.values("verify");
+    m_instanceIdsToVerifyFiles = parser.values("verify-files");
+    m_modsToFind = parser.values("find-mod");
+    for (auto bundle : parser.values("import-bundle")) {
+        m_bundlesToImport.append(QFileInfo(bundle).absoluteFilePath());
+    }
+    if (parser.isSet("export-bundle")) {
+        m_bundleToExport = QFileInfo(parser.value("export-bundle")).absoluteFilePath();
+    }
 
     for (auto zip_path : parser.values("import")){
         m_zipsToImport.append(QUrl::fromLocalFile(QFileInfo(zip_path).absoluteFilePath()));
@@ -242,13 +285,33 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
 
 
     // error if --launch is missing with --server or --profile
-    if((!m_serverToJoin.isEmpty() || !m_profileToUse.isEmpty()) && m_instanceIdToLaunch.isEmpty())
+    if((!m_serverToJoin.isEmpty() || !m_profileToUse.isEmpty()) && m_instanceIdsToLaunch.isEmpty())
     {
         std::cerr << "--server and --profile can only be used in combination with --launch!" << std::endl;
         m_status = Application::Failed;
         return;
     }
 
+    // error if --create, the verifications, the bundles or the mod queries are given without --headless, or --show with it
+    if(!m_headless && (!m_instancesToCreate.isEmpty() || !m_instanceIdsToVerify.isEmpty() || !m_instanceIdsToVerifyFiles.isEmpty() || !m_bundlesToImport.isEmpty() || !m_bundleToExport.isEmpty() || !m_modsToFind.isEmpty()))
+    {
+        std::cerr << "--create, --verify, --verify-files, --import-bundle, --export-bundle and --find-mod can only be used in combination with --headless!" << std::endl;
+        m_status = Application::Failed;
+        return;
+    }
+    if(m_headless && !m_instanceIdToShowWindowOf.isEmpty())
+    {
+        std::cerr << "--show can't be used in combination with --headless!" << std::endl;
+        m_status = Application::Failed;
+        return;
+    }
+    if(m_headless && m_instanceIdsToLaunch.size() > 1)
+    {
+        std::cerr << "Only one instance can be launched with --headless!" << std::endl;
+        m_status = Application::Failed;
+        return;
+    }
+
     QString origcwdPath = QDir::currentPath();
     QString binPath = applicationDirPath();
 
@@ -335,9 +398,17 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         m_peerInstance = new LocalPeer(this, appID);
         connect(m_peerInstance, &LocalPeer::messageReceived, this, &Application::messageReceived);
         if(m_peerInstance->isClient()) {
+            // the running copy would do it with its GUI, and two copies can't work on the same data
+            if(m_headless)
+            {
+                std::cerr << "Another copy of the launcher is already using this data directory, it can't run headless now." << std::endl;
+                m_status = Application::Failed;
+                return;
+            }
+
             int timeout = 2000;
 
-            if(m_instanceIdToLaunch.isEmpty())
+            if(m_instanceIdsToLaunch.isEmpty())
             {
                 ApplicationMessage activate;
                 activate.command = "activate";
@@ -352,12 +423,21 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
                         m_peerInstance->sendMessage(import.serialize(), timeout);
                     }
                 }
+
+                if(!m_instanceIdsToUpdate.isEmpty())
+                {
+                    ApplicationMessage update;
+                    update.command = "update";
+                    update.args.insert("ids", m_instanceIdsToUpdate.join('\n'));
+                    m_peerInstance->sendMessage(update.serialize(), timeout);
+                }
             }
             else
             {
                 ApplicationMessage launch;
                 launch.command = "launch";
-                launch.args["id"] = m_instanceIdToLaunch;
+                // several are launched together, see BatchLaunch
+                launch.args["id"] = m_instanceIdsToLaunch.join('\n');
 
                 if(!m_serverToJoin.isEmpty())
                 {
@@ -389,7 +469,7 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         moveFile(logBase.arg(1), logBase.arg(2));
         moveFile(logBase.arg(0), logBase.arg(1));
 
-        logFile = std::unique_ptr<QFile>(new QFile(logBase.arg(0)));
+        auto logFile = std::unique_ptr<QFile>(new QFile(logBase.arg(0)));
         if(!logFile->open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
         {
             showFatalErrorMessage(
@@ -405,6 +485,7 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
             );
             return;
         }
+        logger.reset(new AsyncLogger(std::move(logFile)));
         qInstallMessageHandler(appDebugOutput);
 
         qSetMessagePattern(
@@ -453,6 +534,20 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
             }
             auto rules_str = rules.join("\n");
             QLoggingCategory::setFilterRules(rules_str);
+            loggingRules.endGroup();
+
+            // how many messages a second a category may log, like "launcher.task.net=200"
+            loggingRules.beginGroup("RateLimits");
+            QHash<QByteArray, int> limits;
+            for (auto category : loggingRules.childKeys()) {
+                auto limit = loggingRules.value(category).toInt();
+                if (limit > 0) {
+                    limits.insert(category.toUtf8(), limit);
+                    qDebug() << "Limiting" << category << "to" << limit << "messages a second";
+                }
+            }
+            loggingRules.endGroup();
+            logger->setRateLimits(limits);
         }
 
         qDebug() << "<> Log initialized.";
@@ -485,9 +580,9 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         }
         qDebug() << "Binary path                : " << binPath;
         qDebug() << "Application root path      : " << m_rootPath;
-        if(!m_instanceIdToLaunch.isEmpty())
+        if(!m_instanceIdsToLaunch.isEmpty())
         {
-            qDebug() << "ID of instance to launch   : " << m_instanceIdToLaunch;
+            qDebug() << "ID of instance to launch   : " << m_instanceIdsToLaunch.join(", ");
         }
         if(!m_serverToJoin.isEmpty())
         {
@@ -517,7 +612,9 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
     // Initialize application settings
     {
         // Provide a fallback for migration from PolyMC
-        m_settings.reset(new INISettingsObject({ BuildConfig.LAUNCHER_CONFIGFILE, "polymc.cfg", "multimc.cfg" }, this));
+        auto settings = new INISettingsObject({ BuildConfig.LAUNCHER_CONFIGFILE, "polymc.cfg", "multimc.cfg" }, this);
+        settings->setSaveDelay(500);
+        m_settings.reset(settings);
 
         // Theming
         m_settings->registerSetting("IconTheme", QString("pe_colored"));
@@ -587,10 +684,29 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         m_settings->registerSetting({"ProxyUser", "ProxyUsername"}, "");
         m_settings->registerSetting({"ProxyPass", "ProxyPassword"}, "");
 
+        // Download engine
+        m_settings->registerSetting("NumberOfConcurrentDownloads", 6);
+        m_settings->registerSetting("UseHttp2", true);
+        // KiB/s, 0 for no limit
+        m_settings->registerSetting("DownloadBandwidthLimit", 0);
+        // Connect to the hosts we need before anything asks for them, the most recently used first
+        m_settings->registerSetting("ConnectionWarmup", true);
+        m_settings->registerSetting("RecentHosts", "");
+        // Base URLs the libraries and assets are also found under, see Net::MirrorList
+        m_settings->registerSetting("LibraryMirrors", "");
+        m_settings->registerSetting("AssetMirrors", "");
+        m_settings->registerSetting("SharedObjectStore", false);
+        // Get what is in the store of other launchers on the LAN, and let them get ours, see Net::PeerCache
+        m_settings->registerSetting("LanPeerCache", false);
+        // Download the libraries of versions picked when creating instances before the instances get created
+        m_settings->registerSetting("PrefetchVersions", true);
+
         // Memory
         m_settings->registerSetting({"MinMemAlloc", "MinMemoryAlloc"}, 512);
         m_settings->registerSetting({"MaxMemAlloc", "MaxMemoryAlloc"}, suitableMaxMem());
         m_settings->registerSetting("PermGen", 128);
+        // size the heap from the system memory, the mods and what the game used, instead of the allocations above
+        m_settings->registerSetting("AutoMemory", false);
 
         // Java Settings
         m_settings->registerSetting("JavaPath", "");
@@ -601,7 +717,11 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         m_settings->registerSetting("JavaVendor", "");
         m_settings->registerSetting("LastHostname", "");
         m_settings->registerSetting("JvmArgs", "");
+        // the id of a tuning profile from JvmProfiles, none when empty
+        m_settings->registerSetting("JvmProfile", "");
         m_settings->registerSetting("IgnoreJavaCompatibility", false);
+        // see VerifyJavaInstall
+        m_settings->registerSetting("AutomaticJavaSelection", true);
         m_settings->registerSetting("IgnoreJavaWizard", false);
 
         // Native library workarounds
@@ -612,6 +732,20 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         m_settings->registerSetting("EnableFeralGamemode", false);
         m_settings->registerSetting("EnableMangoHud", false);
         m_settings->registerSetting("UseDiscreteGpu", false);
+        // on hybrid graphics, see SystemProbe::discreteGpu
+        m_settings->registerSetting("AutoDiscreteGpu", true);
+        m_settings->registerSetting("ShaderCachePerInstance", false);
+        // in MiB, for each driver
+        m_settings->registerSetting("ShaderCacheSize", 1024);
+
+        // Keep the hardware info printed in the launch logs until the next reboot
+        m_settings->registerSetting("SystemInfoCache", true);
+
+        // Save a trace of the tasks of every launch and install to cache/traces
+        m_settings->registerSetting("RecordTaskTraces", false);
+
+        // zlib level of exported instances and packs, 1 is the fastest and 9 the smallest
+        m_settings->registerSetting("ExportCompressionLevel", 6);
 
         // Game time
         m_settings->registerSetting("ShowGameTime", true);
@@ -690,8 +824,32 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         // meta URL
         m_settings->registerSetting("MetaURLOverride", "");
 
+        // Screenshots uploaded to Imgur: the largest side in pixels (0 to keep their size) and "png" or "jpg". See ImgurUpload
+        m_settings->registerSetting("ScreenshotUploadMaxSize", 0);
+        m_settings->registerSetting("ScreenshotUploadFormat", "png");
+
+        // Cache size limits, in MiB, 0 for none. See CacheCleanupTask
+        m_settings->registerSetting("LibrariesCacheBudget", 16384);
+        m_settings->registerSetting("AssetsCacheBudget", 16384);
+        m_settings->registerSetting("DownloadsCacheBudget", 4096);
+        // the metadata is JSON that's read back whole, it's stored compressed. See HttpMetaCache::setCompressed
+        m_settings->registerSetting("CompressMetadataCache", true);
+        m_settings->registerSetting("AutoCacheCleanup", true);
+        m_settings->registerSetting("LastCacheCleanup", QDateTime());
+        // see PrefetchScheduler, the window is in local time
+        m_settings->registerSetting("PrefetchUpdates", false);
+        m_settings->registerSetting("PrefetchWindowStart", "02:00");
+        m_settings->registerSetting("PrefetchWindowEnd", "06:00");
+        m_settings->registerSetting("PrefetchOnMetered", false);
+        m_settings->registerSetting("LastPrefetch", QDateTime());
+
         m_settings->registerSetting("CloseAfterLaunch", false);
         m_settings->registerSetting("QuitAfterGameStop", false);
+        // in seconds, see BatchLaunch
+        m_settings->registerSetting("BatchLaunchDelay", 20);
+        m_settings->registerSetting("BatchLaunchWaitForWindow", true);
+        // the sounds are downloaded while the game runs, see AssetUpdateTask
+        m_settings->registerSetting("FastFirstLaunch", false);
 
         // Custom Microsoft Authentication Client ID
         m_settings->registerSetting("MSAClientIDOverride", "");
@@ -722,10 +880,37 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
             m_globalSettingsProvider->addPage<ExternalToolsPage>();
             m_globalSettingsProvider->addPage<AccountListPage>();
             m_globalSettingsProvider->addPage<APIPage>();
+            m_globalSettingsProvider->addPage<NetworkDiagnosticsPage>();
+            m_globalSettingsProvider->addPage<MemoryPage>();
         }
 
         PixmapCache::setInstance(new PixmapCache(this));
 
+        // Qt doesn't say what QPixmapCache holds, only that it can be emptied
+        MemoryAccounting::track(
+            "Pixmap cache", [] { return MemoryAccounting::Usage(); }, [] { PixmapCache::clear(); });
+        MemoryAccounting::track(
+            "Image cache",
+            [] {
+                auto& cache = ImageCache::instance();
+                return MemoryAccounting::Usage{ cache.count(), cache.size() };
+            },
+            [] { ImageCache::instance().clear(); });
+        MemoryAccounting::track(
+            "Interned strings",
+            [] {
+                auto& pool = StringPool::instance();
+                return MemoryAccounting::Usage{ pool.count(), pool.size() };
+            },
+            [] { StringPool::instance().prune(); });
+
+        auto traceSetting = m_settings->getSetting("RecordTaskTraces");
+        TaskTrace::setRecording(traceSetting->get().toBool());
+        connect(traceSetting.get(), &Setting::SettingChanged, [](const Setting &, QVariant value)
+        {
+            TaskTrace::setRecording(value.toBool());
+        });
+
         qDebug() << "<> Settings loaded.";
     }
 
@@ -733,8 +918,13 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
     QAccessible::installFactory(groupViewAccessibleFactory);
 #endif /* !QT_NO_ACCESSIBILITY */
 
+    // read what needs no GUI thread and nothing else from the startup from disk in the background
+    StartupPhases startup;
+    auto accountsFile = startup.start("Reading accounts", [] { return AccountList::readListFile("accounts.json"); });
+    auto translationFiles = startup.start("Scanning translations", [] { return TranslationsModel::scanLocalFiles("translations"); });
+
     // initialize network access and proxy setup
-    {
+    startup.run("Network", [this] {
         m_network.reset(new QNetworkAccessManager());
         QString proxyTypeStr = settings()->get("ProxyType").toString();
         QString addr = settings()->get("ProxyAddr").toString();
@@ -742,17 +932,63 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         QString user = settings()->get("ProxyUser").toString();
         QString pass = settings()->get("ProxyPass").toString();
         updateProxySettings(proxyTypeStr, addr, port, user, pass);
+
+        m_hostPool.reset(new Net::HostPool());
+        m_hostPool->setMaxPerHost(settings()->get("NumberOfConcurrentDownloads").toInt());
+        m_hostPool->setHttp2Allowed(settings()->get("UseHttp2").toBool());
+        m_hostPool->setBandwidthLimit(settings()->get("DownloadBandwidthLimit").toLongLong() * 1024);
+        m_mirrors = std::make_shared<Net::MirrorList>();
+        m_mirrors->loadSettings(*settings());
+        m_netDiagnostics.reset(new Net::Diagnostics());
         qDebug() << "<> Network done.";
+    });
+
+    // init the http meta cache, nothing uses it before the startup is joined below
+    {
+        m_metacache.reset(new HttpMetaCache("metacache"));
+        m_metacache->addBase("asset_indexes", QDir("assets/indexes").absolutePath());
+        m_metacache->addBase("asset_objects", QDir("assets/objects").absolutePath());
+        m_metacache->addBase("versions", QDir("versions").absolutePath());
+        m_metacache->addBase("libraries", QDir("libraries").absolutePath());
+        m_metacache->addBase("minecraftforge", QDir("mods/minecraftforge").absolutePath());
+        m_metacache->addBase("fmllibs", QDir("mods/minecraftforge/libs").absolutePath());
+        m_metacache->addBase("liteloader", QDir("mods/liteloader").absolutePath());
+        m_metacache->addBase("general", QDir("cache").absolutePath());
+        m_metacache->addBase("ATLauncherPacks", QDir("cache/ATLauncherPacks").absolutePath());
+        m_metacache->addBase("FTBPacks", QDir("cache/FTBPacks").absolutePath());
+        m_metacache->addBase("ModpacksCHPacks", QDir("cache/ModpacksCHPacks").absolutePath());
+        m_metacache->addBase("TechnicPacks", QDir("cache/TechnicPacks").absolutePath());
+        m_metacache->addBase("FlamePacks", QDir("cache/FlamePacks").absolutePath());
+        m_metacache->addBase("FlameMods", QDir("cache/FlameMods").absolutePath());
+        m_metacache->addBase("ModrinthPacks", QDir("cache/ModrinthPacks").absolutePath());
+        m_metacache->addBase("ModrinthModpacks", QDir("cache/ModrinthModpacks").absolutePath());
+        m_metacache->addBase("ModrinthUpdates", QDir("cache/ModrinthUpdates").absolutePath());
+        m_metacache->addBase("ResourceProjects", QDir("cache/ResourceProjects").absolutePath());
+        m_metacache->addBase("root", QDir::currentPath());
+        m_metacache->addBase("translations", QDir("translations").absolutePath());
+        m_metacache->addBase("icons", QDir("cache/icons").absolutePath());
+        m_metacache->addBase("meta", QDir("meta").absolutePath());
+
+        // the metadata, icons and translations are small and always needed, they get no budget
+        auto mib = [this](const QString& setting) { return m_settings->get(setting).toLongLong() * 1024 * 1024; };
+        m_metacache->setBudget("libraries", mib("LibrariesCacheBudget"));
+        m_metacache->setBudget("asset_objects", mib("AssetsCacheBudget"));
+        for (auto base : { "general", "ATLauncherPacks", "FTBPacks", "ModpacksCHPacks", "TechnicPacks", "FlamePacks", "FlameMods",
+                           "ModrinthPacks", "ModrinthModpacks", "ModrinthUpdates" })
+            m_metacache->setBudget(base, mib("DownloadsCacheBudget"));
+        m_metacache->setCompressed("meta", m_settings->get("CompressMetadataCache").toBool());
+        HttpMetaCache* metacache = m_metacache.get();
+        startup.start("Loading the cache", [metacache] { metacache->Load(); });
     }
 
     // load translations
-    {
-        m_translations.reset(new TranslationsModel("translations"));
+    startup.run("Translations", [this, &translationFiles] {
+        m_translations.reset(new TranslationsModel("translations", translationFiles.result()));
         auto bcp47Name = m_settings->get("Language").toString();
         m_translations->selectLanguage(bcp47Name);
         qDebug() << "Your language is" << bcp47Name;
         qDebug() << "<> Translations loaded.";
-    }
+    });
 
     // initialize the updater
     if(BuildConfig.UPDATER_ENABLED)
@@ -765,7 +1001,7 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
     }
 
     // Instance icons
-    {
+    startup.run("Instance icons", [this] {
         auto setting = APPLICATION->settings()->getSetting("IconsDir");
         QStringList instFolders =
         {
@@ -780,13 +1016,13 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
             m_icons->directoryChanged(value.toString());
         });
         qDebug() << "<> Instance icons intialized.";
-    }
+    });
 
     // Themes
-    m_themeManager = std::make_unique<ThemeManager>(m_mainWindow);
+    startup.run("Themes", [this] { m_themeManager = std::make_unique<ThemeManager>(m_mainWindow); });
 
     // initialize and load all instances
-    {
+    startup.run("Instances", [this] {
         auto InstDirSetting = m_settings->getSetting("InstanceDir");
         // instance path: check for problems with '!' in instance path and warn the user in the log
         // and remember that we have to show him a dialog when the gui starts (if it does so)
@@ -798,47 +1034,36 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         }
         m_instances.reset(new InstanceList(m_settings, instDir, this));
         connect(InstDirSetting.get(), &Setting::SettingChanged, m_instances.get(), &InstanceList::on_InstFolderChanged);
+        connect(m_icons.get(), &IconList::iconUpdated, m_instances.get(), &InstanceList::iconUpdated);
         qDebug() << "Loading Instances...";
         m_instances->loadList();
         qDebug() << "<> Instances loaded.";
-    }
+    });
 
     // and accounts
-    {
+    startup.run("Accounts", [this, &accountsFile] {
         m_accounts.reset(new AccountList(this));
         qDebug() << "Loading accounts...";
         m_accounts->setListFilePath("accounts.json", true);
-        m_accounts->loadList();
+        m_accounts->loadList(accountsFile.result());
         m_accounts->fillQueue();
         qDebug() << "<> Accounts loaded.";
-    }
+    });
 
-    // init the http meta cache
-    {
-        m_metacache.reset(new HttpMetaCache("metacache"));
-        m_metacache->addBase("asset_indexes", QDir("assets/indexes").absolutePath());
-        m_metacache->addBase("asset_objects", QDir("assets/objects").absolutePath());
-        m_metacache->addBase("versions", QDir("versions").absolutePath());
-        m_metacache->addBase("libraries", QDir("libraries").absolutePath());
-        m_metacache->addBase("minecraftforge", QDir("mods/minecraftforge").absolutePath());
-        m_metacache->addBase("fmllibs", QDir("mods/minecraftforge/libs").absolutePath());
-        m_metacache->addBase("liteloader", QDir("mods/liteloader").absolutePath());
-        m_metacache->addBase("general", QDir("cache").absolutePath());
-        m_metacache->addBase("ATLauncherPacks", QDir("cache/ATLauncherPacks").absolutePath());
-        m_metacache->addBase("FTBPacks", QDir("cache/FTBPacks").absolutePath());
-        m_metacache->addBase("ModpacksCHPacks", QDir("cache/ModpacksCHPacks").absolutePath());
-        m_metacache->addBase("TechnicPacks", QDir("cache/TechnicPacks").absolutePath());
-        m_metacache->addBase("FlamePacks", QDir("cache/FlamePacks").absolutePath());
-        m_metacache->addBase("FlameMods", QDir("cache/FlameMods").absolutePath());
-        m_metacache->addBase("ModrinthPacks", QDir("cache/ModrinthPacks").absolutePath());
-        m_metacache->addBase("ModrinthModpacks", QDir("cache/ModrinthModpacks").absolutePath());
-        m_metacache->addBase("root", QDir::currentPath());
-        m_metacache->addBase("translations", QDir("translations").absolutePath());
-        m_metacache->addBase("icons", QDir("cache/icons").absolutePath());
-        m_metacache->addBase("meta", QDir("meta").absolutePath());
-        m_metacache->Load();
-        qDebug() << "<> Cache initialized.";
-    }
+    startup.join();
+    qDebug() << "<> Cache initialized.";
+
+    // the hardware info for the launch logs takes a while to get, start on it now
+    systemProbe()->gather();
+
+    // the first requests of the session shouldn't have to wait for their connections
+    m_connectionWarmer.reset(new Net::ConnectionWarmer(m_network, m_settings));
+    connect(m_hostPool.get(), &Net::HostPool::hostRequested, m_connectionWarmer.get(), &Net::ConnectionWarmer::hostUsed);
+    m_connectionWarmer->warmUp();
+
+    // the sockets of the LAN cache belong to this thread
+    m_peerCache.reset(new Net::PeerCache());
+    m_peerCache->setEnabled(m_settings->get("LanPeerCache").toBool());
 
     // now we have network, download translation updates
     m_translations->downloadIndex();
@@ -846,6 +1071,8 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
     //FIXME: what to do with these?
     m_profilers.insert("jprofiler", std::shared_ptr<BaseProfilerFactory>(new JProfilerFactory()));
     m_profilers.insert("jvisualvm", std::shared_ptr<BaseProfilerFactory>(new JVisualVMFactory()));
+    m_profilers.insert("jfr", std::shared_ptr<BaseProfilerFactory>(new FlightRecorderFactory()));
+    m_profilers.insert("asyncprofiler", std::shared_ptr<BaseProfilerFactory>(new AsyncProfilerFactory()));
     for (auto profiler : m_profilers.values())
     {
         profiler->registerSettings(m_settings);
@@ -868,17 +1095,24 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
             // save any remaining instance state
             m_instances->saveNow();
         }
-        if(logFile)
-        {
-            logFile->flush();
-            logFile->close();
-        }
     });
 
-    applyCurrentlySelectedTheme(true);
+    // nothing is shown in headless mode, the themes would only be loaded for nothing
+    if(!m_headless)
+    {
+        applyCurrentlySelectedTheme(true);
+    }
 
     updateCapabilities();
 
+    startup.report();
+
+    if(m_headless)
+    {
+        runHeadless();
+        return;
+    }
+
     if(createSetupWizard())
     {
         return;
@@ -980,34 +1214,52 @@ void Application::setupWizardFinished(int status)
 void Application::performMainStartupAction()
 {
     m_status = Application::Initialized;
-    if(!m_instanceIdToLaunch.isEmpty())
+    QList<InstancePtr> toLaunch;
+    for(auto &id : m_instanceIdsToLaunch)
     {
-        auto inst = instances()->getInstanceById(m_instanceIdToLaunch);
+        auto inst = instances()->getInstanceById(id);
         if(inst)
         {
-            MinecraftServerTargetPtr serverToJoin = nullptr;
-            MinecraftAccountPtr accountToUse = nullptr;
+            toLaunch.append(inst);
+        }
+        else
+        {
+            qWarning() << "Can't launch instance" << id << "as it doesn't exist.";
+        }
+    }
+    if(!toLaunch.isEmpty())
+    {
+        MinecraftServerTargetPtr serverToJoin = nullptr;
+        MinecraftAccountPtr accountToUse = nullptr;
 
-            qDebug() << "<> Instance" << m_instanceIdToLaunch << "launching";
-            if(!m_serverToJoin.isEmpty())
-            {
-                // FIXME: validate the server string
-                serverToJoin.reset(new MinecraftServerTarget(MinecraftServerTarget::parse(m_serverToJoin)));
-                qDebug() << "   Launching with server" << m_serverToJoin;
-            }
+        qDebug() << "<> Instances" << m_instanceIdsToLaunch << "launching";
+        if(!m_serverToJoin.isEmpty())
+        {
+            // FIXME: validate the server string
+            serverToJoin.reset(new MinecraftServerTarget(MinecraftServerTarget::parse(m_serverToJoin)));
+            qDebug() << "   Launching with server" << m_serverToJoin;
+        }
 
-            if(!m_profileToUse.isEmpty())
-            {
-                accountToUse = accounts()->getAccountByProfileName(m_profileToUse);
-                if(!accountToUse) {
-                    return;
-                }
-                qDebug() << "   Launching with account" << m_profileToUse;
+        if(!m_profileToUse.isEmpty())
+        {
+            accountToUse = accounts()->getAccountByProfileName(m_profileToUse);
+            if(!accountToUse) {
+                return;
             }
+            qDebug() << "   Launching with account" << m_profileToUse;
+        }
 
-            launch(inst, true, false, nullptr, serverToJoin, accountToUse);
-            return;
+        if(toLaunch.size() > 1)
+        {
+            // what the batch is at shows in the status bar
+            showMainWindow();
+            launchBatch(toLaunch, true, serverToJoin, accountToUse);
         }
+        else
+        {
+            launch(toLaunch.first(), true, false, nullptr, serverToJoin, accountToUse);
+        }
+        return;
     }
     if(!m_instanceIdToShowWindowOf.isEmpty())
     {
@@ -1030,19 +1282,113 @@ void Application::performMainStartupAction()
         qDebug() << "<> Importing from zip:" << m_zipsToImport;
         m_mainWindow->processURLs( m_zipsToImport );
     }
+    if(!m_instanceIdsToUpdate.isEmpty())
+    {
+        qDebug() << "<> Updating instances:" << m_instanceIdsToUpdate;
+        updateInstances(m_instanceIdsToUpdate);
+    }
+    scheduleCacheCleanup();
+    m_prefetchScheduler.reset(new PrefetchScheduler(m_instances, m_settings));
+    m_prefetchScheduler->reschedule();
+    // what changed in the instances since the last session is measured again, out of the way of the startup
+    QTimer::singleShot(30 * 1000, this, [this] { diskUsage(); });
+}
+
+void Application::scheduleCacheCleanup()
+{
+    if (!m_settings->get("AutoCacheCleanup").toBool())
+        return;
+    auto last = m_settings->get("LastCacheCleanup").toDateTime();
+    if (last.isValid() && last.secsTo(QDateTime::currentDateTime()) < 24 * 60 * 60)
+        return;
+
+    // out of the way of the startup, and of whatever the user does first
+    QTimer::singleShot(5 * 60 * 1000, this, [this] {
+        QList<InstancePtr> instances;
+        for (int i = 0; i < m_instances->count(); i++)
+            instances.append(m_instances->at(i));
+
+        m_cacheCleanup.reset(new CacheCleanupTask(instances, false));
+        connect(m_cacheCleanup.get(), &Task::succeeded, this, [this] {
+            qDebug() << "Cache cleanup done:" << m_cacheCleanup->report();
+            m_settings->set("LastCacheCleanup", QDateTime::currentDateTime());
+        });
+        connect(m_cacheCleanup.get(), &Task::failed, this, [](QString reason) { qWarning() << "Cache cleanup failed:" << reason; });
+        connect(m_cacheCleanup.get(), &Task::finished, this, [this] { m_cacheCleanup.reset(); });
+        m_cacheCleanup->start();
+    });
+}
+
+void Application::updateInstances(const QStringList &ids)
+{
+    QList<InstancePtr> toUpdate;
+    for(auto &id : ids)
+    {
+        auto inst = instances()->getInstanceById(id);
+        if(!inst)
+        {
+            qWarning() << "Can't update instance" << id << "as it doesn't exist.";
+            continue;
+        }
+        toUpdate.append(inst);
+    }
+    if(!toUpdate.isEmpty())
+    {
+        showMainWindow();
+        m_mainWindow->updateInstances(toUpdate);
+    }
+}
+
+void Application::runHeadless()
+{
+    m_status = Application::Initialized;
+
+    HeadlessRunner::Actions actions;
+    actions.toCreate = m_instancesToCreate;
+    actions.toImport = m_zipsToImport;
+    actions.toUpdate = m_instanceIdsToUpdate;
+    actions.toVerify = m_instanceIdsToVerify;
+    actions.toVerifyFiles = m_instanceIdsToVerifyFiles;
+    actions.modsToFind = m_modsToFind;
+    actions.bundlesToImport = m_bundlesToImport;
+    actions.bundleToExport = m_bundleToExport;
+    actions.toLaunch = m_instanceIdsToLaunch.value(0);
+    actions.serverToJoin = m_serverToJoin;
+    actions.profileToUse = m_profileToUse;
+
+    auto runner = new HeadlessRunner(actions, this);
+    connect(runner, &HeadlessRunner::finished, this, [this](int exitCode)
+    {
+        qDebug() << "<> Headless run finished with exit code" << exitCode;
+        exit(exitCode);
+    });
+    // once the event loop runs, the tasks need it
+    QMetaObject::invokeMethod(runner, [runner] { runner->start(); }, Qt::QueuedConnection);
 }
 
 void Application::showFatalErrorMessage(const QString& title, const QString& content)
 {
     m_status = Application::Failed;
+    if(m_headless)
+    {
+        std::cerr << title.toLocal8Bit().constData() << std::endl << content.toLocal8Bit().constData() << std::endl;
+        return;
+    }
     auto dialog = CustomMessageBox::selectable(nullptr, title, content, QMessageBox::Critical);
     dialog->exec();
 }
 
 Application::~Application()
 {
+    if (m_metadataIndex)
+    {
+        m_metadataIndex->saveSnapshot();
+    }
+
     // Shut down logger by setting the logger function to nothing
     qInstallMessageHandler(nullptr);
+    if (logger)
+        logger->stop();
 
 #if defined Q_OS_WIN32
     // Detach from Windows console
@@ -1085,19 +1431,20 @@ void Application::messageReceived(const QByteArray& message)
     }
     else if(command == "launch")
     {
-        QString id = received.args["id"];
         QString server = received.args["server"];
         QString profile = received.args["profile"];
 
-        InstancePtr instance;
-        if(!id.isEmpty()) {
-            instance = instances()->getInstanceById(id);
+        // several are launched together
+        QList<InstancePtr> toLaunch;
+        for(auto id : received.args["id"].split('\n', Qt::SkipEmptyParts)) {
+            auto instance = instances()->getInstanceById(id);
             if(!instance) {
                 qWarning() << "Launch command requires an valid instance ID. " << id << "resolves to nothing.";
                 return;
             }
+            toLaunch.append(instance);
         }
-        else {
+        if(toLaunch.isEmpty()) {
             qWarning() << "Launch command called without an instance ID...";
             return;
         }
@@ -1116,8 +1463,13 @@ void Application::messageReceived(const QByteArray& message)
             }
         }
 
+        if(toLaunch.size() > 1)
+        {
+            launchBatch(toLaunch, true, serverObject, accountObject);
+            return;
+        }
         launch(
-            instance,
+            toLaunch.first(),
             true,
             false,
             nullptr,
@@ -1125,6 +1477,16 @@ void Application::messageReceived(const QByteArray& message)
             accountObject
         );
     }
+    else if(command == "update")
+    {
+        QString ids = received.args["ids"];
+        if(ids.isEmpty())
+        {
+            qWarning() << "Received" << command << "message without instance IDs.";
+            return;
+        }
+        updateInstances(ids.split('\n'));
+    }
     else
     {
         qWarning() << "Received invalid message" << message;
@@ -1145,6 +1507,24 @@ std::shared_ptr<JavaInstallList> Application::javalist()
     return m_javalist;
 }
 
+std::shared_ptr<JavaProbeCache> Application::javaProbeCache()
+{
+    if (!m_javaProbeCache)
+    {
+        m_javaProbeCache = std::make_shared<JavaProbeCache>(QDir("cache").absoluteFilePath("java_probes.json"));
+    }
+    return m_javaProbeCache;
+}
+
+std::shared_ptr<SystemProbe> Application::systemProbe()
+{
+    if (!m_systemProbe)
+    {
+        m_systemProbe = std::make_shared<SystemProbe>(QDir("cache").absoluteFilePath("system_info.json"));
+    }
+    return m_systemProbe;
+}
+
 QList<ITheme*> Application::getValidApplicationThemes()
 {
     return m_themeManager->getValidApplicationThemes();
@@ -1248,6 +1628,41 @@ bool Application::launch(
     return false;
 }
 
+void Application::launchBatch(
+        const QList<InstancePtr> &instances,
+        bool online,
+        MinecraftServerTargetPtr serverToJoin,
+        MinecraftAccountPtr accountToUse
+) {
+    if(m_batchLaunch)
+    {
+        qDebug() << "Cannot launch instances together while other ones are being launched. Please try again once they are started.";
+        return;
+    }
+    auto starter = [this, online, serverToJoin, accountToUse](InstancePtr instance) {
+        return launch(instance, online, false, nullptr, serverToJoin, accountToUse);
+    };
+    m_batchLaunch.reset(new BatchLaunch(instances, starter));
+    m_batchLaunch->setOnline(online);
+    m_batchLaunch->setDelay(m_settings->get("BatchLaunchDelay").toInt() * 1000);
+    m_batchLaunch->setWaitForWindow(m_settings->get("BatchLaunchWaitForWindow").toBool());
+    connect(m_batchLaunch.get(), &Task::status, this, [this](QString status) {
+        if(m_mainWindow)
+        {
+            m_mainWindow->statusBar()->showMessage(status);
+        }
+    });
+    connect(m_batchLaunch.get(), &Task::failed, this, [](QString reason) { qWarning() << "Launching instances together failed:" << reason; });
+    connect(m_batchLaunch.get(), &Task::finished, this, [this] {
+        if(m_mainWindow)
+        {
+            m_mainWindow->statusBar()->clearMessage();
+        }
+        m_batchLaunch.reset();
+    });
+    m_batchLaunch->start();
+}
+
 bool Application::kill(InstancePtr instance)
 {
     if (!instance->isRunning())
@@ -1529,15 +1944,74 @@ shared_qobject_ptr<QNetworkAccessManager> Application::network()
     return m_network;
 }
 
+shared_qobject_ptr<Net::HostPool> Application::hostPool()
+{
+    return m_hostPool;
+}
+
+std::shared_ptr<Net::MirrorList> Application::mirrors()
+{
+    return m_mirrors;
+}
+
+shared_qobject_ptr<Net::PeerCache> Application::peerCache()
+{
+    return m_peerCache;
+}
+
+shared_qobject_ptr<Net::Diagnostics> Application::netDiagnostics()
+{
+    return m_netDiagnostics;
+}
+
 shared_qobject_ptr<Meta::Index> Application::metadataIndex()
 {
     if (!m_metadataIndex)
     {
         m_metadataIndex.reset(new Meta::Index());
+        m_metadataIndex->loadSnapshot();
     }
     return m_metadataIndex;
 }
 
+shared_qobject_ptr<VersionPrefetcher> Application::versionPrefetcher()
+{
+    if (!m_versionPrefetcher)
+    {
+        m_versionPrefetcher.reset(new VersionPrefetcher());
+    }
+    return m_versionPrefetcher;
+}
+
+shared_qobject_ptr<SpareJavaPool> Application::spareJavas()
+{
+    if (!m_spareJavas)
+    {
+        m_spareJavas.reset(new SpareJavaPool());
+    }
+    return m_spareJavas;
+}
+
+shared_qobject_ptr<InstanceModIndex> Application::instanceModIndex()
+{
+    if (!m_instanceModIndex)
+    {
+        m_instanceModIndex.reset(new InstanceModIndex(m_instances));
+    }
+    return m_instanceModIndex;
+}
+
+shared_qobject_ptr<DiskUsage> Application::diskUsage()
+{
+    if (!m_diskUsage)
+    {
+        m_diskUsage.reset(new DiskUsage(m_instances, QDir("cache").absoluteFilePath("diskusage")));
+        m_instances->setDiskUsage(m_diskUsage.get());
+        m_diskUsage->start();
+    }
+    return m_diskUsage;
+}
+
 void Application::updateCapabilities()
 {
     m_capabilities = None;
@@ -1695,21 +2169,44 @@ bool Application::handleDataMigration(const QString& currentData,
 
     if (!currentExists) {
         // Migrate!
-        auto matcher = std::make_shared<MultiMatcher>();
-        matcher->add(std::make_shared<SimplePrefixMatcher>(configFile));
-        matcher->add(std::make_shared<SimplePrefixMatcher>(
-            BuildConfig.LAUNCHER_CONFIGFILE));  // it's possible that we already used that directory before
-        matcher->add(std::make_shared<SimplePrefixMatcher>("accounts.json"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("accounts/"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("assets/"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("icons/"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("instances/"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("libraries/"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("mods/"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("themes/"));
+        auto matcher = std::make_shared<PathRuleMatcher>();
+        matcher->addPath(configFile);
+        matcher->addPath(BuildConfig.LAUNCHER_CONFIGFILE);  // it's possible that we already used that directory before
+        matcher->addPath("accounts.json");
+        matcher->addPath("accounts");
+        matcher->addPath("assets");
+        matcher->addPath("icons");
+        matcher->addPath("instances");
+        matcher->addPath("libraries");
+        matcher->addPath("mods");
+        matcher->addPath("themes");
+
+        // moving or linking is next to instant, but it isn't for everyone, so it's only offered
+        auto method = DataMigrationTask::Method::Copy;
+        auto methods = DataMigrationTask::methods(oldData, currentData);
+        if (methods.size() > 1) {
+            QMessageBox methodDialog(QMessageBox::Question, BuildConfig.LAUNCHER_DISPLAYNAME,
+                                     tr("The data of %1 is on the same drive as the new location of %2. It can be copied, which keeps both "
+                                        "apart, or moved, which is instant but leaves %1 without it.")
+                                         .arg(name, BuildConfig.LAUNCHER_DISPLAYNAME));
+            auto copyButton = methodDialog.addButton(tr("Copy"), QMessageBox::AcceptRole);
+            auto moveButton = methodDialog.addButton(tr("Move"), QMessageBox::AcceptRole);
+            QAbstractButton* linkButton = nullptr;
+            if (methods.contains(DataMigrationTask::Method::HardLink)) {
+                linkButton = methodDialog.addButton(tr("Share"), QMessageBox::AcceptRole);
+                methodDialog.setInformativeText(tr("The files can also be shared between both, which takes no space, but a file changed "
+                                                   "in one launcher is then changed in the other too."));
+            }
+            methodDialog.setDefaultButton(copyButton);
+            methodDialog.exec();
+            if (methodDialog.clickedButton() == moveButton)
+                method = DataMigrationTask::Method::Move;
+            else if (linkButton && methodDialog.clickedButton() == linkButton)
+                method = DataMigrationTask::Method::HardLink;
+        }
 
         ProgressDialog diag;
-        DataMigrationTask task(nullptr, oldData, currentData, matcher);
+        DataMigrationTask task(nullptr, oldData, currentData, matcher, method);
         if (diag.execWithTask(&task)) {
             qDebug() << "<> Migration succeeded";
             setDoNotMigrate();
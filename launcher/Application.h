@@ -55,7 +55,7 @@ class InstanceWindow;
 class MainWindow;
 class SetupWizard;
 class GenericPageProvider;
-class QFile;
+class AsyncLogger;
 class HttpMetaCache;
 class SettingsObject;
 class InstanceList;
@@ -63,6 +63,8 @@ class AccountList;
 class IconList;
 class QNetworkAccessManager;
 class JavaInstallList;
+class JavaProbeCache;
+class SystemProbe;
 class ExternalUpdater;
 class BaseProfilerFactory;
 class BaseDetachedToolFactory;
@@ -70,11 +72,26 @@ class TranslationsModel;
 class ITheme;
 class MCEditTool;
 class ThemeManager;
+class VersionPrefetcher;
+class CacheCleanupTask;
+class SpareJavaPool;
+class InstanceModIndex;
+class DiskUsage;
+class BatchLaunch;
+class PrefetchScheduler;
 
 namespace Meta {
     class Index;
 }
 
+namespace Net {
+    class HostPool;
+    class ConnectionWarmer;
+    class MirrorList;
+    class PeerCache;
+    class Diagnostics;
+}
+
 #if defined(APPLICATION)
 #undef APPLICATION
 #endif
@@ -136,6 +153,10 @@ public:
 
     std::shared_ptr<JavaInstallList> javalist();
 
+    std::shared_ptr<JavaProbeCache> javaProbeCache();
+
+    std::shared_ptr<SystemProbe> systemProbe();
+
     std::shared_ptr<InstanceList> instances() const {
         return m_instances;
     }
@@ -164,10 +185,31 @@ public:
 
     shared_qobject_ptr<QNetworkAccessManager> network();
 
+    shared_qobject_ptr<Net::HostPool> hostPool();
+
+    std::shared_ptr<Net::MirrorList> mirrors();
+
+    shared_qobject_ptr<Net::PeerCache> peerCache();
+
+    shared_qobject_ptr<Net::Diagnostics> netDiagnostics();
+
     shared_qobject_ptr<HttpMetaCache> metacache();
 
     shared_qobject_ptr<Meta::Index> metadataIndex();
 
+    shared_qobject_ptr<VersionPrefetcher> versionPrefetcher();
+
+    shared_qobject_ptr<SpareJavaPool> spareJavas();
+
+    /** Built once something looks into it, see InstanceModIndex::build(). */
+    shared_qobject_ptr<InstanceModIndex> instanceModIndex();
+
+    /** Started a moment after the startup, see DiskUsage::start(). */
+    shared_qobject_ptr<DiskUsage> diskUsage();
+
+    /** Prefetches the updates of the instances in the window set in the settings, see PrefetchScheduler. */
+    shared_qobject_ptr<PrefetchScheduler> prefetchScheduler() { return m_prefetchScheduler; }
+
     void updateCapabilities();
 
     /*!
@@ -230,6 +272,13 @@ public slots:
         MinecraftServerTargetPtr serverToJoin = nullptr,
         MinecraftAccountPtr accountToUse = nullptr
     );
+    /** Launches the instances one after the other, with what they share done once, see BatchLaunch. */
+    void launchBatch(
+        const QList<InstancePtr> &instances,
+        bool online = true,
+        MinecraftServerTargetPtr serverToJoin = nullptr,
+        MinecraftAccountPtr accountToUse = nullptr
+    );
     bool kill(InstancePtr instance);
     void closeCurrentWindow();
 
@@ -244,6 +293,10 @@ private:
     bool handleDataMigration(const QString & currentData, const QString & oldData, const QString & name, const QString & configFile) const;
     bool createSetupWizard();
     void performMainStartupAction();
+    void updateInstances(const QStringList &ids);
+    // once a day, when AutoCacheCleanup is on
+    void scheduleCacheCleanup();
+    void runHeadless();
 
     // sets the fatal error message and m_status to Failed.
     void showFatalErrorMessage(const QString & title, const QString & content);
@@ -257,17 +310,31 @@ private:
     QDateTime startTime;
 
     shared_qobject_ptr<QNetworkAccessManager> m_network;
+    shared_qobject_ptr<Net::HostPool> m_hostPool;
+    shared_qobject_ptr<Net::ConnectionWarmer> m_connectionWarmer;
+    std::shared_ptr<Net::MirrorList> m_mirrors;
+    shared_qobject_ptr<Net::PeerCache> m_peerCache;
+    shared_qobject_ptr<Net::Diagnostics> m_netDiagnostics;
 
     shared_qobject_ptr<ExternalUpdater> m_updater;
     shared_qobject_ptr<AccountList> m_accounts;
 
     shared_qobject_ptr<HttpMetaCache> m_metacache;
     shared_qobject_ptr<Meta::Index> m_metadataIndex;
+    shared_qobject_ptr<VersionPrefetcher> m_versionPrefetcher;
+    shared_qobject_ptr<CacheCleanupTask> m_cacheCleanup;
+    shared_qobject_ptr<SpareJavaPool> m_spareJavas;
+    shared_qobject_ptr<InstanceModIndex> m_instanceModIndex;
+    shared_qobject_ptr<DiskUsage> m_diskUsage;
+    shared_qobject_ptr<BatchLaunch> m_batchLaunch;
+    shared_qobject_ptr<PrefetchScheduler> m_prefetchScheduler;
 
     std::shared_ptr<SettingsObject> m_settings;
     std::shared_ptr<InstanceList> m_instances;
     std::shared_ptr<IconList> m_icons;
     std::shared_ptr<JavaInstallList> m_javalist;
+    std::shared_ptr<JavaProbeCache> m_javaProbeCache;
+    std::shared_ptr<SystemProbe> m_systemProbe;
     std::shared_ptr<TranslationsModel> m_translations;
     std::shared_ptr<GenericPageProvider> m_globalSettingsProvider;
     std::unique_ptr<MCEditTool> m_mcedit;
@@ -310,11 +377,19 @@ private:
 
     SetupWizard * m_setupWizard = nullptr;
 public:
-    QString m_instanceIdToLaunch;
+    QStringList m_instanceIdsToLaunch;
     QString m_serverToJoin;
     QString m_profileToUse;
     bool m_liveCheck = false;
     QList<QUrl> m_zipsToImport;
     QString m_instanceIdToShowWindowOf;
-    std::unique_ptr<QFile> logFile;
+    QStringList m_instanceIdsToUpdate;
+    QStringList m_instancesToCreate;
+    QStringList m_instanceIdsToVerify;
+    QStringList m_instanceIdsToVerifyFiles;
+    QStringList m_modsToFind;
+    QStringList m_bundlesToImport;
+    QString m_bundleToExport;
+    bool m_headless = false;
+    std::unique_ptr<AsyncLogger> logger;
 };
@@ -0,0 +1,518 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ArchiveReader.h"
+
+#include <QDebug>
+#include <QDir>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <climits>
+
+namespace MMCZip {
+
+namespace {
+
+constexpr quint32 s_local_header_signature = 0x04034b50;
+constexpr quint32 s_central_header_signature = 0x02014b50;
+constexpr quint32 s_end_of_central_dir_signature = 0x06054b50;
+constexpr quint32 s_zip64_end_of_central_dir_signature = 0x06064b50;
+constexpr quint32 s_zip64_locator_signature = 0x07064b50;
+
+constexpr qint64 s_local_header_size = 30;
+constexpr qint64 s_central_header_size = 46;
+constexpr qint64 s_end_of_central_dir_size = 22;
+constexpr qint64 s_zip64_locator_size = 20;
+constexpr qint64 s_zip64_end_of_central_dir_size = 56;
+
+constexpr quint16 s_flag_encrypted = 1 << 0;
+constexpr quint16 s_flag_utf8 = 1 << 11;
+
+constexpr quint16 s_extra_zip64 = 0x0001;
+constexpr quint16 s_extra_ntfs = 0x000a;
+
+constexpr quint16 s_method_stored = 0;
+constexpr quint16 s_method_deflated = 8;
+
+constexpr quint32 s_unix_file_type_mask = 0170000;
+constexpr quint32 s_unix_symlink = 0120000;
+
+// Bigger files get their space allocated before being written, so they don't end up scattered across the disk
+constexpr quint64 s_preallocate_size = 1024 * 1024;
+constexpr int s_extract_chunk_size = 256 * 1024;
+
+// All the numbers in zip files are little-endian
+quint16 read16(const uchar* p)
+{
+    return quint16(p[0]) | quint16(p[1]) << 8;
+}
+
+quint32 read32(const uchar* p)
+{
+    return quint32(p[0]) | quint32(p[1]) << 8 | quint32(p[2]) << 16 | quint32(p[3]) << 24;
+}
+
+quint64 read64(const uchar* p)
+{
+    return quint64(read32(p)) | quint64(read32(p + 4)) << 32;
+}
+
+// Same as QuaZipFileInfo64::getPermissions()
+QFileDevice::Permissions fromUnixMode(quint32 mode)
+{
+    QFileDevice::Permissions permissions;
+    if (mode & 0400)
+        permissions |= QFileDevice::ReadOwner | QFileDevice::ReadUser;
+    if (mode & 0200)
+        permissions |= QFileDevice::WriteOwner | QFileDevice::WriteUser;
+    if (mode & 0100)
+        permissions |= QFileDevice::ExeOwner | QFileDevice::ExeUser;
+    if (mode & 0040)
+        permissions |= QFileDevice::ReadGroup;
+    if (mode & 0020)
+        permissions |= QFileDevice::WriteGroup;
+    if (mode & 0010)
+        permissions |= QFileDevice::ExeGroup;
+    if (mode & 0004)
+        permissions |= QFileDevice::ReadOther;
+    if (mode & 0002)
+        permissions |= QFileDevice::WriteOther;
+    if (mode & 0001)
+        permissions |= QFileDevice::ExeOther;
+    return permissions;
+}
+
+QDateTime fromDosTime(quint16 date, quint16 time)
+{
+    return QDateTime(QDate(1980 + (date >> 9), (date >> 5) & 0xf, date & 0x1f),
+                     QTime(time >> 11, (time >> 5) & 0x3f, (time & 0x1f) * 2));
+}
+
+// Windows' FILETIME: 100ns intervals since 1601-01-01 UTC
+QDateTime fromFileTime(quint64 time)
+{
+    constexpr qint64 s_epoch_difference = 11644473600000;
+    return QDateTime::fromMSecsSinceEpoch(qint64(time / 10000) - s_epoch_difference, Qt::UTC);
+}
+
+}  // namespace
+
+ArchiveReader::ArchiveReader(QString path) : m_path(std::move(path)), m_file(m_path) {}
+
+bool ArchiveReader::open()
+{
+    if (isOpen())
+        return true;
+
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+
+    m_size = m_file.size();
+    m_data = m_size > 0 ? m_file.map(0, m_size) : nullptr;
+    if (!m_data) {
+        m_file.close();
+        return false;
+    }
+
+    if (!readCentralDirectory()) {
+        qWarning() << "Invalid zip archive:" << m_path;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ArchiveReader::close()
+{
+    if (m_data)
+        m_file.unmap(const_cast<uchar*>(m_data));
+    m_file.close();
+    m_data = nullptr;
+    m_size = 0;
+    m_entries.clear();
+    m_index.clear();
+    m_dirs.clear();
+}
+
+bool ArchiveReader::readCentralDirectory()
+{
+    if (m_size < s_end_of_central_dir_size)
+        return false;
+
+    // The end of central directory record is at the very end, unless the archive has a comment (of at most 64 KiB)
+    qint64 eocd = -1;
+    auto search_end = std::max<qint64>(0, m_size - s_end_of_central_dir_size - 0xffff);
+    for (auto pos = m_size - s_end_of_central_dir_size; pos >= search_end; pos--) {
+        if (read32(m_data + pos) == s_end_of_central_dir_signature) {
+            eocd = pos;
+            break;
+        }
+    }
+    if (eocd < 0)
+        return false;
+
+    quint64 count = read16(m_data + eocd + 10);
+    quint64 cd_size = read32(m_data + eocd + 12);
+    quint64 cd_offset = read32(m_data + eocd + 16);
+
+    // Archives that are too big for the fields above have their real values in a zip64 record
+    auto locator = eocd - s_zip64_locator_size;
+    if (locator >= 0 && read32(m_data + locator) == s_zip64_locator_signature) {
+        auto zip64_eocd = read64(m_data + locator + 8);
+        if (zip64_eocd + s_zip64_end_of_central_dir_size > quint64(locator) ||
+            read32(m_data + zip64_eocd) != s_zip64_end_of_central_dir_signature)
+            return false;
+
+        count = read64(m_data + zip64_eocd + 32);
+        cd_size = read64(m_data + zip64_eocd + 40);
+        cd_offset = read64(m_data + zip64_eocd + 48);
+    }
+
+    if (cd_offset + cd_size > quint64(eocd))
+        return false;
+
+    m_entries.reserve(int(std::min<quint64>(count, cd_size / s_central_header_size)));
+    m_index.reserve(m_entries.capacity());
+
+    auto pos = cd_offset;
+    auto end = cd_offset + cd_size;
+    for (quint64 i = 0; i < count; i++) {
+        if (pos + s_central_header_size > end)
+            return false;
+
+        auto header = m_data + pos;
+        if (read32(header) != s_central_header_signature)
+            return false;
+
+        Entry entry;
+        entry.flags = read16(header + 8);
+        entry.method = read16(header + 10);
+        entry.modified = fromDosTime(read16(header + 14), read16(header + 12));
+        entry.crc32 = read32(header + 16);
+        entry.compressed_size = read32(header + 20);
+        entry.uncompressed_size = read32(header + 24);
+        quint16 name_length = read16(header + 28);
+        quint16 extra_length = read16(header + 30);
+        quint16 comment_length = read16(header + 32);
+        entry.external_attributes = read32(header + 38);
+        entry.local_header_offset = read32(header + 42);
+
+        if (pos + s_central_header_size + name_length + extra_length + comment_length > end)
+            return false;
+
+        auto name = reinterpret_cast<const char*>(header + s_central_header_size);
+        entry.name = entry.flags & s_flag_utf8 ? QString::fromUtf8(name, name_length) : QString::fromLocal8Bit(name, name_length);
+
+        // Look for the zip64 extended information, holding the fields that didn't fit in the header,
+        // and for a more precise modification time than the DOS one
+        auto extra = header + s_central_header_size + name_length;
+        auto extra_end = extra + extra_length;
+        while (extra + 4 <= extra_end) {
+            quint16 id = read16(extra);
+            quint16 size = read16(extra + 2);
+            auto field = extra + 4;
+            auto field_end = std::min(field + size, extra_end);
+            if (id == s_extra_zip64) {
+                if (entry.uncompressed_size == 0xffffffff && field + 8 <= field_end) {
+                    entry.uncompressed_size = read64(field);
+                    field += 8;
+                }
+                if (entry.compressed_size == 0xffffffff && field + 8 <= field_end) {
+                    entry.compressed_size = read64(field);
+                    field += 8;
+                }
+                if (entry.local_header_offset == 0xffffffff && field + 8 <= field_end) {
+                    entry.local_header_offset = read64(field);
+                }
+            } else if (id == s_extra_ntfs && field + 4 + 4 + 8 <= field_end) {
+                // 4 reserved bytes, then attributes of which the first one holds the times (mtime first)
+                if (read16(field + 4) == 0x0001 && read16(field + 6) >= 24)
+                    entry.modified = fromFileTime(read64(field + 8));
+            }
+            extra = field + size;
+        }
+
+        pos += s_central_header_size + name_length + extra_length + comment_length;
+
+        int index = m_entries.size();
+        for (int slash = entry.name.indexOf('/'); slash >= 0; slash = entry.name.indexOf('/', slash + 1)) {
+            auto dir = entry.name.left(slash + 1);
+            if (!m_dirs.contains(dir))
+                m_dirs.insert(dir, index);
+        }
+
+        // like QuaZip, the first of duplicated entries wins
+        if (!m_index.contains(entry.name))
+            m_index.insert(entry.name, index);
+        m_entries.append(std::move(entry));
+    }
+
+    return true;
+}
+
+const ArchiveReader::Entry* ArchiveReader::entry(const QString& name) const
+{
+    auto it = m_index.constFind(name);
+    if (it == m_index.constEnd())
+        return nullptr;
+    return &m_entries.at(*it);
+}
+
+QStringList ArchiveReader::fileNames() const
+{
+    QStringList names;
+    names.reserve(m_entries.size());
+    for (auto& entry : m_entries)
+        names.append(entry.name);
+    return names;
+}
+
+bool ArchiveReader::containsDir(QString dir) const
+{
+    if (dir.startsWith('/'))
+        dir.remove(0, 1);
+    if (!dir.endsWith('/'))
+        dir.append('/');
+    return m_dirs.contains(dir);
+}
+
+std::optional<QByteArray> ArchiveReader::read(const QString& name) const
+{
+    auto entry = this->entry(name);
+    if (!entry || !isOpen())
+        return {};
+
+    if (entry->flags & s_flag_encrypted) {
+        qWarning() << "Encrypted zip entries are not supported:" << name;
+        return {};
+    }
+    if (entry->uncompressed_size > INT_MAX || entry->compressed_size > INT_MAX)
+        return {};
+
+    auto data_offset = dataOffset(*entry);
+    if (data_offset < 0)
+        return {};
+
+    auto compressed = reinterpret_cast<const char*>(m_data + data_offset);
+    QByteArray contents;
+
+    switch (entry->method) {
+        case s_method_stored: {
+            if (entry->compressed_size != entry->uncompressed_size)
+                return {};
+            contents = QByteArray::fromRawData(compressed, int(entry->uncompressed_size));
+            break;
+        }
+        case s_method_deflated: {
+            contents = QByteArray(int(entry->uncompressed_size), Qt::Uninitialized);
+
+            z_stream stream = {};
+            // negative window bits, since entries are raw deflate streams without any zlib header
+            if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+                return {};
+
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed));
+            stream.avail_in = uInt(entry->compressed_size);
+            stream.next_out = reinterpret_cast<Bytef*>(contents.data());
+            stream.avail_out = uInt(contents.size());
+
+            auto result = inflate(&stream, Z_FINISH);
+            inflateEnd(&stream);
+            if (result != Z_STREAM_END || stream.total_out != entry->uncompressed_size) {
+                qWarning() << "Failed to inflate" << name << "from" << m_path;
+                return {};
+            }
+            break;
+        }
+        default:
+            qWarning() << "Unsupported compression method" << entry->method << "for" << name << "in" << m_path;
+            return {};
+    }
+
+    if (crc32(0, reinterpret_cast<const Bytef*>(contents.constData()), uInt(contents.size())) != entry->crc32) {
+        qWarning() << "CRC mismatch for" << name << "in" << m_path;
+        return {};
+    }
+
+    return contents;
+}
+
+qint64 ArchiveReader::dataOffset(const Entry& entry) const
+{
+    auto header_offset = entry.local_header_offset;
+    if (header_offset + s_local_header_size > quint64(m_size) || read32(m_data + header_offset) != s_local_header_signature)
+        return -1;
+
+    // The local header can have a different extra field than the central directory, so its length has to be read from there
+    auto data_offset = header_offset + s_local_header_size + read16(m_data + header_offset + 26) + read16(m_data + header_offset + 28);
+    if (data_offset + entry.compressed_size > quint64(m_size))
+        return -1;
+    return qint64(data_offset);
+}
+
+bool ArchiveReader::extract(const Entry& entry, const QString& path) const
+{
+    if (!isOpen())
+        return false;
+
+    if (entry.name.endsWith('/'))
+        return QDir().mkpath(path);
+
+    if (entry.flags & s_flag_encrypted) {
+        qWarning() << "Encrypted zip entries are not supported:" << entry.name;
+        return false;
+    }
+
+    auto data_offset = dataOffset(entry);
+    if (data_offset < 0)
+        return false;
+    auto compressed = m_data + data_offset;
+
+    quint32 mode = entry.external_attributes >> 16;
+    if ((mode & s_unix_file_type_mask) == s_unix_symlink) {
+        if (entry.method != s_method_stored || entry.compressed_size > 0xffff)
+            return false;
+        QFile::remove(path);
+        return QFile::link(QFile::decodeName(QByteArray(reinterpret_cast<const char*>(compressed), int(entry.compressed_size))), path);
+    }
+
+    if (entry.method == s_method_stored && entry.compressed_size != entry.uncompressed_size)
+        return false;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to open" << path << "for writing:" << file.errorString();
+        return false;
+    }
+    if (entry.uncompressed_size >= s_preallocate_size) {
+        file.resize(qint64(entry.uncompressed_size));
+        file.seek(0);
+    }
+
+    quint32 crc = crc32(0, nullptr, 0);
+    quint64 written = 0;
+    auto write = [&file, &crc, &written](const uchar* data, qint64 size) {
+        crc = crc32(crc, data, uInt(size));
+        written += size;
+        return file.write(reinterpret_cast<const char*>(data), size) == size;
+    };
+
+    bool ok = true;
+    switch (entry.method) {
+        case s_method_stored: {
+            for (quint64 pos = 0; ok && pos < entry.compressed_size; pos += s_extract_chunk_size)
+                ok = write(compressed + pos, qint64(std::min<quint64>(s_extract_chunk_size, entry.compressed_size - pos)));
+            break;
+        }
+        case s_method_deflated: {
+            z_stream stream = {};
+            if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+                ok = false;
+                break;
+            }
+
+            QByteArray buffer(s_extract_chunk_size, Qt::Uninitialized);
+            auto out = reinterpret_cast<Bytef*>(buffer.data());
+            auto in = compressed;
+            auto in_end = compressed + entry.compressed_size;
+            int result = Z_OK;
+            while (ok && result != Z_STREAM_END) {
+                if (stream.avail_in == 0) {
+                    if (in == in_end)
+                        break;
+                    // avail_in is only 32 bits wide
+                    stream.next_in = const_cast<Bytef*>(in);
+                    stream.avail_in = uInt(std::min<quint64>(in_end - in, 1u << 30));
+                    in += stream.avail_in;
+                }
+                stream.next_out = out;
+                stream.avail_out = uInt(buffer.size());
+                result = inflate(&stream, Z_NO_FLUSH);
+                if (result != Z_OK && result != Z_STREAM_END)
+                    break;
+                ok = write(out, buffer.size() - stream.avail_out);
+            }
+            inflateEnd(&stream);
+            if (result != Z_STREAM_END) {
+                qWarning() << "Failed to inflate" << entry.name << "from" << m_path;
+                ok = false;
+            }
+            break;
+        }
+        default:
+            qWarning() << "Unsupported compression method" << entry.method << "for" << entry.name << "in" << m_path;
+            ok = false;
+    }
+
+    if (ok && (written != entry.uncompressed_size || crc != entry.crc32)) {
+        qWarning() << "CRC mismatch for" << entry.name << "in" << m_path;
+        ok = false;
+    }
+    if (!ok) {
+        file.remove();
+        return false;
+    }
+
+    file.close();
+    if (mode & 0777)
+        file.setPermissions(fromUnixMode(mode));
+    return file.error() == QFileDevice::NoError;
+}
+
+QString ArchiveReader::findFolderOfFile(const QString& what, const QStringList& ignore_paths) const
+{
+    return findFoldersOfFiles({ what }, ignore_paths).first();
+}
+
+QStringList ArchiveReader::findFoldersOfFiles(const QStringList& whats, const QStringList& ignore_paths) const
+{
+    auto is_ignored = [&ignore_paths](const QStringList& folders) {
+        return std::any_of(folders.cbegin(), folders.cend(), [&ignore_paths](const QString& folder) {
+            return ignore_paths.contains(folder + '/');
+        });
+    };
+
+    // Whether `a` would be found before `b` by searching folder by folder, looking at the files
+    // of a folder before going into its subfolders
+    auto comes_before = [this](const QStringList& a, const QStringList& b) {
+        QString prefix;
+        for (int i = 0;; i++) {
+            if (i == a.size())
+                return i != b.size();
+            if (i == b.size())
+                return false;
+            if (a[i] != b[i])
+                return m_dirs.value(prefix + a[i] + '/') < m_dirs.value(prefix + b[i] + '/');
+            prefix += a[i] + '/';
+        }
+    };
+
+    QVector<std::optional<QStringList>> found(whats.size());
+    for (auto& entry : m_entries) {
+        auto slash = entry.name.lastIndexOf('/');
+        auto which = whats.indexOf(entry.name.mid(slash + 1));
+        if (which < 0)
+            continue;
+
+        auto folders = entry.name.left(slash).split('/', Qt::SkipEmptyParts);
+        if (is_ignored(folders))
+            continue;
+
+        if (!found[which] || comes_before(folders, *found[which]))
+            found[which] = folders;
+    }
+
+    QStringList folders;
+    for (auto& folder : found) {
+        if (!folder)
+            folders.append(QString());
+        else if (folder->isEmpty())
+            folders.append(QString(""));
+        else
+            folders.append(folder->join('/') + '/');
+    }
+    return folders;
+}
+
+}  // namespace MMCZip
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <optional>
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace MMCZip {
+
+/* Read-only access to the files of a zip archive.
+ *
+ * The archive is memory-mapped and its central directory is read only once, into a
+ * hash index, so looking files up doesn't need to scan the archive every time like
+ * QuaZip::setCurrentFile() does. Meant for the many places that only need to peek at
+ * a couple of files in an archive (mod metadata, pack.mcmeta, ...).
+ */
+class ArchiveReader {
+   public:
+    struct Entry {
+        QString name;
+        quint16 flags = 0;
+        quint16 method = 0;
+        quint32 crc32 = 0;
+        quint64 compressed_size = 0;
+        quint64 uncompressed_size = 0;
+        quint64 local_header_offset = 0;
+        /* the upper half holds the unix mode of the file, when the archive was made on unix */
+        quint32 external_attributes = 0;
+        /* NTFS modification time if the archive has it, DOS one otherwise */
+        QDateTime modified;
+    };
+
+    explicit ArchiveReader(QString path);
+
+    /** Maps the archive and indexes its central directory. */
+    bool open();
+    bool isOpen() const { return m_data != nullptr; }
+    void close();
+
+    QString path() const { return m_path; }
+
+    bool contains(const QString& name) const { return m_index.contains(name); }
+    const Entry* entry(const QString& name) const;
+
+    /** Names of all the entries, in the order they appear in the archive. */
+    QStringList fileNames() const;
+    /** All the entries, in the order they appear in the archive, duplicates included. */
+    const QVector<Entry>& entries() const { return m_entries; }
+
+    /** Whether there are entries under the given directory (e.g. "assets/"). */
+    bool containsDir(QString dir) const;
+
+    /**
+     * Contents of a file in the archive, or nothing if it doesn't exist or can't be read.
+     *
+     * Stored (uncompressed) entries are returned as a view of the mapped archive, without
+     * any copying. Such views must not outlive the reader.
+     */
+    std::optional<QByteArray> read(const QString& name) const;
+
+    /**
+     * Extract an entry to a file, inflating it piece by piece instead of reading all of it into memory.
+     * Folders (entries ending with a '/') are created, and so are symbolic links.
+     *
+     * Doesn't modify the reader, so several threads can extract from the same one at the same time.
+     * The folder holding `path` has to exist already.
+     */
+    bool extract(const Entry& entry, const QString& path) const;
+
+    /**
+     * Find a single file in the archive by file name (not path), searching the folders
+     * depth-first, in the order they appear in the archive.
+     *
+     * \param ignore_paths folders to skip when searching, with a trailing slash (e.g. "overrides/")
+     *
+     * \return the path prefix where the file is, or a null string if it wasn't found
+     */
+    QString findFolderOfFile(const QString& what, const QStringList& ignore_paths = {}) const;
+    /** Same as findFolderOfFile() for several file names, in a single pass over the entries. */
+    QStringList findFoldersOfFiles(const QStringList& whats, const QStringList& ignore_paths = {}) const;
+
+   private:
+    bool readCentralDirectory();
+    /** Where the data of an entry starts, or -1 if that's not inside the archive. */
+    qint64 dataOffset(const Entry& entry) const;
+
+    QString m_path;
+    QFile m_file;
+    const uchar* m_data = nullptr;
+    qint64 m_size = 0;
+
+    QVector<Entry> m_entries;
+    QHash<QString, int> m_index;
+    // every folder holding entries, with the index of the first entry found in it
+    QHash<QString, int> m_dirs;
+};
+
+}  // namespace MMCZip
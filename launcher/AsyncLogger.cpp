@@ -0,0 +1,235 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "AsyncLogger.h"
+
+#include <chrono>
+#include <cstddef>
+
+namespace {
+constexpr auto s_flushInterval = std::chrono::seconds(1);
+constexpr auto s_idleWait = std::chrono::milliseconds(100);
+constexpr int s_maxBatch = 512;
+
+bool isUrgent(QtMsgType type)
+{
+    return type == QtWarningMsg || type == QtCriticalMsg || type == QtFatalMsg;
+}
+
+qint64 currentSecond()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+QString droppedLine(const QByteArray& category, int dropped, int perSecond)
+{
+    return QString("[%1] %2 messages dropped, it's limited to %3 a second\n").arg(QString(category)).arg(dropped).arg(perSecond);
+}
+}  // namespace
+
+AsyncLogger::AsyncLogger(std::unique_ptr<QFile> file) : m_file(std::move(file)), m_entries(new Entry[s_capacity])
+{
+    for (size_t i = 0; i < s_capacity; i++)
+        m_entries[i].sequence.store(i, std::memory_order_relaxed);
+    m_writer = std::thread([this] { run(); });
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    stop();
+}
+
+void AsyncLogger::setRateLimits(const QHash<QByteArray, int>& limits)
+{
+    if (m_ownedLimits || limits.isEmpty())
+        return;
+
+    m_ownedLimits.reset(new Limits);
+    for (auto iter = limits.begin(); iter != limits.end(); iter++) {
+        auto limit = std::make_shared<Limit>();
+        limit->perSecond = iter.value();
+        m_ownedLimits->insert(iter.key(), limit);
+    }
+    m_limits.store(m_ownedLimits.get(), std::memory_order_release);
+}
+
+void AsyncLogger::log(QtMsgType type, const char* category, QString line)
+{
+    if (!allowed(category))
+        return;
+
+    if (m_stopped.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(m_directMutex);
+        write(line);
+        flush();
+        return;
+    }
+
+    if (!enqueue(type, line)) {
+        std::lock_guard<std::mutex> lock(m_directMutex);
+        write(line);
+        return;
+    }
+    if (isUrgent(type))
+        m_wake.notify_one();
+}
+
+bool AsyncLogger::allowed(const char* category)
+{
+    auto limits = m_limits.load(std::memory_order_acquire);
+    if (!limits || !category)
+        return true;
+
+    auto found = limits->constFind(QByteArray::fromRawData(category, qstrlen(category)));
+    if (found == limits->constEnd())
+        return true;
+
+    auto& limit = **found;
+    auto now = currentSecond();
+    auto second = limit.second.load(std::memory_order_relaxed);
+    if (second != now && limit.second.compare_exchange_strong(second, now)) {
+        // a new second, whoever gets here first tells what the last one dropped
+        limit.count.store(0, std::memory_order_relaxed);
+        auto dropped = limit.dropped.exchange(0);
+        if (dropped > 0)
+            log(QtInfoMsg, nullptr, droppedLine(found.key(), dropped, limit.perSecond));
+    }
+
+    if (limit.count.fetch_add(1, std::memory_order_relaxed) < limit.perSecond)
+        return true;
+    limit.dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// A bounded queue after Dmitry Vyukov's: each entry's sequence says whose turn it is, so producers only race on the
+// position they take, and the single consumer doesn't race at all.
+bool AsyncLogger::enqueue(QtMsgType type, const QString& line)
+{
+    auto pos = m_enqueued.load(std::memory_order_relaxed);
+    Entry* entry;
+    while (true) {
+        entry = &m_entries[pos % s_capacity];
+        auto sequence = entry->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (m_enqueued.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // full, the writer is behind, waiting for it is still better than losing the message
+            if (m_stopped.load(std::memory_order_acquire))
+                return false;
+            m_wake.notify_one();
+            std::this_thread::yield();
+            pos = m_enqueued.load(std::memory_order_relaxed);
+        } else {
+            pos = m_enqueued.load(std::memory_order_relaxed);
+        }
+    }
+
+    entry->type = type;
+    entry->line = line;
+    entry->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool AsyncLogger::dequeue(QtMsgType& type, QString& line)
+{
+    auto& entry = m_entries[m_dequeued % s_capacity];
+    if (entry.sequence.load(std::memory_order_acquire) != m_dequeued + 1)
+        return false;
+
+    type = entry.type;
+    line = std::move(entry.line);
+    entry.line = QString();
+    entry.sequence.store(m_dequeued + s_capacity, std::memory_order_release);
+    m_dequeued++;
+    return true;
+}
+
+void AsyncLogger::run()
+{
+    auto lastFlush = std::chrono::steady_clock::now();
+    bool unflushed = false;
+
+    while (true) {
+        QByteArray fileOut, errOut;
+        bool urgent = false;
+        int taken = 0;
+
+        QtMsgType type;
+        QString line;
+        while (taken < s_maxBatch && dequeue(type, line)) {
+            fileOut += line.toUtf8();
+            errOut += line.toLocal8Bit();
+            urgent |= isUrgent(type);
+            taken++;
+        }
+
+        if (taken > 0) {
+            if (m_file)
+                m_file->write(fileOut);
+            fwrite(errOut.constData(), 1, errOut.size(), stderr);
+            fflush(stderr);
+            unflushed = true;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (unflushed && (urgent || now - lastFlush >= s_flushInterval)) {
+            if (m_file)
+                m_file->flush();
+            unflushed = false;
+            lastFlush = now;
+        }
+
+        if (taken == s_maxBatch)
+            continue;
+        if (taken == 0 && m_stopped.load(std::memory_order_acquire))
+            break;
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait_for(lock, s_idleWait);
+    }
+
+    if (m_file)
+        m_file->flush();
+}
+
+void AsyncLogger::stop()
+{
+    std::lock_guard<std::mutex> lock(m_directMutex);
+    if (m_stopped.exchange(true))
+        return;
+
+    m_wake.notify_one();
+    if (m_writer.joinable())
+        m_writer.join();
+
+    // what was queued while the writer was finishing, nothing takes from the queue anymore but this
+    QtMsgType type;
+    QString line;
+    while (dequeue(type, line))
+        write(line);
+
+    if (auto limits = m_limits.load(std::memory_order_acquire)) {
+        for (auto iter = limits->begin(); iter != limits->end(); iter++) {
+            auto dropped = (*iter)->dropped.exchange(0);
+            if (dropped > 0)
+                write(droppedLine(iter.key(), dropped, (*iter)->perSecond));
+        }
+    }
+    flush();
+}
+
+void AsyncLogger::write(const QString& line)
+{
+    if (m_file)
+        m_file->write(line.toUtf8());
+    auto local = line.toLocal8Bit();
+    fwrite(local.constData(), 1, local.size(), stderr);
+}
+
+void AsyncLogger::flush()
+{
+    if (m_file)
+        m_file->flush();
+    fflush(stderr);
+}
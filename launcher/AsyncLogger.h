@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/* Writes the launcher's log to its file and to stderr on a thread of its own.
+ *
+ * Messages go through a lock-free queue, so the threads logging don't wait on each other or on the disk. The writer
+ * takes them out in batches and flushes about once a second, and right away after a warning or worse. Categories can
+ * be limited to a number of messages a second, the ones over that are counted and dropped.
+ */
+class AsyncLogger {
+   public:
+    explicit AsyncLogger(std::unique_ptr<QFile> file);
+    ~AsyncLogger();
+
+    /** Limits categories to the given number of messages a second. Can only be set once. */
+    void setRateLimits(const QHash<QByteArray, int>& limits);
+
+    /** Logs a formatted `line`, from any thread. */
+    void log(QtMsgType type, const char* category, QString line);
+
+    /** Writes out everything that's waiting and stops the writer. Later messages are written right away. */
+    void stop();
+
+   private:
+    struct Entry {
+        std::atomic<size_t> sequence{ 0 };
+        QtMsgType type = QtDebugMsg;
+        QString line;
+    };
+    struct Limit {
+        int perSecond = 0;
+        std::atomic<qint64> second{ 0 };
+        std::atomic<int> count{ 0 };
+        std::atomic<int> dropped{ 0 };
+    };
+    using Limits = QHash<QByteArray, std::shared_ptr<Limit>>;
+
+    bool allowed(const char* category);
+    bool enqueue(QtMsgType type, const QString& line);
+    bool dequeue(QtMsgType& type, QString& line);
+    void run();
+    void write(const QString& line);
+    void flush();
+
+    std::unique_ptr<QFile> m_file;
+
+    static constexpr size_t s_capacity = 8192;
+    std::unique_ptr<Entry[]> m_entries;
+    alignas(64) std::atomic<size_t> m_enqueued{ 0 };
+    alignas(64) size_t m_dequeued = 0;
+
+    std::unique_ptr<Limits> m_ownedLimits;
+    std::atomic<Limits*> m_limits{ nullptr };
+
+    std::thread m_writer;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_stopped{ false };
+    // for the messages after stop()
+    std::mutex m_directMutex;
+};
@@ -58,15 +58,17 @@ BaseInstance::BaseInstance(SettingsObjectPtr globalSettings, SettingsObjectPtr s
     m_global_settings = globalSettings;
     m_rootDir = rootDir;
 
-    m_settings->registerSetting("name", "Unnamed Instance");
-    m_settings->registerSetting("iconKey", "default");
-    m_settings->registerSetting("notes", "");
+    m_settings->declareSetting("name", "Unnamed Instance");
+    m_settings->declareSetting("iconKey", "default");
+    m_settings->declareSetting("notes", "");
 
-    m_settings->registerSetting("lastLaunchTime", 0);
-    m_settings->registerSetting("totalTimePlayed", 0);
-    m_settings->registerSetting("lastTimePlayed", 0);
+    m_settings->declareSetting("lastLaunchTime", 0);
+    m_settings->declareSetting("totalTimePlayed", 0);
+    m_settings->declareSetting("lastTimePlayed", 0);
 
-    m_settings->registerSetting("linkedInstances", "[]");
+    m_settings->declareSetting("linkedInstances", "[]");
+    // the id of the base instance of a layered instance, see InstanceLayer
+    m_settings->declareSetting("layeredOn", "");
 
     // Game time override
     auto gameTimeOverride = m_settings->registerSetting("OverrideGameTime", false);
@@ -75,8 +77,8 @@ BaseInstance::BaseInstance(SettingsObjectPtr globalSettings, SettingsObjectPtr s
 
     // NOTE: Sometimees InstanceType is already registered, as it was used to identify the type of
     // a locally stored instance
-    if (!m_settings->getSetting("InstanceType"))
-        m_settings->registerSetting("InstanceType", "");
+    if (!m_settings->contains("InstanceType"))
+        m_settings->declareSetting("InstanceType", "");
 
     // Custom Commands
     auto commandSetting = m_settings->registerSetting({"OverrideCommands","OverrideLaunchCmd"}, false);
@@ -95,12 +97,12 @@ BaseInstance::BaseInstance(SettingsObjectPtr globalSettings, SettingsObjectPtr s
     m_settings->registerPassthrough(globalSettings->getSetting("ConsoleOverflowStop"), nullptr);
 
     // Managed Packs
-    m_settings->registerSetting("ManagedPack", false);
-    m_settings->registerSetting("ManagedPackType", "");
-    m_settings->registerSetting("ManagedPackID", "");
-    m_settings->registerSetting("ManagedPackName", "");
-    m_settings->registerSetting("ManagedPackVersionID", "");
-    m_settings->registerSetting("ManagedPackVersionName", "");
+    m_settings->declareSetting("ManagedPack", false);
+    m_settings->declareSetting("ManagedPackType", "");
+    m_settings->declareSetting("ManagedPackID", "");
+    m_settings->declareSetting("ManagedPackName", "");
+    m_settings->declareSetting("ManagedPackVersionID", "");
+    m_settings->declareSetting("ManagedPackVersionName", "");
 }
 
 QString BaseInstance::getPreLaunchCommand()
@@ -218,6 +220,16 @@ bool BaseInstance::isLinkedToInstanceId(const QString& id) const
     return linkedInstances.contains(id);
 }
 
+QString BaseInstance::layeredOn() const
+{
+    return m_settings->get("layeredOn").toString();
+}
+
+void BaseInstance::setLayeredOn(const QString& id)
+{
+    m_settings->set("layeredOn", id);
+}
+
 void BaseInstance::iconUpdated(QString key)
 {
     if(iconKey() == key)
@@ -288,6 +288,10 @@ public:
     bool removeLinkedInstanceId(const QString& id);
     bool isLinkedToInstanceId(const QString& id) const;
 
+    /// the id of the instance this one is layered on, empty when it has all its files (see InstanceLayer)
+    QString layeredOn() const;
+    void setLayeredOn(const QString& id);
+
 protected:
     void changeStatus(Status newStatus);
 
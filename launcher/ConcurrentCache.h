@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+
+#include <array>
+#include <atomic>
+#include <type_traits>
+
+/* A cache any thread can put into and take from, within a budget of bytes.
+ *
+ * The entries are split over a few shards with a lock each, so the threads filling it and the GUI reading it seldom
+ * wait for each other. Each shard keeps its share of the budget and lets go of what was used the longest ago when an
+ * entry doesn't fit. The values are copied in and out, so they should be implicitly shared (QIcon, QImage, QString...).
+ *
+ * An entry can be marked stale, for when what it was made from changed: it's still found, until it's replaced.
+ */
+template <typename K, typename V, int Shards = 16>
+class ConcurrentCache {
+   public:
+    struct Stats {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        int count = 0;
+        qint64 bytes = 0;
+    };
+
+    explicit ConcurrentCache(qint64 budget)
+    {
+        for (auto& shard : m_shards)
+            shard.entries.setMaxCost(qMax<qint64>(budget / 1024 / Shards, 1));
+    }
+
+    /** Puts the value in the place of what the key had, returns false when it's bigger than a shard can hold. */
+    bool insert(const K& key, const V& value, qint64 bytes)
+    {
+        // costs in KiB, so that a hint of the size is enough
+        auto cost = qMax<qint64>(bytes / 1024, 1);
+        auto& shard = shardOf(key);
+        QMutexLocker locker(&shard.lock);
+        return shard.entries.insert(key, new Entry{ value, false }, cost);
+    }
+
+    /** Counted in the hits and misses. `value` may be null to only know if it's there. */
+    bool find(const K& key, V* value) const
+    {
+        auto& shard = shardOf(key);
+        QMutexLocker locker(&shard.lock);
+        auto found = shard.entries.object(key);
+        if (!found) {
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        if (value)
+            *value = found->value;
+        return true;
+    }
+
+    /** Not there, or marked stale since it was put in. */
+    bool stale(const K& key) const
+    {
+        auto& shard = shardOf(key);
+        QMutexLocker locker(&shard.lock);
+        auto found = shard.entries.object(key);
+        return !found || found->stale;
+    }
+
+    void setStale(const K& key)
+    {
+        auto& shard = shardOf(key);
+        QMutexLocker locker(&shard.lock);
+        if (auto found = shard.entries.object(key))
+            found->stale = true;
+    }
+
+    void remove(const K& key)
+    {
+        auto& shard = shardOf(key);
+        QMutexLocker locker(&shard.lock);
+        shard.entries.remove(key);
+    }
+
+    void clear()
+    {
+        for (auto& shard : m_shards) {
+            QMutexLocker locker(&shard.lock);
+            shard.entries.clear();
+        }
+    }
+
+    Stats stats() const
+    {
+        Stats stats;
+        stats.hits = m_hits.load(std::memory_order_relaxed);
+        stats.misses = m_misses.load(std::memory_order_relaxed);
+        for (auto& shard : m_shards) {
+            QMutexLocker locker(&shard.lock);
+            stats.count += shard.entries.count();
+            stats.bytes += qint64(shard.entries.totalCost()) * 1024;
+        }
+        return stats;
+    }
+
+   private:
+    struct Entry {
+        V value;
+        bool stale;
+    };
+    struct Shard {
+        mutable QMutex lock;
+        QCache<K, Entry> entries;
+    };
+
+    Shard& shardOf(const K& key) const
+    {
+        // handed out one after the other, integers spread the most evenly as they are
+        if constexpr (std::is_integral_v<K>)
+            return m_shards[static_cast<std::make_unsigned_t<K>>(key) % Shards];
+        else
+            return m_shards[qHash(key) % Shards];
+    }
+
+    mutable std::array<Shard, Shards> m_shards;
+    mutable std::atomic<qint64> m_hits{ 0 };
+    mutable std::atomic<qint64> m_misses{ 0 };
+};
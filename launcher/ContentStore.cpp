@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ContentStore.h"
+
+#include <QDebug>
+#include <QFileInfo>
+
+#include "Application.h"
+#include "FileSystem.h"
+#include "settings/SettingsObject.h"
+
+namespace ContentStore {
+
+static const QString s_store_root = "store";
+
+QString algorithmName(QCryptographicHash::Algorithm algorithm)
+{
+    switch (algorithm) {
+        case QCryptographicHash::Md5:
+            return "md5";
+        case QCryptographicHash::Sha1:
+            return "sha1";
+        case QCryptographicHash::Sha256:
+            return "sha256";
+        case QCryptographicHash::Sha512:
+            return "sha512";
+        default:
+            return {};
+    }
+}
+
+bool isEnabled()
+{
+    return APPLICATION->settings()->get("SharedObjectStore").toBool();
+}
+
+std::optional<QCryptographicHash::Algorithm> algorithmFromName(const QString& name)
+{
+    auto lower = name.toLower();
+    if (lower == "md5")
+        return QCryptographicHash::Md5;
+    if (lower == "sha1")
+        return QCryptographicHash::Sha1;
+    if (lower == "sha256")
+        return QCryptographicHash::Sha256;
+    if (lower == "sha512")
+        return QCryptographicHash::Sha512;
+    return {};
+}
+
+QString objectPath(QCryptographicHash::Algorithm algorithm, const QByteArray& hash)
+{
+    auto name = algorithmName(algorithm);
+    if (name.isEmpty() || hash.isEmpty())
+        return {};
+
+    auto hex = QString::fromLatin1(hash.toHex());
+    return FS::PathCombine(s_store_root, name, hex.left(2), hex);
+}
+
+bool contains(QCryptographicHash::Algorithm algorithm, const QByteArray& hash)
+{
+    auto path = objectPath(algorithm, hash);
+    return !path.isEmpty() && QFileInfo::exists(path);
+}
+
+bool materialize(QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& target)
+{
+    if (!contains(algorithm, hash))
+        return false;
+
+    if (!FS::cloneOrLinkFile(objectPath(algorithm, hash), target)) {
+        qWarning() << "Failed to place stored object" << hash.toHex() << "at" << target;
+        return false;
+    }
+    return true;
+}
+
+bool insert(QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& path)
+{
+    auto object = objectPath(algorithm, hash);
+    if (object.isEmpty())
+        return false;
+
+    if (!QFileInfo::exists(object)) {
+        // the stored copy shares the data with the file we just got, so this is cheap
+        if (!FS::cloneOrLinkFile(path, object)) {
+            qWarning() << "Failed to add" << path << "to the content store";
+            return false;
+        }
+        return true;
+    }
+
+    // we already had it (e.g. two downloads raced), make the new file share the stored data
+    return FS::cloneOrLinkFile(object, path);
+}
+
+}  // namespace ContentStore
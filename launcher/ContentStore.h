@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QString>
+
+#include <optional>
+
+/** A launcher-wide, content-addressed store for downloaded files.
+ *
+ *  Objects live under `store/<algorithm>/<first two hex digits>/<hash>` and are
+ *  reflinked, hard linked or (as a last resort) copied into the instances that use
+ *  them, so a jar shared by many modpacks is only downloaded and stored once.
+ */
+namespace ContentStore {
+
+/** Whether the user enabled the shared store. */
+bool isEnabled();
+
+/** Maps the hash names used by the mod platforms ("sha1", "sha512", ...) to our algorithms. */
+std::optional<QCryptographicHash::Algorithm> algorithmFromName(const QString& name);
+/** The other way around, empty for the algorithms the store doesn't use. */
+QString algorithmName(QCryptographicHash::Algorithm algorithm);
+
+/** Where the object with the given raw (not hex-encoded) hash would be stored. */
+QString objectPath(QCryptographicHash::Algorithm algorithm, const QByteArray& hash);
+
+bool contains(QCryptographicHash::Algorithm algorithm, const QByteArray& hash);
+
+/** Places the stored object at `target`. Returns false if it isn't in the store or can't be linked. */
+bool materialize(QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& target);
+
+/** Adds the already verified file at `path` to the store, then makes `path` share the stored data. */
+bool insert(QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& path);
+
+}  // namespace ContentStore
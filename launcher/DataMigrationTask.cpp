@@ -4,93 +4,249 @@
 
 #include "DataMigrationTask.h"
 
+#include "Executors.h"
 #include "FileSystem.h"
+#include "StringUtils.h"
 
-#include <QDirIterator>
+#include <QDir>
+#include <QFile>
 #include <QFileInfo>
-#include <QMap>
+#include <QSet>
 
 #include <QtConcurrent>
 
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+bool copyFile(const QString& src, const QString& dst, std::atomic_bool& can_clone, bool is_symlink)
+{
+    std::error_code err;
+    if (can_clone && !is_symlink) {
+        if (FS::clone_file_data(src, dst, err))
+            return true;
+        // the empty file a failed clone leaves would make the copy fail too
+        QFile::remove(dst);
+        // the filesystem is one that can, but not this one of them: the other files would only fail the same way
+        if (FS::isCloneUnsupported(err) && can_clone.exchange(false))
+            qDebug() << "Cloning isn't supported for" << dst << ", copying instead:" << QString::fromStdString(err.message());
+        err.clear();
+    }
+    fs::copy_file(StringUtils::toStdString(src), StringUtils::toStdString(dst), fs::copy_options::overwrite_existing, err);
+    if (err) {
+        qWarning() << "Failed to copy" << src << "to" << dst << ":" << QString::fromStdString(err.message());
+        return false;
+    }
+    return true;
+}
+}  // namespace
+
 DataMigrationTask::DataMigrationTask(QObject* parent,
                                      const QString& sourcePath,
                                      const QString& targetPath,
-                                     const IPathMatcher::Ptr pathMatcher)
-    : Task(parent), m_sourcePath(sourcePath), m_targetPath(targetPath), m_pathMatcher(pathMatcher), m_copy(sourcePath, targetPath)
+                                     const IPathMatcher::Ptr pathMatcher,
+                                     Method method)
+    : Task(parent), m_sourcePath(sourcePath), m_targetPath(targetPath), m_pathMatcher(pathMatcher), m_method(method)
+{
+    connect(&m_scanWatcher, &QFutureWatcher<QList<File>>::finished, this, &DataMigrationTask::scanFinished);
+    connect(&m_migrateWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::migrateFinished);
+    m_progressTimer.setInterval(s_progress_interval);
+    connect(&m_progressTimer, &QTimer::timeout, this, &DataMigrationTask::updateProgress);
+}
+
+DataMigrationTask::~DataMigrationTask()
 {
-    m_copy.matcher(m_pathMatcher.get()).whitelist(true);
+    m_state->canceled.store(true);
+    m_scanWatcher.waitForFinished();
+    m_migrateWatcher.waitForFinished();
+}
+
+QList<DataMigrationTask::Method> DataMigrationTask::methods(const QString& sourcePath, const QString& targetPath)
+{
+    QList<Method> methods{ Method::Copy };
+    if (FS::statFS(sourcePath).rootPath != FS::statFS(targetPath).rootPath)
+        return methods;
+    if (FS::canLink(sourcePath, targetPath))
+        methods.append(Method::HardLink);
+    methods.append(Method::Move);
+    return methods;
+}
+
+bool DataMigrationTask::abort()
+{
+    // the files migrated already stay where they are
+    m_state->canceled.store(true);
+    return true;
 }
 
 void DataMigrationTask::executeTask()
 {
+    if (!QFileInfo(m_sourcePath).isDir()) {
+        emitFailed(tr("Failed to scan source path."));
+        return;
+    }
     setStatus(tr("Scanning files..."));
+    m_scanWatcher.setFuture(QtConcurrent::run(Executors::io(), &DataMigrationTask::scan, m_sourcePath, m_pathMatcher.get()));
+}
 
-    // 1. Scan
-    // Check how many files we gotta copy
-    m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), [&] {
-        return m_copy(true);  // dry run to collect amount of files
-    });
-    connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::dryRunFinished);
-    connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::canceled, this, &DataMigrationTask::dryRunAborted);
-    m_copyFutureWatcher.setFuture(m_copyFuture);
+auto DataMigrationTask::scan(const QString& sourcePath, const IPathMatcher* matcher) -> QList<File>
+{
+    QList<File> files;
+    QDir source(sourcePath);
+    QStringList folders{ sourcePath };
+    while (!folders.isEmpty()) {
+        QDir folder(folders.takeLast());
+        for (auto& info : folder.entryInfoList(QDir::Files | QDir::Hidden)) {
+            auto relative = source.relativeFilePath(info.filePath());
+            if (matcher && !matcher->matches(relative))
+                continue;
+            files.append({ relative, info.size(), info.isSymLink() });
+        }
+        // the folders linked to aren't followed, they may well be outside of the data
+        for (auto& info : folder.entryInfoList(QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot | QDir::NoSymLinks))
+            folders.append(info.filePath());
+    }
+    // the big files first, so the last ones to be done aren't those that take the longest
+    std::stable_sort(files.begin(), files.end(), [](const File& a, const File& b) { return a.size > b.size; });
+    return files;
 }
 
-void DataMigrationTask::dryRunFinished()
+void DataMigrationTask::scanFinished()
 {
-    disconnect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::dryRunFinished);
-    disconnect(&m_copyFutureWatcher, &QFutureWatcher<bool>::canceled, this, &DataMigrationTask::dryRunAborted);
-
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    if (!m_copyFuture.isValid() || !m_copyFuture.result()) {
-#else
-    if (!m_copyFuture.result()) {
-#endif
-        emitFailed(tr("Failed to scan source path."));
+    if (m_state->canceled.load()) {
+        emitAborted();
         return;
     }
 
-    // 2. Copy
-    // Actually copy all files now.
-    m_toCopy = m_copy.totalCopied();
-    connect(&m_copy, &FS::copy::fileCopied, [&, this](const QString& relativeName) {
-        QString shortenedName = relativeName;
-        // shorten the filename to hopefully fit into one line
-        if (shortenedName.length() > 50)
-            shortenedName = relativeName.left(20) + "…" + relativeName.right(29);
-        setProgress(m_copy.totalCopied(), m_toCopy);
-        setStatus(tr("Copying %1…").arg(shortenedName));
-    });
-    m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), [&] {
-        return m_copy(false);  // actually copy now
+    auto files = m_scanWatcher.result();
+    m_files = files.size();
+    for (auto& file : files)
+        m_bytes += file.size;
+    qDebug() << "Migrating" << m_files << "files," << m_bytes << "bytes, from" << m_sourcePath << "to" << m_targetPath;
+
+    setProgress(0, m_bytes);
+    m_progressTimer.start();
+    m_migrateWatcher.setFuture(
+        QtConcurrent::run(Executors::io(), &DataMigrationTask::migrate, m_sourcePath, m_targetPath, files, m_method, m_state));
+}
+
+bool DataMigrationTask::migrate(QString sourcePath, QString targetPath, QList<File> files, Method method, std::shared_ptr<State> state)
+{
+    // workers creating the folders themselves would race each other for the common parts of their paths
+    QSet<QString> folders;
+    for (auto& file : files)
+        folders.insert(QFileInfo(FS::PathCombine(targetPath, file.relativePath)).absolutePath());
+    for (auto& folder : folders) {
+        if (!FS::ensureFolderPathExists(folder)) {
+            qWarning() << "Failed to create" << folder;
+            return false;
+        }
+    }
+
+    // only worth trying when both ends are on the same filesystem that can do it, which is checked once and not for every file
+    std::atomic_bool can_clone{ method == Method::Copy && !files.isEmpty() && FS::canClone(sourcePath, targetPath) };
+    std::atomic_bool failed{ false };
+
+    QtConcurrent::blockingMap(files, [&](const File& file) {
+        if (state->canceled.load())
+            return;
+        auto src = FS::PathCombine(sourcePath, file.relativePath);
+        auto dst = FS::PathCombine(targetPath, file.relativePath);
+
+        std::error_code err;
+        bool done = false;
+        switch (method) {
+            case Method::Move:
+                fs::rename(StringUtils::toStdString(src), StringUtils::toStdString(dst), err);
+                done = !err;
+                // a folder in there can be another filesystem mounted
+                if (!done && copyFile(src, dst, can_clone, file.isSymlink))
+                    done = QFile::remove(src);
+                break;
+            case Method::HardLink:
+                // the link would be to the link, not to the file
+                if (!file.isSymlink) {
+                    fs::create_hard_link(StringUtils::toStdString(src), StringUtils::toStdString(dst), err);
+                    done = !err;
+                }
+                if (!done)
+                    done = copyFile(src, dst, can_clone, file.isSymlink);
+                break;
+            case Method::Copy:
+                done = copyFile(src, dst, can_clone, file.isSymlink);
+                break;
+        }
+        if (!done) {
+            qWarning() << "Failed to migrate" << src << "to" << dst;
+            failed = true;
+        }
+
+        state->files++;
+        state->bytes += file.size;
+        QMutexLocker locker(&state->mutex);
+        state->current = file.relativePath;
     });
-    connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::copyFinished);
-    connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::canceled, this, &DataMigrationTask::copyAborted);
-    m_copyFutureWatcher.setFuture(m_copyFuture);
+
+    if (method == Method::Move) {
+        // the folders that were moved out of, the deepest first, only those left empty can be removed
+        QSet<QString> emptied;
+        for (auto& file : files) {
+            for (auto parent = QFileInfo(file.relativePath).path(); parent != "." && !emptied.contains(parent);
+                 parent = QFileInfo(parent).path())
+                emptied.insert(parent);
+        }
+        auto sorted = emptied.values();
+        std::sort(sorted.begin(), sorted.end(), [](const QString& a, const QString& b) { return a.count('/') > b.count('/'); });
+        QDir source(sourcePath);
+        for (auto& folder : sorted)
+            source.rmdir(folder);
+    }
+
+    return !failed;
 }
 
-void DataMigrationTask::dryRunAborted()
+void DataMigrationTask::updateProgress()
 {
-    emitFailed(tr("Aborted"));
+    QString current;
+    {
+        QMutexLocker locker(&m_state->mutex);
+        current = m_state->current;
+    }
+    setProgress(m_state->bytes.load(), m_bytes);
+    if (current.isEmpty())
+        return;
+
+    // shorten the filename to hopefully fit into one line
+    if (current.length() > 50)
+        current = current.left(20) + "…" + current.right(29);
+    switch (m_method) {
+        case Method::Move:
+            setStatus(tr("Moving %1…").arg(current));
+            break;
+        case Method::HardLink:
+            setStatus(tr("Linking %1…").arg(current));
+            break;
+        case Method::Copy:
+            setStatus(tr("Copying %1…").arg(current));
+            break;
+    }
+    setDetails(tr("%1 of %2 files").arg(m_state->files.load()).arg(m_files));
 }
 
-void DataMigrationTask::copyFinished()
+void DataMigrationTask::migrateFinished()
 {
-    disconnect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::copyFinished);
-    disconnect(&m_copyFutureWatcher, &QFutureWatcher<bool>::canceled, this, &DataMigrationTask::copyAborted);
-
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    if (!m_copyFuture.isValid() || !m_copyFuture.result()) {
-#else
-    if (!m_copyFuture.result()) {
-#endif
+    m_progressTimer.stop();
+    if (m_state->canceled.load()) {
+        emitAborted();
+        return;
+    }
+    updateProgress();
+    if (!m_migrateWatcher.result()) {
         emitFailed(tr("Some paths could not be copied!"));
         return;
     }
 
     emitSucceeded();
 }
-
-void DataMigrationTask::copyAborted()
-{
-    emitFailed(tr("Aborted"));
-}
@@ -4,39 +4,90 @@
 
 #pragma once
 
-#include "FileSystem.h"
 #include "pathmatcher/IPathMatcher.h"
 #include "tasks/Task.h"
 
-#include <QFuture>
 #include <QFutureWatcher>
+#include <QList>
+#include <QMutex>
+#include <QTimer>
+
+#include <atomic>
+#include <memory>
 
 /*
  * Migrate existing data from other MMC-like launchers.
+ *
+ * The source is listed once, with the sizes of the files for the progress to be in bytes, then the files are migrated
+ * several at a time. Copies are reflinks where both ends are on a filesystem that can do it (see FS::canClone()). On the
+ * same filesystem, the files can also be hard linked or moved instead, see methods().
  */
 
 class DataMigrationTask : public Task {
     Q_OBJECT
    public:
-    explicit DataMigrationTask(QObject* parent, const QString& sourcePath, const QString& targetPath, const IPathMatcher::Ptr pathmatcher);
-    ~DataMigrationTask() override = default;
+    enum class Method {
+        // the files of both launchers are apart, whether they're cloned or copied
+        Copy,
+        // the files share their data with those of the other launcher, changing one changes the other
+        HardLink,
+        // the other launcher is left without them
+        Move,
+    };
+
+    explicit DataMigrationTask(QObject* parent,
+                               const QString& sourcePath,
+                               const QString& targetPath,
+                               const IPathMatcher::Ptr pathmatcher,
+                               Method method = Method::Copy);
+    ~DataMigrationTask() override;
+
+    /** How the data can be migrated from `sourcePath` to `targetPath`, Copy always, the others on the same filesystem only. */
+    static QList<Method> methods(const QString& sourcePath, const QString& targetPath);
+
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
 
    protected:
     virtual void executeTask() override;
 
-   protected slots:
-    void dryRunFinished();
-    void dryRunAborted();
-    void copyFinished();
-    void copyAborted();
+   private:
+    struct File {
+        QString relativePath;
+        qint64 size = 0;
+        bool isSymlink = false;
+    };
+
+    // what the workers did so far, shared with them
+    struct State {
+        std::atomic_bool canceled{ false };
+        std::atomic<qint64> files{ 0 };
+        std::atomic<qint64> bytes{ 0 };
+        QMutex mutex;
+        QString current;
+    };
+
+    static QList<File> scan(const QString& sourcePath, const IPathMatcher* matcher);
+    static bool migrate(QString sourcePath, QString targetPath, QList<File> files, Method method, std::shared_ptr<State> state);
+
+    void scanFinished();
+    void migrateFinished();
+    void updateProgress();
 
    private:
-    const QString& m_sourcePath;
-    const QString& m_targetPath;
+    const QString m_sourcePath;
+    const QString m_targetPath;
     const IPathMatcher::Ptr m_pathMatcher;
+    const Method m_method;
+
+    qint64 m_files = 0;
+    qint64 m_bytes = 0;
+    std::shared_ptr<State> m_state = std::make_shared<State>();
+    QFutureWatcher<QList<File>> m_scanWatcher;
+    QFutureWatcher<bool> m_migrateWatcher;
+    QTimer m_progressTimer;
 
-    FS::copy m_copy;
-    int m_toCopy = 0;
-    QFuture<bool> m_copyFuture;
-    QFutureWatcher<bool> m_copyFutureWatcher;
+    static constexpr int s_progress_interval = 100;
 };
@@ -0,0 +1,441 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "DiskUsage.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+#include "Executors.h"
+#include "FileSystem.h"
+#include "InstanceList.h"
+#include "minecraft/ShaderCache.h"
+
+namespace {
+
+constexpr quint32 s_magic = 0x44534b55;  // "DSKU"
+constexpr quint32 s_version = 1;
+constexpr auto s_stream_version = QDataStream::Qt_5_12;
+
+// what the game folders have of what's added and removed outside the game, they're watched besides the game folder
+const QStringList s_watched_folders = { "saves", "mods", "resourcepacks", "texturepacks", "shaderpacks", "screenshots" };
+
+// what the mod loaders keep for the next launches, and make again when it's gone
+const QStringList s_cache_folders = { ".cache", ".fabric", ".mixin.out", ".quilt" };
+
+qint64 folderSize(const QString& path)
+{
+    qint64 total = 0;
+    // the links point at what's counted where it is, if the instance has it at all
+    QDirIterator it(path, QDir::Files | QDir::Hidden | QDir::System | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        total += it.fileInfo().size();
+    }
+    return total;
+}
+
+qint64 removeOlder(const QString& dir, const QDateTime& olderThan, const QStringList& keep)
+{
+    qint64 freed = 0;
+    QDirIterator it(dir, QDir::Files | QDir::Hidden | QDir::System, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        auto info = it.fileInfo();
+        if (keep.contains(info.fileName()) || info.lastModified() >= olderThan)
+            continue;
+        auto size = info.size();
+        if (QFile::remove(info.absoluteFilePath()))
+            freed += size;
+    }
+    return freed;
+}
+
+}  // namespace
+
+qint64 DiskUsage::Usage::total() const
+{
+    qint64 sum = 0;
+    for (auto value : bytes)
+        sum += value;
+    return sum;
+}
+
+DiskUsage::DiskUsage(std::shared_ptr<InstanceList> instances, QString file, QObject* parent)
+    : QObject(parent), m_instances(std::move(instances)), m_file(std::move(file))
+{
+    connect(&m_scanWatcher, &QFutureWatcher<Snapshot>::finished, this, &DiskUsage::scanned);
+    connect(&m_watcher, &FileWatcher::changed, this, [this](const QString& dir, const QStringList&) { folderChanged(dir); });
+    connect(m_instances.get(), &InstanceList::instancesChanged, this, [this] {
+        if (m_started)
+            syncInstances();
+    });
+}
+
+DiskUsage::~DiskUsage()
+{
+    m_scanWatcher.waitForFinished();
+    save();
+}
+
+void DiskUsage::start()
+{
+    if (m_started)
+        return;
+    m_started = true;
+    load();
+    syncInstances();
+}
+
+auto DiskUsage::usage(const QString& instanceId) const -> std::optional<Usage>
+{
+    auto found = m_records.constFind(instanceId);
+    if (found == m_records.constEnd() || !found->measured.isValid())
+        return {};
+    return usageOf(found->snapshot);
+}
+
+QDateTime DiskUsage::measured(const QString& instanceId) const
+{
+    return m_records.value(instanceId).measured;
+}
+
+bool DiskUsage::isMeasuring(const QString& instanceId) const
+{
+    return m_scanning == instanceId || m_queue.contains(instanceId);
+}
+
+void DiskUsage::refresh(const QString& instanceId, bool full)
+{
+    if (!m_records.contains(instanceId))
+        return;
+    // someone waits for this one, it goes before the others
+    m_queue.removeAll(instanceId);
+    m_queue.prepend(instanceId);
+    if (full)
+        m_fullScans.insert(instanceId);
+    next();
+}
+
+void DiskUsage::syncInstances()
+{
+    QSet<QString> ids;
+    for (int i = 0; i < m_instances->count(); i++) {
+        auto instance = m_instances->at(i);
+        auto id = instance->id();
+        ids.insert(id);
+
+        auto& record = m_records[id];
+        auto instance_root = QDir(instance->instanceRoot()).absolutePath();
+        auto game_root = QDir(instance->gameRoot()).absolutePath();
+        bool moved = record.instanceRoot != instance_root || record.gameRoot != game_root;
+        if (!moved && m_runningConnections.contains(id))
+            continue;
+
+        if (moved) {
+            unwatch(id);
+            record.instanceRoot = instance_root;
+            record.gameRoot = game_root;
+        }
+        disconnect(m_runningConnections.take(id));
+        m_runningConnections.insert(id, connect(instance.get(), &BaseInstance::runningStatusChanged, this, [this, id](bool running) {
+            if (!running)
+                refresh(id);
+        }));
+        watch(id);
+        enqueue(id, moved && record.measured.isValid());
+    }
+
+    for (auto& id : m_records.keys()) {
+        if (ids.contains(id))
+            continue;
+        unwatch(id);
+        disconnect(m_runningConnections.take(id));
+        m_records.remove(id);
+        m_queue.removeAll(id);
+        m_fullScans.remove(id);
+        m_dirty = true;
+        emit updated(id);
+    }
+    next();
+}
+
+void DiskUsage::enqueue(const QString& instanceId, bool full)
+{
+    if (full)
+        m_fullScans.insert(instanceId);
+    if (!m_queue.contains(instanceId))
+        m_queue.append(instanceId);
+}
+
+void DiskUsage::next()
+{
+    if (!m_scanning.isEmpty())
+        return;
+    while (!m_queue.isEmpty()) {
+        auto id = m_queue.takeFirst();
+        auto instance = m_instances->getInstanceById(id);
+        // what the game writes changes all the time while it runs, it's measured once it exits
+        if (!instance || instance->isRunning())
+            continue;
+        auto& record = m_records[id];
+        m_scanning = id;
+        m_scanWatcher.setFuture(QtConcurrent::run(Executors::io(), &DiskUsage::scan, record.instanceRoot, record.gameRoot, record.snapshot,
+                                                  m_fullScans.contains(id) || !record.measured.isValid()));
+        m_fullScans.remove(id);
+        return;
+    }
+    save();
+}
+
+void DiskUsage::scanned()
+{
+    auto id = m_scanning;
+    m_scanning.clear();
+    auto found = m_records.find(id);
+    if (found != m_records.end()) {
+        found->snapshot = m_scanWatcher.result();
+        found->measured = QDateTime::currentDateTime();
+        m_dirty = true;
+        // the folders that weren't there before are watched now
+        watch(id);
+        emit updated(id);
+    }
+    next();
+}
+
+void DiskUsage::watch(const QString& instanceId)
+{
+    auto& record = m_records[instanceId];
+    QStringList dirs = { record.gameRoot };
+    for (auto& folder : s_watched_folders)
+        dirs << FS::PathCombine(record.gameRoot, folder);
+    for (auto& dir : dirs) {
+        if (m_watchedDirs.contains(dir) || !QFileInfo(dir).isDir())
+            continue;
+        if (m_watcher.addPath(dir))
+            m_watchedDirs.insert(dir, instanceId);
+    }
+}
+
+void DiskUsage::unwatch(const QString& instanceId)
+{
+    for (auto it = m_watchedDirs.begin(); it != m_watchedDirs.end();) {
+        if (it.value() == instanceId) {
+            m_watcher.removePath(it.key());
+            it = m_watchedDirs.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+void DiskUsage::folderChanged(const QString& dir)
+{
+    auto id = m_watchedDirs.value(dir);
+    if (id.isEmpty() || m_scanning == id)
+        return;
+    enqueue(id, false);
+    next();
+}
+
+auto DiskUsage::categorize(const QString& entry) -> Category
+{
+    auto name = entry.toLower();
+    if (name == "saves")
+        return Category::Worlds;
+    if (name == "mods" || name == "coremods" || name == "nilmods")
+        return Category::Mods;
+    if (name == "resourcepacks" || name == "texturepacks")
+        return Category::ResourcePacks;
+    if (name == "shaderpacks")
+        return Category::ShaderPacks;
+    if (name == "screenshots")
+        return Category::Screenshots;
+    if (name == "logs")
+        return Category::Logs;
+    if (name == "crash-reports")
+        return Category::CrashReports;
+    if (s_cache_folders.contains(name))
+        return Category::Caches;
+    if (name == ShaderCache::s_folder)
+        return Category::ShaderCache;
+    return Category::Other;
+}
+
+QString DiskUsage::categoryName(Category category)
+{
+    switch (category) {
+        case Category::Worlds:
+            return tr("Worlds");
+        case Category::Mods:
+            return tr("Mods");
+        case Category::ResourcePacks:
+            return tr("Resource packs");
+        case Category::ShaderPacks:
+            return tr("Shader packs");
+        case Category::Screenshots:
+            return tr("Screenshots");
+        case Category::Logs:
+            return tr("Logs");
+        case Category::CrashReports:
+            return tr("Crash reports");
+        case Category::Caches:
+            return tr("Caches");
+        case Category::ShaderCache:
+            return tr("Shader cache");
+        case Category::Other:
+            break;
+    }
+    return tr("Other");
+}
+
+auto DiskUsage::scan(const QString& instanceRoot, const QString& gameRoot, const Snapshot& previous, bool full) -> Snapshot
+{
+    struct Folder {
+        QString key;
+        QString path;
+        qint64 bytes = 0;
+    };
+
+    Snapshot snapshot;
+    QList<Folder> folders;
+    auto game_root = QDir(gameRoot).absolutePath();
+    auto list = [&](const QString& root, const QString& prefix) {
+        for (auto& info : QDir(root).entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System)) {
+            if (!prefix.isEmpty() && info.absoluteFilePath() == game_root)
+                continue;
+            auto key = prefix + info.fileName();
+            Entry entry{ info.lastModified().toMSecsSinceEpoch(), 0 };
+            if (info.isDir() && !info.isSymLink()) {
+                auto found = previous.constFind(key);
+                if (!full && found != previous.constEnd() && found->mtime == entry.mtime) {
+                    snapshot.insert(key, *found);
+                    continue;
+                }
+                folders.append({ key, info.absoluteFilePath() });
+            } else if (!info.isSymLink()) {
+                entry.bytes = info.size();
+            }
+            snapshot.insert(key, entry);
+        }
+    };
+    list(game_root, {});
+    if (QDir(instanceRoot).absolutePath() != game_root)
+        list(instanceRoot, "../");
+
+    // the folders of an instance are on the same disk, but the big ones (the worlds, the mods) are walked side by side
+    // with the many small ones
+    QtConcurrent::blockingMap(folders, [](Folder& folder) { folder.bytes = folderSize(folder.path); });
+    for (auto& folder : folders)
+        snapshot[folder.key].bytes = folder.bytes;
+    return snapshot;
+}
+
+auto DiskUsage::usageOf(const Snapshot& snapshot) -> Usage
+{
+    Usage usage;
+    for (auto it = snapshot.cbegin(); it != snapshot.cend(); it++) {
+        // what's in the instance folder besides the game is the launcher's
+        auto category = it.key().startsWith("../") ? Category::Other : categorize(it.key());
+        usage.bytes[int(category)] += it->bytes;
+    }
+    return usage;
+}
+
+qint64 DiskUsage::cleanUp(const QString& gameRoot, Cleanup what, const QDateTime& olderThan)
+{
+    QDir root(gameRoot);
+    switch (what) {
+        case Cleanup::OldLogs:
+            return removeOlder(root.filePath("logs"), olderThan, { "latest.log", "debug.log" });
+        case Cleanup::CrashReports:
+            return removeOlder(root.filePath("crash-reports"), olderThan, {});
+        case Cleanup::Caches:
+        case Cleanup::ShaderCache:
+            break;
+    }
+
+    qint64 freed = 0;
+    auto folders = what == Cleanup::ShaderCache ? QStringList{ ShaderCache::s_folder } : s_cache_folders;
+    for (auto& folder : folders) {
+        auto path = root.filePath(folder);
+        if (!QFileInfo(path).isDir())
+            continue;
+        auto size = folderSize(path);
+        if (FS::deletePath(path))
+            freed += size;
+    }
+    return freed;
+}
+
+void DiskUsage::save()
+{
+    if (!m_dirty)
+        return;
+
+    QSaveFile file(m_file);
+    if (!FS::ensureFilePathExists(m_file) || !file.open(QFile::WriteOnly)) {
+        qWarning() << "Could not open the disk usage cache for writing:" << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(s_stream_version);
+    quint32 count = 0;
+    for (auto& record : m_records)
+        count += record.measured.isValid();
+    out << s_magic << s_version << count;
+    for (auto it = m_records.cbegin(); it != m_records.cend(); it++) {
+        if (!it->measured.isValid())
+            continue;
+        out << it.key() << it->instanceRoot << it->gameRoot << it->measured << quint32(it->snapshot.size());
+        for (auto entry = it->snapshot.cbegin(); entry != it->snapshot.cend(); entry++)
+            out << entry.key() << entry->mtime << entry->bytes;
+    }
+
+    if (!file.commit()) {
+        qWarning() << "Could not write the disk usage cache:" << file.errorString();
+        return;
+    }
+    m_dirty = false;
+}
+
+void DiskUsage::load()
+{
+    QFile file(m_file);
+    if (!file.open(QFile::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setVersion(s_stream_version);
+
+    quint32 magic, version, count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != s_magic || version != s_version)
+        return;
+
+    QHash<QString, Record> records;
+    for (quint32 i = 0; i < count; i++) {
+        QString id;
+        Record record;
+        quint32 entries;
+        in >> id >> record.instanceRoot >> record.gameRoot >> record.measured >> entries;
+        for (quint32 j = 0; j < entries && in.status() == QDataStream::Ok; j++) {
+            QString key;
+            Entry entry;
+            in >> key >> entry.mtime >> entry.bytes;
+            record.snapshot.insert(key, entry);
+        }
+        if (in.status() != QDataStream::Ok) {
+            // the instances will just be measured again
+            m_dirty = true;
+            return;
+        }
+        records.insert(id, record);
+    }
+    m_records = records;
+}
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QDateTime>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QMetaObject>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <array>
+#include <memory>
+#include <optional>
+
+#include "FileWatcher.h"
+
+class InstanceList;
+
+/* What the instances take on the disk, by what it's for: the worlds, the mods, the logs...
+ *
+ * The instances are measured once, each top-level folder of them in parallel, and the sizes are kept in a file so the
+ * next sessions start from them. Only the folders that changed since are measured again: the top-level ones whose
+ * modification time changed, and those the watched folders of the instances say changed meanwhile. Deeper changes
+ * (the regions of a world, a log getting longer) don't show in those, so an instance is measured again in full when
+ * its game exits, which is when most of them happen, or when asked to.
+ */
+class DiskUsage : public QObject {
+    Q_OBJECT
+   public:
+    enum class Category {
+        Worlds,
+        Mods,
+        ResourcePacks,
+        ShaderPacks,
+        Screenshots,
+        Logs,
+        CrashReports,
+        // what the mod loaders make again when it's gone
+        Caches,
+        // what the drivers compiled, when the instance has a shader cache of its own
+        ShaderCache,
+        Other,
+    };
+    static constexpr int s_category_count = int(Category::Other) + 1;
+
+    struct Usage {
+        std::array<qint64, s_category_count> bytes{};
+
+        qint64 of(Category category) const { return bytes[int(category)]; }
+        qint64 total() const;
+    };
+
+    /** A top-level file or folder of an instance, with everything under it. */
+    struct Entry {
+        qint64 mtime = 0;
+        qint64 bytes = 0;
+    };
+    // by their path relative to the game folder, the instance folder being ".."
+    using Snapshot = QHash<QString, Entry>;
+
+    enum class Cleanup {
+        OldLogs,
+        CrashReports,
+        Caches,
+        ShaderCache,
+    };
+
+    DiskUsage(std::shared_ptr<InstanceList> instances, QString file, QObject* parent = nullptr);
+    ~DiskUsage() override;
+
+    /** Loads the sizes of the last session and measures what changed since. */
+    void start();
+
+    /** Empty until the instance was measured once. */
+    std::optional<Usage> usage(const QString& instanceId) const;
+    QDateTime measured(const QString& instanceId) const;
+    bool isMeasuring(const QString& instanceId) const;
+
+    /** Measures the instance again, everything in it when `full`, only the folders that changed otherwise. */
+    void refresh(const QString& instanceId, bool full = true);
+
+    static Category categorize(const QString& entry);
+    static QString categoryName(Category category);
+
+    /** Measures the top-level entries of an instance, those of `previous` that didn't change are taken from it unless
+     * `full`. */
+    static Snapshot scan(const QString& instanceRoot, const QString& gameRoot, const Snapshot& previous = {}, bool full = true);
+    static Usage usageOf(const Snapshot& snapshot);
+
+    /** Deletes what `what` stands for in the game folder, the logs and crash reports only if they were last modified
+     * before `olderThan`, and never the log the game writes to. Returns how many bytes were freed. */
+    static qint64 cleanUp(const QString& gameRoot, Cleanup what, const QDateTime& olderThan = QDateTime::currentDateTime());
+
+   signals:
+    /** The sizes of the instance changed, or it's gone. */
+    void updated(const QString& instanceId);
+
+   private:
+    struct Record {
+        QString instanceRoot;
+        QString gameRoot;
+        QDateTime measured;
+        Snapshot snapshot;
+    };
+
+    void syncInstances();
+    void enqueue(const QString& instanceId, bool full);
+    void next();
+    void scanned();
+    void watch(const QString& instanceId);
+    void unwatch(const QString& instanceId);
+    void folderChanged(const QString& dir);
+
+    void load();
+    void save();
+
+   private:
+    std::shared_ptr<InstanceList> m_instances;
+    QString m_file;
+    bool m_started = false;
+    bool m_dirty = false;
+
+    QHash<QString, Record> m_records;
+    QHash<QString, QMetaObject::Connection> m_runningConnections;
+
+    // one instance at a time, the folders of each are measured in parallel already
+    QStringList m_queue;
+    QSet<QString> m_fullScans;
+    QString m_scanning;
+    QFutureWatcher<Snapshot> m_scanWatcher;
+
+    FileWatcher m_watcher;
+    QHash<QString, QString> m_watchedDirs;
+};
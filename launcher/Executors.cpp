@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Executors.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <chrono>
+#include <functional>
+
+namespace {
+// past a few threads, a disk only gets slower at copying
+constexpr int s_max_io_threads = 4;
+
+auto makePool(int threads) -> QThreadPool*
+{
+    auto pool = new QThreadPool(QCoreApplication::instance());
+    pool->setMaxThreadCount(qMax(1, threads));
+    return pool;
+}
+
+class GroupRunnable : public QRunnable {
+   public:
+    GroupRunnable(std::function<void()> work) : m_work(std::move(work)) { setAutoDelete(true); }
+    void run() override { m_work(); }
+
+   private:
+    std::function<void()> m_work;
+};
+}  // namespace
+
+namespace Executors {
+
+QThreadPool* io()
+{
+    static QThreadPool* s_pool = makePool(qMin(s_max_io_threads, qMax(2, QThread::idealThreadCount())));
+    return s_pool;
+}
+
+QThreadPool* cpu()
+{
+    static QThreadPool* s_pool = makePool(QThread::idealThreadCount());
+    return s_pool;
+}
+
+QThreadPool* background()
+{
+    static QThreadPool* s_pool = [] {
+        auto pool = makePool(1);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)
+        pool->setThreadPriority(QThread::LowPriority);
+#endif
+        return pool;
+    }();
+    return s_pool;
+}
+
+void WorkGroup::State::enter()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    running += 1;
+}
+
+void WorkGroup::State::leave()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    running -= 1;
+    if (running == 0)
+        done.notify_all();
+}
+
+WorkGroup::WorkGroup() : m_state(std::make_shared<State>()) {}
+
+WorkGroup::~WorkGroup()
+{
+    cancel();
+    waitForDone();
+}
+
+void WorkGroup::start(QThreadPool* pool, QRunnable* runnable)
+{
+    auto state = m_state;
+    state->enter();
+    pool->start(new GroupRunnable([state, runnable] {
+        Leave leave{ state };
+        if (!state->canceled)
+            runnable->run();
+    }));
+}
+
+void WorkGroup::cancel()
+{
+    m_state->canceled = true;
+}
+
+bool WorkGroup::isCanceled() const
+{
+    return m_state->canceled;
+}
+
+bool WorkGroup::isBusy() const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->running > 0;
+}
+
+void WorkGroup::waitForDone()
+{
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    while (m_state->running > 0) {
+        if (m_state->done.wait_for(lock, std::chrono::milliseconds(100), [this] { return m_state->running == 0; }))
+            break;
+        // the work may be waiting for this thread to handle something
+        lock.unlock();
+        QCoreApplication::processEvents();
+        lock.lock();
+    }
+}
+
+}  // namespace Executors
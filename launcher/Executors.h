@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QFuture>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+/* The thread pools the work off the GUI thread goes to, so one kind of work doesn't hold up another.
+ *
+ * What copies, extracts or zips whole folders goes to io(), where a few threads are all the disk has use for, and a
+ * long copy still leaves cpu() free for the parsing and hashing the mod lists need. What nobody waits for (icons,
+ * thumbnails, caches) goes to background(), on a single thread of low priority.
+ */
+namespace Executors {
+
+/** Copying, extracting and zipping: a few threads. */
+QThreadPool* io();
+/** Parsing and hashing: a thread per core. */
+QThreadPool* cpu();
+/** What can take its time: a single thread, of low priority when Qt allows it. */
+QThreadPool* background();
+
+/* The work one owner started on the pools, that it can cancel and wait for without waiting for everyone else's.
+ *
+ * Canceling only makes what didn't start yet not run, and tells what runs already (see isCanceled()) so it can
+ * stop early. The group waits for its work when it goes away, so that work can use its owner until then.
+ */
+class WorkGroup {
+   public:
+    WorkGroup();
+    ~WorkGroup();
+
+    WorkGroup(const WorkGroup&) = delete;
+    WorkGroup& operator=(const WorkGroup&) = delete;
+
+    /** Runs `runnable` on `pool` unless the group gets canceled first. The group doesn't own it. */
+    void start(QThreadPool* pool, QRunnable* runnable);
+
+    /** Runs `work` on `pool`. It runs even when the group gets canceled first, it's up to it to check. */
+    template <typename Work>
+    auto run(QThreadPool* pool, Work work) -> QFuture<decltype(work())>
+    {
+        auto state = m_state;
+        state->enter();
+        return QtConcurrent::run(pool, [state, work] {
+            Leave leave{ state };
+            return work();
+        });
+    }
+
+    void cancel();
+    bool isCanceled() const;
+
+    /** Whether anything the group started is still running or waiting to. */
+    bool isBusy() const;
+    /** Waits for what the group started, handling the events of the calling thread meanwhile. */
+    void waitForDone();
+
+   private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable done;
+        int running = 0;
+        std::atomic_bool canceled{ false };
+
+        void enter();
+        void leave();
+    };
+    struct Leave {
+        std::shared_ptr<State> state;
+        ~Leave() { state->leave(); }
+    };
+
+    std::shared_ptr<State> m_state;
+};
+
+}  // namespace Executors
@@ -0,0 +1,412 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ExportTreeModel.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QLocale>
+#include <algorithm>
+
+#include "MMCZip.h"
+#include "StringUtils.h"
+#include "pathmatcher/PathRuleMatcher.h"
+
+ExportTreeModel::ExportTreeModel(QString root, QObject* parent)
+    : QAbstractItemModel(parent), m_root_path(root), m_root(std::make_unique<Node>())
+{
+    m_root->info = QFileInfo(root);
+    m_root->children = list(m_root.get());
+    m_root->populated = true;
+}
+
+ExportTreeModel::~ExportTreeModel() = default;
+
+ExportTreeModel::Node* ExportTreeModel::nodeFor(const QModelIndex& index) const
+{
+    if (!index.isValid())
+        return m_root.get();
+    return static_cast<Node*>(index.internalPointer());
+}
+
+QModelIndex ExportTreeModel::indexFor(Node* node, int column) const
+{
+    if (node == m_root.get())
+        return QModelIndex();
+    return createIndex(node->row, column, node);
+}
+
+ExportTreeModel::Node* ExportTreeModel::nodeFor(const QString& path) const
+{
+    auto node = m_root.get();
+    for (auto& part : path.split('/', Qt::SkipEmptyParts)) {
+        auto found = std::find_if(node->children.begin(), node->children.end(),
+                                  [&part](const std::unique_ptr<Node>& child) { return child->info.fileName() == part; });
+        if (found == node->children.end())
+            return nullptr;
+        node = found->get();
+    }
+    return node;
+}
+
+QModelIndex ExportTreeModel::index(int row, int column, const QModelIndex& parent) const
+{
+    auto node = nodeFor(parent);
+    if (row < 0 || row >= static_cast<int>(node->children.size()) || column < 0 || column >= columnCount())
+        return QModelIndex();
+    return createIndex(row, column, node->children[row].get());
+}
+
+QModelIndex ExportTreeModel::parent(const QModelIndex& index) const
+{
+    if (!index.isValid())
+        return QModelIndex();
+    return indexFor(nodeFor(index)->parent);
+}
+
+int ExportTreeModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.column() > 0)
+        return 0;
+    return static_cast<int>(nodeFor(parent)->children.size());
+}
+
+int ExportTreeModel::columnCount(const QModelIndex&) const
+{
+    // name and size
+    return 2;
+}
+
+bool ExportTreeModel::hasChildren(const QModelIndex& parent) const
+{
+    if (parent.column() > 0)
+        return false;
+    auto node = nodeFor(parent);
+    if (!node->populated)
+        return node->info.isDir();
+    return !node->children.empty();
+}
+
+bool ExportTreeModel::canFetchMore(const QModelIndex& parent) const
+{
+    auto node = nodeFor(parent);
+    return !node->populated && node->info.isDir();
+}
+
+void ExportTreeModel::fetchMore(const QModelIndex& parent)
+{
+    auto node = nodeFor(parent);
+    if (node->populated)
+        return;
+    auto children = list(node);
+    node->populated = true;
+    if (children.empty())
+        return;
+
+    beginInsertRows(parent, 0, static_cast<int>(children.size()) - 1);
+    node->children = std::move(children);
+    endInsertRows();
+}
+
+std::vector<std::unique_ptr<ExportTreeModel::Node>> ExportTreeModel::list(Node* node) const
+{
+    std::vector<std::unique_ptr<Node>> children;
+    QDir dir(node->info.absoluteFilePath());
+    for (auto& info : dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::AllDirs | QDir::Hidden)) {
+        auto child = std::make_unique<Node>();
+        child->parent = node;
+        child->info = info;
+        child->path = node->path.isEmpty() ? info.fileName() : node->path + '/' + info.fileName();
+        child->state = stateFor(child.get());
+        children.push_back(std::move(child));
+    }
+
+    std::stable_sort(children.begin(), children.end(),
+                     [this](const std::unique_ptr<Node>& left, const std::unique_ptr<Node>& right) { return lessThan(left.get(), right.get()); });
+    for (size_t i = 0; i < children.size(); i++)
+        children[i]->row = static_cast<int>(i);
+    return children;
+}
+
+Qt::CheckState ExportTreeModel::stateFor(const Node* node) const
+{
+    // what's in a folder that is fully checked or unchecked is too, no need to look it up
+    auto parent = node->parent;
+    if (parent != m_root.get() && parent->state != Qt::PartiallyChecked)
+        return parent->state;
+
+    if (m_blocked.covers(node->path))
+        return Qt::Unchecked;
+    if (m_blocked.exists(node->path))
+        return Qt::PartiallyChecked;
+    return Qt::Checked;
+}
+
+void ExportTreeModel::updateState(Node* node)
+{
+    if (node == m_root.get())
+        return;
+
+    Qt::CheckState state = Qt::Checked;
+    if (m_blocked.covers(node->path))
+        state = Qt::Unchecked;
+    else if (m_blocked.exists(node->path))
+        state = Qt::PartiallyChecked;
+
+    if (node->state == state)
+        return;
+    node->state = state;
+    auto index = indexFor(node);
+    emit dataChanged(index, index, { Qt::CheckStateRole });
+}
+
+void ExportTreeModel::updateStates(Node* node)
+{
+    // the node and everything listed under it, the folders before what's in them
+    updateState(node);
+    std::vector<Node*> todo{ node };
+    while (!todo.empty()) {
+        auto folder = todo.back();
+        todo.pop_back();
+        for (auto& child : folder->children) {
+            auto state = stateFor(child.get());
+            if (child->state != state) {
+                child->state = state;
+                auto index = indexFor(child.get());
+                emit dataChanged(index, index, { Qt::CheckStateRole });
+            }
+            if (!child->children.empty())
+                todo.push_back(child.get());
+        }
+    }
+
+    // and the folders it is in
+    for (auto up = node->parent; up && up != m_root.get(); up = up->parent)
+        updateState(up);
+}
+
+QVariant ExportTreeModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+    auto node = nodeFor(index);
+
+    if (index.column() == 0) {
+        switch (role) {
+            case Qt::DisplayRole:
+            case Qt::EditRole:
+                return node->info.fileName();
+            case Qt::DecorationRole:
+                if (m_icons)
+                    return m_icons->icon(node->info);
+                return QVariant();
+            case Qt::CheckStateRole:
+                return node->state;
+            default:
+                return QVariant();
+        }
+    }
+
+    if (index.column() == 1) {
+        switch (role) {
+            case Qt::DisplayRole:
+                if (node->info.isDir())
+                    return QVariant();
+                return QLocale().formattedDataSize(node->info.size());
+            case Qt::TextAlignmentRole:
+                return int(Qt::AlignRight | Qt::AlignVCenter);
+            default:
+                return QVariant();
+        }
+    }
+    return QVariant();
+}
+
+QVariant ExportTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    switch (section) {
+        case 0:
+            return tr("Name");
+        case 1:
+            return tr("Size");
+        default:
+            return QVariant();
+    }
+}
+
+Qt::ItemFlags ExportTreeModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+
+    Qt::ItemFlags flags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    if (index.column() == 0) {
+        flags |= Qt::ItemIsUserCheckable;
+        if (nodeFor(index)->info.isDir())
+            flags |= Qt::ItemIsAutoTristate;
+    }
+    return flags;
+}
+
+bool ExportTreeModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (!index.isValid() || index.column() != 0 || role != Qt::CheckStateRole)
+        return false;
+    return setFilterState(nodeFor(index), static_cast<Qt::CheckState>(value.toInt()));
+}
+
+bool ExportTreeModel::setFilterState(Node* node, Qt::CheckState state)
+{
+    if (state == Qt::Unchecked) {
+        // blocking a path, which also takes care of the blocked paths under it
+        m_blocked.insert(node->path);
+        updateStates(node);
+        return true;
+    }
+
+    if (m_blocked.remove(node->path)) {
+        updateStates(node);
+        return true;
+    }
+
+    auto cover = m_blocked.cover(node->path);
+    auto cover_node = cover.isNull() ? nullptr : nodeFor(cover);
+    if (!cover_node)
+        return false;
+    qDebug() << "Blocked by cover" << cover;
+
+    // uncover, and block everything from the cover down to the node except the way to it
+    m_blocked.remove(cover);
+    for (auto on_the_way = node; on_the_way != cover_node; on_the_way = on_the_way->parent) {
+        for (auto& sibling : on_the_way->parent->children) {
+            if (sibling.get() != on_the_way)
+                m_blocked.insert(sibling->path);
+        }
+    }
+    updateStates(cover_node);
+    return true;
+}
+
+bool ExportTreeModel::shouldExpand(const QModelIndex& index) const
+{
+    auto found = m_blocked.find(nodeFor(index)->path);
+    return found && !found->leaf();
+}
+
+void ExportTreeModel::setBlockedPaths(QStringList paths)
+{
+    beginResetModel();
+    m_blocked.clear();
+    m_blocked.insert(paths);
+    // the listed folders stay listed, only their states change
+    std::vector<Node*> todo{ m_root.get() };
+    while (!todo.empty()) {
+        auto folder = todo.back();
+        todo.pop_back();
+        for (auto& child : folder->children) {
+            child->state = stateFor(child.get());
+            todo.push_back(child.get());
+        }
+    }
+    endResetModel();
+}
+
+void ExportTreeModel::blockPath(const QString& path)
+{
+    m_blocked.insert(path);
+    if (auto node = nodeFor(path))
+        updateStates(node);
+}
+
+IPathMatcher::Ptr ExportTreeModel::blockedMatcher() const
+{
+    return std::make_shared<PathRuleMatcher>(m_blocked);
+}
+
+bool ExportTreeModel::collectFiles(QFileInfoList* files) const
+{
+    IPathMatcher::Ptr blocked;
+    std::vector<const Node*> todo{ m_root.get() };
+    while (!todo.empty()) {
+        auto folder = todo.back();
+        todo.pop_back();
+        for (auto& child : folder->children) {
+            if (child->state == Qt::Unchecked)
+                continue;
+            if (!child->info.isDir()) {
+                // like MMCZip::collectFileListRecursively, which doesn't list the hidden files
+                if (!child->info.isHidden())
+                    files->append(child->info);
+                continue;
+            }
+            if (child->populated) {
+                todo.push_back(child.get());
+                continue;
+            }
+
+            // a folder that was never expanded, only the ones with something blocked in them need the filter
+            MMCZip::FilterFunction filter;
+            if (child->state == Qt::PartiallyChecked) {
+                if (!blocked)
+                    blocked = blockedMatcher();
+                filter = [blocked](const QString& path) { return blocked->matches(path); };
+            }
+            if (!MMCZip::collectFileListRecursively(m_root_path, child->info.absoluteFilePath(), files, filter))
+                return false;
+        }
+    }
+    return true;
+}
+
+bool ExportTreeModel::lessThan(const Node* left, const Node* right) const
+{
+    // the folders always come first
+    auto left_dir = left->info.isDir();
+    auto right_dir = right->info.isDir();
+    if (left_dir != right_dir)
+        return left_dir;
+
+    auto names = [left, right] { return StringUtils::naturalCompare(left->info.fileName(), right->info.fileName(), Qt::CaseInsensitive); };
+    int compared;
+    if (m_sort_column == 1 && !left_dir && left->info.size() != right->info.size())
+        compared = left->info.size() < right->info.size() ? -1 : 1;
+    else
+        compared = names();
+    return m_sort_order == Qt::AscendingOrder ? compared < 0 : compared > 0;
+}
+
+void ExportTreeModel::sortChildren(Node* node)
+{
+    std::stable_sort(node->children.begin(), node->children.end(),
+                     [this](const std::unique_ptr<Node>& left, const std::unique_ptr<Node>& right) { return lessThan(left.get(), right.get()); });
+    for (size_t i = 0; i < node->children.size(); i++) {
+        node->children[i]->row = static_cast<int>(i);
+        sortChildren(node->children[i].get());
+    }
+}
+
+void ExportTreeModel::sort(int column, Qt::SortOrder order)
+{
+    if (column == m_sort_column && order == m_sort_order)
+        return;
+
+    emit layoutAboutToBeChanged();
+    m_sort_column = column;
+    m_sort_order = order;
+
+    auto persistent = persistentIndexList();
+    std::vector<std::pair<Node*, int>> nodes;
+    nodes.reserve(persistent.size());
+    for (auto& index : persistent)
+        nodes.emplace_back(nodeFor(index), index.column());
+
+    sortChildren(m_root.get());
+
+    QModelIndexList moved;
+    moved.reserve(persistent.size());
+    for (auto& [node, node_column] : nodes)
+        moved.append(indexFor(node, node_column));
+    changePersistentIndexList(persistent, moved);
+    emit layoutChanged();
+}
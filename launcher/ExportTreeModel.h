@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QFileIconProvider>
+#include <QFileInfo>
+#include <memory>
+#include <vector>
+
+#include "SeparatorPrefixTree.h"
+#include "pathmatcher/IPathMatcher.h"
+
+/* The files of a folder to pick what goes in an export, with the paths that are left out.
+ *
+ * A folder is only listed when it gets expanded, and the check state of every listed file and folder is worked
+ * out once and kept. Checking or unchecking something only updates what's under it and the folders it is in.
+ * The files to export come from the listed folders, only the ones that never got expanded are searched.
+ */
+class ExportTreeModel : public QAbstractItemModel {
+    Q_OBJECT
+
+   public:
+    ExportTreeModel(QString root, QObject* parent);
+    ~ExportTreeModel() override;
+
+    void setIconProvider(QFileIconProvider* provider) { m_icons = provider; }
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& index) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    /** Whether something under the folder is left out, so it should be shown expanded. */
+    bool shouldExpand(const QModelIndex& index) const;
+
+    void setBlockedPaths(QStringList paths);
+    /** Leaves out the path, relative to the root, and everything under it. */
+    void blockPath(const QString& path);
+
+    const SeparatorPrefixTree<'/'>& blockedPaths() const { return m_blocked; }
+    // the blocked paths as they are now, to match a lot of paths against
+    IPathMatcher::Ptr blockedMatcher() const;
+
+    /** The files that are checked, for MMCZip::compressDirFiles. */
+    bool collectFiles(QFileInfoList* files) const;
+
+   private:
+    struct Node {
+        Node* parent = nullptr;
+        int row = 0;
+        QFileInfo info;
+        // relative to the root, empty for the root itself
+        QString path;
+        bool populated = false;
+        Qt::CheckState state = Qt::Checked;
+        std::vector<std::unique_ptr<Node>> children;
+    };
+
+    Node* nodeFor(const QModelIndex& index) const;
+    QModelIndex indexFor(Node* node, int column = 0) const;
+    Node* nodeFor(const QString& path) const;
+
+    std::vector<std::unique_ptr<Node>> list(Node* node) const;
+    Qt::CheckState stateFor(const Node* node) const;
+    void updateStates(Node* node);
+    void updateState(Node* node);
+    bool setFilterState(Node* node, Qt::CheckState state);
+
+    bool lessThan(const Node* left, const Node* right) const;
+    void sortChildren(Node* node);
+
+   private:
+    const QString m_root_path;
+    std::unique_ptr<Node> m_root;
+    SeparatorPrefixTree<'/'> m_blocked;
+    QFileIconProvider* m_icons = nullptr;
+    int m_sort_column = 0;
+    Qt::SortOrder m_sort_order = Qt::AscendingOrder;
+};
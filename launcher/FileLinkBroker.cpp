@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "FileLinkBroker.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+#include "BuildConfig.h"
+#include "StringUtils.h"
+#include "filelink/FileLinkProtocol.h"
+
+FileLinkBroker* FileLinkBroker::instance()
+{
+    static FileLinkBroker* s_instance = [] {
+        // the links are asked for from the tasks' threads too
+        auto broker = new FileLinkBroker;
+        broker->moveToThread(QCoreApplication::instance()->thread());
+        return broker;
+    }();
+    return s_instance;
+}
+
+FileLinkBroker::FileLinkBroker() : QObject()
+{
+    qRegisterMetaType<FS::LinkResult>();
+    // the program exits when it's disconnected
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this] {
+        if (m_socket)
+            m_socket->disconnectFromServer();
+    });
+}
+
+void FileLinkBroker::submit(quint32 batch, const QList<FS::LinkPair>& links, bool hardLinks)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending.append({ batch, links, hardLinks });
+    }
+    QMetaObject::invokeMethod(this, &FileLinkBroker::dispatch, Qt::QueuedConnection);
+}
+
+void FileLinkBroker::dispatch()
+{
+    if (!m_socket) {
+        // the batches are sent once it connected
+        if (!m_process)
+            start();
+        return;
+    }
+
+    QList<Batch> pending;
+    {
+        QMutexLocker locker(&m_mutex);
+        pending.swap(m_pending);
+    }
+    for (auto& batch : pending) {
+        qDebug() << "Sending" << batch.links.size() << "links to make with privileges, batch" << batch.id;
+        m_running.insert(batch.id);
+        FileLinkProtocol::write(m_socket, FileLinkProtocol::batch(batch.id, batch.hardLinks, batch.links));
+    }
+    m_socket->flush();
+}
+
+void FileLinkBroker::start()
+{
+    auto serverName = BuildConfig.LAUNCHER_APP_BINARY_NAME + "_filelink_server" + StringUtils::getRandomAlphaNumeric();
+    m_server = new QLocalServer(this);
+    connect(m_server, &QLocalServer::newConnection, this, &FileLinkBroker::connected);
+    qDebug() << "Listening on pipe" << serverName;
+    if (!m_server->listen(serverName)) {
+        qWarning() << "Unable to start local pipe server on" << serverName << ":" << m_server->errorString();
+        stopped();
+        return;
+    }
+
+    m_process = new ExternalLinkFileProcess(serverName, this);
+    connect(m_process, &ExternalLinkFileProcess::processExited, this, &FileLinkBroker::stopped);
+    connect(m_process, &ExternalLinkFileProcess::finished, m_process, &QObject::deleteLater);
+    m_process->start();
+}
+
+void FileLinkBroker::connected()
+{
+    auto socket = m_server->nextPendingConnection();
+    if (m_socket) {
+        qWarning() << "Refusing another connection to the link server";
+        socket->abort();
+        return;
+    }
+    qDebug() << "Link program connected";
+    m_socket = socket;
+    connect(m_socket, &QLocalSocket::readyRead, this, &FileLinkBroker::readMessages);
+    dispatch();
+}
+
+void FileLinkBroker::readMessages()
+{
+    QDataStream in(m_socket);
+    in.setVersion(QDataStream::Qt_5_6);
+    QByteArray message;
+    while (FileLinkProtocol::read(in, message)) {
+        QDataStream body(message);
+        body.setVersion(QDataStream::Qt_5_6);
+        quint8 type;
+        quint32 batch;
+        body >> type >> batch;
+
+        if (type == quint8(FileLinkProtocol::Message::Result)) {
+            FS::LinkResult result;
+            qint32 err_value;
+            body >> result.src >> result.dst >> result.err_msg >> err_value;
+            result.err_value = err_value;
+            emit linked(batch, result);
+        } else if (type == quint8(FileLinkProtocol::Message::Done)) {
+            m_running.remove(batch);
+            emit batchFinished(batch, true);
+        } else {
+            qWarning() << "Unknown message from the link program:" << type;
+        }
+    }
+}
+
+void FileLinkBroker::stopped()
+{
+    qDebug() << "Link program exited";
+    // what it said last
+    if (m_socket)
+        readMessages();
+    if (m_server) {
+        // with the connection to it
+        m_server->deleteLater();
+        m_server = nullptr;
+    }
+    m_socket = nullptr;
+    m_process = nullptr;
+
+    QList<Batch> pending;
+    {
+        QMutexLocker locker(&m_mutex);
+        pending.swap(m_pending);
+    }
+    auto running = m_running;
+    m_running.clear();
+    for (auto batch : running)
+        emit batchFinished(batch, false);
+    for (auto& batch : pending)
+        emit batchFinished(batch.id, false);
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+
+#include <atomic>
+
+#include "FileSystem.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+/* Makes the links the launcher can't, through one elevated filelink program for the whole session.
+ *
+ * Windows only lets elevated programs make symbolic links, unless developer mode is on. Starting the program for each
+ * batch of links would ask the user for elevation every time, so it's started for the first batch and then kept,
+ * serving the next batches on the same connection (see FileLinkProtocol). It exits with the launcher. If the user
+ * declines, or the program goes away, the batches it had are finished without their results, and the next batch
+ * starts it again.
+ */
+class FileLinkBroker : public QObject {
+    Q_OBJECT
+   public:
+    /** The broker of the session, on the GUI thread. */
+    static FileLinkBroker* instance();
+
+    /** An id for a batch, to connect to the signals with before submitting it. From any thread. */
+    quint32 newBatch() { return m_next_batch++; }
+    /** Has the links of `batch` made. From any thread. */
+    void submit(quint32 batch, const QList<FS::LinkPair>& links, bool hardLinks);
+
+   signals:
+    void linked(quint32 batch, const FS::LinkResult& result);
+    /** `complete` is false when the program went away before making all of them. */
+    void batchFinished(quint32 batch, bool complete);
+
+   private:
+    struct Batch {
+        quint32 id;
+        QList<FS::LinkPair> links;
+        bool hardLinks;
+    };
+
+    FileLinkBroker();
+
+    void dispatch();
+    void start();
+    void connected();
+    void readMessages();
+    void stopped();
+
+   private:
+    std::atomic<quint32> m_next_batch{ 1 };
+
+    // submitted, not sent yet
+    QMutex m_mutex;
+    QList<Batch> m_pending;
+    // sent, not done yet
+    QSet<quint32> m_running;
+
+    QLocalServer* m_server = nullptr;
+    QLocalSocket* m_socket = nullptr;
+    ExternalLinkFileProcess* m_process = nullptr;
+};
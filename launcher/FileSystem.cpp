@@ -42,17 +42,23 @@
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
+#include <QMutex>
 #include <QSaveFile>
 #include <QStandardPaths>
 #include <QStorageInfo>
 #include <QTextStream>
 #include <QUrl>
+#include <QtConcurrentMap>
 #include <QtNetwork>
+#include <atomic>
+#include <memory>
 #include <system_error>
 
 #include "DesktopServices.h"
+#include "FileLinkBroker.h"
 #include "StringUtils.h"
 
 #if defined Q_OS_WIN32
@@ -99,15 +105,18 @@ namespace fs = ghc::filesystem;
 #if defined(Q_OS_LINUX)
 #include <errno.h>
 #include <fcntl.h> /* Definition of FICLONE* constants */
+#include <linux/falloc.h>
 #include <linux/fs.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 #elif defined(Q_OS_MACOS) || defined(Q_OS_FREEBSD) || defined(Q_OS_OPENBSD)
+#include <fcntl.h>
 #include <sys/attr.h>
 #include <sys/clonefile.h>
 #elif defined(Q_OS_WIN)
 // winbtrfs clone vs rundll32 shellbtrfs.dll,ReflinkCopy
 #include <fileapi.h>
+#include <io.h>
 #include <stdio.h>
 #include <tchar.h>
 #include <windows.h>
@@ -219,6 +228,30 @@ bool updateTimestamp(const QString& filename)
 #endif
 }
 
+bool preallocate(QFileDevice& file, qint64 size)
+{
+    int fd = file.handle();
+    if (fd < 0 || size <= 0)
+        return false;
+#if defined(Q_OS_LINUX)
+    return fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, size) == 0;
+#elif defined(Q_OS_MACOS)
+    // in one piece if there is, wherever there's room otherwise
+    fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, size, 0 };
+    if (fcntl(fd, F_PREALLOCATE, &store) == 0)
+        return true;
+    store.fst_flags = F_ALLOCATEALL;
+    return fcntl(fd, F_PREALLOCATE, &store) == 0;
+#elif defined(Q_OS_WIN)
+    FILE_ALLOCATION_INFO info;
+    info.AllocationSize.QuadPart = size;
+    auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    return SetFileInformationByHandle(handle, FileAllocationInfo, &info, sizeof(info));
+#else
+    return false;
+#endif
+}
+
 bool ensureFilePathExists(QString filenamepath)
 {
     QFileInfo a(filenamepath);
@@ -237,6 +270,12 @@ bool ensureFolderPathExists(QString foldernamepath)
     return success;
 }
 
+bool isCloneUnsupported(const std::error_code& err)
+{
+    return err == std::errc::not_supported || err == std::errc::operation_not_supported || err == std::errc::cross_device_link ||
+           err == std::errc::invalid_argument || err == std::errc::function_not_supported;
+}
+
 /**
  * @brief Copies a directory and it's contents from src to dest
  * @param offset subdirectory form src to copy to dest
@@ -255,51 +294,106 @@ bool copy::operator()(const QString& offset, bool dryRun)
     auto src = PathCombine(m_src.absolutePath(), offset);
     auto dst = PathCombine(m_dst.absolutePath(), offset);
 
-    std::error_code err;
-
     fs::copy_options opt = copy_opts::none;
 
     // The default behavior is to follow symlinks
     if (!m_followSymlinks)
         opt |= copy_opts::copy_symlinks;
 
-    // Function that'll do the actual copying
-    auto copy_file = [&](QString src_path, QString relative_dst_path) {
+    struct Job {
+        QString src_path;
+        QString relative_path;
+        bool is_symlink;
+    };
+    QVector<Job> jobs;
+
+    auto addFile = [&](const QFileInfo& src_info, QString relative_dst_path) {
         if (m_matcher && (m_matcher->matches(relative_dst_path) != m_whitelist))
             return;
-
-        auto dst_path = PathCombine(dst, relative_dst_path);
-        if (!dryRun) {
-            ensureFilePathExists(dst_path);
-            fs::copy(StringUtils::toStdString(src_path), StringUtils::toStdString(dst_path), opt, err);
-        }
-        if (err) {
-            qWarning() << "Failed to copy files:" << QString::fromStdString(err.message());
-            qDebug() << "Source file:" << src_path;
-            qDebug() << "Destination file:" << dst_path;
-        }
-        m_copied++;
-        emit fileCopied(relative_dst_path);
+        jobs.append({ src_info.filePath(), std::move(relative_dst_path), src_info.isSymLink() });
     };
 
     // We can't use copy_opts::recursive because we need to take into account the
     // blacklisted paths, so we iterate over the source directory, and if there's no blacklist
     // match, we copy the file.
+    // Everything gets listed before copying anything, so that the copies can run at the same time.
+    // Folders the blacklist covers whole aren't looked into at all.
     QDir src_dir(src);
-    QDirIterator source_it(src, QDir::Filter::Files | QDir::Filter::Hidden, QDirIterator::Subdirectories);
-
-    while (source_it.hasNext()) {
-        auto src_path = source_it.next();
-        auto relative_path = src_dir.relativeFilePath(src_path);
-
-        copy_file(src_path, relative_path);
+    QStringList folders_to_list{ src };
+    while (!folders_to_list.isEmpty()) {
+        QDir folder(folders_to_list.takeLast());
+        for (auto& info : folder.entryInfoList(QDir::Filter::Files | QDir::Filter::Hidden))
+            addFile(info, src_dir.relativeFilePath(info.filePath()));
+        for (auto& info : folder.entryInfoList(QDir::Filter::Dirs | QDir::Filter::Hidden | QDir::Filter::NoDotAndDotDot | QDir::Filter::NoSymLinks)) {
+            if (m_matcher && !m_whitelist && m_matcher->matchesFolder(src_dir.relativeFilePath(info.filePath())))
+                continue;
+            folders_to_list.append(info.filePath());
+        }
     }
 
     // If the root src is not a directory, the previous iterator won't run.
     if (!fs::is_directory(StringUtils::toStdString(src)))
-        copy_file(src, "");
+        addFile(QFileInfo(src), "");
 
-    return err.value() == 0;
+    if (dryRun) {
+        m_copied = jobs.size();
+        return true;
+    }
+
+    // Workers creating the folders themselves would race each other for the common parts of their paths
+    QSet<QString> folders;
+    for (auto& job : jobs)
+        folders.insert(QFileInfo(PathCombine(dst, job.relative_path)).absolutePath());
+    for (auto& folder : folders)
+        ensureFolderPathExists(folder);
+
+    // Cloning is only worth trying when both ends are on the same filesystem that can do it, which is checked once
+    // and not for every file like clone_file() does
+    std::atomic_bool can_clone{ !jobs.isEmpty() && canClone(src, dst) };
+
+    std::atomic_bool failed{ false };
+    QMutex progress_mutex;
+    QElapsedTimer since_progress;
+    since_progress.start();
+
+    QtConcurrent::blockingMap(jobs, [&](const Job& job) {
+        auto dst_path = PathCombine(dst, job.relative_path);
+
+        std::error_code err;
+        bool cloned = false;
+        if (can_clone && (m_followSymlinks || !job.is_symlink)) {
+            // a clone can't replace an existing file
+            QFile::remove(dst_path);
+            cloned = clone_file_data(job.src_path, dst_path, err);
+            if (!cloned) {
+                // the empty file a failed clone leaves would make the copy fail too
+                QFile::remove(dst_path);
+                // the filesystem is one that can, but not this one of them (XFS without reflink, ZFS without block cloning):
+                // the other files would only fail the same way
+                if (isCloneUnsupported(err) && can_clone.exchange(false))
+                    qDebug() << "Cloning isn't supported from" << src << "to" << dst << ", copying instead:" << QString::fromStdString(err.message());
+            }
+            err.clear();
+        }
+        if (!cloned)
+            fs::copy(StringUtils::toStdString(job.src_path), StringUtils::toStdString(dst_path), opt, err);
+        if (err) {
+            qWarning() << "Failed to copy files:" << QString::fromStdString(err.message());
+            qDebug() << "Source file:" << job.src_path;
+            qDebug() << "Destination file:" << dst_path;
+            failed = true;
+        }
+
+        // Don't flood the receivers with a signal for every small file, and don't emit them from several threads at once
+        auto copied = ++m_copied;
+        QMutexLocker locker(&progress_mutex);
+        if (copied == jobs.size() || since_progress.elapsed() >= s_progress_interval) {
+            since_progress.restart();
+            emit fileCopied(job.relative_path);
+        }
+    });
+
+    return !failed;
 }
 
 /// qDebug print support for the LinkPair struct
@@ -434,98 +528,32 @@ void create_link::runPrivileged(const QString& offset)
     m_path_results.clear();
     m_links_to_make.clear();
 
-    bool gotResults = false;
-
     make_link_list(offset);
 
-    QString serverName = BuildConfig.LAUNCHER_APP_BINARY_NAME + "_filelink_server" + StringUtils::getRandomAlphaNumeric();
-
-    connect(&m_linkServer, &QLocalServer::newConnection, this, [&]() {
-        qDebug() << "Client connected, sending out pairs";
-        // construct block of data to send
-        QByteArray block;
-        QDataStream out(&block, QIODevice::WriteOnly);
-
-        qint32 blocksize = quint32(sizeof(quint32));
-        for (auto link : m_links_to_make) {
-            blocksize += quint32(link.src.size());
-            blocksize += quint32(link.dst.size());
-        }
-        qDebug() << "About to write block of size:" << blocksize;
-        out << blocksize;
-
-        out << quint32(m_links_to_make.length());
-        for (auto link : m_links_to_make) {
-            out << link.src;
-            out << link.dst;
+    auto broker = FileLinkBroker::instance();
+    auto batch = broker->newBatch();
+    auto linked = connect(broker, &FileLinkBroker::linked, this, [this, batch](quint32 id, const LinkResult& result) {
+        if (id != batch)
+            return;
+        if (result.err_value) {
+            qDebug() << "privileged link fail" << result.src << "to" << result.dst << "code" << result.err_value << result.err_msg;
+            emit linkFailed(result.src, result.dst, result.err_msg, result.err_value);
+        } else {
+            qDebug() << "privileged link success" << result.src << "to" << result.dst;
+            m_linked++;
+            emit fileLinked(result.src, result.dst);
         }
-
-        QLocalSocket* clientConnection = m_linkServer.nextPendingConnection();
-        connect(clientConnection, &QLocalSocket::disconnected, clientConnection, &QLocalSocket::deleteLater);
-
-        connect(clientConnection, &QLocalSocket::readyRead, this, [&, clientConnection]() {
-            QDataStream in;
-            quint32 blockSize = 0;
-            in.setDevice(clientConnection);
-
-            qDebug() << "Reading path results from client";
-            qDebug() << "bytes available" << clientConnection->bytesAvailable();
-
-            // Relies on the fact that QDataStream serializes a quint32 into
-            // sizeof(quint32) bytes
-            if (clientConnection->bytesAvailable() < (int)sizeof(quint32))
-                return;
-            qDebug() << "reading block size";
-            in >> blockSize;
-
-            qDebug() << "blocksize is" << blockSize;
-            qDebug() << "bytes available" << clientConnection->bytesAvailable();
-            if (clientConnection->bytesAvailable() < blockSize || in.atEnd())
-                return;
-
-            quint32 numResults;
-            in >> numResults;
-            qDebug() << "numResults" << numResults;
-
-            for (quint32 i = 0; i < numResults; i++) {
-                FS::LinkResult result;
-                in >> result.src;
-                in >> result.dst;
-                in >> result.err_msg;
-                qint32 err_value;
-                in >> err_value;
-                result.err_value = err_value;
-                if (result.err_value) {
-                    qDebug() << "privileged link fail" << result.src << "to" << result.dst << "code" << result.err_value << result.err_msg;
-                    emit linkFailed(result.src, result.dst, result.err_msg, result.err_value);
-                } else {
-                    qDebug() << "privileged link success" << result.src << "to" << result.dst;
-                    m_linked++;
-                    emit fileLinked(result.src, result.dst);
-                }
-                m_path_results.append(result);
-            }
-            gotResults = true;
-            qDebug() << "results received, closing connection";
-            clientConnection->close();
-        });
-
-        qint64 byteswritten = clientConnection->write(block);
-        bool bytesflushed = clientConnection->flush();
-        qDebug() << "block flushed" << byteswritten << bytesflushed;
+        m_path_results.append(result);
     });
-
-    qDebug() << "Listening on pipe" << serverName;
-    if (!m_linkServer.listen(serverName)) {
-        qDebug() << "Unable to start local pipe server on" << serverName << ":" << m_linkServer.errorString();
-        return;
-    }
-
-    ExternalLinkFileProcess* linkFileProcess = new ExternalLinkFileProcess(serverName, m_useHardLinks, this);
-    connect(linkFileProcess, &ExternalLinkFileProcess::processExited, this, [&]() { emit finishedPrivileged(gotResults); });
-    connect(linkFileProcess, &ExternalLinkFileProcess::finished, linkFileProcess, &QObject::deleteLater);
-
-    linkFileProcess->start();
+    auto finished = std::make_shared<QMetaObject::Connection>();
+    *finished = connect(broker, &FileLinkBroker::batchFinished, this, [this, batch, linked, finished](quint32 id, bool complete) {
+        if (id != batch)
+            return;
+        disconnect(linked);
+        disconnect(*finished);
+        emit finishedPrivileged(complete);
+    });
+    broker->submit(batch, m_links_to_make, m_useHardLinks);
 }
 
 void ExternalLinkFileProcess::runLinkFile()
@@ -534,8 +562,6 @@ void ExternalLinkFileProcess::runLinkFile()
         PathCombine(QCoreApplication::instance()->applicationDirPath(), BuildConfig.LAUNCHER_APP_BINARY_NAME + "_filelink");
     QString params = "-s " + m_server;
 
-    params += " -H " + QVariant(m_useHardLinks).toString();
-
 #if defined Q_OS_WIN32
     SHELLEXECUTEINFO ShExecInfo;
 
@@ -596,7 +622,7 @@ bool deletePath(QString path)
     return err.value() == 0;
 }
 
-bool trash(QString path, QString* pathInTrash)
+bool canTrash()
 {
 #if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
     return false;
@@ -608,6 +634,19 @@ bool trash(QString path, QString* pathInTrash)
     if (IsWindowsServer())
         return false;
 #endif
+    return true;
+#endif
+}
+
+bool trash(QString path, QString* pathInTrash)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+    Q_UNUSED(path);
+    Q_UNUSED(pathInTrash);
+    return false;
+#else
+    if (!canTrash())
+        return false;
     return QFile::moveToTrash(path, pathInTrash);
 #endif
 }
@@ -1056,76 +1095,12 @@ bool canClone(const QString& src, const QString& dst)
     return sameDevice && canCloneOnFS(srcVInfo) && canCloneOnFS(dstVInfo);
 }
 
-/**
- * @brief reflink/clones a directory and it's contents from src to dest
- * @param offset subdirectory form src to copy to dest
- * @return if there was an error during the filecopy
- */
-bool clone::operator()(const QString& offset, bool dryRun)
-{
-    if (!canClone(m_src.absolutePath(), m_dst.absolutePath())) {
-        qWarning() << "Can not clone: not same device or not clone/reflink filesystem";
-        qDebug() << "Source path:" << m_src.absolutePath();
-        qDebug() << "Destination path:" << m_dst.absolutePath();
-        emit cloneFailed(m_src.absolutePath(), m_dst.absolutePath());
-        return false;
-    }
-
-    m_cloned = 0;  // reset counter
-
-    auto src = PathCombine(m_src.absolutePath(), offset);
-    auto dst = PathCombine(m_dst.absolutePath(), offset);
-
-    std::error_code err;
-
-    // Function that'll do the actual cloneing
-    auto cloneFile = [&](QString src_path, QString relative_dst_path) {
-        if (m_matcher && (m_matcher->matches(relative_dst_path) != m_whitelist))
-            return;
-
-        auto dst_path = PathCombine(dst, relative_dst_path);
-        if (!dryRun) {
-            ensureFilePathExists(dst_path);
-            clone_file(src_path, dst_path, err);
-        }
-        if (err) {
-            qDebug() << "Failed to clone files: error" << err.value() << "message" << QString::fromStdString(err.message());
-            qDebug() << "Source file:" << src_path;
-            qDebug() << "Destination file:" << dst_path;
-        }
-        m_cloned++;
-        emit fileCloned(src_path, dst_path);
-    };
-
-    // We can't use copy_opts::recursive because we need to take into account the
-    // blacklisted paths, so we iterate over the source directory, and if there's no blacklist
-    // match, we copy the file.
-    QDir src_dir(src);
-    QDirIterator source_it(src, QDir::Filter::Files | QDir::Filter::Hidden, QDirIterator::Subdirectories);
-
-    while (source_it.hasNext()) {
-        auto src_path = source_it.next();
-        auto relative_path = src_dir.relativeFilePath(src_path);
-
-        cloneFile(src_path, relative_path);
-    }
-
-    // If the root src is not a directory, the previous iterator won't run.
-    if (!fs::is_directory(StringUtils::toStdString(src)))
-        cloneFile(src, "");
-
-    return err.value() == 0;
-}
-
 /**
  * @brief clone/reflink file from src to dst
  *
  */
 bool clone_file(const QString& src, const QString& dst, std::error_code& ec)
 {
-    auto src_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(src).absoluteFilePath()));
-    auto dst_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(dst).absoluteFilePath()));
-
     FilesystemInfo srcinfo = statFS(src);
     FilesystemInfo dstinfo = statFS(dst);
 
@@ -1135,6 +1110,14 @@ bool clone_file(const QString& src, const QString& dst, std::error_code& ec)
         return false;
     }
 
+    return clone_file_data(src, dst, ec);
+}
+
+bool clone_file_data(const QString& src, const QString& dst, std::error_code& ec)
+{
+    auto src_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(src).absoluteFilePath()));
+    auto dst_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(dst).absoluteFilePath()));
+
 #if defined(Q_OS_WIN)
 
     if (!win_ioctl_clone(src_path, dst_path, ec)) {
@@ -1435,4 +1418,38 @@ uintmax_t hardLinkCount(const QString& path)
     return count;
 }
 
+bool cloneOrLinkFile(const QString& src, const QString& dst)
+{
+    return cloneOrLinkFile(src, dst, canClone(src, dst), canLink(src, dst));
+}
+
+bool cloneOrLinkFile(const QString& src, const QString& dst, bool can_clone, bool can_link)
+{
+    if (!ensureFilePathExists(dst))
+        return false;
+
+    std::error_code err;
+    auto src_path = StringUtils::toStdString(src);
+    auto dst_path = StringUtils::toStdString(dst);
+
+    if (fs::exists(dst_path, err) && !fs::remove(dst_path, err)) {
+        qWarning() << "Failed to replace" << dst << ":" << QString::fromStdString(err.message());
+        return false;
+    }
+
+    if (can_clone && clone_file(src, dst, err))
+        return true;
+
+    err.clear();
+    if (can_link) {
+        // fails when both sides are not on the same device, in which case we just copy
+        fs::create_hard_link(src_path, dst_path, err);
+        if (!err)
+            return true;
+        qDebug() << "Could not hard link" << src << "to" << dst << ":" << QString::fromStdString(err.message());
+    }
+
+    return QFile::copy(src, dst);
+}
+
 }  // namespace FS
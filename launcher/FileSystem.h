@@ -40,9 +40,11 @@
 #include "Exception.h"
 #include "pathmatcher/IPathMatcher.h"
 
+#include <atomic>
 #include <system_error>
 
 #include <QDir>
+#include <QFileDevice>
 #include <QFlags>
 #include <QLocalServer>
 #include <QObject>
@@ -70,6 +72,12 @@ QByteArray read(const QString& filename);
  */
 bool updateTimestamp(const QString& filename);
 
+/**
+ * Reserves room on the disk for `size` bytes of an open file, without changing its size, so that writing it doesn't
+ * grow it a bit at a time. Only a hint: returns false where the filesystem can't, and the writes still work then.
+ */
+bool preallocate(QFileDevice& file, qint64 size);
+
 /**
  * Creates all the folders in a path for the specified path
  * last segment of the path is treated as a file name and is ignored!
@@ -84,6 +92,9 @@ bool ensureFolderPathExists(QString filenamepath);
 
 /**
  * @brief Copies a directory and it's contents from src to dest
+ *
+ * The files are listed first, then copied several at a time on the global thread pool. They get cloned
+ * instead when both ends are on a filesystem that can do it (see canClone()).
  */
 class copy : public QObject {
     Q_OBJECT
@@ -114,6 +125,7 @@ class copy : public QObject {
     int totalCopied() { return m_copied; }
 
    signals:
+    /** Emitted from the copying threads, one at a time, at most every few milliseconds (and for the last file). */
     void fileCopied(const QString& relativeName);
     // TODO: maybe add a "shouldCopy" signal in the future?
 
@@ -126,7 +138,9 @@ class copy : public QObject {
     bool m_whitelist = false;
     QDir m_src;
     QDir m_dst;
-    int m_copied;
+    std::atomic_int m_copied{ 0 };
+
+    static constexpr qint64 s_progress_interval = 50;
 };
 
 struct LinkPair {
@@ -144,9 +158,7 @@ struct LinkResult {
 class ExternalLinkFileProcess : public QThread {
     Q_OBJECT
    public:
-    ExternalLinkFileProcess(QString server, bool useHardLinks, QObject* parent = nullptr)
-        : QThread(parent), m_useHardLinks(useHardLinks), m_server(server)
-    {}
+    ExternalLinkFileProcess(QString server, QObject* parent = nullptr) : QThread(parent), m_server(server) {}
 
     void run() override
     {
@@ -160,8 +172,6 @@ class ExternalLinkFileProcess : public QThread {
    private:
     void runLinkFile();
 
-    bool m_useHardLinks = false;
-
     QString m_server;
 };
 
@@ -214,6 +224,7 @@ class create_link : public QObject {
 
     int totalLinked() { return m_linked; }
 
+    /** Makes the links through the elevated link program of the session (see FileLinkBroker), finishedPrivileged() tells when. */
     void runPrivileged() { runPrivileged(QString()); }
     void runPrivileged(const QString& offset);
 
@@ -246,8 +257,6 @@ class create_link : public QObject {
     int m_linked;
     bool m_debug = false;
     std::error_code m_os_err;
-
-    QLocalServer m_linkServer;
 };
 
 /**
@@ -268,6 +277,11 @@ bool deletePath(QString path);
  */
 bool trash(QString path, QString* pathInTrash = nullptr);
 
+/**
+ * Whether there's a trash to move things to, trash() doesn't even try otherwise
+ */
+bool canTrash();
+
 QString PathCombine(const QString& path1, const QString& path2);
 QString PathCombine(const QString& path1, const QString& path2, const QString& path3);
 QString PathCombine(const QString& path1, const QString& path2, const QString& path3, const QString& path4);
@@ -447,51 +461,22 @@ bool canCloneOnFS(FilesystemType type);
 bool canClone(const QString& src, const QString& dst);
 
 /**
- * @brief Copies a directory and it's contents from src to dest
+ * @brief clone/reflink file from src to dst
+ *
  */
-class clone : public QObject {
-    Q_OBJECT
-   public:
-    clone(const QString& src, const QString& dst, QObject* parent = nullptr) : QObject(parent)
-    {
-        m_src.setPath(src);
-        m_dst.setPath(dst);
-    }
-    clone& matcher(const IPathMatcher* filter)
-    {
-        m_matcher = filter;
-        return *this;
-    }
-    clone& whitelist(bool whitelist)
-    {
-        m_whitelist = whitelist;
-        return *this;
-    }
-
-    bool operator()(bool dryRun = false) { return operator()(QString(), dryRun); }
-
-    int totalCloned() { return m_cloned; }
-
-   signals:
-    void fileCloned(const QString& src, const QString& dst);
-    void cloneFailed(const QString& src, const QString& dst);
-
-   private:
-    bool operator()(const QString& offset, bool dryRun = false);
+bool clone_file(const QString& src, const QString& dst, std::error_code& ec);
 
-   private:
-    const IPathMatcher* m_matcher = nullptr;
-    bool m_whitelist = false;
-    QDir m_src;
-    QDir m_dst;
-    int m_cloned;
-};
+/**
+ * @brief clone/reflink file from src to dst, without checking that both are on the same filesystem first
+ *
+ */
+bool clone_file_data(const QString& src, const QString& dst, std::error_code& ec);
 
 /**
- * @brief clone/reflink file from src to dst
+ * @brief whether a clone failing with `ec` means the filesystem can't clone at all, rather than just that file
  *
  */
-bool clone_file(const QString& src, const QString& dst, std::error_code& ec);
+bool isCloneUnsupported(const std::error_code& ec);
 
 #if defined(Q_OS_WIN)
 bool win_ioctl_clone(const std::wstring& src_path, const std::wstring& dst_path, std::error_code& ec);
@@ -521,4 +506,19 @@ bool canLink(const QString& src, const QString& dst);
 
 uintmax_t hardLinkCount(const QString& path);
 
+/**
+ * @brief places a copy of the file src at dst, sharing the data when the filesystem lets us
+ * tries a reflink/clone first, then a hard link, and finally falls back to a plain copy.
+ * an existing file at dst is replaced.
+ */
+bool cloneOrLinkFile(const QString& src, const QString& dst);
+
+/**
+ * @brief same as above, for when placing many files: whether cloning and hard linking are possible is given instead of
+ * asking the filesystems every time.
+ */
+bool cloneOrLinkFile(const QString& src, const QString& dst, bool can_clone, bool can_link);
+
 }  // namespace FS
+
+Q_DECLARE_METATYPE(FS::LinkResult)
@@ -0,0 +1,451 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "FileWatchBackend.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QPointer>
+
+#if defined(Q_OS_LINUX)
+#include <QSocketNotifier>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+
+#include <memory>
+#include <thread>
+#endif
+
+namespace {
+
+bool isUnder(const QString& path, const QString& dir)
+{
+    return path.size() > dir.size() && path.startsWith(dir) && path.at(dir.size()) == '/';
+}
+
+QString parentOf(const QString& path)
+{
+    return path.left(path.lastIndexOf('/'));
+}
+
+/* QFileSystemWatcher, for the systems without a backend of their own. */
+class QtFileWatchBackend : public FileWatchBackend {
+   public:
+    explicit QtFileWatchBackend(QObject* parent) : FileWatchBackend(parent)
+    {
+        connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString& dir) {
+            subtreeChanged(dir);
+            emit changed(dir, true);
+        });
+        connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, [this](const QString& path) { emit changed(path, false); });
+    }
+
+   protected:
+    bool watchPath(const QString& path) override { return m_watcher.addPath(path); }
+    void unwatchPath(const QString& path) override { m_watcher.removePath(path); }
+
+   private:
+    QFileSystemWatcher m_watcher;
+};
+
+#if defined(Q_OS_LINUX)
+/* One inotify instance for every watched folder. */
+class InotifyFileWatchBackend : public FileWatchBackend {
+   public:
+    static FileWatchBackend* create(QObject* parent)
+    {
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) {
+            qWarning() << "Couldn't start inotify, folders are watched with QFileSystemWatcher:" << strerror(errno);
+            return nullptr;
+        }
+        return new InotifyFileWatchBackend(fd, parent);
+    }
+
+    ~InotifyFileWatchBackend() override { ::close(m_fd); }
+
+    bool reportsFileChanges() const override { return true; }
+
+   protected:
+    bool watchPath(const QString& path) override
+    {
+        // the modifications of files only count once they're written, not for each write
+        constexpr uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF |
+                                  IN_MOVE_SELF | IN_ONLYDIR;
+        int wd = inotify_add_watch(m_fd, QFile::encodeName(path).constData(), mask);
+        if (wd < 0) {
+            if (errno == ENOSPC && !m_warned_limit) {
+                qWarning() << "Out of inotify watches, some folders aren't watched. Raise fs.inotify.max_user_watches to watch them all.";
+                m_warned_limit = true;
+            }
+            return false;
+        }
+        // inotify gives the same watch for the same folder, under another path when it's a link
+        if (m_watchUsers[wd]++ == 0)
+            m_paths.insert(wd, path);
+        m_watches.insert(path, wd);
+        return true;
+    }
+
+    void unwatchPath(const QString& path) override
+    {
+        auto it = m_watches.find(path);
+        if (it == m_watches.end())
+            return;
+        auto wd = it.value();
+        m_watches.erase(it);
+        if (--m_watchUsers[wd] > 0)
+            return;
+        m_watchUsers.remove(wd);
+        if (m_paths.remove(wd))
+            inotify_rm_watch(m_fd, wd);
+    }
+
+   private:
+    InotifyFileWatchBackend(int fd, QObject* parent) : FileWatchBackend(parent), m_fd(fd), m_notifier(fd, QSocketNotifier::Read)
+    {
+        connect(&m_notifier, &QSocketNotifier::activated, this, [this] { readEvents(); });
+    }
+
+    void readEvents()
+    {
+        alignas(inotify_event) char buffer[16 * 1024];
+        for (;;) {
+            auto length = ::read(m_fd, buffer, sizeof(buffer));
+            if (length <= 0)
+                return;
+
+            for (char* ptr = buffer; ptr < buffer + length;) {
+                auto event = reinterpret_cast<const inotify_event*>(ptr);
+                ptr += sizeof(inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    resync();
+                    continue;
+                }
+                auto dir = m_paths.value(event->wd);
+                if (dir.isEmpty())
+                    continue;
+                if (event->mask & IN_IGNORED) {
+                    // the folder is gone, the kernel dropped its watch and may give its number to another one
+                    m_paths.remove(event->wd);
+                    m_watchUsers.remove(event->wd);
+                    for (auto it = m_watches.begin(); it != m_watches.end();)
+                        it = it.value() == event->wd ? m_watches.erase(it) : std::next(it);
+                    continue;
+                }
+
+                bool is_dir = event->mask & IN_ISDIR;
+                auto path = event->len ? dir + '/' + QFile::decodeName(event->name) : dir;
+                if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                    subtreeChanged(dir);
+                    is_dir = true;
+                } else if (is_dir && (event->mask & (IN_CREATE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM))) {
+                    subtreeChanged(path);
+                }
+                emit changed(path, is_dir);
+            }
+        }
+    }
+
+   private:
+    int m_fd;
+    QSocketNotifier m_notifier;
+    QHash<int, QString> m_paths;
+    QHash<QString, int> m_watches;
+    QHash<int, int> m_watchUsers;
+    bool m_warned_limit = false;
+};
+#elif defined(Q_OS_WIN)
+/* A ReadDirectoryChangesW stream for each root, with the whole tree under it when it's recursive. */
+class WindowsFileWatchBackend : public FileWatchBackend {
+   public:
+    explicit WindowsFileWatchBackend(QObject* parent) : FileWatchBackend(parent) {}
+
+    ~WindowsFileWatchBackend() override
+    {
+        for (auto& stream : m_streams)
+            stop(*stream);
+    }
+
+    bool reportsFileChanges() const override { return true; }
+
+    bool addRoot(const QString& dir, bool recursive, bool files) override
+    {
+        Q_UNUSED(files);
+        auto key = rootKey(dir, recursive, false);
+        if (auto it = m_streams.find(key); it != m_streams.end()) {
+            it.value()->users++;
+            return true;
+        }
+
+        auto handle = CreateFileW(reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(dir).utf16()), FILE_LIST_DIRECTORY,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                  FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (handle == INVALID_HANDLE_VALUE)
+            return false;
+
+        auto stream = std::make_shared<Stream>();
+        stream->handle = handle;
+        stream->stop = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        stream->thread = std::thread([this, dir, recursive, handle, stop = stream->stop] { read(dir, recursive, handle, stop); });
+        m_streams.insert(key, stream);
+        return true;
+    }
+
+    void removeRoot(const QString& dir, bool recursive, bool files) override
+    {
+        Q_UNUSED(files);
+        auto it = m_streams.find(rootKey(dir, recursive, false));
+        if (it == m_streams.end() || --it.value()->users > 0)
+            return;
+        stop(*it.value());
+        m_streams.erase(it);
+    }
+
+   private:
+    struct Stream {
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        HANDLE stop = nullptr;
+        std::thread thread;
+        int users = 1;
+    };
+
+    static void stop(Stream& stream)
+    {
+        SetEvent(stream.stop);
+        stream.thread.join();
+        CloseHandle(stream.handle);
+        CloseHandle(stream.stop);
+    }
+
+    /** Runs on the thread of the stream until it's stopped. */
+    void read(const QString& dir, bool recursive, HANDLE handle, HANDLE stop)
+    {
+        constexpr DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE |
+                                 FILE_NOTIFY_CHANGE_SIZE;
+        // 64 KiB at most, more doesn't work on network shares
+        alignas(DWORD) char buffer[64 * 1024];
+        OVERLAPPED overlapped{};
+        overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+        for (;;) {
+            ResetEvent(overlapped.hEvent);
+            if (!ReadDirectoryChangesW(handle, buffer, sizeof(buffer), recursive, filter, nullptr, &overlapped, nullptr))
+                break;
+
+            HANDLE events[] = { overlapped.hEvent, stop };
+            DWORD bytes = 0;
+            if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0) {
+                CancelIo(handle);
+                GetOverlappedResult(handle, &overlapped, &bytes, TRUE);
+                break;
+            }
+            if (!GetOverlappedResult(handle, &overlapped, &bytes, FALSE))
+                break;
+
+            QStringList paths;
+            if (bytes == 0) {
+                // too much happened at once for the buffer, only the folder is known to have changed
+                paths.append(dir);
+            } else {
+                for (auto ptr = buffer;;) {
+                    auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(ptr);
+                    auto name = QString::fromWCharArray(info->FileName, int(info->FileNameLength / sizeof(WCHAR)));
+                    paths.append(dir + '/' + QDir::fromNativeSeparators(name));
+                    if (!info->NextEntryOffset)
+                        break;
+                    ptr += info->NextEntryOffset;
+                }
+            }
+            QMetaObject::invokeMethod(
+                this,
+                [this, paths] {
+                    for (auto& path : paths)
+                        emit changed(path, !QFileInfo(path).isFile());
+                },
+                Qt::QueuedConnection);
+        }
+        CloseHandle(overlapped.hEvent);
+    }
+
+   private:
+    QHash<QString, std::shared_ptr<Stream>> m_streams;
+};
+#endif
+
+}  // namespace
+
+FileWatchBackend* FileWatchBackend::instance()
+{
+    static QPointer<FileWatchBackend> s_instance;
+    if (!s_instance) {
+        auto parent = QCoreApplication::instance();
+#if defined(Q_OS_LINUX)
+        s_instance = InotifyFileWatchBackend::create(parent);
+#elif defined(Q_OS_WIN)
+        s_instance = new WindowsFileWatchBackend(parent);
+#endif
+        if (!s_instance)
+            s_instance = new QtFileWatchBackend(parent);
+    }
+    return s_instance;
+}
+
+QString FileWatchBackend::rootKey(const QString& dir, bool recursive, bool files)
+{
+    return QString("%1%2:%3").arg(recursive ? 'r' : '-').arg(files ? 'f' : '-').arg(dir);
+}
+
+bool FileWatchBackend::addRoot(const QString& dir, bool recursive, bool files)
+{
+    files = files && !reportsFileChanges();
+    auto key = rootKey(dir, recursive, files);
+    if (auto it = m_roots.find(key); it != m_roots.end()) {
+        it->users++;
+        return true;
+    }
+
+    Root root;
+    root.dir = dir;
+    root.recursive = recursive;
+    root.files = files;
+    root.users = 1;
+    for (auto& path : gather(root, dir)) {
+        if (ref(path)) {
+            root.paths.insert(path);
+        } else if (path == dir) {
+            for (auto& watched : root.paths)
+                unref(watched);
+            return false;
+        }
+    }
+    if (!root.paths.contains(dir))
+        return false;
+    m_roots.insert(key, root);
+    return true;
+}
+
+void FileWatchBackend::removeRoot(const QString& dir, bool recursive, bool files)
+{
+    files = files && !reportsFileChanges();
+    auto it = m_roots.find(rootKey(dir, recursive, files));
+    if (it == m_roots.end() || --it->users > 0)
+        return;
+    for (auto& path : it->paths)
+        unref(path);
+    m_roots.erase(it);
+}
+
+QStringList FileWatchBackend::gather(const Root& root, const QString& dir) const
+{
+    if (!QFileInfo(dir).isDir())
+        return {};
+    QStringList paths{ dir };
+    if (root.files) {
+        QDirIterator it(dir, QDir::Files | QDir::Hidden);
+        while (it.hasNext())
+            paths.append(it.next());
+    }
+    if (root.recursive) {
+        QDirIterator it(dir, QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot);
+        while (it.hasNext())
+            paths.append(gather(root, it.next()));
+    }
+    return paths;
+}
+
+void FileWatchBackend::subtreeChanged(const QString& dir)
+{
+    for (auto& root : m_roots) {
+        if (dir != root.dir && !(root.recursive && isUnder(dir, root.dir)))
+            continue;
+
+        // what's in the folder now, with everything under the folders that weren't watched yet
+        QSet<QString> present;
+        if (QFileInfo(dir).isDir()) {
+            present.insert(dir);
+            if (root.files) {
+                QDirIterator it(dir, QDir::Files | QDir::Hidden);
+                while (it.hasNext())
+                    present.insert(it.next());
+            }
+            if (root.recursive) {
+                QDirIterator it(dir, QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot);
+                while (it.hasNext()) {
+                    auto subdir = it.next();
+                    if (root.paths.contains(subdir)) {
+                        present.insert(subdir);
+                        continue;
+                    }
+                    for (auto& path : gather(root, subdir))
+                        present.insert(path);
+                }
+            }
+        }
+
+        QStringList gone;
+        for (auto& path : root.paths) {
+            if (path == dir || (path != root.dir && parentOf(path) == dir)) {
+                if (!present.contains(path))
+                    gone.append(path);
+            }
+        }
+        for (auto& path : gone) {
+            for (auto it = root.paths.begin(); it != root.paths.end();) {
+                if (*it == path || isUnder(*it, path)) {
+                    unref(*it);
+                    it = root.paths.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        for (auto& path : present) {
+            if (!root.paths.contains(path) && ref(path))
+                root.paths.insert(path);
+        }
+    }
+}
+
+void FileWatchBackend::resync()
+{
+    QStringList dirs;
+    for (auto& root : m_roots)
+        dirs.append(root.dir);
+    for (auto& dir : dirs) {
+        subtreeChanged(dir);
+        emit changed(dir, true);
+    }
+}
+
+bool FileWatchBackend::ref(const QString& path)
+{
+    auto it = m_refs.find(path);
+    if (it != m_refs.end()) {
+        it.value()++;
+        return true;
+    }
+    if (!watchPath(path))
+        return false;
+    m_refs.insert(path, 1);
+    return true;
+}
+
+void FileWatchBackend::unref(const QString& path)
+{
+    auto it = m_refs.find(path);
+    if (it == m_refs.end() || --it.value() > 0)
+        return;
+    m_refs.erase(it);
+    unwatchPath(path);
+}
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+/* What FileWatchers watch folders with, one for the whole launcher.
+ *
+ * A folder watched by several FileWatchers is only watched once, and a folder watched with everything under it
+ * doesn't need a watch for each of its subfolders where the system can do that: ReadDirectoryChangesW watches a whole
+ * tree on Windows. On Linux, a single inotify instance holds the watches of every FileWatcher, and it reports the
+ * changes to the files in a watched folder, so the files themselves never need a watch. Elsewhere, it's a
+ * QFileSystemWatcher, which uses FSEvents on macOS.
+ *
+ * Only for the main thread.
+ */
+class FileWatchBackend : public QObject {
+    Q_OBJECT
+   public:
+    /** The backend of this system, made on first use. */
+    static FileWatchBackend* instance();
+
+    /** Starts watching `dir`, with everything under it when recursive. Files are watched one by one with
+     * `files` only when the backend doesn't report their changes anyway. False when `dir` can't be watched. */
+    virtual bool addRoot(const QString& dir, bool recursive, bool files);
+    virtual void removeRoot(const QString& dir, bool recursive, bool files);
+
+    /** Whether the changes to the files of a watched folder are reported without watching each file. */
+    virtual bool reportsFileChanges() const { return false; }
+
+   signals:
+    /** Something changed at `path`, in a watched folder or the watched folder itself. `is_dir` is true as well when
+     * what changed is gone and it may have been a folder. */
+    void changed(const QString& path, bool is_dir);
+
+   protected:
+    using QObject::QObject;
+
+    /* The backends that watch paths one by one implement these, and addRoot() and removeRoot() keep track of which
+     * paths have to be watched for the roots, shared between them. */
+    virtual bool watchPath(const QString& path)
+    {
+        Q_UNUSED(path);
+        return false;
+    }
+    virtual void unwatchPath(const QString& path) { Q_UNUSED(path); }
+
+    /** The folder `dir` changed, or appeared, or went away: watches what's new in it, and stops watching what's gone. */
+    void subtreeChanged(const QString& dir);
+    /** The backend lost track of what happened: everything may have changed. */
+    void resync();
+
+    static QString rootKey(const QString& dir, bool recursive, bool files);
+
+   private:
+    struct Root {
+        QString dir;
+        bool recursive = false;
+        bool files = false;
+        int users = 0;
+        // the paths watched for this root
+        QSet<QString> paths;
+    };
+
+    QStringList gather(const Root& root, const QString& dir) const;
+    bool ref(const QString& path);
+    void unref(const QString& path);
+
+   private:
+    QHash<QString, Root> m_roots;
+    // how many roots need each path watched
+    QHash<QString, int> m_refs;
+};
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "FileWatcher.h"
+
+#include <QDir>
+#include <QFileInfo>
+
+#include "FileWatchBackend.h"
+
+namespace {
+constexpr int s_default_interval_ms = 100;
+// changes that never settle are still reported after that many intervals
+constexpr int s_max_delay_intervals = 10;
+
+QString normalized(const QString& dir)
+{
+    return QDir::cleanPath(QFileInfo(dir).absoluteFilePath());
+}
+}  // namespace
+
+FileWatcher::FileWatcher(QObject* parent) : QObject(parent), m_backend(FileWatchBackend::instance())
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(s_default_interval_ms);
+    connect(&m_timer, &QTimer::timeout, this, &FileWatcher::flush);
+    connect(m_backend, &FileWatchBackend::changed, this, &FileWatcher::backendChanged);
+}
+
+FileWatcher::~FileWatcher()
+{
+    removeAll();
+}
+
+bool FileWatcher::addPath(const QString& dir, Mode mode)
+{
+    Watched watched{ normalized(dir), mode == Mode::Recursive, m_watch_files };
+    for (auto& other : m_watched) {
+        if (other.dir == watched.dir)
+            return false;
+    }
+    if (!m_backend || !m_backend->addRoot(watched.dir, watched.recursive, watched.files))
+        return false;
+    m_watched.append(watched);
+    return true;
+}
+
+QStringList FileWatcher::addPaths(const QStringList& dirs, Mode mode)
+{
+    QStringList failed;
+    for (auto& dir : dirs) {
+        if (!addPath(dir, mode))
+            failed.append(dir);
+    }
+    return failed;
+}
+
+bool FileWatcher::removePath(const QString& dir)
+{
+    auto path = normalized(dir);
+    for (int i = 0; i < m_watched.size(); i++) {
+        auto& watched = m_watched[i];
+        if (watched.dir != path)
+            continue;
+        if (m_backend)
+            m_backend->removeRoot(watched.dir, watched.recursive, watched.files);
+        m_pending.remove(watched.dir);
+        m_watched.removeAt(i);
+        return true;
+    }
+    return false;
+}
+
+QStringList FileWatcher::removePaths(const QStringList& dirs)
+{
+    QStringList failed;
+    for (auto& dir : dirs) {
+        if (!removePath(dir))
+            failed.append(dir);
+    }
+    return failed;
+}
+
+void FileWatcher::removeAll()
+{
+    for (auto& watched : m_watched) {
+        if (m_backend)
+            m_backend->removeRoot(watched.dir, watched.recursive, watched.files);
+    }
+    m_watched.clear();
+    m_pending.clear();
+    m_timer.stop();
+}
+
+QStringList FileWatcher::directories() const
+{
+    QStringList dirs;
+    for (auto& watched : m_watched)
+        dirs.append(watched.dir);
+    return dirs;
+}
+
+void FileWatcher::backendChanged(const QString& path, bool is_dir)
+{
+    for (auto& watched : m_watched) {
+        if (path != watched.dir) {
+            if (!path.startsWith(watched.dir) || path.size() <= watched.dir.size() || path.at(watched.dir.size()) != '/')
+                continue;
+            // only what's right in the folder, unless it's watched with everything under it
+            if (!watched.recursive && path.indexOf('/', watched.dir.size() + 1) >= 0)
+                continue;
+            if (!is_dir && m_matcher && !m_matcher->matches(path.mid(watched.dir.size() + 1)))
+                continue;
+        }
+        if (m_pending.isEmpty())
+            m_pending_since.start();
+        m_pending[watched.dir].insert(path);
+        if (!m_timer.isActive() || m_pending_since.elapsed() < qint64(s_max_delay_intervals) * m_timer.interval())
+            m_timer.start();
+    }
+}
+
+void FileWatcher::flush()
+{
+    auto pending = std::move(m_pending);
+    m_pending.clear();
+    for (auto it = pending.cbegin(); it != pending.cend(); ++it)
+        emit changed(it.key(), it.value().values());
+}
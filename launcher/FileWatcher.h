@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include "pathmatcher/IPathMatcher.h"
+
+class FileWatchBackend;
+
+/* Watches folders for changes, through the FileWatchBackend the whole launcher shares.
+ *
+ * The changes are reported once they settle, for each watched folder with the paths that changed in it, so a burst
+ * of them (a lot of files copied at once, a game writing its logs) ends up in a single changed() signal.
+ */
+class FileWatcher : public QObject {
+    Q_OBJECT
+   public:
+    enum class Mode {
+        // the folder and the files and folders right in it
+        Contents,
+        // everything under the folder
+        Recursive,
+    };
+
+    explicit FileWatcher(QObject* parent = nullptr);
+    ~FileWatcher() override;
+
+    /** Returns false when the folder can't be watched. */
+    bool addPath(const QString& dir, Mode mode = Mode::Contents);
+    /** The folders that couldn't be watched. */
+    QStringList addPaths(const QStringList& dirs, Mode mode = Mode::Contents);
+    bool removePath(const QString& dir);
+    /** The folders that weren't watched. */
+    QStringList removePaths(const QStringList& dirs);
+    void removeAll();
+
+    QStringList directories() const;
+
+    /** Also report the changes to the contents of the files, not only files coming and going. It costs a watch for
+     * each file on the systems that don't report them anyway. Applies to the folders added afterwards. */
+    void setWatchFiles(bool watch_files) { m_watch_files = watch_files; }
+
+    /** Only report the files that match, by their path relative to the watched folder. Folders are always reported. */
+    void setMatcher(IPathMatcher::Ptr matcher) { m_matcher = std::move(matcher); }
+
+    /** How long things have to be quiet before the changes are reported, in milliseconds. */
+    void setInterval(int msec) { m_timer.setInterval(msec); }
+
+   signals:
+    /** Things changed in the watched folder `dir`: added, removed or modified at `paths`. `dir` itself is in there when
+     * it changed in a way the backend didn't tell more about. */
+    void changed(const QString& dir, const QStringList& paths);
+
+   private:
+    struct Watched {
+        QString dir;
+        bool recursive = false;
+        bool files = false;
+    };
+
+    void backendChanged(const QString& path, bool is_dir);
+    void flush();
+
+   private:
+    QPointer<FileWatchBackend> m_backend;
+    QList<Watched> m_watched;
+    bool m_watch_files = false;
+    IPathMatcher::Ptr m_matcher;
+
+    QTimer m_timer;
+    // the changed paths, by watched folder
+    QHash<QString, QSet<QString>> m_pending;
+    QElapsedTimer m_pending_since;
+};
@@ -1,6 +1,10 @@
 #include "Filter.h"
 
 Filter::~Filter(){}
+bool Filter::narrows(const Filter*) const
+{
+    return false;
+}
 
 ContainsFilter::ContainsFilter(const QString& pattern) : pattern(pattern){}
 ContainsFilter::~ContainsFilter(){}
@@ -8,6 +12,11 @@ bool ContainsFilter::accepts(const QString& value)
 {
     return value.contains(pattern);
 }
+bool ContainsFilter::narrows(const Filter* previous) const
+{
+    auto other = dynamic_cast<const ContainsFilter*>(previous);
+    return other && pattern.contains(other->pattern);
+}
 
 ExactFilter::ExactFilter(const QString& pattern) : pattern(pattern){}
 ExactFilter::~ExactFilter(){}
@@ -15,6 +24,11 @@ bool ExactFilter::accepts(const QString& value)
 {
     return value == pattern;
 }
+bool ExactFilter::narrows(const Filter* previous) const
+{
+    auto other = dynamic_cast<const ExactFilter*>(previous);
+    return other && pattern == other->pattern;
+}
 
 RegexpFilter::RegexpFilter(const QString& regexp, bool invert)
     :invert(invert)
@@ -29,3 +43,8 @@ bool RegexpFilter::accepts(const QString& value)
     bool matched = match.hasMatch();
     return invert ? (!matched) : (matched);
 }
+bool RegexpFilter::narrows(const Filter* previous) const
+{
+    auto other = dynamic_cast<const RegexpFilter*>(previous);
+    return other && pattern == other->pattern && invert == other->invert;
+}
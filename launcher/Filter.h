@@ -8,6 +8,8 @@ class Filter
 public:
     virtual ~Filter();
     virtual bool accepts(const QString & value) = 0;
+    // whether everything this accepts was accepted by the previous filter too, so only what that let through has to be checked again
+    virtual bool narrows(const Filter * previous) const;
 };
 
 class ContainsFilter: public Filter
@@ -16,6 +18,7 @@ public:
     ContainsFilter(const QString &pattern);
     virtual ~ContainsFilter();
     bool accepts(const QString & value) override;
+    bool narrows(const Filter * previous) const override;
 private:
     QString pattern;
 };
@@ -26,6 +29,8 @@ public:
     ExactFilter(const QString &pattern);
     virtual ~ExactFilter();
     bool accepts(const QString & value) override;
+    bool narrows(const Filter * previous) const override;
+    const QString &value() const { return pattern; }
 private:
     QString pattern;
 };
@@ -36,6 +41,7 @@ public:
     RegexpFilter(const QString &regexp, bool invert);
     virtual ~RegexpFilter();
     bool accepts(const QString & value) override;
+    bool narrows(const Filter * previous) const override;
 private:
     QRegularExpression pattern;
     bool invert = false;
@@ -37,6 +37,34 @@
 #include <zlib.h>
 #include <QByteArray>
 
+namespace {
+// one chunk for the streaming paths, and the most the trailer is trusted with as a size hint
+constexpr int chunkSize = 64 * 1024;
+constexpr qint64 maxSizeHint = 256 * 1024 * 1024;
+}
+
+bool GZip::isCompressed(const QByteArray &bytes)
+{
+    return bytes.size() >= 2 && uchar(bytes[0]) == 0x1f && uchar(bytes[1]) == 0x8b;
+}
+
+qint64 GZip::uncompressedSizeHint(const QByteArray &compressedBytes)
+{
+    // ISIZE, the last four bytes in little endian, is the size modulo 2^32 of the last member only
+    if (compressedBytes.size() < 18)
+    {
+        return 0;
+    }
+    auto trailer = reinterpret_cast<const uchar *>(compressedBytes.constData() + compressedBytes.size() - 4);
+    qint64 size = qint64(trailer[0]) | (qint64(trailer[1]) << 8) | (qint64(trailer[2]) << 16) | (qint64(trailer[3]) << 24);
+    // deflate can't do better than about 1032:1, so a bigger size means the data is cut off or isn't gzip
+    if (size > maxSizeHint || size > qint64(compressedBytes.size()) * 1032)
+    {
+        return 0;
+    }
+    return size;
+}
+
 bool GZip::unzip(const QByteArray &compressedBytes, QByteArray &uncompressedBytes)
 {
     if (compressedBytes.size() == 0)
@@ -45,7 +73,8 @@ bool GZip::unzip(const QByteArray &compressedBytes, QByteArray &uncompressedByte
         return true;
     }
 
-    unsigned uncompLength = compressedBytes.size();
+    // usually right the first time, the doubling below only kicks in for concatenated or odd streams
+    unsigned uncompLength = qMax<qint64>(uncompressedSizeHint(compressedBytes), compressedBytes.size());
     uncompressedBytes.clear();
     uncompressedBytes.resize(uncompLength);
 
@@ -94,6 +123,30 @@ bool GZip::unzip(const QByteArray &compressedBytes, QByteArray &uncompressedByte
     return true;
 }
 
+bool GZip::unzip(const QByteArray &compressedBytes, QIODevice &out)
+{
+    if (compressedBytes.size() == 0)
+    {
+        return true;
+    }
+
+    GZipReader reader(compressedBytes);
+    if (!reader.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QByteArray chunk(chunkSize, Qt::Uninitialized);
+    while (!reader.atEnd())
+    {
+        auto read = reader.read(chunk.data(), chunk.size());
+        if (read < 0 || out.write(chunk.constData(), read) != read)
+        {
+            return false;
+        }
+    }
+    return !reader.failed();
+}
+
 bool GZip::zip(const QByteArray &uncompressedBytes, QByteArray &compressedBytes)
 {
     if (uncompressedBytes.size() == 0)
@@ -148,3 +201,108 @@ bool GZip::zip(const QByteArray &uncompressedBytes, QByteArray &compressedBytes)
     }
     return true;
 }
+
+struct GZipReader::Stream
+{
+    z_stream strm;
+};
+
+GZipReader::GZipReader(QByteArray compressedBytes, QObject *parent) : QIODevice(parent), m_compressed(std::move(compressedBytes)) {}
+
+GZipReader::~GZipReader()
+{
+    close();
+}
+
+bool GZipReader::open(OpenMode mode)
+{
+    if ((mode & QIODevice::WriteOnly) || isOpen())
+    {
+        return false;
+    }
+    m_stream.reset(new Stream);
+    memset(&m_stream->strm, 0, sizeof(m_stream->strm));
+    m_stream->strm.next_in = (Bytef *)m_compressed.data();
+    m_stream->strm.avail_in = m_compressed.size();
+    if (inflateInit2(&m_stream->strm, (16 + MAX_WBITS)) != Z_OK)
+    {
+        m_stream.reset();
+        return false;
+    }
+    m_chunk.clear();
+    m_chunkPos = 0;
+    m_finished = m_compressed.isEmpty();
+    m_failed = false;
+    return QIODevice::open(mode | QIODevice::Unbuffered);
+}
+
+void GZipReader::close()
+{
+    if (m_stream)
+    {
+        inflateEnd(&m_stream->strm);
+        m_stream.reset();
+    }
+    m_chunk.clear();
+    QIODevice::close();
+}
+
+bool GZipReader::atEnd() const
+{
+    return m_finished && m_chunkPos >= m_chunk.size();
+}
+
+qint64 GZipReader::bytesAvailable() const
+{
+    return m_chunk.size() - m_chunkPos + QIODevice::bytesAvailable();
+}
+
+bool GZipReader::fill()
+{
+    if (m_finished || !m_stream)
+    {
+        return false;
+    }
+    m_chunk.resize(chunkSize);
+    m_chunkPos = 0;
+    auto &strm = m_stream->strm;
+    strm.next_out = reinterpret_cast<Bytef *>(m_chunk.data());
+    strm.avail_out = m_chunk.size();
+
+    // Inflate another chunk.
+    int err = inflate(&strm, Z_SYNC_FLUSH);
+    m_chunk.resize(m_chunk.size() - strm.avail_out);
+    if (err == Z_STREAM_END)
+    {
+        m_finished = true;
+    }
+    else if (err != Z_OK)
+    {
+        m_finished = true;
+        m_failed = true;
+        setErrorString(strm.msg ? QString::fromLatin1(strm.msg) : QStringLiteral("The gzip data is corrupt"));
+        return false;
+    }
+    return true;
+}
+
+qint64 GZipReader::readData(char *data, qint64 maxSize)
+{
+    qint64 read = 0;
+    while (read < maxSize)
+    {
+        if (m_chunkPos >= m_chunk.size() && !fill())
+        {
+            break;
+        }
+        auto count = qMin<qint64>(maxSize - read, m_chunk.size() - m_chunkPos);
+        memcpy(data + read, m_chunk.constData() + m_chunkPos, count);
+        m_chunkPos += count;
+        read += count;
+    }
+    if (read == 0 && m_failed)
+    {
+        return -1;
+    }
+    return read;
+}
@@ -1,10 +1,58 @@
 #pragma once
 #include <QByteArray>
+#include <QIODevice>
+
+#include <memory>
 
 class GZip
 {
 public:
     static bool unzip(const QByteArray &compressedBytes, QByteArray &uncompressedBytes);
+    /** Inflates into `out` a chunk at a time, so what is inflated is never all held in memory. */
+    static bool unzip(const QByteArray &compressedBytes, QIODevice &out);
     static bool zip(const QByteArray &uncompressedBytes, QByteArray &compressedBytes);
+
+    /** Whether the data starts like gzip does. Text never does, JSON and XML included. */
+    static bool isCompressed(const QByteArray &bytes);
+
+    /** What the gzip trailer says the inflated size is, or 0 if it can't be trusted as a size hint. */
+    static qint64 uncompressedSizeHint(const QByteArray &compressedBytes);
 };
 
+/* A read-only, sequential device that inflates the gzip data it was made with as it is read.
+ *
+ * Only one chunk of the inflated data is held at a time, for reading through large files for just a few values.
+ */
+class GZipReader : public QIODevice
+{
+    Q_OBJECT
+public:
+    explicit GZipReader(QByteArray compressedBytes, QObject *parent = nullptr);
+    ~GZipReader() override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override { return true; }
+    bool atEnd() const override;
+    qint64 bytesAvailable() const override;
+
+    /** Whether the data turned out not to be valid gzip, or to end early. */
+    bool failed() const { return m_failed; }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    /** Inflates the next chunk into m_chunk. */
+    bool fill();
+
+private:
+    struct Stream;
+    std::unique_ptr<Stream> m_stream;
+    QByteArray m_compressed;
+    QByteArray m_chunk;
+    qint64 m_chunkPos = 0;
+    bool m_finished = false;
+    bool m_failed = false;
+};
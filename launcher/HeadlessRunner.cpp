@@ -0,0 +1,387 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "HeadlessRunner.h"
+
+#include <QDebug>
+#include <QFileInfo>
+
+#include <iostream>
+
+#include "Application.h"
+#include "BuildConfig.h"
+#include "InstanceImportTask.h"
+#include "InstanceList.h"
+#include "InstanceTask.h"
+#include "OfflineBundle.h"
+#include "launch/LaunchTask.h"
+#include "launch/LogModel.h"
+#include "launch/steps/TextPrint.h"
+#include "meta/Index.h"
+#include "meta/VersionList.h"
+#include "minecraft/BulkUpdateTask.h"
+#include "minecraft/InstanceVerifyTask.h"
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/VanillaInstanceCreationTask.h"
+#include "minecraft/auth/AccountList.h"
+#include "minecraft/auth/AccountTask.h"
+#include "minecraft/mod/InstanceModIndex.h"
+
+namespace {
+void print(const QString& line)
+{
+    std::cout << line.toLocal8Bit().constData() << std::endl;
+}
+
+void printError(const QString& line)
+{
+    std::cerr << line.toLocal8Bit().constData() << std::endl;
+}
+}  // namespace
+
+HeadlessRunner::HeadlessRunner(Actions actions, QObject* parent) : QObject(parent), m_actions(std::move(actions))
+{
+    // the instances are only known once they are committed to the list
+    connect(APPLICATION->instances().get(), &InstanceList::instanceSelectRequest, this, [this](const QString& id) {
+        if (!m_added.contains(id))
+            m_added.append(id);
+    });
+}
+
+void HeadlessRunner::start()
+{
+    for (auto& path : m_actions.bundlesToImport)
+        m_steps.append([this, path] { importBundle(path); });
+    for (auto& spec : m_actions.toCreate)
+        m_steps.append([this, spec] { create(spec); });
+    for (auto& url : m_actions.toImport)
+        m_steps.append([this, url] { import(url); });
+    m_steps.append([this] { update(); });
+    if (!m_actions.bundleToExport.isEmpty())
+        m_steps.append([this] { exportBundle(); });
+    for (auto& id : m_actions.toVerify)
+        m_steps.append([this, id] { verify(id); });
+    for (auto& id : m_actions.toVerifyFiles)
+        m_steps.append([this, id] { verifyFiles(id); });
+    for (auto& query : m_actions.modsToFind)
+        m_steps.append([this, query] { findMod(query); });
+    if (!m_actions.toLaunch.isEmpty()) {
+        m_steps.append([this] {
+            auto instance = APPLICATION->instances()->getInstanceById(m_actions.toLaunch);
+            if (!instance) {
+                fail(tr("There is no instance with the ID %1 to launch.").arg(m_actions.toLaunch));
+                return;
+            }
+            auto account = m_actions.profileToUse.isEmpty() ? APPLICATION->accounts()->defaultAccount()
+                                                            : APPLICATION->accounts()->getAccountByProfileName(m_actions.profileToUse);
+            if (!account) {
+                fail(m_actions.profileToUse.isEmpty() ? tr("There is no default account to launch %1 with.").arg(instance->name())
+                                                      : tr("There is no account with the profile %1.").arg(m_actions.profileToUse));
+                return;
+            }
+            login(instance, account, 0);
+        });
+    }
+    next();
+}
+
+void HeadlessRunner::next()
+{
+    if (m_steps.isEmpty()) {
+        if (m_failures)
+            print(tr("%n step(s) failed.", nullptr, m_failures));
+        emit finished(m_failures ? 1 : 0);
+        return;
+    }
+    auto step = m_steps.takeFirst();
+    step();
+}
+
+void HeadlessRunner::fail(const QString& reason)
+{
+    printError(reason);
+    stepDone(false);
+}
+
+void HeadlessRunner::stepDone(bool succeeded)
+{
+    if (!succeeded)
+        m_failures++;
+    next();
+}
+
+void HeadlessRunner::runTask(Task::Ptr task, const QString& what, std::function<void(bool)> done)
+{
+    m_running.append(task);
+    auto percent = std::make_shared<int>(-1);
+    connect(task.get(), &Task::status, this, [what](const QString& status) { print(QString("%1: %2").arg(what, status)); });
+    connect(task.get(), &Task::progress, this, [what, percent](qint64 current, qint64 total) {
+        if (total <= 0)
+            return;
+        // every percent at most, downloads report a lot more often than that
+        int now = static_cast<int>(current * 100 / total);
+        if (now == *percent)
+            return;
+        *percent = now;
+        print(QString("%1: %2%").arg(what).arg(now));
+    });
+    connect(task.get(), &Task::succeeded, this, [what] { print(QString("%1: done").arg(what)); });
+    connect(task.get(), &Task::failed, this, [what](const QString& reason) { printError(QString("%1 failed: %2").arg(what, reason)); });
+    connect(task.get(), &Task::aborted, this, [what] { printError(QString("%1 was aborted").arg(what)); });
+    connect(task.get(), &Task::finished, this, [this, raw = task.get(), done] {
+        bool succeeded = raw->wasSuccessful();
+        for (int i = 0; i < m_running.size(); i++) {
+            if (m_running[i].get() == raw) {
+                m_running.removeAt(i);
+                break;
+            }
+        }
+        done(succeeded);
+    });
+    // one that is already running, like an account refresh, is just waited for
+    task->start();
+}
+
+void HeadlessRunner::create(const QString& spec)
+{
+    auto separator = spec.lastIndexOf(':');
+    if (separator <= 0 || separator == spec.size() - 1) {
+        fail(tr("Can't create %1, instances are given as <name>:<Minecraft version>.").arg(spec));
+        return;
+    }
+    auto name = spec.left(separator);
+    auto version = spec.mid(separator + 1);
+
+    auto versions = APPLICATION->metadataIndex()->get("net.minecraft");
+    runTask(versions->getLoadTask(), tr("Loading the Minecraft versions"), [this, versions, name, version](bool loaded) {
+        if (!loaded) {
+            stepDone(false);
+            return;
+        }
+        if (!versions->hasVersion(version)) {
+            fail(tr("Can't create %1, there is no Minecraft version %2.").arg(name, version));
+            return;
+        }
+        auto task = new VanillaCreationTask(versions->getVersion(version));
+        task->setName(name);
+        createFrom(task, tr("Creating %1").arg(name));
+    });
+}
+
+void HeadlessRunner::import(const QUrl& url)
+{
+    // nothing to ask about updating an instance without a GUI, they are just updated
+    auto task = new InstanceImportTask(url);
+    task->setName(QFileInfo(url.fileName()).completeBaseName());
+    task->setConfirmUpdate(false);
+    createFrom(task, tr("Importing %1").arg(url.toDisplayString()));
+}
+
+void HeadlessRunner::createFrom(InstanceTask* task, const QString& what)
+{
+    task->setIcon("default");
+    Task::Ptr wrapped(APPLICATION->instances()->wrapInstanceTask(task));
+    runTask(wrapped, what, [this](bool succeeded) { stepDone(succeeded); });
+}
+
+void HeadlessRunner::update()
+{
+    QList<InstancePtr> instances;
+    auto ids = m_actions.toUpdate + m_added;
+    ids.removeDuplicates();
+    for (auto& id : ids) {
+        auto instance = APPLICATION->instances()->getInstanceById(id);
+        if (!instance) {
+            printError(tr("Can't update instance %1 as it doesn't exist.").arg(id));
+            m_failures++;
+            continue;
+        }
+        instances.append(instance);
+    }
+    if (instances.isEmpty()) {
+        next();
+        return;
+    }
+    runTask(makeShared<BulkUpdateTask>(instances), tr("Updating %n instance(s)", nullptr, instances.size()),
+            [this](bool succeeded) { stepDone(succeeded); });
+}
+
+void HeadlessRunner::importBundle(const QString& path)
+{
+    auto task = makeShared<OfflineBundleImportTask>(path);
+    runTask(task, tr("Importing the bundle %1").arg(QFileInfo(path).fileName()), [this, raw = task.get()](bool succeeded) {
+        m_bundled.append(raw->importedInstances());
+        stepDone(succeeded);
+    });
+}
+
+void HeadlessRunner::exportBundle()
+{
+    QList<InstancePtr> instances;
+    auto ids = m_actions.toUpdate + m_added;
+    ids.removeDuplicates();
+    for (auto& id : ids) {
+        if (auto instance = APPLICATION->instances()->getInstanceById(id))
+            instances.append(instance);
+    }
+    if (instances.isEmpty()) {
+        fail(tr("There are no instances to put in the bundle, they are given with --update."));
+        return;
+    }
+    runTask(makeShared<OfflineBundleExportTask>(instances, m_actions.bundleToExport),
+            tr("Bundling %n instance(s)", nullptr, instances.size()), [this](bool succeeded) { stepDone(succeeded); });
+}
+
+void HeadlessRunner::verify(const QString& id)
+{
+    auto instance = APPLICATION->instances()->getInstanceById(id);
+    if (!instance) {
+        fail(tr("Can't verify instance %1 as it doesn't exist.").arg(id));
+        return;
+    }
+    // the offline update loads the components and checks the files without downloading anything
+    auto task = instance->createUpdateTask(Net::Mode::Offline);
+    if (!task) {
+        fail(tr("Instance %1 can't be verified.").arg(instance->name()));
+        return;
+    }
+    runTask(task, tr("Verifying %1").arg(instance->name()), [this](bool succeeded) { stepDone(succeeded); });
+}
+
+void HeadlessRunner::verifyFiles(const QString& id)
+{
+    auto instance = std::dynamic_pointer_cast<MinecraftInstance>(APPLICATION->instances()->getInstanceById(id));
+    if (!instance) {
+        fail(tr("Can't verify the files of instance %1 as it doesn't exist or isn't a Minecraft instance.").arg(id));
+        return;
+    }
+    auto task = makeShared<InstanceVerifyTask>(instance);
+    runTask(task, tr("Verifying the files of %1").arg(instance->name()), [this, raw = task.get()](bool succeeded) {
+        // a failure already printed the report as its reason
+        if (succeeded)
+            print(raw->report());
+        stepDone(succeeded);
+    });
+}
+
+void HeadlessRunner::findMod(const QString& query)
+{
+    auto index = APPLICATION->instanceModIndex();
+    auto report = [this, index, query] {
+        static ModPlatform::ProviderCapabilities ProviderCaps;
+        auto found = index->find(query);
+        print(tr("%n mod(s) matching %1:", nullptr, found.size()).arg(query));
+        // one per line, tab separated for scripts: instance, file, mod ID, version, enabled, provider:project
+        for (auto& entry : found) {
+            print(QString("%1\t%2\t%3\t%4\t%5\t%6")
+                      .arg(entry.instanceId, entry.fileName, entry.modId, entry.version, entry.enabled ? QString("enabled") : QString("disabled"),
+                           entry.hasMetadata ? QString("%1:%2").arg(ProviderCaps.name(entry.provider), entry.projectId) : QString("-")));
+        }
+        stepDone(true);
+    };
+    if (index->isReady()) {
+        report();
+        return;
+    }
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    *connection = connect(index.get(), &InstanceModIndex::ready, this, [connection, report] {
+        QObject::disconnect(*connection);
+        report();
+    });
+    index->build();
+}
+
+void HeadlessRunner::login(InstancePtr instance, MinecraftAccountPtr account, int tries)
+{
+    auto session = std::make_shared<AuthSession>();
+    session->wants_online = true;
+    account->fillSession(session);
+
+    if (account->isOffline()) {
+        launch(instance, session);
+        return;
+    }
+
+    switch (account->accountState()) {
+        case AccountState::Offline: {
+            auto lastOfflinePlayerName = APPLICATION->settings()->get("LastOfflinePlayerName").toString();
+            session->wants_online = false;
+            session->MakeOffline(lastOfflinePlayerName.isEmpty() ? session->player_name : lastOfflinePlayerName);
+            launch(instance, session);
+            return;
+        }
+        case AccountState::Online: {
+            if (!account->ownsMinecraft() || !account->hasProfile()) {
+                fail(tr("The account %1 can't play Minecraft, it doesn't own it or has no profile.").arg(account->profileName()));
+                return;
+            }
+            launch(instance, session);
+            return;
+        }
+        case AccountState::Errored:
+        case AccountState::Unchecked:
+        case AccountState::Working: {
+            // the same as the GUI, a few refreshes before giving up
+            if (tries >= 3 && m_bundled.contains(instance->id())) {
+                // a machine a bundle was brought to likely can't reach the servers, the game can still be played
+                printError(tr("Couldn't log in with the account %1, launching %2 offline.").arg(account->profileName(), instance->name()));
+                session->wants_online = false;
+                session->MakeOffline(account->profileName());
+                launch(instance, session);
+                return;
+            }
+            if (tries >= 3) {
+                fail(tr("Couldn't log in with the account %1 after %2 tries.").arg(account->profileName()).arg(tries));
+                return;
+            }
+            runTask(account->refresh(), tr("Logging in with %1").arg(account->profileName()),
+                    [this, instance, account, tries](bool) { login(instance, account, tries + 1); });
+            return;
+        }
+        case AccountState::Expired:
+            fail(tr("The account has expired and needs to be logged into manually again."));
+            return;
+        case AccountState::Disabled:
+            fail(tr("The launcher's client identification has changed. Please remove this account and add it again."));
+            return;
+        case AccountState::Gone:
+            fail(tr("The account no longer exists on the servers. It may have been migrated, in which case please add the new account you migrated this one to."));
+            return;
+    }
+    fail(tr("Failed to launch."));
+}
+
+void HeadlessRunner::launch(InstancePtr instance, AuthSessionPtr session)
+{
+    if (!instance->reloadSettings()) {
+        fail(tr("Couldn't load the instance profile."));
+        return;
+    }
+
+    MinecraftServerTargetPtr serverToJoin;
+    if (!m_actions.serverToJoin.isEmpty())
+        serverToJoin.reset(new MinecraftServerTarget(MinecraftServerTarget::parse(m_actions.serverToJoin)));
+
+    m_launch = instance->createLaunchTask(session, serverToJoin);
+    if (!m_launch) {
+        fail(tr("Couldn't instantiate a launcher."));
+        return;
+    }
+
+    // no profiler to set up, the game is started as soon as it can be
+    connect(m_launch.get(), &LaunchTask::readyForLaunch, m_launch.get(), &LaunchTask::proceed);
+
+    // the game log goes to the console
+    auto log = m_launch->getLogModel();
+    connect(log.get(), &QAbstractItemModel::rowsInserted, this, [log](const QModelIndex&, int first, int last) {
+        for (int row = first; row <= last; row++)
+            print(log->data(log->index(row), Qt::DisplayRole).toString());
+    });
+
+    auto mode = session->wants_online ? "online" : "offline";
+    m_launch->prependStep(makeShared<TextPrint>(m_launch.get(), QString("Launched instance in %1 mode\n").arg(mode), MessageLevel::Launcher));
+    m_launch->prependStep(makeShared<TextPrint>(
+        m_launch.get(), BuildConfig.LAUNCHER_DISPLAYNAME + " version: " + BuildConfig.printableVersionString() + "\n\n", MessageLevel::Launcher));
+
+    // the launch only finishes once the game is closed again
+    runTask(m_launch, tr("Launching %1").arg(instance->name()), [this](bool succeeded) { stepDone(succeeded); });
+}
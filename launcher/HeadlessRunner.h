@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+
+#include <functional>
+
+#include "BaseInstance.h"
+#include "QObjectPtr.h"
+#include "minecraft/auth/MinecraftAccount.h"
+#include "tasks/Task.h"
+
+class InstanceTask;
+class LaunchTask;
+
+/* Does what was asked for on the command line with --headless: creates, imports, updates, verifies and launches
+ * instances with the same tasks the GUI uses, printing their progress instead of showing dialogs.
+ *
+ * The steps run in that order, and instances created or imported by the earlier ones are updated along with the
+ * ones asked for. Bundles (see OfflineBundle) are imported before anything else, their instances aren't updated as
+ * the machine may have no network, and the bundle to export is made once the instances are updated. finished() is emitted once everything is done, with the exit code for the launcher.
+ */
+class HeadlessRunner : public QObject {
+    Q_OBJECT
+   public:
+    struct Actions {
+        /** As "<name>:<Minecraft version>". */
+        QStringList toCreate;
+        QList<QUrl> toImport;
+        QStringList toUpdate;
+        QStringList toVerify;
+        /** Hashed and repaired, see InstanceVerifyTask. */
+        QStringList toVerifyFiles;
+        /** Printed with the instances that have them, see InstanceModIndex::find(). */
+        QStringList modsToFind;
+        QStringList bundlesToImport;
+        /** Of the instances that get updated. */
+        QString bundleToExport;
+        QString toLaunch;
+        QString serverToJoin;
+        QString profileToUse;
+    };
+
+    explicit HeadlessRunner(Actions actions, QObject* parent = nullptr);
+
+    void start();
+
+   signals:
+    void finished(int exitCode);
+
+   private:
+    void next();
+    void fail(const QString& reason);
+    void stepDone(bool succeeded);
+
+    /** Runs `task` with its progress printed as `what`, and calls `done` with whether it succeeded. */
+    void runTask(Task::Ptr task, const QString& what, std::function<void(bool)> done);
+
+    void create(const QString& spec);
+    void import(const QUrl& url);
+    void createFrom(InstanceTask* task, const QString& what);
+    void update();
+    void importBundle(const QString& path);
+    void exportBundle();
+    void verify(const QString& id);
+    void verifyFiles(const QString& id);
+    void findMod(const QString& query);
+    void login(InstancePtr instance, MinecraftAccountPtr account, int tries);
+    void launch(InstancePtr instance, AuthSessionPtr session);
+
+   private:
+    Actions m_actions;
+    QList<std::function<void()>> m_steps;
+    /** The ones created or imported so far, they get updated too. */
+    QStringList m_added;
+    /** The ones that came with a bundle, they may be launched without logging in. */
+    QStringList m_bundled;
+    QList<Task::Ptr> m_running;
+    shared_qobject_ptr<LaunchTask> m_launch;
+    int m_failures = 0;
+};
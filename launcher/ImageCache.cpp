@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ImageCache.h"
+
+#include <QCoreApplication>
+#include <QPixmapCache>
+#include <QThread>
+
+ImageCache& ImageCache::instance()
+{
+    static ImageCache s_instance;
+    return s_instance;
+}
+
+ImageCache::ImageCache(qint64 budget) : m_images(budget) {}
+
+auto ImageCache::insert(const QImage& image) -> Key
+{
+    auto key = m_nextKey.fetch_add(1, std::memory_order_relaxed);
+    if (!m_images.insert(key, image, image.sizeInBytes()))
+        return 0;
+    return key;
+}
+
+bool ImageCache::find(Key key, QImage* image) const
+{
+    if (key == 0)
+        return false;
+    return m_images.find(key, image);
+}
+
+void ImageCache::remove(Key key)
+{
+    if (key == 0)
+        return;
+
+    m_images.remove(key);
+    // a stale pixmap of it in QPixmapCache can't be found anymore, as keys aren't used twice, and it goes away by itself
+}
+
+void ImageCache::clear()
+{
+    m_images.clear();
+}
+
+int ImageCache::count() const
+{
+    return m_images.stats().count;
+}
+
+qint64 ImageCache::size() const
+{
+    return m_images.stats().bytes;
+}
+
+bool ImageCache::pixmap(Key key, QSize size, QPixmap* pixmap) const
+{
+    Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+
+    QImage image;
+    if (!find(key, &image))
+        return false;
+    if (size.isNull())
+        size = image.size();
+
+    // converted pixmaps are kept too, they're what gets painted over and over
+    auto pixmapKey = QString("ImageCache/%1/%2x%3").arg(key).arg(size.width()).arg(size.height());
+    if (QPixmapCache::find(pixmapKey, pixmap))
+        return true;
+
+    *pixmap = QPixmap::fromImage(size == image.size() ? image : image.scaled(size));
+    QPixmapCache::insert(pixmapKey, *pixmap);
+    return true;
+}
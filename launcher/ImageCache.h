@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QImage>
+#include <QPixmap>
+#include <QSize>
+
+#include <atomic>
+
+#include "ConcurrentCache.h"
+
+/* A cache of images that any thread can put into and take from without waiting for the GUI thread.
+ *
+ * The images are kept as QImage in a ConcurrentCache, within a memory budget. They only become pixmaps when they're
+ * shown, on the GUI thread, see pixmap().
+ */
+class ImageCache {
+   public:
+    /** 0 is never a key. */
+    using Key = quint64;
+
+    static ImageCache& instance();
+
+    explicit ImageCache(qint64 budget = 64 * 1024 * 1024);
+
+    /** The key `image` can be found by, 0 when it's too big for the cache. */
+    Key insert(const QImage& image);
+    bool find(Key key, QImage* image) const;
+    void remove(Key key);
+    /** Drops all the images, the keys handed out so far aren't found anymore. */
+    void clear();
+
+    /** How many images are kept. */
+    int count() const;
+    /** What the kept images take, in bytes. */
+    qint64 size() const;
+    ConcurrentCache<Key, QImage>::Stats stats() const { return m_images.stats(); }
+
+    /** The image as a pixmap of `size` (the image's own size when that's null), only on the GUI thread. */
+    bool pixmap(Key key, QSize size, QPixmap* pixmap) const;
+
+   private:
+    ConcurrentCache<Key, QImage> m_images;
+    std::atomic<Key> m_nextKey{ 1 };
+};
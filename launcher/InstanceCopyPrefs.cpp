@@ -22,7 +22,8 @@ QString InstanceCopyPrefs::getSelectedFiltersAsRegex() const
 {
     return getSelectedFiltersAsRegex({});
 }
-QString InstanceCopyPrefs::getSelectedFiltersAsRegex(const QStringList& additionalFilters) const
+
+QStringList InstanceCopyPrefs::getSelectedFilters() const
 {
     QStringList filters;
 
@@ -47,6 +48,13 @@ QString InstanceCopyPrefs::getSelectedFiltersAsRegex(const QStringList& addition
     if(!copyScreenshots)
         filters << "screenshots";
 
+    return filters;
+}
+
+QString InstanceCopyPrefs::getSelectedFiltersAsRegex(const QStringList& additionalFilters) const
+{
+    QStringList filters = getSelectedFilters();
+
     for (auto filter : additionalFilters) {
         filters << filter;
     }
@@ -127,6 +135,11 @@ bool InstanceCopyPrefs::isUseCloneEnabled() const
     return useClone;
 }
 
+bool InstanceCopyPrefs::isLayerEnabled() const
+{
+    return layer;
+}
+
 // ======= Setters =======
 void InstanceCopyPrefs::enableCopySaves(bool b)
 {
@@ -191,4 +204,9 @@ void InstanceCopyPrefs::enableDontLinkSaves(bool b)
 void InstanceCopyPrefs::enableUseClone(bool b)
 {
     useClone = b;
+}
+
+void InstanceCopyPrefs::enableLayer(bool b)
+{
+    layer = b;
 }
\ No newline at end of file
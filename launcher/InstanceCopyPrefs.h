@@ -9,6 +9,8 @@
 struct InstanceCopyPrefs {
    public:
     [[nodiscard]] bool allTrue() const;
+    // the files and folders of the game folder that aren't copied (ex: "saves", "servers.dat")
+    [[nodiscard]] QStringList getSelectedFilters() const;
     [[nodiscard]] QString getSelectedFiltersAsRegex() const;
     [[nodiscard]] QString getSelectedFiltersAsRegex(const QStringList& additionalFilters) const;
     // Getters
@@ -25,6 +27,7 @@ struct InstanceCopyPrefs {
     [[nodiscard]] bool isUseHardLinksEnabled() const;
     [[nodiscard]] bool isDontLinkSavesEnabled() const;
     [[nodiscard]] bool isUseCloneEnabled() const;
+    [[nodiscard]] bool isLayerEnabled() const;
     // Setters
     void enableCopySaves(bool b);
     void enableKeepPlaytime(bool b);
@@ -39,6 +42,7 @@ struct InstanceCopyPrefs {
     void enableUseHardLinks(bool b);
     void enableDontLinkSaves(bool b);
     void enableUseClone(bool b);
+    void enableLayer(bool b);
 
    protected: // data
     bool copySaves = true;
@@ -54,4 +58,6 @@ struct InstanceCopyPrefs {
     bool useHardLinks = false;
     bool dontLinkSaves = false;
     bool useClone = false;
+    // only keep what differs from the original, see InstanceLayer
+    bool layer = false;
 };
@@ -1,9 +1,11 @@
 #include "InstanceCopyTask.h"
 #include <QDebug>
 #include <QtConcurrentRun>
+#include "Executors.h"
 #include "FileSystem.h"
 #include "NullInstance.h"
-#include "pathmatcher/RegexpMatcher.h"
+#include "minecraft/InstanceLayer.h"
+#include "pathmatcher/PathRuleMatcher.h"
 #include "settings/INISettingsObject.h"
 
 InstanceCopyTask::InstanceCopyTask(InstancePtr origInstance, const InstanceCopyPrefs& prefs)
@@ -15,23 +17,28 @@ InstanceCopyTask::InstanceCopyTask(InstancePtr origInstance, const InstanceCopyP
     m_useHardLinks = prefs.isLinkRecursivelyEnabled() && prefs.isUseHardLinksEnabled();
     m_copySaves = prefs.isLinkRecursivelyEnabled() && prefs.isDontLinkSavesEnabled() && prefs.isCopySavesEnabled();
     m_useClone = prefs.isUseCloneEnabled();
-
-    QString filters = prefs.getSelectedFiltersAsRegex();
-    if (m_useLinks || m_useHardLinks) {
-        if (!filters.isEmpty())
-            filters += "|";
-        filters += "instance.cfg";
+    m_layer = prefs.isLayerEnabled();
+    if (m_layer) {
+        // the files of the original are placed by the layer, the links and clones don't apply
+        m_useLinks = m_useHardLinks = m_useClone = false;
+        m_copySaves = prefs.isCopySavesEnabled();
     }
 
+    auto filters = prefs.getSelectedFilters();
     qDebug() << "CopyFilters:" << filters;
 
-    if (!filters.isEmpty()) {
-        // Set regex filter:
-        // FIXME: get this from the original instance type...
-        auto matcherReal = new RegexpMatcher(filters);
-        matcherReal->caseSensitive(false);
-        m_matcher.reset(matcherReal);
+    // FIXME: get this from the original instance type...
+    auto matcher = std::make_unique<PathRuleMatcher>();
+    matcher->caseSensitive(false);
+    for (auto& filter : filters) {
+        matcher->addPath("minecraft/" + filter);
+        matcher->addPath(".minecraft/" + filter);
     }
+    if (m_useLinks || m_useHardLinks)
+        matcher->addPath("instance.cfg");
+
+    if (!filters.isEmpty() || m_useLinks || m_useHardLinks)
+        m_matcher = std::move(matcher);
 }
 
 void InstanceCopyTask::executeTask()
@@ -54,9 +61,28 @@ void InstanceCopyTask::executeTask()
         return savesCopy();
     };
 
-    m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), [this, copySaves] {
-        if (m_useClone) {
-            FS::clone folderClone(m_origInstance->instanceRoot(), m_stagingPath);
+    m_copyFuture = QtConcurrent::run(Executors::io(), [this, copySaves] {
+        if (m_layer) {
+            // the settings of the instance, and its worlds if asked for, the rest gets placed from the original
+            if (!FS::ensureFolderPathExists(m_stagingPath) ||
+                !QFile::copy(FS::PathCombine(m_origInstance->instanceRoot(), "instance.cfg"), FS::PathCombine(m_stagingPath, "instance.cfg")))
+                return false;
+            auto gameFolder = QDir(m_origInstance->instanceRoot()).relativeFilePath(m_origInstance->gameRoot());
+            InstanceLayer layer({ m_stagingPath, FS::PathCombine(m_stagingPath, gameFolder), m_origInstance->instanceRoot(),
+                                  m_origInstance->gameRoot() });
+            auto result = layer.compose();
+            if (!result.error.isEmpty()) {
+                qWarning() << "Couldn't layer the instance:" << result.error;
+                return false;
+            }
+            return !m_copySaves || copySaves();
+        } else if (m_useClone) {
+            if (!FS::canClone(m_origInstance->instanceRoot(), m_stagingPath)) {
+                qWarning() << "Can not clone: not same device or not clone/reflink filesystem";
+                return false;
+            }
+            // FS::copy clones whatever it can
+            FS::copy folderClone(m_origInstance->instanceRoot(), m_stagingPath);
             folderClone.matcher(m_matcher.get());
 
             return folderClone();
@@ -144,6 +170,11 @@ void InstanceCopyTask::copyFinished()
     }
     if (m_useLinks)
         inst->addLinkedInstanceId(m_origInstance->id());
+    if (m_layer) {
+        inst->setLayeredOn(m_origInstance->id());
+        // deleting the original warns about the instances made on it
+        inst->addLinkedInstanceId(m_origInstance->id());
+    }
     if (m_useLinks) {
         auto allowed_symlinks_file = QFileInfo(FS::PathCombine(inst->gameRoot(), "allowed_symlinks.txt"));
 
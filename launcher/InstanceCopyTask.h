@@ -35,4 +35,5 @@ private:
     bool m_copySaves = false;
     bool m_linkRecursively = false;
     bool m_useClone = false;
+    bool m_layer = false;
 };
@@ -0,0 +1,237 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "InstanceDedupTask.h"
+
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QHash>
+#include <QPair>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+#include "Executors.h"
+#include "FileSystem.h"
+#include "StringUtils.h"
+#include "modplatform/helpers/HashUtils.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+// what the game reads or replaces as a whole, so sharing it through a hard link is safe
+const QStringList s_archive_suffixes = { "jar", "zip", "litemod" };
+// not worth a lookup for each, whatever is smaller
+constexpr qint64 s_min_size = 4096;
+
+struct File {
+    QString path;
+    qint64 size = 0;
+    qint64 mtime = 0;
+    int root = 0;
+};
+
+struct Scan {
+    QString root;
+    int index = 0;
+    QList<File> files;
+};
+
+void scan(Scan& scan)
+{
+    QDirIterator it(scan.root, QDir::Files | QDir::Hidden | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        auto info = it.fileInfo();
+        if (info.size() < s_min_size || !s_archive_suffixes.contains(info.suffix().toLower()))
+            continue;
+        scan.files.append({ info.absoluteFilePath(), info.size(), info.lastModified().toMSecsSinceEpoch(), scan.index });
+    }
+}
+
+bool unchanged(const File& file)
+{
+    QFileInfo info(file.path);
+    return info.isFile() && info.size() == file.size && info.lastModified().toMSecsSinceEpoch() == file.mtime;
+}
+
+/* Puts a clone or hard link of `keeper` in place of `copy`, through a file next to it, so `copy` is never missing. */
+bool replace(const QString& keeper, const QString& copy, bool clone)
+{
+    auto temp = copy + ".dedup";
+    auto temp_path = StringUtils::toStdString(temp);
+    std::error_code err;
+    fs::remove(temp_path, err);
+    err.clear();
+
+    if (clone)
+        FS::clone_file_data(keeper, temp, err);
+    else
+        fs::create_hard_link(StringUtils::toStdString(keeper), temp_path, err);
+    if (!err)
+        fs::rename(temp_path, StringUtils::toStdString(copy), err);
+    if (err) {
+        qDebug() << "Could not" << (clone ? "clone" : "hard link") << keeper << "to" << copy << ":" << QString::fromStdString(err.message());
+        std::error_code ignored;
+        fs::remove(temp_path, ignored);
+        return false;
+    }
+    return true;
+}
+}  // namespace
+
+InstanceDedupTask::InstanceDedupTask(const QList<InstancePtr>& instances, bool dry_run, QObject* parent)
+    : Task(parent), m_dry_run(dry_run)
+{
+    for (auto& instance : instances) {
+        // the game may hold its files open
+        if (!instance->isRunning())
+            m_roots.append(instance->instanceRoot());
+    }
+    connect(&m_watcher, &QFutureWatcher<Result>::finished, this, &InstanceDedupTask::done);
+}
+
+InstanceDedupTask::InstanceDedupTask(const QStringList& roots, bool dry_run, QObject* parent)
+    : Task(parent), m_roots(roots), m_dry_run(dry_run)
+{
+    connect(&m_watcher, &QFutureWatcher<Result>::finished, this, &InstanceDedupTask::done);
+}
+
+InstanceDedupTask::~InstanceDedupTask()
+{
+    m_canceled->store(true);
+    m_watcher.waitForFinished();
+}
+
+void InstanceDedupTask::executeTask()
+{
+    setStatus(m_dry_run ? tr("Looking for identical files in %n instance(s)...", nullptr, m_roots.size())
+                        : tr("Sharing the identical files of %n instance(s)...", nullptr, m_roots.size()));
+    m_watcher.setFuture(QtConcurrent::run(Executors::io(), &InstanceDedupTask::deduplicate, m_roots, m_dry_run, m_canceled));
+}
+
+bool InstanceDedupTask::abort()
+{
+    // the file being replaced is, the others are left as they are
+    m_canceled->store(true);
+    return true;
+}
+
+auto InstanceDedupTask::deduplicate(QStringList roots, bool dry_run, std::shared_ptr<std::atomic_bool> canceled) -> Result
+{
+    Result result;
+
+    std::vector<Scan> scans;
+    for (int i = 0; i < roots.size(); i++)
+        scans.push_back({ roots[i], i, {} });
+    QtConcurrent::blockingMap(scans, scan);
+
+    // only the files with the same size as another can be the same
+    QHash<qint64, QList<File>> by_size;
+    for (auto& scan : scans) {
+        for (auto& file : scan.files)
+            by_size[file.size].append(file);
+    }
+    QList<File> candidates;
+    for (auto& files : by_size) {
+        if (files.size() > 1)
+            candidates.append(files);
+    }
+
+    QList<QFuture<Hashing::FileHashes>> hashes;
+    for (auto& file : candidates)
+        hashes.append(Hashing::hashFileAsync(file.path));
+
+    QHash<QPair<qint64, QString>, QList<File>> groups;
+    for (int i = 0; i < candidates.size(); i++) {
+        if (canceled->load())
+            return result;
+        auto sha1 = hashes[i].result().sha1;
+        if (!sha1.isEmpty())
+            groups[{ candidates[i].size, sha1 }].append(candidates[i]);
+    }
+
+    // whether the files of two instances can be cloned or linked, the instances being on one filesystem each
+    QHash<QPair<int, int>, QPair<bool, bool>> sharing;
+    for (auto& files : groups) {
+        if (files.size() < 2)
+            continue;
+
+        // the copy that already has other names (from the content store, or an earlier run) is kept, the others join it
+        auto link_counts = std::make_shared<QHash<QString, uintmax_t>>();
+        for (auto& file : files)
+            link_counts->insert(file.path, FS::hardLinkCount(file.path));
+        std::stable_sort(files.begin(), files.end(),
+                         [link_counts](const File& a, const File& b) { return link_counts->value(a.path) > link_counts->value(b.path); });
+        auto& keeper = files.first();
+
+        for (int i = 1; i < files.size(); i++) {
+            if (canceled->load())
+                return result;
+            auto& copy = files[i];
+            std::error_code err;
+            if (fs::equivalent(StringUtils::toStdString(keeper.path), StringUtils::toStdString(copy.path), err))
+                continue;
+            result.duplicates++;
+
+            QPair<int, int> roots_pair{ keeper.root, copy.root };
+            if (!sharing.contains(roots_pair))
+                sharing.insert(roots_pair, { FS::canClone(keeper.path, copy.path), FS::canLink(keeper.path, copy.path) });
+            auto [can_clone, can_link] = sharing.value(roots_pair);
+
+            // the data only goes away with the last name it has
+            auto freed = link_counts->value(copy.path) <= 1 ? copy.size : 0;
+            if (!can_clone && !can_link) {
+                result.left++;
+                continue;
+            }
+            if (!dry_run && (!unchanged(copy) || !unchanged(keeper) || !replace(keeper.path, copy.path, can_clone))) {
+                result.left++;
+                continue;
+            }
+            if (can_clone)
+                result.cloned++;
+            else
+                result.linked++;
+            result.reclaimed += freed;
+        }
+    }
+    return result;
+}
+
+void InstanceDedupTask::done()
+{
+    if (m_canceled->load()) {
+        emitAborted();
+        return;
+    }
+    m_result = m_watcher.result();
+    qDebug() << "Deduplication of" << m_roots.size() << "instances" << (m_dry_run ? "would reclaim" : "reclaimed") << m_result.reclaimed
+             << "bytes";
+    emitSucceeded();
+}
+
+QString InstanceDedupTask::report() const
+{
+    if (m_result.duplicates == 0)
+        return tr("The instances have no identical archives that don't share their data already.");
+
+    QStringList lines;
+    lines.append(tr("%n file(s) are copies of another one.", nullptr, m_result.duplicates));
+    auto reclaimed = StringUtils::humanReadableFileSize(m_result.reclaimed);
+    if (m_dry_run)
+        lines.append(tr("%1 would be reclaimed, sharing %2 of them as reflinks and %3 as hard links.")
+                         .arg(reclaimed)
+                         .arg(m_result.cloned)
+                         .arg(m_result.linked));
+    else
+        lines.append(tr("%1 reclaimed, sharing %2 of them as reflinks and %3 as hard links.")
+                         .arg(reclaimed)
+                         .arg(m_result.cloned)
+                         .arg(m_result.linked));
+    if (m_result.left > 0)
+        lines.append(tr("%n file(s) can't share their data, they're on another filesystem or couldn't be replaced.", nullptr,
+                        m_result.left));
+    return lines.join("\n");
+}
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QFutureWatcher>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+#include <memory>
+
+#include "BaseInstance.h"
+#include "tasks/Task.h"
+
+/* Shares the data of the identical archives the instances have, the mods, resource packs and zips they were each given
+ * a copy of before the content store (see ContentStore) was there.
+ *
+ * The instances are scanned in parallel, only the files of the same size are hashed (through the hash cache, see
+ * Hashing::hashFile()), and the copies of a file are replaced by reflinks of one of them where the filesystem can do
+ * it, hard links otherwise. Reflinks are copies on write, so the instances stay independent. Hard links aren't, which
+ * is why only archives are shared: the game only ever reads or replaces those, never writes them in place. Files on
+ * different filesystems are left alone, and so are the instances that are running.
+ *
+ * A dry run only tells how much space would be reclaimed.
+ */
+class InstanceDedupTask : public Task {
+    Q_OBJECT
+   public:
+    struct Result {
+        // files that had the same contents as another, and weren't sharing it already
+        int duplicates = 0;
+        int cloned = 0;
+        int linked = 0;
+        // on another filesystem than the file they're a copy of, or that failed to be replaced
+        int left = 0;
+        qint64 reclaimed = 0;
+    };
+
+    InstanceDedupTask(const QList<InstancePtr>& instances, bool dry_run, QObject* parent = nullptr);
+    /** For the folders of instances themselves. */
+    InstanceDedupTask(const QStringList& roots, bool dry_run, QObject* parent = nullptr);
+    ~InstanceDedupTask() override;
+
+    /** Once the task is done. */
+    const Result& result() const { return m_result; }
+    /** What result() says, for people. */
+    QString report() const;
+
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    void done();
+
+    static Result deduplicate(QStringList roots, bool dry_run, std::shared_ptr<std::atomic_bool> canceled);
+
+   private:
+    QStringList m_roots;
+    bool m_dry_run;
+    Result m_result;
+    std::shared_ptr<std::atomic_bool> m_canceled = std::make_shared<std::atomic_bool>(false);
+    QFutureWatcher<Result> m_watcher;
+};
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "InstanceDeletionTask.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QtConcurrentRun>
+
+#include "Executors.h"
+#include "FileSystem.h"
+
+namespace {
+// the progress is passed on every that many files, there can be a lot of them in a world
+constexpr qint64 s_progress_step = 256;
+
+constexpr auto s_file_filter = QDir::Files | QDir::Hidden | QDir::System;
+}  // namespace
+
+const QString InstanceDeletionTask::s_trash_suffix = ".trash";
+
+InstanceDeletionTask::InstanceDeletionTask(QString tombstones) : m_tombstones(std::move(tombstones)) {}
+
+void InstanceDeletionTask::executeTask()
+{
+    setStatus(tr("Deleting instances..."));
+    m_future = QtConcurrent::run(Executors::background(), [this] { return removeAll(); });
+    connect(&m_watcher, &QFutureWatcher<bool>::finished, this, &InstanceDeletionTask::finish);
+    m_watcher.setFuture(m_future);
+}
+
+bool InstanceDeletionTask::removeAll()
+{
+    auto tombstones = QDir(m_tombstones).entryInfoList(QDir::Dirs | QDir::Files | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+
+    QStringList to_remove;
+    for (auto& tombstone : tombstones) {
+        if (!tombstone.fileName().endsWith(s_trash_suffix)) {
+            to_remove.append(tombstone.absoluteFilePath());
+            continue;
+        }
+        QString location;
+        if (FS::trash(tombstone.absoluteFilePath(), &location)) {
+            emit trashed(tombstone.fileName(), location);
+            continue;
+        }
+        // what can't go to the trash is deleted, the same as when there's no trash at all
+        to_remove.append(tombstone.absoluteFilePath());
+        emit trashed(tombstone.fileName(), {});
+    }
+    if (to_remove.isEmpty())
+        return true;
+
+    // counting first costs a walk of the folders, but it's nothing next to removing the files
+    qint64 total = 0;
+    for (auto& path : to_remove) {
+        QDirIterator it(path, s_file_filter, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            total++;
+        }
+    }
+    setStatus(tr("Deleting %n instance(s)...", "", to_remove.size()));
+    setProgress(0, total);
+
+    qint64 removed = 0;
+    bool ok = true;
+    for (auto& path : to_remove) {
+        // symbolic links are removed, never followed
+        QDirIterator it(path, s_file_filter, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            QFile::remove(it.next());
+            if (++removed % s_progress_step == 0)
+                setProgress(removed, total);
+        }
+        // the folders, and the files that couldn't be removed one by one
+        if (!FS::deletePath(path)) {
+            qWarning() << "Couldn't remove all of" << path << "it's tried again next time";
+            ok = false;
+        }
+    }
+    setProgress(total, total);
+    return ok;
+}
+
+void InstanceDeletionTask::finish()
+{
+    if (m_future.result())
+        emitSucceeded();
+    else
+        emitFailed(tr("Some files of the deleted instances couldn't be removed."));
+}
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QString>
+
+#include "tasks/Task.h"
+
+/* Removes the folders of deleted instances, on the background pool.
+ *
+ * InstanceList moves the folder of an instance into the tombstones folder first, which is only a rename, so the
+ * instance is gone from the list right away however big it is. This removes whatever is in the tombstones folder
+ * then. Folders ending with s_trash_suffix go to the trash instead, or are removed when there's no trash to go to.
+ *
+ * What's left after a crash is still in the tombstones folder, and is removed the next time the task runs.
+ */
+class InstanceDeletionTask : public Task {
+    Q_OBJECT
+   public:
+    static const QString s_trash_suffix;
+
+    explicit InstanceDeletionTask(QString tombstones);
+
+   signals:
+    /** A folder to trash went to the trash, at `location`. Empty when it was removed instead. */
+    void trashed(const QString& tombstone, const QString& location);
+
+   protected:
+    void executeTask() override;
+
+   private:
+    bool removeAll();
+    void finish();
+
+   private:
+    QString m_tombstones;
+    QFuture<bool> m_future;
+    QFutureWatcher<bool> m_watcher;
+};
@@ -37,9 +37,12 @@
 #include "InstanceImportTask.h"
 
 #include "Application.h"
+#include "Executors.h"
 #include "FileSystem.h"
 #include "MMCZip.h"
 #include "NullInstance.h"
+#include "StreamExtractor.h"
+#include "net/ExtractingValidator.h"
 
 #include "QObjectPtr.h"
 #include "icons/IconList.h"
@@ -54,8 +57,6 @@
 #include <QtConcurrentRun>
 #include <algorithm>
 
-#include <quazip/quazipdir.h>
-
 InstanceImportTask::InstanceImportTask(const QUrl sourceUrl, QWidget* parent, QMap<QString, QString>&& extra_info)
     : m_sourceUrl(sourceUrl), m_extra_info(extra_info), m_parent(parent)
 {}
@@ -67,6 +68,10 @@ bool InstanceImportTask::abort()
 
     if (m_filesNetJob)
         m_filesNetJob->abort();
+    if (m_streamExtractor)
+        m_streamExtractor->cancel();
+    if (m_streamFuture.isRunning())
+        m_streamFuture.waitForFinished();
     if (m_extractFuture.isRunning()) {
         // NOTE: The tasks created by QtConcurrent::run() can't actually get cancelled,
         // but we can use this call to check the state when the extraction finishes.
@@ -95,7 +100,12 @@ void InstanceImportTask::executeTask()
         m_archivePath = entry->getFullPath();
 
         m_filesNetJob.reset(new NetJob(tr("Modpack download"), APPLICATION->network()));
-        m_filesNetJob->addNetAction(Net::Download::makeCached(m_sourceUrl, entry));
+        // modpacks can be big, don't start over when the connection drops, and take them in parts when the server lets us
+        auto download = Net::Download::makeCached(m_sourceUrl, entry, Net::Download::Option::Resumable | Net::Download::Option::Segmented);
+        // and extract them while they're downloading, instead of waiting for the download to finish
+        m_streamExtractor = std::make_shared<MMCZip::StreamExtractor>(FS::PathCombine(m_stagingPath, ".streamed"));
+        download->addValidator(new Net::ExtractingValidator(m_streamExtractor));
+        m_filesNetJob->addNetAction(download);
 
         connect(m_filesNetJob.get(), &NetJob::succeeded, this, &InstanceImportTask::downloadSucceeded);
         connect(m_filesNetJob.get(), &NetJob::progress, this, &InstanceImportTask::downloadProgressChanged);
@@ -109,8 +119,74 @@ void InstanceImportTask::executeTask()
 
 void InstanceImportTask::downloadSucceeded()
 {
-    processZipPack();
     m_filesNetJob.reset();
+    if (!m_streamExtractor) {
+        processZipPack();
+        return;
+    }
+
+    // the extraction may still be catching up with the end of the download
+    setStatus(tr("Extracting modpack"));
+    auto extractor = m_streamExtractor;
+    auto archive = m_archivePath;
+    m_streamFuture = QtConcurrent::run(Executors::io(), [extractor, archive] { return extractor->validate(archive); });
+    connect(&m_streamFutureWatcher, &QFutureWatcher<bool>::finished, this, &InstanceImportTask::streamedExtractionFinished);
+    m_streamFutureWatcher.setFuture(m_streamFuture);
+}
+
+void InstanceImportTask::streamedExtractionFinished()
+{
+    auto streamedPath = m_streamExtractor->target();
+    m_streamExtractor.reset();
+    if (m_streamFuture.isCanceled() || !isRunning())
+        return;
+
+    auto fallBack = [this, streamedPath] {
+        FS::deletePath(streamedPath);
+        processZipPack();
+    };
+    if (!m_streamFuture.result()) {
+        qDebug() << "Extracting" << m_archivePath << "again, since it couldn't be extracted while downloading";
+        fallBack();
+        return;
+    }
+
+    MMCZip::ArchiveReader packIndex(m_archivePath);
+    if (!packIndex.open())
+    {
+        FS::deletePath(streamedPath);
+        emitFailed(tr("Unable to open supplied modpack zip file."));
+        return;
+    }
+    QString root;
+    if (!detectModpackType(packIndex, root))
+    {
+        FS::deletePath(streamedPath);
+        emitFailed(tr("Archive does not contain a recognized modpack type."));
+        return;
+    }
+
+    // Only keep the pack itself, like extractSubDir() does
+    QDir extractDir(m_stagingPath);
+    if (m_modpackType == ModpackType::Technic)
+    {
+        extractDir.mkpath(".minecraft");
+        extractDir.cd(".minecraft");
+    }
+    QDir packDir(FS::PathCombine(streamedPath, root));
+    for (auto& name : packDir.entryList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot))
+    {
+        if (!QDir().rename(packDir.absoluteFilePath(name), extractDir.absoluteFilePath(name)))
+        {
+            qWarning() << "Could not move" << name << "into" << extractDir.absolutePath();
+            // what was moved already would be extracted again on top of it
+            fallBack();
+            return;
+        }
+    }
+    FS::deletePath(streamedPath);
+
+    packExtracted();
 }
 
 void InstanceImportTask::downloadFailed(QString reason)
@@ -136,20 +212,42 @@ void InstanceImportTask::processZipPack()
     QDir extractDir(m_stagingPath);
     qDebug() << "Attempting to create instance from" << m_archivePath;
 
-    // open the zip and find relevant files in it
-    m_packZip.reset(new QuaZip(m_archivePath));
-    if (!m_packZip->open(QuaZip::mdUnzip))
+    // index the archive once, to look for the files telling us what kind of pack this is and to extract it
+    m_packIndex = std::make_unique<MMCZip::ArchiveReader>(m_archivePath);
+    if (!m_packIndex->open())
     {
+        m_packIndex.reset();
         emitFailed(tr("Unable to open supplied modpack zip file."));
         return;
     }
 
-    QuaZipDir packZipDir(m_packZip.get());
+    QString root;
+    if(!detectModpackType(*m_packIndex, root))
+    {
+        m_packIndex.reset();
+        emitFailed(tr("Archive does not contain a recognized modpack type."));
+        return;
+    }
+    if (m_modpackType == ModpackType::Technic)
+    {
+        extractDir.mkpath(".minecraft");
+        extractDir.cd(".minecraft");
+    }
+
+    // make sure we extract just the pack
+    auto packIndex = m_packIndex.get();
+    auto target = extractDir.absolutePath();
+    m_extractFuture = QtConcurrent::run(Executors::io(), [packIndex, root, target] { return MMCZip::extractSubDir(*packIndex, root, target); });
+    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &InstanceImportTask::extractFinished);
+    m_extractFutureWatcher.setFuture(m_extractFuture);
+}
 
+bool InstanceImportTask::detectModpackType(const MMCZip::ArchiveReader& packIndex, QString& root)
+{
     // https://docs.modrinth.com/docs/modpacks/format_definition/#storage
-    bool modrinthFound = packZipDir.exists("/modrinth.index.json");
-    bool technicFound = packZipDir.exists("/bin/modpack.jar") || packZipDir.exists("/bin/version.json");
-    QString root;
+    bool modrinthFound = packIndex.contains("modrinth.index.json");
+    bool technicFound = packIndex.contains("bin/modpack.jar") || packIndex.contains("bin/version.json");
+    root.clear();
 
     // NOTE: Prioritize modpack platforms that aren't searched for recursively.
     // Especially Flame has a very common filename for its manifest, which may appear inside overrides for example
@@ -163,41 +261,32 @@ void InstanceImportTask::processZipPack()
     {
         // process as Technic pack
         qDebug() << "Technic:" << technicFound;
-        extractDir.mkpath(".minecraft");
-        extractDir.cd(".minecraft");
         m_modpackType = ModpackType::Technic;
     }
     else
     {
         QStringList paths_to_ignore { "overrides/" };
 
-        if (QString mmcRoot = MMCZip::findFolderOfFileInZip(m_packZip.get(), "instance.cfg", paths_to_ignore); !mmcRoot.isNull()) {
+        // both are looked for in the same pass over the entries
+        auto roots = packIndex.findFoldersOfFiles({ "instance.cfg", "manifest.json" }, paths_to_ignore);
+        if (QString mmcRoot = roots[0]; !mmcRoot.isNull()) {
             // process as MultiMC instance/pack
             qDebug() << "MultiMC:" << mmcRoot;
             root = mmcRoot;
             m_modpackType = ModpackType::MultiMC;
-        } else if (QString flameRoot = MMCZip::findFolderOfFileInZip(m_packZip.get(), "manifest.json", paths_to_ignore); !flameRoot.isNull()) {
+        } else if (QString flameRoot = roots[1]; !flameRoot.isNull()) {
             // process as Flame pack
             qDebug() << "Flame:" << flameRoot;
             root = flameRoot;
             m_modpackType = ModpackType::Flame;
         }
     }
-    if(m_modpackType == ModpackType::Unknown)
-    {
-        emitFailed(tr("Archive does not contain a recognized modpack type."));
-        return;
-    }
-
-    // make sure we extract just the pack
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), MMCZip::extractSubDir, m_packZip.get(), root, extractDir.absolutePath());
-    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &InstanceImportTask::extractFinished);
-    m_extractFutureWatcher.setFuture(m_extractFuture);
+    return m_modpackType != ModpackType::Unknown;
 }
 
 void InstanceImportTask::extractFinished()
 {
-    m_packZip.reset();
+    m_packIndex.reset();
 
     if (m_extractFuture.isCanceled())
         return;
@@ -206,6 +295,11 @@ void InstanceImportTask::extractFinished()
         return;
     }
 
+    packExtracted();
+}
+
+void InstanceImportTask::packExtracted()
+{
     QDir extractDir(m_stagingPath);
 
     qDebug() << "Fixing permissions for extracted pack files...";
@@ -44,9 +44,14 @@
 #include "QObjectPtr.h"
 #include "modplatform/flame/PackManifest.h"
 
+#include <memory>
 #include <optional>
 
-class QuaZip;
+namespace MMCZip
+{
+    class ArchiveReader;
+    class StreamExtractor;
+}
 namespace Flame
 {
     class FileResolvingTask;
@@ -70,6 +75,8 @@ protected:
 
 private:
     void processZipPack();
+    bool detectModpackType(const MMCZip::ArchiveReader& packIndex, QString& root);
+    void packExtracted();
     void processMultiMC();
     void processTechnic();
     void processFlame();
@@ -81,6 +88,7 @@ private slots:
     void downloadProgressChanged(qint64 current, qint64 total);
     void downloadAborted();
     void extractFinished();
+    void streamedExtractionFinished();
 
 private: /* data */
     NetJob::Ptr m_filesNetJob;
@@ -88,9 +96,14 @@ private: /* data */
     QUrl m_sourceUrl;
     QString m_archivePath;
     bool m_downloadRequired = false;
-    std::unique_ptr<QuaZip> m_packZip;
+    // the index of the archive, kept from detecting the kind of pack to extracting it
+    std::unique_ptr<MMCZip::ArchiveReader> m_packIndex;
     QFuture<std::optional<QStringList>> m_extractFuture;
     QFutureWatcher<std::optional<QStringList>> m_extractFutureWatcher;
+    // extracts the pack while it's downloading, falling back to extracting the downloaded archive when it can't
+    std::shared_ptr<MMCZip::StreamExtractor> m_streamExtractor;
+    QFuture<bool> m_streamFuture;
+    QFutureWatcher<bool> m_streamFutureWatcher;
     QVector<Flame::File> m_blockedMods;
     enum class ModpackType{
         Unknown,
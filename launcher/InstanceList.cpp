@@ -33,6 +33,7 @@
  *      limitations under the License.
  */
 
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
@@ -51,14 +52,19 @@
 #include <QXmlStreamReader>
 
 #include "BaseInstance.h"
+#include "DiskUsage.h"
 #include "ExponentialSeries.h"
 #include "FileSystem.h"
+#include "InstanceDeletionTask.h"
 #include "InstanceList.h"
 #include "InstanceTask.h"
+#include "MemoryAccounting.h"
 #include "NullInstance.h"
+#include "StringUtils.h"
 #include "WatchLock.h"
 #include "minecraft/MinecraftInstance.h"
 #include "settings/INISettingsObject.h"
+#include "tasks/TaskTrace.h"
 
 #ifdef Q_OS_WIN32
 #include <Windows.h>
@@ -66,8 +72,11 @@
 
 const static int GROUP_FILE_FORMAT_VERSION = 1;
 
+// where the folders of deleted instances wait to be removed, in the instance folder so moving them there is a rename
+const static QString TOMBSTONES_DIR = ".LAUNCHER_DELETED";
+
 InstanceList::InstanceList(SettingsObjectPtr settings, const QString& instDir, QObject* parent)
-    : QAbstractListModel(parent), m_globalSettings(settings)
+    : QAbstractListModel(parent), m_globalSettings(settings), m_summaryCache(QDir("cache").absoluteFilePath("instances"))
 {
     resumeWatch();
     // Create aand normalize path
@@ -82,9 +91,34 @@ InstanceList::InstanceList(SettingsObjectPtr settings, const QString& instDir, Q
     m_watcher = new QFileSystemWatcher(this);
     connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &InstanceList::instanceDirContentsChanged);
     m_watcher->addPath(m_instDir);
+
+    m_groupSaveTimer.setSingleShot(true);
+    m_groupSaveTimer.setInterval(1000);
+    connect(&m_groupSaveTimer, &QTimer::timeout, this, &InstanceList::saveGroupListNow);
+
+    m_dirChangeTimer.setSingleShot(true);
+    m_dirChangeTimer.setInterval(500);
+    connect(&m_dirChangeTimer, &QTimer::timeout, this, &InstanceList::applyDirChanges);
+
+    // the folder models and logs of the instances are counted on their own
+    MemoryAccounting::track(this, "Instances", [this] {
+        MemoryAccounting::Usage usage;
+        usage.items = m_instances.size();
+        for (auto& instance : m_instances)
+            usage.bytes += qint64(sizeof(MinecraftInstance)) + MemoryAccounting::bytesOf(instance->name()) +
+                           MemoryAccounting::bytesOf(instance->instanceRoot());
+        return usage;
+    });
+
+    // what a crash left there
+    reapTombstones();
 }
 
-InstanceList::~InstanceList() {}
+InstanceList::~InstanceList()
+{
+    if (m_groupSaveTimer.isActive())
+        saveGroupListNow();
+}
 
 Qt::DropActions InstanceList::supportedDragActions() const
 {
@@ -139,6 +173,16 @@ QStringList InstanceList::getLinkedInstancesById(const QString &id) const
     return linkedInstances;
 }
 
+void InstanceList::setDiskUsage(DiskUsage *usage)
+{
+    m_diskUsage = usage;
+    connect(usage, &DiskUsage::updated, this, [this](const QString &id) {
+        auto index = getInstanceIndexById(id);
+        if (index.isValid())
+            emit dataChanged(index, index, { Qt::ToolTipRole });
+    });
+}
+
 int InstanceList::rowCount(const QModelIndex& parent) const
 {
     Q_UNUSED(parent);
@@ -181,7 +225,10 @@ QVariant InstanceList::data(const QModelIndex& index, int role) const
     }
     case Qt::ToolTipRole:
     {
-        return pdata->instanceRoot();
+        auto usage = m_diskUsage ? m_diskUsage->usage(pdata->id()) : std::nullopt;
+        if (!usage)
+            return pdata->instanceRoot();
+        return tr("%1\n%2 on disk").arg(pdata->instanceRoot(), StringUtils::humanReadableFileSize(usage->total()));
     }
     case Qt::DecorationRole:
     {
@@ -305,23 +352,28 @@ bool InstanceList::trashInstance(const InstanceId& id)
         return false;
     }
 
+    if (!FS::canTrash()) {
+        qDebug() << "Cannot trash instance" << id << ", there is no trash.";
+        return false;
+    }
+
     auto cachedGroupId = m_instanceGroupIndex[id];
+    auto instanceRoot = inst->instanceRoot();
 
     qDebug() << "Will trash instance" << id;
-    QString trashedLoc;
+    auto tombstone = buryInstance(inst, true);
+    if (tombstone.isEmpty()) {
+        qDebug() << "Trash of instance" << id << "has not been completely successfully...";
+        return false;
+    }
 
     if (m_instanceGroupIndex.remove(id)) {
         saveGroupList();
     }
 
-    if (!FS::trash(inst->instanceRoot(), &trashedLoc)) {
-        qDebug() << "Trash of instance" << id << "has not been completely successfully...";
-        return false;
-    }
-
-    qDebug() << "Instance" << id << "has been trashed by the launcher.";
-    m_trashHistory.push({id, inst->instanceRoot(), trashedLoc, cachedGroupId});
-    
+    // it can be brought back once it's in the trash
+    m_trashing.insert(QFileInfo(tombstone).fileName(), {id, instanceRoot, QString(), cachedGroupId});
+    reapTombstones();
     return true;
 }
 
@@ -365,6 +417,12 @@ void InstanceList::deleteInstance(const InstanceId& id)
     }
 
     qDebug() << "Will delete instance" << id;
+    if (!buryInstance(inst, false).isEmpty()) {
+        reapTombstones();
+        return;
+    }
+
+    // a folder that can't be moved (files in use on Windows, a link to another drive) is removed right away
     if (!FS::deletePath(inst->instanceRoot())) {
         qWarning() << "Deletion of instance" << id << "has not been completely successful ...";
         return;
@@ -373,6 +431,66 @@ void InstanceList::deleteInstance(const InstanceId& id)
     qDebug() << "Instance" << id << "has been deleted by the launcher.";
 }
 
+QString InstanceList::buryInstance(const InstancePtr& inst, bool trash)
+{
+    auto tombstones = FS::PathCombine(m_instDir, TOMBSTONES_DIR);
+    if (!FS::ensureFolderPathExists(tombstones)) {
+        return QString();
+    }
+#ifdef Q_OS_WIN32
+    SetFileAttributesA(tombstones.toStdString().c_str(), FILE_ATTRIBUTE_HIDDEN | FILE_ATTRIBUTE_NOT_CONTENT_INDEXED);
+#endif
+
+    auto tombstone = FS::PathCombine(tombstones, QUuid::createUuid().toString(QUuid::WithoutBraces));
+    if (trash) {
+        tombstone += InstanceDeletionTask::s_trash_suffix;
+    }
+    if (!QDir().rename(inst->instanceRoot(), tombstone)) {
+        qWarning() << "Couldn't move" << inst->instanceRoot() << "out of the way to remove it";
+        return QString();
+    }
+
+    // gone from the list right away, whatever is left to remove
+    emit instancesChanged();
+    return tombstone;
+}
+
+void InstanceList::reapTombstones()
+{
+    if (m_deletion && m_deletion->isRunning()) {
+        m_reapAgain = true;
+        return;
+    }
+    auto tombstones = FS::PathCombine(m_instDir, TOMBSTONES_DIR);
+    if (QDir(tombstones).isEmpty()) {
+        return;
+    }
+
+    m_reapAgain = false;
+    m_deletion.reset(new InstanceDeletionTask(tombstones));
+    connect(m_deletion.get(), &InstanceDeletionTask::trashed, this, [this](const QString& tombstone, const QString& location) {
+        if (!m_trashing.contains(tombstone)) {
+            return;
+        }
+        auto item = m_trashing.take(tombstone);
+        if (location.isEmpty()) {
+            qWarning() << "Instance" << item.id << "couldn't go to the trash, it was deleted.";
+            return;
+        }
+        qDebug() << "Instance" << item.id << "has been trashed by the launcher.";
+        item.trashPath = location;
+        m_trashHistory.push(item);
+        emit trashHistoryChanged();
+    });
+    connect(m_deletion.get(), &Task::finished, this, [this] {
+        if (m_reapAgain) {
+            reapTombstones();
+        }
+    });
+    emit deletionStarted(m_deletion);
+    m_deletion->start();
+}
+
 static QMap<InstanceId, InstanceLocator> getIdMapping(const QList<InstancePtr>& list)
 {
     QMap<InstanceId, InstanceLocator> out;
@@ -388,15 +506,21 @@ static QMap<InstanceId, InstanceLocator> getIdMapping(const QList<InstancePtr>&
     return out;
 }
 
-QList<InstanceId> InstanceList::discoverInstances()
+static qint64 fileStamp(const QString& path)
+{
+    QFileInfo info(path);
+    return info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+QList<InstanceId> InstanceList::scanInstanceDir(QHash<InstanceId, QPair<qint64, qint64>>& stamps) const
 {
-    qDebug() << "Discovering instances in" << m_instDir;
     QList<InstanceId> out;
     QDirIterator iter(m_instDir, QDir::Dirs | QDir::NoDot | QDir::NoDotDot | QDir::Readable | QDir::Hidden, QDirIterator::FollowSymlinks);
     while (iter.hasNext()) {
         QString subDir = iter.next();
         QFileInfo dirInfo(subDir);
-        if (!QFileInfo(FS::PathCombine(subDir, "instance.cfg")).exists())
+        auto configStamp = fileStamp(FS::PathCombine(subDir, "instance.cfg"));
+        if (configStamp < 0)
             continue;
         // if it is a symlink, ignore it if it goes to the instance folder
         if (dirInfo.isSymLink()) {
@@ -409,6 +533,17 @@ QList<InstanceId> InstanceList::discoverInstances()
         }
         auto id = dirInfo.fileName();
         out.append(id);
+        stamps.insert(id, { configStamp, fileStamp(FS::PathCombine(subDir, "mmc-pack.json")) });
+    }
+    return out;
+}
+
+QList<InstanceId> InstanceList::discoverInstances()
+{
+    qDebug() << "Discovering instances in" << m_instDir;
+    m_instanceStamps.clear();
+    auto out = scanInstanceDir(m_instanceStamps);
+    for (auto& id : out) {
         qDebug() << "Found instance ID" << id;
     }
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
@@ -478,6 +613,13 @@ InstanceList::InstListError InstanceList::loadList()
     if (newList.size()) {
         add(newList);
     }
+
+    QSet<QString> instanceRoots;
+    for (auto& instance : m_instances)
+        instanceRoots.insert(instance->instanceRoot());
+    m_summaryCache.retain(instanceRoots);
+    m_summaryCache.save();
+
     m_dirty = false;
     updateTotalPlayTime();
     return NoError;
@@ -485,17 +627,30 @@ InstanceList::InstListError InstanceList::loadList()
 
 void InstanceList::updateTotalPlayTime()
 {
-    totalPlayTime = 0;
+    m_playTimes.clear();
+    m_totalPlayTime = 0;
     for (auto const& itr : m_instances) {
-        totalPlayTime += itr.get()->totalTimePlayed();
+        auto time = itr->totalTimePlayed();
+        m_playTimes.insert(itr->id(), time);
+        m_totalPlayTime += time;
     }
 }
 
+void InstanceList::updatePlayTime(BaseInstance* inst)
+{
+    auto time = inst->totalTimePlayed();
+    auto& known = m_playTimes[inst->id()];
+    m_totalPlayTime += time - known;
+    known = time;
+}
+
 void InstanceList::saveNow()
 {
     for (auto& item : m_instances) {
         item->saveNow();
     }
+    if (m_groupSaveTimer.isActive())
+        saveGroupListNow();
 }
 
 void InstanceList::add(const QList<InstancePtr>& t)
@@ -579,7 +734,16 @@ void InstanceList::propertiesChanged(BaseInstance* inst)
     int i = getInstIndex(inst);
     if (i != -1) {
         emit dataChanged(index(i), index(i));
-        updateTotalPlayTime();
+        updatePlayTime(inst);
+    }
+}
+
+void InstanceList::iconUpdated(const QString& key)
+{
+    // only the icon changed, nothing moves
+    for (int i = 0; i < m_instances.count(); i++) {
+        if (m_instances[i]->iconKey() == key)
+            emit dataChanged(index(i), index(i), { Qt::DecorationRole });
     }
 }
 
@@ -590,10 +754,19 @@ InstancePtr InstanceList::loadInstance(const InstanceId& id)
     }
 
     auto instanceRoot = FS::PathCombine(m_instDir, id);
-    auto instanceSettings = std::make_shared<INISettingsObject>(FS::PathCombine(instanceRoot, "instance.cfg"));
+    QFileInfo configInfo(FS::PathCombine(instanceRoot, "instance.cfg"));
+
+    auto config = m_summaryCache.find(instanceRoot, configInfo);
+    if (!config) {
+        config.emplace();
+        config->loadFile(configInfo.filePath());
+        m_summaryCache.insert(instanceRoot, configInfo, *config);
+    }
+    auto instanceSettings = std::make_shared<INISettingsObject>(configInfo.filePath(), std::move(*config));
+    instanceSettings->setSaveDelay(500);
     InstancePtr inst;
 
-    instanceSettings->registerSetting("InstanceType", "");
+    instanceSettings->declareSetting("InstanceType", "");
 
     QString inst_type = instanceSettings->get("InstanceType").toString();
 
@@ -612,6 +785,12 @@ InstancePtr InstanceList::loadInstance(const InstanceId& id)
 
 void InstanceList::saveGroupList()
 {
+    m_groupSaveTimer.start();
+}
+
+void InstanceList::saveGroupListNow()
+{
+    m_groupSaveTimer.stop();
     qDebug() << "Will save group list now.";
     if (!m_instancesProbed) {
         qDebug() << "Group saving prevented because we don't know the full list of instances yet.";
@@ -756,15 +935,95 @@ void InstanceList::loadGroupList()
 void InstanceList::instanceDirContentsChanged(const QString& path)
 {
     Q_UNUSED(path);
-    emit instancesChanged();
+    // a running game or a sync tool can change things in there many times a second
+    m_dirChangeTimer.start();
+}
+
+void InstanceList::applyDirChanges()
+{
+    if (m_watchLevel != 1 || !m_instancesProbed) {
+        // looked at once the watch resumes
+        m_dirty = true;
+        return;
+    }
+
+    QHash<InstanceId, QPair<qint64, qint64>> stamps;
+    auto found = scanInstanceDir(stamps);
+
+    QList<InstanceId> added;
+    QList<InstanceId> changed;
+    for (auto& id : found) {
+        auto known = m_instanceStamps.constFind(id);
+        if (known == m_instanceStamps.cend())
+            added.append(id);
+        else if (*known != stamps.value(id))
+            changed.append(id);
+    }
+    QList<int> removedRows;
+    for (int i = 0; i < m_instances.size(); i++) {
+        if (!stamps.contains(m_instances[i]->id()))
+            removedRows.append(i);
+    }
+    // only what happens to instance.cfg and mmc-pack.json matters, nothing has to be loaded for the rest
+    m_instanceStamps = stamps;
+    if (added.isEmpty() && changed.isEmpty() && removedRows.isEmpty())
+        return;
+    qDebug() << "Instance folder changed:" << added.size() << "added," << removedRows.size() << "removed," << changed.size() << "changed";
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    instanceSet = QSet<QString>(found.begin(), found.end());
+#else
+    instanceSet = found.toSet();
+#endif
+
+    // from the last row, so the ones before don't move
+    for (int i = removedRows.size() - 1; i >= 0; i--) {
+        auto row = removedRows[i];
+        m_instances[row]->invalidate();
+        beginRemoveRows(QModelIndex(), row, row);
+        m_instances.removeAt(row);
+        endRemoveRows();
+    }
+
+    QList<InstancePtr> newList;
+    for (auto& id : added) {
+        // an instance that was already there under that ID is kept, like loadList() does
+        if (getInstanceById(id))
+            continue;
+        if (auto inst = loadInstance(id))
+            newList.append(inst);
+    }
+    if (!newList.isEmpty()) {
+        add(newList);
+    }
+
+    for (auto& id : changed) {
+        auto inst = getInstanceById(id);
+        if (!inst)
+            continue;
+        // the components are read again when the instance is launched or edited
+        inst->reloadSettings();
+        auto row = getInstIndex(inst.get());
+        emit dataChanged(index(row), index(row));
+    }
+
+    if (!removedRows.isEmpty() || !newList.isEmpty()) {
+        QSet<QString> instanceRoots;
+        for (auto& instance : m_instances)
+            instanceRoots.insert(instance->instanceRoot());
+        m_summaryCache.retain(instanceRoots);
+        m_summaryCache.save();
+    }
+    updateTotalPlayTime();
 }
 
 void InstanceList::on_InstFolderChanged(const Setting& setting, QVariant value)
 {
     QString newInstDir = QDir(value.toString()).canonicalPath();
     if (newInstDir != m_instDir) {
-        if (m_groupsLoaded) {
-            saveGroupList();
+        // what's waiting to be saved belongs to the old folder
+        if (m_groupsLoaded || m_groupSaveTimer.isActive()) {
+            saveGroupListNow();
         }
         m_instDir = newInstDir;
         m_groupsLoaded = false;
@@ -801,6 +1060,11 @@ class InstanceStaging : public Task {
         connect(child, &Task::progress, this, &InstanceStaging::setProgress);
         connect(child, &Task::stepProgress, this, &InstanceStaging::propogateStepProgress);
         connect(&m_backoffTimer, &QTimer::timeout, this, &InstanceStaging::childSucceded);
+        connect(this, &Task::finished, this, [this] {
+            auto trace = TaskTrace::save(*this, "install");
+            if (!trace.isEmpty())
+                qDebug() << "Saved the trace of the install to" << trace;
+        });
     }
 
     virtual ~InstanceStaging(){};
@@ -944,8 +1208,13 @@ bool InstanceList::destroyStagingPath(const QString& keyPath)
 
 int InstanceList::getTotalPlayTime()
 {
-    updateTotalPlayTime();
-    return totalPlayTime;
+    // the instances that are running have played some more since
+    qint64 total = m_totalPlayTime;
+    for (auto& instance : m_instances) {
+        if (instance->isRunning())
+            total += instance->totalTimePlayed() - m_playTimes.value(instance->id());
+    }
+    return total;
 }
 
 #include "InstanceList.moc"
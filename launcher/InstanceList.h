@@ -21,10 +21,17 @@
 #include <QList>
 #include <QStack>
 #include <QPair>
+#include <QPointer>
+#include <QTimer>
 
 #include "BaseInstance.h"
+#include "InstanceSummaryCache.h"
+#include "QObjectPtr.h"
+#include "tasks/Task.h"
 
 class QFileSystemWatcher;
+class DiskUsage;
+class InstanceDeletionTask;
 class InstanceTask;
 struct InstanceName;
 
@@ -113,9 +120,14 @@ public:
     void setInstanceGroup(const InstanceId & id, const GroupId& name);
 
     void deleteGroup(const GroupId & name);
+    /**
+     * The instance is gone from the list right away, its folder goes to the trash in the background (see
+     * InstanceDeletionTask). False when there's no trash to go to, or the folder can't be moved.
+     */
     bool trashInstance(const InstanceId &id);
     bool trashedSomething();
     void undoTrashInstance();
+    /** The instance is gone from the list right away, its folder is removed in the background. */
     void deleteInstance(const InstanceId & id);
 
     // Wrap an instance creation task in some more task machinery and make it ready to be used
@@ -156,35 +168,54 @@ public:
 
     QStringList getLinkedInstancesById(const QString &id) const;
 
+    /** For the tooltips of the instances to tell how much they take on the disk. */
+    void setDiskUsage(DiskUsage *usage);
+
 signals:
     void dataIsInvalid();
     void instancesChanged();
     void instanceSelectRequest(QString instanceId);
     void groupsChanged(QSet<QString> groups);
+    /** Folders of deleted instances are being removed, see InstanceDeletionTask. */
+    void deletionStarted(shared_qobject_ptr<Task> task);
+    /** A trashed instance can be brought back now, see trashedSomething(). */
+    void trashHistoryChanged();
 
 public slots:
     void on_InstFolderChanged(const Setting &setting, QVariant value);
     void on_GroupStateChanged(const QString &group, bool collapsed);
+    void iconUpdated(const QString &key);
 
 private slots:
     void propertiesChanged(BaseInstance *inst);
     void providerUpdated();
     void instanceDirContentsChanged(const QString &path);
+    void applyDirChanges();
 
 private:
     int getInstIndex(BaseInstance *inst) const;
     void updateTotalPlayTime();
+    void updatePlayTime(BaseInstance *inst);
     void suspendWatch();
     void resumeWatch();
     void add(const QList<InstancePtr> &list);
     void loadGroupList();
     void saveGroupList();
+    void saveGroupListNow();
     QList<InstanceId> discoverInstances();
+    // what the instance folders look like now, without loading anything
+    QList<InstanceId> scanInstanceDir(QHash<InstanceId, QPair<qint64, qint64>>& stamps) const;
     InstancePtr loadInstance(const InstanceId& id);
+    /** Moves the folder of the instance among the tombstones, and returns where it went. Empty when it couldn't be moved. */
+    QString buryInstance(const InstancePtr& inst, bool trash);
+    /** Removes the tombstones in the background, again once done if more were added meanwhile. */
+    void reapTombstones();
 
 private:
     int m_watchLevel = 0;
-    int totalPlayTime = 0;
+    // the play time of each instance when it last changed, and their sum
+    QHash<InstanceId, qint64> m_playTimes;
+    qint64 m_totalPlayTime = 0;
     bool m_dirty = false;
     QList<InstancePtr> m_instances;
     QSet<QString> m_groupNameCache;
@@ -196,8 +227,20 @@ private:
     QSet<QString> m_collapsedGroups;
     QMap<InstanceId, GroupId> m_instanceGroupIndex;
     QSet<InstanceId> instanceSet;
+    // when the instance.cfg and mmc-pack.json of each instance last changed, as of the last scan
+    QHash<InstanceId, QPair<qint64, qint64>> m_instanceStamps;
+    // the changes in the instance folder come in bursts, they are looked at once it's quiet
+    QTimer m_dirChangeTimer;
     bool m_groupsLoaded = false;
+    // the group list is written a moment after the last change to it, moving instances around changes it a lot
+    QTimer m_groupSaveTimer;
     bool m_instancesProbed = false;
+    InstanceSummaryCache m_summaryCache;
+    QPointer<DiskUsage> m_diskUsage;
 
     QStack<TrashHistoryItem> m_trashHistory;
+    // the instances on their way to the trash, by their tombstone
+    QHash<QString, TrashHistoryItem> m_trashing;
+    shared_qobject_ptr<InstanceDeletionTask> m_deletion;
+    bool m_reapAgain = false;
 };
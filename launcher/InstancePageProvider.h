@@ -3,7 +3,10 @@
 #include <FileSystem.h>
 #include "ui/pages/BasePage.h"
 #include "ui/pages/BasePageProvider.h"
+#include "ui/pages/LazyPage.h"
 #include "ui/pages/instance/LogPage.h"
+#include "ui/pages/instance/TelemetryPage.h"
+#include "ui/pages/instance/DiskUsagePage.h"
 #include "ui/pages/instance/VersionPage.h"
 #include "ui/pages/instance/ManagedPackPage.h"
 #include "ui/pages/instance/ModFolderPage.h"
@@ -32,27 +35,45 @@ public:
     {
         QList<BasePage *> values;
         values.append(new LogPage(inst));
+        values.append(new TelemetryPage(inst));
         std::shared_ptr<MinecraftInstance> onesix = std::dynamic_pointer_cast<MinecraftInstance>(inst);
         values.append(new VersionPage(onesix.get()));
         values.append(ManagedPackPage::createPage(onesix.get()));
-        auto modsPage = new ModFolderPage(onesix.get(), onesix->loaderModList());
-        modsPage->setFilter("%1 (*.zip *.jar *.litemod *.nilmod)");
-        values.append(modsPage);
-        values.append(new CoreModFolderPage(onesix.get(), onesix->coreModList()));
-        values.append(new NilModFolderPage(onesix.get(), onesix->nilModList()));
-        values.append(new ResourcePackPage(onesix.get(), onesix->resourcePackList()));
-        values.append(new TexturePackPage(onesix.get(), onesix->texturePackList()));
-        values.append(new ShaderPackPage(onesix.get(), onesix->shaderPackList()));
+        // the pages below scan folders or parse files, with their models, they're only built when they're shown
+        values.append(new LazyPage({ "mods", [] { return ModFolderPage::tr("Mods"); }, "loadermods", "Loader-mods" }, [onesix] {
+            auto modsPage = new ModFolderPage(onesix.get(), onesix->loaderModList());
+            modsPage->setFilter("%1 (*.zip *.jar *.litemod *.nilmod)");
+            return modsPage;
+        }));
+        values.append(new LazyPage({ "coremods", [] { return ModFolderPage::tr("Core mods"); }, "coremods", "Core-mods",
+                                     [onesix] { return CoreModFolderPage::shouldDisplayFor(onesix.get()); } },
+                                   [onesix] { return new CoreModFolderPage(onesix.get(), onesix->coreModList()); }));
+        values.append(new LazyPage({ "nilmods", [] { return ModFolderPage::tr("Nilmods"); }, "coremods", "Nilmods",
+                                     [onesix] { return NilModFolderPage::shouldDisplayFor(onesix.get()); } },
+                                   [onesix] { return new NilModFolderPage(onesix.get(), onesix->nilModList()); }));
+        values.append(new LazyPage({ "resourcepacks", [] { return ResourcePackPage::tr("Resource packs"); }, "resourcepacks", "Resource-packs",
+                                     [onesix] { return ResourcePackPage::shouldDisplayFor(onesix.get()); } },
+                                   [onesix] { return new ResourcePackPage(onesix.get(), onesix->resourcePackList()); }));
+        values.append(new LazyPage({ "texturepacks", [] { return TexturePackPage::tr("Texture packs"); }, "resourcepacks", "Texture-packs",
+                                     [onesix] { return TexturePackPage::shouldDisplayFor(onesix.get()); } },
+                                   [onesix] { return new TexturePackPage(onesix.get(), onesix->texturePackList()); }));
+        values.append(new LazyPage({ "shaderpacks", [] { return ShaderPackPage::tr("Shader packs"); }, "shaderpacks", "Resource-packs" },
+                                   [onesix] { return new ShaderPackPage(onesix.get(), onesix->shaderPackList()); }));
         values.append(new NotesPage(onesix.get()));
-        values.append(new WorldListPage(onesix.get(), onesix->worldList()));
-        values.append(new ServersPage(onesix));
+        values.append(new LazyPage({ "worlds", [] { return WorldListPage::tr("Worlds"); }, "worlds", "Worlds" },
+                                   [onesix] { return new WorldListPage(onesix.get(), onesix->worldList()); }));
+        values.append(new LazyPage({ "servers", [] { return ServersPage::tr("Servers"); }, "server", "Servers-management" },
+                                   [onesix] { return new ServersPage(onesix); }));
         // values.append(new GameOptionsPage(onesix.get()));
-        values.append(new ScreenshotsPage(FS::PathCombine(onesix->gameRoot(), "screenshots")));
+        values.append(new LazyPage({ "screenshots", [] { return ScreenshotsPage::tr("Screenshots"); }, "screenshots", "Screenshots-management" },
+                                   [onesix] { return new ScreenshotsPage(FS::PathCombine(onesix->gameRoot(), "screenshots")); }));
+        values.append(new DiskUsagePage(inst));
         values.append(new InstanceSettingsPage(onesix.get()));
         auto logMatcher = inst->getLogFileMatcher();
         if(logMatcher)
         {
-            values.append(new OtherLogsPage(inst->getLogFileRoot(), logMatcher));
+            values.append(new LazyPage({ "logs", [] { return OtherLogsPage::tr("Other logs"); }, "log", "Minecraft-Logs" },
+                                       [instance = inst, logMatcher] { return new OtherLogsPage(instance, instance->getLogFileRoot(), logMatcher); }));
         }
         return values;
     }
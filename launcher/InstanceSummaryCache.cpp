@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "InstanceSummaryCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QSaveFile>
+
+#include "FileSystem.h"
+
+namespace {
+
+constexpr quint32 s_magic = 0x494e5354;  // "INST"
+constexpr quint32 s_version = 1;
+constexpr auto s_stream_version = QDataStream::Qt_5_12;
+
+}  // namespace
+
+InstanceSummaryCache::InstanceSummaryCache(QString file) : m_file(std::move(file)) {}
+
+std::optional<INIFile> InstanceSummaryCache::find(const QString& instance_root, const QFileInfo& config)
+{
+    load();
+
+    auto it = m_entries.constFind(instance_root);
+    if (it == m_entries.constEnd() || it->size != config.size() || it->mtime != config.lastModified().toMSecsSinceEpoch())
+        return {};
+
+    INIFile contents;
+    for (auto value = it->contents.constBegin(); value != it->contents.constEnd(); value++)
+        contents.insert(value.key(), value.value());
+    return contents;
+}
+
+void InstanceSummaryCache::insert(const QString& instance_root, const QFileInfo& config, const INIFile& contents)
+{
+    load();
+
+    m_entries.insert(instance_root, { config.size(), config.lastModified().toMSecsSinceEpoch(), contents });
+    m_dirty = true;
+}
+
+void InstanceSummaryCache::retain(const QSet<QString>& instance_roots)
+{
+    load();
+
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (instance_roots.contains(it.key())) {
+            it++;
+        } else {
+            it = m_entries.erase(it);
+            m_dirty = true;
+        }
+    }
+}
+
+void InstanceSummaryCache::save()
+{
+    if (!m_dirty)
+        return;
+
+    QSaveFile file(m_file);
+    if (!FS::ensureFilePathExists(m_file) || !file.open(QFile::WriteOnly)) {
+        qWarning() << "Could not open the instance cache for writing:" << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(s_stream_version);
+    out << s_magic << s_version << quint32(m_entries.size());
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); it++)
+        out << it.key() << it->size << it->mtime << it->contents;
+
+    if (!file.commit()) {
+        qWarning() << "Could not write the instance cache:" << file.errorString();
+        return;
+    }
+    m_dirty = false;
+}
+
+void InstanceSummaryCache::load()
+{
+    if (m_loaded)
+        return;
+    m_loaded = true;
+
+    QFile file(m_file);
+    if (!file.open(QFile::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setVersion(s_stream_version);
+
+    quint32 magic, version, count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != s_magic || version != s_version)
+        return;
+
+    for (quint32 i = 0; i < count; i++) {
+        QString root;
+        Entry entry;
+        in >> root >> entry.size >> entry.mtime >> entry.contents;
+        if (in.status() != QDataStream::Ok) {
+            // just start over, the instances will be read from their own files
+            m_entries.clear();
+            m_dirty = true;
+            return;
+        }
+        m_entries.insert(root, entry);
+    }
+}
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <optional>
+
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+#include "settings/INIFile.h"
+
+/* Cache of the instance.cfg files of all the instances, in a single file.
+ *
+ * Loading hundreds of instances means opening and parsing hundreds of small files
+ * before the instance list can be shown. With this, only the files that changed
+ * since the last time (according to their size and modification time) are read again.
+ */
+class InstanceSummaryCache {
+   public:
+    explicit InstanceSummaryCache(QString file);
+
+    /** Settings of the instance at 'instance_root', if its instance.cfg ('config') didn't change. */
+    std::optional<INIFile> find(const QString& instance_root, const QFileInfo& config);
+    void insert(const QString& instance_root, const QFileInfo& config, const INIFile& contents);
+
+    /** Forgets about all the instances not in 'instance_roots'. */
+    void retain(const QSet<QString>& instance_roots);
+
+    /** Writes the cache back to disk, if anything changed. */
+    void save();
+
+   private:
+    struct Entry {
+        qint64 size;
+        qint64 mtime;
+        QMap<QString, QVariant> contents;
+    };
+
+    void load();
+
+    QString m_file;
+    bool m_loaded = false;
+    bool m_dirty = false;
+    QHash<QString, Entry> m_entries;
+};
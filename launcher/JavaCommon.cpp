@@ -35,10 +35,36 @@
 
 #include "JavaCommon.h"
 #include "java/JavaUtils.h"
+#include "java/JvmProfiles.h"
 #include "ui/dialogs/CustomMessageBox.h"
 
+#include <QComboBox>
 #include <QRegularExpression>
 
+void JavaCommon::fillJvmProfiles(QComboBox *box, const QString &selected)
+{
+    box->clear();
+    box->addItem(QObject::tr("None, only the JVM arguments"), QString());
+    for (auto &profile : JvmProfiles::all())
+    {
+        box->addItem(JvmProfiles::displayName(profile), profile.id);
+        box->setItemData(box->count() - 1, JvmProfiles::description(profile), Qt::ToolTipRole);
+    }
+    auto index = box->findData(selected);
+    if (index < 0 && !selected.isEmpty())
+    {
+        // a profile from another version of the launcher, kept as it is
+        box->addItem(QObject::tr("Unknown (%1)").arg(selected), selected);
+        index = box->count() - 1;
+    }
+    box->setCurrentIndex(qMax(index, 0));
+}
+
+QString JavaCommon::selectedJvmProfile(QComboBox *box)
+{
+    return box->currentData().toString();
+}
+
 bool JavaCommon::checkJVMArgs(QString jvmargs, QWidget *parent)
 {
     if (jvmargs.contains("-XX:PermSize=") || jvmargs.contains(QRegularExpression("-Xm[sx]"))
@@ -1,6 +1,7 @@
 #pragma once
 #include <java/JavaChecker.h>
 
+class QComboBox;
 class QWidget;
 
 /**
@@ -10,6 +11,11 @@ namespace JavaCommon
 {
     bool checkJVMArgs(QString args, QWidget *parent);
 
+    // Fill a combo box with the JVM tuning profiles, the item data is the id of the profile
+    void fillJvmProfiles(QComboBox *box, const QString &selected);
+    // The id of the profile picked in a combo box filled by fillJvmProfiles
+    QString selectedJvmProfile(QComboBox *box);
+
     // Show a dialog saying that the Java binary was usable
     void javaWasOk(QWidget *parent, JavaCheckResult result);
     // Show a dialog saying that the Java binary was not usable because of bad options
@@ -352,6 +352,20 @@ void LaunchController::launchInstance()
     {
         APPLICATION->showInstanceWindow(m_instance);
     }
+    if (m_profiler)
+    {
+        QString error;
+        if (!m_profiler->check(&error))
+        {
+            QMessageBox::critical(m_parentWidget, tr("Error!"), tr("Couldn't start profiler: %1").arg(error));
+            emitFailed("Profiler startup failed!");
+            return;
+        }
+        // the ones that record from the start need to be there before the game is
+        m_profilerInstance = m_profiler->createProfiler(m_launcher->instance(), this);
+        m_launcher->setExtraJavaArguments(m_profilerInstance->launchArguments());
+    }
+
     connect(m_launcher.get(), &LaunchTask::readyForLaunch, this, &LaunchController::readyForLaunch);
     connect(m_launcher.get(), &LaunchTask::succeeded, this, &LaunchController::onSucceeded);
     connect(m_launcher.get(), &LaunchTask::failed, this,  &LaunchController::onFailed);
@@ -402,16 +416,13 @@ void LaunchController::readyForLaunch()
         return;
     }
 
-    QString error;
-    if (!m_profiler->check(&error))
-    {
-        m_launcher->abort();
-        QMessageBox::critical(m_parentWidget, tr("Error!"), tr("Couldn't start profiler: %1").arg(error));
-        emitFailed("Profiler startup failed!");
-        return;
-    }
-    BaseProfiler *profilerInstance = m_profiler->createProfiler(m_launcher->instance(), this);
+    BaseProfiler *profilerInstance = m_profilerInstance;
 
+    connect(profilerInstance, &BaseProfiler::recording, [this](const QString & message)
+    {
+        m_launcher->onLogLine(message, MessageLevel::Launcher);
+        m_launcher->proceed();
+    });
     connect(profilerInstance, &BaseProfiler::readyToLaunch, [this](const QString & message)
     {
         QMessageBox msg;
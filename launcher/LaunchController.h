@@ -104,6 +104,7 @@ private slots:
 
 private:
     BaseProfilerFactory *m_profiler = nullptr;
+    BaseProfiler *m_profilerInstance = nullptr;
     bool m_online = true;
     bool m_demo = false;
     InstancePtr m_instance;
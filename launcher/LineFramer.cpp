@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "LineFramer.h"
+
+#include <QIODevice>
+
+#include <cstring>
+
+namespace {
+// the buffer is moved back to its start once what was framed in it is at least this much
+constexpr qint64 s_compact_threshold = 64 * 1024;
+constexpr qint64 s_initial_size = 16 * 1024;
+}  // namespace
+
+LineFramer::LineFramer(QTextCodec* codec) : m_codec(codec ? codec : QTextCodec::codecForName("UTF-8"))
+{
+    // the MIB of UTF-8, which Qt decodes faster on its own
+    m_utf8 = m_codec->mibEnum() == 106;
+}
+
+QStringList LineFramer::read(QIODevice* device)
+{
+    auto available = device->bytesAvailable();
+    if (available <= 0)
+        return {};
+
+    auto read = device->read(reserve(available), available);
+    if (read > 0)
+        m_end += read;
+    return takeLines();
+}
+
+QStringList LineFramer::feed(const char* data, qint64 size)
+{
+    if (size <= 0)
+        return {};
+    std::memcpy(reserve(size), data, size);
+    m_end += size;
+    return takeLines();
+}
+
+char* LineFramer::reserve(qint64 size)
+{
+    auto pending = m_end - m_start;
+    if (m_start > 0 && (pending == 0 || m_start >= s_compact_threshold)) {
+        std::memmove(m_buffer.data(), m_buffer.constData() + m_start, pending);
+        m_scanned -= m_start;
+        m_start = 0;
+        m_end = pending;
+    }
+    if (m_end + size > m_buffer.size())
+        m_buffer.resize(qMax(m_end + size, qMax<qint64>(m_buffer.size() * 2, s_initial_size)));
+    return m_buffer.data() + m_end;
+}
+
+QStringList LineFramer::flush()
+{
+    QStringList lines;
+    appendLine(lines, m_buffer.constData() + m_start, m_end - m_start);
+    m_start = m_scanned = m_end = 0;
+    return lines;
+}
+
+QStringList LineFramer::takeLines()
+{
+    QStringList lines;
+    auto data = m_buffer.constData();
+    auto scan = qMax(m_start, m_scanned);
+    while (scan < m_end) {
+        auto lineEnd = static_cast<const char*>(std::memchr(data + scan, '\n', m_end - scan));
+        if (!lineEnd) {
+            scan = m_end;
+            break;
+        }
+        appendLine(lines, data + m_start, lineEnd - (data + m_start));
+        m_start = scan = lineEnd - data + 1;
+    }
+    m_scanned = scan;
+    if (m_start == m_end)
+        m_start = m_scanned = m_end = 0;
+    return lines;
+}
+
+void LineFramer::appendLine(QStringList& lines, const char* begin, qint64 size) const
+{
+    // the usual carriage return is the one of a CRLF
+    while (size > 0 && begin[size - 1] == '\r')
+        size--;
+    if (size == 0)
+        return;
+
+    auto line = m_utf8 ? QString::fromUtf8(begin, size) : m_codec->toUnicode(begin, size);
+    if (std::memchr(begin, '\r', size))
+        line.remove(QChar::CarriageReturn);
+    if (!line.isEmpty())
+        lines.append(line);
+}
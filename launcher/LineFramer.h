@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QByteArray>
+#include <QStringList>
+#include <QTextCodec>
+
+class QIODevice;
+
+/* Cuts the output of a process into lines, decoding only the lines that are complete.
+ *
+ * The bytes are read into a buffer that keeps its size from one read to the next, the line ends are looked for in
+ * the bytes, and each complete line is decoded on its own, without its carriage returns. What comes after the last
+ * line end stays in the buffer until the rest of its line comes. Empty lines are left out.
+ *
+ * The line ends are looked for as bytes, so the text has to be in an encoding where a byte 0x0A is always a line feed,
+ * as UTF-8 and the 8 bit code pages are.
+ */
+class LineFramer {
+   public:
+    explicit LineFramer(QTextCodec* codec = QTextCodec::codecForLocale());
+
+    /** Reads all that `device` has, and returns the lines that are complete. */
+    QStringList read(QIODevice* device);
+    QStringList feed(const char* data, qint64 size);
+    QStringList feed(const QByteArray& data) { return feed(data.constData(), data.size()); }
+
+    /** The rest, as a last line, once nothing more will come. */
+    QStringList flush();
+
+   private:
+    /** Room for `size` more bytes at the end of the buffer. */
+    char* reserve(qint64 size);
+    QStringList takeLines();
+    void appendLine(QStringList& lines, const char* begin, qint64 size) const;
+
+   private:
+    QTextCodec* m_codec;
+    bool m_utf8;
+    QByteArray m_buffer;
+    // the bytes before this were framed already
+    qint64 m_start = 0;
+    // no line end before this, past the start
+    qint64 m_scanned = 0;
+    qint64 m_end = 0;
+};
@@ -36,7 +36,6 @@
 
 #include "LoggedProcess.h"
 #include <QDebug>
-#include <QTextDecoder>
 #include "MessageLevel.h"
 
 LoggedProcess::LoggedProcess(QObject *parent) : QProcess(parent)
@@ -57,36 +56,28 @@ LoggedProcess::~LoggedProcess()
     }
 }
 
-QStringList LoggedProcess::reprocess(const QByteArray& data, QTextDecoder& decoder)
+QStringList LoggedProcess::readLines(QProcess::ProcessChannel channel, LineFramer& framer)
 {
-    auto str = decoder.toUnicode(data);
-
-    if (!m_leftover_line.isEmpty()) {
-        str.prepend(m_leftover_line);
-        m_leftover_line = "";
-    }
-
-#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
-    auto lines = str.remove(QChar::CarriageReturn).split(QChar::LineFeed, QString::SkipEmptyParts);
-#else
-    auto lines = str.remove(QChar::CarriageReturn).split(QChar::LineFeed, Qt::SkipEmptyParts);
-#endif
-
-    if (!str.endsWith(QChar::LineFeed))
-        m_leftover_line = lines.takeLast();
+    // the framer reads straight from the process, which reads from its current channel
+    auto previous = readChannel();
+    setReadChannel(channel);
+    auto lines = framer.read(this);
+    setReadChannel(previous);
     return lines;
 }
 
 void LoggedProcess::on_stdErr()
 {
-    auto lines = reprocess(readAllStandardError(), m_err_decoder);
-    emit log(lines, MessageLevel::StdErr);
+    auto lines = readLines(QProcess::StandardError, m_err_framer);
+    if (!lines.isEmpty())
+        emit log(lines, MessageLevel::StdErr);
 }
 
 void LoggedProcess::on_stdOut()
 {
-    auto lines = reprocess(readAllStandardOutput(), m_out_decoder);
-    emit log(lines, MessageLevel::StdOut);
+    auto lines = readLines(QProcess::StandardOutput, m_out_framer);
+    if (!lines.isEmpty())
+        emit log(lines, MessageLevel::StdOut);
 }
 
 void LoggedProcess::on_exit(int exit_code, QProcess::ExitStatus status)
@@ -94,6 +85,14 @@ void LoggedProcess::on_exit(int exit_code, QProcess::ExitStatus status)
     // save the exit code
     m_exit_code = exit_code;
 
+    // what's left of the output, and its last line which may have had no line end
+    on_stdOut();
+    on_stdErr();
+    if (auto lines = m_out_framer.flush(); !lines.isEmpty())
+        emit log(lines, MessageLevel::StdOut);
+    if (auto lines = m_err_framer.flush(); !lines.isEmpty())
+        emit log(lines, MessageLevel::StdErr);
+
     // based on state, send signals
     if (!m_is_aborting)
     {
@@ -36,7 +36,7 @@
 #pragma once
 
 #include <QProcess>
-#include <QTextDecoder>
+#include "LineFramer.h"
 #include "MessageLevel.h"
 
 /*
@@ -88,12 +88,11 @@ private slots:
 private:
     void changeState(LoggedProcess::State state);
 
-    QStringList reprocess(const QByteArray& data, QTextDecoder& decoder);
+    QStringList readLines(QProcess::ProcessChannel channel, LineFramer& framer);
 
 private:
-    QTextDecoder m_err_decoder = QTextDecoder(QTextCodec::codecForLocale());
-    QTextDecoder m_out_decoder = QTextDecoder(QTextCodec::codecForLocale());
-    QString m_leftover_line;
+    LineFramer m_err_framer;
+    LineFramer m_out_framer;
     bool m_killed = false;
     State m_state = NotRunning;
     int m_exit_code = 0;
@@ -41,6 +41,10 @@
 
 #include <QCoreApplication>
 #include <QDebug>
+#include <QtConcurrentMap>
+
+#include <atomic>
+#include <zlib.h>
 
 // ours
 bool MMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &contained, const FilterFunction filter)
@@ -67,15 +71,26 @@ bool MMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &containe
         }
         contained.insert(filename);
 
-        if (!fileInsideMod.open(QIODevice::ReadOnly))
+        QuaZipFileInfo64 info_in;
+        if (!modZip.getCurrentFileInfo(&info_in))
+        {
+            qCritical() << "Failed to read the details of " << filename << " from " << from.fileName();
+            return false;
+        }
+
+        // Copy the compressed data as it is, instead of inflating it only to deflate it again
+        int method = 0;
+        int level = 0;
+        if (!fileInsideMod.open(QIODevice::ReadOnly, &method, &level, true))
         {
             qCritical() << "Failed to open " << filename << " from " << from.fileName();
             return false;
         }
 
         QuaZipNewInfo info_out(fileInsideMod.getActualFileName());
+        info_out.uncompressedSize = info_in.uncompressedSize;
 
-        if (!zipOutFile.open(QIODevice::WriteOnly, info_out))
+        if (!zipOutFile.open(QIODevice::WriteOnly, info_out, nullptr, info_in.crc, method, level, true))
         {
             qCritical() << "Failed to open " << filename << " in the jar";
             fileInsideMod.close();
@@ -83,22 +98,24 @@ bool MMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &containe
         }
         if (!JlCompress::copyData(fileInsideMod, zipOutFile))
         {
-            zipOutFile.close();
+            zipOutFile.closeRaw(info_in.uncompressedSize, info_in.crc);
             fileInsideMod.close();
             qCritical() << "Failed to copy data of " << filename << " into the jar";
             return false;
         }
-        zipOutFile.close();
+        zipOutFile.closeRaw(info_in.uncompressedSize, info_in.crc);
         fileInsideMod.close();
     }
     return true;
 }
 
-bool MMCZip::compressDirFiles(QuaZip *zip, QString dir, QFileInfoList files, bool followSymlinks)
+bool MMCZip::compressDirFiles(QuaZip *zip, QString dir, QFileInfoList files, bool followSymlinks, int level)
 {
     QDir directory(dir);
     if (!directory.exists()) return false;
 
+    QList<QPair<QString, QString>> entries;
+    entries.reserve(files.size());
     for (auto e : files) {
         auto filePath = directory.relativeFilePath(e.absoluteFilePath());
         auto srcPath = e.absoluteFilePath();
@@ -109,13 +126,156 @@ bool MMCZip::compressDirFiles(QuaZip *zip, QString dir, QFileInfoList files, boo
                 srcPath = e.canonicalFilePath();
             }
         }
-        if( !JlCompress::compressFile(zip, srcPath, filePath)) return false;
+        entries.append({ filePath, srcPath });
+    }
+
+    return compressFiles(zip, entries, level);
+}
+
+namespace {
+// how much of the files is read and compressed before it gets written out
+constexpr qint64 s_batchBytes = 64 * 1024 * 1024;
+// files bigger than this are compressed while they're written, instead of being read whole
+constexpr qint64 s_maxBufferedFile = 16 * 1024 * 1024;
+
+struct CompressedEntry {
+    QString name;
+    QString source;
+    // read and compressed ahead of time, the others are compressed on the way into the archive
+    bool buffered = false;
+    bool ok = false;
+    QByteArray data;
+    qint64 size = 0;
+    quint32 crc = 0;
+    int method = Z_DEFLATED;
+};
+
+void compressEntry(CompressedEntry &entry, int level)
+{
+    QFile file(entry.source);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+    QByteArray contents = file.readAll();
+    if (file.error() != QFileDevice::NoError)
+        return;
+
+    entry.size = contents.size();
+    entry.crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef *>(contents.constData()), contents.size());
+
+    if (level != 0 && !MMCZip::isCompressedFormat(entry.name) && !contents.isEmpty()) {
+        // raw deflate, without a zlib header: the archive has its own
+        z_stream stream{};
+        if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK) {
+            QByteArray deflated(deflateBound(&stream, contents.size()), Qt::Uninitialized);
+            stream.next_in = reinterpret_cast<Bytef *>(contents.data());
+            stream.avail_in = contents.size();
+            stream.next_out = reinterpret_cast<Bytef *>(deflated.data());
+            stream.avail_out = deflated.size();
+            auto result = deflate(&stream, Z_FINISH);
+            deflated.resize(stream.total_out);
+            deflateEnd(&stream);
+            // keep it stored if deflating doesn't make it any smaller
+            if (result == Z_STREAM_END && deflated.size() < contents.size()) {
+                entry.data = std::move(deflated);
+                entry.method = Z_DEFLATED;
+                entry.ok = true;
+                return;
+            }
+        }
     }
 
+    entry.data = std::move(contents);
+    entry.method = 0;
+    entry.ok = true;
+}
+
+bool writeEntry(QuaZip *zip, CompressedEntry &entry, int level)
+{
+    QuaZipNewInfo info(entry.name, entry.source);
+    QuaZipFile out(zip);
+
+    if (entry.buffered) {
+        info.uncompressedSize = entry.size;
+        if (!out.open(QIODevice::WriteOnly, info, nullptr, entry.crc, entry.method, level, true))
+            return false;
+        auto written = out.write(entry.data);
+        auto expected = entry.data.size();
+        entry.data.clear();
+        out.closeRaw(entry.size, entry.crc);
+        return written == expected && out.getZipError() == ZIP_OK;
+    }
+
+    QFile file(entry.source);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    info.uncompressedSize = file.size();
+    int method = (level == 0 || MMCZip::isCompressedFormat(entry.name)) ? 0 : Z_DEFLATED;
+    if (!out.open(QIODevice::WriteOnly, info, nullptr, 0, method, level))
+        return false;
+    bool copied = JlCompress::copyData(file, out);
+    out.close();
+    return copied && out.getZipError() == ZIP_OK;
+}
+}  // namespace
+
+bool MMCZip::isCompressedFormat(const QString &fileName)
+{
+    static const QStringList compressed = { "jar", "zip", "png", "ogg", "jpg", "jpeg", "gz", "xz", "7z", "mp3", "litemod", "mrpack" };
+    QString name = fileName;
+    if (name.endsWith(".disabled"))
+        name.chop(9);
+    return compressed.contains(QFileInfo(name).suffix().toLower());
+}
+
+bool MMCZip::compressFiles(QuaZip *zip, const QList<QPair<QString, QString>> &entries, int level, std::function<bool()> cancelled,
+                           std::function<void(int, int)> progress)
+{
+    if (level < 0)
+        level = Z_DEFAULT_COMPRESSION;
+
+    int written = 0;
+    int next = 0;
+    while (next < entries.size()) {
+        // gather a batch, so only so much of the files is in memory at a time
+        QVector<CompressedEntry> batch;
+        qint64 batchBytes = 0;
+        while (next < entries.size() && (batch.isEmpty() || batchBytes < s_batchBytes)) {
+            CompressedEntry entry;
+            entry.name = entries[next].first;
+            entry.source = entries[next].second;
+            auto size = QFileInfo(entry.source).size();
+            entry.buffered = size <= s_maxBufferedFile;
+            if (entry.buffered)
+                batchBytes += size;
+            batch.append(entry);
+            next++;
+        }
+
+        QtConcurrent::blockingMap(batch, [level](CompressedEntry &entry) {
+            if (entry.buffered)
+                compressEntry(entry, level);
+        });
+
+        for (auto &entry : batch) {
+            if (cancelled && cancelled())
+                return false;
+            if (entry.buffered && !entry.ok) {
+                qWarning() << "Could not read" << entry.source << "to add it to the archive";
+                return false;
+            }
+            if (!writeEntry(zip, entry, level)) {
+                qWarning() << "Could not add" << entry.source << "to the archive as" << entry.name;
+                return false;
+            }
+            written++;
+            if (progress)
+                progress(written, entries.size());
+        }
+    }
     return true;
 }
 
-bool MMCZip::compressDirFiles(QString fileCompressed, QString dir, QFileInfoList files, bool followSymlinks)
+bool MMCZip::compressDirFiles(QString fileCompressed, QString dir, QFileInfoList files, bool followSymlinks, int level)
 {
     QuaZip zip(fileCompressed);
     QDir().mkpath(QFileInfo(fileCompressed).absolutePath());
@@ -124,7 +284,7 @@ bool MMCZip::compressDirFiles(QString fileCompressed, QString dir, QFileInfoList
         return false;
     }
 
-    auto result = compressDirFiles(&zip, dir, files, followSymlinks);
+    auto result = compressDirFiles(&zip, dir, files, followSymlinks, level);
 
     zip.close();
     if(zip.getZipError()!=0) {
@@ -260,6 +420,11 @@ QString MMCZip::findFolderOfFileInZip(QuaZip* zip, const QString& what, const QS
     return {};
 }
 
+QString MMCZip::findFolderOfFileInZip(const ArchiveReader& zip, const QString& what, const QStringList& ignore_paths)
+{
+    return zip.findFolderOfFile(what, ignore_paths);
+}
+
 // ours
 bool MMCZip::findFilesInZip(QuaZip * zip, const QString & what, QStringList & result, const QString &root)
 {
@@ -283,6 +448,13 @@ bool MMCZip::findFilesInZip(QuaZip * zip, const QString & what, QStringList & re
 // ours
 std::optional<QStringList> MMCZip::extractSubDir(QuaZip *zip, const QString & subdir, const QString &target)
 {
+    // Archives coming from a file can be extracted without going through QuaZip, several entries at a time
+    if (!zip->getZipName().isEmpty()) {
+        ArchiveReader reader(zip->getZipName());
+        if (reader.open())
+            return extractSubDir(reader, subdir, target);
+    }
+
     auto target_top_dir = QUrl::fromLocalFile(target);
 
     QStringList extracted;
@@ -353,6 +525,119 @@ std::optional<QStringList> MMCZip::extractSubDir(QuaZip *zip, const QString & su
     return extracted;
 }
 
+// ours
+std::optional<QStringList> MMCZip::extractSubDir(const ArchiveReader& zip, const QString& subdir, const QString& target)
+{
+    auto target_top_dir = QUrl::fromLocalFile(target);
+
+    qDebug() << "Extracting subdir" << subdir << "from" << zip.path() << "to" << target;
+    if (zip.entries().isEmpty()) {
+        qDebug() << "Extracting empty archives seems odd...";
+        return QStringList();
+    }
+
+    QList<QPair<const ArchiveReader::Entry*, QString>> entries;
+    for (auto& entry : zip.entries()) {
+        if (!entry.name.startsWith(subdir))
+            continue;
+
+        auto relative_file_name = QDir::fromNativeSeparators(entry.name.mid(subdir.size()));
+        if (relative_file_name.startsWith('/'))
+            relative_file_name = relative_file_name.mid(1);
+
+        QString target_file_path;
+        if (relative_file_name.isEmpty()) {
+            target_file_path = target + '/';
+        } else {
+            target_file_path = FS::PathCombine(target_top_dir.toLocalFile(), relative_file_name);
+            if (relative_file_name.endsWith('/') && !target_file_path.endsWith('/'))
+                target_file_path += '/';
+        }
+
+        if (!target_top_dir.isParentOf(QUrl::fromLocalFile(target_file_path))) {
+            qWarning() << "Extracting" << relative_file_name << "was cancelled, because it was effectively outside of the target path" << target;
+            return std::nullopt;
+        }
+
+        entries.append({ &entry, target_file_path });
+    }
+
+    QStringList extracted;
+    if (!extractEntries(zip, entries, QFileDevice::ReadUser | QFileDevice::WriteUser | QFileDevice::ExeUser, &extracted)) {
+        JlCompress::removeFile(extracted);
+        return std::nullopt;
+    }
+    qDebug() << "Extracted" << extracted.size() << "files to" << target;
+    return extracted;
+}
+
+// ours
+bool MMCZip::extractEntries(const ArchiveReader& zip,
+                            const QList<QPair<const ArchiveReader::Entry*, QString>>& entries,
+                            QFileDevice::Permissions permissions,
+                            QStringList* extracted)
+{
+    struct Job {
+        const ArchiveReader::Entry* entry;
+        QString path;
+        bool done = false;
+    };
+
+    // Only the last entry going to a path matters, and two workers must never write the same file
+    // (paths are compared without their trailing slash, a folder and a file can't share them either)
+    QHash<QString, int> last;
+    for (int i = 0; i < entries.size(); i++) {
+        auto path = entries[i].second;
+        if (path.endsWith('/'))
+            path.chop(1);
+        last.insert(path, i);
+    }
+
+    QVector<Job> jobs;
+    jobs.reserve(last.size());
+    QSet<QString> folders;
+    for (int i = 0; i < entries.size(); i++) {
+        auto path = entries[i].second;
+        if (path.endsWith('/'))
+            path.chop(1);
+        if (last.value(path) != i)
+            continue;
+
+        jobs.append({ entries[i].first, entries[i].second });
+        folders.insert(entries[i].first->name.endsWith('/') ? path : QFileInfo(path).absolutePath());
+    }
+
+    // Creating the folders from the workers would have them race each other for the common parts of their paths
+    for (auto& folder : folders) {
+        if (!FS::ensureFolderPathExists(folder)) {
+            qWarning() << "Failed to create folder" << folder;
+            return false;
+        }
+    }
+
+    std::atomic_bool failed{ false };
+    QtConcurrent::blockingMap(jobs, [&zip, &failed, permissions](Job& job) {
+        if (failed)
+            return;
+        if (!zip.extract(*job.entry, job.path)) {
+            qWarning() << "Failed to extract file" << job.entry->name << "to" << job.path;
+            failed = true;
+            return;
+        }
+        if (permissions)
+            QFile::setPermissions(job.path, permissions);
+        job.done = true;
+    });
+
+    if (extracted) {
+        for (auto& job : jobs) {
+            if (job.done)
+                extracted->append(job.path);
+        }
+    }
+    return !failed;
+}
+
 // ours
 bool MMCZip::extractRelFile(QuaZip *zip, const QString &file, const QString &target)
 {
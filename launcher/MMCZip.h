@@ -38,6 +38,7 @@
 #include <QString>
 #include <QFileInfo>
 #include <QSet>
+#include "ArchiveReader.h"
 #include "minecraft/mod/Mod.h"
 #include <functional>
 
@@ -62,7 +63,7 @@ namespace MMCZip
      * \param followSymlinks should follow symlinks when compressing file data
      * \return true for success or false for failure
      */
-    bool compressDirFiles(QuaZip *zip, QString dir, QFileInfoList files, bool followSymlinks = false);
+    bool compressDirFiles(QuaZip *zip, QString dir, QFileInfoList files, bool followSymlinks = false, int level = -1);
 
     /**
      * Compress directory, by providing a list of files to compress
@@ -72,7 +73,27 @@ namespace MMCZip
      * \param followSymlinks should follow symlinks when compressing file data
      * \return true for success or false for failure
      */
-    bool compressDirFiles(QString fileCompressed, QString dir, QFileInfoList files, bool followSymlinks = false);
+    bool compressDirFiles(QString fileCompressed, QString dir, QFileInfoList files, bool followSymlinks = false, int level = -1);
+
+    /**
+     * Compress files into an archive, several of them at the same time
+     *
+     * The files are read and deflated in parallel, a batch at a time, and written to the archive in order.
+     * The ones that are compressed already (see isCompressedFormat) are stored as they are.
+     * \param zip target archive
+     * \param entries pairs of the path in the archive and the path of the file to compress, in the order they are written
+     * \param level zlib compression level, from 1 (fastest) to 9 (smallest), 0 to only store and -1 for zlib's default
+     * \param cancelled asked before every file, stops with a failure when it returns true
+     * \param progress told how many of the files were written
+     * \return true for success or false for failure
+     */
+    bool compressFiles(QuaZip *zip, const QList<QPair<QString, QString>> &entries, int level = -1,
+                       std::function<bool()> cancelled = nullptr, std::function<void(int, int)> progress = nullptr);
+
+    /**
+     * Whether a file is in a format that is compressed already (jars, zips, images and sounds), by its name
+     */
+    bool isCompressedFormat(const QString &fileName);
 
     /**
      * take a source jar, add mods to it, resulting in target jar
@@ -88,6 +109,15 @@ namespace MMCZip
      */
     QString findFolderOfFileInZip(QuaZip * zip, const QString & what, const QStringList& ignore_paths = {}, const QString &root = QString(""));
 
+    /**
+     * Find a single file in an indexed archive by file name (not path), without walking the archive folder by folder
+     *
+     * \param ignore_paths paths to skip when searching
+     *
+     * \return the path prefix where the file is
+     */
+    QString findFolderOfFileInZip(const ArchiveReader& zip, const QString& what, const QStringList& ignore_paths = {});
+
     /**
      * Find a multiple files of the same name in archive by file name
      * If a file is found in a path, no deeper paths are searched
@@ -98,9 +128,32 @@ namespace MMCZip
 
     /**
      * Extract a subdirectory from an archive
+     *
+     * Archives opened from a file are extracted from an ArchiveReader, several entries at the same time.
      */
     std::optional<QStringList> extractSubDir(QuaZip *zip, const QString & subdir, const QString &target);
 
+    /**
+     * Extract a subdirectory from an indexed archive, several entries at the same time
+     */
+    std::optional<QStringList> extractSubDir(const ArchiveReader& zip, const QString& subdir, const QString& target);
+
+    /**
+     * Extract entries of an indexed archive to the given paths, spread across the global thread pool.
+     *
+     * All the folders are created before extracting anything. When several entries go to the same path,
+     * the last one wins, as when extracting them one after the other.
+     *
+     * \param entries entries of 'zip' along with the path to extract each of them to
+     * \param permissions when set, the permissions given to everything extracted
+     * \param extracted if not null, receives the paths that were written, even on failure
+     * \return true for success or false for failure
+     */
+    bool extractEntries(const ArchiveReader& zip,
+                        const QList<QPair<const ArchiveReader::Entry*, QString>>& entries,
+                        QFileDevice::Permissions permissions = {},
+                        QStringList* extracted = nullptr);
+
     bool extractRelFile(QuaZip *zip, const QString & file, const QString &target);
 
     /**
@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "MemoryAccounting.h"
+
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+
+#include <algorithm>
+#include <vector>
+
+#include "StringUtils.h"
+
+#if defined(Q_OS_WIN)
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace MemoryAccounting {
+
+namespace {
+struct Source {
+    // null for what lives as long as the launcher
+    QObject* owner;
+    QString subsystem;
+    Measure measure;
+    Trim trim;
+};
+
+QMutex s_mutex;
+std::vector<Source> s_sources;
+
+std::vector<Source> sources()
+{
+    QMutexLocker locker(&s_mutex);
+    return s_sources;
+}
+
+void untrack(QObject* owner)
+{
+    QMutexLocker locker(&s_mutex);
+    s_sources.erase(std::remove_if(s_sources.begin(), s_sources.end(), [owner](const Source& source) { return source.owner == owner; }),
+                    s_sources.end());
+}
+
+qint64 total(const QList<Subsystem>& subsystems)
+{
+    qint64 bytes = 0;
+    for (auto& subsystem : subsystems)
+        bytes += subsystem.bytes;
+    return bytes;
+}
+}  // namespace
+
+void track(QObject* owner, const QString& subsystem, Measure measure, Trim trim)
+{
+    {
+        QMutexLocker locker(&s_mutex);
+        s_sources.push_back({ owner, subsystem, std::move(measure), std::move(trim) });
+    }
+    if (owner)
+        QObject::connect(owner, &QObject::destroyed, [owner] { untrack(owner); });
+}
+
+void track(const QString& subsystem, Measure measure, Trim trim)
+{
+    track(nullptr, subsystem, std::move(measure), std::move(trim));
+}
+
+QList<Subsystem> report()
+{
+    QList<Subsystem> subsystems;
+    QHash<QString, int> index;
+    for (auto& source : sources()) {
+        auto found = index.constFind(source.subsystem);
+        if (found == index.constEnd()) {
+            found = index.insert(source.subsystem, subsystems.size());
+            subsystems.append({ source.subsystem });
+        }
+        auto& subsystem = subsystems[*found];
+        auto usage = source.measure();
+        subsystem.objects++;
+        subsystem.items += usage.items;
+        subsystem.bytes += usage.bytes;
+        subsystem.trimmable |= bool(source.trim);
+    }
+    std::sort(subsystems.begin(), subsystems.end(), [](const Subsystem& a, const Subsystem& b) { return a.bytes > b.bytes; });
+    return subsystems;
+}
+
+qint64 trim()
+{
+    auto before = total(report());
+    for (auto& source : sources()) {
+        if (source.trim)
+            source.trim();
+    }
+#if defined(__GLIBC__)
+    // the freed memory stays with the process otherwise, for the next allocations
+    malloc_trim(0);
+#endif
+    return qMax<qint64>(before - total(report()), 0);
+}
+
+qint64 residentBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return -1;
+    return qint64(counters.WorkingSetSize);
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+        return -1;
+    return qint64(info.resident_size);
+#elif defined(Q_OS_UNIX)
+    // the total size, then the resident one, in pages
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly))
+        return -1;
+    auto fields = statm.readAll().split(' ');
+    bool ok = false;
+    auto pages = fields.size() > 1 ? fields[1].toLongLong(&ok) : 0;
+    if (!ok)
+        return -1;
+    return pages * sysconf(_SC_PAGESIZE);
+#else
+    return -1;
+#endif
+}
+
+QString summary()
+{
+    auto subsystems = report();
+    QStringList lines;
+    auto resident = residentBytes();
+    lines << QString("Memory: %1 resident, about %2 accounted for")
+                 .arg(resident < 0 ? QString("?") : StringUtils::humanReadableFileSize(resident))
+                 .arg(StringUtils::humanReadableFileSize(total(subsystems)));
+    for (auto& subsystem : subsystems) {
+        lines << QString("  %1: %2 in %3 items of %4 objects")
+                     .arg(subsystem.name)
+                     .arg(StringUtils::humanReadableFileSize(subsystem.bytes))
+                     .arg(subsystem.items)
+                     .arg(subsystem.objects);
+    }
+    return lines.join('\n');
+}
+
+}  // namespace MemoryAccounting
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#include <functional>
+
+/* What the parts of the launcher keep in memory, for finding out what makes it big after a long session.
+ *
+ * The parts that hold a lot (the instance list, the folder models of the instances, the caches, the logs of the
+ * instances) say how many things they hold and about how many bytes those take. The bytes are an estimate: the sizes
+ * of the objects and of their strings, not what the allocator adds, nor what the objects point to besides. The parts
+ * holding caches that can be made again also say how to let go of them, see trim().
+ *
+ * All of it is meant for the GUI thread, where the measured objects live.
+ */
+namespace MemoryAccounting {
+
+struct Usage {
+    // the instances, entries, lines... it holds
+    qint64 items = 0;
+    qint64 bytes = 0;
+};
+
+using Measure = std::function<Usage()>;
+using Trim = std::function<void()>;
+
+/** A subsystem, with the usage of all the objects counted under its name. */
+struct Subsystem {
+    QString name;
+    int objects = 0;
+    qint64 items = 0;
+    qint64 bytes = 0;
+    bool trimmable = false;
+};
+
+/** Counts what `measure` says `owner` holds under `subsystem`, until `owner` is destroyed. */
+void track(QObject* owner, const QString& subsystem, Measure measure, Trim trim = {});
+/** The same, for what lives as long as the launcher. */
+void track(const QString& subsystem, Measure measure, Trim trim = {});
+
+/** The subsystems, the biggest first. */
+QList<Subsystem> report();
+
+/** Lets go of what can be made again, in every subsystem, and gives the freed memory back to the system where it can.
+ * Returns about how many bytes the subsystems let go of. */
+qint64 trim();
+
+/** What the process has in RAM, as the system counts it, -1 when it can't tell. */
+qint64 residentBytes();
+
+/** report() and residentBytes(), in a few lines for the log. */
+QString summary();
+
+inline qint64 bytesOf(const QString& string)
+{
+    return qint64(sizeof(QString)) + qint64(string.capacity()) * qint64(sizeof(QChar));
+}
+
+inline qint64 bytesOf(const QByteArray& array)
+{
+    return qint64(sizeof(QByteArray)) + array.capacity();
+}
+
+}  // namespace MemoryAccounting
@@ -0,0 +1,461 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "OfflineBundle.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTemporaryFile>
+#include <QtConcurrentRun>
+
+#include <quazip/quazip.h>
+
+#include <algorithm>
+
+#include "Application.h"
+#include "ArchiveReader.h"
+#include "BuildConfig.h"
+#include "Exception.h"
+#include "Executors.h"
+#include "FileSystem.h"
+#include "InstanceList.h"
+#include "Json.h"
+#include "MMCZip.h"
+#include "java/ManagedRuntime.h"
+#include "minecraft/AssetsUtils.h"
+#include "minecraft/Component.h"
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+#include "net/HttpMetaCache.h"
+#include "tasks/ConcurrentTask.h"
+
+namespace OfflineBundle {
+
+const QString s_manifest_name = "bundle.json";
+
+namespace {
+const QString s_instances_prefix = "instances/";
+
+// where the files of the cache bases are, relative to the data folder (see Application)
+const QList<QPair<QString, QString>> s_cache_bases = {
+    { "libraries/", "libraries" },
+    { "assets/indexes/", "asset_indexes" },
+    { "assets/objects/", "asset_objects" },
+    { "meta/", "meta" },
+};
+const QStringList s_shared_prefixes = { "libraries/", "assets/indexes/", "assets/objects/", "meta/", "java/runtimes/" };
+}  // namespace
+
+QString cacheBase(const QString& path)
+{
+    for (auto& base : s_cache_bases) {
+        if (path.startsWith(base.first))
+            return base.second;
+    }
+    return {};
+}
+
+QString cachePath(const QString& path)
+{
+    for (auto& base : s_cache_bases) {
+        if (path.startsWith(base.first))
+            return path.mid(base.first.size());
+    }
+    return {};
+}
+
+bool isImportable(const QString& path)
+{
+    if (path.isEmpty() || path.startsWith('/') || path.contains('\\') || path.contains(':'))
+        return false;
+    if (path.split('/').contains(".."))
+        return false;
+    if (path.startsWith(s_instances_prefix))
+        return path.indexOf('/', s_instances_prefix.size()) > s_instances_prefix.size();
+    return std::any_of(s_shared_prefixes.begin(), s_shared_prefixes.end(), [&](const QString& prefix) { return path.startsWith(prefix); });
+}
+
+}  // namespace OfflineBundle
+
+using namespace OfflineBundle;
+
+OfflineBundleExportTask::OfflineBundleExportTask(const QList<InstancePtr>& instances, QString output, QObject* parent)
+    : Task(parent), m_output(std::move(output))
+{
+    for (auto& instance : instances) {
+        auto minecraft = std::dynamic_pointer_cast<MinecraftInstance>(instance);
+        if (minecraft)
+            m_instances.append(minecraft);
+    }
+}
+
+void OfflineBundleExportTask::executeTask()
+{
+    if (m_instances.isEmpty()) {
+        emitFailed(tr("There are no instances to bundle."));
+        return;
+    }
+
+    // the instances are bundled as they are now, nothing gets downloaded
+    setStatus(tr("Resolving the components of %n instance(s)...", "", m_instances.size()));
+    auto step = makeShared<ConcurrentTask>(nullptr, tr("Resolving components"));
+    for (auto& instance : m_instances) {
+        instance->updateRuntimeContext();
+        auto components = instance->getPackProfile();
+        components->reload(Net::Mode::Offline);
+        if (auto task = components->getCurrentTask())
+            step->addTask(task);
+    }
+    m_step = step;
+    connect(step.get(), &Task::succeeded, this, &OfflineBundleExportTask::collectFiles);
+    connect(step.get(), &Task::failed, this, [this](QString reason) { emitFailed(reason); });
+    connect(step.get(), &Task::aborted, this, [this] { emitAborted(); });
+    step->start();
+}
+
+bool OfflineBundleExportTask::abort()
+{
+    if (m_step && m_step->isRunning())
+        return m_step->abort();
+    if (m_build.isRunning()) {
+        m_build.cancel();
+        return true;
+    }
+    return Task::abort();
+}
+
+void OfflineBundleExportTask::addFile(const QString& path)
+{
+    if (m_added.contains(path) || !QFileInfo(path).isFile())
+        return;
+    m_added.insert(path);
+    m_files.append({ path, QDir::current().absoluteFilePath(path) });
+}
+
+void OfflineBundleExportTask::addFolder(const QString& path, const QString& prefix)
+{
+    QDir root(path);
+    QDirIterator it(path, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        auto file = it.next();
+        auto name = prefix + root.relativeFilePath(file);
+        if (m_added.contains(name))
+            continue;
+        m_added.insert(name);
+        m_files.append({ name, file });
+    }
+}
+
+void OfflineBundleExportTask::collectFiles()
+{
+    m_step.reset();
+    setStatus(tr("Collecting the files..."));
+
+    QJsonArray instances;
+    QSet<QString> asset_ids;
+    addFile("meta/index.json");
+    for (auto& instance : m_instances) {
+        auto profile = instance->getPackProfile()->getProfile();
+        if (!profile) {
+            emitFailed(tr("The components of %1 couldn't be resolved.").arg(instance->name()));
+            return;
+        }
+
+        QList<LibraryPtr> libraries;
+        libraries.append(profile->getLibraries());
+        libraries.append(profile->getNativeLibraries());
+        libraries.append(profile->getMavenFiles());
+        for (auto agent : profile->getAgents())
+            libraries.append(agent->library());
+        libraries.append(profile->getMainJar());
+        for (auto& library : libraries) {
+            // the local ones are in the instance
+            if (!library || library->isLocal())
+                continue;
+            for (auto& storage : library->getCacheStorages(instance->runtimeContext()))
+                addFile("libraries/" + storage);
+        }
+
+        auto components = instance->getPackProfile();
+        for (int i = 0; i < components->rowCount(); i++) {
+            auto component = components->getComponent(i);
+            addFile(QString("meta/%1/index.json").arg(component->getID()));
+            addFile(QString("meta/%1/%2.json").arg(component->getID(), component->getVersion()));
+        }
+
+        auto assets = profile->getMinecraftAssets();
+        if (assets && !asset_ids.contains(assets->id)) {
+            asset_ids.insert(assets->id);
+            auto index_path = "assets/indexes/" + assets->id + ".json";
+            AssetsIndex index;
+            if (!AssetsUtils::loadAssetsIndexJson(assets->id, index_path, index)) {
+                emitFailed(tr("The assets of %1 aren't all there, update it before bundling it.").arg(instance->name()));
+                return;
+            }
+            addFile(index_path);
+            for (int i = 0; i < index.size(); i++)
+                addFile(index.object(i).getLocalPath());
+        }
+
+        QJsonObject entry;
+        entry["id"] = instance->id();
+        entry["name"] = instance->name();
+        // a runtime the launcher manages is somewhere else on the other machine
+        auto component = ManagedRuntime::componentOf(instance->settings()->get("JavaPath").toString());
+        if (!component.isEmpty()) {
+            entry["javaRuntime"] = component;
+            auto runtime = ManagedRuntime::runtimePath(component);
+            addFolder(runtime, QDir::current().relativeFilePath(runtime) + '/');
+            addFile(QDir::current().relativeFilePath(runtime + ".index.json"));
+        }
+        addFolder(instance->instanceRoot(), s_instances_prefix + instance->id() + '/');
+        instances.append(entry);
+    }
+
+    // what the cache knows about the files, so they aren't downloaded again
+    QJsonArray cache;
+    auto metacache = APPLICATION->metacache();
+    for (auto& file : m_files) {
+        auto base = cacheBase(file.first);
+        if (base.isEmpty())
+            continue;
+        auto entry = metacache->getEntry(base, cachePath(file.first));
+        if (!entry)
+            continue;
+        QJsonObject record;
+        record["path"] = file.first;
+        record["md5"] = entry->getMD5Sum();
+        if (!entry->getETag().isEmpty())
+            record["etag"] = entry->getETag();
+        if (!entry->getRemoteChangedTimestamp().isEmpty())
+            record["remoteChanged"] = entry->getRemoteChangedTimestamp();
+        if (entry->isEternal())
+            record["eternal"] = true;
+        else
+            record["maxAge"] = entry->getMaximumAge();
+        cache.append(record);
+    }
+
+    m_manifest["formatVersion"] = s_format_version;
+    m_manifest["launcherVersion"] = BuildConfig.printableVersionString();
+    m_manifest["created"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    m_manifest["instances"] = instances;
+    m_manifest["cache"] = cache;
+    m_manifest["files"] = m_files.size();
+
+    setStatus(tr("Adding %n file(s)...", "", m_files.size()));
+    auto manifest = QJsonDocument(m_manifest).toJson();
+    m_build = QtConcurrent::run(Executors::io(), [this, manifest] { return buildZip(manifest); });
+    connect(&m_build_watcher, &QFutureWatcher<BuildResult>::finished, this, &OfflineBundleExportTask::finish);
+    m_build_watcher.setFuture(m_build);
+}
+
+OfflineBundleExportTask::BuildResult OfflineBundleExportTask::buildZip(const QByteArray& manifest)
+{
+    QTemporaryFile manifest_file;
+    if (!manifest_file.open() || manifest_file.write(manifest) != manifest.size() || !manifest_file.flush())
+        return tr("Could not write the manifest");
+
+    QuaZip zip(m_output);
+    zip.setZip64Enabled(true);
+    if (!zip.open(QuaZip::mdCreate))
+        return tr("Could not create %1").arg(m_output);
+
+    // the manifest first, an import knows what it's in for before the rest
+    QList<QPair<QString, QString>> entries = { { s_manifest_name, manifest_file.fileName() } };
+    entries.append(m_files);
+    const int level = APPLICATION->settings()->get("ExportCompressionLevel").toInt();
+    if (!MMCZip::compressFiles(
+            &zip, entries, level, [this] { return m_build.isCanceled(); }, [this](int done, int total) { setProgress(done, total); })) {
+        zip.close();
+        QFile::remove(m_output);
+        if (m_build.isCanceled())
+            return {};
+        return tr("Could not read and compress the files");
+    }
+
+    zip.close();
+    if (zip.getZipError() != 0) {
+        QFile::remove(m_output);
+        return tr("A zip error occurred");
+    }
+    return {};
+}
+
+void OfflineBundleExportTask::finish()
+{
+    if (m_build.isCanceled()) {
+        emitAborted();
+        return;
+    }
+    auto result = m_build.result();
+    if (result) {
+        emitFailed(*result);
+        return;
+    }
+    qDebug() << "Bundled" << m_instances.size() << "instance(s) and" << m_files.size() << "file(s) in" << m_output;
+    emitSucceeded();
+}
+
+OfflineBundleImportTask::OfflineBundleImportTask(QString bundle, QObject* parent) : Task(parent), m_bundle(std::move(bundle)) {}
+
+void OfflineBundleImportTask::executeTask()
+{
+    setStatus(tr("Extracting %1...").arg(QFileInfo(m_bundle).fileName()));
+    auto instances_dir = QDir(APPLICATION->settings()->get("InstanceDir").toString()).absolutePath();
+    m_extract = QtConcurrent::run(Executors::io(), [this, instances_dir] { return extract(instances_dir); });
+    connect(&m_extract_watcher, &QFutureWatcher<Extracted>::finished, this, &OfflineBundleImportTask::hydrate);
+    m_extract_watcher.setFuture(m_extract);
+}
+
+bool OfflineBundleImportTask::abort()
+{
+    if (m_extract.isRunning()) {
+        m_extract.cancel();
+        return true;
+    }
+    return Task::abort();
+}
+
+OfflineBundleImportTask::Extracted OfflineBundleImportTask::extract(const QString& instances_dir)
+{
+    Extracted extracted;
+    MMCZip::ArchiveReader zip(m_bundle);
+    if (!zip.open()) {
+        extracted.error = tr("Could not open %1").arg(m_bundle);
+        return extracted;
+    }
+
+    auto manifest_data = zip.read(s_manifest_name);
+    if (!manifest_data) {
+        extracted.error = tr("%1 is not a bundle, it has no manifest").arg(m_bundle);
+        return extracted;
+    }
+    try {
+        extracted.manifest = Json::requireObject(Json::requireDocument(*manifest_data, s_manifest_name), s_manifest_name);
+    } catch (const Exception& e) {
+        extracted.error = tr("The manifest of the bundle can't be read: %1").arg(e.cause());
+        return extracted;
+    }
+    if (extracted.manifest["formatVersion"].toInt() != s_format_version) {
+        extracted.error = tr("The bundle was made by a version of the launcher this one doesn't understand");
+        return extracted;
+    }
+
+    // an instance that is here already is left as it is, the bundle doesn't know what changed in it since
+    QSet<QString> skipped;
+    for (auto value : extracted.manifest["instances"].toArray()) {
+        auto id = value.toObject()["id"].toString();
+        if (id.isEmpty() || id.contains('/') || id == "..")
+            continue;
+        if (QDir(FS::PathCombine(instances_dir, id)).exists()) {
+            qWarning() << "Not importing instance" << id << "from the bundle, there is one with that ID already";
+            skipped.insert(id);
+            continue;
+        }
+        extracted.instances.append(id);
+    }
+
+    QSet<QString> cached;
+    for (auto value : extracted.manifest["cache"].toArray())
+        cached.insert(value.toObject()["path"].toString());
+
+    // a single pass over the archive, each file going where it would have been downloaded to
+    auto& entries = zip.entries();
+    int done = 0, total = entries.size();
+    for (auto& entry : entries) {
+        if (m_extract.isCanceled())
+            return extracted;
+        setProgress(++done, total);
+        if (entry.name == s_manifest_name || entry.name.endsWith('/'))
+            continue;
+        if (!isImportable(entry.name)) {
+            qWarning() << "Not importing" << entry.name << "from the bundle, it doesn't go anywhere the launcher knows";
+            continue;
+        }
+
+        QString target;
+        if (entry.name.startsWith(s_instances_prefix)) {
+            auto relative = entry.name.mid(s_instances_prefix.size());
+            auto id = relative.left(relative.indexOf('/'));
+            if (!extracted.instances.contains(id))
+                continue;
+            target = FS::PathCombine(instances_dir, relative);
+        } else {
+            target = QDir::current().absoluteFilePath(entry.name);
+        }
+
+        if (!FS::ensureFilePathExists(target) || !zip.extract(entry, target)) {
+            extracted.error = tr("Could not extract %1").arg(entry.name);
+            return extracted;
+        }
+        if (cached.contains(entry.name))
+            extracted.cached_files.insert(entry.name, QFileInfo(target).lastModified().toUTC().toMSecsSinceEpoch());
+    }
+    return extracted;
+}
+
+void OfflineBundleImportTask::hydrate()
+{
+    if (m_extract.isCanceled()) {
+        emitAborted();
+        return;
+    }
+    auto extracted = m_extract.result();
+    if (!extracted.error.isEmpty()) {
+        emitFailed(extracted.error);
+        return;
+    }
+
+    // the cache knows the files as if they had just been downloaded
+    setStatus(tr("Adding the files to the cache..."));
+    auto metacache = APPLICATION->metacache();
+    int added = 0;
+    for (auto value : extracted.manifest["cache"].toArray()) {
+        auto record = value.toObject();
+        auto path = record["path"].toString();
+        auto base = cacheBase(path);
+        if (base.isEmpty() || !extracted.cached_files.contains(path))
+            continue;
+
+        auto entry = metacache->resolveEntry(base, cachePath(path));
+        entry->setMD5Sum(record["md5"].toString());
+        entry->setETag(record["etag"].toString());
+        entry->setRemoteChangedTimestamp(record["remoteChanged"].toString());
+        entry->setLocalChangedTimestamp(extracted.cached_files.value(path));
+        entry->makeEternal(record["eternal"].toBool());
+        entry->setMaximumAge(record["maxAge"].toVariant().toLongLong());
+        entry->setCurrentAge(0);
+        entry->setStale(false);
+        if (metacache->updateEntry(entry))
+            added++;
+    }
+    metacache->SaveNow();
+
+    APPLICATION->instances()->loadList();
+    for (auto value : extracted.manifest["instances"].toArray()) {
+        auto record = value.toObject();
+        auto id = record["id"].toString();
+        if (!extracted.instances.contains(id))
+            continue;
+        auto instance = APPLICATION->instances()->getInstanceById(id);
+        if (!instance) {
+            qWarning() << "The instance" << id << "from the bundle couldn't be loaded";
+            continue;
+        }
+        m_imported.append(id);
+
+        auto runtime = record["javaRuntime"].toString();
+        if (!runtime.isEmpty()) {
+            instance->settings()->set("OverrideJavaLocation", true);
+            instance->settings()->set("JavaPath", ManagedRuntime::javaPath(runtime));
+        }
+    }
+
+    qDebug() << "Imported" << m_imported.size() << "instance(s) from" << m_bundle << "with" << added << "cache entries";
+    emitSucceeded();
+}
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <optional>
+
+#include "BaseInstance.h"
+#include "tasks/Task.h"
+
+class MinecraftInstance;
+
+/* Everything some instances need to launch, in a single zip, for machines that can't download it.
+ *
+ * A bundle holds the instances themselves, and what they share with others in the data folder: the libraries, the
+ * asset index and objects, the metadata of their components, and the managed Java runtime they use. Its manifest
+ * ("bundle.json", the first entry) lists the instances, and the entries of the HttpMetaCache the shared files had, so
+ * importing a bundle puts the files where the launcher would have downloaded them and makes the cache know them, and
+ * nothing gets downloaded again once there is a network. An instance imported from a bundle launches offline right
+ * away.
+ *
+ * The files are under the same path in the bundle as in the data folder, the instances under "instances/<id>/".
+ */
+namespace OfflineBundle {
+
+constexpr int s_format_version = 1;
+extern const QString s_manifest_name;
+
+/** The HttpMetaCache base a file in the bundle belongs to, empty for the files the cache doesn't know about. */
+QString cacheBase(const QString& path);
+
+/** Where a file in the bundle is in its cache base. */
+QString cachePath(const QString& path);
+
+/** Whether an entry of a bundle is one an import may write, nothing outside the folders a bundle has. */
+bool isImportable(const QString& path);
+
+}  // namespace OfflineBundle
+
+class OfflineBundleExportTask : public Task {
+    Q_OBJECT
+   public:
+    /** Instances that aren't Minecraft instances are left out. */
+    OfflineBundleExportTask(const QList<InstancePtr>& instances, QString output, QObject* parent = nullptr);
+
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    using BuildResult = std::optional<QString>;
+
+    void collectFiles();
+    void addFile(const QString& path);
+    void addFolder(const QString& path, const QString& prefix);
+    BuildResult buildZip(const QByteArray& manifest);
+    void finish();
+
+   private:
+    QList<std::shared_ptr<MinecraftInstance>> m_instances;
+    QString m_output;
+    Task::Ptr m_step;
+
+    // path in the bundle -> path on disk
+    QList<QPair<QString, QString>> m_files;
+    QSet<QString> m_added;
+    QJsonObject m_manifest;
+
+    QFuture<BuildResult> m_build;
+    QFutureWatcher<BuildResult> m_build_watcher;
+};
+
+class OfflineBundleImportTask : public Task {
+    Q_OBJECT
+   public:
+    explicit OfflineBundleImportTask(QString bundle, QObject* parent = nullptr);
+
+    /** The IDs of the instances that came with the bundle, once it succeeded. */
+    QStringList importedInstances() const { return m_imported; }
+
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    struct Extracted {
+        QString error;
+        QJsonObject manifest;
+        QStringList instances;
+        // the extracted files of the cache bases, by their path in the bundle, with their modification time
+        QHash<QString, qint64> cached_files;
+    };
+
+    Extracted extract(const QString& instances_dir);
+    void hydrate();
+
+   private:
+    QString m_bundle;
+    QStringList m_imported;
+
+    QFuture<Extracted> m_extract;
+    QFutureWatcher<Extracted> m_extract_watcher;
+};
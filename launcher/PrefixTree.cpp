@@ -0,0 +1,236 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "PrefixTree.h"
+
+#include <QVarLengthArray>
+
+namespace {
+// Goes through the parts of a path, an empty path being one empty part like the separated ones
+class PartWalker {
+   public:
+    PartWalker(QStringView path, QChar separator) : m_path(path), m_separator(separator) {}
+
+    bool next(QStringView& part)
+    {
+        if (m_done)
+            return false;
+        auto end = m_start;
+        while (end < m_path.size() && m_path[end] != m_separator)
+            end++;
+        part = m_path.mid(m_start, end - m_start);
+        m_end = end;
+        m_done = end == m_path.size();
+        m_start = end + 1;
+        return true;
+    }
+    /** Where the last part returned ends in the path. */
+    qsizetype end() const { return m_end; }
+
+   private:
+    QStringView m_path;
+    QChar m_separator;
+    qsizetype m_start = 0;
+    qsizetype m_end = 0;
+    bool m_done = false;
+};
+}  // namespace
+
+PrefixTree::PrefixTree(QChar separator, bool contained) : m_separator(separator)
+{
+    Entry root;
+    root.contained = contained;
+    m_nodes.append(root);
+}
+
+int PrefixTree::childPosition(int node, QStringView name) const
+{
+    // the first child that doesn't sort before the name
+    auto& children = m_nodes[node].children;
+    int low = 0;
+    int high = children.size();
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (QStringView(m_names[m_nodes[children[middle]].name]) < name)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+int PrefixTree::child(int node, QStringView name) const
+{
+    auto& children = m_nodes[node].children;
+    auto position = childPosition(node, name);
+    if (position < children.size() && QStringView(m_names[m_nodes[children[position]].name]) == name)
+        return children[position];
+    return -1;
+}
+
+int PrefixTree::intern(QStringView name)
+{
+    auto key = name.toString();
+    auto found = m_name_ids.constFind(key);
+    if (found != m_name_ids.constEnd())
+        return *found;
+    m_names.append(key);
+    m_name_ids.insert(key, m_names.size() - 1);
+    return m_names.size() - 1;
+}
+
+int PrefixTree::addChild(int node, QStringView name)
+{
+    auto position = childPosition(node, name);
+    auto& children = m_nodes[node].children;
+    if (position < children.size() && QStringView(m_names[m_nodes[children[position]].name]) == name)
+        return children[position];
+
+    Entry entry;
+    entry.name = intern(name);
+    int index;
+    if (!m_free.isEmpty()) {
+        index = m_free.takeLast();
+        m_nodes[index] = entry;
+    } else {
+        index = m_nodes.size();
+        m_nodes.append(entry);
+    }
+    // appending may have moved the nodes
+    m_nodes[node].children.insert(position, index);
+    return index;
+}
+
+void PrefixTree::clearChildren(int node)
+{
+    QVarLengthArray<int, 32> todo;
+    for (auto child : m_nodes[node].children)
+        todo.append(child);
+    m_nodes[node].children.clear();
+    while (!todo.isEmpty()) {
+        auto index = todo.takeLast();
+        for (auto child : m_nodes[index].children)
+            todo.append(child);
+        m_nodes[index].children.clear();
+        m_nodes[index].contained = false;
+        m_free.append(index);
+    }
+}
+
+PrefixTree::Node PrefixTree::insert(QStringView path)
+{
+    int node = 0;
+    PartWalker walker(path, m_separator);
+    QStringView part;
+    while (walker.next(part))
+        node = addChild(node, part);
+    // the inserted path covers whatever was under it
+    clearChildren(node);
+    m_nodes[node].contained = true;
+    return { this, node };
+}
+
+bool PrefixTree::find(QStringView path, int& index) const
+{
+    int node = 0;
+    PartWalker walker(path, m_separator);
+    QStringView part;
+    while (walker.next(part)) {
+        node = child(node, part);
+        if (node == -1)
+            return false;
+    }
+    index = node;
+    return true;
+}
+
+bool PrefixTree::exists(QStringView path) const
+{
+    int index;
+    return find(path, index);
+}
+
+bool PrefixTree::covers(QStringView path) const
+{
+    int node = 0;
+    PartWalker walker(path, m_separator);
+    QStringView part;
+    while (!m_nodes[node].contained) {
+        if (!walker.next(part))
+            return false;
+        node = child(node, part);
+        if (node == -1)
+            return false;
+    }
+    return true;
+}
+
+QString PrefixTree::cover(QStringView path) const
+{
+    if (m_nodes[0].contained)
+        return QString("");
+    int node = 0;
+    PartWalker walker(path, m_separator);
+    QStringView part;
+    while (walker.next(part)) {
+        node = child(node, part);
+        if (node == -1)
+            return QString();
+        if (m_nodes[node].contained)
+            return path.left(walker.end()).toString();
+    }
+    return QString();
+}
+
+bool PrefixTree::remove(QStringView path)
+{
+    QVarLengthArray<int, 16> chain;
+    chain.append(0);
+    if (!path.isEmpty()) {
+        PartWalker walker(path, m_separator);
+        QStringView part;
+        while (walker.next(part)) {
+            auto node = child(chain.last(), part);
+            if (node == -1)
+                return false;
+            chain.append(node);
+        }
+    }
+
+    auto target = chain.last();
+    if (m_nodes[target].contained) {
+        m_nodes[target].contained = false;
+        if (!m_nodes[target].children.isEmpty())
+            return true;
+    } else {
+        // removing a prefix removes everything under it
+        clearChildren(target);
+    }
+
+    // take out the nodes that are left with nothing in them, the root always stays
+    for (int i = chain.size() - 1; i > 0; i--) {
+        auto node = chain[i];
+        auto parent = chain[i - 1];
+        m_nodes[parent].children.removeOne(node);
+        m_free.append(node);
+        if (m_nodes[parent].contained || !m_nodes[parent].children.isEmpty())
+            break;
+    }
+    return true;
+}
+
+void PrefixTree::collect(int node, const QString& prefix, QStringList& into) const
+{
+    for (auto child : m_nodes[node].children) {
+        auto path = prefix + m_names[m_nodes[child].name];
+        collect(child, path + m_separator, into);
+        if (m_nodes[child].contained)
+            into.append(path);
+    }
+}
+
+QStringList PrefixTree::toStringList() const
+{
+    QStringList collected;
+    collect(0, QString(), collected);
+    return collected;
+}
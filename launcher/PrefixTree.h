@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QChar>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+
+/* A prefix tree of paths, where the node names are the parts between separators.
+ *
+ * All the nodes live in one array and refer to each other by index, and every name is stored once, however many
+ * nodes have it. Looking a path up walks it as a view, so nothing gets allocated for the parts of the path. The
+ * children of a node are sorted by name, so they can be searched and listed in order.
+ *
+ * Removed nodes are kept for reuse by the next inserts.
+ */
+class PrefixTree {
+   public:
+    template <typename Tree>
+    class NodeRef {
+       public:
+        NodeRef(Tree* tree, int index) : m_tree(tree), m_index(index) {}
+
+        /** Whether the node has no children. */
+        bool leaf() const { return m_tree->m_nodes[m_index].children.isEmpty(); }
+        /** Whether the node was inserted, and isn't only there for the paths under it. */
+        bool contained() const { return m_tree->m_nodes[m_index].contained; }
+        /** Removes everything under the node. */
+        void clear() { m_tree->clearChildren(m_index); }
+
+       private:
+        Tree* m_tree;
+        int m_index;
+    };
+    using Node = NodeRef<PrefixTree>;
+    using ConstNode = NodeRef<const PrefixTree>;
+
+    explicit PrefixTree(QChar separator, bool contained = false);
+
+    /** Inserts a path, which also covers everything under it from now on. */
+    Node insert(QStringView path);
+    /** Whether the path was inserted, or one of the paths in the tree goes through it. */
+    bool exists(QStringView path) const;
+    /** Whether the path, or one of the folders it is in, were inserted. */
+    bool covers(QStringView path) const;
+    /** The inserted path that covers the path, an empty string if that's the root and a null one if there's none. */
+    QString cover(QStringView path) const;
+    /** The node of the path, if it exists. */
+    bool find(QStringView path, int& index) const;
+    ConstNode node(int index) const { return { this, index }; }
+    Node node(int index) { return { this, index }; }
+
+    /** Removes an inserted path or a prefix and everything under it. An empty path is the root. */
+    bool remove(QStringView path);
+    /** Removes everything, the root stays as it is. */
+    void clear() { clearChildren(0); }
+
+    /** All the inserted paths, the paths in a folder before the folder itself. */
+    QStringList toStringList() const;
+
+   private:
+    struct Entry {
+        int name = -1;
+        bool contained = false;
+        QVector<int> children;
+    };
+
+    int child(int node, QStringView name) const;
+    int childPosition(int node, QStringView name) const;
+    int addChild(int node, QStringView name);
+    int intern(QStringView name);
+    void clearChildren(int node);
+    void collect(int node, const QString& prefix, QStringList& into) const;
+
+   private:
+    QChar m_separator;
+    QVector<Entry> m_nodes;
+    QVector<int> m_free;
+    QStringList m_names;
+    QHash<QString, int> m_name_ids;
+};
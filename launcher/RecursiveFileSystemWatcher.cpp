@@ -2,14 +2,12 @@
 
 #include <QRegularExpression>
 #include <QDebug>
+#include <QFileInfo>
 
 RecursiveFileSystemWatcher::RecursiveFileSystemWatcher(QObject *parent)
-    : QObject(parent), m_watcher(new QFileSystemWatcher(this))
+    : QObject(parent), m_watcher(new FileWatcher(this))
 {
-    connect(m_watcher, &QFileSystemWatcher::fileChanged, this,
-            &RecursiveFileSystemWatcher::fileChange);
-    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this,
-            &RecursiveFileSystemWatcher::directoryChange);
+    connect(m_watcher, &FileWatcher::changed, this, &RecursiveFileSystemWatcher::changes);
 }
 
 void RecursiveFileSystemWatcher::setRootDir(const QDir &root)
@@ -41,7 +39,10 @@ void RecursiveFileSystemWatcher::enable()
         return;
     }
     Q_ASSERT(m_root != QDir::root());
-    addFilesToWatcherRecursive(m_root);
+    // one watch for the whole tree where the system can do it, the backend takes care of the subfolders elsewhere
+    m_watcher->setWatchFiles(m_watchFiles);
+    m_watcher->setMatcher(m_matcher);
+    m_watcher->addPath(m_root.absolutePath(), FileWatcher::Mode::Recursive);
     m_isEnabled = true;
 }
 void RecursiveFileSystemWatcher::disable()
@@ -51,8 +52,7 @@ void RecursiveFileSystemWatcher::disable()
         return;
     }
     m_isEnabled = false;
-    m_watcher->removePaths(m_watcher->files());
-    m_watcher->removePaths(m_watcher->directories());
+    m_watcher->removeAll();
 }
 
 void RecursiveFileSystemWatcher::setFiles(const QStringList &files)
@@ -64,21 +64,6 @@ void RecursiveFileSystemWatcher::setFiles(const QStringList &files)
     }
 }
 
-void RecursiveFileSystemWatcher::addFilesToWatcherRecursive(const QDir &dir)
-{
-    m_watcher->addPath(dir.absolutePath());
-    for (const QString &directory : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
-    {
-        addFilesToWatcherRecursive(dir.absoluteFilePath(directory));
-    }
-    if (m_watchFiles)
-    {
-        for (const QFileInfo &info : dir.entryInfoList(QDir::Files))
-        {
-            m_watcher->addPath(info.absoluteFilePath());
-        }
-    }
-}
 QStringList RecursiveFileSystemWatcher::scanRecursive(const QDir &directory)
 {
     QStringList ret;
@@ -101,11 +86,32 @@ QStringList RecursiveFileSystemWatcher::scanRecursive(const QDir &directory)
     return ret;
 }
 
-void RecursiveFileSystemWatcher::fileChange(const QString &path)
+void RecursiveFileSystemWatcher::changes(const QString &dir, const QStringList &paths)
 {
-    emit fileChanged(path);
-}
-void RecursiveFileSystemWatcher::directoryChange(const QString &path)
-{
-    setFiles(scanRecursive(m_root));
+    // the watcher only passes on matching files, the folders are the only reason to look at the whole tree again
+    bool rescan = false;
+    auto files = m_files;
+    for (const QString &path : paths)
+    {
+        QFileInfo info(path);
+        auto relPath = m_root.relativeFilePath(path);
+        if (path == dir || info.isDir() || !m_matcher || !m_matcher->matches(relPath))
+        {
+            rescan = true;
+            continue;
+        }
+        if (!info.exists())
+        {
+            files.removeAll(relPath);
+        }
+        else if (!files.contains(relPath))
+        {
+            files.append(relPath);
+        }
+        else if (m_watchFiles)
+        {
+            emit fileChanged(path);
+        }
+    }
+    setFiles(rescan ? scanRecursive(m_root) : files);
 }
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <QFileSystemWatcher>
 #include <QDir>
+#include "FileWatcher.h"
 #include "pathmatcher/IPathMatcher.h"
 
 class RecursiveFileSystemWatcher : public QObject
@@ -47,15 +47,13 @@ private:
     bool m_isEnabled = false;
     IPathMatcher::Ptr m_matcher;
 
-    QFileSystemWatcher *m_watcher;
+    FileWatcher *m_watcher;
 
     QStringList m_files;
     void setFiles(const QStringList &files);
 
-    void addFilesToWatcherRecursive(const QDir &dir);
     QStringList scanRecursive(const QDir &dir);
 
 private slots:
-    void fileChange(const QString &path);
-    void directoryChange(const QString &path);
+    void changes(const QString &dir, const QStringList &paths);
 };
@@ -17,8 +17,12 @@
 #include "net/HttpMetaCache.h"
 #include "Application.h"
 
+#include <QCache>
+#include <QCryptographicHash>
 #include <QFile>
+#include <QFutureWatcher>
 #include <QPainter>
+#include <QtConcurrentRun>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -47,4 +51,65 @@ QPixmap getFaceFromCache(QString username, int height, int width)
 
     return QPixmap();
 }
+
+namespace {
+struct FaceCache {
+    // a few faces for every account, they're tiny
+    QCache<QString, QPixmap> faces{ 256 };
+    QHash<QString, QList<std::function<void()>>> pending;
+};
+
+FaceCache& faceCache()
+{
+    static FaceCache s_cache;
+    return s_cache;
+}
+
+// QPixmap is only for the GUI thread, this is done with images
+QImage renderFace(const QByteArray& skin, int size)
+{
+    QImage texture;
+    if (!texture.loadFromData(skin, "PNG"))
+        return {};
+
+    QImage face(8, 8, QImage::Format_ARGB32_Premultiplied);
+    face.fill(Qt::transparent);
+    QPainter painter(&face);
+    painter.drawImage(0, 0, texture.copy(8, 8, 8, 8));
+    // the hat goes over it
+    painter.drawImage(0, 0, texture.copy(40, 8, 8, 8));
+    painter.end();
+    return face.scaled(size, size, Qt::KeepAspectRatio);
+}
+}  // namespace
+
+QPixmap getFace(const QByteArray& skin, int size, std::function<void()> ready)
+{
+    if (skin.isEmpty())
+        return {};
+
+    auto& cache = faceCache();
+    auto key = QString("%1-%2").arg(QString(QCryptographicHash::hash(skin, QCryptographicHash::Sha1).toHex())).arg(size);
+    if (auto face = cache.faces.object(key))
+        return *face;
+
+    auto pending = cache.pending.find(key);
+    if (pending != cache.pending.end()) {
+        if (ready)
+            pending->append(ready);
+        return {};
+    }
+
+    cache.pending.insert(key, ready ? QList<std::function<void()>>{ ready } : QList<std::function<void()>>{});
+    auto watcher = new QFutureWatcher<QImage>(APPLICATION);
+    QObject::connect(watcher, &QFutureWatcher<QImage>::finished, APPLICATION, [watcher, key] {
+        watcher->deleteLater();
+        auto& cache = faceCache();
+        cache.faces.insert(key, new QPixmap(QPixmap::fromImage(watcher->result())));
+        for (auto const& callback : cache.pending.take(key))
+            callback();
+    });
+    watcher->setFuture(QtConcurrent::run([skin, size] { return renderFace(skin, size); }));
+    return {};
+}
 }
@@ -15,9 +15,20 @@
 
 #pragma once
 
+#include <QByteArray>
 #include <QPixmap>
 
+#include <functional>
+
 namespace SkinUtils
 {
 QPixmap getFaceFromCache(QString id, int height = 64, int width = 64);
+
+/**
+ * The face of the skin in the PNG `skin`, `size` pixels wide, from a cache of the faces rendered so far.
+ *
+ * A face that isn't in the cache yet is rendered in the background. It's null until then, and `ready` is called on the
+ * GUI thread once it's there. A skin that can't be read stays null.
+ */
+QPixmap getFace(const QByteArray& skin, int size = 64, std::function<void()> ready = {});
 }
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "StartupPhases.h"
+
+#include <QDebug>
+
+void StartupPhases::join()
+{
+    for (auto& future : m_started)
+        future.waitForFinished();
+    m_started.clear();
+}
+
+void StartupPhases::record(const QString& name, qint64 nsecs, bool background)
+{
+    QMutexLocker locker(&m_mutex);
+    m_phases.append({ name, nsecs, background });
+}
+
+void StartupPhases::report() const
+{
+    QMutexLocker locker(&m_mutex);
+    qDebug() << "<> Startup profile:";
+    for (auto& phase : m_phases) {
+        qDebug().noquote() << QString("    %1: %2 ms%3")
+                                  .arg(phase.name)
+                                  .arg(phase.nsecs / 1000000.0, 0, 'f', 1)
+                                  .arg(phase.background ? " (in the background)" : "");
+    }
+    qDebug().noquote() << QString("    Total: %1 ms").arg(m_total.nsecsElapsed() / 1000000.0, 0, 'f', 1);
+}
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <type_traits>
+
+/* Times the phases of the startup, and runs the ones that don't need the GUI thread or each other on the thread pool.
+ *
+ * What runs on the pool only gets copies of what it needs, and its result is only used on the GUI thread once the
+ * future for it is done. Everything started is waited for by join(), at the latest when this goes away.
+ */
+class StartupPhases {
+   public:
+    StartupPhases() { m_total.start(); }
+    ~StartupPhases() { join(); }
+
+    /** Runs `work` right away on this thread, timed as `name`. */
+    template <typename Work>
+    void run(const QString& name, Work work)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        work();
+        record(name, timer.nsecsElapsed(), false);
+    }
+
+    /** Starts `work` on the global thread pool, timed as `name`. Its result comes from the returned future. */
+    template <typename Work>
+    auto start(const QString& name, Work work) -> QFuture<decltype(work())>
+    {
+        using Result = decltype(work());
+        auto future = QtConcurrent::run(QThreadPool::globalInstance(), [this, name, work]() -> Result {
+            QElapsedTimer timer;
+            timer.start();
+            if constexpr (std::is_void_v<Result>) {
+                work();
+                record(name, timer.nsecsElapsed(), true);
+            } else {
+                auto result = work();
+                record(name, timer.nsecsElapsed(), true);
+                return result;
+            }
+        });
+        m_started.append(QFuture<void>(future));
+        return future;
+    }
+
+    /** Waits for everything that was started. */
+    void join();
+
+    /** Logs how long every phase took, and the whole startup so far. */
+    void report() const;
+
+   private:
+    struct Phase {
+        QString name;
+        qint64 nsecs = 0;
+        bool background = false;
+    };
+
+    void record(const QString& name, qint64 nsecs, bool background);
+
+   private:
+    QElapsedTimer m_total;
+    QList<QFuture<void>> m_started;
+    mutable QMutex m_mutex;
+    QVector<Phase> m_phases;
+};
@@ -0,0 +1,449 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "StreamExtractor.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QSet>
+#include <QThreadPool>
+#include <QUrl>
+#include <QtConcurrent>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <climits>
+
+#include "ArchiveReader.h"
+#include "Executors.h"
+#include "FileSystem.h"
+
+namespace MMCZip {
+
+namespace {
+
+constexpr quint32 s_local_header_signature = 0x04034b50;
+constexpr quint32 s_central_header_signature = 0x02014b50;
+constexpr quint32 s_end_of_central_dir_signature = 0x06054b50;
+constexpr quint32 s_data_descriptor_signature = 0x08074b50;
+
+constexpr qint64 s_local_header_size = 30;
+
+constexpr quint16 s_flag_encrypted = 1 << 0;
+constexpr quint16 s_flag_data_descriptor = 1 << 3;
+constexpr quint16 s_flag_utf8 = 1 << 11;
+
+constexpr quint16 s_extra_zip64 = 0x0001;
+
+constexpr quint16 s_method_stored = 0;
+constexpr quint16 s_method_deflated = 8;
+
+// When the network is faster than the disk, don't keep more than this in memory: use the usual extraction instead
+constexpr int s_max_pending = 256 * 1024 * 1024;
+constexpr int s_output_chunk = 256 * 1024;
+
+// All the numbers in zip files are little-endian
+quint16 read16(const uchar* p)
+{
+    return quint16(p[0]) | quint16(p[1]) << 8;
+}
+
+quint32 read32(const uchar* p)
+{
+    return quint32(p[0]) | quint32(p[1]) << 8 | quint32(p[2]) << 16 | quint32(p[3]) << 24;
+}
+
+quint64 read64(const uchar* p)
+{
+    return quint64(read32(p)) | quint64(read32(p + 4)) << 32;
+}
+
+}  // namespace
+
+StreamExtractor::StreamExtractor(QString target) : m_target(std::move(target)) {}
+
+StreamExtractor::~StreamExtractor()
+{
+    stopWorker();
+}
+
+void StreamExtractor::stopWorker()
+{
+    cancel();
+    m_worker.waitForFinished();
+}
+
+void StreamExtractor::reset()
+{
+    stopWorker();
+
+    m_pending.clear();
+    m_finished = false;
+    m_cancelled = false;
+    m_given_up = false;
+    m_buffer.clear();
+    m_offset = 0;
+    m_extracted.clear();
+    m_complete = false;
+    m_started = false;
+
+    FS::deletePath(m_target);
+}
+
+void StreamExtractor::feed(const QByteArray& data)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_given_up || m_cancelled || m_finished || data.isEmpty())
+        return;
+
+    if (m_pending.size() > s_max_pending - data.size()) {
+        qDebug() << "Not extracting" << m_target << "while downloading anymore: the extraction can't keep up";
+        m_given_up = true;
+        m_pending.clear();
+        m_wake.wakeAll();
+        return;
+    }
+
+    m_pending.append(data);
+    if (!m_started) {
+        m_started = true;
+        m_worker = QtConcurrent::run(Executors::io(), [this] { run(); });
+    }
+    m_wake.wakeAll();
+}
+
+void StreamExtractor::finish()
+{
+    QMutexLocker locker(&m_mutex);
+    m_finished = true;
+    m_wake.wakeAll();
+}
+
+void StreamExtractor::cancel()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cancelled = true;
+    m_wake.wakeAll();
+}
+
+bool StreamExtractor::validate(const QString& archive)
+{
+    finish();
+    m_worker.waitForFinished();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_given_up || m_cancelled || !m_complete)
+            return false;
+    }
+
+    ArchiveReader reader(archive);
+    if (!reader.open())
+        return false;
+
+    QSet<QString> names;
+    for (auto& name : reader.fileNames()) {
+        if (names.contains(name))
+            continue;
+        names.insert(name);
+
+        auto central = reader.entry(name);
+        auto local = m_extracted.constFind(name);
+        if (local == m_extracted.constEnd() || local->crc32 != central->crc32 || local->uncompressed_size != central->uncompressed_size) {
+            qDebug() << "Extracted" << name << "while downloading, but it doesn't match the central directory of" << archive;
+            return false;
+        }
+    }
+    if (names.size() != m_extracted.size()) {
+        qDebug() << "Extracted entries that aren't in the central directory of" << archive;
+        return false;
+    }
+    return true;
+}
+
+void StreamExtractor::giveUp(const QString& reason)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_cancelled)
+        qDebug() << "Not extracting" << m_target << "while downloading anymore:" << reason;
+    m_given_up = true;
+    m_pending.clear();
+}
+
+void StreamExtractor::run()
+{
+    for (bool done = false; !done;) {
+        if (!extractNext(done))
+            return;
+    }
+    m_complete = true;
+}
+
+bool StreamExtractor::fill(qint64 size)
+{
+    while (m_buffer.size() - m_offset < size) {
+        QMutexLocker locker(&m_mutex);
+        while (m_pending.isEmpty() && !m_finished && !m_cancelled && !m_given_up)
+            m_wake.wait(&m_mutex);
+        if (m_cancelled || m_given_up || m_pending.isEmpty())
+            return false;
+
+        m_buffer.remove(0, m_offset);
+        m_offset = 0;
+        m_buffer.append(m_pending);
+        m_pending.clear();
+    }
+    return true;
+}
+
+qint64 StreamExtractor::fillSome()
+{
+    if (m_buffer.size() - m_offset > 0 || fill(1))
+        return m_buffer.size() - m_offset;
+    return 0;
+}
+
+QString StreamExtractor::targetPath(const QString& name) const
+{
+    auto relative = QDir::fromNativeSeparators(name);
+    while (relative.startsWith('/'))
+        relative.remove(0, 1);
+
+    auto path = FS::PathCombine(m_target, relative);
+    if (!QUrl::fromLocalFile(m_target).isParentOf(QUrl::fromLocalFile(path)))
+        return {};
+    return path;
+}
+
+bool StreamExtractor::extractNext(bool& done)
+{
+    if (!fill(4)) {
+        giveUp("the archive ended before its central directory");
+        return false;
+    }
+
+    auto signature = read32(reinterpret_cast<const uchar*>(m_buffer.constData()) + m_offset);
+    if (signature == s_central_header_signature || signature == s_end_of_central_dir_signature) {
+        // everything else is in the central directory, which is read from the complete archive
+        done = true;
+        return true;
+    }
+    if (signature != s_local_header_signature) {
+        giveUp("unexpected data in the archive");
+        return false;
+    }
+
+    if (!fill(s_local_header_size)) {
+        giveUp("the archive ended in a file header");
+        return false;
+    }
+    auto header = reinterpret_cast<const uchar*>(m_buffer.constData()) + m_offset;
+    quint16 flags = read16(header + 6);
+    quint16 method = read16(header + 8);
+    quint32 crc = read32(header + 14);
+    quint64 compressed_size = read32(header + 18);
+    quint64 uncompressed_size = read32(header + 22);
+    quint16 name_length = read16(header + 26);
+    quint16 extra_length = read16(header + 28);
+
+    if (!fill(s_local_header_size + name_length + extra_length)) {
+        giveUp("the archive ended in a file header");
+        return false;
+    }
+    header = reinterpret_cast<const uchar*>(m_buffer.constData()) + m_offset;
+
+    auto raw_name = reinterpret_cast<const char*>(header + s_local_header_size);
+    auto name = flags & s_flag_utf8 ? QString::fromUtf8(raw_name, name_length) : QString::fromLocal8Bit(raw_name, name_length);
+
+    // The sizes that don't fit in the header are in the zip64 extended information, and so are the ones of the data descriptor
+    bool zip64 = false;
+    auto extra = header + s_local_header_size + name_length;
+    auto extra_end = extra + extra_length;
+    while (extra + 4 <= extra_end) {
+        quint16 id = read16(extra);
+        quint16 size = read16(extra + 2);
+        auto field = extra + 4;
+        auto field_end = std::min(field + size, extra_end);
+        if (id == s_extra_zip64) {
+            zip64 = true;
+            if (uncompressed_size == 0xffffffff && field + 8 <= field_end) {
+                uncompressed_size = read64(field);
+                field += 8;
+            }
+            if (compressed_size == 0xffffffff && field + 8 <= field_end)
+                compressed_size = read64(field);
+        }
+        extra = field + size;
+    }
+    m_offset += s_local_header_size + name_length + extra_length;
+
+    if (flags & s_flag_encrypted) {
+        giveUp("encrypted entries are not supported");
+        return false;
+    }
+
+    auto path = targetPath(name);
+    if (path.isEmpty()) {
+        giveUp(name + " would be outside of the target folder");
+        return false;
+    }
+
+    bool has_descriptor = flags & s_flag_data_descriptor;
+    if (name.endsWith('/') && compressed_size == 0 && !has_descriptor) {
+        if (!FS::ensureFolderPathExists(path)) {
+            giveUp("could not create " + path);
+            return false;
+        }
+        m_extracted.insert(name, {});
+        return true;
+    }
+
+    quint32 actual_crc = 0;
+    quint64 actual_compressed_size = 0;
+    quint64 actual_uncompressed_size = 0;
+    switch (method) {
+        case s_method_stored:
+            // there's no telling where the data ends
+            if (has_descriptor) {
+                giveUp("stored entries of unknown size are not supported");
+                return false;
+            }
+            if (!writeStored(path, compressed_size, actual_crc))
+                return false;
+            actual_compressed_size = actual_uncompressed_size = compressed_size;
+            break;
+        case s_method_deflated:
+            if (!writeDeflated(path, actual_compressed_size, actual_uncompressed_size, actual_crc))
+                return false;
+            break;
+        default:
+            giveUp(QString("unsupported compression method %1").arg(method));
+            return false;
+    }
+
+    if (has_descriptor) {
+        qint64 size_length = zip64 ? 8 : 4;
+        if (!fill(4 + 4 + 2 * size_length)) {
+            giveUp("the archive ended in a data descriptor");
+            return false;
+        }
+        auto descriptor = reinterpret_cast<const uchar*>(m_buffer.constData()) + m_offset;
+        // the signature is optional
+        if (read32(descriptor) == s_data_descriptor_signature) {
+            m_offset += 4;
+            if (!fill(4 + 2 * size_length)) {
+                giveUp("the archive ended in a data descriptor");
+                return false;
+            }
+            descriptor = reinterpret_cast<const uchar*>(m_buffer.constData()) + m_offset;
+        }
+        crc = read32(descriptor);
+        compressed_size = zip64 ? read64(descriptor + 4) : read32(descriptor + 4);
+        uncompressed_size = zip64 ? read64(descriptor + 12) : read32(descriptor + 8);
+        m_offset += 4 + 2 * size_length;
+    }
+
+    if (crc != actual_crc || compressed_size != actual_compressed_size || uncompressed_size != actual_uncompressed_size) {
+        giveUp("CRC mismatch for " + name);
+        return false;
+    }
+
+    QFile::setPermissions(path, QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser | QFileDevice::Permission::ExeUser);
+    m_extracted.insert(name, { crc, uncompressed_size });
+    return true;
+}
+
+bool StreamExtractor::writeStored(const QString& path, quint64 size, quint32& crc)
+{
+    QFile file(path);
+    if (!FS::ensureFilePathExists(path) || !file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        giveUp("could not open " + path);
+        return false;
+    }
+
+    crc = crc32(0, nullptr, 0);
+    for (auto remaining = size; remaining > 0;) {
+        auto available = fillSome();
+        if (available <= 0) {
+            giveUp("the archive ended in " + path);
+            return false;
+        }
+
+        auto length = qint64(std::min<quint64>(remaining, quint64(available)));
+        auto data = m_buffer.constData() + m_offset;
+        if (file.write(data, length) != length) {
+            giveUp("could not write " + path);
+            return false;
+        }
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(data), uInt(length));
+        m_offset += int(length);
+        remaining -= length;
+    }
+    return true;
+}
+
+bool StreamExtractor::writeDeflated(const QString& path, quint64& compressed_size, quint64& uncompressed_size, quint32& crc)
+{
+    QFile file(path);
+    if (!FS::ensureFilePathExists(path) || !file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        giveUp("could not open " + path);
+        return false;
+    }
+
+    z_stream stream = {};
+    // negative window bits, since entries are raw deflate streams without any zlib header
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        giveUp("could not initialize zlib");
+        return false;
+    }
+
+    QByteArray output(s_output_chunk, Qt::Uninitialized);
+    crc = crc32(0, nullptr, 0);
+    compressed_size = 0;
+    uncompressed_size = 0;
+
+    for (int result = Z_OK; result != Z_STREAM_END;) {
+        auto available = fillSome();
+        if (available <= 0) {
+            inflateEnd(&stream);
+            giveUp("the archive ended in " + path);
+            return false;
+        }
+
+        auto input = std::min<qint64>(available, UINT_MAX);
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(m_buffer.constData() + m_offset));
+        stream.avail_in = uInt(input);
+
+        // inflate what we have, for as long as it fills the output
+        do {
+            stream.next_out = reinterpret_cast<Bytef*>(output.data());
+            stream.avail_out = uInt(output.size());
+            result = inflate(&stream, Z_NO_FLUSH);
+            if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+                inflateEnd(&stream);
+                giveUp("could not inflate " + path);
+                return false;
+            }
+
+            auto produced = output.size() - qint64(stream.avail_out);
+            if (file.write(output.constData(), produced) != produced) {
+                inflateEnd(&stream);
+                giveUp("could not write " + path);
+                return false;
+            }
+            crc = crc32(crc, reinterpret_cast<const Bytef*>(output.constData()), uInt(produced));
+            uncompressed_size += produced;
+        } while (result == Z_OK && stream.avail_out == 0);
+
+        auto consumed = input - qint64(stream.avail_in);
+        m_offset += int(consumed);
+        compressed_size += consumed;
+    }
+
+    inflateEnd(&stream);
+    return true;
+}
+
+}  // namespace MMCZip
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QByteArray>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+namespace MMCZip {
+
+/* Extracts a zip archive while it's still being downloaded.
+ *
+ * The data is fed in the order it arrives, and a worker on the global thread pool parses the local file
+ * headers, inflating and writing the entries as soon as their data is there. Since local headers can lie
+ * (or describe files that were removed from the central directory since), nothing extracted can be trusted
+ * before validate() checks it against the central directory of the complete archive.
+ *
+ * Archives that can't be read from the start to the end (stored entries of unknown size, encryption, ...)
+ * make the extractor give up, in which case the complete archive has to be extracted the usual way.
+ */
+class StreamExtractor {
+   public:
+    explicit StreamExtractor(QString target);
+    ~StreamExtractor();
+
+    /** Throws away everything, to start again from the first byte of the archive. */
+    void reset();
+
+    /** Hands the next bytes of the archive over to the worker. Never blocks. */
+    void feed(const QByteArray& data);
+
+    /** There's nothing more to feed. */
+    void finish();
+
+    /** Stops the worker as soon as possible. */
+    void cancel();
+
+    /**
+     * Waits for the worker to be done, and checks that what it extracted is exactly what the central
+     * directory of the complete archive at `archive` describes.
+     *
+     * \return whether the whole archive is in the target folder
+     */
+    bool validate(const QString& archive);
+
+    QString target() const { return m_target; }
+
+   private:
+    struct Entry {
+        quint32 crc32 = 0;
+        quint64 uncompressed_size = 0;
+    };
+
+    void run();
+    bool extractNext(bool& done);
+    bool fill(qint64 size);
+    qint64 fillSome();
+    bool writeStored(const QString& path, quint64 size, quint32& crc);
+    bool writeDeflated(const QString& path, quint64& compressed_size, quint64& uncompressed_size, quint32& crc);
+    QString targetPath(const QString& name) const;
+    void giveUp(const QString& reason);
+    void stopWorker();
+
+   private:
+    QString m_target;
+
+    // Shared with the worker
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;
+    QByteArray m_pending;
+    bool m_finished = false;
+    bool m_cancelled = false;
+    bool m_given_up = false;
+    bool m_started = false;
+
+    // Only touched by the worker while it runs
+    QByteArray m_buffer;
+    int m_offset = 0;
+    QHash<QString, Entry> m_extracted;
+    bool m_complete = false;
+
+    QFuture<void> m_worker;
+};
+
+}  // namespace MMCZip
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "StringPool.h"
+
+#include "MemoryAccounting.h"
+
+StringPool& StringPool::instance()
+{
+    static StringPool s_instance;
+    return s_instance;
+}
+
+QString StringPool::intern(const QString& string)
+{
+    // not worth a lookup, an empty string has no buffer of its own
+    if (string.isEmpty())
+        return string;
+
+    QMutexLocker locker(&m_lock);
+    auto it = m_strings.constFind(string);
+    if (it != m_strings.constEnd())
+        return *it;
+    m_strings.insert(string);
+    return string;
+}
+
+QStringList StringPool::intern(const QStringList& strings)
+{
+    QStringList interned;
+    interned.reserve(strings.size());
+    for (auto& string : strings)
+        interned.append(intern(string));
+    return interned;
+}
+
+int StringPool::prune()
+{
+    QMutexLocker locker(&m_lock);
+    int pruned = 0;
+    for (auto it = m_strings.begin(); it != m_strings.end();) {
+        // the copy in the set is the only one left
+        if (it->isDetached()) {
+            it = m_strings.erase(it);
+            pruned++;
+        } else {
+            ++it;
+        }
+    }
+    return pruned;
+}
+
+int StringPool::count() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_strings.size();
+}
+
+qint64 StringPool::size() const
+{
+    QMutexLocker locker(&m_lock);
+    qint64 size = 0;
+    for (auto& string : m_strings)
+        size += MemoryAccounting::bytesOf(string);
+    return size;
+}
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+/* Strings that many objects hold the same of, stored once.
+ *
+ * The same mod in a few hundred instances has the same authors, description and URLs in each of them. Qt's strings are
+ * implicitly shared, so handing out the copy kept here in place of equal ones lets them all use one buffer. Any thread
+ * can intern strings. The pool only lets go of the strings nobody else holds anymore when it's pruned.
+ */
+class StringPool {
+   public:
+    static StringPool& instance();
+
+    /** The kept string equal to `string`, which becomes the kept one when there's none yet. */
+    QString intern(const QString& string);
+    QStringList intern(const QStringList& strings);
+
+    /** Lets go of the strings only the pool holds. Returns how many there were. */
+    int prune();
+
+    int count() const;
+    /** What the kept strings take, in bytes. */
+    qint64 size() const;
+
+   private:
+    mutable QMutex m_lock;
+    QSet<QString> m_strings;
+};
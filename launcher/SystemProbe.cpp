@@ -0,0 +1,330 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "SystemProbe.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#if defined(Q_OS_FREEBSD)
+#include <sys/sysctl.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#endif
+
+#include "Json.h"
+
+namespace {
+
+constexpr quint16 s_vendor_intel = 0x8086;
+constexpr quint16 s_vendor_nvidia = 0x10de;
+
+QJsonObject gpuToJson(const SystemProbe::Gpu& gpu)
+{
+    QJsonObject obj;
+    obj.insert("pci", gpu.pci_slot);
+    obj.insert("vendor", gpu.vendor);
+    obj.insert("driver", gpu.driver);
+    obj.insert("boot_vga", gpu.boot_vga);
+    obj.insert("vram", double(gpu.vram));
+    return obj;
+}
+
+SystemProbe::Gpu gpuFromJson(const QJsonObject& obj)
+{
+    SystemProbe::Gpu gpu;
+    gpu.pci_slot = Json::requireString(obj, "pci");
+    gpu.vendor = quint16(Json::requireInteger(obj, "vendor"));
+    gpu.driver = Json::requireString(obj, "driver");
+    gpu.boot_vga = Json::requireBoolean(obj, "boot_vga");
+    gpu.vram = qint64(Json::requireDouble(obj, "vram"));
+    return gpu;
+}
+
+}  // namespace
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+namespace {
+#if defined(Q_OS_LINUX)
+void probeProcCpuinfo(QStringList& log)
+{
+    std::ifstream cpuin("/proc/cpuinfo");
+    for (std::string line; std::getline(cpuin, line);) {
+        if (strncmp(line.c_str(), "model name", 10) == 0) {
+            log << QString::fromStdString(line.substr(13, std::string::npos));
+            break;
+        }
+    }
+}
+
+void runLspci(QStringList& log)
+{
+    // FIXME: fixed size buffers...
+    char buff[512];
+    int gpuline = -1;
+    int cline = 0;
+    FILE* lspci = popen("lspci -k", "r");
+
+    if (!lspci)
+        return;
+
+    while (fgets(buff, 512, lspci) != NULL) {
+        std::string str(buff);
+        if (str.length() < 9)
+            continue;
+        if (str.substr(8, 3) == "VGA") {
+            gpuline = cline;
+            log << QString::fromStdString(str.substr(35, std::string::npos));
+        }
+        if (gpuline > -1 && gpuline != cline) {
+            if (cline - gpuline < 3) {
+                log << QString::fromStdString(str.substr(1, std::string::npos));
+            }
+        }
+        cline++;
+    }
+    pclose(lspci);
+}
+#elif defined(Q_OS_FREEBSD)
+void runSysctlHwModel(QStringList& log)
+{
+    char buff[512];
+    FILE* hwmodel = popen("sysctl hw.model", "r");
+    if (!hwmodel)
+        return;
+
+    while (fgets(buff, 512, hwmodel) != NULL) {
+        log << QString::fromUtf8(buff);
+        break;
+    }
+    pclose(hwmodel);
+}
+
+void runPciconf(QStringList& log)
+{
+    char buff[512];
+    std::string strcard;
+    FILE* pciconf = popen("pciconf -lv -a vgapci0", "r");
+    if (!pciconf)
+        return;
+
+    while (fgets(buff, 512, pciconf) != NULL) {
+        if (strncmp(buff, "    vendor", 10) == 0) {
+            std::string str(buff);
+            strcard.append(str.substr(str.find_first_of("'") + 1, str.find_last_not_of("'") - (str.find_first_of("'") + 2)));
+            strcard.append(" ");
+        } else if (strncmp(buff, "    device", 10) == 0) {
+            std::string str2(buff);
+            strcard.append(str2.substr(str2.find_first_of("'") + 1, str2.find_last_not_of("'") - (str2.find_first_of("'") + 2)));
+        }
+        log << QString::fromStdString(strcard);
+        break;
+    }
+    pclose(pciconf);
+}
+#endif
+void runGlxinfo(QStringList& log)
+{
+    // FIXME: fixed size buffers...
+    char buff[512];
+    FILE* glxinfo = popen("glxinfo", "r");
+    if (!glxinfo)
+        return;
+
+    while (fgets(buff, 512, glxinfo) != NULL) {
+        if (strncmp(buff, "OpenGL version string:", 22) == 0) {
+            log << QString::fromUtf8(buff);
+            break;
+        }
+    }
+    pclose(glxinfo);
+}
+
+}  // namespace
+#endif
+
+SystemProbe::SystemProbe(QString cache_path, QObject* parent) : QObject(parent), m_cache_path(cache_path) {}
+
+void SystemProbe::gather(bool refresh)
+{
+    if (m_gathering) {
+        // what's being gathered may come from the cache
+        m_refresh_queued |= refresh;
+        return;
+    }
+    m_gathering = true;
+    if (refresh)
+        m_ready = false;
+
+    auto cache_path = m_cache_path;
+    auto future = QtConcurrent::run(QThreadPool::globalInstance(), [cache_path, refresh]() -> Info {
+        auto boot_id = bootId();
+        if (!refresh && !boot_id.isEmpty() && QFileInfo::exists(cache_path)) {
+            try {
+                auto root = Json::requireObject(Json::requireDocument(cache_path, "System info cache"), "System info cache");
+                if (Json::requireString(root, "boot") == boot_id) {
+                    Info info;
+                    for (auto line : Json::requireArray(root, "lines"))
+                        info.lines << Json::requireString(line);
+                    // caches from before the GPUs were in them have to be probed again
+                    for (auto gpu : Json::requireArray(root, "gpus"))
+                        info.gpus << gpuFromJson(Json::requireObject(gpu));
+                    return info;
+                }
+            } catch (const Exception& e) {
+                qWarning() << "Couldn't load the system info cache:" << e.cause();
+            }
+        }
+
+        Info info{ probe(), probeGpus() };
+        if (!boot_id.isEmpty()) {
+            QJsonObject root;
+            root.insert("boot", boot_id);
+            root.insert("lines", QJsonArray::fromStringList(info.lines));
+            QJsonArray gpus;
+            for (auto& gpu : info.gpus)
+                gpus.append(gpuToJson(gpu));
+            root.insert("gpus", gpus);
+            try {
+                Json::write(root, cache_path);
+            } catch (const Exception& e) {
+                qWarning() << "Couldn't save the system info cache:" << e.cause();
+            }
+        }
+        return info;
+    });
+
+    auto watcher = new QFutureWatcher<Info>(this);
+    connect(watcher, &QFutureWatcher<Info>::finished, this, [this, watcher] {
+        auto info = watcher->result();
+        m_lines = info.lines;
+        m_gpus = info.gpus;
+        watcher->deleteLater();
+        m_gathering = false;
+
+        if (m_refresh_queued) {
+            m_refresh_queued = false;
+            gather(true);
+            return;
+        }
+        m_ready = true;
+        emit gathered(m_lines);
+    });
+    watcher->setFuture(future);
+}
+
+void SystemProbe::whenReady(QObject* context, std::function<void(QStringList)> callback)
+{
+    if (m_ready) {
+        callback(m_lines);
+        return;
+    }
+
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    *connection = connect(this, &SystemProbe::gathered, context, [connection, callback](QStringList lines) {
+        QObject::disconnect(*connection);
+        callback(lines);
+    });
+    gather();
+}
+
+QList<SystemProbe::Gpu> SystemProbe::gpus() const
+{
+    if (m_ready)
+        return m_gpus;
+    return probeGpus();
+}
+
+std::optional<SystemProbe::Gpu> SystemProbe::discreteGpu(const QList<Gpu>& gpus)
+{
+    auto boot = std::find_if(gpus.cbegin(), gpus.cend(), [](const Gpu& gpu) { return gpu.boot_vga; });
+    // a desktop booting with its NVIDIA card: the other GPU can only be the integrated one
+    if (boot == gpus.cend() || boot->vendor == s_vendor_nvidia)
+        return {};
+
+    for (auto& gpu : gpus) {
+        if (gpu.boot_vga || gpu.vendor == s_vendor_intel)
+            continue;
+        // Intel only makes integrated GPUs (as far as laptops go). With an AMD APU, the other GPU is the
+        // discrete one if it has more memory of its own.
+        if (boot->vendor == s_vendor_intel || gpu.vendor == s_vendor_nvidia || gpu.vram > boot->vram)
+            return gpu;
+    }
+    return {};
+}
+
+QString SystemProbe::bootId()
+{
+#if defined(Q_OS_LINUX)
+    QFile file("/proc/sys/kernel/random/boot_id");
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return QString::fromLatin1(file.readAll()).trimmed();
+#elif defined(Q_OS_FREEBSD)
+    struct timeval boottime;
+    size_t size = sizeof(boottime);
+    if (sysctlbyname("kern.boottime", &boottime, &size, nullptr, 0) != 0)
+        return {};
+    return QString::number(static_cast<qint64>(boottime.tv_sec));
+#else
+    return {};
+#endif
+}
+
+QStringList SystemProbe::probe()
+{
+    QStringList log;
+#if defined(Q_OS_LINUX)
+    ::probeProcCpuinfo(log);
+    ::runLspci(log);
+    ::runGlxinfo(log);
+#elif defined(Q_OS_FREEBSD)
+    ::runSysctlHwModel(log);
+    ::runPciconf(log);
+    ::runGlxinfo(log);
+#endif
+    return log;
+}
+
+QList<SystemProbe::Gpu> SystemProbe::probeGpus()
+{
+    QList<Gpu> gpus;
+#if defined(Q_OS_LINUX)
+    auto readFile = [](const QString& path) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return QString();
+        return QString::fromLatin1(file.readAll()).trimmed();
+    };
+
+    QDir drm("/sys/class/drm");
+    for (auto& card : drm.entryList({ "card*" }, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::System)) {
+        // the connectors, like card0-HDMI-A-1
+        if (card.contains('-'))
+            continue;
+        QDir device(drm.filePath(card + "/device"));
+        bool ok = false;
+        Gpu gpu;
+        gpu.vendor = readFile(device.filePath("vendor")).toUShort(&ok, 0);
+        if (!ok)
+            continue;
+        gpu.pci_slot = QFileInfo(device.absolutePath()).canonicalFilePath().section('/', -1);
+        gpu.driver = QFileInfo(QFileInfo(device.filePath("driver")).canonicalFilePath()).fileName();
+        gpu.boot_vga = readFile(device.filePath("boot_vga")) == "1";
+        gpu.vram = readFile(device.filePath("mem_info_vram_total")).toLongLong();
+        gpus << gpu;
+    }
+#endif
+    return gpus;
+}
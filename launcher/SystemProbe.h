@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <functional>
+#include <optional>
+
+/* The hardware description printed at the top of every launch log (the CPU, the GPUs and their drivers, the
+ * OpenGL version), and the GPUs the game can be told to run on.
+ *
+ * Getting it means running lspci and glxinfo, and glxinfo alone can take a good part of a second since it
+ * creates a GL context. None of that changes until the next reboot, so it's gathered once on the global
+ * thread pool when the launcher starts, and kept in a file along with the ID of the boot it's for.
+ */
+class SystemProbe : public QObject {
+    Q_OBJECT
+   public:
+    struct Gpu {
+        // like "0000:01:00.0"
+        QString pci_slot;
+        quint16 vendor = 0;
+        QString driver;
+        // the GPU the firmware set up, the integrated one on hybrid laptops
+        bool boot_vga = false;
+        // in bytes, 0 when the driver doesn't tell
+        qint64 vram = 0;
+    };
+
+    explicit SystemProbe(QString cache_path, QObject* parent = nullptr);
+
+    /** Starts gathering the description, from the cache if it's for this boot unless `refresh` is set. */
+    void gather(bool refresh = false);
+
+    /** Calls `callback` with the description once it's there, right away if it already is. */
+    void whenReady(QObject* context, std::function<void(QStringList)> callback);
+
+    /** The GPUs, as gathered, or listed right away if they weren't yet (that only reads a few files from sysfs). */
+    QList<Gpu> gpus() const;
+    /** The discrete GPU of a hybrid setup, if `gpus` is one: a GPU other than the one the system booted with, and bigger. */
+    static std::optional<Gpu> discreteGpu(const QList<Gpu>& gpus);
+
+   signals:
+    void gathered(QStringList lines);
+
+   private:
+    struct Info {
+        QStringList lines;
+        QList<Gpu> gpus;
+    };
+
+    static QString bootId();
+    static QStringList probe();
+    static QList<Gpu> probeGpus();
+
+   private:
+    QString m_cache_path;
+    QStringList m_lines;
+    QList<Gpu> m_gpus;
+    bool m_ready = false;
+    bool m_gathering = false;
+    bool m_refresh_queued = false;
+};
@@ -5,54 +5,86 @@
 #include <QRegularExpressionMatch>
 #include <QUrl>
 
+#include <limits>
+
 Version::Version(QString str) : m_string(std::move(str))
 {
     parse();
 }
 
-#define VERSION_OPERATOR(return_on_different)                                               \
-    bool exclude_our_sections = false;                                                      \
-    bool exclude_their_sections = false;                                                    \
-                                                                                            \
-    const auto size = qMax(m_sections.size(), other.m_sections.size());                     \
-    for (int i = 0; i < size; ++i) {                                                        \
-        Section sec1 = (i >= m_sections.size()) ? Section() : m_sections.at(i);             \
-        Section sec2 = (i >= other.m_sections.size()) ? Section() : other.m_sections.at(i); \
-                                                                                            \
-        { /* Don't include appendixes in the comparison */                                  \
-            if (sec1.isAppendix())                                                          \
-                exclude_our_sections = true;                                                \
-            if (sec2.isAppendix())                                                          \
-                exclude_their_sections = true;                                              \
-                                                                                            \
-            if (exclude_our_sections) {                                                     \
-                sec1 = Section();                                                           \
-                if (sec2.m_isNull)                                                          \
-                    break;                                                                  \
-            }                                                                               \
-                                                                                            \
-            if (exclude_their_sections) {                                                   \
-                sec2 = Section();                                                           \
-                if (sec1.m_isNull)                                                          \
-                    break;                                                                  \
-            }                                                                               \
-        }                                                                                   \
-                                                                                            \
-        if (sec1 != sec2)                                                                   \
-            return return_on_different;                                                     \
+bool Version::sectionEquals(const Section* ours, const Version& other, const Section* theirs) const
+{
+    if (!ours || !theirs)
+        return !ours && !theirs;
+    if (ours->digits != theirs->digits)
+        return false;
+    if (ours->digits)
+        return ours->number == theirs->number;
+    return text(*ours) == other.text(*theirs);
+}
+
+bool Version::sectionLess(const Section* ours, const Version& other, const Section* theirs) const
+{
+    // a missing section is higher than a zero or a pre-release, and lower than anything else
+    auto unequal_is_less = [](const Section& section) { return section.digits ? section.number == 0 : section.pre_release; };
+
+    if (!theirs)
+        return ours && unequal_is_less(*ours);
+    if (!ours)
+        return !unequal_is_less(*theirs);
+
+    // numbers are lower than text, unless they are 0
+    if (ours->digits && theirs->digits)
+        return ours->number < theirs->number;
+    if (ours->digits)
+        return true;
+    if (theirs->digits)
+        return theirs->number > 0;
+    return text(*ours) < other.text(*theirs);
+}
+
+int Version::compare(const Version& other) const
+{
+    bool exclude_our_sections = false;
+    bool exclude_their_sections = false;
+
+    const auto size = qMax(m_sections.size(), other.m_sections.size());
+    for (int i = 0; i < size; ++i) {
+        const Section* ours = i < m_sections.size() ? &m_sections[i] : nullptr;
+        const Section* theirs = i < other.m_sections.size() ? &other.m_sections[i] : nullptr;
+
+        { /* Don't include appendixes in the comparison */
+            if (ours && ours->appendix)
+                exclude_our_sections = true;
+            if (theirs && theirs->appendix)
+                exclude_their_sections = true;
+
+            if (exclude_our_sections) {
+                ours = nullptr;
+                if (!theirs)
+                    break;
+            }
+
+            if (exclude_their_sections) {
+                theirs = nullptr;
+                if (!ours)
+                    break;
+            }
+        }
+
+        if (!sectionEquals(ours, other, theirs))
+            return sectionLess(ours, other, theirs) ? -1 : 1;
     }
+    return 0;
+}
 
 bool Version::operator<(const Version& other) const
 {
-    VERSION_OPERATOR(sec1 < sec2)
-
-    return false;
+    return compare(other) < 0;
 }
 bool Version::operator==(const Version& other) const
 {
-    VERSION_OPERATOR(false)
-
-    return true;
+    return compare(other) == 0;
 }
 bool Version::operator!=(const Version& other) const
 {
@@ -74,38 +106,45 @@ bool Version::operator>=(const Version& other) const
 void Version::parse()
 {
     m_sections.clear();
-    QString currentSection;
-
-    if (m_string.isEmpty())
-        return;
 
-    auto classChange = [&](QChar lastChar, QChar currentChar) {
-        if (lastChar.isNull())
-            return false;
-        if (lastChar.isDigit() != currentChar.isDigit())
-            return true;
-
-        const QList<QChar> s_separators{ '.', '-', '+' };
-        if (s_separators.contains(currentChar) && currentSection.at(0) != currentChar)
-            return true;
-
-        return false;
+    auto add_section = [this](int start, int end) {
+        Section section;
+        section.start = start;
+        section.length = end - start;
+        section.digits = m_string.at(start).isDigit();
+        if (section.digits) {
+            // like QString::toInt, only ASCII digits count and it's 0 when it doesn't fit
+            qint64 number = 0;
+            for (int i = start; i < end && number <= std::numeric_limits<int>::max(); i++) {
+                auto c = m_string.at(i).unicode();
+                number = c >= '0' && c <= '9' ? number * 10 + (c - '0') : std::numeric_limits<qint64>::max();
+            }
+            section.number = number <= std::numeric_limits<int>::max() ? static_cast<int>(number) : 0;
+        } else {
+            section.appendix = m_string.at(start) == '+';
+            section.pre_release = m_string.at(start) == '-' && section.length > 1;
+        }
+        m_sections.append(section);
     };
 
-    currentSection += m_string.at(0);
+    int start = 0;
     for (int i = 1; i < m_string.size(); ++i) {
-        const auto& current_char = m_string.at(i);
-        if (classChange(m_string.at(i - 1), current_char)) {
-            if (!currentSection.isEmpty())
-                m_sections.append(Section(currentSection));
-            currentSection = "";
+        const auto last_char = m_string.at(i - 1);
+        const auto current_char = m_string.at(i);
+        if (last_char.isNull())
+            continue;
+
+        // a new section starts with every change between digits and the rest, and with every separator that
+        // doesn't just repeat the one the section started with
+        bool is_separator = current_char == '.' || current_char == '-' || current_char == '+';
+        if (last_char.isDigit() != current_char.isDigit() || (is_separator && m_string.at(start) != current_char)) {
+            add_section(start, i);
+            start = i;
         }
-
-        currentSection += current_char;
     }
 
-    if (!currentSection.isEmpty())
-        m_sections.append(Section(currentSection));
+    if (!m_string.isEmpty())
+        add_section(start, m_string.size());
 }
 
 /// qDebug print support for the Version class
@@ -116,9 +155,9 @@ QDebug operator<<(QDebug debug, const Version& v)
     debug.nospace() << "Version{ string: " << v.toString() << ", sections: [ ";
 
     bool first = true;
-    for (auto s : v.m_sections) {
+    for (auto& s : v.m_sections) {
         if (!first) debug.nospace() << ", ";
-        debug.nospace() << s.m_fullString;
+        debug.nospace() << v.text(s);
         first = false;
     }
                     
@@ -37,9 +37,12 @@
 #pragma once
 
 #include <QDebug>
-#include <QList>
 #include <QString>
 #include <QStringView>
+#include <QVector>
+
+#include <algorithm>
+#include <vector>
 
 class QUrl;
 
@@ -57,114 +60,59 @@ class Version {
 
     QString toString() const { return m_string; }
 
+    /** Sorts the items by the versions `version_of` gives for them, from the lowest.
+     *
+     * Every version gets parsed once, instead of once for every comparison. The sort is stable.
+     */
+    template <typename Container, typename VersionOf>
+    static void sort(Container& items, VersionOf version_of, bool descending = false)
+    {
+        std::vector<std::pair<Version, int>> keys;
+        keys.reserve(items.size());
+        for (int i = 0; i < static_cast<int>(items.size()); i++)
+            keys.emplace_back(Version(version_of(items[i])), i);
+
+        // a stable sort, as the comparison doesn't hold up to a strict weak ordering with every odd version string
+        std::stable_sort(keys.begin(), keys.end(), [descending](const auto& left, const auto& right) {
+            return descending ? right.first < left.first : left.first < right.first;
+        });
+
+        Container sorted;
+        sorted.reserve(items.size());
+        for (auto& key : keys)
+            sorted.push_back(std::move(items[key.second]));
+        items = std::move(sorted);
+    }
+
     friend QDebug operator<<(QDebug debug, const Version& v);
 
    private:
+    /* A part of the version string, either all digits or none of them.
+     *
+     * The parts only point into m_string, what the comparisons need from them is worked out when parsing.
+     */
     struct Section {
-        explicit Section(QString fullString) : m_fullString(std::move(fullString))
-        {
-            int cutoff = m_fullString.size();
-            for (int i = 0; i < m_fullString.size(); i++) {
-                if (!m_fullString[i].isDigit()) {
-                    cutoff = i;
-                    break;
-                }
-            }
-
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-            auto numPart = QStringView{m_fullString}.left(cutoff);
-#else
-            auto numPart = m_fullString.leftRef(cutoff);
-#endif
-
-            if (!numPart.isEmpty()) {
-                m_isNull = false;
-                m_numPart = numPart.toInt();
-            }
-
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-            auto stringPart = QStringView{m_fullString}.mid(cutoff);
-#else
-            auto stringPart = m_fullString.midRef(cutoff);
-#endif
-
-            if (!stringPart.isEmpty()) {
-                m_isNull = false;
-                m_stringPart = stringPart.toString();
-            }
-        }
-
-        explicit Section() = default;
-
-        bool m_isNull = true;
-
-        int m_numPart = 0;
-        QString m_stringPart;
-
-        QString m_fullString;
-
-        [[nodiscard]] inline bool isAppendix() const { return m_stringPart.startsWith('+'); }
-        [[nodiscard]] inline bool isPreRelease() const { return m_stringPart.startsWith('-') && m_stringPart.length() > 1; }
-
-        inline bool operator==(const Section& other) const
-        {
-            if (m_isNull && !other.m_isNull)
-                return false;
-            if (!m_isNull && other.m_isNull)
-                return false;
-
-            if (!m_isNull && !other.m_isNull) {
-                return (m_numPart == other.m_numPart) && (m_stringPart == other.m_stringPart);
-            }
-
-            return true;
-        }
-
-        inline bool operator<(const Section& other) const
-        {   
-            static auto unequal_is_less = [](Section const& non_null) -> bool {
-                if (non_null.m_stringPart.isEmpty())
-                    return non_null.m_numPart == 0;
-                return (non_null.m_stringPart != QLatin1Char('.')) && non_null.isPreRelease();
-            };
-
-            if (!m_isNull && other.m_isNull)
-                return unequal_is_less(*this);
-            if (m_isNull && !other.m_isNull)
-                return !unequal_is_less(other);
-
-            if (!m_isNull && !other.m_isNull) {
-                if (m_numPart < other.m_numPart)
-                    return true;
-                if (m_numPart == other.m_numPart && m_stringPart < other.m_stringPart)
-                    return true;
-
-                if (!m_stringPart.isEmpty() && other.m_stringPart.isEmpty())
-                    return false;
-                if (m_stringPart.isEmpty() && !other.m_stringPart.isEmpty())
-                    return true;
-
-                return false;
-            }
-
-            return m_fullString < other.m_fullString;
-        }
-
-        inline bool operator!=(const Section& other) const
-        {
-            return !(*this == other);
-        }
-        inline bool operator>(const Section &other) const
-        {
-            return !(*this < other || *this == other);
-        }
+        int start = 0;
+        int length = 0;
+        // the value of the digits, 0 for the other parts or when it doesn't fit
+        int number = 0;
+        bool digits = false;
+        // starts with '+', like build metadata, it and anything after it is left out of the comparisons
+        bool appendix = false;
+        // starts with '-' and has more to it, like "-pre1"
+        bool pre_release = false;
     };
 
+    QStringView text(const Section& section) const { return QStringView(m_string).mid(section.start, section.length); }
+
+    // the sections of both compared one by one, -1 when this one is lower, 1 when it's different but not lower
+    int compare(const Version& other) const;
+    bool sectionEquals(const Section* ours, const Version& other, const Section* theirs) const;
+    bool sectionLess(const Section* ours, const Version& other, const Section* theirs) const;
+
    private:
     QString m_string;
-    QList<Section> m_sections;
+    QVector<Section> m_sections;
 
     void parse();
 };
-
-
@@ -35,15 +35,32 @@
 
 #include "VersionProxyModel.h"
 #include "Application.h"
+#include <QBitArray>
 #include <QSortFilterProxyModel>
 #include <QPixmapCache>
+#include <QVector>
 #include <Version.h>
 #include <meta/VersionList.h>
 
+/* Filters and sorts the versions, with the values it needs from every row read once and kept.
+ *
+ * Whether a row was let through is kept as well, so when a filter only gets more specific just the rows it let
+ * through are checked again, against that filter alone. When it gets less specific, only the rows it left out are.
+ */
 class VersionFilterModel : public QSortFilterProxyModel
 {
     Q_OBJECT
 public:
+    // how the filters changed since the rows were filtered last
+    enum class Change
+    {
+        Any,
+        // the filter of one role lets through less than before, or there is a new one
+        Narrowed,
+        // the filter of one role lets through more than before, or filters were removed
+        Widened
+    };
+
     VersionFilterModel(VersionProxyModel *parent) : QSortFilterProxyModel(parent)
     {
         m_parent = parent;
@@ -51,28 +68,239 @@ public:
         sort(0, Qt::DescendingOrder);
     }
 
-    bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
+    void setSourceModel(QAbstractItemModel *model) override
+    {
+        for (auto &connection : m_sourceConnections)
+            disconnect(connection);
+        m_sourceConnections.clear();
+        clearCache();
+
+        // connected before the sort filter model connects itself, so the cached values are up to date by the time it
+        // filters and sorts the changed rows
+        if (model)
+        {
+            m_sourceConnections << connect(model, &QAbstractItemModel::rowsInserted, this,
+                                           [this](const QModelIndex &, int first, int last) { insertRows(first, last); });
+            m_sourceConnections << connect(model, &QAbstractItemModel::rowsRemoved, this,
+                                           [this](const QModelIndex &, int first, int last) { removeRows(first, last); });
+            m_sourceConnections << connect(model, &QAbstractItemModel::dataChanged, this,
+                                           [this](const QModelIndex &top_left, const QModelIndex &bottom_right) {
+                                               refreshRows(top_left.row(), bottom_right.row());
+                                           });
+            m_sourceConnections << connect(model, &QAbstractItemModel::modelAboutToBeReset, this, &VersionFilterModel::clearCache);
+            m_sourceConnections << connect(model, &QAbstractItemModel::modelReset, this, &VersionFilterModel::clearCache);
+            m_sourceConnections << connect(model, &QAbstractItemModel::layoutChanged, this, &VersionFilterModel::clearCache);
+            m_sourceConnections << connect(model, &QAbstractItemModel::rowsMoved, this, &VersionFilterModel::clearCache);
+        }
+        QSortFilterProxyModel::setSourceModel(model);
+    }
+
+    bool filterAcceptsRow(int source_row, const QModelIndex &) const override
     {
         const auto &filters = m_parent->filters();
+        auto rows = sourceModel()->rowCount();
+        if (m_accepted.size() != rows)
+            m_accepted.fill(Unknown, rows);
+
+        auto &state = m_accepted[source_row];
+        if (state != Unknown)
+        {
+            if (m_change == Change::Narrowed)
+            {
+                if (state == Rejected)
+                    return false;
+                // the other filters let it through already
+                auto filter = filters.value(static_cast<BaseVersionList::ModelRoles>(m_changedRole));
+                if (filter && !accepts(filter.get(), source_row, m_changedRole))
+                    state = Rejected;
+                return state == Accepted;
+            }
+            if (m_change == Change::Widened && state == Accepted)
+                return true;
+        }
+
+        state = Accepted;
         for (auto it = filters.begin(); it != filters.end(); ++it)
         {
-            auto idx = sourceModel()->index(source_row, 0, source_parent);
-            auto data = sourceModel()->data(idx, it.key());
-            auto match = data.toString();
-            if(!it.value()->accepts(match))
+            if (!accepts(it.value().get(), source_row, it.key()))
             {
-                return false;
+                state = Rejected;
+                break;
             }
         }
-        return true;
+        return state == Accepted;
     }
 
-    void filterChanged()
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override
     {
+        if (hasSortKeys())
+            return m_sortKeys[left.row()] < m_sortKeys[right.row()];
+        return QSortFilterProxyModel::lessThan(left, right);
+    }
+
+    void filterChanged(Change change = Change::Any, int role = 0)
+    {
+        m_change = change;
+        m_changedRole = role;
         invalidateFilter();
+        m_change = Change::Any;
+    }
+
+private:
+    enum State : qint8
+    {
+        Unknown,
+        Rejected,
+        Accepted
+    };
+
+    bool accepts(Filter *filter, int row, int role) const
+    {
+        // the metadata lists know which of their rows go with a version of Minecraft, the others don't have to be looked at
+        auto list = qobject_cast<Meta::VersionList *>(sourceModel());
+        auto exact = dynamic_cast<ExactFilter *>(filter);
+        if (!list || !exact || role != BaseVersionList::ParentVersionRole)
+            return filter->accepts(value(row, role));
+
+        auto rows = sourceModel()->rowCount();
+        if (m_indexedRows.size() != rows || m_indexedParent != exact->value() || !m_hasIndexedRows)
+        {
+            m_indexedRows.fill(false, rows);
+            for (auto indexed : list->rowsRequiring(exact->value()))
+                m_indexedRows.setBit(indexed);
+            m_indexedParent = exact->value();
+            m_hasIndexedRows = true;
+        }
+        return m_indexedRows.testBit(row);
+    }
+
+    QString fetchValue(int row, int role) const
+    {
+        return sourceModel()->data(sourceModel()->index(row, 0), role).toString();
+    }
+
+    const QString &value(int row, int role) const
+    {
+        auto rows = sourceModel()->rowCount();
+        auto &column = m_values[role];
+        if (column.size() != rows)
+        {
+            column.resize(rows);
+            for (int i = 0; i < rows; i++)
+                column[i] = fetchValue(i, role);
+        }
+        return column[row];
     }
+
+    // the sort role has a number for every row, the time of the metadata versions, so it can be compared without QVariant
+    bool fetchSortKey(int row, qint64 *key) const
+    {
+        auto data = sourceModel()->data(sourceModel()->index(row, 0), sortRole());
+        switch (data.userType())
+        {
+            case QMetaType::LongLong:
+            case QMetaType::Int:
+            case QMetaType::UInt:
+                *key = data.toLongLong();
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool hasSortKeys() const
+    {
+        auto rows = sourceModel()->rowCount();
+        if (m_sortKeysChecked && m_sortKeys.size() == rows)
+            return m_hasSortKeys;
+
+        m_sortKeysChecked = true;
+        m_hasSortKeys = true;
+        m_sortKeys.resize(rows);
+        for (int i = 0; i < rows && m_hasSortKeys; i++)
+            m_hasSortKeys = fetchSortKey(i, &m_sortKeys[i]);
+        if (!m_hasSortKeys)
+            m_sortKeys.clear();
+        return m_hasSortKeys;
+    }
+
+    void insertRows(int first, int last)
+    {
+        auto count = last - first + 1;
+        auto previousRows = sourceModel()->rowCount() - count;
+        for (auto it = m_values.begin(); it != m_values.end(); ++it)
+        {
+            // a column that's out of date gets read again when it's needed
+            if (it->size() != previousRows)
+                continue;
+            it->insert(first, count, QString());
+            for (int row = first; row <= last; row++)
+                (*it)[row] = fetchValue(row, it.key());
+        }
+        if (m_accepted.size() == previousRows)
+            m_accepted.insert(first, count, Unknown);
+        m_sortKeysChecked = false;
+        m_hasIndexedRows = false;
+    }
+
+    void removeRows(int first, int last)
+    {
+        auto count = last - first + 1;
+        for (auto it = m_values.begin(); it != m_values.end(); ++it)
+        {
+            if (it->size() >= first + count)
+                it->remove(first, count);
+        }
+        if (m_accepted.size() >= first + count)
+            m_accepted.remove(first, count);
+        if (m_hasSortKeys && m_sortKeys.size() >= first + count)
+            m_sortKeys.remove(first, count);
+        m_hasIndexedRows = false;
+    }
+
+    void refreshRows(int first, int last)
+    {
+        for (auto it = m_values.begin(); it != m_values.end(); ++it)
+        {
+            for (int row = first; row <= last && row < it->size(); row++)
+                (*it)[row] = fetchValue(row, it.key());
+        }
+        for (int row = first; row <= last && row < m_accepted.size(); row++)
+            m_accepted[row] = Unknown;
+        m_hasIndexedRows = false;
+        for (int row = first; m_hasSortKeys && row <= last && row < m_sortKeys.size(); row++)
+        {
+            if (!fetchSortKey(row, &m_sortKeys[row]))
+                m_sortKeysChecked = false;
+        }
+    }
+
+    void clearCache()
+    {
+        m_hasIndexedRows = false;
+        m_values.clear();
+        m_accepted.clear();
+        m_sortKeys.clear();
+        m_sortKeysChecked = false;
+    }
+
 private:
     VersionProxyModel *m_parent;
+    QList<QMetaObject::Connection> m_sourceConnections;
+
+    // the value of every row for each role there is a filter on, as the filters get them
+    mutable QHash<int, QVector<QString>> m_values;
+    mutable QVector<State> m_accepted;
+    mutable QVector<qint64> m_sortKeys;
+    mutable bool m_sortKeysChecked = false;
+    mutable bool m_hasSortKeys = false;
+    // the rows the list says go with the version of Minecraft filtered on
+    mutable QBitArray m_indexedRows;
+    mutable QString m_indexedParent;
+    mutable bool m_hasIndexedRows = false;
+
+    Change m_change = Change::Any;
+    int m_changedRole = 0;
 };
 
 VersionProxyModel::VersionProxyModel(QObject *parent) : QAbstractProxyModel(parent)
@@ -431,13 +659,20 @@ QModelIndex VersionProxyModel::getVersion(const QString& version) const
 void VersionProxyModel::clearFilters()
 {
     m_filters.clear();
-    filterModel->filterChanged();
+    filterModel->filterChanged(VersionFilterModel::Change::Widened);
 }
 
 void VersionProxyModel::setFilter(const BaseVersionList::ModelRoles column, Filter * f)
 {
+    auto change = VersionFilterModel::Change::Any;
+    auto previous = m_filters.value(column);
+    if(!previous || f->narrows(previous.get()))
+        change = VersionFilterModel::Change::Narrowed;
+    else if(previous->narrows(f))
+        change = VersionFilterModel::Change::Widened;
+
     m_filters[column].reset(f);
-    filterModel->filterChanged();
+    filterModel->filterChanged(change, column);
 }
 
 const VersionProxyModel::FilterMap &VersionProxyModel::filters() const
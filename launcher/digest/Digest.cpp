@@ -0,0 +1,254 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Digest.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace {
+
+constexpr uint32_t s_sha1_init[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+constexpr uint32_t s_sha224_init[8] = { 0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4 };
+constexpr uint32_t s_sha256_init[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+constexpr uint64_t s_sha384_init[8] = { 0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
+                                        0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4 };
+constexpr uint64_t s_sha512_init[8] = { 0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+                                        0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179 };
+
+// big enough for the overhead of reading to not matter, small enough to stay in the cache
+constexpr qint64 s_read_size = 64 * 1024;
+
+enum class Family { Sha1, Sha256, Sha512, Other };
+
+Family familyOf(QCryptographicHash::Algorithm algorithm)
+{
+    switch (algorithm) {
+        case QCryptographicHash::Sha1:
+            return Family::Sha1;
+        case QCryptographicHash::Sha224:
+        case QCryptographicHash::Sha256:
+            return Family::Sha256;
+        case QCryptographicHash::Sha384:
+        case QCryptographicHash::Sha512:
+            return Family::Sha512;
+        default:
+            return Family::Other;
+    }
+}
+
+bool implements(const Sha::Engine& engine, Family family)
+{
+    switch (family) {
+        case Family::Sha1:
+            return engine.sha1 != nullptr;
+        case Family::Sha256:
+            return engine.sha256 != nullptr;
+        case Family::Sha512:
+            return engine.sha512 != nullptr;
+        default:
+            return false;
+    }
+}
+
+/** What this CPU can run, the fastest first. */
+const QList<const Sha::Engine*>& engines()
+{
+    static const QList<const Sha::Engine*> s_engines = [] {
+        QList<const Sha::Engine*> found;
+        QStringList names;
+        for (auto engine : { Sha::armEngine(), Sha::x86Engine(), &Sha::genericEngine() }) {
+            if (engine) {
+                found.append(engine);
+                names.append(engine->name);
+            }
+        }
+        qDebug() << "SHA implementations:" << names;
+        return found;
+    }();
+    return s_engines;
+}
+
+void storeBigEndian(char* out, uint64_t value, int bytes)
+{
+    for (int i = bytes - 1; i >= 0; i--, value >>= 8)
+        out[i] = static_cast<char>(value & 0xff);
+}
+
+}  // namespace
+
+Digest::Digest(QCryptographicHash::Algorithm algorithm) : Digest(algorithm, QString()) {}
+
+Digest::Digest(QCryptographicHash::Algorithm algorithm, const QString& implementation) : m_algorithm(algorithm)
+{
+    auto family = familyOf(algorithm);
+    if (family == Family::Other) {
+        m_qt = std::make_unique<QCryptographicHash>(algorithm);
+        return;
+    }
+
+    const Sha::Engine* chosen = nullptr;
+    for (auto engine : engines()) {
+        if (!implements(*engine, family) || (!implementation.isEmpty() && implementation != engine->name))
+            continue;
+        chosen = engine;
+        break;
+    }
+    if (!chosen) {
+        qWarning() << "No SHA implementation named" << implementation << "for this CPU, using the portable one";
+        chosen = &Sha::genericEngine();
+    }
+
+    if (family == Family::Sha1)
+        m_block32 = chosen->sha1;
+    else if (family == Family::Sha256)
+        m_block32 = chosen->sha256;
+    else
+        m_block64 = chosen->sha512;
+    reset();
+}
+
+Digest::~Digest() = default;
+
+void Digest::reset()
+{
+    m_buffered = 0;
+    m_length = 0;
+    m_result.clear();
+
+    switch (m_algorithm) {
+        case QCryptographicHash::Sha1:
+            std::copy(std::begin(s_sha1_init), std::end(s_sha1_init), m_state32);
+            break;
+        case QCryptographicHash::Sha224:
+            std::copy(std::begin(s_sha224_init), std::end(s_sha224_init), m_state32);
+            break;
+        case QCryptographicHash::Sha256:
+            std::copy(std::begin(s_sha256_init), std::end(s_sha256_init), m_state32);
+            break;
+        case QCryptographicHash::Sha384:
+            std::copy(std::begin(s_sha384_init), std::end(s_sha384_init), m_state64);
+            break;
+        case QCryptographicHash::Sha512:
+            std::copy(std::begin(s_sha512_init), std::end(s_sha512_init), m_state64);
+            break;
+        default:
+            m_qt->reset();
+            break;
+    }
+}
+
+void Digest::addData(const char* data, qsizetype length)
+{
+    if (m_qt) {
+        m_qt->addData(data, length);
+        return;
+    }
+    if (!m_result.isEmpty() || length <= 0)
+        return;
+    m_length += length;
+    process(reinterpret_cast<const unsigned char*>(data), static_cast<size_t>(length));
+}
+
+bool Digest::addData(QIODevice* device)
+{
+    if (m_qt)
+        return m_qt->addData(device);
+
+    QByteArray buffer(s_read_size, Qt::Uninitialized);
+    while (!device->atEnd()) {
+        auto read = device->read(buffer.data(), buffer.size());
+        if (read <= 0)
+            return false;
+        addData(buffer.constData(), read);
+    }
+    return true;
+}
+
+void Digest::process(const unsigned char* data, size_t length)
+{
+    const size_t block = m_block64 ? 128 : 64;
+    auto blocks = [this](const unsigned char* from, size_t count) {
+        if (m_block64)
+            m_block64(m_state64, from, count);
+        else
+            m_block32(m_state32, from, count);
+    };
+
+    if (m_buffered) {
+        auto taken = std::min(block - m_buffered, length);
+        std::memcpy(m_buffer + m_buffered, data, taken);
+        m_buffered += taken;
+        data += taken;
+        length -= taken;
+        if (m_buffered < block)
+            return;
+        blocks(m_buffer, 1);
+        m_buffered = 0;
+    }
+
+    // straight from the data, as many blocks at a time as there are
+    if (auto whole = length / block) {
+        blocks(data, whole);
+        data += whole * block;
+        length -= whole * block;
+    }
+
+    std::memcpy(m_buffer, data, length);
+    m_buffered = length;
+}
+
+void Digest::finish()
+{
+    const size_t block = m_block64 ? 128 : 64;
+    const size_t length_size = m_block64 ? 16 : 8;
+    const quint64 bits = m_length * 8;
+
+    // a one bit, zeros, then the length in bits, big-endian, ending a block
+    unsigned char padding[256] = { 0x80 };
+    size_t padded = block - m_buffered;
+    if (padded < length_size + 1)
+        padded += block;
+    storeBigEndian(reinterpret_cast<char*>(padding) + padded - 8, bits, 8);
+    process(padding, padded);
+    Q_ASSERT(m_buffered == 0);
+
+    int size = QCryptographicHash::hashLength(m_algorithm);
+    m_result.resize(size);
+    auto out = m_result.data();
+    if (m_block64) {
+        for (int i = 0; i < size / 8; i++)
+            storeBigEndian(out + 8 * i, m_state64[i], 8);
+    } else {
+        for (int i = 0; i < size / 4; i++)
+            storeBigEndian(out + 4 * i, m_state32[i], 4);
+    }
+}
+
+QByteArray Digest::result()
+{
+    if (m_qt)
+        return m_qt->result();
+    if (m_result.isEmpty())
+        finish();
+    return m_result;
+}
+
+QByteArray Digest::hash(const QByteArray& data, QCryptographicHash::Algorithm algorithm)
+{
+    Digest digest(algorithm);
+    digest.addData(data);
+    return digest.result();
+}
+
+QStringList Digest::implementations(QCryptographicHash::Algorithm algorithm)
+{
+    QStringList names;
+    for (auto engine : engines()) {
+        if (implements(*engine, familyOf(algorithm)))
+            names.append(engine->name);
+    }
+    return names;
+}
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QIODevice>
+#include <QStringList>
+
+#include <memory>
+
+#include "Sha.h"
+
+/* A streaming hash, like QCryptographicHash, hashing the SHA-1 and SHA-2 families with the fastest implementation
+ * the CPU can run.
+ *
+ * How fast QCryptographicHash is depends on the Qt build, and it never uses the SHA instructions of x86 and ARM
+ * CPUs, which make SHA-1 and SHA-256 several times faster. Which implementation to use is decided once, from what
+ * the CPU has. The other algorithms (MD5, SHA-3, ...) are left to QCryptographicHash.
+ */
+class Digest {
+   public:
+    explicit Digest(QCryptographicHash::Algorithm algorithm);
+    /** With the given implementation (see implementations()) instead of the fastest one, for testing them. */
+    Digest(QCryptographicHash::Algorithm algorithm, const QString& implementation);
+    ~Digest();
+
+    Digest(const Digest&) = delete;
+    Digest& operator=(const Digest&) = delete;
+
+    QCryptographicHash::Algorithm algorithm() const { return m_algorithm; }
+
+    void reset();
+    void addData(const char* data, qsizetype length);
+    void addData(const QByteArray& data) { addData(data.constData(), data.size()); }
+    /** Reads the device until its end, returns false if reading it failed. */
+    bool addData(QIODevice* device);
+
+    /** The hash of what was added so far. Adding more afterwards needs a reset() first, like QCryptographicHash. */
+    QByteArray result();
+
+    static QByteArray hash(const QByteArray& data, QCryptographicHash::Algorithm algorithm);
+
+    /** The implementations this CPU can run for the algorithm, the fastest first, none if it's left to Qt. */
+    static QStringList implementations(QCryptographicHash::Algorithm algorithm);
+
+   private:
+    void process(const unsigned char* data, size_t length);
+    void finish();
+
+   private:
+    QCryptographicHash::Algorithm m_algorithm;
+    // either of them for the SHA-1 and SHA-2 families, m_qt for the rest
+    Sha::Block32 m_block32 = nullptr;
+    Sha::Block64 m_block64 = nullptr;
+    std::unique_ptr<QCryptographicHash> m_qt;
+
+    uint32_t m_state32[8];
+    uint64_t m_state64[8];
+    unsigned char m_buffer[128];
+    size_t m_buffered = 0;
+    quint64 m_length = 0;
+    QByteArray m_result;
+};
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* The block functions of SHA-1, SHA-256 and SHA-512, in portable C++ and using the instructions some CPUs have for them.
+ *
+ * They only hash whole blocks (64 bytes, 128 for SHA-512) into the state, the buffering and the padding are up to
+ * Digest. The state is kept as the algorithms define it: a, b, c, d, e, ... in that order.
+ */
+namespace Sha {
+
+using Block32 = void (*)(uint32_t* state, const unsigned char* blocks, size_t count);
+using Block64 = void (*)(uint64_t* state, const unsigned char* blocks, size_t count);
+
+/** The block functions of one implementation, null for the algorithms it doesn't do. */
+struct Engine {
+    const char* name;
+    Block32 sha1;
+    Block32 sha256;
+    Block64 sha512;
+};
+
+/** Portable, for every CPU. */
+const Engine& genericEngine();
+/** With the SHA extensions of x86 CPUs, null if this CPU doesn't have them. */
+const Engine* x86Engine();
+/** With the cryptography extension of ARMv8 CPUs, null if this CPU doesn't have it or it wasn't built in. */
+const Engine* armEngine();
+
+}  // namespace Sha
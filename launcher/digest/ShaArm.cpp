@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Sha.h"
+
+// Built with the cryptography extension enabled (see CMakeLists.txt), so nothing but the block functions lives here:
+// anything else could end up using the instructions on a CPU that doesn't have them.
+#if (defined(__aarch64__) || defined(_M_ARM64)) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#define SHA_ARM
+
+#include <arm_neon.h>
+
+#if defined(__APPLE__)
+// every Apple CPU has it
+#elif defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+#endif
+
+namespace Sha {
+
+#ifdef SHA_ARM
+namespace {
+
+bool hasCryptoExtension()
+{
+#if defined(__APPLE__)
+    return true;
+#elif defined(__linux__)
+    auto hwcap = getauxval(AT_HWCAP);
+    return (hwcap & HWCAP_SHA1) && (hwcap & HWCAP_SHA2);
+#elif defined(_WIN32)
+    return IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE);
+#else
+    return false;
+#endif
+}
+
+const uint32_t s_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be,
+    0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa,
+    0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85,
+    0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f,
+    0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+inline uint32x4_t loadBigEndian(const unsigned char* p)
+{
+    return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p)));
+}
+
+void sha1(uint32_t* state, const unsigned char* blocks, size_t count)
+{
+    const uint32x4_t k[4] = { vdupq_n_u32(0x5a827999), vdupq_n_u32(0x6ed9eba1), vdupq_n_u32(0x8f1bbcdc), vdupq_n_u32(0xca62c1d6) };
+
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32_t e = state[4];
+
+    for (; count; count--, blocks += 64) {
+        uint32x4_t abcd_save = abcd;
+        uint32_t e_save = e;
+
+        uint32x4_t msg[4];
+        for (int i = 0; i < 4; i++)
+            msg[i] = loadBigEndian(blocks + 16 * i);
+
+        // 20 groups of four rounds, msg[g % 4] holds the words of group g
+        for (int g = 0; g < 20; g++) {
+            uint32x4_t words = vaddq_u32(msg[g % 4], k[g / 5]);
+            uint32_t next_e = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+            switch (g / 5) {
+                case 0:
+                    abcd = vsha1cq_u32(abcd, e, words);
+                    break;
+                case 2:
+                    abcd = vsha1mq_u32(abcd, e, words);
+                    break;
+                default:
+                    abcd = vsha1pq_u32(abcd, e, words);
+                    break;
+            }
+            e = next_e;
+
+            if (g < 16)
+                msg[g % 4] = vsha1su1q_u32(vsha1su0q_u32(msg[g % 4], msg[(g + 1) % 4], msg[(g + 2) % 4]), msg[(g + 3) % 4]);
+        }
+
+        abcd = vaddq_u32(abcd, abcd_save);
+        e += e_save;
+    }
+
+    vst1q_u32(state, abcd);
+    state[4] = e;
+}
+
+void sha256(uint32_t* state, const unsigned char* blocks, size_t count)
+{
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32x4_t efgh = vld1q_u32(state + 4);
+
+    for (; count; count--, blocks += 64) {
+        uint32x4_t abcd_save = abcd;
+        uint32x4_t efgh_save = efgh;
+
+        uint32x4_t msg[4];
+        for (int i = 0; i < 4; i++)
+            msg[i] = loadBigEndian(blocks + 16 * i);
+
+        // 16 groups of four rounds, msg[g % 4] holds the words of group g
+        for (int g = 0; g < 16; g++) {
+            uint32x4_t words = vaddq_u32(msg[g % 4], vld1q_u32(s_sha256_k + 4 * g));
+            uint32x4_t abcd_before = abcd;
+            abcd = vsha256hq_u32(abcd, efgh, words);
+            efgh = vsha256h2q_u32(efgh, abcd_before, words);
+
+            if (g < 12)
+                msg[g % 4] = vsha256su1q_u32(vsha256su0q_u32(msg[g % 4], msg[(g + 1) % 4]), msg[(g + 2) % 4], msg[(g + 3) % 4]);
+        }
+
+        abcd = vaddq_u32(abcd, abcd_save);
+        efgh = vaddq_u32(efgh, efgh_save);
+    }
+
+    vst1q_u32(state, abcd);
+    vst1q_u32(state + 4, efgh);
+}
+
+}  // namespace
+#endif
+
+const Engine* armEngine()
+{
+#ifdef SHA_ARM
+    static const Engine s_engine{ "armv8-crypto", sha1, sha256, nullptr };
+    static const bool s_supported = hasCryptoExtension();
+    return s_supported ? &s_engine : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+}  // namespace Sha
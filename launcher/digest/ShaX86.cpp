@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Sha.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SHA_X86
+
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// the intrinsics don't need to be enabled
+#define SHA_TARGET
+#else
+#include <cpuid.h>
+// only these functions get to use the instructions, they are only called once the CPU is known to have them
+#define SHA_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+#endif
+#endif
+
+namespace Sha {
+
+#ifdef SHA_X86
+namespace {
+
+bool hasShaExtensions()
+{
+    // SSSE3 and SSE4.1 in leaf 1, SHA in leaf 7
+    unsigned leaf1_ecx = 0, leaf7_ebx = 0;
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    leaf1_ecx = info[2];
+    __cpuidex(info, 7, 0);
+    leaf7_ebx = info[1];
+#else
+    unsigned eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, nullptr) < 7)
+        return false;
+    __cpuid(1, eax, ebx, ecx, edx);
+    leaf1_ecx = ecx;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    leaf7_ebx = ebx;
+#endif
+    bool ssse3 = leaf1_ecx & (1u << 9);
+    bool sse41 = leaf1_ecx & (1u << 19);
+    bool sha = leaf7_ebx & (1u << 29);
+    return ssse3 && sse41 && sha;
+}
+
+alignas(16) constexpr uint32_t s_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be,
+    0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa,
+    0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85,
+    0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f,
+    0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/* Four rounds of SHA-1, the message words of the next groups being worked out meanwhile.
+ *
+ * msg[g % 4] holds the words of group G. The round function is an immediate, which is why the groups are
+ * templates, unrolled at compile time.
+ */
+template <int G>
+SHA_TARGET inline void sha1Group(__m128i& abcd, __m128i& e0, __m128i& e1, __m128i* msg)
+{
+    constexpr int cur = G % 4;
+    if constexpr (G == 0)
+        e0 = _mm_add_epi32(e0, msg[cur]);
+    else
+        e0 = _mm_sha1nexte_epu32(e0, msg[cur]);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, G / 5);
+
+    if constexpr (G >= 3 && G <= 18)
+        msg[(G + 1) % 4] = _mm_sha1msg2_epu32(msg[(G + 1) % 4], msg[cur]);
+    if constexpr (G >= 2 && G <= 17)
+        msg[(G + 2) % 4] = _mm_xor_si128(msg[(G + 2) % 4], msg[cur]);
+    if constexpr (G >= 1 && G <= 16)
+        msg[(G + 3) % 4] = _mm_sha1msg1_epu32(msg[(G + 3) % 4], msg[cur]);
+
+    // the registers of E swap roles from one group to the next
+    if constexpr (G < 19)
+        sha1Group<G + 1>(abcd, e1, e0, msg);
+}
+
+SHA_TARGET void sha1(uint32_t* state, const unsigned char* blocks, size_t count)
+{
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1b);
+    __m128i e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+
+    for (; count; count--, blocks += 64) {
+        __m128i abcd_save = abcd;
+        __m128i e0_save = e0;
+
+        __m128i msg[4];
+        for (int i = 0; i < 4; i++)
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16 * i)), mask);
+
+        // after the last group, e0 holds a, b, c and d as they were before it
+        __m128i e1;
+        sha1Group<0>(abcd, e0, e1, msg);
+
+        e0 = _mm_sha1nexte_epu32(e0, e0_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+}
+
+/* Four rounds of SHA-256, two at a time, the message words of the next groups being worked out meanwhile. */
+template <int G>
+SHA_TARGET inline void sha256Group(__m128i& state0, __m128i& state1, __m128i* msg)
+{
+    constexpr int cur = G % 4;
+    __m128i words = _mm_add_epi32(msg[cur], _mm_load_si128(reinterpret_cast<const __m128i*>(s_sha256_k + 4 * G)));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, words);
+    if constexpr (G >= 3 && G <= 14) {
+        __m128i& next = msg[(G + 1) % 4];
+        next = _mm_add_epi32(next, _mm_alignr_epi8(msg[cur], msg[(G + 3) % 4], 4));
+        next = _mm_sha256msg2_epu32(next, msg[cur]);
+    }
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(words, 0x0e));
+    if constexpr (G >= 1 && G <= 12)
+        msg[(G + 3) % 4] = _mm_sha256msg1_epu32(msg[(G + 3) % 4], msg[cur]);
+
+    if constexpr (G < 15)
+        sha256Group<G + 1>(state0, state1, msg);
+}
+
+SHA_TARGET void sha256(uint32_t* state, const unsigned char* blocks, size_t count)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // the instructions want the state as ABEF and CDGH
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xb1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1b);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+    for (; count; count--, blocks += 64) {
+        __m128i abef_save = state0;
+        __m128i cdgh_save = state1;
+
+        __m128i msg[4];
+        for (int i = 0; i < 4; i++)
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16 * i)), mask);
+
+        sha256Group<0>(state0, state1, msg);
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(tmp, state1, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(state1, tmp, 8));
+}
+
+}  // namespace
+#endif
+
+const Engine* x86Engine()
+{
+#ifdef SHA_X86
+    // no SHA-512 instructions on the CPUs we run on yet, the portable one does it
+    static const Engine s_engine{ "x86-sha", sha1, sha256, nullptr };
+    static const bool s_supported = hasShaExtensions();
+    return s_supported ? &s_engine : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+}  // namespace Sha
@@ -22,6 +22,7 @@
 
 #include "FileLink.h"
 #include "BuildConfig.h"
+#include "FileLinkProtocol.h"
 
 #include "StringUtils.h"
 
@@ -94,15 +95,14 @@ FileLinkApp::FileLinkApp(int& argc, char** argv) : QCoreApplication(argc, argv),
     QCommandLineParser parser;
     parser.setApplicationDescription(QObject::tr("a batch MKLINK program for windows to be used with prismlauncher"));
 
-    parser.addOptions({ { { "s", "server" }, "Join the specified server on launch", "pipe name" },
-                        { { "H", "hard" }, "use hard links instead of symbolic", "true/false" } });
+    parser.addOptions({ { { "s", "server" }, "Join the specified server on launch, and make the links it asks for until it's gone",
+                          "pipe name" } });
     parser.addHelpOption();
     parser.addVersionOption();
 
     parser.process(arguments());
 
     QString serverToJoin = parser.value("server");
-    m_useHardLinks = QVariant(parser.value("hard")).toBool();
 
     qDebug() << "link program launched";
 
@@ -117,13 +117,12 @@ FileLinkApp::FileLinkApp(int& argc, char** argv) : QCoreApplication(argc, argv),
 
 void FileLinkApp::joinServer(QString server)
 {
-    blockSize = 0;
-
     in.setDevice(&socket);
+    in.setVersion(QDataStream::Qt_5_6);
 
     connect(&socket, &QLocalSocket::connected, this, [&]() { qDebug() << "connected to server"; });
 
-    connect(&socket, &QLocalSocket::readyRead, this, &FileLinkApp::readPathPairs);
+    connect(&socket, &QLocalSocket::readyRead, this, &FileLinkApp::readBatches);
 
     connect(&socket, &QLocalSocket::errorOccurred, this, [&](QLocalSocket::LocalSocketError socketError) {
         switch (socketError) {
@@ -156,18 +155,17 @@ void FileLinkApp::joinServer(QString server)
     socket.connectToServer(server);
 }
 
-void FileLinkApp::runLink()
+void FileLinkApp::runLink(quint32 batch, const QList<FS::LinkPair>& links, bool useHardLinks)
 {
-    std::error_code os_err;
-
-    qDebug() << "creating links";
+    qDebug() << "creating" << links.size() << "links, batch" << batch;
 
-    for (auto link : m_links_to_make) {
+    for (auto link : links) {
+        std::error_code os_err;
         QString src_path = link.src;
         QString dst_path = link.dst;
 
         FS::ensureFilePathExists(dst_path);
-        if (m_useHardLinks) {
+        if (useHardLinks) {
             qDebug() << "making hard link:" << src_path << "to" << dst_path;
             fs::create_hard_link(StringUtils::toStdString(src_path), StringUtils::toStdString(dst_path), os_err);
         } else if (fs::is_directory(StringUtils::toStdString(src_path))) {
@@ -178,6 +176,7 @@ void FileLinkApp::runLink()
             fs::create_symlink(StringUtils::toStdString(src_path), StringUtils::toStdString(dst_path), os_err);
         }
 
+        FS::LinkResult result = { src_path, dst_path };
         if (os_err) {
             qWarning() << "Failed to link files:" << QString::fromStdString(os_err.message());
             qDebug() << "Source file:" << src_path;
@@ -185,78 +184,42 @@ void FileLinkApp::runLink()
             qDebug() << "Error category:" << os_err.category().name();
             qDebug() << "Error code:" << os_err.value();
 
-            FS::LinkResult result = { src_path, dst_path, QString::fromStdString(os_err.message()), os_err.value() };
-            m_path_results.append(result);
-        } else {
-            FS::LinkResult result = { src_path, dst_path };
-            m_path_results.append(result);
+            result = { src_path, dst_path, QString::fromStdString(os_err.message()), os_err.value() };
         }
+        // each result as it comes, for the launcher to show the progress
+        FileLinkProtocol::write(&socket, FileLinkProtocol::result(batch, result));
+        socket.flush();
     }
 
-    sendResults();
-    qDebug() << "done, should exit soon";
+    FileLinkProtocol::write(&socket, FileLinkProtocol::done(batch));
+    socket.flush();
+    qDebug() << "done with batch" << batch;
 }
 
-void FileLinkApp::sendResults()
+void FileLinkApp::readBatches()
 {
-    // construct block of data to send
-    QByteArray block;
-    QDataStream out(&block, QIODevice::WriteOnly);
-
-    qint32 blocksize = quint32(sizeof(quint32));
-    for (auto result : m_path_results) {
-        blocksize += quint32(result.src.size());
-        blocksize += quint32(result.dst.size());
-        blocksize += quint32(result.err_msg.size());
-        blocksize += quint32(sizeof(quint32));
-    }
-    qDebug() << "About to write block of size:" << blocksize;
-    out << blocksize;
-
-    out << quint32(m_path_results.length());
-    for (auto result : m_path_results) {
-        out << result.src;
-        out << result.dst;
-        out << result.err_msg;
-        out << quint32(result.err_value);
-    }
-
-    qint64 byteswritten = socket.write(block);
-    bool bytesflushed = socket.flush();
-    qDebug() << "block flushed" << byteswritten << bytesflushed;
-}
+    QByteArray message;
+    while (FileLinkProtocol::read(in, message)) {
+        QDataStream body(message);
+        body.setVersion(QDataStream::Qt_5_6);
+        quint8 type;
+        quint32 batch;
+        bool useHardLinks;
+        quint32 numLinks;
+        body >> type >> batch >> useHardLinks >> numLinks;
+        if (type != quint8(FileLinkProtocol::Message::Batch)) {
+            qWarning() << "Unknown message from the server:" << type;
+            continue;
+        }
 
-void FileLinkApp::readPathPairs()
-{
-    m_links_to_make.clear();
-    qDebug() << "Reading path pairs from server";
-    qDebug() << "bytes available" << socket.bytesAvailable();
-    if (blockSize == 0) {
-        // Relies on the fact that QDataStream serializes a quint32 into
-        // sizeof(quint32) bytes
-        if (socket.bytesAvailable() < (int)sizeof(quint32))
-            return;
-        qDebug() << "reading block size";
-        in >> blockSize;
-    }
-    qDebug() << "blocksize is" << blockSize;
-    qDebug() << "bytes available" << socket.bytesAvailable();
-    if (socket.bytesAvailable() < blockSize || in.atEnd())
-        return;
-
-    quint32 numLinks;
-    in >> numLinks;
-    qDebug() << "numLinks" << numLinks;
-
-    for (int i = 0; i < numLinks; i++) {
-        FS::LinkPair pair;
-        in >> pair.src;
-        in >> pair.dst;
-        qDebug() << "link" << pair.src << "to" << pair.dst;
-        m_links_to_make.append(pair);
+        QList<FS::LinkPair> links;
+        for (quint32 i = 0; i < numLinks && !body.atEnd(); i++) {
+            FS::LinkPair pair;
+            body >> pair.src >> pair.dst;
+            links.append(pair);
+        }
+        runLink(batch, links, useHardLinks);
     }
-
-    runLink();
 }
 
 FileLinkApp::~FileLinkApp()
@@ -46,19 +46,12 @@ class FileLinkApp : public QCoreApplication {
 
    private:
     void joinServer(QString server);
-    void readPathPairs();
-    void runLink();
-    void sendResults();
-
-    bool m_useHardLinks = false;
+    void readBatches();
+    void runLink(quint32 batch, const QList<FS::LinkPair>& links, bool useHardLinks);
 
     QDateTime m_startTime;
     QLocalSocket socket;
     QDataStream in;
-    quint32 blockSize;
-
-    QList<FS::LinkPair> m_links_to_make;
-    QList<FS::LinkResult> m_path_results;
 
 #if defined Q_OS_WIN32
     // used on Windows to attach the standard IO streams
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QIODevice>
+#include <QList>
+
+#include "FileSystem.h"
+
+/* What the launcher and the filelink program say to each other over their local socket.
+ *
+ * Each message is a QByteArray, which QDataStream writes with its size in front, so the reader knows when it has all of
+ * it. The launcher sends batches of links to make, the program answers with the result of each link as soon as it's
+ * made, then with the end of the batch. It serves batches until the launcher disconnects.
+ */
+namespace FileLinkProtocol {
+
+enum class Message : quint8 {
+    Batch = 1,
+    Result,
+    Done,
+};
+
+inline void write(QIODevice* device, const QByteArray& message)
+{
+    QDataStream out(device);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << message;
+}
+
+/** Takes the next message out of `in`, false until all of it arrived. */
+inline bool read(QDataStream& in, QByteArray& message)
+{
+    in.startTransaction();
+    in >> message;
+    return in.commitTransaction();
+}
+
+inline QByteArray batch(quint32 id, bool hardLinks, const QList<FS::LinkPair>& links)
+{
+    QByteArray message;
+    QDataStream out(&message, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << quint8(Message::Batch) << id << hardLinks << quint32(links.size());
+    for (auto& link : links)
+        out << link.src << link.dst;
+    return message;
+}
+
+inline QByteArray result(quint32 id, const FS::LinkResult& result)
+{
+    QByteArray message;
+    QDataStream out(&message, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << quint8(Message::Result) << id << result.src << result.dst << result.err_msg << qint32(result.err_value);
+    return message;
+}
+
+inline QByteArray done(quint32 id)
+{
+    QByteArray message;
+    QDataStream out(&message, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << quint8(Message::Done) << id;
+    return message;
+}
+
+}  // namespace FileLinkProtocol
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "IconAtlas.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QImageReader>
+#include <QPixmap>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "Executors.h"
+#include "FileSystem.h"
+
+IconAtlas::IconAtlas(QString cacheDir, QObject* parent) : QObject(parent), m_cacheDir(cacheDir) {}
+
+const QList<int>& IconAtlas::bucketSizes()
+{
+    // what the instance view, the icon picker and the toolbars paint them at
+    static const QList<int> sizes = { 16, 24, 32, 48, 64, 128 };
+    return sizes;
+}
+
+QIcon IconAtlas::icon(const QString& path)
+{
+    auto iter = m_entries.constFind(path);
+    if (iter != m_entries.constEnd() && !iter->icon.isNull())
+        return iter->icon;
+    load(path);
+    return QIcon();
+}
+
+void IconAtlas::load(const QString& path)
+{
+    auto& entry = m_entries[path];
+    if (entry.loading || entry.failed || !entry.icon.isNull())
+        return;
+    entry.loading = true;
+
+    int generation = entry.generation;
+    auto cacheDir = m_cacheDir;
+    auto watcher = new QFutureWatcher<QList<QImage>>(this);
+    connect(watcher, &QFutureWatcher<QList<QImage>>::finished, this, [this, watcher, path, generation] {
+        loaded(path, generation, watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(Executors::background(), [path, cacheDir] { return scale(path, cacheDir); }));
+}
+
+void IconAtlas::invalidate(const QString& path)
+{
+    auto iter = m_entries.find(path);
+    if (iter == m_entries.end())
+        return;
+    iter->icon = QIcon();
+    iter->loading = false;
+    iter->failed = false;
+    iter->generation++;
+}
+
+QList<QImage> IconAtlas::scale(const QString& path, const QString& cacheDir)
+{
+    QList<QImage> images;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return images;
+    auto data = file.readAll();
+    auto hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+
+    QDir cache(cacheDir);
+    // made before, maybe for another copy of the same file
+    for (auto size : bucketSizes()) {
+        QImage image(cache.absoluteFilePath(QString("%1-%2.png").arg(QString::fromLatin1(hash)).arg(size)));
+        if (image.isNull()) {
+            images.clear();
+            break;
+        }
+        images.append(image);
+    }
+    if (!images.isEmpty())
+        return images;
+
+    QBuffer buffer(&data);
+    QImageReader reader(&buffer);
+    auto largest = bucketSizes().last();
+    // vector images can be rendered at the right size right away, the others are as big as they are
+    if (reader.supportsOption(QImageIOHandler::ScaledSize) && reader.size().isValid())
+        reader.setScaledSize(reader.size().scaled(largest, largest, Qt::KeepAspectRatio));
+    auto source = reader.read();
+    if (source.isNull()) {
+        qWarning() << "Couldn't decode icon" << path << ":" << reader.errorString();
+        return images;
+    }
+
+    FS::ensureFolderPathExists(cache.absolutePath());
+    for (auto size : bucketSizes()) {
+        auto image = source;
+        // smaller images are kept as they are, and centered when painted
+        if (source.width() > size || source.height() > size)
+            image = source.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        image.save(cache.absoluteFilePath(QString("%1-%2.png").arg(QString::fromLatin1(hash)).arg(size)), "PNG");
+        images.append(image);
+    }
+    return images;
+}
+
+void IconAtlas::loaded(const QString& path, int generation, const QList<QImage>& images)
+{
+    auto iter = m_entries.find(path);
+    if (iter == m_entries.end() || iter->generation != generation)
+        return;
+    iter->loading = false;
+    if (images.isEmpty()) {
+        iter->failed = true;
+        return;
+    }
+
+    QIcon icon;
+    QList<QSize> sizes;
+    for (auto& image : images) {
+        // small images are the same in more than one bucket
+        if (sizes.contains(image.size()))
+            continue;
+        sizes.append(image.size());
+        icon.addPixmap(QPixmap::fromImage(image));
+    }
+    iter->icon = icon;
+    emit iconLoaded(path);
+}
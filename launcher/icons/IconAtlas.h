@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QIcon>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+/* Icons from image files, decoded and scaled down to the sizes they get painted at, off the GUI thread.
+ *
+ * Icon files can be any size, and a QIcon made from one decodes the whole image and then scales it down
+ * every time it's painted at a size it doesn't have. Here, every image is decoded once, in the background,
+ * into a pixmap for each of the sizes in `bucketSizes()`, so painting never has to scale anything.
+ *
+ * The scaled images are also kept on disk, named after the hash of the file they come from, so they
+ * don't have to be made again the next time, or for another copy of the same file.
+ */
+class IconAtlas : public QObject {
+    Q_OBJECT
+   public:
+    explicit IconAtlas(QString cacheDir, QObject* parent = nullptr);
+
+    static const QList<int>& bucketSizes();
+
+    /** The scaled icon for the file at `path`, or a null icon when it isn't ready yet (it will get loaded then). */
+    QIcon icon(const QString& path);
+
+    /** Starts loading the file at `path` in the background, unless it is already loaded or loading. */
+    void load(const QString& path);
+
+    /** Forgets what was loaded from `path`, for when the file changed. */
+    void invalidate(const QString& path);
+
+   signals:
+    void iconLoaded(QString path);
+
+   private:
+    struct Entry {
+        QIcon icon;
+        bool loading = false;
+        // not an image, no point in trying again until it changes
+        bool failed = false;
+        // bumped whenever the entry gets invalidated, so results of older loads get thrown away
+        int generation = 0;
+    };
+
+    static QList<QImage> scale(const QString& path, const QString& cacheDir);
+    void loaded(const QString& path, int generation, const QList<QImage>& images);
+
+   private:
+    QString m_cacheDir;
+    QHash<QString, Entry> m_entries;
+};
@@ -35,11 +35,11 @@
 
 #include "IconList.h"
 #include <FileSystem.h>
+#include <FileWatcher.h>
 #include <QMap>
 #include <QEventLoop>
 #include <QMimeData>
 #include <QUrl>
-#include <QFileSystemWatcher>
 #include <QSet>
 #include <QDebug>
 
@@ -64,10 +64,14 @@ IconList::IconList(const QStringList &builtinPaths, QString path, QObject *paren
         addThemeIcon(builtinName);
     }
 
-    m_watcher.reset(new QFileSystemWatcher());
+    m_atlas.reset(new IconAtlas(QDir("cache/scaled_icons").absolutePath()));
+    connect(m_atlas.get(), &IconAtlas::iconLoaded, this, &IconList::scaledIconLoaded);
+
+    m_watcher.reset(new FileWatcher());
+    // an icon can be changed in place, not only replaced
+    m_watcher->setWatchFiles(true);
     is_watching = false;
-    connect(m_watcher.get(), &QFileSystemWatcher::directoryChanged, this, &IconList::directoryChanged);
-    connect(m_watcher.get(), &QFileSystemWatcher::fileChanged, this, &IconList::fileChanged);
+    connect(m_watcher.get(), &FileWatcher::changed, this, &IconList::watchedChanged);
 
     directoryChanged(path);
 
@@ -155,7 +159,6 @@ void IconList::directoryChanged(const QString &path)
         {
             dataChanged(index(idx), index(idx));
         }
-        m_watcher->removePath(remove);
         emit iconUpdated(key);
     }
 
@@ -173,7 +176,6 @@ void IconList::directoryChanged(const QString &path)
 
         if (addIcon(key, QString(), addfile.filePath(), IconType::FileBased))
         {
-            m_watcher->addPath(add);
             emit iconUpdated(key);
         }
     }
@@ -181,6 +183,25 @@ void IconList::directoryChanged(const QString &path)
     sortIconList();
 }
 
+void IconList::watchedChanged(const QString &dir, const QStringList &paths)
+{
+    // the icons that were there already are loaded again, the new ones get loaded with the folder
+    for (auto &path : paths)
+    {
+        if (path == dir)
+            continue;
+        for (auto &icon : icons)
+        {
+            if (icon.has(IconType::FileBased) && QFileInfo(icon.m_images[IconType::FileBased].filename).absoluteFilePath() == path)
+            {
+                fileChanged(path);
+                break;
+            }
+        }
+    }
+    directoryChanged(dir);
+}
+
 void IconList::fileChanged(const QString &path)
 {
     qDebug() << "Checking " << path;
@@ -196,10 +217,23 @@ void IconList::fileChanged(const QString &path)
         return;
 
     icons[idx].m_images[IconType::FileBased].icon = icon;
+    m_atlas->invalidate(path);
+    m_atlas->load(path);
     dataChanged(index(idx), index(idx));
     emit iconUpdated(key);
 }
 
+void IconList::scaledIconLoaded(const QString &path)
+{
+    for (int i = 0; i < icons.size(); i++)
+    {
+        if (icons[i].type() != IconType::FileBased || icons[i].getFilePath() != path)
+            continue;
+        dataChanged(index(i), index(i), { Qt::DecorationRole });
+        emit iconUpdated(icons[i].m_key);
+    }
+}
+
 void IconList::SettingChanged(const Setting &setting, QVariant value)
 {
     if(setting.id() != "IconsDir")
@@ -225,8 +259,7 @@ void IconList::startWatching()
 
 void IconList::stopWatching()
 {
-    m_watcher->removePaths(m_watcher->files());
-    m_watcher->removePaths(m_watcher->directories());
+    m_watcher->removeAll();
     is_watching = false;
 }
 
@@ -289,7 +322,7 @@ QVariant IconList::data(const QModelIndex &index, int role) const
     switch (role)
     {
     case Qt::DecorationRole:
-        return icons[row].icon();
+        return scaledIcon(icons[row]);
     case Qt::DisplayRole:
         return icons[row].name();
     case Qt::UserRole:
@@ -400,6 +433,10 @@ bool IconList::addIcon(const QString &key, const QString &name, const QString &p
     QIcon icon(path);
     if (icon.isNull())
         return false;
+    if (type == IconType::FileBased)
+    {
+        m_atlas->load(path);
+    }
     auto iter = name_index.find(key);
     if (iter != name_index.end())
     {
@@ -449,16 +486,28 @@ QIcon IconList::getIcon(const QString &key) const
     int icon_index = getIconIndex(key);
 
     if (icon_index != -1)
-        return icons[icon_index].icon();
+        return scaledIcon(icons[icon_index]);
 
     // Fallback for icons that don't exist.
     icon_index = getIconIndex("grass");
 
     if (icon_index != -1)
-        return icons[icon_index].icon();
+        return scaledIcon(icons[icon_index]);
     return QIcon();
 }
 
+QIcon IconList::scaledIcon(const MMCIcon &icon) const
+{
+    // until the scaled one is there, the full size one has to do
+    if (icon.type() == IconType::FileBased)
+    {
+        auto scaled = m_atlas->icon(icon.getFilePath());
+        if (!scaled.isNull())
+            return scaled;
+    }
+    return icon.icon();
+}
+
 int IconList::getIconIndex(const QString &key) const
 {
     auto iter = name_index.find(key == "default" ? "grass" : key);
@@ -22,12 +22,13 @@
 #include <QtGui/QIcon>
 #include <memory>
 
+#include "IconAtlas.h"
 #include "MMCIcon.h"
 #include "settings/Setting.h"
 
 #include "QObjectPtr.h"
 
-class QFileSystemWatcher;
+class FileWatcher;
 
 class IconList : public QAbstractListModel
 {
@@ -73,15 +74,19 @@ private:
     IconList &operator=(const IconList &) = delete;
     void reindex();
     void sortIconList();
+    QIcon scaledIcon(const MMCIcon &icon) const;
 
 public slots:
     void directoryChanged(const QString &path);
 
 protected slots:
+    void watchedChanged(const QString &dir, const QStringList &paths);
     void fileChanged(const QString &path);
+    void scaledIconLoaded(const QString &path);
     void SettingChanged(const Setting & setting, QVariant value);
 private:
-    shared_qobject_ptr<QFileSystemWatcher> m_watcher;
+    shared_qobject_ptr<FileWatcher> m_watcher;
+    shared_qobject_ptr<IconAtlas> m_atlas;
     bool is_watching;
     QMap<QString, int> name_index;
     QVector<MMCIcon> icons;
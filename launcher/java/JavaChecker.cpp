@@ -35,12 +35,15 @@
 
 #include "JavaChecker.h"
 
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QProcess>
 #include <QMap>
 #include <QDebug>
 
 #include "JavaUtils.h"
+#include "JavaProbeCache.h"
 #include "FileSystem.h"
 #include "Commandline.h"
 #include "Application.h"
@@ -51,6 +54,19 @@ JavaChecker::JavaChecker(QObject *parent) : QObject(parent)
 
 void JavaChecker::performCheck()
 {
+    if (isPlainProbe())
+    {
+        JavaCheckResult result;
+        if (APPLICATION->javaProbeCache()->lookup(m_path, result) || readReleaseFile(result))
+        {
+            qDebug() << "Java checker result for" << m_path << "is already known.";
+            result.id = m_id;
+            // still asynchronous, like the real check
+            QTimer::singleShot(0, this, [this, result] { emit checkFinished(result); });
+            return;
+        }
+    }
+
     QString checkerJar = JavaUtils::getJavaCheckPath();
 
     if (checkerJar.isEmpty())
@@ -97,6 +113,69 @@ void JavaChecker::performCheck()
     process->start();
 }
 
+void JavaChecker::setArchitecture(JavaCheckResult& result, const QString& arch)
+{
+    bool is_64 = arch == "x86_64" || arch == "amd64" || arch == "aarch64" || arch == "arm64";
+    result.is_64bit = is_64;
+    result.mojangPlatform = is_64 ? "64" : "32";
+    result.realPlatform = arch;
+}
+
+bool JavaChecker::readReleaseFile(JavaCheckResult& result) const
+{
+    // JDKs (and the JREs made from them) describe themselves in <java home>/release, next to bin/java
+    QFileInfo binary(QFileInfo(m_path).canonicalFilePath());
+    QDir home = binary.dir();
+    if (!binary.exists() || !home.cdUp())
+    {
+        return false;
+    }
+    QFile release(home.absoluteFilePath("release"));
+    if (!release.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return false;
+    }
+
+    QMap<QString, QString> values;
+    while (!release.atEnd())
+    {
+        auto line = QString::fromUtf8(release.readLine()).trimmed();
+        auto separator = line.indexOf('=');
+        if (separator <= 0)
+        {
+            continue;
+        }
+        auto value = line.mid(separator + 1).trimmed();
+        if (value.size() >= 2 && value.startsWith('"') && value.endsWith('"'))
+        {
+            value = value.mid(1, value.size() - 2);
+        }
+        values.insert(line.left(separator), value);
+    }
+
+    // older ones leave some of it out, the JVM has to be asked then
+    auto version = values.value("JAVA_VERSION");
+    auto vendor = values.value("IMPLEMENTOR");
+    auto arch = values.value("OS_ARCH");
+    if (version.isEmpty() || vendor.isEmpty() || arch.isEmpty())
+    {
+        return false;
+    }
+
+    result.path = m_path;
+    result.validity = JavaCheckResult::Validity::Valid;
+    setArchitecture(result, arch);
+    result.javaVersion = version;
+    result.javaVendor = vendor;
+    return true;
+}
+
+bool JavaChecker::isPlainProbe() const
+{
+    // anything else tests whether Java starts with these options, that can't be known in advance
+    return m_args.isEmpty() && m_minMem == 0 && m_maxMem == 0 && m_permGen == 64;
+}
+
 void JavaChecker::stdoutReady()
 {
     QByteArray data = process->readAllStandardOutput();
@@ -179,16 +258,16 @@ void JavaChecker::finished(int exitcode, QProcess::ExitStatus status)
     auto os_arch = results["os.arch"];
     auto java_version = results["java.version"];
     auto java_vendor = results["java.vendor"];
-    bool is_64 = os_arch == "x86_64" || os_arch == "amd64" || os_arch == "aarch64" || os_arch == "arm64";
-
 
     result.validity = JavaCheckResult::Validity::Valid;
-    result.is_64bit = is_64;
-    result.mojangPlatform = is_64 ? "64" : "32";
-    result.realPlatform = os_arch;
+    setArchitecture(result, os_arch);
     result.javaVersion = java_version;
     result.javaVendor = java_vendor;
     qDebug() << "Java checker succeeded.";
+    if (isPlainProbe())
+    {
+        APPLICATION->javaProbeCache()->store(result);
+    }
     emit checkFinished(result);
 }
 
@@ -37,6 +37,9 @@ public:
     explicit JavaChecker(QObject *parent = 0);
     void performCheck();
 
+    /** Fills in the architecture related parts of a result from the name of the architecture (os.arch). */
+    static void setArchitecture(JavaCheckResult& result, const QString& arch);
+
     QString m_path;
     QString m_args;
     int m_id = 0;
@@ -47,6 +50,9 @@ public:
 signals:
     void checkFinished(JavaCheckResult result);
 private:
+    bool isPlainProbe() const;
+    bool readReleaseFile(JavaCheckResult& result) const;
+
     QProcessPtr process;
     QTimer killTimer;
     QString m_stdout;
@@ -16,6 +16,7 @@
 #include "JavaCheckerJob.h"
 
 #include <QDebug>
+#include <QThread>
 
 void JavaCheckerJob::partFinished(JavaCheckResult result)
 {
@@ -29,16 +30,31 @@ void JavaCheckerJob::partFinished(JavaCheckResult result)
     if (num_finished == javacheckers.size())
     {
         emitSucceeded();
+        return;
     }
+    startNext();
 }
 
 void JavaCheckerJob::executeTask()
 {
     qDebug() << m_job_name.toLocal8Bit() << " started.";
-    for (auto iter : javacheckers)
+    if (javacheckers.isEmpty())
     {
-        javaresults.append(JavaCheckResult());
-        connect(iter.get(), &JavaChecker::checkFinished, this, &JavaCheckerJob::partFinished);
-        iter->performCheck();
+        emitSucceeded();
+        return;
+    }
+    startNext();
+}
+
+void JavaCheckerJob::startNext()
+{
+    // every JVM takes its share of memory, a lot of cores don't make a lot of them a good idea
+    int max_concurrent = m_max_concurrent > 0 ? m_max_concurrent : qBound(1, QThread::idealThreadCount(), 4);
+    while (num_started < javacheckers.size() && num_started - num_finished < max_concurrent)
+    {
+        auto checker = javacheckers[num_started];
+        num_started++;
+        connect(checker.get(), &JavaChecker::checkFinished, this, &JavaCheckerJob::partFinished);
+        checker->performCheck();
     }
 }
@@ -27,18 +27,22 @@ class JavaCheckerJob : public Task
 {
     Q_OBJECT
 public:
-    explicit JavaCheckerJob(QString job_name) : Task(), m_job_name(job_name) {};
+    /**
+     * Checks at most `max_concurrent` Javas at once, every check possibly being a JVM of its own.
+     * 0 means as many as there are cores, up to 4.
+     */
+    explicit JavaCheckerJob(QString job_name, int max_concurrent = 0) : Task(), m_job_name(job_name), m_max_concurrent(max_concurrent) {};
     virtual ~JavaCheckerJob() {};
 
     bool addJavaCheckerAction(JavaCheckerPtr base)
     {
         javacheckers.append(base);
-        // if this is already running, the action needs to be started right away!
+        javaresults.append(JavaCheckResult());
+        // if this is already running, the action needs to be started as soon as there's room for it!
         if (isRunning())
         {
             setProgress(num_finished, javacheckers.size());
-            connect(base.get(), &JavaChecker::checkFinished, this, &JavaCheckerJob::partFinished);
-            base->performCheck();
+            startNext();
         }
         return true;
     }
@@ -53,8 +57,13 @@ private slots:
 protected:
     virtual void executeTask() override;
 
+private:
+    void startNext();
+
 private:
     QString m_job_name;
+    int m_max_concurrent = 0;
+    int num_started = 0;
     QList<JavaCheckerPtr> javacheckers;
     QList<JavaCheckResult> javaresults;
     int num_finished = 0;
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "JavaProbeCache.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+#include "FileSystem.h"
+#include "Json.h"
+
+JavaProbeCache::JavaProbeCache(QString path) : m_path(path)
+{
+    load();
+}
+
+bool JavaProbeCache::lookup(const QString& javaPath, JavaCheckResult& result) const
+{
+    auto iter = m_entries.constFind(key(javaPath));
+    if (iter == m_entries.constEnd() || !(iter->identity == identityOf(javaPath)))
+        return false;
+
+    result.path = javaPath;
+    result.validity = JavaCheckResult::Validity::Valid;
+    JavaChecker::setArchitecture(result, iter->realPlatform);
+    result.javaVersion = iter->javaVersion;
+    result.javaVendor = iter->javaVendor;
+    return true;
+}
+
+bool JavaProbeCache::findCompatible(const QList<int>& majors, JavaCheckResult& result) const
+{
+    // whether `a` is to be picked over `b`
+    auto better = [](JavaCheckResult& a, JavaCheckResult& b) {
+        if (a.is_64bit != b.is_64bit)
+            return a.is_64bit;
+        return b.javaVersion < a.javaVersion;
+    };
+
+    bool found = false;
+    for (auto iter = m_entries.cbegin(); iter != m_entries.cend(); iter++) {
+        JavaVersion version(iter->javaVersion);
+        if (!majors.contains(version.major()))
+            continue;
+
+        JavaCheckResult candidate;
+        if (!lookup(iter.key(), candidate))
+            continue;
+        if (found && !better(candidate, result))
+            continue;
+        result = candidate;
+        found = true;
+    }
+    return found;
+}
+
+void JavaProbeCache::store(const JavaCheckResult& result)
+{
+    if (result.validity != JavaCheckResult::Validity::Valid)
+        return;
+
+    auto identity = identityOf(result.path);
+    if (identity.size < 0)
+        return;
+
+    Entry entry;
+    entry.identity = identity;
+    entry.javaVersion = result.javaVersion.toString();
+    entry.javaVendor = result.javaVendor;
+    entry.realPlatform = result.realPlatform;
+    m_entries.insert(key(result.path), entry);
+    save();
+}
+
+QString JavaProbeCache::key(const QString& javaPath)
+{
+    // the same binary can be reached through symlinks, like /usr/bin/java
+    auto canonical = QFileInfo(javaPath).canonicalFilePath();
+    return canonical.isEmpty() ? javaPath : canonical;
+}
+
+JavaProbeCache::Identity JavaProbeCache::identityOf(const QString& javaPath)
+{
+    Identity identity;
+    QFileInfo info(key(javaPath));
+    if (!info.exists())
+        return identity;
+
+    identity.size = info.size();
+    identity.mtime = info.lastModified().toMSecsSinceEpoch();
+#ifdef Q_OS_UNIX
+    struct stat st;
+    if (stat(QFile::encodeName(info.filePath()).constData(), &st) == 0)
+        identity.inode = st.st_ino;
+#endif
+    return identity;
+}
+
+void JavaProbeCache::load()
+{
+    if (!QFileInfo::exists(m_path))
+        return;
+
+    try {
+        auto root = Json::requireObject(Json::requireDocument(m_path, "Java probe cache"), "Java probe cache");
+        for (auto value : Json::ensureArray(root, "javas")) {
+            auto obj = Json::requireObject(value);
+            Entry entry;
+            entry.identity.size = static_cast<qint64>(Json::requireDouble(obj, "size"));
+            entry.identity.mtime = static_cast<qint64>(Json::requireDouble(obj, "mtime"));
+            entry.identity.inode = Json::ensureString(obj, "inode", "0").toULongLong();
+            entry.javaVersion = Json::requireString(obj, "version");
+            entry.javaVendor = Json::requireString(obj, "vendor");
+            entry.realPlatform = Json::requireString(obj, "arch");
+            m_entries.insert(Json::requireString(obj, "path"), entry);
+        }
+    } catch (const Exception& e) {
+        qWarning() << "Couldn't load the Java probe cache:" << e.cause();
+        m_entries.clear();
+    }
+}
+
+void JavaProbeCache::save() const
+{
+    QJsonArray javas;
+    for (auto iter = m_entries.cbegin(); iter != m_entries.cend(); iter++) {
+        QJsonObject obj;
+        obj.insert("path", iter.key());
+        obj.insert("size", iter->identity.size);
+        obj.insert("mtime", iter->identity.mtime);
+        // doesn't fit in a double
+        obj.insert("inode", QString::number(iter->identity.inode));
+        obj.insert("version", iter->javaVersion);
+        obj.insert("vendor", iter->javaVendor);
+        obj.insert("arch", iter->realPlatform);
+        javas.append(obj);
+    }
+    QJsonObject root;
+    root.insert("javas", javas);
+
+    try {
+        Json::write(root, m_path);
+    } catch (const Exception& e) {
+        qWarning() << "Couldn't save the Java probe cache:" << e.cause();
+    }
+}
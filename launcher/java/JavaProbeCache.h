@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include "JavaChecker.h"
+
+/* What the Java checker found out about Java binaries, so the same binary doesn't get started over and over.
+ *
+ * A result is tied to the identity of the binary it came from (its size, modification time and inode), so
+ * updating or replacing a Java install makes it get probed again. Only valid results are kept: a Java that
+ * couldn't be started may well start next time.
+ */
+class JavaProbeCache {
+   public:
+    explicit JavaProbeCache(QString path);
+
+    /** Looks up the result for the binary at `javaPath`, as long as the binary didn't change since. */
+    bool lookup(const QString& javaPath, JavaCheckResult& result) const;
+
+    /**
+     * Finds the best Java of the ones probed so far whose major version is one of `majors`: the newest one, 64-bit
+     * before 32-bit. Javas that changed or went away since they were probed don't count.
+     */
+    bool findCompatible(const QList<int>& majors, JavaCheckResult& result) const;
+
+    /** Remembers a result, and writes the cache back to disk. */
+    void store(const JavaCheckResult& result);
+
+   private:
+    struct Identity {
+        qint64 size = -1;
+        qint64 mtime = 0;
+        quint64 inode = 0;
+
+        bool operator==(const Identity& other) const
+        {
+            return size == other.size && mtime == other.mtime && inode == other.inode;
+        }
+    };
+    struct Entry {
+        Identity identity;
+        QString javaVersion;
+        QString javaVendor;
+        QString realPlatform;
+    };
+
+    static QString key(const QString& javaPath);
+    static Identity identityOf(const QString& javaPath);
+    void load();
+    void save() const;
+
+   private:
+    QString m_path;
+    QHash<QString, Entry> m_entries;
+};
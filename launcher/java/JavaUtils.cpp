@@ -43,6 +43,7 @@
 #include <QDebug>
 #include "java/JavaUtils.h"
 #include "java/JavaInstallList.h"
+#include "java/ManagedRuntime.h"
 #include "FileSystem.h"
 #include "Application.h"
 
@@ -379,6 +380,7 @@ QList<QString> JavaUtils::FindJavaPaths()
         }
     }
 
+    candidates.append(ManagedRuntime::installedJavaPaths());
     candidates = addJavasFromEnv(candidates);
     candidates.removeDuplicates();
     return candidates;
@@ -404,6 +406,7 @@ QList<QString> JavaUtils::FindJavaPaths()
         javas.append(systemLibraryJVMDir.absolutePath() + "/" + java + "/Contents/Home/bin/java");
         javas.append(systemLibraryJVMDir.absolutePath() + "/" + java + "/Contents/Commands/java");
     }
+    javas.append(ManagedRuntime::installedJavaPaths());
     javas = addJavasFromEnv(javas);
     javas.removeDuplicates();
     return javas;
@@ -450,6 +453,7 @@ QList<QString> JavaUtils::FindJavaPaths()
     scanJavaDirs("/opt/jdks");
     // flatpak
     scanJavaDirs("/app/jdk");
+    javas.append(ManagedRuntime::installedJavaPaths());
     javas = addJavasFromEnv(javas);
     javas.removeDuplicates();
     return javas;
@@ -461,6 +465,7 @@ QList<QString> JavaUtils::FindJavaPaths()
 
     QList<QString> javas;
     javas.append(this->GetDefaultJava()->path);
+    javas.append(ManagedRuntime::installedJavaPaths());
 
     return addJavasFromEnv(javas);
 }
@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "JvmProfiles.h"
+
+#include <QCoreApplication>
+
+namespace JvmProfiles {
+
+namespace {
+// OpenJ9 is a different JVM altogether, it has none of the HotSpot collectors
+const QStringList s_not_hotspot = { "IBM", "OpenJ9" };
+
+QList<Profile> makeProfiles()
+{
+    QList<Profile> profiles;
+
+    // the flags of Aikar, well known for servers and good for clients too
+    Profile g1;
+    g1.id = "g1-low-pause";
+    g1.revision = 1;
+    g1.name = QT_TRANSLATE_NOOP("JvmProfiles", "G1, low pauses");
+    g1.description = QT_TRANSLATE_NOOP("JvmProfiles", "The default collector, tuned for short pauses. Works well for most modpacks.");
+    g1.minJava = 8;
+    g1.excludedVendors = s_not_hotspot;
+    g1.arguments = {
+        { "-XX:+UseG1GC" },
+        { "-XX:+ParallelRefProcEnabled" },
+        { "-XX:MaxGCPauseMillis=200" },
+        { "-XX:+UnlockExperimentalVMOptions" },
+        { "-XX:+DisableExplicitGC" },
+        { "-XX:+AlwaysPreTouch" },
+        { "-XX:G1NewSizePercent=30" },
+        { "-XX:G1MaxNewSizePercent=40" },
+        { "-XX:G1HeapRegionSize=8M" },
+        { "-XX:G1ReservePercent=20" },
+        { "-XX:G1HeapWastePercent=5" },
+        { "-XX:G1MixedGCCountTarget=4" },
+        { "-XX:InitiatingHeapOccupancyPercent=15" },
+        { "-XX:G1MixedGCLiveThresholdPercent=90" },
+        // gone with the rewrite of the remembered sets
+        { "-XX:G1RSetUpdatingPauseTimePercent=5", 0, 19 },
+        { "-XX:SurvivorRatio=32" },
+        { "-XX:+PerfDisableSharedMem" },
+        { "-XX:MaxTenuringThreshold=1" },
+    };
+    profiles.append(g1);
+
+    Profile zgc;
+    zgc.id = "zgc-generational";
+    zgc.revision = 1;
+    zgc.name = QT_TRANSLATE_NOOP("JvmProfiles", "Generational ZGC");
+    zgc.description = QT_TRANSLATE_NOOP("JvmProfiles", "Pauses of at most a millisecond, for a bit more CPU and memory. Needs Java 21 and a big heap.");
+    zgc.minJava = 21;
+    zgc.excludedVendors = s_not_hotspot;
+    zgc.needs64Bit = true;
+    zgc.minMemory = 4096;
+    zgc.arguments = {
+        { "-XX:+UseZGC" },
+        // generational is the only mode from Java 23 on, the flag is deprecated there
+        { "-XX:+ZGenerational", 0, 22 },
+        { "-XX:+AlwaysPreTouch" },
+        { "-XX:+DisableExplicitGC" },
+    };
+    profiles.append(zgc);
+
+    Profile shenandoah;
+    shenandoah.id = "shenandoah";
+    shenandoah.revision = 1;
+    shenandoah.name = QT_TRANSLATE_NOOP("JvmProfiles", "Shenandoah");
+    shenandoah.description = QT_TRANSLATE_NOOP("JvmProfiles", "Short pauses on smaller heaps. Not in the builds of Oracle.");
+    shenandoah.minJava = 11;
+    shenandoah.excludedVendors = s_not_hotspot + QStringList{ "Oracle" };
+    shenandoah.arguments = {
+        // experimental before Java 15
+        { "-XX:+UnlockExperimentalVMOptions", 0, 14 },
+        { "-XX:+UseShenandoahGC" },
+        { "-XX:+AlwaysPreTouch" },
+        { "-XX:+DisableExplicitGC" },
+        { "-XX:+ParallelRefProcEnabled" },
+    };
+    profiles.append(shenandoah);
+
+    Profile throughput;
+    throughput.id = "throughput";
+    throughput.revision = 1;
+    throughput.name = QT_TRANSLATE_NOOP("JvmProfiles", "Throughput");
+    throughput.description = QT_TRANSLATE_NOOP("JvmProfiles", "The parallel collector, the most work done for longer pauses. For servers and world generation.");
+    throughput.minJava = 8;
+    throughput.excludedVendors = s_not_hotspot;
+    throughput.arguments = {
+        { "-XX:+UseParallelGC" },
+        { "-XX:+DisableExplicitGC" },
+        { "-XX:+AlwaysPreTouch" },
+    };
+    profiles.append(throughput);
+
+    return profiles;
+}
+}  // namespace
+
+const QList<Profile>& all()
+{
+    static const QList<Profile> s_profiles = makeProfiles();
+    return s_profiles;
+}
+
+const Profile* find(const QString& id)
+{
+    for (auto const& profile : all()) {
+        if (profile.id == id)
+            return &profile;
+    }
+    return nullptr;
+}
+
+QString displayName(const Profile& profile)
+{
+    return QCoreApplication::translate("JvmProfiles", profile.name);
+}
+
+QString description(const Profile& profile)
+{
+    return QCoreApplication::translate("JvmProfiles", profile.description);
+}
+
+QString unusableReason(const Profile& profile, const Jvm& jvm)
+{
+    auto version = jvm.version;
+    auto major = version.major();
+    if (major == 0)
+        return QCoreApplication::translate("JvmProfiles", "the version of Java isn't known yet");
+    if (profile.minJava && major < profile.minJava)
+        return QCoreApplication::translate("JvmProfiles", "it needs Java %1 or newer").arg(profile.minJava);
+    if (profile.maxJava && major > profile.maxJava)
+        return QCoreApplication::translate("JvmProfiles", "it needs Java %1 or older").arg(profile.maxJava);
+
+    for (auto const& vendor : profile.excludedVendors) {
+        if (jvm.vendor.contains(vendor, Qt::CaseInsensitive))
+            return QCoreApplication::translate("JvmProfiles", "Java from %1 doesn't support it").arg(jvm.vendor);
+    }
+    if (profile.needs64Bit && jvm.architecture != "64")
+        return QCoreApplication::translate("JvmProfiles", "it needs a 64-bit Java");
+    if (jvm.maxMemory < profile.minMemory)
+        return QCoreApplication::translate("JvmProfiles", "it needs at least %1 MiB of maximum memory").arg(profile.minMemory);
+
+    // two collectors make the JVM refuse to start
+    for (auto const& argument : jvm.userArguments) {
+        if (argument.startsWith("-XX:+Use") && argument.endsWith("GC"))
+            return QCoreApplication::translate("JvmProfiles", "the Java arguments choose a collector already (%1)").arg(argument);
+    }
+    return {};
+}
+
+QStringList arguments(const Profile& profile, const Jvm& jvm)
+{
+    if (!unusableReason(profile, jvm).isEmpty())
+        return {};
+
+    auto version = jvm.version;
+    auto major = version.major();
+    QStringList out;
+    for (auto const& argument : profile.arguments) {
+        if (argument.minJava && major < argument.minJava)
+            continue;
+        if (argument.maxJava && major > argument.maxJava)
+            continue;
+        out << argument.value;
+    }
+    return out;
+}
+
+}  // namespace JvmProfiles
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "JavaVersion.h"
+
+/* Sets of JVM flags for the garbage collector and the heap, picked by name instead of being copied into every instance.
+ *
+ * Each profile says which Java versions, vendors and heap sizes it is meant for, and is checked against what the Java
+ * checker found out about the JVM the instance launches with. A profile that doesn't fit is left out of the launch, and
+ * flags that only exist in some of the versions a profile covers only go to those. The revision of a profile goes up
+ * whenever its flags change, so the launch log tells which ones an instance ran with.
+ */
+namespace JvmProfiles {
+
+struct Argument {
+    QString value;
+    // the Java versions the flag is given to, 0 when there is no bound
+    int minJava = 0;
+    int maxJava = 0;
+};
+
+struct Profile {
+    QString id;
+    int revision = 1;
+    // untranslated, see displayName()
+    const char* name = "";
+    const char* description = "";
+    int minJava = 0;
+    int maxJava = 0;
+    // vendors that don't ship the collector, matched as part of the vendor string
+    QStringList excludedVendors;
+    bool needs64Bit = false;
+    // in MiB, the maximum heap of the instance
+    int minMemory = 0;
+    QList<Argument> arguments;
+};
+
+/** What the Java checker found out about the JVM, and the heap it gets. */
+struct Jvm {
+    JavaVersion version;
+    QString vendor;
+    QString architecture;
+    int maxMemory = 0;
+    // the arguments the user gave, a collector chosen there wins over the profile
+    QStringList userArguments;
+};
+
+/** All the profiles, in the order they are offered. */
+const QList<Profile>& all();
+
+/** The profile with `id`, nullptr if there is none. */
+const Profile* find(const QString& id);
+
+QString displayName(const Profile& profile);
+QString description(const Profile& profile);
+
+/** Why `profile` can't be used with `jvm`, empty when it can. */
+QString unusableReason(const Profile& profile, const Jvm& jvm);
+
+/** The flags of `profile` for `jvm`, nothing when the profile can't be used with it. */
+QStringList arguments(const Profile& profile, const Jvm& jvm);
+
+}  // namespace JvmProfiles
@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ManagedRuntime.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QSysInfo>
+#include <QtConcurrent>
+
+#include "Application.h"
+#include "Executors.h"
+#include "FileSystem.h"
+#include "Json.h"
+#include "net/Download.h"
+
+namespace {
+const QString s_index_url =
+    "https://launchermeta.mojang.com/v1/products/java-runtime/2ec0cc96c44e5a76b9c8b7c39df7210883d12871/all.json";
+
+// what Mojang calls this OS and architecture in the runtime index
+QString platformName()
+{
+    auto arch = QSysInfo::currentCpuArchitecture();
+#if defined(Q_OS_WIN)
+    if (arch == "arm64")
+        return "windows-arm64";
+    return arch == "x86_64" ? "windows-x64" : "windows-x86";
+#elif defined(Q_OS_MACOS)
+    return arch == "arm64" ? "mac-os-arm64" : "mac-os";
+#elif defined(Q_OS_LINUX)
+    return arch == "x86_64" ? "linux" : "linux-i386";
+#else
+    return {};
+#endif
+}
+
+QString runtimesRoot()
+{
+    return QDir("java/runtimes").absolutePath();
+}
+
+QString indexPath(const QString& component)
+{
+    // next to the runtime, anything inside it would be taken as a file that doesn't belong there
+    return FS::PathCombine(runtimesRoot(), component + ".index.json");
+}
+
+void setExecutable(const QString& path, bool executable)
+{
+    auto permissions = QFile::permissions(path);
+    auto execute = QFileDevice::ExeOwner | QFileDevice::ExeUser | QFileDevice::ExeGroup | QFileDevice::ExeOther;
+    QFile::setPermissions(path, executable ? permissions | execute : permissions & ~execute);
+}
+}  // namespace
+
+namespace ManagedRuntime {
+
+QList<QPair<QString, QString>> knownComponents()
+{
+    return {
+        { "java-runtime-delta", "21" },
+        { "java-runtime-gamma", "17" },
+        { "java-runtime-beta", "17" },
+        { "java-runtime-alpha", "16" },
+        { "jre-legacy", "8" },
+    };
+}
+
+QString runtimePath(const QString& component)
+{
+    return FS::PathCombine(runtimesRoot(), component);
+}
+
+QString javaPath(const QString& component)
+{
+#if defined(Q_OS_WIN)
+    return FS::PathCombine(runtimePath(component), "bin", "javaw.exe");
+#elif defined(Q_OS_MACOS)
+    return FS::PathCombine(runtimePath(component), "jre.bundle", "Contents", "Home", "bin", "java");
+#else
+    return FS::PathCombine(runtimePath(component), "bin", "java");
+#endif
+}
+
+QStringList installedJavaPaths()
+{
+    QStringList paths;
+    for (auto& component : knownComponents()) {
+        auto path = javaPath(component.first);
+        if (QFileInfo::exists(path))
+            paths.append(path);
+    }
+    return paths;
+}
+
+QString componentOf(const QString& java_path)
+{
+    auto canonical = QFileInfo(java_path).canonicalFilePath();
+    if (canonical.isEmpty())
+        return {};
+    for (auto& component : knownComponents()) {
+        if (QFileInfo(javaPath(component.first)).canonicalFilePath() == canonical)
+            return component.first;
+    }
+    return {};
+}
+
+}  // namespace ManagedRuntime
+
+ManagedRuntimeTask::ManagedRuntimeTask(QString component, bool rehash) : Task(), m_component(component), m_rehash(rehash) {}
+
+void ManagedRuntimeTask::executeTask()
+{
+    if (platformName().isEmpty()) {
+        emitFailed(tr("Mojang doesn't provide Java runtimes for this system."));
+        return;
+    }
+
+    setStatus(tr("Looking for the %1 runtime...").arg(m_component));
+    m_job = makeShared<NetJob>("Java runtime index", APPLICATION->network());
+    m_job->addNetAction(Net::Download::makeByteArray(s_index_url, m_response.get()));
+    connect(m_job.get(), &NetJob::succeeded, this, &ManagedRuntimeTask::indexDownloaded);
+    connect(m_job.get(), &NetJob::failed, this, &ManagedRuntimeTask::emitFailed);
+    connect(m_job.get(), &NetJob::aborted, this, &ManagedRuntimeTask::emitAborted);
+    m_job->start();
+}
+
+void ManagedRuntimeTask::indexDownloaded()
+{
+    QString manifest_url;
+    QString version;
+    try {
+        auto root = Json::requireObject(Json::requireDocument(*m_response, "Java runtime index"), "Java runtime index");
+        auto platform = Json::requireObject(root, platformName());
+        auto releases = Json::ensureArray(platform, m_component);
+        if (releases.isEmpty()) {
+            emitFailed(tr("There is no %1 runtime for this system.").arg(m_component));
+            return;
+        }
+        auto release = Json::requireObject(releases.first());
+        manifest_url = Json::requireString(Json::requireObject(release, "manifest"), "url");
+        version = Json::ensureString(Json::ensureObject(release, "version"), "name", "?");
+    } catch (const Exception& e) {
+        emitFailed(tr("Couldn't read the Java runtime index: %1").arg(e.cause()));
+        return;
+    }
+
+    setStatus(tr("Getting the file list of Java %1...").arg(version));
+    m_response->clear();
+    m_job = makeShared<NetJob>("Java runtime manifest", APPLICATION->network());
+    m_job->addNetAction(Net::Download::makeByteArray(manifest_url, m_response.get()));
+    connect(m_job.get(), &NetJob::succeeded, this, &ManagedRuntimeTask::manifestDownloaded);
+    connect(m_job.get(), &NetJob::failed, this, &ManagedRuntimeTask::emitFailed);
+    connect(m_job.get(), &NetJob::aborted, this, &ManagedRuntimeTask::emitAborted);
+    m_job->start();
+}
+
+void ManagedRuntimeTask::manifestDownloaded()
+{
+    m_package = mojang_files::Package::fromManifestContents(*m_response);
+    m_response->clear();
+    if (!m_package) {
+        emitFailed(tr("The file list of the %1 runtime is invalid.").arg(m_component));
+        return;
+    }
+
+    setStatus(tr("Checking the installed files..."));
+    auto path = ManagedRuntime::runtimePath(m_component);
+    auto index_path = indexPath(m_component);
+    auto package = m_package;
+    auto rehash = m_rehash;
+    auto future = QtConcurrent::run(Executors::io(), [path, index_path, package, rehash] {
+        auto index = mojang_files::HashIndex::load(index_path);
+        auto installed = mojang_files::Package::fromInspectedFolder(path, rehash ? nullptr : &index);
+        auto operations = mojang_files::UpdateOperations::resolve(installed, package);
+        if (!operations.valid)
+            return operations;
+
+        // make room for what's going to be downloaded
+        for (auto& file : operations.deletes)
+            QFile::remove(FS::PathCombine(path, file.toString()));
+        for (auto& folder : operations.rmdirs)
+            QDir(path).rmdir(folder.toString());
+        for (auto& folder : operations.mkdirs)
+            FS::ensureFolderPathExists(FS::PathCombine(path, folder.toString()));
+        return operations;
+    });
+
+    auto watcher = new QFutureWatcher<mojang_files::UpdateOperations>(this);
+    connect(watcher, &QFutureWatcher<mojang_files::UpdateOperations>::finished, this, [this, watcher] {
+        auto operations = watcher->result();
+        watcher->deleteLater();
+        if (isRunning())
+            operationsResolved(operations);
+    });
+    watcher->setFuture(future);
+}
+
+void ManagedRuntimeTask::operationsResolved(const mojang_files::UpdateOperations& operations)
+{
+    if (!operations.valid) {
+        emitFailed(tr("Couldn't check the installed files of the %1 runtime.").arg(m_component));
+        return;
+    }
+    m_operations = operations;
+
+    auto path = ManagedRuntime::runtimePath(m_component);
+    m_job = makeShared<NetJob>("Java runtime files", APPLICATION->network());
+    for (auto& download : m_operations.downloads) {
+        auto source = static_cast<const mojang_files::FileSource&>(download.second);
+        if (source.compression != mojang_files::Compression::Raw) {
+            // the raw file is always there, and there's nothing here to decompress the others
+            auto raw = m_package.rawSources.find(source.hash);
+            if (raw == m_package.rawSources.end()) {
+                emitFailed(tr("There is no uncompressed download for %1.").arg(download.first.toString()));
+                return;
+            }
+            source = raw->second;
+        }
+        // the manifest tells the size, so only the big ones (the modules file) pay for the probe of a segmented download
+        auto options = static_cast<qint64>(source.size) >= Net::Download::s_segment_threshold ? Net::Download::Option::Segmented
+                                                                                              : Net::Download::Option::NoOptions;
+        m_job->addNetAction(
+            Net::Download::makeStored(source.url, FS::PathCombine(path, download.first.toString()), "sha1", source.hash, options));
+    }
+
+    setStatus(tr("Downloading %n file(s)...", nullptr, static_cast<int>(m_operations.downloads.size())));
+    connect(m_job.get(), &NetJob::succeeded, this, &ManagedRuntimeTask::filesDownloaded);
+    connect(m_job.get(), &NetJob::failed, this, &ManagedRuntimeTask::emitFailed);
+    connect(m_job.get(), &NetJob::aborted, this, &ManagedRuntimeTask::emitAborted);
+    connect(m_job.get(), &NetJob::progress, this, &ManagedRuntimeTask::setProgress);
+    connect(m_job.get(), &NetJob::stepProgress, this, &ManagedRuntimeTask::propogateStepProgress);
+    m_job->start();
+}
+
+void ManagedRuntimeTask::filesDownloaded()
+{
+    setStatus(tr("Verifying the installed files..."));
+    auto path = ManagedRuntime::runtimePath(m_component);
+    auto index_path = indexPath(m_component);
+    auto package = m_package;
+    auto operations = m_operations;
+    auto future = QtConcurrent::run(Executors::io(), [path, index_path, package, operations] {
+        for (auto& download : operations.downloads)
+            setExecutable(FS::PathCombine(path, download.first.toString()), download.second.executable);
+        for (auto& fix : operations.executable_fixes)
+            setExecutable(FS::PathCombine(path, fix.first.toString()), fix.second);
+        for (auto& link : operations.mklinks) {
+            auto link_path = FS::PathCombine(path, link.first.toString());
+            QFile::remove(link_path);
+            QFile::link(link.second.toString(), link_path);
+        }
+
+        // only the files that were just downloaded get hashed here, the rest is in the index
+        auto index = mojang_files::HashIndex::load(index_path);
+        auto installed = mojang_files::Package::fromInspectedFolder(path, &index);
+        auto remaining = mojang_files::UpdateOperations::resolve(installed, package);
+        if (!remaining.valid || !remaining.downloads.empty())
+            return false;
+        index.save(index_path);
+        return true;
+    });
+
+    auto watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher] {
+        auto verified = watcher->result();
+        watcher->deleteLater();
+        if (!isRunning())
+            return;
+        if (!verified) {
+            emitFailed(tr("The files of the %1 runtime don't match what they should be.").arg(m_component));
+            return;
+        }
+        emitSucceeded();
+    });
+    watcher->setFuture(future);
+}
+
+bool ManagedRuntimeTask::abort()
+{
+    if (m_job && m_job->isRunning())
+        return m_job->abort();
+    if (isRunning())
+        emitAborted();
+    return true;
+}
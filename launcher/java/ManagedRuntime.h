@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QList>
+#include <QPair>
+#include <QStringList>
+
+#include "mojang/PackageManifest.h"
+#include "net/NetJob.h"
+#include "tasks/Task.h"
+
+/* Java runtimes downloaded from Mojang, by component ("java-runtime-gamma", "jre-legacy", ...).
+ *
+ * Each component has its own folder under java/runtimes. Installing one that is already there goes through
+ * the package diff, so only the files that changed since are downloaded. The files go through the shared
+ * content store when it's enabled, and the runtimes that have files in common only keep them once.
+ */
+namespace ManagedRuntime {
+
+/** The components Mojang has runtimes for, and the Java version in them. */
+QList<QPair<QString, QString>> knownComponents();
+
+/** The folder the runtime of `component` is installed in. */
+QString runtimePath(const QString& component);
+
+/** The Java binary of the runtime of `component`. */
+QString javaPath(const QString& component);
+
+/** The Java binaries of all the installed runtimes. */
+QStringList installedJavaPaths();
+
+/** The component `java_path` is the Java binary of the runtime of, empty when it isn't one of them. */
+QString componentOf(const QString& java_path);
+
+}  // namespace ManagedRuntime
+
+class ManagedRuntimeTask : public Task {
+    Q_OBJECT
+   public:
+    /** With `rehash`, the installed files are all hashed again instead of trusting the hashes from the last time,
+     * so the ones damaged since are found and downloaded again. */
+    explicit ManagedRuntimeTask(QString component, bool rehash = false);
+
+    /** The Java binary of the runtime, once the task succeeded. */
+    QString javaPath() const { return ManagedRuntime::javaPath(m_component); }
+    /** How many files had to be downloaded, once the task succeeded. */
+    int downloadedFiles() const { return static_cast<int>(m_operations.downloads.size()); }
+
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    void indexDownloaded();
+    void manifestDownloaded();
+    void operationsResolved(const mojang_files::UpdateOperations& operations);
+    void filesDownloaded();
+
+   private:
+    QString m_component;
+    bool m_rehash = false;
+    NetJob::Ptr m_job;
+    std::shared_ptr<QByteArray> m_response = std::make_shared<QByteArray>();
+    mojang_files::Package m_package;
+    mojang_files::UpdateOperations m_operations;
+};
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ArgumentTemplate.h"
+
+namespace {
+bool isNameChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == '_';
+}
+}  // namespace
+
+ArgumentTemplate::ArgumentTemplate(const QString& text, Syntax syntax) : m_syntax(syntax)
+{
+    // the text between the variables, including the $ that don't start one, is a single part
+    int literal_start = 0;
+    auto addLiteral = [this, &text, &literal_start](int end) {
+        if (end > literal_start) {
+            m_literal_size += end - literal_start;
+            m_parts.append({ text.mid(literal_start, end - literal_start), false });
+        }
+    };
+
+    int i = text.indexOf('$');
+    while (i >= 0) {
+        int start = i + 1;
+        int end = start;
+        if (m_syntax == Syntax::Braced) {
+            // ${name}, up to the first }
+            auto close = text.indexOf('}', start);
+            if (start < text.size() && text.at(start) == '{' && close > start + 1) {
+                start++;
+                end = close;
+            }
+        } else {
+            while (end < text.size() && isNameChar(text.at(end)))
+                end++;
+        }
+
+        if (end > start) {
+            addLiteral(i);
+            m_parts.append({ text.mid(start, end - start), true });
+            literal_start = m_syntax == Syntax::Braced ? end + 1 : end;
+        }
+        i = text.indexOf('$', qMax(end, i + 1));
+    }
+    addLiteral(text.size());
+}
+
+QList<ArgumentTemplate> ArgumentTemplate::parseArguments(const QString& text)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    auto arguments = text.split(' ', Qt::SkipEmptyParts);
+#else
+    auto arguments = text.split(' ', QString::SkipEmptyParts);
+#endif
+    QList<ArgumentTemplate> templates;
+    templates.reserve(arguments.size());
+    for (auto& argument : arguments)
+        templates.append(ArgumentTemplate(argument));
+    return templates;
+}
+
+QString ArgumentTemplate::render(const Variables& variables) const
+{
+    // nothing to put together
+    if (m_parts.size() == 1 && !m_parts.first().variable)
+        return m_parts.first().text;
+
+    QString result;
+    result.reserve(m_literal_size);
+    for (auto& part : m_parts)
+        result += part.variable ? lookup(part.text, variables) : part.text;
+    return result;
+}
+
+QStringList ArgumentTemplate::render(const QList<ArgumentTemplate>& templates, const Variables& variables)
+{
+    QStringList rendered;
+    rendered.reserve(templates.size());
+    for (auto& argument : templates)
+        rendered.append(argument.render(variables));
+    return rendered;
+}
+
+QStringList ArgumentTemplate::variables() const
+{
+    QStringList names;
+    for (auto& part : m_parts) {
+        if (part.variable)
+            names.append(part.text);
+    }
+    return names;
+}
+
+QString ArgumentTemplate::lookup(const QString& name, const Variables& variables) const
+{
+    auto it = variables.constFind(name);
+    if (it != variables.constEnd())
+        return *it;
+    if (m_syntax == Syntax::Braced)
+        return {};
+
+    // $INST_DIRECTORY is $INST_DIR and "ECTORY", as it always was
+    for (int length = name.size() - 1; length > 0; length--) {
+        it = variables.constFind(name.left(length));
+        if (it != variables.constEnd())
+            return *it + name.mid(length);
+    }
+    return '$' + name;
+}
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/* An argument with variables in it, parsed once so it can be rendered any number of times.
+ *
+ * Braced is Minecraft's syntax, `${auth_player_name}`, where a variable that isn't known becomes nothing. Shell is
+ * the one of the custom commands, `$INST_DIR`, where a variable that isn't known is left as it is. That one also
+ * takes the longest known variable the name starts with, like the replacing it was done with before did.
+ *
+ * Rendering is a single pass over the parts, so what a variable is replaced with is never looked at for variables.
+ */
+class ArgumentTemplate {
+   public:
+    using Variables = QHash<QString, QString>;
+    enum class Syntax { Braced, Shell };
+
+    ArgumentTemplate() = default;
+    explicit ArgumentTemplate(const QString& text, Syntax syntax = Syntax::Braced);
+
+    /** Splits `text` on spaces, like Minecraft's arguments are, and parses each argument. */
+    static QList<ArgumentTemplate> parseArguments(const QString& text);
+
+    QString render(const Variables& variables) const;
+    static QStringList render(const QList<ArgumentTemplate>& templates, const Variables& variables);
+
+    /** The names of the variables in it, in order. */
+    QStringList variables() const;
+
+   private:
+    struct Part {
+        QString text;
+        bool variable = false;
+    };
+
+    QString lookup(const QString& name, const Variables& variables) const;
+
+   private:
+    Syntax m_syntax = Syntax::Braced;
+    QList<Part> m_parts;
+    // for reserving what the result takes, without the variables
+    int m_literal_size = 0;
+};
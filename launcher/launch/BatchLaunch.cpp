@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "BatchLaunch.h"
+
+#include <QDebug>
+
+#include "java/JavaUtils.h"
+#include "launch/LaunchTask.h"
+#include "launch/steps/CheckJava.h"
+#include "minecraft/BulkUpdateTask.h"
+#include "minecraft/MinecraftInstance.h"
+
+BatchLaunch::BatchLaunch(QList<InstancePtr> instances, Starter starter, QObject* parent)
+    : Task(parent), m_instances(std::move(instances)), m_starter(std::move(starter))
+{
+    m_delayTimer.setSingleShot(true);
+    connect(&m_delayTimer, &QTimer::timeout, this, &BatchLaunch::moveOn);
+}
+
+void BatchLaunch::executeTask()
+{
+    qDebug() << "Launching" << m_instances.size() << "instances together";
+    if (m_online)
+        update();
+    else
+        checkJava();
+}
+
+bool BatchLaunch::abort()
+{
+    if (!isRunning())
+        return true;
+    m_aborted = true;
+    m_delayTimer.stop();
+    for (auto& wait : m_waits)
+        disconnect(wait);
+    m_waits.clear();
+    if (m_update && m_update->isRunning())
+        m_update->abort();
+    // the games that were started already keep running
+    emitAborted();
+    return true;
+}
+
+void BatchLaunch::update()
+{
+    setStatus(tr("Downloading what the instances need..."));
+    m_update = makeShared<BulkUpdateTask>(m_instances);
+    connect(m_update.get(), &Task::progress, this, &Task::setProgress);
+    connect(m_update.get(), &Task::stepProgress, this, &BatchLaunch::propogateStepProgress);
+    connect(m_update.get(), &Task::details, this, &Task::setDetails);
+    connect(m_update.get(), &Task::finished, this, [this] {
+        if (m_aborted)
+            return;
+        if (m_update->wasSuccessful()) {
+            for (auto& instance : m_instances) {
+                if (auto minecraft = std::dynamic_pointer_cast<MinecraftInstance>(instance))
+                    minecraft->setUpdatedForLaunch();
+            }
+        } else {
+            // the launches update what couldn't be updated here on their own, and tell what's wrong with it
+            qWarning() << "Couldn't update the instances together:" << m_update->failReason();
+        }
+        m_update.reset();
+        checkJava();
+    });
+    m_update->start();
+}
+
+void BatchLaunch::checkJava()
+{
+    // the launches say what's missing
+    if (JavaUtils::getJavaCheckPath().isEmpty()) {
+        launchNext();
+        return;
+    }
+    for (auto& instance : m_instances) {
+        auto settings = instance->settings();
+        auto binary = CheckJava::javaBinary(settings);
+        // the launch tells what's wrong with a Java that can't be found
+        if (binary.isEmpty() || CheckJava::isKnown(settings, binary))
+            continue;
+        m_javaUsers[binary].append(instance);
+    }
+    if (m_javaUsers.isEmpty()) {
+        launchNext();
+        return;
+    }
+
+    setStatus(tr("Checking the Java installations..."));
+    for (auto& binary : m_javaUsers.keys()) {
+        // a plain check, the cache of the checks can answer it
+        JavaCheckerPtr checker(new JavaChecker);
+        checker->m_path = binary;
+        connect(checker.get(), &JavaChecker::checkFinished, this, [this, binary](JavaCheckResult result) { javaChecked(binary, result); });
+        m_javaCheckers.insert(binary, checker);
+        checker->performCheck();
+    }
+}
+
+void BatchLaunch::javaChecked(const QString& binary, const JavaCheckResult& result)
+{
+    if (m_aborted)
+        return;
+    // what isn't valid is checked again and reported by the launches themselves
+    if (result.validity == JavaCheckResult::Validity::Valid) {
+        for (auto& instance : m_javaUsers.value(binary))
+            CheckJava::remember(instance->settings(), binary, result);
+    }
+    m_javaUsers.remove(binary);
+    m_javaCheckers.remove(binary);
+    if (m_javaUsers.isEmpty())
+        launchNext();
+}
+
+void BatchLaunch::launchNext()
+{
+    if (m_aborted)
+        return;
+    setProgress(m_next, m_instances.size());
+    if (m_next >= m_instances.size()) {
+        if (m_failed.isEmpty())
+            emitSucceeded();
+        else
+            emitFailed(tr("Couldn't launch %1.").arg(m_failed.join(", ")));
+        return;
+    }
+
+    auto instance = m_instances.at(m_next++);
+    setStatus(tr("Launching %1...").arg(instance->name()));
+    if (instance->isRunning() || !m_starter(instance)) {
+        if (!instance->isRunning())
+            m_failed.append(instance->name());
+        launchNext();
+        return;
+    }
+    // nothing to wait for after the last one
+    if (m_next >= m_instances.size()) {
+        launchNext();
+        return;
+    }
+    if (m_waitForWindow)
+        waitForWindow(instance);
+    m_delayTimer.start(m_delay);
+}
+
+void BatchLaunch::waitForWindow(const InstancePtr& instance)
+{
+    auto watch = [this](shared_qobject_ptr<LaunchTask> task) {
+        if (!task)
+            return;
+        m_waits.append(connect(task.get(), &LaunchTask::windowOpened, this, &BatchLaunch::moveOn));
+        // a game that doesn't get that far doesn't hold up the others
+        m_waits.append(connect(task.get(), &Task::finished, this, &BatchLaunch::moveOn));
+    };
+    // the launch task is there once the account is logged in, which may have happened already
+    if (auto task = instance->getLaunchTask())
+        watch(task);
+    else
+        m_waits.append(connect(instance.get(), &BaseInstance::launchTaskChanged, this, watch));
+}
+
+void BatchLaunch::moveOn()
+{
+    m_delayTimer.stop();
+    for (auto& wait : m_waits)
+        disconnect(wait);
+    m_waits.clear();
+    launchNext();
+}
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMetaObject>
+#include <QStringList>
+#include <QTimer>
+
+#include <functional>
+
+#include "BaseInstance.h"
+#include "java/JavaChecker.h"
+#include "tasks/Task.h"
+
+/* Launches several instances, doing the work they share once and starting their games one after the other.
+ *
+ * Launched on their own, each instance would update itself, check its Java and start its game at the same moment
+ * as the others, fighting over the disk and the CPU. Instead, everything the instances need is downloaded first by a
+ * single BulkUpdateTask, so their launches only check their files, and each Java binary they use is checked once.
+ * The games are then started one at a time, the next one a delay after the one before, or as soon as the one before
+ * opened its window when waiting for that.
+ *
+ * The task is done once every game was started, it doesn't wait for them to exit.
+ */
+class BatchLaunch : public Task {
+    Q_OBJECT
+   public:
+    /** Starts the launch of an instance, returns whether it did. */
+    using Starter = std::function<bool(InstancePtr)>;
+
+    BatchLaunch(QList<InstancePtr> instances, Starter starter, QObject* parent = nullptr);
+    ~BatchLaunch() override = default;
+
+    /** Offline, nothing is downloaded first. */
+    void setOnline(bool online) { m_online = online; }
+    /** Between two starts, in milliseconds, the longest wait when waiting for the window. */
+    void setDelay(int msec) { m_delay = msec; }
+    void setWaitForWindow(bool wait) { m_waitForWindow = wait; }
+
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    void update();
+    void checkJava();
+    void javaChecked(const QString& binary, const JavaCheckResult& result);
+    void launchNext();
+    void waitForWindow(const InstancePtr& instance);
+    void moveOn();
+
+   private:
+    QList<InstancePtr> m_instances;
+    Starter m_starter;
+    bool m_online = true;
+    int m_delay = 20000;
+    bool m_waitForWindow = true;
+
+    Task::Ptr m_update;
+    // the instances using each Java binary that wasn't checked yet
+    QHash<QString, QList<InstancePtr>> m_javaUsers;
+    QHash<QString, JavaCheckerPtr> m_javaCheckers;
+
+    int m_next = 0;
+    QTimer m_delayTimer;
+    QList<QMetaObject::Connection> m_waits;
+    QStringList m_failed;
+    bool m_aborted = false;
+};
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "LaunchHistory.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+#include <algorithm>
+
+#include "FileSystem.h"
+
+namespace LaunchHistory {
+
+QJsonObject Record::toJson() const
+{
+    QJsonObject object;
+    object["started"] = started.toString(Qt::ISODate);
+    object["spawnTime"] = spawnTime;
+    object["windowTime"] = windowTime;
+    object["javaVersion"] = javaVersion;
+    object["javaArguments"] = QJsonArray::fromStringList(javaArguments);
+    object["mods"] = mods;
+    object["exitCode"] = exitCode;
+    object["crashed"] = crashed;
+    object["telemetry"] = telemetry.toJson();
+    return object;
+}
+
+Record Record::fromJson(const QJsonObject& object)
+{
+    Record record;
+    record.started = QDateTime::fromString(object["started"].toString(), Qt::ISODate);
+    record.spawnTime = static_cast<qint64>(object["spawnTime"].toDouble(-1));
+    record.windowTime = static_cast<qint64>(object["windowTime"].toDouble(-1));
+    record.javaVersion = object["javaVersion"].toString();
+    for (auto argument : object["javaArguments"].toArray())
+        record.javaArguments.append(argument.toString());
+    record.mods = object["mods"].toInt();
+    record.exitCode = object["exitCode"].toInt(-1);
+    record.crashed = object["crashed"].toBool();
+    record.telemetry = LaunchTelemetry::Summary::fromJson(object["telemetry"].toObject());
+    return record;
+}
+
+QString file(const QString& instanceRoot)
+{
+    return FS::PathCombine(instanceRoot, "launches.jsonl");
+}
+
+void append(const QString& file, const Record& record, int keep)
+{
+    QList<QByteArray> lines;
+    QFile in(file);
+    if (in.open(QFile::ReadOnly)) {
+        for (auto& line : in.readAll().split('\n')) {
+            if (!line.trimmed().isEmpty())
+                lines.append(line);
+        }
+        in.close();
+    }
+    lines.append(QJsonDocument(record.toJson()).toJson(QJsonDocument::Compact));
+    while (lines.size() > keep)
+        lines.removeFirst();
+
+    QSaveFile out(file);
+    if (!FS::ensureFilePathExists(file) || !out.open(QFile::WriteOnly)) {
+        qWarning() << "Could not write the launch history to" << file << ":" << out.errorString();
+        return;
+    }
+    for (auto& line : lines) {
+        out.write(line);
+        out.write("\n");
+    }
+    if (!out.commit())
+        qWarning() << "Could not write the launch history to" << file << ":" << out.errorString();
+}
+
+QList<Record> load(const QString& file)
+{
+    QList<Record> records;
+    QFile in(file);
+    if (!in.open(QFile::ReadOnly))
+        return records;
+
+    for (auto& line : in.readAll().split('\n')) {
+        auto document = QJsonDocument::fromJson(line);
+        if (document.isObject())
+            records.append(Record::fromJson(document.object()));
+    }
+    return records;
+}
+
+double change(const QList<Record>& records, const std::function<qint64(const Record&)>& value, int window)
+{
+    if (records.isEmpty())
+        return 0;
+    auto last = value(records.last());
+    if (last <= 0)
+        return 0;
+
+    QList<qint64> before;
+    for (int i = records.size() - 2; i >= 0 && before.size() < window; i--) {
+        auto earlier = value(records[i]);
+        if (earlier > 0)
+            before.append(earlier);
+    }
+    if (before.size() < 2)
+        return 0;
+
+    // the median, so a single launch that happened to be slow doesn't count much
+    std::sort(before.begin(), before.end());
+    auto middle = before.size() / 2;
+    double median = before.size() % 2 ? before[middle] : (before[middle - 1] + before[middle]) / 2.0;
+    return last / median - 1;
+}
+
+}  // namespace LaunchHistory
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <functional>
+
+#include <QDateTime>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "LaunchTelemetry.h"
+
+/* The launches of an instance and how they went, so a slower startup or a bigger heap after an update shows.
+ *
+ * A launch task fills in its record while it runs. Once it's done, the record is added to a file in the instance
+ * folder, with one JSON object per line, which keeps only the most recent launches.
+ */
+namespace LaunchHistory {
+
+struct Record {
+    QDateTime started;
+    // ms from the start of the launch until the JVM was there and until the game opened its window, -1 when it didn't
+    qint64 spawnTime = -1;
+    qint64 windowTime = -1;
+    QString javaVersion;
+    QStringList javaArguments;
+    int mods = 0;
+    // -1 when the game didn't exit by itself
+    int exitCode = -1;
+    bool crashed = false;
+    // what the launcher part told, empty when it didn't
+    LaunchTelemetry::Summary telemetry;
+
+    QJsonObject toJson() const;
+    static Record fromJson(const QJsonObject& object);
+};
+
+/** The history file of the instance at `instanceRoot`. */
+QString file(const QString& instanceRoot);
+
+/** Adds `record` to the history in `file`, keeping the last `keep` launches. */
+void append(const QString& file, const Record& record, int keep = 100);
+
+/** The launches in `file`, the oldest first. */
+QList<Record> load(const QString& file);
+
+/**
+ * How much `value` of the last launch differs from the median of the `window` launches before it, as a fraction (0.3 is
+ * 30% more). Values of 0 or less aren't known, and it's 0 when the last launch or two of the ones before don't have it.
+ */
+double change(const QList<Record>& records, const std::function<qint64(const Record&)>& value, int window = 5);
+
+}  // namespace LaunchHistory
@@ -36,9 +36,11 @@
  */
 
 #include "launch/LaunchTask.h"
+#include "launch/ArgumentTemplate.h"
 #include "MessageLevel.h"
 #include "java/JavaChecker.h"
 #include "tasks/Task.h"
+#include "tasks/TaskTrace.h"
 #include <QDebug>
 #include <QDir>
 #include <QEventLoop>
@@ -47,6 +49,8 @@
 #include <QStandardPaths>
 #include <assert.h>
 
+#include <algorithm>
+
 void LaunchTask::init()
 {
     m_instance->setRunning(true);
@@ -61,61 +65,131 @@ shared_qobject_ptr<LaunchTask> LaunchTask::create(InstancePtr inst)
 
 LaunchTask::LaunchTask(InstancePtr instance): m_instance(instance)
 {
+    connect(this, &Task::finished, this, [this]()
+    {
+        auto trace = TaskTrace::save(*this, "launch-" + m_instance->id());
+        if(!trace.isEmpty())
+        {
+            qDebug() << "Saved the trace of the launch to" << trace;
+        }
+    });
 }
 
 void LaunchTask::appendStep(shared_qobject_ptr<LaunchStep> step)
+{
+    appendStep(step, m_steps);
+}
+
+void LaunchTask::appendStep(shared_qobject_ptr<LaunchStep> step, const QList<shared_qobject_ptr<LaunchStep>>& dependencies)
 {
     m_steps.append(step);
+    auto& stepDependencies = m_dependencies[step.get()];
+    for(auto& dependency : dependencies)
+    {
+        stepDependencies.append(dependency.get());
+    }
 }
 
 void LaunchTask::prependStep(shared_qobject_ptr<LaunchStep> step)
 {
+    for(auto& other : m_steps)
+    {
+        m_dependencies[other.get()].append(step.get());
+    }
     m_steps.prepend(step);
 }
 
 void LaunchTask::executeTask()
 {
     m_instance->setCrashed(false);
+    m_record.started = QDateTime::currentDateTime();
     if(!m_steps.size())
     {
         state = LaunchTask::Finished;
         emitSucceeded();
+        return;
     }
     state = LaunchTask::Running;
-    onStepFinished();
+    startReadySteps();
 }
 
 void LaunchTask::onReadyForLaunch()
 {
+    m_waitingStep = qobject_cast<LaunchStep*>(sender());
     state = LaunchTask::Waiting;
     emit readyForLaunch();
 }
 
-void LaunchTask::onStepFinished()
+bool LaunchTask::dependenciesDone(LaunchStep* step) const
 {
-    // initial -> just start the first step
-    if(currentStep == -1)
+    for(auto dependency : m_dependencies.value(step))
     {
-        currentStep ++;
-        m_steps[currentStep]->start();
-        return;
+        if(!dependency->wasSuccessful())
+        {
+            return false;
+        }
     }
+    return true;
+}
 
-    auto step = m_steps[currentStep];
-    if(step->wasSuccessful())
+void LaunchTask::startReadySteps()
+{
+    // A lot of steps are done as soon as they're started, so this gets called again from inside step->start().
+    // The outer call picks up whatever they unblocked instead.
+    if(m_startingSteps)
     {
-        // end?
-        if(currentStep == m_steps.size() - 1)
+        return;
+    }
+    m_startingSteps = true;
+    bool startedAny = true;
+    while(startedAny && !m_finalized)
+    {
+        startedAny = false;
+        for(auto& step : m_steps)
         {
-            finalizeSteps(true, QString());
+            if(m_finalized)
+            {
+                break;
+            }
+            if(step->getState() != Task::State::Inactive || !dependenciesDone(step.get()))
+            {
+                continue;
+            }
+            m_startedSteps.append(step.get());
+            step->start();
+            startedAny = true;
         }
-        else
+    }
+    m_startingSteps = false;
+
+    if(m_finalized)
+    {
+        return;
+    }
+    for(auto& step : m_steps)
+    {
+        if(!step->wasSuccessful())
         {
-            currentStep ++;
-            step = m_steps[currentStep];
-            step->start();
+            return;
         }
     }
+    finalizeSteps(true, QString());
+}
+
+void LaunchTask::onStepFinished()
+{
+    auto step = qobject_cast<LaunchStep*>(sender());
+    if(!step || m_finalized)
+    {
+        return;
+    }
+    qDebug() << "Launch step" << step->metaObject()->className() << "finished after" << step->duration() << "ms";
+    onLogLine(QString("%1 took %2 ms").arg(step->metaObject()->className()).arg(step->duration()), MessageLevel::Launcher);
+
+    if(step->wasSuccessful())
+    {
+        startReadySteps();
+    }
     else
     {
         finalizeSteps(false, step->failReason());
@@ -124,9 +198,21 @@ void LaunchTask::onStepFinished()
 
 void LaunchTask::finalizeSteps(bool successful, const QString& error)
 {
-    for(auto step = currentStep; step >= 0; step--)
+    m_finalized = true;
+    if(!successful)
+    {
+        // nothing else is going to get to run, so stop what runs alongside the failed step
+        for(auto& step : m_steps)
+        {
+            if(step->isRunning() && step->canAbort())
+            {
+                step->abort();
+            }
+        }
+    }
+    for(auto step = m_startedSteps.size() - 1; step >= 0; step--)
     {
-        m_steps[step]->finalize();
+        m_startedSteps[step]->finalize();
     }
     if(successful)
     {
@@ -140,33 +226,62 @@ void LaunchTask::finalizeSteps(bool successful, const QString& error)
 
 void LaunchTask::onProgressReportingRequested()
 {
+    auto step = qobject_cast<LaunchStep*>(sender());
+    if(!step)
+    {
+        return;
+    }
+    m_waitingStep = step;
     state = LaunchTask::Waiting;
-    emit requestProgress(m_steps[currentStep].get());
+    emit requestProgress(step);
 }
 
 void LaunchTask::setCensorFilter(QMap<QString, QString> filter)
 {
     m_censorFilter = filter;
+
+    QStringList keys;
+    for (auto iter = m_censorFilter.cbegin(); iter != m_censorFilter.cend(); iter++)
+    {
+        if (!iter.key().isEmpty())
+            keys.append(QRegularExpression::escape(iter.key()));
+    }
+    // prefer the longest match when a key is a part of another one
+    std::sort(keys.begin(), keys.end(), [](const QString& a, const QString& b) { return a.size() > b.size(); });
+    m_censorPattern = keys.isEmpty() ? QRegularExpression() : QRegularExpression(keys.join('|'));
+    m_censorPattern.optimize();
 }
 
 QString LaunchTask::censorPrivateInfo(QString in)
 {
-    auto iter = m_censorFilter.begin();
-    while (iter != m_censorFilter.end())
+    if (m_censorPattern.pattern().isEmpty())
+        return in;
+
+    auto matches = m_censorPattern.globalMatch(in);
+    if (!matches.hasNext())
+        return in;
+
+    QString out;
+    out.reserve(in.size());
+    int last = 0;
+    while (matches.hasNext())
     {
-        in.replace(iter.key(), iter.value());
-        iter++;
+        auto match = matches.next();
+        out.append(in.mid(last, match.capturedStart() - last));
+        out.append(m_censorFilter.value(match.captured()));
+        last = match.capturedEnd();
     }
-    return in;
+    out.append(in.mid(last));
+    return out;
 }
 
 void LaunchTask::proceed()
 {
-    if(state != LaunchTask::Waiting)
+    if(state != LaunchTask::Waiting || !m_waitingStep)
     {
         return;
     }
-    m_steps[currentStep]->proceed();
+    m_waitingStep->proceed();
 }
 
 bool LaunchTask::canAbort() const
@@ -182,8 +297,14 @@ bool LaunchTask::canAbort() const
         case LaunchTask::Running:
         case LaunchTask::Waiting:
         {
-            auto step = m_steps[currentStep];
-            return step->canAbort();
+            for(auto& step : m_steps)
+            {
+                if(step->isRunning() && !step->canAbort())
+                {
+                    return false;
+                }
+            }
+            return true;
         }
     }
     return false;
@@ -206,15 +327,18 @@ bool LaunchTask::abort()
         case LaunchTask::Running:
         case LaunchTask::Waiting:
         {
-            auto step = m_steps[currentStep];
-            if(!step->canAbort())
+            if(!canAbort())
             {
                 return false;
             }
-            if(step->abort())
+            // the first step to go down takes the others with it
+            for(auto& step : m_steps)
             {
-                state = LaunchTask::Aborted;
-                return true;
+                if(step->isRunning() && step->abort())
+                {
+                    state = LaunchTask::Aborted;
+                    return true;
+                }
             }
         }
         default:
@@ -238,65 +362,138 @@ shared_qobject_ptr<LogModel> LaunchTask::getLogModel()
     return m_logModel;
 }
 
-void LaunchTask::onLogLines(const QStringList &lines, MessageLevel::Enum defaultLevel)
+std::shared_ptr<LogSpool> LaunchTask::getLogSpool()
 {
-    for (auto & line: lines)
+    if(!m_logSpool)
     {
-        onLogLine(line, defaultLevel);
+        m_logSpool = std::make_shared<LogSpool>(QDir("cache/console").absoluteFilePath(m_instance->id()));
     }
+    return m_logSpool;
 }
 
-void LaunchTask::onLogLine(QString line, MessageLevel::Enum level)
+shared_qobject_ptr<LaunchTelemetry> LaunchTask::getTelemetry()
 {
-    // if the launcher part set a log level, use it
-    auto innerLevel = MessageLevel::fromLine(line);
-    if(innerLevel != MessageLevel::Unknown)
+    if(!m_telemetry)
     {
-        level = innerLevel;
+        m_telemetry.reset(new LaunchTelemetry());
     }
+    return m_telemetry;
+}
+
+void LaunchTask::onLogLines(const QStringList &lines, MessageLevel::Enum defaultLevel)
+{
+    QStringList censored;
+    QVector<MessageLevel::Enum> levels;
+    censored.reserve(lines.size());
+    levels.reserve(lines.size());
 
-    // If the level is still undetermined, guess level
-    if (level == MessageLevel::StdErr || level == MessageLevel::StdOut || level == MessageLevel::Unknown)
+    for (auto line: lines)
     {
-        level = m_instance->guessLevel(line, level);
+        // not for the log, it goes to its own view
+        if (LaunchTelemetry::isTelemetry(line))
+        {
+            getTelemetry()->parseLine(line);
+            continue;
+        }
+
+        // the game logs this once its window is there, the older versions the other one
+        static const QRegularExpression s_window("Backend library: LWJGL|LWJGL Version: ");
+        if (m_record.windowTime < 0 && m_record.spawnTime >= 0 && s_window.match(line).hasMatch())
+        {
+            m_record.windowTime = (TaskTrace::now() - startedAt()) / 1000;
+            emit windowOpened();
+        }
+
+        auto level = defaultLevel;
+
+        // if the launcher part set a log level, use it
+        auto innerLevel = MessageLevel::fromLine(line);
+        if(innerLevel != MessageLevel::Unknown)
+        {
+            level = innerLevel;
+        }
+
+        // If the level is still undetermined, guess level
+        if (level == MessageLevel::StdErr || level == MessageLevel::StdOut || level == MessageLevel::Unknown)
+        {
+            level = m_instance->guessLevel(line, level);
+        }
+
+        // censor private user info
+        censored.append(censorPrivateInfo(line));
+        levels.append(level);
     }
 
-    // censor private user info
-    line = censorPrivateInfo(line);
+    // add them all at once, so the views only get to update once
+    getLogSpool()->append(levels, censored);
+    getLogModel()->append(levels, censored);
+}
 
-    auto &model = *getLogModel();
-    model.append(level, line);
+void LaunchTask::onLogLine(QString line, MessageLevel::Enum level)
+{
+    onLogLines(QStringList{ line }, level);
 }
 
 void LaunchTask::emitSucceeded()
 {
     m_instance->setRunning(false);
+    saveRecord();
     Task::emitSucceeded();
 }
 
 void LaunchTask::emitFailed(QString reason)
 {
     m_instance->setRunning(false);
+    m_record.crashed = true;
+    saveRecord();
     m_instance->setCrashed(true);
     Task::emitFailed(reason);
 }
 
-void LaunchTask::substituteVariables(QStringList &args) const
+void LaunchTask::saveRecord()
 {
-    auto env = m_instance->createEnvironment();
+    // launches that never got to the game say nothing about how it runs
+    if (m_record.spawnTime < 0)
+    {
+        return;
+    }
+    if (m_telemetry)
+    {
+        m_record.telemetry = m_telemetry->summary();
+    }
+    LaunchHistory::append(LaunchHistory::file(m_instance->instanceRoot()), m_record);
+}
 
-    for (auto key : env.keys())
+void LaunchTask::setPid(qint64 pid)
+{
+    m_pid = pid;
+    if (pid > 0 && m_record.spawnTime < 0)
     {
-        args.replaceInStrings("$" + key, env.value(key));
+        m_record.spawnTime = (TaskTrace::now() - startedAt()) / 1000;
     }
 }
 
-void LaunchTask::substituteVariables(QString &cmd) const
+static ArgumentTemplate::Variables environmentVariables(const QProcessEnvironment& env)
 {
-    auto env = m_instance->createEnvironment();
+    ArgumentTemplate::Variables variables;
+    for (auto& key : env.keys())
+    {
+        variables.insert(key, env.value(key));
+    }
+    return variables;
+}
 
-    for (auto key : env.keys())
+void LaunchTask::substituteVariables(QStringList &args) const
+{
+    auto variables = environmentVariables(m_instance->createEnvironment());
+    for (auto& arg : args)
     {
-        cmd.replace("$" + key, env.value(key));
+        arg = ArgumentTemplate(arg, ArgumentTemplate::Syntax::Shell).render(variables);
     }
 }
+
+void LaunchTask::substituteVariables(QString &cmd) const
+{
+    auto variables = environmentVariables(m_instance->createEnvironment());
+    cmd = ArgumentTemplate(cmd, ArgumentTemplate::Syntax::Shell).render(variables);
+}
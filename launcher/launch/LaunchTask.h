@@ -36,9 +36,14 @@
  */
 
 #pragma once
+#include <QHash>
 #include <QProcess>
+#include <QRegularExpression>
 #include <QObjectPtr.h>
 #include "LogModel.h"
+#include "LogSpool.h"
+#include "LaunchHistory.h"
+#include "LaunchTelemetry.h"
 #include "BaseInstance.h"
 #include "MessageLevel.h"
 #include "LoggedProcess.h"
@@ -66,7 +71,17 @@ public: /* methods */
     static shared_qobject_ptr<LaunchTask> create(InstancePtr inst);
     virtual ~LaunchTask() {};
 
+    /**
+     * @brief add a step that starts once all the steps added before it are done
+     */
     void appendStep(shared_qobject_ptr<LaunchStep> step);
+    /**
+     * @brief add a step that starts as soon as the given steps are done, alongside anything else that can run
+     */
+    void appendStep(shared_qobject_ptr<LaunchStep> step, const QList<shared_qobject_ptr<LaunchStep>>& dependencies);
+    /**
+     * @brief add a step that has to be done before all the steps already there
+     */
     void prependStep(shared_qobject_ptr<LaunchStep> step);
     void setCensorFilter(QMap<QString, QString> filter);
 
@@ -75,16 +90,26 @@ public: /* methods */
         return m_instance;
     }
 
-    void setPid(qint64 pid)
-    {
-        m_pid = pid;
-    }
+    void setPid(qint64 pid);
 
     qint64 pid()
     {
         return m_pid;
     }
 
+    /**
+     * @brief arguments for the JVM that come with this launch instead of the instance, like the ones of a profiler
+     */
+    void setExtraJavaArguments(const QStringList& args)
+    {
+        m_extraJavaArguments = args;
+    }
+
+    QStringList extraJavaArguments() const
+    {
+        return m_extraJavaArguments;
+    }
+
     /**
      * @brief prepare the process for launch (for multi-stage launch)
      */
@@ -103,6 +128,15 @@ public: /* methods */
     bool canAbort() const override;
 
     shared_qobject_ptr<LogModel> getLogModel();
+    /** All the output of the launch, including what doesn't fit in the log model anymore. */
+    std::shared_ptr<LogSpool> getLogSpool();
+    /** What the launcher part told about the game apart from its log. */
+    shared_qobject_ptr<LaunchTelemetry> getTelemetry();
+    /** How this launch went, for the launch history of the instance. The steps add what they know. */
+    LaunchHistory::Record& record()
+    {
+        return m_record;
+    }
 
 public:
     void substituteVariables(QStringList &args) const;
@@ -119,6 +153,11 @@ signals:
      */
     void readyForLaunch();
 
+    /**
+     * @brief emitted once the game says its window is there, which is about when it's done starting
+     */
+    void windowOpened();
+
     void requestProgress(Task *task);
 
     void requestLogging();
@@ -131,14 +170,29 @@ public slots:
     void onProgressReportingRequested();
 
 private: /*methods */
+    void startReadySteps();
+    bool dependenciesDone(LaunchStep* step) const;
     void finalizeSteps(bool successful, const QString & error);
+    void saveRecord();
 
 protected: /* data */
     InstancePtr m_instance;
     shared_qobject_ptr<LogModel> m_logModel;
+    std::shared_ptr<LogSpool> m_logSpool;
+    shared_qobject_ptr<LaunchTelemetry> m_telemetry;
     QList <shared_qobject_ptr<LaunchStep>> m_steps;
     QMap<QString, QString> m_censorFilter;
-    int currentStep = -1;
+    // all the keys of m_censorFilter, longest first, so they can be replaced in one pass
+    QRegularExpression m_censorPattern;
+    // step -> the steps it waits for
+    QHash<LaunchStep*, QList<LaunchStep*>> m_dependencies;
+    // in the order they were started, to finalize them the other way around
+    QList<LaunchStep*> m_startedSteps;
+    LaunchStep* m_waitingStep = nullptr;
+    bool m_startingSteps = false;
+    bool m_finalized = false;
     State state = NotStarted;
     qint64 m_pid = -1;
+    QStringList m_extraJavaArguments;
+    LaunchHistory::Record m_record;
 };
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "LaunchTelemetry.h"
+
+namespace {
+const QString s_prefix = "!![Telemetry]!";
+// an hour of samples at one every five seconds
+constexpr int s_max_samples = 720;
+}  // namespace
+
+QJsonObject LaunchTelemetry::Summary::toJson() const
+{
+    QJsonObject object;
+    object["startup"] = startup;
+    object["duration"] = duration;
+    object["peakHeap"] = peakHeap;
+    object["heapMax"] = heapMax;
+    object["gcCount"] = gcCount;
+    object["gcTime"] = gcTime;
+    object["longestGcPause"] = longestGcPause;
+    return object;
+}
+
+auto LaunchTelemetry::Summary::fromJson(const QJsonObject& object) -> Summary
+{
+    Summary summary;
+    summary.startup = object["startup"].toVariant().toLongLong();
+    summary.duration = object["duration"].toVariant().toLongLong();
+    summary.peakHeap = object["peakHeap"].toVariant().toLongLong();
+    summary.heapMax = object["heapMax"].toVariant().toLongLong();
+    summary.gcCount = object["gcCount"].toVariant().toLongLong();
+    summary.gcTime = object["gcTime"].toVariant().toLongLong();
+    summary.longestGcPause = object["longestGcPause"].toVariant().toLongLong();
+    return summary;
+}
+
+LaunchTelemetry::LaunchTelemetry(QObject* parent) : QObject(parent) {}
+
+bool LaunchTelemetry::isTelemetry(const QString& line)
+{
+    return line.startsWith(s_prefix);
+}
+
+bool LaunchTelemetry::parseLine(const QString& line)
+{
+    if (!isTelemetry(line))
+        return false;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    auto parts = line.mid(s_prefix.size()).trimmed().split(' ', Qt::SkipEmptyParts);
+#else
+    auto parts = line.mid(s_prefix.size()).trimmed().split(' ', QString::SkipEmptyParts);
+#endif
+    if (parts.isEmpty())
+        return false;
+
+    bool ok = false;
+    if (parts[0] == "phase" && parts.size() == 3) {
+        Phase phase{ parts[1], parts[2].toLongLong(&ok) };
+        if (!ok)
+            return false;
+        m_phases.append(phase);
+        if (phase.name == "game")
+            m_summary.startup = phase.uptime;
+        m_summary.duration = qMax(m_summary.duration, phase.uptime);
+    } else if (parts[0] == "sample") {
+        Sample sample;
+        for (int i = 1; i < parts.size(); i++) {
+            auto key = parts[i].section('=', 0, 0);
+            auto value = parts[i].section('=', 1).toLongLong(&ok);
+            if (!ok)
+                return false;
+
+            if (key == "uptime")
+                sample.uptime = value;
+            else if (key == "used")
+                sample.heapUsed = value;
+            else if (key == "committed")
+                sample.heapCommitted = value;
+            else if (key == "max")
+                sample.heapMax = value;
+            else if (key == "gcCount")
+                sample.gcCount = value;
+            else if (key == "gcTime")
+                sample.gcTime = value;
+            // newer launcher parts may tell more, that's fine
+        }
+        add(sample);
+    } else {
+        return false;
+    }
+
+    emit changed();
+    return true;
+}
+
+void LaunchTelemetry::add(const Sample& sample)
+{
+    if (!m_samples.isEmpty()) {
+        auto& last = m_samples.last();
+        auto collections = sample.gcCount - last.gcCount;
+        if (collections > 0)
+            m_summary.longestGcPause = qMax(m_summary.longestGcPause, (sample.gcTime - last.gcTime) / collections);
+    } else if (sample.gcCount > 0) {
+        m_summary.longestGcPause = sample.gcTime / sample.gcCount;
+    }
+
+    m_summary.duration = qMax(m_summary.duration, sample.uptime);
+    m_summary.peakHeap = qMax(m_summary.peakHeap, sample.heapUsed);
+    m_summary.heapMax = sample.heapMax;
+    m_summary.gcCount = sample.gcCount;
+    m_summary.gcTime = sample.gcTime;
+
+    if (m_samples.size() >= s_max_samples)
+        m_samples.removeFirst();
+    m_samples.append(sample);
+}
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+/* What the launcher part tells about a running game, apart from its log.
+ *
+ * The launcher part writes the startup phases and, every few seconds, the heap and the collections on lines of their
+ * own (see Telemetry.java). The launch task takes those out of the log and hands them to this, which keeps them for the
+ * live view and sums them up. The summary goes to the launch history of the instance (see LaunchHistory), so launches
+ * can be compared with the ones before.
+ */
+class LaunchTelemetry : public QObject {
+    Q_OBJECT
+   public:
+    struct Phase {
+        QString name;
+        // ms since the JVM started
+        qint64 uptime = 0;
+    };
+    struct Sample {
+        qint64 uptime = 0;
+        qint64 heapUsed = 0;
+        qint64 heapCommitted = 0;
+        qint64 heapMax = 0;
+        // summed up since the start
+        qint64 gcCount = 0;
+        qint64 gcTime = 0;
+    };
+    struct Summary {
+        // until the game's main got called, 0 when it never did
+        qint64 startup = 0;
+        qint64 duration = 0;
+        qint64 peakHeap = 0;
+        qint64 heapMax = 0;
+        qint64 gcCount = 0;
+        qint64 gcTime = 0;
+        // the longest average collection in one of the sampling intervals
+        qint64 longestGcPause = 0;
+
+        QJsonObject toJson() const;
+        static Summary fromJson(const QJsonObject& object);
+    };
+
+    explicit LaunchTelemetry(QObject* parent = nullptr);
+
+    /** Whether `line` of the game's output is telemetry, and not for the log. */
+    static bool isTelemetry(const QString& line);
+
+    /** Takes in a telemetry line, false if it couldn't be understood. */
+    bool parseLine(const QString& line);
+
+    const QList<Phase>& phases() const { return m_phases; }
+    /** The most recent samples, older ones are only in the summary. */
+    const QVector<Sample>& samples() const { return m_samples; }
+    const Summary& summary() const { return m_summary; }
+    bool isEmpty() const { return m_phases.isEmpty() && m_samples.isEmpty(); }
+
+   signals:
+    void changed();
+
+   private:
+    void add(const Sample& sample);
+
+    QList<Phase> m_phases;
+    QVector<Sample> m_samples;
+    Summary m_summary;
+};
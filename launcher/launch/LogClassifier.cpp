@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "LogClassifier.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+bool isTimestampChar(QChar c)
+{
+    return (c >= '0' && c <= '9') || c == ':';
+}
+
+}  // namespace
+
+LogClassifier::LogClassifier() : LogClassifier(defaultHeaderLevels(), defaultLegacyTags(), defaultRules()) {}
+
+LogClassifier::LogClassifier(QHash<QString, MessageLevel::Enum> header_levels,
+                             QList<QPair<QString, MessageLevel::Enum>> legacy_tags,
+                             QList<Rule> rules)
+    : m_header_levels(std::move(header_levels)), m_rules(std::move(rules))
+{
+    m_min_tag_length = INT_MAX;
+    for (int i = 0; i < legacy_tags.size(); i++) {
+        auto& tag = legacy_tags.at(i).first;
+        m_legacy_tags.insert(tag, { i, legacy_tags.at(i).second });
+        m_min_tag_length = std::min(m_min_tag_length, int(tag.size()));
+        m_max_tag_length = std::max(m_max_tag_length, int(tag.size()));
+    }
+
+    // compile everything now, instead of when the first line comes in
+    for (auto& rule : m_rules) {
+        if (!rule.regex.pattern().isEmpty())
+            rule.regex.optimize();
+    }
+}
+
+QHash<QString, MessageLevel::Enum> LogClassifier::defaultHeaderLevels()
+{
+    return {
+        { "INFO", MessageLevel::Message }, { "WARN", MessageLevel::Warning }, { "ERROR", MessageLevel::Error },
+        { "FATAL", MessageLevel::Fatal },  { "TRACE", MessageLevel::Debug },  { "DEBUG", MessageLevel::Debug },
+    };
+}
+
+QList<QPair<QString, MessageLevel::Enum>> LogClassifier::defaultLegacyTags()
+{
+    // Old style Forge logs
+    return {
+        { "[INFO]", MessageLevel::Message },  { "[CONFIG]", MessageLevel::Message }, { "[FINE]", MessageLevel::Message },
+        { "[FINER]", MessageLevel::Message }, { "[FINEST]", MessageLevel::Message }, { "[SEVERE]", MessageLevel::Error },
+        { "[STDERR]", MessageLevel::Error },  { "[WARNING]", MessageLevel::Warning }, { "[DEBUG]", MessageLevel::Debug },
+    };
+}
+
+QList<LogClassifier::Rule> LogClassifier::defaultRules()
+{
+    // NOTE: this diverges from the real regexp. no unicode, the first section is + instead of *
+    static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
+
+    return {
+        { { "overwriting existing" }, {}, MessageLevel::Fatal },
+        // Java exceptions and stack traces
+        { { "Exception in thread" }, {}, MessageLevel::Error },
+        { { "at " }, QRegularExpression("\\s+at " + javaSymbol), MessageLevel::Error },
+        { { "Caused by: " }, QRegularExpression("Caused by: " + javaSymbol), MessageLevel::Error },
+        { { "Exception", "Error", "Throwable" },
+          QRegularExpression("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)"),
+          MessageLevel::Error },
+        { { " more" }, QRegularExpression("... \\d+ more$"), MessageLevel::Error },
+    };
+}
+
+MessageLevel::Enum LogClassifier::classify(const QString& line, MessageLevel::Enum level) const
+{
+    int start, length;
+    if (findHeaderLevel(line, start, length)) {
+        // New style logs from log4j
+        auto it = m_header_levels.constFind(line.mid(start, length));
+        if (it != m_header_levels.constEnd())
+            level = *it;
+    } else {
+        level = legacyLevel(line, level);
+    }
+
+    for (auto& rule : m_rules) {
+        if (!rule.contains.isEmpty() &&
+            std::none_of(rule.contains.cbegin(), rule.contains.cend(), [&line](const QString& text) { return line.contains(text); }))
+            continue;
+        if (!rule.regex.pattern().isEmpty() && !rule.regex.match(line).hasMatch())
+            continue;
+        return rule.level;
+    }
+
+    return level;
+}
+
+bool LogClassifier::findHeaderLevel(const QString& line, int& start, int& length)
+{
+    // Same as matching "\[[0-9:]+\] \[[^/]+/([^\]]+)\]", without the regular expression
+    const int size = line.size();
+    for (int open = line.indexOf('['); open >= 0; open = line.indexOf('[', open + 1)) {
+        int pos = open + 1;
+        while (pos < size && isTimestampChar(line[pos]))
+            pos++;
+        if (pos == open + 1 || pos + 3 > size || line[pos] != ']' || line[pos + 1] != ' ' || line[pos + 2] != '[')
+            continue;
+
+        // the thread name
+        auto slash = line.indexOf('/', pos + 3);
+        if (slash < 0)
+            return false;  // no other '[' can be followed by a header either
+        if (slash == pos + 3)
+            continue;
+
+        auto close = line.indexOf(']', slash + 1);
+        if (close < 0)
+            return false;
+        if (close == slash + 1)
+            continue;
+
+        start = slash + 1;
+        length = close - start;
+        return true;
+    }
+    return false;
+}
+
+MessageLevel::Enum LogClassifier::legacyLevel(const QString& line, MessageLevel::Enum level) const
+{
+    if (m_legacy_tags.isEmpty())
+        return level;
+
+    // All the tags go from a '[' to the first ']' after it, so we only need to look at those
+    int priority = -1;
+    int close = -1;
+    for (int open = line.indexOf('['); open >= 0; open = line.indexOf('[', open + 1)) {
+        if (close < open) {
+            close = line.indexOf(']', open + 1);
+            if (close < 0)
+                break;
+        }
+
+        int length = close - open + 1;
+        if (length < m_min_tag_length || length > m_max_tag_length)
+            continue;
+
+        auto it = m_legacy_tags.constFind(line.mid(open, length));
+        if (it != m_legacy_tags.constEnd() && it->first > priority) {
+            priority = it->first;
+            level = it->second;
+        }
+    }
+    return level;
+}
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+
+#include "MessageLevel.h"
+
+/* Guesses the level of the lines logged by the game.
+ *
+ * Everything is prepared once when constructing the classifier, so classifying a line
+ * is a single pass over it for the common cases:
+ *  - log4j lines ("[12:34:56] [Render thread/WARN]: ..."), whose header is parsed by hand
+ *  - old Forge lines, tagged with things like "[INFO]" or "[SEVERE]", looked up in a table
+ * and the (much more expensive) rules spotting stack traces are only tried on lines that
+ * contain the text they need.
+ */
+class LogClassifier {
+   public:
+    /* A line matching this rule gets its 'level', whatever the header said. */
+    struct Rule {
+        /** The rule only applies to lines containing one of these. Checked before 'regex', which is optional. */
+        QStringList contains;
+        QRegularExpression regex;
+        MessageLevel::Enum level;
+    };
+
+    /** A classifier using the default rules, matching what Minecraft and its mod loaders log. */
+    LogClassifier();
+    /**
+     * \param header_levels the level names of log4j headers
+     * \param legacy_tags tags of old style logs, with their brackets. When a line has several of them, the one coming last in
+     *        this list wins.
+     * \param rules rules applied after those, in order
+     */
+    LogClassifier(QHash<QString, MessageLevel::Enum> header_levels,
+                  QList<QPair<QString, MessageLevel::Enum>> legacy_tags,
+                  QList<Rule> rules);
+
+    MessageLevel::Enum classify(const QString& line, MessageLevel::Enum level) const;
+
+    static QHash<QString, MessageLevel::Enum> defaultHeaderLevels();
+    static QList<QPair<QString, MessageLevel::Enum>> defaultLegacyTags();
+    static QList<Rule> defaultRules();
+
+   private:
+    /** Finds the level in a "[HH:MM:SS] [thread/LEVEL]" header, anywhere in the line. Returns its position and length. */
+    static bool findHeaderLevel(const QString& line, int& start, int& length);
+    MessageLevel::Enum legacyLevel(const QString& line, MessageLevel::Enum level) const;
+
+    QHash<QString, MessageLevel::Enum> m_header_levels;
+    // tag -> (priority, level)
+    QHash<QString, QPair<int, MessageLevel::Enum>> m_legacy_tags;
+    int m_min_tag_length = 0;
+    int m_max_tag_length = 0;
+    QList<Rule> m_rules;
+};
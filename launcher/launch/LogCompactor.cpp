@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "LogCompactor.h"
+
+#include <QHash>
+
+#include <algorithm>
+
+#include "LogClassifier.h"
+
+namespace {
+
+// traces shorter than this aren't worth replacing with a reference
+constexpr int s_min_trace_lines = 3;
+
+bool isTraceLine(const QString& line)
+{
+    if (line.startsWith("Caused by: "))
+        return true;
+    if (line.isEmpty() || !line.at(0).isSpace())
+        return false;
+    auto trimmed = line.trimmed();
+    return trimmed.startsWith("at ") || trimmed.startsWith("Caused by: ") || trimmed.startsWith("Suppressed: ") ||
+           (trimmed.startsWith("... ") && trimmed.endsWith(" more"));
+}
+
+}  // namespace
+
+LogCompactor::LogCompactor(int max_lines, int context) : m_max_lines(max_lines), m_context(context) {}
+
+QString LogCompactor::compact(const QString& text, const QVector<MessageLevel::Enum>& levels) const
+{
+    auto lines = text.split('\n');
+    // the log ends with a line break, which isn't one more line
+    if (!lines.isEmpty() && lines.last().isEmpty())
+        lines.removeLast();
+    return compact(lines, levels).join('\n') + '\n';
+}
+
+QStringList LogCompactor::compact(const QStringList& lines, QVector<MessageLevel::Enum> levels) const
+{
+    if (levels.size() != lines.size()) {
+        LogClassifier classifier;
+        levels.clear();
+        levels.reserve(lines.size());
+        for (auto& line : lines)
+            levels.append(classifier.classify(line, MessageLevel::Message));
+    }
+
+    QStringList collapsed;
+    QVector<MessageLevel::Enum> collapsedLevels;
+    collapseRepeats(lines, levels, collapsed, collapsedLevels);
+    return trim(collapsed, collapsedLevels);
+}
+
+void LogCompactor::collapseRepeats(const QStringList& lines,
+                                   const QVector<MessageLevel::Enum>& levels,
+                                   QStringList& out_lines,
+                                   QVector<MessageLevel::Enum>& out_levels) const
+{
+    // stack trace -> line of its first copy in the output, counting from 1
+    QHash<QString, int> traces;
+
+    const int count = lines.size();
+    for (int i = 0; i < count;) {
+        int end = i;
+        while (end < count && isTraceLine(lines.at(end)))
+            end++;
+        if (end - i >= s_min_trace_lines) {
+            auto trace = lines.mid(i, end - i).join('\n');
+            auto first = traces.constFind(trace);
+            if (first != traces.constEnd()) {
+                out_lines.append(QString("\t[same stack trace as on line %1, %2 lines]").arg(*first).arg(end - i));
+                out_levels.append(levels.at(i));
+            } else {
+                traces.insert(trace, out_lines.size() + 1);
+                for (int j = i; j < end; j++) {
+                    out_lines.append(lines.at(j));
+                    out_levels.append(levels.at(j));
+                }
+            }
+            i = end;
+            continue;
+        }
+
+        end = i + 1;
+        while (end < count && lines.at(end) == lines.at(i))
+            end++;
+        out_lines.append(lines.at(i));
+        out_levels.append(levels.at(i));
+        if (end - i > 1) {
+            out_lines.append(QString("[the line above was repeated %1 more times]").arg(end - i - 1));
+            out_levels.append(levels.at(i));
+        }
+        i = end;
+    }
+}
+
+QStringList LogCompactor::trim(const QStringList& lines, const QVector<MessageLevel::Enum>& levels) const
+{
+    const int count = lines.size();
+    if (m_max_lines <= 0 || count <= m_max_lines)
+        return lines;
+
+    // a quarter of the lines for the start and the end each, what is left for the errors in between
+    const int head = m_max_lines / 4;
+    const int tail = m_max_lines / 4;
+    QVector<bool> keep(count, false);
+    for (int i = 0; i < head; i++)
+        keep[i] = true;
+    for (int i = count - tail; i < count; i++)
+        keep[i] = true;
+
+    int budget = m_max_lines - head - tail;
+    for (int i = head; i < count - tail && budget > 0; i++) {
+        if (levels.at(i) != MessageLevel::Error && levels.at(i) != MessageLevel::Fatal)
+            continue;
+        for (int j = std::max(head, i - m_context); j <= std::min(count - tail - 1, i + m_context) && budget > 0; j++) {
+            if (!keep[j]) {
+                keep[j] = true;
+                budget--;
+            }
+        }
+    }
+
+    QStringList out;
+    out.reserve(m_max_lines + 1);
+    for (int i = 0; i < count;) {
+        if (keep[i]) {
+            out.append(lines.at(i));
+            i++;
+            continue;
+        }
+        int end = i;
+        while (end < count && !keep[end])
+            end++;
+        out.append(QString("[... %1 lines left out ...]").arg(end - i));
+        i = end;
+    }
+    return out;
+}
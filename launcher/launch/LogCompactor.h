@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "MessageLevel.h"
+
+/* Makes a log small enough to be uploaded to a paste service.
+ *
+ * Modded logs repeat themselves a lot: the same line many times in a row, and the same stack
+ * trace every time the same thing fails. Those are collapsed into their first copy and a count.
+ * If the log is still too long after that, its middle is left out, except for the errors and
+ * what was logged around them, since that is what people look at an uploaded log for.
+ */
+class LogCompactor {
+   public:
+    /**
+     * \param max_lines about how many lines the compacted log may have, or 0 to never leave anything out
+     * \param context how many lines to keep before and after each error, when leaving lines out
+     */
+    explicit LogCompactor(int max_lines = 25000, int context = 10);
+
+    /** Compacts 'lines', of which 'levels' are the levels. Without levels, they are guessed. */
+    QStringList compact(const QStringList& lines, QVector<MessageLevel::Enum> levels = {}) const;
+    /** The same for a whole log, as text. */
+    QString compact(const QString& text, const QVector<MessageLevel::Enum>& levels = {}) const;
+
+   private:
+    void collapseRepeats(const QStringList& lines,
+                         const QVector<MessageLevel::Enum>& levels,
+                         QStringList& out_lines,
+                         QVector<MessageLevel::Enum>& out_levels) const;
+    QStringList trim(const QStringList& lines, const QVector<MessageLevel::Enum>& levels) const;
+
+    int m_max_lines;
+    int m_context;
+};
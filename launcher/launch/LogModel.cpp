@@ -1,8 +1,18 @@
 #include "LogModel.h"
 
+#include <algorithm>
+
+#include "MemoryAccounting.h"
+
 LogModel::LogModel(QObject *parent):QAbstractListModel(parent)
 {
-    m_content.resize(m_maxLines);
+    MemoryAccounting::track(this, "Instance logs", [this] {
+        MemoryAccounting::Usage usage;
+        usage.items = qint64(m_content.size());
+        for (auto& entry : m_content)
+            usage.bytes += qint64(sizeof(entry)) - qint64(sizeof(QString)) + MemoryAccounting::bytesOf(entry.line);
+        return usage;
+    });
 }
 
 int LogModel::rowCount(const QModelIndex &parent) const
@@ -10,23 +20,22 @@ int LogModel::rowCount(const QModelIndex &parent) const
     if (parent.isValid())
         return 0;
 
-    return m_numLines;
+    return int(m_content.size());
 }
 
 QVariant LogModel::data(const QModelIndex &index, int role) const
 {
-    if (index.row() < 0 || index.row() >= m_numLines)
+    if (index.row() < 0 || index.row() >= rowCount())
         return QVariant();
 
-    auto row = index.row();
-    auto realRow = (row + m_firstLine) % m_maxLines;
+    auto & entry = m_content[index.row()];
     if (role == Qt::DisplayRole || role == Qt::EditRole)
     {
-        return m_content[realRow].line;
+        return entry.line;
     }
     if(role == LevelRole)
     {
-        return m_content[realRow].level;
+        return entry.level;
     }
 
     return QVariant();
@@ -34,33 +43,53 @@ QVariant LogModel::data(const QModelIndex &index, int role) const
 
 void LogModel::append(MessageLevel::Enum level, QString line)
 {
-    if(m_suspended)
+    append(QVector<MessageLevel::Enum>{ level }, QStringList{ line });
+}
+
+void LogModel::append(const QVector<MessageLevel::Enum>& levels, const QStringList& lines)
+{
+    if(m_suspended || lines.isEmpty() || m_maxLines <= 0)
     {
         return;
     }
-    int lineNum = (m_firstLine + m_numLines) % m_maxLines;
-    // overflow
-    if(m_numLines == m_maxLines)
+    int numLines = rowCount();
+    // the lines of the batch that make it into the buffer
+    int first = 0;
+    int count = lines.size();
+    if(m_stopOnOverflow)
     {
-        if(m_stopOnOverflow)
+        // nothing more to do once the buffer is full
+        count = std::min(count, m_maxLines - numLines);
+        if(count <= 0)
         {
-            // nothing more to do, the buffer is full
             return;
         }
-        beginRemoveRows(QModelIndex(), 0, 0);
-        m_firstLine = (m_firstLine + 1) % m_maxLines;
-        m_numLines --;
+    }
+    else if(count > m_maxLines)
+    {
+        first = count - m_maxLines;
+        count = m_maxLines;
+    }
+
+    // overflow, drop the oldest lines
+    int overflow = numLines + count - m_maxLines;
+    if(overflow > 0)
+    {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        m_content.erase(m_content.begin(), m_content.begin() + overflow);
+        numLines -= overflow;
         endRemoveRows();
     }
-    else if (m_numLines == m_maxLines - 1 && m_stopOnOverflow)
+
+    beginInsertRows(QModelIndex(), numLines, numLines + count - 1);
+    for(int i = first; i < first + count; i++)
     {
-        level = MessageLevel::Fatal;
-        line = m_overflowMessage;
+        m_content.push_back({ levels.value(i, MessageLevel::Unknown), lines.at(i) });
+    }
+    if(m_stopOnOverflow && rowCount() == m_maxLines)
+    {
+        m_content.back() = { MessageLevel::Fatal, m_overflowMessage };
     }
-    beginInsertRows(QModelIndex(), m_numLines, m_numLines);
-    m_numLines ++;
-    m_content[lineNum].level = level;
-    m_content[lineNum].line = line;
     endInsertRows();
 }
 
@@ -77,24 +106,33 @@ bool LogModel::suspended()
 void LogModel::clear()
 {
     beginResetModel();
-    m_firstLine = 0;
-    m_numLines = 0;
+    m_content.clear();
     endResetModel();
 }
 
 QString LogModel::toPlainText()
 {
     QString out;
-    out.reserve(m_numLines * 80);
-    for(int i = 0; i < m_numLines; i++)
+    out.reserve(rowCount() * 80);
+    for(auto & entry : m_content)
     {
-        QString & line = m_content[(m_firstLine + i) % m_maxLines].line;
-        out.append(line + '\n');
+        out.append(entry.line + '\n');
     }
     out.squeeze();
     return out;
 }
 
+QVector<MessageLevel::Enum> LogModel::levels() const
+{
+    QVector<MessageLevel::Enum> out;
+    out.reserve(int(m_content.size()));
+    for(auto & entry : m_content)
+    {
+        out.append(entry.level);
+    }
+    return out;
+}
+
 void LogModel::setMaxLines(int maxLines)
 {
     // no-op
@@ -102,39 +140,14 @@ void LogModel::setMaxLines(int maxLines)
     {
         return;
     }
-    // if it all still fits in the buffer, just resize it
-    if(m_firstLine + m_numLines < m_maxLines)
-    {
-        m_maxLines = maxLines;
-        m_content.resize(maxLines);
-        return;
-    }
-    // otherwise, we need to reorganize the data because it crosses the wrap boundary
-    QVector<entry> newContent;
-    newContent.resize(maxLines);
-    if(m_numLines <= maxLines)
+    // if it doesn't fit, part of the data needs to be thrown away (the oldest log messages)
+    int lead = rowCount() - std::max(maxLines, 0);
+    if(lead > 0)
     {
-        // if it all fits in the new buffer, just copy it over
-        for(int i = 0; i < m_numLines; i++)
-        {
-            newContent[i] = m_content[(m_firstLine + i) % m_maxLines];
-        }
-        m_content.swap(newContent);
-    }
-    else
-    {
-        // if it doesn't fit, part of the data needs to be thrown away (the oldest log messages)
-        int lead = m_numLines - maxLines;
         beginRemoveRows(QModelIndex(), 0, lead - 1);
-        for(int i = 0; i < maxLines; i++)
-        {
-            newContent[i] = m_content[(m_firstLine + lead + i) % m_maxLines];
-        }
-        m_numLines = m_maxLines;
-        m_content.swap(newContent);
+        m_content.erase(m_content.begin(), m_content.begin() + lead);
         endRemoveRows();
     }
-    m_firstLine = 0;
     m_maxLines = maxLines;
 }
 
@@ -2,6 +2,9 @@
 
 #include <QAbstractListModel>
 #include <QString>
+#include <QStringList>
+#include <QVector>
+#include <deque>
 #include "MessageLevel.h"
 
 class LogModel : public QAbstractListModel
@@ -14,12 +17,16 @@ public:
     QVariant data(const QModelIndex &index, int role) const;
 
     void append(MessageLevel::Enum, QString line);
+    /* Appends a batch of lines, with one level for each of them, as a single row insertion. */
+    void append(const QVector<MessageLevel::Enum>& levels, const QStringList& lines);
     void clear();
 
     void suspend(bool suspend);
     bool suspended();
 
     QString toPlainText();
+    /* The levels of the lines of toPlainText(). */
+    QVector<MessageLevel::Enum> levels() const;
 
     int getMaxLines();
     void setMaxLines(int maxLines);
@@ -42,12 +49,10 @@ private /* types */:
     };
 
 private: /* data */
-    QVector <entry> m_content;
+    // a deque allocates in chunks, so only the lines actually logged take memory, whatever m_maxLines is,
+    // and dropping the oldest lines doesn't move the others
+    std::deque<entry> m_content;
     int m_maxLines = 1000;
-    // first line in the circular buffer
-    int m_firstLine = 0;
-    // number of lines occupied in the circular buffer
-    int m_numLines = 0;
     bool m_stopOnOverflow = false;
     QString m_overflowMessage = "OVERFLOW";
     bool m_suspended = false;
@@ -0,0 +1,242 @@
+#include "LogSearchIndex.h"
+
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <vector>
+
+#include "Executors.h"
+#include "LogModel.h"
+
+namespace {
+// a search over fewer lines than this is done right away, the background isn't worth the round trip
+constexpr int SyncScanLines = 5000;
+}  // namespace
+
+LogSearchIndex::LogSearchIndex(QObject* parent) : QObject(parent) {}
+
+void LogSearchIndex::setModel(QAbstractItemModel* model)
+{
+    if (m_model) {
+        disconnect(m_model, nullptr, this, nullptr);
+    }
+    m_model = model;
+    if (m_model) {
+        connect(m_model, &QAbstractItemModel::modelReset, this, &LogSearchIndex::repopulate);
+        connect(m_model, &QAbstractItemModel::rowsInserted, this, &LogSearchIndex::rowsInserted);
+        connect(m_model, &QAbstractItemModel::rowsRemoved, this, &LogSearchIndex::rowsRemoved);
+    }
+    repopulate();
+}
+
+void LogSearchIndex::repopulate()
+{
+    m_firstId += qint64(m_lines.size());
+    m_lines.clear();
+    m_lineLevels.clear();
+    if (m_model) {
+        int rows = m_model->rowCount();
+        for (int row = 0; row < rows; row++) {
+            auto index = m_model->index(row, 0);
+            m_lines.push_back(m_model->data(index, Qt::DisplayRole).toString());
+            m_lineLevels.push_back(MessageLevel::Enum(m_model->data(index, LogModel::LevelRole).toInt()));
+        }
+    }
+    rebuild();
+}
+
+void LogSearchIndex::setQuery(const QString& query)
+{
+    if (query == m_query) {
+        return;
+    }
+    m_query = query;
+    rebuild();
+}
+
+void LogSearchIndex::setLevels(const QList<MessageLevel::Enum>& levels)
+{
+    quint32 mask = 0;
+    for (auto level : levels) {
+        mask |= 1u << level;
+    }
+    if (mask == m_levelMask) {
+        return;
+    }
+    m_levelMask = mask;
+    refilter();
+    emit matchesChanged();
+}
+
+void LogSearchIndex::rebuild()
+{
+    m_generation++;
+    m_textMatches.clear();
+    m_scannedId = m_firstId;
+    m_building = false;
+    if (m_query.isEmpty() || int(m_lines.size()) < SyncScanLines) {
+        scanFrom(m_firstId);
+        refilter();
+        emit matchesChanged();
+        return;
+    }
+
+    QStringList lines;
+    lines.reserve(int(m_lines.size()));
+    for (auto& line : m_lines) {
+        lines.append(line);
+    }
+    auto base = m_firstId;
+    auto query = m_query;
+    auto generation = m_generation;
+    m_building = true;
+    m_matches.clear();
+    emit matchesChanged();
+
+    auto future = QtConcurrent::run(Executors::cpu(), [lines, base, query] {
+        std::vector<qint64> ids;
+        for (int i = 0; i < lines.size(); i++) {
+            if (lines.at(i).contains(query, Qt::CaseInsensitive)) {
+                ids.push_back(base + i);
+            }
+        }
+        return ids;
+    });
+    auto watcher = new QFutureWatcher<std::vector<qint64>>(this);
+    connect(watcher, &QFutureWatcher<std::vector<qint64>>::finished, this, [this, watcher, generation, base, count = lines.size()] {
+        watcher->deleteLater();
+        if (generation != m_generation) {
+            return;
+        }
+        // the oldest lines may have gone away while the scan ran
+        for (auto id : watcher->result()) {
+            if (id >= m_firstId) {
+                m_textMatches.push_back(id);
+            }
+        }
+        m_building = false;
+        // and the lines that came in since still need a look
+        scanFrom(std::max(base + count, m_firstId));
+        refilter();
+        emit matchesChanged();
+    });
+    watcher->setFuture(future);
+}
+
+void LogSearchIndex::scanFrom(qint64 id)
+{
+    auto end = m_firstId + qint64(m_lines.size());
+    if (!m_query.isEmpty()) {
+        for (; id < end; id++) {
+            if (m_lines[size_t(rowOf(id))].contains(m_query, Qt::CaseInsensitive)) {
+                m_textMatches.push_back(id);
+            }
+        }
+    }
+    m_scannedId = end;
+}
+
+void LogSearchIndex::refilter()
+{
+    m_matches.clear();
+    if (!m_query.isEmpty()) {
+        std::copy_if(m_textMatches.begin(), m_textMatches.end(), std::back_inserter(m_matches),
+                     [this](qint64 id) { return levelMatches(id); });
+    } else if (m_levelMask) {
+        auto end = m_firstId + qint64(m_lines.size());
+        for (auto id = m_firstId; id < end; id++) {
+            if (levelMatches(id)) {
+                m_matches.push_back(id);
+            }
+        }
+    }
+}
+
+bool LogSearchIndex::levelMatches(qint64 id) const
+{
+    return !m_levelMask || (m_levelMask & (1u << m_lineLevels[size_t(rowOf(id))]));
+}
+
+void LogSearchIndex::rowsInserted(const QModelIndex& parent, int first, int last)
+{
+    auto end = m_firstId + qint64(m_lines.size());
+    for (int row = first; row <= last; row++) {
+        auto index = m_model->index(row, 0, parent);
+        m_lines.push_back(m_model->data(index, Qt::DisplayRole).toString());
+        m_lineLevels.push_back(MessageLevel::Enum(m_model->data(index, LogModel::LevelRole).toInt()));
+    }
+    if (m_building) {
+        // picked up when the scan is done
+        return;
+    }
+
+    auto previous = m_matches.size();
+    if (!m_query.isEmpty()) {
+        auto textMatches = m_textMatches.size();
+        scanFrom(m_scannedId);
+        std::copy_if(m_textMatches.begin() + textMatches, m_textMatches.end(), std::back_inserter(m_matches),
+                     [this](qint64 id) { return levelMatches(id); });
+    } else if (m_levelMask) {
+        for (auto id = end; id < m_firstId + qint64(m_lines.size()); id++) {
+            if (levelMatches(id)) {
+                m_matches.push_back(id);
+            }
+        }
+    }
+    if (m_matches.size() != previous) {
+        emit matchesChanged();
+    }
+}
+
+void LogSearchIndex::rowsRemoved(const QModelIndex& parent, int first, int last)
+{
+    Q_UNUSED(parent)
+    if (first != 0) {
+        return;
+    }
+    int count = last - first + 1;
+    m_lines.erase(m_lines.begin(), m_lines.begin() + count);
+    m_lineLevels.erase(m_lineLevels.begin(), m_lineLevels.begin() + count);
+    m_firstId += count;
+    m_scannedId = std::max(m_scannedId, m_firstId);
+
+    auto previous = m_matches.size();
+    auto dropGone = [this](std::deque<qint64>& ids) {
+        ids.erase(ids.begin(), std::lower_bound(ids.begin(), ids.end(), m_firstId));
+    };
+    dropGone(m_textMatches);
+    dropGone(m_matches);
+    if (m_matches.size() != previous) {
+        emit matchesChanged();
+    }
+}
+
+int LogSearchIndex::matchCount() const
+{
+    return int(m_matches.size());
+}
+
+int LogSearchIndex::matchIndex(int row) const
+{
+    auto id = m_firstId + row;
+    auto it = std::lower_bound(m_matches.begin(), m_matches.end(), id);
+    if (it == m_matches.end() || *it != id) {
+        return -1;
+    }
+    return int(it - m_matches.begin());
+}
+
+int LogSearchIndex::nextMatch(int row, bool reverse) const
+{
+    if (m_matches.empty()) {
+        return -1;
+    }
+    auto id = m_firstId + row;
+    if (reverse) {
+        auto it = std::lower_bound(m_matches.begin(), m_matches.end(), id);
+        return rowOf(it == m_matches.begin() ? m_matches.back() : *(it - 1));
+    }
+    auto it = std::upper_bound(m_matches.begin(), m_matches.end(), id);
+    return rowOf(it == m_matches.end() ? m_matches.front() : *it);
+}
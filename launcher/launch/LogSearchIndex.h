@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <deque>
+
+#include "MessageLevel.h"
+
+/* The lines of a log model that match a search, kept up to date as the model grows and drops its oldest lines.
+ *
+ * The index holds its own (implicitly shared) copy of the lines and their levels, so a new search is scanned on
+ * Executors::cpu() while the log keeps coming in, and only the lines appended since get scanned afterwards. The
+ * level filter only narrows the lines the search found, so changing it never scans the text again.
+ *
+ * Matches are found by row and line: what needs the position inside the line looks it up on the row it goes to.
+ */
+class LogSearchIndex : public QObject {
+    Q_OBJECT
+   public:
+    explicit LogSearchIndex(QObject* parent = nullptr);
+
+    /* The model to index: rows are only ever appended, or dropped from the front, like LogModel does. */
+    void setModel(QAbstractItemModel* model);
+
+    /* Case insensitive text to look for. With none, every line of the levels matches, and nothing when no levels are set. */
+    void setQuery(const QString& query);
+    QString query() const { return m_query; }
+
+    /* Only the lines of these levels match, or of all of them when empty. */
+    void setLevels(const QList<MessageLevel::Enum>& levels);
+
+    /* Whether the search is still scanned in the background, and the matches aren't all known yet. */
+    bool isBuilding() const { return m_building; }
+
+    int matchCount() const;
+    /* Which match (from 0) the row is, or -1 when it isn't one. */
+    int matchIndex(int row) const;
+    /* The first matching row after the row, or before it when reversed, wrapping around the log. -1 when nothing matches. */
+    int nextMatch(int row, bool reverse) const;
+
+   signals:
+    void matchesChanged();
+
+   private slots:
+    void rowsInserted(const QModelIndex& parent, int first, int last);
+    void rowsRemoved(const QModelIndex& parent, int first, int last);
+    void repopulate();
+
+   private:
+    void rebuild();
+    void scanFrom(qint64 id);
+    void refilter();
+    bool levelMatches(qint64 id) const;
+    int rowOf(qint64 id) const { return int(id - m_firstId); }
+
+   private:
+    QPointer<QAbstractItemModel> m_model;
+
+    // the lines of the model, and the id of the one on row 0: ids keep counting up as the oldest lines go away
+    std::deque<QString> m_lines;
+    std::deque<MessageLevel::Enum> m_lineLevels;
+    qint64 m_firstId = 0;
+
+    QString m_query;
+    quint32 m_levelMask = 0;
+
+    // the lines containing the query, and the ones of them of the right levels
+    std::deque<qint64> m_textMatches;
+    std::deque<qint64> m_matches;
+    // the lines before this one were scanned for the query
+    qint64 m_scannedId = 0;
+    bool m_building = false;
+    // bumped on each new search, so a scan of an older one is thrown away
+    int m_generation = 0;
+};
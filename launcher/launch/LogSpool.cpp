@@ -0,0 +1,277 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "LogSpool.h"
+
+#include <QByteArrayMatcher>
+#include <QDebug>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "FileSystem.h"
+#include "GZip.h"
+
+LogSpool::LogSpool(QString directory, qint64 segment_size) : m_directory(std::move(directory)), m_segment_size(segment_size) {}
+
+LogSpool::~LogSpool()
+{
+    clear();
+}
+
+void LogSpool::clear()
+{
+    for (auto& segment : m_segments) {
+        if (segment->map)
+            segment->file->unmap(segment->map);
+        segment->file->close();
+        if (segment->owned)
+            segment->file->remove();
+    }
+    m_segments.clear();
+    m_dir.reset();
+    m_levels.clear();
+    m_pending.clear();
+    m_failed = false;
+    m_read_only = false;
+    m_longest_line = 0;
+}
+
+bool LogSpool::load(const QString& path)
+{
+    clear();
+
+    auto file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open the log" << path << ":" << file->errorString();
+        return false;
+    }
+
+    Segment* segment = nullptr;
+    if (path.endsWith(".gz")) {
+        auto compressed = file->readAll();
+        file->close();
+        segment = writableSegment(0);
+        if (!segment || !GZip::unzip(compressed, *segment->file) || !segment->file->flush()) {
+            qWarning() << "Could not inflate the log" << path;
+            clear();
+            return false;
+        }
+    } else {
+        auto adopted = std::make_shared<Segment>();
+        adopted->file = std::move(file);
+        adopted->owned = false;
+        m_segments.append(adopted);
+        segment = adopted.get();
+    }
+
+    if (!indexSegment(*segment)) {
+        clear();
+        return false;
+    }
+    m_read_only = true;
+    return true;
+}
+
+bool LogSpool::indexSegment(Segment& segment)
+{
+    auto size = segment.file->size();
+    if (size > std::numeric_limits<quint32>::max()) {
+        qWarning() << "The log" << segment.file->fileName() << "is too big to be indexed";
+        return false;
+    }
+    segment.first_line = lineCount();
+    segment.size = quint32(size);
+    if (size == 0)
+        return true;
+
+    auto contents = data(segment);
+    if (!contents)
+        return false;
+
+    // one pass over the mapped file, looking for the ends of the lines
+    const char* pos = contents;
+    const char* end = contents + size;
+    while (pos < end) {
+        segment.offsets.append(quint32(pos - contents));
+        auto newline = static_cast<const char*>(std::memchr(pos, '\n', size_t(end - pos)));
+        if (!newline) {
+            segment.unterminated = true;
+            m_longest_line = std::max(m_longest_line, qint64(end - pos));
+            break;
+        }
+        m_longest_line = std::max(m_longest_line, qint64(newline - pos));
+        pos = newline + 1;
+    }
+    m_levels.append(QByteArray(segment.offsets.size(), char(MessageLevel::Unknown)));
+    return true;
+}
+
+void LogSpool::append(MessageLevel::Enum level, const QString& line)
+{
+    append(QVector<MessageLevel::Enum>{ level }, QStringList{ line });
+}
+
+void LogSpool::append(const QVector<MessageLevel::Enum>& levels, const QStringList& lines)
+{
+    if (m_failed || m_read_only)
+        return;
+
+    for (int i = 0; i < lines.size(); i++) {
+        auto utf8 = lines.at(i).toUtf8();
+        auto segment = writableSegment(utf8.size() + 1);
+        if (!segment)
+            return;
+
+        segment->offsets.append(segment->size);
+        segment->size += utf8.size() + 1;
+        m_longest_line = std::max(m_longest_line, qint64(utf8.size()));
+        m_pending.append(utf8);
+        m_pending.append('\n');
+        m_levels.append(char(levels.value(i, MessageLevel::Unknown)));
+    }
+    flush();
+}
+
+LogSpool::Segment* LogSpool::writableSegment(qint64 needed)
+{
+    if (!m_segments.isEmpty()) {
+        auto& last = m_segments.last();
+        if (last->size == 0 || last->size + needed <= m_segment_size)
+            return last.get();
+        flush();
+    }
+
+    if (!m_dir) {
+        if (FS::ensureFolderPathExists(m_directory))
+            m_dir = std::make_unique<QTemporaryDir>(FS::PathCombine(m_directory, "XXXXXX"));
+        if (!m_dir || !m_dir->isValid()) {
+            qWarning() << "Could not create the log spool folder in" << m_directory;
+            m_dir.reset();
+            m_failed = true;
+            return nullptr;
+        }
+    }
+
+    auto segment = std::make_shared<Segment>();
+    segment->first_line = lineCount();
+    segment->file = std::make_unique<QFile>(m_dir->filePath(QString("%1.spool").arg(m_segments.size(), 6, 10, QChar('0'))));
+    if (!segment->file->open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        qWarning() << "Could not open the log spool" << segment->file->fileName() << ":" << segment->file->errorString();
+        m_failed = true;
+        return nullptr;
+    }
+    m_segments.append(segment);
+    return segment.get();
+}
+
+void LogSpool::flush()
+{
+    if (m_pending.isEmpty() || m_segments.isEmpty())
+        return;
+
+    auto& file = *m_segments.last()->file;
+    if (file.write(m_pending) != m_pending.size() || !file.flush()) {
+        qWarning() << "Could not write to the log spool" << file.fileName() << ":" << file.errorString();
+        m_failed = true;
+    }
+    m_pending.clear();
+}
+
+int LogSpool::segmentOf(int line) const
+{
+    auto it = std::upper_bound(m_segments.cbegin(), m_segments.cend(), line,
+                               [](int line, const std::shared_ptr<Segment>& segment) { return line < segment->first_line; });
+    return int(it - m_segments.cbegin()) - 1;
+}
+
+const char* LogSpool::data(const Segment& segment) const
+{
+    if (segment.size == 0)
+        return nullptr;
+    if (!segment.map || segment.mapped_size < segment.size) {
+        if (segment.map)
+            segment.file->unmap(segment.map);
+        segment.map = segment.file->map(0, segment.size);
+        segment.mapped_size = segment.map ? segment.size : 0;
+        if (!segment.map)
+            qWarning() << "Could not map the log spool" << segment.file->fileName() << ":" << segment.file->errorString();
+    }
+    return reinterpret_cast<const char*>(segment.map);
+}
+
+QByteArray LogSpool::rawLine(const Segment& segment, int line) const
+{
+    auto contents = data(segment);
+    if (!contents)
+        return {};
+
+    int index = line - segment.first_line;
+    auto start = segment.offsets.at(index);
+    bool last = index + 1 == segment.offsets.size();
+    auto end = last ? segment.size : segment.offsets.at(index + 1);
+    // without the newline, and the carriage return before it in logs written on Windows
+    int length = int(end - start);
+    if (!last || !segment.unterminated)
+        length--;
+    if (length > 0 && contents[start + length - 1] == '\r')
+        length--;
+    return QByteArray::fromRawData(contents + start, length);
+}
+
+QString LogSpool::line(int index) const
+{
+    if (index < 0 || index >= lineCount())
+        return {};
+    return QString::fromUtf8(rawLine(*m_segments.at(segmentOf(index)), index));
+}
+
+QStringList LogSpool::lines(int first, int count) const
+{
+    QStringList result;
+    first = std::max(first, 0);
+    auto last = std::min(first + count, lineCount());
+    if (first >= last)
+        return result;
+
+    result.reserve(last - first);
+    int segment = segmentOf(first);
+    for (int i = first; i < last; i++) {
+        while (segment + 1 < m_segments.size() && m_segments.at(segment + 1)->first_line <= i)
+            segment++;
+        result.append(QString::fromUtf8(rawLine(*m_segments.at(segment), i)));
+    }
+    return result;
+}
+
+int LogSpool::findLevel(LevelMask levels, int from, bool reverse) const
+{
+    int step = reverse ? -1 : 1;
+    int start = reverse ? std::min(from, lineCount() - 1) : std::max(from, 0);
+    for (int i = start; i >= 0 && i < lineCount(); i += step) {
+        if (levels & levelBit(level(i)))
+            return i;
+    }
+    return -1;
+}
+
+int LogSpool::find(const QString& what, int from, bool reverse, LevelMask levels, Qt::CaseSensitivity cs) const
+{
+    if (what.isEmpty())
+        return findLevel(levels, from, reverse);
+
+    // Case sensitive searches can look for the bytes directly, without decoding anything. The search can't span lines,
+    // since the needle can't contain a newline.
+    auto needle = what.toUtf8();
+    bool raw = cs == Qt::CaseSensitive && !needle.contains('\n');
+    QByteArrayMatcher matcher(needle);
+
+    int step = reverse ? -1 : 1;
+    for (int i = findLevel(levels, from, reverse); i >= 0; i = findLevel(levels, i + step, reverse)) {
+        auto& segment = *m_segments.at(segmentOf(i));
+        auto bytes = rawLine(segment, i);
+        if (raw ? matcher.indexIn(bytes) >= 0 : QString::fromUtf8(bytes).contains(what, cs))
+            return i;
+    }
+    return -1;
+}
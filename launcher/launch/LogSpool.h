@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QVector>
+
+#include <memory>
+
+#include "MessageLevel.h"
+
+/* Keeps the whole output of a launch on disk, so it can be browsed and searched after it scrolled out of the console.
+ *
+ * Lines are appended as UTF-8 to segment files of a few megabytes. Only the index (where each line starts and its
+ * level, a few bytes per line) stays in memory; the lines themselves are read back from the memory-mapped segments
+ * when asked for, so hours of output don't have to fit in RAM.
+ *
+ * Each spool gets its own folder in 'directory', removed along with the spool.
+ */
+class LogSpool {
+   public:
+    /** Set of levels, as a bitmask of (1 << level). */
+    using LevelMask = quint32;
+    static constexpr LevelMask AllLevels = ~LevelMask(0);
+    static constexpr LevelMask levelBit(MessageLevel::Enum level) { return LevelMask(1) << level; }
+
+    explicit LogSpool(QString directory, qint64 segment_size = 16 * 1024 * 1024);
+    ~LogSpool();
+
+    void append(const QVector<MessageLevel::Enum>& levels, const QStringList& lines);
+    void append(MessageLevel::Enum level, const QString& line);
+    /** Forgets all the lines and removes their files. */
+    void clear();
+
+    /**
+     * Replaces the lines with the ones of the log file at 'path'. The file is mapped and indexed in place, like a
+     * segment the spool doesn't own; a gzipped one (".gz") is inflated into a segment of its own first. The levels of
+     * its lines are unknown, and nothing can be appended to it.
+     *
+     * \return false if the file couldn't be read, the spool is empty then
+     */
+    bool load(const QString& path);
+
+    int lineCount() const { return m_levels.size(); }
+    /** The length of the longest line, in bytes. */
+    qint64 longestLine() const { return m_longest_line; }
+    MessageLevel::Enum level(int index) const { return MessageLevel::Enum(m_levels.at(index)); }
+    QString line(int index) const;
+    /** Up to 'count' lines, starting at 'first'. */
+    QStringList lines(int first, int count) const;
+
+    /**
+     * Finds the next line containing 'what', starting at 'from' (included) and going forward or backwards.
+     * Only the lines with one of the given levels are looked at.
+     *
+     * \return the index of the line, or -1 if there is none
+     */
+    int find(const QString& what,
+             int from,
+             bool reverse = false,
+             LevelMask levels = AllLevels,
+             Qt::CaseSensitivity cs = Qt::CaseInsensitive) const;
+
+    /** Finds the next line with one of the given levels, like find(). */
+    int findLevel(LevelMask levels, int from, bool reverse = false) const;
+
+   private:
+    struct Segment {
+        std::unique_ptr<QFile> file;
+        int first_line = 0;
+        // where each line starts in the file, the end of the last one being the size of the file
+        QVector<quint32> offsets;
+        quint32 size = 0;
+        // false for the log file a spool was loaded from, which stays where it is
+        bool owned = true;
+        // whether the file doesn't end with a newline, which only happens with loaded ones
+        bool unterminated = false;
+        // the file is mapped up to 'mapped_size' when reading, and remapped when it grew since then
+        mutable uchar* map = nullptr;
+        mutable quint32 mapped_size = 0;
+    };
+
+    int segmentOf(int line) const;
+    const char* data(const Segment& segment) const;
+    QByteArray rawLine(const Segment& segment, int line) const;
+    Segment* writableSegment(qint64 needed);
+    void flush();
+    /** Indexes the lines of a segment that was written in one go, as the last one. */
+    bool indexSegment(Segment& segment);
+
+    QString m_directory;
+    std::unique_ptr<QTemporaryDir> m_dir;
+    qint64 m_segment_size;
+    QList<std::shared_ptr<Segment>> m_segments;
+    // the level of every line
+    QByteArray m_levels;
+    // written, but not flushed into the files yet
+    QByteArray m_pending;
+    bool m_failed = false;
+    bool m_read_only = false;
+    qint64 m_longest_line = 0;
+};
@@ -41,6 +41,29 @@
 #include <QFileInfo>
 #include <sys.h>
 
+QString CheckJava::javaBinary(SettingsObjectPtr settings)
+{
+    return QStandardPaths::findExecutable(FS::ResolveExecutable(settings->get("JavaPath").toString()));
+}
+
+bool CheckJava::isKnown(SettingsObjectPtr settings, const QString &javaBinary)
+{
+    qlonglong javaUnixTime = QFileInfo(javaBinary).lastModified().toMSecsSinceEpoch();
+    // if timestamps are not the same, or something is missing, check!
+    return javaUnixTime == settings->get("JavaTimestamp").toLongLong() && !settings->get("JavaVersion").toString().isEmpty()
+        && !settings->get("JavaArchitecture").toString().isEmpty() && !settings->get("JavaRealArchitecture").toString().isEmpty()
+        && !settings->get("JavaVendor").toString().isEmpty();
+}
+
+void CheckJava::remember(SettingsObjectPtr settings, const QString &javaBinary, const JavaCheckResult &result)
+{
+    settings->set("JavaVersion", result.javaVersion.toString());
+    settings->set("JavaArchitecture", result.mojangPlatform);
+    settings->set("JavaRealArchitecture", result.realPlatform);
+    settings->set("JavaVendor", result.javaVendor);
+    settings->set("JavaTimestamp", QFileInfo(javaBinary).lastModified().toMSecsSinceEpoch());
+}
+
 void CheckJava::executeTask()
 {
     auto instance = m_parent->instance();
@@ -48,7 +71,7 @@ void CheckJava::executeTask()
     m_javaPath = FS::ResolveExecutable(settings->get("JavaPath").toString());
     bool perInstance = settings->get("OverrideJava").toBool() || settings->get("OverrideJavaLocation").toBool();
 
-    auto realJavaPath = QStandardPaths::findExecutable(m_javaPath);
+    auto realJavaPath = javaBinary(settings);
     if (realJavaPath.isEmpty())
     {
         if (perInstance)
@@ -80,18 +103,8 @@ void CheckJava::executeTask()
         return;
     }
 
-    QFileInfo javaInfo(realJavaPath);
-    qlonglong javaUnixTime = javaInfo.lastModified().toMSecsSinceEpoch();
-    auto storedUnixTime = settings->get("JavaTimestamp").toLongLong();
-    auto storedArchitecture = settings->get("JavaArchitecture").toString();
-    auto storedRealArchitecture = settings->get("JavaRealArchitecture").toString();
-    auto storedVersion = settings->get("JavaVersion").toString();
-    auto storedVendor = settings->get("JavaVendor").toString();
-    m_javaUnixTime = javaUnixTime;
-    // if timestamps are not the same, or something is missing, check!
-    if (javaUnixTime != storedUnixTime || storedVersion.size() == 0
-        || storedArchitecture.size() == 0 || storedRealArchitecture.size() == 0
-        || storedVendor.size() == 0)
+    m_realJavaPath = realJavaPath;
+    if (!isKnown(settings, realJavaPath))
     {
         m_JavaChecker.reset(new JavaChecker);
         emit logLine(QString("Checking Java version..."), MessageLevel::Launcher);
@@ -136,11 +149,7 @@ void CheckJava::checkJavaFinished(JavaCheckResult result)
         {
             auto instance = m_parent->instance();
             printJavaInfo(result.javaVersion.toString(), result.mojangPlatform, result.realPlatform, result.javaVendor);
-            instance->settings()->set("JavaVersion", result.javaVersion.toString());
-            instance->settings()->set("JavaArchitecture", result.mojangPlatform);
-            instance->settings()->set("JavaRealArchitecture", result.realPlatform);
-            instance->settings()->set("JavaVendor", result.javaVendor);
-            instance->settings()->set("JavaTimestamp", m_javaUnixTime);
+            remember(instance->settings(), m_realJavaPath, result);
             emitSucceeded();
             return;
         }
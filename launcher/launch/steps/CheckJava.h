@@ -18,6 +18,7 @@
 #include <launch/LaunchStep.h>
 #include <LoggedProcess.h>
 #include <java/JavaChecker.h>
+#include <settings/SettingsObject.h>
 
 class CheckJava: public LaunchStep
 {
@@ -31,6 +32,13 @@ public:
     {
         return false;
     }
+
+    /// the Java binary the settings of an instance point at, empty when it can't be found
+    static QString javaBinary(SettingsObjectPtr settings);
+    /// whether what the settings say about the binary is still current, so it doesn't need checking
+    static bool isKnown(SettingsObjectPtr settings, const QString &javaBinary);
+    /// writes what a check found out about the binary to the settings
+    static void remember(SettingsObjectPtr settings, const QString &javaBinary, const JavaCheckResult &result);
 private slots:
     void checkJavaFinished(JavaCheckResult result);
 
@@ -40,6 +48,6 @@ private:
 
 private:
     QString m_javaPath;
-    qlonglong m_javaUnixTime;
+    QString m_realJavaPath;
     JavaCheckerPtr m_JavaChecker;
 };
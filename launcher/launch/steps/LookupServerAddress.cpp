@@ -17,6 +17,7 @@
 #include "LookupServerAddress.h"
 
 #include <launch/LaunchTask.h>
+#include "minecraft/ServerPing.h"
 
 LookupServerAddress::LookupServerAddress(LaunchTask *parent) :
     LaunchStep(parent), m_dnsLookup(new QDnsLookup(this))
@@ -46,6 +47,14 @@ bool LookupServerAddress::abort()
 
 void LookupServerAddress::executeTask()
 {
+    // the servers page looks the servers up when pinging them, no need to wait for DNS again
+    if (auto resolved = ServerStatusCache::resolved(m_lookupAddress))
+    {
+        emit logLine(QString("Resolved server address %1 to %2 with port %3 (cached)\n").arg(
+                m_dnsLookup->name(), resolved->address, QString::number(resolved->port)), MessageLevel::Launcher);
+        resolve(resolved->address, resolved->port);
+        return;
+    }
     m_dnsLookup->lookup();
 }
 
@@ -72,6 +81,8 @@ void LookupServerAddress::on_dnsLookupFinished()
         emit logLine(
                 QString("Failed to resolve server address %1: the DNS lookup succeeded, but no records were returned.\n")
                 .arg(m_dnsLookup->name()), MessageLevel::Warning);
+        // no records is an answer too, keep it like the servers page does
+        ServerStatusCache::setResolved(m_lookupAddress, { m_lookupAddress, 25565 }, 0);
         resolve(m_lookupAddress, 25565); // Technically the task failed, however, we don't abort the launch
                                                       // and leave it up to minecraft to fail (or maybe not) when connecting
         return;
@@ -82,6 +93,7 @@ void LookupServerAddress::on_dnsLookupFinished()
 
     emit logLine(QString("Resolved server address %1 to %2 with port %3\n").arg(
             m_dnsLookup->name(), firstRecord.target(), QString::number(port)),MessageLevel::Launcher);
+    ServerStatusCache::setResolved(m_lookupAddress, { firstRecord.target(), port }, firstRecord.timeToLive());
     resolve(firstRecord.target(), port);
 }
 
@@ -64,6 +64,16 @@ int main(int argc, char *argv[])
     QGuiApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
 #endif
 
+    // there is no display to use on the machines that run it headless, nothing is shown anyway
+    for (int i = 1; i < argc; i++)
+    {
+        if (qstrcmp(argv[i], "--headless") == 0 && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+            break;
+        }
+    }
+
     // initialize Qt
     Application app(argc, argv);
 
@@ -15,14 +15,28 @@
 
 #include "BaseEntity.h"
 
+#include <QCryptographicHash>
+#include <QFileInfo>
+
 #include "net/Download.h"
 #include "net/HttpMetaCache.h"
 #include "net/NetJob.h"
+#include "FileSystem.h"
 #include "Json.h"
 
 #include "BuildConfig.h"
 #include "Application.h"
 
+namespace {
+// How long files without a published checksum (the index itself) are considered fresh, in seconds
+constexpr qint64 refreshInterval = 60 * 60;
+
+QString sha256Of(const QByteArray &data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex();
+}
+}
+
 class ParsingValidator : public Net::Validator
 {
 public: /* con/des */
@@ -55,6 +69,7 @@ public: /* methods */
             auto doc = Json::requireDocument(data, fname);
             auto obj = Json::requireObject(doc, fname);
             m_entity->parse(obj);
+            m_entity->setLocalSha256(sha256Of(data));
             return true;
         }
         catch (const Exception &e)
@@ -90,16 +105,24 @@ QUrl Meta::BaseEntity::url() const
 bool Meta::BaseEntity::loadLocalFile()
 {
     const QString fname = QDir("meta").absoluteFilePath(localFilename());
-    if (!QFile::exists(fname))
+    QFileInfo info(fname);
+    if (!info.exists())
     {
         return false;
     }
-    // TODO: check if the file has the expected checksum
     try
     {
-        auto doc = Json::requireDocument(fname, fname);
+        auto data = HttpMetaCache::readFile(fname);
+        auto doc = Json::requireDocument(data, fname);
         auto obj = Json::requireObject(doc, fname);
         parse(obj);
+        m_localSha256 = sha256Of(data);
+        m_localFileTime = info.lastModified();
+        if (!m_sha256.isEmpty() && m_localSha256 != m_sha256)
+        {
+            // still good enough to be used offline
+            qDebug() << fname << "doesn't match the checksum published in the index, it will be updated";
+        }
         return true;
     }
     catch (const Exception &e)
@@ -140,6 +163,8 @@ void Meta::BaseEntity::load(Net::Mode loadType)
     m_updateStatus = UpdateStatus::InProgress;
     QObject::connect(m_updateTask.get(), &NetJob::succeeded, [&]()
     {
+        m_localFileTime = QFileInfo(QDir("meta").absoluteFilePath(localFilename())).lastModified();
+        m_lastRemoteUpdate = QDateTime::currentDateTimeUtc();
         m_loadStatus = LoadStatus::Remote;
         m_updateStatus = UpdateStatus::Succeeded;
         m_updateTask.reset();
@@ -160,7 +185,34 @@ bool Meta::BaseEntity::isLoaded() const
 bool Meta::BaseEntity::shouldStartRemoteUpdate() const
 {
     // TODO: version-locks and offline mode?
-    return m_updateStatus != UpdateStatus::InProgress;
+    if(m_updateStatus == UpdateStatus::InProgress)
+    {
+        return false;
+    }
+    if(isVerified())
+    {
+        return false;
+    }
+    // Without a published checksum to compare with, only look for a newer file once in a while.
+    // Files known to be outdated are looked for again, unless they were just downloaded.
+    QDateTime lastUpdate = m_lastRemoteUpdate;
+    if(!lastUpdate.isValid() && m_sha256.isEmpty() && isLoaded())
+    {
+        lastUpdate = m_localFileTime;
+    }
+    return !lastUpdate.isValid() || lastUpdate.secsTo(QDateTime::currentDateTimeUtc()) >= refreshInterval;
+}
+
+bool Meta::BaseEntity::isVerified() const
+{
+    return isLoaded() && !m_sha256.isEmpty() && m_localSha256 == m_sha256;
+}
+
+void Meta::BaseEntity::setLoadedFromSnapshot(const QString &localSha256, const QDateTime &localFileTime)
+{
+    m_localSha256 = localSha256;
+    m_localFileTime = localFileTime;
+    m_loadStatus = LoadStatus::Local;
 }
 
 Task::Ptr Meta::BaseEntity::getCurrentTask()
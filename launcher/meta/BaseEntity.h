@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <QDateTime>
 #include <QJsonObject>
 #include <QObject>
 #include "QObjectPtr.h"
@@ -53,9 +54,23 @@ public:
     bool isLoaded() const;
     bool shouldStartRemoteUpdate() const;
 
+    /** The sha256 of the file, as published by the index or version list pointing to it. Empty when unknown. */
+    QString sha256() const { return m_sha256; }
+    /** The sha256 of the local file that was loaded. Empty when nothing was loaded from the disk. */
+    QString localSha256() const { return m_localSha256; }
+    QDateTime localFileTime() const { return m_localFileTime; }
+    /** Whether the loaded file is the one published by the index, so there's no need to look for a newer one. */
+    bool isVerified() const;
+
     void load(Net::Mode loadType);
     Task::Ptr getCurrentTask();
 
+public: // for usage by parsers and the snapshot only
+    void setSha256(const QString &sha256) { m_sha256 = sha256; }
+    void setLocalSha256(const QString &sha256) { m_localSha256 = sha256; }
+    /** The contents of the local file were restored from the snapshot instead of being parsed. */
+    void setLoadedFromSnapshot(const QString &localSha256, const QDateTime &localFileTime);
+
 protected: /* methods */
     bool loadLocalFile();
 
@@ -63,5 +78,9 @@ private:
     LoadStatus m_loadStatus = LoadStatus::NotLoaded;
     UpdateStatus m_updateStatus = UpdateStatus::NotDone;
     NetJob::Ptr m_updateTask;
+    QString m_sha256;
+    QString m_localSha256;
+    QDateTime m_localFileTime;
+    QDateTime m_lastRemoteUpdate;
 };
 }
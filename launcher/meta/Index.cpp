@@ -15,13 +15,136 @@
 
 #include "Index.h"
 
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+
+#include "FileSystem.h"
+#include "MemoryAccounting.h"
 #include "VersionList.h"
 #include "JsonFormat.h"
 
 namespace Meta
 {
+namespace
+{
+const quint32 snapshotMagic = 0x4d534e50; // "MSNP"
+const quint32 snapshotVersion = 1;
+const char *snapshotFilename = "snapshot.bin";
+
+// What the parsed data came from. The data is only good as long as the file didn't change.
+struct SnapshotSource
+{
+    QString filename;
+    qint64 size = -1;
+    qint64 lastModified = 0;
+    QString localSha256;
+};
+
+QDataStream &operator<<(QDataStream &out, const SnapshotSource &source)
+{
+    return out << source.filename << source.size << source.lastModified << source.localSha256;
+}
+
+QDataStream &operator>>(QDataStream &in, SnapshotSource &source)
+{
+    return in >> source.filename >> source.size >> source.lastModified >> source.localSha256;
+}
+
+bool describeSource(const QDir &metaDir, const BaseEntity &entity, SnapshotSource &source)
+{
+    QFileInfo info(metaDir.absoluteFilePath(entity.localFilename()));
+    // we can only vouch for files that weren't replaced since they were parsed
+    if (entity.localSha256().isEmpty() || !info.exists() || info.lastModified() != entity.localFileTime())
+    {
+        return false;
+    }
+    source.filename = entity.localFilename();
+    source.size = info.size();
+    source.lastModified = info.lastModified().toMSecsSinceEpoch();
+    source.localSha256 = entity.localSha256();
+    return true;
+}
+
+bool isUnchanged(const QDir &metaDir, const SnapshotSource &source)
+{
+    QFileInfo info(metaDir.absoluteFilePath(source.filename));
+    return info.exists() && info.size() == source.size && info.lastModified().toMSecsSinceEpoch() == source.lastModified;
+}
+
+void writeRequires(QDataStream &out, const RequireSet &reqs)
+{
+    out << qint32(reqs.size());
+    for (const auto &req : reqs)
+    {
+        out << req.uid << req.equalsVersion << req.suggests;
+    }
+}
+
+RequireSet readRequires(QDataStream &in)
+{
+    RequireSet reqs;
+    qint32 count = 0;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; i++)
+    {
+        Require req;
+        in >> req.uid >> req.equalsVersion >> req.suggests;
+        reqs.insert(req);
+    }
+    return reqs;
+}
+
+void writeVersions(QDataStream &out, const QVector<Version::Ptr> &versions)
+{
+    out << qint32(versions.size());
+    for (const auto &version : versions)
+    {
+        out << version->version() << version->type() << version->rawTime() << version->isRecommended() << version->isVolatile()
+            << version->sha256();
+        writeRequires(out, version->requiredSet());
+        writeRequires(out, version->conflictSet());
+    }
+}
+
+QVector<Version::Ptr> readVersions(QDataStream &in, const QString &uid)
+{
+    QVector<Version::Ptr> versions;
+    qint32 count = 0;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; i++)
+    {
+        QString name, type, sha256;
+        qint64 time = 0;
+        bool recommended = false, isVolatile = false;
+        in >> name >> type >> time >> recommended >> isVolatile >> sha256;
+        auto reqs = readRequires(in);
+        auto conflicts = readRequires(in);
+
+        // the same as parsing the version list would give
+        auto version = std::make_shared<Version>(uid, name);
+        version->setType(type);
+        version->setTime(time);
+        version->setRecommended(recommended);
+        version->setVolatile(isVolatile);
+        version->setRequires(reqs, conflicts);
+        version->setProvidesRecommendations();
+        version->setSha256(sha256);
+        versions.append(version);
+    }
+    return versions;
+}
+
+struct SnapshotList
+{
+    SnapshotSource source;
+    VersionList::Ptr list;
+};
+}
+
 Index::Index(QObject *parent)
-    : QAbstractListModel(parent)
+    : Index({}, parent)
 {
 }
 Index::Index(const QVector<VersionList::Ptr> &lists, QObject *parent)
@@ -32,6 +155,23 @@ Index::Index(const QVector<VersionList::Ptr> &lists, QObject *parent)
         m_uids.insert(m_lists.at(i)->uid(), m_lists.at(i));
         connectVersionList(i, m_lists.at(i));
     }
+
+    // the versions, and the version files of those that were loaded
+    MemoryAccounting::track(this, "Metadata", [this] {
+        MemoryAccounting::Usage usage;
+        for (auto &list : m_lists)
+        {
+            usage.bytes += qint64(sizeof(VersionList)) + MemoryAccounting::bytesOf(list->name());
+            for (auto &version : list->versions())
+            {
+                usage.items++;
+                usage.bytes += qint64(sizeof(Version)) + MemoryAccounting::bytesOf(version->version());
+                if (version->isLoaded())
+                    usage.bytes += qint64(sizeof(VersionFile));
+            }
+        }
+        return usage;
+    });
 }
 
 QVariant Index::data(const QModelIndex &index, int role) const
@@ -103,6 +243,128 @@ void Index::parse(const QJsonObject& obj)
     parseIndex(obj, this);
 }
 
+bool Index::loadSnapshot(const QString &metaDir)
+{
+    const QDir dir(metaDir);
+    QByteArray data;
+    try
+    {
+        data = FS::read(dir.absoluteFilePath(snapshotFilename));
+    }
+    catch (const Exception &)
+    {
+        return false;
+    }
+
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_12);
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != snapshotMagic || version != snapshotVersion)
+    {
+        return false;
+    }
+
+    SnapshotSource indexSource;
+    in >> indexSource;
+    qint32 count = 0;
+    in >> count;
+    QVector<VersionList::Ptr> lists;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; i++)
+    {
+        QString uid, name, sha256;
+        in >> uid >> name >> sha256;
+        auto list = std::make_shared<VersionList>(uid);
+        list->setName(name);
+        list->setSha256(sha256);
+        lists.append(list);
+    }
+
+    in >> count;
+    QVector<SnapshotList> versionLists;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; i++)
+    {
+        SnapshotList entry;
+        QString uid, name;
+        in >> entry.source >> uid >> name;
+        entry.list = std::make_shared<VersionList>(uid);
+        entry.list->setName(name);
+        entry.list->setVersions(readVersions(in, uid));
+        versionLists.append(entry);
+    }
+
+    // don't restore half of a damaged snapshot
+    if (in.status() != QDataStream::Ok || !isUnchanged(dir, indexSource))
+    {
+        return false;
+    }
+
+    merge(std::make_shared<Index>(lists));
+    setLoadedFromSnapshot(indexSource.localSha256, QDateTime::fromMSecsSinceEpoch(indexSource.lastModified));
+    for (const auto &entry : versionLists)
+    {
+        if (!isUnchanged(dir, entry.source))
+        {
+            continue;
+        }
+        auto list = get(entry.list->uid());
+        if (list->isLoaded())
+        {
+            continue;
+        }
+        list->merge(entry.list);
+        list->setLoadedFromSnapshot(entry.source.localSha256, QDateTime::fromMSecsSinceEpoch(entry.source.lastModified));
+    }
+    return true;
+}
+
+void Index::saveSnapshot(const QString &metaDir) const
+{
+    const QDir dir(metaDir);
+    SnapshotSource indexSource;
+    if (!isLoaded() || !describeSource(dir, *this, indexSource))
+    {
+        return;
+    }
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << snapshotMagic << snapshotVersion << indexSource;
+
+    out << qint32(m_lists.size());
+    for (const auto &list : m_lists)
+    {
+        out << list->uid() << list->name() << list->sha256();
+    }
+
+    QVector<SnapshotList> versionLists;
+    for (const auto &list : m_uids)
+    {
+        SnapshotList entry;
+        if (list->isLoaded() && describeSource(dir, *list, entry.source))
+        {
+            entry.list = list;
+            versionLists.append(entry);
+        }
+    }
+    out << qint32(versionLists.size());
+    for (const auto &entry : versionLists)
+    {
+        out << entry.source << entry.list->uid() << entry.list->name();
+        writeVersions(out, entry.list->versions());
+    }
+
+    try
+    {
+        FS::write(dir.absoluteFilePath(snapshotFilename), data);
+    }
+    catch (const Exception &e)
+    {
+        qWarning() << "Unable to save the metadata snapshot:" << e.cause();
+    }
+}
+
 void Index::merge(const std::shared_ptr<Index> &other)
 {
     const QVector<VersionList::Ptr> lists = std::dynamic_pointer_cast<Index>(other)->m_lists;
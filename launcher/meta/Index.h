@@ -54,6 +54,16 @@ public:
 
     QVector<VersionList::Ptr> lists() const { return m_lists; }
 
+    /**
+     * Restores the index and the version lists saved by saveSnapshot(), in place of parsing their files.
+     * Only what comes from files left untouched since is restored.
+     *
+     * \return whether the index itself was restored
+     */
+    bool loadSnapshot(const QString &metaDir = "meta");
+    /** Saves the index and the version lists loaded so far, for the next session. */
+    void saveSnapshot(const QString &metaDir = "meta") const;
+
 public: // for usage by parsers only
     void merge(const std::shared_ptr<Index> &other);
     void parse(const QJsonObject &obj) override;
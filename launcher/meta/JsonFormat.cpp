@@ -19,6 +19,8 @@
 #include "minecraft/OneSixVersionFormat.h"
 #include "Json.h"
 
+#include <QSet>
+
 #include "Index.h"
 #include "Version.h"
 #include "VersionList.h"
@@ -43,22 +45,51 @@ static std::shared_ptr<Index> parseIndexInternal(const QJsonObject &obj)
     {
         VersionList::Ptr list = std::make_shared<VersionList>(requireString(obj, "uid"));
         list->setName(ensureString(obj, "name", QString()));
+        list->setSha256(ensureString(obj, "sha256", QString()));
         return list;
     });
     return std::make_shared<Index>(lists);
 }
 
+// The versions of a list repeat the same few strings (the types, what they require), which they share instead of
+// keeping a copy each
+using StringPool = QSet<QString>;
+
+static QString intern(StringPool *pool, const QString &string)
+{
+    if (!pool)
+        return string;
+    auto it = pool->constFind(string);
+    if (it == pool->constEnd())
+        it = pool->insert(string);
+    return *it;
+}
+
+static void parseRequires(const QJsonObject &obj, RequireSet *ptr, const char *keyName, StringPool *pool)
+{
+    if (!obj.contains(keyName))
+        return;
+    for (auto value : requireArray(obj, keyName))
+    {
+        auto reqObject = requireObject(value);
+        auto uid = intern(pool, requireString(reqObject, "uid"));
+        auto equals = intern(pool, ensureString(reqObject, "equals", QString()));
+        auto suggests = intern(pool, ensureString(reqObject, "suggests", QString()));
+        ptr->insert({uid, equals, suggests});
+    }
+}
+
 // Version
-static Version::Ptr parseCommonVersion(const QString &uid, const QJsonObject &obj)
+static Version::Ptr parseCommonVersion(const QString &uid, const QJsonObject &obj, StringPool *pool = nullptr)
 {
     Version::Ptr version = std::make_shared<Version>(uid, requireString(obj, "version"));
     version->setTime(QDateTime::fromString(requireString(obj, "releaseTime"), Qt::ISODate).toMSecsSinceEpoch() / 1000);
-    version->setType(ensureString(obj, "type", QString()));
+    version->setType(intern(pool, ensureString(obj, "type", QString())));
     version->setRecommended(ensureBoolean(obj, QString("recommended"), false));
     version->setVolatile(ensureBoolean(obj, QString("volatile"), false));
     RequireSet reqs, conflicts;
-    parseRequires(obj, &reqs, "requires");
-    parseRequires(obj, &conflicts, "conflicts");
+    parseRequires(obj, &reqs, "requires", pool);
+    parseRequires(obj, &conflicts, "conflicts", pool);
     version->setRequires(reqs, conflicts);
     return version;
 }
@@ -81,10 +112,12 @@ static VersionList::Ptr parseVersionListInternal(const QJsonObject &obj)
     const QVector<QJsonObject> versionsRaw = requireIsArrayOf<QJsonObject>(obj, "versions");
     QVector<Version::Ptr> versions;
     versions.reserve(versionsRaw.size());
-    std::transform(versionsRaw.begin(), versionsRaw.end(), std::back_inserter(versions), [uid](const QJsonObject &vObj)
+    StringPool pool;
+    std::transform(versionsRaw.begin(), versionsRaw.end(), std::back_inserter(versions), [uid, &pool](const QJsonObject &vObj)
     {
-        auto version = parseCommonVersion(uid, vObj);
+        auto version = parseCommonVersion(uid, vObj, &pool);
         version->setProvidesRecommendations();
+        version->setSha256(ensureString(vObj, "sha256", QString()));
         return version;
     });
 
@@ -174,20 +207,7 @@ void parseVersion(const QJsonObject &obj, Version *ptr)
 */
 void parseRequires(const QJsonObject& obj, RequireSet* ptr, const char * keyName)
 {
-    if(obj.contains(keyName))
-    {
-        auto reqArray = requireArray(obj, keyName);
-        auto iter = reqArray.begin();
-        while(iter != reqArray.end())
-        {
-            auto reqObject = requireObject(*iter);
-            auto uid = requireString(reqObject, "uid");
-            auto equals = ensureString(reqObject, "equals", QString());
-            auto suggests = ensureString(reqObject, "suggests", QString());
-            ptr->insert({uid, equals, suggests});
-            iter++;
-        }
-    }
+    parseRequires(obj, ptr, keyName, nullptr);
 }
 void serializeRequires(QJsonObject& obj, RequireSet* ptr, const char * keyName)
 {
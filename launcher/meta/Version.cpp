@@ -83,6 +83,11 @@ void Meta::Version::mergeFromList(const Meta::Version::Ptr& other)
     {
         setVolatile(other->m_volatile);
     }
+    // only version lists know the checksum of the version files
+    if(!other->sha256().isEmpty())
+    {
+        setSha256(other->sha256());
+    }
 }
 
 void Meta::Version::merge(const Version::Ptr &other)
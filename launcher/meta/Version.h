@@ -67,6 +67,14 @@ public:
     {
         return m_requires;
     }
+    const Meta::RequireSet &conflictSet() const
+    {
+        return m_conflicts;
+    }
+    bool isVolatile() const
+    {
+        return m_volatile;
+    }
     VersionFilePtr data() const
     {
         return m_data;
@@ -56,6 +56,7 @@ void VersionList::sortVersions()
     {
         return *a.get() < *b.get();
     });
+    indexParents();
     endResetModel();
 }
 
@@ -76,17 +77,12 @@ QVariant VersionList::data(const QModelIndex &index, int role) const
         return version->version();
     case ParentVersionRole:
     {
-        // FIXME: HACK: this should be generic and be replaced by something else. Anything that is a hard 'equals' dep is a 'parent uid'.
-        auto & reqs = version->requiredSet();
-        auto iter = std::find_if(reqs.begin(), reqs.end(), [](const Require & req)
-        {
-            return req.uid == "net.minecraft";
-        });
-        if (iter != reqs.end())
+        auto parent = m_parentVersions.value(index.row());
+        if (parent.isNull())
         {
-            return (*iter).equalsVersion;
+            return QVariant();
         }
-        return QVariant();
+        return parent;
     }
     case TypeRole: return version->type();
 
@@ -170,6 +166,7 @@ void VersionList::setVersions(const QVector<Version::Ptr> &versions)
     // FIXME: this is dumb, we have 'recommended' as part of the metadata already...
     auto recommendedIt = std::find_if(m_versions.constBegin(), m_versions.constEnd(), [](const Version::Ptr &ptr) { return ptr->type() == "release"; });
     m_recommended = recommendedIt == m_versions.constEnd() ? nullptr : *recommendedIt;
+    indexParents();
     endResetModel();
 }
 
@@ -200,6 +197,7 @@ void VersionList::mergeFromIndex(const VersionList::Ptr &other)
     {
         setName(other->m_name);
     }
+    setSha256(other->sha256());
 }
 
 void VersionList::merge(const VersionList::Ptr &other)
@@ -216,22 +214,25 @@ void VersionList::merge(const VersionList::Ptr &other)
     {
         qWarning() << "Empty list loaded ...";
     }
-    for (const Version::Ptr &version : other->m_versions)
+    for (Version::Ptr version : other->m_versions)
     {
-        // we already have the version. merge the contents
+        // we already have the version. merge the contents, and keep the object others may be holding on to
         if (m_lookup.contains(version->version()))
         {
-            m_lookup.value(version->version())->mergeFromList(version);
+            auto existing = m_lookup.value(version->version());
+            existing->mergeFromList(version);
+            version = existing;
         }
         else
         {
-            m_lookup.insert(version->uid(), version);
+            m_lookup.insert(version->version(), version);
         }
         // connect it.
         setupAddedVersion(m_versions.size(), version);
         m_versions.append(version);
         m_recommended = getBetterVersion(m_recommended, version);
     }
+    indexParents();
     endResetModel();
 }
 
@@ -239,11 +240,34 @@ void VersionList::setupAddedVersion(const int row, const Version::Ptr &version)
 {
     // FIXME: do not disconnect from everythin, disconnect only the lambdas here
     version->disconnect();
-    connect(version.get(), &Version::requiresChanged, this, [this, row]() { emit dataChanged(index(row), index(row), QVector<int>() << RequiresRole); });
+    connect(version.get(), &Version::requiresChanged, this, [this, row]() {
+        indexParents();
+        emit dataChanged(index(row), index(row), QVector<int>() << RequiresRole << ParentVersionRole);
+    });
     connect(version.get(), &Version::timeChanged, this, [this, row]() { emit dataChanged(index(row), index(row), QVector<int>() << TimeRole << SortRole); });
     connect(version.get(), &Version::typeChanged, this, [this, row]() { emit dataChanged(index(row), index(row), QVector<int>() << TypeRole); });
 }
 
+void VersionList::indexParents()
+{
+    m_parentVersions.clear();
+    m_parentVersions.reserve(m_versions.size());
+    m_parentRows.clear();
+    for (int row = 0; row < m_versions.size(); row++)
+    {
+        // FIXME: HACK: this should be generic and be replaced by something else. Anything that is a hard 'equals' dep is a 'parent uid'.
+        QString parent;
+        auto &reqs = m_versions.at(row)->requiredSet();
+        auto iter = std::find_if(reqs.begin(), reqs.end(), [](const Require &req) { return req.uid == "net.minecraft"; });
+        if (iter != reqs.end())
+        {
+            parent = iter->equalsVersion;
+            m_parentRows[parent].append(row);
+        }
+        m_parentVersions.append(parent);
+    }
+}
+
 BaseVersion::Ptr VersionList::getRecommended() const
 {
     return m_recommended;
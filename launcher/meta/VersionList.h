@@ -75,6 +75,17 @@ public:
         return m_versions;
     }
 
+    /// the version of Minecraft the version of the row requires exactly, empty when there's none
+    QString parentVersion(int row) const
+    {
+        return m_parentVersions.value(row);
+    }
+    /// the rows of the versions requiring exactly that version of Minecraft, in order, without going through all of them
+    QVector<int> rowsRequiring(const QString &minecraftVersion) const
+    {
+        return m_parentRows.value(minecraftVersion);
+    }
+
 public: // for usage only by parsers
     void setName(const QString &name);
     void setVersions(const QVector<Version::Ptr> &versions);
@@ -98,7 +109,12 @@ private:
 
     Version::Ptr m_recommended;
 
+    // what the versions require of Minecraft, by row and the other way around, for the selectors filtering on it
+    QVector<QString> m_parentVersions;
+    QHash<QString, QVector<int>> m_parentRows;
+
     void setupAddedVersion(const int row, const Version::Ptr &version);
+    void indexParents();
 };
 }
 Q_DECLARE_METATYPE(Meta::VersionList::Ptr)
@@ -36,15 +36,24 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QDirIterator>
+#include <QHash>
 #include <QCryptographicHash>
-#include <QJsonParseError>
-#include <QJsonDocument>
 #include <QJsonObject>
 #include <QVariant>
+#include <QDateTime>
+#include <QDataStream>
 #include <QDebug>
+#include <QMutex>
+#include <QSaveFile>
+#include <QSet>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cctype>
 
 #include "AssetsUtils.h"
 #include "FileSystem.h"
+#include "Json.h"
 #include "net/Download.h"
 #include "net/ChecksumValidator.h"
 #include "BuildConfig.h"
@@ -52,6 +61,419 @@
 #include "Application.h"
 
 namespace {
+// the objects checked at once on a thread of the pool
+constexpr size_t s_checkBatchSize = 256;
+
+/* The asset objects that were there the last time they were looked for, so the next launch doesn't have to stat
+ * each of them again. It's kept by folder of assets/objects with the folder's modification time: a folder where a
+ * file came or went since gets looked at again. */
+const QString s_presentPath = "cache/asset_objects_present";
+constexpr quint32 s_presentMagic = 0x41505253;  // APRS
+constexpr quint32 s_presentVersion = 1;
+QMutex s_presentMutex;
+
+struct PresentFolder
+{
+    qint64 modified = -1;
+    QSet<QByteArray> hashes;
+};
+
+QByteArray hashKey(const AssetsIndex::Entry &entry)
+{
+    return QByteArray(reinterpret_cast<const char *>(entry.hash.data()), int(entry.hash.size()));
+}
+
+qint64 folderModified(int folder)
+{
+    QFileInfo info(QString("assets/objects/%1").arg(folder, 2, 16, QChar('0')));
+    return info.isDir() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+QHash<int, PresentFolder> loadPresentObjects()
+{
+    QHash<int, PresentFolder> present;
+    QFile file(s_presentPath);
+    if (!file.open(QIODevice::ReadOnly))
+        return present;
+    QDataStream in(&file);
+    quint32 magic = 0, version = 0, folders = 0;
+    in >> magic >> version >> folders;
+    if (magic != s_presentMagic || version != s_presentVersion)
+        return present;
+    for (quint32 i = 0; i < folders && in.status() == QDataStream::Ok; i++)
+    {
+        quint8 folder = 0;
+        quint32 count = 0;
+        PresentFolder entry;
+        in >> folder >> entry.modified >> count;
+        for (quint32 j = 0; j < count && in.status() == QDataStream::Ok; j++)
+        {
+            QByteArray hash(20, Qt::Uninitialized);
+            in.readRawData(hash.data(), hash.size());
+            entry.hashes.insert(hash);
+        }
+        present.insert(folder, entry);
+    }
+    if (in.status() != QDataStream::Ok)
+        return {};
+    return present;
+}
+
+void savePresentObjects(const QHash<int, PresentFolder> &present)
+{
+    FS::ensureFolderPathExists(QFileInfo(s_presentPath).absolutePath());
+    QSaveFile file(s_presentPath);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    QDataStream out(&file);
+    out << s_presentMagic << s_presentVersion << quint32(present.size());
+    for (auto it = present.cbegin(); it != present.cend(); it++)
+    {
+        out << quint8(it.key()) << it->modified << quint32(it->hashes.size());
+        for (auto &hash : it->hashes)
+            out.writeRawData(hash.constData(), hash.size());
+    }
+    if (!file.commit())
+        qWarning() << "Failed to save the asset objects that are there to" << s_presentPath;
+}
+
+/* Reads an asset index straight into an AssetsIndex, without a QJsonDocument in between.
+ *
+ * Only the parts of JSON an index can have are handled, everything that isn't "objects", "virtual" or
+ * "map_to_resources" is skipped.
+ */
+class IndexParser
+{
+public:
+    IndexParser(const QByteArray &data, AssetsIndex &index)
+        : m_begin(data.constData()), m_pos(m_begin), m_end(m_begin + data.size()), m_index(index)
+    {
+    }
+
+    bool parse()
+    {
+        m_index.entries.clear();
+        m_index.paths.clear();
+        auto parsed = object([this](const QByteArray &key) {
+            if (key == "objects")
+                return object([this](const QByteArray &path) { return assetObject(path); });
+            if (key == "virtual")
+                return boolean(m_index.isVirtual);
+            if (key == "map_to_resources")
+                return boolean(m_index.mapToResources);
+            return skipValue();
+        });
+        skipSpace();
+        if (parsed && m_pos != m_end)
+            return fail("garbage after the document");
+        if (!parsed)
+            return false;
+        sortEntries();
+        return true;
+    }
+
+    QString error() const { return m_error; }
+    qint64 offset() const { return m_pos - m_begin; }
+
+private:
+    bool fail(const char *error)
+    {
+        if (m_error.isEmpty())
+            m_error = error;
+        return false;
+    }
+
+    void skipSpace()
+    {
+        while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t'))
+            m_pos++;
+    }
+
+    bool consume(char c)
+    {
+        skipSpace();
+        if (m_pos == m_end || *m_pos != c)
+            return false;
+        m_pos++;
+        return true;
+    }
+
+    template <typename Member>
+    bool object(Member member)
+    {
+        if (!consume('{'))
+            return fail("an object was expected");
+        if (consume('}'))
+            return true;
+        do
+        {
+            QByteArray key;
+            if (!string(key))
+                return false;
+            if (!consume(':'))
+                return fail("a colon was expected");
+            if (!member(key))
+                return false;
+        } while (consume(','));
+        if (!consume('}'))
+            return fail("a comma or the end of the object was expected");
+        return true;
+    }
+
+    static int hexDigit(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
+
+    bool codeUnit(uint &unit)
+    {
+        if (m_end - m_pos < 4)
+            return fail("an escape sequence was cut short");
+        unit = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            auto digit = hexDigit(*m_pos++);
+            if (digit < 0)
+                return fail("an escape sequence is invalid");
+            unit = unit * 16 + uint(digit);
+        }
+        return true;
+    }
+
+    static void appendUtf8(QByteArray &out, uint code)
+    {
+        if (code < 0x80)
+        {
+            out.append(char(code));
+        }
+        else if (code < 0x800)
+        {
+            out.append(char(0xC0 | (code >> 6)));
+            out.append(char(0x80 | (code & 0x3F)));
+        }
+        else if (code < 0x10000)
+        {
+            out.append(char(0xE0 | (code >> 12)));
+            out.append(char(0x80 | ((code >> 6) & 0x3F)));
+            out.append(char(0x80 | (code & 0x3F)));
+        }
+        else
+        {
+            out.append(char(0xF0 | (code >> 18)));
+            out.append(char(0x80 | ((code >> 12) & 0x3F)));
+            out.append(char(0x80 | ((code >> 6) & 0x3F)));
+            out.append(char(0x80 | (code & 0x3F)));
+        }
+    }
+
+    /// the string, in UTF-8
+    bool string(QByteArray &out)
+    {
+        if (!consume('"'))
+            return fail("a string was expected");
+        // most strings have no escapes at all, and go in one piece
+        auto start = m_pos;
+        while (m_pos < m_end && *m_pos != '"' && *m_pos != '\\')
+            m_pos++;
+        out = QByteArray(start, int(m_pos - start));
+        while (m_pos < m_end && *m_pos != '"')
+        {
+            if (*m_pos != '\\')
+            {
+                out.append(*m_pos++);
+                continue;
+            }
+            if (++m_pos == m_end)
+                break;
+            char escape = *m_pos++;
+            switch (escape)
+            {
+                case '"': out.append('"'); break;
+                case '\\': out.append('\\'); break;
+                case '/': out.append('/'); break;
+                case 'b': out.append('\b'); break;
+                case 'f': out.append('\f'); break;
+                case 'n': out.append('\n'); break;
+                case 'r': out.append('\r'); break;
+                case 't': out.append('\t'); break;
+                case 'u':
+                {
+                    uint code;
+                    if (!codeUnit(code))
+                        return false;
+                    if (code >= 0xD800 && code < 0xDC00)
+                    {
+                        uint low;
+                        if (m_end - m_pos < 2 || m_pos[0] != '\\' || m_pos[1] != 'u')
+                            return fail("a surrogate pair is incomplete");
+                        m_pos += 2;
+                        if (!codeUnit(low))
+                            return false;
+                        if (low < 0xDC00 || low >= 0xE000)
+                            return fail("a surrogate pair is invalid");
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default:
+                    return fail("an escape sequence is invalid");
+            }
+        }
+        if (m_pos == m_end)
+            return fail("a string isn't terminated");
+        m_pos++;
+        return true;
+    }
+
+    bool number(double &out)
+    {
+        skipSpace();
+        auto start = m_pos;
+        while (m_pos < m_end && (std::isdigit(uchar(*m_pos)) || *m_pos == '-' || *m_pos == '+' || *m_pos == '.' || *m_pos == 'e' || *m_pos == 'E'))
+            m_pos++;
+        bool ok = false;
+        out = QByteArray::fromRawData(start, int(m_pos - start)).toDouble(&ok);
+        return ok || fail("a number was expected");
+    }
+
+    bool literal(const char *word)
+    {
+        auto length = qstrlen(word);
+        if (size_t(m_end - m_pos) < length || qstrncmp(m_pos, word, length) != 0)
+            return false;
+        m_pos += length;
+        return true;
+    }
+
+    bool boolean(bool &out)
+    {
+        skipSpace();
+        if (literal("true"))
+            out = true;
+        else if (literal("false") || literal("null"))
+            out = false;
+        else
+            return fail("a boolean was expected");
+        return true;
+    }
+
+    bool skipValue()
+    {
+        skipSpace();
+        if (m_pos == m_end)
+            return fail("a value was expected");
+        switch (*m_pos)
+        {
+            case '{':
+                return object([this](const QByteArray &) { return skipValue(); });
+            case '[':
+            {
+                m_pos++;
+                if (consume(']'))
+                    return true;
+                do
+                {
+                    if (!skipValue())
+                        return false;
+                } while (consume(','));
+                return consume(']') || fail("a comma or the end of the array was expected");
+            }
+            case '"':
+            {
+                QByteArray ignored;
+                return string(ignored);
+            }
+            case 't':
+            case 'f':
+            case 'n':
+                return literal("true") || literal("false") || literal("null") || fail("a value was expected");
+            default:
+            {
+                double ignored;
+                return number(ignored);
+            }
+        }
+    }
+
+    bool assetObject(const QByteArray &path)
+    {
+        AssetsIndex::Entry entry{};
+        bool hasHash = false;
+        double size = 0;
+        auto parsed = object([&](const QByteArray &key) {
+            if (key == "size")
+                return number(size);
+            if (key != "hash")
+                return skipValue();
+            QByteArray hash;
+            if (!string(hash))
+                return false;
+            if (hash.size() != 40)
+                return fail("an object hash isn't a SHA-1");
+            for (int i = 0; i < 20; i++)
+            {
+                auto high = hexDigit(hash[2 * i]);
+                auto low = hexDigit(hash[2 * i + 1]);
+                if (high < 0 || low < 0)
+                    return fail("an object hash isn't a SHA-1");
+                entry.hash[i] = uchar(high * 16 + low);
+            }
+            hasHash = true;
+            return true;
+        });
+        if (!parsed)
+            return false;
+        if (!hasHash)
+            return fail("an object has no hash");
+        entry.size = qint64(size);
+        entry.pathOffset = quint32(m_index.paths.size());
+        entry.pathLength = quint32(path.size());
+        m_index.paths.append(path);
+        m_index.entries.push_back(entry);
+        return true;
+    }
+
+    void sortEntries()
+    {
+        auto &entries = m_index.entries;
+        auto paths = m_index.paths.constData();
+        auto less = [paths](const AssetsIndex::Entry &a, const AssetsIndex::Entry &b) {
+            return std::lexicographical_compare(paths + a.pathOffset, paths + a.pathOffset + a.pathLength,
+                                                paths + b.pathOffset, paths + b.pathOffset + b.pathLength,
+                                                [](char x, char y) { return uchar(x) < uchar(y); });
+        };
+        // the indexes come sorted, this is only a check then
+        if (!std::is_sorted(entries.begin(), entries.end(), less))
+            std::stable_sort(entries.begin(), entries.end(), less);
+
+        // like a JSON object, the last one of the same path wins
+        std::vector<AssetsIndex::Entry> unique;
+        unique.reserve(entries.size());
+        for (auto &entry : entries)
+        {
+            if (!unique.empty() && !less(unique.back(), entry))
+                unique.back() = entry;
+            else
+                unique.push_back(entry);
+        }
+        entries.swap(unique);
+    }
+
+private:
+    const char *m_begin;
+    const char *m_pos;
+    const char *m_end;
+    AssetsIndex &m_index;
+    QString m_error;
+};
+
 QSet<QString> collectPathsFromDir(QString dirPath)
 {
     QFileInfo dirInfo(dirPath);
@@ -71,7 +493,6 @@ QSet<QString> collectPathsFromDir(QString dirPath)
         if(info.isFile())
         {
             out.insert(value);
-            qDebug() << value;
         }
     }
     return out;
@@ -116,70 +537,12 @@ bool loadAssetsIndexJson(const QString &assetsId, const QString &path, AssetsInd
     QByteArray jsonData = file.readAll();
     file.close();
 
-    QJsonParseError parseError;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData, &parseError);
-
-    // Fail if the JSON is invalid.
-    if (parseError.error != QJsonParseError::NoError)
+    IndexParser parser(jsonData, index);
+    if (!parser.parse())
     {
-        qCritical() << "Failed to parse assets index file:" << parseError.errorString()
-                     << "at offset " << QString::number(parseError.offset);
+        qCritical() << "Failed to parse assets index file:" << parser.error() << "at offset" << QString::number(parser.offset());
         return false;
     }
-
-    // Make sure the root is an object.
-    if (!jsonDoc.isObject())
-    {
-        qCritical() << "Invalid assets index JSON: Root should be an array.";
-        return false;
-    }
-
-    QJsonObject root = jsonDoc.object();
-
-    QJsonValue isVirtual = root.value("virtual");
-    if (!isVirtual.isUndefined())
-    {
-        index.isVirtual = isVirtual.toBool(false);
-    }
-
-    QJsonValue mapToResources = root.value("map_to_resources");
-    if (!mapToResources.isUndefined())
-    {
-        index.mapToResources = mapToResources.toBool(false);
-    }
-
-    QJsonValue objects = root.value("objects");
-    QVariantMap map = objects.toVariant().toMap();
-
-    for (QVariantMap::const_iterator iter = map.begin(); iter != map.end(); ++iter)
-    {
-        // qDebug() << iter.key();
-
-        QVariant variant = iter.value();
-        QVariantMap nested_objects = variant.toMap();
-
-        AssetObject object;
-
-        for (QVariantMap::const_iterator nested_iter = nested_objects.begin();
-             nested_iter != nested_objects.end(); ++nested_iter)
-        {
-            // qDebug() << nested_iter.key() << nested_iter.value().toString();
-            QString key = nested_iter.key();
-            QVariant value = nested_iter.value();
-
-            if (key == "hash")
-            {
-                object.hash = value.toString();
-            }
-            else if (key == "size")
-            {
-                object.size = value.toDouble();
-            }
-        }
-
-        index.objects.insert(iter.key(), object);
-    }
-
     return true;
 }
 
@@ -263,42 +626,115 @@ bool reconstructAssets(QString assetsId, QString resourcesFolder)
 
     if (!targetPath.isNull())
     {
-        auto presentFiles = collectPathsFromDir(targetPath);
-        for (QString map : index.objects.keys())
+        // What we put there the last time, so we only have to act on what changed since then
+        QString manifestPath = FS::PathCombine(targetPath, ".lastused");
+        QHash<QString, QString> previous;
+        bool hasManifest = false;
+        try
         {
-            AssetObject asset_object = index.objects.value(map);
-            QString target_path = FS::PathCombine(targetPath, map);
-            QFile target(target_path);
+            auto manifest = Json::requireDocument(manifestPath, "assets manifest");
+            auto objects = Json::requireObject(Json::requireObject(manifest), "objects");
+            for (auto it = objects.constBegin(); it != objects.constEnd(); it++)
+            {
+                previous.insert(it.key(), it.value().toString());
+            }
+            hasManifest = true;
+        }
+        catch (const Exception&)
+        {
+            // first time, or from an older version: look at what is actually in there
+        }
 
-            QString tlk = asset_object.hash.left(2);
+        // Decide how to place the files once, asking the filesystems for every single file would be wasteful.
+        // Hard links are only used for the virtual folders: the resources folder belongs to the instance, and
+        // changing files in there must not change the shared objects.
+        FS::ensureFolderPathExists(targetPath);
+        bool canClone = FS::canClone(objectDir.absolutePath(), targetPath);
+        bool canLink = index.isVirtual && FS::canLink(objectDir.absolutePath(), targetPath);
+
+        QJsonObject placed;
+        int placedCount = 0;
+        int failedCount = 0;
+        for (int i = 0; i < index.size(); i++)
+        {
+            auto map = index.path(i);
+            auto asset_object = index.object(i);
 
-            QString original_path = FS::PathCombine(objectDir.path(), tlk, asset_object.hash);
-            QFile original(original_path);
-            if (!original.exists())
+            if (previous.value(map) == asset_object.hash)
+            {
+                // already there since the last time
+                placed.insert(map, asset_object.hash);
                 continue;
+            }
 
-            presentFiles.remove(target_path);
+            QString target_path = FS::PathCombine(targetPath, map);
+            QString original_path = FS::PathCombine(objectDir.path(), asset_object.hash.left(2), asset_object.hash);
 
-            if (!target.exists())
+            // Without a manifest, trust the files that are already there, like we always did
+            if (!hasManifest && QFile::exists(target_path))
             {
-                QFileInfo info(target_path);
-                QDir target_dir = info.dir();
+                placed.insert(map, asset_object.hash);
+                continue;
+            }
 
-                qDebug() << target_dir.path();
-                FS::ensureFolderPathExists(target_dir.path());
+            if (!QFile::exists(original_path))
+                continue;
 
-                bool couldCopy = original.copy(target_path);
-                qDebug() << " Copying" << original_path << "to" << target_path << QString::number(couldCopy);
+            if (FS::cloneOrLinkFile(original_path, target_path, canClone, canLink))
+            {
+                placed.insert(map, asset_object.hash);
+                placedCount++;
+            }
+            else
+            {
+                qWarning() << "Failed to place" << original_path << "at" << target_path;
+                failedCount++;
             }
         }
+        qDebug() << "Placed" << placedCount << "asset files in" << targetPath << "," << failedCount << "failed";
 
-        // TODO: Write last used time to virtualRoot/.lastused
-        if(removeLeftovers)
+        if (removeLeftovers)
         {
-            for(auto & file: presentFiles)
+            QStringList leftovers;
+            if (hasManifest)
+            {
+                for (auto it = previous.constBegin(); it != previous.constEnd(); it++)
+                {
+                    if (!index.contains(it.key()))
+                        leftovers.append(FS::PathCombine(targetPath, it.key()));
+                }
+            }
+            else
+            {
+                auto presentFiles = collectPathsFromDir(targetPath);
+                for (int i = 0; i < index.size(); i++)
+                {
+                    presentFiles.remove(FS::PathCombine(targetPath, index.path(i)));
+                }
+                presentFiles.remove(manifestPath);
+                leftovers = presentFiles.values();
+            }
+
+            for (auto& file : leftovers)
             {
-                qDebug() << "Would remove" << file;
+                if (QFile::exists(file) && !QFile::remove(file))
+                    qWarning() << "Failed to remove leftover asset" << file;
             }
+            if (!leftovers.isEmpty())
+                qDebug() << "Removed" << leftovers.size() << "leftover asset files from" << targetPath;
+        }
+
+        QJsonObject manifest;
+        manifest.insert("assetIndex", assetsId);
+        manifest.insert("lastUsed", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+        manifest.insert("objects", placed);
+        try
+        {
+            Json::write(manifest, manifestPath);
+        }
+        catch (const Exception& e)
+        {
+            qWarning() << "Failed to write the assets manifest:" << e.cause();
         }
     }
     return true;
@@ -306,50 +742,213 @@ bool reconstructAssets(QString assetsId, QString resourcesFolder)
 
 }
 
-NetAction::Ptr AssetObject::getDownloadAction()
+NetAction::Ptr AssetObject::getDownloadAction() const
 {
     QFileInfo objectFile(getLocalPath());
     if ((!objectFile.isFile()) || (objectFile.size() != size))
     {
-        auto objectDL = Net::Download::makeFile(getUrl(), objectFile.filePath());
-        if(hash.size())
-        {
-            auto rawHash = QByteArray::fromHex(hash.toLatin1());
-            objectDL->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawHash));
-        }
-        objectDL->setProgress(objectDL->getProgress(), size);
-        return objectDL;
+        return makeDownloadAction();
     }
     return nullptr;
 }
 
-QString AssetObject::getLocalPath()
+NetAction::Ptr AssetObject::makeDownloadAction() const
+{
+    // the objects are named by their hash and checked by their size before they're used, no need for a temporary file
+    auto options = hash.size() ? Net::Download::Option::Direct : Net::Download::Option::NoOptions;
+    auto objectDL = Net::Download::makeFile(getUrl(), getLocalPath(), options);
+    objectDL->routeThroughMirrors(Net::MirrorList::Kind::Assets);
+    if(hash.size())
+    {
+        auto rawHash = QByteArray::fromHex(hash.toLatin1());
+        objectDL->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawHash));
+    }
+    objectDL->setProgress(objectDL->getProgress(), size);
+    return objectDL;
+}
+
+QString AssetObject::getLocalPath() const
 {
     return "assets/objects/" + getRelPath();
 }
 
-QUrl AssetObject::getUrl()
+QUrl AssetObject::getUrl() const
 {
     return BuildConfig.RESOURCE_BASE + getRelPath();
 }
 
-QString AssetObject::getRelPath()
+QString AssetObject::getRelPath() const
 {
     return hash.left(2) + "/" + hash;
 }
 
-NetJob::Ptr AssetsIndex::getDownloadJob()
+AssetObject AssetsIndex::object(int i) const
 {
-    auto job = makeShared<NetJob>(QObject::tr("Assets for %1").arg(id), APPLICATION->network());
-    for (auto &object : objects.values())
+    auto &entry = entries[i];
+    AssetObject object;
+    object.hash = QString::fromLatin1(QByteArray::fromRawData(reinterpret_cast<const char *>(entry.hash.data()), int(entry.hash.size())).toHex());
+    object.size = entry.size;
+    return object;
+}
+
+QString AssetsIndex::path(int i) const
+{
+    auto &entry = entries[i];
+    return QString::fromUtf8(paths.constData() + entry.pathOffset, int(entry.pathLength));
+}
+
+bool AssetsIndex::contains(const QString &path) const
+{
+    auto key = path.toUtf8();
+    auto pool = paths.constData();
+    auto less = [](char x, char y) { return uchar(x) < uchar(y); };
+    auto it = std::lower_bound(entries.begin(), entries.end(), key, [&](const Entry &entry, const QByteArray &key) {
+        return std::lexicographical_compare(pool + entry.pathOffset, pool + entry.pathOffset + entry.pathLength,
+                                            key.constData(), key.constData() + key.size(), less);
+    });
+    return it != entries.end() && QByteArray::fromRawData(pool + it->pathOffset, int(it->pathLength)) == key;
+}
+
+QList<int> AssetsIndex::missingObjects() const
+{
+    // what was there the last time, by folder of assets/objects
+    QMutexLocker locker(&s_presentMutex);
+    auto present = loadPresentObjects();
+
+    QHash<int, QList<int>> byFolder;
+    for (int i = 0; i < size(); i++)
+        byFolder[entries[i].hash[0]].append(i);
+
+    std::vector<int> toCheck;
+    QHash<int, PresentFolder> checked;
+    for (auto it = byFolder.cbegin(); it != byFolder.cend(); it++)
     {
-        auto dl = object.getDownloadAction();
-        if(dl)
+        auto folder = it.key();
+        auto modified = folderModified(folder);
+        auto known = present.constFind(folder);
+        bool unchanged = modified >= 0 && known != present.cend() && known->modified == modified;
+
+        // taken before the checks, so what comes in meanwhile gets checked the next time
+        auto &result = checked[folder];
+        result.modified = modified;
+        for (auto i : it.value())
         {
-            job->addNetAction(dl);
+            if (unchanged && known->hashes.contains(hashKey(entries[i])))
+                result.hashes.insert(hashKey(entries[i]));
+            else
+                toCheck.push_back(i);
         }
     }
-    if(job->size())
-        return job;
-    return nullptr;
+
+    // a stat for each object, in batches on the pool
+    struct Batch
+    {
+        std::vector<int> objects;
+        std::vector<char> there;
+    };
+    std::vector<Batch> batches;
+    for (size_t start = 0; start < toCheck.size(); start += s_checkBatchSize)
+    {
+        Batch batch;
+        batch.objects.assign(toCheck.begin() + start, toCheck.begin() + std::min(toCheck.size(), start + s_checkBatchSize));
+        batches.push_back(std::move(batch));
+    }
+    QtConcurrent::blockingMap(batches, [this](Batch &batch) {
+        batch.there.reserve(batch.objects.size());
+        for (auto i : batch.objects)
+        {
+            QFileInfo objectFile(object(i).getLocalPath());
+            batch.there.push_back(objectFile.isFile() && objectFile.size() == entries[i].size);
+        }
+    });
+
+    QList<int> missing;
+    for (auto &batch : batches)
+    {
+        for (size_t j = 0; j < batch.objects.size(); j++)
+        {
+            auto i = batch.objects[j];
+            if (batch.there[j])
+                checked[entries[i].hash[0]].hashes.insert(hashKey(entries[i]));
+            else
+                missing.append(i);
+        }
+    }
+
+    if (!toCheck.empty())
+    {
+        // the folders this index has nothing in are kept the way they were
+        for (auto it = checked.begin(); it != checked.end(); it++)
+        {
+            if (it->modified < 0)
+                continue;
+            auto &known = present[it.key()];
+            if (known.modified != it->modified)
+                known.hashes.clear();
+            known.modified = it->modified;
+            known.hashes.unite(it->hashes);
+        }
+        savePresentObjects(present);
+    }
+    std::sort(missing.begin(), missing.end());
+    return missing;
+}
+
+NetJob::Ptr AssetsIndex::getDownloadJob() const
+{
+    return makeDownloadJob(missingObjects());
+}
+
+NetJob::Ptr AssetsIndex::makeDownloadJob(const QList<int> &objects) const
+{
+    if (objects.isEmpty())
+        return nullptr;
+    auto job = makeShared<NetJob>(QObject::tr("Assets for %1").arg(id), APPLICATION->network());
+    for (auto i : objects)
+    {
+        job->addNetAction(object(i).makeDownloadAction());
+    }
+    return job;
+}
+
+QList<int> AssetsIndex::takeDeferrable(QList<int> &objects) const
+{
+    if (isVirtual || mapToResources)
+        return {};
+
+    // how late the game likely needs them, -1 for what it needs to start
+    auto lateness = [](const QString &path)
+    {
+        if (!path.startsWith("minecraft/sounds/") || path.startsWith("minecraft/sounds/ui/") || path.startsWith("minecraft/sounds/random/"))
+            return -1;
+        if (path.startsWith("minecraft/sounds/music/") || path.startsWith("minecraft/sounds/records/"))
+            return 2;
+        if (path.startsWith("minecraft/sounds/ambient/") || path.startsWith("minecraft/sounds/mob/"))
+            return 1;
+        return 0;
+    };
+
+    QList<QPair<int, int>> deferred;
+    QList<int> now;
+    for (auto i : objects)
+    {
+        auto late = lateness(path(i));
+        if (late < 0)
+            now.append(i);
+        else
+            deferred.append({ late, i });
+    }
+    // the smaller ones first among those needed as soon, more of them are there sooner
+    std::sort(deferred.begin(), deferred.end(), [this](const QPair<int, int> &a, const QPair<int, int> &b) {
+        if (a.first != b.first)
+            return a.first < b.first;
+        return entries[a.second].size < entries[b.second].size;
+    });
+
+    objects = now;
+    QList<int> later;
+    later.reserve(deferred.size());
+    for (auto &object : deferred)
+        later.append(object.second);
+    return later;
 }
@@ -15,28 +15,66 @@
 
 #pragma once
 
+#include <QByteArray>
 #include <QString>
-#include <QMap>
+#include <QList>
+
+#include <array>
+#include <vector>
+
 #include "net/NetAction.h"
 #include "net/NetJob.h"
 
 struct AssetObject
 {
-    QString getRelPath();
-    QUrl getUrl();
-    QString getLocalPath();
-    NetAction::Ptr getDownloadAction();
+    QString getRelPath() const;
+    QUrl getUrl() const;
+    QString getLocalPath() const;
+    NetAction::Ptr getDownloadAction() const;
+    /// the download, without checking whether the object is there already
+    NetAction::Ptr makeDownloadAction() const;
 
     QString hash;
-    qint64 size;
+    qint64 size = 0;
 };
 
+/* An asset index, kept compact: a recent one has thousands of objects, and it's loaded for every launch.
+ *
+ * The objects are sorted by their path, with their SHA-1 as 20 bytes, and the paths are all in one pool. The
+ * AssetObjects and paths are only made when asked for.
+ */
 struct AssetsIndex
 {
-    NetJob::Ptr getDownloadJob();
+    struct Entry
+    {
+        std::array<uchar, 20> hash;
+        qint64 size;
+        // where the path is in `paths`, in UTF-8
+        quint32 pathOffset;
+        quint32 pathLength;
+    };
+
+    NetJob::Ptr getDownloadJob() const;
+    /// The download of those objects, nullptr when there are none.
+    NetJob::Ptr makeDownloadJob(const QList<int> &objects) const;
+
+    int size() const { return int(entries.size()); }
+    AssetObject object(int i) const;
+    QString path(int i) const;
+    bool contains(const QString &path) const;
+
+    /// The objects that aren't there, or not at their size. The checks run in parallel, and skip the objects that
+    /// were there the last time, in the folders of assets/objects that didn't change since.
+    QList<int> missingObjects() const;
+
+    /// Takes out of `objects` those the game can start without, in the order it will likely need them: the sounds,
+    /// the short effects first and the music last. The sounds of the menus stay, they're played right away. Nothing
+    /// is taken from the indexes that get copied into a folder before the launch.
+    QList<int> takeDeferrable(QList<int> &objects) const;
 
     QString id;
-    QMap<QString, AssetObject> objects;
+    std::vector<Entry> entries;
+    QByteArray paths;
     bool isVirtual = false;
     bool mapToResources = false;
 };
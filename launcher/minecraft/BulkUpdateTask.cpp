@@ -0,0 +1,233 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "BulkUpdateTask.h"
+
+#include <QSet>
+
+#include "minecraft/AssetsUtils.h"
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+#include "minecraft/update/FMLLibrariesTask.h"
+#include "minecraft/update/FoldersTask.h"
+#include "net/ChecksumValidator.h"
+#include "net/Download.h"
+#include "net/NetJob.h"
+#include "tasks/ConcurrentTask.h"
+
+#include "Application.h"
+
+BulkUpdateTask::BulkUpdateTask(const QList<InstancePtr>& instances, QObject* parent) : Task(parent)
+{
+    for (auto& instance : instances) {
+        auto minecraft = std::dynamic_pointer_cast<MinecraftInstance>(instance);
+        if (minecraft)
+            m_instances.append(minecraft);
+    }
+}
+
+void BulkUpdateTask::executeTask()
+{
+    qDebug() << (m_prefetch ? "Prefetching the updates of" : "Updating") << m_instances.size() << "instances at once";
+    resolveComponents();
+}
+
+bool BulkUpdateTask::abort()
+{
+    if (m_step)
+        return m_step->abort();
+    return Task::abort();
+}
+
+void BulkUpdateTask::resolveComponents()
+{
+    setStatus(tr("Resolving the components of %n instance(s)...", "", m_instances.size()));
+    auto step = makeShared<ConcurrentTask>(nullptr, tr("Resolving components"));
+    for (auto& instance : m_instances) {
+        auto inst = instance.get();
+        inst->updateRuntimeContext();
+
+        if (!m_prefetch) {
+            auto folders = makeShared<FoldersTask>(inst);
+            connect(folders.get(), &Task::failed, this, [this, inst](QString reason) { instanceFailed(inst, reason); });
+            step->addTask(folders);
+        }
+
+        auto components = inst->getPackProfile();
+        components->reload(Net::Mode::Online);
+        auto task = components->getCurrentTask();
+        if (task) {
+            connect(task.get(), &Task::failed, this, [this, inst](QString reason) { instanceFailed(inst, reason); });
+            step->addTask(task);
+        }
+    }
+    runStep(step, [this] { downloadLibrariesAndIndexes(); });
+}
+
+void BulkUpdateTask::downloadLibrariesAndIndexes()
+{
+    setStatus(tr("Downloading required library files..."));
+    auto job = makeShared<NetJob>(tr("Libraries for %n instance(s)", "", m_instances.size()), APPLICATION->network());
+    if (m_prefetch)
+        job->setPriority(Net::Priority::Background);
+    auto metacache = APPLICATION->metacache();
+
+    // the same library is the same download, whatever instance it is for
+    QSet<QString> urls;
+    auto addDownloads = [&](const QList<NetAction::Ptr>& downloads) {
+        for (auto& dl : downloads) {
+            auto url = dl->url().toString();
+            if (urls.contains(url))
+                continue;
+            urls.insert(url);
+            job->addNetAction(dl);
+        }
+    };
+
+    for (auto& instance : updatableInstances()) {
+        auto inst = instance.get();
+        auto profile = inst->getPackProfile()->getProfile();
+        if (!profile) {
+            instanceFailed(inst, tr("The components of the instance couldn't be resolved."));
+            continue;
+        }
+
+        QList<LibraryPtr> libArtifactPool;
+        libArtifactPool.append(profile->getLibraries());
+        libArtifactPool.append(profile->getNativeLibraries());
+        libArtifactPool.append(profile->getMavenFiles());
+        for (auto agent : profile->getAgents())
+            libArtifactPool.append(agent->library());
+        libArtifactPool.append(profile->getMainJar());
+
+        QList<NetAction::Ptr> downloads;
+        QStringList failedLocalFiles;
+        bool nullJar = false;
+        auto processArtifactPool = [&](const QList<LibraryPtr>& pool, const QString& localPath) {
+            for (auto lib : pool) {
+                if (!lib) {
+                    nullJar = true;
+                    return;
+                }
+                downloads.append(lib->getDownloads(inst->runtimeContext(), metacache.get(), failedLocalFiles, localPath));
+            }
+        };
+        processArtifactPool(libArtifactPool, inst->getLocalLibraryPath());
+        processArtifactPool(profile->getJarMods(), inst->jarModsDir());
+
+        if (nullJar) {
+            instanceFailed(inst, tr("Null jar is specified in the metadata."));
+            continue;
+        }
+        if (!failedLocalFiles.isEmpty()) {
+            instanceFailed(inst, tr("Some artifacts marked as 'local' are missing their files:\n%1").arg(failedLocalFiles.join("\n")));
+            continue;
+        }
+        addDownloads(downloads);
+
+        auto assets = profile->getMinecraftAssets();
+        if (!assets || m_assetIndexes.contains(assets->id))
+            continue;
+        m_assetIndexes.insert(assets->id, assets);
+
+        auto entry = metacache->resolveEntry("asset_indexes", assets->id + ".json");
+        entry->setStale(true);
+        auto dl = Net::Download::makeCached(QUrl(assets->url), entry);
+        dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, QByteArray::fromHex(assets->sha1.toLatin1())));
+        job->addNetAction(dl);
+    }
+
+    runStep(job, [this] { downloadAssets(); });
+}
+
+void BulkUpdateTask::downloadAssets()
+{
+    setStatus(tr("Getting the assets files from Mojang..."));
+    auto job = makeShared<NetJob>(tr("Assets for %n instance(s)", "", m_instances.size()), APPLICATION->network());
+    if (m_prefetch)
+        job->setPriority(Net::Priority::Background);
+
+    // asset indexes share most of their objects
+    QSet<QString> hashes;
+    for (auto it = m_assetIndexes.cbegin(); it != m_assetIndexes.cend(); it++) {
+        AssetsIndex index;
+        if (!AssetsUtils::loadAssetsIndexJson(it.key(), "assets/indexes/" + it.key() + ".json", index)) {
+            auto metacache = APPLICATION->metacache();
+            metacache->evictEntry(metacache->resolveEntry("asset_indexes", it.key() + ".json"));
+            for (auto& instance : updatableInstances()) {
+                auto assets = instance->getPackProfile()->getProfile()->getMinecraftAssets();
+                if (assets && assets->id == it.key())
+                    instanceFailed(instance.get(), tr("Failed to read the assets index!"));
+            }
+            continue;
+        }
+
+        for (auto i : index.missingObjects()) {
+            auto object = index.object(i);
+            if (hashes.contains(object.hash))
+                continue;
+            hashes.insert(object.hash);
+            job->addNetAction(object.makeDownloadAction());
+        }
+    }
+
+    // the FML libraries are copied into the instances, that's for the update itself
+    runStep(job, [this] { m_prefetch ? finish() : finalizeInstances(); });
+}
+
+void BulkUpdateTask::finalizeInstances()
+{
+    setStatus(tr("Finishing the update of the instances..."));
+    auto step = makeShared<ConcurrentTask>(nullptr, tr("Finishing the update of the instances"));
+    for (auto& instance : updatableInstances()) {
+        auto inst = instance.get();
+        auto fml = makeShared<FMLLibrariesTask>(inst);
+        connect(fml.get(), &Task::failed, this, [this, inst](QString reason) { instanceFailed(inst, reason); });
+        step->addTask(fml);
+    }
+    runStep(step, [this] { finish(); });
+}
+
+void BulkUpdateTask::finish()
+{
+    m_step.reset();
+    if (m_failures.isEmpty()) {
+        emitSucceeded();
+        return;
+    }
+
+    QStringList errors;
+    for (auto& instance : m_instances) {
+        if (m_failures.contains(instance.get()))
+            errors.append(QString("%1: %2").arg(instance->name(), m_failures.value(instance.get())));
+    }
+    emitFailed(tr("%n instance(s) could not be updated:\n%1", "", errors.size()).arg(errors.join("\n")));
+}
+
+void BulkUpdateTask::runStep(Task::Ptr step, std::function<void()> next)
+{
+    m_step = step;
+    connect(step.get(), &Task::succeeded, this, next);
+    connect(step.get(), &Task::failed, this, [this](QString reason) { emitFailed(reason); });
+    connect(step.get(), &Task::aborted, this, [this] { emitAborted(); });
+    connect(step.get(), &Task::progress, this, &BulkUpdateTask::setProgress);
+    connect(step.get(), &Task::stepProgress, this, &BulkUpdateTask::propogateStepProgress);
+    step->start();
+}
+
+void BulkUpdateTask::instanceFailed(MinecraftInstance* instance, const QString& reason)
+{
+    qWarning() << "Updating" << instance->name() << "failed:" << reason;
+    // the first error is the one that matters, the others usually follow from it
+    if (!m_failures.contains(instance))
+        m_failures.insert(instance, reason);
+}
+
+QList<std::shared_ptr<MinecraftInstance>> BulkUpdateTask::updatableInstances() const
+{
+    QList<std::shared_ptr<MinecraftInstance>> instances;
+    for (auto& instance : m_instances) {
+        if (!m_failures.contains(instance.get()))
+            instances.append(instance);
+    }
+    return instances;
+}
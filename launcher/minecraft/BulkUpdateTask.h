@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <functional>
+
+#include "BaseInstance.h"
+#include "minecraft/MojangDownloadInfo.h"
+#include "tasks/Task.h"
+
+class MinecraftInstance;
+
+/* Gets everything many instances need to launch, sharing the work between them.
+ *
+ * Doing what MinecraftUpdate does for each instance would download the libraries and assets the instances
+ * have in common once per instance. Instead, the components of all the instances are resolved, then everything
+ * they need is put together, and every library, asset index and asset object is downloaded once, by a single job.
+ * Each instance is then finalized on its own (the FML libraries that get copied into it).
+ *
+ * An instance that can't be updated doesn't stop the others. It is reported in the error once everything
+ * else is done.
+ */
+class BulkUpdateTask : public Task {
+    Q_OBJECT
+   public:
+    /** Instances that aren't Minecraft instances are ignored. */
+    explicit BulkUpdateTask(const QList<InstancePtr>& instances, QObject* parent = nullptr);
+    ~BulkUpdateTask() override = default;
+
+    bool canAbort() const override { return true; }
+
+    /** Only gets what the instances need into the caches, at background priority, for them to update from later. The
+     *  instances themselves are left alone. */
+    void setPrefetch(bool prefetch) { m_prefetch = prefetch; }
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    void resolveComponents();
+    void downloadLibrariesAndIndexes();
+    void downloadAssets();
+    void finalizeInstances();
+    void finish();
+
+    void runStep(Task::Ptr step, std::function<void()> next);
+    void instanceFailed(MinecraftInstance* instance, const QString& reason);
+    QList<std::shared_ptr<MinecraftInstance>> updatableInstances() const;
+
+   private:
+    QList<std::shared_ptr<MinecraftInstance>> m_instances;
+    QHash<MinecraftInstance*, QString> m_failures;
+    // id -> asset index, for all the instances
+    QHash<QString, MojangAssetIndexInfo::Ptr> m_assetIndexes;
+    Task::Ptr m_step;
+    bool m_prefetch = false;
+};
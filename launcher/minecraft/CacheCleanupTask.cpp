@@ -0,0 +1,262 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "CacheCleanupTask.h"
+
+#include <QDateTime>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+#include "Executors.h"
+#include "FileSystem.h"
+#include "StringUtils.h"
+#include "minecraft/AssetsUtils.h"
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+#include "net/HttpMetaCache.h"
+#include "tasks/ConcurrentTask.h"
+
+#include "Application.h"
+
+CacheCleanupTask::CacheCleanupTask(const QList<InstancePtr>& instances, bool dry_run, QObject* parent)
+    : Task(parent), m_dry_run(dry_run)
+{
+    for (auto& instance : instances) {
+        auto minecraft = std::dynamic_pointer_cast<MinecraftInstance>(instance);
+        if (minecraft)
+            m_instances.append(minecraft);
+    }
+    connect(&m_watcher, &QFutureWatcher<Result>::finished, this, &CacheCleanupTask::done);
+}
+
+void CacheCleanupTask::executeTask()
+{
+    if (APPLICATION->metacache()->getBudgetedBases().isEmpty()) {
+        emitSucceeded();
+        return;
+    }
+    resolveComponents();
+}
+
+bool CacheCleanupTask::abort()
+{
+    // files that are gone are gone, the sweep runs to its end
+    if (m_watcher.isRunning())
+        return false;
+    if (m_step)
+        return m_step->abort();
+    return Task::abort();
+}
+
+void CacheCleanupTask::resolveComponents()
+{
+    setStatus(tr("Resolving the components of %n instance(s)...", "", m_instances.size()));
+    auto step = makeShared<ConcurrentTask>(nullptr, tr("Resolving components"));
+    for (auto& instance : m_instances) {
+        auto inst = instance.get();
+        inst->updateRuntimeContext();
+
+        // what's there is what counts, nothing gets downloaded for this
+        auto components = inst->getPackProfile();
+        components->reload(Net::Mode::Offline);
+        auto task = components->getCurrentTask();
+        if (task) {
+            connect(task.get(), &Task::failed, this, [this, inst](QString reason) {
+                if (m_failure.isEmpty())
+                    m_failure = QString("%1: %2").arg(inst->name(), reason);
+            });
+            step->addTask(task);
+        }
+    }
+
+    m_step = step;
+    connect(step.get(), &Task::succeeded, this, &CacheCleanupTask::collect);
+    connect(step.get(), &Task::failed, this, [this](QString reason) {
+        if (m_failure.isEmpty())
+            m_failure = reason;
+        collect();
+    });
+    connect(step.get(), &Task::aborted, this, [this] { emitAborted(); });
+    connect(step.get(), &Task::progress, this, &CacheCleanupTask::setProgress);
+    connect(step.get(), &Task::stepProgress, this, &CacheCleanupTask::propogateStepProgress);
+    step->start();
+}
+
+void CacheCleanupTask::collect()
+{
+    m_step.reset();
+
+    // what none of the instances needs can't be told apart from what one of them does, so hands off
+    for (auto& instance : m_instances) {
+        if (!m_failure.isEmpty())
+            break;
+        if (!instance->getPackProfile()->getProfile())
+            m_failure = tr("The components of %1 couldn't be resolved.").arg(instance->name());
+    }
+    if (!m_failure.isEmpty()) {
+        emitFailed(tr("Nothing was removed, the files all the instances need aren't known:\n%1").arg(m_failure));
+        return;
+    }
+
+    setStatus(tr("Looking for files no instance needs..."));
+
+    QSet<QString> libraries;
+    QSet<QString> asset_indexes;
+    for (auto& instance : m_instances) {
+        auto profile = instance->getPackProfile()->getProfile();
+
+        QList<LibraryPtr> pool;
+        pool.append(profile->getLibraries());
+        pool.append(profile->getNativeLibraries());
+        pool.append(profile->getMavenFiles());
+        for (auto agent : profile->getAgents())
+            pool.append(agent->library());
+        pool.append(profile->getMainJar());
+        pool.append(profile->getJarMods());
+        for (auto& lib : pool) {
+            if (!lib)
+                continue;
+            for (auto& storage : lib->getCacheStorages(instance->runtimeContext()))
+                libraries.insert(storage);
+        }
+
+        auto assets = profile->getMinecraftAssets();
+        if (assets)
+            asset_indexes.insert(assets->id);
+    }
+
+    auto metacache = APPLICATION->metacache();
+    QList<Base> bases;
+    for (auto& name : metacache->getBudgetedBases()) {
+        Base base;
+        base.usage.base = name;
+        base.usage.budget = metacache->getBudget(name);
+        base.root = metacache->getBasePath(name);
+        if (name == "asset_objects") {
+            // downloaded without the metacache, the sweep looks at the folder instead
+            base.in_metacache = false;
+        } else {
+            for (auto& entry : metacache->getEntries(name))
+                base.files.append({ entry->getRelativePath(), entry->getFullPath(), entry->lastUsed() });
+        }
+        if (name == "libraries")
+            base.needed = libraries;
+        bases.append(base);
+    }
+
+    m_watcher.setFuture(QtConcurrent::run(Executors::background(), &CacheCleanupTask::sweep, bases,
+                                          asset_indexes.values(), m_dry_run));
+}
+
+auto CacheCleanupTask::sweep(QList<Base> bases, QStringList asset_indexes, bool dry_run) -> Result
+{
+    Result result;
+    for (auto& base : bases) {
+        if (!base.in_metacache) {
+            // an index that can't be read could need anything in there
+            bool known = true;
+            for (auto& id : asset_indexes) {
+                AssetsIndex index;
+                if (!AssetsUtils::loadAssetsIndexJson(id, "assets/indexes/" + id + ".json", index)) {
+                    known = false;
+                    break;
+                }
+                for (int i = 0; i < index.size(); i++)
+                    base.needed.insert(index.object(i).getRelPath());
+            }
+            if (!known) {
+                qWarning() << "Not cleaning up" << base.usage.base << "as an asset index couldn't be read";
+                continue;
+            }
+
+            QDirIterator it(base.root, QDir::Files, QDirIterator::Subdirectories);
+            QDir root(base.root);
+            while (it.hasNext()) {
+                auto path = it.next();
+                auto info = it.fileInfo();
+                auto last_used = qMax(info.lastRead(), info.lastModified()).toSecsSinceEpoch();
+                base.files.append({ root.relativeFilePath(path), path, last_used });
+            }
+        }
+
+        auto& usage = base.usage;
+        QList<std::pair<File, qint64>> candidates;
+        for (auto& file : base.files) {
+            QFileInfo info(file.full_path);
+            if (!info.isFile())
+                continue;
+            usage.size += info.size();
+            if (base.needed.contains(file.path))
+                usage.needed += info.size();
+            else
+                candidates.append({ file, info.size() });
+        }
+
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const std::pair<File, qint64>& a, const std::pair<File, qint64>& b) { return a.first.last_used < b.first.last_used; });
+
+        auto left = usage.size;
+        for (auto& [file, size] : candidates) {
+            if (left <= usage.budget)
+                break;
+            if (!dry_run && !QFile::remove(file.full_path)) {
+                qWarning() << "Failed to remove" << file.full_path << "from the cache";
+                continue;
+            }
+            left -= size;
+            usage.freed += size;
+            usage.files++;
+            if (base.in_metacache)
+                result.evicted[usage.base].append(file.path);
+        }
+        result.usage.append(usage);
+    }
+    return result;
+}
+
+void CacheCleanupTask::done()
+{
+    auto result = m_watcher.result();
+    if (!m_dry_run) {
+        auto metacache = APPLICATION->metacache();
+        for (auto it = result.evicted.cbegin(); it != result.evicted.cend(); ++it) {
+            for (auto& path : it.value())
+                metacache->evictEntry(metacache->getEntry(it.key(), path));
+        }
+    }
+    m_usage = result.usage;
+    qDebug() << "Cache cleanup" << (m_dry_run ? "would free" : "freed") << freed() << "bytes";
+    emitSucceeded();
+}
+
+QString CacheCleanupTask::report() const
+{
+    QStringList lines;
+    for (auto& usage : m_usage) {
+        auto line = tr("%1: %2 of %3, %4 of it needed by the instances.")
+                        .arg(usage.base, StringUtils::humanReadableFileSize(usage.size),
+                             StringUtils::humanReadableFileSize(usage.budget), StringUtils::humanReadableFileSize(usage.needed));
+        if (usage.files > 0) {
+            line += " ";
+            if (m_dry_run)
+                line += tr("%n file(s) (%1) would be removed.", "", usage.files).arg(StringUtils::humanReadableFileSize(usage.freed));
+            else
+                line += tr("%n file(s) (%1) removed.", "", usage.files).arg(StringUtils::humanReadableFileSize(usage.freed));
+        }
+        lines.append(line);
+    }
+    if (lines.isEmpty())
+        return tr("No cache has a size limit.");
+    return lines.join("\n");
+}
+
+qint64 CacheCleanupTask::freed() const
+{
+    qint64 freed = 0;
+    for (auto& usage : m_usage)
+        freed += usage.freed;
+    return freed;
+}
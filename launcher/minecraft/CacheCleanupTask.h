@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QStringList>
+
+#include "BaseInstance.h"
+#include "tasks/Task.h"
+
+class MinecraftInstance;
+
+/* Shrinks the caches that grew past their budget (see HttpMetaCache::setBudget()).
+ *
+ * The components of all the instances are resolved offline first, the way BulkUpdateTask does, so the libraries,
+ * asset indexes and asset objects any of them needs to launch are known. Those are never removed, whatever the budget.
+ * The other files of a base go, the least recently used first, until it fits in its budget again. The asset objects
+ * aren't in the metacache, so for them the last time the file was read or written counts.
+ *
+ * If the components of an instance can't be resolved, nothing is removed at all. A dry run only tells what would be.
+ */
+class CacheCleanupTask : public Task {
+    Q_OBJECT
+   public:
+    struct Usage {
+        QString base;
+        qint64 budget = 0;
+        qint64 size = 0;
+        // of what the instances need
+        qint64 needed = 0;
+        // or what would be, in a dry run
+        qint64 freed = 0;
+        int files = 0;
+    };
+
+    /** `instances` should be all of them, instances that aren't Minecraft instances are ignored. */
+    CacheCleanupTask(const QList<InstancePtr>& instances, bool dry_run, QObject* parent = nullptr);
+    ~CacheCleanupTask() override = default;
+
+    /** For each base with a budget, once the task is done. */
+    const QList<Usage>& usage() const { return m_usage; }
+    /** What usage() says, for people. */
+    QString report() const;
+    /** How much is (or would be) freed. */
+    qint64 freed() const;
+
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    struct File {
+        QString path;
+        QString full_path;
+        qint64 last_used = 0;
+    };
+    struct Base {
+        Usage usage;
+        QString root;
+        bool in_metacache = true;
+        QList<File> files;
+        QSet<QString> needed;
+    };
+    struct Result {
+        QList<Usage> usage;
+        // base -> removed paths that were metacache entries
+        QHash<QString, QStringList> evicted;
+    };
+
+    void resolveComponents();
+    void collect();
+    void done();
+
+    static Result sweep(QList<Base> bases, QStringList asset_indexes, bool dry_run);
+
+   private:
+    QList<std::shared_ptr<MinecraftInstance>> m_instances;
+    bool m_dry_run;
+    QString m_failure;
+    Task::Ptr m_step;
+    QList<Usage> m_usage;
+    QFutureWatcher<Result> m_watcher;
+};
@@ -169,6 +169,45 @@ static LoadResult loadIndex(Task::Ptr& loadTask, Net::Mode netmode)
     // FIXME: this is assuming the load succeeded... did it really?
     return LoadResult::LoadedLocal;
 }
+
+/*
+ * Starts loading the versions dependency resolution is going to add or switch to, so they are already there
+ * (or on their way) when it does, instead of being loaded one round of resolution after the other.
+ * Nothing waits on this, the next round of loading picks up whatever is still in progress.
+ */
+static void prefetchRequirements(const ComponentPtr &component, const ComponentIndex &index, Net::Mode netmode)
+{
+    if(netmode == Net::Mode::Offline)
+    {
+        return;
+    }
+    for(const auto &req: component->m_cachedRequires)
+    {
+        QString version = req.equalsVersion;
+        auto existing = index.constFind(req.uid);
+        if(existing != index.cend())
+        {
+            if(version.isEmpty() || (*existing)->getVersion() == version || !(*existing)->m_dependencyOnly)
+            {
+                continue;
+            }
+        }
+        else if(version.isEmpty())
+        {
+            version = req.suggests;
+        }
+        if(version.isEmpty())
+        {
+            continue;
+        }
+        auto metaVersion = APPLICATION->metadataIndex()->get(req.uid, version);
+        if(!metaVersion->isLoaded() && !metaVersion->getCurrentTask())
+        {
+            qDebug() << "Prefetching" << req.uid << version << "for" << component->getName();
+            metaVersion->load(netmode);
+        }
+    }
+}
 }
 
 void ComponentUpdateTask::loadComponents()
@@ -259,6 +298,11 @@ void ComponentUpdateTask::loadComponents()
         }
         componentIndex++;
     }
+    // the requirements cached from the last time are good enough to guess what's coming next
+    for (auto component: d->m_list->d->components)
+    {
+        prefetchRequirements(component, d->m_list->d->componentIndex, d->netmode);
+    }
     d->remoteTasksInProgress = taskIndex;
     switch(result)
     {
@@ -660,6 +704,7 @@ void ComponentUpdateTask::remoteLoadSucceeded(size_t taskIndex)
         auto component = d->m_list->getComponent(taskSlot.PackProfileIndex);
         component->m_loaded = true;
         component->updateCachedData();
+        prefetchRequirements(component, d->m_list->d->componentIndex, d->netmode);
     }
     checkIfAllFinished();
 }
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "GradleSpecifier.h"
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+
+namespace {
+struct Atoms {
+    QMutex mutex;
+    // the views are into the strings, which are never changed nor removed
+    QHash<QStringView, quint32> ids;
+    // by ID - 1
+    QList<QString> strings;
+};
+
+Atoms& atoms()
+{
+    static Atoms atoms;
+    return atoms;
+}
+}  // namespace
+
+GradleSpecifier& GradleSpecifier::operator=(const QString& value)
+{
+    // the same as matching ([^:@]+):([^:@]+):([^:@]+)(?::([^:@]+))?(?:@([^:@]+))? but without a regex, and with the parts as views
+    // group, artifact, version, classifier, extension
+    QStringView fields[5];
+    int count = 0;
+    bool inExtension = false;
+    bool valid = true;
+    int start = 0;
+    for (int i = 0; i <= value.size(); i++) {
+        const bool end = i == value.size();
+        if (!end && value.at(i) != ':' && value.at(i) != '@')
+            continue;
+        auto field = QStringView(value).mid(start, i - start);
+        if (field.isEmpty()) {
+            valid = false;
+            break;
+        }
+        if (inExtension) {
+            // nothing goes after the extension
+            valid = end;
+            fields[4] = field;
+            break;
+        }
+        if (count == 4) {
+            valid = false;
+            break;
+        }
+        fields[count++] = field;
+        inExtension = !end && value.at(i) == '@';
+        start = i + 1;
+    }
+
+    m_valid = valid && count >= 3;
+    if (!m_valid) {
+        m_invalidValue = value;
+        m_groupAtom = 0;
+        m_artifactAtom = 0;
+        return *this;
+    }
+    m_groupAtom = intern(fields[0], m_groupId);
+    m_artifactAtom = intern(fields[1], m_artifactId);
+    m_version = fields[2].toString();
+    m_classifier = fields[3].toString();
+    if (inExtension)
+        m_extension = fields[4].toString();
+    else
+        m_extension = DefaultVariable<QString>("jar");
+    return *this;
+}
+
+quint32 GradleSpecifier::intern(QStringView value, QString& interned)
+{
+    auto& table = atoms();
+    QMutexLocker locker(&table.mutex);
+    auto it = table.ids.constFind(value);
+    if (it != table.ids.constEnd()) {
+        interned = table.strings.at(*it - 1);
+        return *it;
+    }
+
+    interned = value.toString();
+    table.strings.append(interned);
+    auto id = static_cast<quint32>(table.strings.size());
+    table.ids.insert(QStringView(interned), id);
+    return id;
+}
@@ -37,6 +37,8 @@
 
 #include <QString>
 #include <QStringList>
+#include <QStringView>
+// not used here anymore, but many includers got it from here
 #include <QRegularExpression>
 #include "DefaultVariable.h"
 
@@ -50,35 +52,16 @@ struct GradleSpecifier
     {
         operator=(value);
     }
-    GradleSpecifier & operator =(const QString & value)
-    {
-        /*
-        org.gradle.test.classifiers : service : 1.0 : jdk15 @ jar
-         0 "org.gradle.test.classifiers:service:1.0:jdk15@jar"
-         1 "org.gradle.test.classifiers"
-         2 "service"
-         3 "1.0"
-         4 "jdk15"
-         5 "jar"
-        */
-        QRegularExpression matcher(QRegularExpression::anchoredPattern("([^:@]+):([^:@]+):([^:@]+)" "(?::([^:@]+))?" "(?:@([^:@]+))?"));
-        QRegularExpressionMatch match = matcher.match(value);
-        m_valid = match.hasMatch();
-        if(!m_valid) {
-            m_invalidValue = value;
-            return *this;
-        }
-        auto elements = match.captured();
-        m_groupId = match.captured(1);
-        m_artifactId = match.captured(2);
-        m_version = match.captured(3);
-        m_classifier = match.captured(4);
-        if(match.lastCapturedIndex() >= 5)
-        {
-            m_extension = match.captured(5);
-        }
-        return *this;
-    }
+    /*
+    org.gradle.test.classifiers : service : 1.0 : jdk15 @ jar
+     "org.gradle.test.classifiers:service:1.0:jdk15@jar"
+     group "org.gradle.test.classifiers"
+     artifact "service"
+     version "1.0"
+     classifier "jdk15"
+     extension "jar"
+    */
+    GradleSpecifier & operator =(const QString & value);
     QString serialize() const
     {
         if(!m_valid) {
@@ -159,15 +142,18 @@ struct GradleSpecifier
     {
         return m_groupId + ":" + m_artifactId;
     }
+    /// the group and artifact, as an ID that's the same for the same strings and different otherwise (0 when not valid)
+    inline quint64 nameId() const
+    {
+        return (quint64(m_groupAtom) << 32) | m_artifactAtom;
+    }
     bool matchName(const GradleSpecifier & other) const
     {
-        return other.artifactId() == artifactId() && other.groupId() == groupId() && other.classifier() == classifier();
+        return other.nameId() == nameId() && other.classifier() == classifier();
     }
     bool operator==(const GradleSpecifier & other) const
     {
-        if(m_groupId != other.m_groupId)
-            return false;
-        if(m_artifactId != other.m_artifactId)
+        if(nameId() != other.nameId())
             return false;
         if(m_version != other.m_version)
             return false;
@@ -177,6 +163,10 @@ struct GradleSpecifier
             return false;
         return true;
     }
+private:
+    /// the same ID for equal strings, and the same string data too, so equal groups and artifacts are only stored once
+    static quint32 intern(QStringView value, QString & interned);
+
 private:
     QString m_invalidValue;
     QString m_groupId;
@@ -184,5 +174,7 @@ private:
     QString m_version;
     QString m_classifier;
     DefaultVariable<QString> m_extension = DefaultVariable<QString>("jar");
+    quint32 m_groupAtom = 0;
+    quint32 m_artifactAtom = 0;
     bool m_valid = false;
 };
@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "InstanceLayer.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include "FileSystem.h"
+
+namespace {
+constexpr int s_format_version = 1;
+
+// what the base instance has besides its game folder that the layered one needs to play the same
+const QStringList s_instance_entries = { "mmc-pack.json", "patches", "jarmods", "libraries" };
+// the top-level entries of the game folder the game makes for each instance
+const QStringList s_own_game_entries = { "saves", "screenshots", "logs", "crash-reports", "backups", "icon.png", ".shadercache" };
+// the game only ever reads these, they can share their data with the base
+const QStringList s_archive_suffixes = { "jar", "zip", "litemod" };
+
+const QString s_instance_prefix = "instance/";
+const QString s_game_prefix = "game/";
+}  // namespace
+
+InstanceLayer::InstanceLayer(Roots roots) : m_roots(std::move(roots)) {}
+
+InstanceLayer::Stat InstanceLayer::stat(const QString& path)
+{
+    QFileInfo info(path);
+    if (!info.isFile())
+        return {};
+    return { info.size(), info.lastModified().toMSecsSinceEpoch() };
+}
+
+QString InstanceLayer::targetPath(const QString& key) const
+{
+    if (key.startsWith(s_instance_prefix))
+        return FS::PathCombine(m_roots.instance, key.mid(s_instance_prefix.size()));
+    return FS::PathCombine(m_roots.game, key.mid(s_game_prefix.size()));
+}
+
+QString InstanceLayer::basePath(const QString& key) const
+{
+    if (key.startsWith(s_instance_prefix))
+        return FS::PathCombine(m_roots.baseInstance, key.mid(s_instance_prefix.size()));
+    return FS::PathCombine(m_roots.baseGame, key.mid(s_game_prefix.size()));
+}
+
+QHash<QString, InstanceLayer::Stat> InstanceLayer::baseFiles() const
+{
+    QHash<QString, Stat> files;
+    auto add = [&files](const QString& root, const QString& prefix, const QFileInfo& entry) {
+        QDir dir(root);
+        if (entry.isFile()) {
+            files.insert(prefix + dir.relativeFilePath(entry.filePath()), { entry.size(), entry.lastModified().toMSecsSinceEpoch() });
+            return;
+        }
+        QDirIterator it(entry.filePath(), QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            auto info = it.fileInfo();
+            files.insert(prefix + dir.relativeFilePath(info.filePath()), { info.size(), info.lastModified().toMSecsSinceEpoch() });
+        }
+    };
+
+    for (auto& name : s_instance_entries) {
+        QFileInfo entry(FS::PathCombine(m_roots.baseInstance, name));
+        if (entry.exists())
+            add(m_roots.baseInstance, s_instance_prefix, entry);
+    }
+    auto gameEntries = QDir(m_roots.baseGame).entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot);
+    for (auto& entry : gameEntries) {
+        if (!s_own_game_entries.contains(entry.fileName(), Qt::CaseInsensitive))
+            add(m_roots.baseGame, s_game_prefix, entry);
+    }
+    return files;
+}
+
+InstanceLayer::Result InstanceLayer::compose() const
+{
+    Result result;
+    if (!QFileInfo(m_roots.baseInstance).isDir()) {
+        result.error = QObject::tr("The base instance is gone.");
+        return result;
+    }
+
+    Manifest manifest;
+    if (!load(manifest))
+        qWarning() << "Couldn't read the layer manifest of" << m_roots.instance << ", the files there are taken as its own";
+
+    auto base = baseFiles();
+    bool canClone = FS::canClone(m_roots.baseInstance, m_roots.instance);
+    bool canLink = FS::canLinkOnFS(m_roots.baseInstance) && FS::canLinkOnFS(m_roots.instance);
+
+    QStringList failed;
+    for (auto it = base.cbegin(); it != base.cend(); it++) {
+        auto& key = it.key();
+        auto& baseStat = it.value();
+        if (manifest.hidden.contains(key))
+            continue;
+
+        auto target = targetPath(key);
+        auto placed = manifest.placed.find(key);
+        if (placed != manifest.placed.end()) {
+            auto current = stat(target);
+            if (current.size < 0) {
+                // deleted by the instance, since it put it there it would have noticed
+                manifest.placed.erase(placed);
+                manifest.hidden.insert(key);
+                continue;
+            }
+            // a hard linked file changes with the base, that isn't a change of the instance
+            bool unchanged = current == Stat{ placed->size, placed->mtime } || current == baseStat;
+            if (!unchanged) {
+                manifest.placed.erase(placed);
+                result.overridden++;
+                continue;
+            }
+            if (baseStat == Stat{ placed->baseSize, placed->baseMtime } && current == Stat{ placed->size, placed->mtime })
+                continue;
+        } else if (QFileInfo::exists(target)) {
+            // the instance's own
+            continue;
+        }
+
+        bool archive = s_archive_suffixes.contains(QFileInfo(key).suffix(), Qt::CaseInsensitive);
+        if (!FS::cloneOrLinkFile(basePath(key), target, canClone, canLink && archive)) {
+            failed.append(key);
+            manifest.placed.remove(key);
+            continue;
+        }
+        auto now = stat(target);
+        manifest.placed.insert(key, { now.size, now.mtime, baseStat.size, baseStat.mtime });
+        result.placed++;
+    }
+
+    for (auto it = manifest.placed.begin(); it != manifest.placed.end();) {
+        if (base.contains(it.key())) {
+            it++;
+            continue;
+        }
+        auto target = targetPath(it.key());
+        auto current = stat(target);
+        if (current == Stat{ it->size, it->mtime }) {
+            if (QFile::remove(target))
+                result.removed++;
+        } else if (current.size >= 0) {
+            result.overridden++;
+        }
+        it = manifest.placed.erase(it);
+    }
+    for (auto it = manifest.hidden.begin(); it != manifest.hidden.end();) {
+        if (base.contains(*it))
+            it++;
+        else
+            it = manifest.hidden.erase(it);
+    }
+
+    if (!save(manifest))
+        result.error = QObject::tr("Couldn't write %1.").arg(manifestName());
+    else if (!failed.isEmpty())
+        result.error = QObject::tr("Couldn't place %1 in the instance.").arg(failed.join(", "));
+    return result;
+}
+
+bool InstanceLayer::load(Manifest& manifest) const
+{
+    QFile file(FS::PathCombine(m_roots.instance, manifestName()));
+    if (!file.exists())
+        return true;
+    if (!file.open(QFile::ReadOnly))
+        return false;
+    auto doc = QJsonDocument::fromJson(file.readAll());
+    auto root = doc.object();
+    if (!doc.isObject() || root.value("formatVersion").toInt() != s_format_version)
+        return false;
+
+    auto placed = root.value("placed").toObject();
+    for (auto it = placed.constBegin(); it != placed.constEnd(); it++) {
+        auto entry = it.value().toObject();
+        manifest.placed.insert(it.key(), { entry.value("size").toVariant().toLongLong(), entry.value("mtime").toVariant().toLongLong(),
+                                           entry.value("baseSize").toVariant().toLongLong(),
+                                           entry.value("baseMtime").toVariant().toLongLong() });
+    }
+    for (auto hidden : root.value("hidden").toArray())
+        manifest.hidden.insert(hidden.toString());
+    return true;
+}
+
+bool InstanceLayer::save(const Manifest& manifest) const
+{
+    QJsonObject placed;
+    for (auto it = manifest.placed.cbegin(); it != manifest.placed.cend(); it++) {
+        placed.insert(it.key(), QJsonObject{ { "size", it->size }, { "mtime", it->mtime }, { "baseSize", it->baseSize }, { "baseMtime", it->baseMtime } });
+    }
+    QJsonArray hidden;
+    for (auto& key : manifest.hidden)
+        hidden.append(key);
+    QJsonObject root{ { "formatVersion", s_format_version }, { "placed", placed }, { "hidden", hidden } };
+
+    QSaveFile file(FS::PathCombine(m_roots.instance, manifestName()));
+    if (!file.open(QFile::WriteOnly))
+        return false;
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+/* An instance made on top of a base instance, which only keeps the files it changed.
+ *
+ * Before each launch the missing files of the base are placed in the layered instance: its components, jar mods and
+ * libraries, and everything in its game folder but what the game makes for each instance (the worlds, screenshots,
+ * logs...). They are cloned when the filesystem can, the archives (mods, packs) are hard linked otherwise since the
+ * game never writes into them, and the rest is copied. What was placed is recorded in layer.json, so the next time
+ * only what changed in the base is placed again, and a file of the base the instance changed, or one it added, is
+ * left alone: it overrides the base from then on. A placed file the instance deleted stays deleted, and a placed file
+ * the base lost goes too, unless the instance changed it.
+ */
+class InstanceLayer {
+   public:
+    struct Roots {
+        QString instance;
+        QString game;
+        QString baseInstance;
+        QString baseGame;
+    };
+
+    struct Result {
+        QString error;
+        // the files of the base placed in the instance, again for those the base changed
+        int placed = 0;
+        // those the base lost
+        int removed = 0;
+        // those the instance changed, which are its own from now on
+        int overridden = 0;
+    };
+
+    explicit InstanceLayer(Roots roots);
+
+    /** Places what's missing of the base, see above. Neither instance should be running. */
+    Result compose() const;
+
+    /** The name of the file the placed files are recorded in, in the instance folder. */
+    static QString manifestName() { return "layer.json"; }
+
+   private:
+    // a file of the layered instance, by its path relative to the instance or game folder: "instance/mmc-pack.json",
+    // "game/config/foo.cfg"
+    struct Placed {
+        // of the placed file, and of the file of the base it was placed from
+        qint64 size = 0;
+        qint64 mtime = 0;
+        qint64 baseSize = 0;
+        qint64 baseMtime = 0;
+    };
+    struct Manifest {
+        QHash<QString, Placed> placed;
+        // placed files the instance deleted
+        QSet<QString> hidden;
+    };
+    struct Stat {
+        qint64 size = -1;
+        qint64 mtime = 0;
+        bool operator==(const Stat& other) const { return size == other.size && mtime == other.mtime; }
+    };
+
+    QHash<QString, Stat> baseFiles() const;
+    QString targetPath(const QString& key) const;
+    QString basePath(const QString& key) const;
+    static Stat stat(const QString& path);
+
+    bool load(Manifest& manifest) const;
+    bool save(const Manifest& manifest) const;
+
+   private:
+    Roots m_roots;
+};
@@ -0,0 +1,391 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "InstanceVerifyTask.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QSet>
+
+#include <algorithm>
+
+#include "FileSystem.h"
+#include "digest/Digest.h"
+#include "java/ManagedRuntime.h"
+#include "minecraft/AssetsUtils.h"
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+#include "modplatform/helpers/HashUtils.h"
+#include "modplatform/packwiz/Packwiz.h"
+#include "net/ChecksumValidator.h"
+#include "net/Download.h"
+#include "net/HttpMetaCache.h"
+#include "net/NetJob.h"
+
+#include "Application.h"
+
+namespace {
+// the files hashed at once on a thread of the pool
+constexpr size_t s_batch_size = 64;
+// the report lists that many of the files that weren't right, and counts the others
+constexpr int s_listed_files = 50;
+
+// what FileHashes knows of the hashes the packwiz metadata may have
+const QStringList s_mod_hash_types = { "md5", "sha1", "sha512", "murmur2" };
+}  // namespace
+
+InstanceVerifyTask::InstanceVerifyTask(std::shared_ptr<MinecraftInstance> instance, QObject* parent)
+    : Task(parent), m_instance(std::move(instance))
+{}
+
+InstanceVerifyTask::~InstanceVerifyTask()
+{
+    m_work.cancel();
+    m_work.waitForDone();
+}
+
+void InstanceVerifyTask::executeTask()
+{
+    setStatus(tr("Resolving the components of %1...").arg(m_instance->name()));
+    m_instance->updateRuntimeContext();
+
+    // what the files should be is what the metadata that's there says, nothing gets downloaded for it
+    auto components = m_instance->getPackProfile();
+    components->reload(Net::Mode::Offline);
+    auto task = components->getCurrentTask();
+    if (!task) {
+        collect();
+        return;
+    }
+    runStep(task, [this] { collect(); });
+}
+
+bool InstanceVerifyTask::abort()
+{
+    if (m_step)
+        return m_step->abort();
+    m_work.cancel();
+    if (isRunning())
+        emitAborted();
+    return true;
+}
+
+void InstanceVerifyTask::collect()
+{
+    m_step.reset();
+    if (!m_instance->getPackProfile()->getProfile()) {
+        emitFailed(tr("The components of the instance couldn't be resolved."));
+        return;
+    }
+
+    setStatus(tr("Looking for the files of the instance..."));
+    collectLibraries();
+    collectAssets();
+    collectMods();
+    check();
+}
+
+void InstanceVerifyTask::collectLibraries()
+{
+    auto profile = m_instance->getPackProfile()->getProfile();
+    auto base = APPLICATION->metacache()->getBasePath("libraries");
+
+    QList<LibraryPtr> pool;
+    pool.append(profile->getLibraries());
+    pool.append(profile->getNativeLibraries());
+    pool.append(profile->getMavenFiles());
+    for (auto agent : profile->getAgents())
+        pool.append(agent->library());
+    pool.append(profile->getMainJar());
+
+    auto instance = m_instance;
+    QSet<QString> seen;
+    for (auto& lib : pool) {
+        if (!lib)
+            continue;
+        for (auto& checksum : lib->getChecksums(m_instance->runtimeContext())) {
+            if (seen.contains(checksum.first))
+                continue;
+            seen.insert(checksum.first);
+
+            Item item;
+            item.name = checksum.first;
+            item.path = FS::PathCombine(base, checksum.first);
+            item.hash_type = "sha1";
+            item.hash = checksum.second;
+            // the file is out of the way by then, so the library's metacache entry is stale and gets downloaded
+            item.repair = [lib, instance] {
+                QStringList failed_local_files;
+                return lib->getDownloads(instance->runtimeContext(), APPLICATION->metacache().get(), failed_local_files,
+                                         instance->getLocalLibraryPath());
+            };
+            m_items->push_back(item);
+            m_libraries++;
+        }
+    }
+}
+
+void InstanceVerifyTask::collectAssets()
+{
+    auto assets = m_instance->getPackProfile()->getProfile()->getMinecraftAssets();
+    if (!assets)
+        return;
+
+    auto index_path = "assets/indexes/" + assets->id + ".json";
+    Item index_item;
+    index_item.name = index_path;
+    index_item.path = QFileInfo(index_path).absoluteFilePath();
+    index_item.hash_type = "sha1";
+    index_item.hash = assets->sha1;
+    index_item.repair = [assets]() -> QList<NetAction::Ptr> {
+        auto entry = APPLICATION->metacache()->resolveEntry("asset_indexes", assets->id + ".json");
+        entry->setStale(true);
+        auto dl = Net::Download::makeCached(QUrl(assets->url), entry);
+        dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, QByteArray::fromHex(assets->sha1.toLatin1())));
+        return { dl };
+    };
+    m_items->push_back(index_item);
+
+    AssetsIndex index;
+    if (!AssetsUtils::loadAssetsIndexJson(assets->id, index_path, index)) {
+        m_notes.append(tr("The asset index %1 couldn't be read, its objects will be checked once it's there again.").arg(assets->id));
+        return;
+    }
+
+    // objects with the same contents are the same file
+    QSet<QString> seen;
+    for (int i = 0; i < index.size(); i++) {
+        auto object = index.object(i);
+        if (seen.contains(object.hash))
+            continue;
+        seen.insert(object.hash);
+
+        Item item;
+        item.name = index.path(i);
+        item.path = QFileInfo(object.getLocalPath()).absoluteFilePath();
+        item.hash_type = "sha1";
+        item.hash = object.hash;
+        item.size = object.size;
+        item.repair = [object]() -> QList<NetAction::Ptr> { return { object.makeDownloadAction() }; };
+        m_items->push_back(item);
+        m_assets++;
+    }
+}
+
+void InstanceVerifyTask::collectMods()
+{
+    auto mods_root = m_instance->modsRoot();
+    QDir index_dir(FS::PathCombine(mods_root, ".index"));
+    for (auto& file : index_dir.entryList({ "*.pw.toml" }, QDir::Files)) {
+        auto mod = Packwiz::V1::getIndexForMod(index_dir, file);
+        if (mod.filename.isEmpty() || mod.hash.isEmpty() || !s_mod_hash_types.contains(mod.hash_format))
+            continue;
+
+        auto path = FS::PathCombine(mods_root, mod.filename);
+        if (!QFileInfo::exists(path) && QFileInfo::exists(path + ".disabled"))
+            path += ".disabled";
+
+        Item item;
+        item.name = mod.name.isEmpty() ? mod.filename : mod.name;
+        item.path = path;
+        item.hash_type = mod.hash_format;
+        item.hash = mod.hash;
+        item.is_mod = true;
+        // the ones the platform doesn't let us download (see BlockedModsDialog) can't be repaired
+        if (mod.url.isValid()) {
+            item.repair = [url = mod.url, path, type = mod.hash_format, hash = mod.hash]() -> QList<NetAction::Ptr> {
+                return { Net::Download::makeStored(url, path, type, hash, Net::Download::Option::KeepHashes) };
+            };
+        }
+        m_items->push_back(item);
+        m_mods++;
+    }
+}
+
+void InstanceVerifyTask::check()
+{
+    auto total = m_items->size();
+    setStatus(tr("Checking %n file(s)...", nullptr, static_cast<int>(total)));
+    setProgress(0, static_cast<qint64>(total));
+    if (total == 0) {
+        repair();
+        return;
+    }
+
+    for (size_t begin = 0; begin < total; begin += s_batch_size) {
+        auto end = std::min(begin + s_batch_size, total);
+        auto watcher = new QFutureWatcher<void>(this);
+        connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, count = static_cast<int>(end - begin)] {
+            watcher->deleteLater();
+            m_checked += count;
+            batchChecked();
+        });
+        m_pending++;
+        // each batch has its own items, and nothing else touches them until all the batches are done
+        watcher->setFuture(m_work.run(Executors::cpu(), [items = m_items, begin, end, work = &m_work] {
+            for (auto i = begin; i < end && !work->isCanceled(); i++)
+                (*items)[i].state = checkItem((*items)[i]);
+        }));
+    }
+}
+
+void InstanceVerifyTask::batchChecked()
+{
+    m_pending--;
+    if (!isRunning())
+        return;
+    setProgress(m_checked, static_cast<qint64>(m_items->size()));
+    if (m_pending == 0)
+        repair();
+}
+
+InstanceVerifyTask::State InstanceVerifyTask::checkItem(const Item& item)
+{
+    QFileInfo info(item.path);
+    if (!info.isFile())
+        return State::Missing;
+    if (item.size >= 0 && info.size() != item.size)
+        return State::Damaged;
+    if (item.hash.isEmpty())
+        return State::Intact;
+
+    QString actual;
+    if (item.is_mod) {
+        // the mod lists read their hashes from that cache, it gets what the file really is now
+        actual = Hashing::hashFile(item.path, false).get(item.hash_type);
+    } else {
+        QFile file(item.path);
+        Digest hash(QCryptographicHash::Sha1);
+        if (!file.open(QIODevice::ReadOnly) || !hash.addData(&file))
+            return State::Damaged;
+        actual = hash.result().toHex();
+    }
+    return actual.compare(item.hash, Qt::CaseInsensitive) == 0 ? State::Intact : State::Damaged;
+}
+
+void InstanceVerifyTask::repair()
+{
+    auto job = makeShared<NetJob>(tr("Repairing %1").arg(m_instance->name()), APPLICATION->network());
+    // libraries with both architectures of their natives give both downloads for each of them
+    QSet<QString> urls;
+    for (auto& item : *m_items) {
+        if (item.state == State::Intact)
+            continue;
+        if (!item.repair) {
+            m_unrepaired.append(item.name);
+            continue;
+        }
+        if (item.state == State::Damaged)
+            QFile::remove(item.path);
+        for (auto& dl : item.repair()) {
+            auto url = dl->url().toString();
+            if (urls.contains(url))
+                continue;
+            urls.insert(url);
+            job->addNetAction(dl);
+        }
+    }
+
+    if (job->size() == 0) {
+        checkRuntime();
+        return;
+    }
+    setStatus(tr("Downloading %n damaged or missing file(s)...", nullptr, job->size()));
+    runStep(job, [this] {
+        m_downloaded = true;
+        checkRuntime();
+    });
+}
+
+void InstanceVerifyTask::checkRuntime()
+{
+    m_step.reset();
+    m_runtime = ManagedRuntime::componentOf(m_instance->settings()->get("JavaPath").toString());
+    if (m_runtime.isEmpty()) {
+        finish();
+        return;
+    }
+
+    setStatus(tr("Checking the %1 Java runtime...").arg(m_runtime));
+    auto task = makeShared<ManagedRuntimeTask>(m_runtime, true);
+    m_step = task;
+    connect(task.get(), &Task::succeeded, this, [this, raw = task.get()] {
+        m_runtime_repaired = raw->downloadedFiles();
+        finish();
+    });
+    // the files of the instance are done by then, the report still tells about them
+    connect(task.get(), &Task::failed, this, [this](QString reason) {
+        m_unrepaired.append(tr("Java runtime %1 (%2)").arg(m_runtime, reason));
+        finish();
+    });
+    connect(task.get(), &Task::aborted, this, [this] { emitAborted(); });
+    connect(task.get(), &Task::progress, this, &InstanceVerifyTask::setProgress);
+    connect(task.get(), &Task::stepProgress, this, &InstanceVerifyTask::propogateStepProgress);
+    task->start();
+}
+
+void InstanceVerifyTask::finish()
+{
+    m_step.reset();
+    qDebug() << "Verified" << m_instance->name() << "-" << report();
+    if (m_unrepaired.isEmpty())
+        emitSucceeded();
+    else
+        emitFailed(report());
+}
+
+QString InstanceVerifyTask::report() const
+{
+    QStringList lines;
+    lines.append(tr("Checked %1 libraries, %2 asset objects and %3 mods of %4.")
+                     .arg(m_libraries)
+                     .arg(m_assets)
+                     .arg(m_mods)
+                     .arg(m_instance->name()));
+
+    QStringList files;
+    int wrong = 0;
+    for (auto& item : *m_items) {
+        if (item.state == State::Intact)
+            continue;
+        if (++wrong > s_listed_files)
+            continue;
+        auto state = item.state == State::Missing ? tr("missing") : tr("damaged");
+        if (!item.repair)
+            files.append(tr("%1: %2, it can't be downloaded again").arg(item.name, state));
+        else if (m_downloaded)
+            files.append(tr("%1: %2, downloaded again").arg(item.name, state));
+        else
+            files.append(tr("%1: %2").arg(item.name, state));
+    }
+    if (wrong == 0)
+        lines.append(tr("All of those files are intact."));
+    else
+        lines.append(tr("%n of those file(s) weren't right:", nullptr, wrong));
+    lines.append(files);
+    if (wrong > s_listed_files)
+        lines.append(tr("... and %n more.", nullptr, wrong - s_listed_files));
+
+    if (m_runtime_repaired == 0)
+        lines.append(tr("The files of the %1 Java runtime are intact.").arg(m_runtime));
+    else if (m_runtime_repaired > 0)
+        lines.append(tr("%n file(s) of the %1 Java runtime were downloaded again.", nullptr, m_runtime_repaired).arg(m_runtime));
+
+    lines.append(m_notes);
+    if (!m_unrepaired.isEmpty())
+        lines.append(tr("Couldn't repair: %1").arg(m_unrepaired.join(", ")));
+    return lines.join('\n');
+}
+
+void InstanceVerifyTask::runStep(Task::Ptr step, std::function<void()> next)
+{
+    m_step = step;
+    connect(step.get(), &Task::succeeded, this, next);
+    connect(step.get(), &Task::failed, this, [this](QString reason) { emitFailed(reason); });
+    connect(step.get(), &Task::aborted, this, [this] { emitAborted(); });
+    connect(step.get(), &Task::progress, this, &InstanceVerifyTask::setProgress);
+    connect(step.get(), &Task::stepProgress, this, &InstanceVerifyTask::propogateStepProgress);
+    step->start();
+}
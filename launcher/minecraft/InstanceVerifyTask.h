@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Executors.h"
+#include "net/NetAction.h"
+#include "tasks/Task.h"
+
+class MinecraftInstance;
+
+/* Checks that the files of an instance are what they should be, and gets the ones that aren't again.
+ *
+ * The libraries and the asset objects are hashed against the SHA-1 their metadata gives, the mods against the hash
+ * in their packwiz metadata. The files are all read again, whatever the hash caches say, on the hashing pool. Only
+ * the files that are missing or damaged are downloaded, all by one job. The Java runtime the launcher manages, when
+ * the instance uses one, is checked against its Mojang manifest the same way (see ManagedRuntimeTask).
+ *
+ * The components are resolved offline, nothing is downloaded to find out what the files should be. The task fails
+ * when some of the files couldn't be repaired, report() tells which.
+ */
+class InstanceVerifyTask : public Task {
+    Q_OBJECT
+   public:
+    explicit InstanceVerifyTask(std::shared_ptr<MinecraftInstance> instance, QObject* parent = nullptr);
+    ~InstanceVerifyTask() override;
+
+    bool canAbort() const override { return true; }
+
+    /** What was checked and what was repaired, once the task is done. */
+    QString report() const;
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    enum class State { Intact, Missing, Damaged };
+
+    struct Item {
+        // what the report calls it
+        QString name;
+        QString path;
+        // how the hash is checked: "sha1" on its own, the others along with the hash cache of the mods
+        QString hash_type;
+        QString hash;
+        qint64 size = -1;
+        bool is_mod = false;
+        // gets it again, once the damaged file is out of the way; empty when it can't be
+        std::function<QList<NetAction::Ptr>()> repair;
+        State state = State::Intact;
+    };
+
+    void collect();
+    void collectLibraries();
+    void collectAssets();
+    void collectMods();
+    void check();
+    void batchChecked();
+    void repair();
+    void checkRuntime();
+    void finish();
+
+    void runStep(Task::Ptr step, std::function<void()> next);
+
+    static State checkItem(const Item& item);
+
+   private:
+    std::shared_ptr<MinecraftInstance> m_instance;
+    std::shared_ptr<std::vector<Item>> m_items = std::make_shared<std::vector<Item>>();
+    int m_libraries = 0;
+    int m_assets = 0;
+    int m_mods = 0;
+    // of the batches on the hashing pool
+    int m_pending = 0;
+    int m_checked = 0;
+    bool m_downloaded = false;
+    QStringList m_notes;
+    QStringList m_unrepaired;
+    QString m_runtime;
+    int m_runtime_repaired = -1;
+    Task::Ptr m_step;
+    Executors::WorkGroup m_work;
+};
@@ -42,6 +42,7 @@ void LaunchProfile::clear()
     m_minecraftVersionType.clear();
     m_minecraftAssets.reset();
     m_minecraftArguments.clear();
+    m_minecraftArgumentTemplates.reset();
     m_addnJvmArguments.clear();
     m_tweakers.clear();
     m_mainClass.clear();
@@ -80,6 +81,7 @@ void LaunchProfile::applyMainClass(const QString& mainClass)
 void LaunchProfile::applyMinecraftArguments(const QString& minecraftArguments)
 {
     applyString(minecraftArguments, this->m_minecraftArguments);
+    m_minecraftArgumentTemplates.reset();
 }
 
 void LaunchProfile::applyAddnJvmArguments(const QStringList& addnJvmArguments)
@@ -318,6 +320,15 @@ QString LaunchProfile::getMinecraftArguments() const
     return m_minecraftArguments;
 }
 
+const QList<ArgumentTemplate> & LaunchProfile::getMinecraftArgumentTemplates() const
+{
+    if(!m_minecraftArgumentTemplates)
+    {
+        m_minecraftArgumentTemplates = ArgumentTemplate::parseArguments(m_minecraftArguments);
+    }
+    return *m_minecraftArgumentTemplates;
+}
+
 const QStringList & LaunchProfile::getAddnJvmArguments() const
 {
     return m_addnJvmArguments;
@@ -38,6 +38,9 @@
 #include "Library.h"
 #include "Agent.h"
 #include <ProblemProvider.h>
+#include "launch/ArgumentTemplate.h"
+
+#include <optional>
 
 class LaunchProfile: public ProblemProvider
 {
@@ -72,6 +75,8 @@ public: /* getters for profile variables */
     QString getMinecraftVersionType() const;
     MojangAssetIndexInfo::Ptr getMinecraftAssets() const;
     QString getMinecraftArguments() const;
+    /// the minecraft arguments, split up and parsed for their variables the first time they're needed
+    const QList<ArgumentTemplate> & getMinecraftArgumentTemplates() const;
     const QStringList & getAddnJvmArguments() const;
     const QSet<QString> & getTraits() const;
     const QStringList & getTweakers() const;
@@ -110,6 +115,7 @@ private:
      *      --version ${version_name} --gameDir ${game_directory} --assetsDir ${game_assets}"
      */
     QString m_minecraftArguments;
+    mutable std::optional<QList<ArgumentTemplate>> m_minecraftArgumentTemplates;
 
     /**
      * Additional arguments to pass to the JVM in addition to those the user has configured,
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "LaunchProfileCache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+#include "BuildConfig.h"
+#include "Exception.h"
+#include "meta/Version.h"
+#include "minecraft/LaunchProfile.h"
+#include "minecraft/OneSixVersionFormat.h"
+#include "minecraft/VersionFile.h"
+
+namespace LaunchProfileCache {
+
+namespace {
+constexpr quint32 s_magic = 0x4d434c50;  // "MCLP"
+constexpr quint32 s_version = 1;
+constexpr auto s_stream_version = QDataStream::Qt_5_12;
+
+// the profile, as the one version file that would make it up
+VersionFilePtr flatten(const LaunchProfile& profile)
+{
+    auto file = std::make_shared<VersionFile>();
+    // what only Minecraft itself gets to set is applied for it
+    file->uid = "net.minecraft";
+    file->version = profile.getMinecraftVersion();
+    file->minecraftVersion = profile.getMinecraftVersion();
+    file->type = profile.getMinecraftVersionType();
+    file->mojangAssetIndex = profile.getMinecraftAssets();
+    file->assets = file->mojangAssetIndex->id;
+    file->mainJar = profile.getMainJar();
+    file->mainClass = profile.getMainClass();
+    file->appletClass = profile.getAppletClass();
+    file->minecraftArguments = profile.getMinecraftArguments();
+    file->addnJvmArguments = profile.getAddnJvmArguments();
+    file->addTweakers = profile.getTweakers();
+    file->traits = profile.getTraits();
+    file->compatibleJavaMajors = profile.getCompatibleJavaMajors();
+    file->jarMods = profile.getJarMods();
+    // the natives go back to their own list when applied
+    file->libraries = profile.getLibraries() + profile.getNativeLibraries();
+    file->mavenFiles = profile.getMavenFiles();
+    file->agents = profile.getAgents();
+    return file;
+}
+}  // namespace
+
+QByteArray key(const QList<ComponentPtr>& components, const RuntimeContext& context)
+{
+    if (components.isEmpty())
+        return {};
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    auto add = [&hash](const QString& value) { hash.addData((value + '\n').toUtf8()); };
+    add(BuildConfig.printableVersionString());
+    add(context.javaArchitecture);
+    add(context.javaRealArchitecture);
+    add(context.system);
+    for (auto& component : components) {
+        add(component->getID());
+        add(component->m_version);
+        add(component->getVersion());
+        add(component->isEnabled() ? "enabled" : "disabled");
+
+        QString path;
+        if (component->m_metaVersion)
+            path = QDir("meta").absoluteFilePath(component->m_metaVersion->localFilename());
+        else if (component->m_file)
+            path = component->getFilename();
+        QFileInfo info(path);
+        // only in memory, or not loaded at all
+        if (path.isEmpty() || !info.isFile())
+            return {};
+        add(info.absoluteFilePath());
+        add(QString::number(info.size()));
+        add(QString::number(info.lastModified().toMSecsSinceEpoch()));
+    }
+    return hash.result();
+}
+
+std::shared_ptr<LaunchProfile> load(const QString& path, const QByteArray& key, const RuntimeContext& context)
+{
+    if (key.isEmpty())
+        return nullptr;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return nullptr;
+    QDataStream in(&file);
+    in.setVersion(s_stream_version);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QByteArray saved_key;
+    QByteArray data;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != s_magic || version != s_version)
+        return nullptr;
+    in >> saved_key;
+    if (in.status() != QDataStream::Ok || saved_key != key)
+        return nullptr;
+    in >> data;
+    if (in.status() != QDataStream::Ok)
+        return nullptr;
+
+    try {
+        auto flat = OneSixVersionFormat::versionFileFromJson(QJsonDocument::fromJson(data), path, false);
+        if (flat->getProblemSeverity() != ProblemSeverity::None)
+            return nullptr;
+        auto profile = std::make_shared<LaunchProfile>();
+        flat->applyTo(profile.get(), context);
+        return profile;
+    } catch (const Exception& e) {
+        qWarning() << "Couldn't read the cached launch profile" << path << ":" << e.cause();
+        return nullptr;
+    }
+}
+
+bool save(const QString& path, const QByteArray& key, const LaunchProfile& profile)
+{
+    if (key.isEmpty() || profile.getProblemSeverity() != ProblemSeverity::None)
+        return false;
+
+    auto data = OneSixVersionFormat::versionFileToJson(flatten(profile)).toJson(QJsonDocument::Compact);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream out(&file);
+    out.setVersion(s_stream_version);
+    out << s_magic << s_version << key << data;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+}  // namespace LaunchProfileCache
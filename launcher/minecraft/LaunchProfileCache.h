@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include <memory>
+
+#include "Component.h"
+#include "RuntimeContext.h"
+
+class LaunchProfile;
+
+/* The LaunchProfile of an instance as it was last put together from its components.
+ *
+ * Putting it together means applying every version file in order, merging their libraries and evaluating their rules.
+ * What comes out only changes with the components (their versions, whether they're enabled, and the files they're read
+ * from, by size and modification time) and with the runtime context the rules are evaluated for. The cached profile is
+ * saved as a single version file, with everything already merged, so loading it is one read and parse.
+ *
+ * key(), load() and save() only touch the disk besides the components, which key() needs the GUI thread for.
+ */
+namespace LaunchProfileCache {
+
+/** What the cached profile has to be saved with to be used. Empty when a component has no file to go by. */
+QByteArray key(const QList<ComponentPtr>& components, const RuntimeContext& context);
+
+/** The profile saved at `path`, when it was saved with `key`. */
+std::shared_ptr<LaunchProfile> load(const QString& path, const QByteArray& key, const RuntimeContext& context);
+
+/** Saves `profile` at `path`, unless it has problems, which should show up again the next time. */
+bool save(const QString& path, const QByteArray& key, const LaunchProfile& profile);
+
+}  // namespace LaunchProfileCache
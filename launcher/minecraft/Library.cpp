@@ -79,6 +79,71 @@ void Library::getApplicableFiles(const RuntimeContext & runtimeContext, QStringL
     }
 }
 
+QStringList Library::getCacheStorages(const RuntimeContext & runtimeContext) const
+{
+    if(isLocal())
+    {
+        return {};
+    }
+    QString raw_storage = storageSuffix(runtimeContext);
+    if(raw_storage.contains("${arch}"))
+    {
+        QString nat32Storage = raw_storage;
+        QString nat64Storage = raw_storage;
+        return { nat32Storage.replace("${arch}", "32"), nat64Storage.replace("${arch}", "64") };
+    }
+    return { raw_storage };
+}
+
+QList<QPair<QString, QString>> Library::getChecksums(const RuntimeContext & runtimeContext) const
+{
+    if(isLocal())
+    {
+        return {};
+    }
+    QList<QPair<QString, QString>> out;
+    QString raw_storage = storageSuffix(runtimeContext);
+    if(!m_mojangDownloads)
+    {
+        for(auto & storage : getCacheStorages(runtimeContext))
+        {
+            out.append({ storage, QString() });
+        }
+        return out;
+    }
+    if(!isNative())
+    {
+        if(m_mojangDownloads->artifact)
+        {
+            out.append({ raw_storage, m_mojangDownloads->artifact->sha1 });
+        }
+        return out;
+    }
+    auto nativeClassifier = getCompatibleNative(runtimeContext);
+    if(nativeClassifier.isNull())
+    {
+        return out;
+    }
+    // the same as getDownloads(), both architectures when the classifier is for either
+    QStringList archs = nativeClassifier.contains("${arch}") ? QStringList{ "32", "64" } : QStringList{ QString() };
+    for(auto & arch : archs)
+    {
+        auto classifier = nativeClassifier;
+        auto storage = raw_storage;
+        if(!arch.isNull())
+        {
+            classifier.replace("${arch}", arch);
+            storage.replace("${arch}", arch);
+        }
+        auto info = m_mojangDownloads->getDownloadInfo(classifier);
+        if(info)
+        {
+            out.append({ storage, info->sha1 });
+        }
+    }
+    return out;
+}
+
 QList<NetAction::Ptr> Library::getDownloads(
     const RuntimeContext & runtimeContext,
     class HttpMetaCache* cache,
@@ -126,19 +191,19 @@ QList<NetAction::Ptr> Library::getDownloads(
         // Don't add a time limit for the libraries cache entry validity
         options |= Net::Download::Option::MakeEternal;
 
+        auto dl = Net::Download::makeCached(url, entry, options);
+        dl->routeThroughMirrors(Net::MirrorList::Kind::Libraries);
         if(sha1.size())
         {
             auto rawSha1 = QByteArray::fromHex(sha1.toLatin1());
-            auto dl = Net::Download::makeCached(url, entry, options);
             dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawSha1));
             qDebug() << "Checksummed Download for:" << rawName().serialize() << "storage:" << storage << "url:" << url;
-            out.append(dl);
         }
         else
         {
-            out.append(Net::Download::makeCached(url, entry, options));
             qDebug() << "Download for:" << rawName().serialize() << "storage:" << storage << "url:" << url;
         }
+        out.append(dl);
         return true;
     };
 
@@ -238,14 +303,20 @@ QList<NetAction::Ptr> Library::getDownloads(
     return out;
 }
 
-bool Library::isActive(const RuntimeContext & runtimeContext) const
+void Library::evaluate(const RuntimeContext & runtimeContext) const
 {
-    bool result = true;
-    if (m_rules.empty())
+    if (m_evaluated && m_evaluated->system == runtimeContext.system
+        && m_evaluated->javaRealArchitecture == runtimeContext.javaRealArchitecture)
     {
-        result = true;
+        return;
     }
-    else
+
+    Evaluation evaluation;
+    evaluation.system = runtimeContext.system;
+    evaluation.javaRealArchitecture = runtimeContext.javaRealArchitecture;
+
+    bool result = true;
+    if (!m_rules.empty())
     {
         RuleAction ruleResult = Disallow;
         for (auto rule : m_rules)
@@ -254,13 +325,28 @@ bool Library::isActive(const RuntimeContext & runtimeContext) const
             if (temp != Defer)
                 ruleResult = temp;
         }
-        result = result && (ruleResult == Allow);
+        result = ruleResult == Allow;
     }
     if (isNative())
     {
-        result = result && !getCompatibleNative(runtimeContext).isNull();
+        // try to match precise classifier "[os]-[arch]"
+        auto entry = m_nativeClassifiers.constFind(runtimeContext.getClassifier());
+        // try to match imprecise classifier on legacy architectures "[os]"
+        if (entry == m_nativeClassifiers.constEnd() && runtimeContext.isLegacyArch())
+            entry = m_nativeClassifiers.constFind(runtimeContext.system);
+
+        if (entry != m_nativeClassifiers.constEnd())
+            evaluation.nativeClassifier = entry.value();
+        result = result && !evaluation.nativeClassifier.isNull();
     }
-    return result;
+    evaluation.active = result;
+    m_evaluated = evaluation;
+}
+
+bool Library::isActive(const RuntimeContext & runtimeContext) const
+{
+    evaluate(runtimeContext);
+    return m_evaluated->active;
 }
 
 bool Library::isLocal() const
@@ -274,16 +360,8 @@ bool Library::isAlwaysStale() const
 }
 
 QString Library::getCompatibleNative(const RuntimeContext & runtimeContext) const {
-    // try to match precise classifier "[os]-[arch]"
-    auto entry = m_nativeClassifiers.constFind(runtimeContext.getClassifier());
-    // try to match imprecise classifier on legacy architectures "[os]"
-    if (entry == m_nativeClassifiers.constEnd() && runtimeContext.isLegacyArch())
-        entry = m_nativeClassifiers.constFind(runtimeContext.system);
-
-    if (entry == m_nativeClassifiers.constEnd())
-        return QString();
-
-    return entry.value();
+    evaluate(runtimeContext);
+    return m_evaluated->nativeClassifier;
 }
 
 void Library::setStoragePrefix(QString prefix)
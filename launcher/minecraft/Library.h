@@ -44,6 +44,7 @@
 #include <QDir>
 #include <QUrl>
 #include <memory>
+#include <optional>
 
 #include "Rule.h"
 #include "GradleSpecifier.h"
@@ -173,6 +174,7 @@ public: /* methods */
     void setRules(QList<std::shared_ptr<Rule>> rules)
     {
         m_rules = rules;
+        m_evaluated.reset();
     }
 
     /// Returns true if the library should be loaded (or extracted, in case of natives)
@@ -191,6 +193,13 @@ public: /* methods */
     QList<NetAction::Ptr> getDownloads(const RuntimeContext & runtimeContext, class HttpMetaCache * cache,
                                      QStringList & failedLocalFiles, const QString & overridePath) const;
 
+    /// Get the paths getDownloads() may look up in the "libraries" base of the metacache
+    QStringList getCacheStorages(const RuntimeContext & runtimeContext) const;
+
+    /// Get the paths getDownloads() downloads to in the "libraries" base of the metacache, with the sha1 they should
+    /// have (empty when the metadata doesn't tell)
+    QList<QPair<QString, QString>> getChecksums(const RuntimeContext & runtimeContext) const;
+
     QString getCompatibleNative(const RuntimeContext & runtimeContext) const;
 
 private: /* methods */
@@ -208,6 +217,9 @@ private: /* methods */
         return m_hint;
     }
 
+    /// evaluates the rules and native classifiers for the context, unless they already were for the same one
+    void evaluate(const RuntimeContext & runtimeContext) const;
+
 protected: /* data */
     /// the basic gradle dependency specifier.
     GradleSpecifier m_name;
@@ -252,5 +264,19 @@ protected: /* data */
 
     /// MOJANG: container with Mojang style download info
     MojangLibraryDownloadInfo::Ptr m_mojangDownloads;
+
+private: /* data */
+    /**
+     * What the rules and native classifiers came to, for the system and architecture they were evaluated for.
+     * Those are all the rules look at, so the same context doesn't need them evaluated again.
+     */
+    struct Evaluation
+    {
+        QString system;
+        QString javaRealArchitecture;
+        bool active = false;
+        QString nativeClassifier;
+    };
+    mutable std::optional<Evaluation> m_evaluated;
 };
 
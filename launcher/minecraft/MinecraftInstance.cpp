@@ -43,6 +43,7 @@
 #include "settings/Setting.h"
 #include "settings/SettingsObject.h"
 #include "Application.h"
+#include "SystemProbe.h"
 
 #include "pathmatcher/RegexpMatcher.h"
 #include "pathmatcher/MultiMatcher.h"
@@ -50,6 +51,7 @@
 #include "java/JavaVersion.h"
 #include "MMCTime.h"
 
+#include "launch/ArgumentTemplate.h"
 #include "launch/LaunchTask.h"
 #include "launch/steps/LookupServerAddress.h"
 #include "launch/steps/PostLaunchCommand.h"
@@ -63,8 +65,12 @@
 #include "minecraft/launch/DirectJavaLaunch.h"
 #include "minecraft/launch/ModMinecraftJar.h"
 #include "minecraft/launch/ClaimAccount.h"
+#include "minecraft/launch/HeapSizing.h"
 #include "minecraft/launch/ReconstructAssets.h"
+#include "minecraft/launch/ComposeLayer.h"
 #include "minecraft/launch/ScanModFolders.h"
+#include "minecraft/launch/SyncPackwiz.h"
+#include "minecraft/launch/SnapshotWorlds.h"
 #include "minecraft/launch/VerifyJavaInstall.h"
 
 #include "java/JavaUtils.h"
@@ -85,6 +91,7 @@
 #include "AssetsUtils.h"
 #include "MinecraftUpdate.h"
 #include "MinecraftLoadAndCheck.h"
+#include "ShaderCache.h"
 #include "minecraft/gameoptions/GameOptions.h"
 #include "minecraft/update/FoldersTask.h"
 
@@ -145,6 +152,7 @@ void MinecraftInstance::loadSpecificSettings()
     if (auto global_settings = globalSettings()) {
         m_settings->registerOverride(global_settings->getSetting("JavaPath"), javaOrLocation);
         m_settings->registerOverride(global_settings->getSetting("JvmArgs"), javaOrArgs);
+        m_settings->registerOverride(global_settings->getSetting("JvmProfile"), javaOrArgs);
         m_settings->registerOverride(global_settings->getSetting("IgnoreJavaCompatibility"), javaOrLocation);
 
         // special!
@@ -152,6 +160,7 @@ void MinecraftInstance::loadSpecificSettings()
         m_settings->registerPassthrough(global_settings->getSetting("JavaVersion"), javaOrLocation);
         m_settings->registerPassthrough(global_settings->getSetting("JavaArchitecture"), javaOrLocation);
         m_settings->registerPassthrough(global_settings->getSetting("JavaRealArchitecture"), javaOrLocation);
+        m_settings->registerPassthrough(global_settings->getSetting("JavaVendor"), javaOrLocation);
 
         // Window Size
         auto windowSetting = m_settings->registerSetting("OverrideWindow", false);
@@ -164,6 +173,7 @@ void MinecraftInstance::loadSpecificSettings()
         m_settings->registerOverride(global_settings->getSetting("MinMemAlloc"), memorySetting);
         m_settings->registerOverride(global_settings->getSetting("MaxMemAlloc"), memorySetting);
         m_settings->registerOverride(global_settings->getSetting("PermGen"), memorySetting);
+        m_settings->registerOverride(global_settings->getSetting("AutoMemory"), memorySetting);
 
         // Minecraft launch method
         auto launchMethodOverride = m_settings->registerSetting("OverrideMCLaunchMethod", false);
@@ -179,22 +189,51 @@ void MinecraftInstance::loadSpecificSettings()
         m_settings->registerOverride(global_settings->getSetting("EnableFeralGamemode"), performanceOverride);
         m_settings->registerOverride(global_settings->getSetting("EnableMangoHud"), performanceOverride);
         m_settings->registerOverride(global_settings->getSetting("UseDiscreteGpu"), performanceOverride);
+        m_settings->registerOverride(global_settings->getSetting("AutoDiscreteGpu"), performanceOverride);
+        m_settings->registerOverride(global_settings->getSetting("ShaderCachePerInstance"), performanceOverride);
 
         // Miscellaneous
         auto miscellaneousOverride = m_settings->registerSetting("OverrideMiscellaneous", false);
         m_settings->registerOverride(global_settings->getSetting("CloseAfterLaunch"), miscellaneousOverride);
         m_settings->registerOverride(global_settings->getSetting("QuitAfterGameStop"), miscellaneousOverride);
+        m_settings->registerOverride(global_settings->getSetting("PrefetchUpdates"), miscellaneousOverride);
 
         m_settings->set("InstanceType", "OneSix");
     }
 
     // Join server on launch, this does not have a global override
-    m_settings->registerSetting("JoinServerOnLaunch", false);
-    m_settings->registerSetting("JoinServerOnLaunchAddress", "");
+    m_settings->declareSetting("JoinServerOnLaunch", false);
+    m_settings->declareSetting("JoinServerOnLaunchAddress", "");
+
+    // Packwiz pack to sync with before launching, see Packwiz::SyncTask
+    m_settings->declareSetting("PackwizSync", false);
+    m_settings->declareSetting("PackwizPackURL", "");
 
     // Use account for instance, this does not have a global override
-    m_settings->registerSetting("UseAccountForInstance", false);
-    m_settings->registerSetting("InstanceAccountId", "");
+    m_settings->declareSetting("UseAccountForInstance", false);
+    m_settings->declareSetting("InstanceAccountId", "");
+
+    // the most heap the game used, in MiB, for sizing it automatically
+    m_settings->declareSetting("HeapPeak", 0);
+
+    // Class data sharing archive of the instance, this does not have a global override
+    m_settings->declareSetting("UseClassDataSharing", false);
+
+    // Java process started ahead of the next launch, this does not have a global override
+    m_settings->declareSetting("KeepSpareJava", false);
+
+    // Scheduling and resource limits of the game process, see ProcessControls, these do not have a global override
+    m_settings->declareSetting("ProcessPriority", "normal");
+    m_settings->declareSetting("CpuAffinity", "");
+    m_settings->declareSetting("CpuQuota", 0);
+    m_settings->declareSetting("MemoryLimit", 0);
+
+    // Heap and collection reports of the launcher part, for the telemetry page, this does not have a global override
+    m_settings->declareSetting("LaunchTelemetry", true);
+
+    // Snapshots of the worlds after the game exits, see WorldSnapshots, these do not have a global override
+    m_settings->declareSetting("WorldSnapshotsOnExit", false);
+    m_settings->declareSetting("WorldSnapshotsToKeep", 10);
 
     qDebug() << "Instance-type specific settings were loaded!";
 
@@ -251,10 +290,19 @@ QString MinecraftInstance::binRoot() const
 
 QString MinecraftInstance::getNativePath() const
 {
+    if (!m_native_path.isEmpty())
+    {
+        return m_native_path;
+    }
     QDir natives_dir(FS::PathCombine(instanceRoot(), "natives/"));
     return natives_dir.absolutePath();
 }
 
+void MinecraftInstance::setNativePath(const QString& path)
+{
+    m_native_path = path;
+}
+
 QString MinecraftInstance::getLocalLibraryPath() const
 {
     QDir libraries_dir(FS::PathCombine(instanceRoot(), "libraries/"));
@@ -325,6 +373,11 @@ QString MinecraftInstance::worldDir() const
     return FS::PathCombine(gameRoot(), "saves");
 }
 
+QString MinecraftInstance::worldSnapshotsDir() const
+{
+    return FS::PathCombine(instanceRoot(), "world_snapshots");
+}
+
 QString MinecraftInstance::resourcesDir() const
 {
     return FS::PathCombine(gameRoot(), "resources");
@@ -397,6 +450,12 @@ QStringList MinecraftInstance::javaArguments()
 {
     QStringList args;
 
+    // the tuning profile goes before everything else, so what the user gives wins
+    if (auto profile = jvmProfile())
+    {
+        args.append(JvmProfiles::arguments(*profile, probedJvm()));
+    }
+
     // custom args go first. we want to override them if we have our own here.
     args.append(extraArguments());
 
@@ -423,6 +482,15 @@ QStringList MinecraftInstance::javaArguments()
 
     int min = settings()->get("MinMemAlloc").toInt();
     int max = settings()->get("MaxMemAlloc").toInt();
+    if (settings()->get("AutoMemory").toBool())
+    {
+        auto bounds = HeapSizing::boundsFor(this);
+        if (bounds.max > 0)
+        {
+            min = bounds.min;
+            max = bounds.max;
+        }
+    }
     if(min < max)
     {
         args << QString("-Xms%1m").arg(min);
@@ -523,52 +591,40 @@ QProcessEnvironment MinecraftInstance::createLaunchEnvironment()
         env.insert("__VK_LAYER_NV_optimus", "NVIDIA_only");
         env.insert("__GLX_VENDOR_LIBRARY_NAME", "nvidia");
     }
-#endif
-
-    return env;
-}
-
-static QString replaceTokensIn(QString text, QMap<QString, QString> with)
-{
-    // TODO: does this still work??
-    QString result;
-    QRegularExpression token_regexp("\\$\\{(.+)\\}", QRegularExpression::InvertedGreedinessOption);
-    QStringList list;
-    QRegularExpressionMatchIterator i = token_regexp.globalMatch(text);
-    int lastCapturedEnd = 0;
-    while (i.hasNext())
-    {
-        QRegularExpressionMatch match = i.next();
-        result.append(text.mid(lastCapturedEnd, match.capturedStart()));
-        QString key = match.captured(1);
-        auto iter = with.find(key);
-        if (iter != with.end())
+    else if (settings()->get("AutoDiscreteGpu").toBool())
+    {
+        // only on hybrid graphics, and only what the driver of the discrete GPU understands
+        if (auto gpu = SystemProbe::discreteGpu(APPLICATION->systemProbe()->gpus()))
         {
-            result.append(*iter);
+            if (gpu->driver == "nvidia")
+            {
+                env.insert("__NV_PRIME_RENDER_OFFLOAD", "1");
+                env.insert("__VK_LAYER_NV_optimus", "NVIDIA_only");
+                env.insert("__GLX_VENDOR_LIBRARY_NAME", "nvidia");
+            }
+            else
+            {
+                // Mesa takes the PCI slot, with underscores
+                env.insert("DRI_PRIME", "pci-" + QString(gpu->pci_slot).replace(':', '_').replace('.', '_'));
+            }
         }
-        lastCapturedEnd = match.capturedEnd();
     }
-    result.append(text.mid(lastCapturedEnd));
-    return result;
+
+    if (settings()->get("ShaderCachePerInstance").toBool())
+    {
+        ShaderCache::setUp(env, ShaderCache::path(gameRoot()), APPLICATION->settings()->get("ShaderCacheSize").toInt());
+    }
+#endif
+
+    return env;
 }
 
 QStringList MinecraftInstance::processMinecraftArgs(
         AuthSessionPtr session, MinecraftServerTargetPtr serverToJoin) const
 {
     auto profile = m_components->getProfile();
-    QString args_pattern = profile->getMinecraftArguments();
-    for (auto tweaker : profile->getTweakers())
-    {
-        args_pattern += " --tweakClass " + tweaker;
-    }
 
-    if (serverToJoin && !serverToJoin->address.isEmpty())
-    {
-        args_pattern += " --server " + serverToJoin->address;
-        args_pattern += " --port " + QString::number(serverToJoin->port);
-    }
-
-    QMap<QString, QString> token_mapping;
+    ArgumentTemplate::Variables token_mapping;
     // yggdrasil!
     if(session) {
         // token_mapping["auth_username"] = session->username;
@@ -578,9 +634,6 @@ QStringList MinecraftInstance::processMinecraftArgs(
         token_mapping["auth_uuid"] = session->uuid;
         token_mapping["user_properties"] = session->serializeUserProperties();
         token_mapping["user_type"] = session->user_type;
-        if(session->demo) {
-            args_pattern += " --demo";
-        }
     }
 
     token_mapping["profile_name"] = name();
@@ -597,14 +650,21 @@ QStringList MinecraftInstance::processMinecraftArgs(
     token_mapping["assets_root"] = absAssetsDir;
     token_mapping["assets_index_name"] = assets->id;
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-    QStringList parts = args_pattern.split(' ', Qt::SkipEmptyParts);
-#else
-    QStringList parts = args_pattern.split(' ', QString::SkipEmptyParts);
-#endif
-    for (int i = 0; i < parts.length(); i++)
+    // the templates are parsed once per profile, the rest has no variables in it
+    QStringList parts = ArgumentTemplate::render(profile->getMinecraftArgumentTemplates(), token_mapping);
+    for (auto tweaker : profile->getTweakers())
+    {
+        parts << "--tweakClass" << tweaker;
+    }
+
+    if (serverToJoin && !serverToJoin->address.isEmpty())
     {
-        parts[i] = replaceTokensIn(parts[i], token_mapping);
+        parts << "--server" << serverToJoin->address;
+        parts << "--port" << QString::number(serverToJoin->port);
+    }
+
+    if(session && session->demo) {
+        parts << "--demo";
     }
     return parts;
 }
@@ -670,6 +730,17 @@ QString MinecraftInstance::createLaunchScript(AuthSessionPtr session, MinecraftS
         launchScript += "traits " + trait + "\n";
     }
 
+    // the peak of the heap is only of use when it gets sized automatically
+    if (settings()->get("AutoMemory").toBool())
+    {
+        launchScript += "heapMonitor true\n";
+    }
+
+    if (settings()->get("LaunchTelemetry").toBool())
+    {
+        launchScript += "telemetry true\n";
+    }
+
     launchScript += "launcher " + getLauncher() + "\n";
 
     // qDebug() << "Generated launch script:" << launchScript;
@@ -809,6 +880,37 @@ QStringList MinecraftInstance::verboseDescription(AuthSessionPtr session, Minecr
     out << "";
     out << "Launcher: " + getLauncher();
     out << "";
+
+    if (settings->get("AutoMemory").toBool())
+    {
+        out << "Memory, sized automatically:";
+        auto bounds = HeapSizing::boundsFor(this);
+        if (bounds.max > 0)
+            out << QString("  %1 - %2 MiB, %3").arg(bounds.min).arg(bounds.max).arg(bounds.reason);
+        else
+            out << "  the system memory is not known, the memory settings are used";
+        out << "";
+    }
+
+    auto profileId = settings->get("JvmProfile").toString();
+    if (!profileId.isEmpty())
+    {
+        out << "JVM tuning profile:";
+        if (auto profile = jvmProfile())
+        {
+            auto reason = JvmProfiles::unusableReason(*profile, probedJvm());
+            auto name = QString("%1 (%2, revision %3)").arg(JvmProfiles::displayName(*profile), profile->id).arg(profile->revision);
+            if (reason.isEmpty())
+                out << "  " + name;
+            else
+                out << "  " + name + " is not used, " + reason;
+        }
+        else
+        {
+            out << "  " + profileId + " is not known, it is not used";
+        }
+        out << "";
+    }
     return out;
 }
 
@@ -844,49 +946,7 @@ QMap<QString, QString> MinecraftInstance::createCensorFilterFromSession(AuthSess
 
 MessageLevel::Enum MinecraftInstance::guessLevel(const QString &line, MessageLevel::Enum level)
 {
-    QRegularExpression re("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]");
-    auto match = re.match(line);
-    if(match.hasMatch())
-    {
-        // New style logs from log4j
-        QString timestamp = match.captured("timestamp");
-        QString levelStr = match.captured("level");
-        if(levelStr == "INFO")
-            level = MessageLevel::Message;
-        if(levelStr == "WARN")
-            level = MessageLevel::Warning;
-        if(levelStr == "ERROR")
-            level = MessageLevel::Error;
-        if(levelStr == "FATAL")
-            level = MessageLevel::Fatal;
-        if(levelStr == "TRACE" || levelStr == "DEBUG")
-            level = MessageLevel::Debug;
-    }
-    else
-    {
-        // Old style forge logs
-        if (line.contains("[INFO]") || line.contains("[CONFIG]") || line.contains("[FINE]") ||
-            line.contains("[FINER]") || line.contains("[FINEST]"))
-            level = MessageLevel::Message;
-        if (line.contains("[SEVERE]") || line.contains("[STDERR]"))
-            level = MessageLevel::Error;
-        if (line.contains("[WARNING]"))
-            level = MessageLevel::Warning;
-        if (line.contains("[DEBUG]"))
-            level = MessageLevel::Debug;
-    }
-    if (line.contains("overwriting existing"))
-        return MessageLevel::Fatal;
-    //NOTE: this diverges from the real regexp. no unicode, the first section is + instead of *
-    static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
-    if (line.contains("Exception in thread")
-        || line.contains(QRegularExpression("\\s+at " + javaSymbol))
-        || line.contains(QRegularExpression("Caused by: " + javaSymbol))
-        || line.contains(QRegularExpression("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)"))
-        || line.contains(QRegularExpression("... \\d+ more$"))
-        )
-        return MessageLevel::Error;
-    return level;
+    return m_log_classifier.classify(line, level);
 }
 
 IPathMatcher::Ptr MinecraftInstance::getLogFileMatcher()
@@ -959,6 +1019,29 @@ Task::Ptr MinecraftInstance::createUpdateTask(Net::Mode mode)
     return nullptr;
 }
 
+void MinecraftInstance::setDeferredAssets(NetJob::Ptr job)
+{
+    // those still missing are in the new ones
+    if (m_deferred_assets && m_deferred_assets->isRunning())
+        m_deferred_assets->abort();
+    m_deferred_assets = job;
+    if (!job)
+        return;
+
+    qDebug() << name() << ": downloading" << job->size() << "assets while the game runs";
+    connect(job.get(), &Task::failed, this, [this](QString reason) {
+        // the next launch downloads them again
+        qWarning() << name() << ": couldn't download the remaining assets:" << reason;
+    });
+    connect(job.get(), &Task::finished, this, [this, job] {
+        if (m_deferred_assets == job)
+            m_deferred_assets.reset();
+    });
+    // after whatever some launch is waiting for
+    job->setPriority(Net::Priority::Background);
+    job->start();
+}
+
 shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPtr session, MinecraftServerTargetPtr serverToJoin)
 {
     updateRuntimeContext();
@@ -969,14 +1052,12 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPt
     APPLICATION->icons()->saveIcon(iconKey(), FS::PathCombine(gameRoot(), "icon.png"), "PNG");
 
     // print a header
-    {
-        process->appendStep(makeShared<TextPrint>(pptr, "Minecraft folder is:\n" + gameRoot() + "\n\n", MessageLevel::Launcher));
-    }
+    auto header = makeShared<TextPrint>(pptr, "Minecraft folder is:\n" + gameRoot() + "\n\n", MessageLevel::Launcher);
+    process->appendStep(header);
 
     // check java
-    {
-        process->appendStep(makeShared<CheckJava>(pptr));
-    }
+    auto checkJava = makeShared<CheckJava>(pptr);
+    process->appendStep(checkJava, { header });
 
     // check launch method
     QStringList validMethods = {"LauncherPart", "DirectJava"};
@@ -987,11 +1068,18 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPt
         return process;
     }
 
-    // create the .minecraft folder and server-resource-packs (workaround for Minecraft bug MCL-3732)
+    // the files of the base instance, for a layered instance
+    shared_qobject_ptr<LaunchStep> composed = header;
+    if (!layeredOn().isEmpty())
     {
-        process->appendStep(makeShared<CreateGameFolders>(pptr));
+        composed = makeShared<ComposeLayer>(pptr);
+        process->appendStep(composed, { header });
     }
 
+    // create the .minecraft folder and server-resource-packs (workaround for Minecraft bug MCL-3732)
+    auto createFolders = makeShared<CreateGameFolders>(pptr);
+    process->appendStep(createFolders, { composed });
+
     if (!serverToJoin && settings()->get("JoinServerOnLaunch").toBool())
     {
         QString fullAddress = settings()->get("JoinServerOnLaunchAddress").toString();
@@ -1004,53 +1092,69 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPt
         auto step = makeShared<LookupServerAddress>(pptr);
         step->setLookupAddress(serverToJoin->address);
         step->setOutputAddressPtr(serverToJoin);
-        process->appendStep(step);
+        process->appendStep(step, { header });
     }
 
+    // what changes the contents of the instance folder has to wait for the pre-launch command, it may do that too
+    shared_qobject_ptr<LaunchStep> prepared = createFolders;
+
     // run pre-launch command if that's needed
     if(getPreLaunchCommand().size())
     {
         auto step = makeShared<PreLaunchCommand>(pptr);
         step->setWorkingDirectory(gameRoot());
-        process->appendStep(step);
+        process->appendStep(step, { checkJava, createFolders });
+        prepared = step;
+    }
+
+    // bring the files of the packwiz pack up to date, before anything looks at the mods
+    auto packwizURL = settings()->get("PackwizPackURL").toString();
+    if (settings()->get("PackwizSync").toBool() && !packwizURL.isEmpty())
+    {
+        auto step = makeShared<SyncPackwiz>(pptr, QUrl(packwizURL));
+        process->appendStep(step, { prepared });
+        prepared = step;
     }
 
     // if we aren't in offline mode,.
+    shared_qobject_ptr<LaunchStep> update;
     if(session->status != AuthSession::PlayableOffline)
     {
         if(!session->demo) {
-            process->appendStep(makeShared<ClaimAccount>(pptr, session));
+            process->appendStep(makeShared<ClaimAccount>(pptr, session), { header });
         }
-        process->appendStep(makeShared<Update>(pptr, Net::Mode::Online));
+        update = makeShared<Update>(pptr, m_updated_for_launch ? Net::Mode::Offline : Net::Mode::Online);
     }
     else
     {
-        process->appendStep(makeShared<Update>(pptr, Net::Mode::Offline));
+        update = makeShared<Update>(pptr, Net::Mode::Offline);
     }
+    process->appendStep(update, { prepared });
+    m_updated_for_launch = false;
 
     // if there are any jar mods
     {
-        process->appendStep(makeShared<ModMinecraftJar>(pptr));
+        process->appendStep(makeShared<ModMinecraftJar>(pptr), { update });
     }
 
     // Scan mods folders for mods
     {
-        process->appendStep(makeShared<ScanModFolders>(pptr));
+        process->appendStep(makeShared<ScanModFolders>(pptr), { prepared });
     }
 
-    // print some instance info here...
+    // extract native jars if needed
     {
-        process->appendStep(makeShared<PrintInstanceInfo>(pptr, session, serverToJoin));
+        process->appendStep(makeShared<ExtractNatives>(pptr), { update });
     }
 
-    // extract native jars if needed
+    // reconstruct assets if needed
     {
-        process->appendStep(makeShared<ExtractNatives>(pptr));
+        process->appendStep(makeShared<ReconstructAssets>(pptr), { update });
     }
 
-    // reconstruct assets if needed
+    // print some instance info here...
     {
-        process->appendStep(makeShared<ReconstructAssets>(pptr));
+        process->appendStep(makeShared<PrintInstanceInfo>(pptr, session, serverToJoin));
     }
 
     // verify that minimum Java requirements are met
@@ -1079,6 +1183,12 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPt
         }
     }
 
+    // snapshot the worlds the game changed, before anything else gets to them
+    if(m_settings->get("WorldSnapshotsOnExit").toBool())
+    {
+        process->appendStep(makeShared<SnapshotWorlds>(pptr));
+    }
+
     // run post-exit command if that's needed
     if(getPostExitCommand().size())
     {
@@ -1109,6 +1219,31 @@ JavaVersion MinecraftInstance::getJavaVersion()
     return JavaVersion(settings()->get("JavaVersion").toString());
 }
 
+const JvmProfiles::Profile* MinecraftInstance::jvmProfile()
+{
+    auto id = settings()->get("JvmProfile").toString();
+    if (id.isEmpty())
+        return nullptr;
+    return JvmProfiles::find(id);
+}
+
+JvmProfiles::Jvm MinecraftInstance::probedJvm()
+{
+    JvmProfiles::Jvm jvm;
+    jvm.version = getJavaVersion();
+    jvm.vendor = settings()->get("JavaVendor").toString();
+    jvm.architecture = settings()->get("JavaArchitecture").toString();
+    jvm.maxMemory = qMax(settings()->get("MinMemAlloc").toInt(), settings()->get("MaxMemAlloc").toInt());
+    if (settings()->get("AutoMemory").toBool())
+    {
+        auto bounds = HeapSizing::boundsFor(this);
+        if (bounds.max > 0)
+            jvm.maxMemory = bounds.max;
+    }
+    jvm.userArguments = BaseInstance::extraArguments();
+    return jvm;
+}
+
 std::shared_ptr<ModFolderModel> MinecraftInstance::loaderModList()
 {
     if (!m_loader_mod_list)
@@ -37,10 +37,13 @@
 #pragma once
 #include "BaseInstance.h"
 #include <java/JavaVersion.h>
+#include <java/JvmProfiles.h>
 #include "minecraft/mod/Mod.h"
 #include <QProcess>
 #include <QDir>
 #include "minecraft/launch/MinecraftServerTarget.h"
+#include "launch/LogClassifier.h"
+#include "net/NetJob.h"
 
 class ModFolderModel;
 class ResourceFolderModel;
@@ -88,6 +91,8 @@ public:
     QString modsCacheLocation() const;
     QString libDir() const;
     QString worldDir() const;
+    // the snapshots of the worlds, see WorldSnapshots, outside of the game folder
+    QString worldSnapshotsDir() const;
     QString resourcesDir() const;
     QDir jarmodsPath() const;
     QDir librariesPath() const;
@@ -102,6 +107,8 @@ public:
 
     // where to put the natives during/before launch
     QString getNativePath() const;
+    // use an already populated natives folder (from the natives cache) for the current launch, or stop doing so with an empty path
+    void setNativePath(const QString& path);
 
     // where the instance-local libraries should be
     QString getLocalLibraryPath() const;
@@ -127,6 +134,11 @@ public:
     //////  Launch stuff //////
     Task::Ptr createUpdateTask(Net::Mode mode) override;
     shared_qobject_ptr<LaunchTask> createLaunchTask(AuthSessionPtr account, MinecraftServerTargetPtr serverToJoin) override;
+    /// the next launch only checks the files, they were just downloaded along with other instances (see BatchLaunch)
+    void setUpdatedForLaunch() { m_updated_for_launch = true; }
+    /// downloads the assets the game was started without while it runs (see AssetUpdateTask), instead of what's left of
+    /// those of a launch before
+    void setDeferredAssets(NetJob::Ptr job);
     QStringList extraArguments() override;
     QStringList verboseDescription(AuthSessionPtr session, MinecraftServerTargetPtr serverToJoin) override;
     QList<Mod*> getJarMods() const;
@@ -163,6 +175,11 @@ public:
 
     virtual JavaVersion getJavaVersion();
 
+    /// the JVM tuning profile picked for the instance, nullptr when there is none
+    const JvmProfiles::Profile* jvmProfile();
+    /// the probed JVM the profile is checked against
+    JvmProfiles::Jvm probedJvm();
+
 protected:
     QMap<QString, QString> createCensorFilterFromSession(AuthSessionPtr session);
     QStringList validLaunchMethods();
@@ -176,8 +193,12 @@ protected: // data
     mutable std::shared_ptr<ResourcePackFolderModel> m_resource_pack_list;
     mutable std::shared_ptr<ShaderPackFolderModel> m_shader_pack_list;
     mutable std::shared_ptr<TexturePackFolderModel> m_texture_pack_list;
+    LogClassifier m_log_classifier;
+    QString m_native_path;
     mutable std::shared_ptr<WorldList> m_world_list;
     mutable std::shared_ptr<GameOptions> m_game_options;
+    bool m_updated_for_launch = false;
+    NetJob::Ptr m_deferred_assets;
 };
 
 typedef std::shared_ptr<MinecraftInstance> MinecraftInstancePtr;
@@ -20,16 +20,19 @@
 #include <QUrl>
 
 #include "net/NetJob.h"
-#include "tasks/Task.h"
+#include "tasks/TaskGraph.h"
 #include "minecraft/VersionFilterData.h"
 #include <quazip/quazip.h>
 
-class MinecraftVersion;
 class MinecraftInstance;
 
-// FIXME: This looks very similar to a SequentialTask. Maybe we can reduce code duplications? :^)
-
-class MinecraftUpdate : public Task
+/* Gets everything an instance needs to launch.
+ *
+ * Resolving the components comes first, since everything else depends on what they are, and then
+ * the libraries (with the main jar), the FML libraries and the assets are downloaded at the same time.
+ * The libraries and assets are skipped when the instance's integrity stamp says nothing changed.
+ */
+class MinecraftUpdate : public TaskGraph
 {
     Q_OBJECT
 public:
@@ -37,23 +40,7 @@ public:
     virtual ~MinecraftUpdate() {};
 
     void executeTask() override;
-    bool canAbort() const override;
-
-private
-slots:
-    bool abort() override;
-    void subtaskSucceeded();
-    void subtaskFailed(QString error);
-
-private:
-    void next();
 
 private:
     MinecraftInstance *m_inst = nullptr;
-    QList<Task::Ptr> m_tasks;
-    QString m_preFailure;
-    int m_currentTask = -1;
-    bool m_abort = false;
-    bool m_failed_out_of_order = false;
-    QString m_fail_reason;
 };
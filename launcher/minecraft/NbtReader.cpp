@@ -0,0 +1,250 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "NbtReader.h"
+
+#include <QIODevice>
+
+namespace {
+// the same limit as the game, anything nested deeper is broken or malicious
+constexpr int maxDepth = 512;
+
+QString join(const QString& path, const QString& name)
+{
+    return path.isEmpty() ? name : path + '/' + name;
+}
+}  // namespace
+
+NbtReader::NbtReader(QIODevice* device) : m_stream(device)
+{
+    m_stream.setByteOrder(QDataStream::BigEndian);
+    m_stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+}
+
+bool NbtReader::read(const QStringList& paths)
+{
+    m_fields.clear();
+    m_error.clear();
+    m_wanted.clear();
+    m_parents.clear();
+    for (auto& path : paths) {
+        m_wanted.insert(path);
+        for (int i = path.indexOf('/'); i >= 0; i = path.indexOf('/', i + 1))
+            m_parents.insert(path.left(i));
+    }
+
+    quint8 type = 0;
+    m_stream >> type;
+    if (m_stream.status() != QDataStream::Ok)
+        return fail("The data is empty");
+    if (TagType(type) != TagType::Compound)
+        return fail(QString("The root tag is of type %1, not a compound").arg(type));
+    if (!readString(m_rootName))
+        return false;
+    return readCompound(QString(), 0) || m_wanted.isEmpty();
+}
+
+std::optional<NbtReader::Field> NbtReader::field(const QString& path) const
+{
+    auto found = m_fields.constFind(path);
+    if (found == m_fields.constEnd())
+        return std::nullopt;
+    return *found;
+}
+
+bool NbtReader::readCompound(const QString& path, int depth)
+{
+    if (depth > maxDepth)
+        return fail("The tags are nested too deep");
+    while (true) {
+        quint8 type = 0;
+        m_stream >> type;
+        if (m_stream.status() != QDataStream::Ok)
+            return fail("The data ends inside a compound");
+        if (TagType(type) == TagType::End)
+            return true;
+
+        QString name;
+        if (!readString(name))
+            return false;
+        auto child = join(path, name);
+        if (m_wanted.contains(child) || m_parents.contains(child)) {
+            if (!readPayload(TagType(type), child, depth + 1))
+                return false;
+        } else if (!skipPayload(TagType(type), depth + 1)) {
+            return false;
+        }
+        // everything after the last wanted field doesn't matter
+        if (m_wanted.isEmpty())
+            return true;
+    }
+}
+
+bool NbtReader::readPayload(TagType type, const QString& path, int depth)
+{
+    Field field;
+    field.type = type;
+    switch (type) {
+        case TagType::Byte: {
+            qint8 value = 0;
+            m_stream >> value;
+            field.value = int(value);
+            break;
+        }
+        case TagType::Short: {
+            qint16 value = 0;
+            m_stream >> value;
+            field.value = int(value);
+            break;
+        }
+        case TagType::Int: {
+            qint32 value = 0;
+            m_stream >> value;
+            field.value = value;
+            break;
+        }
+        case TagType::Long: {
+            qint64 value = 0;
+            m_stream >> value;
+            field.value = qlonglong(value);
+            break;
+        }
+        case TagType::Float: {
+            float value = 0;
+            m_stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+            m_stream >> value;
+            m_stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+            field.value = value;
+            break;
+        }
+        case TagType::Double: {
+            double value = 0;
+            m_stream >> value;
+            field.value = value;
+            break;
+        }
+        case TagType::String: {
+            QString value;
+            if (!readString(value))
+                return false;
+            field.value = value;
+            break;
+        }
+        case TagType::Compound: {
+            // recorded before, so the ones looked for themselves are there even when reading stops inside them
+            m_fields.insert(path, field);
+            m_wanted.remove(path);
+            return readCompound(path, depth);
+        }
+        default:
+            // arrays and lists aren't kept, wanting one only tells that it is there
+            if (!skipPayload(type, depth))
+                return false;
+            break;
+    }
+    if (m_stream.status() != QDataStream::Ok)
+        return fail(QString("The data ends inside %1").arg(path));
+    m_fields.insert(path, field);
+    m_wanted.remove(path);
+    return true;
+}
+
+bool NbtReader::skipPayload(TagType type, int depth)
+{
+    if (depth > maxDepth)
+        return fail("The tags are nested too deep");
+    switch (type) {
+        case TagType::Byte:
+            return skip(1);
+        case TagType::Short:
+            return skip(2);
+        case TagType::Int:
+        case TagType::Float:
+            return skip(4);
+        case TagType::Long:
+        case TagType::Double:
+            return skip(8);
+        case TagType::String:
+            return skipString();
+        case TagType::ByteArray:
+        case TagType::IntArray:
+        case TagType::LongArray: {
+            qint32 length = 0;
+            m_stream >> length;
+            if (m_stream.status() != QDataStream::Ok || length < 0)
+                return fail("An array has no valid length");
+            int element = type == TagType::ByteArray ? 1 : type == TagType::IntArray ? 4 : 8;
+            return skip(qint64(length) * element);
+        }
+        case TagType::List: {
+            quint8 element = 0;
+            qint32 length = 0;
+            m_stream >> element >> length;
+            if (m_stream.status() != QDataStream::Ok)
+                return fail("A list has no valid header");
+            // empty lists can say they are of the end type
+            if (length <= 0)
+                return true;
+            if (TagType(element) == TagType::End || element > quint8(TagType::LongArray))
+                return fail(QString("A list is of the unknown type %1").arg(element));
+            for (qint32 i = 0; i < length; i++) {
+                if (!skipPayload(TagType(element), depth + 1))
+                    return false;
+            }
+            return true;
+        }
+        case TagType::Compound: {
+            while (true) {
+                quint8 child = 0;
+                m_stream >> child;
+                if (m_stream.status() != QDataStream::Ok)
+                    return fail("The data ends inside a compound");
+                if (TagType(child) == TagType::End)
+                    return true;
+                if (!skipString() || !skipPayload(TagType(child), depth + 1))
+                    return false;
+            }
+        }
+        case TagType::End:
+            break;
+    }
+    return fail(QString("Unknown tag type %1").arg(quint8(type)));
+}
+
+bool NbtReader::readString(QString& out)
+{
+    quint16 length = 0;
+    m_stream >> length;
+    QByteArray bytes(length, Qt::Uninitialized);
+    if (m_stream.status() != QDataStream::Ok || m_stream.readRawData(bytes.data(), length) != length)
+        return fail("The data ends inside a string");
+    out = QString::fromUtf8(bytes);
+    return true;
+}
+
+bool NbtReader::skipString()
+{
+    quint16 length = 0;
+    m_stream >> length;
+    if (m_stream.status() != QDataStream::Ok)
+        return fail("The data ends inside a string");
+    return skip(length);
+}
+
+bool NbtReader::skip(qint64 bytes)
+{
+    // skipRawData takes an int, and reads through sequential devices in small pieces
+    while (bytes > 0) {
+        int piece = int(qMin<qint64>(bytes, 1 << 30));
+        if (m_stream.skipRawData(piece) != piece)
+            return fail("The data ends early");
+        bytes -= piece;
+    }
+    return true;
+}
+
+bool NbtReader::fail(const QString& error)
+{
+    if (m_error.isEmpty())
+        m_error = error;
+    return false;
+}
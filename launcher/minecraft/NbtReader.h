@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QDataStream>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+#include <optional>
+
+class QIODevice;
+
+/* Reads just the named fields out of NBT data, like the few a world list needs from a level.dat, without building the
+ * tree of everything in it like libnbtplusplus does.
+ *
+ * The data is read front to back from the device once. Every tag that isn't wanted or on the way to one is skipped over
+ * without being kept, and reading stops as soon as all wanted fields were found.
+ */
+class NbtReader {
+   public:
+    enum class TagType : quint8 {
+        End = 0,
+        Byte = 1,
+        Short = 2,
+        Int = 3,
+        Long = 4,
+        Float = 5,
+        Double = 6,
+        ByteArray = 7,
+        String = 8,
+        List = 9,
+        Compound = 10,
+        IntArray = 11,
+        LongArray = 12,
+    };
+
+    struct Field {
+        TagType type = TagType::End;
+        /** Set for the number and string tags, a compound on the way to a wanted field only has its type. */
+        QVariant value;
+    };
+
+    explicit NbtReader(QIODevice* device);
+
+    /** Reads the fields at `paths`, given like "Data/WorldGenSettings/seed" from inside the root compound.
+     *
+     * Returns false if the data isn't NBT, or is cut off before all of them were found. The fields found until then can
+     * still be looked at. The ones that just aren't in the data are not an error.
+     */
+    bool read(const QStringList& paths);
+
+    /** The field at `path`, if it was found. */
+    std::optional<Field> field(const QString& path) const;
+
+    /** The name of the root compound. */
+    QString rootName() const { return m_rootName; }
+    QString errorString() const { return m_error; }
+
+   private:
+    bool readCompound(const QString& path, int depth);
+    bool readPayload(TagType type, const QString& path, int depth);
+    bool skipPayload(TagType type, int depth);
+    bool readString(QString& out);
+    bool skipString();
+    bool skip(qint64 bytes);
+    bool fail(const QString& error);
+
+   private:
+    QDataStream m_stream;
+    QSet<QString> m_wanted;
+    /** The compounds the wanted fields are in, the only ones looked into. */
+    QSet<QString> m_parents;
+    QHash<QString, Field> m_fields;
+    QString m_rootName;
+    QString m_error;
+};
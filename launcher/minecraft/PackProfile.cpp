@@ -58,6 +58,7 @@
 #include "PackProfile.h"
 #include "PackProfile_p.h"
 #include "ComponentUpdateTask.h"
+#include "LaunchProfileCache.h"
 
 #include "Application.h"
 #include "modplatform/ResourceAPI.h"
@@ -1037,6 +1038,15 @@ std::shared_ptr<LaunchProfile> PackProfile::getProfile() const
 {
     if(!d->m_profile)
     {
+        // unchanged components make the same profile, which is faster to read back than to put together again
+        auto context = d->m_instance->runtimeContext();
+        auto cachePath = FS::PathCombine(d->m_instance->instanceRoot(), ".launch_profile");
+        auto cacheKey = LaunchProfileCache::key(d->components, context);
+        d->m_profile = LaunchProfileCache::load(cachePath, cacheKey, context);
+        if(d->m_profile)
+        {
+            return d->m_profile;
+        }
         try
         {
             auto profile = std::make_shared<LaunchProfile>();
@@ -1046,6 +1056,7 @@ std::shared_ptr<LaunchProfile> PackProfile::getProfile() const
                 file->applyTo(profile.get());
             }
             d->m_profile = profile;
+            LaunchProfileCache::save(cachePath, cacheKey, *profile);
         }
         catch (const Exception &error)
         {
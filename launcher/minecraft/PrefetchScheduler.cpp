@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "PrefetchScheduler.h"
+
+#include <QDebug>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+#include <QNetworkInformation>
+#endif
+
+#include "InstanceList.h"
+#include "minecraft/BulkUpdateTask.h"
+#include "minecraft/MinecraftInstance.h"
+
+namespace {
+
+const QString s_time_format = "HH:mm";
+
+// on a metered connection, how long to wait before looking again while still in the window
+constexpr int s_metered_retry = 30 * 60 * 1000;
+
+}  // namespace
+
+PrefetchScheduler::PrefetchScheduler(std::shared_ptr<InstanceList> instances, SettingsObjectPtr settings, QObject* parent)
+    : QObject(parent), m_instances(std::move(instances)), m_settings(std::move(settings))
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::VeryCoarseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &PrefetchScheduler::run);
+}
+
+bool PrefetchScheduler::inWindow(QTime time, QTime start, QTime end)
+{
+    if (start <= end)
+        return start <= time && time < end;
+    return time >= start || time < end;
+}
+
+QDateTime PrefetchScheduler::nextRun(const QDateTime& now, const QDateTime& last, QTime start, QTime end)
+{
+    if (inWindow(now.time(), start, end)) {
+        // a window past midnight started the day before
+        auto started = QDateTime(now.time() >= start ? now.date() : now.date().addDays(-1), start);
+        if (!last.isValid() || last < started)
+            return now;
+    }
+    auto next = QDateTime(now.date(), start);
+    return next > now ? next : next.addDays(1);
+}
+
+QTime PrefetchScheduler::windowStart() const
+{
+    return QTime::fromString(m_settings->get("PrefetchWindowStart").toString(), s_time_format);
+}
+
+QTime PrefetchScheduler::windowEnd() const
+{
+    return QTime::fromString(m_settings->get("PrefetchWindowEnd").toString(), s_time_format);
+}
+
+void PrefetchScheduler::reschedule()
+{
+    m_timer.stop();
+    auto start = windowStart();
+    auto end = windowEnd();
+    if (!start.isValid() || !end.isValid() || start == end) {
+        qWarning() << "No window to prefetch the updates in:" << m_settings->get("PrefetchWindowStart").toString() << "to"
+                   << m_settings->get("PrefetchWindowEnd").toString();
+        return;
+    }
+    if (m_task)
+        return;
+
+    auto now = QDateTime::currentDateTime();
+    auto next = nextRun(now, m_settings->get("LastPrefetch").toDateTime(), start, end);
+    // a day is well within what a timer can wait
+    m_timer.start(int(qMax<qint64>(now.msecsTo(next), 0)));
+}
+
+bool PrefetchScheduler::metered() const
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+    if (QNetworkInformation::loadBackendByFeatures(QNetworkInformation::Feature::Metered))
+        return QNetworkInformation::instance()->isMetered();
+#endif
+    // nothing says so
+    return false;
+}
+
+void PrefetchScheduler::run()
+{
+    // the computer may have been asleep through the window
+    if (!inWindow(QTime::currentTime(), windowStart(), windowEnd())) {
+        reschedule();
+        return;
+    }
+    if (metered() && !m_settings->get("PrefetchOnMetered").toBool()) {
+        qDebug() << "Not prefetching the updates on a metered connection";
+        m_timer.start(s_metered_retry);
+        return;
+    }
+
+    QList<InstancePtr> instances;
+    for (int i = 0; i < m_instances->count(); i++) {
+        auto instance = m_instances->at(i);
+        // those being played are updated when they are launched again anyway
+        if (!std::dynamic_pointer_cast<MinecraftInstance>(instance) || instance->isRunning())
+            continue;
+        if (instance->settings()->get("PrefetchUpdates").toBool())
+            instances.append(instance);
+    }
+    if (instances.isEmpty()) {
+        m_settings->set("LastPrefetch", QDateTime::currentDateTime());
+        reschedule();
+        return;
+    }
+
+    auto task = makeShared<BulkUpdateTask>(instances);
+    task->setPrefetch(true);
+    m_task = task;
+    connect(task.get(), &Task::failed, this, [](QString reason) { qWarning() << "Prefetching the updates failed:" << reason; });
+    // once a window, failed or not: what's missing is downloaded by the update anyway
+    connect(task.get(), &Task::finished, this, [this] {
+        m_settings->set("LastPrefetch", QDateTime::currentDateTime());
+        m_task.reset();
+        reschedule();
+    });
+    task->start();
+}
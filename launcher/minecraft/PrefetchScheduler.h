@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QDateTime>
+#include <QObject>
+#include <QTime>
+#include <QTimer>
+
+#include <memory>
+
+#include "QObjectPtr.h"
+#include "settings/SettingsObject.h"
+#include "tasks/Task.h"
+
+class InstanceList;
+
+/* Downloads what the updates of the instances need while nobody is using the computer, so that updating them later
+ * mostly finds everything in the caches.
+ *
+ * Once a day, in the window of time set in the settings (02:00 to 06:00 by default), the instances with the
+ * "PrefetchUpdates" setting get their components resolved again, and the libraries and assets those need are downloaded
+ * at background priority. Nothing of the instances themselves is changed: that's left to when they are updated or
+ * launched. On a metered connection it waits for the window to come again, unless told otherwise.
+ */
+class PrefetchScheduler : public QObject {
+    Q_OBJECT
+   public:
+    PrefetchScheduler(std::shared_ptr<InstanceList> instances, SettingsObjectPtr settings, QObject* parent = nullptr);
+
+    /** Reads the window from the settings again, for when they changed. */
+    void reschedule();
+
+    /** If the time is in the window, which may go past midnight (22:00 to 04:00). An empty window has no time in it. */
+    static bool inWindow(QTime time, QTime start, QTime end);
+
+    /** When to prefetch next: `now` if it's in a window not prefetched in since `last` started, the next start otherwise. */
+    static QDateTime nextRun(const QDateTime& now, const QDateTime& last, QTime start, QTime end);
+
+   private:
+    void run();
+    bool metered() const;
+    QTime windowStart() const;
+    QTime windowEnd() const;
+
+   private:
+    std::shared_ptr<InstanceList> m_instances;
+    SettingsObjectPtr m_settings;
+    QTimer m_timer;
+    Task::Ptr m_task;
+};
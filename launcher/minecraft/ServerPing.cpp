@@ -0,0 +1,348 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ServerPing.h"
+
+#include <QDnsLookup>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTcpSocket>
+
+namespace {
+// how long the status of a server is trusted, and the bounds for how long a resolution is
+constexpr qint64 statusTtlSeconds = 60;
+constexpr quint32 minResolveTtlSeconds = 60;
+constexpr quint32 maxResolveTtlSeconds = 60 * 60;
+// a server that takes longer than this to answer is as good as down for the list
+constexpr int timeoutMs = 5000;
+// any protocol version will do to get the status, -1 is what is sent when it isn't known
+constexpr int protocolVersion = -1;
+constexpr quint16 defaultPort = 25565;
+
+template <typename T>
+struct Cached {
+    T value;
+    QDateTime expires;
+};
+
+QHash<QString, Cached<MinecraftServerTarget>>& resolutions()
+{
+    static QHash<QString, Cached<MinecraftServerTarget>> cache;
+    return cache;
+}
+
+QHash<QString, Cached<ServerStatus>>& statuses()
+{
+    static QHash<QString, Cached<ServerStatus>> cache;
+    return cache;
+}
+
+template <typename T>
+std::optional<T> lookup(QHash<QString, Cached<T>>& cache, const QString& key)
+{
+    auto found = cache.find(key);
+    if (found == cache.end())
+        return std::nullopt;
+    if (found->expires < QDateTime::currentDateTimeUtc()) {
+        cache.erase(found);
+        return std::nullopt;
+    }
+    return found->value;
+}
+
+void writeVarInt(QByteArray& out, int value)
+{
+    auto bits = static_cast<quint32>(value);
+    do {
+        char byte = bits & 0x7F;
+        bits >>= 7;
+        if (bits)
+            byte |= 0x80;
+        out.append(byte);
+    } while (bits);
+}
+
+/** Reads a VarInt at `pos` and moves past it, false if it isn't all there yet or is too long to be one. */
+bool readVarInt(const QByteArray& in, int& pos, int& value)
+{
+    quint32 result = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= in.size())
+            return false;
+        auto byte = static_cast<quint8>(in[pos++]);
+        result |= quint32(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            value = static_cast<int>(result);
+            return true;
+        }
+    }
+    return false;
+}
+
+void writeString(QByteArray& out, const QString& value)
+{
+    auto bytes = value.toUtf8();
+    writeVarInt(out, bytes.size());
+    out.append(bytes);
+}
+
+QByteArray packet(int id, const QByteArray& payload)
+{
+    QByteArray body;
+    writeVarInt(body, id);
+    body.append(payload);
+    QByteArray out;
+    writeVarInt(out, body.size());
+    out.append(body);
+    return out;
+}
+
+/** The plain text of a chat component, or of the legacy string with its formatting codes. */
+QString plainText(const QJsonValue& component)
+{
+    if (component.isString()) {
+        static const QRegularExpression formatting(QStringLiteral("\u00A7."));
+        return component.toString().remove(formatting);
+    }
+    if (component.isArray()) {
+        QString text;
+        for (auto part : component.toArray())
+            text += plainText(part);
+        return text;
+    }
+    if (component.isObject()) {
+        auto object = component.toObject();
+        auto text = plainText(object.value("text"));
+        for (auto part : object.value("extra").toArray())
+            text += plainText(part);
+        return text;
+    }
+    return {};
+}
+}  // namespace
+
+std::optional<MinecraftServerTarget> ServerStatusCache::resolved(const QString& host)
+{
+    return lookup(resolutions(), host.toLower());
+}
+
+void ServerStatusCache::setResolved(const QString& host, const MinecraftServerTarget& target, quint32 ttlSeconds)
+{
+    auto ttl = qBound(minResolveTtlSeconds, ttlSeconds, maxResolveTtlSeconds);
+    resolutions().insert(host.toLower(), { target, QDateTime::currentDateTimeUtc().addSecs(ttl) });
+}
+
+std::optional<ServerStatus> ServerStatusCache::status(const QString& address)
+{
+    return lookup(statuses(), address.trimmed().toLower());
+}
+
+void ServerStatusCache::setStatus(const QString& address, const ServerStatus& status)
+{
+    statuses().insert(address.trimmed().toLower(), { status, QDateTime::currentDateTimeUtc().addSecs(statusTtlSeconds) });
+}
+
+ServerPing::ServerPing(QString address, QObject* parent) : Task(parent), m_address(std::move(address))
+{
+    m_timeout.setSingleShot(true);
+    m_timeout.setInterval(timeoutMs);
+    connect(&m_timeout, &QTimer::timeout, this, [this] { finish(tr("The server didn't answer in time")); });
+}
+
+ServerPing::~ServerPing()
+{
+    if (m_socket)
+        m_socket->abort();
+}
+
+bool ServerPing::abort()
+{
+    if (!isRunning())
+        return true;
+    if (m_lookup)
+        m_lookup->abort();
+    if (m_socket)
+        m_socket->abort();
+    m_timeout.stop();
+    emitAborted();
+    return true;
+}
+
+void ServerPing::executeTask()
+{
+    m_buffer.clear();
+    m_status = {};
+    m_gotStatus = false;
+    m_timeout.start();
+
+    auto target = MinecraftServerTarget::parse(m_address.trimmed());
+    if (target.address.isEmpty()) {
+        finish(tr("The server has no address"));
+        return;
+    }
+    // the game only looks for an SRV record when there is no port given
+    if (target.port != defaultPort) {
+        connectTo(target);
+        return;
+    }
+    if (auto resolved = ServerStatusCache::resolved(target.address)) {
+        connectTo(*resolved);
+        return;
+    }
+
+    m_target = target;
+    m_lookup = new QDnsLookup(QDnsLookup::SRV, QString("_minecraft._tcp.%1").arg(target.address), this);
+    connect(m_lookup, &QDnsLookup::finished, this, &ServerPing::lookupFinished);
+    m_lookup->lookup();
+}
+
+void ServerPing::lookupFinished()
+{
+    if (!isRunning())
+        return;
+
+    auto target = m_target;
+    quint32 ttl = minResolveTtlSeconds;
+    const auto records = m_lookup->serviceRecords();
+    if (m_lookup->error() == QDnsLookup::NoError && !records.isEmpty()) {
+        target.address = records.first().target();
+        target.port = records.first().port();
+        ttl = records.first().timeToLive();
+    }
+    // no record is an answer too, the address is used as it is then
+    ServerStatusCache::setResolved(m_target.address, target, ttl);
+    m_lookup->deleteLater();
+    connectTo(target);
+}
+
+void ServerPing::connectTo(const MinecraftServerTarget& target)
+{
+    m_target = target;
+    m_socket = new QTcpSocket(this);
+    connect(m_socket, &QTcpSocket::connected, this, &ServerPing::connected);
+    connect(m_socket, &QTcpSocket::readyRead, this, &ServerPing::readyRead);
+    connect(m_socket, &QTcpSocket::disconnected, this, [this] {
+        // some servers hang up right after the status instead of answering the ping, its round trip is the latency then
+        if (m_gotStatus)
+            finish({});
+        else
+            finish(tr("The server closed the connection"));
+    });
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    connect(m_socket, &QTcpSocket::errorOccurred, this, [this] { finish(m_gotStatus ? QString() : m_socket->errorString()); });
+#else
+    connect(m_socket, QOverload<QAbstractSocket::SocketError>::of(&QTcpSocket::error), this,
+            [this] { finish(m_gotStatus ? QString() : m_socket->errorString()); });
+#endif
+    m_socket->connectToHost(target.address, target.port);
+}
+
+void ServerPing::connected()
+{
+    QByteArray handshake;
+    writeVarInt(handshake, protocolVersion);
+    writeString(handshake, m_target.address);
+    handshake.append(char(m_target.port >> 8));
+    handshake.append(char(m_target.port & 0xFF));
+    writeVarInt(handshake, 1);  // the status state
+
+    m_socket->write(packet(0x00, handshake));
+    m_socket->write(packet(0x00, {}));
+    m_pingTimer.start();
+}
+
+bool ServerPing::readPacket(int& id, QByteArray& payload)
+{
+    int pos = 0;
+    int length = 0;
+    if (!readVarInt(m_buffer, pos, length))
+        return false;
+    if (m_buffer.size() - pos < length)
+        return false;
+    auto body = m_buffer.mid(pos, length);
+    m_buffer.remove(0, pos + length);
+
+    int bodyPos = 0;
+    if (!readVarInt(body, bodyPos, id))
+        return false;
+    payload = body.mid(bodyPos);
+    return true;
+}
+
+void ServerPing::readyRead()
+{
+    m_buffer.append(m_socket->readAll());
+    // the status is at most a few hundred KiB with its icon, some protection against something else talking back
+    if (m_buffer.size() > 4 * 1024 * 1024) {
+        finish(tr("The server sent too much"));
+        return;
+    }
+
+    int id = 0;
+    QByteArray payload;
+    while (isRunning() && readPacket(id, payload)) {
+        if (id == 0x00) {
+            statusReceived(payload);
+        } else if (id == 0x01) {
+            m_status.latency = static_cast<int>(m_pingTimer.elapsed());
+            finish({});
+        }
+    }
+}
+
+void ServerPing::statusReceived(const QByteArray& payload)
+{
+    m_status.latency = static_cast<int>(m_pingTimer.elapsed());
+
+    int pos = 0;
+    int length = 0;
+    if (!readVarInt(payload, pos, length) || payload.size() - pos < length) {
+        finish(tr("The server sent a broken status"));
+        return;
+    }
+    QJsonParseError error{};
+    auto doc = QJsonDocument::fromJson(payload.mid(pos, length), &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        finish(tr("The server sent a broken status: %1").arg(error.errorString()));
+        return;
+    }
+    auto root = doc.object();
+    auto players = root.value("players").toObject();
+    m_status.currentPlayers = players.value("online").toInt();
+    m_status.maxPlayers = players.value("max").toInt();
+    m_status.motd = plainText(root.value("description"));
+    m_gotStatus = true;
+
+    auto favicon = root.value("favicon").toString();
+    auto comma = favicon.indexOf(',');
+    if (favicon.startsWith("data:image/png;base64,") && comma > 0)
+        m_status.icon = QByteArray::fromBase64(favicon.mid(comma + 1).toLatin1());
+
+    // the ping after the status gets the latency without the time the server took to put the status together
+    QByteArray ping;
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (int shift = 56; shift >= 0; shift -= 8)
+        ping.append(char((now >> shift) & 0xFF));
+    m_socket->write(packet(0x01, ping));
+    m_pingTimer.start();
+}
+
+void ServerPing::finish(const QString& error)
+{
+    if (!isRunning())
+        return;
+    m_timeout.stop();
+    if (m_socket) {
+        m_socket->disconnect(this);
+        m_socket->abort();
+        m_socket->deleteLater();
+    }
+    if (!error.isEmpty()) {
+        emitFailed(error);
+        return;
+    }
+    ServerStatusCache::setStatus(m_address, m_status);
+    emitSucceeded();
+}
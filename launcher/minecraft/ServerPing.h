@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+
+#include <optional>
+
+#include "minecraft/launch/MinecraftServerTarget.h"
+#include "tasks/Task.h"
+
+class QDnsLookup;
+class QTcpSocket;
+
+/** What a server said about itself in the server list ping. */
+struct ServerStatus {
+    int latency = 0;
+    int currentPlayers = 0;
+    int maxPlayers = 0;
+    QString motd;
+    QByteArray icon;
+};
+
+/* The server list pings and SRV resolutions done recently, shared by everything that talks to servers.
+ *
+ * Pings are kept for a minute, so flipping between pages doesn't ping everything again. Resolutions are kept for as
+ * long as their DNS records say, within reason, so a launch joining a server that was just pinged doesn't wait for DNS.
+ */
+class ServerStatusCache {
+   public:
+    /** Where the SRV record of `host` points to, if it was looked up recently. */
+    static std::optional<MinecraftServerTarget> resolved(const QString& host);
+    static void setResolved(const QString& host, const MinecraftServerTarget& target, quint32 ttlSeconds);
+
+    /** The status of the server at `address`, as written in the server list, if it was pinged recently. */
+    static std::optional<ServerStatus> status(const QString& address);
+    static void setStatus(const QString& address, const ServerStatus& status);
+};
+
+/* Pings a server with the server list ping protocol, the way the game's multiplayer screen does.
+ *
+ * Addresses with no explicit port have their SRV record looked up first. The task fails if the server can't be
+ * reached or doesn't answer in time, status() is only set once it succeeded.
+ */
+class ServerPing : public Task {
+    Q_OBJECT
+   public:
+    explicit ServerPing(QString address, QObject* parent = nullptr);
+    ~ServerPing() override;
+
+    QString address() const { return m_address; }
+    ServerStatus status() const { return m_status; }
+
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    void lookupFinished();
+    void connectTo(const MinecraftServerTarget& target);
+    void connected();
+    void readyRead();
+    bool readPacket(int& id, QByteArray& payload);
+    void statusReceived(const QByteArray& payload);
+    void finish(const QString& error);
+
+   private:
+    QString m_address;
+    MinecraftServerTarget m_target;
+    QPointer<QDnsLookup> m_lookup;
+    QPointer<QTcpSocket> m_socket;
+    QTimer m_timeout;
+    QElapsedTimer m_pingTimer;
+    QByteArray m_buffer;
+    ServerStatus m_status;
+    bool m_gotStatus = false;
+};
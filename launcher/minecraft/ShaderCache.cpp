@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ShaderCache.h"
+
+#include <QDir>
+
+#include "FileSystem.h"
+
+namespace ShaderCache {
+
+const QString s_folder = ".shadercache";
+
+QString path(const QString& gameRoot)
+{
+    return FS::PathCombine(gameRoot, s_folder);
+}
+
+void setUp(QProcessEnvironment& env, const QString& cacheRoot, int maxMiB)
+{
+    QDir root(cacheRoot);
+    auto mesa = root.filePath("mesa");
+    auto nvidia = root.filePath("nvidia");
+    auto dxvk = root.filePath("dxvk");
+    for (auto& folder : { mesa, nvidia, dxvk })
+        FS::ensureFolderPathExists(folder);
+
+    // Mesa, for OpenGL and its Vulkan drivers, the GLSL name for the versions before 20.3
+    env.insert("MESA_SHADER_CACHE_DIR", mesa);
+    env.insert("MESA_GLSL_CACHE_DIR", mesa);
+    env.insert("MESA_SHADER_CACHE_MAX_SIZE", QString("%1M").arg(maxMiB));
+
+    // NVIDIA, for OpenGL and Vulkan, the size in bytes
+    env.insert("__GL_SHADER_DISK_CACHE", "1");
+    env.insert("__GL_SHADER_DISK_CACHE_PATH", nvidia);
+    env.insert("__GL_SHADER_DISK_CACHE_SIZE", QString::number(qint64(maxMiB) * 1024 * 1024));
+
+    // DXVK keeps the pipeline states apart from the drivers, for when the game goes through it
+    env.insert("DXVK_STATE_CACHE_PATH", dxvk);
+}
+
+}  // namespace ShaderCache
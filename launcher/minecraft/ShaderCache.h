@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QProcessEnvironment>
+#include <QString>
+
+/* A shader cache of the instance's own, kept in its game folder.
+ *
+ * The drivers keep what they compiled in one cache for every program of the user, bounded in size. Switching between
+ * instances with many shaders evicts those of the others, so each launch compiles them again and stutters meanwhile.
+ * Pointing the drivers at a folder of the instance keeps its shaders with it, and they go when it goes.
+ */
+namespace ShaderCache {
+
+/** The folder of the cache, relative to the game folder. */
+extern const QString s_folder;
+
+QString path(const QString& gameRoot);
+
+/** Points the OpenGL drivers (Mesa, NVIDIA) and the Vulkan layers at the cache in `cacheRoot`, up to `maxMiB` of it
+ * each, and makes the folders the drivers don't make themselves. */
+void setUp(QProcessEnvironment& env, const QString& cacheRoot, int maxMiB);
+
+}  // namespace ShaderCache
@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "VersionPrefetcher.h"
+
+#include <QDebug>
+
+#include "Application.h"
+#include "meta/Index.h"
+#include "minecraft/Library.h"
+#include "minecraft/VersionFile.h"
+#include "net/ChecksumValidator.h"
+
+namespace {
+// Don't start fetching anything while the user is just scrolling through the versions
+constexpr int s_prefetch_delay = 1500;
+}  // namespace
+
+VersionPrefetcher::VersionPrefetcher(QObject* parent) : QObject(parent)
+{
+    m_delay.setSingleShot(true);
+    m_delay.setInterval(s_prefetch_delay);
+    connect(&m_delay, &QTimer::timeout, this, &VersionPrefetcher::start);
+}
+
+void VersionPrefetcher::prefetch(const QString& uid, const QString& version)
+{
+    if (uid.isEmpty() || version.isEmpty() || !APPLICATION->settings()->get("PrefetchVersions").toBool())
+        return;
+    if (uid == m_uid && version == m_version && (m_delay.isActive() || m_loading > 0 || m_job))
+        return;
+
+    m_uid = uid;
+    m_version = version;
+    m_delay.start();
+}
+
+void VersionPrefetcher::cancel()
+{
+    m_delay.stop();
+    m_generation++;
+    m_loading = 0;
+    m_loaded.clear();
+    if (m_job) {
+        m_job->abort();
+        m_job.reset();
+    }
+}
+
+void VersionPrefetcher::start()
+{
+    cancel();
+
+    qDebug() << "Prefetching" << m_uid << m_version;
+    m_runtime_context.updateFromInstanceSettings(APPLICATION->settings());
+    m_job.reset(new NetJob(tr("Prefetch %1 %2").arg(m_uid, m_version), APPLICATION->network()));
+    m_job->setPriority(Net::Priority::Background);
+
+    loadVersion(m_uid, m_version);
+}
+
+void VersionPrefetcher::loadVersion(const QString& uid, const QString& version)
+{
+    auto key = uid + ':' + version;
+    if (m_loaded.contains(key))
+        return;
+    m_loaded.insert(key);
+
+    auto meta_version = APPLICATION->metadataIndex()->get(uid, version);
+    if (!meta_version)
+        return;
+
+    m_loading++;
+    meta_version->load(Net::Mode::Online);
+    auto task = meta_version->getCurrentTask();
+    if (task && task->isRunning()) {
+        auto generation = m_generation;
+        connect(task.get(), &Task::finished, this, [this, generation, meta_version] { versionLoaded(generation, meta_version); });
+    } else {
+        versionLoaded(m_generation, meta_version);
+    }
+}
+
+void VersionPrefetcher::versionLoaded(int generation, Meta::Version::Ptr version)
+{
+    if (generation != m_generation || !m_job)
+        return;
+    m_loading--;
+
+    if (version->isLoaded()) {
+        for (auto& require : version->requiredSet()) {
+            auto required_version = require.equalsVersion.isEmpty() ? require.suggests : require.equalsVersion;
+            if (!required_version.isEmpty())
+                loadVersion(require.uid, required_version);
+        }
+        addDownloads(version->data());
+    } else {
+        qDebug() << "Not prefetching" << version->uid() << version->version() << "further, its metadata couldn't be loaded";
+    }
+
+    if (m_loading == 0)
+        startDownloads();
+}
+
+void VersionPrefetcher::addDownloads(const VersionFilePtr& data)
+{
+    auto metacache = APPLICATION->metacache();
+
+    QList<LibraryPtr> libraries;
+    libraries.append(data->libraries);
+    libraries.append(data->mavenFiles);
+    if (data->mainJar)
+        libraries.append(data->mainJar);
+
+    for (auto& library : libraries) {
+        // these only exist on the disk of whoever made the pack
+        if (!library->isActive(m_runtime_context) || library->isLocal())
+            continue;
+        QStringList failed_local_files;
+        for (auto& download : library->getDownloads(m_runtime_context, metacache.get(), failed_local_files, QString()))
+            m_job->addNetAction(download);
+    }
+
+    auto assets = data->mojangAssetIndex;
+    if (assets && !assets->url.isEmpty()) {
+        auto entry = metacache->resolveEntry("asset_indexes", assets->id + ".json");
+        if (entry->isStale()) {
+            auto download = Net::Download::makeCached(QUrl(assets->url), entry);
+            if (!assets->sha1.isEmpty())
+                download->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, QByteArray::fromHex(assets->sha1.toLatin1())));
+            m_job->addNetAction(download);
+        }
+    }
+}
+
+void VersionPrefetcher::startDownloads()
+{
+    if (m_job->size() == 0) {
+        qDebug() << "Nothing to prefetch for" << m_uid << m_version;
+        m_job.reset();
+        return;
+    }
+
+    qDebug() << "Prefetching" << m_job->size() << "files for" << m_uid << m_version;
+    auto generation = m_generation;
+    connect(m_job.get(), &NetJob::finished, this, [this, generation] {
+        if (generation == m_generation)
+            m_job.reset();
+    });
+    m_job->start();
+}
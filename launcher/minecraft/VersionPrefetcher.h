@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+
+#include "RuntimeContext.h"
+#include "meta/Version.h"
+#include "net/NetJob.h"
+
+/* Warms up the caches for a version of a component while the user is still deciding whether to create an instance with it.
+ *
+ * Once a version stays selected for a moment, its metadata is loaded along with the metadata of everything it requires,
+ * and the libraries and asset index those need are downloaded into the shared caches at background priority. Creating
+ * the instance and launching it for the first time then mostly finds everything already there.
+ *
+ * Only one version is prefetched at a time: selecting another one cancels what's left of the previous one.
+ */
+class VersionPrefetcher : public QObject {
+    Q_OBJECT
+   public:
+    explicit VersionPrefetcher(QObject* parent = nullptr);
+
+    /** Prefetches that version of the component with that uid (e.g. "net.minecraft"), unless something else gets selected soon. */
+    void prefetch(const QString& uid, const QString& version);
+
+    /** Stops prefetching anything. */
+    void cancel();
+
+   private:
+    void start();
+    void loadVersion(const QString& uid, const QString& version);
+    void versionLoaded(int generation, Meta::Version::Ptr version);
+    void addDownloads(const VersionFilePtr& data);
+    void startDownloads();
+
+   private:
+    QString m_uid;
+    QString m_version;
+    QTimer m_delay;
+
+    // bumped for every version prefetched, to ignore the results of the ones no longer selected
+    int m_generation = 0;
+    int m_loading = 0;
+    QSet<QString> m_loaded;
+    RuntimeContext m_runtime_context;
+    NetJob::Ptr m_job;
+};
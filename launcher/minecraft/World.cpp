@@ -42,6 +42,7 @@
 #include "World.h"
 
 #include "GZip.h"
+#include "NbtReader.h"
 #include <MMCZip.h>
 #include <FileSystem.h>
 #include <sstream>
@@ -49,8 +50,6 @@
 #include <tag_string.h>
 #include <tag_primitive.h>
 #include <quazip/quazip.h>
-#include <quazip/quazipfile.h>
-#include <quazip/quazipdir.h>
 
 #include <QCoreApplication>
 
@@ -236,11 +235,22 @@ World::World(const QFileInfo &file)
     repath(file);
 }
 
+World::World(const QFileInfo &file, int64_t bytes)
+{
+    readContainer(file);
+    m_size = bytes;
+}
+
 void World::repath(const QFileInfo &file)
+{
+    readContainer(file);
+    m_size = calculateWorldSize(file);
+}
+
+void World::readContainer(const QFileInfo &file)
 {
     m_containerFile = file;
     m_folderName = file.fileName();
-    m_size = calculateWorldSize(file);
     if(file.isFile() && file.suffix() == "zip")
     {
         m_iconFile = QString();
@@ -282,41 +292,29 @@ void World::readFromFS(const QFileInfo &file)
 
 void World::readFromZip(const QFileInfo &file)
 {
-    QuaZip zip(file.absoluteFilePath());
-    is_valid = zip.open(QuaZip::mdUnzip);
+    MMCZip::ArchiveReader zip(file.absoluteFilePath());
+    is_valid = zip.open();
     if (!is_valid)
     {
         return;
     }
-    auto location = MMCZip::findFolderOfFileInZip(&zip, "level.dat");
+    auto location = MMCZip::findFolderOfFileInZip(zip, "level.dat");
     is_valid = !location.isEmpty();
     if (!is_valid)
     {
         return;
     }
     m_containerOffsetPath = location;
-    QuaZipFile zippedFile(&zip);
     // read the install profile
-    is_valid = zip.setCurrentFile(location + "level.dat");
-    if (!is_valid)
-    {
-        return;
-    }
-    is_valid = zippedFile.open(QIODevice::ReadOnly);
-    QuaZipFileInfo64 levelDatInfo;
-    zippedFile.getFileInfo(&levelDatInfo);
-    auto modTime = levelDatInfo.getNTFSmTime();
-    if(!modTime.isValid())
-    {
-        modTime = levelDatInfo.dateTime;
-    }
-    levelDatTime = modTime;
+    auto levelDat = zip.entry(location + "level.dat");
+    auto contents = zip.read(location + "level.dat");
+    is_valid = levelDat && contents;
     if (!is_valid)
     {
         return;
     }
-    loadFromLevelDat(zippedFile.readAll());
-    zippedFile.close();
+    levelDatTime = levelDat->modified;
+    loadFromLevelDat(*contents);
 }
 
 bool World::install(const QString &to, const QString &name)
@@ -334,7 +332,7 @@ bool World::install(const QString &to, const QString &name)
         {
             return false;
         }
-        ok = !MMCZip::extractSubDir(&zip, m_containerOffsetPath, finalPath);
+        ok = MMCZip::extractSubDir(&zip, m_containerOffsetPath, finalPath).has_value();
     }
     else if(m_containerFile.isDir())
     {
@@ -396,130 +394,101 @@ bool World::rename(const QString &newName)
 
 namespace {
 
-optional<QString> read_string (nbt::value& parent, const char * name)
+// the level.dat fields the world list shows, everything else in there is skipped over
+const QStringList levelDatFields = {
+    "Data",
+    "Data/LevelName",
+    "Data/LastPlayed",
+    "Data/GameType",
+    "Data/WorldGenSettings/seed",
+    "Data/RandomSeed",
+};
+
+optional<QVariant> read_field(const NbtReader& reader, const QString& path, NbtReader::TagType type, const char* typeName)
 {
-    try
-    {
-        auto &namedValue = parent.at(name);
-        if(namedValue.get_type() != nbt::tag_type::String)
-        {
-            return nullopt;
-        }
-        auto & tag_str = namedValue.as<nbt::tag_string>();
-        return QString::fromStdString(tag_str.get());
-    }
-    catch (const std::out_of_range &e)
+    auto field = reader.field(path);
+    if(!field)
     {
         // fallback for old world formats
-        qWarning() << "String NBT tag" << name << "could not be found.";
+        qWarning() << typeName << "NBT tag" << path << "could not be found.";
         return nullopt;
     }
-    catch (const std::bad_cast &e)
+    if(field->type != type)
     {
         // type mismatch
-        qWarning() << "NBT tag" << name << "could not be converted to string.";
+        qWarning() << "NBT tag" << path << "could not be converted to" << typeName;
         return nullopt;
     }
+    return field->value;
 }
 
-optional<int64_t> read_long (nbt::value& parent, const char * name)
+optional<QString> read_string(const NbtReader& reader, const QString& path)
 {
-    try
-    {
-        auto &namedValue = parent.at(name);
-        if(namedValue.get_type() != nbt::tag_type::Long)
-        {
-            return nullopt;
-        }
-        auto & tag_str = namedValue.as<nbt::tag_long>();
-        return tag_str.get();
-    }
-    catch (const std::out_of_range &e)
-    {
-        // fallback for old world formats
-        qWarning() << "Long NBT tag" << name << "could not be found.";
-        return nullopt;
-    }
-    catch (const std::bad_cast &e)
-    {
-        // type mismatch
-        qWarning() << "NBT tag" << name << "could not be converted to long.";
-        return nullopt;
-    }
+    auto value = read_field(reader, path, NbtReader::TagType::String, "String");
+    return value ? optional<QString>(value->toString()) : nullopt;
 }
 
-optional<int> read_int (nbt::value& parent, const char * name)
+optional<int64_t> read_long(const NbtReader& reader, const QString& path)
 {
-    try
-    {
-        auto &namedValue = parent.at(name);
-        if(namedValue.get_type() != nbt::tag_type::Int)
-        {
-            return nullopt;
-        }
-        auto & tag_str = namedValue.as<nbt::tag_int>();
-        return tag_str.get();
-    }
-    catch (const std::out_of_range &e)
-    {
-        // fallback for old world formats
-        qWarning() << "Int NBT tag" << name << "could not be found.";
-        return nullopt;
-    }
-    catch (const std::bad_cast &e)
-    {
-        // type mismatch
-        qWarning() << "NBT tag" << name << "could not be converted to int.";
-        return nullopt;
-    }
+    auto value = read_field(reader, path, NbtReader::TagType::Long, "Long");
+    return value ? optional<int64_t>(value->toLongLong()) : nullopt;
 }
 
-GameType read_gametype(nbt::value& parent, const char * name) {
-    return GameType(read_int(parent, name));
+optional<int> read_int(const NbtReader& reader, const QString& path)
+{
+    auto value = read_field(reader, path, NbtReader::TagType::Int, "Int");
+    return value ? optional<int>(value->toInt()) : nullopt;
+}
+
+GameType read_gametype(const NbtReader& reader, const QString& path) {
+    return GameType(read_int(reader, path));
 }
 
 }
 
 void World::loadFromLevelDat(QByteArray data)
 {
-    auto levelData = parseLevelDat(data);
-    if(!levelData)
+    // inflated as it is read, and only until the wanted fields are found
+    GZipReader device(std::move(data));
+    if(!device.open(QIODevice::ReadOnly))
     {
         is_valid = false;
         return;
     }
-
-    nbt::value * valPtr = nullptr;
-    try {
-        valPtr = &levelData->at("Data");
+    NbtReader reader(&device);
+    if(!reader.read(levelDatFields) || !reader.rootName().isEmpty())
+    {
+        qWarning() << "Unable to parse level.dat of" << m_folderName << ":" << reader.errorString();
+        is_valid = false;
+        return;
     }
-    catch (const std::out_of_range &e) {
-        qWarning() << "Unable to read NBT tags from " << m_folderName << ":" << e.what();
+
+    auto dataField = reader.field("Data");
+    if(!dataField)
+    {
+        qWarning() << "Unable to read NBT tags from " << m_folderName << ": there is no Data tag";
         is_valid = false;
         return;
     }
-    nbt::value &val = *valPtr;
 
-    is_valid = val.get_type() == nbt::tag_type::Compound;
+    is_valid = dataField->type == NbtReader::TagType::Compound;
     if(!is_valid)
         return;
 
-    auto name = read_string(val, "LevelName");
+    auto name = read_string(reader, "Data/LevelName");
     m_actualName = name ? *name : m_folderName;
 
-    auto timestamp = read_long(val, "LastPlayed");
+    auto timestamp = read_long(reader, "Data/LastPlayed");
     m_lastPlayed = timestamp ? QDateTime::fromMSecsSinceEpoch(*timestamp) : levelDatTime;
 
-    m_gameType = read_gametype(val, "GameType");
+    m_gameType = read_gametype(reader, "Data/GameType");
 
     optional<int64_t> randomSeed;
-    try {
-        auto &WorldGen_val = val.at("WorldGenSettings");
-        randomSeed = read_long(WorldGen_val, "seed");
+    if(reader.field("Data/WorldGenSettings/seed")) {
+        randomSeed = read_long(reader, "Data/WorldGenSettings/seed");
     }
-    catch (const std::out_of_range &) {}
     if(!randomSeed) {
-        randomSeed = read_long(val, "RandomSeed");
+        randomSeed = read_long(reader, "Data/RandomSeed");
     }
     m_randomSeed = randomSeed ? *randomSeed : 0;
 
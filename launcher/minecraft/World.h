@@ -40,6 +40,8 @@ class World
 {
 public:
     World(const QFileInfo &file);
+    // same, but with a size worked out elsewhere, going through all the files of a big world takes a while
+    World(const QFileInfo &file, int64_t bytes);
     QString folderName() const
     {
         return m_folderName;
@@ -111,6 +113,7 @@ public:
     QString canonicalFilePath() const { return m_containerFile.canonicalFilePath(); }
 
 private:
+    void readContainer(const QFileInfo &file);
     void readFromZip(const QFileInfo &file);
     void readFromFS(const QFileInfo &file);
     void loadFromLevelDat(QByteArray data);
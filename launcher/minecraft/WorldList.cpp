@@ -37,13 +37,17 @@
 
 #include "Application.h"
 #include <FileSystem.h>
+#include <FileWatcher.h>
 #include <Qt>
 #include <QMimeData>
 #include <QUrl>
 #include <QUuid>
 #include <QString>
-#include <QFileSystemWatcher>
 #include <QDebug>
+#include <QDirIterator>
+#include <QSet>
+#include <QThreadPool>
+#include <QtConcurrent>
 
 WorldList::WorldList(const QString &dir, BaseInstance* instance)
     : QAbstractListModel(), m_instance(instance), m_dir(dir)
@@ -51,9 +55,19 @@ WorldList::WorldList(const QString &dir, BaseInstance* instance)
     FS::ensureFolderPathExists(m_dir.absolutePath());
     m_dir.setFilter(QDir::Readable | QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs);
     m_dir.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
-    m_watcher = new QFileSystemWatcher(this);
+    m_watcher = new FileWatcher(this);
     is_watching = false;
-    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &WorldList::directoryChanged);
+    connect(m_watcher, &FileWatcher::changed, this, &WorldList::directoryChanged);
+}
+
+WorldList::~WorldList()
+{
+    // the scans check this between worlds, and they use this list until they're done
+    m_scanGeneration++;
+    for (auto& future : m_scanFutures)
+    {
+        future.waitForFinished();
+    }
 }
 
 void WorldList::startWatching()
@@ -96,7 +110,8 @@ bool WorldList::update()
     if (!isValid())
         return false;
 
-    QList<World> newWorlds;
+    QList<QFileInfo> folders;
+    QSet<QString> names;
     m_dir.refresh();
     auto folderContents = m_dir.entryInfoList();
     // if there are any untracked files...
@@ -105,18 +120,141 @@ bool WorldList::update()
         if(!entry.isDir())
             continue;
 
-        World w(entry);
-        if(w.isValid())
+        folders.append(entry);
+        names.insert(entry.fileName());
+    }
+
+    // the worlds that are gone go right away, the others get replaced as they're read again
+    for (int i = worlds.size() - 1; i >= 0; i--)
+    {
+        if (names.contains(worlds[i].folderName()))
+            continue;
+        beginRemoveRows(QModelIndex(), i, i);
+        worlds.removeAt(i);
+        endRemoveRows();
+    }
+    for (auto iter = m_scans.begin(); iter != m_scans.end();)
+    {
+        if (names.contains(iter.key()))
+            iter++;
+        else
+            iter = m_scans.erase(iter);
+    }
+
+    for (int i = m_scanFutures.size() - 1; i >= 0; i--)
+    {
+        if (m_scanFutures[i].isFinished())
+            m_scanFutures.removeAt(i);
+    }
+
+    // any scan still running is out of date now
+    int generation = ++m_scanGeneration;
+    auto previousScans = m_scans;
+    m_scanFutures.append(QtConcurrent::run(QThreadPool::globalInstance(), [this, generation, folders, previousScans] {
+        for (auto& folder : folders)
         {
-            newWorlds.append(w);
+            if (m_scanGeneration != generation)
+                return;
+            auto scan = scanWorld(folder, previousScans.value(folder.fileName()));
+            QMetaObject::invokeMethod(this, [this, generation, scan] { worldScanned(generation, scan); }, Qt::QueuedConnection);
         }
-    }
-    beginResetModel();
-    worlds.swap(newWorlds);
-    endResetModel();
+    }));
     return true;
 }
 
+WorldList::WorldScan WorldList::scanWorld(const QFileInfo &folder, const WorldScan &previous)
+{
+    WorldScan scan;
+    QDir root(folder.absoluteFilePath());
+    QFileInfo levelDat(root.absoluteFilePath("level.dat"));
+    QFileInfo icon(root.absoluteFilePath("icon.png"));
+    scan.levelDatModified = levelDat.exists() ? levelDat.lastModified() : QDateTime();
+    scan.levelDatSize = levelDat.exists() ? levelDat.size() : -1;
+    scan.iconModified = icon.exists() ? icon.lastModified() : QDateTime();
+
+    // the game saves level.dat whenever it saves anything else, region files included
+    bool unchanged = previous.world && previous.levelDatModified == scan.levelDatModified && previous.levelDatSize == scan.levelDatSize;
+
+    // region files get written over without their folder changing, so only the folders of worlds that weren't played since
+    // can be trusted to still have the same size. Those can also be left alone as long as nothing was added or removed.
+    int64_t bytes = 0;
+    QStringList paths = { QString() };
+    QDirIterator subfolders(root.absolutePath(), QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (subfolders.hasNext())
+    {
+        paths.append(root.relativeFilePath(subfolders.next()));
+    }
+    for (auto& path : paths)
+    {
+        QFileInfo info(path.isEmpty() ? root.absolutePath() : root.absoluteFilePath(path));
+        FolderSize size;
+        size.modified = info.lastModified();
+        auto known = previous.folders.constFind(path);
+        if (unchanged && known != previous.folders.constEnd() && known->modified == size.modified)
+        {
+            size.bytes = known->bytes;
+        }
+        else
+        {
+            for (auto& file : QDir(info.absoluteFilePath()).entryInfoList(QDir::Files))
+            {
+                size.bytes += file.size();
+            }
+        }
+        scan.folders.insert(path, size);
+        bytes += size.bytes;
+    }
+
+    if (unchanged && previous.iconModified == scan.iconModified && previous.world->bytes() == bytes)
+    {
+        scan.world = previous.world;
+    }
+    else
+    {
+        scan.world = World(folder, bytes);
+    }
+    return scan;
+}
+
+void WorldList::worldScanned(int generation, const WorldScan &scan)
+{
+    if (generation != m_scanGeneration)
+        return;
+
+    auto& world = *scan.world;
+    m_scans.insert(world.folderName(), scan);
+
+    int row = -1;
+    for (int i = 0; i < worlds.size(); i++)
+    {
+        if (worlds[i].folderName() == world.folderName())
+        {
+            row = i;
+            break;
+        }
+    }
+
+    if (!world.isValid())
+    {
+        if (row >= 0)
+        {
+            beginRemoveRows(QModelIndex(), row, row);
+            worlds.removeAt(row);
+            endRemoveRows();
+        }
+        return;
+    }
+    if (row >= 0)
+    {
+        worlds[row] = world;
+        emit dataChanged(index(row, 0), index(row, columnCount(QModelIndex()) - 1));
+        return;
+    }
+    beginInsertRows(QModelIndex(), worlds.size(), worlds.size());
+    worlds.append(world);
+    endInsertRows();
+}
+
 void WorldList::directoryChanged(QString path)
 {
     update();
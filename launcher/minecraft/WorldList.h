@@ -19,11 +19,15 @@
 #include <QString>
 #include <QDir>
 #include <QAbstractListModel>
+#include <QFuture>
+#include <QHash>
 #include <QMimeData>
+#include <atomic>
+#include <optional>
 #include "minecraft/World.h"
 #include "BaseInstance.h"
 
-class QFileSystemWatcher;
+class FileWatcher;
 
 class WorldList : public QAbstractListModel
 {
@@ -51,6 +55,7 @@ public:
     };
 
     WorldList(const QString &dir, BaseInstance* instance);
+    virtual ~WorldList();
 
     virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
 
@@ -75,7 +80,7 @@ public:
         return worlds[index];
     }
 
-    /// Reloads the mod list and returns true if the list changed.
+    /// Starts reloading the world list in the background, the worlds get updated one by one as they are read.
     virtual bool update();
 
     /// Install a world from location
@@ -127,10 +132,36 @@ private slots:
 signals:
     void changed();
 
+private:
+    struct FolderSize
+    {
+        QDateTime modified;
+        int64_t bytes = 0;
+    };
+    // what was read from a world folder, it doesn't have to be read again as long as these files stay the same
+    struct WorldScan
+    {
+        QDateTime levelDatModified;
+        qint64 levelDatSize = -1;
+        QDateTime iconModified;
+        std::optional<World> world;
+        // relative path -> size of the files directly in it
+        QHash<QString, FolderSize> folders;
+    };
+
+    static WorldScan scanWorld(const QFileInfo &folder, const WorldScan &previous);
+    void worldScanned(int generation, const WorldScan &scan);
+
 protected:
     BaseInstance* m_instance;
-    QFileSystemWatcher *m_watcher;
+    FileWatcher *m_watcher;
     bool is_watching;
     QDir m_dir;
     QList<World> worlds;
+
+private:
+    // folder name -> the last time it was read
+    QHash<QString, WorldScan> m_scans;
+    std::atomic<int> m_scanGeneration { 0 };
+    QList<QFuture<void>> m_scanFutures;
 };
@@ -0,0 +1,659 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "WorldSnapshots.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSaveFile>
+#include <QSet>
+#include <QtConcurrent>
+
+#include <atomic>
+#include <optional>
+#include <vector>
+
+#include "Executors.h"
+#include "FileSystem.h"
+
+namespace {
+constexpr quint32 s_magic = 0x574E5350;  // WNSP
+constexpr quint32 s_version = 1;
+const QString s_suffix = ".snapshot";
+
+// the region files are in sectors of 4 KiB, the first two being the locations and the timestamps of the chunks
+constexpr int s_sector = 4096;
+constexpr int s_slots = 1024;
+// the compression type of the chunks the game didn't compress
+constexpr quint8 s_uncompressed_chunk = 3;
+
+// the game keeps it locked while the world is open, and there's nothing in it but a timestamp
+const QString s_session_lock = "session.lock";
+
+// one change to a store at a time, so the garbage collection never sees the objects of a manifest that isn't written yet
+QMutex s_store_lock;
+
+enum class Kind : quint8 { Folder = 0, Plain = 1, Region = 2 };
+
+struct Chunk {
+    quint16 index = 0;
+    quint32 timestamp = 0;
+    quint8 sectors = 0;
+    QByteArray hash;
+};
+
+struct Entry {
+    QString path;
+    qint64 size = 0;
+    qint64 mtime = 0;
+    Kind kind = Kind::Plain;
+    // of the contents of a plain file
+    QByteArray hash;
+    // of a region file, by index
+    std::vector<Chunk> chunks;
+};
+
+struct Manifest {
+    QDateTime created;
+    qint64 size = 0;
+    std::vector<Entry> entries;
+};
+
+quint32 readBigEndian(const uchar* data, int bytes)
+{
+    quint32 value = 0;
+    for (int i = 0; i < bytes; i++)
+        value = (value << 8) | data[i];
+    return value;
+}
+
+void writeBigEndian(uchar* data, quint32 value, int bytes)
+{
+    for (int i = bytes - 1; i >= 0; i--) {
+        data[i] = value & 0xff;
+        value >>= 8;
+    }
+}
+
+QByteArray sha1(const QByteArray& data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+/* The objects, each in a file named by the SHA-1 of its contents, with a byte before them telling whether they are
+ * compressed. */
+class Store {
+   public:
+    explicit Store(const QString& root) : m_root(root) {}
+
+    QString path(const QByteArray& hash) const
+    {
+        auto hex = QString::fromLatin1(hash.toHex());
+        return FS::PathCombine(m_root, "objects", hex.left(2), hex);
+    }
+
+    /** Adds the size of what it wrote to `written`. */
+    bool put(const QByteArray& hash, const QByteArray& data, bool compress, qint64& written) const
+    {
+        auto object_path = path(hash);
+        if (QFileInfo::exists(object_path))
+            return true;
+
+        QByteArray stored;
+        if (compress) {
+            auto compressed = qCompress(data);
+            // not worth it for what the game compressed already (level.dat, the icon)
+            if (compressed.size() < data.size() * 9 / 10)
+                stored = QByteArray(1, '\1') + compressed;
+        }
+        if (stored.isEmpty())
+            stored = QByteArray(1, '\0') + data;
+
+        if (!FS::ensureFilePathExists(object_path))
+            return false;
+        QSaveFile file(object_path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(stored) != stored.size() || !file.commit())
+            return false;
+        written += stored.size();
+        return true;
+    }
+
+    /** Nothing when it's missing or damaged. */
+    std::optional<QByteArray> get(const QByteArray& hash) const
+    {
+        QFile file(path(hash));
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        auto stored = file.readAll();
+        if (stored.isEmpty())
+            return {};
+        auto data = stored.at(0) == '\1' ? qUncompress(reinterpret_cast<const uchar*>(stored.constData()) + 1, stored.size() - 1)
+                                         : stored.mid(1);
+        if (sha1(data) != hash)
+            return {};
+        return data;
+    }
+
+   private:
+    QString m_root;
+};
+
+QString worldsRoot(const QString& root)
+{
+    return FS::PathCombine(root, "worlds");
+}
+
+QString manifestPath(const QString& root, const QString& world, const QString& id)
+{
+    return FS::PathCombine(worldsRoot(root), world, id + s_suffix);
+}
+
+bool writeManifest(const QString& path, const Manifest& manifest)
+{
+    if (!FS::ensureFilePathExists(path))
+        return false;
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << s_magic << s_version << manifest.created.toMSecsSinceEpoch() << quint32(manifest.entries.size()) << manifest.size;
+    for (auto& entry : manifest.entries) {
+        out << entry.path << entry.size << entry.mtime << quint8(entry.kind);
+        if (entry.kind == Kind::Plain) {
+            out.writeRawData(entry.hash.constData(), entry.hash.size());
+        } else if (entry.kind == Kind::Region) {
+            out << quint32(entry.chunks.size());
+            for (auto& chunk : entry.chunks) {
+                out << chunk.index << chunk.timestamp << chunk.sectors;
+                out.writeRawData(chunk.hash.constData(), chunk.hash.size());
+            }
+        }
+    }
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+/** Only the header with `header_only`, what a Snapshot says, the entries being left empty. */
+std::optional<Manifest> readManifest(const QString& path, bool header_only = false)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0, version = 0, count = 0;
+    qint64 created = 0;
+    Manifest manifest;
+    in >> magic >> version >> created >> count >> manifest.size;
+    if (magic != s_magic || version != s_version || in.status() != QDataStream::Ok)
+        return {};
+    manifest.created = QDateTime::fromMSecsSinceEpoch(created, Qt::UTC);
+    if (header_only) {
+        manifest.entries.resize(count);
+        return manifest;
+    }
+
+    auto readHash = [&in] {
+        QByteArray hash(20, Qt::Uninitialized);
+        if (in.readRawData(hash.data(), hash.size()) != hash.size())
+            in.setStatus(QDataStream::ReadPastEnd);
+        return hash;
+    };
+    manifest.entries.reserve(count);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        Entry entry;
+        quint8 kind = 0;
+        in >> entry.path >> entry.size >> entry.mtime >> kind;
+        entry.kind = static_cast<Kind>(kind);
+        if (entry.kind == Kind::Plain) {
+            entry.hash = readHash();
+        } else if (entry.kind == Kind::Region) {
+            quint32 chunks = 0;
+            in >> chunks;
+            if (chunks > quint32(s_slots))
+                return {};
+            entry.chunks.resize(chunks);
+            for (auto& chunk : entry.chunks) {
+                in >> chunk.index >> chunk.timestamp >> chunk.sectors;
+                chunk.hash = readHash();
+            }
+        } else if (entry.kind != Kind::Folder) {
+            return {};
+        }
+        manifest.entries.push_back(std::move(entry));
+    }
+    if (in.status() != QDataStream::Ok)
+        return {};
+    return manifest;
+}
+
+struct Work {
+    Entry* entry = nullptr;
+    QString path;
+    // the same file in the last snapshot
+    const Entry* previous = nullptr;
+    qint64 written = 0;
+    QString error;
+};
+
+/* Splits a region file into its chunks. Returns false when it isn't laid out like one, to store it as a plain file. */
+bool snapshotRegion(const Store& store, Work& work, QFile& file)
+{
+    auto size = file.size();
+    auto header = file.read(2 * s_sector);
+    if (header.size() != 2 * s_sector)
+        return false;
+    auto data = reinterpret_cast<const uchar*>(header.constData());
+
+    QHash<quint16, const Chunk*> known;
+    if (work.previous && work.previous->kind == Kind::Region) {
+        for (auto& chunk : work.previous->chunks)
+            known.insert(chunk.index, &chunk);
+    }
+
+    std::vector<Chunk> chunks;
+    for (int i = 0; i < s_slots; i++) {
+        auto location = readBigEndian(data + i * 4, 3);
+        quint8 sectors = data[i * 4 + 3];
+        // not generated yet
+        if (location == 0 && sectors == 0)
+            continue;
+        if (location < 2 || sectors == 0 || qint64(location) * s_sector + 5 > size)
+            return false;
+
+        Chunk chunk;
+        chunk.index = i;
+        chunk.timestamp = readBigEndian(data + s_sector + i * 4, 4);
+        chunk.sectors = sectors;
+        // the game sets the timestamp each time it saves the chunk
+        auto previous = known.value(chunk.index);
+        if (previous && previous->timestamp == chunk.timestamp && previous->sectors == chunk.sectors) {
+            chunk.hash = previous->hash;
+            chunks.push_back(chunk);
+            continue;
+        }
+
+        if (!file.seek(qint64(location) * s_sector))
+            return false;
+        auto payload = file.read(5);
+        if (payload.size() != 5)
+            return false;
+        auto length = readBigEndian(reinterpret_cast<const uchar*>(payload.constData()), 4);
+        if (length < 1 || qint64(length) + 4 > qint64(sectors) * s_sector)
+            return false;
+        payload += file.read(length - 1);
+        if (payload.size() != qint64(length) + 4)
+            return false;
+
+        chunk.hash = sha1(payload);
+        bool compress = quint8(payload.at(4)) == s_uncompressed_chunk;
+        if (!store.put(chunk.hash, payload, compress, work.written)) {
+            work.error = QObject::tr("Couldn't store a chunk of %1.").arg(work.path);
+            return true;
+        }
+        chunks.push_back(chunk);
+    }
+    work.entry->chunks = std::move(chunks);
+    return true;
+}
+
+void snapshotFile(const Store& store, Work& work)
+{
+    QFile file(work.path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        work.error = QObject::tr("Couldn't read %1: %2").arg(work.path, file.errorString());
+        return;
+    }
+    if (work.entry->kind == Kind::Region) {
+        if (snapshotRegion(store, work, file))
+            return;
+        qDebug() << work.path << "isn't laid out like a region file, it's stored as a whole";
+        work.entry->kind = Kind::Plain;
+        file.seek(0);
+    }
+
+    auto data = file.readAll();
+    if (file.error() != QFileDevice::NoError) {
+        work.error = QObject::tr("Couldn't read %1: %2").arg(work.path, file.errorString());
+        return;
+    }
+    work.entry->hash = sha1(data);
+    if (!store.put(work.entry->hash, data, true, work.written))
+        work.error = QObject::tr("Couldn't store %1.").arg(work.path);
+}
+
+/* The region file again, its chunks one after the other. */
+std::optional<QByteArray> buildRegion(const Store& store, const Entry& entry)
+{
+    QByteArray out(2 * s_sector, '\0');
+    for (auto& chunk : entry.chunks) {
+        auto payload = store.get(chunk.hash);
+        if (!payload)
+            return {};
+        auto sector = out.size() / s_sector;
+        // as many sectors as it had, so the next snapshot knows it again by them
+        auto sectors = qMax<int>((payload->size() + s_sector - 1) / s_sector, chunk.sectors);
+        if (sectors > 255)
+            return {};
+        auto header = reinterpret_cast<uchar*>(out.data());
+        writeBigEndian(header + chunk.index * 4, sector, 3);
+        header[chunk.index * 4 + 3] = sectors;
+        writeBigEndian(header + s_sector + chunk.index * 4, chunk.timestamp, 4);
+        out += *payload;
+        out += QByteArray(sectors * s_sector - payload->size(), '\0');
+    }
+    return out;
+}
+
+bool writeFile(const QString& path, const QByteArray& data, qint64 mtime)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.flush())
+        return false;
+    // the next snapshot knows it again by it
+    file.setFileTime(QDateTime::fromMSecsSinceEpoch(mtime), QFileDevice::FileModificationTime);
+    return true;
+}
+
+QStringList manifestIds(const QString& root, const QString& world)
+{
+    QDir dir(FS::PathCombine(worldsRoot(root), world));
+    QStringList ids;
+    // the ids sort the way they were taken
+    for (auto& name : dir.entryList({ "*" + s_suffix }, QDir::Files, QDir::Name | QDir::Reversed))
+        ids.append(name.chopped(s_suffix.size()));
+    return ids;
+}
+
+void collectGarbageIn(const QString& root)
+{
+    QSet<QByteArray> needed;
+    QDir worlds(worldsRoot(root));
+    for (auto& world : worlds.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        for (auto& id : manifestIds(root, world)) {
+            auto manifest = readManifest(manifestPath(root, world, id));
+            if (!manifest) {
+                // it could need any of them
+                qWarning() << "Not removing any world snapshot data, the snapshot" << id << "of" << world << "can't be read";
+                return;
+            }
+            for (auto& entry : manifest->entries) {
+                needed.insert(entry.hash);
+                for (auto& chunk : entry.chunks)
+                    needed.insert(chunk.hash);
+            }
+        }
+    }
+
+    int removed = 0;
+    QDirIterator it(FS::PathCombine(root, "objects"), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        auto path = it.next();
+        if (!needed.contains(QByteArray::fromHex(it.fileName().toLatin1())) && QFile::remove(path))
+            removed++;
+    }
+    qDebug() << "Removed" << removed << "world snapshot objects no snapshot needs";
+}
+}  // namespace
+
+WorldSnapshots::WorldSnapshots(QString root) : m_root(std::move(root)) {}
+
+auto WorldSnapshots::take(const QString& world_path) const -> TakeResult
+{
+    QMutexLocker lock(&s_store_lock);
+    TakeResult result;
+    QDir world(world_path);
+    if (!world.exists()) {
+        result.error = QObject::tr("The world folder %1 doesn't exist.").arg(world_path);
+        return result;
+    }
+    auto name = QFileInfo(world_path).fileName();
+    Store store(m_root);
+
+    std::optional<Manifest> last;
+    auto ids = manifestIds(m_root, name);
+    if (!ids.isEmpty())
+        last = readManifest(manifestPath(m_root, name, ids.first()));
+    QHash<QString, const Entry*> previous;
+    if (last) {
+        for (auto& entry : last->entries)
+            previous.insert(entry.path, &entry);
+    }
+
+    Manifest manifest;
+    manifest.created = QDateTime::currentDateTimeUtc();
+    std::vector<QString> paths;
+    bool changed = !last;
+    QDirIterator it(world_path, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        auto info = it.fileInfo();
+        Entry entry;
+        entry.path = world.relativeFilePath(info.filePath());
+        if (info.isDir()) {
+            entry.kind = Kind::Folder;
+            changed |= !previous.contains(entry.path);
+            manifest.entries.push_back(entry);
+            paths.emplace_back();
+            continue;
+        }
+        if (!info.isFile() || info.fileName() == s_session_lock)
+            continue;
+
+        entry.size = info.size();
+        entry.mtime = info.lastModified().toMSecsSinceEpoch();
+        manifest.size += entry.size;
+        auto old = previous.value(entry.path);
+        if (old && old->kind != Kind::Folder && old->size == entry.size && old->mtime == entry.mtime) {
+            manifest.entries.push_back(*old);
+            paths.emplace_back();
+            continue;
+        }
+        auto suffix = info.suffix().toLower();
+        entry.kind = suffix == "mca" || suffix == "mcr" ? Kind::Region : Kind::Plain;
+        manifest.entries.push_back(entry);
+        paths.push_back(info.absoluteFilePath());
+        changed = true;
+    }
+    changed |= last && last->entries.size() != manifest.entries.size();
+    if (!changed)
+        return result;
+
+    // the entries don't move anymore
+    std::vector<Work> work;
+    for (size_t i = 0; i < manifest.entries.size(); i++) {
+        if (!paths[i].isEmpty())
+            work.push_back({ &manifest.entries[i], paths[i], previous.value(manifest.entries[i].path), 0, {} });
+    }
+    QtConcurrent::blockingMap(work, [&store](Work& item) { snapshotFile(store, item); });
+    for (auto& item : work) {
+        if (!item.error.isEmpty()) {
+            result.error = item.error;
+            return result;
+        }
+        result.written += item.written;
+    }
+
+    auto id = manifest.created.toString("yyyyMMdd-HHmmss-zzz");
+    if (!writeManifest(manifestPath(m_root, name, id), manifest)) {
+        result.error = QObject::tr("Couldn't save the snapshot of %1.").arg(name);
+        return result;
+    }
+    result.taken = true;
+    result.snapshot = { id, manifest.created, static_cast<int>(manifest.entries.size()), manifest.size };
+    qDebug() << "Took the snapshot" << id << "of" << name << "writing" << result.written << "bytes for" << work.size() << "changed files";
+    return result;
+}
+
+QList<WorldSnapshots::Snapshot> WorldSnapshots::list(const QString& world) const
+{
+    QList<Snapshot> snapshots;
+    for (auto& id : manifestIds(m_root, world)) {
+        auto manifest = readManifest(manifestPath(m_root, world, id), true);
+        if (manifest)
+            snapshots.append({ id, manifest->created, static_cast<int>(manifest->entries.size()), manifest->size });
+    }
+    return snapshots;
+}
+
+QString WorldSnapshots::restore(const QString& world_path, const QString& id) const
+{
+    QMutexLocker lock(&s_store_lock);
+    QFileInfo info(world_path);
+    auto name = info.fileName();
+    auto manifest = readManifest(manifestPath(m_root, name, id));
+    if (!manifest)
+        return QObject::tr("The snapshot %1 of %2 can't be read.").arg(id, name);
+
+    // put together next to the world, so it's only replaced once all of it is there
+    auto staging = FS::PathCombine(info.absolutePath(), "." + name + ".restoring");
+    auto replaced = FS::PathCombine(info.absolutePath(), "." + name + ".replaced");
+    FS::deletePath(staging);
+    FS::deletePath(replaced);
+
+    Store store(m_root);
+    std::vector<const Entry*> files;
+    for (auto& entry : manifest->entries) {
+        if (entry.kind == Kind::Folder)
+            FS::ensureFolderPathExists(FS::PathCombine(staging, entry.path));
+        else
+            files.push_back(&entry);
+    }
+    FS::ensureFolderPathExists(staging);
+
+    std::atomic_bool failed{ false };
+    QtConcurrent::blockingMap(files, [&](const Entry* entry) {
+        auto data = entry->kind == Kind::Region ? buildRegion(store, *entry) : store.get(entry->hash);
+        auto path = FS::PathCombine(staging, entry->path);
+        if (!data || !FS::ensureFilePathExists(path) || !writeFile(path, *data, entry->mtime)) {
+            qWarning() << "Couldn't restore" << entry->path << "of" << name << "from the snapshot" << id;
+            failed = true;
+        }
+    });
+    if (failed) {
+        FS::deletePath(staging);
+        return QObject::tr("Some of the data of the snapshot is missing or damaged, the world was left as it is.");
+    }
+
+    QDir dir;
+    if (info.exists() && !dir.rename(world_path, replaced)) {
+        FS::deletePath(staging);
+        return QObject::tr("The world folder couldn't be replaced, is the game still running?");
+    }
+    if (!dir.rename(staging, world_path)) {
+        dir.rename(replaced, world_path);
+        FS::deletePath(staging);
+        return QObject::tr("The world folder couldn't be replaced.");
+    }
+    FS::deletePath(replaced);
+    qDebug() << "Restored" << name << "from the snapshot" << id;
+    return {};
+}
+
+bool WorldSnapshots::remove(const QString& world, const QString& id) const
+{
+    QMutexLocker lock(&s_store_lock);
+    if (!QFile::remove(manifestPath(m_root, world, id)))
+        return false;
+    collectGarbageIn(m_root);
+    return true;
+}
+
+void WorldSnapshots::prune(const QString& world, int keep) const
+{
+    QMutexLocker lock(&s_store_lock);
+    auto ids = manifestIds(m_root, world);
+    if (ids.size() <= keep)
+        return;
+    for (int i = keep; i < ids.size(); i++)
+        QFile::remove(manifestPath(m_root, world, ids[i]));
+    collectGarbageIn(m_root);
+}
+
+void WorldSnapshots::collectGarbage() const
+{
+    QMutexLocker lock(&s_store_lock);
+    collectGarbageIn(m_root);
+}
+
+WorldSnapshotTask::WorldSnapshotTask(QString root, QStringList world_paths, int keep, QObject* parent)
+    : Task(parent), m_root(std::move(root)), m_world_paths(std::move(world_paths)), m_keep(keep)
+{
+    connect(&m_watcher, &QFutureWatcher<Result>::finished, this, [this] {
+        m_result = m_watcher.result();
+        if (!m_result.errors.isEmpty()) {
+            emitFailed(m_result.errors.join("\n"));
+            return;
+        }
+        emitSucceeded();
+    });
+}
+
+QStringList WorldSnapshotTask::worldsIn(const QString& saves)
+{
+    QStringList worlds;
+    for (auto& info : QDir(saves).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+        // the ones being restored start with a dot
+        if (!info.fileName().startsWith('.') && QFileInfo(FS::PathCombine(info.filePath(), "level.dat")).isFile())
+            worlds.append(info.filePath());
+    }
+    return worlds;
+}
+
+void WorldSnapshotTask::executeTask()
+{
+    setStatus(tr("Taking snapshots of %n world(s)...", nullptr, m_world_paths.size()));
+    m_watcher.setFuture(QtConcurrent::run(Executors::io(), [root = m_root, paths = m_world_paths, keep = m_keep] {
+        WorldSnapshots snapshots(root);
+        Result result;
+        for (auto& path : paths) {
+            auto taken = snapshots.take(path);
+            if (!taken.error.isEmpty()) {
+                result.errors.append(taken.error);
+                continue;
+            }
+            if (taken.taken) {
+                result.taken++;
+                result.written += taken.written;
+            }
+            if (keep > 0)
+                snapshots.prune(QFileInfo(path).fileName(), keep);
+        }
+        return result;
+    }));
+}
+
+WorldRestoreTask::WorldRestoreTask(QString root, QString world_path, QString id, int keep, QObject* parent)
+    : Task(parent), m_root(std::move(root)), m_world_path(std::move(world_path)), m_id(std::move(id)), m_keep(keep)
+{
+    connect(&m_watcher, &QFutureWatcher<QString>::finished, this, [this] {
+        auto error = m_watcher.result();
+        if (!error.isEmpty()) {
+            emitFailed(error);
+            return;
+        }
+        emitSucceeded();
+    });
+}
+
+void WorldRestoreTask::executeTask()
+{
+    setStatus(tr("Restoring the snapshot %1...").arg(m_id));
+    m_watcher.setFuture(QtConcurrent::run(Executors::io(), [root = m_root, path = m_world_path, id = m_id, keep = m_keep] {
+        WorldSnapshots snapshots(root);
+        auto before = snapshots.take(path);
+        if (!before.error.isEmpty())
+            return QObject::tr("Couldn't take a snapshot of the world as it is first: %1").arg(before.error);
+        auto error = snapshots.restore(path, id);
+        // the one restored may be the one to go otherwise
+        if (error.isEmpty() && keep > 0)
+            snapshots.prune(QFileInfo(path).fileName(), keep + 1);
+        return error;
+    }));
+}
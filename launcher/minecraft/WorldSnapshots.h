@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QDateTime>
+#include <QFutureWatcher>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "tasks/Task.h"
+
+/* Backups of the worlds of an instance, that only store what changed since the last one.
+ *
+ * The data goes in a content-addressed store of objects shared by all the snapshots under the root folder, named by
+ * their SHA-1 and compressed with zlib when that makes them smaller. A snapshot is a manifest saying which object each
+ * file of the world was. The region files (.mca, .mcr) are split into their chunks, so a file of which a few chunks
+ * changed only adds those chunks. The chunks are already compressed by the game, they are stored as they are.
+ *
+ * Taking a snapshot only reads what changed: a file with the size and modification time it had in the previous
+ * snapshot is the same, and a chunk with the timestamp and sector count the region header had for it then too.
+ */
+class WorldSnapshots {
+   public:
+    struct Snapshot {
+        QString id;
+        QDateTime created;
+        int files = 0;
+        // of the world, as it was
+        qint64 size = 0;
+    };
+
+    struct TakeResult {
+        QString error;
+        // false when nothing changed since the last one, or it failed
+        bool taken = false;
+        Snapshot snapshot;
+        // what the snapshot added to the store
+        qint64 written = 0;
+    };
+
+    /** The snapshots are kept in `root`, see MinecraftInstance::worldSnapshotsDir(). */
+    explicit WorldSnapshots(QString root);
+
+    /** Takes a snapshot of the world in the folder `world_path`. The world shouldn't be played meanwhile. */
+    TakeResult take(const QString& world_path) const;
+
+    /** The snapshots of the world with that folder name, the newest first. */
+    QList<Snapshot> list(const QString& world) const;
+
+    /** Puts the world in the folder `world_path` back as it was in the snapshot `id`. Returns the error, if any. */
+    QString restore(const QString& world_path, const QString& id) const;
+
+    bool remove(const QString& world, const QString& id) const;
+
+    /** Removes the snapshots of the world past the `keep` newest ones, and the objects no snapshot needs anymore. */
+    void prune(const QString& world, int keep) const;
+
+    /** Removes the objects no snapshot needs. */
+    void collectGarbage() const;
+
+   private:
+    QString m_root;
+};
+
+/* Takes snapshots of worlds, the ones that changed since their last one, and prunes the old ones. */
+class WorldSnapshotTask : public Task {
+    Q_OBJECT
+   public:
+    /** `keep` snapshots are kept of each world, all of them with 0. */
+    WorldSnapshotTask(QString root, QStringList world_paths, int keep, QObject* parent = nullptr);
+
+    /** The worlds of which a snapshot was taken, once the task succeeded. */
+    int taken() const { return m_result.taken; }
+    /** What the snapshots added to the store, once the task succeeded. */
+    qint64 written() const { return m_result.written; }
+
+    /** The folders with a level.dat in `saves`, the worlds the game knows about. */
+    static QStringList worldsIn(const QString& saves);
+
+   protected:
+    void executeTask() override;
+
+   private:
+    struct Result {
+        int taken = 0;
+        qint64 written = 0;
+        QStringList errors;
+    };
+
+    QString m_root;
+    QStringList m_world_paths;
+    int m_keep;
+    Result m_result;
+    QFutureWatcher<Result> m_watcher;
+};
+
+/* Puts a world back as it was in a snapshot. A snapshot of how it was before is taken first, so it can be undone. */
+class WorldRestoreTask : public Task {
+    Q_OBJECT
+   public:
+    WorldRestoreTask(QString root, QString world_path, QString id, int keep, QObject* parent = nullptr);
+
+   protected:
+    void executeTask() override;
+
+   private:
+    QString m_root;
+    QString m_world_path;
+    QString m_id;
+    int m_keep;
+    QFutureWatcher<QString> m_watcher;
+};
@@ -52,6 +52,7 @@
 #include <FileSystem.h>
 #include <QSaveFile>
 
+#include <algorithm>
 #include <chrono>
 
 enum AccountListVersion {
@@ -63,9 +64,6 @@ AccountList::AccountList(QObject *parent) : QAbstractListModel(parent) {
     m_refreshTimer = new QTimer(this);
     m_refreshTimer->setSingleShot(true);
     connect(m_refreshTimer, &QTimer::timeout, this, &AccountList::fillQueue);
-    m_nextTimer = new QTimer(this);
-    m_nextTimer->setSingleShot(true);
-    connect(m_nextTimer, &QTimer::timeout, this, &AccountList::tryNext);
 }
 
 AccountList::~AccountList() noexcept {}
@@ -119,6 +117,7 @@ void AccountList::addAccount(const MinecraftAccountPtr account)
     // hook up notifications for changes in the account
     connect(account.get(), &MinecraftAccount::changed, this, &AccountList::accountChanged);
     connect(account.get(), &MinecraftAccount::activityChanged, this, &AccountList::accountActivityChanged);
+    connect(account.get(), &MinecraftAccount::faceChanged, this, &AccountList::listChanged);
 
     // override/replace existing account with the same profileId
     auto profileId = account->profileId();
@@ -449,6 +448,24 @@ bool AccountList::setData(const QModelIndex &idx, const QVariant &value, int rol
     return true;
 }
 
+AccountList::ListFile AccountList::readListFile(const QString& path)
+{
+    ListFile listFile;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return listFile;
+    }
+    listFile.opened = true;
+
+    // Read the file and close it.
+    QByteArray jsonData = file.readAll();
+    file.close();
+
+    listFile.document = QJsonDocument::fromJson(jsonData, &listFile.parseError);
+    return listFile;
+}
+
 bool AccountList::loadList()
 {
     if (m_listFilePath.isEmpty())
@@ -456,23 +473,21 @@ bool AccountList::loadList()
         qCritical() << "Can't load Mojang account list. No file path given and no default set.";
         return false;
     }
+    return loadList(readListFile(m_listFilePath));
+}
 
-    QFile file(m_listFilePath);
-
+bool AccountList::loadList(const ListFile& listFile)
+{
     // Try to open the file and fail if we can't.
     // TODO: We should probably report this error to the user.
-    if (!file.open(QIODevice::ReadOnly))
+    if (!listFile.opened)
     {
         qCritical() << QString("Failed to read the account list file (%1).").arg(m_listFilePath).toUtf8();
         return false;
     }
 
-    // Read the file and close it.
-    QByteArray jsonData = file.readAll();
-    file.close();
-
-    QJsonParseError parseError;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData, &parseError);
+    const auto& parseError = listFile.parseError;
+    const auto& jsonDoc = listFile.document;
 
     // Fail if the JSON is invalid.
     if (parseError.error != QJsonParseError::NoError)
@@ -507,7 +522,7 @@ bool AccountList::loadList()
             QString newName = "accounts-old.json";
             qWarning() << "Unknown format version when loading account list. Existing one will be renamed to" << newName;
             // Attempt to rename the old version.
-            file.rename(newName);
+            QFile::rename(m_listFilePath, newName);
             return false;
         }
     }
@@ -532,6 +547,7 @@ bool AccountList::loadV2(QJsonObject& root) {
             }
             connect(account.get(), &MinecraftAccount::changed, this, &AccountList::accountChanged);
             connect(account.get(), &MinecraftAccount::activityChanged, this, &AccountList::accountActivityChanged);
+            connect(account.get(), &MinecraftAccount::faceChanged, this, &AccountList::listChanged);
             m_accounts.append(account);
             if (defaultUserName.size() && account->mojangUserName() == defaultUserName) {
                 m_defaultAccount = account;
@@ -543,6 +559,9 @@ bool AccountList::loadV2(QJsonObject& root) {
         }
     }
     endResetModel();
+    // so the faces are there by the time the accounts are shown
+    for (auto& account : m_accounts)
+        account->getFace();
     return true;
 }
 
@@ -563,6 +582,7 @@ bool AccountList::loadV3(QJsonObject& root) {
             }
             connect(account.get(), &MinecraftAccount::changed, this, &AccountList::accountChanged);
             connect(account.get(), &MinecraftAccount::activityChanged, this, &AccountList::accountActivityChanged);
+            connect(account.get(), &MinecraftAccount::faceChanged, this, &AccountList::listChanged);
             m_accounts.append(account);
             if(accountObj.value("active").toBool(false)) {
                 m_defaultAccount = account;
@@ -574,6 +594,9 @@ bool AccountList::loadV3(QJsonObject& root) {
         }
     }
     endResetModel();
+    // so the faces are there by the time the accounts are shown
+    for (auto& account : m_accounts)
+        account->getFace();
     return true;
 }
 
@@ -696,9 +719,7 @@ void AccountList::requestRefresh(QString accountId) {
     }
     m_refreshQueue.push_front(accountId);
     qDebug() << "AccountList: Pushed account with internal ID " << accountId << " to the front of the queue";
-    if(!isActive()) {
-        tryNext();
-    }
+    tryNext();
 }
 
 void AccountList::queueRefresh(QString accountId) {
@@ -711,38 +732,67 @@ void AccountList::queueRefresh(QString accountId) {
 
 
 void AccountList::tryNext() {
-    while (m_refreshQueue.length()) {
+    while (m_refreshQueue.length() && m_refreshing.size() < maxConcurrentRefreshes) {
         auto accountId = m_refreshQueue.front();
         m_refreshQueue.pop_front();
+        if(m_refreshing.contains(accountId)) {
+            continue;
+        }
+        MinecraftAccountPtr account;
         for(int i = 0; i < count(); i++) {
-            auto account = at(i);
-            if(account->internalId() == accountId) {
-                m_currentTask = account->refresh();
-                if(m_currentTask) {
-                    connect(m_currentTask.get(), &AccountTask::succeeded, this, &AccountList::authSucceeded);
-                    connect(m_currentTask.get(), &AccountTask::failed, this, &AccountList::authFailed);
-                    m_currentTask->start();
-                    qDebug() << "RefreshSchedule: Processing account " << account->accountDisplayString() << " with internal ID " << accountId;
-                    return;
-                }
+            if(at(i)->internalId() == accountId) {
+                account = at(i);
+                break;
             }
         }
-        qDebug() << "RefreshSchedule: Account with with internal ID " << accountId << " not found.";
+        if(!account) {
+            qDebug() << "RefreshSchedule: Account with with internal ID " << accountId << " not found.";
+            continue;
+        }
+        auto task = account->refresh();
+        if(!task) {
+            continue;
+        }
+        m_refreshing.insert(accountId, task);
+        connect(task.get(), &AccountTask::succeeded, this, [this, accountId]() { authSucceeded(accountId); });
+        connect(task.get(), &AccountTask::failed, this, [this, accountId](QString reason) { authFailed(accountId, reason); });
+        connect(task.get(), &AccountTask::aborted, this, [this, accountId]() { authFailed(accountId, tr("Aborted")); });
+        // it may be running already, for a launch
+        if(!task->isRunning()) {
+            task->start();
+        }
+        qDebug() << "RefreshSchedule: Processing account " << account->accountDisplayString() << " with internal ID " << accountId;
+    }
+    if(m_refreshQueue.isEmpty() && m_refreshing.isEmpty()) {
+        scheduleRefresh();
     }
-    // if we get here, no account needed refreshing. Schedule refresh in an hour.
-    m_refreshTimer->start(1000 * 3600);
 }
 
-void AccountList::authSucceeded() {
+void AccountList::scheduleRefresh() {
+    // Check at least every hour, for the accounts that couldn't be refreshed because they were in use
+    qint64 delay = 3600 * 1000;
+    auto now = QDateTime::currentDateTimeUtc();
+    for(auto &account : m_accounts) {
+        auto next = account->nextRefresh();
+        if(next.isValid()) {
+            // but don't come back right away for an account that needs a refresh now, it just had one
+            delay = std::min(delay, std::max<qint64>(now.msecsTo(next), 60 * 1000));
+        }
+    }
+    qDebug() << "RefreshSchedule: Next refresh check in" << delay / 1000 << "seconds";
+    m_refreshTimer->start(delay);
+}
+
+void AccountList::authSucceeded(QString accountId) {
     qDebug() << "RefreshSchedule: Background account refresh succeeded";
-    m_currentTask.reset();
-    m_nextTimer->start(1000 * 20);
+    m_refreshing.remove(accountId);
+    tryNext();
 }
 
-void AccountList::authFailed(QString reason) {
+void AccountList::authFailed(QString accountId, QString reason) {
     qDebug() << "RefreshSchedule: Background account refresh failed: " << reason;
-    m_currentTask.reset();
-    m_nextTimer->start(1000 * 20);
+    m_refreshing.remove(accountId);
+    tryNext();
 }
 
 bool AccountList::isActive() const {
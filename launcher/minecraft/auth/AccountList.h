@@ -40,6 +40,8 @@
 #include <QObject>
 #include <QVariant>
 #include <QAbstractListModel>
+#include <QHash>
+#include <QJsonDocument>
 #include <QSharedPointer>
 
 /*!
@@ -101,7 +103,16 @@ public:
      */
     void setListFilePath(QString path, bool autosave = false);
 
+    /// What loadList() gets from the list file, reading it can be done ahead off the GUI thread.
+    struct ListFile {
+        bool opened = false;
+        QJsonDocument document;
+        QJsonParseError parseError{};
+    };
+    static ListFile readListFile(const QString &path);
+
     bool loadList();
+    bool loadList(const ListFile &file);
     bool loadV2(QJsonObject &root);
     bool loadV3(QJsonObject &root);
     bool saveList();
@@ -137,21 +148,26 @@ public slots:
     void accountActivityChanged(bool active);
 
     /**
-     * This is initially to run background account refresh tasks, or on a hourly timer
+     * This is initially to run background account refresh tasks, and then whenever an account is about to need one
      */
     void fillQueue();
 
 private slots:
     void tryNext();
 
-    void authSucceeded();
-    void authFailed(QString reason);
+private:
+    void scheduleRefresh();
+    void authSucceeded(QString accountId);
+    void authFailed(QString accountId, QString reason);
 
 protected:
+    // how many accounts get refreshed at the same time
+    static constexpr int maxConcurrentRefreshes = 4;
+
     QList<QString> m_refreshQueue;
     QTimer *m_refreshTimer;
-    QTimer *m_nextTimer;
-    shared_qobject_ptr<AccountTask> m_currentTask;
+    // internal ID -> refresh task
+    QHash<QString, shared_qobject_ptr<AccountTask>> m_refreshing;
 
     /*!
      * Called whenever the list changes.
@@ -47,6 +47,9 @@
 #include <QDebug>
 
 #include <QPainter>
+#include <QPointer>
+
+#include "SkinUtils.h"
 
 #include "flows/MSA.h"
 #include "flows/Mojang.h"
@@ -117,15 +120,12 @@ AccountState MinecraftAccount::accountState() const {
 }
 
 QPixmap MinecraftAccount::getFace() const {
-    QPixmap skinTexture;
-    if(!skinTexture.loadFromData(data.minecraftProfile.skin.data, "PNG")) {
-        return QPixmap();
-    }
-    QPixmap skin = QPixmap(8, 8);
-    QPainter painter(&skin);
-    painter.drawPixmap(0, 0, skinTexture.copy(8, 8, 8, 8));
-    painter.drawPixmap(0, 0, skinTexture.copy(40, 8, 8, 8));
-    return skin.scaled(64, 64, Qt::KeepAspectRatio);
+    // the signal is about the account, not a change to it, so it's fine to send it from here
+    QPointer<MinecraftAccount> self(const_cast<MinecraftAccount*>(this));
+    return SkinUtils::getFace(data.minecraftProfile.skin.data, 64, [self] {
+        if (self)
+            emit self->faceChanged();
+    });
 }
 
 
@@ -242,6 +242,11 @@ bool MinecraftAccount::isActive() const {
 }
 
 bool MinecraftAccount::shouldRefresh() const {
+    auto next = nextRefresh();
+    return next.isValid() && next <= QDateTime::currentDateTimeUtc();
+}
+
+QDateTime MinecraftAccount::nextRefresh() const {
     /*
      * Never refresh accounts that are being used by the game, it breaks the game session.
      * Always refresh accounts that have not been refreshed yet during this session.
@@ -249,30 +254,29 @@ bool MinecraftAccount::shouldRefresh() const {
      * Refresh accounts that would expire in the next 12 hours (fresh token validity is 24 hours).
      */
     if(isInUse()) {
-        return false;
+        return QDateTime();
     }
     switch(data.validity_) {
         case Katabasis::Validity::Certain: {
             break;
         }
         case Katabasis::Validity::None: {
-            return false;
+            return QDateTime();
         }
         case Katabasis::Validity::Assumed: {
-            return true;
+            return QDateTime::currentDateTimeUtc();
         }
     }
-    auto now = QDateTime::currentDateTimeUtc();
     auto issuedTimestamp = data.yggdrasilToken.issueInstant;
     auto expiresTimestamp = data.yggdrasilToken.notAfter;
 
     if(!expiresTimestamp.isValid()) {
         expiresTimestamp = issuedTimestamp.addSecs(24 * 3600);
     }
-    if (now.secsTo(expiresTimestamp) < (12 * 3600)) {
-        return true;
+    if(!expiresTimestamp.isValid()) {
+        return QDateTime::currentDateTimeUtc();
     }
-    return false;
+    return expiresTimestamp.addSecs(-12 * 3600);
 }
 
 void MinecraftAccount::fillSession(AuthSessionPtr session)
@@ -35,6 +35,7 @@
 
 #pragma once
 
+#include <QDateTime>
 #include <QObject>
 #include <QString>
 #include <QList>
@@ -187,6 +188,7 @@ public: /* queries */
         }
     }
 
+    /** The face of the skin, null while it's still being rendered. See faceChanged. */
     QPixmap getFace() const;
 
     //! Returns the current state of the account
@@ -197,6 +199,8 @@ public: /* queries */
     }
 
     bool shouldRefresh() const;
+    /** When the account will need to be refreshed. Invalid if it won't need one for now (broken or in use). */
+    QDateTime nextRefresh() const;
 
     void fillSession(AuthSessionPtr session);
 
@@ -212,6 +216,11 @@ signals:
 
     void activityChanged(bool active);
 
+    /**
+     * This signal is emitted when the face of the skin is there, after getFace() had to render it
+     */
+    void faceChanged();
+
     // TODO: better signalling for the various possible state changes - especially errors
 
 protected: /* variables */
@@ -176,7 +176,9 @@ bool parseMinecraftProfile(QByteArray & data, MinecraftProfile &output) {
         if(!getString(skinObj.value("variant"), skinOut.variant)) {
             continue;
         }
-        // we deal with only the active skin
+        // we deal with only the active skin, the texture is only got again when it's another one
+        if (skinOut.url == output.skin.url)
+            skinOut.data = output.skin.data;
         output.skin = skinOut;
         break;
     }
@@ -372,6 +374,9 @@ bool parseMinecraftProfileMojang(QByteArray & data, MinecraftProfile &output) {
         }
     }
 
+    // the texture is only got again when it's another one
+    if (skinOut.url == output.skin.url)
+        skinOut.data = output.skin.data;
     output.skin = skinOut;
     if (capeOut.alias == "cape") {
         output.capes = QMap<QString, Cape>({{capeOut.alias, capeOut}});
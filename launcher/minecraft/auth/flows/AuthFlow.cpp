@@ -22,28 +22,52 @@ void AuthFlow::succeed() {
 }
 
 void AuthFlow::executeTask() {
-    if(m_currentStep) {
+    if(!m_currentSteps.isEmpty()) {
         return;
     }
     changeState(AccountTaskState::STATE_WORKING, tr("Initializing"));
     nextStep();
 }
 
+void AuthFlow::addStep(AuthStep::Ptr step) {
+    m_steps.append(QList<AuthStep::Ptr>{ step });
+}
+
+void AuthFlow::addSteps(const QList<AuthStep::Ptr> &steps) {
+    m_steps.append(steps);
+}
+
 void AuthFlow::nextStep() {
     if(m_steps.size() == 0) {
         // we got to the end without an incident... assume this is all.
-        m_currentStep.reset();
+        m_currentSteps.clear();
         succeed();
         return;
     }
-    m_currentStep = m_steps.front();
-    qDebug() << "AuthFlow:" << m_currentStep->describe();
+    m_currentSteps = m_steps.front();
     m_steps.pop_front();
-    connect(m_currentStep.get(), &AuthStep::finished, this, &AuthFlow::stepFinished);
-    connect(m_currentStep.get(), &AuthStep::showVerificationUriAndCode, this, &AuthFlow::showVerificationUriAndCode);
-    connect(m_currentStep.get(), &AuthStep::hideVerificationUriAndCode, this, &AuthFlow::hideVerificationUriAndCode);
+    m_pendingSteps.clear();
+    m_stageSucceeded = false;
+    m_stageMessage.clear();
+    for(auto &step : m_currentSteps) {
+        m_pendingSteps.insert(step.get());
+        auto rawStep = step.get();
+        connect(rawStep, &AuthStep::finished, this, [this, rawStep](AccountTaskState resultingState, QString message) {
+            stepFinished(rawStep, resultingState, message);
+        });
+        connect(rawStep, &AuthStep::showVerificationUriAndCode, this, &AuthFlow::showVerificationUriAndCode);
+        connect(rawStep, &AuthStep::hideVerificationUriAndCode, this, &AuthFlow::hideVerificationUriAndCode);
+    }
 
-    m_currentStep->perform();
+    // steps may finish right away, with a failure ending the whole flow
+    auto steps = m_currentSteps;
+    for(auto &step : steps) {
+        if(!m_pendingSteps.contains(step.get())) {
+            break;
+        }
+        qDebug() << "AuthFlow:" << step->describe();
+        step->perform();
+    }
 }
 
 
@@ -51,12 +75,12 @@ QString AuthFlow::getStateMessage() const {
     switch (m_taskState)
     {
         case AccountTaskState::STATE_WORKING: {
-            if(m_currentStep) {
-                return m_currentStep->describe();
-            }
-            else {
-                return tr("Working...");
+            for(auto &step : m_currentSteps) {
+                if(m_pendingSteps.contains(step.get())) {
+                    return step->describe();
+                }
             }
+            return tr("Working...");
         }
         default: {
             return AccountTask::getStateMessage();
@@ -64,8 +88,32 @@ QString AuthFlow::getStateMessage() const {
     }
 }
 
-void AuthFlow::stepFinished(AccountTaskState resultingState, QString message) {
-    if(changeState(resultingState, message)) {
+void AuthFlow::stepFinished(AuthStep *step, AccountTaskState resultingState, QString message) {
+    if(!m_pendingSteps.remove(step)) {
+        // the stage it belonged to is over already
+        return;
+    }
+    switch(resultingState) {
+        case AccountTaskState::STATE_WORKING: {
+            break;
+        }
+        case AccountTaskState::STATE_SUCCEEDED: {
+            // there is nothing more to do, once the rest of the stage is done
+            m_stageSucceeded = true;
+            break;
+        }
+        default: {
+            // anything going wrong ends the flow, whatever the other steps of the stage do
+            m_pendingSteps.clear();
+            changeState(resultingState, message);
+            return;
+        }
+    }
+    m_stageMessage = message;
+    if(!m_pendingSteps.isEmpty()) {
+        return;
+    }
+    if(changeState(m_stageSucceeded ? AccountTaskState::STATE_SUCCEEDED : AccountTaskState::STATE_WORKING, m_stageMessage)) {
         nextStep();
     }
 }
@@ -33,13 +33,24 @@ signals:
     void activityChanged(Katabasis::Activity activity);
 
 private slots:
-    void stepFinished(AccountTaskState resultingState, QString message);
+    void stepFinished(AuthStep *step, AccountTaskState resultingState, QString message);
 
 protected:
     void succeed();
     void nextStep();
 
+    /** Adds a step, that starts once the ones added before it are done. */
+    void addStep(AuthStep::Ptr step);
+    /** Adds steps that don't depend on each other, so they run at the same time. */
+    void addSteps(const QList<AuthStep::Ptr> &steps);
+
 protected:
-    QList<AuthStep::Ptr> m_steps;
-    AuthStep::Ptr m_currentStep;
+    // steps of the same stage run at the same time
+    QList<QList<AuthStep::Ptr>> m_steps;
+    QList<AuthStep::Ptr> m_currentSteps;
+
+private:
+    QSet<AuthStep *> m_pendingSteps;
+    bool m_stageSucceeded = false;
+    QString m_stageMessage;
 };
@@ -10,28 +10,28 @@
 #include "minecraft/auth/steps/GetSkinStep.h"
 
 MSASilent::MSASilent(AccountData* data, QObject* parent) : AuthFlow(data, parent) {
-    m_steps.append(makeShared<MSAStep>(m_data, MSAStep::Action::Refresh));
-    m_steps.append(makeShared<XboxUserStep>(m_data));
-    m_steps.append(makeShared<XboxAuthorizationStep>(m_data, &m_data->xboxApiToken, "http://xboxlive.com", "Xbox"));
-    m_steps.append(makeShared<XboxAuthorizationStep>(m_data, &m_data->mojangservicesToken, "rp://api.minecraftservices.com/", "Mojang"));
-    m_steps.append(makeShared<LauncherLoginStep>(m_data));
-    m_steps.append(makeShared<XboxProfileStep>(m_data));
-    m_steps.append(makeShared<EntitlementsStep>(m_data));
-    m_steps.append(makeShared<MinecraftProfileStep>(m_data));
-    m_steps.append(makeShared<GetSkinStep>(m_data));
+    addStep(makeShared<MSAStep>(m_data, MSAStep::Action::Refresh));
+    addStep(makeShared<XboxUserStep>(m_data));
+    // both tokens only need the user token, and everything after needs one of them
+    addSteps({ makeShared<XboxAuthorizationStep>(m_data, &m_data->xboxApiToken, "http://xboxlive.com", "Xbox"),
+               makeShared<XboxAuthorizationStep>(m_data, &m_data->mojangservicesToken, "rp://api.minecraftservices.com/", "Mojang") });
+    addSteps({ makeShared<LauncherLoginStep>(m_data), makeShared<XboxProfileStep>(m_data) });
+    addSteps({ makeShared<EntitlementsStep>(m_data), makeShared<MinecraftProfileStep>(m_data) });
+    // the skin is found in the profile
+    addStep(makeShared<GetSkinStep>(m_data));
 }
 
 MSAInteractive::MSAInteractive(
     AccountData* data,
     QObject* parent
 ) : AuthFlow(data, parent) {
-    m_steps.append(makeShared<MSAStep>(m_data, MSAStep::Action::Login));
-    m_steps.append(makeShared<XboxUserStep>(m_data));
-    m_steps.append(makeShared<XboxAuthorizationStep>(m_data, &m_data->xboxApiToken, "http://xboxlive.com", "Xbox"));
-    m_steps.append(makeShared<XboxAuthorizationStep>(m_data, &m_data->mojangservicesToken, "rp://api.minecraftservices.com/", "Mojang"));
-    m_steps.append(makeShared<LauncherLoginStep>(m_data));
-    m_steps.append(makeShared<XboxProfileStep>(m_data));
-    m_steps.append(makeShared<EntitlementsStep>(m_data));
-    m_steps.append(makeShared<MinecraftProfileStep>(m_data));
-    m_steps.append(makeShared<GetSkinStep>(m_data));
+    addStep(makeShared<MSAStep>(m_data, MSAStep::Action::Login));
+    addStep(makeShared<XboxUserStep>(m_data));
+    // both tokens only need the user token, and everything after needs one of them
+    addSteps({ makeShared<XboxAuthorizationStep>(m_data, &m_data->xboxApiToken, "http://xboxlive.com", "Xbox"),
+               makeShared<XboxAuthorizationStep>(m_data, &m_data->mojangservicesToken, "rp://api.minecraftservices.com/", "Mojang") });
+    addSteps({ makeShared<LauncherLoginStep>(m_data), makeShared<XboxProfileStep>(m_data) });
+    addSteps({ makeShared<EntitlementsStep>(m_data), makeShared<MinecraftProfileStep>(m_data) });
+    // the skin is found in the profile
+    addStep(makeShared<GetSkinStep>(m_data));
 }
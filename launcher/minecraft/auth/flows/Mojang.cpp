@@ -9,10 +9,10 @@ MojangRefresh::MojangRefresh(
     AccountData *data,
     QObject *parent
 ) : AuthFlow(data, parent) {
-    m_steps.append(makeShared<YggdrasilStep>(m_data, QString()));
-    m_steps.append(makeShared<MinecraftProfileStepMojang>(m_data));
-    m_steps.append(makeShared<MigrationEligibilityStep>(m_data));
-    m_steps.append(makeShared<GetSkinStep>(m_data));
+    addStep(makeShared<YggdrasilStep>(m_data, QString()));
+    addStep(makeShared<MinecraftProfileStepMojang>(m_data));
+    addStep(makeShared<MigrationEligibilityStep>(m_data));
+    addStep(makeShared<GetSkinStep>(m_data));
 }
 
 MojangLogin::MojangLogin(
@@ -20,8 +20,8 @@ MojangLogin::MojangLogin(
     QString password,
     QObject *parent
 ): AuthFlow(data, parent), m_password(password) {
-    m_steps.append(makeShared<YggdrasilStep>(m_data, m_password));
-    m_steps.append(makeShared<MinecraftProfileStepMojang>(m_data));
-    m_steps.append(makeShared<MigrationEligibilityStep>(m_data));
-    m_steps.append(makeShared<GetSkinStep>(m_data));
+    addStep(makeShared<YggdrasilStep>(m_data, m_password));
+    addStep(makeShared<MinecraftProfileStepMojang>(m_data));
+    addStep(makeShared<MigrationEligibilityStep>(m_data));
+    addStep(makeShared<GetSkinStep>(m_data));
 }
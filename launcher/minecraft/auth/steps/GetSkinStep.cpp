@@ -17,6 +17,12 @@ QString GetSkinStep::describe() {
 }
 
 void GetSkinStep::perform() {
+    // the texture hash is part of the url, so a skin we have already is still the same one
+    if (!m_data->minecraftProfile.skin.data.isEmpty()) {
+        emit finished(AccountTaskState::STATE_SUCCEEDED, tr("Got skin"));
+        return;
+    }
+
     auto url = QUrl(m_data->minecraftProfile.skin.url);
     QNetworkRequest request = QNetworkRequest(url);
     AuthRequest *requestor = new AuthRequest(this);
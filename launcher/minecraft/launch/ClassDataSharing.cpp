@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ClassDataSharing.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+
+#include "FileSystem.h"
+#include "java/JavaVersion.h"
+#include "minecraft/MinecraftInstance.h"
+#include "settings/SettingsObject.h"
+
+namespace ClassDataSharing {
+
+namespace {
+// the first version with -XX:ArchiveClassesAtExit
+constexpr int s_min_java = 13;
+
+void addFile(QCryptographicHash& hash, const QFileInfo& info)
+{
+    hash.addData((info.absoluteFilePath() + '\n' + QString::number(info.size()) + '\n' +
+                  QString::number(info.lastModified().toMSecsSinceEpoch()) + '\n')
+                     .toUtf8());
+}
+
+void addFolder(QCryptographicHash& hash, const QString& path)
+{
+    QDir dir(path);
+    for (auto& info : dir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name))
+        addFile(hash, info);
+}
+}  // namespace
+
+Archive archiveFor(MinecraftInstance* instance, const QStringList& classPath)
+{
+    auto settings = instance->settings();
+    if (!settings->get("UseClassDataSharing").toBool())
+        return {};
+
+    auto java_version = settings->get("JavaVersion").toString();
+    if (JavaVersion(java_version).major() < s_min_java)
+        return {};
+
+    // the user's own archive settings win
+    auto jvm_args = settings->get("JvmArgs").toString();
+    if (jvm_args.contains("-Xshare") || jvm_args.contains("SharedArchiveFile") || jvm_args.contains("ArchiveClassesAtExit"))
+        return {};
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData((java_version + '\n' + settings->get("JavaPath").toString() + '\n').toUtf8());
+    for (auto& entry : classPath)
+        addFile(hash, QFileInfo(entry));
+    addFolder(hash, instance->modsRoot());
+    addFolder(hash, instance->coreModsDir());
+
+    QDir dir("cache/cds");
+    auto prefix = instance->id() + '-';
+    auto name = prefix + QString::fromLatin1(hash.result().toHex()) + ".jsa";
+
+    // only the archive of the instance as it is now is of any use
+    for (auto& old : dir.entryList({ prefix + "*.jsa" }, QDir::Files)) {
+        if (old != name)
+            dir.remove(old);
+    }
+
+    if (!FS::ensureFolderPathExists(dir.absolutePath()))
+        return {};
+
+    Archive archive;
+    archive.path = dir.absoluteFilePath(name);
+    archive.create = !QFileInfo::exists(archive.path);
+    return archive;
+}
+
+QStringList arguments(const Archive& archive)
+{
+    if (archive.path.isEmpty())
+        return {};
+    if (archive.create)
+        return { "-XX:ArchiveClassesAtExit=" + archive.path };
+    return { "-XX:SharedArchiveFile=" + archive.path, "-Xshare:auto" };
+}
+
+void launchFinished(const Archive& archive, bool succeeded)
+{
+    if (archive.create && !succeeded && QFile::remove(archive.path))
+        qDebug() << "Removed the class data sharing archive of a failed launch:" << archive.path;
+}
+
+}  // namespace ClassDataSharing
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+class MinecraftInstance;
+
+/* Class data sharing archives for the launches of an instance.
+ *
+ * The first launch with the setting on has the JVM write the classes it loaded to an archive when it exits,
+ * the launches after that map the archive instead of loading and verifying all those classes again. The
+ * archive goes with the Java version, the class path and the mods of the instance (with the sizes and
+ * modification times of their files), so changing any of them makes a new one and the old one is removed.
+ *
+ * Only Java 13 and newer can write archives like this, older ones launch the same way as before.
+ */
+namespace ClassDataSharing {
+
+struct Archive {
+    // empty when the archive isn't used for this launch
+    QString path;
+    // whether this launch writes the archive
+    bool create = false;
+};
+
+/** The archive for launching `instance` with `classPath`. */
+Archive archiveFor(MinecraftInstance* instance, const QStringList& classPath);
+
+/** What to give the JVM for the archive. */
+QStringList arguments(const Archive& archive);
+
+/** Drops an archive written by a launch that didn't end well, it may only have part of the classes. */
+void launchFinished(const Archive& archive, bool succeeded);
+
+}  // namespace ClassDataSharing
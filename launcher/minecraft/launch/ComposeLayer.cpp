@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ComposeLayer.h"
+
+#include <QtConcurrent>
+
+#include "Application.h"
+#include "Executors.h"
+#include "InstanceList.h"
+#include "launch/LaunchTask.h"
+
+void ComposeLayer::executeTask()
+{
+    auto instance = m_parent->instance();
+    auto base = APPLICATION->instances()->getInstanceById(instance->layeredOn());
+    if (!base) {
+        emit logLine(tr("The base instance of this one is gone, it's launched with the files it has."), MessageLevel::Warning);
+        emitSucceeded();
+        return;
+    }
+
+    emit logLine(tr("Placing the files of %1...").arg(base->name()), MessageLevel::Launcher);
+    InstanceLayer layer({ instance->instanceRoot(), instance->gameRoot(), base->instanceRoot(), base->gameRoot() });
+    connect(&m_watcher, &QFutureWatcher<InstanceLayer::Result>::finished, this, &ComposeLayer::composed);
+    m_watcher.setFuture(QtConcurrent::run(Executors::io(), [layer] { return layer.compose(); }));
+}
+
+void ComposeLayer::composed()
+{
+    auto result = m_watcher.result();
+    if (!result.error.isEmpty()) {
+        emitFailed(tr("Couldn't place the files of the base instance: %1").arg(result.error));
+        return;
+    }
+    if (result.placed || result.removed || result.overridden) {
+        emit logLine(tr("Placed %1 file(s) of the base instance, removed %2 it doesn't have anymore, %3 overridden by this one.")
+                         .arg(result.placed)
+                         .arg(result.removed)
+                         .arg(result.overridden),
+                     MessageLevel::Launcher);
+    }
+    emitSucceeded();
+}
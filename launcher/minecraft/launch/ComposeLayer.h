@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <launch/LaunchStep.h>
+
+#include <QFutureWatcher>
+
+#include "minecraft/InstanceLayer.h"
+
+/* Places the files of the base instance of a layered instance in it before the launch, see InstanceLayer. Without its
+ * base, the instance is launched with the files it has. */
+class ComposeLayer : public LaunchStep {
+    Q_OBJECT
+   public:
+    explicit ComposeLayer(LaunchTask* parent) : LaunchStep(parent) {}
+    ~ComposeLayer() override = default;
+
+    void executeTask() override;
+    bool canAbort() const override { return false; }
+
+   private:
+    void composed();
+
+   private:
+    QFutureWatcher<InstanceLayer::Result> m_watcher;
+};
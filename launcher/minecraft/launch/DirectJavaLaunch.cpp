@@ -18,10 +18,13 @@
 
 #include <launch/LaunchTask.h>
 #include <minecraft/MinecraftInstance.h>
+#include <minecraft/mod/ModFolderModel.h>
 #include <FileSystem.h>
 #include <Commandline.h>
 
 #include "Application.h"
+#include "ClassDataSharing.h"
+#include "ProcessControls.h"
 
 #ifdef Q_OS_LINUX
 #include "gamemode_client.h"
@@ -38,10 +41,20 @@ void DirectJavaLaunch::executeTask()
     auto instance = m_parent->instance();
     std::shared_ptr<MinecraftInstance> minecraftInstance = std::dynamic_pointer_cast<MinecraftInstance>(instance);
     QStringList args = minecraftInstance->javaArguments();
+    args.append(m_parent->extraJavaArguments());
+
+    auto& record = m_parent->record();
+    record.javaVersion = instance->settings()->get("JavaVersion").toString();
+    record.javaArguments = args;
+    auto mods = minecraftInstance->loaderModList()->allMods();
+    record.mods = std::count_if(mods.begin(), mods.end(), [](Mod* mod) { return mod->enabled(); });
 
     args.append("-Djava.library.path=" + minecraftInstance->getNativePath());
 
     auto classPathEntries = minecraftInstance->getClassPath();
+    m_cdsArchive = ClassDataSharing::archiveFor(minecraftInstance.get(), classPathEntries);
+    args.append(ClassDataSharing::arguments(m_cdsArchive));
+
     args.append("-cp");
     QString classpath;
 #ifdef Q_OS_WIN32
@@ -65,6 +78,7 @@ void DirectJavaLaunch::executeTask()
     auto mcArgs = minecraftInstance->processMinecraftArgs(m_session, m_serverToJoin);
     args.append(mcArgs);
 
+    QString program = javaPath;
     QString wrapperCommandStr = instance->getWrapperCommand().trimmed();
     if(!wrapperCommandStr.isEmpty())
     {
@@ -80,11 +94,19 @@ void DirectJavaLaunch::executeTask()
         }
         emit logLine("Wrapper command is:\n" + wrapperCommandStr + "\n\n", MessageLevel::Launcher);
         args.prepend(javaPath);
-        m_process.start(wrapperCommand, wrapperArgs + args);
+        args = wrapperArgs + args;
+        program = wrapperCommand;
+    }
+
+    auto controls = ProcessControls::fromSettings(*instance->settings());
+    for (auto& problem : ProcessControls::wrap(controls, program, args))
+    {
+        emit logLine(problem + "\n", MessageLevel::Warning);
     }
-    else
+    m_process.start(program, args);
+    for (auto& problem : ProcessControls::apply(controls, m_process.processId()))
     {
-        m_process.start(javaPath, args);
+        emit logLine(problem + "\n", MessageLevel::Warning);
     }
 
 #ifdef Q_OS_LINUX
@@ -115,6 +137,7 @@ void DirectJavaLaunch::on_state(LoggedProcess::State state)
         case LoggedProcess::Crashed:
         {
             m_parent->setPid(-1);
+            ClassDataSharing::launchFinished(m_cdsArchive, false);
             emitFailed(tr("Game crashed."));
             return;
         }
@@ -123,6 +146,8 @@ void DirectJavaLaunch::on_state(LoggedProcess::State state)
             m_parent->setPid(-1);
             // if the exit code wasn't 0, report this as a crash
             auto exitCode = m_process.exitCode();
+            m_parent->record().exitCode = exitCode;
+            ClassDataSharing::launchFinished(m_cdsArchive, exitCode == 0);
             if(exitCode != 0)
             {
                 emitFailed(tr("Game crashed."));
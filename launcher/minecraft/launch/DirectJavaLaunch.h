@@ -19,6 +19,7 @@
 #include <LoggedProcess.h>
 #include <minecraft/auth/AuthSession.h>
 
+#include "ClassDataSharing.h"
 #include "MinecraftServerTarget.h"
 
 class DirectJavaLaunch: public LaunchStep
@@ -54,5 +55,6 @@ private:
     QString m_command;
     AuthSessionPtr m_session;
     MinecraftServerTargetPtr m_serverToJoin;
+    ClassDataSharing::Archive m_cdsArchive;
 };
 
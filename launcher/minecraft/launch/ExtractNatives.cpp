@@ -17,11 +17,14 @@
 #include <minecraft/MinecraftInstance.h>
 #include <launch/LaunchTask.h>
 
-#include <quazip/quazip.h>
-#include <quazip/quazipdir.h>
 #include "MMCZip.h"
 #include "FileSystem.h"
+#include "modplatform/helpers/HashUtils.h"
+#include <QCryptographicHash>
 #include <QDir>
+#include <QDirIterator>
+#include <QTemporaryDir>
+#include <QtConcurrent>
 
 #ifdef major
     #undef major
@@ -42,20 +45,16 @@ static QString replaceSuffix (QString target, const QString &suffix, const QStri
 
 static bool unzipNatives(QString source, QString targetFolder, bool applyJnilibHack, bool nativeOpenAL, bool nativeGLFW)
 {
-    QuaZip zip(source);
-    if(!zip.open(QuaZip::mdUnzip))
+    MMCZip::ArchiveReader zip(source);
+    if(!zip.open())
     {
         return false;
     }
     QDir directory(targetFolder);
-    if (!zip.goToFirstFile())
+    QList<QPair<const MMCZip::ArchiveReader::Entry*, QString>> entries;
+    for (auto& entry : zip.entries())
     {
-        return false;
-    }
-    do
-    {
-        QString name = zip.getCurrentFileName();
-        auto lowercase = name.toLower();
+        QString name = entry.name;
         if (nativeGLFW && name.contains("glfw")) {
             continue;
         }
@@ -66,24 +65,121 @@ static bool unzipNatives(QString source, QString targetFolder, bool applyJnilibH
         {
             name = replaceSuffix(name, ".jnilib", ".dylib");
         }
-        QString absFilePath = directory.absoluteFilePath(name);
-        if (!JlCompress::extractFile(&zip, "", absFilePath))
+        entries.append({ &entry, directory.absoluteFilePath(name) });
+    }
+    return MMCZip::extractEntries(zip, entries);
+}
+
+// Moves everything in 'source' into 'target', replacing what's already there
+static bool mergeInto(const QString& source, const QString& target)
+{
+    QDir sourceDir(source);
+    QDirIterator it(source, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        auto path = it.next();
+        auto destination = FS::PathCombine(target, sourceDir.relativeFilePath(path));
+        if (!FS::ensureFilePathExists(destination))
+        {
+            return false;
+        }
+        QFile::remove(destination);
+        if (!QFile::rename(path, destination))
         {
             return false;
         }
-    } while (zip.goToNextFile());
-    zip.close();
-    if(zip.getZipError()!=0)
-    {
-        return false;
     }
     return true;
 }
 
+/* Finds the folder of the natives cache holding these jars, extracted with these options, populating it if needed.
+ *
+ * Cached folders are never modified once they're in place, so any number of instances can use them at the same time.
+ * They're identified by the hashes of the jars (which are cached too, so they're not read again on every launch)
+ * along with the options, since those change what gets extracted.
+ */
+ExtractNatives::Result ExtractNatives::prepareNatives(const QStringList& jars, bool jniHackEnabled, bool nativeOpenAL, bool nativeGLFW)
+{
+    QStringList keyParts{ QString("jnilib=%1 openal=%2 glfw=%3").arg(jniHackEnabled).arg(nativeOpenAL).arg(nativeGLFW) };
+    for (const auto& jar : jars)
+    {
+        auto hashes = Hashing::hashFile(jar);
+        if (!hashes.isValid())
+        {
+            return { {}, jar };
+        }
+        keyParts.append(hashes.sha1);
+    }
+    auto key = QString(QCryptographicHash::hash(keyParts.join('\n').toUtf8(), QCryptographicHash::Sha1).toHex());
+
+    QDir cache(QDir("cache/natives").absolutePath());
+    auto target = cache.absoluteFilePath(key);
+    if (QFileInfo(target).isDir())
+    {
+        return { target, {} };
+    }
+
+    // Populate a staging folder, and only move it into the cache once it's complete
+    if (!FS::ensureFolderPathExists(cache.absolutePath()))
+    {
+        return { {}, jars.first() };
+    }
+    QTemporaryDir staging(cache.absoluteFilePath(key + ".XXXXXX"));
+    if (!staging.isValid())
+    {
+        return { {}, jars.first() };
+    }
+
+    // The jars are extracted at the same time, each one in its own folder, and then merged in order so that
+    // the same files win as when extracting them one after the other
+    QList<QFuture<bool>> extractions;
+    for (int i = 0; i < jars.size(); i++)
+    {
+        auto folder = staging.filePath(QString::number(i));
+        auto jar = jars.at(i);
+        extractions.append(QtConcurrent::run(QThreadPool::globalInstance(), [jar, folder, jniHackEnabled, nativeOpenAL, nativeGLFW] {
+            return unzipNatives(jar, folder, jniHackEnabled, nativeOpenAL, nativeGLFW);
+        }));
+    }
+
+    auto merged = staging.filePath("natives");
+    QString failed;
+    for (int i = 0; i < jars.size(); i++)
+    {
+        // wait for all of them, even after a failure, so none is left writing into the staging folder
+        if (!extractions[i].result() && failed.isEmpty())
+        {
+            failed = jars.at(i);
+        }
+    }
+    if (failed.isEmpty() && FS::ensureFolderPathExists(merged))
+    {
+        for (int i = 0; i < jars.size() && failed.isEmpty(); i++)
+        {
+            if (!mergeInto(staging.filePath(QString::number(i)), merged))
+            {
+                failed = jars.at(i);
+            }
+        }
+    }
+    if (!failed.isEmpty())
+    {
+        return { {}, failed };
+    }
+
+    // Another launch may have got there first, which is fine as it's the same contents
+    if (!QDir().rename(merged, target) && !QFileInfo(target).isDir())
+    {
+        return { {}, jars.first() };
+    }
+    return { target, {} };
+}
+
 void ExtractNatives::executeTask()
 {
     auto instance = m_parent->instance();
     std::shared_ptr<MinecraftInstance> minecraftInstance = std::dynamic_pointer_cast<MinecraftInstance>(instance);
+    minecraftInstance->setNativePath({});
     auto toExtract = minecraftInstance->getNativeJars();
     if(toExtract.isEmpty())
     {
@@ -94,24 +190,30 @@ void ExtractNatives::executeTask()
     bool nativeOpenAL = settings->get("UseNativeOpenAL").toBool();
     bool nativeGLFW = settings->get("UseNativeGLFW").toBool();
 
-    auto outputPath  = minecraftInstance->getNativePath();
     auto javaVersion = minecraftInstance->getJavaVersion();
     bool jniHackEnabled = javaVersion.major() >= 8;
-    for(const auto &source: toExtract)
-    {
-        if(!unzipNatives(source, outputPath, jniHackEnabled, nativeOpenAL, nativeGLFW))
+
+    connect(&m_watcher, &QFutureWatcher<Result>::finished, this, [this, minecraftInstance] {
+        auto result = m_watcher.result();
+        if(result.path.isEmpty())
         {
-            const char *reason = QT_TR_NOOP("Couldn't extract native jar '%1' to destination '%2'");
-            emit logLine(QString(reason).arg(source, outputPath), MessageLevel::Fatal);
-            emitFailed(tr(reason).arg(source, outputPath));
+            const char *reason = QT_TR_NOOP("Couldn't extract native jar '%1' to the natives cache");
+            emit logLine(QString(reason).arg(result.failedJar), MessageLevel::Fatal);
+            emitFailed(tr(reason).arg(result.failedJar));
+            return;
         }
-    }
-    emitSucceeded();
+        minecraftInstance->setNativePath(result.path);
+        emitSucceeded();
+    });
+    m_watcher.setFuture(QtConcurrent::run(QThreadPool::globalInstance(), &ExtractNatives::prepareNatives, toExtract, jniHackEnabled,
+                                          nativeOpenAL, nativeGLFW));
 }
 
 void ExtractNatives::finalize()
 {
     auto instance = m_parent->instance();
+    std::dynamic_pointer_cast<MinecraftInstance>(instance)->setNativePath({});
+    // natives used to be extracted into the instance, before there was a cache for them
     QString target_dir = FS::PathCombine(instance->instanceRoot(), "natives/");
     QDir dir(target_dir);
     dir.removeRecursively();
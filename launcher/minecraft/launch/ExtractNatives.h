@@ -16,6 +16,7 @@
 #pragma once
 
 #include <launch/LaunchStep.h>
+#include <QFutureWatcher>
 #include <memory>
 #include "minecraft/auth/AuthSession.h"
 
@@ -33,6 +34,17 @@ public:
         return false;
     }
     void finalize() override;
+
+private:
+    struct Result
+    {
+        // the folder of the natives cache to use, empty on failure
+        QString path;
+        QString failedJar;
+    };
+    static Result prepareNatives(const QStringList& jars, bool jniHackEnabled, bool nativeOpenAL, bool nativeGLFW);
+
+    QFutureWatcher<Result> m_watcher;
 };
 
 
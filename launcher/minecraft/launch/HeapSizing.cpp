@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "HeapSizing.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+
+#include <sys.h>
+
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/mod/ModFolderModel.h"
+#include "settings/SettingsObject.h"
+
+namespace HeapSizing {
+
+namespace {
+// all in MiB
+// what vanilla gets along with, and the least any instance gets
+constexpr int s_base = 1024;
+// registries, classes and mixins of a mod, before looking at how big it is
+constexpr int s_per_mod = 8;
+// mods and packs are compressed, and textures take more space as images than as files
+constexpr int s_size_factor = 2;
+// left to the system, or a quarter of the memory when that's more
+constexpr int s_system_reserve = 2048;
+// on top of what is free already, the launch itself takes some
+constexpr int s_available_reserve = 512;
+// above this the JVM can't use compressed pointers, and a bigger heap holds less
+constexpr int s_max_heap = 31744;
+constexpr int s_step = 256;
+
+int roundUp(int value, int step)
+{
+    return (value + step - 1) / step * step;
+}
+
+int mebibytes(qint64 bytes)
+{
+    return static_cast<int>((bytes + Sys::mebibyte - 1) / Sys::mebibyte);
+}
+}  // namespace
+
+Bounds compute(const Inputs& inputs)
+{
+    if (inputs.physicalMemory <= 0)
+        return {};
+
+    Bounds bounds;
+    int wanted;
+    if (inputs.peak > 0) {
+        // the collectors need room above what stays alive, or they hardly do anything else
+        wanted = inputs.peak * 3 / 2;
+        bounds.reason = QString("1.5 times the measured peak of %1 MiB").arg(inputs.peak);
+    } else {
+        wanted = s_base + inputs.mods * s_per_mod + (inputs.modsSize + inputs.resourcePacksSize) * s_size_factor;
+        bounds.reason = QString("estimated for %1 mods (%2 MiB) and %3 resource packs (%4 MiB)")
+                            .arg(inputs.mods)
+                            .arg(inputs.modsSize)
+                            .arg(inputs.resourcePacks)
+                            .arg(inputs.resourcePacksSize);
+    }
+    wanted = roundUp(qMax(wanted, s_base), s_step);
+
+    int ceiling = qMin(inputs.physicalMemory - qMax(s_system_reserve, inputs.physicalMemory / 4), s_max_heap);
+    QString limit = "the system memory";
+    if (inputs.availableMemory > 0 && inputs.availableMemory - s_available_reserve < ceiling) {
+        ceiling = inputs.availableMemory - s_available_reserve;
+        limit = "the free memory";
+    }
+    // a heap that is too small for the game doesn't help anyone either
+    ceiling = qMax(ceiling / s_step * s_step, qMin(s_base, inputs.physicalMemory / 2));
+    if (wanted > ceiling) {
+        wanted = ceiling;
+        bounds.reason += ", limited by " + limit;
+    }
+
+    bounds.max = wanted;
+    bounds.min = qMin(bounds.max, qMax(512, bounds.max / 4 / 128 * 128));
+    return bounds;
+}
+
+Bounds boundsFor(MinecraftInstance* instance)
+{
+    Inputs inputs;
+    inputs.physicalMemory = mebibytes(Sys::getSystemRam());
+    inputs.availableMemory = mebibytes(Sys::getAvailableRam());
+    inputs.peak = instance->settings()->get("HeapPeak").toInt();
+
+    qint64 mods_size = 0;
+    for (auto mod : instance->loaderModList()->allMods()) {
+        if (!mod->enabled())
+            continue;
+        inputs.mods++;
+        // the size of a folder says nothing
+        if (mod->fileinfo().isFile())
+            mods_size += mod->fileinfo().size();
+    }
+    inputs.modsSize = mebibytes(mods_size);
+
+    qint64 packs_size = 0;
+    QDir packs(instance->resourcePacksDir());
+    for (auto& info : packs.entryInfoList({ "*.zip" }, QDir::Files)) {
+        inputs.resourcePacks++;
+        packs_size += info.size();
+    }
+    inputs.resourcePacksSize = mebibytes(packs_size);
+
+    return compute(inputs);
+}
+
+bool parsePeakLine(const QString& line, int& peak)
+{
+    // the level prefix is still there in what comes straight from the process
+    static const QRegularExpression s_line("^(?:!!\\[Launcher\\]!)?Heap peak: (\\d+) MiB\\s*$");
+    auto match = s_line.match(line);
+    if (!match.hasMatch())
+        return false;
+
+    bool ok;
+    peak = match.captured(1).toInt(&ok);
+    return ok && peak > 0;
+}
+
+void recordPeak(MinecraftInstance* instance, int peak)
+{
+    auto settings = instance->settings();
+    auto stored = settings->get("HeapPeak").toInt();
+    // more than ever was used counts right away, less only pulls the size down a quarter of the way
+    settings->set("HeapPeak", peak >= stored ? peak : (stored * 3 + peak) / 4);
+}
+
+}  // namespace HeapSizing
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QString>
+
+class MinecraftInstance;
+
+/* The heap of instances that have their memory sized automatically.
+ *
+ * Until a launch tells how much heap the game really used, the size is estimated from the mods and resource packs of the
+ * instance. Once it did, the heap is made big enough for the most the game used, and a launch that needed less brings
+ * the size down slowly, so a single short session doesn't shrink it right away. Either way the heap stays clear of the
+ * memory the system needs for itself and of what's taken by other programs at the time of the launch.
+ */
+namespace HeapSizing {
+
+struct Inputs {
+    // in MiB, 0 when not known
+    int physicalMemory = 0;
+    int availableMemory = 0;
+    int mods = 0;
+    int modsSize = 0;
+    int resourcePacks = 0;
+    int resourcePacksSize = 0;
+    // the most heap earlier launches used, 0 when none told yet
+    int peak = 0;
+};
+
+struct Bounds {
+    // in MiB, 0 when the heap can't be sized and the settings are used instead
+    int min = 0;
+    int max = 0;
+    // how the size was come up with, for the launch log
+    QString reason;
+};
+
+/** The heap for a launch with `inputs`. */
+Bounds compute(const Inputs& inputs);
+
+/** The heap for launching `instance` now. */
+Bounds boundsFor(MinecraftInstance* instance);
+
+/** Whether `line` of the game's output reports the peak of the heap, which is put in `peak`. */
+bool parsePeakLine(const QString& line, int& peak);
+
+/** Takes the peak a launch of `instance` reported into account for the next launches. */
+void recordPeak(MinecraftInstance* instance, int peak);
+
+}  // namespace HeapSizing
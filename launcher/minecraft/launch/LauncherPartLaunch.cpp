@@ -36,25 +36,35 @@
 #include "LauncherPartLaunch.h"
 
 #include <QStandardPaths>
+#include <QTimer>
 #include <QRegularExpression>
 
 #include "launch/LaunchTask.h"
 #include "minecraft/MinecraftInstance.h"
+#include "minecraft/mod/ModFolderModel.h"
 #include "FileSystem.h"
 #include "Commandline.h"
 #include "Application.h"
+#include "ClassDataSharing.h"
+#include "HeapSizing.h"
+#include "ProcessControls.h"
 
 #ifdef Q_OS_LINUX
 #include "gamemode_client.h"
 #endif
 
-LauncherPartLaunch::LauncherPartLaunch(LaunchTask *parent) : LaunchStep(parent)
+LauncherPartLaunch::LauncherPartLaunch(LaunchTask *parent) : LaunchStep(parent), m_process(new LoggedProcess())
 {
-    auto instance = parent->instance();
+    connectProcess();
+}
+
+void LauncherPartLaunch::connectProcess()
+{
+    auto instance = m_parent->instance();
     if (instance->settings()->get("CloseAfterLaunch").toBool())
     {
         std::shared_ptr<QMetaObject::Connection> connection{new QMetaObject::Connection};
-        *connection = connect(&m_process, &LoggedProcess::log, this, [=](QStringList lines, MessageLevel::Enum level) {
+        *connection = connect(m_process.get(), &LoggedProcess::log, this, [=](QStringList lines, MessageLevel::Enum level) {
             qDebug() << lines;
             if (lines.filter(QRegularExpression(".*Setting user.+", QRegularExpression::CaseInsensitiveOption)).length() != 0)
             {
@@ -64,8 +74,20 @@ LauncherPartLaunch::LauncherPartLaunch(LaunchTask *parent) : LaunchStep(parent)
         });
     }
 
-    connect(&m_process, &LoggedProcess::log, this, &LauncherPartLaunch::logLines);
-    connect(&m_process, &LoggedProcess::stateChanged, this, &LauncherPartLaunch::on_state);
+    if (instance->settings()->get("AutoMemory").toBool())
+    {
+        connect(m_process.get(), &LoggedProcess::log, this, [this](QStringList lines, MessageLevel::Enum) {
+            int peak;
+            for (auto& line : lines)
+            {
+                if (HeapSizing::parsePeakLine(line, peak))
+                    HeapSizing::recordPeak(std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance()).get(), peak);
+            }
+        });
+    }
+
+    connect(m_process.get(), &LoggedProcess::log, this, &LauncherPartLaunch::logLines);
+    connect(m_process.get(), &LoggedProcess::stateChanged, this, &LauncherPartLaunch::on_state);
 }
 
 #ifdef Q_OS_WIN
@@ -110,19 +132,33 @@ void LauncherPartLaunch::executeTask()
 
     m_launchScript = minecraftInstance->createLaunchScript(m_session, m_serverToJoin);
     QStringList args = minecraftInstance->javaArguments();
+    args.append(m_parent->extraJavaArguments());
+
+    auto& record = m_parent->record();
+    record.javaVersion = instance->settings()->get("JavaVersion").toString();
+    record.javaArguments = args;
+    auto mods = minecraftInstance->loaderModList()->allMods();
+    record.mods = std::count_if(mods.begin(), mods.end(), [](Mod* mod) { return mod->enabled(); });
+
     QString allArgs = args.join(", ");
     emit logLine("Java Arguments:\n[" + m_parent->censorPrivateInfo(allArgs) + "]\n\n", MessageLevel::Launcher);
 
     auto javaPath = FS::ResolveExecutable(instance->settings()->get("JavaPath").toString());
 
-    m_process.setProcessEnvironment(instance->createLaunchEnvironment());
-
-    // make detachable - this will keep the process running even if the object is destroyed
-    m_process.setDetachable(true);
+    m_command.environment = instance->createLaunchEnvironment();
+    m_command.workingDirectory = m_process->workingDirectory();
 
     auto classPath = minecraftInstance->getClassPath();
     classPath.prepend(jarPath);
 
+    m_cdsArchive = ClassDataSharing::archiveFor(minecraftInstance.get(), classPath);
+    if (!m_cdsArchive.path.isEmpty())
+    {
+        emit logLine((m_cdsArchive.create ? "Writing the class data sharing archive:\n" : "Using the class data sharing archive:\n")
+                         + m_cdsArchive.path + "\n\n", MessageLevel::Launcher);
+        args << ClassDataSharing::arguments(m_cdsArchive);
+    }
+
     auto natPath = minecraftInstance->getNativePath();
 #ifdef Q_OS_WIN
     if (!fitsInLocal8bit(natPath))
@@ -174,17 +210,39 @@ void LauncherPartLaunch::executeTask()
         }
         emit logLine("Wrapper command is:\n" + wrapperCommandStr + "\n\n", MessageLevel::Launcher);
         args.prepend(javaPath);
-        m_process.start(wrapperCommand, wrapperArgs + args);
+        m_command.program = wrapperCommand;
+        m_command.arguments = wrapperArgs + args;
     }
     else
     {
-        m_process.start(javaPath, args);
+        m_command.program = javaPath;
+        m_command.arguments = args;
+    }
+
+    auto controls = ProcessControls::fromSettings(*instance->settings());
+    for (auto& problem : ProcessControls::wrap(controls, m_command.program, m_command.arguments))
+    {
+        emit logLine(problem + "\n", MessageLevel::Warning);
+    }
+
+    // a launch that writes the class data sharing archive is followed by one that uses it, with other arguments
+    m_keepSpare = instance->settings()->get("KeepSpareJava").toBool() && !m_cdsArchive.create;
+    if (!adoptSpare())
+    {
+        m_process->setProcessEnvironment(m_command.environment);
+        m_process->start(m_command.program, m_command.arguments);
+    }
+    // make detachable - this will keep the process running even if the object is destroyed
+    m_process->setDetachable(true);
+    for (auto& problem : ProcessControls::apply(controls, m_process->processId()))
+    {
+        emit logLine(problem + "\n", MessageLevel::Warning);
     }
 
 #ifdef Q_OS_LINUX
     if (instance->settings()->get("EnableFeralGamemode").toBool() && APPLICATION->capabilities() & Application::SupportsGameMode)
     {
-        auto pid = m_process.processId();
+        auto pid = m_process->processId();
         if (pid)
         {
             gamemode_request_start_for(pid);
@@ -193,6 +251,31 @@ void LauncherPartLaunch::executeTask()
 #endif
 }
 
+bool LauncherPartLaunch::adoptSpare()
+{
+    auto pool = APPLICATION->spareJavas();
+    auto instanceId = m_parent->instance()->id();
+    if (!m_keepSpare)
+    {
+        pool->discard(instanceId);
+        return false;
+    }
+
+    auto spare = pool->take(instanceId, m_command);
+    if (!spare)
+        return false;
+
+    emit logLine("Using the Java process started after the last launch.\n\n", MessageLevel::Launcher);
+    m_process.reset(spare);
+    connectProcess();
+    // it may have gotten there before it was handed over
+    if (m_process->state() == LoggedProcess::Running)
+    {
+        QTimer::singleShot(0, this, [this] { on_state(LoggedProcess::Running); });
+    }
+    return true;
+}
+
 void LauncherPartLaunch::on_state(LoggedProcess::State state)
 {
     switch(state)
@@ -209,6 +292,9 @@ void LauncherPartLaunch::on_state(LoggedProcess::State state)
         case LoggedProcess::Crashed:
         {
             m_parent->setPid(-1);
+            ClassDataSharing::launchFinished(m_cdsArchive, false);
+            if (m_keepSpare)
+                APPLICATION->spareJavas()->prepare(m_parent->instance()->id(), m_command);
             emitFailed(tr("Game crashed."));
             return;
         }
@@ -220,7 +306,11 @@ void LauncherPartLaunch::on_state(LoggedProcess::State state)
 
             m_parent->setPid(-1);
             // if the exit code wasn't 0, report this as a crash
-            auto exitCode = m_process.exitCode();
+            auto exitCode = m_process->exitCode();
+            m_parent->record().exitCode = exitCode;
+            ClassDataSharing::launchFinished(m_cdsArchive, exitCode == 0);
+            if (m_keepSpare)
+                APPLICATION->spareJavas()->prepare(instance->id(), m_command);
             if(exitCode != 0)
             {
                 emitFailed(tr("Game crashed."));
@@ -233,11 +323,11 @@ void LauncherPartLaunch::on_state(LoggedProcess::State state)
             break;
         }
         case LoggedProcess::Running:
-            emit logLine(QString("Minecraft process ID: %1\n\n").arg(m_process.processId()), MessageLevel::Launcher);
-            m_parent->setPid(m_process.processId());
+            emit logLine(QString("Minecraft process ID: %1\n\n").arg(m_process->processId()), MessageLevel::Launcher);
+            m_parent->setPid(m_process->processId());
             m_parent->instance()->setLastLaunch();
             // send the launch script to the launcher part
-            m_process.write(m_launchScript.toUtf8());
+            m_process->write(m_launchScript.toUtf8());
 
             mayProceed = true;
             emit readyForLaunch();
@@ -249,7 +339,7 @@ void LauncherPartLaunch::on_state(LoggedProcess::State state)
 
 void LauncherPartLaunch::setWorkingDirectory(const QString &wd)
 {
-    m_process.setWorkingDirectory(wd);
+    m_process->setWorkingDirectory(wd);
 }
 
 void LauncherPartLaunch::proceed()
@@ -257,7 +347,7 @@ void LauncherPartLaunch::proceed()
     if(mayProceed)
     {
         QString launchString("launch\n");
-        m_process.write(launchString.toUtf8());
+        m_process->write(launchString.toUtf8());
         mayProceed = false;
     }
 }
@@ -268,14 +358,14 @@ bool LauncherPartLaunch::abort()
     {
         mayProceed = false;
         QString launchString("abort\n");
-        m_process.write(launchString.toUtf8());
+        m_process->write(launchString.toUtf8());
     }
     else
     {
-        auto state = m_process.state();
+        auto state = m_process->state();
         if (state == LoggedProcess::Running || state == LoggedProcess::Starting)
         {
-            m_process.kill();
+            m_process->kill();
         }
     }
     return true;
@@ -19,7 +19,11 @@
 #include <LoggedProcess.h>
 #include <minecraft/auth/AuthSession.h>
 
+#include <memory>
+
+#include "ClassDataSharing.h"
 #include "MinecraftServerTarget.h"
+#include "SpareJavaPool.h"
 
 class LauncherPartLaunch: public LaunchStep
 {
@@ -50,11 +54,18 @@ private slots:
     void on_state(LoggedProcess::State state);
 
 private:
-    LoggedProcess m_process;
-    QString m_command;
+    void connectProcess();
+    bool adoptSpare();
+
+private:
+    std::unique_ptr<LoggedProcess> m_process;
+    SpareJavaPool::Command m_command;
+    // whether a spare is started for the next launch once this one is over
+    bool m_keepSpare = false;
     AuthSessionPtr m_session;
     QString m_launchScript;
     MinecraftServerTargetPtr m_serverToJoin;
+    ClassDataSharing::Archive m_cdsArchive;
 
     bool mayProceed = false;
 };
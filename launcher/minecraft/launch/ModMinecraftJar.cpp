@@ -39,6 +39,51 @@
 #include "FileSystem.h"
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
+#include "minecraft/mod/Mod.h"
+#include "modplatform/helpers/HashUtils.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDebug>
+
+namespace {
+
+/* Identifies the jar built from the source jar and these jar mods, or returns an empty string if it can't be cached.
+ *
+ * Everything that changes the contents of the built jar goes into it: the hash of the source jar, and the order,
+ * state, name and hash of every jar mod. The hashes are cached, so the files are only read again when they change.
+ */
+QString moddedJarKey(const QString& sourceJarPath, const QList<Mod*>& jarMods)
+{
+    auto sourceHashes = Hashing::hashFile(sourceJarPath);
+    if(!sourceHashes.isValid())
+    {
+        return {};
+    }
+    QStringList keyParts{ "source " + sourceHashes.sha1 };
+    for(auto mod : jarMods)
+    {
+        if(!mod->enabled())
+        {
+            keyParts.append("disabled");
+            continue;
+        }
+        // folders would need hashing all their files, they're not worth it
+        if(mod->type() != ResourceType::ZIPFILE && mod->type() != ResourceType::SINGLEFILE)
+        {
+            return {};
+        }
+        auto hashes = Hashing::hashFile(mod->fileinfo().absoluteFilePath());
+        if(!hashes.isValid())
+        {
+            return {};
+        }
+        keyParts.append(QString("%1 %2 %3").arg(int(mod->type())).arg(hashes.sha1, mod->fileinfo().fileName()));
+    }
+    return QString(QCryptographicHash::hash(keyParts.join('\n').toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+}
 
 void ModMinecraftJar::executeTask()
 {
@@ -71,9 +116,49 @@ void ModMinecraftJar::executeTask()
         QStringList jars, temp1, temp2, temp3, temp4;
         mainJar->getApplicableFiles(m_inst->runtimeContext(), jars, temp1, temp2, temp3, m_inst->getLocalLibraryPath());
         auto sourceJarPath = jars[0];
-        if(!MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods))
+        auto key = moddedJarKey(sourceJarPath, jarMods);
+        if(key.isEmpty())
+        {
+            if(!MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods))
+            {
+                emitFailed(tr("Failed to create the custom Minecraft jar file."));
+                return;
+            }
+            emitSucceeded();
+            return;
+        }
+
+        // Built jars are kept in the cache, so launching again with the same jar mods doesn't rebuild it
+        QDir cache(QDir("cache/jars").absolutePath());
+        auto cachedJarPath = cache.absoluteFilePath(key + ".jar");
+        if(!QFileInfo(cachedJarPath).isFile())
+        {
+            // build it next to its final place, so an interrupted build is never taken for a complete one
+            auto partialJarPath = cache.absoluteFilePath(QString("%1.jar.%2.part").arg(key).arg(QCoreApplication::applicationPid()));
+            if(!FS::ensureFolderPathExists(cache.absolutePath()) || !MMCZip::createModdedJar(sourceJarPath, partialJarPath, jarMods))
+            {
+                emitFailed(tr("Failed to create the custom Minecraft jar file."));
+                return;
+            }
+            // Another launch may have got there first, which is fine as it's the same jar
+            if(!QFile::rename(partialJarPath, cachedJarPath))
+            {
+                QFile::remove(partialJarPath);
+                if(!QFileInfo(cachedJarPath).isFile())
+                {
+                    emitFailed(tr("Failed to create the custom Minecraft jar file."));
+                    return;
+                }
+            }
+        }
+        else
+        {
+            qDebug() << "Reusing the custom Minecraft jar" << cachedJarPath;
+        }
+
+        if(!FS::cloneOrLinkFile(cachedJarPath, finalJarPath))
         {
-            emitFailed(tr("Failed to create the custom Minecraft jar file."));
+            emitFailed(tr("Couldn't copy the custom Minecraft jar file to %1").arg(finalJarPath));
             return;
         }
     }
@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ProcessControls.h"
+
+#include <QStandardPaths>
+
+#include <algorithm>
+
+#include "settings/SettingsObject.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace {
+// more than any machine has, to catch typos like "0-40000"
+constexpr int s_max_cpu = 4095;
+
+struct PriorityName {
+    ProcessControls::Priority priority;
+    const char* name;
+    int niceness;
+};
+
+const PriorityName s_priorities[] = {
+    { ProcessControls::Priority::Idle, "idle", 19 },
+    { ProcessControls::Priority::BelowNormal, "below-normal", 10 },
+    { ProcessControls::Priority::Normal, "normal", 0 },
+    { ProcessControls::Priority::AboveNormal, "above-normal", -5 },
+    { ProcessControls::Priority::High, "high", -10 },
+};
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+bool prepend(const QString& command, const QStringList& commandArguments, QString& program, QStringList& arguments)
+{
+    auto path = QStandardPaths::findExecutable(command);
+    if (path.isEmpty())
+        return false;
+    arguments = commandArguments + QStringList{ program } + arguments;
+    program = path;
+    return true;
+}
+#endif
+}  // namespace
+
+namespace ProcessControls {
+
+Controls fromSettings(SettingsObject& settings)
+{
+    Controls controls;
+    controls.priority = priorityFromName(settings.get("ProcessPriority").toString());
+    controls.cpus = parseCpuList(settings.get("CpuAffinity").toString()).value_or(QList<int>());
+    controls.cpuQuota = qMax(0, settings.get("CpuQuota").toInt());
+    controls.memoryLimit = qMax(0, settings.get("MemoryLimit").toInt());
+    return controls;
+}
+
+QString priorityName(Priority priority)
+{
+    for (auto& entry : s_priorities) {
+        if (entry.priority == priority)
+            return entry.name;
+    }
+    return "normal";
+}
+
+Priority priorityFromName(const QString& name)
+{
+    for (auto& entry : s_priorities) {
+        if (name == entry.name)
+            return entry.priority;
+    }
+    return Priority::Normal;
+}
+
+int niceness(Priority priority)
+{
+    for (auto& entry : s_priorities) {
+        if (entry.priority == priority)
+            return entry.niceness;
+    }
+    return 0;
+}
+
+std::optional<QList<int>> parseCpuList(const QString& text)
+{
+    QList<int> cpus;
+    auto trimmed = text.trimmed();
+    if (trimmed.isEmpty())
+        return cpus;
+
+    for (auto& item : trimmed.split(',')) {
+        auto bounds = item.trimmed().split('-');
+        if (bounds.size() > 2)
+            return {};
+        bool ok_first, ok_last;
+        int first = bounds.first().trimmed().toInt(&ok_first);
+        int last = bounds.last().trimmed().toInt(&ok_last);
+        if (!ok_first || !ok_last || first < 0 || last < first || last > s_max_cpu)
+            return {};
+        for (int cpu = first; cpu <= last; cpu++)
+            cpus.append(cpu);
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+QString formatCpuList(const QList<int>& cpus)
+{
+    QStringList ranges;
+    for (int i = 0; i < cpus.size();) {
+        int last = i;
+        while (last + 1 < cpus.size() && cpus.at(last + 1) == cpus.at(last) + 1)
+            last++;
+        ranges.append(last == i ? QString::number(cpus.at(i)) : QString("%1-%2").arg(cpus.at(i)).arg(cpus.at(last)));
+        i = last + 1;
+    }
+    return ranges.join(',');
+}
+
+QStringList wrap(const Controls& controls, QString& program, QStringList& arguments)
+{
+    QStringList problems;
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    // the innermost first, these end up in front of each other
+    if (controls.priority != Priority::Normal &&
+        !prepend("nice", { "-n", QString::number(niceness(controls.priority)) }, program, arguments))
+        problems.append("The priority can't be changed, nice couldn't be found.");
+#endif
+
+#if defined(Q_OS_LINUX)
+    if (!controls.cpus.isEmpty() && !prepend("taskset", { "-c", formatCpuList(controls.cpus) }, program, arguments))
+        problems.append("The CPU affinity can't be set, taskset couldn't be found.");
+
+    if (controls.cpuQuota > 0 || controls.memoryLimit > 0) {
+        QStringList scope{ "--user", "--scope", "--quiet" };
+        if (controls.cpuQuota > 0)
+            scope << "-p" << QString("CPUQuota=%1%").arg(controls.cpuQuota);
+        if (controls.memoryLimit > 0)
+            scope << "-p" << QString("MemoryMax=%1M").arg(controls.memoryLimit);
+        scope << "--";
+        if (!prepend("systemd-run", scope, program, arguments))
+            problems.append("The CPU and memory limits can't be set, systemd-run couldn't be found.");
+    }
+#else
+    if (controls.cpuQuota > 0 || controls.memoryLimit > 0)
+        problems.append("The CPU and memory limits can only be set on Linux.");
+#endif
+
+#if defined(Q_OS_MACOS)
+    if (!controls.cpus.isEmpty())
+        problems.append("The CPU affinity can't be set on macOS.");
+#endif
+    return problems;
+}
+
+QStringList apply([[maybe_unused]] const Controls& controls, [[maybe_unused]] qint64 pid)
+{
+    QStringList problems;
+#ifdef Q_OS_WIN
+    if (controls.priority == Priority::Normal && controls.cpus.isEmpty())
+        return problems;
+
+    auto process = OpenProcess(PROCESS_SET_INFORMATION | PROCESS_QUERY_INFORMATION, FALSE, static_cast<DWORD>(pid));
+    if (!process) {
+        problems.append("The process couldn't be opened to set its priority and CPU affinity.");
+        return problems;
+    }
+
+    if (controls.priority != Priority::Normal) {
+        DWORD priorityClass = NORMAL_PRIORITY_CLASS;
+        switch (controls.priority) {
+            case Priority::Idle:
+                priorityClass = IDLE_PRIORITY_CLASS;
+                break;
+            case Priority::BelowNormal:
+                priorityClass = BELOW_NORMAL_PRIORITY_CLASS;
+                break;
+            case Priority::AboveNormal:
+                priorityClass = ABOVE_NORMAL_PRIORITY_CLASS;
+                break;
+            case Priority::High:
+                priorityClass = HIGH_PRIORITY_CLASS;
+                break;
+            case Priority::Normal:
+                break;
+        }
+        if (!SetPriorityClass(process, priorityClass))
+            problems.append("The priority couldn't be changed.");
+    }
+
+    if (!controls.cpus.isEmpty()) {
+        // a mask only covers the CPUs of one processor group
+        DWORD_PTR mask = 0;
+        for (auto cpu : controls.cpus) {
+            if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8))
+                mask |= DWORD_PTR(1) << cpu;
+        }
+        if (!mask || !SetProcessAffinityMask(process, mask))
+            problems.append("The CPU affinity couldn't be set.");
+    }
+    CloseHandle(process);
+#endif
+    return problems;
+}
+
+}  // namespace ProcessControls
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <optional>
+
+class SettingsObject;
+
+/* Scheduling and resource controls for the game process of an instance.
+ *
+ * The priority and the CPUs the game may run on work everywhere but macOS, which has no CPU affinity. On Linux the
+ * game can also get a limit on how much CPU time and memory it takes, by starting it in a transient systemd scope of
+ * the user, which puts it in a cgroup of its own.
+ *
+ * On Linux and macOS the controls are commands put in front of the game's, `nice`, `taskset` and `systemd-run`, which
+ * all run what follows them in place, so the game keeps the process they were started as. On Windows they are applied
+ * to the process right after it's created.
+ */
+namespace ProcessControls {
+
+enum class Priority { Idle, BelowNormal, Normal, AboveNormal, High };
+
+struct Controls {
+    Priority priority = Priority::Normal;
+    // the CPUs the game may run on, all of them when empty
+    QList<int> cpus;
+    // percent of a single CPU, no limit when 0
+    int cpuQuota = 0;
+    // MiB, no limit when 0
+    int memoryLimit = 0;
+};
+
+/** The controls in the settings of an instance. */
+Controls fromSettings(SettingsObject& settings);
+
+QString priorityName(Priority priority);
+Priority priorityFromName(const QString& name);
+/** The niceness for `priority`, raising the priority above normal needs privileges. */
+int niceness(Priority priority);
+
+/** Parses a CPU list like `taskset` takes them, "0-3,8". Empty means all of them, and nothing is returned if it's not one. */
+std::optional<QList<int>> parseCpuList(const QString& text);
+QString formatCpuList(const QList<int>& cpus);
+
+/** Puts the commands that apply `controls` in front of `program` with `arguments`, where that's how they're applied.
+ *  Returns what can't be applied on this system. */
+QStringList wrap(const Controls& controls, QString& program, QStringList& arguments);
+
+/** Applies `controls` to the started process `pid`, where that's how they're applied. Returns what couldn't be applied. */
+QStringList apply(const Controls& controls, qint64 pid);
+
+}  // namespace ProcessControls
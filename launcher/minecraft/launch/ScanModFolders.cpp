@@ -44,21 +44,22 @@ void ScanModFolders::executeTask()
 {
     auto m_inst = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
 
+    // folders that didn't change since they were last scanned, like when the mods page was just open, are taken as they are
     auto loaders = m_inst->loaderModList();
     connect(loaders.get(), &ModFolderModel::updateFinished, this, &ScanModFolders::modsDone);
-    if(!loaders->update()) {
+    if(!loaders->updateIfChanged()) {
         m_modsDone = true;
     }
 
     auto cores = m_inst->coreModList();
     connect(cores.get(), &ModFolderModel::updateFinished, this, &ScanModFolders::coreModsDone);
-    if(!cores->update()) {
+    if(!cores->updateIfChanged()) {
         m_coreModsDone = true;
     }
 
     auto nils = m_inst->nilModList();
     connect(nils.get(), &ModFolderModel::updateFinished, this, &ScanModFolders::nilModsDone);
-    if(!nils->update()) {
+    if(!nils->updateIfChanged()) {
         m_nilModsDone = true;
     }
     checkDone();
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "SnapshotWorlds.h"
+
+#include "StringUtils.h"
+#include "launch/LaunchTask.h"
+#include "minecraft/MinecraftInstance.h"
+#include "settings/SettingsObject.h"
+
+void SnapshotWorlds::executeTask()
+{
+    auto instance = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
+    auto worlds = WorldSnapshotTask::worldsIn(instance->worldDir());
+    if (worlds.isEmpty()) {
+        emitSucceeded();
+        return;
+    }
+
+    emit logLine(tr("Taking snapshots of the worlds..."), MessageLevel::Launcher);
+    m_task.reset(new WorldSnapshotTask(instance->worldSnapshotsDir(), worlds, instance->settings()->get("WorldSnapshotsToKeep").toInt()));
+    connect(m_task.get(), &Task::finished, this, &SnapshotWorlds::snapshotsTaken);
+    m_task->start();
+}
+
+void SnapshotWorlds::snapshotsTaken()
+{
+    if (!m_task->wasSuccessful()) {
+        emit logLine(tr("Couldn't take snapshots of all the worlds: %1").arg(m_task->failReason()), MessageLevel::Error);
+    } else if (m_task->taken() == 0) {
+        emit logLine(tr("The worlds didn't change since their last snapshot."), MessageLevel::Launcher);
+    } else {
+        emit logLine(tr("Took snapshots of %n world(s), adding %1.", nullptr, m_task->taken())
+                         .arg(StringUtils::humanReadableFileSize(m_task->written())),
+                     MessageLevel::Launcher);
+    }
+    // the game is done already, the snapshots are only a bonus
+    emitSucceeded();
+}
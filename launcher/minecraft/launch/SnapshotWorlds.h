@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <launch/LaunchStep.h>
+
+#include <memory>
+
+#include "minecraft/WorldSnapshots.h"
+
+/* Takes snapshots of the worlds the game changed, once it exited, see WorldSnapshots. A snapshot that fails to be
+ * taken is logged and the launch goes on, the worlds are left as they are either way. */
+class SnapshotWorlds : public LaunchStep {
+    Q_OBJECT
+   public:
+    explicit SnapshotWorlds(LaunchTask* parent) : LaunchStep(parent) {}
+    ~SnapshotWorlds() override = default;
+
+    void executeTask() override;
+    bool canAbort() const override { return false; }
+
+   private:
+    void snapshotsTaken();
+
+   private:
+    std::unique_ptr<WorldSnapshotTask> m_task;
+};
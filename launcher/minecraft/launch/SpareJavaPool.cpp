@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "SpareJavaPool.h"
+
+#include <QDebug>
+#include <QTimer>
+
+#include "LoggedProcess.h"
+
+namespace {
+// how long a spare waits for the next launch before it's stopped
+constexpr int s_idle_ms = 30 * 60 * 1000;
+}  // namespace
+
+bool SpareJavaPool::Command::operator==(const Command& other) const
+{
+    return program == other.program && arguments == other.arguments && environment == other.environment &&
+           workingDirectory == other.workingDirectory;
+}
+
+SpareJavaPool::SpareJavaPool(QObject* parent) : QObject(parent) {}
+
+LoggedProcess* SpareJavaPool::take(const QString& instanceId, const Command& command)
+{
+    auto it = m_spares.find(instanceId);
+    if (it == m_spares.end())
+        return nullptr;
+
+    auto spare = *it;
+    m_spares.erase(it);
+    auto state = spare.process->state();
+    if (!(spare.command == command) || (state != LoggedProcess::Starting && state != LoggedProcess::Running)) {
+        qDebug() << "The spare Java process of" << instanceId << "doesn't fit this launch, stopping it";
+        spare.process->kill();
+        spare.process->deleteLater();
+        return nullptr;
+    }
+
+    spare.process->disconnect(this);
+    spare.process->setParent(nullptr);
+    return spare.process;
+}
+
+void SpareJavaPool::prepare(const QString& instanceId, const Command& command)
+{
+    discard(instanceId);
+
+    auto process = new LoggedProcess(this);
+    process->setProcessEnvironment(command.environment);
+    process->setWorkingDirectory(command.workingDirectory);
+    connect(process, &LoggedProcess::log, this, [instanceId](QStringList lines, MessageLevel::Enum) {
+        qDebug() << "Spare Java process of" << instanceId << ":" << lines;
+    });
+    connect(process, &LoggedProcess::stateChanged, this, [this, instanceId, process](LoggedProcess::State state) {
+        if (state == LoggedProcess::Starting || state == LoggedProcess::Running)
+            return;
+        auto it = m_spares.find(instanceId);
+        if (it == m_spares.end() || it->process != process)
+            return;
+        qWarning() << "The spare Java process of" << instanceId << "stopped on its own";
+        m_spares.erase(it);
+        process->deleteLater();
+    });
+    QTimer::singleShot(s_idle_ms, process, [this, instanceId, process] {
+        auto it = m_spares.constFind(instanceId);
+        if (it != m_spares.constEnd() && it->process == process) {
+            qDebug() << "The spare Java process of" << instanceId << "wasn't used, stopping it";
+            discard(instanceId);
+        }
+    });
+
+    m_spares.insert(instanceId, { command, process });
+    process->start(command.program, command.arguments);
+}
+
+void SpareJavaPool::discard(const QString& instanceId)
+{
+    auto it = m_spares.find(instanceId);
+    if (it == m_spares.end())
+        return;
+    auto process = it->process;
+    m_spares.erase(it);
+    process->disconnect(this);
+    process->kill();
+    process->deleteLater();
+}
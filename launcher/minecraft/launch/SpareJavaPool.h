@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QProcessEnvironment>
+#include <QString>
+#include <QStringList>
+
+class LoggedProcess;
+
+/* Java processes started ahead of the next launch of an instance.
+ *
+ * After the game of an instance with the setting on exits, the same command it was launched with is started again.
+ * The launcher part only reads the launch script from its input before doing anything, so that process boots the
+ * JVM and then waits. When the instance is launched again with exactly the same command, environment and working
+ * directory, it gets that process and only has to send it the script. Anything else, like other JVM arguments or a
+ * changed class path, stops it and launches as usual.
+ *
+ * A spare that isn't used for a while is stopped, and so are all of them when the launcher exits.
+ */
+class SpareJavaPool : public QObject {
+    Q_OBJECT
+   public:
+    struct Command {
+        QString program;
+        QStringList arguments;
+        QProcessEnvironment environment;
+        QString workingDirectory;
+
+        bool operator==(const Command& other) const;
+    };
+
+    explicit SpareJavaPool(QObject* parent = nullptr);
+
+    /** The spare of the instance if it was started with `command` and is still waiting, which the caller then owns.
+     *  Returns null otherwise, and stops the spare the instance may have had. */
+    LoggedProcess* take(const QString& instanceId, const Command& command);
+
+    /** Starts a spare for the instance with `command`, in place of the one it may have. */
+    void prepare(const QString& instanceId, const Command& command);
+
+    /** Stops the spare of the instance, if it has one. */
+    void discard(const QString& instanceId);
+
+   private:
+    struct Spare {
+        Command command;
+        LoggedProcess* process = nullptr;
+    };
+
+   private:
+    QHash<QString, Spare> m_spares;
+};
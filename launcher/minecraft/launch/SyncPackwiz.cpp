@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "SyncPackwiz.h"
+
+#include "launch/LaunchTask.h"
+#include "minecraft/MinecraftInstance.h"
+
+void SyncPackwiz::executeTask()
+{
+    auto instance = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
+    emit logLine(tr("Syncing with the packwiz pack at %1").arg(m_pack_url.toString()), MessageLevel::Launcher);
+
+    m_sync.reset(new Packwiz::SyncTask(instance.get(), m_pack_url));
+    connect(m_sync.get(), &Task::finished, this, &SyncPackwiz::syncFinished);
+    connect(m_sync.get(), &Task::progress, this, &SyncPackwiz::setProgress);
+    connect(m_sync.get(), &Task::stepProgress, this, &SyncPackwiz::propogateStepProgress);
+    connect(m_sync.get(), &Task::status, this, &SyncPackwiz::setStatus);
+    m_sync->start();
+}
+
+void SyncPackwiz::syncFinished()
+{
+    auto sync = m_sync;
+    m_sync.reset();
+    if (sync->wasSuccessful()) {
+        emitSucceeded();
+        return;
+    }
+    if (sync->getState() == Task::State::AbortedByUser) {
+        emitAborted();
+        return;
+    }
+
+    auto instance = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
+    if (Packwiz::SyncTask::wasSynced(instance.get())) {
+        // playing what was synced last beats not playing, like when offline
+        emit logLine(tr("Couldn't sync with the pack, launching with the files of the last sync: %1").arg(sync->failReason()),
+                     MessageLevel::Warning);
+        emitSucceeded();
+        return;
+    }
+    auto reason = tr("Couldn't sync with the pack: %1").arg(sync->failReason());
+    emit logLine(reason, MessageLevel::Fatal);
+    emitFailed(reason);
+}
+
+bool SyncPackwiz::abort()
+{
+    if (m_sync)
+        return m_sync->abort();
+    return true;
+}
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <launch/LaunchStep.h>
+
+#include "modplatform/packwiz/PackwizSync.h"
+
+/* Brings the instance up to date with the packwiz pack it's synced with, see Packwiz::SyncTask.
+ *
+ * When the pack can't be synced, the game is launched with the files it has, unless it was never synced before.
+ */
+class SyncPackwiz : public LaunchStep {
+    Q_OBJECT
+   public:
+    explicit SyncPackwiz(LaunchTask* parent, QUrl pack_url) : LaunchStep(parent), m_pack_url(std::move(pack_url)) {}
+    ~SyncPackwiz() override = default;
+
+    void executeTask() override;
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
+
+   private:
+    void syncFinished();
+
+   private:
+    QUrl m_pack_url;
+    shared_qobject_ptr<Packwiz::SyncTask> m_sync;
+};
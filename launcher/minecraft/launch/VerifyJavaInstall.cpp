@@ -35,7 +35,10 @@
 
 #include "VerifyJavaInstall.h"
 
+#include "Application.h"
+#include "java/JavaProbeCache.h"
 #include "java/JavaVersion.h"
+#include "launch/steps/CheckJava.h"
 #include "minecraft/PackProfile.h"
 #include "minecraft/MinecraftInstance.h"
 
@@ -57,6 +60,26 @@ void VerifyJavaInstall::executeTask() {
     }
 
 
+    // the instance goes with the Java of the global settings, which doesn't fit it: give it one of its own that does,
+    // from the Javas probed so far, rather than fail
+    bool usesGlobalJava = !settings->get("OverrideJava").toBool() && !settings->get("OverrideJavaLocation").toBool();
+    if (!ignoreCompatibility && usesGlobalJava && APPLICATION->settings()->get("AutomaticJavaSelection").toBool())
+    {
+        JavaCheckResult result;
+        if (APPLICATION->javaProbeCache()->findCompatible(compatibleMajors, result))
+        {
+            settings->set("OverrideJavaLocation", true);
+            settings->set("JavaPath", result.path);
+            CheckJava::remember(settings, result.path, result);
+            emit logLine(tr("This instance is not compatible with Java version %1, switching it to Java %2:\n%3\n")
+                             .arg(javaVersion.major())
+                             .arg(result.javaVersion.toString(), result.path),
+                         MessageLevel::Launcher);
+            emitSucceeded();
+            return;
+        }
+    }
+
     if (ignoreCompatibility)
     {
         emit logLine(tr("Java major version is incompatible. Things might break."), MessageLevel::Warning);
@@ -25,6 +25,7 @@
 #include <QMap>
 #include <QRegularExpression>
 
+#include "StringPool.h"
 #include "Version.h"
 
 // Values taken from:
@@ -53,7 +54,7 @@ void DataPack::setDescription(QString new_description)
 {
     QMutexLocker locker(&m_data_lock);
 
-    m_description = new_description;
+    m_description = StringPool::instance().intern(new_description);
 }
 
 std::pair<Version, Version> DataPack::compatibleVersions() const
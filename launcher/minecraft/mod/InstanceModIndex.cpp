@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "InstanceModIndex.h"
+
+#include <QDir>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
+#include "Executors.h"
+#include "InstanceList.h"
+#include "minecraft/mod/MetadataHandler.h"
+#include "minecraft/mod/Mod.h"
+#include "minecraft/mod/tasks/LocalModParseTask.h"
+
+InstanceModIndex::InstanceModIndex(std::shared_ptr<InstanceList> instances, QObject* parent)
+    : QObject(parent), m_instances(std::move(instances))
+{
+    m_watcher.setWatchFiles(true);
+    connect(&m_watcher, &FileWatcher::changed, this, [this](const QString& dir, const QStringList&) { folderChanged(dir); });
+    connect(m_instances.get(), &InstanceList::instancesChanged, this, [this] {
+        if (m_built)
+            syncInstances();
+    });
+}
+
+void InstanceModIndex::build()
+{
+    if (m_built)
+        return;
+    m_built = true;
+    syncInstances();
+    if (m_scanning == 0)
+        emit ready();
+}
+
+void InstanceModIndex::syncInstances()
+{
+    QSet<QString> ids;
+    for (int i = 0; i < m_instances->count(); i++) {
+        auto instance = m_instances->at(i);
+        auto id = instance->id();
+        ids.insert(id);
+        auto folder = QDir(instance->modsRoot()).absolutePath();
+        if (m_folders.value(id) == folder)
+            continue;
+
+        if (m_folders.contains(id)) {
+            m_watcher.removePath(m_folders[id]);
+            m_folderInstances.remove(m_folders[id]);
+        }
+        m_folders.insert(id, folder);
+        m_folderInstances.insert(folder, id);
+        // the folder is only made once there's something in it, whatever appears in the instance then is a change
+        if (!m_watcher.addPath(folder, FileWatcher::Mode::Recursive))
+            m_watcher.addPath(instance->gameRoot());
+        scan(id);
+    }
+
+    for (auto& id : m_folders.keys()) {
+        if (ids.contains(id))
+            continue;
+        m_watcher.removePath(m_folders[id]);
+        m_folderInstances.remove(m_folders.take(id));
+        m_entries.remove(id);
+        m_generations[id]++;
+        emit instanceUpdated(id);
+    }
+}
+
+void InstanceModIndex::folderChanged(const QString& dir)
+{
+    auto id = m_folderInstances.value(QDir(dir).absolutePath());
+    if (!id.isEmpty()) {
+        scan(id);
+        return;
+    }
+    // the game folder of an instance that didn't have a mods folder yet
+    for (auto it = m_folders.cbegin(); it != m_folders.cend(); it++) {
+        if (it.value().startsWith(QDir(dir).absolutePath() + '/') && m_watcher.addPath(it.value(), FileWatcher::Mode::Recursive)) {
+            m_watcher.removePath(dir);
+            scan(it.key());
+            return;
+        }
+    }
+}
+
+void InstanceModIndex::scan(const QString& instanceId)
+{
+    auto generation = ++m_generations[instanceId];
+    m_scanning++;
+    auto watcher = new QFutureWatcher<QList<Entry>>(this);
+    connect(watcher, &QFutureWatcher<QList<Entry>>::finished, this, [this, watcher, instanceId, generation] {
+        watcher->deleteLater();
+        m_scanning--;
+        if (m_generations.value(instanceId) == generation) {
+            auto entries = watcher->result();
+            for (auto& entry : entries)
+                entry.instanceId = instanceId;
+            m_entries.insert(instanceId, entries);
+            emit instanceUpdated(instanceId);
+        }
+        if (m_scanning == 0)
+            emit ready();
+    });
+    watcher->setFuture(QtConcurrent::run(Executors::io(), &InstanceModIndex::scanFolder, m_folders.value(instanceId)));
+}
+
+auto InstanceModIndex::scanFolder(const QString& modsDir) -> QList<Entry>
+{
+    QList<Entry> entries;
+    QDir dir(modsDir);
+    if (!dir.exists())
+        return entries;
+
+    QDir index_dir(dir.filePath(".index"));
+    // the metadata files are named after the mods' slugs, not their files
+    QHash<QString, Metadata::ModStruct> metadata;
+    if (index_dir.exists()) {
+        for (auto& name : index_dir.entryList({ "*.pw.toml" }, QDir::Files)) {
+            auto slug = name.chopped(QString(".pw.toml").size());
+            auto mod = Metadata::get(index_dir, slug);
+            if (mod.isValid())
+                metadata.insert(mod.filename, mod);
+        }
+    }
+
+    for (auto& info : dir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden)) {
+        if (info.fileName() == ".index")
+            continue;
+        Mod mod(info);
+        if (mod.type() == ResourceType::UNKNOWN || mod.type() == ResourceType::SINGLEFILE)
+            continue;
+        ModUtils::process(mod, ModUtils::ProcessingLevel::BasicInfoOnly);
+
+        Entry entry;
+        entry.fileName = info.fileName();
+        entry.enabled = mod.enabled();
+        entry.modId = mod.details().mod_id;
+        entry.name = mod.name();
+        entry.version = mod.version();
+
+        auto file_name = entry.fileName;
+        if (file_name.endsWith(".disabled"))
+            file_name.chop(QString(".disabled").size());
+        auto found = metadata.constFind(file_name);
+        if (found != metadata.constEnd()) {
+            entry.hasMetadata = true;
+            entry.provider = found->provider;
+            entry.projectId = found->project_id.toString();
+            entry.fileId = found->file_id.toString();
+            entry.hashFormat = found->hash_format;
+            entry.hash = found->hash;
+        }
+        entries.append(entry);
+    }
+    return entries;
+}
+
+bool InstanceModIndex::matches(const Entry& entry, const QString& query)
+{
+    if (query.isEmpty())
+        return true;
+    for (auto* field : { &entry.modId, &entry.name, &entry.fileName, &entry.projectId }) {
+        if (field->contains(query, Qt::CaseInsensitive))
+            return true;
+    }
+    // a hash is only looked for whole
+    return !entry.hash.isEmpty() && entry.hash.compare(query, Qt::CaseInsensitive) == 0;
+}
+
+auto InstanceModIndex::find(const QString& query) const -> QList<Entry>
+{
+    auto trimmed = query.trimmed();
+    QList<Entry> found;
+    for (auto& entries : m_entries) {
+        for (auto& entry : entries) {
+            if (matches(entry, trimmed))
+                found.append(entry);
+        }
+    }
+    return found;
+}
+
+auto InstanceModIndex::entries() const -> QList<Entry>
+{
+    return find({});
+}
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#include <memory>
+
+#include "FileWatcher.h"
+#include "modplatform/ModIndex.h"
+
+class InstanceList;
+
+/* The mods of all the instances, for finding which instances have a mod without opening each of them.
+ *
+ * It's built the first time it's asked for, from the mod folders of the instances, with the details of the mod files
+ * from the mod details cache (see ModDetailsCache) and the metadata of the mods downloaded through the launcher. The
+ * folders are then watched, and only those that changed are looked at again, as are the instances that are added.
+ */
+class InstanceModIndex : public QObject {
+    Q_OBJECT
+   public:
+    struct Entry {
+        QString instanceId;
+        // in the mods folder, with ".disabled" when it's disabled
+        QString fileName;
+        bool enabled = true;
+        QString modId;
+        QString name;
+        QString version;
+
+        // from the metadata, for the mods downloaded through the launcher
+        bool hasMetadata = false;
+        ModPlatform::ResourceProvider provider = ModPlatform::ResourceProvider::MODRINTH;
+        QString projectId;
+        QString fileId;
+        QString hashFormat;
+        QString hash;
+    };
+
+    explicit InstanceModIndex(std::shared_ptr<InstanceList> instances, QObject* parent = nullptr);
+
+    /** Indexes the instances, ready() tells when it's done. Once built, it's kept up to date and this does nothing. */
+    void build();
+    bool isReady() const { return m_built && m_scanning == 0; }
+
+    /** The mods whose ID, name, file name, project ID or hash contain `query`, ignoring case. */
+    QList<Entry> find(const QString& query) const;
+    QList<Entry> entries() const;
+
+    /** What's in a mods folder, without the instance. */
+    static QList<Entry> scanFolder(const QString& modsDir);
+    static bool matches(const Entry& entry, const QString& query);
+
+   signals:
+    void ready();
+    /** The mods of the instance changed, or it's gone. */
+    void instanceUpdated(const QString& instanceId);
+
+   private:
+    void syncInstances();
+    void scan(const QString& instanceId);
+    void folderChanged(const QString& dir);
+
+   private:
+    std::shared_ptr<InstanceList> m_instances;
+    bool m_built = false;
+    int m_scanning = 0;
+
+    QHash<QString, QList<Entry>> m_entries;
+    // the mods folder of each instance, and the other way around
+    QHash<QString, QString> m_folders;
+    QHash<QString, QString> m_folderInstances;
+    // for the results of the scans that were started again before to be dropped
+    QHash<QString, int> m_generations;
+
+    FileWatcher m_watcher;
+};
@@ -41,9 +41,10 @@
 #include <QString>
 #include <QRegularExpression>
 
+#include "FileSystem.h"
 #include "MetadataHandler.h"
-#include "Version.h"
 #include "minecraft/mod/ModDetails.h"
+#include "minecraft/mod/PackIcon.h"
 
 static ModPlatform::ProviderCapabilities ProviderCaps;
 
@@ -91,8 +92,8 @@ std::pair<int, bool> Mod::compare(const Resource& other, SortType type) const
                 return res;
         }
         case SortType::VERSION: {
-            auto this_ver = Version(version());
-            auto other_ver = Version(cast_other->version());
+            auto& this_ver = comparableVersion();
+            auto& other_ver = cast_other->comparableVersion();
             if (this_ver > other_ver)
                 return { 1, type == SortType::VERSION };
             if (this_ver < other_ver)
@@ -159,6 +160,14 @@ auto Mod::version() const -> QString
     return details().version;
 }
 
+auto Mod::comparableVersion() const -> const Version&
+{
+    auto current = version();
+    if (m_comparable_version.toString() != current)
+        m_comparable_version = Version(current);
+    return m_comparable_version;
+}
+
 auto Mod::homeurl() const -> QString
 {
     return details().homeurl;
@@ -198,11 +207,59 @@ void Mod::finishResolvingWithDetails(ModDetails&& details)
     if (details.status == ModStatus::Unknown)
         details.status = m_local_details.status;
 
+    if (details.icon_path != m_local_details.icon_path) {
+        ImageCache::instance().remove(m_image_key);
+        m_image_key = 0;
+        m_image_failed = false;
+    }
+
+    details.intern();
     m_local_details = std::move(details);
     if (metadata)
         setMetadata(std::move(metadata));
 };
 
+QPixmap Mod::image(QSize size)
+{
+    QPixmap cached_image;
+    if (ImageCache::instance().pixmap(m_image_key, size, &cached_image))
+        return cached_image;
+
+    // Not decoded yet, or evicted from the cache since.
+    if (m_image_loading || m_image_failed || m_local_details.icon_path.isEmpty())
+        return {};
+
+    PackIcon icon;
+    icon.pack = fileinfo().filePath();
+    switch (type()) {
+        case ResourceType::FOLDER:
+            icon.entry = FS::PathCombine(icon.pack, m_local_details.icon_path);
+            break;
+        case ResourceType::ZIPFILE:
+        case ResourceType::LITEMOD:
+            icon.entry = m_local_details.icon_path;
+            icon.in_zip = true;
+            break;
+        default:
+            return {};
+    }
+
+    m_image_loading = true;
+    icon.loadAsync(size, this, [this](QImage image) {
+        m_image_loading = false;
+        if (image.isNull()) {
+            // don't try again each time the row gets painted
+            m_image_failed = true;
+            return;
+        }
+
+        ImageCache::instance().remove(m_image_key);
+        m_image_key = ImageCache::instance().insert(image);
+        emit imageChanged();
+    });
+    return {};
+}
+
 auto Mod::provider() const -> std::optional<QString>
 {
     if (metadata())
@@ -38,11 +38,14 @@
 #include <QDateTime>
 #include <QFileInfo>
 #include <QList>
+#include <QPixmap>
 
 #include <optional>
 
+#include "ImageCache.h"
 #include "Resource.h"
 #include "ModDetails.h"
+#include "Version.h"
 
 class Mod : public Resource
 {
@@ -65,6 +68,12 @@ public:
     auto status()      const -> ModStatus;
     auto provider()    const -> std::optional<QString>;
 
+    /**
+     * The icon of the mod, scaled to size. It's null until the icon got decoded in the background,
+     * imageChanged() is emitted once it is.
+     */
+    [[nodiscard]] QPixmap image(QSize size);
+
     auto metadata() -> std::shared_ptr<Metadata::ModStruct>;
     auto metadata() const -> const std::shared_ptr<Metadata::ModStruct>;
 
@@ -83,6 +92,19 @@ public:
 
     void finishResolvingWithDetails(ModDetails&& details);
 
+signals:
+    void imageChanged();
+
 protected:
     ModDetails m_local_details;
+
+private:
+    // the version parsed for sorting, kept so it isn't parsed again for every comparison
+    auto comparableVersion() const -> const Version&;
+    mutable Version m_comparable_version;
+
+    // 0 until the icon got decoded
+    ImageCache::Key m_image_key = 0;
+    bool m_image_loading = false;
+    bool m_image_failed = false;
 };
@@ -40,6 +40,7 @@
 #include <QString>
 #include <QStringList>
 
+#include "StringPool.h"
 #include "minecraft/mod/MetadataHandler.h"
 
 enum class ModStatus {
@@ -72,6 +73,9 @@ struct ModDetails
     /* List of the author's names */
     QStringList authors = {};
 
+    /* Path of the icon inside the mod file, empty when it doesn't have one */
+    QString icon_path = {};
+
     /* Installation status of the mod */
     ModStatus status = ModStatus::Unknown;
 
@@ -80,6 +84,19 @@ struct ModDetails
 
     ModDetails() = default;
 
+    /** Shares the strings with the details of the same mod elsewhere, see StringPool. The icon path is left alone. */
+    void intern()
+    {
+        auto& pool = StringPool::instance();
+        mod_id = pool.intern(mod_id);
+        name = pool.intern(name);
+        version = pool.intern(version);
+        mcversion = pool.intern(mcversion);
+        homeurl = pool.intern(homeurl);
+        description = pool.intern(description);
+        authors = pool.intern(authors);
+    }
+
     /** Metadata should be handled manually to properly set the mod status. */
     ModDetails(const ModDetails& other)
         : mod_id(other.mod_id)
@@ -89,6 +106,7 @@ struct ModDetails
         , homeurl(other.homeurl)
         , description(other.description)
         , authors(other.authors)
+        , icon_path(other.icon_path)
         , status(other.status)
     {}
 
@@ -101,6 +119,7 @@ struct ModDetails
         this->homeurl = other.homeurl;
         this->description = other.description;
         this->authors = other.authors;
+        this->icon_path = other.icon_path;
         this->status = other.status;
 
         return *this;
@@ -115,6 +134,7 @@ struct ModDetails
         this->homeurl = other.homeurl;
         this->description = other.description;
         this->authors = other.authors;
+        this->icon_path = other.icon_path;
         this->status = other.status;
 
         return *this;
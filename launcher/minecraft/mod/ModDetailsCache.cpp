@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ModDetailsCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QSaveFile>
+
+#include "FileSystem.h"
+
+namespace {
+
+constexpr quint32 s_magic = 0x4d4f4443;  // "MODC"
+// Bump this whenever the parsers change what they extract, so the old results get thrown away
+constexpr quint32 s_version = 2;
+constexpr auto s_stream_version = QDataStream::Qt_5_12;
+
+void writeEntry(QDataStream& out, const QString& path, qint64 size, qint64 mtime, const ModDetailsCache::Result& result)
+{
+    auto& details = result.details;
+    out << path << size << mtime << result.valid << details.mod_id << details.name << details.version << details.mcversion
+        << details.homeurl << details.description << details.authors << details.icon_path;
+}
+
+bool readEntry(QDataStream& in, QString& path, qint64& size, qint64& mtime, ModDetailsCache::Result& result)
+{
+    auto& details = result.details;
+    in >> path >> size >> mtime >> result.valid >> details.mod_id >> details.name >> details.version >> details.mcversion >>
+        details.homeurl >> details.description >> details.authors >> details.icon_path;
+    details.intern();
+    return in.status() == QDataStream::Ok;
+}
+
+}  // namespace
+
+ModDetailsCache::ModDetailsCache(QString file) : m_file(std::move(file)) {}
+
+ModDetailsCache& ModDetailsCache::instance()
+{
+    static ModDetailsCache s_instance(QDir("cache").absoluteFilePath("moddetails"));
+    return s_instance;
+}
+
+std::optional<ModDetailsCache::Result> ModDetailsCache::find(const QFileInfo& file)
+{
+    QMutexLocker lock(&m_lock);
+    load();
+
+    auto it = m_entries.constFind(file.absoluteFilePath());
+    if (it == m_entries.constEnd() || it->size != file.size() || it->mtime != file.lastModified().toMSecsSinceEpoch())
+        return {};
+    return it->result;
+}
+
+void ModDetailsCache::insert(const QFileInfo& file, bool valid, const ModDetails& details)
+{
+    QMutexLocker lock(&m_lock);
+    load();
+
+    auto path = file.absoluteFilePath();
+    Entry entry{ file.size(), file.lastModified().toMSecsSinceEpoch(), { valid, details } };
+    entry.result.details.intern();
+    m_entries.insert(path, entry);
+
+    QFile out_file(m_file);
+    bool is_new = !out_file.exists();
+    if (!FS::ensureFilePathExists(m_file) || !out_file.open(QFile::WriteOnly | QFile::Append)) {
+        qWarning() << "[ModDetailsCache] Could not open the cache for writing:" << out_file.errorString();
+        return;
+    }
+
+    QDataStream out(&out_file);
+    out.setVersion(s_stream_version);
+    if (is_new)
+        out << s_magic << s_version;
+    writeEntry(out, path, entry.size, entry.mtime, entry.result);
+    m_records++;
+}
+
+void ModDetailsCache::load()
+{
+    if (m_loaded)
+        return;
+    m_loaded = true;
+
+    QFile file(m_file);
+    if (!file.open(QFile::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setVersion(s_stream_version);
+
+    quint32 magic, version;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != s_magic || version != s_version) {
+        file.close();
+        compact();
+        return;
+    }
+
+    while (!in.atEnd()) {
+        QString path;
+        Entry entry;
+        if (!readEntry(in, path, entry.size, entry.mtime, entry.result))
+            break;
+
+        m_entries.insert(path, entry);
+        m_records++;
+    }
+
+    // entries of mods that got updated pile up over time
+    if (in.status() != QDataStream::Ok || m_records > 2 * m_entries.size() + 256) {
+        file.close();
+        compact();
+    }
+}
+
+void ModDetailsCache::compact()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (QFileInfo::exists(it.key()))
+            it++;
+        else
+            it = m_entries.erase(it);
+    }
+
+    QSaveFile file(m_file);
+    if (!FS::ensureFilePathExists(m_file) || !file.open(QFile::WriteOnly)) {
+        qWarning() << "[ModDetailsCache] Could not open the cache for writing:" << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(s_stream_version);
+    out << s_magic << s_version;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); it++)
+        writeEntry(out, it.key(), it->size, it->mtime, it->result);
+
+    if (!file.commit())
+        qWarning() << "[ModDetailsCache] Could not write the cache:" << file.errorString();
+    m_records = m_entries.size();
+}
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <optional>
+
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include "minecraft/mod/ModDetails.h"
+
+/* Persistent cache of the details parsed out of mod files.
+ *
+ * Entries are keyed by the file's path, size and modification time, so a mod
+ * file that did not change since the last time we looked at it doesn't need to
+ * be opened again. Files that didn't contain any mod metadata are remembered too.
+ *
+ * Like the file hash cache, it is stored as an append-only log of records, which
+ * gets compacted when loading it if it grew much bigger than what it describes.
+ */
+class ModDetailsCache {
+   public:
+    struct Result {
+        bool valid;
+        ModDetails details;
+    };
+
+    explicit ModDetailsCache(QString file);
+
+    /** The cache shared by every mod folder of the launcher. */
+    static ModDetailsCache& instance();
+
+    std::optional<Result> find(const QFileInfo& file);
+    void insert(const QFileInfo& file, bool valid, const ModDetails& details);
+
+   private:
+    struct Entry {
+        qint64 size;
+        qint64 mtime;
+        Result result;
+    };
+
+    void load();
+    void compact();
+
+    QMutex m_lock;
+    QString m_file;
+    bool m_loaded = false;
+    int m_records = 0;
+    QHash<QString, Entry> m_entries;
+};
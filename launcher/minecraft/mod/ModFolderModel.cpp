@@ -38,7 +38,6 @@
 
 #include <FileSystem.h>
 #include <QDebug>
-#include <QFileSystemWatcher>
 #include <QIcon>
 #include <QMimeData>
 #include <QString>
@@ -52,8 +51,17 @@
 
 #include "minecraft/mod/tasks/LocalModParseTask.h"
 #include "minecraft/mod/tasks/ModFolderLoadTask.h"
+#include "minecraft/mod/MetadataHandler.h"
 #include "modplatform/ModIndex.h"
 
+// the icons in the list, a bit bigger than they're drawn so they stay sharp when scaled
+static const QSize s_icon_size(32, 32);
+
+static QString indexKey(ModPlatform::ResourceProvider provider, const QString& value)
+{
+    return QString("%1:%2").arg(static_cast<int>(provider)).arg(value);
+}
+
 ModFolderModel::ModFolderModel(const QString& dir, BaseInstance* instance, bool is_indexed, bool create_dir)
     : ResourceFolderModel(QDir(dir), instance, nullptr, create_dir), m_is_indexed(is_indexed)
 {
@@ -119,6 +127,12 @@ QVariant ModFolderModel::data(const QModelIndex &index, int role) const
         if (column == NAME_COLUMN && (at(row)->isSymLinkUnder(instDirPath()) || at(row)->isMoreThanOneHardLink()))
             return APPLICATION->getThemedIcon("status-yellow");
 
+        if (column == NameColumn) {
+            // only asked for the rows that are shown, the icon is decoded in the background the first time
+            auto image = static_cast<Mod*>(m_resources[row].get())->image(s_icon_size);
+            if (!image.isNull())
+                return QIcon(image);
+        }
         return {};
     }
     case Qt::CheckStateRole:
@@ -197,42 +211,35 @@ Task* ModFolderModel::createParseTask(Resource& resource)
 
 bool ModFolderModel::uninstallMod(const QString& filename, bool preserve_metadata)
 {
-    for(auto mod : allMods()){
-        if(mod->fileinfo().fileName() == filename){
-            auto index_dir = indexDir();
-            mod->destroy(index_dir, preserve_metadata);
+    auto mod = static_cast<Mod*>(findByFileName(filename));
+    if (!mod)
+        return false;
 
-            update();
+    auto index_dir = indexDir();
+    mod->destroy(index_dir, preserve_metadata);
 
-            return true;
-        }
-    }
+    update();
 
-    return false;
+    return true;
 }
 
 bool ModFolderModel::deleteMods(const QModelIndexList& indexes)
 {
-    if(!m_can_interact) {
-        return false;
-    }
-
-    if(indexes.isEmpty())
-        return true;
-
-    for (auto i: indexes)
-    {
-        if(i.column() != 0) {
-            continue;
-        }
-        auto m = at(i.row());
-        auto index_dir = indexDir();
-        m->destroy(index_dir);
-    }
-
-    update();
+    return deleteResources(indexes);
+}
 
-    return true;
+std::function<bool()> ModFolderModel::deleteOperation(Resource& resource)
+{
+    auto& mod = static_cast<Mod&>(resource);
+    auto index_dir = indexDir();
+    auto slug = mod.metadata() ? mod.metadata()->slug : mod.name();
+    auto name = mod.name();
+    auto delete_files = ResourceFolderModel::deleteOperation(resource);
+    return [index_dir, slug, name, delete_files]() mutable {
+        qDebug() << QString("Destroying metadata for '%1' on purpose").arg(name);
+        Metadata::remove(index_dir, slug);
+        return delete_files();
+    };
 }
 
 bool ModFolderModel::isValid()
@@ -252,6 +259,12 @@ bool ModFolderModel::stopWatching()
     return ResourceFolderModel::stopWatching({ m_dir.absolutePath(), indexDir().absolutePath() });
 }
 
+QList<QDir> ModFolderModel::scannedDirs() const
+{
+    // the metadata of the mods is read too
+    return { m_dir, indexDir() };
+}
+
 auto ModFolderModel::selectedMods(QModelIndexList& indexes) -> QList<Mod*>
 {
     QList<Mod*> selected_resources;
@@ -275,6 +288,44 @@ auto ModFolderModel::allMods() -> QList<Mod*>
     return mods;
 }
 
+auto ModFolderModel::findByHash(ModPlatform::ResourceProvider provider, const QString& hash) const -> Mod*
+{
+    auto row = m_hash_index.value(indexKey(provider, hash), -1);
+    if (row < 0)
+        return nullptr;
+    // the metadata may have changed since
+    auto mod = static_cast<Mod*>(m_resources.at(row).get());
+    auto metadata = mod->metadata();
+    return metadata && metadata->provider == provider && metadata->hash == hash ? mod : nullptr;
+}
+
+auto ModFolderModel::findByProject(ModPlatform::ResourceProvider provider, const QVariant& project_id) const -> Mod*
+{
+    auto row = m_project_index.value(indexKey(provider, project_id.toString()), -1);
+    if (row < 0)
+        return nullptr;
+    auto mod = static_cast<Mod*>(m_resources.at(row).get());
+    auto metadata = mod->metadata();
+    return metadata && metadata->provider == provider && metadata->project_id.toString() == project_id.toString() ? mod : nullptr;
+}
+
+void ModFolderModel::rebuildIndexes()
+{
+    ResourceFolderModel::rebuildIndexes();
+
+    m_hash_index.clear();
+    m_project_index.clear();
+    for (int row = 0; row < m_resources.size(); row++) {
+        auto metadata = static_cast<const Mod*>(m_resources.at(row).get())->metadata();
+        if (!metadata)
+            continue;
+        if (!metadata->hash.isEmpty())
+            m_hash_index.insert(indexKey(metadata->provider, metadata->hash), row);
+        if (!metadata->project_id.isNull())
+            m_project_index.insert(indexKey(metadata->provider, metadata->project_id.toString()), row);
+    }
+}
+
 void ModFolderModel::onUpdateSucceeded()
 {
     auto update_results = static_cast<ModFolderLoadTask*>(m_current_update_task.get())->result();
@@ -301,7 +352,9 @@ void ModFolderModel::onParseSucceeded(int ticket, QString mod_id)
     if (iter == m_active_parse_tasks.constEnd())
         return;
 
-    int row = m_resources_index[mod_id];
+    int row = m_resources_index.value(mod_id, -1);
+    if (row < 0)
+        return;
 
     auto parse_task = *iter;
     auto cast_task = static_cast<LocalModParseTask*>(parse_task.get());
@@ -311,8 +364,23 @@ void ModFolderModel::onParseSucceeded(int ticket, QString mod_id)
     auto resource = find(mod_id);
 
     auto result = cast_task->result();
-    if (result && resource)
+    if (result && resource) {
         resource->finishResolvingWithDetails(std::move(result->details));
+        connect(resource.get(), &Mod::imageChanged, this, &ModFolderModel::onImageChanged, Qt::UniqueConnection);
+    }
 
     emit dataChanged(index(row), index(row, columnCount(QModelIndex()) - 1));
 }
+
+void ModFolderModel::onImageChanged()
+{
+    auto mod = qobject_cast<Mod*>(sender());
+    if (!mod)
+        return;
+
+    auto row = m_resources_index.value(mod->internal_id(), -1);
+    if (row < 0 || row >= m_resources.size() || m_resources[row].get() != mod)
+        return;
+
+    emit dataChanged(index(row, NameColumn), index(row, NameColumn), { Qt::DecorationRole });
+}
@@ -36,6 +36,7 @@
 
 #pragma once
 
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QSet>
@@ -51,7 +52,6 @@
 
 class LegacyInstance;
 class BaseInstance;
-class QFileSystemWatcher;
 
 /**
  * A legacy mod list.
@@ -96,19 +96,33 @@ public:
     bool startWatching() override;
     bool stopWatching() override;
 
-    QDir indexDir() { return { QString("%1/.index").arg(dir().absolutePath()) }; }
+    QDir indexDir() const { return { QString("%1/.index").arg(dir().absolutePath()) }; }
 
     auto selectedMods(QModelIndexList& indexes) -> QList<Mod*>;
     auto allMods() -> QList<Mod*>;
 
+    /** The mod whose metadata has this hash or project, as of the last update of the model. */
+    auto findByHash(ModPlatform::ResourceProvider provider, const QString& hash) const -> Mod*;
+    auto findByProject(ModPlatform::ResourceProvider provider, const QVariant& project_id) const -> Mod*;
+
     RESOURCE_HELPERS(Mod)
 
 private
 slots:
     void onUpdateSucceeded() override;
     void onParseSucceeded(int ticket, QString resource_id) override;
+    void onImageChanged();
 
 protected:
+    [[nodiscard]] QList<QDir> scannedDirs() const override;
+    /** Removes the metadata of the mod too. */
+    [[nodiscard]] std::function<bool()> deleteOperation(Resource& resource) override;
+    void rebuildIndexes() override;
+
     bool m_is_indexed;
     bool m_first_folder_load = true;
+
+    // the rows of the mods by the provider and hash, and the provider and project, of their metadata
+    QHash<QString, int> m_hash_index;
+    QHash<QString, int> m_project_index;
 };
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "PackIcon.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QImageReader>
+#include <QtConcurrent>
+
+#include "ArchiveReader.h"
+#include "Executors.h"
+#include "FileSystem.h"
+
+QString PackIcon::thumbnailPath(const QString& cache_dir, QSize size) const
+{
+    // what changes when the pack gets replaced, without reading all of it
+    QFileInfo source(in_zip ? pack : entry);
+    auto fingerprint = QString("%1\n%2\n%3\n%4\n%5\n%6x%7")
+                           .arg(pack, entry)
+                           .arg(source.size())
+                           .arg(source.lastModified().toMSecsSinceEpoch())
+                           .arg(this->size)
+                           .arg(size.width())
+                           .arg(size.height());
+    auto hash = QCryptographicHash::hash(fingerprint.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return FS::PathCombine(cache_dir, QString(hash) + ".png");
+}
+
+QImage PackIcon::load(QSize size, const QString& cache_dir) const
+{
+    if (!isValid())
+        return {};
+
+    QString thumbnail;
+    if (!cache_dir.isEmpty()) {
+        thumbnail = thumbnailPath(cache_dir, size);
+        QImage cached(thumbnail, "PNG");
+        if (!cached.isNull())
+            return cached;
+    }
+
+    QByteArray data;
+    if (in_zip) {
+        MMCZip::ArchiveReader zip(pack);
+        if (!zip.open())
+            return {};
+        auto contents = zip.read(entry);
+        if (!contents)
+            return {};
+        // stored entries are views of the mapped archive, which goes away with the reader
+        data = QByteArray(contents->constData(), contents->size());
+    } else {
+        QFile file(entry);
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        data = file.readAll();
+    }
+
+    QBuffer buffer(&data);
+    QImageReader reader(&buffer);
+    auto image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "Failed to parse the pack.png of" << pack;
+        return {};
+    }
+    if (size.isValid() && image.size() != size)
+        image = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    if (!thumbnail.isEmpty() && FS::ensureFolderPathExists(cache_dir))
+        image.save(thumbnail, "PNG");
+    return image;
+}
+
+void PackIcon::loadAsync(QSize size, QObject* context, std::function<void(QImage)> done) const
+{
+    auto icon = *this;
+    auto cache_dir = cacheDir();
+    auto future = QtConcurrent::run(Executors::background(), [icon, size, cache_dir] { return icon.load(size, cache_dir); });
+
+    // goes away with the context, so nothing comes back once it's gone
+    auto watcher = new QFutureWatcher<QImage>(context);
+    QObject::connect(watcher, &QFutureWatcher<QImage>::finished, context, [watcher, done] {
+        auto image = watcher->result();
+        watcher->deleteLater();
+        done(image);
+    });
+    watcher->setFuture(future);
+}
+
+QString PackIcon::cacheDir()
+{
+    return QDir("cache/pack_icons").absolutePath();
+}
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <functional>
+
+#include <QImage>
+#include <QObject>
+#include <QSize>
+#include <QString>
+
+/* Where the pack.png of a resource or texture pack is, or the icon of a mod, so it's only read once it's shown.
+ *
+ * Parsing a pack only notes where the image is. It gets decoded at the size it's shown at, on the global thread pool,
+ * and the small version is kept in its own cache folder under a fingerprint of the pack, so the image of a pack is
+ * decoded at full size only once, and not at all on later starts.
+ */
+struct PackIcon {
+    // the pack or mod file, or folder
+    QString pack;
+    // the image in the zip, or the path of the image file when it's not a zip
+    QString entry;
+    bool in_zip = false;
+    // of the image, for the fingerprint
+    qint64 size = 0;
+
+    bool isValid() const { return !entry.isEmpty(); }
+
+    /** Where the thumbnail of `size` goes in `cache_dir`, changes whenever the pack or the image does. */
+    QString thumbnailPath(const QString& cache_dir, QSize size) const;
+
+    /**
+     * The image scaled to `size`, a null image if it can't be read. Takes the thumbnail in `cache_dir` when there's one,
+     * and writes it otherwise, unless `cache_dir` is empty. Blocks, so not for the GUI thread.
+     */
+    QImage load(QSize size, const QString& cache_dir) const;
+
+    /** Does load() on the global thread pool, and then calls `done` on the thread of `context`, unless it went away. */
+    void loadAsync(QSize size, QObject* context, std::function<void(QImage)> done) const;
+
+    /** The folder the launcher keeps the thumbnails in. */
+    static QString cacheDir();
+};
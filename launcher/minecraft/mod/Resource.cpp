@@ -53,15 +53,28 @@ void Resource::parseFile()
     }
 
     m_changed_date_time = m_file_info.lastModified();
+    m_changed_msecs = m_changed_date_time.toMSecsSinceEpoch();
 }
 
 static void removeThePrefix(QString& string)
 {
-    QRegularExpression regex(QStringLiteral("^(?:the|teh) +"), QRegularExpression::CaseInsensitiveOption);
+    static const QRegularExpression regex(QStringLiteral("^(?:the|teh) +"), QRegularExpression::CaseInsensitiveOption);
     string.remove(regex);
     string = string.trimmed();
 }
 
+auto Resource::sortName() const -> const QString&
+{
+    auto current = name();
+    if (m_sort_name_of != current || m_sort_name_of.isNull()) {
+        m_sort_name = current;
+        removeThePrefix(m_sort_name);
+        m_sort_name = m_sort_name.toCaseFolded();
+        m_sort_name_of = current;
+    }
+    return m_sort_name;
+}
+
 std::pair<int, bool> Resource::compare(const Resource& other, SortType type) const
 {
     switch (type) {
@@ -72,20 +85,14 @@ std::pair<int, bool> Resource::compare(const Resource& other, SortType type) con
             if (!enabled() && other.enabled())
                 return { -1, type == SortType::ENABLED };
         case SortType::NAME: {
-            QString this_name{ name() };
-            QString other_name{ other.name() };
-
-            removeThePrefix(this_name);
-            removeThePrefix(other_name);
-
-            auto compare_result = QString::compare(this_name, other_name, Qt::CaseInsensitive);
+            auto compare_result = sortName().compare(other.sortName());
             if (compare_result != 0)
                 return { compare_result, type == SortType::NAME };
         }
         case SortType::DATE:
-            if (dateTimeChanged() > other.dateTimeChanged())
+            if (m_changed_msecs > other.m_changed_msecs)
                 return { 1, type == SortType::DATE };
-            if (dateTimeChanged() < other.dateTimeChanged())
+            if (m_changed_msecs < other.m_changed_msecs)
                 return { -1, type == SortType::DATE };
     }
 
@@ -99,12 +106,24 @@ bool Resource::applyFilter(QRegularExpression filter) const
 
 bool Resource::enable(EnableAction action)
 {
-    if (m_type == ResourceType::UNKNOWN || m_type == ResourceType::FOLDER)
+    auto path = enabledPath(action);
+    if (path.isEmpty())
+        return false;
+
+    QFile file(m_file_info.absoluteFilePath());
+    if (!file.rename(path))
         return false;
 
+    setEnabledFile(path);
+    return true;
+}
+
+QString Resource::enabledPath(EnableAction action) const
+{
+    if (m_type == ResourceType::UNKNOWN || m_type == ResourceType::FOLDER)
+        return {};
 
     QString path = m_file_info.absoluteFilePath();
-    QFile file(path);
 
     bool enable = true;
     switch (action) {
@@ -121,28 +140,24 @@ bool Resource::enable(EnableAction action)
     }
 
     if (m_enabled == enable)
-        return false;
+        return {};
 
     if (enable) {
         // m_enabled is false, but there's no '.disabled' suffix.
         // TODO: Report error?
         if (!path.endsWith(".disabled"))
-            return false;
+            return {};
         path.chop(9);
-
-        if (!file.rename(path))
-            return false;
     } else {
         path += ".disabled";
-
-        if (!file.rename(path))
-            return false;
     }
+    return path;
+}
 
+void Resource::setEnabledFile(const QString& path)
+{
     setFile(QFileInfo(path));
-
-    m_enabled = enable;
-    return true;
+    m_enabled = !path.endsWith(".disabled");
 }
 
 bool Resource::destroy()
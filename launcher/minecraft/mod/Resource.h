@@ -60,6 +60,9 @@ class Resource : public QObject {
     [[nodiscard]] virtual auto name() const -> QString { return m_name; }
     [[nodiscard]] virtual bool valid() const { return m_type != ResourceType::UNKNOWN; }
 
+    /** The name to sort by: case folded, without a leading "the". Only made again when the name changes. */
+    [[nodiscard]] auto sortName() const -> const QString&;
+
     /** Compares two Resources, for sorting purposes, considering a ascending order, returning:
      *  > 0: 'this' comes after 'other'
      *  = 0: 'this' is equal to 'other'
@@ -80,6 +83,11 @@ class Resource : public QObject {
      */
     bool enable(EnableAction action);
 
+    /** The path the file of the resource gets with 'action', empty if nothing would change. */
+    [[nodiscard]] QString enabledPath(EnableAction action) const;
+    /** Takes over the file at 'path', after it was renamed to the path enabledPath() gave. */
+    void setEnabledFile(const QString& path);
+
     [[nodiscard]] auto shouldResolve() const -> bool { return !m_is_resolving && !m_is_resolved; }
     [[nodiscard]] auto isResolving() const -> bool { return m_is_resolving; }
     [[nodiscard]] auto isResolved() const -> bool { return m_is_resolved; }
@@ -112,6 +120,8 @@ class Resource : public QObject {
     QFileInfo m_file_info;
     /* The cached date when this file was last changed. */
     QDateTime m_changed_date_time;
+    /* The same, as milliseconds since the epoch, which is what sorting by date compares. */
+    qint64 m_changed_msecs = 0;
 
     /* Internal ID for internal purposes. Properties such as human-readability should not be assumed. */
     QString m_internal_id;
@@ -128,4 +138,9 @@ class Resource : public QObject {
     bool m_is_resolving = false;
     bool m_is_resolved = false;
     int m_resolution_ticket = 0;
+
+   private:
+    /* The sort key of the name, and the name it was made from. */
+    mutable QString m_sort_name;
+    mutable QString m_sort_name_of;
 };
@@ -3,14 +3,17 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QFileInfo>
+#include <QFutureWatcher>
 #include <QIcon>
 #include <QMimeData>
 #include <QStyle>
 #include <QThreadPool>
 #include <QUrl>
+#include <QtConcurrent>
 
 #include "Application.h"
 #include "FileSystem.h"
+#include "MemoryAccounting.h"
 
 #include "minecraft/mod/tasks/BasicFolderLoadTask.h"
 
@@ -26,14 +29,32 @@ ResourceFolderModel::ResourceFolderModel(QDir dir, BaseInstance* instance, QObje
     m_dir.setFilter(QDir::Readable | QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs);
     m_dir.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
 
-    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &ResourceFolderModel::directoryChanged);
+    m_watcher.setInterval(250);
+    connect(&m_watcher, &FileWatcher::changed, this, &ResourceFolderModel::directoryChanged);
     connect(&m_helper_thread_task, &ConcurrentTask::finished, this, [this] { m_helper_thread_task.clear(); });
+
+    MemoryAccounting::track(this, "Resource folders", [this] {
+        MemoryAccounting::Usage usage;
+        usage.items = m_resources.size();
+        for (auto& resource : m_resources)
+            usage.bytes += qint64(sizeof(Resource)) + MemoryAccounting::bytesOf(resource->name()) +
+                           MemoryAccounting::bytesOf(resource->fileinfo().absoluteFilePath());
+        return usage;
+    });
 }
 
 ResourceFolderModel::~ResourceFolderModel()
 {
-    while (!QThreadPool::globalInstance()->waitForDone(100))
-        QCoreApplication::processEvents();
+    // nothing under way has to finish, only to stop using this model: the folder scan checks for its abort as it
+    // goes, and the parses not started yet are dropped, so this only waits for what runs this very moment
+    m_work.cancel();
+    if (m_current_update_task)
+        m_current_update_task->abort();
+    for (auto& task : m_active_parse_tasks)
+        task->abort();
+    if (m_helper_thread_task.isRunning())
+        m_helper_thread_task.abort();
+    m_work.waitForDone();
 }
 
 bool ResourceFolderModel::startWatching(const QStringList paths)
@@ -154,16 +175,36 @@ bool ResourceFolderModel::installResource(QString original_path)
 
 bool ResourceFolderModel::uninstallResource(QString file_name)
 {
-    for (auto& resource : m_resources) {
-        if (resource->fileinfo().fileName() == file_name) {
-            auto res = resource->destroy();
+    auto resource = findByFileName(file_name);
+    if (!resource)
+        return false;
 
-            update();
+    auto res = resource->destroy();
 
-            return res;
-        }
+    update();
+
+    return res;
+}
+
+Resource* ResourceFolderModel::findByFileName(const QString& file_name) const
+{
+    auto row = m_file_name_index.value(file_name, -1);
+    if (row < 0)
+        return nullptr;
+    return m_resources.at(row).get();
+}
+
+void ResourceFolderModel::rebuildIndexes()
+{
+    m_resources_index.clear();
+    m_file_name_index.clear();
+    m_file_name_index.reserve(m_resources.size());
+    int idx = 0;
+    for (auto const& resource : qAsConst(m_resources)) {
+        m_resources_index[resource->internal_id()] = idx;
+        m_file_name_index.insert(resource->fileinfo().fileName(), idx);
+        idx++;
     }
-    return false;
 }
 
 bool ResourceFolderModel::deleteResources(const QModelIndexList& indexes)
@@ -174,18 +215,16 @@ bool ResourceFolderModel::deleteResources(const QModelIndexList& indexes)
     if (indexes.isEmpty())
         return true;
 
+    QList<BatchItem> items;
     for (auto i : indexes) {
-        if (i.column() != 0) {
+        if (!validateIndex(i) || i.column() != 0)
             continue;
-        }
 
         auto& resource = m_resources.at(i.row());
-
-        resource->destroy();
+        items.append({ resource, resource->internal_id(), {}, deleteOperation(*resource) });
     }
 
-    update();
-
+    startBatch(items);
     return true;
 }
 
@@ -197,34 +236,168 @@ bool ResourceFolderModel::setResourceEnabled(const QModelIndexList &indexes, Ena
     if (indexes.isEmpty())
         return true;
 
-    bool succeeded = true;
+    QList<BatchItem> items;
     for (auto const& idx : indexes) {
         if (!validateIndex(idx) || idx.column() != 0)
             continue;
 
-        int row = idx.row();
+        auto& resource = m_resources[idx.row()];
+        auto new_path = resource->enabledPath(action);
+        if (new_path.isEmpty())
+            continue;
+
+        auto old_path = resource->fileinfo().absoluteFilePath();
+        items.append({ resource, resource->internal_id(), new_path, [old_path, new_path] { return QFile::rename(old_path, new_path); } });
+    }
+
+    startBatch(items);
+    return true;
+}
+
+std::function<bool()> ResourceFolderModel::deleteOperation(Resource& resource)
+{
+    auto path = resource.fileinfo().filePath();
+    return [path] { return FS::trash(path) || FS::deletePath(path); };
+}
+
+void ResourceFolderModel::startBatch(QList<BatchItem> items)
+{
+    if (items.isEmpty())
+        return;
+
+    m_pending_batches.append(items);
+    if (!m_batch_running)
+        runNextBatch();
+}
+
+void ResourceFolderModel::runNextBatch()
+{
+    if (m_pending_batches.isEmpty())
+        return;
+
+    auto items = m_pending_batches.takeFirst();
+    m_batch_running = true;
+    m_batch_up_to_date = isUpToDate();
 
-        auto& resource = m_resources[row];
+    // the model already knows what is going to change, an update for each file of the batch would only slow it down
+    if (m_is_watching && m_suspended_paths.isEmpty()) {
+        m_suspended_paths = m_watcher.directories();
+        if (!m_suspended_paths.isEmpty())
+            m_watcher.removePaths(m_suspended_paths);
+    }
+
+    QList<std::function<bool()>> operations;
+    for (auto const& item : items)
+        operations.append(item.operation);
+
+    auto watcher = new QFutureWatcher<QVector<bool>>(this);
+    connect(watcher, &QFutureWatcher<QVector<bool>>::finished, this, [this, watcher, items] {
+        auto results = watcher->result();
+        watcher->deleteLater();
+        applyBatch(items, results);
+    });
+    watcher->setFuture(m_work.run(Executors::io(), [operations] {
+        QVector<bool> results;
+        results.reserve(operations.size());
+        for (auto const& operation : operations)
+            results.append(operation());
+        return results;
+    }));
+}
 
-        // Preserve the row, but change its ID
-        auto old_id = resource->internal_id();
-        if (!resource->enable(action)) {
+void ResourceFolderModel::applyBatch(const QList<BatchItem>& items, const QVector<bool>& results)
+{
+    bool succeeded = true;
+    int first_changed = -1;
+    int last_changed = -1;
+    QList<int> removed_rows;
+    for (int i = 0; i < items.size(); i++) {
+        auto const& item = items.at(i);
+        if (!results.at(i)) {
             succeeded = false;
             continue;
         }
 
-        auto new_id = resource->internal_id();
+        // an update that ran before the batch was started may have moved the resource around already
+        auto row = m_resources_index.value(item.old_id, -1);
+        if (row < 0 || m_resources.at(row) != item.resource)
+            continue;
+
+        if (item.new_path.isEmpty()) {
+            removed_rows.append(row);
+            continue;
+        }
+
+        item.resource->setEnabledFile(item.new_path);
+        auto new_id = item.resource->internal_id();
         if (m_resources_index.contains(new_id)) {
             // FIXME: https://github.com/PolyMC/PolyMC/issues/550
         }
-
-        m_resources_index.remove(old_id);
+        m_resources_index.remove(item.old_id);
         m_resources_index[new_id] = row;
 
-        emit dataChanged(index(row, 0), index(row, columnCount(QModelIndex()) - 1));
+        first_changed = first_changed < 0 ? row : qMin(first_changed, row);
+        last_changed = qMax(last_changed, row);
+    }
+
+    if (first_changed >= 0)
+        emit dataChanged(index(first_changed, 0), index(last_changed, columnCount(QModelIndex()) - 1));
+
+    if (!removed_rows.isEmpty())
+        removeResourceRows(removed_rows);
+    // the renamed ones have other file names, the rows after the removed ones moved
+    if (first_changed >= 0 || !removed_rows.isEmpty())
+        rebuildIndexes();
+
+    // the model is as it would be after a scan, unless something else changed the folder too
+    if (m_batch_up_to_date)
+        m_scanned_state = folderState();
+    else if (m_is_watching)
+        m_scheduled_update = true;
+
+    m_batch_running = false;
+    if (!m_pending_batches.isEmpty()) {
+        runNextBatch();
+    } else {
+        if (m_is_watching && !m_suspended_paths.isEmpty())
+            m_watcher.addPaths(m_suspended_paths);
+        m_suspended_paths.clear();
+        // an update asked for while the files were changing
+        if (m_scheduled_update && !m_current_update_task) {
+            m_scheduled_update = false;
+            update();
+        }
+    }
+
+    emit batchFinished(succeeded);
+}
+
+void ResourceFolderModel::removeResourceRows(QList<int> rows)
+{
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+
+    for (auto& removed_index : rows) {
+        auto const& removed = m_resources.at(removed_index);
+        if (removed->isResolving()) {
+            auto ticket = removed->resolutionTicket();
+            if (m_active_parse_tasks.contains(ticket)) {
+                auto task = (*m_active_parse_tasks.find(ticket)).get();
+                task->abort();
+            }
+        }
     }
 
-    return succeeded;
+    // remove contiguous rows in one go, so views don't have to relayout once per removed resource
+    for (int i = 0; i < rows.size();) {
+        int last = rows.at(i);
+        int first = last;
+        for (i++; i < rows.size() && rows.at(i) == first - 1; i++)
+            first--;
+
+        beginRemoveRows(QModelIndex(), first, last);
+        m_resources.erase(m_resources.begin() + first, m_resources.begin() + last + 1);
+        endRemoveRows();
+    }
 }
 
 static QMutex s_update_task_mutex;
@@ -233,8 +406,8 @@ bool ResourceFolderModel::update()
     // We hold a lock here to prevent race conditions on the m_current_update_task reset.
     QMutexLocker lock(&s_update_task_mutex);
 
-    // Already updating, so we schedule a future update and return.
-    if (m_current_update_task) {
+    // Already updating, or a batch is changing the files, so we schedule a future update and return.
+    if (m_current_update_task || m_batch_running) {
         m_scheduled_update = true;
         return false;
     }
@@ -243,6 +416,13 @@ bool ResourceFolderModel::update()
     if (!m_current_update_task)
         return false;
 
+    // taken before the scan, so whatever changes while it runs is seen as a change next time
+    m_scanning_state = folderState();
+    connect(m_current_update_task.get(), &Task::succeeded, this, [this] {
+        m_scanned_state = m_scanning_state;
+        m_has_scanned = true;
+    }, Qt::ConnectionType::QueuedConnection);
+    connect(m_current_update_task.get(), &Task::failed, this, [this] { m_has_scanned = false; }, Qt::ConnectionType::QueuedConnection);
     connect(m_current_update_task.get(), &Task::succeeded, this, &ResourceFolderModel::onUpdateSucceeded,
             Qt::ConnectionType::QueuedConnection);
     connect(m_current_update_task.get(), &Task::failed, this, &ResourceFolderModel::onUpdateFailed, Qt::ConnectionType::QueuedConnection);
@@ -256,11 +436,35 @@ bool ResourceFolderModel::update()
         }
     }, Qt::ConnectionType::QueuedConnection);
 
-    QThreadPool::globalInstance()->start(m_current_update_task.get());
+    m_work.start(Executors::io(), m_current_update_task.get());
 
     return true;
 }
 
+bool ResourceFolderModel::isUpToDate() const
+{
+    return m_has_scanned && !m_current_update_task && folderState() == m_scanned_state;
+}
+
+bool ResourceFolderModel::updateIfChanged()
+{
+    if (isUpToDate())
+        return false;
+    return update();
+}
+
+auto ResourceFolderModel::folderState() const -> FolderState
+{
+    FolderState state;
+    for (auto const& dir : scannedDirs()) {
+        // a directory that doesn't exist is a state too, it has no entries and no time
+        state.insert(dir.absolutePath(), QFileInfo(dir.absolutePath()).lastModified().toMSecsSinceEpoch());
+        for (auto const& entry : dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System))
+            state.insert(entry.absoluteFilePath(), entry.lastModified().toMSecsSinceEpoch());
+    }
+    return state;
+}
+
 void ResourceFolderModel::resolveResource(Resource* res)
 {
     if (!res->shouldResolve()) {
@@ -276,17 +480,19 @@ void ResourceFolderModel::resolveResource(Resource* res)
     res->setResolving(true, ticket);
     m_active_parse_tasks.insert(ticket, task);
 
+    // by the time the results arrive, the resource may have been replaced or the model gone, which only drops them
+    auto resource_id = res->internal_id();
     connect(
-        task.get(), &Task::succeeded, this, [=] { onParseSucceeded(ticket, res->internal_id()); }, Qt::ConnectionType::QueuedConnection);
+        task.get(), &Task::succeeded, this, [=] { onParseSucceeded(ticket, resource_id); }, Qt::ConnectionType::QueuedConnection);
     connect(
-        task.get(), &Task::failed, this, [=] { onParseFailed(ticket, res->internal_id()); }, Qt::ConnectionType::QueuedConnection);
+        task.get(), &Task::failed, this, [=] { onParseFailed(ticket, resource_id); }, Qt::ConnectionType::QueuedConnection);
     connect(
         task.get(), &Task::finished, this, [=] { m_active_parse_tasks.remove(ticket); }, Qt::ConnectionType::QueuedConnection);
 
     m_helper_thread_task.addTask(task);
 
     if (!m_helper_thread_task.isRunning()) {
-        QThreadPool::globalInstance()->start(&m_helper_thread_task);
+        m_work.start(Executors::cpu(), &m_helper_thread_task);
     }
 }
 
@@ -316,7 +522,9 @@ void ResourceFolderModel::onParseSucceeded(int ticket, QString resource_id)
     if (iter == m_active_parse_tasks.constEnd())
         return;
 
-    int row = m_resources_index[resource_id];
+    int row = m_resources_index.value(resource_id, -1);
+    if (row < 0)
+        return;
     emit dataChanged(index(row), index(row, columnCount(QModelIndex()) - 1));
 }
 
@@ -332,6 +540,7 @@ bool ResourceFolderModel::hasPendingParseTasks() const
 
 void ResourceFolderModel::directoryChanged(QString path)
 {
+    // the watcher only reports once things settle down
     update();
 }
 
@@ -522,15 +731,56 @@ void ResourceFolderModel::enableInteraction(bool enabled)
 }
 
 /* Standard Proxy Model for createFilterProxyModel */
+void ResourceFolderModel::ProxyModel::setSourceModel(QAbstractItemModel* source_model)
+{
+    if (sourceModel())
+        sourceModel()->disconnect(this);
+    forgetMatches();
+
+    // rows that moved or changed may not match like they did. These are connected first so they run before the proxy
+    // filters the rows again.
+    if (source_model) {
+        connect(source_model, &QAbstractItemModel::rowsInserted, this, &ProxyModel::forgetMatches);
+        connect(source_model, &QAbstractItemModel::rowsRemoved, this, &ProxyModel::forgetMatches);
+        connect(source_model, &QAbstractItemModel::rowsMoved, this, &ProxyModel::forgetMatches);
+        connect(source_model, &QAbstractItemModel::dataChanged, this, &ProxyModel::forgetMatches);
+        connect(source_model, &QAbstractItemModel::layoutChanged, this, &ProxyModel::forgetMatches);
+        connect(source_model, &QAbstractItemModel::modelReset, this, &ProxyModel::forgetMatches);
+    }
+
+    QSortFilterProxyModel::setSourceModel(source_model);
+}
+
 [[nodiscard]] bool ResourceFolderModel::ProxyModel::filterAcceptsRow(int source_row, const QModelIndex& source_parent) const
 {
     auto* model = qobject_cast<ResourceFolderModel*>(sourceModel());
     if (!model)
         return true;
 
+    auto filter = filterRegularExpression();
+    if (filter != m_filter) {
+        // a new filter, all the rows are going to be tried with it
+        static const QRegularExpression s_special(QStringLiteral(R"([\\^$.|?*+()\[\]{}])"));
+        auto sensitivity = filter.patternOptions().testFlag(QRegularExpression::CaseInsensitiveOption) ? Qt::CaseInsensitive
+                                                                                                         : Qt::CaseSensitive;
+        m_narrowing = m_matches_valid && filter.patternOptions() == m_filter.patternOptions() && !m_filter.pattern().isEmpty() &&
+                      !filter.pattern().contains(s_special) && !m_filter.pattern().contains(s_special) &&
+                      filter.pattern().contains(m_filter.pattern(), sensitivity);
+        m_previous_matches.swap(m_matches);
+        m_matches.clear();
+        m_filter = filter;
+        m_matches_valid = true;
+    }
+
+    if (m_narrowing && !m_previous_matches.contains(source_row))
+        return false;
+
     const auto& resource = model->at(source_row);
 
-    return resource.applyFilter(filterRegularExpression());
+    bool accepted = resource.applyFilter(filter);
+    if (accepted)
+        m_matches.insert(source_row);
+    return accepted;
 }
 
 [[nodiscard]] bool ResourceFolderModel::ProxyModel::lessThan(const QModelIndex& source_left, const QModelIndex& source_right) const
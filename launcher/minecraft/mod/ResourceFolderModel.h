@@ -1,12 +1,17 @@
 #pragma once
 
+#include <functional>
+
 #include <QAbstractListModel>
 #include <QDir>
-#include <QFileSystemWatcher>
+#include <QHash>
 #include <QMutex>
 #include <QSet>
 #include <QSortFilterProxyModel>
+#include <QTimer>
 
+#include "Executors.h"
+#include "FileWatcher.h"
 #include "Resource.h"
 
 #include "BaseInstance.h"
@@ -59,17 +64,33 @@ class ResourceFolderModel : public QAbstractListModel {
      *  Returns whether the removal was successful.
      */
     virtual bool uninstallResource(QString file_name);
+
+    /** Deletes the resources in 'indexes', as one batch (see batchFinished()).
+     *
+     *  Returns whether the batch was started.
+     */
     virtual bool deleteResources(const QModelIndexList&);
 
-    /** Applies the given 'action' to the resources in 'indexes'.
+    /** Applies the given 'action' to the resources in 'indexes', as one batch (see batchFinished()).
      *
-     *  Returns whether the action was successfully applied to all resources.
+     *  Returns whether the batch was started.
      */
     virtual bool setResourceEnabled(const QModelIndexList& indexes, EnableAction action);
 
+    /** Whether a batch of renames or deletions is being done, or waiting for one to finish. */
+    [[nodiscard]] bool hasPendingBatches() const { return m_batch_running || !m_pending_batches.isEmpty(); }
+
     /** Creates a new update task and start it. Returns false if no update was done, like when an update is already underway. */
     virtual bool update();
 
+    /** Whether nothing in the folder changed since the last successful update, going by what is in it and when it was changed.
+     *
+     *  This only looks at the directory listing, it's cheap compared to an update.
+     */
+    [[nodiscard]] bool isUpToDate() const;
+    /** Like update(), but doesn't do anything when the model is up to date already. */
+    bool updateIfChanged();
+
     /** Creates a new parse task, if needed, for 'res' and start it.*/
     virtual void resolveResource(Resource* res);
 
@@ -79,6 +100,9 @@ class ResourceFolderModel : public QAbstractListModel {
     [[nodiscard]] Resource const& at(int index) const { return *m_resources.at(index); }
     [[nodiscard]] QList<Resource::Ptr> const& all() const { return m_resources; }
 
+    /** The resource with the given file name (not path), looked up in an index kept along with the rows. */
+    [[nodiscard]] Resource* findByFileName(const QString& file_name) const;
+
     [[nodiscard]] QDir const& dir() const { return m_dir; }
 
     /** Checks whether there's any parse tasks being done.
@@ -118,13 +142,35 @@ class ResourceFolderModel : public QAbstractListModel {
 
     [[nodiscard]] SortType columnToSortKey(size_t column) const;
 
+    /* Sorts with Resource::compare and filters with Resource::applyFilter.
+     *
+     * While a plain text filter only grows, like it does when typing it, the rows the shorter one filtered out can't
+     * match either, so only the ones it let through are tried again. Any change in the rows starts over.
+     */
     class ProxyModel : public QSortFilterProxyModel {
        public:
         explicit ProxyModel(QObject* parent = nullptr) : QSortFilterProxyModel(parent) {}
 
+        void setSourceModel(QAbstractItemModel* source_model) override;
+
        protected:
         [[nodiscard]] bool filterAcceptsRow(int source_row, const QModelIndex& source_parent) const override;
         [[nodiscard]] bool lessThan(const QModelIndex& source_left, const QModelIndex& source_right) const override;
+
+       private:
+        void forgetMatches()
+        {
+            m_matches_valid = false;
+            m_narrowing = false;
+        }
+
+       private:
+        // the filter the matches are of, and the rows that matched it
+        mutable QRegularExpression m_filter;
+        mutable QSet<int> m_matches;
+        mutable QSet<int> m_previous_matches;
+        mutable bool m_matches_valid = false;
+        mutable bool m_narrowing = false;
     };
 
     QString instDirPath() const;
@@ -136,6 +182,9 @@ class ResourceFolderModel : public QAbstractListModel {
    signals:
     void updateFinished();
 
+    /** Emitted when the files of a batch were renamed or deleted and the model reflects it, 'succeeded' if all of them were. */
+    void batchFinished(bool succeeded);
+
    protected:
     /** This creates a new update task to be executed by update().
      *
@@ -163,6 +212,21 @@ class ResourceFolderModel : public QAbstractListModel {
     template <typename T>
     void applyUpdates(QSet<QString>& current_set, QSet<QString>& new_set, QMap<QString, T>& new_resources);
 
+    /** The directories the update task reads, only a change in those makes another update necessary. */
+    [[nodiscard]] virtual QList<QDir> scannedDirs() const { return { m_dir }; }
+
+    /** What deleting 'resource' does on disk, run on a worker thread as part of a batch.
+     *
+     *  It is made on the main thread, so anything it needs from the resource has to be copied into it.
+     */
+    [[nodiscard]] virtual std::function<bool()> deleteOperation(Resource& resource);
+
+    /** Removes the given rows, aborting their parse tasks. Contiguous rows go in one go, so views don't relayout once per row. */
+    void removeResourceRows(QList<int> rows);
+
+    /** Indexes the resources again once the rows changed. Subclasses index more of them by overriding it. */
+    virtual void rebuildIndexes();
+
    protected slots:
     void directoryChanged(QString);
 
@@ -192,20 +256,49 @@ class ResourceFolderModel : public QAbstractListModel {
 
     QDir m_dir;
     BaseInstance* m_instance;
-    QFileSystemWatcher m_watcher;
+    // coalesces bursts of directory changes (e.g. copying a lot of files at once) into a single update
+    FileWatcher m_watcher;
     bool m_is_watching = false;
 
     Task::Ptr m_current_update_task = nullptr;
     bool m_scheduled_update = false;
 
+    // the modification times of the scanned directories and their entries, by path
+    using FolderState = QHash<QString, qint64>;
+    [[nodiscard]] FolderState folderState() const;
+    // what the folder looked like when the last successful update started, and when the current one started
+    FolderState m_scanned_state;
+    FolderState m_scanning_state;
+    bool m_has_scanned = false;
+
+    // renames and deletions many resources at a time, done on a worker thread one batch after the other
+    struct BatchItem {
+        Resource::Ptr resource;
+        QString old_id;
+        QString new_path;  // empty when deleting
+        std::function<bool()> operation;
+    };
+    void startBatch(QList<BatchItem> items);
+    void runNextBatch();
+    void applyBatch(const QList<BatchItem>& items, const QVector<bool>& results);
+    QList<QList<BatchItem>> m_pending_batches;
+    bool m_batch_running = false;
+    bool m_batch_up_to_date = false;
+    QStringList m_suspended_paths;
+
     QList<Resource::Ptr> m_resources;
 
     // Represents the relationship between a resource's internal ID and it's row position on the model.
     QMap<QString, int> m_resources_index;
+    // and between their file names and their rows
+    QHash<QString, int> m_file_name_index;
 
     ConcurrentTask m_helper_thread_task;
     QMap<int, Task::Ptr> m_active_parse_tasks;
     std::atomic<int> m_next_resolution_ticket = 0;
+
+    // what the model runs off the GUI thread, it's only that its teardown waits for
+    Executors::WorkGroup m_work;
 };
 
 /* A macro to define useful functions to handle Resource* -> T* more easily on derived classes */
@@ -232,11 +325,10 @@ class ResourceFolderModel : public QAbstractListModel {
     }                                                                                             \
     [[nodiscard]] T* find(QString id)                                                             \
     {                                                                                             \
-        auto iter = std::find_if(m_resources.constBegin(), m_resources.constEnd(),                \
-                                 [&](Resource::Ptr const& r) { return r->internal_id() == id; }); \
-        if (iter == m_resources.constEnd())                                                       \
+        auto row = m_resources_index.value(id, -1);                                               \
+        if (row < 0)                                                                              \
             return nullptr;                                                                       \
-        return static_cast<T*>((*iter).get());                                                    \
+        return static_cast<T*>(m_resources[row].get());                                           \
     }
 
 /* Template definition to avoid some code duplication */
@@ -286,26 +378,7 @@ void ResourceFolderModel::applyUpdates(QSet<QString>& current_set, QSet<QString>
         for (auto& removed : removed_set)
             removed_rows.append(m_resources_index[removed]);
 
-        std::sort(removed_rows.begin(), removed_rows.end(), std::greater<int>());
-
-        for (auto& removed_index : removed_rows) {
-            auto removed_it = m_resources.begin() + removed_index;
-
-            Q_ASSERT(removed_it != m_resources.end());
-            Q_ASSERT(removed_set.contains(removed_it->get()->internal_id()));
-
-            if ((*removed_it)->isResolving()) {
-                auto ticket = (*removed_it)->resolutionTicket();
-                if (m_active_parse_tasks.contains(ticket)) {
-                    auto task = (*m_active_parse_tasks.find(ticket)).get();
-                    task->abort();
-                }
-            }
-
-            beginRemoveRows(QModelIndex(), removed_index, removed_index);
-            m_resources.erase(removed_it);
-            endRemoveRows();
-        }
+        removeResourceRows(removed_rows);
     }
 
     // add new resources to the end
@@ -327,13 +400,5 @@ void ResourceFolderModel::applyUpdates(QSet<QString>& current_set, QSet<QString>
         }
     }
 
-    // update index
-    {
-        m_resources_index.clear();
-        int idx = 0;
-        for (auto const& mod : qAsConst(m_resources)) {
-            m_resources_index[mod->internal_id()] = idx;
-            idx++;
-        }
-    }
+    rebuildIndexes();
 }
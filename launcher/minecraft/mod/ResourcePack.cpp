@@ -5,11 +5,10 @@
 #include <QMap>
 #include <QRegularExpression>
 
-#include "MTPixmapCache.h"
+#include "ImageCache.h"
+#include "StringPool.h"
 #include "Version.h"
 
-#include "minecraft/mod/tasks/LocalResourcePackParseTask.h"
-
 // Values taken from:
 // https://minecraft.fandom.com/wiki/Tutorials/Creating_a_resource_pack#Formatting_pack.mcmeta
 static const QMap<int, std::pair<Version, Version>> s_pack_format_versions = {
@@ -37,7 +36,7 @@ void ResourcePack::setDescription(QString new_description)
 {
     QMutexLocker locker(&m_data_lock);
 
-    m_description = new_description;
+    m_description = StringPool::instance().intern(new_description);
 }
 
 void ResourcePack::setImage(QImage new_image)
@@ -46,35 +45,54 @@ void ResourcePack::setImage(QImage new_image)
 
     Q_ASSERT(!new_image.isNull());
 
-    if (m_pack_image_cache_key.key.isValid())
-        PixmapCache::instance().remove(m_pack_image_cache_key.key);
+    // this is called from the thread pool once the icon got decoded, the image becomes a pixmap only when it's shown
+    if (m_pack_image_cache_key)
+        ImageCache::instance().remove(m_pack_image_cache_key);
 
-    m_pack_image_cache_key.key = PixmapCache::instance().insert(QPixmap::fromImage(new_image));
-    m_pack_image_cache_key.was_ever_used = true;
+    m_pack_image_cache_key = ImageCache::instance().insert(new_image);
 
-    // This can happen if the pixmap is too big to fit in the cache :c
-    if (!m_pack_image_cache_key.key.isValid()) {
+    // This can happen if the image is too big to fit in the cache :c
+    if (!m_pack_image_cache_key)
         qWarning() << "Could not insert a image cache entry! Ignoring it.";
-        m_pack_image_cache_key.was_ever_used = false;
-    }
+}
+
+void ResourcePack::setIcon(PackIcon new_icon)
+{
+    QMutexLocker locker(&m_data_lock);
+
+    m_icon = new_icon;
+}
+
+PackIcon ResourcePack::icon() const
+{
+    QMutexLocker locker(&m_data_lock);
+
+    return m_icon;
 }
 
 QPixmap ResourcePack::image(QSize size)
 {
     QPixmap cached_image;
-    if (PixmapCache::instance().find(m_pack_image_cache_key.key, &cached_image)) {
-        if (size.isNull())
-            return cached_image;
-        return cached_image.scaled(size);
-    }
+    if (ImageCache::instance().pixmap(m_pack_image_cache_key, size, &cached_image))
+        return cached_image;
 
-    // No valid image we can get
-    if (!m_pack_image_cache_key.was_ever_used)
+    // Not decoded yet, or evicted from the cache since.
+    auto pack_icon = icon();
+    if (!pack_icon.isValid() || m_icon_loading)
         return {};
 
-    // Imaged got evicted from the cache. Re-process it and retry.
-    ResourcePackUtils::process(*this);
-    return image(size);
+    m_icon_loading = true;
+    pack_icon.loadAsync(size, this, [this](QImage new_image) {
+        m_icon_loading = false;
+        if (new_image.isNull()) {
+            // don't try again each time it's shown
+            setIcon({});
+            return;
+        }
+        setImage(new_image);
+        emit imageChanged();
+    });
+    return {};
 }
 
 std::pair<Version, Version> ResourcePack::compatibleVersions() const
@@ -1,11 +1,12 @@
 #pragma once
 
+#include "ImageCache.h"
+#include "PackIcon.h"
 #include "Resource.h"
 
 #include <QImage>
 #include <QMutex>
 #include <QPixmap>
-#include <QPixmapCache>
 
 class Version;
 
@@ -30,9 +31,15 @@ class ResourcePack : public Resource {
     /** Gets the description of the resource pack. */
     [[nodiscard]] QString description() const { return m_description; }
 
-    /** Gets the image of the resource pack, converted to a QPixmap for drawing, and scaled to size. */
+    /**
+     * Gets the image of the resource pack, converted to a QPixmap for drawing, and scaled to size.
+     * It's null until the image got decoded in the background, imageChanged() is emitted once it is.
+     */
     [[nodiscard]] QPixmap image(QSize size);
 
+    /** Where the image of the resource pack is, invalid when it doesn't have one. */
+    [[nodiscard]] PackIcon icon() const;
+
     /** Thread-safe. */
     void setPackFormat(int new_format_id);
 
@@ -42,11 +49,17 @@ class ResourcePack : public Resource {
     /** Thread-safe. */
     void setImage(QImage new_image);
 
+    /** Thread-safe. */
+    void setIcon(PackIcon new_icon);
+
     bool valid() const override;
 
     [[nodiscard]] auto compare(Resource const& other, SortType type) const -> std::pair<int, bool> override;
     [[nodiscard]] bool applyFilter(QRegularExpression filter) const override;
 
+   signals:
+    void imageChanged();
+
    protected:
     mutable QMutex m_data_lock;
 
@@ -59,13 +72,10 @@ class ResourcePack : public Resource {
      */
     QString m_description;
 
-    /** The resource pack's image file cache key, for access in the QPixmapCache global instance.
-     *
-     *  The 'was_ever_used' state simply identifies whether the key was never inserted on the cache (true),
-     *  so as to tell whether a cache entry is inexistent or if it was just evicted from the cache.
+    /** The resource pack's image file cache key, for access in the ImageCache global instance. 0 until it's decoded.
      */
-    struct {
-        QPixmapCache::Key key;
-        bool was_ever_used = false;
-    } m_pack_image_cache_key;
+    ImageCache::Key m_pack_image_cache_key = 0;
+
+    PackIcon m_icon;
+    bool m_icon_loading = false;
 };
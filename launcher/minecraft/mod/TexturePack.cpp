@@ -23,13 +23,14 @@
 #include <QMap>
 #include <QRegularExpression>
 
-#include "minecraft/mod/tasks/LocalTexturePackParseTask.h"
+#include "ImageCache.h"
+#include "StringPool.h"
 
 void TexturePack::setDescription(QString new_description)
 {
     QMutexLocker locker(&m_data_lock);
 
-    m_description = new_description;
+    m_description = StringPool::instance().intern(new_description);
 }
 
 void TexturePack::setImage(QImage new_image)
@@ -38,29 +39,54 @@ void TexturePack::setImage(QImage new_image)
 
     Q_ASSERT(!new_image.isNull());
 
-    if (m_pack_image_cache_key.key.isValid())
-        QPixmapCache::remove(m_pack_image_cache_key.key);
+    // this is called from the thread pool once the icon got decoded, the image becomes a pixmap only when it's shown
+    if (m_pack_image_cache_key)
+        ImageCache::instance().remove(m_pack_image_cache_key);
 
-    m_pack_image_cache_key.key = QPixmapCache::insert(QPixmap::fromImage(new_image));
-    m_pack_image_cache_key.was_ever_used = true;
+    m_pack_image_cache_key = ImageCache::instance().insert(new_image);
+
+    // This can happen if the image is too big to fit in the cache :c
+    if (!m_pack_image_cache_key)
+        qWarning() << "Could not insert a image cache entry! Ignoring it.";
+}
+
+void TexturePack::setIcon(PackIcon new_icon)
+{
+    QMutexLocker locker(&m_data_lock);
+
+    m_icon = new_icon;
+}
+
+PackIcon TexturePack::icon() const
+{
+    QMutexLocker locker(&m_data_lock);
+
+    return m_icon;
 }
 
 QPixmap TexturePack::image(QSize size)
 {
     QPixmap cached_image;
-    if (QPixmapCache::find(m_pack_image_cache_key.key, &cached_image)) {
-        if (size.isNull())
-            return cached_image;
-        return cached_image.scaled(size);
-    }
-
-    // No valid image we can get
-    if (!m_pack_image_cache_key.was_ever_used)
+    if (ImageCache::instance().pixmap(m_pack_image_cache_key, size, &cached_image))
+        return cached_image;
+
+    // Not decoded yet, or evicted from the cache since.
+    auto pack_icon = icon();
+    if (!pack_icon.isValid() || m_icon_loading)
         return {};
 
-    // Imaged got evicted from the cache. Re-process it and retry.
-    TexturePackUtils::process(*this);
-    return image(size);
+    m_icon_loading = true;
+    pack_icon.loadAsync(size, this, [this](QImage new_image) {
+        m_icon_loading = false;
+        if (new_image.isNull()) {
+            // don't try again each time it's shown
+            setIcon({});
+            return;
+        }
+        setImage(new_image);
+        emit imageChanged();
+    });
+    return {};
 }
 
 bool TexturePack::valid() const
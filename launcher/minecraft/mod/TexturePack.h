@@ -19,12 +19,13 @@
 
 #pragma once
 
+#include "ImageCache.h"
+#include "PackIcon.h"
 #include "Resource.h"
 
 #include <QImage>
 #include <QMutex>
 #include <QPixmap>
-#include <QPixmapCache>
 
 class Version;
 
@@ -39,17 +40,29 @@ class TexturePack : public Resource {
     /** Gets the description of the texture pack. */
     [[nodiscard]] QString description() const { return m_description; }
 
-    /** Gets the image of the texture pack, converted to a QPixmap for drawing, and scaled to size. */
+    /**
+     * Gets the image of the texture pack, converted to a QPixmap for drawing, and scaled to size.
+     * It's null until the image got decoded in the background, imageChanged() is emitted once it is.
+     */
     [[nodiscard]] QPixmap image(QSize size);
 
+    /** Where the image of the texture pack is, invalid when it doesn't have one. */
+    [[nodiscard]] PackIcon icon() const;
+
     /** Thread-safe. */
     void setDescription(QString new_description);
 
     /** Thread-safe. */
     void setImage(QImage new_image);
 
+    /** Thread-safe. */
+    void setIcon(PackIcon new_icon);
+
     bool valid() const override;
 
+   signals:
+    void imageChanged();
+
    protected:
     mutable QMutex m_data_lock;
 
@@ -57,13 +70,10 @@ class TexturePack : public Resource {
      */
     QString m_description;
 
-    /** The texture pack's image file cache key, for access in the QPixmapCache global instance.
-     *
-     *  The 'was_ever_used' state simply identifies whether the key was never inserted on the cache (true),
-     *  so as to tell whether a cache entry is inexistent or if it was just evicted from the cache.
+    /** The texture pack's image file cache key, for access in the ImageCache global instance. 0 until it's decoded.
      */
-    struct {
-        QPixmapCache::Key key;
-        bool was_ever_used = false;
-    } m_pack_image_cache_key;
+    ImageCache::Key m_pack_image_cache_key = 0;
+
+    PackIcon m_icon;
+    bool m_icon_loading = false;
 };
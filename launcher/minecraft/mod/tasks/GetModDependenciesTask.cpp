@@ -0,0 +1,214 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "GetModDependenciesTask.h"
+
+#include <QDebug>
+
+#include "Application.h"
+#include "Json.h"
+#include "Version.h"
+
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+#include "minecraft/mod/Mod.h"
+#include "minecraft/mod/ModFolderModel.h"
+
+#include "modplatform/flame/FlameAPI.h"
+#include "modplatform/flame/FlameModIndex.h"
+#include "modplatform/modrinth/ModrinthAPI.h"
+#include "modplatform/modrinth/ModrinthPackIndex.h"
+
+static ModPlatform::ProviderCapabilities ProviderCaps;
+
+static ModrinthAPI modrinth_api;
+static FlameAPI flame_api;
+
+namespace {
+// how many dependencies of a level are looked up at the same time
+constexpr int s_max_concurrent = 6;
+
+auto apiFor(ModPlatform::ResourceProvider provider) -> ResourceAPI*
+{
+    switch (provider) {
+        case ModPlatform::ResourceProvider::MODRINTH:
+            return &modrinth_api;
+        case ModPlatform::ResourceProvider::FLAME:
+            return &flame_api;
+    }
+    return nullptr;
+}
+}  // namespace
+
+GetModDependenciesTask::GetModDependenciesTask(BaseInstance* instance,
+                                               std::shared_ptr<ModFolderModel> folder,
+                                               QList<PackDependency> selected)
+    : m_instance(instance), m_selected(selected)
+{
+    for (auto mod : folder->allMods()) {
+        auto metadata = mod->metadata();
+        if (!metadata)
+            continue;
+        m_known.insert(key(metadata->provider, metadata->project_id));
+        if (!metadata->hash.isEmpty())
+            m_installed_hashes.insert(metadata->hash_format + ':' + metadata->hash);
+    }
+    for (auto& pack : m_selected)
+        m_known.insert(key(pack.pack->provider, pack.pack->addonId));
+}
+
+auto GetModDependenciesTask::key(ModPlatform::ResourceProvider provider, const QVariant& addonId) -> QString
+{
+    return QString("%1:%2").arg(ProviderCaps.name(provider), addonId.toString());
+}
+
+bool GetModDependenciesTask::abort()
+{
+    if (m_current_task)
+        m_current_task->abort();
+    emitAborted();
+    return true;
+}
+
+void GetModDependenciesTask::executeTask()
+{
+    setStatus(tr("Looking for the dependencies of the selected mods..."));
+    for (auto& pack : m_selected)
+        queueDependencies(pack);
+    lookUpNextLevel();
+}
+
+void GetModDependenciesTask::queueDependencies(const PackDependency& of)
+{
+    for (auto& dependency : of.version.dependencies) {
+        if (dependency.type != ModPlatform::DependencyType::REQUIRED)
+            continue;
+        // Modrinth may only name the version of the dependency, there's no project to look up then
+        if (dependency.addonId.toString().isEmpty() || dependency.addonId.toString() == "0")
+            continue;
+
+        auto dependency_key = key(of.pack->provider, dependency.addonId);
+        if (m_known.contains(dependency_key))
+            continue;
+        m_known.insert(dependency_key);
+
+        auto pending = std::make_shared<PackDependency>();
+        pending->pack = std::make_shared<ModPlatform::IndexedPack>();
+        pending->pack->addonId = dependency.addonId;
+        pending->pack->provider = of.pack->provider;
+        pending->pack->name = dependency.addonId.toString();
+        pending->version.fileId = dependency.version;
+        pending->required_by = of.pack->name;
+        m_pending.append(pending);
+    }
+}
+
+void GetModDependenciesTask::lookUpNextLevel()
+{
+    if (m_pending.isEmpty()) {
+        emitSucceeded();
+        return;
+    }
+
+    auto level = m_pending;
+    m_pending.clear();
+
+    auto task = makeShared<ConcurrentTask>(nullptr, tr("Looking up dependencies"), s_max_concurrent);
+    for (auto& dependency : level) {
+        if (auto lookup = lookUpTask(dependency))
+            task->addTask(lookup);
+    }
+
+    connect(task.get(), &Task::progress, this, &GetModDependenciesTask::setProgress);
+    connect(task.get(), &Task::finished, this, [this, level] {
+        m_current_task = nullptr;
+        if (!isRunning())
+            return;
+
+        for (auto& dependency : level) {
+            if (!dependency->version.downloadUrl.isEmpty() && !isInstalled(dependency->version)) {
+                m_dependencies.append(*dependency);
+                queueDependencies(*dependency);
+            } else if (dependency->version.downloadUrl.isEmpty()) {
+                qWarning() << "No version of" << dependency->pack->name << "fits the instance, it's required by"
+                           << dependency->required_by;
+            }
+        }
+        lookUpNextLevel();
+    });
+
+    m_current_task = task;
+    task->start();
+}
+
+auto GetModDependenciesTask::lookUpTask(Pending dependency) -> Task::Ptr
+{
+    auto api = apiFor(dependency->pack->provider);
+    auto profile = static_cast<MinecraftInstance*>(m_instance)->getPackProfile();
+    auto mc_version = profile->getComponentVersion("net.minecraft");
+    auto provider = dependency->pack->provider;
+    auto instance = m_instance;
+
+    auto task = makeShared<ConcurrentTask>(nullptr, dependency->pack->name, 2);
+
+    ResourceAPI::ProjectInfoCallbacks info_callbacks;
+    info_callbacks.on_succeed = [dependency, provider](QJsonDocument& doc, ModPlatform::IndexedPack) {
+        try {
+            auto obj = provider == ModPlatform::ResourceProvider::FLAME ? Json::requireObject(doc.object(), "data") : doc.object();
+            if (provider == ModPlatform::ResourceProvider::FLAME)
+                FlameMod::loadIndexedPack(*dependency->pack, obj);
+            else
+                Modrinth::loadIndexedPack(*dependency->pack, obj);
+        } catch (const Json::JsonException& e) {
+            qWarning() << "Failed to parse the project of the dependency" << dependency->pack->addonId << ":" << e.cause();
+        }
+    };
+    if (auto info_task = api->getProjectInfo({ *dependency->pack }, std::move(info_callbacks)))
+        task->addTask(info_task);
+
+    ResourceAPI::VersionSearchCallbacks version_callbacks;
+    version_callbacks.on_succeed = [dependency, provider, instance, mc_version](QJsonDocument& doc, ModPlatform::IndexedPack) {
+        // until now, the version the dependency is pinned to is all that is known of its version
+        auto pinned = dependency->version.fileId;
+        ModPlatform::IndexedPack versions;
+        versions.addonId = dependency->pack->addonId;
+        try {
+            if (provider == ModPlatform::ResourceProvider::FLAME) {
+                auto arr = Json::requireArray(doc.object(), "data");
+                FlameMod::loadIndexedPackVersions(versions, arr, APPLICATION->network(), instance);
+            } else {
+                auto arr = Json::requireArray(doc);
+                Modrinth::loadIndexedPackVersions(versions, arr, APPLICATION->network(), instance);
+            }
+        } catch (const Json::JsonException& e) {
+            qWarning() << "Failed to parse the versions of the dependency" << dependency->pack->addonId << ":" << e.cause();
+            return;
+        }
+
+        // newest first, so the first that fits is the newest
+        std::optional<ModPlatform::IndexedVersion> chosen;
+        for (auto& version : versions.versions) {
+            if (!version.mcVersion.contains(mc_version) || version.downloadUrl.isEmpty())
+                continue;
+            if (pinned.isValid() && version.fileId == pinned) {
+                chosen = version;
+                break;
+            }
+            if (!chosen)
+                chosen = version;
+        }
+        if (chosen)
+            dependency->version = *chosen;
+        else
+            dependency->version = {};
+    };
+    std::optional<std::list<Version>> mc_versions = std::list<Version>{ Version(mc_version) };
+    if (auto versions_task = api->getProjectVersions({ *dependency->pack, mc_versions, profile->getModLoaders() }, std::move(version_callbacks)))
+        task->addTask(versions_task);
+
+    return task;
+}
+
+auto GetModDependenciesTask::isInstalled(const ModPlatform::IndexedVersion& version) const -> bool
+{
+    return !version.hash.isEmpty() && m_installed_hashes.contains(version.hash_type + ':' + version.hash);
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QList>
+#include <QSet>
+#include <QString>
+
+#include <memory>
+
+#include "modplatform/ModIndex.h"
+#include "tasks/ConcurrentTask.h"
+
+class BaseInstance;
+class ModFolderModel;
+
+/* Finds the required dependencies of the mods selected for download, and of their dependencies in turn.
+ *
+ * The dependencies are looked up a level at a time, all of a level at once: each one gets its project and the versions
+ * that fit the instance, and the newest of them (or the one it's pinned to) is the one that gets downloaded. Mods that
+ * are installed already, by their project or by the hash of the file, aren't looked up again, and neither are the ones
+ * that are selected or were found on an earlier level.
+ */
+class GetModDependenciesTask : public Task {
+    Q_OBJECT
+   public:
+    using Ptr = shared_qobject_ptr<GetModDependenciesTask>;
+
+    struct PackDependency {
+        ModPlatform::IndexedPack::Ptr pack;
+        ModPlatform::IndexedVersion version;
+        // the name of the mod it's a dependency of
+        QString required_by;
+    };
+
+    GetModDependenciesTask(BaseInstance* instance, std::shared_ptr<ModFolderModel> folder, QList<PackDependency> selected);
+
+    /** The dependencies that have to be downloaded with the selection, once it succeeded. */
+    auto getDependencies() const -> QList<PackDependency> { return m_dependencies; }
+
+    auto canAbort() const -> bool override { return true; }
+    auto abort() -> bool override;
+
+   protected slots:
+    void executeTask() override;
+
+   private:
+    using Pending = std::shared_ptr<PackDependency>;
+
+    void lookUpNextLevel();
+    auto lookUpTask(Pending dependency) -> Task::Ptr;
+    void queueDependencies(const PackDependency& of);
+    auto isInstalled(const ModPlatform::IndexedVersion& version) const -> bool;
+
+    static auto key(ModPlatform::ResourceProvider provider, const QVariant& addonId) -> QString;
+
+   private:
+    BaseInstance* m_instance;
+    QList<PackDependency> m_selected;
+
+    // the projects that are installed, selected or already looked up
+    QSet<QString> m_known;
+    QSet<QString> m_installed_hashes;
+
+    QList<Pending> m_pending;
+    QList<PackDependency> m_dependencies;
+    ConcurrentTask::Ptr m_current_task;
+};
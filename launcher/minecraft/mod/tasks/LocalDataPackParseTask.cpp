@@ -21,13 +21,10 @@
 
 #include "LocalDataPackParseTask.h"
 
+#include "ArchiveReader.h"
 #include "FileSystem.h"
 #include "Json.h"
 
-#include <quazip/quazip.h>
-#include <quazip/quazipdir.h>
-#include <quazip/quazipfile.h>
-
 #include <QCryptographicHash>
 
 namespace DataPackUtils {
@@ -88,48 +85,38 @@ bool processZIP(DataPack& pack, ProcessingLevel level)
 {
     Q_ASSERT(pack.type() == ResourceType::ZIPFILE);
 
-    QuaZip zip(pack.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    MMCZip::ArchiveReader zip(pack.fileinfo().filePath());
+    if (!zip.open())
         return false;  // can't open zip file
 
-    QuaZipFile file(&zip);
-
     auto mcmeta_invalid = [&pack]() {
         qWarning() << "Data pack at" << pack.fileinfo().filePath() << "does not have a valid pack.mcmeta";
         return false;  // the mcmeta is not optional
     };
 
-    if (zip.setCurrentFile("pack.mcmeta")) {
-        if (!file.open(QIODevice::ReadOnly)) {
+    if (zip.contains("pack.mcmeta")) {
+        auto data = zip.read("pack.mcmeta");
+        if (!data) {
             qCritical() << "Failed to open file in zip.";
-            zip.close();
             return mcmeta_invalid();
         }
 
-        auto data = file.readAll();
-
-        bool mcmeta_result = DataPackUtils::processMCMeta(pack, std::move(data));
-
-        file.close();
+        bool mcmeta_result = DataPackUtils::processMCMeta(pack, std::move(*data));
         if (!mcmeta_result) {
             return mcmeta_invalid();  // mcmeta invalid
         }
     } else {
-        return mcmeta_invalid();  // could not set pack.mcmeta as current file.
+        return mcmeta_invalid();  // could not find pack.mcmeta.
     }
 
-    QuaZipDir zipDir(&zip);
-    if (!zipDir.exists("/data")) {
+    if (!zip.containsDir("data")) {
         return false;  // data dir does not exists at zip root
     }
 
     if (level == ProcessingLevel::BasicInfoOnly) {
-        zip.close();
         return true;  // only need basic info already checked
     }
 
-    zip.close();
-
     return true;
 }
 
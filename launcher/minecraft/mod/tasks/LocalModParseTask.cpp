@@ -1,7 +1,5 @@
 #include "LocalModParseTask.h"
 
-#include <quazip/quazip.h>
-#include <quazip/quazipfile.h>
 #include <toml++/toml.h>
 #include <qdcss.h>
 #include <QJsonArray>
@@ -10,13 +8,48 @@
 #include <QJsonValue>
 #include <QString>
 
+#include "ArchiveReader.h"
 #include "FileSystem.h"
 #include "Json.h"
 #include "minecraft/mod/ModDetails.h"
+#include "minecraft/mod/ModDetailsCache.h"
 #include "settings/INIFile.h"
 
 namespace ModUtils {
 
+// paths in the metadata are from the root of the mod file, some have a leading slash anyway
+static QString iconPath(QString path)
+{
+    while (path.startsWith('/'))
+        path.remove(0, 1);
+    return path;
+}
+
+// fabric and quilt take either a path, or an object of paths by the width of the icon
+static QString chooseIcon(const QJsonValue& icon)
+{
+    if (icon.isString())
+        return iconPath(icon.toString());
+
+    // the smallest one that's still good for the mod list, and the biggest one when they're all smaller
+    constexpr int wanted = 32;
+    auto icons = icon.toObject();
+    int chosen = -1;
+    QString path;
+    for (auto it = icons.constBegin(); it != icons.constEnd(); ++it) {
+        bool ok = false;
+        int width = it.key().toInt(&ok);
+        if (!ok || !it.value().isString())
+            continue;
+        bool better = chosen < 0 || (width >= wanted ? chosen < wanted || width < chosen : chosen < wanted && width > chosen);
+        if (better) {
+            chosen = width;
+            path = it.value().toString();
+        }
+    }
+    return iconPath(path);
+}
+
 // NEW format
 // https://github.com/MinecraftForge/FML/wiki/FML-mod-information-file/c8d8f1929aff9979e322af79a59ce81f3e02db6a
 
@@ -55,6 +88,7 @@ ModDetails ReadMCModInfo(QByteArray contents)
         for (auto author : authors) {
             details.authors.append(author.toString());
         }
+        details.icon_path = iconPath(firstObj.value("logoFile").toString());
         return details;
     };
     QJsonParseError jsonError;
@@ -166,6 +200,12 @@ ModDetails ReadMCModTOML(QByteArray contents)
     }
     details.homeurl = homeurl;
 
+    if (auto logoDatum = (*modsTable)["logoFile"].as_string()) {
+        details.icon_path = iconPath(QString::fromStdString(logoDatum->get()));
+    } else if (auto logoDatum = tomlData["logoFile"].as_string()) {
+        details.icon_path = iconPath(QString::fromStdString(logoDatum->get()));
+    }
+
     return details;
 }
 
@@ -202,6 +242,8 @@ ModDetails ReadFabricModInfo(QByteArray contents)
                 details.homeurl = contact.value("homepage").toString();
             }
         }
+
+        details.icon_path = chooseIcon(object.value("icon"));
     }
     return details;
 }
@@ -238,6 +280,8 @@ ModDetails ReadQuiltModInfo(QByteArray contents)
         if (modContact.contains("homepage")) {
             details.homeurl = Json::requireString(modContact.value("homepage"));
         }
+
+        details.icon_path = chooseIcon(modMetadata.value("icon"));
     }
     return details;
 }
@@ -318,44 +362,53 @@ bool process(Mod& mod, ProcessingLevel level)
         case ResourceType::FOLDER:
             return processFolder(mod, level);
         case ResourceType::ZIPFILE:
-            return processZIP(mod, level);
+            return processCached(mod, level, processZIP);
         case ResourceType::LITEMOD:
-            return processLitemod(mod);
+            return processCached(mod, level, processLitemod);
         default:
             qWarning() << "Invalid type for mod parse task!";
             return false;
     }
 }
 
+bool processCached(Mod& mod, ProcessingLevel level, std::function<bool(Mod&, ProcessingLevel)> processor)
+{
+    auto& cache = ModDetailsCache::instance();
+    if (auto cached = cache.find(mod.fileinfo())) {
+        if (cached->valid)
+            mod.setDetails(cached->details);
+        return cached->valid;
+    }
+
+    bool valid = processor(mod, level);
+    cache.insert(mod.fileinfo(), valid, mod.details());
+    return valid;
+}
+
 bool processZIP(Mod& mod, ProcessingLevel level)
 {
     ModDetails details;
 
-    QuaZip zip(mod.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    MMCZip::ArchiveReader zip(mod.fileinfo().filePath());
+    if (!zip.open())
         return false;
 
-    QuaZipFile file(&zip);
-
-    if (zip.setCurrentFile("META-INF/mods.toml")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
+    if (zip.contains("META-INF/mods.toml")) {
+        auto contents = zip.read("META-INF/mods.toml");
+        if (!contents)
             return false;
-        }
 
-        details = ReadMCModTOML(file.readAll());
-        file.close();
+        details = ReadMCModTOML(*contents);
 
         // to replace ${file.jarVersion} with the actual version, as needed
         if (details.version == "${file.jarVersion}") {
-            if (zip.setCurrentFile("META-INF/MANIFEST.MF")) {
-                if (!file.open(QIODevice::ReadOnly)) {
-                    zip.close();
+            if (zip.contains("META-INF/MANIFEST.MF")) {
+                auto manifest = zip.read("META-INF/MANIFEST.MF");
+                if (!manifest)
                     return false;
-                }
 
                 // quick and dirty line-by-line parser
-                auto manifestLines = file.readAll().split('\n');
+                auto manifestLines = manifest->split('\n');
                 QString manifestVersion = "";
                 for (auto& line : manifestLines) {
                     if (QString(line).startsWith("Implementation-Version: ")) {
@@ -371,69 +424,50 @@ bool processZIP(Mod& mod, ProcessingLevel level)
                 }
 
                 details.version = manifestVersion;
-
-                file.close();
             }
         }
 
-        zip.close();
         mod.setDetails(details);
 
         return true;
-    } else if (zip.setCurrentFile("mcmod.info")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
+    } else if (zip.contains("mcmod.info")) {
+        auto contents = zip.read("mcmod.info");
+        if (!contents)
             return false;
-        }
 
-        details = ReadMCModInfo(file.readAll());
-        file.close();
-        zip.close();
+        details = ReadMCModInfo(*contents);
 
         mod.setDetails(details);
         return true;
-    } else if (zip.setCurrentFile("quilt.mod.json")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
+    } else if (zip.contains("quilt.mod.json")) {
+        auto contents = zip.read("quilt.mod.json");
+        if (!contents)
             return false;
-        }
 
-        details = ReadQuiltModInfo(file.readAll());
-        file.close();
-        zip.close();
+        details = ReadQuiltModInfo(*contents);
 
         mod.setDetails(details);
         return true;
-    } else if (zip.setCurrentFile("fabric.mod.json")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
+    } else if (zip.contains("fabric.mod.json")) {
+        auto contents = zip.read("fabric.mod.json");
+        if (!contents)
             return false;
-        }
 
-        details = ReadFabricModInfo(file.readAll());
-        file.close();
-        zip.close();
+        details = ReadFabricModInfo(*contents);
 
         mod.setDetails(details);
         return true;
-    } else if (zip.setCurrentFile("forgeversion.properties")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
-            return false;
-        }
-
-        details = ReadForgeInfo(file.getFileName());
-        file.close();
-        zip.close();
+    } else if (zip.contains("forgeversion.properties")) {
+        details = ReadForgeInfo("forgeversion.properties");
 
         mod.setDetails(details);
         return true;
-    } else if (zip.setCurrentFile("META-INF/nil/mappings.json")) {
+    } else if (zip.contains("META-INF/nil/mappings.json")) {
         // nilloader uses the filename of the metadata file for the modid, so we can't know the exact filename
         // thankfully, there is a good file to use as a canary so we don't look for nil meta all the time
 
         QString foundNilMeta;
-        for (auto& fname : zip.getFileNameList()) {
+        for (auto& fname : zip.fileNames()) {
             // nilmods can shade nilloader to be able to run as a standalone agent - which includes nilloader's own meta file
             if (fname.endsWith(".nilmod.css") && fname != "nilloader.nilmod.css") {
                 foundNilMeta = fname;
@@ -441,22 +475,18 @@ bool processZIP(Mod& mod, ProcessingLevel level)
             }
         }
 
-        if (zip.setCurrentFile(foundNilMeta)) {
-            if (!file.open(QIODevice::ReadOnly)) {
-                zip.close();
+        if (zip.contains(foundNilMeta)) {
+            auto contents = zip.read(foundNilMeta);
+            if (!contents)
                 return false;
-            }
 
-            details = ReadNilModInfo(file.readAll(), foundNilMeta);
-            file.close();
-            zip.close();
+            details = ReadNilModInfo(*contents, foundNilMeta);
 
             mod.setDetails(details);
             return true;
         }
     }
 
-    zip.close();
     return false;  // no valid mod found in archive
 }
 
@@ -485,25 +515,20 @@ bool processLitemod(Mod& mod, ProcessingLevel level)
 {
     ModDetails details;
 
-    QuaZip zip(mod.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    MMCZip::ArchiveReader zip(mod.fileinfo().filePath());
+    if (!zip.open())
         return false;
 
-    QuaZipFile file(&zip);
-
-    if (zip.setCurrentFile("litemod.json")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
+    if (zip.contains("litemod.json")) {
+        auto contents = zip.read("litemod.json");
+        if (!contents)
             return false;
-        }
 
-        details = ReadLiteModInfo(file.readAll());
-        file.close();
+        details = ReadLiteModInfo(*contents);
 
         mod.setDetails(details);
         return true;
     }
-    zip.close();
 
     return false;  // no valid litemod.json found in archive
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+
 #include <QDebug>
 #include <QObject>
 
@@ -23,6 +25,9 @@ bool processZIP(Mod& mod, ProcessingLevel level = ProcessingLevel::Full);
 bool processFolder(Mod& mod, ProcessingLevel level = ProcessingLevel::Full);
 bool processLitemod(Mod& mod, ProcessingLevel level = ProcessingLevel::Full);
 
+/** Runs the processor on archives that aren't in the mod details cache, taking the details from there otherwise. */
+bool processCached(Mod& mod, ProcessingLevel level, std::function<bool(Mod&, ProcessingLevel)> processor);
+
 /** Checks whether a file is valid as a mod or not. */
 bool validate(QFileInfo file);
 }  // namespace ModUtils
@@ -18,13 +18,10 @@
 
 #include "LocalResourcePackParseTask.h"
 
+#include "ArchiveReader.h"
 #include "FileSystem.h"
 #include "Json.h"
 
-#include <quazip/quazip.h>
-#include <quazip/quazipdir.h>
-#include <quazip/quazipfile.h>
-
 #include <QCryptographicHash>
 
 namespace ResourcePackUtils {
@@ -83,20 +80,10 @@ bool processFolder(ResourcePack& pack, ProcessingLevel level)
         return true;  // the png is optional
     };
 
+    // only where the image is, it gets decoded once it's shown
     QFileInfo image_file_info(FS::PathCombine(pack.fileinfo().filePath(), "pack.png"));
     if (image_file_info.exists() && image_file_info.isFile()) {
-        QFile pack_png_file(image_file_info.filePath());
-        if (!pack_png_file.open(QIODevice::ReadOnly))
-            return png_invalid();  // can't open pack.png file
-
-        auto data = pack_png_file.readAll();
-
-        bool pack_png_result = ResourcePackUtils::processPackPNG(pack, std::move(data));
-
-        pack_png_file.close();
-        if (!pack_png_result) {
-            return png_invalid();  // pack.png invalid
-        }
+        pack.setIcon({ pack.fileinfo().filePath(), image_file_info.filePath(), false, image_file_info.size() });
     } else {
         return png_invalid();  // pack.png does not exists or is not a valid file.
     }
@@ -108,43 +95,35 @@ bool processZIP(ResourcePack& pack, ProcessingLevel level)
 {
     Q_ASSERT(pack.type() == ResourceType::ZIPFILE);
 
-    QuaZip zip(pack.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    MMCZip::ArchiveReader zip(pack.fileinfo().filePath());
+    if (!zip.open())
         return false;  // can't open zip file
 
-    QuaZipFile file(&zip);
-
     auto mcmeta_invalid = [&pack]() {
         qWarning() << "Resource pack at" << pack.fileinfo().filePath() << "does not have a valid pack.mcmeta";
         return false;  // the mcmeta is not optional
     };
 
-    if (zip.setCurrentFile("pack.mcmeta")) {
-        if (!file.open(QIODevice::ReadOnly)) {
+    if (zip.contains("pack.mcmeta")) {
+        auto data = zip.read("pack.mcmeta");
+        if (!data) {
             qCritical() << "Failed to open file in zip.";
-            zip.close();
             return mcmeta_invalid();
         }
 
-        auto data = file.readAll();
-
-        bool mcmeta_result = ResourcePackUtils::processMCMeta(pack, std::move(data));
-
-        file.close();
+        bool mcmeta_result = ResourcePackUtils::processMCMeta(pack, std::move(*data));
         if (!mcmeta_result) {
             return mcmeta_invalid();  // mcmeta invalid
         }
     } else {
-        return mcmeta_invalid();  // could not set pack.mcmeta as current file.
+        return mcmeta_invalid();  // could not find pack.mcmeta.
     }
 
-    QuaZipDir zipDir(&zip);
-    if (!zipDir.exists("/assets")) {
+    if (!zip.containsDir("assets")) {
         return false;  // assets dir does not exists at zip root
     }
 
     if (level == ProcessingLevel::BasicInfoOnly) {
-        zip.close();
         return true;  // only need basic info already checked
     }
 
@@ -153,27 +132,13 @@ bool processZIP(ResourcePack& pack, ProcessingLevel level)
         return true;  // the png is optional
     };
 
-    if (zip.setCurrentFile("pack.png")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            qCritical() << "Failed to open file in zip.";
-            zip.close();
-            return png_invalid();
-        }
-
-        auto data = file.readAll();
-
-        bool pack_png_result = ResourcePackUtils::processPackPNG(pack, std::move(data));
-
-        file.close();
-        if (!pack_png_result) {
-            return png_invalid();  // pack.png invalid
-        }
+    // only where the image is, it gets decoded once it's shown
+    if (auto entry = zip.entry("pack.png")) {
+        pack.setIcon({ pack.fileinfo().filePath(), entry->name, true, qint64(entry->uncompressed_size) });
     } else {
-        return png_invalid();  // could not set pack.mcmeta as current file.
+        return png_invalid();  // could not find pack.png.
     }
 
-    zip.close();
-
     return true;
 }
 
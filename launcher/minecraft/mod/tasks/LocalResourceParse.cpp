@@ -20,9 +20,14 @@
  */
 
 #include <QObject> 
+#include <QtConcurrent>
+
+#include <algorithm>
 
 #include "LocalResourceParse.h"
 
+#include "ArchiveReader.h"
+
 #include "LocalDataPackParseTask.h"
 #include "LocalModParseTask.h"
 #include "LocalResourcePackParseTask.h"
@@ -42,8 +47,101 @@ static const QMap<PackedResourceType, QString> s_packed_type_names = {
 };
 
 namespace ResourceUtils {
+
+// what each kind of resource can't go without, in the order they are tried
+static const QList<PackedResourceType> s_identify_order = {
+    PackedResourceType::ResourcePack, PackedResourceType::TexturePack, PackedResourceType::DataPack,
+    PackedResourceType::Mod,          PackedResourceType::WorldSave,   PackedResourceType::ShaderPack
+};
+
+static const QStringList s_mod_markers = { "META-INF/mods.toml",      "mcmod.info",          "quilt.mod.json", "fabric.mod.json",
+                                           "forgeversion.properties", "META-INF/nil/mappings.json", "litemod.json" };
+
+static bool hasLevelDat(const MMCZip::ArchiveReader& zip)
+{
+    // level.dat, <world>/level.dat or saves/<world>/level.dat
+    for (auto& entry : zip.entries()) {
+        if (entry.name != "level.dat" && !entry.name.endsWith("/level.dat"))
+            continue;
+        auto depth = entry.name.count('/');
+        if (depth <= 1 || (depth == 2 && entry.name.startsWith("saves/")))
+            return true;
+    }
+    return false;
+}
+
+/** The kinds of resource the archive could be, judging by the names of its entries. */
+static QList<PackedResourceType> candidates(const MMCZip::ArchiveReader& zip)
+{
+    QList<PackedResourceType> types;
+    for (auto type : s_identify_order) {
+        bool possible = false;
+        switch (type) {
+            case PackedResourceType::ResourcePack:
+                possible = zip.contains("pack.mcmeta") && zip.containsDir("assets");
+                break;
+            case PackedResourceType::TexturePack:
+                possible = zip.contains("pack.txt");
+                break;
+            case PackedResourceType::DataPack:
+                possible = zip.contains("pack.mcmeta") && zip.containsDir("data");
+                break;
+            case PackedResourceType::Mod:
+                possible = std::any_of(s_mod_markers.begin(), s_mod_markers.end(), [&zip](const QString& name) { return zip.contains(name); });
+                break;
+            case PackedResourceType::WorldSave:
+                possible = hasLevelDat(zip);
+                break;
+            case PackedResourceType::ShaderPack:
+                possible = zip.containsDir("shaders");
+                break;
+            default:
+                break;
+        }
+        if (possible)
+            types.append(type);
+    }
+    return types;
+}
+
+static bool validate(PackedResourceType type, const QFileInfo& file)
+{
+    switch (type) {
+        case PackedResourceType::ResourcePack:
+            return ResourcePackUtils::validate(file);
+        case PackedResourceType::TexturePack:
+            return TexturePackUtils::validate(file);
+        case PackedResourceType::DataPack:
+            return DataPackUtils::validate(file);
+        case PackedResourceType::Mod:
+            return ModUtils::validate(file);
+        case PackedResourceType::WorldSave:
+            return WorldSaveUtils::validate(file);
+        case PackedResourceType::ShaderPack:
+            return ShaderPackUtils::validate(file);
+        default:
+            return false;
+    }
+}
+
 PackedResourceType identify(QFileInfo file){
     if (file.exists() && file.isFile()) {
+        // The central directory tells what the archive can't be, so only the parsers of what it can be are run,
+        // instead of each of them opening and parsing it in turn.
+        MMCZip::ArchiveReader zip(file.filePath());
+        if (zip.open()) {
+            auto types = candidates(zip);
+            zip.close();
+            for (auto type : types) {
+                if (validate(type, file)) {
+                    qDebug() << file.fileName() << "is a" << getPackedTypeName(type);
+                    return type;
+                }
+            }
+            qDebug() << "Can't Identify" << file.fileName();
+            return PackedResourceType::UNKNOWN;
+        }
+
         if (ResourcePackUtils::validate(file)) {
             qDebug() << file.fileName() << "is a resource pack";
             return PackedResourceType::ResourcePack;
@@ -71,6 +169,26 @@ PackedResourceType identify(QFileInfo file){
     return PackedResourceType::UNKNOWN;
 }
 
+QList<PackedResourceType> identify(const QList<QFileInfo>& files)
+{
+    struct Item {
+        QFileInfo file;
+        PackedResourceType type = PackedResourceType::UNKNOWN;
+    };
+    QVector<Item> items;
+    items.reserve(files.size());
+    for (auto& file : files)
+        items.append({ file });
+
+    QtConcurrent::blockingMap(items, [](Item& item) { item.type = identify(item.file); });
+
+    QList<PackedResourceType> types;
+    types.reserve(items.size());
+    for (auto& item : items)
+        types.append(item.type);
+    return types;
+}
+
 QString getPackedTypeName(PackedResourceType type) {
     return s_packed_type_names.constFind(type).value();
 }
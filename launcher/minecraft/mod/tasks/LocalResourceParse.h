@@ -33,5 +33,7 @@ static const std::set<PackedResourceType> ValidResourceTypes = { PackedResourceT
                                                                  PackedResourceType::TexturePack, PackedResourceType::ShaderPack,
                                                                  PackedResourceType::WorldSave,   PackedResourceType::Mod };
 PackedResourceType identify(QFileInfo file);
+/** Identifies several files at the same time, the types are in the same order as the files. */
+QList<PackedResourceType> identify(const QList<QFileInfo>& files);
 QString getPackedTypeName(PackedResourceType type);
 }  // namespace ResourceUtils
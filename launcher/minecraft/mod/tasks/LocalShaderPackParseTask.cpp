@@ -21,12 +21,9 @@
 
 #include "LocalShaderPackParseTask.h"
 
+#include "ArchiveReader.h"
 #include "FileSystem.h"
 
-#include <quazip/quazip.h>
-#include <quazip/quazipdir.h>
-#include <quazip/quazipfile.h>
-
 namespace ShaderPackUtils {
 
 bool process(ShaderPack& pack, ProcessingLevel level)
@@ -63,25 +60,19 @@ bool processZIP(ShaderPack& pack, ProcessingLevel level)
 {
     Q_ASSERT(pack.type() == ResourceType::ZIPFILE);
 
-    QuaZip zip(pack.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    MMCZip::ArchiveReader zip(pack.fileinfo().filePath());
+    if (!zip.open())
         return false;  // can't open zip file
 
-    QuaZipFile file(&zip);
-
-    QuaZipDir zipDir(&zip);
-    if (!zipDir.exists("/shaders")) {
+    if (!zip.containsDir("shaders")) {
         return false;  // assets dir does not exists at zip root
     }
     pack.setPackFormat(ShaderPackFormat::VALID);
 
     if (level == ProcessingLevel::BasicInfoOnly) {
-        zip.close();
         return true;  // only need basic info already checked
     }
 
-    zip.close();
-
     return true;
 }
 
@@ -19,11 +19,9 @@
 
 #include "LocalTexturePackParseTask.h"
 
+#include "ArchiveReader.h"
 #include "FileSystem.h"
 
-#include <quazip/quazip.h>
-#include <quazip/quazipfile.h>
-
 #include <QCryptographicHash>
 
 namespace TexturePackUtils {
@@ -66,20 +64,10 @@ bool processFolder(TexturePack& pack, ProcessingLevel level)
     if (level == ProcessingLevel::BasicInfoOnly)
         return true;
 
+    // only where the image is, it gets decoded once it's shown
     QFileInfo image_file_info(FS::PathCombine(pack.fileinfo().filePath(), "pack.png"));
     if (image_file_info.isFile()) {
-        QFile mcmeta_file(image_file_info.filePath());
-        if (!mcmeta_file.open(QIODevice::ReadOnly))
-            return false;
-
-        auto data = mcmeta_file.readAll();
-
-        bool packPNG_result = TexturePackUtils::processPackPNG(pack, std::move(data));
-
-        mcmeta_file.close();
-        if (!packPNG_result) {
-            return false;
-        }
+        pack.setIcon({ pack.fileinfo().filePath(), image_file_info.filePath(), false, image_file_info.size() });
     } else {
         return false;
     }
@@ -91,52 +79,30 @@ bool processZIP(TexturePack& pack, ProcessingLevel level)
 {
     Q_ASSERT(pack.type() == ResourceType::ZIPFILE);
 
-    QuaZip zip(pack.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    MMCZip::ArchiveReader zip(pack.fileinfo().filePath());
+    if (!zip.open())
         return false;
 
-    QuaZipFile file(&zip);
-
-    if (zip.setCurrentFile("pack.txt")) {
-        if (!file.open(QIODevice::ReadOnly)) {
+    if (zip.contains("pack.txt")) {
+        auto data = zip.read("pack.txt");
+        if (!data) {
             qCritical() << "Failed to open file in zip.";
-            zip.close();
             return false;
         }
 
-        auto data = file.readAll();
-
-        bool packTXT_result = TexturePackUtils::processPackTXT(pack, std::move(data));
-
-        file.close();
+        bool packTXT_result = TexturePackUtils::processPackTXT(pack, std::move(*data));
         if (!packTXT_result) {
             return false;
         }
     }
 
     if (level == ProcessingLevel::BasicInfoOnly) {
-        zip.close();
         return true;
     }
 
-    if (zip.setCurrentFile("pack.png")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            qCritical() << "Failed to open file in zip.";
-            zip.close();
-            return false;
-        }
-
-        auto data = file.readAll();
-
-        bool packPNG_result = TexturePackUtils::processPackPNG(pack, std::move(data));
-
-        file.close();
-        if (!packPNG_result) {
-            return false;
-        }
-    }
-
-    zip.close();
+    // only where the image is, it gets decoded once it's shown
+    if (auto entry = zip.entry("pack.png"))
+        pack.setIcon({ pack.fileinfo().filePath(), entry->name, true, qint64(entry->uncompressed_size) });
 
     return true;
 }
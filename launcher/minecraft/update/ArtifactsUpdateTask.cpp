@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ArtifactsUpdateTask.h"
+
+#include <QDebug>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/update/LibrariesTask.h"
+
+ArtifactsUpdateTask::ArtifactsUpdateTask(MinecraftInstance* inst) : Task(), m_inst(inst) {}
+
+void ArtifactsUpdateTask::executeTask()
+{
+    setStatus(tr("Checking the files of the instance..."));
+    m_stamp = IntegrityStamp::collect(m_inst);
+
+    auto stamp = m_stamp;
+    auto watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher] {
+        auto unchanged = watcher->result();
+        watcher->deleteLater();
+        if (!isRunning())
+            return;
+        if (unchanged) {
+            qDebug() << m_inst->name() << ": nothing changed since the last update, skipping the libraries and assets";
+            emitSucceeded();
+            return;
+        }
+        startUpdate();
+    });
+    watcher->setFuture(QtConcurrent::run(QThreadPool::globalInstance(), [stamp] { return IntegrityStamp::matches(stamp); }));
+}
+
+void ArtifactsUpdateTask::startUpdate()
+{
+    // whatever happens now, the files are not what the stamp says anymore
+    IntegrityStamp::remove(m_stamp);
+
+    m_update = makeShared<TaskGraph>(nullptr, tr("Updating libraries and assets"));
+    m_update->addTask(makeShared<LibrariesTask>(m_inst));
+    m_assets = makeShared<AssetUpdateTask>(m_inst);
+    m_update->addTask(m_assets);
+
+    connect(m_update.get(), &Task::succeeded, this, &ArtifactsUpdateTask::writeStamp);
+    connect(m_update.get(), &Task::failed, this, &ArtifactsUpdateTask::emitFailed);
+    connect(m_update.get(), &Task::aborted, this, &ArtifactsUpdateTask::emitAborted);
+    connect(m_update.get(), &Task::status, this, &ArtifactsUpdateTask::setStatus);
+    connect(m_update.get(), &Task::progress, this, &ArtifactsUpdateTask::setProgress);
+    connect(m_update.get(), &Task::stepProgress, this, &ArtifactsUpdateTask::propogateStepProgress);
+    m_update->start();
+}
+
+void ArtifactsUpdateTask::writeStamp()
+{
+    // the instance has everything once the rest came in, which the next update checks
+    if (m_assets->deferredAssets()) {
+        emitSucceeded();
+        return;
+    }
+
+    auto stamp = m_stamp;
+    auto watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher] {
+        if (!watcher->result())
+            qDebug() << m_inst->name() << ": couldn't write the update stamp";
+        watcher->deleteLater();
+        if (isRunning())
+            emitSucceeded();
+    });
+    watcher->setFuture(QtConcurrent::run(QThreadPool::globalInstance(), [stamp] { return IntegrityStamp::write(stamp); }));
+}
+
+bool ArtifactsUpdateTask::abort()
+{
+    if (m_update && m_update->isRunning())
+        return m_update->abort();
+    if (isRunning())
+        emitAborted();
+    return true;
+}
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "minecraft/update/AssetUpdateTask.h"
+#include "minecraft/update/IntegrityStamp.h"
+#include "tasks/TaskGraph.h"
+
+class MinecraftInstance;
+
+/* Downloads the libraries and the assets of an instance, unless nothing changed since its last update.
+ *
+ * Before anything else, the integrity stamp of the instance is checked on the global thread pool. If it matches,
+ * the task is done right away, without resolving a single library through the metacache or reading the asset
+ * index. Otherwise the libraries and the assets are updated at the same time, and the stamp is written again
+ * once both succeeded, unless some assets are left for later (see AssetUpdateTask).
+ */
+class ArtifactsUpdateTask : public Task {
+    Q_OBJECT
+   public:
+    explicit ArtifactsUpdateTask(MinecraftInstance* inst);
+    ~ArtifactsUpdateTask() override = default;
+
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    void startUpdate();
+    void writeStamp();
+
+   private:
+    MinecraftInstance* m_inst;
+    IntegrityStamp::Inputs m_stamp;
+    shared_qobject_ptr<TaskGraph> m_update;
+    shared_qobject_ptr<AssetUpdateTask> m_assets;
+};
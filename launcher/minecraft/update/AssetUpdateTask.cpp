@@ -73,9 +73,18 @@ void AssetUpdateTask::assetIndexFinished()
         auto entry = metacache->resolveEntry("asset_indexes", assets->id + ".json");
         metacache->evictEntry(entry);
         emitFailed(tr("Failed to read the assets index!"));
+        return;
     }
 
-    auto job = index.getDownloadJob();
+    auto missing = index.missingObjects();
+    // with a fast first launch, the game starts once what it needs to start is there, the sounds come in meanwhile
+    QList<int> deferred;
+    if (APPLICATION->settings()->get("FastFirstLaunch").toBool())
+        deferred = index.takeDeferrable(missing);
+    m_deferred = !deferred.isEmpty();
+    m_inst->setDeferredAssets(index.makeDownloadJob(deferred));
+
+    auto job = index.makeDownloadJob(missing);
     if(job)
     {
         setStatus(tr("Getting the assets files from Mojang..."));
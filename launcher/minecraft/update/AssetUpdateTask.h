@@ -14,6 +14,9 @@ public:
 
     bool canAbort() const override;
 
+    /// whether some assets are left to download while the game runs, the instance isn't complete then
+    bool deferredAssets() const { return m_deferred; }
+
 private slots:
     void assetIndexFinished();
     void assetIndexFailed(QString reason);
@@ -25,4 +28,5 @@ public slots:
 private:
     MinecraftInstance *m_inst;
     NetJob::Ptr downloadJob;
+    bool m_deferred = false;
 };
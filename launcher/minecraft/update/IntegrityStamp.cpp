@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "IntegrityStamp.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include "FileSystem.h"
+#include "minecraft/AssetsUtils.h"
+#include "minecraft/Component.h"
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+
+namespace IntegrityStamp {
+
+namespace {
+constexpr quint32 s_magic = 0x4d434953;  // "MCIS"
+constexpr quint32 s_version = 1;
+constexpr auto s_stream_version = QDataStream::Qt_5_12;
+
+struct FileState {
+    QString path;
+    qint64 size = 0;
+    qint64 modified = 0;
+};
+
+QByteArray readHeader(QDataStream& in)
+{
+    quint32 magic = 0;
+    quint32 version = 0;
+    QByteArray profile_hash;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != s_magic || version != s_version)
+        return {};
+    in >> profile_hash;
+    return profile_hash;
+}
+}  // namespace
+
+Inputs collect(MinecraftInstance* instance)
+{
+    Inputs inputs;
+    inputs.stamp_path = FS::PathCombine(instance->instanceRoot(), ".update_stamp");
+
+    auto components = instance->getPackProfile();
+    auto profile = components->getProfile();
+    if (!profile)
+        return inputs;
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (int i = 0; i < components->rowCount(); i++) {
+        auto component = components->getComponent(i);
+        hash.addData((component->getID() + '\n' + component->getVersion() + '\n').toUtf8());
+    }
+
+    auto addFiles = [&](const QList<LibraryPtr>& pool, const QString& override_path) {
+        for (auto& lib : pool) {
+            if (!lib)
+                continue;
+            QStringList jar, native, native32, native64;
+            lib->getApplicableFiles(instance->runtimeContext(), jar, native, native32, native64, override_path);
+            inputs.files << jar << native << native32 << native64;
+        }
+    };
+    QList<LibraryPtr> libraries;
+    libraries.append(profile->getLibraries());
+    libraries.append(profile->getNativeLibraries());
+    libraries.append(profile->getMavenFiles());
+    for (auto& agent : profile->getAgents())
+        libraries.append(agent->library());
+    libraries.append(profile->getMainJar());
+    addFiles(libraries, instance->getLocalLibraryPath());
+    addFiles(profile->getJarMods(), instance->jarModsDir());
+    for (auto& file : inputs.files)
+        hash.addData((file + '\n').toUtf8());
+
+    auto assets = profile->getMinecraftAssets();
+    if (assets) {
+        inputs.assets_id = assets->id;
+        hash.addData((assets->id + '\n' + assets->sha1 + '\n').toUtf8());
+    }
+
+    inputs.profile_hash = hash.result();
+    return inputs;
+}
+
+bool matches(const Inputs& inputs)
+{
+    if (inputs.profile_hash.isEmpty())
+        return false;
+
+    QFile file(inputs.stamp_path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    in.setVersion(s_stream_version);
+    if (readHeader(in) != inputs.profile_hash)
+        return false;
+
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count; i++) {
+        FileState state;
+        in >> state.path >> state.size >> state.modified;
+        if (in.status() != QDataStream::Ok)
+            return false;
+        QFileInfo info(state.path);
+        if (!info.isFile() || info.size() != state.size || info.lastModified().toMSecsSinceEpoch() != state.modified)
+            return false;
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+bool write(const Inputs& inputs)
+{
+    if (inputs.profile_hash.isEmpty())
+        return false;
+
+    QStringList paths = inputs.files;
+    if (!inputs.assets_id.isEmpty()) {
+        auto index_path = "assets/indexes/" + inputs.assets_id + ".json";
+        AssetsIndex index;
+        if (!AssetsUtils::loadAssetsIndexJson(inputs.assets_id, index_path, index))
+            return false;
+        paths.append(index_path);
+        for (int i = 0; i < index.size(); i++)
+            paths.append(index.object(i).getLocalPath());
+    }
+
+    QList<FileState> states;
+    states.reserve(paths.size());
+    for (auto& path : paths) {
+        QFileInfo info(path);
+        if (!info.isFile()) {
+            qDebug() << "Not writing the update stamp," << path << "is missing";
+            return false;
+        }
+        states.append({ info.absoluteFilePath(), info.size(), info.lastModified().toMSecsSinceEpoch() });
+    }
+
+    QSaveFile file(inputs.stamp_path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream out(&file);
+    out.setVersion(s_stream_version);
+    out << s_magic << s_version << inputs.profile_hash << static_cast<quint32>(states.size());
+    for (auto& state : states)
+        out << state.path << state.size << state.modified;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+void remove(const Inputs& inputs)
+{
+    QFile::remove(inputs.stamp_path);
+}
+
+}  // namespace IntegrityStamp
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+class MinecraftInstance;
+
+/* What an instance looked like after its last successful update.
+ *
+ * The stamp holds a hash of the resolved components (their versions, the files of their libraries and the
+ * asset index they use), and the size and modification time of every one of those files and of the asset
+ * objects. As long as the hash and all the files are the same, there's nothing for an update to download.
+ *
+ * collect() needs the GUI thread, matches() and write() only touch the disk and can run anywhere.
+ */
+namespace IntegrityStamp {
+
+struct Inputs {
+    QString stamp_path;
+    QByteArray profile_hash;
+    // absolute paths of the library files
+    QStringList files;
+    QString assets_id;
+};
+
+/** What the stamp of the instance has to match, from its resolved components. */
+Inputs collect(MinecraftInstance* instance);
+
+/** Whether the stamp on disk is for the same profile, and none of its files changed since. */
+bool matches(const Inputs& inputs);
+
+/** Writes the stamp for the files as they are now. Doesn't write anything if some of them are missing. */
+bool write(const Inputs& inputs);
+
+/** Removes the stamp, so the next update doesn't assume anything. */
+void remove(const Inputs& inputs);
+
+}  // namespace IntegrityStamp
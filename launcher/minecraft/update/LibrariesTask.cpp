@@ -12,6 +12,41 @@ LibrariesTask::LibrariesTask(MinecraftInstance * inst)
 
 void LibrariesTask::executeTask()
 {
+    setStatus(tr("Checking the library files..."));
+    MinecraftInstance *inst = (MinecraftInstance *)m_inst;
+    auto profile = inst->getPackProfile()->getProfile();
+
+    // Look at the files of the libraries off the GUI thread first, getDownloads() then only has to stat them.
+    QStringList storages;
+    auto addStorages = [&](const QList<LibraryPtr> & pool)
+    {
+        for (auto lib : pool)
+        {
+            if(lib)
+            {
+                storages.append(lib->getCacheStorages(inst->runtimeContext()));
+            }
+        }
+    };
+    addStorages(profile->getLibraries());
+    addStorages(profile->getNativeLibraries());
+    addStorages(profile->getMavenFiles());
+    for (auto agent : profile->getAgents())
+    {
+        addStorages({ agent->library() });
+    }
+    addStorages({ profile->getMainJar() });
+    addStorages(profile->getJarMods());
+
+    APPLICATION->metacache()->validateEntries("libraries", storages, this, [this](QStringList) { startDownloads(); });
+}
+
+void LibrariesTask::startDownloads()
+{
+    // aborted while the files were being checked
+    if (!isRunning())
+        return;
+
     setStatus(tr("Downloading required library files..."));
     qDebug() << m_inst->name() << ": downloading libraries";
     MinecraftInstance *inst = (MinecraftInstance *)m_inst;
@@ -94,6 +129,8 @@ bool LibrariesTask::abort()
     else
     {
         qWarning() << "Prematurely aborted LibrariesTask";
+        if (isRunning())
+            emitAborted();
     }
     return true;
 }
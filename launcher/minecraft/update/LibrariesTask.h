@@ -17,6 +17,9 @@ public:
 private slots:
     void jarlibFailed(QString reason);
 
+private:
+    void startDownloads();
+
 public slots:
     bool abort() override;
 
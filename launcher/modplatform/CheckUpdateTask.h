@@ -40,6 +40,15 @@ class CheckUpdateTask : public Task {
 
    signals:
     void checkFailed(Mod* failed, QString reason, QUrl recover_url = {});
+    /** For each update as soon as it's known, while the others are still being looked for. */
+    void updateFound(const CheckUpdateTask::UpdatableMod& mod);
+
+   protected:
+    void addUpdatable(UpdatableMod&& mod)
+    {
+        emit updateFound(mod);
+        m_updatable.push_back(std::move(mod));
+    }
 
    protected:
     QList<Mod*>& m_mods;
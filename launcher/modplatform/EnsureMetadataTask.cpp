@@ -2,14 +2,17 @@
 
 #include <MurmurHash2.h>
 #include <QDebug>
+#include <QSet>
 
 #include "Json.h"
+#include "net/JsonResponse.h"
 
 #include "minecraft/mod/Mod.h"
 #include "minecraft/mod/tasks/LocalModUpdateTask.h"
 
 #include "modplatform/flame/FlameAPI.h"
 #include "modplatform/flame/FlameModIndex.h"
+#include "modplatform/helpers/LookupMisses.h"
 #include "modplatform/modrinth/ModrinthAPI.h"
 #include "modplatform/modrinth/ModrinthPackIndex.h"
 
@@ -18,57 +21,62 @@ static ModPlatform::ProviderCapabilities ProviderCaps;
 static ModrinthAPI modrinth_api;
 static FlameAPI flame_api;
 
-EnsureMetadataTask::EnsureMetadataTask(Mod* mod, QDir dir, ModPlatform::ResourceProvider prov)
-    : Task(nullptr), m_index_dir(dir), m_provider(prov), m_hashing_task(nullptr), m_current_task(nullptr)
+// the hash the provider knows files by
+static QString lookupHash(ModPlatform::ResourceProvider provider, const Hashing::FileHashes& hashes)
 {
-    auto hash_task = createNewHash(mod);
-    if (!hash_task)
-        return;
-    connect(hash_task.get(), &Task::succeeded, [this, hash_task, mod] { m_mods.insert(hash_task->getResult(), mod); });
-    connect(hash_task.get(), &Task::failed, [this, hash_task, mod] { emitFail(mod, "", RemoveFromList::No); });
-    hash_task->start();
+    switch (provider) {
+        case ModPlatform::ResourceProvider::MODRINTH:
+            return hashes.get(ProviderCaps.hashType(ModPlatform::ResourceProvider::MODRINTH).first());
+        case ModPlatform::ResourceProvider::FLAME:
+            return hashes.murmur2;
+    }
+    return {};
 }
 
-EnsureMetadataTask::EnsureMetadataTask(QList<Mod*>& mods, QDir dir, ModPlatform::ResourceProvider prov)
-    : Task(nullptr), m_index_dir(dir), m_provider(prov), m_current_task(nullptr)
+static ModPlatform::ResourceProvider otherProvider(ModPlatform::ResourceProvider provider)
 {
-    m_hashing_task.reset(new ConcurrentTask(this, "MakeHashesTask", 10));
-    for (auto* mod : mods) {
-        auto hash_task = createNewHash(mod);
-        if (!hash_task)
-            continue;
-        connect(hash_task.get(), &Task::succeeded, [this, hash_task, mod] { m_mods.insert(hash_task->getResult(), mod); });
-        connect(hash_task.get(), &Task::failed, [this, hash_task, mod] { emitFail(mod, "", RemoveFromList::No); });
-        m_hashing_task->addTask(hash_task);
+    switch (provider) {
+        case ModPlatform::ResourceProvider::MODRINTH:
+            return ModPlatform::ResourceProvider::FLAME;
+        case ModPlatform::ResourceProvider::FLAME:
+            return ModPlatform::ResourceProvider::MODRINTH;
     }
+    return ModPlatform::ResourceProvider::FLAME;
 }
 
-Hashing::Hasher::Ptr EnsureMetadataTask::createNewHash(Mod* mod)
+EnsureMetadataTask::EnsureMetadataTask(Mod* mod, QDir dir, ModPlatform::ResourceProvider prov, bool try_others)
+    : Task(nullptr), m_index_dir(dir), m_providers{ prov }, m_hashing_task(nullptr), m_current_task(nullptr)
 {
-    if (!mod || !mod->valid() || mod->type() == ResourceType::FOLDER)
-        return nullptr;
+    if (try_others)
+        m_providers.append(otherProvider(prov));
 
-    return Hashing::createHasher(mod->fileinfo().absoluteFilePath(), m_provider);
+    // Hashing happens off-thread, so it has to be run (see getHashingTask()) before this task
+    m_hashing_task.reset(new ConcurrentTask(this, "MakeHashesTask", 1));
+    addHashTask(mod);
 }
 
-QString EnsureMetadataTask::getExistingHash(Mod* mod)
+EnsureMetadataTask::EnsureMetadataTask(QList<Mod*>& mods, QDir dir, ModPlatform::ResourceProvider prov, bool try_others)
+    : Task(nullptr), m_index_dir(dir), m_providers{ prov }, m_current_task(nullptr)
 {
-    // Check for already computed hashes
-    // (linear on the number of mods vs. linear on the size of the mod's JAR)
-    auto it = m_mods.keyValueBegin();
-    while (it != m_mods.keyValueEnd()) {
-        if ((*it).second == mod)
-            break;
-        it++;
-    }
+    if (try_others)
+        m_providers.append(otherProvider(prov));
 
-    // We already have the hash computed
-    if (it != m_mods.keyValueEnd()) {
-        return (*it).first;
-    }
+    m_hashing_task.reset(new ConcurrentTask(this, "MakeHashesTask", 10));
+    m_hashing_task->setConcurrency(ConcurrentTask::Concurrency::CpuBound);
+    for (auto* mod : mods)
+        addHashTask(mod);
+}
 
-    // No existing hash
-    return {};
+void EnsureMetadataTask::addHashTask(Mod* mod)
+{
+    if (!mod || !mod->valid() || mod->type() == ResourceType::FOLDER)
+        return;
+
+    // every hash is made at once, whichever provider picks which
+    auto hash_task = Hashing::createHasher(mod->fileinfo().absoluteFilePath(), m_providers.first());
+    connect(hash_task.get(), &Task::succeeded, [this, hash_task, mod] { m_mods.insert(mod, hash_task->getHashes()); });
+    connect(hash_task.get(), &Task::failed, [this, mod] { emitFail(mod); });
+    m_hashing_task->addTask(hash_task);
 }
 
 bool EnsureMetadataTask::abort()
@@ -85,7 +93,7 @@ void EnsureMetadataTask::executeTask()
 {
     setStatus(tr("Checking if mods have metadata..."));
 
-    for (auto* mod : m_mods) {
+    for (auto* mod : m_mods.keys()) {
         if (!mod->valid()) {
             qDebug() << "Mod" << mod->name() << "is invalid!";
             emitFail(mod);
@@ -93,7 +101,7 @@ void EnsureMetadataTask::executeTask()
         }
 
         // They already have the right metadata :o
-        if (mod->status() != ModStatus::NoMetadata && mod->metadata() && mod->metadata()->provider == m_provider) {
+        if (mod->status() != ModStatus::NoMetadata && mod->metadata() && m_providers.contains(mod->metadata()->provider)) {
             qDebug() << "Mod" << mod->name() << "already has metadata!";
             emitReady(mod);
             continue;
@@ -105,150 +113,206 @@ void EnsureMetadataTask::executeTask()
         }
     }
 
-    Task::Ptr version_task;
+    lookUpVersions();
+}
 
-    switch (m_provider) {
-        case (ModPlatform::ResourceProvider::MODRINTH):
-            version_task = modrinthVersionsTask();
-            break;
-        case (ModPlatform::ResourceProvider::FLAME):
-            version_task = flameVersionsTask();
-            break;
+EnsureMetadataTask::ModsByHash EnsureMetadataTask::modsByHash(ModPlatform::ResourceProvider provider)
+{
+    auto& misses = LookupMisses::instance();
+    ModsByHash mods;
+    for (auto it = m_mods.constBegin(); it != m_mods.constEnd(); it++) {
+        auto hash = lookupHash(provider, it.value());
+        if (hash.isEmpty())
+            continue;
+        if (misses.contains(provider, hash)) {
+            qDebug() << "Not asking" << ProviderCaps.readableName(provider) << "about" << it.key()->name() << "again";
+            continue;
+        }
+        mods.insert(hash, it.key());
     }
+    return mods;
+}
 
-    auto invalidade_leftover = [this] {
-        for (auto mod = m_mods.constBegin(); mod != m_mods.constEnd(); mod++)
-            emitFail(mod.value(), mod.key(), RemoveFromList::No);
-        m_mods.clear();
-
-        emitSucceeded();
-    };
+void EnsureMetadataTask::rememberMisses(ModPlatform::ResourceProvider provider, const ModsByHash& mods)
+{
+    auto& misses = LookupMisses::instance();
+    auto& found = m_temp_versions[provider];
+    for (auto it = mods.constBegin(); it != mods.constEnd(); it++) {
+        if (found.contains(it.value()))
+            misses.remove(provider, it.key());
+        else
+            misses.insert(provider, it.key());
+    }
+    misses.save();
+}
 
-    connect(version_task.get(), &Task::finished, this, [this, invalidade_leftover] {
-        Task::Ptr project_task;
+void EnsureMetadataTask::lookUpVersions()
+{
+    auto versions_task = makeShared<ConcurrentTask>(this, "MetadataVersionsTask", m_providers.size());
+    QStringList names;
+    for (auto provider : m_providers) {
+        auto mods = modsByHash(provider);
+        if (mods.isEmpty())
+            continue;
 
-        switch (m_provider) {
-            case (ModPlatform::ResourceProvider::MODRINTH):
-                project_task = modrinthProjectsTask();
+        Task::Ptr task;
+        switch (provider) {
+            case ModPlatform::ResourceProvider::MODRINTH:
+                task = modrinthVersionsTask(mods);
                 break;
-            case (ModPlatform::ResourceProvider::FLAME):
-                project_task = flameProjectsTask();
+            case ModPlatform::ResourceProvider::FLAME:
+                task = flameVersionsTask(mods);
                 break;
         }
+        // Prevents unfortunate timings when aborting the task
+        if (!task)
+            continue;
 
-        if (!project_task) {
-            invalidade_leftover();
-            return;
-        }
+        versions_task->addTask(task);
+        names.append(ProviderCaps.readableName(provider));
+    }
 
-        connect(project_task.get(), &Task::finished, this, [=] {
-            invalidade_leftover();
-            project_task->deleteLater();
-            m_current_task = nullptr;
-        });
+    if (names.isEmpty()) {
+        finish();
+        return;
+    }
+
+    if (m_mods.size() > 1)
+        setStatus(tr("Requesting metadata information from %1...").arg(names.join(tr(" and "))));
+    else if (!m_mods.empty())
+        setStatus(tr("Requesting metadata information from %1 for '%2'...").arg(names.join(tr(" and ")), m_mods.begin().key()->name()));
 
-        m_current_task = project_task;
-        project_task->start();
+    connect(versions_task.get(), &Task::finished, this, [this, versions_task] {
+        versions_task->deleteLater();
+        m_current_task = nullptr;
+        lookUpProjects();
     });
 
-    connect(version_task.get(), &Task::finished, [=] {
-        version_task->deleteLater();
+    m_current_task = versions_task;
+    versions_task->start();
+}
+
+void EnsureMetadataTask::lookUpProjects()
+{
+    // the mods go to the first provider that has them
+    QSet<Mod*> taken;
+    for (auto provider : m_providers) {
+        auto& versions = m_temp_versions[provider];
+        for (auto it = versions.begin(); it != versions.end();) {
+            if (taken.contains(it.key()) || !m_mods.contains(it.key())) {
+                it = versions.erase(it);
+            } else {
+                taken.insert(it.key());
+                it++;
+            }
+        }
+    }
+
+    auto projects_task = makeShared<ConcurrentTask>(this, "MetadataProjectsTask", m_providers.size());
+    bool any = false;
+    for (auto provider : m_providers) {
+        Task::Ptr task;
+        switch (provider) {
+            case ModPlatform::ResourceProvider::MODRINTH:
+                task = modrinthProjectsTask();
+                break;
+            case ModPlatform::ResourceProvider::FLAME:
+                task = flameProjectsTask();
+                break;
+        }
+        if (!task)
+            continue;
+        projects_task->addTask(task);
+        any = true;
+    }
+
+    if (!any) {
+        finish();
+        return;
+    }
+
+    connect(projects_task.get(), &Task::finished, this, [this, projects_task] {
+        projects_task->deleteLater();
         m_current_task = nullptr;
+        finish();
     });
 
-    if (m_mods.size() > 1)
-        setStatus(tr("Requesting metadata information from %1...").arg(ProviderCaps.readableName(m_provider)));
-    else if (!m_mods.empty())
-        setStatus(tr("Requesting metadata information from %1 for '%2'...")
-                      .arg(ProviderCaps.readableName(m_provider), m_mods.begin().value()->name()));
+    m_current_task = projects_task;
+    projects_task->start();
+}
+
+void EnsureMetadataTask::finish()
+{
+    for (auto* mod : m_mods.keys())
+        emitFail(mod);
+    m_mods.clear();
 
-    m_current_task = version_task;
-    version_task->start();
+    emitSucceeded();
 }
 
-void EnsureMetadataTask::emitReady(Mod* m, QString key, RemoveFromList remove)
+void EnsureMetadataTask::emitReady(Mod* m)
 {
     if (!m) {
         qCritical() << "Tried to mark a null mod as ready.";
-        if (!key.isEmpty())
-            m_mods.remove(key);
-
         return;
     }
 
     qDebug() << QString("Generated metadata for %1").arg(m->name());
     emit metadataReady(m);
 
-    if (remove == RemoveFromList::Yes) {
-        if (key.isEmpty())
-            key = getExistingHash(m);
-        m_mods.remove(key);
-    }
+    m_mods.remove(m);
 }
 
-void EnsureMetadataTask::emitFail(Mod* m, QString key, RemoveFromList remove)
+void EnsureMetadataTask::emitFail(Mod* m)
 {
     if (!m) {
         qCritical() << "Tried to mark a null mod as failed.";
-        if (!key.isEmpty())
-            m_mods.remove(key);
-
         return;
     }
 
     qDebug() << QString("Failed to generate metadata for %1").arg(m->name());
     emit metadataFailed(m);
 
-    if (remove == RemoveFromList::Yes) {
-        if (key.isEmpty())
-            key = getExistingHash(m);
-        m_mods.remove(key);
-    }
+    m_mods.remove(m);
 }
 
 // Modrinth
 
-Task::Ptr EnsureMetadataTask::modrinthVersionsTask()
+Task::Ptr EnsureMetadataTask::modrinthVersionsTask(const ModsByHash& mods)
 {
     auto hash_type = ProviderCaps.hashType(ModPlatform::ResourceProvider::MODRINTH).first();
 
     auto* response = new QByteArray();
-    auto ver_task = modrinth_api.currentVersions(m_mods.keys(), hash_type, response);
+    auto ver_task = modrinth_api.currentVersions(mods.keys(), hash_type, response);
 
     // Prevents unfortunate timings when aborting the task
     if (!ver_task)
         return Task::Ptr{nullptr};
 
-    connect(ver_task.get(), &Task::succeeded, this, [this, response] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from Modrinth::CurrentVersions at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-
-            failed(parse_error.errorString());
-            return;
-        }
+    auto parsed = Net::parseJson(ver_task.get(), response, "Modrinth::CurrentVersions");
+    connect(ver_task.get(), &Task::succeeded, this, [this, parsed, mods] {
+        auto& doc = *parsed;
 
         try {
             auto entries = Json::requireObject(doc);
-            for (auto& hash : m_mods.keys()) {
-                auto mod = m_mods.find(hash).value();
+            for (auto it = mods.constBegin(); it != mods.constEnd(); it++) {
+                auto* mod = it.value();
+                if (!entries.contains(it.key()))
+                    continue;
                 try {
-                    auto entry = Json::requireObject(entries, hash);
+                    auto entry = Json::requireObject(entries, it.key());
 
                     setStatus(tr("Parsing API response from Modrinth for '%1'...").arg(mod->name()));
                     qDebug() << "Getting version for" << mod->name() << "from Modrinth";
 
-                    m_temp_versions.insert(hash, Modrinth::loadIndexedPackVersion(entry));
+                    m_temp_versions[ModPlatform::ResourceProvider::MODRINTH].insert(mod, Modrinth::loadIndexedPackVersion(entry));
                 } catch (Json::JsonException& e) {
                     qDebug() << e.cause();
                     qDebug() << entries;
-
-                    emitFail(mod);
                 }
             }
+            // only an answer says that it doesn't have them
+            rememberMisses(ModPlatform::ResourceProvider::MODRINTH, mods);
         } catch (Json::JsonException& e) {
             qDebug() << e.cause();
             qDebug() << doc;
@@ -260,15 +324,16 @@ Task::Ptr EnsureMetadataTask::modrinthVersionsTask()
 
 Task::Ptr EnsureMetadataTask::modrinthProjectsTask()
 {
-    QHash<QString, QString> addonIds;
-    for (auto const& data : m_temp_versions)
-        addonIds.insert(data.addonId.toString(), data.hash);
+    auto const& versions = m_temp_versions[ModPlatform::ResourceProvider::MODRINTH];
+    QHash<QString, Mod*> addonIds;
+    for (auto it = versions.constBegin(); it != versions.constEnd(); it++)
+        addonIds.insert(it.value().addonId.toString(), it.key());
 
     auto response = new QByteArray();
     Task::Ptr proj_task;
 
     if (addonIds.isEmpty()) {
-        qWarning() << "No addonId found!";
+        return Task::Ptr{nullptr};
     } else if (addonIds.size() == 1) {
         proj_task = modrinth_api.getProject(*addonIds.keyBegin(), response);
     } else {
@@ -279,15 +344,9 @@ Task::Ptr EnsureMetadataTask::modrinthProjectsTask()
     if (!proj_task)
         return Task::Ptr{nullptr};
 
-    connect(proj_task.get(), &Task::succeeded, this, [this, response, addonIds] {
-        QJsonParseError parse_error{};
-        auto doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from Modrinth projects task at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-            return;
-        }
+    auto parsed = Net::parseJson(proj_task.get(), response, "Modrinth::GetProjects");
+    connect(proj_task.get(), &Task::succeeded, this, [this, parsed, addonIds] {
+        auto& doc = *parsed;
 
         QJsonArray entries;
 
@@ -316,10 +375,8 @@ Task::Ptr EnsureMetadataTask::modrinthProjectsTask()
                 continue;
             }
 
-            auto hash = addonIds.find(pack.addonId.toString()).value();
-
-            auto mod_iter = m_mods.find(hash);
-            if (mod_iter == m_mods.end()) {
+            auto mod_iter = addonIds.find(pack.addonId.toString());
+            if (mod_iter == addonIds.end() || !m_mods.contains(mod_iter.value())) {
                 qWarning() << "Invalid project id from the API response.";
                 continue;
             }
@@ -329,7 +386,7 @@ Task::Ptr EnsureMetadataTask::modrinthProjectsTask()
             try {
                 setStatus(tr("Parsing API response from Modrinth for '%1'...").arg(mod->name()));
 
-                modrinthCallback(pack, m_temp_versions.find(hash).value(), mod);
+                modrinthCallback(pack, m_temp_versions[ModPlatform::ResourceProvider::MODRINTH][mod], mod);
             } catch (Json::JsonException& e) {
                 qDebug() << e.cause();
                 qDebug() << entries;
@@ -343,28 +400,20 @@ Task::Ptr EnsureMetadataTask::modrinthProjectsTask()
 }
 
 // Flame
-Task::Ptr EnsureMetadataTask::flameVersionsTask()
+Task::Ptr EnsureMetadataTask::flameVersionsTask(const ModsByHash& mods)
 {
     auto* response = new QByteArray();
 
     QList<uint> fingerprints;
-    for (auto& murmur : m_mods.keys()) {
+    for (auto& murmur : mods.keys()) {
         fingerprints.push_back(murmur.toUInt());
     }
 
     auto ver_task = flame_api.matchFingerprints(fingerprints, response);
 
-    connect(ver_task.get(), &Task::succeeded, this, [this, response] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from Modrinth::CurrentVersions at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-
-            failed(parse_error.errorString());
-            return;
-        }
+    auto parsed = Net::parseJson(ver_task.get(), response, "Flame::MatchFingerprints");
+    connect(ver_task.get(), &Task::succeeded, this, [this, parsed, mods] {
+        auto& doc = *parsed;
 
         try {
             auto doc_obj = Json::requireObject(doc);
@@ -374,6 +423,7 @@ Task::Ptr EnsureMetadataTask::flameVersionsTask()
             if (data_arr.isEmpty()) {
                 qWarning() << "No matches found for fingerprint search!";
 
+                rememberMisses(ModPlatform::ResourceProvider::FLAME, mods);
                 return;
             }
 
@@ -388,16 +438,17 @@ Task::Ptr EnsureMetadataTask::flameVersionsTask()
                 }
 
                 auto fingerprint = QString::number(Json::ensureVariant(file_obj, "fileFingerprint").toUInt());
-                auto mod = m_mods.find(fingerprint);
-                if (mod == m_mods.end()) {
+                auto mod = mods.find(fingerprint);
+                if (mod == mods.end()) {
                     qWarning() << "Invalid fingerprint from the API response.";
                     continue;
                 }
 
                 setStatus(tr("Parsing API response from CurseForge for '%1'...").arg((*mod)->name()));
 
-                m_temp_versions.insert(fingerprint, FlameMod::loadIndexedPackVersion(file_obj));
+                m_temp_versions[ModPlatform::ResourceProvider::FLAME].insert(*mod, FlameMod::loadIndexedPackVersion(file_obj));
             }
+            rememberMisses(ModPlatform::ResourceProvider::FLAME, mods);
 
         } catch (Json::JsonException& e) {
             qDebug() << e.cause();
@@ -410,22 +461,19 @@ Task::Ptr EnsureMetadataTask::flameVersionsTask()
 
 Task::Ptr EnsureMetadataTask::flameProjectsTask()
 {
-    QHash<QString, QString> addonIds;
-    for (auto const& hash : m_mods.keys()) {
-        if (m_temp_versions.contains(hash)) {
-            auto const& data = m_temp_versions.find(hash).value();
-
-            auto id_str = data.addonId.toString();
-            if (!id_str.isEmpty())
-                addonIds.insert(data.addonId.toString(), hash);
-        }
+    auto const& versions = m_temp_versions[ModPlatform::ResourceProvider::FLAME];
+    QHash<QString, Mod*> addonIds;
+    for (auto it = versions.constBegin(); it != versions.constEnd(); it++) {
+        auto id_str = it.value().addonId.toString();
+        if (!id_str.isEmpty())
+            addonIds.insert(id_str, it.key());
     }
 
     auto response = new QByteArray();
     Task::Ptr proj_task;
 
     if (addonIds.isEmpty()) {
-        qWarning() << "No addonId found!";
+        return Task::Ptr{nullptr};
     } else if (addonIds.size() == 1) {
         proj_task = flame_api.getProject(*addonIds.keyBegin(), response);
     } else {
@@ -436,15 +484,9 @@ Task::Ptr EnsureMetadataTask::flameProjectsTask()
     if (!proj_task)
         return Task::Ptr{nullptr};
 
-    connect(proj_task.get(), &Task::succeeded, this, [this, response, addonIds] {
-        QJsonParseError parse_error{};
-        auto doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from Modrinth projects task at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-            return;
-        }
+    auto parsed = Net::parseJson(proj_task.get(), response, "Flame::GetProjects");
+    connect(proj_task.get(), &Task::succeeded, this, [this, parsed, addonIds] {
+        auto& doc = *parsed;
 
         try {
             QJsonArray entries;
@@ -457,8 +499,12 @@ Task::Ptr EnsureMetadataTask::flameProjectsTask()
                 auto entry_obj = Json::requireObject(entry);
 
                 auto id = QString::number(Json::requireInteger(entry_obj, "id"));
-                auto hash = addonIds.find(id).value();
-                auto mod = m_mods.find(hash).value();
+                auto mod_iter = addonIds.find(id);
+                if (mod_iter == addonIds.end() || !m_mods.contains(mod_iter.value())) {
+                    qWarning() << "Invalid project id from the API response.";
+                    continue;
+                }
+                auto* mod = mod_iter.value();
 
                 try {
                     setStatus(tr("Parsing API response from CurseForge for '%1'...").arg(mod->name()));
@@ -466,7 +512,7 @@ Task::Ptr EnsureMetadataTask::flameProjectsTask()
                     ModPlatform::IndexedPack pack;
                     FlameMod::loadIndexedPack(pack, entry_obj);
 
-                    flameCallback(pack, m_temp_versions.find(hash).value(), mod);
+                    flameCallback(pack, m_temp_versions[ModPlatform::ResourceProvider::FLAME][mod], mod);
                 } catch (Json::JsonException& e) {
                     qDebug() << e.cause();
                     qDebug() << entries;
@@ -10,12 +10,18 @@
 class Mod;
 class QDir;
 
+/* Finds the mods on the mod platforms from the hashes of their files, and writes the metadata they need to be updated.
+ *
+ * With `try_others`, the other platform is asked at the same time as the chosen one, and the chosen one wins for the
+ * mods both of them know. The files are only hashed once for both of them. Hashes a platform didn't know are
+ * remembered for a while (see LookupMisses), so they aren't asked about again on every update check.
+ */
 class EnsureMetadataTask : public Task {
     Q_OBJECT
 
    public:
-    EnsureMetadataTask(Mod*, QDir, ModPlatform::ResourceProvider = ModPlatform::ResourceProvider::MODRINTH);
-    EnsureMetadataTask(QList<Mod*>&, QDir, ModPlatform::ResourceProvider = ModPlatform::ResourceProvider::MODRINTH);
+    EnsureMetadataTask(Mod*, QDir, ModPlatform::ResourceProvider = ModPlatform::ResourceProvider::MODRINTH, bool try_others = false);
+    EnsureMetadataTask(QList<Mod*>&, QDir, ModPlatform::ResourceProvider = ModPlatform::ResourceProvider::MODRINTH, bool try_others = false);
 
     ~EnsureMetadataTask() = default;
 
@@ -27,24 +33,29 @@ class EnsureMetadataTask : public Task {
     void executeTask() override;
 
    private:
+    using ModsByHash = QHash<QString, Mod*>;
+
     // FIXME: Move to their own namespace
-    auto modrinthVersionsTask() -> Task::Ptr;
+    auto modrinthVersionsTask(const ModsByHash& mods) -> Task::Ptr;
     auto modrinthProjectsTask() -> Task::Ptr;
 
-    auto flameVersionsTask() -> Task::Ptr;
+    auto flameVersionsTask(const ModsByHash& mods) -> Task::Ptr;
     auto flameProjectsTask() -> Task::Ptr;
 
+    void lookUpVersions();
+    void lookUpProjects();
+    void finish();
+
     // Helpers
-    enum class RemoveFromList {
-        Yes,
-        No
-    };
-    void emitReady(Mod*, QString key = {}, RemoveFromList = RemoveFromList::Yes);
-    void emitFail(Mod*, QString key = {}, RemoveFromList = RemoveFromList::Yes);
+    void addHashTask(Mod*);
+    void emitReady(Mod*);
+    void emitFail(Mod*);
 
-    // Hashes and stuff
-    auto createNewHash(Mod*) -> Hashing::Hasher::Ptr;
-    auto getExistingHash(Mod*) -> QString;
+    /* The mods still waiting for metadata, by the hash `provider` knows their files by. Leaves out the ones it didn't
+     * know recently. */
+    auto modsByHash(ModPlatform::ResourceProvider provider) -> ModsByHash;
+    /* Remembers the mods `provider` didn't have a version for. */
+    void rememberMisses(ModPlatform::ResourceProvider provider, const ModsByHash& mods);
 
    private slots:
     void modrinthCallback(ModPlatform::IndexedPack& pack, ModPlatform::IndexedVersion& ver, Mod*);
@@ -55,11 +66,14 @@ class EnsureMetadataTask : public Task {
     void metadataFailed(Mod*);
 
    private:
-    QHash<QString, Mod*> m_mods;
+    // the mods still waiting for metadata, with the hashes of their files
+    QHash<Mod*, Hashing::FileHashes> m_mods;
     QDir m_index_dir;
-    ModPlatform::ResourceProvider m_provider;
+    // in the order of preference
+    QList<ModPlatform::ResourceProvider> m_providers;
 
-    QHash<QString, ModPlatform::IndexedVersion> m_temp_versions;
+    // the versions each provider has of the mods, only the preferred one keeps a mod once all of them answered
+    QMap<ModPlatform::ResourceProvider, QHash<Mod*, ModPlatform::IndexedVersion>> m_temp_versions;
     ConcurrentTask::Ptr m_hashing_task;
     Task::Ptr m_current_task;
 };
@@ -19,6 +19,8 @@
 #include "modplatform/ModIndex.h"
 
 #include <QCryptographicHash>
+
+#include "digest/Digest.h"
 #include <QDebug>
 #include <QIODevice>
 
@@ -69,11 +71,11 @@ auto ProviderCapabilities::hash(ResourceProvider p, QIODevice* device, QString t
             break;
     }
 
-    QCryptographicHash hash(algo);
+    Digest hash(algo);
     if(!hash.addData(device))
         qCritical() << "Failed to read JAR to create hash!";
 
-    Q_ASSERT(hash.result().length() == hash.hashLength(algo));
+    Q_ASSERT(hash.result().length() == QCryptographicHash::hashLength(algo));
     return { hash.result().toHex() };
 }
 
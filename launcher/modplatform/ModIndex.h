@@ -52,6 +52,15 @@ struct DonationData {
     QString url;
 };
 
+enum class DependencyType { REQUIRED, OPTIONAL, INCOMPATIBLE, EMBEDDED, TOOL, INCLUDE, UNKNOWN };
+
+struct Dependency {
+    QVariant addonId;
+    DependencyType type;
+    // the version it has to be, when it's pinned to one
+    QVariant version;
+};
+
 struct IndexedVersion {
     QVariant addonId;
     QVariant fileId;
@@ -66,6 +75,7 @@ struct IndexedVersion {
     QString hash;
     bool is_preferred = true;
     QString changelog;
+    QList<Dependency> dependencies;
 
     // For internal use, not provided by APIs
     bool is_currently_selected = false;
@@ -40,6 +40,7 @@
 
 #include <quazip/quazip.h>
 
+#include "Executors.h"
 #include "MMCZip.h"
 #include "minecraft/OneSixVersionFormat.h"
 #include "Version.h"
@@ -67,6 +68,7 @@ PackInstallTask::PackInstallTask(UserInteractionSupport *support, QString packNa
     m_pack_safe_name = packName.replace(QRegularExpression("[^A-Za-z0-9]"), "");
     m_version_name = version;
     m_install_mode = installMode;
+    m_modPool.setMaxThreadCount(QThread::idealThreadCount());
 }
 
 bool PackInstallTask::abort()
@@ -675,6 +677,11 @@ void PackInstallTask::installConfigs()
     connect(jobPtr.get(), &NetJob::failed, [&](QString reason)
     {
         abortable = false;
+        if (!isRunning())
+        {
+            jobPtr.reset();
+            return;
+        }
         jobPtr.reset();
         emitFailed(reason);
     });
@@ -708,9 +715,9 @@ void PackInstallTask::extractConfigs()
     }
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), QOverload<QString, QString>::of(MMCZip::extractDir), archivePath, extractDir.absolutePath() + "/minecraft");
+    m_extractFuture = QtConcurrent::run(Executors::io(), QOverload<QString, QString>::of(MMCZip::extractDir), archivePath, extractDir.absolutePath() + "/minecraft");
 #else
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), MMCZip::extractDir, archivePath, extractDir.absolutePath() + "/minecraft");
+    m_extractFuture = QtConcurrent::run(Executors::io(), MMCZip::extractDir, archivePath, extractDir.absolutePath() + "/minecraft");
 #endif
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, [&]()
     {
@@ -776,44 +783,21 @@ void PackInstallTask::downloadMods()
         QFileInfo fileName(mod.file);
         auto cacheName = fileName.completeBaseName() + "-" + mod.md5 + "." + fileName.suffix();
 
+        auto entry = APPLICATION->metacache()->resolveEntry("ATLauncherPacks", cacheName);
+        entry->setStale(true);
+        auto modPath = entry->getFullPath();
+
+        std::function<bool()> unit;
         if (mod.type == ModType::Extract || mod.type == ModType::TexturePackExtract || mod.type == ModType::ResourcePackExtract) {
-            auto entry = APPLICATION->metacache()->resolveEntry("ATLauncherPacks", cacheName);
-            entry->setStale(true);
-            modsToExtract.insert(entry->getFullPath(), mod);
-
-            auto dl = Net::Download::makeCached(url, entry);
-            if (!mod.md5.isEmpty()) {
-                auto rawMd5 = QByteArray::fromHex(mod.md5.toLatin1());
-                dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Md5, rawMd5));
-            }
-            jobPtr->addNetAction(dl);
+            unit = [this, modPath, mod] { return extractMod(modPath, mod); };
         }
         else if(mod.type == ModType::Decomp) {
-            auto entry = APPLICATION->metacache()->resolveEntry("ATLauncherPacks", cacheName);
-            entry->setStale(true);
-            modsToDecomp.insert(entry->getFullPath(), mod);
-
-            auto dl = Net::Download::makeCached(url, entry);
-            if (!mod.md5.isEmpty()) {
-                auto rawMd5 = QByteArray::fromHex(mod.md5.toLatin1());
-                dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Md5, rawMd5));
-            }
-            jobPtr->addNetAction(dl);
+            unit = [this, modPath, mod] { return decompMod(modPath, mod); };
         }
         else {
             auto relpath = getDirForModType(mod.type, mod.type_raw);
             if(relpath == Q_NULLPTR) continue;
 
-            auto entry = APPLICATION->metacache()->resolveEntry("ATLauncherPacks", cacheName);
-            entry->setStale(true);
-
-            auto dl = Net::Download::makeCached(url, entry);
-            if (!mod.md5.isEmpty()) {
-                auto rawMd5 = QByteArray::fromHex(mod.md5.toLatin1());
-                dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Md5, rawMd5));
-            }
-            jobPtr->addNetAction(dl);
-
             auto path = FS::PathCombine(m_stagingPath, "minecraft", relpath, mod.file);
 
             if(mod.type == ModType::Forge) {
@@ -834,15 +818,31 @@ void PackInstallTask::downloadMods()
 
             // Download after Forge handling, to avoid downloading Forge twice.
             qDebug() << "Will download" << url << "to" << path;
-            modsToCopy[entry->getFullPath()] = path;
+            unit = [modPath, path] { return copyMod(modPath, path); };
         }
+
+        auto dl = Net::Download::makeCached(url, entry);
+        if (!mod.md5.isEmpty()) {
+            auto rawMd5 = QByteArray::fromHex(mod.md5.toLatin1());
+            dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Md5, rawMd5));
+        }
+        // each mod is put in place as soon as it's there, instead of waiting for all the others
+        connect(dl.get(), &Net::Download::succeeded, this, [this, unit] { startModUnit(unit); });
+        jobPtr->addNetAction(dl);
     }
 
+    m_modsDownloaded = false;
+    m_modUnitsRunning = 0;
+    m_modUnitFailed = false;
+
     connect(jobPtr.get(), &NetJob::succeeded, this, &PackInstallTask::onModsDownloaded);
     connect(jobPtr.get(), &NetJob::failed, [&](QString reason)
     {
         abortable = false;
         jobPtr.reset();
+        if (!isRunning())
+            return;
+        stopModUnits();
         emitFailed(reason);
     });
     connect(jobPtr.get(), &NetJob::progress, [&](qint64 current, qint64 total)
@@ -856,120 +856,138 @@ void PackInstallTask::downloadMods()
     {
         abortable = false;
         jobPtr.reset();
+        // also when a mod failed to extract and the task gave up already
+        if (!isRunning())
+            return;
+        stopModUnits();
         emitAborted();
     });
 
     jobPtr->start();
 }
 
+void PackInstallTask::startModUnit(std::function<bool()> unit)
+{
+    if (m_modUnitFailed || !isRunning())
+        return;
+
+    m_modUnitsRunning++;
+    auto watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher] {
+        watcher->deleteLater();
+        m_modUnitsRunning--;
+        if (!watcher->future().result())
+            m_modUnitFailed = true;
+        onModUnitFinished();
+    });
+    watcher->setFuture(QtConcurrent::run(&m_modPool, unit));
+}
+
+void PackInstallTask::stopModUnits()
+{
+    // the staging folder goes away once the task is done, so nothing may still be writing in it
+    m_modPool.clear();
+    m_modPool.waitForDone();
+}
+
 void PackInstallTask::onModsDownloaded() {
     abortable = false;
 
     qDebug() << "PackInstallTask::onModsDownloaded: " << QThread::currentThreadId();
     jobPtr.reset();
 
-    if(!modsToExtract.empty() || !modsToDecomp.empty() || !modsToCopy.empty()) {
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        m_modExtractFuture = QtConcurrent::run(QThreadPool::globalInstance(), &PackInstallTask::extractMods, this, modsToExtract, modsToDecomp, modsToCopy);
-#else
-        m_modExtractFuture = QtConcurrent::run(QThreadPool::globalInstance(), this, &PackInstallTask::extractMods, modsToExtract, modsToDecomp, modsToCopy);
-#endif
-        connect(&m_modExtractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &PackInstallTask::onModsExtracted);
-        connect(&m_modExtractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, [&]()
-        {
-            emitAborted();
-        });
-        m_modExtractFutureWatcher.setFuture(m_modExtractFuture);
-    }
-    else {
-        install();
+    m_modsDownloaded = true;
+    if (m_modUnitsRunning > 0) {
+        setStatus(tr("Extracting mods..."));
+        setDetails(tr("%n mod(s) left", "", m_modUnitsRunning));
     }
+    onModUnitFinished();
 }
 
-void PackInstallTask::onModsExtracted() {
-    qDebug() << "PackInstallTask::onModsExtracted: " << QThread::currentThreadId();
-    if(m_modExtractFuture.result()) {
-        install();
-    }
-    else {
+void PackInstallTask::onModUnitFinished() {
+    if (m_modUnitFailed && isRunning()) {
+        abortable = false;
+        stopModUnits();
         emitFailed(tr("Failed to extract mods..."));
+        // the other downloads aren't of any use anymore
+        if (jobPtr)
+            jobPtr->abort();
+        return;
     }
-}
-
-bool PackInstallTask::extractMods(
-    const QMap<QString, VersionMod> &toExtract,
-    const QMap<QString, VersionMod> &toDecomp,
-    const QMap<QString, QString> &toCopy
-) {
-    qDebug() << "PackInstallTask::extractMods: " << QThread::currentThreadId();
-
-    setStatus(tr("Extracting mods..."));
-    for (auto iter = toExtract.begin(); iter != toExtract.end(); iter++) {
-        auto &modPath = iter.key();
-        auto &mod = iter.value();
-
-        QString extractToDir;
-        if(mod.type == ModType::Extract) {
-            extractToDir = getDirForModType(mod.extractTo, mod.extractTo_raw);
-        }
-        else if(mod.type == ModType::TexturePackExtract) {
-            extractToDir = FS::PathCombine("texturepacks", "extracted");
-        }
-        else if(mod.type == ModType::ResourcePackExtract) {
-            extractToDir = FS::PathCombine("resourcepacks", "extracted");
-        }
+    if (!m_modsDownloaded || !isRunning())
+        return;
 
-        QDir extractDir(m_stagingPath);
-        auto extractToPath = FS::PathCombine(extractDir.absolutePath(), "minecraft", extractToDir);
+    if (m_modUnitsRunning > 0) {
+        setDetails(tr("%n mod(s) left", "", m_modUnitsRunning));
+        return;
+    }
 
-        QString folderToExtract = "";
-        if(mod.type == ModType::Extract) {
-            folderToExtract = mod.extractFolder;
-            folderToExtract.remove(QRegularExpression("^/"));
-        }
+    qDebug() << "PackInstallTask::onModUnitFinished: " << QThread::currentThreadId();
+    install();
+}
 
-        qDebug() << "Extracting " + mod.file + " to " + extractToDir;
-        if(!MMCZip::extractDir(modPath, folderToExtract, extractToPath)) {
-            // assume error
-            return false;
-        }
+bool PackInstallTask::extractMod(const QString &modPath, const VersionMod &mod)
+{
+    QString extractToDir;
+    if(mod.type == ModType::Extract) {
+        extractToDir = getDirForModType(mod.extractTo, mod.extractTo_raw);
+    }
+    else if(mod.type == ModType::TexturePackExtract) {
+        extractToDir = FS::PathCombine("texturepacks", "extracted");
+    }
+    else if(mod.type == ModType::ResourcePackExtract) {
+        extractToDir = FS::PathCombine("resourcepacks", "extracted");
     }
 
-    for (auto iter = toDecomp.begin(); iter != toDecomp.end(); iter++) {
-        auto &modPath = iter.key();
-        auto &mod = iter.value();
-        auto extractToDir = getDirForModType(mod.decompType, mod.decompType_raw);
+    QDir extractDir(m_stagingPath);
+    auto extractToPath = FS::PathCombine(extractDir.absolutePath(), "minecraft", extractToDir);
 
-        QDir extractDir(m_stagingPath);
-        auto extractToPath = FS::PathCombine(extractDir.absolutePath(), "minecraft", extractToDir, mod.decompFile);
+    QString folderToExtract = "";
+    if(mod.type == ModType::Extract) {
+        folderToExtract = mod.extractFolder;
+        folderToExtract.remove(QRegularExpression("^/"));
+    }
 
-        qDebug() << "Extracting " + mod.decompFile + " to " + extractToDir;
-        if(!MMCZip::extractFile(modPath, mod.decompFile, extractToPath)) {
-            qWarning() << "Failed to extract" << mod.decompFile;
-            return false;
-        }
+    qDebug() << "Extracting " + mod.file + " to " + extractToDir;
+    if(!MMCZip::extractDir(modPath, folderToExtract, extractToPath)) {
+        qWarning() << "Failed to extract" << mod.file;
+        return false;
     }
+    return true;
+}
 
-    for (auto iter = toCopy.begin(); iter != toCopy.end(); iter++) {
-        auto &from = iter.key();
-        auto &to = iter.value();
+bool PackInstallTask::decompMod(const QString &modPath, const VersionMod &mod)
+{
+    auto extractToDir = getDirForModType(mod.decompType, mod.decompType_raw);
 
-        // If the file already exists, assume the mod is the correct copy - and remove
-        // the copy from the Configs.zip
-        QFileInfo fileInfo(to);
-        if (fileInfo.exists()) {
-            if (!QFile::remove(to)) {
-                qWarning() << "Failed to delete" << to;
-                return false;
-            }
-        }
+    QDir extractDir(m_stagingPath);
+    auto extractToPath = FS::PathCombine(extractDir.absolutePath(), "minecraft", extractToDir, mod.decompFile);
 
-        FS::copy fileCopyOperation(from, to);
-        if(!fileCopyOperation()) {
-            qWarning() << "Failed to copy" << from << "to" << to;
+    qDebug() << "Extracting " + mod.decompFile + " to " + extractToDir;
+    if(!MMCZip::extractFile(modPath, mod.decompFile, extractToPath)) {
+        qWarning() << "Failed to extract" << mod.decompFile;
+        return false;
+    }
+    return true;
+}
+
+bool PackInstallTask::copyMod(const QString &from, const QString &to)
+{
+    // If the file already exists, assume the mod is the correct copy - and remove
+    // the copy from the Configs.zip
+    QFileInfo fileInfo(to);
+    if (fileInfo.exists()) {
+        if (!QFile::remove(to)) {
+            qWarning() << "Failed to delete" << to;
             return false;
         }
     }
+
+    FS::copy fileCopyOperation(from, to);
+    if(!fileCopyOperation()) {
+        qWarning() << "Failed to copy" << from << "to" << to;
+        return false;
+    }
     return true;
 }
 
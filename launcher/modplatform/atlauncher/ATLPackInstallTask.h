@@ -46,6 +46,9 @@
 #include "minecraft/PackProfile.h"
 #include "meta/Version.h"
 
+#include <QThreadPool>
+
+#include <functional>
 #include <optional>
 
 namespace ATLauncher {
@@ -96,7 +99,7 @@ private slots:
     void onDownloadAborted();
 
     void onModsDownloaded();
-    void onModsExtracted();
+    void onModUnitFinished();
 
 private:
     QString getDirForModType(ModType type, QString raw);
@@ -110,11 +113,12 @@ private:
     void installConfigs();
     void extractConfigs();
     void downloadMods();
-    bool extractMods(
-        const QMap<QString, VersionMod> &toExtract,
-        const QMap<QString, VersionMod> &toDecomp,
-        const QMap<QString, QString> &toCopy
-    );
+    void startModUnit(std::function<bool()> unit);
+    void stopModUnits();
+    // the units of work of the mods, run on the mod pool as soon as their download is done
+    bool extractMod(const QString &modPath, const VersionMod &mod);
+    bool decompMod(const QString &modPath, const VersionMod &mod);
+    static bool copyMod(const QString &from, const QString &to);
     void install();
 
 private:
@@ -131,10 +135,6 @@ private:
     QString m_version_name;
     PackVersion m_version;
 
-    QMap<QString, VersionMod> modsToExtract;
-    QMap<QString, VersionMod> modsToDecomp;
-    QMap<QString, QString> modsToCopy;
-
     QString archivePath;
     QStringList jarmods;
     Meta::Version::Ptr minecraftVersion;
@@ -143,8 +143,11 @@ private:
     QFuture<std::optional<QStringList>> m_extractFuture;
     QFutureWatcher<std::optional<QStringList>> m_extractFutureWatcher;
 
-    QFuture<bool> m_modExtractFuture;
-    QFutureWatcher<bool> m_modExtractFutureWatcher;
+    bool m_modsDownloaded = false;
+    int m_modUnitsRunning = 0;
+    bool m_modUnitFailed = false;
+    // last, so it waits for its workers before anything they use goes away
+    QThreadPool m_modPool;
 
 };
 
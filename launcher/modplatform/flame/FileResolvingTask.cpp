@@ -64,9 +64,7 @@ void Flame::FileResolvingTask::executeTask()
 void Flame::FileResolvingTask::netJobFinished()
 {
     setProgress(1, 3);
-    // job to check modrinth for blocked projects
-    m_checkJob.reset(new NetJob("Modrinth check", m_network));
-    blockedProjects = QMap<File*, std::shared_ptr<QByteArray>>();
+    blockedProjects.clear();
 
     QJsonDocument doc;
     QJsonArray array;
@@ -83,38 +81,52 @@ void Flame::FileResolvingTask::netJobFinished()
         return;
     }
 
+    QList<int> resolved;
+    QJsonArray hashes;
     for (QJsonValueRef file : array) {
         auto fileid = Json::requireInteger(Json::requireObject(file)["id"]);
         auto& out = m_toProcess.files[fileid];
         try {
            out.parseFromObject(Json::requireObject(file));
+           resolved.append(fileid);
         } catch (const JSONValidationError& e) {
             qDebug() << "Blocked mod on curseforge" << out.fileName;
-            auto hash = out.hash;
-            if(!hash.isEmpty()) {
-                auto url = QString("https://api.modrinth.com/v2/version_file/%1?algorithm=sha1").arg(hash);
-                auto output = std::make_shared<QByteArray>();
-                auto dl = Net::Download::makeByteArray(QUrl(url), output.get());
-                QObject::connect(dl.get(), &Net::Download::succeeded, [&out]() {
-                    out.resolved = true;
-                });
-
-                m_checkJob->addNetAction(dl);
-                blockedProjects.insert(&out, output);
+            if (!out.hash.isEmpty()) {
+                blockedProjects.append(&out);
+                hashes.append(out.hash);
             }
         }
     }
+    // These can be downloaded while we look for the other ones
+    if (!resolved.isEmpty())
+        emit filesResolved(resolved);
+
+    if (blockedProjects.isEmpty()) {
+        modrinthCheckFinished();
+        return;
+    }
+
+    // look for all the blocked projects on modrinth at once
+    m_checkJob.reset(new NetJob("Modrinth check", m_network));
+    m_modrinthResult = std::make_shared<QByteArray>();
+    QJsonObject request;
+    request["hashes"] = hashes;
+    request["algorithm"] = "sha1";
+    m_checkJob->addNetAction(
+        Net::Upload::makeByteArray(QUrl("https://api.modrinth.com/v2/version_files"), m_modrinthResult.get(), Json::toText(request)));
+
     auto step_progress = std::make_shared<TaskStepProgress>();
+    connect(m_checkJob.get(), &NetJob::succeeded, this, [step_progress]() { step_progress->state = TaskStepState::Succeeded; });
+    connect(m_checkJob.get(), &NetJob::failed, this, [step_progress](QString reason) {
+        // not finding them on modrinth isn't a reason to stop
+        qWarning() << "Failed to look for blocked mods on modrinth:" << reason;
+        step_progress->state = TaskStepState::Failed;
+        step_progress->status = reason;
+    });
     connect(m_checkJob.get(), &NetJob::finished, this, [this, step_progress]() {
-        step_progress->state = TaskStepState::Succeeded;
         stepProgress(*step_progress);
         modrinthCheckFinished();
     });
-    connect(m_checkJob.get(), &NetJob::failed, this, [this, step_progress](QString reason) {
-        step_progress->state = TaskStepState::Failed;
-        stepProgress(*step_progress);
-        emitFailed(reason);
-    });
     connect(m_checkJob.get(), &NetJob::stepProgress, this, &FileResolvingTask::propogateStepProgress);
     connect(m_checkJob.get(), &NetJob::progress, this, [this, step_progress](qint64 current, qint64 total) {
         qDebug() << "Resolve slug progress" << current << total;
@@ -133,31 +145,31 @@ void Flame::FileResolvingTask::modrinthCheckFinished() {
     setProgress(2, 3);
     qDebug() << "Finished with blocked mods : " << blockedProjects.size();
 
-    for (auto it = blockedProjects.keyBegin(); it != blockedProjects.keyEnd(); it++) {
-        auto &out = *it;
-        auto bytes = blockedProjects[out];
-        if (!out->resolved) {
+    // a version for each of the hashes found
+    auto versions = m_modrinthResult ? QJsonDocument::fromJson(*m_modrinthResult).object() : QJsonObject();
+    QList<int> resolved;
+    for (auto out : blockedProjects) {
+        auto obj = versions.value(out->hash).toObject();
+        if (obj.isEmpty())
             continue;
-        }
-
-        QJsonDocument doc = QJsonDocument::fromJson(*bytes);
-        auto obj = doc.object();
         auto file = Modrinth::loadIndexedPackVersion(obj);
 
         // If there's more than one mod loader for this version, we can't know for sure
         // which file is relative to each loader, so it's best to not use any one and
         // let the user download it manually.
-        if (file.loaders.size() <= 1) {
+        if (file.loaders.size() <= 1 && !file.downloadUrl.isEmpty()) {
             out->url = file.downloadUrl;
+            out->resolved = true;
+            resolved.append(out->fileId);
             qDebug() << "Found alternative on modrinth " << out->fileName;
-        } else {
-            out->resolved = false;
         }
     }
+    if (!resolved.isEmpty())
+        emit filesResolved(resolved);
+
     //copy to an output list and filter out projects found on modrinth
     auto block = std::make_shared<QList<File*>>();
-    auto it = blockedProjects.keys();
-    std::copy_if(it.begin(), it.end(), std::back_inserter(*block), [](File *f) {
+    std::copy_if(blockedProjects.begin(), blockedProjects.end(), std::back_inserter(*block), [](File *f) {
         return !f->resolved;
     });
     //Display not found mods early
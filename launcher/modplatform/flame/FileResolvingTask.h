@@ -16,6 +16,10 @@ class FileResolvingTask : public Task {
 
     const Flame::Manifest& getResults() const { return m_toProcess; }
 
+   signals:
+    /** Emitted as soon as the URLs of some files are known, with their file IDs. */
+    void filesResolved(const QList<int>& fileIds);
+
    protected:
     virtual void executeTask() override;
 
@@ -28,10 +32,11 @@ class FileResolvingTask : public Task {
     std::shared_ptr<QByteArray> result;
     NetJob::Ptr m_dljob;
     NetJob::Ptr m_checkJob;
+    std::shared_ptr<QByteArray> m_modrinthResult;
     NetJob::Ptr m_slugJob;
 
     void modrinthCheckFinished();
 
-    QMap<File*, std::shared_ptr<QByteArray>> blockedProjects;
+    QList<File*> blockedProjects;
 };
 }  // namespace Flame
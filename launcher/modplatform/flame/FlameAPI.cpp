@@ -8,6 +8,8 @@
 #include "Application.h"
 #include "BuildConfig.h"
 #include "Json.h"
+#include "modplatform/helpers/ProjectCache.h"
+#include "net/JsonResponse.h"
 #include "net/NetJob.h"
 #include "net/Upload.h"
 
@@ -33,131 +35,77 @@ Task::Ptr FlameAPI::matchFingerprints(const QList<uint>& fingerprints, QByteArra
     return netJob;
 }
 
-auto FlameAPI::getModFileChangelog(int modId, int fileId) -> QString
+Task::Ptr FlameAPI::getProjectInfo(ProjectInfoArgs&& args, ProjectInfoCallbacks&& callbacks) const
 {
-    QEventLoop lock;
-    QString changelog;
-
-    auto netJob = makeShared<NetJob>(QString("Flame::FileChangelog"), APPLICATION->network());
-    auto response = std::make_shared<QByteArray>();
-    netJob->addNetAction(Net::Download::makeByteArray(
-        QString("https://api.curseforge.com/v1/mods/%1/files/%2/changelog")
-            .arg(QString::fromStdString(std::to_string(modId)), QString::fromStdString(std::to_string(fileId))),
-        response.get()));
-
-    QObject::connect(netJob.get(), &NetJob::succeeded, [&netJob, response, &changelog] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from Flame::FileChangelog at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-
-            netJob->failed(parse_error.errorString());
-            return;
-        }
-
-        changelog = Json::ensureString(doc.object(), "data");
+    auto response = new QByteArray();
+    auto job = getProject(args.pack.addonId.toString(), response);
+    auto net_job = qobject_cast<NetJob*>(job.get());
+    if (!net_job)
+        return nullptr;
+
+    // the description comes at the same time as the rest, with a request of its own
+    auto description_response = new QByteArray();
+    ProjectCache::fetch(net_job, QString("https://api.curseforge.com/v1/mods/%1/description").arg(args.pack.addonId.toString()),
+                        description_response);
+    QObject::connect(net_job, &NetJob::finished, [description_response] { delete description_response; });
+
+    auto doc = Net::parseJson(job.get(), response, "Flame::GetProject");
+    auto description = Net::processJson<QString>(job.get(), description_response, "Flame::ModDescription",
+                                                 [](const QJsonDocument& doc) { return Json::ensureString(doc.object(), "data"); });
+    QObject::connect(net_job, &NetJob::succeeded, [doc, description, callbacks, args] {
+        // next to "data", which is how the project comes
+        auto obj = doc->object();
+        obj.insert("description", *description);
+        QJsonDocument with_description(obj);
+        callbacks.on_succeed(with_description, args.pack);
     });
 
-    QObject::connect(netJob.get(), &NetJob::finished, [&lock] { lock.quit(); });
-
-    netJob->start();
-    lock.exec();
-
-    return changelog;
+    return job;
 }
 
-auto FlameAPI::getModDescription(int modId) -> QString
+Task::Ptr FlameAPI::getDescription(int modId, QByteArray* response) const
 {
-    QEventLoop lock;
-    QString description;
-
     auto netJob = makeShared<NetJob>(QString("Flame::ModDescription"), APPLICATION->network());
-    auto response = std::make_shared<QByteArray>();
-    netJob->addNetAction(Net::Download::makeByteArray(
-        QString("https://api.curseforge.com/v1/mods/%1/description").arg(QString::number(modId)), response.get()));
-
-    QObject::connect(netJob.get(), &NetJob::succeeded, [&netJob, response, &description] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from Flame::ModDescription at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-
-            netJob->failed(parse_error.errorString());
-            return;
-        }
+    netJob->setPriority(Net::Priority::Interactive);
 
-        description = Json::ensureString(doc.object(), "data");
-    });
+    netJob->addNetAction(
+        Net::Download::makeByteArray(QString("https://api.curseforge.com/v1/mods/%1/description").arg(QString::number(modId)), response));
 
-    QObject::connect(netJob.get(), &NetJob::finished, [&lock] { lock.quit(); });
-
-    netJob->start();
-    lock.exec();
+    QObject::connect(netJob.get(), &NetJob::finished, [response] { delete response; });
 
-    return description;
+    return netJob;
 }
 
-auto FlameAPI::getLatestVersion(VersionSearchArgs&& args) -> ModPlatform::IndexedVersion
+auto FlameAPI::getLatestVersion(QJsonDocument& doc) -> ModPlatform::IndexedVersion
 {
-    auto versions_url_optional = getVersionsURL(args);
-    if (!versions_url_optional.has_value())
-        return {};
-
-    auto versions_url = versions_url_optional.value();
-
-    QEventLoop loop;
-
-    auto netJob = makeShared<NetJob>(QString("Flame::GetLatestVersion(%1)").arg(args.pack.name), APPLICATION->network());
-    auto response = std::make_shared<QByteArray>();
-    ModPlatform::IndexedVersion ver;
-
-    netJob->addNetAction(Net::Download::makeByteArray(versions_url, response.get()));
-
-    QObject::connect(netJob.get(), &NetJob::succeeded, [response, args, &ver] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from latest mod version at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-            return;
+    auto obj = Json::requireObject(doc);
+    auto arr = Json::requireArray(obj, "data");
+
+    QJsonObject latest_file_obj;
+    ModPlatform::IndexedVersion ver_tmp;
+
+    for (auto file : arr) {
+        auto file_obj = Json::requireObject(file);
+        auto file_tmp = FlameMod::loadIndexedPackVersion(file_obj);
+        if(file_tmp.date > ver_tmp.date) {
+            ver_tmp = file_tmp;
+            latest_file_obj = file_obj;
         }
+    }
 
-        try {
-            auto obj = Json::requireObject(doc);
-            auto arr = Json::requireArray(obj, "data");
-
-            QJsonObject latest_file_obj;
-            ModPlatform::IndexedVersion ver_tmp;
-
-            for (auto file : arr) {
-                auto file_obj = Json::requireObject(file);
-                auto file_tmp = FlameMod::loadIndexedPackVersion(file_obj);
-                if(file_tmp.date > ver_tmp.date) {
-                    ver_tmp = file_tmp;
-                    latest_file_obj = file_obj;
-                }
-            }
-
-            ver = FlameMod::loadIndexedPackVersion(latest_file_obj);
-        } catch (Json::JsonException& e) {
-            qCritical() << "Failed to parse response from a version request.";
-            qCritical() << e.what();
-            qDebug() << doc;
-        }
-    });
+    return FlameMod::loadIndexedPackVersion(latest_file_obj);
+}
 
-    QObject::connect(netJob.get(), &NetJob::finished, [&loop] { loop.quit(); });
+Task::Ptr FlameAPI::getFileChangelog(int modId, int fileId, QByteArray* response) const
+{
+    auto netJob = makeShared<NetJob>(QString("Flame::FileChangelog"), APPLICATION->network());
 
-    netJob->start();
+    netJob->addNetAction(Net::Download::makeByteArray(
+        QString("https://api.curseforge.com/v1/mods/%1/files/%2/changelog").arg(QString::number(modId), QString::number(fileId)), response));
 
-    loop.exec();
+    QObject::connect(netJob.get(), &NetJob::finished, [response] { delete response; });
 
-    return ver;
+    return netJob;
 }
 
 Task::Ptr FlameAPI::getProjects(QStringList addonIds, QByteArray* response) const
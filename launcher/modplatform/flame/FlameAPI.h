@@ -9,10 +9,13 @@
 
 class FlameAPI : public NetworkResourceAPI {
    public:
-    auto getModFileChangelog(int modId, int fileId) -> QString;
-    auto getModDescription(int modId) -> QString;
+    /** The most recent of the files in a response to getProjectVersions(). Throws a Json::JsonException when it's malformed. */
+    static auto getLatestVersion(QJsonDocument& doc) -> ModPlatform::IndexedVersion;
 
-    auto getLatestVersion(VersionSearchArgs&& args) -> ModPlatform::IndexedVersion;
+    Task::Ptr getFileChangelog(int modId, int fileId, QByteArray* response) const;
+    Task::Ptr getDescription(int modId, QByteArray* response) const;
+    /** Gets the description along with the project, the document handed to the callback has it as "description". */
+    Task::Ptr getProjectInfo(ProjectInfoArgs&& args, ProjectInfoCallbacks&& callbacks) const override;
 
     Task::Ptr getProjects(QStringList addonIds, QByteArray* response) const override;
     Task::Ptr matchFingerprints(const QList<uint>& fingerprints, QByteArray* response);
@@ -2,14 +2,15 @@
 #include "FlameAPI.h"
 #include "FlameModIndex.h"
 
-#include <MurmurHash2.h>
 #include <memory>
 
-#include "FileSystem.h"
 #include "Json.h"
 
 #include "ResourceDownloadTask.h"
 
+#include "net/JsonResponse.h"
+#include "tasks/ConcurrentTask.h"
+
 #include "minecraft/mod/ModFolderModel.h"
 #include "minecraft/mod/ResourceFolderModel.h"
 
@@ -18,166 +19,220 @@ static FlameAPI api;
 bool FlameCheckUpdate::abort()
 {
     m_was_aborted = true;
-    if (m_net_job)
-        return m_net_job->abort();
+    if (m_task)
+        return m_task->abort();
     return true;
 }
 
-ModPlatform::IndexedPack getProjectInfo(ModPlatform::IndexedVersion& ver_info)
-{
-    ModPlatform::IndexedPack pack;
-
-    QEventLoop loop;
-
-    auto get_project_job = new NetJob("Flame::GetProjectJob", APPLICATION->network());
-
-    auto response = new QByteArray();
-    auto url = QString("https://api.curseforge.com/v1/mods/%1").arg(ver_info.addonId.toString());
-    auto dl = Net::Download::makeByteArray(url, response);
-    get_project_job->addNetAction(dl);
-
-    QObject::connect(get_project_job, &NetJob::succeeded, [response, &pack]() {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from FlameCheckUpdate at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-            return;
-        }
-
-        try {
-            auto doc_obj = Json::requireObject(doc);
-            auto data_obj = Json::requireObject(doc_obj, "data");
-            FlameMod::loadIndexedPack(pack, data_obj);
-        } catch (Json::JsonException& e) {
-            qWarning() << e.cause();
-            qDebug() << doc;
-        }
-    });
-
-    QObject::connect(get_project_job, &NetJob::finished, [&loop, get_project_job] {
-        get_project_job->deleteLater();
-        loop.quit();
-    });
-
-    get_project_job->start();
-    loop.exec();
-
-    return pack;
-}
-
-ModPlatform::IndexedVersion getFileInfo(int addonId, int fileId)
-{
-    ModPlatform::IndexedVersion ver;
-
-    QEventLoop loop;
-
-    auto get_file_info_job = new NetJob("Flame::GetFileInfoJob", APPLICATION->network());
-
-    auto response = new QByteArray();
-    auto url = QString("https://api.curseforge.com/v1/mods/%1/files/%2").arg(QString::number(addonId), QString::number(fileId));
-    auto dl = Net::Download::makeByteArray(url, response);
-    get_file_info_job->addNetAction(dl);
-
-    QObject::connect(get_file_info_job, &NetJob::succeeded, [response, &ver]() {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from FlameCheckUpdate at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-            return;
-        }
-
-        try {
-            auto doc_obj = Json::requireObject(doc);
-            auto data_obj = Json::requireObject(doc_obj, "data");
-            ver = FlameMod::loadIndexedPackVersion(data_obj);
-        } catch (Json::JsonException& e) {
-            qWarning() << e.cause();
-            qDebug() << doc;
-        }
-    });
-
-    QObject::connect(get_file_info_job, &NetJob::finished, [&loop, get_file_info_job] {
-        get_file_info_job->deleteLater();
-        loop.quit();
-    });
-
-    get_file_info_job->start();
-    loop.exec();
-
-    return ver;
-}
-
 /* Check for update:
- * - Get latest version available
+ * - Get the latest version available of all the mods, a few at a time
  * - Compare hash of the latest version with the current hash
  * - If equal, no updates, else, there's updates, so add to the list
+ * - Get whatever else is needed about those, for all of them at once
+ *
+ * The updates that need nothing else are told about as soon as their latest version is known.
+ *
+ * The changelogs aren't part of this, they're only fetched when someone wants to read them.
  * */
 void FlameCheckUpdate::executeTask()
 {
     setStatus(tr("Preparing mods for CurseForge..."));
 
-    int i = 0;
     for (auto* mod : m_mods) {
         if (!mod->enabled()) {
             emit checkFailed(mod, tr("Disabled mods won't be updated, to prevent mod duplication issues!"));
             continue;
         }
+        m_candidates.append(mod);
+    }
 
-        setStatus(tr("Getting API response from CurseForge for '%1'...").arg(mod->name()));
-        setProgress(i++, m_mods.size());
+    getLatestVersions();
+}
 
-        auto latest_ver = api.getLatestVersion({ { mod->metadata()->project_id.toString() }, m_game_versions, m_loaders });
+void FlameCheckUpdate::getLatestVersions()
+{
+    setStatus(tr("Getting the latest versions from CurseForge..."));
+
+    auto job = makeShared<ConcurrentTask>(nullptr, "Flame::GetLatestVersions", APPLICATION->settings()->get("NumberOfConcurrentDownloads").toInt());
+    for (auto* mod : m_candidates) {
+        ModPlatform::IndexedPack pack;
+        pack.addonId = mod->metadata()->project_id;
+        pack.name = mod->name();
+
+        auto versions_task = api.getProjectVersions({ pack, m_game_versions, m_loaders }, { [this, mod](QJsonDocument& doc, ModPlatform::IndexedPack) {
+            try {
+                m_latest_versions.insert(mod, FlameAPI::getLatestVersion(doc));
+            } catch (Json::JsonException& e) {
+                qCritical() << "Failed to parse response from a version request.";
+                qCritical() << e.what();
+                qDebug() << doc;
+                return;
+            }
+            if (!m_was_aborted && !needsMoreInfo(mod))
+                collectUpdate(mod);
+        } });
+        if (versions_task)
+            job->addTask(versions_task);
+    }
 
-        // Check if we were aborted while getting the latest version
+    // a few mods failing to answer doesn't prevent updating the others
+    connect(job.get(), &Task::progress, this, &FlameCheckUpdate::setProgress);
+    connect(job.get(), &Task::finished, this, [this] {
         if (m_was_aborted) {
-            aborted();
+            emitAborted();
             return;
         }
+        getMissingInfo();
+    });
 
-        setStatus(tr("Parsing the API response from CurseForge for '%1'...").arg(mod->name()));
+    m_task = job;
+    job->start();
+}
 
-        if (!latest_ver.addonId.isValid()) {
-            emit checkFailed(mod, tr("No valid version found for this mod. It's probably unavailable for the current game "
-                                     "version / mod loader."));
+void FlameCheckUpdate::getMissingInfo()
+{
+    QStringList project_ids;
+    QStringList file_ids;
+    for (auto* mod : m_candidates) {
+        auto latest_ver = m_latest_versions.value(mod);
+        if (!latest_ver.addonId.isValid() || m_collected.contains(mod))
             continue;
-        }
 
         if (latest_ver.downloadUrl.isEmpty() && latest_ver.fileId != mod->metadata()->file_id) {
-            auto pack = getProjectInfo(latest_ver);
-            auto recover_url = QString("%1/download/%2").arg(pack.websiteUrl, latest_ver.fileId.toString());
-            emit checkFailed(mod, tr("Mod has a new update available, but is not downloadable using CurseForge."), recover_url);
-
-            continue;
+            // for the website URL, to recover from that
+            project_ids.append(latest_ver.addonId.toString());
+        } else if (mod->version().isEmpty() && mod->status() != ModStatus::NotInstalled) {
+            // for the name of the current version
+            file_ids.append(mod->metadata()->file_id.toString());
         }
+    }
 
-        if (!latest_ver.hash.isEmpty() && (mod->metadata()->hash != latest_ver.hash || mod->status() == ModStatus::NotInstalled)) {
-            // Fake pack with the necessary info to pass to the download task :)
-            auto pack = std::make_shared<ModPlatform::IndexedPack>();
-            pack->name = mod->name();
-            pack->slug = mod->metadata()->slug;
-            pack->addonId = mod->metadata()->project_id;
-            pack->websiteUrl = mod->homeurl();
-            for (auto& author : mod->authors())
-                pack->authors.append({ author });
-            pack->description = mod->description();
-            pack->provider = ModPlatform::ResourceProvider::FLAME;
-
-            auto old_version = mod->version();
-            if (old_version.isEmpty() && mod->status() != ModStatus::NotInstalled) {
-                auto current_ver = getFileInfo(latest_ver.addonId.toInt(), mod->metadata()->file_id.toInt());
-                old_version = current_ver.version;
-            }
+    if (project_ids.isEmpty() && file_ids.isEmpty()) {
+        collectUpdates();
+        return;
+    }
 
-            auto download_task = makeShared<ResourceDownloadTask>(pack, latest_ver, m_mods_folder);
-            m_updatable.emplace_back(pack->name, mod->metadata()->hash, old_version, latest_ver.version,
-                                     api.getModFileChangelog(latest_ver.addonId.toInt(), latest_ver.fileId.toInt()),
-                                     ModPlatform::ResourceProvider::FLAME, download_task);
+    setStatus(tr("Getting mod information from CurseForge..."));
+
+    auto job = makeShared<ConcurrentTask>(nullptr, "Flame::GetMissingInfo");
+    if (!project_ids.isEmpty()) {
+        auto response = new QByteArray();
+        auto projects_task = api.getProjects(project_ids, response);
+        auto projects = Net::processJson<QList<ModPlatform::IndexedPack>>(
+            projects_task.get(), response, "FlameCheckUpdate::getProjects", [](const QJsonDocument& doc) {
+                QList<ModPlatform::IndexedPack> packs;
+                for (auto project : Json::requireArray(Json::requireObject(doc), "data")) {
+                    try {
+                        auto project_obj = Json::requireObject(project);
+                        ModPlatform::IndexedPack pack;
+                        FlameMod::loadIndexedPack(pack, project_obj);
+                        packs.append(pack);
+                    } catch (Json::JsonException& e) {
+                        qWarning() << e.cause();
+                    }
+                }
+                return packs;
+            });
+        connect(projects_task.get(), &Task::succeeded, this, [this, projects] {
+            for (auto& pack : *projects)
+                m_projects.insert(pack.addonId.toString(), pack);
+        });
+        job->addTask(projects_task);
+    }
+    if (!file_ids.isEmpty()) {
+        auto response = new QByteArray();
+        auto files_task = api.getFiles(file_ids, response);
+        auto files = Net::processJson<QList<ModPlatform::IndexedVersion>>(
+            files_task.get(), response, "FlameCheckUpdate::getFiles", [](const QJsonDocument& doc) {
+                QList<ModPlatform::IndexedVersion> versions;
+                for (auto file : Json::requireArray(Json::requireObject(doc), "data")) {
+                    try {
+                        auto file_obj = Json::requireObject(file);
+                        versions.append(FlameMod::loadIndexedPackVersion(file_obj));
+                    } catch (Json::JsonException& e) {
+                        qWarning() << e.cause();
+                    }
+                }
+                return versions;
+            });
+        connect(files_task.get(), &Task::succeeded, this, [this, files] {
+            for (auto& ver : *files)
+                m_current_versions.insert(ver.fileId.toString(), ver);
+        });
+        job->addTask(files_task);
+    }
+
+    connect(job.get(), &Task::finished, this, [this] {
+        if (m_was_aborted) {
+            emitAborted();
+            return;
         }
+        collectUpdates();
+    });
+
+    m_task = job;
+    job->start();
+}
+
+void FlameCheckUpdate::collectUpdates()
+{
+    setStatus(tr("Parsing the API response from CurseForge..."));
+
+    for (auto* mod : m_candidates) {
+        if (!m_collected.contains(mod))
+            collectUpdate(mod);
     }
 
     emitSucceeded();
 }
+
+bool FlameCheckUpdate::needsMoreInfo(Mod* mod) const
+{
+    auto latest_ver = m_latest_versions.value(mod);
+    if (!latest_ver.addonId.isValid())
+        return false;
+    // the website URL, to recover from that, or the name of the current version
+    return (latest_ver.downloadUrl.isEmpty() && latest_ver.fileId != mod->metadata()->file_id) ||
+           (mod->version().isEmpty() && mod->status() != ModStatus::NotInstalled);
+}
+
+void FlameCheckUpdate::collectUpdate(Mod* mod)
+{
+    m_collected.insert(mod);
+
+    auto latest_ver = m_latest_versions.value(mod);
+    if (!latest_ver.addonId.isValid()) {
+        emit checkFailed(mod, tr("No valid version found for this mod. It's probably unavailable for the current game "
+                                 "version / mod loader."));
+        return;
+    }
+
+    if (latest_ver.downloadUrl.isEmpty() && latest_ver.fileId != mod->metadata()->file_id) {
+        auto pack = m_projects.value(latest_ver.addonId.toString());
+        auto recover_url = QString("%1/download/%2").arg(pack.websiteUrl, latest_ver.fileId.toString());
+        emit checkFailed(mod, tr("Mod has a new update available, but is not downloadable using CurseForge."), recover_url);
+        return;
+    }
+
+    if (!latest_ver.hash.isEmpty() && (mod->metadata()->hash != latest_ver.hash || mod->status() == ModStatus::NotInstalled)) {
+        // Fake pack with the necessary info to pass to the download task :)
+        auto pack = std::make_shared<ModPlatform::IndexedPack>();
+        pack->name = mod->name();
+        pack->slug = mod->metadata()->slug;
+        pack->addonId = mod->metadata()->project_id;
+        pack->websiteUrl = mod->homeurl();
+        for (auto& author : mod->authors())
+            pack->authors.append({ author });
+        pack->description = mod->description();
+        pack->provider = ModPlatform::ResourceProvider::FLAME;
+
+        auto old_version = mod->version();
+        if (old_version.isEmpty() && mod->status() != ModStatus::NotInstalled)
+            old_version = m_current_versions.value(mod->metadata()->file_id.toString()).version;
+
+        // the changelog is left empty, to be fetched if it's ever looked at
+        auto download_task = makeShared<ResourceDownloadTask>(pack, latest_ver, m_mods_folder);
+        addUpdatable({ pack->name, mod->metadata()->hash, old_version, latest_ver.version, QString(),
+                       ModPlatform::ResourceProvider::FLAME, download_task });
+    }
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QSet>
+
 #include "Application.h"
 #include "modplatform/CheckUpdateTask.h"
 #include "net/NetJob.h"
@@ -19,7 +21,22 @@ class FlameCheckUpdate : public CheckUpdateTask {
     void executeTask() override;
 
    private:
-    NetJob* m_net_job = nullptr;
+    void getLatestVersions();
+    void getMissingInfo();
+    void collectUpdates();
+    /** Whether more has to be asked about the mod before telling if it has an update. */
+    bool needsMoreInfo(Mod* mod) const;
+    void collectUpdate(Mod* mod);
+
+    Task::Ptr m_task;
+
+    QList<Mod*> m_candidates;
+    QHash<Mod*, ModPlatform::IndexedVersion> m_latest_versions;
+    // only filled for the mods that need them
+    QHash<QString, ModPlatform::IndexedPack> m_projects;
+    QHash<QString, ModPlatform::IndexedVersion> m_current_versions;
+    // those already told about, as soon as they could be
+    QSet<Mod*> m_collected;
 
     bool m_was_aborted = false;
 };
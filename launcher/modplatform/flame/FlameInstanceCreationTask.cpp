@@ -57,6 +57,8 @@
 #include <QDebug>
 #include <QFileInfo>
 
+#include <algorithm>
+
 #include "minecraft/World.h"
 #include "minecraft/mod/tasks/LocalResourceParse.h"
 
@@ -76,8 +78,8 @@ bool FlameCreationTask::abort()
     m_abort = true;
     if (m_process_update_file_info_job)
         m_process_update_file_info_job->abort();
-    if (m_files_job)
-        m_files_job->abort();
+    for (auto& job : m_files_jobs)
+        job->abort();
     if (m_mod_id_resolver)
         m_mod_id_resolver->abort();
 
@@ -153,6 +155,7 @@ bool FlameCreationTask::updateInstance()
 
                     old_files.remove(file.key());
                     files_iterator = files.erase(files_iterator);
+                    continue;
                 }
             }
 
@@ -161,15 +164,13 @@ bool FlameCreationTask::updateInstance()
 
         QDir old_minecraft_dir(inst->gameRoot());
 
-        // We will remove all the previous overrides, to prevent duplicate files!
-        // TODO: Currently 'overrides' will always override the stuff on update. How do we preserve unchanged overrides?
+        // Only the overrides that changed are applied again, the others are left as they are.
         // FIXME: We may want to do something about disabled mods.
-        auto old_overrides = Override::readOverrides("overrides", old_index_folder);
-        for (const auto& entry : old_overrides) {
-            if (entry.isEmpty())
-                continue;
-            qDebug() << "Scheduling" << entry << "for removal";
-            m_files_to_remove.append(old_minecraft_dir.absoluteFilePath(entry));
+        if (!m_pack.overrides.isEmpty()) {
+            auto override_path = FS::PathCombine(m_stagingPath, m_pack.overrides);
+            m_files_to_remove.append(Override::diffOverrides("overrides", old_index_folder, override_path, old_minecraft_dir.absolutePath(),
+                                                             m_unchanged_overrides));
+            qDebug() << m_unchanged_overrides.size() << "overrides didn't change";
         }
 
         // Remove remaining old files (we need to do an API request to know which ids are which files...)
@@ -259,6 +260,7 @@ bool FlameCreationTask::updateInstance()
 bool FlameCreationTask::createInstance()
 {
     QEventLoop loop;
+    m_loop = &loop;
 
     QString parent_folder(FS::PathCombine(m_stagingPath, "flame"));
 
@@ -282,6 +284,7 @@ bool FlameCreationTask::createInstance()
         if (QFile::exists(overridePath)) {
             // Create a list of overrides in "overrides.txt" inside flame/
             Override::createOverrides("overrides", parent_folder, overridePath);
+            Override::dropUnchanged(overridePath, m_unchanged_overrides);
 
             QString mcPath = FS::PathCombine(m_stagingPath, "minecraft");
             if (!QFile::rename(overridePath, mcPath)) {
@@ -374,12 +377,13 @@ bool FlameCreationTask::createInstance()
         instance.setManagedPack("flame", m_managed_id, m_pack.name, m_managed_version_id, m_pack.version);
     instance.setName(name());
 
+    // Files start downloading as soon as we know where to get them from, while the other ones are still being looked up
     m_mod_id_resolver.reset(new Flame::FileResolvingTask(APPLICATION->network(), m_pack));
-    connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::succeeded, this, [this, &loop] { idResolverSucceeded(loop); });
+    connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::filesResolved, this, &FlameCreationTask::startDownloads);
+    connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::succeeded, this, &FlameCreationTask::idResolverSucceeded);
     connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::failed, [&](QString reason) {
         m_mod_id_resolver.reset();
-        setError(tr("Unable to resolve mod IDs:\n") + reason);
-        loop.quit();
+        failDownloads(tr("Unable to resolve mod IDs:\n") + reason);
     });
     connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::progress, this, &FlameCreationTask::setProgress);
     connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::status, this, &FlameCreationTask::setStatus);
@@ -388,6 +392,7 @@ bool FlameCreationTask::createInstance()
     m_mod_id_resolver->start();
 
     loop.exec();
+    m_loop = nullptr;
 
     bool did_succeed = getError().isEmpty();
 
@@ -402,7 +407,7 @@ bool FlameCreationTask::createInstance()
     return did_succeed;
 }
 
-void FlameCreationTask::idResolverSucceeded(QEventLoop& loop)
+void FlameCreationTask::idResolverSucceeded()
 {
     auto results = m_mod_id_resolver->getResults();
 
@@ -419,6 +424,7 @@ void FlameCreationTask::idResolverSucceeded(QEventLoop& loop)
             blocked_mod.name = result.fileName;
             blocked_mod.websiteUrl = result.websiteUrl;
             blocked_mod.hash = result.hash;
+            blocked_mod.size = result.size;
             blocked_mod.matched = false;
             blocked_mod.localPath = "";
             blocked_mod.targetFolder = result.targetFolder;
@@ -428,6 +434,8 @@ void FlameCreationTask::idResolverSucceeded(QEventLoop& loop)
             anyBlocked = true;
         }
     }
+    m_mod_id_resolver.reset();
+
     if (anyBlocked) {
         qWarning() << "Blocked mods found, displaying mod list";
 
@@ -438,24 +446,34 @@ void FlameCreationTask::idResolverSucceeded(QEventLoop& loop)
 
         message_dialog.setModal(true);
 
+        // the other mods keep downloading in the meantime
         if (message_dialog.exec()) {
             qDebug() << "Post dialog blocked mods list: " << blocked_mods;
             copyBlockedMods(blocked_mods);
-            setupDownloadJob(loop);
         } else {
-            m_mod_id_resolver.reset();
-            setError("Canceled");
-            loop.quit();
+            failDownloads("Canceled");
+            return;
         }
-    } else {
-        setupDownloadJob(loop);
     }
+
+    m_resolving_done = true;
+    setStatus(tr("Downloading mods..."));
+    finishIfDone();
 }
 
-void FlameCreationTask::setupDownloadJob(QEventLoop& loop)
+void FlameCreationTask::startDownloads(const QList<int>& file_ids)
 {
-    m_files_job.reset(new NetJob(tr("Mod Download Flame"), APPLICATION->network()));
-    for (const auto& result : m_mod_id_resolver->getResults().files) {
+    if (!m_mod_id_resolver)
+        return;
+
+    auto job = makeShared<NetJob>(tr("Mod Download Flame"), APPLICATION->network());
+    auto& files = m_mod_id_resolver->getResults().files;
+    for (auto id : file_ids) {
+        auto it = files.constFind(id);
+        if (it == files.constEnd())
+            continue;
+        auto& result = *it;
+
         QString filename = result.fileName;
         if (!result.required) {
             filename += ".disabled";
@@ -473,8 +491,8 @@ void FlameCreationTask::setupDownloadJob(QEventLoop& loop)
             case Flame::File::Type::Mod: {
                 if (!result.url.isEmpty()) {
                     qDebug() << "Will download" << result.url << "to" << path;
-                    auto dl = Net::Download::makeFile(result.url, path);
-                    m_files_job->addNetAction(dl);
+                    auto dl = Net::Download::makeStored(result.url, path, "sha1", result.hash, Net::Download::Option::KeepHashes);
+                    job->addNetAction(dl);
                 }
                 break;
             }
@@ -488,25 +506,57 @@ void FlameCreationTask::setupDownloadJob(QEventLoop& loop)
                 break;
         }
     }
-
-    m_mod_id_resolver.reset();
-    connect(m_files_job.get(), &NetJob::succeeded, this, [&]() {
-        m_files_job.reset();
-        validateZIPResouces();
+    if (job->size() == 0)
+        return;
+
+    // the downloads report the progress from now on
+    disconnect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::progress, this, &FlameCreationTask::setProgress);
+
+    auto raw_job = job.get();
+    m_files_jobs.append(job);
+    connect(raw_job, &NetJob::succeeded, this, [this, raw_job]() {
+        m_files_jobs.erase(std::remove_if(m_files_jobs.begin(), m_files_jobs.end(), [raw_job](const NetJob::Ptr& job) { return job.get() == raw_job; }),
+                           m_files_jobs.end());
+        finishIfDone();
     });
-    connect(m_files_job.get(), &NetJob::failed, [&](QString reason) {
-        m_files_job.reset();
-        setError(reason);
-    });
-    connect(m_files_job.get(), &NetJob::progress, this, [this](qint64 current, qint64 total){
-        setDetails(tr("%1 out of %2 complete").arg(current).arg(total));
-        setProgress(current, total);
+    connect(raw_job, &NetJob::failed, this, [this](QString reason) { failDownloads(reason); });
+    connect(raw_job, &NetJob::progress, this, [this, raw_job](qint64 current, qint64 total) {
+        m_download_progress[raw_job] = { current, total };
+        qint64 all_current = 0, all_total = 0;
+        for (auto& progress : m_download_progress) {
+            all_current += progress.first;
+            all_total += progress.second;
+        }
+        setDetails(tr("%1 out of %2 complete").arg(all_current).arg(all_total));
+        setProgress(all_current, all_total);
     });
-    connect(m_files_job.get(), &NetJob::stepProgress, this, &FlameCreationTask::propogateStepProgress);
-    connect(m_files_job.get(), &NetJob::finished, &loop, &QEventLoop::quit);
+    connect(raw_job, &NetJob::stepProgress, this, &FlameCreationTask::propogateStepProgress);
 
-    setStatus(tr("Downloading mods..."));
-    m_files_job->start();
+    job->start();
+}
+
+void FlameCreationTask::finishIfDone()
+{
+    if (!m_resolving_done || !m_files_jobs.isEmpty())
+        return;
+
+    m_download_progress.clear();
+    validateZIPResouces();
+    if (m_loop)
+        m_loop->quit();
+}
+
+void FlameCreationTask::failDownloads(const QString& reason)
+{
+    setError(reason);
+    // take them out first, aborting them makes them fail too
+    auto jobs = std::move(m_files_jobs);
+    m_files_jobs.clear();
+    for (auto& job : jobs)
+        job->abort();
+    m_download_progress.clear();
+    if (m_loop)
+        m_loop->quit();
 }
 
 /// @brief copy the matched blocked mods to the instance staging area
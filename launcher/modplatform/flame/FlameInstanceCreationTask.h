@@ -74,20 +74,30 @@ class FlameCreationTask final : public InstanceCreationTask {
     bool createInstance() override;
 
    private slots:
-    void idResolverSucceeded(QEventLoop&);
-    void setupDownloadJob(QEventLoop&);
+    void idResolverSucceeded();
+    void startDownloads(const QList<int>& file_ids);
     void copyBlockedMods(QList<BlockedMod> const& blocked_mods);
     void validateZIPResouces();
 
+   private:
+    void finishIfDone();
+    void failDownloads(const QString& reason);
+
    private:
     QWidget* m_parent = nullptr;
 
     shared_qobject_ptr<Flame::FileResolvingTask> m_mod_id_resolver;
     Flame::Manifest m_pack;
+    // the overrides an update leaves alone, as they're the same as in the instance
+    QStringList m_unchanged_overrides;
 
     // Handle to allow aborting
     Task::Ptr m_process_update_file_info_job = nullptr;
-    NetJob::Ptr m_files_job = nullptr;
+    // one for every batch of files resolved together
+    QList<NetJob::Ptr> m_files_jobs;
+    QHash<NetJob*, QPair<qint64, qint64>> m_download_progress;
+    bool m_resolving_done = false;
+    QEventLoop* m_loop = nullptr;
 
     QString m_managed_id, m_managed_version_id;
 
@@ -5,7 +5,6 @@
 #include "minecraft/PackProfile.h"
 #include "modplatform/flame/FlameAPI.h"
 
-static FlameAPI api;
 static ModPlatform::ProviderCapabilities ProviderCaps;
 
 void FlameMod::loadIndexedPack(ModPlatform::IndexedPack& pack, QJsonObject& obj)
@@ -56,7 +55,8 @@ void FlameMod::loadURLs(ModPlatform::IndexedPack& pack, QJsonObject& obj)
 
 void FlameMod::loadBody(ModPlatform::IndexedPack& pack, QJsonObject& obj)
 {
-    pack.extraData.body  = api.getModDescription(pack.addonId.toInt());
+    // FlameAPI::getProjectInfo() puts it there
+    pack.extraData.body = Json::ensureString(obj, "description");
 
     if (!pack.extraData.issuesUrl.isEmpty() || !pack.extraData.sourceUrl.isEmpty() || !pack.extraData.wikiUrl.isEmpty())
         pack.extraDataLoaded = true;
@@ -102,7 +102,7 @@ void FlameMod::loadIndexedPackVersions(ModPlatform::IndexedPack& pack,
     pack.versionsLoaded = true;
 }
 
-auto FlameMod::loadIndexedPackVersion(QJsonObject& obj, bool load_changelog) -> ModPlatform::IndexedVersion
+auto FlameMod::loadIndexedPackVersion(QJsonObject& obj) -> ModPlatform::IndexedVersion
 {
     auto versionArray = Json::requireArray(obj, "gameVersions");
     if (versionArray.isEmpty()) {
@@ -136,8 +136,35 @@ auto FlameMod::loadIndexedPackVersion(QJsonObject& obj, bool load_changelog) ->
         }
     }
 
-    if(load_changelog)
-        file.changelog = api.getModFileChangelog(file.addonId.toInt(), file.fileId.toInt());
+    for (auto dependency : Json::ensureArray(obj, "dependencies")) {
+        auto dependency_obj = Json::ensureObject(dependency);
+        ModPlatform::Dependency dep;
+        dep.addonId = Json::ensureInteger(dependency_obj, "modId");
+        switch (Json::ensureInteger(dependency_obj, "relationType")) {
+            case 1:
+                dep.type = ModPlatform::DependencyType::EMBEDDED;
+                break;
+            case 2:
+                dep.type = ModPlatform::DependencyType::OPTIONAL;
+                break;
+            case 3:
+                dep.type = ModPlatform::DependencyType::REQUIRED;
+                break;
+            case 4:
+                dep.type = ModPlatform::DependencyType::TOOL;
+                break;
+            case 5:
+                dep.type = ModPlatform::DependencyType::INCOMPATIBLE;
+                break;
+            case 6:
+                dep.type = ModPlatform::DependencyType::INCLUDE;
+                break;
+            default:
+                dep.type = ModPlatform::DependencyType::UNKNOWN;
+                break;
+        }
+        file.dependencies.append(dep);
+    }
 
     return file;
 }
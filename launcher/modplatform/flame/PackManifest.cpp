@@ -96,6 +96,8 @@ bool Flame::File::parseFromObject(const QJsonObject& obj,  bool throw_on_blocked
     }
 
 
+    size = static_cast<qint64>(Json::ensureDouble(obj, "fileLength", 0));
+
     // may throw, if the project is blocked
     QString rawUrl = Json::ensureString(obj, "downloadUrl");
     url = QUrl(rawUrl, QUrl::TolerantMode);
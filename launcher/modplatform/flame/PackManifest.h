@@ -53,6 +53,8 @@ struct File
     // NOTE: the opposite to 'optional'. This is at the time of writing unused.
     bool required = true;
     QString hash;
+    // size of the file in bytes, 0 if unknown
+    qint64 size = 0;
     // NOTE: only set on blocked files ! Empty otherwise.
     QString websiteUrl;
 
@@ -1,10 +1,22 @@
 #include "HashUtils.h"
 
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QDebug>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QMutex>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QtConcurrentRun>
 
+#include "Executors.h"
 #include "FileSystem.h"
-#include "StringUtils.h"
+#include "digest/Digest.h"
 
 #include <MurmurHash2.h>
 
@@ -12,77 +24,271 @@ namespace Hashing {
 
 static ModPlatform::ProviderCapabilities ProviderCaps;
 
-Hasher::Ptr createHasher(QString file_path, ModPlatform::ResourceProvider provider)
+QString FileHashes::get(const QString& type) const
 {
-    switch (provider) {
-        case ModPlatform::ResourceProvider::MODRINTH:
-            return createModrinthHasher(file_path);
-        case ModPlatform::ResourceProvider::FLAME:
-            return createFlameHasher(file_path);
-        default:
-            qCritical() << "[Hashing]"
-                        << "Unrecognized mod platform!";
-            return nullptr;
-    }
+    if (type == "md5")
+        return md5;
+    if (type == "sha1")
+        return sha1;
+    if (type == "sha512")
+        return sha512;
+    if (type == "murmur2")
+        return murmur2;
+    if (type == "sha256")
+        return sha256;
+    return {};
 }
 
-Hasher::Ptr createModrinthHasher(QString file_path)
+namespace {
+
+/* Persistent (path, size, mtime) -> hashes cache.
+ *
+ * Backed by an append-only log of records, compacted when loading it if the
+ * log got much bigger than the number of files it describes.
+ */
+class HashCache {
+   public:
+    static HashCache& instance()
+    {
+        static HashCache s_instance;
+        return s_instance;
+    }
+
+    std::optional<FileHashes> find(const QString& path, qint64 size, qint64 mtime)
+    {
+        QMutexLocker lock(&m_lock);
+        load();
+
+        auto it = m_entries.constFind(path);
+        if (it == m_entries.constEnd() || it->size != size || it->mtime != mtime)
+            return {};
+        return it->hashes;
+    }
+
+    void insert(const QString& path, qint64 size, qint64 mtime, const FileHashes& hashes)
+    {
+        QMutexLocker lock(&m_lock);
+        load();
+
+        Entry entry{ size, mtime, hashes };
+        m_entries.insert(path, entry);
+
+        QFile file(m_file);
+        bool is_new = !file.exists();
+        if (!FS::ensureFilePathExists(m_file) || !file.open(QFile::WriteOnly | QFile::Append)) {
+            qWarning() << "[Hashing] Could not open hash cache for writing:" << file.errorString();
+            return;
+        }
+
+        QDataStream out(&file);
+        out.setVersion(s_stream_version);
+        if (is_new)
+            out << s_magic << s_version;
+        writeEntry(out, path, entry);
+        m_records++;
+    }
+
+   private:
+    struct Entry {
+        qint64 size;
+        qint64 mtime;
+        FileHashes hashes;
+    };
+
+    static constexpr quint32 s_magic = 0x48415348;  // "HASH"
+    // 2 added SHA-256, the entries of 1 are read without it
+    static constexpr quint32 s_version = 2;
+    static constexpr auto s_stream_version = QDataStream::Qt_5_12;
+
+    HashCache() : m_file(QDir("cache").absoluteFilePath("filehashes")) {}
+
+    static void writeEntry(QDataStream& out, const QString& path, const Entry& entry)
+    {
+        out << path << entry.size << entry.mtime << entry.hashes.md5 << entry.hashes.sha1 << entry.hashes.sha512
+            << entry.hashes.murmur2 << entry.hashes.sha256;
+    }
+
+    void load()
+    {
+        if (m_loaded)
+            return;
+        m_loaded = true;
+
+        QFile file(m_file);
+        if (!file.open(QFile::ReadOnly))
+            return;
+
+        QDataStream in(&file);
+        in.setVersion(s_stream_version);
+
+        quint32 magic, version;
+        in >> magic >> version;
+        if (in.status() != QDataStream::Ok || magic != s_magic || version < 1 || version > s_version) {
+            file.close();
+            compact();
+            return;
+        }
+
+        while (!in.atEnd()) {
+            QString path;
+            Entry entry;
+            in >> path >> entry.size >> entry.mtime >> entry.hashes.md5 >> entry.hashes.sha1 >> entry.hashes.sha512 >>
+                entry.hashes.murmur2;
+            if (version >= 2)
+                in >> entry.hashes.sha256;
+            if (in.status() != QDataStream::Ok)
+                break;
+
+            m_entries.insert(path, entry);
+            m_records++;
+        }
+
+        // entries for files that changed pile up over time
+        if (in.status() != QDataStream::Ok || version != s_version || m_records > 2 * m_entries.size() + 256) {
+            file.close();
+            compact();
+        }
+    }
+
+    void compact()
+    {
+        // stale entries of files that don't exist anymore aren't worth keeping
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (QFileInfo::exists(it.key()))
+                it++;
+            else
+                it = m_entries.erase(it);
+        }
+
+        QSaveFile file(m_file);
+        if (!FS::ensureFilePathExists(m_file) || !file.open(QFile::WriteOnly)) {
+            qWarning() << "[Hashing] Could not open hash cache for writing:" << file.errorString();
+            return;
+        }
+
+        QDataStream out(&file);
+        out.setVersion(s_stream_version);
+        out << s_magic << s_version;
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); it++)
+            writeEntry(out, it.key(), it.value());
+
+        if (!file.commit())
+            qWarning() << "[Hashing] Could not write hash cache:" << file.errorString();
+        m_records = m_entries.size();
+    }
+
+    QMutex m_lock;
+    QString m_file;
+    bool m_loaded = false;
+    int m_records = 0;
+    QHash<QString, Entry> m_entries;
+};
+
+QThreadPool* hashingPool()
 {
-    return makeShared<ModrinthHasher>(file_path);
+    // hashing is mostly I/O bound for small files and CPU bound for big ones, so one thread per core is a good middle ground
+    return Executors::cpu();
 }
 
-Hasher::Ptr createFlameHasher(QString file_path)
+void hashData(const QByteArray& data, FileHashes& out)
 {
-    return makeShared<FlameHasher>(file_path);
+    out.md5 = QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex();
+    out.sha1 = Digest::hash(data, QCryptographicHash::Sha1).toHex();
+    out.sha512 = Digest::hash(data, QCryptographicHash::Sha512).toHex();
+    out.sha256 = Digest::hash(data, QCryptographicHash::Sha256).toHex();
+    out.murmur2 = QString::number(CurseForgeFingerprint(data.constData(), data.size()));
 }
 
-Hasher::Ptr createBlockedModHasher(QString file_path, ModPlatform::ResourceProvider provider)
+}  // namespace
+
+std::optional<FileHashes> cachedHashes(const QString& path)
 {
-    return makeShared<BlockedModHasher>(file_path, provider);
+    QFileInfo info(path);
+    if (!info.isFile())
+        return {};
+    return HashCache::instance().find(info.absoluteFilePath(), info.size(), info.lastModified().toMSecsSinceEpoch());
 }
 
-Hasher::Ptr createBlockedModHasher(QString file_path, ModPlatform::ResourceProvider provider, QString type)
+void rememberHashes(const QString& path, const FileHashes& hashes)
 {
-    auto hasher = makeShared<BlockedModHasher>(file_path, provider);
-    hasher->useHashType(type);
-    return hasher;
+    if (!hashes.isComplete())
+        return;
+
+    [[maybe_unused]] auto future = QtConcurrent::run(hashingPool(), [path, hashes] {
+        QFileInfo info(path);
+        if (info.isFile())
+            HashCache::instance().insert(info.absoluteFilePath(), info.size(), info.lastModified().toMSecsSinceEpoch(), hashes);
+    });
 }
 
-void ModrinthHasher::executeTask()
+FileHashes hashFile(const QString& path, bool use_cache)
 {
-    QFile file(m_path);
+    QFileInfo info(path);
+    auto abs_path = info.absoluteFilePath();
+    auto size = info.size();
+    auto mtime = info.lastModified().toMSecsSinceEpoch();
 
-    try {
-        file.open(QFile::ReadOnly);
-    } catch (FS::FileSystemException& e) {
-        qCritical() << QString("Failed to open JAR file in %1").arg(m_path);
-        qCritical() << QString("Reason: ") << e.cause();
-
-        emitFailed("Failed to open file for hashing.");
-        return;
+    if (use_cache) {
+        if (auto cached = HashCache::instance().find(abs_path, size, mtime))
+            return *cached;
     }
 
-    auto hash_type = ProviderCaps.hashType(ModPlatform::ResourceProvider::MODRINTH).first();
-    m_hash = ProviderCaps.hash(ModPlatform::ResourceProvider::MODRINTH, &file, hash_type);
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly)) {
+        qCritical() << QString("Failed to open file %1 for hashing: %2").arg(path, file.errorString());
+        return {};
+    }
 
-    file.close();
+    FileHashes result;
 
-    if (m_hash.isEmpty()) {
-        emitFailed("Empty hash!");
+    // map the file so all the hashes are computed over a single read of it
+    uchar* mapped = size > 0 ? file.map(0, size) : nullptr;
+    if (mapped) {
+        hashData(QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), size), result);
+        file.unmap(mapped);
     } else {
-        emitSucceeded();
+        auto data = file.readAll();
+        if (file.error() != QFileDevice::NoError) {
+            qCritical() << QString("Failed to read file %1 for hashing: %2").arg(path, file.errorString());
+            return {};
+        }
+        hashData(data, result);
     }
+
+    HashCache::instance().insert(abs_path, size, mtime, result);
+    return result;
+}
+
+QFuture<FileHashes> hashFileAsync(const QString& path)
+{
+    return QtConcurrent::run(hashingPool(), [path] { return hashFile(path); });
+}
+
+void Hasher::executeTask()
+{
+    // don't bother going off-thread for files we already know about
+    if (auto cached = cachedHashes(m_path)) {
+        finishWith(*cached);
+        return;
+    }
+
+    auto watcher = new QFutureWatcher<FileHashes>(this);
+    connect(watcher, &QFutureWatcher<FileHashes>::finished, this, [this, watcher] {
+        watcher->deleteLater();
+        finishWith(watcher->result());
+    });
+    watcher->setFuture(hashFileAsync(m_path));
 }
 
-void FlameHasher::executeTask()
+void Hasher::finishWith(const FileHashes& hashes)
 {
-    // CF-specific
-    auto should_filter_out = [](char c) { return (c == 9 || c == 10 || c == 13 || c == 32); };
+    if (!hashes.isValid()) {
+        emitFailed("Failed to open file for hashing.");
+        return;
+    }
 
-    std::ifstream file_stream(StringUtils::toStdString(m_path).c_str(), std::ifstream::binary);
-    // TODO: This is very heavy work, but apparently QtConcurrent can't use move semantics, so we can't boop this to another thread.
-    // How do we make this non-blocking then?
-    m_hash = QString::number(MurmurHash2(std::move(file_stream), 4 * MiB, should_filter_out));
+    m_hashes = hashes;
+    m_hash = selectHash(hashes);
 
     if (m_hash.isEmpty()) {
         emitFailed("Empty hash!");
@@ -91,36 +297,51 @@ void FlameHasher::executeTask()
     }
 }
 
-
-BlockedModHasher::BlockedModHasher(QString file_path, ModPlatform::ResourceProvider provider)
-    : Hasher(file_path), provider(provider) { 
-    setObjectName(QString("BlockedModHasher: %1").arg(file_path)); 
-    hash_type = ProviderCaps.hashType(provider).first();
+Hasher::Ptr createHasher(QString file_path, ModPlatform::ResourceProvider provider)
+{
+    switch (provider) {
+        case ModPlatform::ResourceProvider::MODRINTH:
+            return createModrinthHasher(file_path);
+        case ModPlatform::ResourceProvider::FLAME:
+            return createFlameHasher(file_path);
+        default:
+            qCritical() << "[Hashing]"
+                        << "Unrecognized mod platform!";
+            return nullptr;
+    }
 }
 
-void BlockedModHasher::executeTask()
+Hasher::Ptr createModrinthHasher(QString file_path)
 {
-    QFile file(m_path);
+    return makeShared<ModrinthHasher>(file_path);
+}
 
-    try {
-        file.open(QFile::ReadOnly);
-    } catch (FS::FileSystemException& e) {
-        qCritical() << QString("Failed to open JAR file in %1").arg(m_path);
-        qCritical() << QString("Reason: ") << e.cause();
+Hasher::Ptr createFlameHasher(QString file_path)
+{
+    return makeShared<FlameHasher>(file_path);
+}
 
-        emitFailed("Failed to open file for hashing.");
-        return;
-    }
+Hasher::Ptr createBlockedModHasher(QString file_path, ModPlatform::ResourceProvider provider)
+{
+    return makeShared<BlockedModHasher>(file_path, provider);
+}
 
-    m_hash = ProviderCaps.hash(provider, &file, hash_type);
+Hasher::Ptr createBlockedModHasher(QString file_path, ModPlatform::ResourceProvider provider, QString type)
+{
+    auto hasher = makeShared<BlockedModHasher>(file_path, provider);
+    hasher->useHashType(type);
+    return hasher;
+}
 
-    file.close();
+QString ModrinthHasher::selectHash(const FileHashes& hashes) const
+{
+    return hashes.get(ProviderCaps.hashType(ModPlatform::ResourceProvider::MODRINTH).first());
+}
 
-    if (m_hash.isEmpty()) {
-        emitFailed("Empty hash!");
-    } else {
-        emitSucceeded();
-    }
+BlockedModHasher::BlockedModHasher(QString file_path, ModPlatform::ResourceProvider provider)
+    : Hasher(file_path), provider(provider) { 
+    setObjectName(QString("BlockedModHasher: %1").arg(file_path)); 
+    hash_type = ProviderCaps.hashType(provider).first();
 }
 
 QStringList BlockedModHasher::getHashTypes() {
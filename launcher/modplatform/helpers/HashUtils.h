@@ -1,12 +1,50 @@
 #pragma once
 
+#include <QFuture>
 #include <QString>
 
+#include <optional>
+
 #include "modplatform/ModIndex.h"
 #include "tasks/Task.h"
 
 namespace Hashing {
 
+/* Every hash a mod platform may ask us for, for a single file. */
+struct FileHashes {
+    QString md5;
+    QString sha1;
+    QString sha512;
+    QString murmur2;  // CurseForge fingerprint, with whitespace filtered out
+    // what packwiz uses by default. Not needed for the cache to have them: older entries don't
+    QString sha256;
+
+    /* Gets the hash by the name the platforms use for it ("sha1", "murmur2", ...) */
+    QString get(const QString& type) const;
+    bool isValid() const { return !sha1.isEmpty(); }
+    /* Whether it has all of them, which is what the cache needs. */
+    bool isComplete() const { return !md5.isEmpty() && !sha1.isEmpty() && !sha512.isEmpty() && !murmur2.isEmpty(); }
+};
+
+/* Hashes the file with every algorithm in FileHashes, reading it only once.
+ * Results are cached on disk, keyed by the file's path, size and modification time,
+ * so files that didn't change are never hashed again.
+ * Without `use_cache`, the file is read whatever the cache says (to find the ones damaged in place), and the cache
+ * gets what was read.
+ */
+FileHashes hashFile(const QString& path, bool use_cache = true);
+
+/* Same as hashFile(), but on the hashing thread pool. */
+QFuture<FileHashes> hashFileAsync(const QString& path);
+
+/* Returns the cached hashes of the file, if it didn't change since. Never reads the file contents. */
+std::optional<FileHashes> cachedHashes(const QString& path);
+
+/* Puts hashes of the file as it is now in the cache, when they're known some other way, like from downloading it
+ * (see Net::MultiDigestValidator). Done on the hashing thread pool, incomplete hashes are ignored.
+ */
+void rememberHashes(const QString& path, const FileHashes& hashes);
+
 class Hasher : public Task {
    public:
     using Ptr = shared_qobject_ptr<Hasher>;
@@ -16,38 +54,52 @@ class Hasher : public Task {
     /* We can't really abort this task, but we can say we aborted and finish our thing quickly :) */
     bool abort() override { return true; }
 
-    void executeTask() override = 0;
+    void executeTask() override;
 
     QString getResult() const { return m_hash; };
     QString getPath() const { return m_path; };
+    /* All the hashes of the file, not only the one picked. */
+    FileHashes getHashes() const { return m_hashes; };
+
+   protected:
+    /* Picks the hash this hasher is interested in. */
+    virtual QString selectHash(const FileHashes& hashes) const = 0;
+
+   private:
+    void finishWith(const FileHashes& hashes);
 
    protected:
     QString m_hash;
     QString m_path;
+    FileHashes m_hashes;
 };
 
 class FlameHasher : public Hasher {
    public:
     FlameHasher(QString file_path) : Hasher(file_path) { setObjectName(QString("FlameHasher: %1").arg(file_path)); }
 
-    void executeTask() override;
+   protected:
+    QString selectHash(const FileHashes& hashes) const override { return hashes.murmur2; }
 };
 
 class ModrinthHasher : public Hasher {
    public:
     ModrinthHasher(QString file_path) : Hasher(file_path) { setObjectName(QString("ModrinthHasher: %1").arg(file_path)); }
 
-    void executeTask() override;
+   protected:
+    QString selectHash(const FileHashes& hashes) const override;
 };
 
 class BlockedModHasher : public Hasher {
    public:
     BlockedModHasher(QString file_path, ModPlatform::ResourceProvider provider);
 
-    void executeTask() override;
-
     QStringList getHashTypes();
     bool useHashType(QString type);
+
+   protected:
+    QString selectHash(const FileHashes& hashes) const override { return hashes.get(hash_type); }
+
    private:
     ModPlatform::ResourceProvider provider;
     QString hash_type;
@@ -0,0 +1,101 @@
+#include "LookupMisses.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "Exception.h"
+#include "Json.h"
+
+namespace {
+constexpr qint64 s_max_age_s = 3 * 24 * 60 * 60;
+
+ModPlatform::ProviderCapabilities ProviderCaps;
+}  // namespace
+
+LookupMisses::LookupMisses(QString path, std::function<qint64()> now) : m_path(std::move(path)), m_now(std::move(now))
+{
+    if (!m_now)
+        m_now = [] { return QDateTime::currentSecsSinceEpoch(); };
+}
+
+LookupMisses& LookupMisses::instance()
+{
+    static LookupMisses s_instance(QDir("cache").absoluteFilePath("lookup_misses.json"));
+    return s_instance;
+}
+
+QString LookupMisses::key(ModPlatform::ResourceProvider provider, const QString& hash)
+{
+    return QString("%1:%2").arg(ProviderCaps.name(provider), hash);
+}
+
+bool LookupMisses::contains(ModPlatform::ResourceProvider provider, const QString& hash)
+{
+    load();
+    auto it = m_misses.find(key(provider, hash));
+    if (it == m_misses.end())
+        return false;
+    if (m_now() - *it < s_max_age_s)
+        return true;
+
+    m_misses.erase(it);
+    m_dirty = true;
+    return false;
+}
+
+void LookupMisses::insert(ModPlatform::ResourceProvider provider, const QString& hash)
+{
+    load();
+    m_misses.insert(key(provider, hash), m_now());
+    m_dirty = true;
+}
+
+void LookupMisses::remove(ModPlatform::ResourceProvider provider, const QString& hash)
+{
+    load();
+    if (m_misses.remove(key(provider, hash)))
+        m_dirty = true;
+}
+
+void LookupMisses::load()
+{
+    if (m_loaded)
+        return;
+    m_loaded = true;
+
+    QFile file(m_path);
+    if (!file.open(QFile::ReadOnly))
+        return;
+
+    auto now = m_now();
+    auto misses = QJsonDocument::fromJson(file.readAll()).object();
+    for (auto it = misses.constBegin(); it != misses.constEnd(); it++) {
+        auto when = static_cast<qint64>(it.value().toDouble());
+        if (now - when < s_max_age_s)
+            m_misses.insert(it.key(), when);
+    }
+}
+
+void LookupMisses::save()
+{
+    if (!m_dirty)
+        return;
+
+    auto now = m_now();
+    QJsonObject misses;
+    for (auto it = m_misses.constBegin(); it != m_misses.constEnd(); it++) {
+        if (now - it.value() < s_max_age_s)
+            misses.insert(it.key(), static_cast<double>(it.value()));
+    }
+
+    try {
+        Json::write(misses, m_path);
+        m_dirty = false;
+    } catch (const Exception& e) {
+        qWarning() << "Couldn't save the platform lookup misses:" << e.cause();
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+
+#include <functional>
+
+#include "modplatform/ModIndex.h"
+
+/* Hashes of files a mod platform was asked about and didn't know.
+ *
+ * Jars that aren't on a platform, like the ones made locally or gotten elsewhere, would otherwise be looked up again
+ * on every update check. A miss is forgotten after a few days, so a file that gets uploaded later is still found.
+ */
+class LookupMisses {
+   public:
+    explicit LookupMisses(QString path, std::function<qint64()> now = {});
+
+    /* The one kept in the cache folder of the launcher. */
+    static LookupMisses& instance();
+
+    bool contains(ModPlatform::ResourceProvider provider, const QString& hash);
+    void insert(ModPlatform::ResourceProvider provider, const QString& hash);
+    void remove(ModPlatform::ResourceProvider provider, const QString& hash);
+
+    /* Writes the misses to disk, if any changed. */
+    void save();
+
+   private:
+    void load();
+    static QString key(ModPlatform::ResourceProvider provider, const QString& hash);
+
+   private:
+    QString m_path;
+    std::function<qint64()> m_now;
+    bool m_loaded = false;
+    bool m_dirty = false;
+    // "<provider>:<hash>" -> when it was missed, in seconds since the epoch
+    QHash<QString, qint64> m_misses;
+};
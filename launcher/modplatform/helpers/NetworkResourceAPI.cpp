@@ -5,9 +5,12 @@
 #include "NetworkResourceAPI.h"
 
 #include "Application.h"
+#include "net/JsonResponse.h"
 #include "net/NetJob.h"
 
 #include "modplatform/ModIndex.h"
+#include "modplatform/helpers/ProjectCache.h"
+#include "modplatform/helpers/ResourceSearchTask.h"
 
 Task::Ptr NetworkResourceAPI::searchProjects(SearchArgs&& args, SearchCallbacks&& callbacks) const
 {
@@ -19,62 +22,32 @@ Task::Ptr NetworkResourceAPI::searchProjects(SearchArgs&& args, SearchCallbacks&
 
     auto search_url = search_url_optional.value();
 
-    auto response = new QByteArray();
-    auto netJob = makeShared<NetJob>(QString("%1::Search").arg(debugName()), APPLICATION->network());
-
-    netJob->addNetAction(Net::Download::makeByteArray(QUrl(search_url), response));
-
-    QObject::connect(netJob.get(), &NetJob::succeeded, [this, response, callbacks]{
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from " << debugName() << " at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-
-            callbacks.on_fail(parse_error.errorString(), -1);
-
-            return;
-        }
+    auto task = makeShared<ResourceSearchTask>(QUrl(search_url), debugName());
+    auto raw_task = task.get();
 
+    QObject::connect(task.get(), &Task::succeeded, [raw_task, callbacks] {
+        auto doc = raw_task->document();
         callbacks.on_succeed(doc);
     });
-
-    QObject::connect(netJob.get(), &NetJob::failed, [&netJob, callbacks](QString reason){
-        int network_error_code = -1;
-        if (auto* failed_action = netJob->getFailedActions().at(0); failed_action && failed_action->m_reply)
-            network_error_code = failed_action->m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-
-       callbacks.on_fail(reason, network_error_code); 
-    });
-    QObject::connect(netJob.get(), &NetJob::aborted, [callbacks]{
-       callbacks.on_abort(); 
+    QObject::connect(task.get(), &Task::failed, [raw_task, callbacks](QString reason) {
+        callbacks.on_fail(reason, raw_task->networkErrorCode());
     });
-    QObject::connect(netJob.get(), &NetJob::finished, [response] {
-        delete response;
+    QObject::connect(task.get(), &Task::aborted, [callbacks] {
+        callbacks.on_abort();
     });
 
-
-    return netJob;
+    return task;
 }
 
 Task::Ptr NetworkResourceAPI::getProjectInfo(ProjectInfoArgs&& args, ProjectInfoCallbacks&& callbacks) const
 {
     auto response = new QByteArray();
     auto job = getProject(args.pack.addonId.toString(), response);
+    if (!job)
+        return nullptr;
 
-    QObject::connect(job.get(), &NetJob::succeeded, [response, callbacks, args] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response for mod info at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-            return;
-        }
-
-        callbacks.on_succeed(doc, args.pack);
-    });
+    auto doc = Net::parseJson(job.get(), response, "mod info");
+    QObject::connect(job.get(), &NetJob::succeeded, [doc, callbacks, args] { callbacks.on_succeed(*doc, args.pack); });
 
     return job;
 }
@@ -88,22 +61,13 @@ Task::Ptr NetworkResourceAPI::getProjectVersions(VersionSearchArgs&& args, Versi
     auto versions_url = versions_url_optional.value();
 
     auto netJob = makeShared<NetJob>(QString("%1::Versions").arg(args.pack.name), APPLICATION->network());
+    netJob->setPriority(Net::Priority::Interactive);
     auto response = new QByteArray();
 
-    netJob->addNetAction(Net::Download::makeByteArray(versions_url, response));
+    ProjectCache::fetch(netJob.get(), versions_url, response);
 
-    QObject::connect(netJob.get(), &NetJob::succeeded, [response, callbacks, args] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response for getting versions at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-            return;
-        }
-
-        callbacks.on_succeed(doc, args.pack);
-    });
+    auto doc = Net::parseJson(netJob.get(), response, "getting versions");
+    QObject::connect(netJob.get(), &NetJob::succeeded, [doc, callbacks, args] { callbacks.on_succeed(*doc, args.pack); });
 
     QObject::connect(netJob.get(), &NetJob::finished, [response] {
         delete response;
@@ -121,8 +85,9 @@ Task::Ptr NetworkResourceAPI::getProject(QString addonId, QByteArray* response)
     auto project_url = project_url_optional.value();
 
     auto netJob = makeShared<NetJob>(QString("%1::GetProject").arg(addonId), APPLICATION->network());
+    netJob->setPriority(Net::Priority::Interactive);
 
-    netJob->addNetAction(Net::Download::makeByteArray(QUrl(project_url), response));
+    ProjectCache::fetch(netJob.get(), QUrl(project_url), response);
 
     QObject::connect(netJob.get(), &NetJob::finished, [response] {
         delete response;
@@ -1,5 +1,7 @@
 #include "OverrideUtils.h"
 
+#include <QCryptographicHash>
+#include <QDebug>
 #include <QDirIterator>
 
 #include "FileSystem.h"
@@ -56,4 +58,59 @@ QStringList readOverrides(const QString& name, const QString& parent_folder)
     return previous_overrides;
 }
 
+static QByteArray hashOf(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+        return {};
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return hash.result();
+}
+
+static bool sameContents(const QString& a, const QString& b)
+{
+    QFileInfo a_info(a), b_info(b);
+    if (!a_info.isFile() || !b_info.isFile() || a_info.size() != b_info.size())
+        return false;
+    auto a_hash = hashOf(a);
+    return !a_hash.isEmpty() && a_hash == hashOf(b);
+}
+
+QStringList diffOverrides(const QString& name,
+                          const QString& old_parent_folder,
+                          const QString& override_path,
+                          const QString& game_root,
+                          QStringList& unchanged)
+{
+    QStringList to_remove;
+    QDir new_dir(override_path);
+    QDir game_dir(game_root);
+
+    for (const auto& entry : readOverrides(name, old_parent_folder)) {
+        if (entry.isEmpty())
+            continue;
+
+        // What's in the instance may not be what the old version put there, so that's compared and not the old list
+        if (sameContents(new_dir.absoluteFilePath(entry), game_dir.absoluteFilePath(entry))) {
+            unchanged.append(entry);
+            continue;
+        }
+
+        qDebug() << "Scheduling" << entry << "for removal";
+        to_remove.append(game_dir.absoluteFilePath(entry));
+    }
+
+    return to_remove;
+}
+
+void dropUnchanged(const QString& override_path, const QStringList& unchanged)
+{
+    QDir dir(override_path);
+    for (const auto& entry : unchanged) {
+        if (!QFile::remove(dir.absoluteFilePath(entry)))
+            qWarning() << "Couldn't leave out the unchanged override" << entry;
+    }
+}
+
 }  // namespace Override
@@ -17,4 +17,19 @@ void createOverrides(const QString& name, const QString& parent_folder, const QS
  */
 QStringList readOverrides(const QString& name, const QString& parent_folder);
 
+/** This compares the overrides of a new version of a pack, in `override_path`, with what the overrides of the old
+ *  version, listed in `old_parent_folder`, left in `game_root`.
+ *
+ *  It returns the old overrides that the new version changed or doesn't have anymore, which are to be removed, and
+ *  puts the ones that are the same in both into `unchanged`.
+ */
+QStringList diffOverrides(const QString& name,
+                          const QString& old_parent_folder,
+                          const QString& override_path,
+                          const QString& game_root,
+                          QStringList& unchanged);
+
+/** This deletes the `unchanged` overrides from `override_path`, so that applying it leaves them alone. */
+void dropUnchanged(const QString& override_path, const QStringList& unchanged);
+
 }  // namespace Override
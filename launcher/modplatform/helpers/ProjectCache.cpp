@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ProjectCache.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFileInfo>
+
+#include "Application.h"
+#include "FileSystem.h"
+#include "net/HttpMetaCache.h"
+#include "net/MetaCacheSink.h"
+
+namespace {
+
+const QString s_cache_base = "ResourceProjects";
+
+// when the API doesn't say, long enough to flip between projects, short enough to see new versions the same day
+constexpr qint64 s_default_lifetime = 10 * 60;
+// the HTML of a description only changes with its text, which is what it's found by
+constexpr qint64 s_html_lifetime = 30 * 24 * 60 * 60;
+
+QString hashOf(const QByteArray& data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+}
+
+}  // namespace
+
+bool ProjectCache::LifetimeValidator::validate(QNetworkReply& reply)
+{
+    auto [max_age, current_age] = Net::MetaCacheSink::cacheLifetime(reply);
+    if (!reply.hasRawHeader("Cache-Control") && !reply.hasRawHeader("Expires"))
+        max_age = s_default_lifetime;
+    *m_lifetime = { max_age, current_age };
+    return true;
+}
+
+void ProjectCache::fetch(NetJob* job, const QUrl& url, QByteArray* response)
+{
+    auto path = "api/" + hashOf(url.toEncoded()) + ".json";
+    if (auto cached = find(path)) {
+        *response = *cached;
+        return;
+    }
+
+    auto lifetime = std::make_shared<Lifetime>();
+    auto download = Net::Download::makeByteArray(url, response);
+    download->addValidator(new LifetimeValidator(lifetime));
+    job->addNetAction(download);
+    QObject::connect(job, &NetJob::succeeded, [path, response, lifetime] { insert(path, *response, *lifetime); });
+}
+
+std::optional<QString> ProjectCache::findHtml(const QString& markdown)
+{
+    if (auto cached = find("html/" + hashOf(markdown.toUtf8()) + ".html"))
+        return QString::fromUtf8(*cached);
+    return {};
+}
+
+void ProjectCache::insertHtml(const QString& markdown, const QString& html)
+{
+    insert("html/" + hashOf(markdown.toUtf8()) + ".html", html.toUtf8(), { s_html_lifetime, 0 });
+}
+
+std::optional<QByteArray> ProjectCache::find(const QString& path)
+{
+    auto entry = APPLICATION->metacache()->resolveEntry(s_cache_base, path);
+    if (entry->isStale())
+        return {};
+
+    try {
+        return FS::read(entry->getFullPath());
+    } catch (const FS::FileSystemException& e) {
+        qWarning() << "Failed to read a cached project answer:" << e.cause();
+        return {};
+    }
+}
+
+void ProjectCache::insert(const QString& path, const QByteArray& data, const Lifetime& lifetime)
+{
+    if (data.isEmpty() || lifetime.max_age <= lifetime.current_age)
+        return;
+
+    auto entry = APPLICATION->metacache()->resolveEntry(s_cache_base, path);
+    try {
+        FS::write(entry->getFullPath(), data);
+    } catch (const FS::FileSystemException& e) {
+        qWarning() << "Failed to cache a project answer:" << e.cause();
+        return;
+    }
+
+    entry->setMD5Sum(QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex().constData());
+    entry->setLocalChangedTimestamp(QFileInfo(entry->getFullPath()).lastModified().toUTC().toMSecsSinceEpoch());
+    entry->setMaximumAge(lifetime.max_age);
+    entry->setCurrentAge(lifetime.current_age);
+    entry->setStale(false);
+    APPLICATION->metacache()->updateEntry(entry);
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+
+#include <memory>
+#include <optional>
+
+#include "net/NetJob.h"
+#include "net/Validator.h"
+
+/* What the platforms answered about projects (their info, description and versions) for the mod browser, kept for as
+ * long as their API allows it to be cached.
+ *
+ * The answers live in the "ResourceProjects" base of the HTTP meta cache, so selecting a project again, in this session
+ * or a later one, doesn't ask the API again until its answer expired. An answer without caching headers is kept for a
+ * few minutes, and one that says it can't be kept isn't. The HTML made of the descriptions is kept there too, by the
+ * hash of their text.
+ */
+class ProjectCache {
+   public:
+    struct Lifetime {
+        qint64 max_age = 0;
+        qint64 current_age = 0;
+    };
+
+    /* Reads the lifetime of the reply it's attached to from its headers. */
+    class LifetimeValidator : public Net::Validator {
+       public:
+        explicit LifetimeValidator(std::shared_ptr<Lifetime> lifetime) : m_lifetime(std::move(lifetime)) {}
+
+        bool init(QNetworkRequest&) override { return true; }
+        bool write(QByteArray&) override { return true; }
+        bool abort() override { return true; }
+        bool validate(QNetworkReply& reply) override;
+
+       private:
+        std::shared_ptr<Lifetime> m_lifetime;
+    };
+
+    /** Puts what `url` answers in `response` by the time `job` succeeds: right away when its answer is still cached,
+     * with a request added to `job` otherwise, which answer is then cached. */
+    static void fetch(NetJob* job, const QUrl& url, QByteArray* response);
+
+    /** The HTML made of a description with that text, if it's cached. */
+    static std::optional<QString> findHtml(const QString& markdown);
+    static void insertHtml(const QString& markdown, const QString& html);
+
+   private:
+    static std::optional<QByteArray> find(const QString& path);
+    static void insert(const QString& path, const QByteArray& data, const Lifetime& lifetime);
+};
@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ResourceSearchTask.h"
+
+#include <QDateTime>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QPointer>
+#include <QtConcurrent>
+
+#include "Application.h"
+#include "Executors.h"
+#include "net/NetJob.h"
+
+// how much of the result pages is kept (going by the size of the responses), and for how long
+static const qint64 s_cache_budget = 8 * 1024 * 1024;
+static const qint64 s_cache_lifetime_secs = 10 * 60;
+
+// A request for a search URL, and the tasks waiting for its results
+struct ResourceSearchFetch {
+    QString key;
+    NetJob::Ptr job;
+    std::shared_ptr<QByteArray> response = std::make_shared<QByteArray>();
+    QList<QPointer<ResourceSearchTask>> waiting;
+};
+
+namespace {
+struct CachedPage {
+    QJsonDocument document;
+    qint64 bytes = 0;
+    qint64 fetched_at = 0;
+};
+
+struct ParsedPage {
+    QJsonDocument document;
+    QString error;
+};
+
+// search URL -> its results, the least recently used first in s_page_order
+QHash<QString, CachedPage> s_pages;
+QStringList s_page_order;
+qint64 s_cached_bytes = 0;
+// search URL -> the request getting it
+QHash<QString, std::shared_ptr<ResourceSearchFetch>> s_fetches;
+
+// the job holds on to the fetch through its connections, this breaks the cycle once it's done
+void fetchDone(const std::shared_ptr<ResourceSearchFetch>& fetch)
+{
+    s_fetches.remove(fetch->key);
+    fetch->job.reset();
+}
+
+bool findPage(const QString& key, QJsonDocument& document)
+{
+    auto page = s_pages.find(key);
+    if (page == s_pages.end())
+        return false;
+    if (QDateTime::currentSecsSinceEpoch() - page->fetched_at > s_cache_lifetime_secs) {
+        s_cached_bytes -= page->bytes;
+        s_pages.erase(page);
+        s_page_order.removeOne(key);
+        return false;
+    }
+    s_page_order.removeOne(key);
+    s_page_order.append(key);
+    document = page->document;
+    return true;
+}
+
+void storePage(const QString& key, const QJsonDocument& document, qint64 bytes)
+{
+    s_cached_bytes -= s_pages.value(key).bytes;
+    s_page_order.removeOne(key);
+    s_page_order.append(key);
+    s_pages.insert(key, { document, bytes, QDateTime::currentSecsSinceEpoch() });
+    s_cached_bytes += bytes;
+    // the page that was just stored is always kept
+    while (s_cached_bytes > s_cache_budget && s_page_order.size() > 1)
+        s_cached_bytes -= s_pages.take(s_page_order.takeFirst()).bytes;
+}
+}  // namespace
+
+ResourceSearchTask::ResourceSearchTask(QUrl url, QString debug_name) : Task(), m_url(url), m_debug_name(debug_name) {}
+
+ResourceSearchTask::~ResourceSearchTask()
+{
+    leaveFetch();
+}
+
+void ResourceSearchTask::executeTask()
+{
+    auto key = m_url.toString();
+    setStatus(tr("Searching..."));
+
+    if (findPage(key, m_document)) {
+        QMetaObject::invokeMethod(this, &ResourceSearchTask::emitSucceeded, Qt::QueuedConnection);
+        return;
+    }
+
+    m_fetch = s_fetches.value(key);
+    if (!m_fetch)
+        startFetch(key);
+    m_fetch->waiting.append(this);
+}
+
+void ResourceSearchTask::startFetch(const QString& key)
+{
+    auto fetch = std::make_shared<ResourceSearchFetch>();
+    fetch->key = key;
+    fetch->job = makeShared<NetJob>(QString("%1::Search").arg(m_debug_name), APPLICATION->network());
+    fetch->job->setPriority(Net::Priority::Interactive);
+    fetch->job->addNetAction(Net::Download::makeByteArray(m_url, fetch->response.get()));
+    s_fetches.insert(key, fetch);
+    m_fetch = fetch;
+
+    auto debug_name = m_debug_name;
+    QObject::connect(fetch->job.get(), &NetJob::succeeded, [fetch, debug_name] {
+        auto response = fetch->response;
+        fetch->job.reset();
+        auto future = QtConcurrent::run(Executors::cpu(), [response, debug_name] {
+            ParsedPage page;
+            QJsonParseError parse_error{};
+            page.document = QJsonDocument::fromJson(*response, &parse_error);
+            if (parse_error.error != QJsonParseError::NoError) {
+                qWarning() << "Error while parsing JSON response from " << debug_name << " at " << parse_error.offset
+                           << " reason: " << parse_error.errorString();
+                qWarning() << *response;
+                page.error = parse_error.errorString();
+            }
+            return page;
+        });
+
+        auto watcher = new QFutureWatcher<ParsedPage>();
+        QObject::connect(watcher, &QFutureWatcher<ParsedPage>::finished, [fetch, watcher] {
+            auto page = watcher->result();
+            watcher->deleteLater();
+
+            fetchDone(fetch);
+            if (page.error.isEmpty())
+                storePage(fetch->key, page.document, fetch->response->size());
+
+            for (auto& task : fetch->waiting) {
+                if (!task || !task->isRunning())
+                    continue;
+                task->m_fetch.reset();
+                if (!page.error.isEmpty()) {
+                    task->emitFailed(page.error);
+                    continue;
+                }
+                task->m_document = page.document;
+                task->emitSucceeded();
+            }
+        });
+        watcher->setFuture(future);
+    });
+
+    QObject::connect(fetch->job.get(), &NetJob::failed, [fetch](QString reason) {
+        int network_error_code = -1;
+        auto failed_actions = fetch->job->getFailedActions();
+        if (!failed_actions.isEmpty() && failed_actions.first()->m_reply)
+            network_error_code = failed_actions.first()->m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        fetchDone(fetch);
+
+        for (auto& task : fetch->waiting) {
+            if (!task || !task->isRunning())
+                continue;
+            task->m_fetch.reset();
+            task->m_network_error_code = network_error_code;
+            task->emitFailed(reason);
+        }
+    });
+
+    QObject::connect(fetch->job.get(), &NetJob::aborted, [fetch] {
+        fetchDone(fetch);
+        for (auto& task : fetch->waiting) {
+            if (!task || !task->isRunning())
+                continue;
+            task->m_fetch.reset();
+            task->emitAborted();
+        }
+    });
+
+    fetch->job->start();
+}
+
+bool ResourceSearchTask::abort()
+{
+    leaveFetch();
+    if (isRunning())
+        emitAborted();
+    return true;
+}
+
+void ResourceSearchTask::leaveFetch()
+{
+    if (!m_fetch)
+        return;
+
+    auto fetch = std::move(m_fetch);
+    m_fetch.reset();
+    fetch->waiting.removeAll(this);
+
+    // the others that wanted these results still do
+    bool wanted = false;
+    for (auto& task : fetch->waiting)
+        wanted |= task && task->isRunning();
+    if (!wanted && fetch->job && fetch->job->isRunning())
+        fetch->job->abort();
+}
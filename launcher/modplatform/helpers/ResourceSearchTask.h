@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QJsonDocument>
+#include <QUrl>
+#include <memory>
+
+#include "tasks/Task.h"
+
+struct ResourceSearchFetch;
+
+/* Gets the search results at a URL, as a JSON document.
+ *
+ * The search URLs have everything in them: the query, filters, sorting and offset. So the results are kept,
+ * by URL, for the last few searches (as many as fit in a few megabytes), and going back to one of them (another sorting and back, deleting what
+ * was just typed, ...) doesn't ask the API again. Searches for a URL that is already being fetched wait for
+ * that one instead of making another request, and the responses are parsed on the global thread pool.
+ *
+ * Everything shared between the tasks is only touched from the GUI thread.
+ */
+class ResourceSearchTask : public Task {
+    Q_OBJECT
+   public:
+    using Ptr = shared_qobject_ptr<ResourceSearchTask>;
+
+    ResourceSearchTask(QUrl url, QString debug_name);
+    ~ResourceSearchTask() override;
+
+    /** The results, once the task succeeded. */
+    [[nodiscard]] QJsonDocument document() const { return m_document; }
+    /** The HTTP status of the response if the task failed because of it, -1 otherwise. */
+    [[nodiscard]] int networkErrorCode() const { return m_network_error_code; }
+
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    void startFetch(const QString& key);
+    void leaveFetch();
+
+   private:
+    QUrl m_url;
+    QString m_debug_name;
+    QJsonDocument m_document;
+    int m_network_error_code = -1;
+    std::shared_ptr<ResourceSearchFetch> m_fetch;
+};
@@ -36,30 +36,80 @@
 #include "PackFetchTask.h"
 #include "PrivatePackManager.h"
 
-#include <QDomDocument>
+#include <QDataStream>
+#include <QFile>
+#include <QXmlStreamReader>
+#include <QtConcurrent>
+
 #include "BuildConfig.h"
 #include "Application.h"
+#include "Executors.h"
+#include "FileSystem.h"
 
 namespace LegacyFTB {
 
+namespace {
+constexpr quint32 s_cache_magic = 0x46544250;  // "FTBP"
+// bump it when what's kept of a pack changes
+constexpr quint32 s_cache_version = 1;
+
+QString cachePath()
+{
+    return FS::PathCombine(APPLICATION->metacache()->getBasePath("FTBPacks"), "packlists.bin");
+}
+}  // namespace
+
+// out of the anonymous namespace, for the ones of QList to find them
+static QDataStream &operator<<(QDataStream &out, const Modpack &pack)
+{
+    return out << pack.name << pack.description << pack.author << pack.oldVersions << pack.currentVersion << pack.mcVersion << pack.mods
+               << pack.logo << pack.dir << pack.file << pack.bugged << pack.broken << qint32(pack.type);
+}
+
+static QDataStream &operator>>(QDataStream &in, Modpack &pack)
+{
+    qint32 type;
+    in >> pack.name >> pack.description >> pack.author >> pack.oldVersions >> pack.currentVersion >> pack.mcVersion >> pack.mods
+        >> pack.logo >> pack.dir >> pack.file >> pack.bugged >> pack.broken >> type;
+    pack.type = PackType(type);
+    return in;
+}
+
 void PackFetchTask::fetch()
 {
-    publicPacks.clear();
-    thirdPartyPacks.clear();
+    auto metacache = APPLICATION->metacache();
+    m_publicEntry = metacache->resolveEntry("FTBPacks", "modpacks.xml");
+    m_thirdPartyEntry = metacache->resolveEntry("FTBPacks", "thirdparty.xml");
+    m_sentKey.clear();
+
+    // the lists of the last time are shown while they're checked for changes
+    auto key = cacheKey(m_publicEntry, m_thirdPartyEntry);
+    QFile cache(cachePath());
+    if (!key.isEmpty() && cache.open(QIODevice::ReadOnly))
+    {
+        ModpackList publicPacks;
+        ModpackList thirdPartyPacks;
+        if (deserializeLists(cache.readAll(), key, publicPacks, thirdPartyPacks))
+        {
+            m_sentKey = key;
+            emit finished(publicPacks, thirdPartyPacks);
+        }
+    }
 
     jobPtr.reset(new NetJob("LegacyFTB::ModpackFetch", m_network));
 
     QUrl publicPacksUrl = QUrl(BuildConfig.LEGACY_FTB_CDN_BASE_URL + "static/modpacks.xml");
     qDebug() << "Downloading public version info from" << publicPacksUrl.toString();
-    jobPtr->addNetAction(Net::Download::makeByteArray(publicPacksUrl, &publicModpacksXmlFileData));
+    jobPtr->addNetAction(Net::Download::makeCached(publicPacksUrl, m_publicEntry));
 
     QUrl thirdPartyUrl = QUrl(BuildConfig.LEGACY_FTB_CDN_BASE_URL + "static/thirdparty.xml");
     qDebug() << "Downloading thirdparty version info from" << thirdPartyUrl.toString();
-    jobPtr->addNetAction(Net::Download::makeByteArray(thirdPartyUrl, &thirdPartyModpacksXmlFileData));
+    jobPtr->addNetAction(Net::Download::makeCached(thirdPartyUrl, m_thirdPartyEntry));
 
     QObject::connect(jobPtr.get(), &NetJob::succeeded, this, &PackFetchTask::fileDownloadFinished);
     QObject::connect(jobPtr.get(), &NetJob::failed, this, &PackFetchTask::fileDownloadFailed);
     QObject::connect(jobPtr.get(), &NetJob::aborted, this, &PackFetchTask::fileDownloadAborted);
+    QObject::connect(&m_parseWatcher, &QFutureWatcher<Lists>::finished, this, &PackFetchTask::listsParsed, Qt::UniqueConnection);
 
     jobPtr->start();
 }
@@ -77,7 +127,9 @@ void PackFetchTask::fetchPrivate(const QStringList & toFetch)
         QObject::connect(job, &NetJob::succeeded, this, [this, job, data, packCode]
         {
             ModpackList packs;
-            parseAndAddPacks(*data, PackType::Private, packs);
+            auto error = parsePacks(*data, PackType::Private, packs);
+            if (!error.isEmpty())
+                qWarning() << "Failed to fetch modpack data:" << error;
             foreach(Modpack currentPack, packs)
             {
                 currentPack.packCode = packCode;
@@ -115,69 +167,115 @@ void PackFetchTask::fileDownloadFinished()
 {
     jobPtr.reset();
 
-    QStringList failedLists;
-
-    if(!parseAndAddPacks(publicModpacksXmlFileData, PackType::Public, publicPacks))
+    auto key = cacheKey(m_publicEntry, m_thirdPartyEntry);
+    if (!key.isEmpty() && key == m_sentKey)
     {
-        failedLists.append(tr("Public Packs"));
+        // the lists shown already are the current ones
+        return;
     }
 
-    if(!parseAndAddPacks(thirdPartyModpacksXmlFileData, PackType::ThirdParty, thirdPartyPacks))
-    {
-        failedLists.append(tr("Third Party Packs"));
-    }
+    m_parseWatcher.setFuture(QtConcurrent::run(Executors::cpu(), &PackFetchTask::parseLists, m_publicEntry->getFullPath(),
+                                               m_thirdPartyEntry->getFullPath(), key, cachePath()));
+}
 
-    if(failedLists.size() > 0)
-    {
-        emit failed(tr("Failed to download some pack lists: %1").arg(failedLists.join("\n- ")));
-    }
-    else
+void PackFetchTask::listsParsed()
+{
+    auto lists = m_parseWatcher.result();
+    if (!lists.error.isEmpty())
     {
-        emit finished(publicPacks, thirdPartyPacks);
+        if (m_sentKey.isEmpty())
+            emit failed(lists.error);
+        else
+            qWarning() << "Keeping the cached FTB pack lists:" << lists.error;
+        return;
     }
+    emit finished(lists.publicPacks, lists.thirdPartyPacks);
 }
 
-bool PackFetchTask::parseAndAddPacks(QByteArray &data, PackType packType, ModpackList &list)
+QString PackFetchTask::cacheKey(const MetaEntryPtr &publicEntry, const MetaEntryPtr &thirdPartyEntry)
 {
-    QDomDocument doc;
+    // the md5sums the files got when they were downloaded, the servers don't always send an ETag
+    auto publicMd5 = publicEntry->getMD5Sum();
+    auto thirdPartyMd5 = thirdPartyEntry->getMD5Sum();
+    if (publicMd5.isEmpty() || thirdPartyMd5.isEmpty())
+        return {};
+    return publicMd5 + ":" + thirdPartyMd5;
+}
 
-    QString errorMsg = "Unknown error.";
-    int errorLine = -1;
-    int errorCol = -1;
+PackFetchTask::Lists PackFetchTask::parseLists(QString publicPath, QString thirdPartyPath, QString key, QString cachePath)
+{
+    Lists lists;
+    QStringList failedLists;
+    auto parse = [&failedLists](const QString &path, PackType packType, ModpackList &list, const QString &name)
+    {
+        QString error;
+        try
+        {
+            error = parsePacks(FS::read(path), packType, list);
+        }
+        catch (const FS::FileSystemException &e)
+        {
+            error = e.cause();
+        }
+        if (!error.isEmpty())
+        {
+            qWarning() << "Failed to fetch modpack data:" << error;
+            failedLists.append(name);
+        }
+    };
+    parse(publicPath, PackType::Public, lists.publicPacks, tr("Public Packs"));
+    parse(thirdPartyPath, PackType::ThirdParty, lists.thirdPartyPacks, tr("Third Party Packs"));
 
-    if(!doc.setContent(data, false, &errorMsg, &errorLine, &errorCol))
+    if (!failedLists.isEmpty())
     {
-        auto fullErrMsg = QString("Failed to fetch modpack data: %1 %2:%3!").arg(errorMsg).arg(errorLine).arg(errorCol);
-        qWarning() << fullErrMsg;
-        data.clear();
-        return false;
+        lists.error = tr("Failed to download some pack lists: %1").arg(failedLists.join("\n- "));
+        return lists;
     }
 
-    QDomNodeList nodes = doc.elementsByTagName("modpack");
-    for(int i = 0; i < nodes.length(); i++)
+    if (!key.isEmpty())
     {
-        QDomElement element = nodes.at(i).toElement();
+        try
+        {
+            FS::write(cachePath, serializeLists(key, lists.publicPacks, lists.thirdPartyPacks));
+        }
+        catch (const FS::FileSystemException &e)
+        {
+            qWarning() << "Couldn't cache the FTB pack lists:" << e.cause();
+        }
+    }
+    return lists;
+}
+
+QString PackFetchTask::parsePacks(const QByteArray &data, PackType packType, ModpackList &list)
+{
+    ModpackList packs;
+    QXmlStreamReader reader(data);
+    while (!reader.atEnd())
+    {
+        if (reader.readNext() != QXmlStreamReader::StartElement || reader.name() != QLatin1String("modpack"))
+        {
+            continue;
+        }
+
+        auto attributes = reader.attributes();
+        auto attribute = [&attributes](const char *name) { return attributes.value(QLatin1String(name)).toString(); };
 
         Modpack modpack;
-        modpack.name = element.attribute("name");
-        modpack.currentVersion = element.attribute("version");
-        modpack.mcVersion = element.attribute("mcVersion");
-        modpack.description = element.attribute("description");
-        modpack.mods = element.attribute("mods");
-        modpack.logo = element.attribute("logo");
-        modpack.oldVersions = element.attribute("oldVersions").split(";");
+        modpack.name = attribute("name");
+        modpack.currentVersion = attribute("version");
+        modpack.mcVersion = attribute("mcVersion");
+        modpack.description = attribute("description");
+        modpack.mods = attribute("mods");
+        modpack.logo = attribute("logo");
+        modpack.oldVersions = attribute("oldVersions").split(";");
         modpack.broken = false;
         modpack.bugged = false;
 
         //remove empty if the xml is bugged
-        for(QString curr : modpack.oldVersions)
+        if(modpack.oldVersions.removeAll(QString()) > 0)
         {
-            if(curr.isNull() || curr.isEmpty())
-            {
-                modpack.oldVersions.removeAll(curr);
-                modpack.bugged = true;
-                qWarning() << "Removed some empty versions from" << modpack.name;
-            }
+            modpack.bugged = true;
+            qWarning() << "Removed some empty versions from" << modpack.name;
         }
 
         if(modpack.oldVersions.size() < 1)
@@ -194,22 +292,62 @@ bool PackFetchTask::parseAndAddPacks(QByteArray &data, PackType packType, Modpac
             }
         }
 
-        modpack.author = element.attribute("author");
+        modpack.author = attribute("author");
 
-        modpack.dir = element.attribute("dir");
-        modpack.file = element.attribute("url");
+        modpack.dir = attribute("dir");
+        modpack.file = attribute("url");
 
         modpack.type = packType;
 
-        list.append(modpack);
+        packs.append(modpack);
+    }
+
+    if (reader.hasError())
+    {
+        return QString("%1 %2:%3").arg(reader.errorString()).arg(reader.lineNumber()).arg(reader.columnNumber());
     }
+    list.append(packs);
+    return {};
+}
 
+QByteArray PackFetchTask::serializeLists(const QString &key, const ModpackList &publicPacks, const ModpackList &thirdPartyPacks)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << s_cache_magic << s_cache_version << key << publicPacks << thirdPartyPacks;
+    return data;
+}
+
+bool PackFetchTask::deserializeLists(const QByteArray &data, const QString &key, ModpackList &publicPacks, ModpackList &thirdPartyPacks)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_12);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString cachedKey;
+    in >> magic >> version >> cachedKey;
+    if (in.status() != QDataStream::Ok || magic != s_cache_magic || version != s_cache_version || cachedKey != key)
+        return false;
+
+    ModpackList cachedPublic;
+    ModpackList cachedThirdParty;
+    in >> cachedPublic >> cachedThirdParty;
+    if (in.status() != QDataStream::Ok)
+        return false;
+    publicPacks = cachedPublic;
+    thirdPartyPacks = cachedThirdParty;
     return true;
 }
 
 void PackFetchTask::fileDownloadFailed(QString reason)
 {
     qWarning() << "Fetching FTBPacks failed:" << reason;
+    if (!m_sentKey.isEmpty())
+    {
+        // offline, the ones from the cache are still there
+        return;
+    }
     emit failed(reason);
 }
 
@@ -3,6 +3,7 @@
 #include "net/NetJob.h"
 #include <QTemporaryDir>
 #include <QByteArray>
+#include <QFutureWatcher>
 #include <QObject>
 #include "PackHelpers.h"
 
@@ -16,19 +17,43 @@ public:
     PackFetchTask(shared_qobject_ptr<QNetworkAccessManager> network) : QObject(nullptr), m_network(network) {};
     virtual ~PackFetchTask() = default;
 
+    /**
+     * Gets the public and third party pack lists. The lists of the last time are sent right away if they're there,
+     * and again once they were downloaded, only if they changed since.
+     */
     void fetch();
     void fetchPrivate(const QStringList &toFetch);
 
+    /** Reads the packs of a pack list, returns the error if it isn't one. */
+    static QString parsePacks(const QByteArray &data, PackType packType, ModpackList &list);
+
+    /** The lists as they are cached between sessions, under `key`, the md5sums of the files they come from. */
+    static QByteArray serializeLists(const QString &key, const ModpackList &publicPacks, const ModpackList &thirdPartyPacks);
+    /** Whether `data` has lists cached under `key`. They're put in the lists when it does. */
+    static bool deserializeLists(const QByteArray &data, const QString &key, ModpackList &publicPacks, ModpackList &thirdPartyPacks);
+
 private:
+    struct Lists {
+        QString error;
+        ModpackList publicPacks;
+        ModpackList thirdPartyPacks;
+    };
+
+    /** What the pack lists in the cache are now. */
+    static QString cacheKey(const MetaEntryPtr &publicEntry, const MetaEntryPtr &thirdPartyEntry);
+    /** Parses the downloaded lists, on a worker, and caches the result. */
+    static Lists parseLists(QString publicPath, QString thirdPartyPath, QString key, QString cachePath);
+
+    void listsParsed();
+
     shared_qobject_ptr<QNetworkAccessManager> m_network;
     NetJob::Ptr jobPtr;
 
-    QByteArray publicModpacksXmlFileData;
-    QByteArray thirdPartyModpacksXmlFileData;
-
-    bool parseAndAddPacks(QByteArray &data, PackType packType, ModpackList &list);
-    ModpackList publicPacks;
-    ModpackList thirdPartyPacks;
+    MetaEntryPtr m_publicEntry;
+    MetaEntryPtr m_thirdPartyEntry;
+    // of the lists sent already, empty if none were
+    QString m_sentKey;
+    QFutureWatcher<Lists> m_parseWatcher;
 
 protected slots:
     void fileDownloadFinished();
@@ -37,6 +37,7 @@
 
 #include <QtConcurrent>
 
+#include "Executors.h"
 #include "MMCZip.h"
 #include "BaseInstance.h"
 #include "FileSystem.h"
@@ -127,9 +128,9 @@ void PackInstallTask::unzip()
     }
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), QOverload<QString, QString>::of(MMCZip::extractDir), archivePath, extractDir.absolutePath() + "/unzip");
+    m_extractFuture = QtConcurrent::run(Executors::io(), QOverload<QString, QString>::of(MMCZip::extractDir), archivePath, extractDir.absolutePath() + "/unzip");
 #else
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), MMCZip::extractDir, archivePath, extractDir.absolutePath() + "/unzip");
+    m_extractFuture = QtConcurrent::run(Executors::io(), MMCZip::extractDir, archivePath, extractDir.absolutePath() + "/unzip");
 #endif
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &PackInstallTask::onUnzipFinished);
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &PackInstallTask::onUnzipCanceled);
@@ -38,12 +38,18 @@
 
 #include "FTBPackInstallTask.h"
 
+#include <QtConcurrentRun>
+
+#include <algorithm>
+
+#include "ContentStore.h"
 #include "FileSystem.h"
+#include "InstanceList.h"
+#include "digest/Digest.h"
 #include "Json.h"
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
 #include "modplatform/flame/PackManifest.h"
-#include "net/ChecksumValidator.h"
 #include "settings/INISettingsObject.h"
 
 #include "Application.h"
@@ -193,6 +199,7 @@ void PackInstallTask::onResolveModsSucceeded()
             blocked_mod.name = local_file.name;
             blocked_mod.websiteUrl = results_file.websiteUrl;
             blocked_mod.hash = results_file.hash;
+            blocked_mod.size = results_file.size ? results_file.size : local_file.size;
             blocked_mod.matched = false;
             blocked_mod.localPath = "";
             blocked_mod.targetFolder = results_file.targetFolder;
@@ -291,24 +298,99 @@ void PackInstallTask::onCreateInstanceSucceeded()
 
 void PackInstallTask::downloadPack()
 {
-    setStatus(tr("Downloading mods..."));
+    setStatus(tr("Looking for files to reuse..."));
     setAbortable(false);
 
-    auto jobPtr = makeShared<NetJob>(tr("Mod download"), APPLICATION->network());
-    for (auto const& file : m_version.files) {
-        if (file.serverOnly || file.url.isEmpty())
+    // Other instances of the same pack have most of the files already, those are copied and not downloaded again
+    struct Candidate {
+        int index;
+        QString from;
+        QString to;
+        QByteArray sha1;
+        qint64 size;
+    };
+    QList<Candidate> candidates;
+
+    QList<QDir> roots;
+    auto instances = APPLICATION->instances();
+    for (int i = 0; i < instances->count(); i++) {
+        auto instance = instances->at(i);
+        if (instance->getManagedPackType() == "modpacksch" && instance->getManagedPackID() == QString::number(m_pack.id))
+            roots.append(QDir(instance->gameRoot()));
+    }
+
+    for (int index = 0; index < m_version.files.size(); index++) {
+        auto const& file = m_version.files.at(index);
+        if (file.serverOnly || file.url.isEmpty() || file.sha1.isEmpty())
+            continue;
+
+        auto sha1 = QByteArray::fromHex(file.sha1.toLatin1());
+        // the shared store places it without a request anyway
+        if (ContentStore::isEnabled() && ContentStore::contains(QCryptographicHash::Sha1, sha1))
             continue;
 
         auto path = FS::PathCombine(m_stagingPath, ".minecraft", file.path, file.name);
-        qDebug() << "Will try to download" << file.url << "to" << path;
+        for (auto const& root : roots) {
+            auto from = root.absoluteFilePath(FS::PathCombine(file.path, file.name));
+            if (QFileInfo(from).size() == file.size)
+                candidates.append({ index, from, path, sha1, file.size });
+        }
+    }
 
-        QFileInfo file_info(file.name);
+    if (candidates.isEmpty()) {
+        startDownloads({});
+        return;
+    }
 
-        auto dl = Net::Download::makeFile(file.url, path);
-        if (!file.sha1.isEmpty()) {
-            auto rawSha1 = QByteArray::fromHex(file.sha1.toLatin1());
-            dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawSha1));
+    connect(&m_reuse_watcher, &QFutureWatcher<QSet<int>>::finished, this, [this] { startDownloads(m_reuse_watcher.result()); });
+    m_reuse_watcher.setFuture(QtConcurrent::run([candidates] {
+        QSet<int> reused;
+        for (auto const& candidate : candidates) {
+            if (reused.contains(candidate.index))
+                continue;
+
+            QFile file(candidate.from);
+            if (!file.open(QFile::ReadOnly))
+                continue;
+            Digest hash(QCryptographicHash::Sha1);
+            hash.addData(&file);
+            if (hash.result() != candidate.sha1)
+                continue;
+
+            // a clone or a copy, the instances mustn't share a file that one of them may change
+            if (FS::cloneOrLinkFile(candidate.from, candidate.to, true, false)) {
+                qDebug() << "Reusing" << candidate.from;
+                reused.insert(candidate.index);
+            }
         }
+        return reused;
+    }));
+}
+
+void PackInstallTask::startDownloads(const QSet<int>& reused)
+{
+    setStatus(tr("Downloading mods..."));
+
+    // The biggest files go first, so the download doesn't end waiting for one big file after all the small ones
+    QList<int> order;
+    for (int index = 0; index < m_version.files.size(); index++) {
+        auto const& file = m_version.files.at(index);
+        if (file.serverOnly || file.url.isEmpty() || reused.contains(index))
+            continue;
+        order.append(index);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return m_version.files.at(a).size > m_version.files.at(b).size; });
+    if (!reused.isEmpty())
+        qDebug() << "Reused" << reused.size() << "files from other instances of the pack," << order.size() << "are left to download";
+
+    auto jobPtr = makeShared<NetJob>(tr("Mod download"), APPLICATION->network());
+    for (auto index : order) {
+        auto const& file = m_version.files.at(index);
+
+        auto path = FS::PathCombine(m_stagingPath, ".minecraft", file.path, file.name);
+        qDebug() << "Will try to download" << file.url << "to" << path;
+
+        auto dl = Net::Download::makeStored(file.url, path, "sha1", file.sha1);
 
         jobPtr->addNetAction(dl);
     }
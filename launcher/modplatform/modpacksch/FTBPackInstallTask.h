@@ -45,6 +45,8 @@
 #include "net/NetJob.h"
 #include "ui/dialogs/BlockedModsDialog.h"
 
+#include <QFutureWatcher>
+#include <QSet>
 #include <QWidget>
 
 namespace ModpacksCH {
@@ -77,10 +79,12 @@ private:
     void resolveMods();
     void createInstance();
     void downloadPack();
+    void startDownloads(const QSet<int>& reused);
     void copyBlockedMods();
 
 private:
     NetJob::Ptr m_net_job = nullptr;
+    QFutureWatcher<QSet<int>> m_reuse_watcher;
     shared_qobject_ptr<Flame::FileResolvingTask> m_mod_id_resolver_task = nullptr;
 
     QList<int> m_file_id_map;
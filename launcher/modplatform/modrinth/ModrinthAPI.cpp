@@ -76,7 +76,8 @@ Task::Ptr ModrinthAPI::latestVersions(const QStringList& hashes,
                                       QString hash_format,
                                       std::optional<std::list<Version>> mcVersions,
                                       std::optional<ModLoaderTypes> loaders,
-                                      QByteArray* response)
+                                      QByteArray* response,
+                                      Net::Validator* validator)
 {
     auto netJob = makeShared<NetJob>(QString("Modrinth::GetLatestVersions"), APPLICATION->network());
 
@@ -99,7 +100,10 @@ Task::Ptr ModrinthAPI::latestVersions(const QStringList& hashes,
     QJsonDocument body(body_obj);
     auto body_raw = body.toJson();
 
-    netJob->addNetAction(Net::Upload::makeByteArray(QString(BuildConfig.MODRINTH_PROD_URL + "/version_files/update"), response, body_raw));
+    auto upload = Net::Upload::makeByteArray(QString(BuildConfig.MODRINTH_PROD_URL + "/version_files/update"), response, body_raw);
+    if (validator)
+        upload->addValidator(validator);
+    netJob->addNetAction(upload);
 
     QObject::connect(netJob.get(), &NetJob::finished, [response] { delete response; });
 
@@ -10,6 +10,10 @@
 
 #include <QDebug>
 
+namespace Net {
+class Validator;
+}
+
 class ModrinthAPI : public NetworkResourceAPI {
    public:
     auto currentVersion(QString hash,
@@ -30,7 +34,8 @@ class ModrinthAPI : public NetworkResourceAPI {
                         QString hash_format,
                        std::optional<std::list<Version>> mcVersions,
                        std::optional<ModLoaderTypes> loaders,
-                        QByteArray* response) -> Task::Ptr;
+                        QByteArray* response,
+                        Net::Validator* validator = nullptr) -> Task::Ptr;
 
     Task::Ptr getProjects(QStringList addonIds, QByteArray* response) const override;
 
@@ -10,16 +10,21 @@
 
 #include "tasks/ConcurrentTask.h"
 
+#include "ModrinthUpdateCache.h"
+
 #include "minecraft/mod/ModFolderModel.h"
 #include "minecraft/mod/ResourceFolderModel.h"
 
 static ModrinthAPI api;
+// hashes asked about in a single request
+static const int s_batch_size = 100;
 static ModPlatform::ProviderCapabilities ProviderCaps;
 
 bool ModrinthCheckUpdate::abort()
 {
-    if (m_net_job)
-        return m_net_job->abort();
+    m_was_aborted = true;
+    if (m_job)
+        return m_job->abort();
     return true;
 }
 
@@ -33,13 +38,10 @@ void ModrinthCheckUpdate::executeTask()
     setStatus(tr("Preparing mods for Modrinth..."));
     setProgress(0, 3);
 
-    QHash<QString, Mod*> mappings;
-
     // Create all hashes
-    QStringList hashes;
-    auto best_hash_type = ProviderCaps.hashType(ModPlatform::ResourceProvider::MODRINTH).first();
+    m_hash_type = ProviderCaps.hashType(ModPlatform::ResourceProvider::MODRINTH).first();
 
-    ConcurrentTask hashing_task(this, "MakeModrinthHashesTask", 10);
+    auto hashing_task = makeShared<ConcurrentTask>(nullptr, "MakeModrinthHashesTask", 10);
     for (auto* mod : m_mods) {
         if (!mod->enabled()) {
             emit checkFailed(mod, tr("Disabled mods won't be updated, to prevent mod duplication issues!"));
@@ -51,136 +53,165 @@ void ModrinthCheckUpdate::executeTask()
         // Sadly the API can only handle one hash type per call, se we
         // need to generate a new hash if the current one is innadequate
         // (though it will rarely happen, if at all)
-        if (mod->metadata()->hash_format != best_hash_type) {
+        if (mod->metadata()->hash_format != m_hash_type) {
             auto hash_task = Hashing::createModrinthHasher(mod->fileinfo().absoluteFilePath());
-            connect(hash_task.get(), &Task::succeeded, [&] {
-                QString hash(hash_task->getResult());
-                hashes.append(hash);
-                mappings.insert(hash, mod);
-            });
-            connect(hash_task.get(), &Task::failed, [this, hash_task] { failed("Failed to generate hash"); });
-            hashing_task.addTask(hash_task);
+            connect(hash_task.get(), &Task::succeeded, this, [this, hasher = hash_task.get(), mod] { m_mappings.insert(hasher->getResult(), mod); });
+            connect(hash_task.get(), &Task::failed, this, [this, mod] { emit checkFailed(mod, tr("Failed to generate hash")); });
+            hashing_task->addTask(hash_task);
         } else {
-            hashes.append(hash);
-            mappings.insert(hash, mod);
+            m_mappings.insert(hash, mod);
         }
     }
 
-    QEventLoop loop;
-    connect(&hashing_task, &Task::finished, [&loop] { loop.quit(); });
-    hashing_task.start();
-    loop.exec();
+    // nothing waits on a loop of its own, so the updates found can be shown while the others are looked for
+    connect(hashing_task.get(), &Task::finished, this, [this] {
+        if (m_was_aborted) {
+            emitAborted();
+            return;
+        }
+        requestVersions();
+    });
+    m_job = hashing_task;
+    hashing_task->start();
+}
 
-    auto* response = new QByteArray();
-    auto job = api.latestVersions(hashes, best_hash_type, m_game_versions, m_loaders, response);
+void ModrinthCheckUpdate::requestVersions()
+{
+    // Sometimes a version may have multiple files, one with "forge" and one with "fabric",
+    // so we may want to filter it
+    if (m_loaders.has_value()) {
+        static auto flags = { ResourceAPI::ModLoaderType::Forge, ResourceAPI::ModLoaderType::Fabric, ResourceAPI::ModLoaderType::Quilt };
+        for (auto flag : flags) {
+            if (m_loaders.value().testFlag(flag)) {
+                m_loader_filter = api.getModLoaderString(flag);
+                break;
+            }
+        }
+    }
+
+    // Answers we got recently, maybe while checking another instance using the same mods, give their updates right away
+    auto cache = std::make_shared<ModrinthUpdateCache>(m_hash_type, m_game_versions, m_loaders);
+    QStringList to_request;
+    for (auto& hash : m_mappings.keys()) {
+        if (auto cached = cache->find(hash))
+            checkVersion(hash, *cached);
+        else
+            to_request.append(hash);
+    }
 
-    QEventLoop lock;
+    // Ask for the others in batches, sent a few at a time, each looked at as soon as it's there
+    auto job = makeShared<ConcurrentTask>(nullptr, "GetModrinthLatestVersions", APPLICATION->settings()->get("NumberOfConcurrentDownloads").toInt());
+    for (int batch_start = 0; batch_start < to_request.size(); batch_start += s_batch_size) {
+        auto batch = to_request.mid(batch_start, s_batch_size);
+        auto* response = new QByteArray();
+        auto lifetime = std::make_shared<ModrinthUpdateCache::Lifetime>();
+        auto batch_job = api.latestVersions(batch, m_hash_type, m_game_versions, m_loaders, response,
+                                            new ModrinthUpdateCache::LifetimeValidator(lifetime));
+
+        connect(batch_job.get(), &Task::succeeded, this, [this, response, batch, lifetime, cache] {
+            QJsonParseError parse_error{};
+            QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
+            if (parse_error.error != QJsonParseError::NoError) {
+                qWarning() << "Error while parsing JSON response from ModrinthCheckUpdate at " << parse_error.offset
+                           << " reason: " << parse_error.errorString();
+                qWarning() << *response;
+                return;
+            }
 
-    connect(job.get(), &Task::succeeded, this, [this, response, &mappings, best_hash_type, job] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from ModrinthCheckUpdate at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
+            for (auto& hash : batch) {
+                auto project_obj = doc[hash].toObject();
+                cache->insert(hash, project_obj, *lifetime);
+                if (!m_was_aborted)
+                    checkVersion(hash, project_obj);
+            }
+        });
+        job->addTask(batch_job);
+    }
 
-            failed(parse_error.errorString());
+    connect(job.get(), &Task::finished, this, [this] {
+        m_job.reset();
+        if (m_was_aborted) {
+            emitAborted();
             return;
         }
 
-        setStatus(tr("Parsing the API response from Modrinth..."));
         setProgress(2, 3);
+        // what's left didn't get an answer
+        for (auto mod : m_mappings)
+            emit checkFailed(mod, tr("Couldn't get an answer from Modrinth for this mod."));
+        m_mappings.clear();
 
-        try {
-            for (auto hash : mappings.keys()) {
-                auto project_obj = doc[hash].toObject();
-
-                // If the returned project is empty, but we have Modrinth metadata,
-                // it means this specific version is not available
-                if (project_obj.isEmpty()) {
-                    qDebug() << "Mod " << mappings.find(hash).value()->name() << " got an empty response.";
-                    qDebug() << "Hash: " << hash;
-
-                    emit checkFailed(
-                        mappings.find(hash).value(),
-                        tr("No valid version found for this mod. It's probably unavailable for the current game version / mod loader."));
-
-                    continue;
-                }
-
-                // Sometimes a version may have multiple files, one with "forge" and one with "fabric",
-                // so we may want to filter it
-                QString loader_filter;
-                if (m_loaders.has_value()) {
-                    static auto flags = { ResourceAPI::ModLoaderType::Forge, ResourceAPI::ModLoaderType::Fabric,
-                                          ResourceAPI::ModLoaderType::Quilt };
-                    for (auto flag : flags) {
-                        if (m_loaders.value().testFlag(flag)) {
-                            loader_filter = api.getModLoaderString(flag);
-                            break;
-                        }
-                    }
-                }
-
-                // Currently, we rely on a couple heuristics to determine whether an update is actually available or not:
-                // - The file needs to be preferred: It is either the primary file, or the one found via (explicit) usage of the
-                // loader_filter
-                // - The version reported by the JAR is different from the version reported by the indexed version (it's usually the case)
-                // Such is the pain of having arbitrary files for a given version .-.
-
-                auto project_ver = Modrinth::loadIndexedPackVersion(project_obj, best_hash_type, loader_filter);
-                if (project_ver.downloadUrl.isEmpty()) {
-                    qCritical() << "Modrinth mod without download url!";
-                    qCritical() << project_ver.fileName;
-
-                    emit checkFailed(mappings.find(hash).value(), tr("Mod has an empty download URL"));
-
-                    continue;
-                }
-
-                auto mod_iter = mappings.find(hash);
-                if (mod_iter == mappings.end()) {
-                    qCritical() << "Failed to remap mod from Modrinth!";
-                    continue;
-                }
-                auto mod = *mod_iter;
-
-                auto key = project_ver.hash;
-                if ((key != hash && project_ver.is_preferred) || (mod->status() == ModStatus::NotInstalled)) {
-                    if (mod->version() == project_ver.version_number)
-                        continue;
-
-                    // Fake pack with the necessary info to pass to the download task :)
-                    auto pack = std::make_shared<ModPlatform::IndexedPack>();
-                    pack->name = mod->name();
-                    pack->slug = mod->metadata()->slug;
-                    pack->addonId = mod->metadata()->project_id;
-                    pack->websiteUrl = mod->homeurl();
-                    for (auto& author : mod->authors())
-                        pack->authors.append({ author });
-                    pack->description = mod->description();
-                    pack->provider = ModPlatform::ResourceProvider::MODRINTH;
-
-                    auto download_task = makeShared<ResourceDownloadTask>(pack, project_ver, m_mods_folder);
-
-                    m_updatable.emplace_back(pack->name, hash, mod->version(), project_ver.version_number, project_ver.changelog,
-                                             ModPlatform::ResourceProvider::MODRINTH, download_task);
-                }
-            }
-        } catch (Json::JsonException& e) {
-            failed(e.cause() + " : " + e.what());
-        }
+        emitSucceeded();
     });
 
-    connect(job.get(), &Task::finished, &lock, &QEventLoop::quit);
-
     setStatus(tr("Waiting for the API response from Modrinth..."));
     setProgress(1, 3);
 
-    m_net_job = qSharedPointerObjectCast<NetJob, Task>(job);
+    m_job = job;
     job->start();
+}
 
-    lock.exec();
+void ModrinthCheckUpdate::checkVersion(const QString& hash, const QJsonObject& project_obj)
+{
+    auto mod_iter = m_mappings.find(hash);
+    if (mod_iter == m_mappings.end()) {
+        qCritical() << "Failed to remap mod from Modrinth!";
+        return;
+    }
+    auto mod = mod_iter.value();
+    m_mappings.erase(mod_iter);
 
-    emitSucceeded();
+    // If the returned project is empty, but we have Modrinth metadata,
+    // it means this specific version is not available
+    if (project_obj.isEmpty()) {
+        qDebug() << "Mod " << mod->name() << " got an empty response.";
+        qDebug() << "Hash: " << hash;
+
+        emit checkFailed(mod, tr("No valid version found for this mod. It's probably unavailable for the current game version / mod loader."));
+        return;
+    }
+
+    // Currently, we rely on a couple heuristics to determine whether an update is actually available or not:
+    // - The file needs to be preferred: It is either the primary file, or the one found via (explicit) usage of the
+    // loader_filter
+    // - The version reported by the JAR is different from the version reported by the indexed version (it's usually the case)
+    // Such is the pain of having arbitrary files for a given version .-.
+
+    ModPlatform::IndexedVersion project_ver;
+    try {
+        auto obj = project_obj;
+        project_ver = Modrinth::loadIndexedPackVersion(obj, m_hash_type, m_loader_filter);
+    } catch (Json::JsonException& e) {
+        emit checkFailed(mod, e.cause());
+        return;
+    }
+    if (project_ver.downloadUrl.isEmpty()) {
+        qCritical() << "Modrinth mod without download url!";
+        qCritical() << project_ver.fileName;
+
+        emit checkFailed(mod, tr("Mod has an empty download URL"));
+        return;
+    }
+
+    auto key = project_ver.hash;
+    if ((key != hash && project_ver.is_preferred) || (mod->status() == ModStatus::NotInstalled)) {
+        if (mod->version() == project_ver.version_number)
+            return;
+
+        // Fake pack with the necessary info to pass to the download task :)
+        auto pack = std::make_shared<ModPlatform::IndexedPack>();
+        pack->name = mod->name();
+        pack->slug = mod->metadata()->slug;
+        pack->addonId = mod->metadata()->project_id;
+        pack->websiteUrl = mod->homeurl();
+        for (auto& author : mod->authors())
+            pack->authors.append({ author });
+        pack->description = mod->description();
+        pack->provider = ModPlatform::ResourceProvider::MODRINTH;
+
+        auto download_task = makeShared<ResourceDownloadTask>(pack, project_ver, m_mods_folder);
+
+        addUpdatable({ pack->name, hash, mod->version(), project_ver.version_number, project_ver.changelog,
+                       ModPlatform::ResourceProvider::MODRINTH, download_task });
+    }
 }
@@ -19,5 +19,17 @@ class ModrinthCheckUpdate : public CheckUpdateTask {
     void executeTask() override;
 
    private:
-    NetJob::Ptr m_net_job = nullptr;
+    void requestVersions();
+    /** Whether `project_obj`, the latest version for the mod with `hash`, is an update to it. */
+    void checkVersion(const QString& hash, const QJsonObject& project_obj);
+
+   private:
+    Task::Ptr m_job;
+
+    QString m_hash_type;
+    QString m_loader_filter;
+    // hash -> the mod with it, until it got an answer
+    QHash<QString, Mod*> m_mappings;
+
+    bool m_was_aborted = false;
 };
@@ -9,7 +9,6 @@
 
 #include "modplatform/helpers/OverrideUtils.h"
 
-#include "net/ChecksumValidator.h"
 
 #include "net/NetJob.h"
 #include "settings/INISettingsObject.h"
@@ -77,60 +76,66 @@ bool ModrinthCreationTask::updateInstance()
         std::vector<Modrinth::File> old_files;
         parseManifest(old_index_path, old_files, false, false);
 
-        // Let's remove all duplicated, identical resources!
+        QDir old_minecraft_dir(inst->gameRoot());
+
+        // Let's remove all duplicated, identical resources that are still in place, they aren't downloaded again!
+        QMultiHash<QString, QString> old_paths;
+        for (auto const& old_file : old_files)
+            old_paths.insert(old_file.hash, old_file.path);
+
         auto files_iterator = m_files.begin();
-    begin:
         while (files_iterator != m_files.end()) {
             auto const& file = *files_iterator;
+            auto old_file_path = old_minecraft_dir.absoluteFilePath(file.path);
+            bool in_place = QFileInfo(old_file_path).isFile() || QFileInfo(old_file_path + ".disabled").isFile();
 
-            auto old_files_iterator = old_files.begin();
-            while (old_files_iterator != old_files.end()) {
-                auto const& old_file = *old_files_iterator;
-
-                if (old_file.hash == file.hash) {
-                    qDebug() << "Removed file at" << file.path << "from list of downloads";
-                    files_iterator = m_files.erase(files_iterator);
-                    old_files_iterator = old_files.erase(old_files_iterator);
-                    goto begin;  // Sorry :c
-                }
-
-                old_files_iterator++;
+            if (in_place && old_paths.contains(file.hash, file.path)) {
+                qDebug() << "Removed file at" << file.path << "from list of downloads";
+                old_paths.remove(file.hash, file.path);
+                files_iterator = m_files.erase(files_iterator);
+                continue;
             }
 
             files_iterator++;
         }
 
-        QDir old_minecraft_dir(inst->gameRoot());
-
         // Some files were removed from the old version, and some will be downloaded in an updated version,
         // so we're fine removing them!
-        if (!old_files.empty()) {
-            for (auto const& file : old_files) {
-                if (file.path.isEmpty())
-                    continue;
-                qDebug() << "Scheduling" << file.path << "for removal";
-                m_files_to_remove.append(old_minecraft_dir.absoluteFilePath(file.path));
-            }
+        for (auto const& path : old_paths) {
+            if (path.isEmpty())
+                continue;
+            qDebug() << "Scheduling" << path << "for removal";
+            m_files_to_remove.append(old_minecraft_dir.absoluteFilePath(path));
         }
 
-        // We will remove all the previous overrides, to prevent duplicate files!
-        // TODO: Currently 'overrides' will always override the stuff on update. How do we preserve unchanged overrides?
+        // Only the overrides that changed are applied again, the others are left as they are.
         // FIXME: We may want to do something about disabled mods.
-        auto old_overrides = Override::readOverrides("overrides", old_index_folder);
-        for (const auto& entry : old_overrides) {
-            if (entry.isEmpty())
-                continue;
-            qDebug() << "Scheduling" << entry << "for removal";
-            m_files_to_remove.append(old_minecraft_dir.absoluteFilePath(entry));
+        auto override_path = FS::PathCombine(m_stagingPath, "overrides");
+        auto client_override_path = FS::PathCombine(m_stagingPath, "client-overrides");
+        m_files_to_remove.append(Override::diffOverrides("overrides", old_index_folder, override_path, old_minecraft_dir.absolutePath(),
+                                                         m_unchanged_overrides));
+        m_files_to_remove.append(Override::diffOverrides("client-overrides", old_index_folder, client_override_path,
+                                                         old_minecraft_dir.absolutePath(), m_unchanged_client_overrides));
+
+        // The client overrides go over the others, so a file that's in both has to come from both again
+        QDir override_dir(override_path), client_override_dir(client_override_path);
+        for (auto iter = m_unchanged_overrides.begin(); iter != m_unchanged_overrides.end();) {
+            if (QFileInfo::exists(client_override_dir.absoluteFilePath(*iter)) && !m_unchanged_client_overrides.contains(*iter)) {
+                m_files_to_remove.append(old_minecraft_dir.absoluteFilePath(*iter));
+                iter = m_unchanged_overrides.erase(iter);
+            } else {
+                iter++;
+            }
         }
-
-        auto old_client_overrides = Override::readOverrides("client-overrides", old_index_folder);
-        for (const auto& entry : old_overrides) {
-            if (entry.isEmpty())
-                continue;
-            qDebug() << "Scheduling" << entry << "for removal";
-            m_files_to_remove.append(old_minecraft_dir.absoluteFilePath(entry));
+        for (auto iter = m_unchanged_client_overrides.begin(); iter != m_unchanged_client_overrides.end();) {
+            if (QFileInfo::exists(override_dir.absoluteFilePath(*iter)) && !m_unchanged_overrides.contains(*iter)) {
+                m_files_to_remove.append(old_minecraft_dir.absoluteFilePath(*iter));
+                iter = m_unchanged_client_overrides.erase(iter);
+            } else {
+                iter++;
+            }
         }
+        qDebug() << m_unchanged_overrides.size() + m_unchanged_client_overrides.size() << "overrides didn't change";
     } else {
         // We don't have an old index file, so we may duplicate stuff!
         auto dialog = CustomMessageBox::selectable(m_parent,
@@ -176,6 +181,7 @@ bool ModrinthCreationTask::createInstance()
     if (QFile::exists(override_path)) {
         // Create a list of overrides in "overrides.txt" inside mrpack/
         Override::createOverrides("overrides", parent_folder, override_path);
+        Override::dropUnchanged(override_path, m_unchanged_overrides);
 
         // Apply the overrides
         if (!QFile::rename(override_path, mcPath)) {
@@ -189,6 +195,7 @@ bool ModrinthCreationTask::createInstance()
     if (QFile::exists(client_override_path)) {
         // Create a list of overrides in "client-overrides.txt" inside mrpack/
         Override::createOverrides("client-overrides", parent_folder, client_override_path);
+        Override::dropUnchanged(client_override_path, m_unchanged_client_overrides);
 
         // Apply the overrides
         if (!FS::overrideFolder(mcPath, client_override_path)) {
@@ -238,8 +245,8 @@ bool ModrinthCreationTask::createInstance()
         }
 
         qDebug() << "Will try to download" << file.downloads.front() << "to" << file_path;
-        auto dl = Net::Download::makeFile(file.downloads.dequeue(), file_path);
-        dl->addValidator(new Net::ChecksumValidator(file.hashAlgorithm, file.hash));
+        auto dl = Net::Download::makeStored(file.downloads.dequeue(), file_path, file.hashAlgorithm, file.hash,
+                                             Net::Download::Option::KeepHashes);
         m_files_job->addNetAction(dl);
 
         if (!file.downloads.empty()) {
@@ -247,8 +254,8 @@ bool ModrinthCreationTask::createInstance()
             // MultipleOptionsTask's , once those exist :)
             auto param = dl.toWeakRef();
             connect(dl.get(), &NetAction::failed, [this, &file, file_path, param] {
-                auto ndl = Net::Download::makeFile(file.downloads.dequeue(), file_path);
-                ndl->addValidator(new Net::ChecksumValidator(file.hashAlgorithm, file.hash));
+                auto ndl = Net::Download::makeStored(file.downloads.dequeue(), file_path, file.hashAlgorithm, file.hash,
+                                                      Net::Download::Option::KeepHashes);
                 m_files_job->addNetAction(ndl);
                 if (auto shared = param.lock()) shared->succeeded();
             });
@@ -46,6 +46,8 @@ class ModrinthCreationTask final : public InstanceCreationTask {
     QString m_managed_id, m_managed_version_id, m_managed_name;
 
     std::vector<Modrinth::File> m_files;
+    // the overrides an update leaves alone, as they're the same as in the instance
+    QStringList m_unchanged_overrides, m_unchanged_client_overrides;
     NetJob::Ptr m_files_job;
 
     std::optional<InstancePtr> m_instance;
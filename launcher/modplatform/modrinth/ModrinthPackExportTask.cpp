@@ -21,11 +21,17 @@
 #include <QCryptographicHash>
 #include <QFileInfo>
 #include <QMessageBox>
+#include <QtConcurrentMap>
 #include <QtConcurrentRun>
+#include "Application.h"
+#include "Executors.h"
 #include "Json.h"
 #include "MMCZip.h"
+#include "digest/Digest.h"
 #include "minecraft/PackProfile.h"
 #include "minecraft/mod/ModFolderModel.h"
+#include "modplatform/helpers/HashUtils.h"
+#include "net/JsonResponse.h"
 
 const QStringList ModrinthPackExportTask::PREFIXES({ "mods", "coremods", "resourcepacks", "texturepacks", "shaderpacks" });
 const QStringList ModrinthPackExportTask::FILE_EXTENSIONS({ "jar", "litemod", "zip" });
@@ -35,7 +41,7 @@ ModrinthPackExportTask::ModrinthPackExportTask(const QString& name,
                                                const QString& summary,
                                                InstancePtr instance,
                                                const QString& output,
-                                               MMCZip::FilterFunction filter)
+                                               QFileInfoList files)
     : name(name)
     , version(version)
     , summary(summary)
@@ -43,7 +49,7 @@ ModrinthPackExportTask::ModrinthPackExportTask(const QString& name,
     , mcInstance(dynamic_cast<MinecraftInstance*>(instance.get()))
     , gameRoot(instance->gameRoot())
     , output(output)
-    , filter(filter)
+    , files(files)
 {}
 
 void ModrinthPackExportTask::executeTask()
@@ -62,6 +68,12 @@ bool ModrinthPackExportTask::abort()
         return true;
     }
 
+    if (hashFuture.isRunning()) {
+        hashFuture.cancel();
+        // NOTE: aborted once the files that are being hashed are done, in `hashesCollected()`
+        return true;
+    }
+
     if (buildZipFuture.isRunning()) {
         buildZipFuture.cancel();
         // NOTE: Here we don't do `emitAborted()` because it will be done when `buildZipFuture` actually cancels, which may not occur immediately.
@@ -76,12 +88,6 @@ void ModrinthPackExportTask::collectFiles()
     setAbortable(false);
     QCoreApplication::processEvents();
 
-    files.clear();
-    if (!MMCZip::collectFileListRecursively(instance->gameRoot(), nullptr, &files, filter)) {
-        emitFailed(tr("Could not search for files"));
-        return;
-    }
-
     pendingHashes.clear();
     resolvedFiles.clear();
 
@@ -94,9 +100,22 @@ void ModrinthPackExportTask::collectFiles()
 
 void ModrinthPackExportTask::collectHashes()
 {
-    for (const QFileInfo& file : files) {
-        QCoreApplication::processEvents();
+    // the mods, by path, with the downloads their metadata allows in a pack
+    QHash<QString, QString> modUrls;
+    if (mcInstance) {
+        disconnect(mcInstance->loaderModList().get(), &ModFolderModel::updateFinished, this, &ModrinthPackExportTask::collectHashes);
+        for (const Mod* mod : mcInstance->loaderModList()->allMods()) {
+            if (mod->metadata() == nullptr)
+                continue;
+            const QUrl& url = mod->metadata()->url;
+            // ensure the url is permitted on modrinth.com
+            if (!url.isEmpty() && BuildConfig.MODRINTH_MRPACK_HOSTS.contains(url.host()))
+                modUrls.insert(mod->fileinfo().absoluteFilePath(), url.toString());
+        }
+    }
 
+    QList<FileToHash> toHash;
+    for (const QFileInfo& file : files) {
         const QString relative = gameRoot.relativeFilePath(file.absoluteFilePath());
         // require sensible file types
         if (!std::any_of(PREFIXES.begin(), PREFIXES.end(),
@@ -107,50 +126,83 @@ void ModrinthPackExportTask::collectHashes()
             })) {
             continue;
         }
+        toHash.append({ relative, file.absoluteFilePath(), modUrls.value(file.absoluteFilePath()) });
+    }
 
-        QCryptographicHash sha512(QCryptographicHash::Algorithm::Sha512);
+    setStatus(tr("Hashing files..."));
+    setAbortable(true);
+    hashFuture = QtConcurrent::mapped(toHash, &ModrinthPackExportTask::hashFile);
+    connect(&hashWatcher, &QFutureWatcher<HashedFile>::progressValueChanged, this,
+            [this](int value) { setProgress(value, hashWatcher.progressMaximum()); });
+    connect(&hashWatcher, &QFutureWatcher<HashedFile>::finished, this, &ModrinthPackExportTask::hashesCollected);
+    hashWatcher.setFuture(hashFuture);
+}
 
-        QFile openFile(file.absoluteFilePath());
-        if (!openFile.open(QFile::ReadOnly)) {
-            qWarning() << "Could not open" << file << "for hashing";
-            continue;
-        }
+ModrinthPackExportTask::HashedFile ModrinthPackExportTask::hashFile(const FileToHash& file)
+{
+    HashedFile hashed{ file.relative, file.url };
+
+    // downloaded mods had their hashes taken on the way in
+    if (auto cached = Hashing::cachedHashes(file.path); cached && !cached->sha512.isEmpty()) {
+        hashed.sha512 = cached->sha512;
+        hashed.sha1 = cached->sha1;
+        hashed.size = QFileInfo(file.path).size();
+        hashed.ok = true;
+        return hashed;
+    }
+
+    QFile openFile(file.path);
+    if (!openFile.open(QFile::ReadOnly)) {
+        qWarning() << "Could not open" << file.path << "for hashing";
+        return hashed;
+    }
 
-        const QByteArray data = openFile.readAll();
-        if (openFile.error() != QFileDevice::NoError) {
-            qWarning() << "Could not read" << file;
+    // the SHA-1 is only needed for the files that don't go through the API
+    Digest sha512(QCryptographicHash::Algorithm::Sha512);
+    Digest sha1(QCryptographicHash::Algorithm::Sha1);
+    QByteArray buffer(64 * 1024, Qt::Uninitialized);
+    qint64 read;
+    while ((read = openFile.read(buffer.data(), buffer.size())) > 0) {
+        const QByteArray chunk = QByteArray::fromRawData(buffer.constData(), read);
+        sha512.addData(chunk);
+        if (!file.url.isEmpty())
+            sha1.addData(chunk);
+    }
+    if (read < 0 || openFile.error() != QFileDevice::NoError) {
+        qWarning() << "Could not read" << file.path;
+        return hashed;
+    }
+
+    hashed.sha512 = sha512.result().toHex();
+    if (!file.url.isEmpty())
+        hashed.sha1 = sha1.result().toHex();
+    hashed.size = openFile.size();
+    hashed.ok = true;
+    return hashed;
+}
+
+void ModrinthPackExportTask::hashesCollected()
+{
+    disconnect(&hashWatcher, nullptr, this, nullptr);
+    if (hashFuture.isCanceled()) {
+        emitAborted();
+        return;
+    }
+
+    for (const HashedFile& file : hashFuture.results()) {
+        if (!file.ok)
+            continue;
+        if (!file.url.isEmpty()) {
+            // nice! we've managed to resolve based on local metadata!
+            // no need to enqueue it
+            qDebug() << "Resolving" << file.relative << "from index";
+            resolvedFiles[file.relative] = ResolvedFile{ file.sha1, file.sha512, file.url, file.size };
             continue;
         }
-        sha512.addData(data);
-
-        auto allMods = mcInstance->loaderModList()->allMods();
-        if (auto modIter = std::find_if(allMods.begin(), allMods.end(), [&file](Mod* mod) { return mod->fileinfo() == file; });
-            modIter != allMods.end()) {
-            const Mod* mod = *modIter;
-            if (mod->metadata() != nullptr) {
-                QUrl& url = mod->metadata()->url;
-                // ensure the url is permitted on modrinth.com
-                if (!url.isEmpty() && BuildConfig.MODRINTH_MRPACK_HOSTS.contains(url.host())) {
-                    qDebug() << "Resolving" << relative << "from index";
-
-                    QCryptographicHash sha1(QCryptographicHash::Algorithm::Sha1);
-                    sha1.addData(data);
-
-                    ResolvedFile file{ sha1.result().toHex(), sha512.result().toHex(), url.toString(), openFile.size() };
-                    resolvedFiles[relative] = file;
-
-                    // nice! we've managed to resolve based on local metadata!
-                    // no need to enqueue it
-                    continue;
-                }
-            }
-        }
-
-        qDebug() << "Enqueueing" << relative << "for Modrinth query";
-        pendingHashes[relative] = sha512.result().toHex();
+        qDebug() << "Enqueueing" << file.relative << "for Modrinth query";
+        pendingHashes[file.relative] = file.sha512;
     }
 
-    setAbortable(true);
     makeApiRequest();
 }
 
@@ -161,41 +213,44 @@ void ModrinthPackExportTask::makeApiRequest()
     else {
         QByteArray* response = new QByteArray;
         task = api.currentVersions(pendingHashes.values(), "sha512", response);
-        connect(task.get(), &NetJob::succeeded, [this, response]() { parseApiResponse(response); });
+        auto hashes = pendingHashes;
+        auto resolved = Net::processJson<QMap<QString, ResolvedFile>>(task.get(), response, "Modrinth::GetCurrentVersions",
+                                                                       [hashes](const QJsonDocument& doc) { return resolveFiles(doc, hashes); });
+        connect(task.get(), &NetJob::succeeded, [this, resolved]() { filesResolved(*resolved); });
         connect(task.get(), &NetJob::failed, this, &ModrinthPackExportTask::emitFailed);
         task->start();
     }
 }
 
-void ModrinthPackExportTask::parseApiResponse(const QByteArray* response)
+QMap<QString, ModrinthPackExportTask::ResolvedFile> ModrinthPackExportTask::resolveFiles(const QJsonDocument& doc,
+                                                                                        const QMap<QString, QString>& hashes)
 {
-    task = nullptr;
-
-    try {
-        const QJsonDocument doc = Json::requireDocument(*response);
-
-        QMapIterator<QString, QString> iterator(pendingHashes);
-        while (iterator.hasNext()) {
-            iterator.next();
+    QMap<QString, ResolvedFile> resolved;
+    QMapIterator<QString, QString> iterator(hashes);
+    while (iterator.hasNext()) {
+        iterator.next();
 
-            const QJsonObject obj = doc[iterator.value()].toObject();
-            if (obj.isEmpty())
-                continue;
+        const QJsonObject obj = doc[iterator.value()].toObject();
+        if (obj.isEmpty())
+            continue;
 
-            const QJsonArray files = obj["files"].toArray();
-            if (auto fileIter = std::find_if(files.begin(), files.end(),
-                                             [&iterator](const QJsonValue& file) { return file["hashes"]["sha512"] == iterator.value(); });
-                fileIter != files.end()) {
-                // map the file to the url
-                resolvedFiles[iterator.key()] =
-                    ResolvedFile{ fileIter->toObject()["hashes"].toObject()["sha1"].toString(), iterator.value(),
-                                  fileIter->toObject()["url"].toString(), fileIter->toObject()["size"].toInt() };
-            }
+        const QJsonArray files = obj["files"].toArray();
+        if (auto fileIter = std::find_if(files.begin(), files.end(),
+                                         [&iterator](const QJsonValue& file) { return file["hashes"]["sha512"] == iterator.value(); });
+            fileIter != files.end()) {
+            // map the file to the url
+            resolved[iterator.key()] = ResolvedFile{ fileIter->toObject()["hashes"].toObject()["sha1"].toString(), iterator.value(),
+                                                     fileIter->toObject()["url"].toString(), fileIter->toObject()["size"].toInt() };
         }
-    } catch (const Json::JsonException& e) {
-        emitFailed(tr("Failed to parse versions response: %1").arg(e.what()));
-        return;
     }
+    return resolved;
+}
+
+void ModrinthPackExportTask::filesResolved(const QMap<QString, ResolvedFile>& resolved)
+{
+    task = nullptr;
+    for (auto it = resolved.constBegin(); it != resolved.constEnd(); ++it)
+        resolvedFiles[it.key()] = it.value();
     pendingHashes.clear();
     buildZip();
 }
@@ -204,7 +259,8 @@ void ModrinthPackExportTask::buildZip()
 {
     setStatus(tr("Adding files..."));
 
-    buildZipFuture = QtConcurrent::run(QThreadPool::globalInstance(), [this]() {
+    const int level = APPLICATION->settings()->get("ExportCompressionLevel").toInt();
+    buildZipFuture = QtConcurrent::run(Executors::io(), [this, level]() {
         QuaZip zip(output);
         if (!zip.open(QuaZip::mdCreate)) {
             QFile::remove(output);
@@ -220,21 +276,22 @@ void ModrinthPackExportTask::buildZip()
             return BuildZipResult(tr("Could not create index"));
         }
         indexFile.write(generateIndex());
+        indexFile.close();
 
-        size_t progress = 0;
+        QList<QPair<QString, QString>> overrides;
         for (const QFileInfo& file : files) {
-            if (buildZipFuture.isCanceled()) {
-                QFile::remove(output);
-                return BuildZipResult();
-            }
-
-            setProgress(progress, files.length());
             const QString relative = gameRoot.relativeFilePath(file.absoluteFilePath());
-            if (!resolvedFiles.contains(relative) && !JlCompress::compressFile(&zip, file.absoluteFilePath(), "overrides/" + relative)) {
-                QFile::remove(output);
-                return BuildZipResult(tr("Could not read and compress %1").arg(relative));
-            }
-            progress++;
+            if (!resolvedFiles.contains(relative))
+                overrides.append({ "overrides/" + relative, file.absoluteFilePath() });
+        }
+
+        if (!MMCZip::compressFiles(
+                &zip, overrides, level, [this] { return buildZipFuture.isCanceled(); },
+                [this](int done, int total) { setProgress(done, total); })) {
+            QFile::remove(output);
+            if (buildZipFuture.isCanceled())
+                return BuildZipResult();
+            return BuildZipResult(tr("Could not read and compress the overrides"));
         }
 
         zip.close();
@@ -33,7 +33,7 @@ class ModrinthPackExportTask : public Task {
                            const QString& summary,
                            InstancePtr instance,
                            const QString& output,
-                           MMCZip::FilterFunction filter);
+                           QFileInfoList files);
 
    protected:
     void executeTask() override;
@@ -45,6 +45,17 @@ class ModrinthPackExportTask : public Task {
         qint64 size;
     };
 
+    // a file that may be on Modrinth, with the download of its mod if the mod's metadata has one
+    struct FileToHash {
+        QString relative, path, url;
+    };
+    struct HashedFile {
+        QString relative, url, sha1, sha512;
+        qint64 size = 0;
+        bool ok = false;
+    };
+    static HashedFile hashFile(const FileToHash& file);
+
     static const QStringList PREFIXES;
     static const QStringList FILE_EXTENSIONS;
 
@@ -54,22 +65,27 @@ class ModrinthPackExportTask : public Task {
     MinecraftInstance* mcInstance;
     const QDir gameRoot;
     const QString output;
-    const MMCZip::FilterFunction filter;
+    // the files picked to go in the pack
+    const QFileInfoList files;
 
     typedef std::optional<QString> BuildZipResult;
 
     ModrinthAPI api;
-    QFileInfoList files;
     QMap<QString, QString> pendingHashes;
     QMap<QString, ResolvedFile> resolvedFiles;
     Task::Ptr task;
+    QFuture<HashedFile> hashFuture;
+    QFutureWatcher<HashedFile> hashWatcher;
     QFuture<BuildZipResult> buildZipFuture;
     QFutureWatcher<BuildZipResult> buildZipWatcher;
 
     void collectFiles();
     void collectHashes();
+    void hashesCollected();
     void makeApiRequest();
-    void parseApiResponse(const QByteArray* response);
+    // the files in the response that have the hashes, by their path, done off the GUI thread
+    static QMap<QString, ResolvedFile> resolveFiles(const QJsonDocument& doc, const QMap<QString, QString>& hashes);
+    void filesResolved(const QMap<QString, ResolvedFile>& resolved);
     void buildZip();
     void finish();
 
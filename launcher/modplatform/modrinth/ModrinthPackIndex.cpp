@@ -140,6 +140,27 @@ auto Modrinth::loadIndexedPackVersion(QJsonObject& obj, QString preferred_hash_t
     file.version_number = Json::requireString(obj, "version_number");
     file.changelog = Json::requireString(obj, "changelog");
 
+    for (auto dependency : Json::ensureArray(obj, "dependencies")) {
+        auto dependency_obj = Json::ensureObject(dependency);
+        auto type = Json::ensureString(dependency_obj, "dependency_type");
+        ModPlatform::Dependency dep;
+        dep.addonId = Json::ensureString(dependency_obj, "project_id");
+        dep.version = Json::ensureString(dependency_obj, "version_id");
+        if (dep.version.toString().isEmpty())
+            dep.version = {};
+        if (type == "required")
+            dep.type = ModPlatform::DependencyType::REQUIRED;
+        else if (type == "optional")
+            dep.type = ModPlatform::DependencyType::OPTIONAL;
+        else if (type == "incompatible")
+            dep.type = ModPlatform::DependencyType::INCOMPATIBLE;
+        else if (type == "embedded")
+            dep.type = ModPlatform::DependencyType::EMBEDDED;
+        else
+            dep.type = ModPlatform::DependencyType::UNKNOWN;
+        file.dependencies.append(dep);
+    }
+
     auto files = Json::requireArray(obj, "files");
     int i = 0;
 
@@ -135,6 +135,10 @@ auto loadIndexedVersion(QJsonObject &obj) -> ModpackVersion
     
     file.date = Json::requireString(obj, "date_published");
 
+    auto game_versions = Json::ensureArray(obj, "game_versions");
+    if (!game_versions.isEmpty())
+        file.mc_version = game_versions.first().toString();
+
     auto files = Json::requireArray(obj, "files");
 
 
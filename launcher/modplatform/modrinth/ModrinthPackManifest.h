@@ -88,6 +88,9 @@ struct ModpackVersion {
     QString date;
 
     QString download_url;
+
+    // the first Minecraft version listed for it
+    QString mc_version;
 };
 
 struct Modpack {
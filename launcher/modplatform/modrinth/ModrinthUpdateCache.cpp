@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ModrinthUpdateCache.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFileInfo>
+#include <QJsonDocument>
+
+#include "Application.h"
+#include "FileSystem.h"
+#include "ModrinthAPI.h"
+#include "net/HttpMetaCache.h"
+#include "net/MetaCacheSink.h"
+
+namespace {
+
+const QString s_cache_base = "ModrinthUpdates";
+
+// when the API doesn't say anything, as the meta cache's default of a week would hide updates for way too long
+constexpr qint64 s_default_lifetime = 10 * 60;
+
+}  // namespace
+
+bool ModrinthUpdateCache::LifetimeValidator::validate(QNetworkReply& reply)
+{
+    auto [max_age, current_age] = Net::MetaCacheSink::cacheLifetime(reply);
+    if (!reply.hasRawHeader("Cache-Control") && !reply.hasRawHeader("Expires"))
+        max_age = s_default_lifetime;
+    *m_lifetime = { max_age, current_age };
+    return true;
+}
+
+ModrinthUpdateCache::ModrinthUpdateCache(const QString& hash_format,
+                                         const std::optional<std::list<Version>>& game_versions,
+                                         const std::optional<ResourceAPI::ModLoaderTypes>& loaders)
+{
+    QStringList context{ hash_format };
+    context.append(loaders.has_value() ? ModrinthAPI::getModLoaderStrings(loaders.value()).join(',') : "*");
+    if (game_versions.has_value()) {
+        QStringList versions;
+        for (auto& version : game_versions.value())
+            versions.append(version.toString());
+        context.append(versions.join(','));
+    } else {
+        context.append("*");
+    }
+
+    m_context = QCryptographicHash::hash(context.join('|').toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+}
+
+std::optional<QJsonObject> ModrinthUpdateCache::find(const QString& hash) const
+{
+    auto entry = APPLICATION->metacache()->resolveEntry(s_cache_base, path(hash));
+    if (entry->isStale())
+        return {};
+
+    try {
+        auto doc = QJsonDocument::fromJson(FS::read(entry->getFullPath()));
+        if (!doc.isObject())
+            return {};
+        return doc.object();
+    } catch (const FS::FileSystemException& e) {
+        qWarning() << "Failed to read a cached Modrinth update:" << e.cause();
+        return {};
+    }
+}
+
+void ModrinthUpdateCache::insert(const QString& hash, const QJsonObject& version, const Lifetime& lifetime)
+{
+    if (lifetime.max_age <= lifetime.current_age)
+        return;
+
+    auto entry = APPLICATION->metacache()->resolveEntry(s_cache_base, path(hash));
+    auto data = QJsonDocument(version).toJson(QJsonDocument::Compact);
+    try {
+        FS::write(entry->getFullPath(), data);
+    } catch (const FS::FileSystemException& e) {
+        qWarning() << "Failed to cache a Modrinth update:" << e.cause();
+        return;
+    }
+
+    entry->setMD5Sum(QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex().constData());
+    entry->setLocalChangedTimestamp(QFileInfo(entry->getFullPath()).lastModified().toUTC().toMSecsSinceEpoch());
+    entry->setMaximumAge(lifetime.max_age);
+    entry->setCurrentAge(lifetime.current_age);
+    entry->setStale(false);
+    APPLICATION->metacache()->updateEntry(entry);
+}
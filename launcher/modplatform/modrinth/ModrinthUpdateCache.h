@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+
+#include <list>
+#include <memory>
+#include <optional>
+
+#include "Version.h"
+#include "modplatform/ResourceAPI.h"
+#include "net/Validator.h"
+
+/* Remembers what Modrinth answered when asked for the latest version of a mod file, for a given set of mod loaders and
+ * game versions, for as long as the API allows it to be cached.
+ *
+ * The answers live in the "ModrinthUpdates" base of the HTTP meta cache, so checking for updates in several instances
+ * sharing the same mods only has to ask about each of them once.
+ */
+class ModrinthUpdateCache {
+   public:
+    struct Lifetime {
+        qint64 max_age = 0;
+        qint64 current_age = 0;
+    };
+
+    /* Reads the lifetime of the reply it's attached to from its headers. */
+    class LifetimeValidator : public Net::Validator {
+       public:
+        explicit LifetimeValidator(std::shared_ptr<Lifetime> lifetime) : m_lifetime(std::move(lifetime)) {}
+
+        bool init(QNetworkRequest&) override { return true; }
+        bool write(QByteArray&) override { return true; }
+        bool abort() override { return true; }
+        bool validate(QNetworkReply& reply) override;
+
+       private:
+        std::shared_ptr<Lifetime> m_lifetime;
+    };
+
+    ModrinthUpdateCache(const QString& hash_format,
+                        const std::optional<std::list<Version>>& game_versions,
+                        const std::optional<ResourceAPI::ModLoaderTypes>& loaders);
+
+    /** The version object Modrinth answered for that hash, empty if there was none, or nothing if it isn't known (anymore). */
+    std::optional<QJsonObject> find(const QString& hash) const;
+    void insert(const QString& hash, const QJsonObject& version, const Lifetime& lifetime);
+
+   private:
+    QString path(const QString& hash) const { return m_context + '/' + hash + ".json"; }
+
+    // identifies the loaders and game versions the answers are for
+    QString m_context;
+};
@@ -27,6 +27,7 @@
 
 #include "minecraft/mod/Mod.h"
 #include "modplatform/ModIndex.h"
+#include "modplatform/packwiz/PackwizIndexCache.h"
 
 #include <toml++/toml.h>
 
@@ -39,12 +40,9 @@ auto getRealIndexName(QDir& index_dir, QString normalized_fname, bool should_fin
     QString real_fname = normalized_fname;
     if (!index_file.exists()) {
         // Tries to get similar entries
-        for (auto& file_name : index_dir.entryList(QDir::Filter::Files)) {
-            if (!QString::compare(normalized_fname, file_name, Qt::CaseInsensitive)) {
-                real_fname = file_name;
-                break;
-            }
-        }
+        auto similar = IndexCache::instance().findName(index_dir, normalized_fname);
+        if (!similar.isEmpty())
+            real_fname = similar;
 
         if (should_find_match && !QString::compare(normalized_fname, real_fname, Qt::CaseSensitive)) {
             qCritical() << "Could not find a match for a valid metadata file!";
@@ -189,6 +187,8 @@ void V1::updateModIndex(QDir& index_dir, Mod& mod)
 
     index_file.flush();
     index_file.close();
+    IndexCache::instance().changed(index_dir, real_fname);
+    IndexCache::instance().changed(index_dir, normalized_fname);
 }
 
 void V1::deleteModIndex(QDir& index_dir, QString& mod_slug)
@@ -208,40 +208,50 @@ void V1::deleteModIndex(QDir& index_dir, QString& mod_slug)
     if (!index_file.remove()) {
         qWarning() << QString("Failed to remove metadata for mod %1!").arg(mod_slug);
     }
+    IndexCache::instance().changed(index_dir, real_fname);
 }
 
 void V1::deleteModIndex(QDir& index_dir, QVariant& mod_id)
 {
-    for (auto& file_name : index_dir.entryList(QDir::Filter::Files)) {
-        auto mod = getIndexForMod(index_dir, file_name);
+    auto file_name = IndexCache::instance().findById(index_dir, mod_id, [&index_dir](const QString& name) { return getIndexForMod(index_dir, name); });
+    if (file_name.isEmpty())
+        return;
 
-        if (mod.mod_id() == mod_id) {
-            deleteModIndex(index_dir, mod.name);
-            break;
-        }
-    }
+    auto mod = getIndexForMod(index_dir, file_name);
+    deleteModIndex(index_dir, mod.name);
 }
 
 auto V1::getIndexForMod(QDir& index_dir, QString slug) -> Mod
 {
-    Mod mod;
-
     auto normalized_fname = indexFileName(slug);
     auto real_fname = getRealIndexName(index_dir, normalized_fname, true);
     if (real_fname.isEmpty())
         return {};
 
+    auto path = index_dir.absoluteFilePath(real_fname);
+    auto mod = IndexCache::instance().get(QFileInfo(path), [&path, &normalized_fname, &slug] { return parseIndexFile(path, normalized_fname, slug); });
+    if (mod.project_id.isNull())
+        return {};
+    // the same file can be asked for by its slug or its file name
+    mod.slug = slug;
+    return mod;
+}
+
+auto V1::parseIndexFile(const QString& path, const QString& normalized_fname, const QString& slug) -> Mod
+{
+    Mod mod;
+
     toml::table table;
 #if TOML_EXCEPTIONS
     try {
-        table = toml::parse_file(StringUtils::toStdString(index_dir.absoluteFilePath(real_fname)));
+        table = toml::parse_file(StringUtils::toStdString(path));
     } catch (const toml::parse_error& err) {
         qWarning() << QString("Could not open file %1!").arg(normalized_fname);
         qWarning() << "Reason: " << QString(err.what());
         return {};
     }
 #else
-    table = toml::parse_file(StringUtils::toStdString(index_dir.absoluteFilePath(real_fname)));
+    table = toml::parse_file(StringUtils::toStdString(path));
     if (!table) {
         qWarning() << QString("Could not open file %1!").arg(normalized_fname);
         qWarning() << "Reason: " << QString(table.error().what());
@@ -301,14 +311,10 @@ auto V1::getIndexForMod(QDir& index_dir, QString slug) -> Mod
 
 auto V1::getIndexForMod(QDir& index_dir, QVariant& mod_id) -> Mod
 {
-    for (auto& file_name : index_dir.entryList(QDir::Filter::Files)) {
-        auto mod = getIndexForMod(index_dir, file_name);
-
-        if (mod.mod_id() == mod_id)
-            return mod;
-    }
-
-    return {};
+    auto file_name = IndexCache::instance().findById(index_dir, mod_id, [&index_dir](const QString& name) { return getIndexForMod(index_dir, name); });
+    if (file_name.isEmpty())
+        return {};
+    return getIndexForMod(index_dir, file_name);
 }
 
 }  // namespace Packwiz
@@ -93,6 +93,10 @@ class V1 {
      * If the mod doesn't have a metadata, it simply returns an empty Mod object.
      * */
     static auto getIndexForMod(QDir& index_dir, QVariant& mod_id) -> Mod;
+
+   private:
+    /* Reads the metadata file at the given path, without looking whether it was read before. */
+    static auto parseIndexFile(const QString& path, const QString& normalized_fname, const QString& slug) -> Mod;
 };
 
 } // namespace Packwiz
@@ -0,0 +1,231 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "PackwizIndexCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QSaveFile>
+
+#include "FileSystem.h"
+
+namespace Packwiz {
+
+namespace {
+
+constexpr quint32 s_magic = 0x50574943;  // "PWIC"
+// Bump this whenever getIndexForMod changes what it reads, so the old results get thrown away
+constexpr quint32 s_version = 1;
+constexpr auto s_stream_version = QDataStream::Qt_5_12;
+
+void writeEntry(QDataStream& out, const QString& path, qint64 size, qint64 mtime, const IndexCache::Result& result)
+{
+    auto& mod = result.mod;
+    out << path << size << mtime << result.valid << mod.name << mod.filename << mod.side << mod.mode << mod.url << mod.hash_format
+        << mod.hash << static_cast<qint32>(mod.provider) << mod.file_id << mod.project_id;
+}
+
+bool readEntry(QDataStream& in, QString& path, qint64& size, qint64& mtime, IndexCache::Result& result)
+{
+    auto& mod = result.mod;
+    qint32 provider;
+    in >> path >> size >> mtime >> result.valid >> mod.name >> mod.filename >> mod.side >> mod.mode >> mod.url >> mod.hash_format >>
+        mod.hash >> provider >> mod.file_id >> mod.project_id;
+    mod.provider = static_cast<ModPlatform::ResourceProvider>(provider);
+    return in.status() == QDataStream::Ok;
+}
+
+qint64 modified(const QString& path)
+{
+    return QFileInfo(path).lastModified().toMSecsSinceEpoch();
+}
+
+}  // namespace
+
+IndexCache::IndexCache(QString file) : m_file(std::move(file)) {}
+
+IndexCache& IndexCache::instance()
+{
+    static IndexCache s_instance(QDir("cache").absoluteFilePath("packwizindex"));
+    return s_instance;
+}
+
+V1::Mod IndexCache::get(const QFileInfo& file, const std::function<V1::Mod()>& parse)
+{
+    auto path = file.absoluteFilePath();
+    {
+        QMutexLocker lock(&m_lock);
+        load();
+
+        auto it = m_entries.constFind(path);
+        if (it != m_entries.constEnd() && it->size == file.size() && it->mtime == file.lastModified().toMSecsSinceEpoch())
+            return it->result.valid ? it->result.mod : V1::Mod{};
+    }
+
+    // parsed without holding the lock, the mod folder loads run side by side
+    auto mod = parse();
+    Entry entry{ file.size(), file.lastModified().toMSecsSinceEpoch(), { mod.isValid(), mod } };
+
+    QMutexLocker lock(&m_lock);
+    m_entries.insert(path, entry);
+    append(path, entry);
+    return mod;
+}
+
+QString IndexCache::findName(const QDir& index_dir, const QString& name)
+{
+    QMutexLocker lock(&m_lock);
+    return listing(index_dir).names.value(name.toLower());
+}
+
+QString IndexCache::findById(const QDir& index_dir, const QVariant& mod_id, const std::function<V1::Mod(const QString&)>& parse)
+{
+    auto key = mod_id.toString();
+    for (int attempt = 0; attempt < 2; attempt++) {
+        QStringList names;
+        qint64 listed_mtime = 0;
+        bool known = false;
+        QString found;
+        {
+            QMutexLocker lock(&m_lock);
+            auto& list = listing(index_dir);
+            known = list.has_ids;
+            if (known) {
+                found = list.ids.value(key);
+            } else {
+                names = list.names.values();
+                listed_mtime = list.mtime;
+            }
+        }
+
+        if (known) {
+            // a file can be changed without its folder changing, so what it says is checked once more
+            if (found.isEmpty() || parse(found).project_id.toString() == key)
+                return found;
+            QMutexLocker lock(&m_lock);
+            listing(index_dir).has_ids = false;
+            continue;
+        }
+
+        QHash<QString, QString> ids;
+        for (auto& name : names) {
+            auto mod = parse(name);
+            if (mod.isValid())
+                ids.insert(mod.project_id.toString(), name);
+        }
+
+        QMutexLocker lock(&m_lock);
+        auto& list = listing(index_dir);
+        if (list.mtime == listed_mtime) {
+            list.ids = ids;
+            list.has_ids = true;
+        }
+        return ids.value(key);
+    }
+    return {};
+}
+
+void IndexCache::changed(const QDir& index_dir, const QString& name)
+{
+    QMutexLocker lock(&m_lock);
+    m_listings.remove(index_dir.absolutePath());
+    m_entries.remove(index_dir.absoluteFilePath(name));
+}
+
+auto IndexCache::listing(const QDir& index_dir) -> Listing&
+{
+    auto path = index_dir.absolutePath();
+    auto mtime = modified(path);
+    auto& list = m_listings[path];
+    if (list.mtime == mtime && mtime != 0)
+        return list;
+
+    list = Listing();
+    list.mtime = mtime;
+    for (auto& name : QDir(path).entryList(QDir::Files))
+        list.names.insert(name.toLower(), name);
+    return list;
+}
+
+void IndexCache::load()
+{
+    if (m_loaded)
+        return;
+    m_loaded = true;
+
+    QFile file(m_file);
+    if (!file.open(QFile::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setVersion(s_stream_version);
+
+    quint32 magic, version;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != s_magic || version != s_version) {
+        file.close();
+        compact();
+        return;
+    }
+
+    while (!in.atEnd()) {
+        QString path;
+        Entry entry;
+        if (!readEntry(in, path, entry.size, entry.mtime, entry.result))
+            break;
+
+        m_entries.insert(path, entry);
+        m_records++;
+    }
+
+    // metadata of mods that got updated piles up over time
+    if (in.status() != QDataStream::Ok || m_records > 2 * m_entries.size() + 256) {
+        file.close();
+        compact();
+    }
+}
+
+void IndexCache::append(const QString& path, const Entry& entry)
+{
+    QFile out_file(m_file);
+    bool is_new = !out_file.exists();
+    if (!FS::ensureFilePathExists(m_file) || !out_file.open(QFile::WriteOnly | QFile::Append)) {
+        qWarning() << "[Packwiz::IndexCache] Could not open the cache for writing:" << out_file.errorString();
+        return;
+    }
+
+    QDataStream out(&out_file);
+    out.setVersion(s_stream_version);
+    if (is_new)
+        out << s_magic << s_version;
+    writeEntry(out, path, entry.size, entry.mtime, entry.result);
+    m_records++;
+}
+
+void IndexCache::compact()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (QFileInfo::exists(it.key()))
+            it++;
+        else
+            it = m_entries.erase(it);
+    }
+
+    QSaveFile file(m_file);
+    if (!FS::ensureFilePathExists(m_file) || !file.open(QFile::WriteOnly)) {
+        qWarning() << "[Packwiz::IndexCache] Could not open the cache for writing:" << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(s_stream_version);
+    out << s_magic << s_version;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); it++)
+        writeEntry(out, it.key(), it->size, it->mtime, it->result);
+
+    if (!file.commit())
+        qWarning() << "[Packwiz::IndexCache] Could not write the cache:" << file.errorString();
+    m_records = m_entries.size();
+}
+
+}  // namespace Packwiz
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <functional>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVariant>
+
+#include "modplatform/packwiz/Packwiz.h"
+
+namespace Packwiz {
+
+/* What is in the .index folders of the mod folders, so looking up metadata doesn't parse the TOML files or list the
+ * folder again and again.
+ *
+ * The parsed files are kept by their path, size and modification time, and stored like the mod details cache, so they
+ * stay known across launches. Listings of the folders, with the names in any case and the mod IDs in them, are only
+ * kept in memory, and are made again once the modification time of the folder changes.
+ */
+class IndexCache {
+   public:
+    struct Result {
+        bool valid;
+        V1::Mod mod;
+    };
+
+    explicit IndexCache(QString file);
+
+    /** The cache shared by every mod folder of the launcher. */
+    static IndexCache& instance();
+
+    /** The metadata in `file`, from `parse` when the file changed since it was last read. */
+    V1::Mod get(const QFileInfo& file, const std::function<V1::Mod()>& parse);
+
+    /** The name of the metadata file in `index_dir` that is called like `name` when ignoring case, empty if there is none. */
+    QString findName(const QDir& index_dir, const QString& name);
+
+    /** The name of the metadata file in `index_dir` for the mod with `mod_id`, empty if there is none.
+     *
+     * `parse` reads the metadata file of the given name, for the ones that aren't known yet.
+     */
+    QString findById(const QDir& index_dir, const QVariant& mod_id, const std::function<V1::Mod(const QString&)>& parse);
+
+    /** Forgets what is known about `name` in `index_dir`, after it was written or removed. */
+    void changed(const QDir& index_dir, const QString& name);
+
+   private:
+    struct Entry {
+        qint64 size;
+        qint64 mtime;
+        Result result;
+    };
+    struct Listing {
+        qint64 mtime = 0;
+        // file names by their lower case form
+        QHash<QString, QString> names;
+        // file names by mod ID, only there once they were all looked at
+        QHash<QString, QString> ids;
+        bool has_ids = false;
+    };
+
+    /** The listing of `index_dir`, made again if it changed. Needs m_lock. */
+    Listing& listing(const QDir& index_dir);
+
+    void load();
+    void compact();
+    void append(const QString& path, const Entry& entry);
+
+    QMutex m_lock;
+    QString m_file;
+    bool m_loaded = false;
+    int m_records = 0;
+    QHash<QString, Entry> m_entries;
+    QHash<QString, Listing> m_listings;
+};
+
+}  // namespace Packwiz
@@ -0,0 +1,491 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "PackwizSync.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QtConcurrent>
+
+#include <optional>
+#include <string_view>
+
+#include <toml++/toml.h>
+
+#include <MurmurHash2.h>
+
+#include "ContentStore.h"
+#include "Exception.h"
+#include "Executors.h"
+#include "FileSystem.h"
+#include "Json.h"
+#include "digest/Digest.h"
+#include "minecraft/MinecraftInstance.h"
+#include "modplatform/helpers/HashUtils.h"
+#include "net/Download.h"
+
+#include "Application.h"
+
+namespace Packwiz {
+
+namespace {
+
+// in the instance folder, next to instance.cfg
+const QString s_state_file = "packwiz-sync.json";
+constexpr int s_state_version = 1;
+
+std::optional<toml::table> parseToml(const QByteArray& data, QString* error)
+{
+    std::string_view text(data.constData(), size_t(data.size()));
+#if TOML_EXCEPTIONS
+    try {
+        return toml::parse(text);
+    } catch (const toml::parse_error& err) {
+        *error = QString(err.what());
+        return {};
+    }
+#else
+    auto result = toml::parse(text);
+    if (!result) {
+        *error = QString(result.error().what());
+        return {};
+    }
+    return std::move(result).table();
+#endif
+}
+
+template <typename Node>
+QString stringOf(Node node)
+{
+    auto value = node.value_or(std::string_view());
+    return QString::fromUtf8(value.data(), qsizetype(value.size()));
+}
+
+bool knownHashFormat(const QString& format)
+{
+    return format == "murmur2" || ContentStore::algorithmFromName(format).has_value();
+}
+
+bool hashMatches(const QByteArray& data, const QString& format, const QString& hash)
+{
+    QString actual;
+    if (format == "murmur2") {
+        actual = QString::number(CurseForgeFingerprint(data.constData(), size_t(data.size())));
+    } else if (auto algorithm = ContentStore::algorithmFromName(format)) {
+        actual = Digest::hash(data, *algorithm).toHex();
+    }
+    return !actual.isEmpty() && actual.compare(hash, Qt::CaseInsensitive) == 0;
+}
+
+QJsonObject toJson(const QString& entry, const SyncTask::File& file)
+{
+    QJsonObject object;
+    object["entry"] = entry;
+    object["entry_hash"] = file.entry_hash;
+    object["path"] = file.path;
+    object["url"] = file.url.toString();
+    object["hash_format"] = file.hash_format;
+    object["hash"] = file.hash;
+    object["preserve"] = file.preserve;
+    return object;
+}
+
+SyncTask::File fileFromJson(const QJsonObject& object)
+{
+    SyncTask::File file;
+    file.entry_hash = object["entry_hash"].toString();
+    file.path = object["path"].toString();
+    file.url = QUrl(object["url"].toString());
+    file.hash_format = object["hash_format"].toString();
+    file.hash = object["hash"].toString();
+    file.preserve = object["preserve"].toBool();
+    return file;
+}
+
+}  // namespace
+
+SyncTask::SyncTask(MinecraftInstance* instance, QUrl pack_url, QObject* parent)
+    : Task(parent), m_instance(instance), m_pack_url(std::move(pack_url))
+{
+    connect(&m_watcher, &QFutureWatcher<Outcome>::finished, this, [this] {
+        if (m_aborted) {
+            emitAborted();
+            return;
+        }
+        download(m_watcher.result());
+    });
+}
+
+bool SyncTask::wasSynced(const MinecraftInstance* instance)
+{
+    return QFileInfo::exists(FS::PathCombine(instance->instanceRoot(), s_state_file));
+}
+
+auto SyncTask::parsePack(const QByteArray& data, const QUrl& pack_url, QString* error) -> Pack
+{
+    auto table = parseToml(data, error);
+    if (!table)
+        return {};
+    auto index = (*table)["index"];
+    if (!index.is_table()) {
+        *error = tr("The pack has no [index].");
+        return {};
+    }
+
+    Pack pack;
+    pack.index_url = pack_url.resolved(QUrl(stringOf(index["file"])));
+    pack.hash_format = stringOf(index["hash-format"]);
+    pack.hash = stringOf(index["hash"]);
+    if (!pack.isValid() || !knownHashFormat(pack.hash_format)) {
+        *error = tr("The [index] of the pack is incomplete, or has a hash format that isn't supported.");
+        return {};
+    }
+    return pack;
+}
+
+auto SyncTask::parseIndex(const QByteArray& data, QString* hash_format, QString* error) -> QList<Entry>
+{
+    auto table = parseToml(data, error);
+    if (!table)
+        return {};
+    *hash_format = stringOf((*table)["hash-format"]);
+    if (!knownHashFormat(*hash_format)) {
+        *error = tr("The index has a hash format that isn't supported: %1").arg(*hash_format);
+        return {};
+    }
+
+    QList<Entry> entries;
+    if (auto files = (*table)["files"].as_array()) {
+        for (auto& item : *files) {
+            auto file = item.as_table();
+            if (!file)
+                continue;
+            Entry entry;
+            entry.path = stringOf((*file)["file"]);
+            entry.hash = stringOf((*file)["hash"]);
+            entry.metafile = (*file)["metafile"].value_or(false);
+            entry.preserve = (*file)["preserve"].value_or(false);
+            if (entry.path.isEmpty() || entry.hash.isEmpty()) {
+                *error = tr("The index has a file without a path or a hash.");
+                return {};
+            }
+            entries.append(entry);
+        }
+    }
+    return entries;
+}
+
+auto SyncTask::parseMetafile(const QByteArray& data, const QString& path, QString* error) -> File
+{
+    auto table = parseToml(data, error);
+    if (!table)
+        return {};
+
+    File file;
+    // packwiz says "both", "client" or "server"
+    if (stringOf((*table)["side"]) == "server")
+        return file;
+
+    auto download = (*table)["download"];
+    auto filename = stringOf((*table)["filename"]);
+    file.url = QUrl(stringOf(download["url"]));
+    file.hash_format = stringOf(download["hash-format"]);
+    file.hash = stringOf(download["hash"]);
+    if (filename.isEmpty() || file.hash.isEmpty() || !knownHashFormat(file.hash_format)) {
+        *error = tr("%1 is incomplete, or has a hash format that isn't supported.").arg(path);
+        return {};
+    }
+    // the CurseForge files that can't be downloaded from elsewhere only have their IDs
+    if (!file.url.isValid()) {
+        *error = tr("%1 has no download URL.").arg(path);
+        return {};
+    }
+
+    auto folder = QFileInfo(path).path();
+    file.path = folder == "." ? filename : folder + '/' + filename;
+    return file;
+}
+
+QString SyncTask::targetPath(const QString& root, const QString& path)
+{
+    if (path.isEmpty() || QDir::isAbsolutePath(path))
+        return {};
+    auto base = QDir::cleanPath(QDir(root).absolutePath());
+    auto target = QDir::cleanPath(base + '/' + path);
+    if (!target.startsWith(base + '/'))
+        return {};
+    return target;
+}
+
+void SyncTask::executeTask()
+{
+    loadState();
+    setStatus(tr("Looking for changes in the pack..."));
+    auto job = makeShared<NetJob>(tr("Packwiz pack"), APPLICATION->network());
+    job->addNetAction(Net::Download::makeByteArray(m_pack_url, m_pack_data.get()));
+    runJob(job, [this] { packDownloaded(); });
+}
+
+bool SyncTask::abort()
+{
+    m_aborted = true;
+    if (m_job)
+        return m_job->abort();
+    if (!m_watcher.isRunning())
+        emitAborted();
+    return true;
+}
+
+void SyncTask::packDownloaded()
+{
+    QString error;
+    auto pack = parsePack(*m_pack_data, m_pack_url, &error);
+    if (!pack.isValid()) {
+        emitFailed(tr("Couldn't read the pack at %1: %2").arg(m_pack_url.toString(), error));
+        return;
+    }
+
+    m_index_hash = pack.hash;
+    if (m_index_hash.compare(m_synced_index_hash, Qt::CaseInsensitive) == 0) {
+        // the index is still the one synced last, only the game folder may have changed since
+        m_files = m_synced;
+        compare();
+        return;
+    }
+
+    setStatus(tr("Downloading the index of the pack..."));
+    auto job = makeShared<NetJob>(tr("Packwiz index"), APPLICATION->network());
+    job->addNetAction(Net::Download::makeByteArray(pack.index_url, m_index_data.get()));
+    runJob(job, [this, pack] { indexDownloaded(pack); });
+}
+
+void SyncTask::indexDownloaded(const Pack& pack)
+{
+    if (!hashMatches(*m_index_data, pack.hash_format, pack.hash)) {
+        emitFailed(tr("The index of the pack doesn't have the hash the pack says."));
+        return;
+    }
+    QString hash_format;
+    QString error;
+    auto entries = parseIndex(*m_index_data, &hash_format, &error);
+    if (!error.isEmpty()) {
+        emitFailed(tr("Couldn't read the index of the pack: %1").arg(error));
+        return;
+    }
+
+    auto root = m_instance->gameRoot();
+    QList<Entry> metafiles;
+    auto job = makeShared<NetJob>(tr("Packwiz metafiles"), APPLICATION->network());
+    m_files.clear();
+    for (auto& entry : entries) {
+        if (targetPath(root, entry.path).isEmpty()) {
+            emitFailed(tr("%1 of the pack would be outside of the game folder.").arg(entry.path));
+            return;
+        }
+
+        // a metafile with the same hash describes the same file
+        auto known = m_synced.constFind(entry.path);
+        if (known != m_synced.constEnd() && known->entry_hash.compare(entry.hash, Qt::CaseInsensitive) == 0) {
+            auto file = *known;
+            file.preserve = entry.preserve;
+            m_files.insert(entry.path, file);
+            continue;
+        }
+
+        auto url = pack.index_url.resolved(QUrl(entry.path));
+        if (entry.metafile) {
+            auto data = std::make_shared<QByteArray>();
+            m_metafiles.insert(entry.path, data);
+            job->addNetAction(Net::Download::makeByteArray(url, data.get()));
+            metafiles.append(entry);
+            continue;
+        }
+
+        File file;
+        file.path = entry.path;
+        file.url = url;
+        file.hash_format = hash_format;
+        file.hash = entry.hash;
+        file.preserve = entry.preserve;
+        file.entry_hash = entry.hash;
+        m_files.insert(entry.path, file);
+    }
+
+    if (metafiles.isEmpty()) {
+        compare();
+        return;
+    }
+    setStatus(tr("Downloading the metadata of %n file(s) of the pack...", "", metafiles.size()));
+    runJob(job, [this, metafiles, hash_format] { metafilesDownloaded(metafiles, hash_format); });
+}
+
+void SyncTask::metafilesDownloaded(const QList<Entry>& entries, const QString& hash_format)
+{
+    auto root = m_instance->gameRoot();
+    for (auto& entry : entries) {
+        auto data = m_metafiles.take(entry.path);
+        if (!hashMatches(*data, hash_format, entry.hash)) {
+            emitFailed(tr("%1 of the pack doesn't have the hash the index says.").arg(entry.path));
+            return;
+        }
+        QString error;
+        auto file = parseMetafile(*data, entry.path, &error);
+        if (!error.isEmpty()) {
+            emitFailed(tr("Couldn't read the metadata of the pack: %1").arg(error));
+            return;
+        }
+        if (!file.path.isEmpty() && targetPath(root, file.path).isEmpty()) {
+            emitFailed(tr("%1 of the pack would be outside of the game folder.").arg(file.path));
+            return;
+        }
+        file.preserve = entry.preserve;
+        file.entry_hash = entry.hash;
+        m_files.insert(entry.path, file);
+    }
+    compare();
+}
+
+void SyncTask::compare()
+{
+    m_job.reset();
+    QList<File> files;
+    QSet<QString> paths;
+    for (auto& file : m_files) {
+        if (file.path.isEmpty())
+            continue;
+        files.append(file);
+        paths.insert(file.path);
+    }
+    // only what was synced from the pack is removed, whatever else is in the game folder stays
+    QList<File> dropped;
+    for (auto& file : m_synced) {
+        if (!file.path.isEmpty() && !paths.contains(file.path))
+            dropped.append(file);
+    }
+
+    setStatus(tr("Comparing the files of the instance with the pack..."));
+    m_watcher.setFuture(QtConcurrent::run(Executors::cpu(), &SyncTask::compareFiles, m_instance->gameRoot(), files, dropped));
+}
+
+auto SyncTask::compareFiles(QString root, QList<File> files, QList<File> dropped) -> Outcome
+{
+    Outcome outcome;
+    for (auto& file : files) {
+        auto target = targetPath(root, file.path);
+        if (QFileInfo(target).isFile()) {
+            if (file.preserve)
+                continue;
+            auto hash = Hashing::hashFile(target).get(file.hash_format);
+            // hashed before the cache knew of that kind of hash
+            if (hash.isEmpty())
+                hash = Hashing::hashFile(target, false).get(file.hash_format);
+            if (hash.compare(file.hash, Qt::CaseInsensitive) == 0)
+                continue;
+        }
+        outcome.outdated.append(file);
+    }
+
+    for (auto& file : dropped) {
+        auto target = targetPath(root, file.path);
+        if (!QFileInfo::exists(target))
+            continue;
+        if (!QFile::remove(target)) {
+            outcome.error = tr("Couldn't remove %1, which isn't in the pack anymore.").arg(file.path);
+            return outcome;
+        }
+        outcome.removed++;
+    }
+    return outcome;
+}
+
+void SyncTask::download(const Outcome& outcome)
+{
+    if (!outcome.error.isEmpty()) {
+        emitFailed(outcome.error);
+        return;
+    }
+    if (outcome.removed)
+        qDebug() << "Removed" << outcome.removed << "files that are not in the pack anymore from" << m_instance->name();
+    if (outcome.outdated.isEmpty()) {
+        finish();
+        return;
+    }
+
+    qDebug() << "Downloading" << outcome.outdated.size() << "files of the pack for" << m_instance->name();
+    setStatus(tr("Downloading %n file(s) of the pack...", "", outcome.outdated.size()));
+    auto root = m_instance->gameRoot();
+    auto job = makeShared<NetJob>(tr("Packwiz files"), APPLICATION->network());
+    for (auto& file : outcome.outdated) {
+        auto target = targetPath(root, file.path);
+        job->addNetAction(Net::Download::makeStored(file.url, target, file.hash_format, file.hash, Net::Download::Option::KeepHashes));
+    }
+    runJob(job, [this] { finish(); });
+}
+
+void SyncTask::finish()
+{
+    m_job.reset();
+    m_synced_index_hash = m_index_hash;
+    m_synced = m_files;
+    saveState();
+    emitSucceeded();
+}
+
+void SyncTask::loadState()
+{
+    auto path = FS::PathCombine(m_instance->instanceRoot(), s_state_file);
+    if (!QFileInfo::exists(path))
+        return;
+    try {
+        auto root = Json::requireObject(Json::requireDocument(path, "packwiz sync state"));
+        if (root["version"].toInt() != s_state_version)
+            return;
+        for (auto value : root["files"].toArray()) {
+            auto object = value.toObject();
+            m_synced.insert(object["entry"].toString(), fileFromJson(object));
+        }
+        // the files of another pack are still removed when they aren't in this one, the index is another one though
+        if (QUrl(root["pack"].toString()) == m_pack_url)
+            m_synced_index_hash = root["index_hash"].toString();
+    } catch (const Exception& e) {
+        qWarning() << "Couldn't read what was synced with the pack last:" << e.cause();
+        m_synced.clear();
+        m_synced_index_hash.clear();
+    }
+}
+
+void SyncTask::saveState()
+{
+    QJsonArray files;
+    for (auto it = m_synced.cbegin(); it != m_synced.cend(); it++)
+        files.append(toJson(it.key(), it.value()));
+
+    QJsonObject root;
+    root["version"] = s_state_version;
+    root["pack"] = m_pack_url.toString();
+    root["index_hash"] = m_synced_index_hash;
+    root["files"] = files;
+    try {
+        Json::write(root, FS::PathCombine(m_instance->instanceRoot(), s_state_file));
+    } catch (const Exception& e) {
+        // the next sync looks at every file again
+        qWarning() << "Couldn't write what was synced with the pack:" << e.cause();
+    }
+}
+
+void SyncTask::runJob(NetJob::Ptr job, std::function<void()> next)
+{
+    m_job = job;
+    connect(job.get(), &Task::succeeded, this, next);
+    connect(job.get(), &Task::failed, this, [this](QString reason) { emitFailed(reason); });
+    connect(job.get(), &Task::aborted, this, [this] { emitAborted(); });
+    connect(job.get(), &Task::progress, this, &SyncTask::setProgress);
+    connect(job.get(), &Task::stepProgress, this, &SyncTask::propogateStepProgress);
+    job->start();
+}
+
+}  // namespace Packwiz
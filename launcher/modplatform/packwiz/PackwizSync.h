@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QByteArray>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QUrl>
+
+#include <memory>
+
+#include "net/NetJob.h"
+#include "tasks/Task.h"
+
+class MinecraftInstance;
+
+namespace Packwiz {
+
+/* Keeps the game folder of an instance in sync with a packwiz pack published on a server (its pack.toml).
+ *
+ * What was synced last is kept in the instance folder: the hash of the index, and for each of its entries where the
+ * file went and what it should hash to. When the index didn't change, the pack.toml is all that's downloaded. The files
+ * in the game folder are compared to what the pack says through the hash cache (see Hashing::hashFile()), so only those
+ * that are missing or changed are downloaded again, all at once, and those the pack dropped are removed. The files of
+ * the game folder the pack never had are left alone, and so are those it marks to preserve once they exist.
+ */
+class SyncTask : public Task {
+    Q_OBJECT
+   public:
+    /** A file of the pack, as it should be in the game folder. */
+    struct File {
+        // relative to the game folder, empty for what isn't for the client
+        QString path;
+        QUrl url;
+        QString hash_format;
+        QString hash;
+        bool preserve = false;
+        // of the entry of the index it's from, which is the hash of the metafile for those that have one
+        QString entry_hash;
+    };
+
+    /** The [index] of a pack.toml. */
+    struct Pack {
+        QUrl index_url;
+        QString hash_format;
+        QString hash;
+
+        bool isValid() const { return index_url.isValid() && !hash.isEmpty(); }
+    };
+
+    /** A [[files]] entry of an index.toml. */
+    struct Entry {
+        QString path;
+        QString hash;
+        bool metafile = false;
+        bool preserve = false;
+    };
+
+    SyncTask(MinecraftInstance* instance, QUrl pack_url, QObject* parent = nullptr);
+    ~SyncTask() override = default;
+
+    /** Whether the instance was synced with a pack before, so it has something to launch when the server can't be reached. */
+    static bool wasSynced(const MinecraftInstance* instance);
+
+    static Pack parsePack(const QByteArray& data, const QUrl& pack_url, QString* error);
+    /** The entries of the index, and the hash format they use in `hash_format`. */
+    static QList<Entry> parseIndex(const QByteArray& data, QString* hash_format, QString* error);
+    /** The file a .pw.toml metafile at `path` (relative to the game folder) is for, without a path if it's server side only. */
+    static File parseMetafile(const QByteArray& data, const QString& path, QString* error);
+    /** Where `path` of the pack goes in `root`, empty if it would end up outside of it. */
+    static QString targetPath(const QString& root, const QString& path);
+
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    struct Outcome {
+        QList<File> outdated;
+        int removed = 0;
+        QString error;
+    };
+
+    void packDownloaded();
+    void indexDownloaded(const Pack& pack);
+    void metafilesDownloaded(const QList<Entry>& entries, const QString& hash_format);
+    void compare();
+    void download(const Outcome& outcome);
+    void finish();
+
+    void loadState();
+    void saveState();
+    void runJob(NetJob::Ptr job, std::function<void()> next);
+
+    static Outcome compareFiles(QString root, QList<File> files, QList<File> dropped);
+
+   private:
+    MinecraftInstance* m_instance;
+    QUrl m_pack_url;
+    NetJob::Ptr m_job;
+    QFutureWatcher<Outcome> m_watcher;
+    bool m_aborted = false;
+
+    std::shared_ptr<QByteArray> m_pack_data = std::make_shared<QByteArray>();
+    std::shared_ptr<QByteArray> m_index_data = std::make_shared<QByteArray>();
+    // index path -> what the metafile there says
+    QHash<QString, std::shared_ptr<QByteArray>> m_metafiles;
+
+    // what was synced last, by the path of the entry in the index
+    QString m_synced_index_hash;
+    QHash<QString, File> m_synced;
+    // what the pack has now
+    QString m_index_hash;
+    QHash<QString, File> m_files;
+};
+
+}  // namespace Packwiz
@@ -40,6 +40,7 @@
 #include <QtConcurrentRun>
 #include <MMCZip.h>
 
+#include "Application.h"
 #include "TechnicPackProcessor.h"
 #include "SolderPackManifest.h"
 #include "net/ChecksumValidator.h"
@@ -56,6 +57,7 @@ Technic::SolderPackInstallTask::SolderPackInstallTask(
     m_version = version;
     m_network = network;
     m_minecraftVersion = minecraftVersion;
+    m_extractPool.setMaxThreadCount(QThread::idealThreadCount());
 }
 
 bool Technic::SolderPackInstallTask::abort() {
@@ -109,21 +111,44 @@ void Technic::SolderPackInstallTask::fileListSucceeded()
 
     m_filesNetJob.reset(new NetJob(tr("Downloading modpack"), m_network));
 
+    m_modCount = build.mods.size();
+    m_downloaded = false;
+    m_extractsRunning = 0;
+    m_extractFailed = false;
+
     int i = 0;
+    int reused = 0;
     for (const auto &mod : build.mods) {
-        auto path = FS::PathCombine(m_outputDir.path(), QString("%1").arg(i));
+        if (mod.md5.isEmpty()) {
+            auto path = FS::PathCombine(m_outputDir.path(), QString("%1").arg(i));
+            auto dl = Net::Download::makeFile(mod.url, path);
+            connect(dl.get(), &Net::Download::succeeded, this, [this, i, path] { startExtract(i, path); });
+            m_filesNetJob->addNetAction(dl);
+            i++;
+            continue;
+        }
 
-        auto dl = Net::Download::makeFile(mod.url, path);
-        if (!mod.md5.isEmpty()) {
-            auto rawMd5 = QByteArray::fromHex(mod.md5.toLatin1());
-            dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Md5, rawMd5));
+        // the zips are kept by their checksum, so the ones an update didn't change aren't downloaded again
+        auto entry = APPLICATION->metacache()->resolveEntry("TechnicPacks", QString("mods/%1.zip").arg(mod.md5.toLower()));
+        auto path = entry->getFullPath();
+        if (!entry->isStale() && entry->getMD5Sum().compare(mod.md5, Qt::CaseInsensitive) == 0) {
+            reused++;
+            startExtract(i, path);
+            i++;
+            continue;
         }
+
+        entry->setStale(true);
+        auto dl = Net::Download::makeCached(mod.url, entry);
+        auto rawMd5 = QByteArray::fromHex(mod.md5.toLatin1());
+        dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Md5, rawMd5));
+        connect(dl.get(), &Net::Download::succeeded, this, [this, i, path] { startExtract(i, path); });
         m_filesNetJob->addNetAction(dl);
 
         i++;
     }
-
-    m_modCount = build.mods.size();
+    if (reused > 0)
+        qDebug() << reused << "of" << m_modCount << "modpack files didn't change and are taken from the cache";
 
     connect(m_filesNetJob.get(), &NetJob::succeeded, this, &Technic::SolderPackInstallTask::downloadSucceeded);
     connect(m_filesNetJob.get(), &NetJob::progress, this, &Technic::SolderPackInstallTask::downloadProgressChanged);
@@ -133,39 +158,112 @@ void Technic::SolderPackInstallTask::fileListSucceeded()
     m_filesNetJob->start();
 }
 
-void Technic::SolderPackInstallTask::downloadSucceeded()
+static QString extractedDir(const QString &stagingPath, int index)
 {
-    m_abortable = false;
+    return FS::PathCombine(stagingPath, ".solder", QString::number(index));
+}
 
-    setStatus(tr("Extracting modpack"));
-    m_filesNetJob.reset();
-    m_extractFuture = QtConcurrent::run([this]()
+void Technic::SolderPackInstallTask::startExtract(int index, const QString &zip)
+{
+    if (m_extractFailed || !isRunning())
+        return;
+
+    // each zip goes to a folder of its own, they're put together in the order of the pack once they're all there
+    auto dir = extractedDir(m_stagingPath, index);
+    m_extractsRunning++;
+    auto watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher] {
+        watcher->deleteLater();
+        m_extractsRunning--;
+        if (!watcher->future().result())
+            m_extractFailed = true;
+        onExtractDone();
+    });
+    watcher->setFuture(QtConcurrent::run(&m_extractPool, [zip, dir] {
+        FS::ensureFolderPathExists(dir);
+        if (!MMCZip::extractDir(zip, dir)) {
+            qWarning() << "Failed to extract" << zip;
+            return false;
+        }
+        return true;
+    }));
+}
+
+void Technic::SolderPackInstallTask::onExtractDone()
+{
+    if (m_extractFailed && isRunning())
     {
-        int i = 0;
-        QString extractDir = FS::PathCombine(m_stagingPath, ".minecraft");
-        FS::ensureFolderPathExists(extractDir);
+        m_abortable = false;
+        stopExtracts();
+        emitFailed(tr("Failed to extract modpack"));
+        // the other downloads aren't of any use anymore
+        if (m_filesNetJob)
+            m_filesNetJob->abort();
+        return;
+    }
+    if (!m_downloaded || m_extractsRunning > 0 || !isRunning())
+        return;
+
+    m_extractFuture = QtConcurrent::run([this] { return mergeExtracted(); });
+    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &Technic::SolderPackInstallTask::extractFinished);
+    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &Technic::SolderPackInstallTask::extractAborted);
+    m_extractFutureWatcher.setFuture(m_extractFuture);
+}
 
-        while (m_modCount > i)
+void Technic::SolderPackInstallTask::stopExtracts()
+{
+    // the staging folder goes away once the task is done, so nothing may still be writing in it
+    m_extractPool.clear();
+    m_extractPool.waitForDone();
+}
+
+bool Technic::SolderPackInstallTask::mergeExtracted()
+{
+    QString extractDir = FS::PathCombine(m_stagingPath, ".minecraft");
+    FS::ensureFolderPathExists(extractDir);
+
+    // later zips of the pack win over earlier ones, as if they were extracted one after the other
+    for (int i = 0; i < m_modCount; i++)
+    {
+        QDir dir(extractedDir(m_stagingPath, i));
+        QDirIterator it(dir.path(), QDir::Files | QDir::Hidden | QDir::System, QDirIterator::Subdirectories);
+        while (it.hasNext())
         {
-            auto path = FS::PathCombine(m_outputDir.path(), QString("%1").arg(i));
-            if (!MMCZip::extractDir(path, extractDir))
+            auto from = it.next();
+            auto to = FS::PathCombine(extractDir, dir.relativeFilePath(from));
+            if (QFileInfo::exists(to) && !QFile::remove(to))
             {
+                qWarning() << "Failed to replace" << to;
+                return false;
+            }
+            if (!FS::ensureFilePathExists(to) || !QFile::rename(from, to))
+            {
+                qWarning() << "Failed to move" << from << "to" << to;
                 return false;
             }
-            i++;
         }
-        return true;
-    });
-    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &Technic::SolderPackInstallTask::extractFinished);
-    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &Technic::SolderPackInstallTask::extractAborted);
-    m_extractFutureWatcher.setFuture(m_extractFuture);
+    }
+    return FS::deletePath(FS::PathCombine(m_stagingPath, ".solder"));
+}
+
+void Technic::SolderPackInstallTask::downloadSucceeded()
+{
+    m_abortable = false;
+
+    setStatus(tr("Extracting modpack"));
+    m_filesNetJob.reset();
+    m_downloaded = true;
+    onExtractDone();
 }
 
 void Technic::SolderPackInstallTask::downloadFailed(QString reason)
 {
     m_abortable = false;
-    emitFailed(reason);
     m_filesNetJob.reset();
+    if (!isRunning())
+        return;
+    stopExtracts();
+    emitFailed(reason);
 }
 
 void Technic::SolderPackInstallTask::downloadProgressChanged(qint64 current, qint64 total)
@@ -176,8 +274,12 @@ void Technic::SolderPackInstallTask::downloadProgressChanged(qint64 current, qin
 
 void Technic::SolderPackInstallTask::downloadAborted()
 {
-    emitAborted();
     m_filesNetJob.reset();
+    // also when a zip failed to extract and the task gave up already
+    if (!isRunning())
+        return;
+    stopExtracts();
+    emitAborted();
 }
 
 void Technic::SolderPackInstallTask::extractFinished()
@@ -39,6 +39,7 @@
 #include <net/NetJob.h>
 #include <tasks/Task.h>
 
+#include <QThreadPool>
 #include <QUrl>
 
 namespace Technic
@@ -66,6 +67,11 @@ namespace Technic
         void extractAborted();
 
     private:
+        void startExtract(int index, const QString &zip);
+        void onExtractDone();
+        void stopExtracts();
+        bool mergeExtracted();
+
         bool m_abortable = false;
 
         shared_qobject_ptr<QNetworkAccessManager> m_network;
@@ -78,7 +84,12 @@ namespace Technic
         QByteArray m_response;
         QTemporaryDir m_outputDir;
         int m_modCount;
+        bool m_downloaded = false;
+        int m_extractsRunning = 0;
+        bool m_extractFailed = false;
         QFuture<bool> m_extractFuture;
         QFutureWatcher<bool> m_extractFutureWatcher;
+        // last, so it waits for its workers before anything they use goes away
+        QThreadPool m_extractPool;
     };
 }
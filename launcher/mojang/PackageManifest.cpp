@@ -4,6 +4,10 @@
 #include <QDirIterator>
 #include <QCryptographicHash>
 #include <QDebug>
+#include <QJsonObject>
+#include <QtConcurrent>
+
+#include "digest/Digest.h"
 
 #ifndef Q_OS_WIN32
 #include <unistd.h>
@@ -121,6 +125,7 @@ void fromJson(QJsonDocument & doc, Package & out) {
                     file.hash = source.hash;
                     file.size = source.size;
                     source.compression = Compression::Raw;
+                    out.rawSources[source.hash] = source;
                 }
                 else if (compression == "lzma") {
                     source.compression = Compression::Lzma;
@@ -226,13 +231,90 @@ bool actually_read_symlink_target(const QString & filepath, Path & out)
 }
 #endif
 
+HashIndex HashIndex::load(const QString &path)
+{
+    HashIndex out;
+    if (!QFileInfo::exists(path))
+        return out;
+    try
+    {
+        auto root = Json::requireObject(Json::requireDocument(path, "Hash index"), "Hash index");
+        auto files = Json::requireObject(root, "files");
+        for (auto iter = files.begin(); iter != files.end(); iter++)
+        {
+            auto fileObject = Json::requireObject(iter.value());
+            Entry entry;
+            entry.size = static_cast<std::uint64_t>(Json::requireDouble(fileObject, "size"));
+            entry.mtime = static_cast<qint64>(Json::requireDouble(fileObject, "mtime"));
+            entry.hash = Json::requireString(fileObject, "sha1");
+            out.entries[Path(iter.key())] = entry;
+        }
+    }
+    catch (const Exception &e)
+    {
+        qDebug() << QString("Unable to load hash index %1: %2").arg(path, e.cause());
+        out.entries.clear();
+    }
+    return out;
+}
+
+bool HashIndex::save(const QString &path) const
+{
+    QJsonObject files;
+    for (auto &item : entries)
+    {
+        QJsonObject fileObject;
+        fileObject.insert("size", static_cast<double>(item.second.size));
+        fileObject.insert("mtime", static_cast<double>(item.second.mtime));
+        fileObject.insert("sha1", item.second.hash);
+        files.insert(item.first.toString(), fileObject);
+    }
+    QJsonObject root;
+    root.insert("files", files);
+    try
+    {
+        Json::write(root, path);
+        return true;
+    }
+    catch (const Exception &e)
+    {
+        qDebug() << QString("Unable to save hash index %1: %2").arg(path, e.cause());
+        return false;
+    }
+}
+
+namespace {
+struct InspectedFile
+{
+    Path path;
+    QString absolutePath;
+    qint64 mtime = 0;
+    File file;
+    bool failed = false;
+};
+
+void hashFile(InspectedFile &inspected)
+{
+    QFile input(inspected.absolutePath);
+    Digest hash(QCryptographicHash::Sha1);
+    if (!input.open(QIODevice::ReadOnly) || !hash.addData(&input))
+    {
+        inspected.failed = true;
+        return;
+    }
+    inspected.file.hash = hash.result().toHex().constData();
+}
+}
+
 // FIXME: Qt filesystem abstraction is bad, but ... let's hope it doesn't break too much?
 // FIXME: The error handling is just DEFICIENT
-Package Package::fromInspectedFolder(const QString& folderPath)
+Package Package::fromInspectedFolder(const QString& folderPath, HashIndex *index)
 {
     QDir root(folderPath);
 
     Package out;
+    std::vector<InspectedFile> inspected;
+    std::vector<InspectedFile> toHash;
     QDirIterator iterator(folderPath, QDir::NoDotAndDotDot | QDir::AllEntries | QDir::System | QDir::Hidden, QDirIterator::Subdirectories);
     while(iterator.hasNext()) {
         iterator.next();
@@ -258,18 +340,23 @@ Package Package::fromInspectedFolder(const QString& folderPath)
             out.addFolder(relPath);
         }
         else if(fileInfo.isFile()) {
-            File f;
-            f.executable = fileInfo.isExecutable();
-            f.size = fileInfo.size();
-            // FIXME: async / optimize the hashing
-            QFile input(fileInfo.absoluteFilePath());
-            if(!input.open(QIODevice::ReadOnly)) {
-                qCritical() << "Folder inspection: Failed to open file:" << fileInfo.absoluteFilePath();
-                out.valid = false;
-                break;
+            InspectedFile file;
+            file.path = Path(relPath);
+            file.absolutePath = fileInfo.absoluteFilePath();
+            file.mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+            file.file.executable = fileInfo.isExecutable();
+            file.file.size = fileInfo.size();
+            if (index)
+            {
+                auto known = index->entries.find(file.path);
+                if (known != index->entries.end() && known->second.size == file.file.size && known->second.mtime == file.mtime)
+                {
+                    file.file.hash = known->second.hash;
+                    inspected.push_back(file);
+                    continue;
+                }
             }
-            f.hash = QCryptographicHash::hash(input.readAll(), QCryptographicHash::Sha1).toHex().constData();
-            out.addFile(relPath, f);
+            toHash.push_back(file);
         }
         else {
             // Something else... oh my
@@ -278,8 +365,25 @@ Package Package::fromInspectedFolder(const QString& folderPath)
             break;
         }
     }
+
+    QtConcurrent::blockingMap(toHash, hashFile);
+    inspected.insert(inspected.end(), toHash.begin(), toHash.end());
+
+    if (index)
+        index->entries.clear();
+    for (auto &file : inspected)
+    {
+        if (file.failed)
+        {
+            qCritical() << "Folder inspection: Failed to open file:" << file.absolutePath;
+            out.valid = false;
+            continue;
+        }
+        out.addFile(file.path, file.file);
+        if (index)
+            index->entries[file.path] = { file.file.size, file.mtime, file.file.hash };
+    }
     out.folders.insert(Path("."));
-    out.valid = true;
     return out;
 }
 
@@ -351,27 +455,27 @@ UpdateOperations UpdateOperations::resolve(const Package& from, const Package& t
         auto new_hash = iter2->second.hash;
         auto new_executable = iter2->second.executable;
         if (current_hash != new_hash) {
+            auto source = to.sources.find(new_hash);
+            if (source == to.sources.end()) {
+                qWarning() << "No source for" << path.toString() << "in the package";
+                return out;
+            }
             out.deletes.push_back(path);
-            out.downloads.emplace(
-                std::pair<Path, FileDownload>{
-                    path,
-                    FileDownload(to.sources.at(iter2->second.hash), iter2->second.executable)
-                }
-            );
+            out.downloads.emplace(path, FileDownload(source->second, new_executable));
         }
         else if (current_executable != new_executable) {
             out.executable_fixes[path] = new_executable;
         }
     }
     for(auto iter = to.files.begin(); iter != to.files.end(); iter++) {
-        auto path = iter->first;
+        const auto &path = iter->first;
         if(!from.files.count(path)) {
-            out.downloads.emplace(
-                std::pair<Path, FileDownload>{
-                    path,
-                    FileDownload(to.sources.at(iter->second.hash), iter->second.executable)
-                }
-            );
+            auto source = to.sources.find(iter->second.hash);
+            if (source == to.sources.end()) {
+                qWarning() << "No source for" << path.toString() << "in the package";
+                return out;
+            }
+            out.downloads.emplace(path, FileDownload(source->second, iter->second.executable));
         }
     }
 
@@ -127,8 +127,24 @@ struct File
     std::uint64_t size = 0;
 };
 
+// The hashes found by an earlier inspection of a folder, so the files that didn't change don't have to be read again
+struct HashIndex {
+    struct Entry {
+        std::uint64_t size = 0;
+        qint64 mtime = 0;
+        Hash hash;
+    };
+    static HashIndex load(const QString &path);
+    bool save(const QString &path) const;
+
+    // by path inside the folder
+    std::map<Path, Entry> entries;
+};
+
 struct Package {
-    static Package fromInspectedFolder(const QString &folderPath);
+    // Files are hashed on the global thread pool. With an index, files with the same size and modification time
+    // as in it keep their hash, and the index is updated with what was found.
+    static Package fromInspectedFolder(const QString &folderPath, HashIndex *index = nullptr);
     static Package fromManifestFile(const QString &path);
     static Package fromManifestContents(const QByteArray& contents);
 
@@ -142,6 +158,8 @@ struct Package {
     void addSource(const FileSource & source);
 
     std::map<Hash, FileSource> sources;
+    // the uncompressed downloads, for the files whose best source is compressed
+    std::map<Hash, FileSource> rawSources;
     bool valid = true;
     std::set<Path> folders;
     std::map<Path, File> files;
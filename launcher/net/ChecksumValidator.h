@@ -40,6 +40,8 @@
 #include <QCryptographicHash>
 #include <QFile>
 
+#include "digest/Digest.h"
+
 namespace Net {
 class ChecksumValidator : public Validator {
    public:
@@ -76,7 +78,7 @@ class ChecksumValidator : public Validator {
     void setExpected(QByteArray expected) { m_expected = expected; }
 
    private:
-    QCryptographicHash m_checksum;
+    Digest m_checksum;
     QByteArray m_expected;
 };
 }  // namespace Net
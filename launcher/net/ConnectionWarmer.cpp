@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ConnectionWarmer.h"
+
+#include <QSslConfiguration>
+#include <QUrl>
+
+#include "BuildConfig.h"
+#include "net/Logging.h"
+#include "settings/SettingsObject.h"
+
+namespace Net {
+
+namespace {
+// more than that and the connections would mostly time out unused
+constexpr int s_max_hosts = 8;
+// the recent hosts are written a while after they change, not for every request
+constexpr int s_save_delay_ms = 30 * 1000;
+}  // namespace
+
+ConnectionWarmer::ConnectionWarmer(shared_qobject_ptr<QNetworkAccessManager> network,
+                                   std::shared_ptr<SettingsObject> settings,
+                                   QObject* parent)
+    : QObject(parent), m_network(network), m_settings(settings)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    m_recent = m_settings->get("RecentHosts").toString().split(',', Qt::SkipEmptyParts);
+#else
+    m_recent = m_settings->get("RecentHosts").toString().split(',', QString::SkipEmptyParts);
+#endif
+
+    m_save_timer.setSingleShot(true);
+    m_save_timer.setInterval(s_save_delay_ms);
+    connect(&m_save_timer, &QTimer::timeout, this, &ConnectionWarmer::save);
+}
+
+ConnectionWarmer::~ConnectionWarmer()
+{
+    if (m_save_timer.isActive())
+        save();
+}
+
+QStringList ConnectionWarmer::hosts() const
+{
+    auto meta = m_settings->get("MetaURLOverride").toString();
+    if (meta.isEmpty())
+        meta = BuildConfig.META_URL;
+
+    QStringList hosts = m_recent;
+    for (auto& url : { BuildConfig.LIBRARY_BASE, QString("https://piston-meta.mojang.com"), meta, BuildConfig.MODRINTH_PROD_URL,
+                       BuildConfig.FLAME_BASE_URL }) {
+        auto host = QUrl(url).host();
+        if (!host.isEmpty() && !hosts.contains(host))
+            hosts.append(host);
+    }
+    return hosts.mid(0, s_max_hosts);
+}
+
+void ConnectionWarmer::warmUp()
+{
+    if (!m_settings->get("ConnectionWarmup").toBool())
+        return;
+
+    auto hosts = this->hosts();
+    qCDebug(taskNetLogC) << "Connecting ahead of time to" << hosts;
+    // what the launcher talks to is all HTTPS
+    auto ssl = QSslConfiguration::defaultConfiguration();
+    // or the connection would be one for HTTP/1.1, which the requests don't take when they can go with HTTP/2
+    if (m_settings->get("UseHttp2").toBool())
+        ssl.setAllowedNextProtocols({ QSslConfiguration::ALPNProtocolHTTP2, QSslConfiguration::NextProtocolHttp1_1 });
+    for (auto& host : hosts)
+        m_network->connectToHostEncrypted(host, 443, ssl);
+}
+
+void ConnectionWarmer::hostUsed(const QString& host)
+{
+    if (host.isEmpty() || (!m_recent.isEmpty() && m_recent.first() == host))
+        return;
+
+    m_recent.removeAll(host);
+    m_recent.prepend(host);
+    while (m_recent.size() > s_max_hosts)
+        m_recent.removeLast();
+    if (!m_save_timer.isActive())
+        m_save_timer.start();
+}
+
+void ConnectionWarmer::save()
+{
+    m_save_timer.stop();
+    m_settings->set("RecentHosts", m_recent.join(','));
+}
+
+}  // namespace Net
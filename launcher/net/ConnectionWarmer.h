@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QNetworkAccessManager>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+
+#include <memory>
+
+#include "QObjectPtr.h"
+
+class SettingsObject;
+
+namespace Net {
+
+/* Sets up the connections to the hosts the launcher talks to before anything asks for them.
+ *
+ * The first request of a session to a host pays for the DNS lookup and the TCP and TLS handshakes, which makes the first
+ * version list or search slow. Right after startup, this connects to the hosts ahead of time, so QNetworkAccessManager
+ * has the connections ready in its pool. The hosts the user made requests to most recently (as the HostPool sees them)
+ * go first, then the ones the launcher always needs. The recent ones are kept in the settings.
+ */
+class ConnectionWarmer : public QObject {
+    Q_OBJECT
+   public:
+    ConnectionWarmer(shared_qobject_ptr<QNetworkAccessManager> network, std::shared_ptr<SettingsObject> settings, QObject* parent = nullptr);
+    ~ConnectionWarmer() override;
+
+    /** The hosts warmUp() connects to, in that order. */
+    QStringList hosts() const;
+
+    /** Connects to hosts(), when the ConnectionWarmup setting is on. */
+    void warmUp();
+
+   public slots:
+    /** Remembers that a request for `host` was made, see HostPool::hostRequested(). */
+    void hostUsed(const QString& host);
+
+   private:
+    void save();
+
+   private:
+    shared_qobject_ptr<QNetworkAccessManager> m_network;
+    std::shared_ptr<SettingsObject> m_settings;
+    // the most recent first
+    QStringList m_recent;
+    QTimer m_save_timer;
+};
+
+}  // namespace Net
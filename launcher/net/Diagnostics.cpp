@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Diagnostics.h"
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSet>
+#include <QUrl>
+#include <QUrlQuery>
+
+#include "BuildConfig.h"
+
+namespace Net {
+
+namespace {
+QJsonArray nameValues(const QList<QPair<QString, QString>>& pairs)
+{
+    QJsonArray array;
+    for (auto& [name, value] : pairs)
+        array.append(QJsonObject{ { "name", name }, { "value", value } });
+    return array;
+}
+
+// HAR has no "didn't happen" for those
+qint64 orZero(qint64 ms)
+{
+    return qMax<qint64>(ms, 0);
+}
+}  // namespace
+
+QString Diagnostics::Request::host() const
+{
+    return QUrl(url).host();
+}
+
+qint64 Diagnostics::Request::total() const
+{
+    return orZero(queued) + orZero(connect) + orZero(send) + orZero(wait) + orZero(receive);
+}
+
+double Diagnostics::HostStats::throughput() const
+{
+    if (receiveTime <= 0)
+        return 0;
+    return bytes * 1000.0 / receiveTime;
+}
+
+Diagnostics::Diagnostics(QObject* parent) : QObject(parent)
+{
+    qRegisterMetaType<Net::Diagnostics::Request>();
+}
+
+void Diagnostics::record(Request request)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        request.id = m_next_id++;
+
+        auto& host = m_hosts[request.host()];
+        host.requests++;
+        if (!request.error.isEmpty())
+            host.failed++;
+        if (request.cache == CacheOutcome::Hit)
+            host.hits++;
+        if (request.cache == CacheOutcome::Revalidated)
+            host.revalidated++;
+        if (request.attempt > 1)
+            host.retries++;
+        host.bytes += request.bytes;
+        host.receiveTime += orZero(request.receive);
+        host.waitTime += orZero(request.wait);
+
+        m_requests.push_back(request);
+        if (m_requests.size() > s_max_requests)
+            m_requests.pop_front();
+    }
+    emit recorded(request);
+}
+
+QList<Diagnostics::Request> Diagnostics::requests(const QString& job) const
+{
+    QMutexLocker locker(&m_mutex);
+    QList<Request> requests;
+    for (auto& request : m_requests) {
+        if (job.isEmpty() || request.job == job)
+            requests.append(request);
+    }
+    return requests;
+}
+
+QStringList Diagnostics::jobs() const
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList jobs;
+    QSet<QString> seen;
+    for (auto& request : m_requests) {
+        if (!request.job.isEmpty() && !seen.contains(request.job)) {
+            seen.insert(request.job);
+            jobs.append(request.job);
+        }
+    }
+    return jobs;
+}
+
+QHash<QString, Diagnostics::HostStats> Diagnostics::hosts() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hosts;
+}
+
+void Diagnostics::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_requests.clear();
+    m_hosts.clear();
+}
+
+QString Diagnostics::cacheOutcomeName(CacheOutcome outcome)
+{
+    switch (outcome) {
+        case CacheOutcome::Hit:
+            return "hit";
+        case CacheOutcome::Revalidated:
+            return "revalidated";
+        case CacheOutcome::Miss:
+            return "miss";
+        case CacheOutcome::None:
+            break;
+    }
+    return "none";
+}
+
+QJsonDocument Diagnostics::toHar(const QList<Request>& requests)
+{
+    QJsonArray entries;
+    for (auto& request : requests) {
+        auto query = QUrlQuery(QUrl(request.url)).queryItems(QUrl::FullyDecoded);
+        QList<QPair<QString, QString>> headers;
+        for (auto& [name, value] : request.headers)
+            headers.append({ QString::fromLatin1(name), QString::fromLatin1(value) });
+
+        auto http_version = request.httpVersion.isEmpty() ? QString("HTTP/1.1") : request.httpVersion;
+        QJsonObject entry{
+            { "startedDateTime", request.started.toUTC().toString(Qt::ISODateWithMs) },
+            { "time", request.total() },
+            { "request", QJsonObject{ { "method", request.method },
+                                      { "url", request.url },
+                                      { "httpVersion", http_version },
+                                      { "cookies", QJsonArray() },
+                                      // what they were sent with has the API keys and tokens
+                                      { "headers", QJsonArray() },
+                                      { "queryString", nameValues(query) },
+                                      { "headersSize", -1 },
+                                      { "bodySize", 0 } } },
+            { "response", QJsonObject{ { "status", request.status },
+                                       { "statusText", request.statusText },
+                                       { "httpVersion", http_version },
+                                       { "cookies", QJsonArray() },
+                                       { "headers", nameValues(headers) },
+                                       { "content", QJsonObject{ { "size", request.bytes }, { "mimeType", request.mimeType } } },
+                                       { "redirectURL", request.redirect },
+                                       { "headersSize", -1 },
+                                       { "bodySize", request.cache == CacheOutcome::Hit ? 0 : request.bytes } } },
+            { "cache", QJsonObject() },
+            { "timings", QJsonObject{ { "blocked", request.queued },
+                                      // both are in connect
+                                      { "dns", -1 },
+                                      { "ssl", -1 },
+                                      { "connect", request.connect },
+                                      { "send", orZero(request.send) },
+                                      { "wait", orZero(request.wait) },
+                                      { "receive", orZero(request.receive) } } },
+            { "_job", request.job },
+            { "_attempt", request.attempt },
+            { "_cache", cacheOutcomeName(request.cache) },
+        };
+        if (!request.error.isEmpty())
+            entry.insert("_error", request.error);
+        entries.append(entry);
+    }
+
+    QJsonObject log{ { "version", "1.2" },
+                     { "creator", QJsonObject{ { "name", BuildConfig.LAUNCHER_DISPLAYNAME },
+                                               { "version", BuildConfig.printableVersionString() } } },
+                     { "pages", QJsonArray() },
+                     { "entries", entries } };
+    return QJsonDocument(QJsonObject{ { "log", log } });
+}
+
+bool Diagnostics::exportHar(const QString& path, const QString& job) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    auto data = toHar(requests(job)).toJson(QJsonDocument::Indented);
+    return file.write(data) == data.size() && file.commit();
+}
+
+}  // namespace Net
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QJsonDocument>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+#include <deque>
+
+namespace Net {
+
+/* What the downloads of the session did on the network, for finding out why an install is slow: how long each request
+ * waited for a slot (see HostPool), for a connection and for the first byte, how long the transfer took, and whether the
+ * cache had the file already.
+ *
+ * Qt doesn't tell the host lookup apart from the connection, nor the TLS handshake from either, so those three are one
+ * time here. A request on a connection that was open already has none. The last requests are kept, and what each host
+ * did over the whole session. Either can be exported as a HAR file, which the browsers' developer tools can open.
+ */
+class Diagnostics : public QObject {
+    Q_OBJECT
+   public:
+    enum class CacheOutcome {
+        // not something that's cached
+        None,
+        // the cache had it, nothing went over the network
+        Hit,
+        // the server said the cached copy is still current
+        Revalidated,
+        Miss,
+    };
+
+    struct Request {
+        quint64 id = 0;
+        // the NetJob it was part of
+        QString job;
+        QString url;
+        QString method = "GET";
+        QDateTime started;
+        // the tries the download is at, 1 for the first
+        int attempt = 1;
+        CacheOutcome cache = CacheOutcome::None;
+
+        // in milliseconds, -1 for what didn't happen
+        qint64 queued = -1;
+        // the host lookup, the connection and the TLS handshake
+        qint64 connect = -1;
+        qint64 send = -1;
+        // until the headers of the reply came, after the request was sent
+        qint64 wait = -1;
+        qint64 receive = -1;
+
+        int status = 0;
+        QString statusText;
+        QString httpVersion;
+        QString mimeType;
+        QString redirect;
+        qint64 bytes = 0;
+        QList<QPair<QByteArray, QByteArray>> headers;
+        // empty when it succeeded
+        QString error;
+
+        QString host() const;
+        /** From the start to the end, all the timings together. */
+        qint64 total() const;
+    };
+
+    struct HostStats {
+        int requests = 0;
+        int failed = 0;
+        int hits = 0;
+        int revalidated = 0;
+        // the tries after the first
+        int retries = 0;
+        qint64 bytes = 0;
+        // of receiving, what the throughput is of
+        qint64 receiveTime = 0;
+        qint64 waitTime = 0;
+
+        /** Bytes per second, 0 when nothing came in. */
+        double throughput() const;
+    };
+
+    explicit Diagnostics(QObject* parent = nullptr);
+
+    /** Takes a request that's done, from any thread. */
+    void record(Request request);
+
+    /** The last requests, the oldest first, only those of `job` if it isn't empty. */
+    QList<Request> requests(const QString& job = {}) const;
+    /** The jobs of the kept requests. */
+    QStringList jobs() const;
+    /** The whole session, by host. */
+    QHash<QString, HostStats> hosts() const;
+    void clear();
+
+    static QJsonDocument toHar(const QList<Request>& requests);
+    /** Writes toHar() of requests(`job`) to `path`. */
+    bool exportHar(const QString& path, const QString& job = {}) const;
+
+    static QString cacheOutcomeName(CacheOutcome outcome);
+
+   signals:
+    void recorded(const Net::Diagnostics::Request& request);
+
+   private:
+    // the raw headers of each are kept too, so not too many
+    static constexpr std::size_t s_max_requests = 5000;
+
+    mutable QMutex m_mutex;
+    quint64 m_next_id = 1;
+    std::deque<Request> m_requests;
+    QHash<QString, HostStats> m_hosts;
+};
+
+}  // namespace Net
+
+Q_DECLARE_METATYPE(Net::Diagnostics::Request)
@@ -41,22 +41,37 @@
 
 #include <QDateTime>
 #include <QFileInfo>
+#include <QTimer>
 
 #include "ByteArraySink.h"
 #include "ChecksumValidator.h"
 #include "MetaCacheSink.h"
+#include "MultiDigestValidator.h"
+#include "StoreSink.h"
 
 #include "Application.h"
 #include "BuildConfig.h"
+#include "ContentStore.h"
 
+#include "net/HostPool.h"
 #include "net/Logging.h"
 #include "net/NetAction.h"
+#include "net/PeerCache.h"
 
 #include "MMCTime.h"
 #include "StringUtils.h"
 
 namespace Net {
 
+namespace {
+// how often a file someone else is downloading is looked at again
+constexpr int s_lease_poll_ms = 250;
+// a segmented download is cut in parts of at least half the threshold, and no more than that many
+constexpr qint64 s_max_segments = 4;
+// how long a mirror may stall before the next one is tried, shorter than the usual timeout as there's somewhere else to go
+constexpr int s_mirror_timeout_ms = 10 * 1000;
+}  // namespace
+
 auto Download::makeCached(QUrl url, MetaEntryPtr entry, Options options) -> Download::Ptr
 {
     auto dl = makeShared<Download>();
@@ -65,6 +80,8 @@ auto Download::makeCached(QUrl url, MetaEntryPtr entry, Options options) -> Down
     dl->m_options = options;
     auto md5Node = new ChecksumValidator(QCryptographicHash::Md5);
     auto cachedNode = new MetaCacheSink(entry, md5Node, options.testFlag(Option::MakeEternal));
+    cachedNode->setResumable(options.testFlag(Option::Resumable));
+    cachedNode->setPreallocate(options.testFlag(Option::Preallocate) || options.testFlag(Option::Segmented));
     dl->m_sink.reset(cachedNode);
     return dl;
 }
@@ -85,16 +102,114 @@ auto Download::makeFile(QUrl url, QString path, Options options) -> Download::Pt
     dl->m_url = url;
     dl->setObjectName(QString("FILE:") + url.toString());
     dl->m_options = options;
-    dl->m_sink.reset(new FileSink(path));
+    auto sink = new FileSink(path);
+    sink->setResumable(options.testFlag(Option::Resumable));
+    sink->setDirect(options.testFlag(Option::Direct));
+    sink->setPreallocate(options.testFlag(Option::Preallocate) || options.testFlag(Option::Segmented));
+    dl->m_sink.reset(sink);
+    return dl;
+}
+
+auto Download::makeStored(QUrl url, QString path, QCryptographicHash::Algorithm algorithm, QByteArray hash, Options options)
+    -> Download::Ptr
+{
+    if (!ContentStore::isEnabled() || hash.isEmpty()) {
+        auto dl = makeFile(url, path, options);
+        if (options.testFlag(Option::KeepHashes))
+            dl->keepHashes(path, algorithm, hash);
+        else if (!hash.isEmpty())
+            dl->addValidator(new ChecksumValidator(algorithm, hash));
+        dl->m_peer_algorithm = algorithm;
+        dl->m_peer_hash = hash;
+        return dl;
+    }
+
+    auto dl = makeShared<Download>();
+    dl->m_url = url;
+    dl->setObjectName(QString("STORE:") + url.toString());
+    dl->m_options = options;
+    auto sink = new StoreSink(path, algorithm, hash);
+    sink->setResumable(options.testFlag(Option::Resumable));
+    sink->setPreallocate(options.testFlag(Option::Preallocate) || options.testFlag(Option::Segmented));
+    dl->m_sink.reset(sink);
+    // the store checks the hash it's given itself
+    if (options.testFlag(Option::KeepHashes))
+        dl->keepHashes(path, algorithm, {});
+    dl->m_peer_algorithm = algorithm;
+    dl->m_peer_hash = hash;
     return dl;
 }
 
+auto Download::makeStored(QUrl url, QString path, QString hash_type, QString hash, Options options) -> Download::Ptr
+{
+    auto algorithm = ContentStore::algorithmFromName(hash_type);
+    if (!algorithm || hash.isEmpty()) {
+        auto dl = makeFile(url, path, options);
+        if (options.testFlag(Option::KeepHashes))
+            dl->keepHashes(path, QCryptographicHash::Sha1, {});
+        return dl;
+    }
+
+    return makeStored(url, path, *algorithm, QByteArray::fromHex(hash.toLatin1()), options);
+}
+
+void Download::keepHashes(const QString& path, QCryptographicHash::Algorithm algorithm, QByteArray expected)
+{
+    auto hashes = std::make_shared<Hashing::FileHashes>();
+    addValidator(new MultiDigestValidator(hashes, algorithm, expected));
+    // the file has the size and time the cache knows it by once it's where it goes, which is after the validators.
+    // nothing came in for files that were there already, those are left alone
+    connect(this, &Task::succeeded, this, [hashes, path] { Hashing::rememberHashes(path, *hashes); });
+}
+
+Download::~Download()
+{
+    releaseHostSlot();
+    for (auto& segment : m_segments) {
+        if (segment->holds_host_slot)
+            APPLICATION->hostPool()->release(m_request.url().host());
+    }
+}
+
 void Download::addValidator(Validator* v)
 {
     m_sink->addValidator(v);
 }
 
+void Download::routeThroughMirrors(MirrorList::Kind kind)
+{
+    m_mirror_kind = kind;
+    m_origin = m_url;
+}
+
 void Download::executeTask()
+{
+    m_failure = {};
+    m_attempts++;
+    if (m_origin.isEmpty())
+        m_origin = m_url;
+
+    // what the peers and mirrors did since the last attempt counts for this one
+    m_routes.clear();
+    m_peer_urls.clear();
+    auto peers = APPLICATION->peerCache();
+    if (peers && peers->isEnabled() && !m_peer_hash.isEmpty()) {
+        for (auto& url : peers->routes(m_peer_algorithm, m_peer_hash)) {
+            m_routes.append(url);
+            m_peer_urls.insert(url);
+        }
+    }
+    if (m_mirror_kind)
+        m_routes.append(APPLICATION->mirrors()->route(*m_mirror_kind, m_origin));
+    else
+        m_routes.append(m_origin);
+
+    m_url = m_routes.takeFirst();
+    m_mirror_url = m_url;
+    startDownload();
+}
+
+void Download::startDownload()
 {
     setStatus(tr("Downloading %1").arg(StringUtils::truncateUrlHumanFriendly(m_url, 80)));
 
@@ -104,10 +219,15 @@ void Download::executeTask()
         return;
     }
 
+    m_probe.reset();
+    m_segments.clear();
+
     QNetworkRequest request(m_url);
     m_state = m_sink->init(request);
     switch (m_state) {
         case State::Succeeded:
+            if (m_sink->isCache())
+                recordTrace(nullptr, "GET", 0);
             emit succeeded();
             qCDebug(taskDownloadLogC) << getUid().toString() << "Download cache hit " << m_url.toString();
             return;
@@ -115,6 +235,17 @@ void Download::executeTask()
             qCDebug(taskDownloadLogC) << getUid().toString() << "Downloading " << m_url.toString();
             break;
         case State::Inactive:
+            // someone else is downloading the same file, it is looked at again once they might be done
+            setStatus(tr("Waiting for %1").arg(StringUtils::truncateUrlHumanFriendly(m_url, 80)));
+            QTimer::singleShot(s_lease_poll_ms, this, [this] {
+                if (m_state == State::AbortedByUser) {
+                    m_sink->abort();
+                    emitAborted();
+                    return;
+                }
+                startDownload();
+            });
+            return;
         case State::Failed:
             emitFailed();
             return;
@@ -135,14 +266,296 @@ void Download::executeTask()
     }
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-    request.setTransferTimeout();
+    if (m_routes.isEmpty())
+        request.setTransferTimeout();
+    else
+        request.setTransferTimeout(s_mirror_timeout_ms);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, APPLICATION->hostPool()->http2Allowed());
+#endif
+
+    // The slot is given back once the reply finishes (or before following a redirect)
+    releaseHostSlot();
+    m_host_slot = request.url().host();
+    // with a bandwidth limit, more connections wouldn't get the file any faster
+    bool probe = m_options.testFlag(Option::Segmented) && m_sink->canWriteSegments() && APPLICATION->hostPool()->bandwidthLimit() == 0;
+    m_queued_time = m_clock.now();
+    APPLICATION->hostPool()->acquire(
+        m_host_slot, this, [this, request, probe] { probe ? startProbe(request) : startRequest(request); }, m_priority);
+}
+
+void Download::startProbe(QNetworkRequest request)
+{
+    m_holds_host_slot = true;
+
+    if (m_state == State::AbortedByUser) {
+        qCDebug(taskDownloadLogC) << getUid().toString() << "Download aborted while waiting for a connection:" << m_url.toString();
+        releaseHostSlot();
+        return;
+    }
+
+    m_request = request;
+    QNetworkRequest head(request);
+    head.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+    m_request_time = m_clock.now();
+    m_probe.reset(m_network->head(head));
+    watchTimings(m_probe.get());
+    connect(m_probe.get(), &QNetworkReply::finished, this, &Download::probeFinished);
+    connect(m_probe.get(), &QNetworkReply::sslErrors, this, &Download::sslErrors);
+}
+
+void Download::probeFinished()
+{
+    auto& probe = *m_probe;
+    if (m_state == State::AbortedByUser || probe.error() == QNetworkReply::OperationCanceledError) {
+        qCDebug(taskDownloadLogC) << getUid().toString() << "Download aborted while probing:" << m_url.toString();
+        releaseHostSlot();
+        m_sink->abort();
+        m_probe.reset();
+        emit aborted();
+        return;
+    }
+
+    recordTrace(&probe, "HEAD", 0);
+
+    int status = probe.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (probe.error() == QNetworkReply::NoError && status == 304) {
+        // the copy we have is still current, which the sink takes the same way as after a GET
+        releaseHostSlot();
+        m_sink->headersReceived(probe);
+        m_state = m_sink->finalize(probe);
+        m_probe.reset();
+        if (m_state != State::Succeeded) {
+            m_sink->abort();
+            emit failed("");
+            return;
+        }
+        qCDebug(taskDownloadLogC) << getUid().toString() << "Download not modified:" << m_url.toString();
+        emit succeeded();
+        return;
+    }
+
+    // Ranges of a file that changes in between would make up something else, so the server has to tell us how to notice
+    auto etag = probe.rawHeader("ETag");
+    m_if_range = etag.startsWith("W/") ? QByteArray() : etag;
+    if (m_if_range.isEmpty())
+        m_if_range = probe.rawHeader("Last-Modified");
+    auto size = probe.header(QNetworkRequest::ContentLengthHeader).toLongLong();
+    bool segmented = probe.error() == QNetworkReply::NoError && status == 200 &&
+                     probe.rawHeader("Accept-Ranges").trimmed().toLower() == "bytes" && size >= s_segment_threshold && !m_if_range.isEmpty();
+
+    // no need to go through the redirects again
+    m_request.setUrl(probe.url());
+    if (!segmented) {
+        qCDebug(taskDownloadLogC) << getUid().toString() << "Downloading in one piece:" << m_url.toString();
+        m_probe.reset();
+        // it has the slot already
+        m_queued_time = m_clock.now();
+        startRequest(m_request);
+        return;
+    }
+
+    // the segments wait for their own slots
+    releaseHostSlot();
+    m_state = m_sink->beginSegments(size);
+    if (m_state != State::Running) {
+        m_sink->abort();
+        m_probe.reset();
+        emit failed("");
+        return;
+    }
+
+    auto count = qBound<qint64>(2, size / (s_segment_threshold / 2), s_max_segments);
+    auto length = size / count;
+    for (qint64 i = 0; i < count; i++) {
+        auto segment = std::make_unique<Segment>();
+        segment->start = i * length;
+        segment->end = i == count - 1 ? size - 1 : (i + 1) * length - 1;
+        m_segments.push_back(std::move(segment));
+    }
+    m_segments_left = m_segments.size();
+    m_segmented_size = size;
+    m_segments_time = m_clock.now();
+    m_last_progress_time = m_clock.now();
+    m_last_progress_bytes = 0;
+
+    qCDebug(taskDownloadLogC) << getUid().toString() << "Downloading" << m_url.toString() << "in" << count << "segments";
+    auto host = m_request.url().host();
+    for (std::size_t i = 0; i < m_segments.size(); i++)
+        APPLICATION->hostPool()->acquire(host, this, [this, i] { startSegment(i); }, m_priority);
+}
+
+void Download::startSegment(std::size_t index)
+{
+    auto& segment = *m_segments[index];
+    segment.holds_host_slot = true;
+    if (m_state != State::Running) {
+        // another segment failed already, or the download got aborted
+        segment.holds_host_slot = false;
+        APPLICATION->hostPool()->release(m_request.url().host());
+        segmentDone();
+        return;
+    }
+
+    QNetworkRequest request(m_request);
+    // what the sink revalidates the cached copy with is about the whole file
+    request.setRawHeader("If-None-Match", QByteArray());
+    request.setRawHeader("If-Modified-Since", QByteArray());
+    request.setRawHeader("Range", "bytes=" + QByteArray::number(segment.start) + "-" + QByteArray::number(segment.end));
+    request.setRawHeader("If-Range", m_if_range);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    // connections of their own are the point, HTTP/2 would put all the segments on one
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
 #endif
 
+    segment.reply.reset(m_network->get(request));
+    auto reply = segment.reply.get();
+    connect(reply, &QNetworkReply::readyRead, this, [this, index] { segmentReadyRead(index); });
+    connect(reply, &QNetworkReply::finished, this, [this, index] { segmentFinished(index); });
+    connect(reply, &QNetworkReply::sslErrors, this, &Download::sslErrors);
+}
+
+void Download::segmentReadyRead(std::size_t index)
+{
+    auto& segment = *m_segments[index];
+    if (m_state != State::Running)
+        return;
+
+    if (segment.reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206) {
+        // the whole file, or a new one: not something the segments can be put together from
+        qCCritical(taskDownloadLogC) << getUid().toString() << "Server didn't send the range asked for:" << m_url.toString();
+        m_state = State::Failed;
+        abortSegments();
+        return;
+    }
+
+    auto data = segment.reply->readAll();
+    if (segment.start + segment.received + data.size() > segment.end + 1) {
+        qCCritical(taskDownloadLogC) << getUid().toString() << "Server sent more than the range asked for:" << m_url.toString();
+        m_state = State::Failed;
+        abortSegments();
+        return;
+    }
+    m_state = m_sink->writeAt(segment.start + segment.received, data);
+    if (m_state != State::Running) {
+        qCCritical(taskDownloadLogC) << getUid().toString() << "Failed to process response chunk";
+        abortSegments();
+        return;
+    }
+    segment.received += data.size();
+
+    qint64 received = 0;
+    for (auto& other : m_segments)
+        received += other->received;
+    downloadProgress(received, m_segmented_size);
+}
+
+void Download::segmentFinished(std::size_t index)
+{
+    auto& segment = *m_segments[index];
+    if (segment.holds_host_slot) {
+        segment.holds_host_slot = false;
+        APPLICATION->hostPool()->release(m_request.url().host());
+    }
+
+    if (m_state == State::Running && segment.reply->bytesAvailable() > 0)
+        segmentReadyRead(index);
+    if (m_state == State::Running) {
+        auto error = segment.reply->error();
+        auto status = segment.reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (error != QNetworkReply::NoError || status != 206 || segment.received != segment.end - segment.start + 1) {
+            qCCritical(taskDownloadLogC) << getUid().toString() << "Segment" << segment.start << "-" << segment.end << "of"
+                                         << m_url.toString() << "failed with" << error << status;
+            noteFailure(*segment.reply, error);
+            m_state = error == QNetworkReply::OperationCanceledError ? State::AbortedByUser : State::Failed;
+            abortSegments();
+        }
+    }
+    segmentDone();
+}
+
+void Download::segmentDone()
+{
+    if (--m_segments_left > 0)
+        return;
+
+    // all of them are in, the headers of the probe are the ones of the whole file
+    if (m_state == State::Running)
+        m_state = m_sink->finalize(*m_probe);
+    if (m_state != State::Succeeded)
+        m_sink->abort();
+
+    // one entry for all of them, they went at once over connections of their own
+    if (auto diagnostics = APPLICATION->netDiagnostics()) {
+        Diagnostics::Request trace;
+        trace.job = m_job_name;
+        trace.url = m_request.url().toString();
+        trace.attempt = m_attempts;
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(m_clock.now() - m_segments_time).count();
+        trace.started = QDateTime::currentDateTimeUtc().addMSecs(-elapsed);
+        trace.receive = elapsed;
+        trace.status = 206;
+        trace.cache = m_sink->isCache() ? Diagnostics::CacheOutcome::Miss : Diagnostics::CacheOutcome::None;
+        for (auto& segment : m_segments)
+            trace.bytes += segment->received;
+        if (m_state != State::Succeeded)
+            trace.error = m_state == State::AbortedByUser ? tr("Aborted") : tr("A segment failed");
+        diagnostics->record(trace);
+    }
+    m_probe.reset();
+    m_segments.clear();
+
+    switch (m_state) {
+        case State::Succeeded:
+            qCDebug(taskDownloadLogC) << getUid().toString() << "Download succeeded:" << m_url.toString();
+            if (m_sink->changedContent())
+                emit contentChanged();
+            emit succeeded();
+            return;
+        case State::AbortedByUser:
+            qCDebug(taskDownloadLogC) << getUid().toString() << "Download aborted:" << m_url.toString();
+            emit aborted();
+            return;
+        default:
+            qCDebug(taskDownloadLogC) << getUid().toString() << "Segmented download failed:" << m_url.toString();
+            emit failed("");
+            return;
+    }
+}
+
+void Download::abortSegments()
+{
+    // aborting a reply finishes it right away, which may finish the download and clear the segments
+    QList<QNetworkReply*> running;
+    for (auto& segment : m_segments) {
+        if (segment->reply && segment->reply->isRunning())
+            running.append(segment->reply.get());
+    }
+    for (auto reply : running)
+        reply->abort();
+}
+
+void Download::startRequest(QNetworkRequest request)
+{
+    m_holds_host_slot = true;
+
+    if (m_state == State::AbortedByUser) {
+        qCDebug(taskDownloadLogC) << getUid().toString() << "Download aborted while waiting for a connection:" << m_url.toString();
+        releaseHostSlot();
+        return;
+    }
+
     m_last_progress_time = m_clock.now();
     m_last_progress_bytes = 0;
+    m_request_time = m_clock.now();
+    m_latency_ms = -1;
+    m_received = 0;
 
     QNetworkReply* rep = m_network->get(request);
     m_reply.reset(rep);
+    watchTimings(rep);
+    // Without a limit, the reply would keep reading from the network however little of it we take
+    if (auto limit = APPLICATION->hostPool()->bandwidthLimit(); limit > 0)
+        rep->setReadBufferSize(qMax<qint64>(16 * 1024, limit / 4));
     connect(rep, &QNetworkReply::downloadProgress, this, &Download::downloadProgress);
     connect(rep, &QNetworkReply::finished, this, &Download::downloadFinished);
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0) // QNetworkReply::errorOccurred added in 5.15
@@ -182,14 +595,15 @@ void Download::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
 
     setDetails(dl_progress + "\n" + dl_speed_str);
 
+    m_received = bytesReceived;
     setProgress(bytesReceived, bytesTotal);
 }
 
 void Download::downloadError(QNetworkReply::NetworkError error)
 {
-    if (error == QNetworkReply::OperationCanceledError) {
+    // a reply that times out gets canceled too, but only abort() says the user wanted it
+    if (error == QNetworkReply::OperationCanceledError && m_state == State::AbortedByUser) {
         qCCritical(taskDownloadLogC) << getUid().toString() << "Aborted " << m_url.toString();
-        m_state = State::AbortedByUser;
     } else {
         if (m_options & Option::AcceptLocalFiles) {
             if (m_sink->hasLocalData()) {
@@ -198,6 +612,8 @@ void Download::downloadError(QNetworkReply::NetworkError error)
             }
         }
         // error happened during download.
+        if (auto reply = qobject_cast<QNetworkReply*>(sender()))
+            noteFailure(*reply, error);
         qCCritical(taskDownloadLogC) << getUid().toString() << "Failed " << m_url.toString() << " with reason " << error;
         m_state = State::Failed;
     }
@@ -262,15 +678,123 @@ auto Download::handleRedirect() -> bool
         qCDebug(taskDownloadLogC) << getUid().toString() << "Location header:" << redirect;
     }
 
+    recordTrace(m_reply.get(), "GET", m_received);
     m_url = QUrl(redirect.toString());
     qCDebug(taskDownloadLogC) << getUid().toString() << "Following redirect to " << m_url.toString();
-    startAction(m_network);
+    startDownload();
 
     return true;
 }
 
+auto Download::failOver() -> bool
+{
+    if (m_peer_urls.contains(m_mirror_url)) {
+        if (auto peers = APPLICATION->peerCache())
+            peers->reportFailure(m_mirror_url);
+    } else if (m_mirror_kind) {
+        APPLICATION->mirrors()->reportFailure(m_mirror_url);
+    }
+    if (m_routes.isEmpty())
+        return false;
+
+    m_url = m_routes.takeFirst();
+    m_mirror_url = m_url;
+    qCDebug(taskDownloadLogC) << getUid().toString() << "Trying the next source:" << m_url.toString();
+    startDownload();
+    return true;
+}
+
+void Download::watchTimings(QNetworkReply* reply)
+{
+    m_connecting_ms = -1;
+    m_encrypted_ms = -1;
+    m_sent_ms = -1;
+    m_headers_ms = -1;
+    auto since_request = [this] { return std::chrono::duration_cast<std::chrono::milliseconds>(m_clock.now() - m_request_time).count(); };
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+    // not emitted when the request goes on a connection that's open already
+    connect(reply, &QNetworkReply::socketStartedConnecting, this, [this, since_request] { m_connecting_ms = since_request(); });
+    connect(reply, &QNetworkReply::requestSent, this, [this, since_request] { m_sent_ms = since_request(); });
+#endif
+    connect(reply, &QNetworkReply::encrypted, this, [this, since_request] { m_encrypted_ms = since_request(); });
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, since_request] {
+        if (m_headers_ms < 0)
+            m_headers_ms = since_request();
+    });
+}
+
+void Download::recordTrace(QNetworkReply* reply, const QString& method, qint64 bytes, const QString& error)
+{
+    auto diagnostics = APPLICATION->netDiagnostics();
+    if (!diagnostics)
+        return;
+
+    Diagnostics::Request trace;
+    trace.job = m_job_name;
+    trace.url = m_url.toString();
+    trace.method = method;
+    trace.attempt = m_attempts;
+    auto now = m_clock.now();
+    auto ms = [](auto duration) { return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(); };
+    if (!reply) {
+        trace.started = QDateTime::currentDateTimeUtc();
+        trace.cache = Diagnostics::CacheOutcome::Hit;
+        diagnostics->record(trace);
+        return;
+    }
+    trace.started = QDateTime::currentDateTimeUtc().addMSecs(-ms(now - m_queued_time));
+
+    // the points in time since the request was handed to Qt, which may hold it a bit longer for a connection
+    auto finished = ms(now - m_request_time);
+    auto headers = m_headers_ms >= 0 ? m_headers_ms : finished;
+    qint64 connected = 0;
+    trace.queued = ms(m_request_time - m_queued_time);
+    if (m_connecting_ms >= 0) {
+        trace.queued += m_connecting_ms;
+        connected = m_encrypted_ms >= 0 ? m_encrypted_ms : m_sent_ms >= 0 ? m_sent_ms : headers;
+        trace.connect = qMax<qint64>(0, connected - m_connecting_ms);
+    }
+    auto sent = m_sent_ms >= 0 ? qMax(m_sent_ms, connected) : connected;
+    trace.send = sent - connected;
+    trace.wait = qMax<qint64>(0, headers - sent);
+    trace.receive = qMax<qint64>(0, finished - headers);
+
+    trace.status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    trace.statusText = QString::fromLatin1(reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toByteArray());
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    trace.httpVersion = reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool() ? "HTTP/2" : "HTTP/1.1";
+#endif
+    trace.mimeType = reply->header(QNetworkRequest::ContentTypeHeader).toString();
+    trace.redirect = QString::fromUtf8(reply->rawHeader("Location"));
+    trace.bytes = bytes;
+    for (auto& header : reply->rawHeaderPairs()) {
+        if (header.first.compare("Set-Cookie", Qt::CaseInsensitive) != 0)
+            trace.headers.append(header);
+    }
+    if (m_sink->isCache())
+        trace.cache = trace.status == 304 ? Diagnostics::CacheOutcome::Revalidated : Diagnostics::CacheOutcome::Miss;
+    // what the network said is the closer one to the cause
+    trace.error = reply->error() != QNetworkReply::NoError ? reply->errorString() : error;
+    diagnostics->record(trace);
+}
+
+void Download::releaseHostSlot()
+{
+    if (!m_holds_host_slot)
+        return;
+
+    m_holds_host_slot = false;
+    APPLICATION->hostPool()->release(m_host_slot);
+}
+
 void Download::downloadFinished()
 {
+    releaseHostSlot();
+    if (m_waiting_for_bandwidth) {
+        m_waiting_for_bandwidth = false;
+        disconnect(APPLICATION->hostPool().get(), &HostPool::bandwidthAvailable, this, &Download::bandwidthAvailable);
+    }
+
     // handle HTTP redirection first
     if (handleRedirect()) {
         qCDebug(taskDownloadLogC) << getUid().toString() << "Download redirected:" << m_url.toString();
@@ -281,24 +805,38 @@ void Download::downloadFinished()
     if (m_state == State::Succeeded)  // pretend to succeed so we continue processing :)
     {
         qCDebug(taskDownloadLogC) << getUid().toString() << "Download failed but we are allowed to proceed:" << m_url.toString();
+        recordTrace(m_reply.get(), "GET", m_received);
         m_sink->abort();
         m_reply.reset();
         emit succeeded();
         return;
     } else if (m_state == State::Failed) {
         qCDebug(taskDownloadLogC) << getUid().toString() << "Download failed in previous step:" << m_url.toString();
+        recordTrace(m_reply.get(), "GET", m_received, tr("The reply couldn't be taken"));
         m_sink->abort();
         m_reply.reset();
-        emit failed("");
+        if (!failOver())
+            emit failed("");
         return;
     } else if (m_state == State::AbortedByUser) {
         qCDebug(taskDownloadLogC) << getUid().toString() << "Download aborted in previous step:" << m_url.toString();
+        recordTrace(m_reply.get(), "GET", m_received, tr("Aborted"));
         m_sink->abort();
         m_reply.reset();
         emit aborted();
         return;
     }
 
+    if (m_sink->headersReceived(*m_reply) == State::Failed) {
+        qCDebug(taskDownloadLogC) << getUid().toString() << "Download failed when checking the reply:" << m_url.toString();
+        recordTrace(m_reply.get(), "GET", m_received, tr("The reply was turned down"));
+        m_sink->abort();
+        m_reply.reset();
+        if (!failOver())
+            emit failed("");
+        return;
+    }
+
     // make sure we got all the remaining data, if any
     auto data = m_reply->readAll();
     if (data.size()) {
@@ -310,21 +848,52 @@ void Download::downloadFinished()
     m_state = m_sink->finalize(*m_reply.get());
     if (m_state != State::Succeeded) {
         qCDebug(taskDownloadLogC) << getUid().toString() << "Download failed to finalize:" << m_url.toString();
+        recordTrace(m_reply.get(), "GET", m_received, tr("The file couldn't be saved, or didn't validate"));
         m_sink->abort();
         m_reply.reset();
-        emit failed("");
+        if (!failOver())
+            emit failed("");
         return;
     }
 
+    recordTrace(m_reply.get(), "GET", m_received);
     m_reply.reset();
+    if (m_mirror_kind && !m_peer_urls.contains(m_mirror_url)) {
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(m_clock.now() - m_request_time).count();
+        APPLICATION->mirrors()->reportSuccess(m_mirror_url, m_latency_ms < 0 ? elapsed_ms : m_latency_ms, m_received, elapsed_ms);
+    }
     qCDebug(taskDownloadLogC) << getUid().toString() << "Download succeeded:" << m_url.toString();
+    if (m_sink->changedContent())
+        emit contentChanged();
     emit succeeded();
 }
 
 void Download::downloadReadyRead()
 {
+    if (m_latency_ms < 0)
+        m_latency_ms = std::chrono::duration_cast<std::chrono::milliseconds>(m_clock.now() - m_request_time).count();
     if (m_state == State::Running) {
-        auto data = m_reply->readAll();
+        m_state = m_sink->headersReceived(*m_reply);
+        if (m_state == State::Failed) {
+            qCCritical(taskDownloadLogC) << getUid().toString() << "Failed to process the reply headers";
+            return;
+        }
+
+        auto pool = APPLICATION->hostPool();
+        auto available = m_reply->bytesAvailable();
+        auto allowed = pool->takeBandwidth(available, m_priority);
+        if (allowed < available) {
+            // the rest stays in the reply until the budget refills
+            if (!m_waiting_for_bandwidth) {
+                m_waiting_for_bandwidth = true;
+                connect(pool.get(), &HostPool::bandwidthAvailable, this, &Download::bandwidthAvailable);
+            }
+            pool->waitForBandwidth();
+        }
+        if (allowed <= 0)
+            return;
+
+        auto data = m_reply->read(allowed);
         m_state = m_sink->write(data);
         if (m_state == State::Failed) {
             qCCritical(taskDownloadLogC) << getUid().toString() << "Failed to process response chunk";
@@ -335,14 +904,30 @@ void Download::downloadReadyRead()
     }
 }
 
+void Download::bandwidthAvailable()
+{
+    m_waiting_for_bandwidth = false;
+    disconnect(APPLICATION->hostPool().get(), &HostPool::bandwidthAvailable, this, &Download::bandwidthAvailable);
+    if (m_reply && m_reply->bytesAvailable() > 0)
+        downloadReadyRead();
+}
+
 }  // namespace Net
 
 auto Net::Download::abort() -> bool
 {
-    if (m_reply) {
-        m_reply->abort();
-    } else {
+    if (!m_segments.empty()) {
         m_state = State::AbortedByUser;
+        abortSegments();
+        return true;
     }
+    if (m_probe) {
+        m_state = State::AbortedByUser;
+        m_probe->abort();
+        return true;
+    }
+    m_state = State::AbortedByUser;
+    if (m_reply)
+        m_reply->abort();
     return true;
 }
@@ -38,9 +38,17 @@
 
 #pragma once
 
+#include <QCryptographicHash>
+#include <QSet>
+
 #include <chrono>
+#include <memory>
+#include <optional>
+#include <vector>
 
+#include "Diagnostics.h"
 #include "HttpMetaCache.h"
+#include "MirrorList.h"
 #include "NetAction.h"
 #include "Sink.h"
 #include "Validator.h"
@@ -53,23 +61,92 @@ class Download : public NetAction {
 
    public:
     using Ptr = shared_qobject_ptr<class Download>;
-    enum class Option { NoOptions = 0, AcceptLocalFiles = 1, MakeEternal = 2 };
+    /**
+     * Segmented: when the file turns out to be big (see s_segment_threshold) and the server takes ranges, it comes in
+     * several parts at once, over connections of their own. Finds out with a HEAD request first, so only for files that
+     * may be big.
+     *
+     * KeepHashes: for makeStored(), computes every hash a mod platform may ask for while the file comes in, and puts
+     * them in the hash cache (see Hashing::rememberHashes()), so a downloaded mod never needs to be hashed again.
+     *
+     * Direct: for makeFile(), writes the file in place rather than through a temporary file (see FileSink::setDirect()),
+     * for the many small files that are checked by their hash and size, like the asset objects.
+     *
+     * Preallocate: reserves the room for the file on the disk once its size is known, implied by Segmented.
+     */
+    enum class Option {
+        NoOptions = 0,
+        AcceptLocalFiles = 1,
+        MakeEternal = 2,
+        Resumable = 4,
+        Segmented = 8,
+        KeepHashes = 16,
+        Direct = 32,
+        Preallocate = 64,
+    };
     Q_DECLARE_FLAGS(Options, Option)
 
+    static constexpr qint64 s_segment_threshold = 32 * 1024 * 1024;
+
    public:
-    ~Download() override = default;
+    ~Download() override;
 
     static auto makeCached(QUrl url, MetaEntryPtr entry, Options options = Option::NoOptions) -> Download::Ptr;
     static auto makeByteArray(QUrl url, QByteArray* output, Options options = Option::NoOptions) -> Download::Ptr;
     static auto makeFile(QUrl url, QString path, Options options = Option::NoOptions) -> Download::Ptr;
+    /**
+     * Like makeFile, but goes through the shared content store when it's enabled. The hash is also validated, and the
+     * launchers on the LAN that share their store are asked for the file first (see PeerCache).
+     */
+    static auto makeStored(QUrl url,
+                           QString path,
+                           QCryptographicHash::Algorithm algorithm,
+                           QByteArray hash,
+                           Options options = Option::NoOptions) -> Download::Ptr;
+    /** Same as above, with a hex-encoded hash named like the mod platforms do ("sha1", "sha512", ...). */
+    static auto makeStored(QUrl url, QString path, QString hash_type, QString hash, Options options = Option::NoOptions) -> Download::Ptr;
 
    public:
     void addValidator(Validator* v);
+    /**
+     * Downloads from the mirrors of `kind` (see MirrorList::route()) when the URL is under its official base, the best
+     * one first. When one fails or times out, the next one is tried right away, and the MirrorList is told how they did.
+     */
+    void routeThroughMirrors(MirrorList::Kind kind);
+
+   signals:
+    /**
+     * Right before succeeded(), when the download got something else than what was there already. Not emitted for
+     * cache hits, nor when the server said the cached copy is still current, so a copy that was used while it got
+     * revalidated has to be looked at again only then.
+     */
+    void contentChanged();
+
+   public:
     auto abort() -> bool override;
     auto canAbort() const -> bool override { return true; };
 
    private:
+    void startDownload();
+    auto failOver() -> bool;
     auto handleRedirect() -> bool;
+    void keepHashes(const QString& path, QCryptographicHash::Algorithm algorithm, QByteArray expected);
+
+    void startRequest(QNetworkRequest request);
+    void releaseHostSlot();
+    void bandwidthAvailable();
+
+    void watchTimings(QNetworkReply* reply);
+    /** Tells the Diagnostics about the request `reply` was for, or about a cache hit without it. */
+    void recordTrace(QNetworkReply* reply, const QString& method, qint64 bytes, const QString& error = {});
+
+    void startProbe(QNetworkRequest request);
+    void probeFinished();
+    void startSegment(std::size_t index);
+    void segmentReadyRead(std::size_t index);
+    void segmentFinished(std::size_t index);
+    void segmentDone();
+    void abortSegments();
 
    protected slots:
     void downloadProgress(qint64 bytesReceived, qint64 bytesTotal) override;
@@ -88,6 +165,52 @@ class Download : public NetAction {
     std::chrono::steady_clock m_clock;
     std::chrono::time_point<std::chrono::steady_clock> m_last_progress_time;
     qint64 m_last_progress_bytes;
+
+    /// host whose slot in the HostPool we are holding (or waiting for)
+    QString m_host_slot;
+    bool m_holds_host_slot = false;
+    /// whether some of the reply is left to be read once the bandwidth budget allows it
+    bool m_waiting_for_bandwidth = false;
+
+    std::optional<MirrorList::Kind> m_mirror_kind;
+    /// the URL it was made with, which the peers and mirrors are picked for again on each attempt
+    QUrl m_origin;
+    /// the peer or mirror being tried (m_url changes with redirects), and the ones to try after it
+    QUrl m_mirror_url;
+    QList<QUrl> m_routes;
+    /// what the LAN peers know the file by (see PeerCache), and the routes that go to them
+    QCryptographicHash::Algorithm m_peer_algorithm = QCryptographicHash::Sha1;
+    QByteArray m_peer_hash;
+    QSet<QUrl> m_peer_urls;
+    std::chrono::time_point<std::chrono::steady_clock> m_request_time;
+    qint64 m_latency_ms = -1;
+    qint64 m_received = 0;
+
+    /// for the Diagnostics: when the download started waiting for a slot, how many tries it's at, and when the
+    /// request got a connection, was sent and got its headers (in ms since m_request_time, -1 when it didn't)
+    std::chrono::time_point<std::chrono::steady_clock> m_queued_time;
+    int m_attempts = 0;
+    qint64 m_connecting_ms = -1;
+    qint64 m_encrypted_ms = -1;
+    qint64 m_sent_ms = -1;
+    qint64 m_headers_ms = -1;
+    std::chrono::time_point<std::chrono::steady_clock> m_segments_time;
+
+    struct Segment {
+        qint64 start = 0;
+        // inclusive, like in the Range header
+        qint64 end = 0;
+        qint64 received = 0;
+        unique_qobject_ptr<QNetworkReply> reply;
+        bool holds_host_slot = false;
+    };
+    /// the HEAD request that tells whether to go with segments, its headers are the ones of the file they make up
+    unique_qobject_ptr<QNetworkReply> m_probe;
+    QNetworkRequest m_request;
+    QByteArray m_if_range;
+    std::vector<std::unique_ptr<Segment>> m_segments;
+    std::size_t m_segments_left = 0;
+    qint64 m_segmented_size = 0;
 };
 }  // namespace Net
 
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <memory>
+
+#include "StreamExtractor.h"
+#include "Validator.h"
+
+namespace Net {
+
+/* Hands the downloaded data over to a StreamExtractor as it comes in.
+ *
+ * This never fails the download: when the archive can't be extracted that way, the extractor gives up
+ * and the complete archive is extracted afterwards instead.
+ */
+class ExtractingValidator : public Validator {
+   public:
+    explicit ExtractingValidator(std::shared_ptr<MMCZip::StreamExtractor> extractor) : m_extractor(std::move(extractor)) {}
+    virtual ~ExtractingValidator() = default;
+
+   public:
+    auto init(QNetworkRequest&) -> bool override
+    {
+        // every attempt starts from the first byte again
+        m_extractor->reset();
+        return true;
+    }
+
+    auto write(QByteArray& data) -> bool override
+    {
+        m_extractor->feed(data);
+        return true;
+    }
+
+    auto abort() -> bool override
+    {
+        m_extractor->cancel();
+        return true;
+    }
+
+    auto validate(QNetworkReply&) -> bool override
+    {
+        m_extractor->finish();
+        return true;
+    }
+
+   private:
+    std::shared_ptr<MMCZip::StreamExtractor> m_extractor;
+};
+
+}  // namespace Net
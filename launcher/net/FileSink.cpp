@@ -35,6 +35,9 @@
 
 #include "FileSink.h"
 
+#include <QJsonDocument>
+#include <QJsonObject>
+
 #include "FileSystem.h"
 
 #include "net/Logging.h"
@@ -55,9 +58,17 @@ Task::State FileSink::init(QNetworkRequest& request)
     }
 
     wroteAnyData = false;
-    m_output_file.reset(new QSaveFile(m_filename));
-    if (!m_output_file->open(QIODevice::WriteOnly)) {
+    if (m_resumable)
+        return initPartFile(request);
+
+    if (m_direct)
+        m_direct_file.reset(new QFile(m_filename));
+    else
+        m_output_file.reset(new QSaveFile(m_filename));
+    if (!output()->open(QIODevice::WriteOnly)) {
         qCCritical(taskNetLogC) << "Could not open " + m_filename + " for writing";
+        m_output_file.reset();
+        m_direct_file.reset();
         return Task::State::Failed;
     }
 
@@ -68,10 +79,23 @@ Task::State FileSink::init(QNetworkRequest& request)
 
 Task::State FileSink::write(QByteArray& data)
 {
-    if (!writeAllValidators(data) || m_output_file->write(data) != data.size()) {
+    if (m_part_file) {
+        // what comes before the headers were checked is the body of a redirect
+        if (!m_checked_response)
+            return Task::State::Running;
+        if (!writeAllValidators(data) || m_part_file->write(data) != data.size()) {
+            qCCritical(taskNetLogC) << "Failed writing into " + partPath();
+            discardPartFile();
+            wroteAnyData = false;
+            return Task::State::Failed;
+        }
+        wroteAnyData = true;
+        return Task::State::Running;
+    }
+
+    if (!writeAllValidators(data) || output()->write(data) != data.size()) {
         qCCritical(taskNetLogC) << "Failed writing into " + m_filename;
-        m_output_file->cancelWriting();
-        m_output_file.reset();
+        discardOutput();
         wroteAnyData = false;
         return Task::State::Failed;
     }
@@ -82,13 +106,24 @@ Task::State FileSink::write(QByteArray& data)
 
 Task::State FileSink::abort()
 {
-    m_output_file->cancelWriting();
+    if (m_part_file) {
+        // keep what we got for the next attempt, if it knows how to check that the file didn't change since
+        m_part_file->close();
+        m_part_file.reset();
+        if (!QFile::exists(partStatePath()))
+            QFile::remove(partPath());
+    } else {
+        discardOutput();
+    }
     failAllValidators();
     return Task::State::Failed;
 }
 
 Task::State FileSink::finalize(QNetworkReply& reply)
 {
+    if (m_part_file)
+        return finalizePartFile(reply);
+
     bool gotFile = false;
     QVariant statusCodeV = reply.attribute(QNetworkRequest::HttpStatusCodeAttribute);
     bool validStatus = false;
@@ -103,23 +138,310 @@ Task::State FileSink::finalize(QNetworkReply& reply)
     if (gotFile || wroteAnyData) {
         // ask validators for data consistency
         // we only do this for actual downloads, not 'your data is still the same' cache hits
-        if (!finalizeAllValidators(reply))
+        if (!finalizeAllValidators(reply)) {
+            discardOutput();
             return Task::State::Failed;
+        }
 
         // nothing went wrong...
-        if (!m_output_file->commit()) {
+        if (!commitOutput()) {
             qCCritical(taskNetLogC) << "Failed to commit changes to " << m_filename;
-            m_output_file->cancelWriting();
+            discardOutput();
             return Task::State::Failed;
         }
+    } else if (m_direct_file) {
+        // what was there was truncated already, an empty file would look like it's there
+        discardOutput();
     }
 
     // then get rid of the save file
     m_output_file.reset();
+    m_direct_file.reset();
+
+    return finalizeCache(reply);
+}
+
+Task::State FileSink::initPartFile(QNetworkRequest& request)
+{
+    m_resume_from = 0;
+    m_checked_response = false;
+
+    // Only continue files we can tell haven't changed on the server since
+    QByteArray if_range;
+    if (QFile::exists(partStatePath())) {
+        QJsonObject state;
+        try {
+            state = QJsonDocument::fromJson(FS::read(partStatePath())).object();
+        } catch (const FS::FileSystemException& e) {
+            qCWarning(taskNetLogC) << "Could not read the download state of" << m_filename << ":" << e.cause();
+        }
+        if (state.value("url").toString() == request.url().toString()) {
+            if_range = state.value("etag").toString().toLatin1();
+            if (if_range.isEmpty())
+                if_range = state.value("last_modified").toString().toLatin1();
+        }
+    }
+    QFileInfo part(partPath());
+    if (!if_range.isEmpty() && part.isFile() && part.size() > 0)
+        m_resume_from = part.size();
+
+    // Nothing is truncated before the server answers: a redirect, or a new attempt failing before that, shouldn't lose the file
+    m_part_file.reset(new QFile(partPath()));
+    if (!m_part_file->open(QIODevice::Append)) {
+        qCCritical(taskNetLogC) << "Could not open " + partPath() + " for writing";
+        m_part_file.reset();
+        return Task::State::Failed;
+    }
+
+    if (!initAllValidators(request)) {
+        discardPartFile();
+        return Task::State::Failed;
+    }
+
+    if (m_resume_from > 0) {
+        // QCryptographicHash can't save its state, so the validators get to see what we already have again
+        QFile kept(partPath());
+        if (!kept.open(QIODevice::ReadOnly)) {
+            discardPartFile();
+            return Task::State::Failed;
+        }
+        while (!kept.atEnd()) {
+            auto chunk = kept.read(1024 * 1024);
+            if (!writeAllValidators(chunk)) {
+                discardPartFile();
+                return Task::State::Failed;
+            }
+        }
+
+        qCDebug(taskNetLogC) << "Resuming" << request.url().toString() << "from byte" << m_resume_from;
+        request.setRawHeader("Range", "bytes=" + QByteArray::number(m_resume_from) + "-");
+        request.setRawHeader("If-Range", if_range);
+    }
+
+    return Task::State::Running;
+}
+
+Task::State FileSink::headersReceived(QNetworkReply& reply)
+{
+    int status_code = reply.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    auto length = reply.header(QNetworkRequest::ContentLengthHeader).toLongLong();
+    if (!m_part_file) {
+        if (m_preallocate && output() && status_code == 200)
+            FS::preallocate(*output(), length);
+        return Task::State::Running;
+    }
+    if (m_checked_response)
+        return Task::State::Running;
+
+    // redirects are followed with another request
+    if (status_code >= 300 && status_code < 400 && status_code != 304)
+        return Task::State::Running;
+    m_checked_response = true;
+
+    if (status_code == 416) {
+        // what we kept doesn't fit the file anymore
+        discardPartFile();
+        return Task::State::Failed;
+    }
+
+    if (m_resume_from > 0 && status_code != 206 && status_code != 304) {
+        // the file changed since (or the server ignores ranges), so it's coming from the start
+        qCDebug(taskNetLogC) << "Could not resume" << reply.url().toString() << ", starting over";
+        m_resume_from = 0;
+        QNetworkRequest request(reply.request());
+        if (!initAllValidators(request)) {
+            discardPartFile();
+            return Task::State::Failed;
+        }
+    }
+    if (m_resume_from == 0 && !m_part_file->resize(0)) {
+        qCCritical(taskNetLogC) << "Could not truncate " + partPath();
+        discardPartFile();
+        return Task::State::Failed;
+    }
+
+    if (status_code == 200 || status_code == 206) {
+        if (m_preallocate)
+            FS::preallocate(*m_part_file, m_resume_from + length);
+        writePartState(reply);
+    }
+    return Task::State::Running;
+}
+
+void FileSink::writePartState(QNetworkReply& reply)
+{
+    // Weak ETags can't be used for ranges
+    auto etag = reply.rawHeader("ETag");
+    if (etag.startsWith("W/"))
+        etag.clear();
+    auto last_modified = reply.rawHeader("Last-Modified");
+    if (etag.isEmpty() && last_modified.isEmpty()) {
+        QFile::remove(partStatePath());
+        return;
+    }
+
+    QJsonObject state;
+    state.insert("url", reply.request().url().toString());
+    state.insert("etag", QString::fromLatin1(etag));
+    state.insert("last_modified", QString::fromLatin1(last_modified));
+    try {
+        FS::write(partStatePath(), QJsonDocument(state).toJson(QJsonDocument::Compact));
+    } catch (const FS::FileSystemException& e) {
+        qCWarning(taskNetLogC) << "Could not save the download state of" << m_filename << ":" << e.cause();
+    }
+}
+
+Task::State FileSink::finalizePartFile(QNetworkReply& reply)
+{
+    int status_code = reply.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    bool gotFile = status_code == 200 || status_code == 203 || status_code == 206;
+
+    if (!gotFile && !wroteAnyData) {
+        // nothing new, like a 304 Not Modified
+        discardPartFile();
+        return finalizeCache(reply);
+    }
+
+    if (!finalizeAllValidators(reply)) {
+        // don't try to continue a file that turned out bad
+        discardPartFile();
+        return Task::State::Failed;
+    }
+
+    m_part_file->close();
+    m_part_file.reset();
+    if ((QFile::exists(m_filename) && !QFile::remove(m_filename)) || !QFile::rename(partPath(), m_filename)) {
+        qCCritical(taskNetLogC) << "Failed to move " << partPath() << " to " << m_filename;
+        discardPartFile();
+        return Task::State::Failed;
+    }
+    QFile::remove(partStatePath());
 
     return finalizeCache(reply);
 }
 
+Task::State FileSink::beginSegments(qint64 size)
+{
+    if (m_resume_from > 0)
+        return Task::State::Failed;
+
+    // The part file can't tell which of its segments are complete, so it's not kept for a later attempt
+    discardOutput();
+    m_part_file.reset();
+    QFile::remove(partStatePath());
+
+    m_part_file.reset(new QFile(partPath()));
+    if (!m_part_file->open(QIODevice::ReadWrite | QIODevice::Truncate) || !m_part_file->resize(size)) {
+        qCCritical(taskNetLogC) << "Could not allocate " + partPath();
+        discardPartFile();
+        return Task::State::Failed;
+    }
+    // resizing leaves a sparse file, that the segments would fill in pieces
+    if (m_preallocate)
+        FS::preallocate(*m_part_file, size);
+    m_checked_response = true;
+    m_written.clear();
+    m_validated = 0;
+    return Task::State::Running;
+}
+
+Task::State FileSink::writeAt(qint64 offset, QByteArray& data)
+{
+    if (!m_part_file || !m_part_file->seek(offset) || m_part_file->write(data) != data.size()) {
+        qCCritical(taskNetLogC) << "Failed writing into " + partPath();
+        discardPartFile();
+        wroteAnyData = false;
+        return Task::State::Failed;
+    }
+    wroteAnyData = true;
+
+    // every segment comes in order, so it continues one of the parts, or starts one
+    auto end = offset + data.size();
+    auto part = m_written.end();
+    for (auto it = m_written.begin(); it != m_written.end(); ++it) {
+        if (it.value() == offset) {
+            part = it;
+            break;
+        }
+    }
+    if (part == m_written.end())
+        part = m_written.insert(offset, end);
+    else
+        part.value() = end;
+    auto next = m_written.find(end);
+    if (next != m_written.end()) {
+        part.value() = next.value();
+        m_written.erase(next);
+    }
+
+    // the validators see the file in order, as soon as everything before a part is in
+    auto contiguous = m_written.value(0, 0);
+    if (contiguous <= m_validated)
+        return Task::State::Running;
+    if (offset == m_validated && contiguous == end) {
+        m_validated = end;
+        if (!writeAllValidators(data)) {
+            discardPartFile();
+            return Task::State::Failed;
+        }
+        return Task::State::Running;
+    }
+    if (!m_part_file->seek(m_validated)) {
+        discardPartFile();
+        return Task::State::Failed;
+    }
+    while (m_validated < contiguous) {
+        auto chunk = m_part_file->read(qMin<qint64>(1024 * 1024, contiguous - m_validated));
+        if (chunk.isEmpty() || !writeAllValidators(chunk)) {
+            discardPartFile();
+            return Task::State::Failed;
+        }
+        m_validated += chunk.size();
+    }
+    return Task::State::Running;
+}
+
+QFileDevice* FileSink::output() const
+{
+    if (m_direct_file)
+        return m_direct_file.get();
+    return m_output_file.get();
+}
+
+bool FileSink::commitOutput()
+{
+    if (m_output_file)
+        return m_output_file->commit();
+    if (!m_direct_file->flush())
+        return false;
+    m_direct_file->close();
+    return m_direct_file->error() == QFileDevice::NoError;
+}
+
+void FileSink::discardOutput()
+{
+    if (m_output_file) {
+        m_output_file->cancelWriting();
+        m_output_file.reset();
+    }
+    if (m_direct_file) {
+        m_direct_file->close();
+        m_direct_file->remove();
+        m_direct_file.reset();
+    }
+}
+
+void FileSink::discardPartFile()
+{
+    if (m_part_file) {
+        m_part_file->close();
+        m_part_file.reset();
+    }
+    QFile::remove(partPath());
+    QFile::remove(partStatePath());
+    m_resume_from = 0;
+}
+
 Task::State FileSink::initCache(QNetworkRequest&)
 {
     return Task::State::Running;
@@ -35,6 +35,7 @@
 
 #pragma once
 
+#include <QMap>
 #include <QSaveFile>
 
 #include "Sink.h"
@@ -51,15 +52,60 @@ class FileSink : public Sink {
     auto abort() -> Task::State override;
     auto finalize(QNetworkReply& reply) -> Task::State override;
 
+    auto headersReceived(QNetworkReply& reply) -> Task::State override;
+
     auto hasLocalData() -> bool override;
 
+    auto canWriteSegments() -> bool override { return m_resume_from == 0; }
+    auto beginSegments(qint64 size) -> Task::State override;
+    auto writeAt(qint64 offset, QByteArray& data) -> Task::State override;
+
+    /** Downloads into a ".part" file kept when the download fails, so that the next attempt can pick up where
+     *  this one stopped with a Range request. Only for big files: validators see the kept part again on resume.
+     */
+    void setResumable(bool resumable) { m_resumable = resumable; }
+    /** Writes the file in place instead of into a temporary file renamed over it, which costs more than the writing
+     *  itself for small files. Only for files whose size tells they're complete and that a validator checks, like the
+     *  asset objects: the file is removed when the download fails, but not if the launcher doesn't get to do it.
+     */
+    void setDirect(bool direct) { m_direct = direct; }
+    /** Reserves the room for the file on the disk once the server said how big it is, for big files. */
+    void setPreallocate(bool preallocate) { m_preallocate = preallocate; }
+
    protected:
     virtual auto initCache(QNetworkRequest&) -> Task::State;
     virtual auto finalizeCache(QNetworkReply& reply) -> Task::State;
 
+   private:
+    auto initPartFile(QNetworkRequest& request) -> Task::State;
+    auto finalizePartFile(QNetworkReply& reply) -> Task::State;
+    void discardPartFile();
+    void writePartState(QNetworkReply& reply);
+    QFileDevice* output() const;
+    bool commitOutput();
+    void discardOutput();
+
+    QString partPath() const { return m_filename + ".part"; }
+    QString partStatePath() const { return m_filename + ".part.json"; }
+
    protected:
     QString m_filename;
     bool wroteAnyData = false;
     std::unique_ptr<QSaveFile> m_output_file;
+
+   private:
+    bool m_resumable = false;
+    bool m_direct = false;
+    bool m_preallocate = false;
+    /// instead of m_output_file, when writing in place
+    std::unique_ptr<QFile> m_direct_file;
+    std::unique_ptr<QFile> m_part_file;
+    /// size of the part file kept from a previous attempt, that this one continues
+    qint64 m_resume_from = 0;
+    bool m_checked_response = false;
+
+    /// for segments: start -> end of the parts of the file that are in, and up to where the validators saw it
+    QMap<qint64, qint64> m_written;
+    qint64 m_validated = 0;
 };
 }  // namespace Net
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "HostPool.h"
+
+#include <algorithm>
+
+namespace Net {
+
+HostPool::HostPool(QObject* parent) : QObject(parent)
+{
+    m_bandwidth_clock.start();
+    m_bandwidth_timer.setSingleShot(true);
+    connect(&m_bandwidth_timer, &QTimer::timeout, this, &HostPool::bandwidthAvailable);
+}
+
+void HostPool::setMaxPerHost(int max)
+{
+    m_max_per_host = qMax(1, max);
+
+    // Raising the limit should take effect right away for the requests already waiting
+    for (auto const& host : m_waiting.keys())
+        startWaiting(host);
+}
+
+void HostPool::acquire(const QString& host, QObject* context, std::function<void()> start, Priority priority)
+{
+    emit hostRequested(host);
+    if (m_in_flight.value(host) < m_max_per_host && !m_waiting.contains(host)) {
+        m_in_flight[host] += 1;
+        start();
+        return;
+    }
+
+    m_waiting[host][static_cast<int>(priority)].enqueue({ context, std::move(start) });
+}
+
+void HostPool::release(const QString& host)
+{
+    auto it = m_in_flight.find(host);
+    if (it == m_in_flight.end())
+        return;
+
+    if (--it.value() <= 0)
+        m_in_flight.erase(it);
+
+    startWaiting(host);
+}
+
+void HostPool::startWaiting(const QString& host)
+{
+    // NOTE: Starting a request may re-enter acquire() / release(), so look the queues up again every time.
+    while (m_in_flight.value(host) < m_max_per_host) {
+        auto it = m_waiting.find(host);
+        if (it == m_waiting.end())
+            return;
+
+        auto queue = std::find_if(it->begin(), it->end(), [](const QQueue<Waiter>& waiting) { return !waiting.isEmpty(); });
+        if (queue == it->end()) {
+            m_waiting.erase(it);
+            return;
+        }
+
+        auto waiter = queue->dequeue();
+        if (!waiter.context)
+            continue;
+
+        m_in_flight[host] += 1;
+        waiter.start();
+    }
+}
+
+void HostPool::setBandwidthLimit(qint64 bytes_per_second)
+{
+    m_bandwidth_limit = qMax<qint64>(0, bytes_per_second);
+    m_bandwidth_budget = m_bandwidth_limit;
+    m_bandwidth_clock.start();
+
+    // Downloads waiting for the previous budget can go on with the new one
+    if (m_bandwidth_timer.isActive()) {
+        m_bandwidth_timer.stop();
+        emit bandwidthAvailable();
+    }
+}
+
+void HostPool::refillBandwidth()
+{
+    auto elapsed = m_bandwidth_clock.restart();
+    // At most a second worth of budget, so idling doesn't let a burst through
+    m_bandwidth_budget = qMin(m_bandwidth_limit, m_bandwidth_budget + m_bandwidth_limit * elapsed / 1000);
+}
+
+qint64 HostPool::takeBandwidth(qint64 wanted, Priority priority)
+{
+    if (m_bandwidth_limit <= 0)
+        return wanted;
+
+    refillBandwidth();
+
+    auto allowed = priority == Priority::Interactive ? wanted : qBound<qint64>(0, m_bandwidth_budget, wanted);
+    // The budget can go below zero because of interactive requests, but not by more than a second worth of it
+    m_bandwidth_budget = qMax(-m_bandwidth_limit, m_bandwidth_budget - allowed);
+    return allowed;
+}
+
+void HostPool::waitForBandwidth()
+{
+    if (m_bandwidth_timer.isActive())
+        return;
+
+    // Often enough for the downloads to look smooth, rarely enough not to wake everything up all the time
+    m_bandwidth_timer.start(50);
+}
+
+}  // namespace Net
@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QTimer>
+
+#include <array>
+#include <functional>
+
+namespace Net {
+
+/** How urgently a request is needed, from the most to the least. */
+enum class Priority {
+    Interactive,  //!< Something the user is looking at right now: search results, icons, ...
+    Launch,       //!< Needed before something can go on, like launching or installing an instance
+    Background,   //!< Nobody is waiting for it: news, translations, ...
+};
+
+/** Schedules the requests of every NetJob, application-wide.
+ *
+ *  QNetworkAccessManager already keeps a connection pool per host (and multiplexes
+ *  requests over a single connection when HTTP/2 is negotiated), so this only decides
+ *  how many requests we hand over to it at once for any given host, and in which order:
+ *  when a host is busy, the waiting requests with the highest priority go first.
+ *
+ *  It also holds the optional download bandwidth budget, shared by every download.
+ */
+class HostPool : public QObject {
+    Q_OBJECT
+   public:
+    explicit HostPool(QObject* parent = nullptr);
+    ~HostPool() override = default;
+
+    void setMaxPerHost(int max);
+    [[nodiscard]] int maxPerHost() const { return m_max_per_host; }
+
+    void setHttp2Allowed(bool allowed) { m_http2_allowed = allowed; }
+    [[nodiscard]] bool http2Allowed() const { return m_http2_allowed; }
+
+    /** Calls `start` as soon as `host` has a free slot, which may be right away.
+     *  The request is dropped from the queue if `context` is destroyed while waiting.
+     */
+    void acquire(const QString& host, QObject* context, std::function<void()> start, Priority priority = Priority::Launch);
+
+    /** Gives back a slot obtained through acquire(), starting the next waiting request for that host. */
+    void release(const QString& host);
+
+    [[nodiscard]] int inFlight(const QString& host) const { return m_in_flight.value(host); }
+
+    /** Limits how fast all the downloads together may go, in bytes per second. 0 means no limit. */
+    void setBandwidthLimit(qint64 bytes_per_second);
+    [[nodiscard]] qint64 bandwidthLimit() const { return m_bandwidth_limit; }
+
+    /** Takes up to `wanted` bytes out of the bandwidth budget, returning how many may be read right away.
+     *  Interactive requests are small and someone is waiting on them, so they always get everything they
+     *  want, but it still counts against the budget of the others.
+     */
+    qint64 takeBandwidth(qint64 wanted, Priority priority);
+
+    /** Makes sure bandwidthAvailable() is emitted once the budget refills a bit. */
+    void waitForBandwidth();
+
+   signals:
+    void bandwidthAvailable();
+    /** Whenever a request for `host` comes in, before it waits for a slot. */
+    void hostRequested(const QString& host);
+
+   private:
+    void startWaiting(const QString& host);
+    void refillBandwidth();
+
+   private:
+    struct Waiter {
+        QPointer<QObject> context;
+        std::function<void()> start;
+    };
+    // one queue per priority
+    using Queues = std::array<QQueue<Waiter>, 3>;
+
+    int m_max_per_host = 6;
+    bool m_http2_allowed = true;
+
+    QHash<QString, int> m_in_flight;
+    QHash<QString, Queues> m_waiting;
+
+    qint64 m_bandwidth_limit = 0;
+    qint64 m_bandwidth_budget = 0;
+    QElapsedTimer m_bandwidth_clock;
+    QTimer m_bandwidth_timer;
+};
+
+}  // namespace Net
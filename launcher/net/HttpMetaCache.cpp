@@ -35,17 +35,97 @@
 
 #include "HttpMetaCache.h"
 #include "FileSystem.h"
+#include "GZip.h"
 #include "Json.h"
+#include "MemoryAccounting.h"
 
 #include <QCryptographicHash>
+#include <QDataStream>
 #include <QDateTime>
 #include <QFile>
 #include <QFileInfo>
+#include <QFutureWatcher>
+#include <QSaveFile>
+#include <QtConcurrent>
 
 #include <QDebug>
 
+#include "FileLease.h"
 #include "net/Logging.h"
 
+/* The index is an append-only log of records:
+ *
+ *   header: quint32 magic, quint32 version
+ *   record: quint8 op, QString base, QString path [, QByteArray entry if op == Upsert]
+ *
+ * Later records override earlier ones for the same entry. The entry payload is only
+ * deserialized when somebody asks for it, and the whole log is rewritten from scratch
+ * once it has grown too much compared to the number of live entries.
+ *
+ * Launchers that share a data directory also share the log. It is only written while holding a
+ * lease on it, after reading in what the others wrote to it in the meantime.
+ */
+namespace {
+constexpr quint32 s_index_magic = 0x4d434958;  // "MCIX"
+constexpr quint32 s_index_version = 1;
+constexpr auto s_stream_version = QDataStream::Qt_5_12;
+
+enum class IndexOp : quint8 { Upsert = 1, Remove = 2 };
+
+// don't bother compacting small logs
+constexpr int s_min_compaction_records = 1024;
+
+QString binaryIndexPath(const QString& index_file)
+{
+    return index_file + ".bin";
+}
+
+// reads the file a bit at a time, libraries can be large
+QString fileMD5(const QString& path)
+{
+    QFile input(path);
+    if (!input.open(QIODevice::ReadOnly))
+        return {};
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    QByteArray buffer(64 * 1024, Qt::Uninitialized);
+    qint64 read;
+    while ((read = input.read(buffer.data(), buffer.size())) > 0)
+        hash.addData(QByteArray::fromRawData(buffer.constData(), static_cast<int>(read)));
+    if (read < 0)
+        return {};
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+// what validateEntries() knows about an entry, and what it found out about its file
+struct EntryCheck {
+    QString resource_path;
+    QString real_path;
+    MetaEntryPtr entry;
+    qint64 local_changed_timestamp = 0;
+    QString md5sum;
+
+    enum class Result { Unchanged, Rehashed, Stale } result = Result::Unchanged;
+    qint64 file_last_changed = 0;
+};
+
+EntryCheck checkEntryFile(const EntryCheck& original)
+{
+    auto check = original;
+    QFileInfo finfo(check.real_path);
+    if (!finfo.isFile() || !finfo.isReadable()) {
+        check.result = EntryCheck::Result::Stale;
+        return check;
+    }
+    check.file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
+    if (check.file_last_changed == check.local_changed_timestamp) {
+        check.result = EntryCheck::Result::Unchanged;
+        return check;
+    }
+    check.result = fileMD5(check.real_path) == check.md5sum ? EntryCheck::Result::Rehashed : EntryCheck::Result::Stale;
+    return check;
+}
+}  // namespace
+
 auto MetaEntry::getFullPath() -> QString
 {
     // FIXME: make local?
@@ -58,6 +138,22 @@ HttpMetaCache::HttpMetaCache(QString path) : QObject(), m_index_file(path)
     saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
 
     connect(&saveBatchingTimer, &QTimer::timeout, this, &HttpMetaCache::SaveNow);
+
+    // the entries nobody asked for yet are still in the form they have in the index
+    MemoryAccounting::track(this, "Download cache index", [this] {
+        MemoryAccounting::Usage usage;
+        for (auto& map : m_entries) {
+            usage.items += map.entry_list.size() + map.raw_entries.size();
+            for (auto& entry : map.entry_list) {
+                usage.bytes += qint64(sizeof(MetaEntry)) + MemoryAccounting::bytesOf(entry->m_relativePath) +
+                               MemoryAccounting::bytesOf(entry->m_md5sum) + MemoryAccounting::bytesOf(entry->m_etag) +
+                               MemoryAccounting::bytesOf(entry->m_remote_changed_timestamp);
+            }
+            for (auto& raw : map.raw_entries)
+                usage.bytes += MemoryAccounting::bytesOf(raw);
+        }
+        return usage;
+    });
 }
 
 HttpMetaCache::~HttpMetaCache()
@@ -79,10 +175,42 @@ auto HttpMetaCache::getEntry(QString base, QString resource_path) -> MetaEntryPt
         return map.entry_list[resource_path];
     }
 
-    return {};
+    auto raw = map.raw_entries.find(resource_path);
+    if (raw == map.raw_entries.end())
+        return {};
+
+    QDataStream in(raw.value());
+    in.setVersion(s_stream_version);
+
+    auto foo = new MetaEntry();
+    foo->m_baseId = base;
+    foo->m_relativePath = resource_path;
+
+    in >> foo->m_md5sum >> foo->m_etag >> foo->m_local_changed_timestamp >> foo->m_remote_changed_timestamp >> foo->m_is_eternal >>
+        foo->m_current_age >> foo->m_max_age;
+    // records written before the entries knew when they were used end here
+    if (!in.atEnd())
+        in >> foo->m_last_used;
+    else
+        foo->m_last_used = foo->m_local_changed_timestamp / 1000;
+    map.raw_entries.erase(raw);
+
+    if (in.status() != QDataStream::Ok) {
+        qCWarning(taskHttpMetaCacheLogC) << "Dropping corrupted cache entry" << base << resource_path;
+        delete foo;
+        markDirty(base, resource_path);
+        return {};
+    }
+
+    // presumed innocent until closer examination
+    foo->m_stale = false;
+
+    auto entry = MetaEntryPtr(foo);
+    map.entry_list.insert(resource_path, entry);
+    return entry;
 }
 
-auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString expected_etag) -> MetaEntryPtr
+auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString expected_etag, qint64 max_stale) -> MetaEntryPtr
 {
     auto entry = getEntry(base, resource_path);
     // it's not present? generate a default stale entry
@@ -98,44 +226,113 @@ auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString ex
     if (!finfo.isFile() || !finfo.isReadable()) {
         // if the file doesn't exist, we disown the entry
         selected_base.entry_list.remove(resource_path);
+        markDirty(base, resource_path);
         return staleEntry(base, resource_path);
     }
 
     if (!expected_etag.isEmpty() && expected_etag != entry->m_etag) {
         // if the etag doesn't match expected, we disown the entry
         selected_base.entry_list.remove(resource_path);
+        markDirty(base, resource_path);
         return staleEntry(base, resource_path);
     }
 
     // if the file changed, check md5sum
     qint64 file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
     if (file_last_changed != entry->m_local_changed_timestamp) {
-        QFile input(real_path);
-        input.open(QIODevice::ReadOnly);
-        QString md5sum = QCryptographicHash::hash(input.readAll(), QCryptographicHash::Md5).toHex().constData();
+        QString md5sum = fileMD5(real_path);
         if (entry->m_md5sum != md5sum) {
             selected_base.entry_list.remove(resource_path);
+            markDirty(base, resource_path);
             return staleEntry(base, resource_path);
         }
 
         // md5sums matched... keep entry and save the new state to file
         entry->m_local_changed_timestamp = file_last_changed;
+        markDirty(base, resource_path);
         SaveEventually();
     }
 
     // Get rid of old entries, to prevent cache problems
     auto current_time = QDateTime::currentSecsSinceEpoch();
-    if (entry->isExpired(current_time - ( file_last_changed / 1000 ))) {
+    auto file_age = current_time - (file_last_changed / 1000);
+    if (entry->isExpired(file_age)) {
+        if (max_stale > 0 && !entry->isExpired(file_age - max_stale)) {
+            // good enough until it's revalidated, with the ETag and Last-Modified it came with
+            entry->m_basePath = getBasePath(base);
+            entry->m_stale = true;
+            entry->m_usable_while_stale = true;
+            markUsed(*entry);
+            return entry;
+        }
+
         qCWarning(taskNetLogC) << "[HttpMetaCache]" << "Removing cache entry because of old age!";
         selected_base.entry_list.remove(resource_path);
+        markDirty(base, resource_path);
         return staleEntry(base, resource_path);
     }
 
     // entry passed all the checks we cared about.
     entry->m_basePath = getBasePath(base);
+    entry->m_usable_while_stale = false;
+    markUsed(*entry);
     return entry;
 }
 
+void HttpMetaCache::validateEntries(QString base, QStringList resource_paths, QObject* context, std::function<void(QStringList)> done)
+{
+    QList<EntryCheck> checks;
+    if (m_entries.contains(base)) {
+        auto base_path = m_entries[base].base_path;
+        for (auto& resource_path : resource_paths) {
+            // entries we don't have are stale whatever their file looks like
+            auto entry = getEntry(base, resource_path);
+            if (!entry)
+                continue;
+            EntryCheck check;
+            check.resource_path = resource_path;
+            check.real_path = FS::PathCombine(base_path, resource_path);
+            check.entry = entry;
+            check.local_changed_timestamp = entry->m_local_changed_timestamp;
+            check.md5sum = entry->m_md5sum;
+            checks.append(check);
+        }
+    }
+
+    auto watcher = new QFutureWatcher<EntryCheck>(context);
+    connect(watcher, &QFutureWatcher<EntryCheck>::finished, context, [this, base, watcher, done] {
+        QStringList dropped;
+        bool rehashed = false;
+        auto& selected_base = m_entries[base];
+        for (auto& check : watcher->future().results()) {
+            // it was downloaded again (or dropped) while we were looking at the file
+            if (selected_base.entry_list.value(check.resource_path) != check.entry ||
+                check.entry->m_local_changed_timestamp != check.local_changed_timestamp || check.entry->m_md5sum != check.md5sum)
+                continue;
+
+            switch (check.result) {
+                case EntryCheck::Result::Unchanged:
+                    break;
+                case EntryCheck::Result::Rehashed:
+                    check.entry->m_local_changed_timestamp = check.file_last_changed;
+                    markDirty(base, check.resource_path);
+                    rehashed = true;
+                    break;
+                case EntryCheck::Result::Stale:
+                    selected_base.entry_list.remove(check.resource_path);
+                    markDirty(base, check.resource_path);
+                    dropped.append(check.resource_path);
+                    break;
+            }
+        }
+        if (rehashed || !dropped.isEmpty())
+            SaveEventually();
+        watcher->deleteLater();
+        done(dropped);
+    });
+    watcher->setFuture(QtConcurrent::mapped(checks, checkEntryFile));
+}
+
 auto HttpMetaCache::updateEntry(MetaEntryPtr stale_entry) -> bool
 {
     if (!m_entries.contains(stale_entry->m_baseId)) {
@@ -148,7 +345,11 @@ auto HttpMetaCache::updateEntry(MetaEntryPtr stale_entry) -> bool
         return false;
     }
 
-    m_entries[stale_entry->m_baseId].entry_list[stale_entry->m_relativePath] = stale_entry;
+    stale_entry->m_last_used = QDateTime::currentSecsSinceEpoch();
+    auto& map = m_entries[stale_entry->m_baseId];
+    map.entry_list[stale_entry->m_relativePath] = stale_entry;
+    map.raw_entries.remove(stale_entry->m_relativePath);
+    markDirty(stale_entry->m_baseId, stale_entry->m_relativePath);
     SaveEventually();
 
     return true;
@@ -160,6 +361,7 @@ auto HttpMetaCache::evictEntry(MetaEntryPtr entry) -> bool
         return false;
 
     entry->m_stale = true;
+    markDirty(entry->m_baseId, entry->m_relativePath);
     SaveEventually();
     return true;
 }
@@ -169,6 +371,10 @@ void HttpMetaCache::evictAll()
     for (QString& base : m_entries.keys()) {
         EntryMap& map = m_entries[base];
         qCDebug(taskHttpMetaCacheLogC) << "Evicting base" << base;
+        // everything is going away, no need to deserialize what we haven't looked at yet
+        for (auto it = map.raw_entries.cbegin(); it != map.raw_entries.cend(); ++it)
+            markDirty(base, it.key());
+        map.raw_entries.clear();
         for (MetaEntryPtr entry : map.entry_list) {
             if (!evictEntry(entry))
                 qCWarning(taskHttpMetaCacheLogC) << "Unexpected missing cache entry" << entry->m_basePath;
@@ -199,6 +405,67 @@ void HttpMetaCache::addBase(QString base, QString base_root)
     m_entries[base] = foo;
 }
 
+void HttpMetaCache::setBudget(QString base, qint64 bytes)
+{
+    if (m_entries.contains(base))
+        m_entries[base].budget = bytes;
+}
+
+auto HttpMetaCache::getBudget(QString base) -> qint64
+{
+    return m_entries.value(base).budget;
+}
+
+auto HttpMetaCache::getBudgetedBases() -> QStringList
+{
+    QStringList bases;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        if (it->budget > 0)
+            bases.append(it.key());
+    }
+    return bases;
+}
+
+void HttpMetaCache::setCompressed(QString base, bool compressed)
+{
+    if (m_entries.contains(base))
+        m_entries[base].compressed = compressed;
+}
+
+auto HttpMetaCache::isCompressed(QString base) -> bool
+{
+    return m_entries.value(base).compressed;
+}
+
+auto HttpMetaCache::readFile(const QString& path) -> QByteArray
+{
+    auto data = FS::read(path);
+    if (!GZip::isCompressed(data))
+        return data;
+    QByteArray inflated;
+    if (!GZip::unzip(data, inflated))
+        throw FS::FileSystemException("Couldn't inflate " + path);
+    return inflated;
+}
+
+auto HttpMetaCache::getEntries(QString base) -> QList<MetaEntryPtr>
+{
+    if (!m_entries.contains(base))
+        return {};
+
+    // getEntry() takes them out of the raw ones
+    for (auto& path : m_entries[base].raw_entries.keys())
+        getEntry(base, path);
+
+    QList<MetaEntryPtr> entries;
+    auto& map = m_entries[base];
+    for (auto& entry : map.entry_list) {
+        entry->m_basePath = map.base_path;
+        entries.append(entry);
+    }
+    return entries;
+}
+
 auto HttpMetaCache::getBasePath(QString base) -> QString
 {
     if (m_entries.contains(base)) {
@@ -208,11 +475,156 @@ auto HttpMetaCache::getBasePath(QString base) -> QString
     return {};
 }
 
+void HttpMetaCache::markDirty(const QString& base, const QString& resource_path)
+{
+    m_dirty.insert({ base, resource_path });
+}
+
+void HttpMetaCache::markUsed(MetaEntry& entry)
+{
+    // to the day, so resolving entries doesn't make the index grow
+    auto now = QDateTime::currentSecsSinceEpoch();
+    if (now - entry.m_last_used < 24 * 60 * 60)
+        return;
+    entry.m_last_used = now;
+    markDirty(entry.m_baseId, entry.m_relativePath);
+    SaveEventually();
+}
+
 void HttpMetaCache::Load()
 {
     if (m_index_file.isNull())
         return;
 
+    // no reading half a record someone else is appending
+    FileLease lease(binaryIndexPath(m_index_file));
+    lease.acquire();
+
+    if (loadIndex())
+        return;
+
+    // no binary index yet, migrate the old JSON one if we have it
+    if (!QFileInfo::exists(m_index_file))
+        return;
+
+    qCDebug(taskHttpMetaCacheLogC) << "Migrating metacache index from JSON";
+    loadLegacyJson();
+    if (compact())
+        QFile::remove(m_index_file);
+}
+
+bool HttpMetaCache::loadIndex()
+{
+    QFile index(binaryIndexPath(m_index_file));
+    if (!index.open(QIODevice::ReadOnly))
+        return false;
+
+    // map the whole log instead of going through small buffered reads
+    QByteArray data;
+    auto size = index.size();
+    uchar* mapped = size > 0 ? index.map(0, size) : nullptr;
+    if (mapped)
+        data = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), size);
+    else
+        data = index.readAll();
+
+    QDataStream in(data);
+    in.setVersion(s_stream_version);
+
+    quint32 magic, version;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != s_index_magic || version != s_index_version) {
+        qCWarning(taskHttpMetaCacheLogC) << "Ignoring metacache index with unknown format";
+        m_needs_compaction = true;
+        return true;
+    }
+
+    m_log_records = 0;
+    readRecords(in);
+    rememberIndexFile();
+
+    if (mapped)
+        index.unmap(mapped);
+
+    return true;
+}
+
+void HttpMetaCache::readRecords(QDataStream& in)
+{
+    while (!in.atEnd()) {
+        quint8 op;
+        QString base, path;
+        QByteArray payload;
+        in >> op >> base >> path;
+        if (static_cast<IndexOp>(op) == IndexOp::Upsert)
+            in >> payload;
+
+        if (in.status() != QDataStream::Ok) {
+            // most likely a partial write at the end, the rest is still good
+            qCWarning(taskHttpMetaCacheLogC) << "Metacache index is truncated after" << m_log_records << "records";
+            m_needs_compaction = true;
+            return;
+        }
+
+        m_log_records++;
+
+        if (!m_entries.contains(base))
+            continue;
+        // what changed here since is written after it, and takes precedence
+        if (m_dirty.contains({ base, path }))
+            continue;
+
+        auto& entrymap = m_entries[base];
+        entrymap.entry_list.remove(path);
+        if (static_cast<IndexOp>(op) == IndexOp::Upsert)
+            entrymap.raw_entries.insert(path, payload);
+        else
+            entrymap.raw_entries.remove(path);
+    }
+}
+
+void HttpMetaCache::mergeIndex()
+{
+    QFileInfo info(binaryIndexPath(m_index_file));
+    if (!info.exists())
+        return;
+    // another launcher either appended to the log, or rewrote it from scratch into a new file
+    bool same_file = m_index_size > 0 && info.birthTime() == m_index_birth;
+    if (same_file && info.size() == m_index_size)
+        return;
+
+    QFile index(info.filePath());
+    if (!index.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&index);
+    in.setVersion(s_stream_version);
+
+    bool appended = same_file && index.size() > m_index_size;
+    if (appended) {
+        index.seek(m_index_size);
+    } else {
+        quint32 magic, version;
+        in >> magic >> version;
+        if (in.status() != QDataStream::Ok || magic != s_index_magic || version != s_index_version)
+            return;
+        m_log_records = 0;
+    }
+
+    qCDebug(taskHttpMetaCacheLogC) << "Reading the metacache changes of another launcher";
+    readRecords(in);
+    rememberIndexFile();
+}
+
+void HttpMetaCache::rememberIndexFile()
+{
+    QFileInfo info(binaryIndexPath(m_index_file));
+    m_index_size = info.size();
+    m_index_birth = info.birthTime();
+}
+
+void HttpMetaCache::loadLegacyJson()
+{
     QFile index(m_index_file);
     if (!index.open(QIODevice::ReadOnly))
         return;
@@ -257,6 +669,16 @@ void HttpMetaCache::Load()
     }
 }
 
+QByteArray HttpMetaCache::serializeEntry(const MetaEntry& entry)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(s_stream_version);
+    out << entry.m_md5sum << entry.m_etag << entry.m_local_changed_timestamp << entry.m_remote_changed_timestamp << entry.m_is_eternal
+        << entry.m_current_age << entry.m_max_age << entry.m_last_used;
+    return payload;
+}
+
 void HttpMetaCache::SaveEventually()
 {
     // reset the save timer
@@ -269,41 +691,111 @@ void HttpMetaCache::SaveNow()
     if (m_index_file.isNull())
         return;
 
-    qCDebug(taskHttpMetaCacheLogC) << "Saving metacache with" << m_entries.size() << "entries";
+    FileLease lease(binaryIndexPath(m_index_file));
+    if (lease.acquire())
+        mergeIndex();
+
+    int live = m_dirty.size();
+    for (auto const& map : m_entries)
+        live += map.entry_list.size() + map.raw_entries.size();
+
+    if (m_needs_compaction || m_log_records > qMax(s_min_compaction_records, 2 * live)) {
+        compact();
+        return;
+    }
+
+    if (m_dirty.isEmpty())
+        return;
+
+    if (!appendDirty())
+        compact();
+}
+
+bool HttpMetaCache::appendDirty()
+{
+    auto path = binaryIndexPath(m_index_file);
+    bool is_new = !QFileInfo::exists(path);
+
+    QFile index(path);
+    if (!index.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(taskHttpMetaCacheLogC) << "Error opening cache index for writing:" << index.errorString();
+        return false;
+    }
+
+    qCDebug(taskHttpMetaCacheLogC) << "Appending" << m_dirty.size() << "changed entries to the metacache";
+
+    QDataStream out(&index);
+    out.setVersion(s_stream_version);
+
+    if (is_new)
+        out << s_index_magic << s_index_version;
+
+    for (auto const& key : m_dirty) {
+        auto const& base = key.first;
+        auto const& resource_path = key.second;
 
-    QJsonObject toplevel;
-    Json::writeString(toplevel, "version", "1");
+        MetaEntryPtr entry;
+        auto map = m_entries.constFind(base);
+        if (map != m_entries.constEnd())
+            entry = map->entry_list.value(resource_path);
 
-    QJsonArray entriesArr;
-    for (auto group : m_entries) {
-        for (auto entry : group.entry_list) {
+        // do not save stale entries. they are dead.
+        if (entry && !entry->m_stale) {
+            out << quint8(IndexOp::Upsert) << base << resource_path << serializeEntry(*entry);
+        } else {
+            out << quint8(IndexOp::Remove) << base << resource_path;
+        }
+        m_log_records++;
+    }
+
+    if (out.status() != QDataStream::Ok || !index.flush()) {
+        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache index:" << index.errorString();
+        return false;
+    }
+
+    rememberIndexFile();
+    m_dirty.clear();
+    return true;
+}
+
+bool HttpMetaCache::compact()
+{
+    QSaveFile index(binaryIndexPath(m_index_file));
+    if (!index.open(QIODevice::WriteOnly)) {
+        qCWarning(taskHttpMetaCacheLogC) << "Error opening cache index for writing:" << index.errorString();
+        return false;
+    }
+
+    QDataStream out(&index);
+    out.setVersion(s_stream_version);
+    out << s_index_magic << s_index_version;
+
+    int records = 0;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        auto const& base = it.key();
+        for (auto const& entry : it->entry_list) {
             // do not save stale entries. they are dead.
-            if (entry->m_stale) {
+            if (entry->m_stale)
                 continue;
-            }
-
-            QJsonObject entryObj;
-            Json::writeString(entryObj, "base", entry->m_baseId);
-            Json::writeString(entryObj, "path", entry->m_relativePath);
-            Json::writeString(entryObj, "md5sum", entry->m_md5sum);
-            Json::writeString(entryObj, "etag", entry->m_etag);
-            entryObj.insert("last_changed_timestamp", QJsonValue(double(entry->m_local_changed_timestamp)));
-            if (!entry->m_remote_changed_timestamp.isEmpty())
-                entryObj.insert("remote_changed_timestamp", QJsonValue(entry->m_remote_changed_timestamp));
-            if (entry->isEternal()) {
-                entryObj.insert("eternal", true);
-            } else {
-                entryObj.insert("current_age", QJsonValue(double(entry->m_current_age)));
-                entryObj.insert("max_age", QJsonValue(double(entry->m_max_age)));
-            }
-            entriesArr.append(entryObj);
+            out << quint8(IndexOp::Upsert) << base << entry->m_relativePath << serializeEntry(*entry);
+            records++;
+        }
+        for (auto raw = it->raw_entries.cbegin(); raw != it->raw_entries.cend(); ++raw) {
+            out << quint8(IndexOp::Upsert) << base << raw.key() << raw.value();
+            records++;
         }
     }
-    toplevel.insert("entries", entriesArr);
 
-    try {
-        Json::write(toplevel, m_index_file);
-    } catch (const Exception& e) {
-        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache:" << e.what();
+    qCDebug(taskHttpMetaCacheLogC) << "Compacting metacache index to" << records << "entries";
+
+    if (out.status() != QDataStream::Ok || !index.commit()) {
+        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache index:" << index.errorString();
+        return false;
     }
+
+    m_log_records = records;
+    rememberIndexFile();
+    m_needs_compaction = false;
+    m_dirty.clear();
+    return true;
 }
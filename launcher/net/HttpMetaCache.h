@@ -35,11 +35,19 @@
 
 #pragma once
 
+#include <QDateTime>
+#include <QHash>
 #include <QMap>
+#include <QPair>
+#include <QSet>
 #include <QString>
+#include <QStringList>
 #include <QTimer>
+#include <functional>
 #include <memory>
 
+class QDataStream;
+
 class HttpMetaCache;
 
 class MetaEntry {
@@ -52,7 +60,13 @@ class MetaEntry {
     auto isStale() -> bool { return m_stale; }
     void setStale(bool stale) { m_stale = stale; }
 
+    /* Stale, but it expired within the staleness bound it was resolved with, so its file can be used until it's
+     * revalidated. */
+    [[nodiscard]] bool isUsableWhileStale() const { return m_stale && m_usable_while_stale; }
+
     auto getFullPath() -> QString;
+    auto getRelativePath() -> QString { return m_relativePath; }
+    auto getBaseId() -> QString { return m_baseId; }
 
     auto getRemoteChangedTimestamp() -> QString { return m_remote_changed_timestamp; }
     void setRemoteChangedTimestamp(QString remote_changed_timestamp) { m_remote_changed_timestamp = remote_changed_timestamp; }
@@ -76,6 +90,9 @@ class MetaEntry {
 
     bool isExpired(qint64 offset) { return !m_is_eternal && (m_current_age >= m_max_age - offset); };
 
+    /* When the entry was last resolved or updated, in seconds since the epoch, to the day. 0 when it isn't known. */
+    [[nodiscard]] qint64 lastUsed() const { return m_last_used; }
+
    protected:
     QString m_baseId;
     QString m_basePath;
@@ -87,9 +104,11 @@ class MetaEntry {
     QString m_remote_changed_timestamp;  // QString for now, RFC 2822 encoded time
     qint64 m_current_age = 0;
     qint64 m_max_age = 0;
+    qint64 m_last_used = 0;
     bool m_is_eternal = false;
 
     bool m_stale = true;
+    bool m_usable_while_stale = false;
 };
 
 using MetaEntryPtr = std::shared_ptr<MetaEntry>;
@@ -106,7 +125,14 @@ class HttpMetaCache : public QObject {
     auto getEntry(QString base, QString resource_path) -> MetaEntryPtr;
 
     // get the entry from cache and verify that it isn't stale (within reason)
-    auto resolveEntry(QString base, QString resource_path, QString expected_etag = QString()) -> MetaEntryPtr;
+    // an entry that expired less than max_stale seconds ago is kept, with what it needs to be revalidated: it's
+    // returned stale, and its file can be used until the download revalidating it is done (stale-while-revalidate).
+    auto resolveEntry(QString base, QString resource_path, QString expected_etag = QString(), qint64 max_stale = 0) -> MetaEntryPtr;
+
+    // check the files of many entries of a base at once, on the global thread pool, and drop the entries
+    // whose file is gone or changed. resolving those entries afterwards doesn't have to read their files.
+    // done gets the paths of the dropped entries, unless context is gone by then.
+    void validateEntries(QString base, QStringList resource_paths, QObject* context, std::function<void(QStringList)> done);
 
     // add a previously resolved stale entry
     auto updateEntry(MetaEntryPtr stale_entry) -> bool;
@@ -117,6 +143,22 @@ class HttpMetaCache : public QObject {
 
     void addBase(QString base, QString base_root);
 
+    // how many bytes the files of a base may take before the least recently used ones get removed, 0 when there's
+    // no limit. see CacheCleanupTask.
+    void setBudget(QString base, qint64 bytes);
+    auto getBudget(QString base) -> qint64;
+    auto getBudgetedBases() -> QStringList;
+
+    // whether the files of a base are stored compressed with gzip. only for bases of text that's read back whole,
+    // with readFile(). the md5sum of such an entry is the one of the compressed file. see MetaCacheSink.
+    void setCompressed(QString base, bool compressed);
+    auto isCompressed(QString base) -> bool;
+    // the contents of a file of the cache, inflated if it was stored compressed. throws FS::FileSystemException
+    static auto readFile(const QString& path) -> QByteArray;
+
+    // all the entries of a base, including the ones nobody asked for yet and the stale ones
+    auto getEntries(QString base) -> QList<MetaEntryPtr>;
+
     // (re)start a timer that calls SaveNow later.
     void SaveEventually();
     void Load();
@@ -130,12 +172,41 @@ class HttpMetaCache : public QObject {
     // create a new stale entry, given the parameters
     auto staleEntry(QString base, QString resource_path) -> MetaEntryPtr;
 
+    // mark an entry as changed, so that the next save appends it to the index
+    void markDirty(const QString& base, const QString& resource_path);
+    // remember that an entry is still used
+    void markUsed(MetaEntry& entry);
+
+    void loadLegacyJson();
+    bool loadIndex();
+    void readRecords(QDataStream& in);
+    // read in the records other launchers sharing the index wrote since this one last looked at it
+    void mergeIndex();
+    void rememberIndexFile();
+    bool appendDirty();
+    bool compact();
+
+    static QByteArray serializeEntry(const MetaEntry& entry);
+
     struct EntryMap {
         QString base_path;
+        qint64 budget = 0;
+        bool compressed = false;
         QMap<QString, MetaEntryPtr> entry_list;
+        // entries read from the index that nobody asked for yet, kept in their serialized form
+        QHash<QString, QByteArray> raw_entries;
     };
 
     QMap<QString, EntryMap> m_entries;
     QString m_index_file;
     QTimer saveBatchingTimer;
+
+    // entries changed since the last save
+    QSet<QPair<QString, QString>> m_dirty;
+    // number of records in the on-disk log, live or not. used to decide when to compact it.
+    int m_log_records = 0;
+    // size of the on-disk log as this launcher last left it
+    qint64 m_index_size = -1;
+    QDateTime m_index_birth;
+    bool m_needs_compaction = false;
 };
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QDebug>
+#include <QJsonDocument>
+#include <memory>
+
+#include "Exception.h"
+#include "net/NetJob.h"
+
+namespace Net {
+
+/** Parses the JSON `response` of `job` and makes a `Result` of it with `process`, on the global thread pool.
+ *
+ * The result is filled in by the time `job` succeeds, so its `succeeded` handlers can just use it. The job fails if
+ * the response isn't JSON, or if `process` throws. `process` runs off the GUI thread, it should only use what it gets.
+ */
+template <typename Result, typename Process>
+std::shared_ptr<Result> processJson(Task* job, const QByteArray* response, QString what, Process process)
+{
+    auto result = std::make_shared<Result>();
+    auto net_job = qobject_cast<NetJob*>(job);
+    if (!net_job) {
+        qCritical() << "Can't process the response from" << what << "without a NetJob";
+        return result;
+    }
+
+    net_job->addResponseProcessor([response, result, what, process] {
+        // copied here, the response can be gone before the processing is done if the job gets aborted
+        auto data = *response;
+        return std::function<QString()>([data, result, what, process] {
+            QJsonParseError parse_error{};
+            auto doc = QJsonDocument::fromJson(data, &parse_error);
+            if (parse_error.error != QJsonParseError::NoError) {
+                qWarning() << "Error while parsing JSON response from" << what << "at" << parse_error.offset
+                           << "reason:" << parse_error.errorString();
+                qWarning() << data;
+                return parse_error.errorString();
+            }
+
+            try {
+                *result = process(doc);
+            } catch (const Exception& e) {
+                qWarning() << "Couldn't make sense of the response from" << what << ":" << e.cause();
+                return e.cause();
+            }
+            return QString();
+        });
+    });
+    return result;
+}
+
+/** Just parses the JSON `response` of `job` on the global thread pool, see processJson. */
+inline std::shared_ptr<QJsonDocument> parseJson(Task* job, const QByteArray* response, QString what)
+{
+    return processJson<QJsonDocument>(job, response, std::move(what), [](const QJsonDocument& doc) { return doc; });
+}
+
+}  // namespace Net
@@ -34,10 +34,13 @@
  */
 
 #include "MetaCacheSink.h"
+#include <QCryptographicHash>
 #include <QFile>
 #include <QFileInfo>
 #include <QRegularExpression>
 #include "Application.h"
+#include "FileSystem.h"
+#include "GZip.h"
 
 #include "net/Logging.h"
 
@@ -62,10 +65,32 @@ Task::State MetaCacheSink::initCache(QNetworkRequest& request)
         return Task::State::Succeeded;
     }
 
+    // a launcher sharing this cache may be downloading the same file right now, it's waited for instead
+    if (!m_lease)
+        m_lease.reset(new FileLease(m_filename));
+    if (!m_lease->tryAcquire()) {
+        if (!m_waited) {
+            m_waited = true;
+            m_changed_before = QFileInfo(m_filename).lastModified();
+        }
+        qCDebug(taskMetaCacheLogC) << "Waiting for someone else to download" << m_filename;
+        return Task::State::Inactive;
+    }
+    if (m_waited) {
+        m_waited = false;
+        QFileInfo info(m_filename);
+        if (info.exists() && info.size() != 0 && info.lastModified() != m_changed_before)
+            return adoptFile();
+    }
+
+    m_changed = false;
+    m_previous_md5.clear();
+
     // check if file exists, if it does, use its information for the request
     QFile current(m_filename);
     if(current.exists() && current.size() != 0)
     {
+        m_previous_md5 = m_entry->getMD5Sum();
         if (m_entry->getRemoteChangedTimestamp().size())
         {
             request.setRawHeader(QString("If-Modified-Since").toLatin1(), m_entry->getRemoteChangedTimestamp().toLatin1());
@@ -81,13 +106,23 @@ Task::State MetaCacheSink::initCache(QNetworkRequest& request)
 
 Task::State MetaCacheSink::finalizeCache(QNetworkReply & reply)
 {
-    QFileInfo output_file_info(m_filename);
+    if (reply.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304)
+    {
+        // revalidated, the age of the copy is counted from its file, so that starts over
+        QFile current(m_filename);
+        if (current.open(QIODevice::ReadWrite))
+            current.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
 
     if(wroteAnyData)
     {
-        m_entry->setMD5Sum(m_md5Node->hash().toHex().constData());
+        auto compressed_md5 = compressFile();
+        m_entry->setMD5Sum(compressed_md5.isEmpty() ? QString::fromLatin1(m_md5Node->hash().toHex()) : compressed_md5);
+        m_changed = m_previous_md5.isEmpty() || m_entry->getMD5Sum() != m_previous_md5;
     }
 
+    QFileInfo output_file_info(m_filename);
+
     m_entry->setETag(reply.rawHeader("ETag").constData());
 
     if (reply.hasRawHeader("Last-Modified"))
@@ -98,44 +133,106 @@ Task::State MetaCacheSink::finalizeCache(QNetworkReply & reply)
     m_entry->setLocalChangedTimestamp(output_file_info.lastModified().toUTC().toMSecsSinceEpoch());
 
     { // Cache lifetime
+        auto [max_age, current_age] = cacheLifetime(reply);
         if (m_is_eternal) {
             qCDebug(taskMetaCacheLogC) << "Adding eternal cache entry:" << m_entry->getFullPath();
             m_entry->makeEternal(true);
-        } else if (reply.hasRawHeader("Cache-Control")) {
-            auto cache_control_header = reply.rawHeader("Cache-Control");
-            qCDebug(taskMetaCacheLogC) << "Parsing 'Cache-Control' header with" << cache_control_header;
-
-            QRegularExpression max_age_expr("max-age=([0-9]+)");
-            qint64 max_age = max_age_expr.match(cache_control_header).captured(1).toLongLong();
-            m_entry->setMaximumAge(max_age);
-
-        } else if (reply.hasRawHeader("Expires")) {
-            auto expires_header = reply.rawHeader("Expires");
-            qCDebug(taskMetaCacheLogC) << "Parsing 'Expires' header with" << expires_header;
-
-            qint64 max_age = QDateTime::fromString(expires_header).toSecsSinceEpoch() - QDateTime::currentSecsSinceEpoch();
-            m_entry->setMaximumAge(max_age);
         } else {
-            m_entry->setMaximumAge(MAX_TIME_TO_EXPIRE);
+            m_entry->setMaximumAge(max_age);
         }
+        m_entry->setCurrentAge(current_age);
+    }
 
-        if (reply.hasRawHeader("Age")) {
-            auto age_header = reply.rawHeader("Age");
-            qCDebug(taskMetaCacheLogC) << "Parsing 'Age' header with" << age_header;
+    m_entry->setStale(false);
+    APPLICATION->metacache()->updateEntry(m_entry);
+    m_lease.reset();
 
-            qint64 current_age = age_header.toLongLong();
-            m_entry->setCurrentAge(current_age);
-        } else {
-            m_entry->setCurrentAge(0);
-        }
-    }
+    return Task::State::Succeeded;
+}
 
+auto MetaCacheSink::adoptFile() -> Task::State
+{
+    QFile file(m_filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        // then it's downloaded here again, the lease is held already
+        return Task::State::Running;
+    }
+    QCryptographicHash md5(QCryptographicHash::Md5);
+    md5.addData(&file);
+
+    qCDebug(taskMetaCacheLogC) << "Using the file someone else downloaded:" << m_filename;
+    m_changed = true;
+    // the reply it came with is only known to the other process, so it is taken as one without any caching headers
+    m_entry->setMD5Sum(md5.result().toHex().constData());
+    m_entry->setETag({});
+    m_entry->setRemoteChangedTimestamp({});
+    m_entry->setLocalChangedTimestamp(QFileInfo(m_filename).lastModified().toUTC().toMSecsSinceEpoch());
+    if (m_is_eternal)
+        m_entry->makeEternal(true);
+    else
+        m_entry->setMaximumAge(MAX_TIME_TO_EXPIRE);
+    m_entry->setCurrentAge(0);
     m_entry->setStale(false);
     APPLICATION->metacache()->updateEntry(m_entry);
+    m_lease.reset();
 
     return Task::State::Succeeded;
 }
 
+auto MetaCacheSink::compressFile() -> QString
+{
+    if (!APPLICATION->metacache()->isCompressed(m_entry->getBaseId()))
+        return {};
+
+    try {
+        auto data = FS::read(m_filename);
+        QByteArray compressed;
+        // the same contents always compress to the same file, so the md5sum still tells whether they changed
+        if (data.size() < s_min_compressed_size || GZip::isCompressed(data) || !GZip::zip(data, compressed) ||
+            compressed.size() >= data.size())
+            return {};
+        FS::write(m_filename, compressed);
+        return QString::fromLatin1(QCryptographicHash::hash(compressed, QCryptographicHash::Md5).toHex());
+    } catch (const FS::FileSystemException& e) {
+        qCWarning(taskMetaCacheLogC) << "Couldn't compress" << m_filename << ":" << e.cause();
+        return {};
+    }
+}
+
+auto MetaCacheSink::abort() -> Task::State
+{
+    m_lease.reset();
+    m_waited = false;
+    return FileSink::abort();
+}
+
+auto MetaCacheSink::cacheLifetime(QNetworkReply& reply) -> std::pair<qint64, qint64>
+{
+    qint64 max_age = MAX_TIME_TO_EXPIRE;
+    if (reply.hasRawHeader("Cache-Control")) {
+        auto cache_control_header = reply.rawHeader("Cache-Control");
+        qCDebug(taskMetaCacheLogC) << "Parsing 'Cache-Control' header with" << cache_control_header;
+
+        QRegularExpression max_age_expr("max-age=([0-9]+)");
+        max_age = max_age_expr.match(cache_control_header).captured(1).toLongLong();
+    } else if (reply.hasRawHeader("Expires")) {
+        auto expires_header = reply.rawHeader("Expires");
+        qCDebug(taskMetaCacheLogC) << "Parsing 'Expires' header with" << expires_header;
+
+        max_age = QDateTime::fromString(expires_header).toSecsSinceEpoch() - QDateTime::currentSecsSinceEpoch();
+    }
+
+    qint64 current_age = 0;
+    if (reply.hasRawHeader("Age")) {
+        auto age_header = reply.rawHeader("Age");
+        qCDebug(taskMetaCacheLogC) << "Parsing 'Age' header with" << age_header;
+
+        current_age = age_header.toLongLong();
+    }
+
+    return { max_age, current_age };
+}
+
 bool MetaCacheSink::hasLocalData()
 {
     QFileInfo info(m_filename);
@@ -35,25 +35,54 @@
 
 #pragma once
 
+#include <QDateTime>
+
+#include <memory>
+
 #include "ChecksumValidator.h"
 #include "FileSink.h"
 #include "net/HttpMetaCache.h"
 
+#include "FileLease.h"
+
 namespace Net {
 class MetaCacheSink : public FileSink {
    public:
     MetaCacheSink(MetaEntryPtr entry, ChecksumValidator* md5sum, bool is_eternal = false);
     virtual ~MetaCacheSink() = default;
 
+    auto abort() -> Task::State override;
     auto hasLocalData() -> bool override;
+    auto changedContent() -> bool override { return m_changed; }
+    auto isCache() -> bool override { return true; }
+
+    /** How long a reply can be cached according to its headers, and how old it already is, in seconds. */
+    static auto cacheLifetime(QNetworkReply& reply) -> std::pair<qint64, qint64>;
 
    protected:
     auto initCache(QNetworkRequest& request) -> Task::State override;
     auto finalizeCache(QNetworkReply& reply) -> Task::State override;
 
+   private:
+    /** Takes over the file another process just downloaded while this one waited for it. */
+    auto adoptFile() -> Task::State;
+    /** Compresses the downloaded file if its base is stored compressed. Returns the md5sum of the compressed file, empty
+     * when the file was left as it came. */
+    auto compressFile() -> QString;
+
+    // smaller ones don't shrink much, and are read often
+    static constexpr int s_min_compressed_size = 4096;
+
    private:
     MetaEntryPtr m_entry;
     ChecksumValidator* m_md5Node;
     bool m_is_eternal;
+    /// held while the file is downloaded, so other processes sharing the cache wait instead of downloading it too
+    std::unique_ptr<FileLease> m_lease;
+    bool m_waited = false;
+    QDateTime m_changed_before;
+    /// md5 of the copy that was there before the download, to tell whether the new one is any different
+    QString m_previous_md5;
+    bool m_changed = false;
 };
 }  // namespace Net
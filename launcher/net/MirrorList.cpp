@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "MirrorList.h"
+
+#include <QRegularExpression>
+
+#include <algorithm>
+
+#include "BuildConfig.h"
+#include "net/Logging.h"
+#include "settings/SettingsObject.h"
+
+namespace Net {
+
+namespace {
+// how much a new measurement counts against what was measured before
+constexpr double s_weight = 0.3;
+// smaller replies are all latency, they don't tell how fast the mirror is
+constexpr qint64 s_min_throughput_bytes = 64 * 1024;
+
+qint64 typicalSize(MirrorList::Kind kind)
+{
+    switch (kind) {
+        case MirrorList::Kind::Libraries:
+            return 512 * 1024;
+        case MirrorList::Kind::Assets:
+        default:
+            return 16 * 1024;
+    }
+}
+
+double average(double previous, double measured)
+{
+    if (previous < 0)
+        return measured;
+    return previous + s_weight * (measured - previous);
+}
+}  // namespace
+
+MirrorList::MirrorList(std::function<qint64()> now) : m_now(std::move(now)) {}
+
+void MirrorList::setMirrors(Kind kind, const QString& official, const QStringList& mirrors)
+{
+    QStringList bases;
+    for (auto& base : mirrors) {
+        if (base != official && !bases.contains(base))
+            bases.append(base);
+    }
+    bases.append(official);
+    m_official[kind] = official;
+    m_bases[kind] = bases;
+}
+
+void MirrorList::loadSettings(SettingsObject& settings)
+{
+    setMirrors(Kind::Libraries, BuildConfig.LIBRARY_BASE, parse(settings.get("LibraryMirrors").toString()));
+    setMirrors(Kind::Assets, BuildConfig.RESOURCE_BASE, parse(settings.get("AssetMirrors").toString()));
+}
+
+QStringList MirrorList::parse(const QString& mirrors)
+{
+    QStringList bases;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    auto entries = mirrors.split(QRegularExpression("[,\\s]+"), Qt::SkipEmptyParts);
+#else
+    auto entries = mirrors.split(QRegularExpression("[,\\s]+"), QString::SkipEmptyParts);
+#endif
+    for (auto& entry : entries) {
+        QUrl url(entry);
+        // what comes from there gets run, like with the metadata server
+        if (url.scheme() == "http")
+            url.setScheme("https");
+        if (!url.isValid() || url.scheme() != "https" || url.host().isEmpty()) {
+            qCWarning(taskNetLogC) << "Ignoring the mirror" << entry << "as it isn't an HTTPS URL";
+            continue;
+        }
+        if (!url.path().endsWith('/'))
+            url.setPath(url.path() + '/');
+        bases.append(url.toString());
+    }
+    return bases;
+}
+
+QList<QUrl> MirrorList::route(Kind kind, const QUrl& url) const
+{
+    auto official = m_official.value(kind);
+    auto full = url.toString();
+    if (official.isEmpty() || !full.startsWith(official))
+        return { url };
+    auto path = full.mid(official.size());
+
+    auto now = m_now();
+    QStringList healthy;
+    QStringList backing_off;
+    for (auto& base : m_bases.value(kind)) {
+        auto it = m_mirrors.constFind(base);
+        if (it == m_mirrors.constEnd() || it->retry_after <= now)
+            healthy.append(base);
+        else
+            backing_off.append(base);
+    }
+    std::stable_sort(healthy.begin(), healthy.end(),
+                     [this, kind](const QString& a, const QString& b) { return estimate(kind, a) < estimate(kind, b); });
+    // the one that comes back first is the best bet of those
+    std::stable_sort(backing_off.begin(), backing_off.end(), [this](const QString& a, const QString& b) {
+        return m_mirrors.value(a).retry_after < m_mirrors.value(b).retry_after;
+    });
+
+    QList<QUrl> urls;
+    for (auto& base : healthy + backing_off)
+        urls.append(QUrl(base + path));
+    return urls;
+}
+
+void MirrorList::reportSuccess(const QUrl& url, qint64 latency_ms, qint64 bytes, qint64 elapsed_ms)
+{
+    auto base = baseOf(url);
+    if (base.isEmpty())
+        return;
+
+    auto& mirror = m_mirrors[base];
+    mirror.latency_ms = average(mirror.latency_ms, latency_ms);
+    auto transfer_ms = elapsed_ms - latency_ms;
+    if (bytes >= s_min_throughput_bytes && transfer_ms > 0)
+        mirror.bytes_per_ms = average(mirror.bytes_per_ms, double(bytes) / transfer_ms);
+    mirror.retry_after = 0;
+    mirror.backoff.reset();
+}
+
+void MirrorList::reportFailure(const QUrl& url)
+{
+    auto base = baseOf(url);
+    if (base.isEmpty())
+        return;
+
+    auto& mirror = m_mirrors[base];
+    auto backoff = mirror.backoff();
+    mirror.retry_after = m_now() + qint64(backoff) * 1000;
+    qCDebug(taskNetLogC) << "Mirror" << base << "failed, leaving it for last for" << backoff << "seconds";
+}
+
+bool MirrorList::isHealthy(const QUrl& url) const
+{
+    auto it = m_mirrors.constFind(baseOf(url));
+    return it == m_mirrors.constEnd() || it->retry_after <= m_now();
+}
+
+QString MirrorList::baseOf(const QUrl& url) const
+{
+    auto full = url.toString();
+    QString found;
+    for (auto& bases : m_bases) {
+        for (auto& base : bases) {
+            if (base.size() > found.size() && full.startsWith(base))
+                found = base;
+        }
+    }
+    return found;
+}
+
+double MirrorList::estimate(Kind kind, const QString& base) const
+{
+    auto it = m_mirrors.constFind(base);
+    // not measured yet, so it gets to be
+    if (it == m_mirrors.constEnd() || it->latency_ms < 0)
+        return -1;
+    if (it->bytes_per_ms <= 0)
+        return it->latency_ms;
+    return it->latency_ms + typicalSize(kind) / it->bytes_per_ms;
+}
+
+}  // namespace Net
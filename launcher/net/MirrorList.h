@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+
+#include <functional>
+
+#include "ExponentialSeries.h"
+
+class SettingsObject;
+
+namespace Net {
+
+/* The hosts the libraries and the assets can be downloaded from, and how well each of them did so far.
+ *
+ * A mirror is a base URL the files of a kind are found under, with the same paths as under the official one (which is
+ * always one of them). route() puts the mirrors in the order a download should try them: the healthy ones first, the
+ * fastest of those first, going by the latency and throughput the downloads reported. A mirror nothing was reported
+ * for yet comes before the others, so every mirror gets measured. A mirror that failed is left for last until its
+ * backoff runs out, which grows with each failure in a row.
+ */
+class MirrorList {
+   public:
+    enum class Kind { Libraries, Assets };
+
+    explicit MirrorList(std::function<qint64()> now = &QDateTime::currentMSecsSinceEpoch);
+
+    /** `mirrors` go before `official` when nothing is known about them yet, in their order. */
+    void setMirrors(Kind kind, const QString& official, const QStringList& mirrors);
+    /** Takes the mirrors from the LibraryMirrors and AssetMirrors settings, see parse(). */
+    void loadSettings(SettingsObject& settings);
+    QStringList mirrors(Kind kind) const { return m_bases.value(kind); }
+
+    /** The URLs `url` can be downloaded from, the one to try first first. Only `url` when it isn't under the official base. */
+    QList<QUrl> route(Kind kind, const QUrl& url) const;
+
+    /** `latency_ms` until the reply started to come in, then `bytes` in `elapsed_ms` in all. */
+    void reportSuccess(const QUrl& url, qint64 latency_ms, qint64 bytes, qint64 elapsed_ms);
+    void reportFailure(const QUrl& url);
+
+    /** Whether the mirror of `url` isn't backing off. */
+    bool isHealthy(const QUrl& url) const;
+
+    /** Base URLs separated by commas or whitespace, with the trailing slash added where it's missing. */
+    static QStringList parse(const QString& mirrors);
+
+   private:
+    // seconds
+    static constexpr unsigned s_min_backoff = 5;
+    static constexpr unsigned s_max_backoff = 300;
+
+    struct Mirror {
+        // -1 until measured
+        double latency_ms = -1;
+        double bytes_per_ms = -1;
+        qint64 retry_after = 0;
+        ExponentialSeries backoff{ s_min_backoff, s_max_backoff };
+    };
+
+    QString baseOf(const QUrl& url) const;
+    double estimate(Kind kind, const QString& base) const;
+
+   private:
+    std::function<qint64()> m_now;
+    QMap<Kind, QString> m_official;
+    // official last
+    QMap<Kind, QStringList> m_bases;
+    QHash<QString, Mirror> m_mirrors;
+};
+
+}  // namespace Net
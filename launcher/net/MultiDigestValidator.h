@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QCryptographicHash>
+
+#include <memory>
+
+#include <MurmurHash2.h>
+
+#include "Validator.h"
+#include "digest/Digest.h"
+#include "modplatform/helpers/HashUtils.h"
+
+namespace Net {
+
+/* Computes every hash a mod platform may ask for (see Hashing::FileHashes) while the file comes in.
+ *
+ * The hashes go to `output` once the download is validated, so they can be put in the hash cache and the file never
+ * needs to be read again to be looked up. The CurseForge fingerprint needs the whole file before it can start, so the
+ * data is kept for it, unless the file is too big for that, then it's left out.
+ */
+class MultiDigestValidator : public Validator {
+   public:
+    MultiDigestValidator(std::shared_ptr<Hashing::FileHashes> output,
+                         QCryptographicHash::Algorithm algorithm = QCryptographicHash::Sha1,
+                         QByteArray expected = QByteArray())
+        : m_output(std::move(output)), m_algorithm(algorithm), m_expected(expected)
+    {
+        if (m_algorithm != QCryptographicHash::Md5 && m_algorithm != QCryptographicHash::Sha1 && m_algorithm != QCryptographicHash::Sha512)
+            m_other.reset(new Digest(m_algorithm));
+    }
+    virtual ~MultiDigestValidator() = default;
+
+   public:
+    auto init(QNetworkRequest&) -> bool override
+    {
+        m_md5.reset();
+        m_sha1.reset();
+        m_sha512.reset();
+        if (m_other)
+            m_other->reset();
+        m_data.clear();
+        m_too_big = false;
+        *m_output = {};
+        return true;
+    }
+
+    auto write(QByteArray& data) -> bool override
+    {
+        m_md5.addData(data);
+        m_sha1.addData(data);
+        m_sha512.addData(data);
+        if (m_other)
+            m_other->addData(data);
+
+        if (!m_too_big && m_data.size() + data.size() > s_max_fingerprint_size) {
+            m_too_big = true;
+            m_data = QByteArray();
+        }
+        if (!m_too_big)
+            m_data.append(data);
+        return true;
+    }
+
+    auto abort() -> bool override
+    {
+        m_data = QByteArray();
+        return true;
+    }
+
+    auto validate(QNetworkReply&) -> bool override
+    {
+        auto md5 = m_md5.result();
+        auto sha1 = m_sha1.result();
+        auto sha512 = m_sha512.result();
+
+        if (m_expected.size()) {
+            QByteArray actual;
+            switch (m_algorithm) {
+                case QCryptographicHash::Md5:
+                    actual = md5;
+                    break;
+                case QCryptographicHash::Sha1:
+                    actual = sha1;
+                    break;
+                case QCryptographicHash::Sha512:
+                    actual = sha512;
+                    break;
+                default:
+                    actual = m_other->result();
+                    break;
+            }
+            if (actual != m_expected) {
+                qWarning() << "Checksum mismatch, download is bad.";
+                m_data = QByteArray();
+                return false;
+            }
+        }
+
+        Hashing::FileHashes hashes;
+        hashes.md5 = md5.toHex();
+        hashes.sha1 = sha1.toHex();
+        hashes.sha512 = sha512.toHex();
+        if (m_algorithm == QCryptographicHash::Sha256)
+            hashes.sha256 = m_other->result().toHex();
+        if (!m_too_big)
+            hashes.murmur2 = QString::number(CurseForgeFingerprint(m_data.constData(), m_data.size()));
+        m_data = QByteArray();
+        *m_output = hashes;
+        return true;
+    }
+
+   private:
+    // mods are much smaller than that, what's bigger isn't looked up on CurseForge
+    static constexpr qsizetype s_max_fingerprint_size = 64 * 1024 * 1024;
+
+    std::shared_ptr<Hashing::FileHashes> m_output;
+    QCryptographicHash::Algorithm m_algorithm;
+    QByteArray m_expected;
+
+    QCryptographicHash m_md5{ QCryptographicHash::Md5 };
+    Digest m_sha1{ QCryptographicHash::Sha1 };
+    Digest m_sha512{ QCryptographicHash::Sha512 };
+    // for an expected hash of another kind
+    std::unique_ptr<Digest> m_other;
+
+    QByteArray m_data;
+    bool m_too_big = false;
+};
+
+}  // namespace Net
@@ -36,10 +36,12 @@
 
 #pragma once
 
+#include <QDateTime>
 #include <QNetworkReply>
 #include <QUrl>
 
 #include "QObjectPtr.h"
+#include "net/HostPool.h"
 #include "tasks/Task.h"
 
 class NetAction : public Task {
@@ -56,6 +58,21 @@ class NetAction : public Task {
 
     void setNetwork(shared_qobject_ptr<QNetworkAccessManager> network) { m_network = network; }
 
+    void setPriority(Net::Priority priority) { m_priority = priority; }
+
+    /** The NetJob it's part of, what its requests are told apart by in the Net::Diagnostics. */
+    void setJobName(QString name) { m_job_name = std::move(name); }
+    Net::Priority priority() const { return m_priority; }
+
+    /** What the last attempt failed with, as far as the network is concerned. */
+    struct Failure {
+        QNetworkReply::NetworkError error = QNetworkReply::NoError;
+        int http_status = 0;
+        // in seconds, when the server said when to come back
+        int retry_after = -1;
+    };
+    Failure lastFailure() const { return m_failure; }
+
    protected slots:
     virtual void downloadProgress(qint64 bytesReceived, qint64 bytesTotal) = 0;
     virtual void downloadError(QNetworkReply::NetworkError error) = 0;
@@ -83,6 +100,28 @@ class NetAction : public Task {
    protected:
     void executeTask() override{};
 
+    /** Remembers why `reply` failed, for whoever decides whether it's worth another try. */
+    void noteFailure(QNetworkReply& reply, QNetworkReply::NetworkError error)
+    {
+        m_failure.error = error;
+        m_failure.http_status = reply.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        m_failure.retry_after = -1;
+
+        // either a number of seconds or a date
+        auto retry_after = QString::fromLatin1(reply.rawHeader("Retry-After")).trimmed();
+        if (retry_after.isEmpty())
+            return;
+        bool ok = false;
+        auto seconds = retry_after.toInt(&ok);
+        if (!ok) {
+            auto date = QDateTime::fromString(retry_after, Qt::RFC2822Date);
+            ok = date.isValid();
+            seconds = ok ? int(QDateTime::currentDateTimeUtc().secsTo(date)) : seconds;
+        }
+        if (ok)
+            m_failure.retry_after = qMax(0, seconds);
+    }
+
    public:
     shared_qobject_ptr<QNetworkAccessManager> m_network;
 
@@ -91,4 +130,11 @@ class NetAction : public Task {
 
     /// source URL
     QUrl m_url;
+
+    /// how the HostPool schedules this request against the others
+    Net::Priority m_priority = Net::Priority::Launch;
+
+    Failure m_failure;
+
+    QString m_job_name;
 };
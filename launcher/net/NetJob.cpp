@@ -37,32 +37,175 @@
 
 #include "NetJob.h"
 
+#include <QFutureWatcher>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include "Application.h"
+#include "Executors.h"
+
+namespace {
+// however long a server asks us to wait, it's not worth waiting longer than that
+constexpr int s_max_retry_after_ms = 2 * 60 * 1000;
+
+// how many more tries an action gets after failing the way it did
+auto retryBudget(const NetAction::Failure& failure) -> int
+{
+    auto status = failure.http_status;
+    if (status == 429)
+        return 4;
+    if (status >= 500)
+        return 3;
+    // the server understood, and said no
+    if (status >= 400)
+        return 0;
+
+    switch (failure.error) {
+        // a reply that times out gets canceled
+        case QNetworkReply::OperationCanceledError:
+        case QNetworkReply::TimeoutError:
+            return 3;
+        case QNetworkReply::HostNotFoundError:
+            return 1;
+        default:
+            return 2;
+    }
+}
+}  // namespace
+
+NetJob::NetJob(QString job_name, shared_qobject_ptr<QNetworkAccessManager> network)
+    : ConcurrentTask(nullptr, job_name, APPLICATION->settings()->get("NumberOfConcurrentDownloads").toInt()), m_network(network)
+{
+    // the setting is the most it goes up to
+    setConcurrency(Concurrency::Adaptive);
+}
+
 auto NetJob::addNetAction(NetAction::Ptr action) -> bool
 {
     action->setNetwork(m_network);
+    action->setPriority(m_priority);
+    action->setJobName(objectName());
 
     addTask(action);
 
     return true;
 }
 
-void NetJob::startNext()
+void NetJob::setPriority(Net::Priority priority)
 {
-    if (m_queue.isEmpty() && m_doing.isEmpty()) {
-        // We're finished, check for failures and retry if we can (up to 3 times)
-        if (!m_failed.isEmpty() && m_try < 3) {
-            m_try += 1;
-            while (!m_failed.isEmpty())
-                m_queue.enqueue(m_failed.take(*m_failed.keyBegin()));
-        }
+    m_priority = priority;
+    for (auto& task : m_queue) {
+        if (auto action = dynamic_cast<NetAction*>(task.get()))
+            action->setPriority(priority);
     }
+}
+
+void NetJob::startNext()
+{
+    // not done before the actions that failed had all of their tries
+    if (m_queue.isEmpty() && m_doing.isEmpty() && !m_retrying.isEmpty())
+        return;
 
     ConcurrentTask::startNext();
 }
 
+void NetJob::subTaskFailed(Task::Ptr task, const QString& msg)
+{
+    auto action = dynamic_cast<NetAction*>(task.get());
+    if (!action || !isRunning() || m_retries[task.get()].attempts >= retryBudget(action->lastFailure())) {
+        m_retries.remove(task.get());
+        ConcurrentTask::subTaskFailed(task, msg);
+        return;
+    }
+
+    auto failure = action->lastFailure();
+    auto& retry = m_retries[task.get()];
+    retry.attempts += 1;
+    int delay_ms = int(retry.backoff());
+    delay_ms += QRandomGenerator::global()->bounded(delay_ms / 2 + 1);
+    if (failure.retry_after >= 0)
+        delay_ms = qMin(qMax(delay_ms, failure.retry_after * 1000), s_max_retry_after_ms);
+
+    qDebug() << "Retrying" << action->url().toString() << "in" << delay_ms << "ms, it failed with" << failure.error
+             << failure.http_status;
+
+    // it leaves its slot to the next one while it waits
+    m_doing.remove(task.get());
+    tuneConcurrency(task.get(), false);
+    m_retrying.insert(task.get(), task);
+    disconnect(task.get(), 0, this, 0);
+
+    auto task_progress = m_task_progress.value(task->getUid());
+    task_progress->state = TaskStepState::Running;
+    task_progress->status = tr("Retrying in %1 s (try %2 of %3)")
+                                .arg(QString::number((delay_ms + 999) / 1000), QString::number(retry.attempts + 1),
+                                     QString::number(retryBudget(failure) + 1));
+    emit stepProgress(*task_progress);
+    updateState();
+    updateStepProgress(*task_progress, Operation::REMOVED);
+
+    QTimer::singleShot(delay_ms, this, [this, task] {
+        if (!m_retrying.remove(task.get()) || !isRunning())
+            return;
+        m_queue.prepend(task);
+        startNext();
+    });
+
+    startNext();
+}
+
+void NetJob::addResponseProcessor(ResponseProcessor prepare)
+{
+    m_processors.append(std::move(prepare));
+}
+
+void NetJob::emitSucceeded()
+{
+    // the downloads are done, the processing may not be
+    if (m_processing)
+        return;
+    m_retries.clear();
+    if (m_processors.isEmpty()) {
+        ConcurrentTask::emitSucceeded();
+        return;
+    }
+
+    m_processing = true;
+    setStatus(tr("Processing the responses..."));
+    QList<std::function<QString()>> steps;
+    for (auto& prepare : m_processors)
+        steps.append(prepare());
+
+    auto future = QtConcurrent::run(Executors::cpu(), [steps] {
+        for (auto& step : steps) {
+            auto error = step();
+            if (!error.isEmpty())
+                return error;
+        }
+        return QString();
+    });
+
+    auto watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher] {
+        auto error = watcher->result();
+        watcher->deleteLater();
+        m_processing = false;
+
+        // aborted while it was at it
+        if (!isRunning())
+            return;
+        if (error.isEmpty())
+            ConcurrentTask::emitSucceeded();
+        else
+            emitFailed(error);
+    });
+    watcher->setFuture(future);
+}
+
 auto NetJob::size() const -> int
 {
-    return m_queue.size() + m_doing.size() + m_done.size();
+    return m_queue.size() + m_doing.size() + m_done.size() + m_retrying.size();
 }
 
 auto NetJob::canAbort() const -> bool
@@ -84,10 +227,13 @@ auto NetJob::abort() -> bool
 {
     bool fullyAborted = true;
 
-    // fail all downloads on the queue
+    // fail all downloads on the queue, and those waiting for another try
     for (auto task : m_queue)
         m_failed.insert(task.get(), task);
     m_queue.clear();
+    for (auto task : m_retrying)
+        m_failed.insert(task.get(), task);
+    m_retrying.clear();
 
     // abort active downloads
     auto toKill = m_doing.values();
@@ -123,7 +269,14 @@ auto NetJob::getFailedFiles() -> QList<QString>
 
 void NetJob::updateState()
 {
-    emit progress(m_done.count(), totalSize());
-    setStatus(tr("Executing %1 task(s) (%2 out of %3 are done)")
-                  .arg(QString::number(m_doing.count()), QString::number(m_done.count()), QString::number(totalSize())));
+    emit progress(m_done.count(), size());
+    if (m_retrying.isEmpty()) {
+        setStatus(tr("Executing %1 task(s) (%2 out of %3 are done%4)")
+                      .arg(QString::number(m_doing.count()), QString::number(m_done.count()), QString::number(size()),
+                           concurrencyStatus()));
+    } else {
+        setStatus(tr("Executing %1 task(s) (%2 out of %3 are done, %4 waiting to retry%5)")
+                      .arg(QString::number(m_doing.count()), QString::number(m_done.count()), QString::number(size()),
+                           QString::number(m_retrying.count()), concurrencyStatus()));
+    }
 }
@@ -39,6 +39,8 @@
 #include <QtNetwork>
 
 #include <QObject>
+#include <functional>
+#include "ExponentialSeries.h"
 #include "NetAction.h"
 #include "tasks/ConcurrentTask.h"
 
@@ -46,13 +48,20 @@
 #include "net/Download.h"
 #include "net/HttpMetaCache.h"
 
+/* Runs NetActions, a few at once.
+ *
+ * An action that fails goes back on the queue on its own, after a while that doubles with every try (with some jitter,
+ * so the actions that failed together don't come back together). How many tries it gets depends on why it failed: a
+ * server that's overloaded or says when to come back gets more of them than a name that doesn't resolve, and a
+ * request the server turned down (4xx) gets none. The job only finishes once no action is waiting for another try.
+ */
 class NetJob : public ConcurrentTask {
     Q_OBJECT
 
    public:
     using Ptr = shared_qobject_ptr<NetJob>;
 
-    explicit NetJob(QString job_name, shared_qobject_ptr<QNetworkAccessManager> network) : ConcurrentTask(nullptr, job_name), m_network(network) {}
+    explicit NetJob(QString job_name, shared_qobject_ptr<QNetworkAccessManager> network);
     ~NetJob() override = default;
 
     void startNext() override;
@@ -62,18 +71,42 @@ class NetJob : public ConcurrentTask {
     auto canAbort() const -> bool override;
     auto addNetAction(NetAction::Ptr action) -> bool;
 
+    /** Priority of the requests of this job, against those of every other job. Launch-blocking by default. */
+    void setPriority(Net::Priority priority);
+
     auto getFailedActions() -> QList<NetAction*>;
     auto getFailedFiles() -> QList<QString>;
 
+    /* Makes something of the responses on the global thread pool, and only succeeds once that's done.
+     *
+     * `prepare` is called on the job's thread when everything is downloaded, and gives what to run on the pool.
+     * That returns why the job fails, or nothing when it went fine. See Net::processJson for the usual case.
+     */
+    using ResponseProcessor = std::function<std::function<QString()>()>;
+    void addResponseProcessor(ResponseProcessor prepare);
+
    public slots:
     // Qt can't handle auto at the start for some reason?
     bool abort() override;
 
+   protected slots:
+    void emitSucceeded() override;
+    void subTaskFailed(Task::Ptr task, const QString& msg) override;
+
    protected:
     void updateState() override;
 
    private:
     shared_qobject_ptr<QNetworkAccessManager> m_network;
+    Net::Priority m_priority = Net::Priority::Launch;
+    QList<ResponseProcessor> m_processors;
+    bool m_processing = false;
 
-    int m_try = 1;
+    struct Retry {
+        int attempts = 0;
+        ExponentialSeries backoff{ 1000, 30000 };
+    };
+    QHash<Task*, Retry> m_retries;
+    // the actions that failed and wait for their next try
+    QHash<Task*, Task::Ptr> m_retrying;
 };
@@ -47,6 +47,7 @@
 #include <QFile>
 #include <QUrlQuery>
 
+#include "launch/LogCompactor.h"
 #include "net/Logging.h"
 
 std::array<PasteUpload::PasteTypeInfo, 4> PasteUpload::PasteTypes = {
@@ -55,7 +56,8 @@ std::array<PasteUpload::PasteTypeInfo, 4> PasteUpload::PasteTypes = {
      {"paste.gg", "https://paste.gg", "/api/v1/pastes"},
      {"mclo.gs", "https://api.mclo.gs", "/1/log"}}};
 
-PasteUpload::PasteUpload(QWidget *window, QString text, QString baseUrl, PasteType pasteType) : m_window(window), m_baseUrl(baseUrl), m_pasteType(pasteType), m_text(text.toUtf8())
+PasteUpload::PasteUpload(QWidget *window, QString text, QString baseUrl, PasteType pasteType, const QVector<MessageLevel::Enum> &levels)
+    : m_window(window), m_baseUrl(baseUrl), m_pasteType(pasteType), m_text(LogCompactor().compact(text, levels).toUtf8())
 {
     if (m_baseUrl == "")
         m_baseUrl = PasteTypes.at(pasteType).defaultBase;
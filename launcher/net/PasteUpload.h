@@ -36,9 +36,11 @@
 #pragma once
 
 #include "tasks/Task.h"
+#include "MessageLevel.h"
 #include <QNetworkReply>
 #include <QString>
 #include <QBuffer>
+#include <QVector>
 #include <memory>
 #include <array>
 
@@ -68,7 +70,8 @@ public:
 
     static std::array<PasteTypeInfo, 4> PasteTypes;
 
-    PasteUpload(QWidget *window, QString text, QString url, PasteType pasteType);
+    /* The log is compacted before it's uploaded, see LogCompactor. 'levels' are the levels of its lines, if known. */
+    PasteUpload(QWidget *window, QString text, QString url, PasteType pasteType, const QVector<MessageLevel::Enum> &levels = {});
     virtual ~PasteUpload();
 
     QString pasteLink()
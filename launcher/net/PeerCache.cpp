@@ -0,0 +1,336 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "PeerCache.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QNetworkDatagram>
+#include <QRegularExpression>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUdpSocket>
+#include <QUuid>
+
+#include <algorithm>
+
+#include "ContentStore.h"
+
+namespace Net {
+
+namespace {
+const QByteArray s_announce_magic = "MIO-PEER-CACHE 1";
+constexpr int s_announce_interval_ms = 5 * 1000;
+// a peer that didn't say it's there for that long is gone
+constexpr qint64 s_peer_timeout_ms = 30 * 1000;
+// how long a peer that failed a download is left out
+constexpr qint64 s_failure_backoff_ms = 60 * 1000;
+// the peers a download tries before going to the origin
+constexpr int s_max_routes = 3;
+// the downloads served at once, past that the peers are told to go elsewhere
+constexpr int s_max_uploads = 4;
+// the request has to come in by then
+constexpr int s_request_timeout_ms = 10 * 1000;
+constexpr qint64 s_chunk_size = 64 * 1024;
+constexpr qint64 s_max_buffered = 4 * s_chunk_size;
+constexpr int s_max_request_size = 8 * 1024;
+
+const QString s_path_prefix = "/store/";
+
+/* Serves one object of the store to one peer, and goes away with the connection. */
+class PeerUpload : public QObject {
+   public:
+    PeerUpload(QTcpSocket* socket, std::function<bool()> begin, std::function<void()> end)
+        : QObject(socket), m_socket(socket), m_begin(std::move(begin)), m_end(std::move(end))
+    {
+        connect(m_socket, &QTcpSocket::readyRead, this, [this] { readRequest(); });
+        connect(m_socket, &QTcpSocket::bytesWritten, this, [this] { pump(); });
+        connect(m_socket, &QTcpSocket::disconnected, m_socket, &QObject::deleteLater);
+        QTimer::singleShot(s_request_timeout_ms, this, [this] {
+            if (!m_answered)
+                m_socket->abort();
+        });
+    }
+
+    ~PeerUpload() override
+    {
+        if (m_uploading)
+            m_end();
+    }
+
+   private:
+    void readRequest()
+    {
+        if (m_answered)
+            return;
+        m_request += m_socket->readAll();
+        if (m_request.size() > s_max_request_size) {
+            m_socket->abort();
+            return;
+        }
+        if (!m_request.contains("\r\n\r\n"))
+            return;
+
+        m_answered = true;
+        auto request_line = QString::fromLatin1(m_request.left(m_request.indexOf("\r\n"))).split(' ');
+        if (request_line.size() != 3 || (request_line[0] != "GET" && request_line[0] != "HEAD")) {
+            reply("400 Bad Request");
+            return;
+        }
+        bool head = request_line[0] == "HEAD";
+
+        auto path = objectPath(request_line[1]);
+        if (path.isEmpty() || !ContentStore::isEnabled()) {
+            reply("404 Not Found");
+            return;
+        }
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            reply("404 Not Found");
+            return;
+        }
+        if (!head) {
+            if (!m_begin()) {
+                reply("503 Service Unavailable");
+                return;
+            }
+            m_uploading = true;
+        }
+
+        m_socket->write(QString("HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: %1\r\nConnection: close\r\n\r\n")
+                            .arg(m_file.size())
+                            .toLatin1());
+        if (head)
+            m_socket->disconnectFromHost();
+        else
+            pump();
+    }
+
+    void pump()
+    {
+        if (!m_uploading)
+            return;
+        while (m_socket->bytesToWrite() < s_max_buffered && !m_file.atEnd()) {
+            auto chunk = m_file.read(s_chunk_size);
+            if (chunk.isEmpty())
+                break;
+            m_socket->write(chunk);
+        }
+        if (m_file.atEnd() && m_socket->bytesToWrite() == 0)
+            m_socket->disconnectFromHost();
+    }
+
+    void reply(const QString& status)
+    {
+        m_socket->write(QString("HTTP/1.1 %1\r\nContent-Length: 0\r\nConnection: close\r\n\r\n").arg(status).toLatin1());
+        m_socket->disconnectFromHost();
+    }
+
+    /** The object a request is for, nothing unless it names one the way the store does. */
+    static QString objectPath(const QString& target)
+    {
+        if (!target.startsWith(s_path_prefix))
+            return {};
+        auto parts = target.mid(s_path_prefix.size()).split('/');
+        if (parts.size() != 2)
+            return {};
+
+        auto algorithm = ContentStore::algorithmFromName(parts[0]);
+        static const QRegularExpression s_hex("^[0-9a-f]+$");
+        if (!algorithm || !s_hex.match(parts[1]).hasMatch() || parts[1].size() != 2 * QCryptographicHash::hashLength(*algorithm))
+            return {};
+
+        auto path = ContentStore::objectPath(*algorithm, QByteArray::fromHex(parts[1].toLatin1()));
+        return QFile::exists(path) ? path : QString();
+    }
+
+   private:
+    QTcpSocket* m_socket;
+    std::function<bool()> m_begin;
+    std::function<void()> m_end;
+    QByteArray m_request;
+    QFile m_file;
+    bool m_answered = false;
+    bool m_uploading = false;
+};
+}  // namespace
+
+PeerCache::PeerCache(std::function<qint64()> now, QObject* parent)
+    : QObject(parent), m_now(std::move(now)), m_id(QUuid::createUuid().toString(QUuid::WithoutBraces))
+{
+    m_announce_timer.setInterval(s_announce_interval_ms);
+    connect(&m_announce_timer, &QTimer::timeout, this, &PeerCache::announce);
+}
+
+PeerCache::~PeerCache()
+{
+    // the uploads still going on count themselves out of m_uploads
+    delete m_server;
+}
+
+void PeerCache::setEnabled(bool enabled)
+{
+    if (enabled == m_enabled)
+        return;
+    m_enabled = enabled;
+
+    if (!enabled) {
+        m_announce_timer.stop();
+        delete m_socket;
+        m_socket = nullptr;
+        delete m_server;
+        m_server = nullptr;
+        m_peers.clear();
+        return;
+    }
+
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this, &PeerCache::acceptConnection);
+    if (!m_server->listen(QHostAddress::AnyIPv4))
+        qWarning() << "The LAN cache can't serve the store:" << m_server->errorString();
+
+    m_socket = new QUdpSocket(this);
+    connect(m_socket, &QUdpSocket::readyRead, this, &PeerCache::readDatagrams);
+    if (!m_socket->bind(QHostAddress::AnyIPv4, s_discovery_port, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint))
+        qWarning() << "The LAN cache can't listen for other launchers:" << m_socket->errorString();
+
+    m_announce_timer.start();
+    announce();
+}
+
+void PeerCache::announce()
+{
+    if (!m_socket || !m_server || !m_server->isListening())
+        return;
+    auto datagram = s_announce_magic + ' ' + m_id.toLatin1() + ' ' + QByteArray::number(m_server->serverPort());
+    m_socket->writeDatagram(datagram, QHostAddress::Broadcast, s_discovery_port);
+}
+
+void PeerCache::readDatagrams()
+{
+    while (m_socket && m_socket->hasPendingDatagrams()) {
+        auto datagram = m_socket->receiveDatagram(512);
+        auto parts = datagram.data().split(' ');
+        // the magic has a space in it
+        if (parts.size() != 4 || parts[0] + ' ' + parts[1] != s_announce_magic)
+            continue;
+
+        auto id = QString::fromLatin1(parts[2]);
+        bool ok = false;
+        auto port = parts[3].toUShort(&ok);
+        if (!ok || id == m_id)
+            continue;
+        notePeer(id, datagram.senderAddress(), port);
+    }
+}
+
+void PeerCache::acceptConnection()
+{
+    while (m_server && m_server->hasPendingConnections()) {
+        auto socket = m_server->nextPendingConnection();
+        if (!isPrivateAddress(socket->peerAddress())) {
+            socket->abort();
+            socket->deleteLater();
+            continue;
+        }
+        new PeerUpload(
+            socket,
+            [this] {
+                if (m_uploads >= s_max_uploads)
+                    return false;
+                m_uploads += 1;
+                return true;
+            },
+            [this] { m_uploads -= 1; });
+    }
+}
+
+void PeerCache::notePeer(const QString& id, const QHostAddress& address, quint16 port)
+{
+    if (!isPrivateAddress(address) || port == 0)
+        return;
+
+    auto& peer = m_peers[id];
+    if (peer.address != address || peer.port != port)
+        qDebug() << "Found a launcher sharing its downloads at" << address.toString() << port;
+    peer.address = address;
+    peer.port = port;
+    peer.last_seen = m_now();
+}
+
+int PeerCache::peerCount() const
+{
+    return int(std::count_if(m_peers.begin(), m_peers.end(), [this](const Peer& peer) { return isAlive(peer); }));
+}
+
+bool PeerCache::isAlive(const Peer& peer) const
+{
+    auto now = m_now();
+    return now - peer.last_seen < s_peer_timeout_ms && peer.failed_until <= now;
+}
+
+QList<QUrl> PeerCache::routes(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const
+{
+    auto name = ContentStore::algorithmName(algorithm);
+    if (name.isEmpty() || hash.isEmpty())
+        return {};
+    auto hex = hash.toHex();
+
+    // each object orders the peers its own way, so they share the work
+    QList<QPair<QByteArray, const Peer*>> ranked;
+    for (auto it = m_peers.begin(); it != m_peers.end(); ++it) {
+        if (isAlive(it.value()))
+            ranked.append({ QCryptographicHash::hash(it.key().toLatin1() + hex, QCryptographicHash::Sha1), &it.value() });
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    QList<QUrl> urls;
+    for (auto& entry : ranked) {
+        if (urls.size() >= s_max_routes)
+            break;
+        auto peer = entry.second;
+        QUrl url;
+        url.setScheme("http");
+        url.setHost(peer->address.toString());
+        url.setPort(peer->port);
+        url.setPath(s_path_prefix + name + '/' + QString::fromLatin1(hex));
+        urls.append(url);
+    }
+    return urls;
+}
+
+bool PeerCache::isPeerUrl(const QUrl& url) const
+{
+    if (!url.path().startsWith(s_path_prefix))
+        return false;
+    QHostAddress address(url.host());
+    return std::any_of(m_peers.begin(), m_peers.end(),
+                       [&](const Peer& peer) { return peer.address == address && peer.port == url.port(); });
+}
+
+void PeerCache::reportFailure(const QUrl& url)
+{
+    QHostAddress address(url.host());
+    for (auto& peer : m_peers) {
+        if (peer.address == address && peer.port == url.port())
+            peer.failed_until = m_now() + s_failure_backoff_ms;
+    }
+}
+
+bool PeerCache::isPrivateAddress(const QHostAddress& address)
+{
+    if (address.isLoopback())
+        return true;
+
+    bool is_ipv4 = false;
+    auto ipv4 = address.toIPv4Address(&is_ipv4);
+    if (is_ipv4) {
+        return (ipv4 >> 24) == 10                // 10.0.0.0/8
+               || (ipv4 >> 20) == 0xAC1          // 172.16.0.0/12
+               || (ipv4 >> 16) == 0xC0A8         // 192.168.0.0/16
+               || (ipv4 >> 16) == 0xA9FE;        // 169.254.0.0/16
+    }
+
+    return address.isInSubnet(QHostAddress("fe80::"), 10) || address.isInSubnet(QHostAddress("fc00::"), 7);
+}
+
+}  // namespace Net
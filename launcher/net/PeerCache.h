@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QHash>
+#include <QHostAddress>
+#include <QObject>
+#include <QTimer>
+#include <QUrl>
+
+#include <functional>
+
+class QTcpServer;
+class QUdpSocket;
+
+namespace Net {
+
+/* Launchers on the same LAN getting the files of each other's shared store (see ContentStore) instead of the internet.
+ *
+ * Each launcher that has it enabled says it's there with a UDP broadcast every few seconds, and serves the objects of
+ * its store over plain HTTP, as `/store/<algorithm>/<hex hash>`. A download that knows the hash of what it gets (see
+ * Download::makeStored()) asks the peers for it before the origin, and the hash is checked the same as for any other
+ * download, so a peer can't give something else. Each object has its own order of the peers (rendezvous hashing), so
+ * several downloads at once spread over all of them; a peer that's busy serving says so, and the next is tried.
+ *
+ * Only addresses of private networks are taken as peers.
+ */
+class PeerCache : public QObject {
+    Q_OBJECT
+   public:
+    static constexpr quint16 s_discovery_port = 45712;
+
+    explicit PeerCache(std::function<qint64()> now = &QDateTime::currentMSecsSinceEpoch, QObject* parent = nullptr);
+    ~PeerCache() override;
+
+    /** Starts or stops announcing, listening for the other launchers, and serving the store. */
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    /** The URLs the object could come from on the LAN, in the order to try them. */
+    QList<QUrl> routes(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const;
+    bool isPeerUrl(const QUrl& url) const;
+    /** Leaves the peer out for a while. */
+    void reportFailure(const QUrl& url);
+
+    /** Takes in what a launcher said about itself, ignored unless it's on a private network. */
+    void notePeer(const QString& id, const QHostAddress& address, quint16 port);
+    int peerCount() const;
+
+    static bool isPrivateAddress(const QHostAddress& address);
+
+   private slots:
+    void announce();
+    void readDatagrams();
+    void acceptConnection();
+
+   private:
+    struct Peer {
+        QHostAddress address;
+        quint16 port = 0;
+        qint64 last_seen = 0;
+        qint64 failed_until = 0;
+    };
+    bool isAlive(const Peer& peer) const;
+
+   private:
+    std::function<qint64()> m_now;
+    bool m_enabled = false;
+    QString m_id;
+
+    QUdpSocket* m_socket = nullptr;
+    QTcpServer* m_server = nullptr;
+    QTimer m_announce_timer;
+    int m_uploads = 0;
+
+    // by the id they announced
+    QHash<QString, Peer> m_peers;
+};
+
+}  // namespace Net
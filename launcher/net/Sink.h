@@ -46,13 +46,26 @@ class Sink {
     virtual ~Sink() = default;
 
    public:
+    /** Inactive means the target is being written by someone else right now, and init should be tried again later. */
     virtual auto init(QNetworkRequest& request) -> Task::State = 0;
     virtual auto write(QByteArray& data) -> Task::State = 0;
     virtual auto abort() -> Task::State = 0;
     virtual auto finalize(QNetworkReply& reply) -> Task::State = 0;
+    /** Called once the headers of the reply are in, before any data is written. */
+    virtual auto headersReceived(QNetworkReply&) -> Task::State { return Task::State::Running; }
 
     virtual auto hasLocalData() -> bool = 0;
 
+    /** Whether, after init(), the file can be taken in segments that come in at once, see Download::Option::Segmented. */
+    virtual auto canWriteSegments() -> bool { return false; }
+    /** Instead of write(): the file is `size` bytes, and writeAt() gets its parts in any order. */
+    virtual auto beginSegments(qint64) -> Task::State { return Task::State::Failed; }
+    virtual auto writeAt(qint64, QByteArray&) -> Task::State { return Task::State::Failed; }
+    /** Whether finalize() left something else than what was there before, false when the server said it didn't change. */
+    virtual auto changedContent() -> bool { return true; }
+    /** Whether it keeps what it gets, so its requests are cache hits or misses, see Net::Diagnostics. */
+    virtual auto isCache() -> bool { return false; }
+
     void addValidator(Validator* validator)
     {
         if (validator) {
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "StoreSink.h"
+
+#include "ContentStore.h"
+
+#include "net/Logging.h"
+
+namespace Net {
+
+StoreSink::StoreSink(QString filename, QCryptographicHash::Algorithm algorithm, QByteArray expected)
+    : FileSink(filename), m_algorithm(algorithm), m_expected(expected)
+{
+    addValidator(new ChecksumValidator(algorithm, expected));
+}
+
+Task::State StoreSink::initCache(QNetworkRequest&)
+{
+    if (ContentStore::materialize(m_algorithm, m_expected, m_filename)) {
+        qCDebug(taskNetLogC) << "Using stored object for" << m_filename;
+        return Task::State::Succeeded;
+    }
+
+    return Task::State::Running;
+}
+
+Task::State StoreSink::finalizeCache(QNetworkReply&)
+{
+    // the validators already made sure this is the file we expected
+    if (wroteAnyData && !ContentStore::insert(m_algorithm, m_expected, m_filename))
+        qCWarning(taskNetLogC) << "Could not add" << m_filename << "to the content store";
+
+    return Task::State::Succeeded;
+}
+
+}  // namespace Net
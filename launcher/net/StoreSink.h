@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "ChecksumValidator.h"
+#include "FileSink.h"
+
+namespace Net {
+
+/** A FileSink backed by the launcher-wide ContentStore.
+ *
+ *  If an object with the expected hash was already stored, it is linked into place and no
+ *  request is made at all. Otherwise the file is downloaded and verified as usual, and then
+ *  added to the store so the next instance that needs it can reuse it.
+ */
+class StoreSink : public FileSink {
+   public:
+    StoreSink(QString filename, QCryptographicHash::Algorithm algorithm, QByteArray expected);
+    virtual ~StoreSink() = default;
+
+    auto isCache() -> bool override { return true; }
+
+   protected:
+    auto initCache(QNetworkRequest&) -> Task::State override;
+    auto finalizeCache(QNetworkReply& reply) -> Task::State override;
+
+   private:
+    QCryptographicHash::Algorithm m_algorithm;
+    QByteArray m_expected;
+};
+
+}  // namespace Net
@@ -246,6 +246,10 @@ namespace Net {
         connect(rep, &QNetworkReply::readyRead, this, &Upload::downloadReadyRead);
     }
 
+    void Upload::addValidator(Validator* v) {
+        m_sink->addValidator(v);
+    }
+
     Upload::Ptr Upload::makeByteArray(QUrl url, QByteArray *output, QByteArray m_post_data) {
         auto up = makeShared<Upload>();
         up->m_url = std::move(url);
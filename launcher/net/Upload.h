@@ -49,6 +49,7 @@ namespace Net {
         using Ptr = shared_qobject_ptr<Upload>;
 
         static Upload::Ptr makeByteArray(QUrl url, QByteArray *output, QByteArray m_post_data);
+        void addValidator(Validator* v);
         auto abort() -> bool override;
         auto canAbort() const -> bool override { return true; };
 
@@ -36,10 +36,18 @@
 #include "NewsChecker.h"
 
 #include <QByteArray>
+#include <QCoreApplication>
 #include <QDomDocument>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QThread>
+#include <QtConcurrent>
 
 #include <QDebug>
 
+#include "Application.h"
+#include "Executors.h"
+
 NewsChecker::NewsChecker(shared_qobject_ptr<QNetworkAccessManager> network, const QString& feedUrl)
 {
     m_network = network;
@@ -57,8 +65,13 @@ void NewsChecker::reloadNews()
 
     qDebug() << "Reloading news.";
 
+    // asked for every time, with the ETag of the copy in the cache, so an unchanged feed isn't sent again
+    m_newsEntry = APPLICATION->metacache()->resolveEntry("general", "news.xml");
+    m_newsEntry->setStale(true);
+
     NetJob::Ptr job{ new NetJob("News RSS Feed", m_network) };
-    job->addNetAction(Net::Download::makeByteArray(m_feedUrl, &newsData));
+    job->setPriority(Net::Priority::Background);
+    job->addNetAction(Net::Download::makeCached(m_feedUrl, m_newsEntry));
     QObject::connect(job.get(), &NetJob::succeeded, this, &NewsChecker::rssDownloadFinished);
     QObject::connect(job.get(), &NetJob::failed, this, &NewsChecker::rssDownloadFailed);
     m_newsNetJob.reset(job);
@@ -70,7 +83,50 @@ void NewsChecker::rssDownloadFinished()
     // Parse the XML file and process the RSS feed entries.
     qDebug() << "Finished loading RSS feed.";
 
-    m_newsNetJob.reset();
+    auto path = m_newsEntry->getFullPath();
+    auto timestamp = QFileInfo(path).lastModified();
+    if (timestamp.isValid() && timestamp == m_parsedTimestamp)
+    {
+        qDebug() << "The news feed didn't change.";
+        succeed();
+        return;
+    }
+
+    // parsing a big feed takes a while, it is done away from the window
+    m_parsing = true;
+    auto watcher = new QFutureWatcher<ParseResult>(this);
+    connect(watcher, &QFutureWatcher<ParseResult>::finished, this, [this, watcher, timestamp] {
+        auto result = watcher->result();
+        watcher->deleteLater();
+        m_parsing = false;
+
+        if (!result.error.isEmpty())
+        {
+            m_parsedTimestamp = QDateTime();
+            fail(result.error);
+            return;
+        }
+        for (auto& entry : result.entries)
+        {
+            qDebug() << "Loaded news entry" << entry->title;
+        }
+        m_newsEntries = result.entries;
+        m_parsedTimestamp = timestamp;
+        succeed();
+    });
+    watcher->setFuture(QtConcurrent::run(Executors::background(), [path] { return parseFeed(path); }));
+}
+
+auto NewsChecker::parseFeed(const QString& path) -> ParseResult
+{
+    ParseResult result;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        result.error = QString("Could not read the RSS feed: %1").arg(file.errorString());
+        return result;
+    }
+
     QDomDocument doc;
     {
         // Stuff to store error info in.
@@ -79,19 +135,15 @@ void NewsChecker::rssDownloadFinished()
         int errorCol = -1;
 
         // Parse the XML.
-        if (!doc.setContent(newsData, false, &errorMsg, &errorLine, &errorCol))
+        if (!doc.setContent(&file, false, &errorMsg, &errorLine, &errorCol))
         {
-            QString fullErrorMsg = QString("Error parsing RSS feed XML. %1 at %2:%3.").arg(errorMsg).arg(errorLine).arg(errorCol);
-            fail(fullErrorMsg);
-            newsData.clear();
-            return;
+            result.error = QString("Error parsing RSS feed XML. %1 at %2:%3.").arg(errorMsg).arg(errorLine).arg(errorCol);
+            return result;
         }
-        newsData.clear();
     }
 
     // If the parsing succeeded, read it.
     QDomNodeList items = doc.elementsByTagName("entry");
-    m_newsEntries.clear();
     for (int i = 0; i < items.length(); i++)
     {
         QDomElement element = items.at(i).toElement();
@@ -100,16 +152,16 @@ void NewsChecker::rssDownloadFinished()
         QString errorMsg = "An unknown error occurred.";
         if (NewsEntry::fromXmlElement(element, entry.get(), &errorMsg))
         {
-            qDebug() << "Loaded news entry" << entry->title;
-            m_newsEntries.append(entry);
+            // made here, but used by the window
+            entry->moveToThread(QCoreApplication::instance()->thread());
+            result.entries.append(entry);
         }
         else
         {
             qWarning() << "Failed to load news entry at index" << i << ":" << errorMsg;
         }
     }
-
-    succeed();
+    return result;
 }
 
 void NewsChecker::rssDownloadFailed(QString reason)
@@ -126,7 +178,7 @@ QList<NewsEntryPtr> NewsChecker::getNewsEntries() const
 
 bool NewsChecker::isLoadingNews() const
 {
-    return m_newsNetJob.get() != nullptr;
+    return m_newsNetJob.get() != nullptr || m_parsing;
 }
 
 QString NewsChecker::getLastLoadErrorMsg() const
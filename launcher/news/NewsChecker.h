@@ -15,10 +15,12 @@
 
 #pragma once
 
+#include <QDateTime>
 #include <QObject>
 #include <QString>
 #include <QList>
 
+#include <net/HttpMetaCache.h>
 #include <net/NetJob.h>
 
 #include "NewsEntry.h"
@@ -72,6 +74,16 @@ protected slots:
     void rssDownloadFinished();
     void rssDownloadFailed(QString reason);
 
+protected:
+    struct ParseResult
+    {
+        QList<NewsEntryPtr> entries;
+        QString error;
+    };
+
+    /// Reads the feed in the file at `path`, runs on a worker thread.
+    static ParseResult parseFeed(const QString& path);
+
 protected: /* data */
     //! The URL for the RSS feed to fetch.
     QString m_feedUrl;
@@ -85,7 +97,14 @@ protected: /* data */
     //! True if news has been loaded.
     bool m_loadedNews;
 
-    QByteArray newsData;
+    //! The copy of the feed in the cache, fetched again only when it changed on the server.
+    MetaEntryPtr m_newsEntry;
+
+    //! True while the feed is parsed.
+    bool m_parsing = false;
+
+    //! The modification time of the feed that was parsed last, it isn't parsed again when the server had nothing new.
+    QDateTime m_parsedTimestamp;
 
     /*!
      * Gets the error message that was given last time the news was loaded.
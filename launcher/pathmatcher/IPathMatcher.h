@@ -10,4 +10,6 @@ public:
 public:
     virtual ~IPathMatcher(){};
     virtual bool matches(const QString &string) const = 0;
+    /// whether everything in a folder matches, so it doesn't have to be looked into. false when unsure
+    virtual bool matchesFolder(const QString &) const { return false; }
 };
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "PathRuleMatcher.h"
+
+PathRuleMatcher::PathRuleMatcher(const SeparatorPrefixTree<'/'>& tree)
+{
+    for (auto& path : tree.toStringList())
+        addPath(path);
+}
+
+PathRuleMatcher& PathRuleMatcher::caseSensitive(bool cs)
+{
+    // the rules are folded the same way as the paths, so this has to come first
+    Q_ASSERT(m_nodes.size() == 1 && m_names.isEmpty() && m_suffixes.isEmpty() && m_globs.isEmpty());
+    m_caseSensitive = cs;
+    return *this;
+}
+
+QString PathRuleMatcher::normalized(const QString& string) const
+{
+    return m_caseSensitive ? string : string.toLower();
+}
+
+PathRuleMatcher& PathRuleMatcher::addPath(const QString& path)
+{
+    int node = 0;
+    for (auto& part : normalized(path).split('/', Qt::SkipEmptyParts)) {
+        if (m_nodes[node].covered)
+            return *this;
+        auto child = m_nodes[node].children.value(part, -1);
+        if (child == -1) {
+            child = m_nodes.size();
+            m_nodes[node].children.insert(part, child);
+            m_nodes.append(Node());
+        }
+        node = child;
+    }
+    // everything under it is covered already, the children aren't needed anymore
+    m_nodes[node].covered = true;
+    m_nodes[node].children.clear();
+    return *this;
+}
+
+PathRuleMatcher& PathRuleMatcher::addName(const QString& name)
+{
+    m_names.insert(normalized(name));
+    return *this;
+}
+
+PathRuleMatcher& PathRuleMatcher::addGlob(const QString& glob)
+{
+    auto folded = normalized(glob);
+    auto suffix = folded.mid(1);
+    if (folded.startsWith('*') && !suffix.contains('*') && !suffix.contains('?') && !suffix.contains('[')) {
+        m_suffixes.append(suffix);
+        return *this;
+    }
+    m_globs.append(folded);
+    compileGlobs();
+    return *this;
+}
+
+void PathRuleMatcher::compileGlobs()
+{
+    QStringList patterns;
+    for (auto& glob : m_globs) {
+        auto pattern = QRegularExpression::wildcardToRegularExpression(glob);
+        // it comes anchored, the anchors go around the whole alternation instead
+        patterns.append("(?:" + pattern + ")");
+    }
+    m_globRegexp.setPattern(patterns.join('|'));
+    m_globRegexp.optimize();
+}
+
+bool PathRuleMatcher::coveredByPath(const QStringList& parts) const
+{
+    int node = 0;
+    for (auto& part : parts) {
+        if (m_nodes[node].covered)
+            return true;
+        node = m_nodes[node].children.value(part, -1);
+        if (node == -1)
+            return false;
+    }
+    return m_nodes[node].covered;
+}
+
+bool PathRuleMatcher::matches(const QString& path) const
+{
+    auto parts = normalized(path).split('/', Qt::SkipEmptyParts);
+    if (parts.isEmpty())
+        return false;
+    if (coveredByPath(parts))
+        return true;
+
+    if (!m_names.isEmpty()) {
+        for (auto& part : parts) {
+            if (m_names.contains(part))
+                return true;
+        }
+    }
+
+    auto& name = parts.last();
+    for (auto& suffix : m_suffixes) {
+        if (name.endsWith(suffix))
+            return true;
+    }
+    return !m_globs.isEmpty() && m_globRegexp.match(name).hasMatch();
+}
+
+bool PathRuleMatcher::matchesFolder(const QString& path) const
+{
+    auto parts = normalized(path).split('/', Qt::SkipEmptyParts);
+    if (parts.isEmpty())
+        return false;
+    if (coveredByPath(parts))
+        return true;
+    for (auto& part : parts) {
+        if (m_names.contains(part))
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QRegularExpression>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+#include "IPathMatcher.h"
+#include "SeparatorPrefixTree.h"
+
+/* Path, name and glob rules, put together once and matched in a single walk over the parts of a path.
+ *
+ * The paths are kept in a tree of their parts, so a path is matched by looking each of its parts up once, however
+ * many rules there are. A path rule matches the path and everything under it, a name rule any file or folder of
+ * that name, and a glob rule ("*.log", "crash-*.txt") the last part of the path. The globs that are only a
+ * suffix ("*.log") are checked as one, the others go in a single regular expression.
+ */
+class PathRuleMatcher : public IPathMatcher {
+   public:
+    PathRuleMatcher() = default;
+    /** Matches the paths of the tree and everything under those. */
+    explicit PathRuleMatcher(const SeparatorPrefixTree<'/'>& tree);
+    ~PathRuleMatcher() override = default;
+
+    PathRuleMatcher& caseSensitive(bool cs = true);
+
+    /** The path and everything under it. */
+    PathRuleMatcher& addPath(const QString& path);
+    /** Anything with that name, at any depth. */
+    PathRuleMatcher& addName(const QString& name);
+    /** The paths whose last part matches the wildcard pattern. */
+    PathRuleMatcher& addGlob(const QString& glob);
+
+    bool matches(const QString& path) const override;
+    bool matchesFolder(const QString& path) const override;
+
+   private:
+    struct Node {
+        QHash<QString, int> children;
+        // a path rule ends here
+        bool covered = false;
+    };
+
+    QString normalized(const QString& string) const;
+    bool coveredByPath(const QStringList& parts) const;
+    void compileGlobs();
+
+   private:
+    bool m_caseSensitive = true;
+    QVector<Node> m_nodes{ Node() };
+    QSet<QString> m_names;
+    QStringList m_suffixes;
+    QStringList m_globs;
+    QRegularExpression m_globRegexp;
+};
@@ -38,6 +38,10 @@
 #include "BuildConfig.h"
 #include "Application.h"
 
+#include <QBuffer>
+#include <QFutureWatcher>
+#include <QImage>
+#include <QImageReader>
 #include <QNetworkRequest>
 #include <QHttpMultiPart>
 #include <QJsonDocument>
@@ -47,6 +51,58 @@
 #include <QUrl>
 #include <QDebug>
 
+#include "Executors.h"
+
+namespace {
+
+struct EncodedImage {
+    QByteArray data;
+    QByteArray mimeType;
+    QString suffix;
+};
+
+/* Reads the screenshot at 'path', made to fit in 'maxSize' pixels on its largest side (0 for any size) and in 'format'.
+ * The file is sent as it is when it already fits, without decoding it. */
+EncodedImage encodeScreenshot(const QString& path, int maxSize, const QString& format)
+{
+    const bool jpeg = format == "jpg";
+
+    QImageReader reader(path);
+    auto size = reader.size();
+    const bool fits = maxSize <= 0 || (size.isValid() && qMax(size.width(), size.height()) <= maxSize);
+    if (fits && !jpeg) {
+        QFile f(path);
+        if (!f.open(QFile::ReadOnly))
+            return {};
+        return { f.readAll(), "image/png", "png" };
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "Could not read screenshot" << path << ":" << reader.errorString();
+        return {};
+    }
+    if (!fits)
+        image = image.scaled(maxSize, maxSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    EncodedImage encoded;
+    QBuffer buffer(&encoded.data);
+    buffer.open(QIODevice::WriteOnly);
+    if (jpeg) {
+        // JPEG has no alpha, screenshots don't need it anyway
+        image.convertToFormat(QImage::Format_RGB888).save(&buffer, "JPG", 90);
+        encoded.mimeType = "image/jpeg";
+        encoded.suffix = "jpg";
+    } else {
+        image.save(&buffer, "PNG");
+        encoded.mimeType = "image/png";
+        encoded.suffix = "png";
+    }
+    return encoded;
+}
+
+}  // namespace
+
 ImgurUpload::ImgurUpload(ScreenShot::Ptr shot) : NetAction(), m_shot(shot)
 {
     m_url = BuildConfig.IMGUR_BASE_URL + "upload.json";
@@ -57,27 +113,46 @@ void ImgurUpload::executeTask()
 {
     finished = false;
     m_state = Task::State::Running;
+
+    // decoding and scaling a 4K screenshot takes a while, and the upload doesn't need the GUI thread until it's done
+    auto path = m_shot->m_file.absoluteFilePath();
+    auto maxSize = APPLICATION->settings()->get("ScreenshotUploadMaxSize").toInt();
+    auto format = APPLICATION->settings()->get("ScreenshotUploadFormat").toString();
+    auto watcher = new QFutureWatcher<EncodedImage>(this);
+    connect(watcher, &QFutureWatcher<EncodedImage>::finished, this, [this, watcher] {
+        auto image = watcher->result();
+        watcher->deleteLater();
+        if (m_state != Task::State::Running)
+            return;
+        if (image.data.isEmpty()) {
+            finished = true;
+            m_state = Task::State::Failed;
+            emitFailed();
+            return;
+        }
+        upload(image.data, image.mimeType, image.suffix);
+    });
+    watcher->setFuture(QtConcurrent::run(Executors::cpu(), [path, maxSize, format] { return encodeScreenshot(path, maxSize, format); }));
+}
+
+void ImgurUpload::upload(const QByteArray& data, const QByteArray& mimeType, const QString& suffix)
+{
     QNetworkRequest request(m_url);
     request.setHeader(QNetworkRequest::UserAgentHeader, APPLICATION->getUserAgentUncached().toUtf8());
     request.setRawHeader("Authorization", QString("Client-ID %1").arg(BuildConfig.IMGUR_CLIENT_ID).toStdString().c_str());
     request.setRawHeader("Accept", "application/json");
 
-    QFile f(m_shot->m_file.absoluteFilePath());
-    if (!f.open(QFile::ReadOnly))
-    {
-        emitFailed();
-        return;
-    }
-
     QHttpMultiPart *multipart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
     QHttpPart filePart;
-    filePart.setBody(f.readAll().toBase64());
-    filePart.setHeader(QNetworkRequest::ContentTypeHeader, "image/png");
-    filePart.setHeader(QNetworkRequest::ContentDispositionHeader, "form-data; name=\"image\"");
+    // sent as is rather than in base64, which is a third bigger
+    filePart.setBody(data);
+    filePart.setHeader(QNetworkRequest::ContentTypeHeader, mimeType);
+    filePart.setHeader(QNetworkRequest::ContentDispositionHeader,
+                       QString("form-data; name=\"image\"; filename=\"%1.%2\"").arg(m_shot->m_file.baseName(), suffix));
     multipart->append(filePart);
     QHttpPart typePart;
     typePart.setHeader(QNetworkRequest::ContentDispositionHeader, "form-data; name=\"type\"");
-    typePart.setBody("base64");
+    typePart.setBody("file");
     multipart->append(typePart);
     QHttpPart namePart;
     namePart.setHeader(QNetworkRequest::ContentDispositionHeader, "form-data; name=\"name\"");
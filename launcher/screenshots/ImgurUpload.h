@@ -59,6 +59,9 @@ slots:
     void executeTask() override;
 
 private:
+    /** Posts the screenshot, once encodeScreenshot() made it what it's going to be uploaded as. */
+    void upload(const QByteArray& data, const QByteArray& mimeType, const QString& suffix);
+
     ScreenShot::Ptr m_shot;
     bool finished = true;
 };
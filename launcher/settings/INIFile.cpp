@@ -45,15 +45,106 @@
 
 #include <QSettings>
 
+namespace {
+// What QSettings writes as is, without escaping or quoting anything
+bool isPlainKey(const QString& key)
+{
+    if (key.isEmpty())
+        return false;
+    for (auto ch : key) {
+        if (!(ch.isLetterOrNumber() && ch.unicode() < 0x80) && ch != '-' && ch != '_' && ch != '.')
+            return false;
+    }
+    return true;
+}
+
+bool isPlainValue(const QString& value)
+{
+    if (value.startsWith('@') || value.startsWith(' ') || value.endsWith(' '))
+        return false;
+    for (auto ch : value) {
+        if (ch.unicode() < 0x20 || ch.unicode() > 0x7e)
+            return false;
+        switch (ch.unicode()) {
+            case '"':
+            case '\\':
+            case ';':
+            case ',':
+            case '#':
+            case '=':
+                return false;
+        }
+    }
+    return true;
+}
+
+bool isPlainType(const QVariant& value)
+{
+    switch (value.userType()) {
+        case QMetaType::QString:
+        case QMetaType::Bool:
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Reads the config files that only have plain 'key=value' lines, which is what almost all of them are.
+// Anything that needs QSettings to make sense of it makes this give up.
+bool loadPlainFile(const QByteArray& data, QMap<QString, QVariant>& out)
+{
+    for (auto& raw_line : data.split('\n')) {
+        auto line = QString::fromLatin1(raw_line).trimmed();
+        if (line.isEmpty() || line == "[General]")
+            continue;
+
+        auto separator = line.indexOf('=');
+        if (separator < 0)
+            return false;
+        auto key = line.left(separator).trimmed();
+        auto value = line.mid(separator + 1).trimmed();
+        if (!isPlainKey(key) || !isPlainValue(value))
+            return false;
+        out.insert(key, value);
+    }
+    return true;
+}
+}  // namespace
+
 INIFile::INIFile()
 {
 }
 
 bool INIFile::saveFile(QString fileName)
 {
+    bool plain = true;
+    for (auto iter = cbegin(); iter != cend() && plain; iter++)
+        plain = isPlainKey(iter.key()) && isPlainType(iter.value()) && isPlainValue(iter.value().toString());
+
+    if (plain) {
+        QByteArray data;
+        if (!isEmpty())
+            data += "[General]\n";
+        for (auto iter = cbegin(); iter != cend(); iter++)
+            data += iter.key().toLatin1() + '=' + iter.value().toString().toLatin1() + '\n';
+
+        QSaveFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+            qCritical() << "Couldn't write" << fileName << ":" << file.errorString();
+            return false;
+        }
+        return true;
+    }
+
     QSettings _settings_obj{ fileName, QSettings::Format::IniFormat };
     _settings_obj.setFallbacksEnabled(false);
 
+    // the file gets the same contents either way, keys that were removed don't stay around
+    _settings_obj.clear();
     for (Iterator iter = begin(); iter != end(); iter++)
         _settings_obj.setValue(iter.key(), iter.value());
 
@@ -74,6 +165,18 @@ bool INIFile::saveFile(QString fileName)
 
 bool INIFile::loadFile(QString fileName)
 {
+    QFile file(fileName);
+    if (!file.exists())
+        return true;
+    if (file.open(QIODevice::ReadOnly)) {
+        QMap<QString, QVariant> plain;
+        if (loadPlainFile(file.readAll(), plain)) {
+            for (auto iter = plain.cbegin(); iter != plain.cend(); iter++)
+                insert(iter.key(), iter.value());
+            return true;
+        }
+    }
+
     QSettings _settings_obj{ fileName, QSettings::Format::IniFormat };
     _settings_obj.setFallbacksEnabled(false);
 
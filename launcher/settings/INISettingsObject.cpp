@@ -18,6 +18,7 @@
 
 #include <QDebug>
 #include <QFile>
+#include <QtConcurrent>
 
 INISettingsObject::INISettingsObject(QStringList paths, QObject *parent)
     : SettingsObject(parent)
@@ -46,16 +47,65 @@ INISettingsObject::INISettingsObject(QString path, QObject* parent)
     m_ini.loadFile(path);
 }
 
+INISettingsObject::INISettingsObject(QString path, INIFile contents, QObject* parent)
+    : SettingsObject(parent)
+{
+    m_filePath = path;
+    m_ini = std::move(contents);
+}
+
+INISettingsObject::~INISettingsObject()
+{
+    saveNow();
+}
+
 void INISettingsObject::setFilePath(const QString &filePath)
 {
+    // what's waiting goes where it was meant to
+    saveNow();
     m_filePath = filePath;
 }
 
 bool INISettingsObject::reload()
 {
+    saveNow();
     return m_ini.loadFile(m_filePath) && SettingsObject::reload();
 }
 
+void INISettingsObject::setSaveDelay(int msec)
+{
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(msec);
+    connect(&m_saveTimer, &QTimer::timeout, this, &INISettingsObject::saveInBackground, Qt::UniqueConnection);
+}
+
+void INISettingsObject::saveNow()
+{
+    m_saving.waitForFinished();
+    if (m_saveTimer.isActive())
+    {
+        m_saveTimer.stop();
+        m_ini.saveFile(m_filePath);
+    }
+}
+
+void INISettingsObject::saveInBackground()
+{
+    // one write at a time, the next one has the latest contents anyway
+    if (m_saving.isRunning())
+    {
+        m_saveTimer.start();
+        return;
+    }
+
+    INIFile contents = m_ini;
+    QString path = m_filePath;
+    m_saving = QtConcurrent::run(QThreadPool::globalInstance(), [contents, path]() {
+        INIFile file = contents;
+        return file.saveFile(path);
+    });
+}
+
 void INISettingsObject::suspendSave()
 {
     m_suspendSave = true;
@@ -66,6 +116,10 @@ void INISettingsObject::resumeSave()
     m_suspendSave = false;
     if(m_doSave)
     {
+        // whoever suspended saving expects the file to be there now
+        m_doSave = false;
+        m_saveTimer.stop();
+        m_saving.waitForFinished();
         m_ini.saveFile(m_filePath);
     }
 }
@@ -98,6 +152,10 @@ void INISettingsObject::doSave()
     {
         m_doSave = true;
     }
+    else if(m_saveTimer.interval() > 0)
+    {
+        m_saveTimer.start();
+    }
     else
     {
         m_ini.saveFile(m_filePath);
@@ -115,16 +173,13 @@ void INISettingsObject::resetSetting(const Setting &setting)
     }
 }
 
-QVariant INISettingsObject::retrieveValue(const Setting &setting)
+QVariant INISettingsObject::retrieveValue(const QStringList &configKeys) const
 {
-    // if we have the setting, return value of the first matching synonym
-    if (contains(setting.id()))
+    // return value of the first matching synonym
+    for(auto iter: configKeys)
     {
-        for(auto iter: setting.configKeys())
-        {
-            if(m_ini.contains(iter))
-                return m_ini[iter];
-        }
+        if(m_ini.contains(iter))
+            return m_ini[iter];
     }
     return QVariant();
 }
@@ -15,7 +15,9 @@
 
 #pragma once
 
+#include <QFuture>
 #include <QObject>
+#include <QTimer>
 
 #include "settings/INIFile.h"
 
@@ -33,6 +35,11 @@ public:
 
     explicit INISettingsObject(QString path, QObject*  parent = nullptr);
 
+    /** Uses already loaded 'contents' instead of reading them from 'path'. */
+    INISettingsObject(QString path, INIFile contents, QObject* parent = nullptr);
+
+    virtual ~INISettingsObject();
+
     /*!
      * \brief Gets the path to the INI file.
      * \return The path to the INI file.
@@ -53,15 +60,30 @@ public:
     void suspendSave() override;
     void resumeSave() override;
 
+    /*!
+     * \brief Makes changes get written after `msec` without other changes, on the global thread pool.
+     * By default, every change is written right away. Objects that live long enough can use this, so
+     * that dragging a slider doesn't rewrite the whole file dozens of times.
+     */
+    void setSaveDelay(int msec);
+
+    /*!
+     * \brief Writes the changes that are still waiting for the save delay, and waits for the ones being written.
+     */
+    void saveNow();
+
 protected slots:
     virtual void changeSetting(const Setting &setting, QVariant value) override;
     virtual void resetSetting(const Setting &setting) override;
 
 protected:
-    virtual QVariant retrieveValue(const Setting &setting) override;
+    virtual QVariant retrieveValue(const QStringList &configKeys) const override;
     void doSave();
+    void saveInBackground();
 
 protected:
     INIFile m_ini;
     QString m_filePath;
+    QTimer m_saveTimer;
+    QFuture<bool> m_saving;
 };
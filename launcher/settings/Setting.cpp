@@ -30,7 +30,7 @@ QVariant Setting::get() const
     }
     else
     {
-        QVariant test = sbase->retrieveValue(*this);
+        QVariant test = sbase->retrieveValue(configKeys());
         if (!test.isValid())
             return defValue();
         return test;
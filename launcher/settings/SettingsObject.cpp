@@ -18,80 +18,130 @@
 #include "settings/OverrideSetting.h"
 #include "PassthroughSetting.h"
 #include <QDebug>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
 
 #include <QVariant>
 
+namespace {
+// Synonyms and defaults of the declared settings. Every instance declares the same ones, so they're only kept once.
+struct SettingInfo
+{
+    QStringList synonyms;
+    QVariant defVal;
+};
+
+struct SettingSchema
+{
+    QMutex lock;
+    QVector<SettingInfo> infos;
+    QMultiHash<QString, int> byId;
+};
+
+SettingSchema &schema()
+{
+    static SettingSchema s_schema;
+    return s_schema;
+}
+
+int internSetting(const QStringList &synonyms, const QVariant &defVal)
+{
+    auto &table = schema();
+    QMutexLocker locker(&table.lock);
+    for (int index : table.byId.values(synonyms.first()))
+    {
+        auto &info = table.infos[index];
+        if (info.synonyms == synonyms && info.defVal == defVal)
+            return index;
+    }
+    table.infos.append({ synonyms, defVal });
+    table.byId.insert(synonyms.first(), table.infos.size() - 1);
+    return table.infos.size() - 1;
+}
+
+SettingInfo settingInfo(int index)
+{
+    auto &table = schema();
+    QMutexLocker locker(&table.lock);
+    return table.infos.at(index);
+}
+}
+
 SettingsObject::SettingsObject(QObject *parent) : QObject(parent)
 {
 }
 
 SettingsObject::~SettingsObject()
 {
-    m_settings.clear();
+    m_entries.clear();
 }
 
-std::shared_ptr<Setting> SettingsObject::registerOverride(std::shared_ptr<Setting> original,
-                                                          std::shared_ptr<Setting> gate)
+bool SettingsObject::addEntry(const QString &id, Entry entry)
 {
-    if (contains(original->id()))
+    if (contains(id))
     {
-        qCritical() << QString("Failed to register setting %1. ID already exists.")
-                   .arg(original->id());
-        return nullptr; // Fail
+        qCritical() << QString("Failed to register setting %1. ID already exists.").arg(id);
+        return false; // Fail
     }
-    auto override = std::make_shared<OverrideSetting>(original, gate);
-    override->m_storage = this;
-    connectSignals(*override);
-    m_settings.insert(override->id(), override);
-    return override;
+    m_entries.insert(id, entry);
+    return true;
 }
 
-std::shared_ptr<Setting> SettingsObject::registerPassthrough(std::shared_ptr<Setting> original,
-                                                             std::shared_ptr<Setting> gate)
+bool SettingsObject::registerOverride(std::shared_ptr<Setting> original, std::shared_ptr<Setting> gate)
 {
-    if (contains(original->id()))
-    {
-        qCritical() << QString("Failed to register setting %1. ID already exists.")
-                   .arg(original->id());
-        return nullptr; // Fail
-    }
-    auto passthrough = std::make_shared<PassthroughSetting>(original, gate);
-    passthrough->m_storage = this;
-    connectSignals(*passthrough);
-    m_settings.insert(passthrough->id(), passthrough);
-    return passthrough;
+    Q_ASSERT(original);
+    Q_ASSERT(gate);
+    Entry entry;
+    entry.kind = Entry::Kind::Override;
+    entry.other = original;
+    entry.gate = gate;
+    return addEntry(original->id(), entry);
 }
 
-std::shared_ptr<Setting> SettingsObject::registerSetting(QStringList synonyms, QVariant defVal)
+bool SettingsObject::registerPassthrough(std::shared_ptr<Setting> original, std::shared_ptr<Setting> gate)
+{
+    Q_ASSERT(original);
+    Entry entry;
+    entry.kind = Entry::Kind::Passthrough;
+    entry.other = original;
+    entry.gate = gate;
+    return addEntry(original->id(), entry);
+}
+
+bool SettingsObject::declareSetting(QStringList synonyms, QVariant defVal)
 {
     if (synonyms.empty())
+        return false;
+    Entry entry;
+    entry.info = internSetting(synonyms, defVal);
+    // the key shares its data with the table
+    return addEntry(settingInfo(entry.info).synonyms.first(), entry);
+}
+
+std::shared_ptr<Setting> SettingsObject::registerSetting(QStringList synonyms, QVariant defVal)
+{
+    if (!declareSetting(synonyms, defVal))
         return nullptr;
-    if (contains(synonyms.first()))
-    {
-        qCritical() << QString("Failed to register setting %1. ID already exists.")
-                   .arg(synonyms.first());
-        return nullptr; // Fail
-    }
-    auto setting = std::make_shared<Setting>(synonyms, defVal);
-    setting->m_storage = this;
-    connectSignals(*setting);
-    m_settings.insert(setting->id(), setting);
-    return setting;
+    return materialize(m_entries[synonyms.first()]);
 }
 
 std::shared_ptr<Setting> SettingsObject::getSetting(const QString &id) const
 {
     // Make sure there is a setting with the given ID.
-    if (!m_settings.contains(id))
+    auto entry = m_entries.find(id);
+    if (entry == m_entries.end())
         return NULL;
 
-    return m_settings[id];
+    return materialize(*entry);
 }
 
 QVariant SettingsObject::get(const QString &id) const
 {
-    auto setting = getSetting(id);
-    return (setting ? setting->get() : QVariant());
+    auto entry = m_entries.constFind(id);
+    if (entry == m_entries.constEnd())
+        return QVariant();
+    return entry->setting ? entry->setting->get() : resolve(*entry);
 }
 
 bool SettingsObject::set(const QString &id, QVariant value)
@@ -116,20 +166,72 @@ void SettingsObject::reset(const QString &id) const
         setting->reset();
 }
 
-bool SettingsObject::contains(const QString &id)
+bool SettingsObject::contains(const QString &id) const
 {
-    return m_settings.contains(id);
+    return m_entries.contains(id);
 }
 
 bool SettingsObject::reload()
 {
-    for (auto setting : m_settings.values())
+    for (auto &entry : m_entries)
     {
+        auto setting = materialize(entry);
         setting->set(setting->get());
     }
     return true;
 }
 
+QVariant SettingsObject::resolve(const Entry &entry) const
+{
+    // the same as what the Setting objects do in get()
+    switch (entry.kind)
+    {
+        case Entry::Kind::Plain:
+        {
+            auto info = settingInfo(entry.info);
+            auto value = retrieveValue(info.synonyms);
+            return value.isValid() ? value : info.defVal;
+        }
+        case Entry::Kind::Override:
+        case Entry::Kind::Passthrough:
+        {
+            if (!entry.gate || !entry.gate->get().toBool())
+                return entry.other->get();
+            auto value = retrieveValue(entry.other->configKeys());
+            return value.isValid() ? value : entry.other->get();
+        }
+    }
+    return QVariant();
+}
+
+std::shared_ptr<Setting> SettingsObject::materialize(Entry &entry) const
+{
+    if (entry.setting)
+        return entry.setting;
+
+    switch (entry.kind)
+    {
+        case Entry::Kind::Plain:
+        {
+            auto info = settingInfo(entry.info);
+            entry.setting = std::make_shared<Setting>(info.synonyms, info.defVal);
+            break;
+        }
+        case Entry::Kind::Override:
+            entry.setting = std::make_shared<OverrideSetting>(entry.other, entry.gate);
+            break;
+        case Entry::Kind::Passthrough:
+            entry.setting = std::make_shared<PassthroughSetting>(entry.other, entry.gate);
+            break;
+    }
+
+    // the settings objects own their settings, what's const about them is their values
+    auto self = const_cast<SettingsObject *>(this);
+    entry.setting->m_storage = self;
+    self->connectSignals(*entry.setting);
+    return entry.setting;
+}
+
 void SettingsObject::connectSignals(const Setting &setting)
 {
     connect(&setting, &Setting::SettingChanged, this, &SettingsObject::changeSetting);
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <QObject>
+#include <QHash>
 #include <QMap>
 #include <QStringList>
 #include <QVariant>
@@ -69,9 +70,9 @@ public:
      *
      * This will fail if there is already a setting with the same ID as
      * the one that is being registered.
-     * \return A valid Setting shared pointer if successful.
+     * \return True if successful, false if it failed.
      */
-    std::shared_ptr<Setting> registerOverride(std::shared_ptr<Setting> original, std::shared_ptr<Setting> gate);
+    bool registerOverride(std::shared_ptr<Setting> original, std::shared_ptr<Setting> gate);
 
     /*!
      * Registers a passthorugh setting for the given original setting in this settings object
@@ -79,9 +80,9 @@ public:
      *
      * This will fail if there is already a setting with the same ID as
      * the one that is being registered.
-     * \return A valid Setting shared pointer if successful.
+     * \return True if successful, false if it failed.
      */
-    std::shared_ptr<Setting> registerPassthrough(std::shared_ptr<Setting> original, std::shared_ptr<Setting> gate);
+    bool registerPassthrough(std::shared_ptr<Setting> original, std::shared_ptr<Setting> gate);
 
     /*!
      * Registers the given setting with this SettingsObject and connects the necessary  signals.
@@ -105,6 +106,22 @@ public:
         return registerSetting(QStringList(id), defVal);
     }
 
+    /*!
+     * Registers a setting like registerSetting(), without making a Setting object for it.
+     *
+     * The synonyms and the default go in a table shared by all settings objects, and get() and
+     * set() work without a Setting object. One only gets made if something asks for it with
+     * getSetting(), or when the setting changes. Meant for the settings of instances, which have
+     * dozens of them each that are hardly ever looked at.
+     * \return True if successful, false if it failed.
+     */
+    bool declareSetting(QStringList synonyms, QVariant defVal = QVariant());
+
+    bool declareSetting(QString id, QVariant defVal = QVariant())
+    {
+        return declareSetting(QStringList(id), defVal);
+    }
+
     /*!
      * \brief Gets the setting with the given ID.
      * \param id The ID of the setting to get.
@@ -142,7 +159,7 @@ public:
      * \param id The ID to check for.
      * \return True if the SettingsObject has a setting with the given ID.
      */
-    bool contains(const QString &id);
+    bool contains(const QString &id) const;
 
     /*!
      * \brief Reloads the settings and emit signals for changed settings
@@ -200,15 +217,33 @@ protected:
 
     /*!
      * \brief Function used by Setting objects to get their values from the SettingsObject.
-     * \param setting The
-     * \return
+     * \param configKeys The keys the setting is stored under, in order of preference.
+     * \return The stored value, or an invalid QVariant if there is none.
      */
-    virtual QVariant retrieveValue(const Setting &setting) = 0;
+    virtual QVariant retrieveValue(const QStringList &configKeys) const = 0;
 
     friend class Setting;
 
 private:
-    QMap<QString, std::shared_ptr<Setting>> m_settings;
+    struct Entry
+    {
+        enum class Kind { Plain, Override, Passthrough };
+        Kind kind = Kind::Plain;
+        // the synonyms and default of a plain setting, in the table shared by all settings objects
+        int info = -1;
+        // what overrides and passthroughs resolve through
+        std::shared_ptr<Setting> other;
+        std::shared_ptr<Setting> gate;
+        // the Setting object, once something needed one
+        std::shared_ptr<Setting> setting;
+    };
+
+    bool addEntry(const QString &id, Entry entry);
+    QVariant resolve(const Entry &entry) const;
+    std::shared_ptr<Setting> materialize(Entry &entry) const;
+
+private:
+    mutable QHash<QString, Entry> m_entries;
 protected:
     bool m_suspendSave = false;
     bool m_doSave = false;
@@ -37,12 +37,19 @@
 
 #include <QCoreApplication>
 #include <QDebug>
+#include <QThread>
 #include "tasks/Task.h"
 
 ConcurrentTask::ConcurrentTask(QObject* parent, QString task_name, int max_concurrent)
-    : Task(parent), m_name(task_name), m_total_max_size(max_concurrent)
+    : Task(parent), m_name(task_name), m_total_max_size(max_concurrent), m_max_concurrent(max_concurrent)
 {
     setObjectName(task_name);
+    m_clock.start();
+
+    m_progress_timer = new QTimer(this);
+    m_progress_timer->setSingleShot(true);
+    m_progress_timer->setInterval(s_progress_interval_ms);
+    connect(m_progress_timer, &QTimer::timeout, this, &ConcurrentTask::flushProgress);
 }
 
 ConcurrentTask::~ConcurrentTask()
@@ -63,6 +70,67 @@ void ConcurrentTask::addTask(Task::Ptr task)
     m_queue.append(task);
 }
 
+void ConcurrentTask::setConcurrency(Concurrency concurrency)
+{
+    m_concurrency = concurrency;
+    m_round_left = 0;
+    m_succeeded_since_change = 0;
+    switch (concurrency) {
+        case Concurrency::Fixed:
+        case Concurrency::Adaptive:
+            m_total_max_size = m_max_concurrent;
+            break;
+        case Concurrency::CpuBound:
+            m_total_max_size = qMax(1, QThread::idealThreadCount());
+            break;
+    }
+}
+
+void ConcurrentTask::tuneConcurrency(Task* task, bool succeeded)
+{
+    auto started_at = m_started_at.take(task);
+    if (m_concurrency != Concurrency::Adaptive)
+        return;
+
+    if (m_round_left > 0)
+        m_round_left -= 1;
+
+    bool congested = !succeeded;
+    if (succeeded) {
+        double duration_ms = m_clock.elapsed() - started_at;
+        m_duration_ms = m_duration_ms < 0 ? duration_ms : 0.8 * m_duration_ms + 0.2 * duration_ms;
+        if (m_best_duration_ms < 0 || m_duration_ms < m_best_duration_ms)
+            m_best_duration_ms = m_duration_ms;
+        // a few milliseconds more don't tell anything
+        congested = m_duration_ms > 3 * m_best_duration_ms && m_duration_ms - m_best_duration_ms > 500;
+    }
+
+    if (m_round_left > 0)
+        return;
+
+    if (congested) {
+        if (m_total_max_size > 1) {
+            m_total_max_size = qMax(1, m_total_max_size / 2);
+            qDebug() << "Running at most" << m_total_max_size << "tasks at once in" << m_name;
+        }
+        m_round_left = m_doing.size();
+        m_succeeded_since_change = 0;
+        return;
+    }
+
+    if (++m_succeeded_since_change >= m_total_max_size) {
+        m_succeeded_since_change = 0;
+        m_total_max_size = qMin(m_total_max_size + 1, m_max_concurrent);
+    }
+}
+
+auto ConcurrentTask::concurrencyStatus() const -> QString
+{
+    if (m_concurrency == Concurrency::Fixed)
+        return {};
+    return tr(", up to %1 at once").arg(m_total_max_size);
+}
+
 void ConcurrentTask::executeTask()
 {
     // Start one task, startNext handles starting the up to the m_total_max_size
@@ -126,8 +194,16 @@ void ConcurrentTask::startNext()
     if (m_queue.isEmpty())
         return;
 
-    Task::Ptr next = m_queue.dequeue();
+    startTask(m_queue.dequeue());
 
+    // Allow going up the number of concurrent tasks in case of tasks being added in the middle of a running task.
+    int num_starts = qMin(m_queue.size(), m_total_max_size - m_doing.size());
+    for (int i = 0; i < num_starts; i++)
+        QMetaObject::invokeMethod(this, &ConcurrentTask::startNext, Qt::QueuedConnection);
+}
+
+void ConcurrentTask::startTask(Task::Ptr next)
+{
     connect(next.get(), &Task::succeeded, this, [this, next]() { subTaskSucceeded(next); });
     connect(next.get(), &Task::failed, this, [this, next](QString msg) { subTaskFailed(next, msg); });
 
@@ -138,6 +214,7 @@ void ConcurrentTask::startNext()
     connect(next.get(), &Task::progress, this, [this, next](qint64 current, qint64 total) { subTaskProgress(next, current, total); });
 
     m_doing.insert(next.get(), next);
+    m_started_at.insert(next.get(), m_clock.elapsed());
     auto task_progress = std::make_shared<TaskStepProgress>(next->getUid());
     m_task_progress.insert(next->getUid(), task_progress);
 
@@ -147,12 +224,9 @@ void ConcurrentTask::startNext()
 
     QCoreApplication::processEvents();
 
-    QMetaObject::invokeMethod(next.get(), &Task::start, Qt::QueuedConnection);
-
-    // Allow going up the number of concurrent tasks in case of tasks being added in the middle of a running task.
-    int num_starts = qMin(m_queue.size(), m_total_max_size - m_doing.size());
-    for (int i = 0; i < num_starts; i++)
-        QMetaObject::invokeMethod(this, &ConcurrentTask::startNext, Qt::QueuedConnection);
+    // tasks started by someone else before being added are only waited for
+    if (!next->isRunning())
+        QMetaObject::invokeMethod(next.get(), &Task::start, Qt::QueuedConnection);
 }
 
 void ConcurrentTask::subTaskSucceeded(Task::Ptr task)
@@ -161,8 +235,10 @@ void ConcurrentTask::subTaskSucceeded(Task::Ptr task)
     m_succeeded.insert(task.get(), task);
 
     m_doing.remove(task.get());
+    tuneConcurrency(task.get(), true);
     auto task_progress = m_task_progress.value(task->getUid());
     task_progress->state = TaskStepState::Succeeded;
+    m_changed_progress.remove(task->getUid());
 
     disconnect(task.get(), 0, this, 0);
 
@@ -178,9 +254,11 @@ void ConcurrentTask::subTaskFailed(Task::Ptr task, const QString& msg)
     m_failed.insert(task.get(), task);
 
     m_doing.remove(task.get());
+    tuneConcurrency(task.get(), false);
 
     auto task_progress = m_task_progress.value(task->getUid());
     task_progress->state = TaskStepState::Failed;
+    m_changed_progress.remove(task->getUid());
 
     disconnect(task.get(), 0, this, 0);
 
@@ -221,13 +299,25 @@ void ConcurrentTask::subTaskProgress(Task::Ptr task, qint64 current, qint64 tota
     auto task_progress = m_task_progress.value(task->getUid());
 
     task_progress->update(current, total);
-        
-    emit stepProgress(*task_progress);
     updateStepProgress(*task_progress, Operation::CHANGED);
+
+    m_changed_progress.insert(task->getUid());
+    if (!m_progress_timer->isActive())
+        m_progress_timer->start();
+}
+
+void ConcurrentTask::flushProgress()
+{
+    for (auto& uid : m_changed_progress) {
+        if (auto task_progress = m_task_progress.value(uid))
+            emit stepProgress(*task_progress);
+    }
+    m_changed_progress.clear();
     updateState();
 
-    if (totalSize() == 1) {
-        setProgress(task_progress->current, task_progress->total);
+    if (totalSize() == 1 && m_doing.size() == 1) {
+        if (auto task_progress = m_task_progress.value(m_doing.begin().key()->getUid()))
+            setProgress(task_progress->current, task_progress->total);
     }
 }
 
@@ -252,8 +342,11 @@ void ConcurrentTask::subTaskStepProgress(Task::Ptr task, TaskStepProgress const&
         tp->details = task_progress.details;
 
         op = Operation::CHANGED;
-        emit stepProgress(*tp.get());
         updateStepProgress(*tp.get(), op);
+
+        m_changed_progress.insert(task_progress.uid);
+        if (!m_progress_timer->isActive())
+            m_progress_timer->start();
     }
 
 }
@@ -284,8 +377,9 @@ void ConcurrentTask::updateState()
 {
     if (totalSize() > 1) {
         setProgress(m_done.count(), totalSize());
-        setStatus(tr("Executing %1 task(s) (%2 out of %3 are done)")
-                      .arg(QString::number(m_doing.count()), QString::number(m_done.count()), QString::number(totalSize())));
+        setStatus(tr("Executing %1 task(s) (%2 out of %3 are done%4)")
+                      .arg(QString::number(m_doing.count()), QString::number(m_done.count()), QString::number(totalSize()),
+                           concurrencyStatus()));
     } else {
         setProgress(m_stepProgress, m_stepTotalProgress);
         QString status = tr("Please wait...");
@@ -35,9 +35,11 @@
  */
 #pragma once
 
+#include <QElapsedTimer>
 #include <QHash>
 #include <QQueue>
 #include <QSet>
+#include <QTimer>
 #include <QUuid>
 #include <memory>
 
@@ -58,6 +60,18 @@ class ConcurrentTask : public Task {
 
     void addTask(Task::Ptr task);
 
+    /* How many of the tasks run at once.
+     *
+     * Fixed: the number it was made with. CpuBound: one per core, for work that keeps a core busy.
+     * Adaptive: starts at the number it was made with, which is also the most it goes up to. When a task fails, or
+     * they start taking much longer than they did at best, it halves, then gets back up one at a time for every round
+     * of tasks that went fine (AIMD, the way TCP does it). For requests to servers that may not take that many.
+     */
+    enum class Concurrency { Fixed, CpuBound, Adaptive };
+    void setConcurrency(Concurrency concurrency);
+    /** How many tasks it runs at once right now. */
+    auto maxConcurrent() const -> int { return m_total_max_size; }
+
    public slots:
     bool abort() override;
 
@@ -70,9 +84,11 @@ class ConcurrentTask : public Task {
     void executeTask() override;
 
     virtual void startNext();
+    /** Tracks the task as being done, and starts it. */
+    void startTask(Task::Ptr task);
 
     void subTaskSucceeded(Task::Ptr);
-    void subTaskFailed(Task::Ptr, const QString& msg);
+    virtual void subTaskFailed(Task::Ptr, const QString& msg);
     void subTaskStatus(Task::Ptr task, const QString& msg);
     void subTaskDetails(Task::Ptr task, const QString& msg);
     void subTaskProgress(Task::Ptr task, qint64 current, qint64 total);
@@ -87,6 +103,14 @@ class ConcurrentTask : public Task {
 
     virtual void updateState();
 
+    /** Tells the Adaptive concurrency how `task` went, the moment it's done with. */
+    void tuneConcurrency(Task* task, bool succeeded);
+    /** What updateState() adds to the status for the concurrency, nothing when it's fixed. */
+    auto concurrencyStatus() const -> QString;
+
+    /** Passes on the progress the tasks made since the last time, see s_progress_interval_ms. */
+    void flushProgress();
+
    protected:
     QString m_name;
     QString m_step_status;
@@ -102,8 +126,26 @@ class ConcurrentTask : public Task {
 
     int m_total_max_size;
 
+    Concurrency m_concurrency = Concurrency::Fixed;
+    // the number it was made with
+    int m_max_concurrent;
+    QElapsedTimer m_clock;
+    QHash<Task*, qint64> m_started_at;
+    // moving average of how long the tasks took, and the best it was
+    double m_duration_ms = -1;
+    double m_best_duration_ms = -1;
+    // the tasks that were running when the concurrency went down, they don't say anything of the new one
+    int m_round_left = 0;
+    int m_succeeded_since_change = 0;
+
     qint64 m_stepProgress = 0;
     qint64 m_stepTotalProgress = 100;
 
+    /* Downloads tell how far they are for every few kilobytes, which is far more often than anyone can look at it.
+     * Their progress is only kept until it's passed on, a few dozen times per second at most. */
+    static constexpr int s_progress_interval_ms = 33;
+    QTimer* m_progress_timer;
+    QSet<QUuid> m_changed_progress;
+
     bool m_aborted = false;
 };
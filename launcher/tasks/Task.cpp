@@ -35,6 +35,7 @@
  */
 
 #include "Task.h"
+#include "TaskTrace.h"
 
 #include <QDebug>
 
@@ -111,6 +112,8 @@ void Task::start()
     }
     // NOTE: only fall through to here in end states
     m_state = State::Running;
+    m_started_at = TaskTrace::now();
+    m_finished_at = 0;
     emit started();
     executeTask();
 }
@@ -125,6 +128,8 @@ void Task::emitFailed(QString reason)
     }
     m_state = State::Failed;
     m_failReason = reason;
+    m_finished_at = TaskTrace::now();
+    TaskTrace::record(*this);
     qCCritical(taskLogC) << "Task" << describe() << "failed: " << reason;
     emit failed(reason);
     emit finished();
@@ -140,6 +145,8 @@ void Task::emitAborted()
     }
     m_state = State::AbortedByUser;
     m_failReason = "Aborted.";
+    m_finished_at = TaskTrace::now();
+    TaskTrace::record(*this);
     if (m_show_debug)
         qCDebug(taskLogC) << "Task" << describe() << "aborted.";
     emit aborted();
@@ -155,6 +162,8 @@ void Task::emitSucceeded()
         return;
     }
     m_state = State::Succeeded;
+    m_finished_at = TaskTrace::now();
+    TaskTrace::record(*this);
     if (m_show_debug)
         qCDebug(taskLogC) << "Task" << describe() << "succeeded";
     emit succeeded();
@@ -201,6 +210,13 @@ bool Task::wasSuccessful() const
     return m_state == State::Succeeded;
 }
 
+qint64 Task::duration() const
+{
+    if (m_state == State::Inactive)
+        return 0;
+    return ((isRunning() ? TaskTrace::now() : m_finished_at) - m_started_at) / 1000;
+}
+
 QString Task::failReason() const
 {
     return m_failReason;
@@ -118,8 +118,8 @@ class Task : public QObject, public QRunnable {
 
     auto getState() const -> State { return m_state; }
 
-    QString getStatus() { return m_status; }
-    QString getDetails() { return m_details; }
+    QString getStatus() const { return m_status; }
+    QString getDetails() const { return m_details; }
 
     qint64 getProgress() { return m_progress; }
     qint64 getTotalProgress() { return m_progressTotal; }
@@ -127,7 +127,13 @@ class Task : public QObject, public QRunnable {
 
      
 
-    QUuid getUid() { return m_uid; }
+    QUuid getUid() const { return m_uid; }
+
+    /** When the task last started and finished, in TaskTrace::now() microseconds. */
+    qint64 startedAt() const { return m_started_at; }
+    qint64 finishedAt() const { return m_finished_at; }
+    /** How long the task ran for, in milliseconds, up to now if it still runs. */
+    qint64 duration() const;
 
    protected:
     void logWarning(const QString& line);
@@ -190,5 +196,7 @@ class Task : public QObject, public QRunnable {
     // Change using setAbortStatus
     bool m_can_abort = false;
     QUuid m_uid;
+    qint64 m_started_at = 0;
+    qint64 m_finished_at = 0;
 
 };
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "TaskGraph.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+TaskGraph::TaskGraph(QObject* parent, QString task_name, int max_concurrent) : ConcurrentTask(parent, task_name, max_concurrent) {}
+
+void TaskGraph::addTask(Task::Ptr task, const QList<Task::Ptr>& dependencies)
+{
+    auto& task_dependencies = m_dependencies[task.get()];
+    for (auto& dependency : dependencies)
+        task_dependencies.append(dependency.get());
+    ConcurrentTask::addTask(task);
+}
+
+bool TaskGraph::isReady(const Task::Ptr& task) const
+{
+    auto dependencies = m_dependencies.value(task.get());
+    return std::all_of(dependencies.cbegin(), dependencies.cend(), [this](Task* dependency) { return m_succeeded.contains(dependency); });
+}
+
+void TaskGraph::startNext()
+{
+    if (m_aborted || !isRunning())
+        return;
+
+    if (!m_failed.isEmpty()) {
+        auto reason = m_failed.constBegin().value()->failReason();
+        // don't come back here when the aborted tasks fail in turn
+        m_queue.clear();
+        m_aborted = true;
+        for (auto& task : m_doing.values()) {
+            if (task->canAbort())
+                task->abort();
+        }
+        emitFailed(reason);
+        return;
+    }
+
+    if (m_queue.isEmpty() && m_doing.isEmpty()) {
+        emitSucceeded();
+        return;
+    }
+
+    if (m_doing.size() >= m_total_max_size)
+        return;
+
+    auto is_ready = [this](const Task::Ptr& task) { return isReady(task); };
+    auto next = std::find_if(m_queue.begin(), m_queue.end(), is_ready);
+    if (next == m_queue.end()) {
+        // Nothing running means nothing left to wait for, so the remaining tasks depend on tasks that aren't in the graph
+        // (or on each other)
+        if (m_doing.isEmpty()) {
+            qWarning() << "TaskGraph" << m_name << ":" << m_queue.size() << "task(s) wait for tasks that will never run";
+            emitFailed(tr("Some tasks depend on tasks that will never run."));
+        }
+        return;
+    }
+
+    auto task = *next;
+    m_queue.erase(next);
+    startTask(task);
+
+    // Start the other tasks that are ready as well, one at a time like ConcurrentTask does
+    int num_starts = qMin(int(std::count_if(m_queue.begin(), m_queue.end(), is_ready)), m_total_max_size - int(m_doing.size()));
+    for (int i = 0; i < num_starts; i++)
+        QMetaObject::invokeMethod(this, &TaskGraph::startNext, Qt::QueuedConnection);
+}
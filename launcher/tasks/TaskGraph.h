@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+
+#include "ConcurrentTask.h"
+
+/** A concurrent task whose tasks can depend on each other.
+ *
+ *  A task is only started once all the tasks it depends on have succeeded, and tasks with nothing left to wait
+ *  for run at the same time, up to the maximum number of concurrent tasks. The first failure fails the whole
+ *  graph, aborting the tasks that are still running.
+ *
+ *  Tasks that are already running when they're added are waited for, without being started again.
+ */
+class TaskGraph : public ConcurrentTask {
+    Q_OBJECT
+   public:
+    explicit TaskGraph(QObject* parent = nullptr, QString task_name = "", int max_concurrent = 6);
+    ~TaskGraph() override = default;
+
+    /** Adds a task, that won't start before the given ones (which must be part of the graph too) succeed. */
+    void addTask(Task::Ptr task, const QList<Task::Ptr>& dependencies = {});
+
+   protected:
+    void startNext() override;
+
+   private:
+    bool isReady(const Task::Ptr& task) const;
+
+   private:
+    QHash<Task*, QList<Task*>> m_dependencies;
+};
@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "TaskTrace.h"
+
+#include <QAtomicInt>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSaveFile>
+#include <deque>
+
+#include "FileSystem.h"
+#include "Task.h"
+
+namespace TaskTrace {
+
+namespace {
+// about a launch with all of its downloads, a few times over
+constexpr std::size_t s_max_spans = 20000;
+// how many saved traces are kept around
+constexpr int s_max_files = 10;
+
+struct Span {
+    QString name;
+    QString uid;
+    QString outcome;
+    QString status;
+    qint64 begin = 0;
+    qint64 end = 0;
+    int thread = 0;
+};
+
+QAtomicInt s_recording = 0;
+QMutex s_mutex;
+std::deque<Span> s_spans;
+
+QElapsedTimer& clock()
+{
+    static QElapsedTimer timer = [] {
+        QElapsedTimer started;
+        started.start();
+        return started;
+    }();
+    return timer;
+}
+
+// small numbers read better than thread handles in the viewers
+int threadNumber()
+{
+    static QAtomicInt s_next_thread = 0;
+    thread_local int number = s_next_thread.fetchAndAddRelaxed(1) + 1;
+    return number;
+}
+
+QString outcomeName(Task::State state)
+{
+    switch (state) {
+        case Task::State::Succeeded:
+            return "succeeded";
+        case Task::State::Failed:
+            return "failed";
+        case Task::State::AbortedByUser:
+            return "aborted";
+        default:
+            return "unfinished";
+    }
+}
+}  // namespace
+
+qint64 now()
+{
+    return clock().nsecsElapsed() / 1000;
+}
+
+bool isRecording()
+{
+    return s_recording.loadRelaxed();
+}
+
+void setRecording(bool recording)
+{
+    s_recording.storeRelaxed(recording);
+    if (!recording) {
+        QMutexLocker locker(&s_mutex);
+        s_spans.clear();
+    }
+}
+
+void record(const Task& task)
+{
+    if (!isRecording())
+        return;
+
+    Span span;
+    span.name = task.metaObject()->className();
+    if (!task.objectName().isEmpty())
+        span.name += " " + task.objectName();
+    span.uid = task.getUid().toString(QUuid::WithoutBraces);
+    span.outcome = outcomeName(task.getState());
+    span.status = task.getStatus();
+    span.begin = task.startedAt();
+    span.end = task.finishedAt();
+    span.thread = threadNumber();
+
+    QMutexLocker locker(&s_mutex);
+    s_spans.push_back(std::move(span));
+    if (s_spans.size() > s_max_spans)
+        s_spans.pop_front();
+}
+
+QByteArray toJson(qint64 from, qint64 to)
+{
+    QJsonArray events;
+    events.append(QJsonObject{ { "name", "process_name" }, { "ph", "M" }, { "pid", 1 }, { "args", QJsonObject{ { "name", "Launcher tasks" } } } });
+
+    QMutexLocker locker(&s_mutex);
+    for (auto& span : s_spans) {
+        if (span.begin < from || span.end > to)
+            continue;
+        // async events, the tasks of a thread overlap without nesting
+        QJsonObject begin{ { "name", span.name }, { "cat", "task" }, { "ph", "b" },   { "id", span.uid },
+                           { "ts", span.begin }, { "pid", 1 },       { "tid", span.thread } };
+        begin.insert("args", QJsonObject{ { "status", span.status } });
+        QJsonObject end{ { "name", span.name }, { "cat", "task" }, { "ph", "e" },   { "id", span.uid },
+                         { "ts", span.end },   { "pid", 1 },       { "tid", span.thread } };
+        end.insert("args", QJsonObject{ { "outcome", span.outcome } });
+        events.append(begin);
+        events.append(end);
+    }
+    locker.unlock();
+
+    return QJsonDocument(QJsonObject{ { "traceEvents", events }, { "displayTimeUnit", "ms" } }).toJson(QJsonDocument::Compact);
+}
+
+QString save(const Task& task, const QString& name)
+{
+    if (!isRecording())
+        return {};
+
+    QDir dir("cache/traces");
+    if (!FS::ensureFolderPathExists(dir.absolutePath()))
+        return {};
+
+    auto old = dir.entryList({ "*.json" }, QDir::Files, QDir::Time);
+    while (old.size() >= s_max_files)
+        dir.remove(old.takeLast());
+
+    auto path = dir.absoluteFilePath(QString("%1-%2.json").arg(name, QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss")));
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(toJson(task.startedAt(), task.finishedAt())) < 0 || !file.commit()) {
+        qWarning() << "Couldn't write the task trace to" << path;
+        return {};
+    }
+    return path;
+}
+
+}  // namespace TaskTrace
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+class Task;
+
+/* Where the time of the tasks goes.
+ *
+ * Every task keeps when it started and finished, on a monotonic clock. While recording, the tasks that finish
+ * also leave a span here (the last few thousand are kept), and the spans of the tasks that ran during a launch
+ * or an install can be saved in the Chrome trace event format, which chrome://tracing and Perfetto open.
+ */
+namespace TaskTrace {
+
+/** Microseconds since the first time this was called, as the spans are timed. */
+qint64 now();
+
+bool isRecording();
+void setRecording(bool recording);
+
+/** Keeps the span of a task that just finished. Does nothing when not recording. */
+void record(const Task& task);
+
+/** The trace of the spans that started no sooner than `from` and finished no later than `to`. */
+QByteArray toJson(qint64 from, qint64 to);
+
+/** Writes the trace of a task and what ran while it did to the trace folder, returns the path of the file. */
+QString save(const Task& task, const QString& name);
+
+}  // namespace TaskTrace
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "AsyncProfiler.h"
+
+#include <QDir>
+#include <QFileInfo>
+
+#include "settings/SettingsObject.h"
+
+class AsyncProfiler : public RecordingProfiler
+{
+    Q_OBJECT
+public:
+    AsyncProfiler(SettingsObjectPtr settings, InstancePtr instance, QObject *parent = 0)
+        : RecordingProfiler(settings, instance, "html", parent)
+    {
+    }
+
+protected:
+    QStringList recordingArguments(const QString &path, int seconds) const override
+    {
+        auto library = AsyncProfilerFactory::agentLibrary(globalSettings->get("AsyncProfilerPath").toString());
+        // a flame graph of where the CPU time goes, the format comes from the extension of the file
+        QString options = "start,event=cpu,file=" + path;
+        if (seconds > 0)
+            options += QString(",timeout=%1").arg(seconds);
+        return { "-agentpath:" + library + "=" + options };
+    }
+};
+
+void AsyncProfilerFactory::registerSettings(SettingsObjectPtr settings)
+{
+    RecordingProfilerFactory::registerSettings(settings);
+    settings->registerSetting("AsyncProfilerPath");
+}
+
+BaseExternalTool *AsyncProfilerFactory::createTool(InstancePtr instance, QObject *parent)
+{
+    return new AsyncProfiler(globalSettings, instance, parent);
+}
+
+QString AsyncProfilerFactory::agentLibrary(const QString &path)
+{
+    QDir dir(path);
+    // the library went from the build folder to lib, and is a .dylib on macOS from version 3 on
+    for (auto name : { "lib/libasyncProfiler.so", "lib/libasyncProfiler.dylib", "build/libasyncProfiler.so" })
+    {
+        if (dir.exists(name))
+            return QFileInfo(dir.absoluteFilePath(name)).absoluteFilePath();
+    }
+    return {};
+}
+
+bool AsyncProfilerFactory::check(QString *error)
+{
+    return check(globalSettings->get("AsyncProfilerPath").toString(), error);
+}
+
+bool AsyncProfilerFactory::check(const QString &path, QString *error)
+{
+#ifdef Q_OS_WIN
+    *error = QObject::tr("async-profiler only runs on Linux and macOS");
+    return false;
+#else
+    if (path.isEmpty())
+    {
+        *error = QObject::tr("Empty path");
+        return false;
+    }
+    QDir dir(path);
+    if (!dir.exists())
+    {
+        *error = QObject::tr("Path does not exist");
+        return false;
+    }
+    if (agentLibrary(path).isEmpty())
+    {
+        *error = QObject::tr("Invalid async-profiler install");
+        return false;
+    }
+    return true;
+#endif
+}
+
+#include "AsyncProfiler.moc"
@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "RecordingProfiler.h"
+
+class AsyncProfilerFactory : public RecordingProfilerFactory
+{
+public:
+    QString name() const override { return "async-profiler"; }
+    void registerSettings(SettingsObjectPtr settings) override;
+    BaseExternalTool *createTool(InstancePtr instance, QObject *parent = 0) override;
+    bool check(QString *error) override;
+    bool check(const QString &path, QString *error) override;
+
+    /** The agent library in the async-profiler install at `path`, empty if there is none. */
+    static QString agentLibrary(const QString &path);
+};
@@ -14,19 +14,26 @@ class BaseProfiler : public BaseExternalTool
 public:
     explicit BaseProfiler(SettingsObjectPtr settings, InstancePtr instance, QObject *parent = 0);
 
+    /**
+     * What the JVM has to be started with, for profilers that record from the start instead of attaching to the game.
+     */
+    virtual QStringList launchArguments() { return {}; }
+
 public
 slots:
     void beginProfiling(shared_qobject_ptr<LaunchTask> process);
     void abortProfiling();
 
 protected:
-    QProcess *m_profilerProcess;
+    QProcess *m_profilerProcess = nullptr;
 
     virtual void beginProfilingImpl(shared_qobject_ptr<LaunchTask> process) = 0;
     virtual void abortProfilingImpl();
 
 signals:
     void readyToLaunch(const QString &message);
+    // the profiler records already, the game can go ahead without waiting for the user
+    void recording(const QString &message);
     void abortLaunch(const QString &message);
 };
 
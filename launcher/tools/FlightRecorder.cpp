@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "FlightRecorder.h"
+
+#include "java/JavaVersion.h"
+#include "settings/SettingsObject.h"
+
+class FlightRecorder : public RecordingProfiler
+{
+    Q_OBJECT
+public:
+    FlightRecorder(SettingsObjectPtr settings, InstancePtr instance, QObject *parent = 0)
+        : RecordingProfiler(settings, instance, "jfr", parent)
+    {
+    }
+
+protected:
+    QString unsupportedReason() const override
+    {
+        // it came to OpenJDK 8 with update 262, before that it was in the commercial builds of Oracle only
+        JavaVersion version(m_instance->settings()->get("JavaVersion").toString());
+        if (version.major() < 8 || (version.major() < 11 && !(version.major() == 8 && version.security() >= 262)))
+            return tr("Java Flight Recorder needs Java 11, or Java 8 from update 262 on");
+        return RecordingProfiler::unsupportedReason();
+    }
+
+    QStringList recordingArguments(const QString &path, int seconds) const override
+    {
+        QString options = "settings=profile,dumponexit=true,filename=" + path;
+        if (seconds > 0)
+            options += QString(",duration=%1s").arg(seconds);
+        return { "-XX:StartFlightRecording=" + options };
+    }
+};
+
+BaseExternalTool *FlightRecorderFactory::createTool(InstancePtr instance, QObject *parent)
+{
+    return new FlightRecorder(globalSettings, instance, parent);
+}
+
+bool FlightRecorderFactory::check(QString *)
+{
+    // part of the JVM, whether it's there depends on the Java of the instance
+    return true;
+}
+
+bool FlightRecorderFactory::check(const QString &, QString *)
+{
+    return true;
+}
+
+#include "FlightRecorder.moc"
@@ -0,0 +1,14 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "RecordingProfiler.h"
+
+class FlightRecorderFactory : public RecordingProfilerFactory
+{
+public:
+    QString name() const override { return "Java Flight Recorder"; }
+    BaseExternalTool *createTool(InstancePtr instance, QObject *parent = 0) override;
+    bool check(QString *error) override;
+    bool check(const QString &path, QString *error) override;
+};
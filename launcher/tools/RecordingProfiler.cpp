@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "RecordingProfiler.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+
+#include "FileSystem.h"
+#include "launch/LaunchTask.h"
+#include "settings/SettingsObject.h"
+
+RecordingProfiler::RecordingProfiler(SettingsObjectPtr settings, InstancePtr instance, const QString &extension, QObject *parent)
+    : BaseProfiler(settings, instance, parent)
+{
+    auto name = QDateTime::currentDateTime().toString("yyyy-MM-dd_HH-mm-ss") + '.' + extension;
+    m_recordingPath = FS::PathCombine(m_instance->instanceRoot(), "profiles", name);
+}
+
+QString RecordingProfiler::unsupportedReason() const
+{
+    // both take their options as a list split by commas
+    if (m_recordingPath.contains(','))
+        return tr("The path of the instance can't have commas in it: %1").arg(m_instance->instanceRoot());
+    return {};
+}
+
+QStringList RecordingProfiler::launchArguments()
+{
+    if (!unsupportedReason().isEmpty() || !FS::ensureFilePathExists(m_recordingPath))
+        return {};
+    return recordingArguments(QFileInfo(m_recordingPath).absoluteFilePath(), globalSettings->get("ProfileStartupSeconds").toInt());
+}
+
+void RecordingProfiler::beginProfilingImpl(shared_qobject_ptr<LaunchTask> process)
+{
+    auto reason = unsupportedReason();
+    if (!reason.isEmpty())
+    {
+        emit abortLaunch(reason);
+        return;
+    }
+
+    auto path = m_recordingPath;
+    connect(process.get(), &LaunchTask::finished, this, [process, path]() {
+        if (QFileInfo::exists(path))
+            process->onLogLine(tr("The profile was saved to %1").arg(path), MessageLevel::Launcher);
+        else
+            process->onLogLine(tr("The profiler didn't write anything to %1").arg(path), MessageLevel::Warning);
+    });
+
+    auto seconds = globalSettings->get("ProfileStartupSeconds").toInt();
+    if (seconds > 0)
+        emit recording(tr("Recording the first %1 seconds to %2").arg(seconds).arg(path));
+    else
+        emit recording(tr("Recording until the game exits to %1").arg(path));
+}
+
+void RecordingProfilerFactory::registerSettings(SettingsObjectPtr settings)
+{
+    // 0 records the whole session
+    settings->registerSetting("ProfileStartupSeconds", 0);
+    globalSettings = settings;
+}
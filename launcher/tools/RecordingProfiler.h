@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "BaseProfiler.h"
+
+/* Profilers that are built into the JVM or loaded by it, and record from the start of the game.
+ *
+ * The recording goes to the profiles folder of the instance and is written when the game exits, or once the startup
+ * seconds of the ProfileStartupSeconds setting are over. Nothing has to be set up by the user while the game waits.
+ */
+class RecordingProfiler : public BaseProfiler
+{
+    Q_OBJECT
+public:
+    RecordingProfiler(SettingsObjectPtr settings, InstancePtr instance, const QString &extension, QObject *parent = 0);
+
+    QStringList launchArguments() override;
+
+    QString recordingPath() const { return m_recordingPath; }
+
+protected:
+    /** Why the instance can't be profiled like this, empty when it can. */
+    virtual QString unsupportedReason() const;
+    /** The arguments for recording to `path`, for `seconds` or until the game exits when 0. */
+    virtual QStringList recordingArguments(const QString &path, int seconds) const = 0;
+
+    void beginProfilingImpl(shared_qobject_ptr<LaunchTask> process) override;
+
+private:
+    QString m_recordingPath;
+};
+
+class RecordingProfilerFactory : public BaseProfilerFactory
+{
+public:
+    void registerSettings(SettingsObjectPtr settings) override;
+};
@@ -1,6 +1,16 @@
 #include "POTranslator.h"
 
+#include <QDateTime>
 #include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include "FileSystem.h"
 
 struct POEntry
@@ -9,14 +19,374 @@ struct POEntry
     bool fuzzy;
 };
 
+/* A .po file compiled into a table that is looked up where it lies in memory, without parsing anything.
+ *
+ * The keys are hashed into buckets, and each bucket has a seed that puts all of its keys into free slots of the table,
+ * so a lookup is two hashes and one comparison of the key. The layout, in little endian:
+ *
+ *   header: quint32 magic, quint32 version, qint64 size and qint64 modification time of the .po, quint32 slot count,
+ *           quint32 bucket count
+ *   seeds:  quint32 per bucket
+ *   slots:  quint32 key offset, key size, text offset, text size in UTF-16 units, flags
+ *   data:   the keys in UTF-8, then the texts in UTF-16
+ *
+ * Keys are "context|source", the ones with a disambiguation "\x01context|source@disambiguation".
+ */
+class POCatalog
+{
+public:
+    struct Piece
+    {
+        const char * data;
+        uint size;
+    };
+
+    struct Found
+    {
+        QString text;
+        bool fuzzy;
+    };
+
+    static bool write(const QString & path, const QHash<QByteArray, POEntry> & entries, qint64 sourceSize, qint64 sourceTime);
+
+    bool open(const QString & path, qint64 sourceSize, qint64 sourceTime);
+    void close();
+    bool isOpen() const
+    {
+        return m_data != nullptr;
+    }
+    bool find(std::initializer_list<Piece> key, Found & found) const;
+
+private:
+    static constexpr quint32 magic = 0x504f4354; // "POCT"
+    static constexpr quint32 version = 1;
+    static constexpr quint32 emptySlot = 0xFFFFFFFF;
+    static constexpr int headerSize = 32;
+    static constexpr int slotSize = 20;
+    static constexpr quint32 fuzzyFlag = 1;
+
+    static quint64 hash(std::initializer_list<Piece> key);
+    static quint64 mix(quint64 value);
+    static quint32 bucketOf(quint64 hash, quint32 buckets)
+    {
+        return mix(hash) % buckets;
+    }
+    static quint32 slotOf(quint64 hash, quint32 seed, quint32 slots)
+    {
+        return mix(hash + seed * Q_UINT64_C(0x9E3779B97F4A7C15)) % slots;
+    }
+    quint32 read32(qint64 offset) const
+    {
+        return qFromLittleEndian<quint32>(m_data + offset);
+    }
+
+    QFile m_file;
+    QByteArray m_buffer;
+    const uchar * m_data = nullptr;
+    qint64 m_size = 0;
+    quint32 m_slots = 0;
+    quint32 m_buckets = 0;
+    qint64 m_slotsStart = 0;
+    qint64 m_dataStart = 0;
+};
+
+quint64 POCatalog::mix(quint64 value)
+{
+    // the finalizer of splitmix64
+    value ^= value >> 30;
+    value *= Q_UINT64_C(0xBF58476D1CE4E5B9);
+    value ^= value >> 27;
+    value *= Q_UINT64_C(0x94D049BB133111EB);
+    value ^= value >> 31;
+    return value;
+}
+
+quint64 POCatalog::hash(std::initializer_list<Piece> key)
+{
+    // FNV-1a over the pieces, as if they were one string
+    quint64 result = Q_UINT64_C(0xcbf29ce484222325);
+    for(auto & piece : key)
+    {
+        for(uint i = 0; i < piece.size; i++)
+        {
+            result ^= static_cast<uchar>(piece.data[i]);
+            result *= Q_UINT64_C(0x100000001b3);
+        }
+    }
+    return result;
+}
+
+bool POCatalog::write(const QString & path, const QHash<QByteArray, POEntry> & entries, qint64 sourceSize, qint64 sourceTime)
+{
+    std::vector<QByteArray> keys;
+    std::vector<const POEntry *> values;
+    keys.reserve(entries.size());
+    values.reserve(entries.size());
+    for(auto iter = entries.cbegin(); iter != entries.cend(); iter++)
+    {
+        keys.push_back(iter.key());
+        values.push_back(&iter.value());
+    }
+
+    quint32 count = static_cast<quint32>(keys.size());
+    quint32 slots = qMax<quint32>(1, count + count / 4);
+    quint32 buckets = qMax<quint32>(1, (count + 3) / 4);
+
+    std::vector<quint64> hashes(count);
+    std::vector<std::vector<quint32>> bucketKeys(buckets);
+    for(quint32 i = 0; i < count; i++)
+    {
+        hashes[i] = hash({ { keys[i].constData(), static_cast<uint>(keys[i].size()) } });
+        bucketKeys[bucketOf(hashes[i], buckets)].push_back(i);
+    }
+
+    // the big buckets are placed first, while there is still a lot of room
+    std::vector<quint32> order(buckets);
+    for(quint32 i = 0; i < buckets; i++)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](quint32 a, quint32 b) { return bucketKeys[a].size() > bucketKeys[b].size(); });
+
+    std::vector<quint32> seeds(buckets, 0);
+    std::vector<qint64> slotKey(slots, -1);
+    std::vector<quint32> placed;
+    for(auto bucket : order)
+    {
+        auto & members = bucketKeys[bucket];
+        if(members.empty())
+        {
+            break;
+        }
+        bool done = false;
+        for(quint32 seed = 1; seed < (1u << 20) && !done; seed++)
+        {
+            placed.clear();
+            done = true;
+            for(auto key : members)
+            {
+                auto slot = slotOf(hashes[key], seed, slots);
+                if(slotKey[slot] != -1 || std::find(placed.begin(), placed.end(), slot) != placed.end())
+                {
+                    done = false;
+                    break;
+                }
+                placed.push_back(slot);
+            }
+            if(done)
+            {
+                seeds[bucket] = seed;
+                for(size_t i = 0; i < members.size(); i++)
+                {
+                    slotKey[placed[i]] = members[i];
+                }
+            }
+        }
+        if(!done)
+        {
+            qWarning() << "Could not build a translation catalog for" << path;
+            return false;
+        }
+    }
+
+    QByteArray keyData;
+    QByteArray textData;
+    QByteArray table(static_cast<int>(slots) * slotSize, Qt::Uninitialized);
+    for(quint32 slot = 0; slot < slots; slot++)
+    {
+        auto out = reinterpret_cast<uchar *>(table.data()) + slot * slotSize;
+        auto key = slotKey[slot];
+        if(key < 0)
+        {
+            qToLittleEndian<quint32>(0, out);
+            qToLittleEndian<quint32>(emptySlot, out + 4);
+            qToLittleEndian<quint32>(0, out + 8);
+            qToLittleEndian<quint32>(0, out + 12);
+            qToLittleEndian<quint32>(0, out + 16);
+            continue;
+        }
+        auto & text = values[key]->text;
+        qToLittleEndian<quint32>(keyData.size(), out);
+        qToLittleEndian<quint32>(keys[key].size(), out + 4);
+        qToLittleEndian<quint32>(textData.size(), out + 8);
+        qToLittleEndian<quint32>(text.size(), out + 12);
+        qToLittleEndian<quint32>(values[key]->fuzzy ? fuzzyFlag : 0, out + 16);
+        keyData += keys[key];
+        for(auto c : text)
+        {
+            char unit[2];
+            qToLittleEndian<quint16>(c.unicode(), unit);
+            textData.append(unit, 2);
+        }
+    }
+    // the texts are read where they are, in steps of two bytes
+    if(keyData.size() % 2)
+    {
+        keyData.append('\0');
+    }
+
+    QByteArray header(headerSize, Qt::Uninitialized);
+    auto out = reinterpret_cast<uchar *>(header.data());
+    qToLittleEndian<quint32>(magic, out);
+    qToLittleEndian<quint32>(version, out + 4);
+    qToLittleEndian<qint64>(sourceSize, out + 8);
+    qToLittleEndian<qint64>(sourceTime, out + 16);
+    qToLittleEndian<quint32>(slots, out + 24);
+    qToLittleEndian<quint32>(buckets, out + 28);
+
+    QByteArray seedData(static_cast<int>(buckets) * 4, Qt::Uninitialized);
+    for(quint32 i = 0; i < buckets; i++)
+    {
+        qToLittleEndian<quint32>(seeds[i], reinterpret_cast<uchar *>(seedData.data()) + i * 4);
+    }
+
+    // the text offsets count from the start of the data, after the keys
+    auto patch = reinterpret_cast<uchar *>(table.data());
+    for(quint32 slot = 0; slot < slots; slot++)
+    {
+        auto entry = patch + slot * slotSize;
+        if(qFromLittleEndian<quint32>(entry + 4) != emptySlot)
+        {
+            qToLittleEndian<quint32>(qFromLittleEndian<quint32>(entry + 8) + keyData.size(), entry + 8);
+        }
+    }
+
+    QSaveFile file(path);
+    if(!FS::ensureFilePathExists(path) || !file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Could not write the translation catalog" << path << file.errorString();
+        return false;
+    }
+    file.write(header);
+    file.write(seedData);
+    file.write(table);
+    file.write(keyData);
+    file.write(textData);
+    if(!file.commit())
+    {
+        qWarning() << "Could not write the translation catalog" << path << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool POCatalog::open(const QString & path, qint64 sourceSize, qint64 sourceTime)
+{
+    close();
+    m_file.setFileName(path);
+    if(!m_file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    m_size = m_file.size();
+    if(m_size < headerSize)
+    {
+        m_file.close();
+        return false;
+    }
+    m_data = m_file.map(0, m_size);
+    if(!m_data)
+    {
+        m_buffer = m_file.readAll();
+        m_data = reinterpret_cast<const uchar *>(m_buffer.constData());
+        m_size = m_buffer.size();
+    }
+
+    auto valid = [&]() {
+        if(m_size < headerSize || read32(0) != magic || read32(4) != version)
+        {
+            return false;
+        }
+        // a catalog of another version of the .po is useless
+        if(qFromLittleEndian<qint64>(m_data + 8) != sourceSize || qFromLittleEndian<qint64>(m_data + 16) != sourceTime)
+        {
+            return false;
+        }
+        m_slots = read32(24);
+        m_buckets = read32(28);
+        m_slotsStart = headerSize + qint64(m_buckets) * 4;
+        m_dataStart = m_slotsStart + qint64(m_slots) * slotSize;
+        return m_slots > 0 && m_buckets > 0 && m_dataStart <= m_size;
+    };
+    if(!valid())
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void POCatalog::close()
+{
+    m_data = nullptr;
+    m_buffer.clear();
+    // closing the file unmaps it
+    m_file.close();
+}
+
+bool POCatalog::find(std::initializer_list<Piece> key, Found & found) const
+{
+    auto keyHash = hash(key);
+    auto seed = read32(headerSize + qint64(bucketOf(keyHash, m_buckets)) * 4);
+    auto slot = m_slotsStart + qint64(slotOf(keyHash, seed, m_slots)) * slotSize;
+
+    auto keyOffset = m_dataStart + read32(slot);
+    auto keySize = read32(slot + 4);
+    if(keySize == emptySlot || keyOffset + keySize > m_size)
+    {
+        return false;
+    }
+
+    // the slot holds whatever key hashes there, so it still has to be this one
+    uint total = 0;
+    for(auto & piece : key)
+    {
+        total += piece.size;
+    }
+    if(total != keySize)
+    {
+        return false;
+    }
+    auto stored = reinterpret_cast<const char *>(m_data + keyOffset);
+    for(auto & piece : key)
+    {
+        if(piece.size && memcmp(stored, piece.data, piece.size) != 0)
+        {
+            return false;
+        }
+        stored += piece.size;
+    }
+
+    auto textOffset = m_dataStart + read32(slot + 8);
+    auto textSize = read32(slot + 12);
+    if(textOffset + qint64(textSize) * 2 > m_size)
+    {
+        return false;
+    }
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    found.text = QString(reinterpret_cast<const QChar *>(m_data + textOffset), textSize);
+#else
+    found.text.resize(textSize);
+    for(quint32 i = 0; i < textSize; i++)
+    {
+        found.text[i] = QChar(qFromLittleEndian<quint16>(m_data + textOffset + i * 2));
+    }
+#endif
+    found.fuzzy = read32(slot + 16) & fuzzyFlag;
+    return true;
+}
+
 struct POTranslatorPrivate
 {
     QString filename;
     QHash<QByteArray, POEntry> mapping;
     QHash<QByteArray, POEntry> mapping_disambiguatrion;
+    POCatalog catalog;
     bool loaded = false;
 
     void reload();
+    bool parse();
+    QString catalogPath() const;
 };
 
 class ParserArray : public QByteArray
@@ -153,13 +523,48 @@ public:
     }
 };
 
+QString POTranslatorPrivate::catalogPath() const
+{
+    // kept with the other caches, the translations folder is watched for changes
+    return QDir("cache").absoluteFilePath("translations/" + QFileInfo(filename).fileName() + "cat");
+}
+
 void POTranslatorPrivate::reload()
+{
+    QFileInfo source(filename);
+    auto sourceSize = source.size();
+    auto sourceTime = source.lastModified().toMSecsSinceEpoch();
+    if(source.exists() && catalog.open(catalogPath(), sourceSize, sourceTime))
+    {
+        loaded = true;
+        return;
+    }
+
+    if(!parse())
+    {
+        return;
+    }
+
+    // compiled once, every start after this one only maps it
+    auto entries = mapping;
+    for(auto iter = mapping_disambiguatrion.cbegin(); iter != mapping_disambiguatrion.cend(); iter++)
+    {
+        entries.insert("\x01" + iter.key(), iter.value());
+    }
+    if(POCatalog::write(catalogPath(), entries, sourceSize, sourceTime) && catalog.open(catalogPath(), sourceSize, sourceTime))
+    {
+        mapping.clear();
+        mapping_disambiguatrion.clear();
+    }
+}
+
+bool POTranslatorPrivate::parse()
 {
     QFile file(filename);
     if(!file.open(QFile::OpenMode::enum_type::ReadOnly | QFile::OpenMode::enum_type::Text))
     {
         qDebug() << "Failed to open PO file:" << filename;
-        return;
+        return false;
     }
 
     QByteArray context;
@@ -232,7 +637,7 @@ void POTranslatorPrivate::reload()
             {
                 case Mode::First:
                     qDebug() << "Unexpected escaped string during initial state... line:" << lineNumber;
-                    return;
+                    return false;
                 case Mode::MessageString:
                     out = &str;
                     break;
@@ -246,7 +651,7 @@ void POTranslatorPrivate::reload()
             if(!line.chompString(*out))
             {
                 qDebug() << "Badly formatted string on line:" << lineNumber;
-                return;
+                return false;
             }
         }
         else if(line.chomp("msgctxt ", 8))
@@ -261,7 +666,7 @@ void POTranslatorPrivate::reload()
                 case Mode::MessageContext:
                 case Mode::MessageId:
                     qDebug() << "Unexpected msgctxt line:" << lineNumber;
-                    return;
+                    return false;
             }
             if(line.chompString(context))
             {
@@ -286,7 +691,7 @@ void POTranslatorPrivate::reload()
                     break;
                 case Mode::MessageId:
                     qDebug() << "Unexpected msgid line:" << lineNumber;
-                    return;
+                    return false;
             }
             if(line.chompString(id))
             {
@@ -301,7 +706,7 @@ void POTranslatorPrivate::reload()
                 case Mode::MessageString:
                 case Mode::MessageContext:
                     qDebug() << "Unexpected msgstr line:" << lineNumber;
-                    return;
+                    return false;
                 case Mode::MessageId:
                     break;
             }
@@ -320,6 +725,7 @@ void POTranslatorPrivate::reload()
     mapping = std::move(newMapping);
     mapping_disambiguatrion = std::move(newMapping_disambiguation);
     loaded = true;
+    return true;
 }
 
 POTranslator::POTranslator(const QString& filename, QObject* parent) : QTranslator(parent)
@@ -336,6 +742,38 @@ POTranslator::~POTranslator()
 
 QString POTranslator::translate(const char* context, const char* sourceText, const char* disambiguation, int n) const
 {
+    if(d->catalog.isOpen())
+    {
+        // looked up piece by piece, no key is put together for strings that are there
+        POCatalog::Piece contextPiece { context ? context : "", context ? static_cast<uint>(strlen(context)) : 0u };
+        POCatalog::Piece sourcePiece { sourceText ? sourceText : "", sourceText ? static_cast<uint>(strlen(sourceText)) : 0u };
+        POCatalog::Found found;
+        auto check = [&](const QByteArray & key) {
+            if(found.text.isEmpty())
+            {
+                qDebug() << "Translation entry has no content:" << key;
+            }
+            if(found.fuzzy)
+            {
+                qDebug() << "Translation entry is fuzzy:" << key << "->" << found.text;
+            }
+            return found.text;
+        };
+        if(disambiguation)
+        {
+            POCatalog::Piece disambiguationPiece { disambiguation, static_cast<uint>(strlen(disambiguation)) };
+            if(d->catalog.find({ { "\x01", 1 }, contextPiece, { "|", 1 }, sourcePiece, { "@", 1 }, disambiguationPiece }, found))
+            {
+                return check(QByteArray(context) + "|" + QByteArray(sourceText) + "@" + QByteArray(disambiguation));
+            }
+        }
+        if(d->catalog.find({ contextPiece, { "|", 1 }, sourcePiece }, found))
+        {
+            return check(QByteArray(context) + "|" + QByteArray(sourceText));
+        }
+        return QString();
+    }
+
     if(disambiguation)
     {
         auto disambiguationKey = QByteArray(context) + "|" + QByteArray(sourceText) + "@" + QByteArray(disambiguation);
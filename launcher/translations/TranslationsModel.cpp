@@ -42,6 +42,8 @@
 #include <QDir>
 #include <QLibraryInfo>
 #include <QDebug>
+#include <QCryptographicHash>
+#include <QFile>
 
 #include "FileSystem.h"
 #include "net/NetJob.h"
@@ -54,6 +56,8 @@
 #include "Application.h"
 
 const static QLatin1String defaultLangCode("en_US");
+// for how long after it expired the cached index is still used while a newer one is looked for
+const static qint64 s_index_max_stale = 7 * 24 * 60 * 60;
 
 enum class FileType
 {
@@ -194,6 +198,8 @@ struct TranslationsModel::Private
     QString m_downloadingTranslation;
     NetJob::Ptr m_dl_job;
     NetJob::Ptr m_index_job;
+    // whether the check of the cached index that's used in the meantime found a newer one
+    bool m_index_changed = false;
     QString m_nextDownload;
 
     std::unique_ptr<POTranslator> m_po_translator;
@@ -205,12 +211,19 @@ struct TranslationsModel::Private
     bool no_language_set = false;
 };
 
-TranslationsModel::TranslationsModel(QString path, QObject* parent): QAbstractListModel(parent)
+TranslationsModel::TranslationsModel(QString path, QObject* parent): TranslationsModel(path, nullptr, parent)
+{
+}
+
+TranslationsModel::TranslationsModel(QString path, std::shared_ptr<LocalFiles> scanned, QObject* parent): QAbstractListModel(parent)
 {
     d.reset(new Private);
     d->m_dir.setPath(path);
     FS::ensureFolderPathExists(path);
-    reloadLocalFiles();
+    if (scanned)
+        applyLocalFiles(*scanned);
+    else
+        reloadLocalFiles();
 
     d->watcher = new QFileSystemWatcher(this);
     connect(d->watcher, &QFileSystemWatcher::directoryChanged, this, &TranslationsModel::translationDirChanged);
@@ -235,7 +248,11 @@ void TranslationsModel::indexReceived()
 {
     qDebug() << "Got translations index!";
     d->m_index_job.reset();
+    useIndex();
+}
 
+void TranslationsModel::useIndex()
+{
     if (d->no_language_set)
     {
         reloadLocalFiles();
@@ -317,12 +334,20 @@ void readIndex(const QString & path, QMap<QString, Language>& languages)
 }
 }
 
-void TranslationsModel::reloadLocalFiles()
+struct TranslationsModel::LocalFiles
+{
+    QMap<QString, Language> languages;
+};
+
+std::shared_ptr<TranslationsModel::LocalFiles> TranslationsModel::scanLocalFiles(const QString& path)
 {
-    QMap<QString, Language> languages = {{defaultLangCode, Language(defaultLangCode)}};
+    auto files = std::make_shared<LocalFiles>();
+    auto& languages = files->languages;
+    languages.insert(defaultLangCode, Language(defaultLangCode));
 
-    readIndex(d->m_dir.absoluteFilePath("index_v2.json"), languages);
-    auto entries = d->m_dir.entryInfoList({"mmc_*.qm", "*.po"}, QDir::Files | QDir::NoDotAndDotDot);
+    QDir dir(path);
+    readIndex(dir.absoluteFilePath("index_v2.json"), languages);
+    auto entries = dir.entryInfoList({"mmc_*.qm", "*.po"}, QDir::Files | QDir::NoDotAndDotDot);
     for(auto & entry: entries)
     {
         auto completeSuffix = entry.completeSuffix();
@@ -362,6 +387,17 @@ void TranslationsModel::reloadLocalFiles()
             }
         }
     }
+    return files;
+}
+
+void TranslationsModel::reloadLocalFiles()
+{
+    applyLocalFiles(*scanLocalFiles(d->m_dir.path()));
+}
+
+void TranslationsModel::applyLocalFiles(LocalFiles files)
+{
+    auto& languages = files.languages;
 
     // changed and removed languages
     for(auto iter = d->m_languages.begin(); iter != d->m_languages.end();)
@@ -671,14 +707,33 @@ void TranslationsModel::downloadIndex()
     }
     qDebug() << "Downloading Translations Index...";
     d->m_index_job.reset(new NetJob("Translations Index", APPLICATION->network()));
-    MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("translations", "index_v2.json");
-    entry->setStale(true);
+    d->m_index_job->setPriority(Net::Priority::Background);
+    // the index is fetched again once its age in the cache runs out, not on every start
+    MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("translations", "index_v2.json", {}, s_index_max_stale);
     auto task = Net::Download::makeCached(QUrl(BuildConfig.TRANSLATIONS_BASE_URL + "index_v2.json"), entry);
     d->m_index_task = task.get();
     d->m_index_job->addNetAction(task);
     connect(d->m_index_job.get(), &NetJob::failed, this, &TranslationsModel::indexFailed);
-    connect(d->m_index_job.get(), &NetJob::succeeded, this, &TranslationsModel::indexReceived);
+
+    if (!entry->isUsableWhileStale()) {
+        connect(d->m_index_job.get(), &NetJob::succeeded, this, &TranslationsModel::indexReceived);
+        d->m_index_job->start();
+        return;
+    }
+
+    // the index that's there is used right away, and again only once a newer one got downloaded
+    qDebug() << "Using the cached translations index while looking for a newer one";
+    d->m_index_changed = false;
+    connect(task.get(), &Net::Download::contentChanged, this, [this] { d->m_index_changed = true; });
+    connect(d->m_index_job.get(), &NetJob::succeeded, this, [this] {
+        if (d->m_index_changed) {
+            indexReceived();
+        } else {
+            d->m_index_job.reset();
+        }
+    });
     d->m_index_job->start();
+    useIndex();
 }
 
 void TranslationsModel::updateLanguage(QString key)
@@ -716,10 +771,14 @@ void TranslationsModel::downloadTranslation(QString key)
 
     d->m_downloadingTranslation = key;
     MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("translations", "mmc_" + key + ".qm");
-    entry->setStale(true);
+    auto rawHash = QByteArray::fromHex(lang->file_sha1.toLatin1());
+    QFile local(entry->getFullPath());
+    if(!local.open(QIODevice::ReadOnly) || QCryptographicHash::hash(local.readAll(), QCryptographicHash::Sha1) != rawHash)
+    {
+        entry->setStale(true);
+    }
 
     auto dl = Net::Download::makeCached(QUrl(BuildConfig.TRANSLATIONS_BASE_URL + lang->file_name), entry);
-    auto rawHash = QByteArray::fromHex(lang->file_sha1.toLatin1());
     dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawHash));
     dl->setProgress(dl->getProgress(), lang->file_size);
 
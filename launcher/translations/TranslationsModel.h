@@ -24,7 +24,11 @@ class TranslationsModel : public QAbstractListModel
 {
     Q_OBJECT
 public:
+    struct LocalFiles;
+
     explicit TranslationsModel(QString path, QObject *parent = 0);
+    /// with the files in the folder already found by scanLocalFiles(), which can be done off the GUI thread
+    TranslationsModel(QString path, std::shared_ptr<LocalFiles> scanned, QObject *parent = 0);
     virtual ~TranslationsModel();
 
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
@@ -39,11 +43,15 @@ public:
 
     void downloadIndex();
 
+    static std::shared_ptr<LocalFiles> scanLocalFiles(const QString &path);
+
 private:
     Language *findLanguage(const QString & key);
     void reloadLocalFiles();
+    void applyLocalFiles(LocalFiles files);
     void downloadTranslation(QString key);
     void downloadNext();
+    void useIndex();
 
     // hide copy constructor
     TranslationsModel(const TranslationsModel &) = delete;
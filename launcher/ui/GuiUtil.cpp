@@ -51,7 +51,8 @@
 #include <DesktopServices.h>
 #include <BuildConfig.h>
 
-std::optional<QString> GuiUtil::uploadPaste(const QString &name, const QString &text, QWidget *parentWidget)
+std::optional<QString> GuiUtil::uploadPaste(const QString &name, const QString &text, QWidget *parentWidget,
+                                            const QVector<MessageLevel::Enum> &levels)
 {
     ProgressDialog dialog(parentWidget);
     auto pasteTypeSetting = static_cast<PasteUpload::PasteType>(APPLICATION->settings()->get("PastebinType").toInt());
@@ -79,7 +80,7 @@ std::optional<QString> GuiUtil::uploadPaste(const QString &name, const QString &
         }
     }
 
-    std::unique_ptr<PasteUpload> paste(new PasteUpload(parentWidget, text, pasteCustomAPIBaseSetting, pasteTypeSetting));
+    std::unique_ptr<PasteUpload> paste(new PasteUpload(parentWidget, text, pasteCustomAPIBaseSetting, pasteTypeSetting, levels));
 
     dialog.execWithTask(paste.get());
     if (!paste->wasSuccessful())
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <QVector>
 #include <QWidget>
 #include <optional>
 
+#include "MessageLevel.h"
+
 namespace GuiUtil
 {
-std::optional<QString> uploadPaste(const QString &name, const QString &text, QWidget *parentWidget);
+/* Uploads a log. 'levels' are the levels of its lines, if known, see LogCompactor. */
+std::optional<QString> uploadPaste(const QString &name, const QString &text, QWidget *parentWidget,
+                                   const QVector<MessageLevel::Enum> &levels = {});
 void setClipboardText(const QString &text);
 QStringList BrowseForFiles(QString context, QString caption, QString filter, QString defaultPath, QWidget *parentWidget);
 QString BrowseForFile(QString context, QString caption, QString filter, QString defaultPath, QWidget *parentWidget);
@@ -71,9 +71,14 @@
 #include <QWidgetAction>
 #include <QProgressDialog>
 #include <QShortcut>
+#include <QTimer>
 
 #include <BaseInstance.h>
+#include <InstanceDedupTask.h>
 #include <InstanceList.h>
+#include <minecraft/BulkUpdateTask.h>
+#include <minecraft/InstanceVerifyTask.h>
+#include <minecraft/CacheCleanupTask.h>
 #include <minecraft/MinecraftInstance.h>
 #include <MMCZip.h>
 #include <icons/IconList.h>
@@ -98,7 +103,9 @@
 #include "ui/instanceview/InstanceView.h"
 #include "ui/instanceview/InstanceDelegate.h"
 #include "ui/widgets/LabeledToolButton.h"
+#include "ui/widgets/ProgressWidget.h"
 #include "ui/dialogs/NewInstanceDialog.h"
+#include "ui/dialogs/ModSearchDialog.h"
 #include "ui/dialogs/NewsDialog.h"
 #include "ui/dialogs/ProgressDialog.h"
 #include "ui/dialogs/AboutDialog.h"
@@ -123,6 +130,7 @@
 #include "InstanceCopyTask.h"
 
 #include "MMCTime.h"
+#include "MemoryAccounting.h"
 
 namespace {
 QString profileInUseFilter(const QString & profile, bool used)
@@ -270,7 +278,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     {
         view = new InstanceView(ui->centralWidget);
 
-        view->setSelectionMode(QAbstractItemView::SingleSelection);
+        view->setSelectionMode(QAbstractItemView::ExtendedSelection);
         // FIXME: leaks ListViewDelegate
         view->setItemDelegate(new ListViewDelegate(this));
         view->setFrameShape(QFrame::NoFrame);
@@ -335,6 +343,17 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     statusBar()->addPermanentWidget(m_statusLeft, 1);
     statusBar()->addPermanentWidget(m_statusCenter, 0);
 
+    // the folders of deleted instances are removed in the background, which can take a while for big ones
+    m_deletionProgress = new ProgressWidget(this, false);
+    m_deletionProgress->hideIfInactive(true);
+    m_deletionProgress->progressFormat(tr("Deleting instances: %p%"));
+    m_deletionProgress->hide();
+    statusBar()->addPermanentWidget(m_deletionProgress, 0);
+    connect(APPLICATION->instances().get(), &InstanceList::deletionStarted, m_deletionProgress,
+            [this](shared_qobject_ptr<Task> task) { m_deletionProgress->watch(task.get()); });
+    connect(APPLICATION->instances().get(), &InstanceList::trashHistoryChanged, this,
+            [this] { ui->actionUndoTrashInstance->setEnabled(APPLICATION->instances()->trashedSomething()); });
+
     // Add "manage accounts" button, right align
     QWidget *spacer = new QWidget();
     spacer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -370,11 +389,11 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     // TODO: refresh accounts here?
     // auto accounts = APPLICATION->accounts();
 
-    // load the news
-    {
+    // load the news once the window is up, it is never worth waiting for
+    QTimer::singleShot(0, this, [this] {
         m_newsChecker->reloadNews();
         updateNewsLabel();
-    }
+    });
 
     if (BuildConfig.UPDATER_ENABLED) {
         bool updatesAllowed = APPLICATION->updatesAreAllowed();
@@ -964,6 +983,55 @@ void MainWindow::on_actionCopyInstance_triggered()
     runModalTask(task.get());
 }
 
+void MainWindow::on_actionVerifyInstance_triggered()
+{
+    auto instance = std::dynamic_pointer_cast<MinecraftInstance>(m_selectedInstance);
+    if (!instance)
+        return;
+    if (instance->isRunning())
+    {
+        CustomMessageBox::selectable(this, tr("Error"), tr("The files of a running instance can't be verified."), QMessageBox::Warning)->show();
+        return;
+    }
+
+    auto task = makeShared<InstanceVerifyTask>(instance);
+    connect(task.get(), &Task::succeeded, this, [this, raw = task.get()]()
+        {
+            CustomMessageBox::selectable(this, tr("Verify Files"), raw->report(), QMessageBox::Information)->show();
+        });
+    runModalTask(task.get());
+}
+
+void MainWindow::on_actionUpdateInstances_triggered()
+{
+    QList<InstancePtr> instances;
+    auto list = APPLICATION->instances();
+    for (int i = 0; i < list->count(); i++)
+    {
+        // don't pull the files from under the feet of the game
+        if (!list->at(i)->isRunning())
+            instances.append(list->at(i));
+    }
+    updateInstances(instances);
+}
+
+void MainWindow::updateInstances(const QList<InstancePtr> &instances)
+{
+    if (!APPLICATION->accounts()->anyAccountIsValid())
+    {
+        CustomMessageBox::selectable(
+            this,
+            tr("Error"),
+            tr("The launcher cannot download Minecraft or update instances unless you have at least "
+                "one account added.\nPlease add your Mojang or Minecraft account."),
+            QMessageBox::Warning
+        )->show();
+        return;
+    }
+    auto task = makeShared<BulkUpdateTask>(instances);
+    runModalTask(task.get());
+}
+
 void MainWindow::finalizeInstance(InstancePtr inst)
 {
     view->updateGeometries();
@@ -1037,13 +1105,24 @@ void MainWindow::on_actionAddInstance_triggered()
 
 void MainWindow::processURLs(QList<QUrl> urls)
 {
-    // NOTE: This loop only processes one dropped file!
+    // The isLocalFile() check below doesn't work as intended without an explicit scheme.
     for (auto& url : urls) {
-        qDebug() << "Processing" << url;
-
-        // The isLocalFile() check below doesn't work as intended without an explicit scheme.
         if (url.scheme().isEmpty())
             url.setScheme("file");
+    }
+
+    // all the dropped files are identified at the same time, before asking what to do with each of them
+    QList<QFileInfo> localFiles;
+    for (auto& url : urls) {
+        if (url.isLocalFile())
+            localFiles.append(QFileInfo(QDir::toNativeSeparators(url.toLocalFile())));
+    }
+    auto localTypes = ResourceUtils::identify(localFiles);
+    int nextLocal = 0;
+
+    // NOTE: This loop only processes one dropped file!
+    for (auto& url : urls) {
+        qDebug() << "Processing" << url;
 
         if (!url.isLocalFile()) {  // probably instance/modpack
             addInstance(url.toString());
@@ -1053,7 +1132,7 @@ void MainWindow::processURLs(QList<QUrl> urls)
         auto localFileName = QDir::toNativeSeparators(url.toLocalFile()) ;
         QFileInfo localFileInfo(localFileName);
 
-        auto type = ResourceUtils::identify(localFileInfo);
+        auto type = localTypes.at(nextLocal++);
 
         if (ResourceUtils::ValidResourceTypes.count(type) == 0) {  // probably instance/modpack
             addInstance(localFileName);
@@ -1279,6 +1358,82 @@ void MainWindow::on_actionClearMetadata_triggered()
     APPLICATION->metacache()->SaveNow();
 }
 
+void MainWindow::on_actionCleanUpCache_triggered()
+{
+    QList<InstancePtr> instances;
+    auto list = APPLICATION->instances();
+    for (int i = 0; i < list->count(); i++)
+        instances.append(list->at(i));
+
+    // tell what would go first
+    auto dryRun = makeShared<CacheCleanupTask>(instances, true);
+    connect(dryRun.get(), &Task::failed, [this](QString reason)
+        {
+            CustomMessageBox::selectable(this, tr("Error"), reason, QMessageBox::Critical)->show();
+        });
+    ProgressDialog dialog(this);
+    dialog.setSkipButton(true, tr("Abort"));
+    dialog.execWithTask(dryRun.get());
+    if (!dryRun->wasSuccessful())
+        return;
+
+    if (dryRun->freed() == 0)
+    {
+        CustomMessageBox::selectable(this, tr("Clean Up Cache"), dryRun->report() + "\n\n" + tr("Nothing needs to be removed."),
+                                     QMessageBox::Information)->exec();
+        return;
+    }
+    auto response = CustomMessageBox::selectable(this, tr("Clean Up Cache"),
+                                                 dryRun->report() + "\n\n" + tr("Remove these files?"),
+                                                 QMessageBox::Question, QMessageBox::Yes | QMessageBox::No, QMessageBox::No)->exec();
+    if (response != QMessageBox::Yes)
+        return;
+
+    auto task = makeShared<CacheCleanupTask>(instances, false);
+    runModalTask(task.get());
+}
+
+void MainWindow::on_actionDeduplicateInstances_triggered()
+{
+    QList<InstancePtr> instances;
+    auto list = APPLICATION->instances();
+    for (int i = 0; i < list->count(); i++)
+        instances.append(list->at(i));
+
+    // tell what would be reclaimed first
+    auto dryRun = makeShared<InstanceDedupTask>(instances, true);
+    ProgressDialog dialog(this);
+    dialog.setSkipButton(true, tr("Abort"));
+    dialog.execWithTask(dryRun.get());
+    if (!dryRun->wasSuccessful())
+        return;
+
+    if (dryRun->result().cloned + dryRun->result().linked == 0)
+    {
+        CustomMessageBox::selectable(this, tr("Deduplicate Instance Files"), dryRun->report(), QMessageBox::Information)->exec();
+        return;
+    }
+    auto response = CustomMessageBox::selectable(this, tr("Deduplicate Instance Files"),
+                                                 dryRun->report() + "\n\n" + tr("Share the data of these files?"),
+                                                 QMessageBox::Question, QMessageBox::Yes | QMessageBox::No, QMessageBox::No)->exec();
+    if (response != QMessageBox::Yes)
+        return;
+
+    auto task = makeShared<InstanceDedupTask>(instances, false);
+    connect(task.get(), &Task::succeeded, this, [this, raw = task.get()]()
+        {
+            CustomMessageBox::selectable(this, tr("Deduplicate Instance Files"), raw->report(), QMessageBox::Information)->show();
+        });
+    runModalTask(task.get());
+}
+
+void MainWindow::on_actionFindMod_triggered()
+{
+    auto dialog = new ModSearchDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
+}
+
 #ifdef Q_OS_MAC
 void MainWindow::on_actionAddToPATH_triggered()
 {
@@ -1424,6 +1579,13 @@ void MainWindow::changeEvent(QEvent* event)
     {
         retranslateUi();
     }
+    else if (event->type() == QEvent::WindowStateChange && isMinimized())
+    {
+        // nothing is shown for a while, what the caches hold can be made again when it is
+        qDebug().noquote() << MemoryAccounting::summary();
+        auto released = MemoryAccounting::trim();
+        qDebug() << "Minimized, the caches let go of about" << released << "bytes, resident now:" << MemoryAccounting::residentBytes();
+    }
     QMainWindow::changeEvent(event);
 }
 
@@ -1441,12 +1603,30 @@ void MainWindow::instanceActivated(QModelIndex index)
 
 void MainWindow::on_actionLaunchInstance_triggered()
 {
+    auto selected = selectedInstances();
+    if (selected.size() > 1)
+    {
+        APPLICATION->launchBatch(selected);
+        return;
+    }
     if(m_selectedInstance && !m_selectedInstance->isRunning())
     {
         APPLICATION->launch(m_selectedInstance);
     }
 }
 
+QList<InstancePtr> MainWindow::selectedInstances() const
+{
+    QList<InstancePtr> instances;
+    for (auto &index : view->selectionModel()->selectedIndexes())
+    {
+        auto instance = APPLICATION->instances()->getInstanceById(index.data(InstanceList::InstanceIDRole).toString());
+        if (instance && !instance->isRunning())
+            instances.append(instance);
+    }
+    return instances;
+}
+
 void MainWindow::activateInstance(InstancePtr instance)
 {
     APPLICATION->launch(instance);
@@ -1454,6 +1634,12 @@ void MainWindow::activateInstance(InstancePtr instance)
 
 void MainWindow::on_actionLaunchInstanceOffline_triggered()
 {
+    auto selected = selectedInstances();
+    if (selected.size() > 1)
+    {
+        APPLICATION->launchBatch(selected, false);
+        return;
+    }
     if (m_selectedInstance)
     {
         APPLICATION->launch(m_selectedInstance, false);
@@ -1774,6 +1960,7 @@ void MainWindow::setInstanceActionsEnabled(bool enabled)
     ui->actionExportInstance->setEnabled(enabled);
     ui->actionDeleteInstance->setEnabled(enabled);
     ui->actionCopyInstance->setEnabled(enabled);
+    ui->actionVerifyInstance->setEnabled(enabled);
     ui->actionCreateInstanceShortcut->setEnabled(enabled);
 }
 
@@ -55,6 +55,7 @@ class NewsChecker;
 class QToolButton;
 class InstanceProxyModel;
 class LabeledToolButton;
+class ProgressWidget;
 class QLabel;
 class MinecraftLauncher;
 class BaseProfilerFactory;
@@ -84,6 +85,8 @@ public:
     void updatesAllowedChanged(bool allowed);
 
     void processURLs(QList<QUrl> urls);
+    /** Updates all the instances at once, downloading what they have in common only once. */
+    void updateInstances(const QList<InstancePtr> &instances);
 signals:
     void isClosing();
 
@@ -107,6 +110,10 @@ private slots:
 
     void on_actionCopyInstance_triggered();
 
+    void on_actionVerifyInstance_triggered();
+
+    void on_actionUpdateInstances_triggered();
+
     void on_actionChangeInstGroup_triggered();
 
     void on_actionChangeInstIcon_triggered();
@@ -129,6 +136,12 @@ private slots:
 
     void on_actionClearMetadata_triggered();
 
+    void on_actionCleanUpCache_triggered();
+
+    void on_actionDeduplicateInstances_triggered();
+
+    void on_actionFindMod_triggered();
+
     #ifdef Q_OS_MAC
     void on_actionAddToPATH_triggered();
     #endif
@@ -215,6 +228,8 @@ private:
 
     void addInstance(QString url = QString());
     void activateInstance(InstancePtr instance);
+    /// the selected instances that aren't running, Ctrl adds to the selection
+    QList<InstancePtr> selectedInstances() const;
     void setCatBackground(bool enabled);
     void updateInstanceToolIcon(QString new_icon);
     void setSelectedInstanceById(const QString &id);
@@ -233,6 +248,7 @@ private:
     QToolButton *newsLabel = nullptr;
     QLabel *m_statusLeft = nullptr;
     QLabel *m_statusCenter = nullptr;
+    ProgressWidget *m_deletionProgress = nullptr;
     LabeledToolButton *changeIconButton = nullptr;
     LabeledToolButton *renameButton = nullptr;
     QToolButton *helpMenuButton = nullptr;
@@ -45,6 +45,7 @@ BlockedModsDialog::BlockedModsDialog(QWidget* parent, const QString& title, cons
     : QDialog(parent), ui(new Ui::BlockedModsDialog), m_mods(mods)
 {
     m_hashing_task = shared_qobject_ptr<ConcurrentTask>(new ConcurrentTask(this, "MakeHashesTask", 10));
+    m_hashing_task->setConcurrency(ConcurrentTask::Concurrency::CpuBound);
     connect(m_hashing_task.get(), &Task::finished, this, &BlockedModsDialog::hashTaskFinished);
 
     ui->setupUi(this);
@@ -254,11 +255,27 @@ void BlockedModsDialog::addHashTask(QString path)
 /// @param path the path to the local file being hashed
 void BlockedModsDialog::buildHashTask(QString path)
 {
+    QFileInfo file(path);
+    if (!checkValidSize(file))
+        return;
+
+    // browsers and the like touch the watched folders all the time, don't hash the same files again
+    auto hashed = m_hashed_files.constFind(path);
+    if (hashed != m_hashed_files.constEnd() && hashed->size == file.size() && hashed->modified == file.lastModified()) {
+        checkMatchHash(hashed->hash, path);
+        return;
+    }
+
     auto hash_task = Hashing::createBlockedModHasher(path, ModPlatform::ResourceProvider::FLAME, "sha1");
 
     qDebug() << "[Blocked Mods Dialog] Creating Hash task for path: " << path;
 
-    connect(hash_task.get(), &Task::succeeded, this, [this, hash_task, path] { checkMatchHash(hash_task->getResult(), path); });
+    auto size = file.size();
+    auto modified = file.lastModified();
+    connect(hash_task.get(), &Task::succeeded, this, [this, hash_task, path, size, modified] {
+        m_hashed_files.insert(path, { size, modified, hash_task->getResult() });
+        checkMatchHash(hash_task->getResult(), path);
+    });
     connect(hash_task.get(), &Task::failed, this, [path] { qDebug() << "Failed to hash path: " << path; });
 
     m_hashing_task->addTask(hash_task);
@@ -346,6 +363,15 @@ bool BlockedModsDialog::checkValidPath(QString path)
     return false;
 }
 
+/// @brief Check if the file could be one of the blocked mods we are searching for, going by its size
+/// @param file the file to check
+/// @return boolean: is there a missing mod of that size (or of an unknown size)?
+bool BlockedModsDialog::checkValidSize(const QFileInfo& file)
+{
+    return std::any_of(m_mods.begin(), m_mods.end(),
+                       [&file](auto const& mod) { return !mod.matched && (mod.size == 0 || mod.size == file.size()); });
+}
+
 bool BlockedModsDialog::allModsMatched()
 {
     return std::all_of(m_mods.begin(), m_mods.end(), [](auto const& mod) { return mod.matched; });
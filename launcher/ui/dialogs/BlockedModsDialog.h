@@ -25,7 +25,9 @@
 
 #pragma once
 
+#include <QDateTime>
 #include <QDialog>
+#include <QHash>
 #include <QList>
 #include <QString>
 
@@ -33,12 +35,15 @@
 
 #include "tasks/ConcurrentTask.h"
 
+class QFileInfo;
 class QPushButton;
 
 struct BlockedMod {
     QString name;
     QString websiteUrl;
     QString hash;
+    // expected size of the file in bytes, 0 if unknown
+    qint64 size = 0;
     bool matched;
     QString localPath;
     QString targetFolder;
@@ -71,6 +76,14 @@ class BlockedModsDialog : public QDialog {
     QFileSystemWatcher m_watcher;
     shared_qobject_ptr<ConcurrentTask> m_hashing_task;
     QSet<QString> m_pending_hash_paths;
+
+    struct HashedFile {
+        qint64 size;
+        QDateTime modified;
+        QString hash;
+    };
+    // path -> the hash of the file, as long as it's still the same size and modification time
+    QHash<QString, HashedFile> m_hashed_files;
     bool m_rehash_pending;
     QPushButton* m_openMissingButton;
 
@@ -90,6 +103,7 @@ class BlockedModsDialog : public QDialog {
     void hashTaskFinished();
 
     bool checkValidPath(QString path);
+    bool checkValidSize(const QFileInfo& file);
     bool allModsMatched();
 };
 
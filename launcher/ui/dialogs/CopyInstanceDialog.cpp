@@ -93,6 +93,7 @@ CopyInstanceDialog::CopyInstanceDialog(InstancePtr original, QWidget* parent)
 
     ui->recursiveLinkCheckbox->setChecked(m_selectedOptions.isLinkRecursivelyEnabled());
     ui->dontLinkSavesCheckbox->setChecked(m_selectedOptions.isDontLinkSavesEnabled());
+    ui->layerCheckbox->setChecked(m_selectedOptions.isLayerEnabled());
 
     auto detectedFS = FS::statFS(m_original->instanceRoot()).fsType;
 
@@ -315,3 +316,15 @@ void CopyInstanceDialog::on_useCloneCheckbox_stateChanged(int state)
     updateUseCloneCheckbox();
     updateLinkOptions();
 }
+
+void CopyInstanceDialog::on_layerCheckbox_stateChanged(int state)
+{
+    bool layer = state == Qt::Checked;
+    m_selectedOptions.enableLayer(layer);
+    // a layer gets everything but its worlds from the original, as it is before each launch
+    ui->linkFilesGroup->setEnabled(!layer);
+    ui->horizontalGroupBox->setEnabled(!layer);
+    for (auto checkbox : { ui->copyGameOptionsCheckbox, ui->copyResPacksCheckbox, ui->copyShaderPacksCheckbox, ui->copyServersCheckbox,
+                           ui->copyModsCheckbox, ui->copyScreenshotsCheckbox })
+        checkbox->setEnabled(!layer);
+}
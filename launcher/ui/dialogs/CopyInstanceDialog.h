@@ -61,6 +61,7 @@ class CopyInstanceDialog : public QDialog {
     void on_recursiveLinkCheckbox_stateChanged(int state);
     void on_dontLinkSavesCheckbox_stateChanged(int state);
     void on_useCloneCheckbox_stateChanged(int state);
+    void on_layerCheckbox_stateChanged(int state);
 
    private:
     void checkAllCheckboxes(const bool& b);
@@ -40,9 +40,7 @@
 #include <MMCZip.h>
 #include <QFileDialog>
 #include <QMessageBox>
-#include <QFileSystemModel>
 
-#include <QSortFilterProxyModel>
 #include <QDebug>
 #include <QSaveFile>
 #include <QStack>
@@ -56,23 +54,26 @@ ExportInstanceDialog::ExportInstanceDialog(InstancePtr instance, QWidget *parent
     : QDialog(parent), ui(new Ui::ExportInstanceDialog), m_instance(instance)
 {
     ui->setupUi(this);
-    auto model = new QFileSystemModel(this);
-    model->setIconProvider(&icons);
     auto root = instance->instanceRoot();
-    proxyModel = new FileIgnoreProxy(root, this);
+    model = new ExportTreeModel(root, this);
+    model->setIconProvider(&icons);
     loadPackIgnore();
-    proxyModel->setSourceModel(model);
-    ui->treeView->setModel(proxyModel);
-    ui->treeView->setRootIndex(proxyModel->mapFromSource(model->index(root)));
+    ui->treeView->setModel(model);
     ui->treeView->sortByColumn(0, Qt::AscendingOrder);
 
-    connect(proxyModel, SIGNAL(rowsInserted(QModelIndex,int,int)), SLOT(rowsInserted(QModelIndex,int,int)));
+    // the folders get listed as they are expanded, expand the ones with blocked paths in them as they show up
+    connect(model, SIGNAL(rowsInserted(QModelIndex,int,int)), SLOT(rowsInserted(QModelIndex,int,int)));
+    rowsInserted(QModelIndex(), 0, model->rowCount() - 1);
 
-    model->setFilter(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::AllDirs | QDir::Hidden);
-    model->setRootPath(root);
     auto headerView = ui->treeView->header();
     headerView->setSectionResizeMode(QHeaderView::ResizeToContents);
     headerView->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    ui->compressionLevel->addItem(tr("Fastest"), 1);
+    ui->compressionLevel->addItem(tr("Balanced"), 6);
+    ui->compressionLevel->addItem(tr("Smallest"), 9);
+    ui->compressionLevel->setCurrentIndex(
+        std::max(0, ui->compressionLevel->findData(APPLICATION->settings()->get("ExportCompressionLevel").toInt())));
 }
 
 ExportInstanceDialog::~ExportInstanceDialog()
@@ -133,16 +134,15 @@ bool ExportInstanceDialog::doExport()
 
     SaveIcon(m_instance);
 
-    auto & blocked = proxyModel->blockedPaths();
-    using std::placeholders::_1;
     auto files = QFileInfoList();
-    if (!MMCZip::collectFileListRecursively(m_instance->instanceRoot(), nullptr, &files,
-                                    std::bind(&SeparatorPrefixTree<'/'>::covers, blocked, _1))) {
+    if (!model->collectFiles(&files)) {
         QMessageBox::warning(this, tr("Error"), tr("Unable to export instance"));
         return false;
     }
 
-    if (!MMCZip::compressDirFiles(output, m_instance->instanceRoot(), files, true))
+    auto level = ui->compressionLevel->currentData().toInt();
+    APPLICATION->settings()->set("ExportCompressionLevel", level);
+    if (!MMCZip::compressDirFiles(output, m_instance->instanceRoot(), files, true, level))
     {
         QMessageBox::warning(this, tr("Error"), tr("Unable to export instance"));
         return false;
@@ -170,17 +170,11 @@ void ExportInstanceDialog::done(int result)
 
 void ExportInstanceDialog::rowsInserted(QModelIndex parent, int top, int bottom)
 {
-    //WARNING: possible off-by-one?
-    for(int i = top; i < bottom; i++)
+    for(int i = top; i <= bottom; i++)
     {
-        auto node = proxyModel->index(i, 0, parent);
-        if(proxyModel->shouldExpand(node))
+        auto node = model->index(i, 0, parent);
+        if(model->shouldExpand(node))
         {
-            auto expNode = node.parent();
-            if(!expNode.isValid())
-            {
-                continue;
-            }
             ui->treeView->expand(node);
         }
     }
@@ -202,15 +196,15 @@ void ExportInstanceDialog::loadPackIgnore()
     auto data = ignoreFile.readAll();
     auto string = QString::fromUtf8(data);
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-    proxyModel->setBlockedPaths(string.split('\n', Qt::SkipEmptyParts));
+    model->setBlockedPaths(string.split('\n', Qt::SkipEmptyParts));
 #else
-    proxyModel->setBlockedPaths(string.split('\n', QString::SkipEmptyParts));
+    model->setBlockedPaths(string.split('\n', QString::SkipEmptyParts));
 #endif
 }
 
 void ExportInstanceDialog::savePackIgnore()
 {
-    auto data = proxyModel->blockedPaths().toStringList().join('\n').toUtf8();
+    auto data = model->blockedPaths().toStringList().join('\n').toUtf8();
     auto filename = ignoreFileName();
     try
     {
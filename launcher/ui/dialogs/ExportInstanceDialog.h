@@ -38,7 +38,7 @@
 #include <QDialog>
 #include <QModelIndex>
 #include <memory>
-#include "FileIgnoreProxy.h"
+#include "ExportTreeModel.h"
 #include "FastFileIconProvider.h"
 
 class BaseInstance;
@@ -68,7 +68,7 @@ private:
 private:
     Ui::ExportInstanceDialog *ui;
     InstancePtr m_instance;
-    FileIgnoreProxy * proxyModel;
+    ExportTreeModel * model;
     FastFileIconProvider icons;
 
 private slots:
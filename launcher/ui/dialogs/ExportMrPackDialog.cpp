@@ -23,10 +23,10 @@
 #include "ui_ExportMrPackDialog.h"
 
 #include <QFileDialog>
-#include <QFileSystemModel>
 #include <QJsonDocument>
 #include <QMessageBox>
 #include <QPushButton>
+#include "Application.h"
 #include "FastFileIconProvider.h"
 #include "FileSystem.h"
 #include "MMCZip.h"
@@ -46,36 +46,35 @@ ExportMrPackDialog::ExportMrPackDialog(InstancePtr instance, QWidget* parent)
     // the instance name can technically be empty
     validate();
 
-    QFileSystemModel* model = new QFileSystemModel(this);
-    model->setIconProvider(&icons);
+    ui->compressionLevel->addItem(tr("Fastest"), 1);
+    ui->compressionLevel->addItem(tr("Balanced"), 6);
+    ui->compressionLevel->addItem(tr("Smallest"), 9);
+    ui->compressionLevel->setCurrentIndex(
+        std::max(0, ui->compressionLevel->findData(APPLICATION->settings()->get("ExportCompressionLevel").toInt())));
 
     // use the game root - everything outside cannot be exported
     const QDir root(instance->gameRoot());
-    proxy = new FileIgnoreProxy(instance->gameRoot(), this);
-    proxy->setSourceModel(model);
+    model = new ExportTreeModel(instance->gameRoot(), this);
+    model->setIconProvider(&icons);
 
     const QDir::Filters filter(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::AllDirs | QDir::Hidden);
 
     for (const QString& file : root.entryList(filter)) {
         if (!(file == "mods" || file == "coremods" || file == "datapacks" || file == "config" || file == "options.txt" ||
               file == "servers.dat"))
-            proxy->blockedPaths().insert(file);
+            model->blockPath(file);
     }
 
     MinecraftInstance* mcInstance = dynamic_cast<MinecraftInstance*>(instance.get());
     if (mcInstance) {
         const QDir index = mcInstance->loaderModList()->indexDir();
         if (index.exists())
-            proxy->blockedPaths().insert(root.relativeFilePath(index.absolutePath()));
+            model->blockPath(root.relativeFilePath(index.absolutePath()));
     }
 
-    ui->treeView->setModel(proxy);
-    ui->treeView->setRootIndex(proxy->mapFromSource(model->index(instance->gameRoot())));
+    ui->treeView->setModel(model);
     ui->treeView->sortByColumn(0, Qt::AscendingOrder);
 
-    model->setFilter(filter);
-    model->setRootPath(instance->gameRoot());
-
     QHeaderView* headerView = ui->treeView->header();
     headerView->setSectionResizeMode(QHeaderView::ResizeToContents);
     headerView->setSectionResizeMode(0, QHeaderView::Stretch);
@@ -97,8 +96,14 @@ void ExportMrPackDialog::done(int result)
         if (output.isEmpty())
             return;
 
-        ModrinthPackExportTask task(ui->name->text(), ui->version->text(), ui->summary->text(), instance, output,
-                                    [this](const QString& path) { return proxy->blockedPaths().covers(path); });
+        QFileInfoList files;
+        if (!model->collectFiles(&files)) {
+            CustomMessageBox::selectable(this, tr("Error"), tr("Could not search for files"), QMessageBox::Critical)->show();
+            return;
+        }
+
+        APPLICATION->settings()->set("ExportCompressionLevel", ui->compressionLevel->currentData());
+        ModrinthPackExportTask task(ui->name->text(), ui->version->text(), ui->summary->text(), instance, output, files);
 
         connect(&task, &Task::failed,
                 [this](const QString reason) { CustomMessageBox::selectable(this, tr("Error"), reason, QMessageBox::Critical)->show(); });
@@ -21,7 +21,7 @@
 #include <QDialog>
 #include "BaseInstance.h"
 #include "FastFileIconProvider.h"
-#include "FileIgnoreProxy.h"
+#include "ExportTreeModel.h"
 
 namespace Ui {
 class ExportMrPackDialog;
@@ -40,6 +40,6 @@ class ExportMrPackDialog : public QDialog {
    private:
     const InstancePtr instance;
     Ui::ExportMrPackDialog* ui;
-    FileIgnoreProxy* proxy;
+    ExportTreeModel* model;
     FastFileIconProvider icons;
 };
@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ModSearchDialog.h"
+
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSet>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "Application.h"
+#include "FileSystem.h"
+#include "InstanceList.h"
+#include "minecraft/mod/Mod.h"
+#include "ui/dialogs/CustomMessageBox.h"
+
+namespace {
+enum Column { InstanceColumn, FileColumn, ModIdColumn, VersionColumn, SourceColumn };
+}
+
+ModSearchDialog::ModSearchDialog(QWidget* parent) : QDialog(parent), m_index(APPLICATION->instanceModIndex())
+{
+    setWindowTitle(tr("Find Mod in Instances"));
+    resize(800, 500);
+
+    auto layout = new QVBoxLayout(this);
+    m_query = new QLineEdit(this);
+    m_query->setPlaceholderText(tr("Mod ID, name, file name, project ID or file hash"));
+    m_query->setClearButtonEnabled(true);
+    layout->addWidget(m_query);
+
+    m_results = new QTreeWidget(this);
+    m_results->setRootIsDecorated(false);
+    m_results->setSortingEnabled(true);
+    m_results->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_results->setHeaderLabels({ tr("Instance"), tr("File"), tr("Mod ID"), tr("Version"), tr("Source") });
+    m_results->header()->setSectionResizeMode(FileColumn, QHeaderView::Stretch);
+    layout->addWidget(m_results);
+
+    m_status = new QLabel(this);
+    layout->addWidget(m_status);
+
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    m_openButton = buttons->addButton(tr("Open Mods Page"), QDialogButtonBox::ActionRole);
+    m_disableButton = buttons->addButton(tr("Disable Everywhere"), QDialogButtonBox::ActionRole);
+    m_enableButton = buttons->addButton(tr("Enable Everywhere"), QDialogButtonBox::ActionRole);
+    layout->addWidget(buttons);
+
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    connect(m_openButton, &QPushButton::clicked, this, &ModSearchDialog::openSelected);
+    connect(m_disableButton, &QPushButton::clicked, this, [this] { enableSelected(false); });
+    connect(m_enableButton, &QPushButton::clicked, this, [this] { enableSelected(true); });
+    connect(m_query, &QLineEdit::textChanged, this, &ModSearchDialog::search);
+    connect(m_results, &QTreeWidget::itemSelectionChanged, this, &ModSearchDialog::selectionChanged);
+    connect(m_results, &QTreeWidget::itemDoubleClicked, this, &ModSearchDialog::openSelected);
+
+    // the results follow the mods folders changing, with what the buttons did too
+    connect(m_index.get(), &InstanceModIndex::ready, this, &ModSearchDialog::search);
+    connect(m_index.get(), &InstanceModIndex::instanceUpdated, this, [this] {
+        if (m_index->isReady())
+            search();
+    });
+    m_index->build();
+    search();
+}
+
+void ModSearchDialog::search()
+{
+    if (!m_index->isReady()) {
+        m_status->setText(tr("Looking at the mods of the instances..."));
+        return;
+    }
+
+    static ModPlatform::ProviderCapabilities ProviderCaps;
+    auto query = m_query->text().trimmed();
+    m_found = query.isEmpty() ? QList<InstanceModIndex::Entry>() : m_index->find(query);
+
+    m_results->setSortingEnabled(false);
+    m_results->clear();
+    auto instances = APPLICATION->instances();
+    QSet<QString> in_instances;
+    for (int i = 0; i < m_found.size(); i++) {
+        auto& entry = m_found[i];
+        auto instance = instances->getInstanceById(entry.instanceId);
+        in_instances.insert(entry.instanceId);
+
+        auto item = new QTreeWidgetItem(m_results);
+        item->setText(InstanceColumn, instance ? instance->name() : entry.instanceId);
+        item->setText(FileColumn, entry.fileName);
+        item->setText(ModIdColumn, entry.modId);
+        item->setText(VersionColumn, entry.version);
+        item->setText(SourceColumn, entry.hasMetadata ? ProviderCaps.readableName(entry.provider) : QString());
+        item->setData(InstanceColumn, Qt::UserRole, i);
+        if (!entry.enabled) {
+            for (int column = 0; column < m_results->columnCount(); column++)
+                item->setForeground(column, m_results->palette().brush(QPalette::Disabled, QPalette::Text));
+        }
+    }
+    m_results->setSortingEnabled(true);
+
+    if (query.isEmpty())
+        m_status->setText(tr("%n mod(s) in the instances.", nullptr, m_index->entries().size()));
+    else
+        m_status->setText(tr("%n instance(s) have a mod matching this.", nullptr, in_instances.size()));
+    selectionChanged();
+}
+
+QList<InstanceModIndex::Entry> ModSearchDialog::selectedEntries() const
+{
+    QList<InstanceModIndex::Entry> entries;
+    for (auto item : m_results->selectedItems())
+        entries.append(m_found.value(item->data(InstanceColumn, Qt::UserRole).toInt()));
+    return entries;
+}
+
+void ModSearchDialog::selectionChanged()
+{
+    auto entries = selectedEntries();
+    bool any_enabled = false;
+    bool any_disabled = false;
+    for (auto& entry : entries) {
+        any_enabled |= entry.enabled;
+        any_disabled |= !entry.enabled;
+    }
+    m_openButton->setEnabled(!entries.isEmpty());
+    m_disableButton->setEnabled(any_enabled);
+    m_enableButton->setEnabled(any_disabled);
+}
+
+void ModSearchDialog::openSelected()
+{
+    QSet<QString> opened;
+    for (auto& entry : selectedEntries()) {
+        if (opened.contains(entry.instanceId))
+            continue;
+        opened.insert(entry.instanceId);
+        if (auto instance = APPLICATION->instances()->getInstanceById(entry.instanceId))
+            APPLICATION->showInstanceWindow(instance, "mods");
+    }
+}
+
+void ModSearchDialog::enableSelected(bool enable)
+{
+    QStringList skipped;
+    QStringList failed;
+    for (auto& entry : selectedEntries()) {
+        if (entry.enabled == enable)
+            continue;
+        auto instance = APPLICATION->instances()->getInstanceById(entry.instanceId);
+        if (!instance)
+            continue;
+        // the game has its mods open
+        if (instance->isRunning()) {
+            skipped.append(instance->name());
+            continue;
+        }
+        Mod mod(QFileInfo(FS::PathCombine(instance->modsRoot(), entry.fileName)));
+        if (!mod.enable(enable ? EnableAction::ENABLE : EnableAction::DISABLE))
+            failed.append(QString("%1 (%2)").arg(entry.fileName, instance->name()));
+    }
+
+    QStringList problems;
+    if (!skipped.isEmpty())
+        problems.append(tr("These instances are running, their mods were left alone: %1").arg(skipped.join(", ")));
+    if (!failed.isEmpty())
+        problems.append(tr("These mods couldn't be renamed: %1").arg(failed.join(", ")));
+    if (!problems.isEmpty())
+        CustomMessageBox::selectable(this, windowTitle(), problems.join("\n\n"), QMessageBox::Warning)->exec();
+}
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QDialog>
+#include <QList>
+
+#include "minecraft/mod/InstanceModIndex.h"
+
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QTreeWidget;
+
+/* Finds the instances that have a mod, by its ID, name, file, project or hash (see InstanceModIndex), and disables or
+ * enables it in all of the instances at once. */
+class ModSearchDialog : public QDialog {
+    Q_OBJECT
+   public:
+    explicit ModSearchDialog(QWidget* parent = nullptr);
+
+   private:
+    void search();
+    void selectionChanged();
+    void openSelected();
+    void enableSelected(bool enable);
+    QList<InstanceModIndex::Entry> selectedEntries() const;
+
+   private:
+    shared_qobject_ptr<InstanceModIndex> m_index;
+    QList<InstanceModIndex::Entry> m_found;
+
+    QLineEdit* m_query;
+    QTreeWidget* m_results;
+    QLabel* m_status;
+    QPushButton* m_openButton;
+    QPushButton* m_disableButton;
+    QPushButton* m_enableButton;
+};
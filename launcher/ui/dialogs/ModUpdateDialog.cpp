@@ -15,9 +15,11 @@
 #include "minecraft/PackProfile.h"
 
 #include "modplatform/EnsureMetadataTask.h"
+#include "modplatform/flame/FlameAPI.h"
 #include "modplatform/flame/FlameCheckUpdate.h"
 #include "modplatform/modrinth/ModrinthCheckUpdate.h"
 
+#include <QPointer>
 #include <QTextBrowser>
 #include <QTreeWidgetItem>
 
@@ -43,13 +45,14 @@ ModUpdateDialog::ModUpdateDialog(QWidget* parent,
     , m_parent(parent)
     , m_mod_model(mods)
     , m_candidates(search_for)
-    , m_second_try_metadata(new ConcurrentTask())
     , m_instance(instance)
 {
     ReviewMessageBox::setGeometry(0, 0, 800, 600);
 
     ui->explainLabel->setText(tr("You're about to update the following mods:"));
     ui->onlyCheckedLabel->setText(tr("Only mods with a check will be updated!"));
+
+    connect(ui->modTreeWidget, &QTreeWidget::itemExpanded, this, &ModUpdateDialog::onItemExpanded);
 }
 
 void ModUpdateDialog::checkCandidates()
@@ -82,40 +85,39 @@ void ModUpdateDialog::checkCandidates()
         }
     }
 
-    auto versions = mcVersions(m_instance);
+    m_game_versions = mcVersions(m_instance);
     auto loaders = mcLoaders(m_instance);
 
-    SequentialTask check_task(m_parent, tr("Checking for updates"));
+    // both providers at once, what either finds is shown right away
+    m_check_task.reset(new ConcurrentTask(nullptr, tr("Checking for updates")));
 
-    if (!m_modrinth_to_update.empty()) {
-        m_modrinth_check_task.reset(new ModrinthCheckUpdate(m_modrinth_to_update, versions, loaders, m_mod_model));
-        connect(m_modrinth_check_task.get(), &CheckUpdateTask::checkFailed, this,
+    auto addCheck = [this](CheckUpdateTask* task) {
+        connect(task, &CheckUpdateTask::checkFailed, this,
                 [this](Mod* mod, QString reason, QUrl recover_url) { m_failed_check_update.append({mod, reason, recover_url}); });
-        check_task.addTask(m_modrinth_check_task);
+        connect(task, &CheckUpdateTask::updateFound, this, &ModUpdateDialog::onUpdateFound);
+    };
+
+    if (!m_modrinth_to_update.empty()) {
+        m_modrinth_check_task.reset(new ModrinthCheckUpdate(m_modrinth_to_update, m_game_versions, loaders, m_mod_model));
+        addCheck(m_modrinth_check_task.get());
+        m_check_task->addTask(m_modrinth_check_task);
     }
 
     if (!m_flame_to_update.empty()) {
-        m_flame_check_task.reset(new FlameCheckUpdate(m_flame_to_update, versions, loaders, m_mod_model));
-        connect(m_flame_check_task.get(), &CheckUpdateTask::checkFailed, this,
-                [this](Mod* mod, QString reason, QUrl recover_url) { m_failed_check_update.append({mod, reason, recover_url}); });
-        check_task.addTask(m_flame_check_task);
+        m_flame_check_task.reset(new FlameCheckUpdate(m_flame_to_update, m_game_versions, loaders, m_mod_model));
+        addCheck(m_flame_check_task.get());
+        m_check_task->addTask(m_flame_check_task);
     }
 
-    connect(&check_task, &Task::failed, this,
-            [&](QString reason) { CustomMessageBox::selectable(this, tr("Error"), reason, QMessageBox::Critical)->exec(); });
+    connect(m_check_task.get(), &Task::finished, this, &ModUpdateDialog::onChecksFinished);
 
-    connect(&check_task, &Task::succeeded, this, [&]() {
-        QStringList warnings = check_task.warnings();
-        if (warnings.count()) {
-            CustomMessageBox::selectable(this, tr("Warnings"), warnings.join('\n'), QMessageBox::Warning)->exec();
-        }
-    });
-
-    // Check for updates
+    // Check for updates, until the first one is found
     ProgressDialog progress_dialog(m_parent);
     progress_dialog.setSkipButton(true, tr("Abort"));
     progress_dialog.setWindowTitle(tr("Checking for updates..."));
-    auto ret = progress_dialog.execWithTask(&check_task);
+    m_progress_dialog = &progress_dialog;
+    auto ret = progress_dialog.execWithTask(m_check_task.get());
+    m_progress_dialog = nullptr;
 
     // If the dialog was skipped / some download error happened
     if (ret == QDialog::DialogCode::Rejected) {
@@ -124,79 +126,133 @@ void ModUpdateDialog::checkCandidates()
         return;
     }
 
-    // Add found updates for Modrinth
-    if (m_modrinth_check_task) {
-        auto modrinth_updates = m_modrinth_check_task->getUpdatable();
-        for (auto& updatable : modrinth_updates) {
-            qDebug() << QString("Mod %1 has an update available!").arg(updatable.name);
+    if (stillChecking()) {
+        ui->explainLabel->setText(tr("Still checking the other mods, the updates found for them will be added here. "
+                                     "You're about to update the following mods:"));
+        return;
+    }
 
-            appendMod(updatable);
-            m_tasks.insert(updatable.name, updatable.download);
-        }
+    if (!reportFailedChecks()) {
+        m_aborted = true;
+        QMetaObject::invokeMethod(this, "reject", Qt::QueuedConnection);
+        return;
     }
 
-    // Add found updated for Flame
-    if (m_flame_check_task) {
-        auto flame_updates = m_flame_check_task->getUpdatable();
-        for (auto& updatable : flame_updates) {
-            qDebug() << QString("Mod %1 has an update available!").arg(updatable.name);
+    // If there's no mod to be updated
+    if (ui->modTreeWidget->topLevelItemCount() == 0)
+        m_no_updates = true;
 
-            appendMod(updatable);
-            m_tasks.insert(updatable.name, updatable.download);
-        }
+    if (m_aborted || m_no_updates)
+        QMetaObject::invokeMethod(this, "reject", Qt::QueuedConnection);
+}
+
+ModUpdateDialog::~ModUpdateDialog()
+{
+    // they look into the lists of mods of this dialog
+    if (stillChecking())
+        m_check_task->abort();
+}
+
+void ModUpdateDialog::onUpdateFound(const CheckUpdateTask::UpdatableMod& info)
+{
+    qDebug() << QString("Mod %1 has an update available!").arg(info.name);
+
+    appendMod(info);
+    m_tasks.insert(info.name, info.download);
+
+    // there's something to review, the rest is checked in the meantime
+    if (m_progress_dialog)
+        m_progress_dialog->accept();
+}
+
+void ModUpdateDialog::onChecksFinished()
+{
+    if (m_check_task->wasSuccessful()) {
+        QStringList warnings = m_check_task->warnings();
+        if (warnings.count())
+            CustomMessageBox::selectable(this, tr("Warnings"), warnings.join('\n'), QMessageBox::Warning)->exec();
+    } else if (!m_check_task->failReason().isEmpty() && m_check_task->getState() != Task::State::AbortedByUser) {
+        CustomMessageBox::selectable(this, tr("Error"), m_check_task->failReason(), QMessageBox::Critical)->exec();
     }
 
-    // Report failed update checking
-    if (!m_failed_check_update.empty()) {
-        QString text;
-        for (const auto& failed : m_failed_check_update) {
-            const auto& mod = std::get<0>(failed);
-            const auto& reason = std::get<1>(failed);
-            const auto& recover_url = std::get<2>(failed);
-
-            qDebug() << mod->name() << " failed to check for updates!";
-
-            text += tr("Mod name: %1").arg(mod->name()) + "<br>";
-            if (!reason.isEmpty())
-                text += tr("Reason: %1").arg(reason) + "<br>";
-            if (!recover_url.isEmpty())
-                //: %1 is the link to download it manually
-                text += tr("Possible solution: Getting the latest version manually:<br>%1<br>")
-                    .arg(QString("<a href='%1'>%1</a>").arg(recover_url.toString()));
-            text += "<br>";
-        }
+    // otherwise checkCandidates() or waitForChecks() take it from here
+    if (m_progress_dialog || !isVisible())
+        return;
 
-        ScrollMessageBox message_dialog(m_parent, tr("Failed to check for updates"),
-                                        tr("Could not check or get the following mods for updates:<br>"
-                                           "Do you wish to proceed without those mods?"),
-                                        text);
-        message_dialog.setModal(true);
-        if (message_dialog.exec() == QDialog::Rejected) {
+    ui->explainLabel->setText(tr("You're about to update the following mods:"));
+    if (!reportFailedChecks()) {
+        m_aborted = true;
+        reject();
+    }
+}
+
+auto ModUpdateDialog::stillChecking() const -> bool
+{
+    return m_check_task && m_check_task->isRunning();
+}
+
+auto ModUpdateDialog::waitForChecks() -> bool
+{
+    if (stillChecking()) {
+        ProgressDialog progress_dialog(m_parent);
+        progress_dialog.setSkipButton(true, tr("Abort"));
+        progress_dialog.setWindowTitle(tr("Checking for updates..."));
+        if (progress_dialog.execWithTask(m_check_task.get()) == QDialog::DialogCode::Rejected)
             m_aborted = true;
-            QMetaObject::invokeMethod(this, "reject", Qt::QueuedConnection);
-            return;
-        }
     }
+    if (m_aborted || !reportFailedChecks())
+        return false;
 
-    // If there's no mod to be updated
-    if (ui->modTreeWidget->topLevelItemCount() == 0) {
-        m_no_updates = true;
-    } else {
-        // FIXME: Find a more efficient way of doing this!
+    ui->explainLabel->setText(tr("You're about to update the following mods:"));
+    m_no_updates = ui->modTreeWidget->topLevelItemCount() == 0;
+    return true;
+}
 
-        // Sort major items in alphabetical order (also sorts the children unfortunately)
-        ui->modTreeWidget->sortItems(0, Qt::SortOrder::AscendingOrder);
+void ModUpdateDialog::clearReviewed()
+{
+    ui->modTreeWidget->clear();
+    m_tasks.clear();
+    m_pending_changelogs.clear();
+}
 
-        // Re-sort the children
-        auto* item = ui->modTreeWidget->topLevelItem(0);
-        for (int i = 1; item != nullptr; ++i) {
-            item->sortChildren(0, Qt::SortOrder::DescendingOrder);
-            item = ui->modTreeWidget->topLevelItem(i);
-        }
-    }
+void ModUpdateDialog::done(int result)
+{
+    if (result == QDialog::Rejected && stillChecking())
+        m_check_task->abort();
+    ReviewMessageBox::done(result);
+}
 
-    if (m_aborted || m_no_updates)
-        QMetaObject::invokeMethod(this, "reject", Qt::QueuedConnection);
+// Report failed update checking, only once for each of them
+auto ModUpdateDialog::reportFailedChecks() -> bool
+{
+    if (m_failed_check_update.empty())
+        return true;
+
+    QString text;
+    for (const auto& failed : m_failed_check_update) {
+        const auto& mod = std::get<0>(failed);
+        const auto& reason = std::get<1>(failed);
+        const auto& recover_url = std::get<2>(failed);
+
+        qDebug() << mod->name() << " failed to check for updates!";
+
+        text += tr("Mod name: %1").arg(mod->name()) + "<br>";
+        if (!reason.isEmpty())
+            text += tr("Reason: %1").arg(reason) + "<br>";
+        if (!recover_url.isEmpty())
+            //: %1 is the link to download it manually
+            text += tr("Possible solution: Getting the latest version manually:<br>%1<br>")
+                .arg(QString("<a href='%1'>%1</a>").arg(recover_url.toString()));
+        text += "<br>";
+    }
+    m_failed_check_update.clear();
+
+    ScrollMessageBox message_dialog(isVisible() ? this : m_parent, tr("Failed to check for updates"),
+                                    tr("Could not check or get the following mods for updates:<br>"
+                                       "Do you wish to proceed without those mods?"),
+                                    text);
+    message_dialog.setModal(true);
+    return message_dialog.exec() != QDialog::Rejected;
 }
 
 // Part 1: Ensure we have a valid metadata
@@ -206,26 +262,15 @@ auto ModUpdateDialog::ensureMetadata() -> bool
 
     SequentialTask seq(m_parent, tr("Looking for metadata"));
 
-    // A better use of data structures here could remove the need for this QHash
-    QHash<QString, bool> should_try_others;
-    QList<Mod*> modrinth_tmp;
-    QList<Mod*> flame_tmp;
+    // the mods by the provider chosen for them, and whether the other one is asked too
+    QMap<std::pair<ModPlatform::ResourceProvider, bool>, QList<Mod*>> to_look_up;
 
     bool confirm_rest = false;
     bool try_others_rest = false;
     bool skip_rest = false;
     ModPlatform::ResourceProvider provider_rest = ModPlatform::ResourceProvider::MODRINTH;
 
-    auto addToTmp = [&](Mod* m, ModPlatform::ResourceProvider p) {
-        switch (p) {
-            case ModPlatform::ResourceProvider::MODRINTH:
-                modrinth_tmp.push_back(m);
-                break;
-            case ModPlatform::ResourceProvider::FLAME:
-                flame_tmp.push_back(m);
-                break;
-        }
-    };
+    auto addToTmp = [&](Mod* m, ModPlatform::ResourceProvider p, bool try_others) { to_look_up[{ p, try_others }].push_back(m); };
 
     for (auto candidate : m_candidates) {
         if (candidate->status() != ModStatus::NoMetadata) {
@@ -237,8 +282,7 @@ auto ModUpdateDialog::ensureMetadata() -> bool
             continue;
 
         if (confirm_rest) {
-            addToTmp(candidate, provider_rest);
-            should_try_others.insert(candidate->internal_id(), try_others_rest);
+            addToTmp(candidate, provider_rest, try_others_rest);
             continue;
         }
 
@@ -259,40 +303,22 @@ auto ModUpdateDialog::ensureMetadata() -> bool
             try_others_rest = response.try_others;
         }
 
-        should_try_others.insert(candidate->internal_id(), response.try_others);
-
         if (confirmed)
-            addToTmp(candidate, response.chosen);
-    }
-
-    if (!modrinth_tmp.empty()) {
-        auto modrinth_task = makeShared<EnsureMetadataTask>(modrinth_tmp, index_dir, ModPlatform::ResourceProvider::MODRINTH);
-        connect(modrinth_task.get(), &EnsureMetadataTask::metadataReady, [this](Mod* candidate) { onMetadataEnsured(candidate); });
-        connect(modrinth_task.get(), &EnsureMetadataTask::metadataFailed, [this, &should_try_others](Mod* candidate) {
-            onMetadataFailed(candidate, should_try_others.find(candidate->internal_id()).value(), ModPlatform::ResourceProvider::MODRINTH);
-        });
-
-        if (modrinth_task->getHashingTask())
-            seq.addTask(modrinth_task->getHashingTask());
-
-        seq.addTask(modrinth_task);
+            addToTmp(candidate, response.chosen, response.try_others);
     }
 
-    if (!flame_tmp.empty()) {
-        auto flame_task = makeShared<EnsureMetadataTask>(flame_tmp, index_dir, ModPlatform::ResourceProvider::FLAME);
-        connect(flame_task.get(), &EnsureMetadataTask::metadataReady, [this](Mod* candidate) { onMetadataEnsured(candidate); });
-        connect(flame_task.get(), &EnsureMetadataTask::metadataFailed, [this, &should_try_others](Mod* candidate) {
-            onMetadataFailed(candidate, should_try_others.find(candidate->internal_id()).value(), ModPlatform::ResourceProvider::FLAME);
-        });
+    // both providers are asked at once for the mods that may be on either of them
+    for (auto it = to_look_up.begin(); it != to_look_up.end(); it++) {
+        auto task = makeShared<EnsureMetadataTask>(it.value(), index_dir, it.key().first, it.key().second);
+        connect(task.get(), &EnsureMetadataTask::metadataReady, [this](Mod* candidate) { onMetadataEnsured(candidate); });
+        connect(task.get(), &EnsureMetadataTask::metadataFailed, [this](Mod* candidate) { onMetadataFailed(candidate); });
 
-        if (flame_task->getHashingTask())
-            seq.addTask(flame_task->getHashingTask());
+        if (task->getHashingTask())
+            seq.addTask(task->getHashingTask());
 
-        seq.addTask(flame_task);
+        seq.addTask(task);
     }
 
-    seq.addTask(m_second_try_metadata);
-
     ProgressDialog checking_dialog(m_parent);
     checking_dialog.setSkipButton(true, tr("Abort"));
     checking_dialog.setWindowTitle(tr("Generating metadata..."));
@@ -317,41 +343,18 @@ void ModUpdateDialog::onMetadataEnsured(Mod* mod)
     }
 }
 
-ModPlatform::ResourceProvider next(ModPlatform::ResourceProvider p)
-{
-    switch (p) {
-        case ModPlatform::ResourceProvider::MODRINTH:
-            return ModPlatform::ResourceProvider::FLAME;
-        case ModPlatform::ResourceProvider::FLAME:
-            return ModPlatform::ResourceProvider::MODRINTH;
-    }
-
-    return ModPlatform::ResourceProvider::FLAME;
-}
-
-void ModUpdateDialog::onMetadataFailed(Mod* mod, bool try_others, ModPlatform::ResourceProvider first_choice)
+void ModUpdateDialog::onMetadataFailed(Mod* mod)
 {
-    if (try_others) {
-        auto index_dir = indexDir();
-
-        auto task = makeShared<EnsureMetadataTask>(mod, index_dir, next(first_choice));
-        connect(task.get(), &EnsureMetadataTask::metadataReady, [this](Mod* candidate) { onMetadataEnsured(candidate); });
-        connect(task.get(), &EnsureMetadataTask::metadataFailed, [this](Mod* candidate) { onMetadataFailed(candidate, false); });
+    QString reason{ tr("Couldn't find a valid version on the selected mod provider(s)") };
 
-        m_second_try_metadata->addTask(task);
-    } else {
-        QString reason{ tr("Couldn't find a valid version on the selected mod provider(s)") };
-
-        m_failed_metadata.append({mod, reason});
-    }
+    m_failed_metadata.append({mod, reason});
 }
 
 void ModUpdateDialog::appendMod(CheckUpdateTask::UpdatableMod const& info)
 {
-    auto item_top = new QTreeWidgetItem(ui->modTreeWidget);
+    auto item_top = new QTreeWidgetItem();
     item_top->setCheckState(0, Qt::CheckState::Checked);
     item_top->setText(0, info.name);
-    item_top->setExpanded(true);
 
     auto provider_item = new QTreeWidgetItem(item_top);
     provider_item->setText(0, tr("Provider: %1").arg(ProviderCaps.readableName(info.provider)));
@@ -368,24 +371,70 @@ void ModUpdateDialog::appendMod(CheckUpdateTask::UpdatableMod const& info)
     auto changelog = new QTreeWidgetItem(changelog_item);
     auto changelog_area = new QTextBrowser();
 
-    QString text = info.changelog;
-    switch (info.provider) {
-        case ModPlatform::ResourceProvider::MODRINTH: {
-            text = markdownToHTML(info.changelog.toUtf8());
-            break;
+    // CurseForge doesn't give the changelogs along with the versions, so they're only fetched once someone wants to see them
+    if (info.changelog.isEmpty() && info.provider == ModPlatform::ResourceProvider::FLAME) {
+        changelog_area->setText(tr("Loading the changelog..."));
+        m_pending_changelogs.insert(changelog_item, { changelog_area, info.download->getPack()->addonId.toInt(),
+                                                      info.download->getVersionID().toInt() });
+    } else {
+        QString text = info.changelog;
+        switch (info.provider) {
+            case ModPlatform::ResourceProvider::MODRINTH: {
+                text = markdownToHTML(info.changelog.toUtf8());
+                break;
+            }
+            default:
+                break;
         }
-        default:
-            break;
-    }
 
-    changelog_area->setHtml(text);
+        changelog_area->setHtml(text);
+    }
     changelog_area->setOpenExternalLinks(true);
     changelog_area->setLineWrapMode(QTextBrowser::LineWrapMode::WidgetWidth);
     changelog_area->setVerticalScrollBarPolicy(Qt::ScrollBarPolicy::ScrollBarAsNeeded);
 
+    // in alphabetical order as they come in, the details stay in the order they were added
+    int row = 0;
+    while (row < ui->modTreeWidget->topLevelItemCount() &&
+           ui->modTreeWidget->topLevelItem(row)->text(0).localeAwareCompare(info.name) < 0)
+        row++;
+    ui->modTreeWidget->insertTopLevelItem(row, item_top);
+    item_top->setExpanded(true);
+
     ui->modTreeWidget->setItemWidget(changelog, 0, changelog_area);
+}
+
+void ModUpdateDialog::onItemExpanded(QTreeWidgetItem* item)
+{
+    auto pending = m_pending_changelogs.find(item);
+    if (pending == m_pending_changelogs.end())
+        return;
 
-    ui->modTreeWidget->addTopLevelItem(item_top);
+    QPointer<QTextBrowser> area = pending->area;
+    auto response = new QByteArray();
+    auto job = FlameAPI().getFileChangelog(pending->addon_id, pending->file_id, response);
+    m_pending_changelogs.erase(pending);
+
+    connect(job.get(), &Task::succeeded, this, [area, response] {
+        if (!area)
+            return;
+
+        QJsonParseError parse_error{};
+        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
+        if (parse_error.error != QJsonParseError::NoError) {
+            qWarning() << "Error while parsing JSON response from Flame::FileChangelog at " << parse_error.offset
+                       << " reason: " << parse_error.errorString();
+            area->setText(tr("Failed to fetch the changelog."));
+            return;
+        }
+        area->setHtml(Json::ensureString(doc.object(), "data"));
+    });
+    connect(job.get(), &Task::failed, this, [area] {
+        if (area)
+            area->setText(tr("Failed to fetch the changelog."));
+    });
+    m_changelog_jobs.append(job);
+    job->start();
 }
 
 auto ModUpdateDialog::getTasks() -> const QList<ResourceDownloadTask::Ptr>
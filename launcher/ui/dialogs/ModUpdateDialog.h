@@ -12,6 +12,9 @@ class Mod;
 class ModrinthCheckUpdate;
 class FlameCheckUpdate;
 class ConcurrentTask;
+class ProgressDialog;
+class QTextBrowser;
+class QTreeWidgetItem;
 
 class ModUpdateDialog final : public ReviewMessageBox {
     Q_OBJECT
@@ -20,7 +23,9 @@ class ModUpdateDialog final : public ReviewMessageBox {
                              BaseInstance* instance,
                              const std::shared_ptr<ModFolderModel> mod_model,
                              QList<Mod*>& search_for);
+    ~ModUpdateDialog() override;
 
+    /** Returns once the first update is found, the other mods are checked meanwhile and their updates get added. */
     void checkCandidates();
 
     void appendMod(const CheckUpdateTask::UpdatableMod& info);
@@ -28,21 +33,39 @@ class ModUpdateDialog final : public ReviewMessageBox {
     const QList<ResourceDownloadTask::Ptr> getTasks();
     auto indexDir() const -> QDir { return m_mod_model->indexDir(); }
 
+    /** Forgets the updates that were reviewed, for those found afterwards to be reviewed on their own. */
+    void clearReviewed();
+    auto stillChecking() const -> bool;
+    /** Waits for the mods still being checked, returns false if that was aborted or the user doesn't want to go on. */
+    auto waitForChecks() -> bool;
+
     auto noUpdates() const -> bool { return m_no_updates; };
     auto aborted() const -> bool { return m_aborted; };
 
+    void done(int result) override;
+
    private:
     auto ensureMetadata() -> bool;
+    /** Tells about the mods that couldn't be checked, returns false if the user doesn't want to go on without them. */
+    auto reportFailedChecks() -> bool;
 
    private slots:
     void onMetadataEnsured(Mod*);
-    void onMetadataFailed(Mod*, bool try_others = false, ModPlatform::ResourceProvider first_choice = ModPlatform::ResourceProvider::MODRINTH);
+    void onMetadataFailed(Mod*);
+    void onUpdateFound(const CheckUpdateTask::UpdatableMod& info);
+    void onChecksFinished();
+    void onItemExpanded(QTreeWidgetItem* item);
 
    private:
     QWidget* m_parent;
 
     shared_qobject_ptr<ModrinthCheckUpdate> m_modrinth_check_task;
     shared_qobject_ptr<FlameCheckUpdate> m_flame_check_task;
+    // both of them at once
+    shared_qobject_ptr<ConcurrentTask> m_check_task;
+    // while waiting for the first update
+    ProgressDialog* m_progress_dialog = nullptr;
+    std::list<Version> m_game_versions;
 
     const std::shared_ptr<ModFolderModel> m_mod_model;
 
@@ -50,11 +73,20 @@ class ModUpdateDialog final : public ReviewMessageBox {
     QList<Mod*> m_modrinth_to_update;
     QList<Mod*> m_flame_to_update;
 
-    ConcurrentTask::Ptr m_second_try_metadata;
     QList<std::tuple<Mod*, QString>> m_failed_metadata;
     QList<std::tuple<Mod*, QString, QUrl>> m_failed_check_update;
 
     QHash<QString, ResourceDownloadTask::Ptr> m_tasks;
+
+    struct PendingChangelog {
+        QTextBrowser* area;
+        int addon_id;
+        int file_id;
+    };
+    // changelog items whose changelog is fetched when they're first expanded
+    QHash<QTreeWidgetItem*, PendingChangelog> m_pending_changelogs;
+    // kept alive as long as the dialog, there are only as many of them as changelogs looked at
+    QList<Task::Ptr> m_changelog_jobs;
     BaseInstance* m_instance;
 
     bool m_no_updates = false;
@@ -67,7 +67,12 @@ ProgressDialog::ProgressDialog(QWidget* parent) : QDialog(parent), ui(new Ui::Pr
     this->setWindowFlags(this->windowFlags() & ~Qt::WindowContextHelpButtonHint);
     setAttribute(Qt::WidgetAttribute::WA_QuitOnClose, true);
     setSkipButton(false);
+
+    m_refresh_timer.setSingleShot(true);
+    m_refresh_timer.setInterval(s_refresh_interval_ms);
+    connect(&m_refresh_timer, &QTimer::timeout, this, &ProgressDialog::refresh);
     changeProgress(0, 100);
+    refresh();
 }
 
 void ProgressDialog::setSkipButton(bool present, QString label)
@@ -214,6 +219,26 @@ void ProgressDialog::addTaskProgress(TaskStepProgress const& progress)
 }
 
 void ProgressDialog::changeStepProgress(TaskStepProgress const& task_progress)
+{
+    m_pending_steps.insert(task_progress.uid, task_progress);
+    if (!m_refresh_timer.isActive())
+        m_refresh_timer.start();
+}
+
+void ProgressDialog::refresh()
+{
+    for (auto& task_progress : m_pending_steps)
+        applyStepProgress(task_progress);
+    m_pending_steps.clear();
+
+    if (m_progress_changed) {
+        m_progress_changed = false;
+        ui->globalProgressBar->setMaximum(m_total);
+        ui->globalProgressBar->setValue(m_current);
+    }
+}
+
+void ProgressDialog::applyStepProgress(TaskStepProgress const& task_progress)
 {
     m_is_multi_step = true;
     if(ui->taskProgressScrollArea->isHidden()) {
@@ -245,9 +270,11 @@ void ProgressDialog::changeStepProgress(TaskStepProgress const& task_progress)
 
 void ProgressDialog::changeProgress(qint64 current, qint64 total)
 {
-    ui->globalProgressBar->setMaximum(total);
-    ui->globalProgressBar->setValue(current);
-
+    m_current = current;
+    m_total = total;
+    m_progress_changed = true;
+    if (!m_refresh_timer.isActive())
+        m_refresh_timer.start();
 }
 
 void ProgressDialog::keyPressEvent(QKeyEvent* e)
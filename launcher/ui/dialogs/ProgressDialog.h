@@ -39,6 +39,7 @@
 #include <QDialog>
 #include <memory>
 #include <QHash>
+#include <QTimer>
 #include <QUuid>
 
 #include "QObjectPtr.h"
@@ -94,6 +95,9 @@ protected:
 private:
     bool handleImmediateResult(QDialog::DialogCode &result);
     void addTaskProgress(TaskStepProgress const& progress);
+    void applyStepProgress(TaskStepProgress const& task_progress);
+    /** Shows the progress that came in since the last time. */
+    void refresh();
 
 private:
     Ui::ProgressDialog *ui;
@@ -103,6 +107,13 @@ private:
     bool m_is_multi_step = false;
     QHash<QUuid, SubTaskProgressBar*> taskProgress;
 
+    // the progress is shown at most this often, however often it comes
+    static constexpr int s_refresh_interval_ms = 33;
+    QTimer m_refresh_timer;
+    QHash<QUuid, TaskStepProgress> m_pending_steps;
+    qint64 m_current = 0;
+    qint64 m_total = 100;
+    bool m_progress_changed = false;
 
 };
 
@@ -29,7 +29,9 @@
 #include "minecraft/mod/ResourcePackFolderModel.h"
 #include "minecraft/mod/ShaderPackFolderModel.h"
 #include "minecraft/mod/TexturePackFolderModel.h"
+#include "minecraft/mod/tasks/GetModDependenciesTask.h"
 
+#include "ui/dialogs/ProgressDialog.h"
 #include "ui/dialogs/ReviewMessageBox.h"
 
 #include "ui/pages/modplatform/ResourcePage.h"
@@ -128,7 +130,7 @@ void ResourceDownloadDialog::confirm()
     confirm_dialog->retranslateUi(resourcesString());
 
     for (auto& task : selected) {
-        confirm_dialog->appendResource({ task->getName(), task->getFilename(), task->getCustomPath() });
+        confirm_dialog->appendResource({ task->getName(), task->getFilename(), task->getCustomPath(), m_required_by.value(task->getName()) });
     }
 
     if (confirm_dialog->exec()) {
@@ -231,6 +233,35 @@ QList<BasePage*> ModDownloadDialog::getPages()
     return pages;
 }
 
+void ModDownloadDialog::confirm()
+{
+    QList<GetModDependenciesTask::PackDependency> selected;
+    for (auto& task : getTasks())
+        selected.append({ task->getPack(), task->getVersion(), {} });
+
+    auto task = makeShared<GetModDependenciesTask>(m_instance, std::static_pointer_cast<ModFolderModel>(getBaseModel()), selected);
+    ProgressDialog progress_dialog(this);
+    progress_dialog.setSkipButton(true, tr("Abort"));
+
+    // the dependencies are selected like the rest, so they show up for review and get downloaded with them
+    if (progress_dialog.execWithTask(task.get()) == QDialog::Accepted) {
+        static ModPlatform::ProviderCapabilities ProviderCaps;
+        for (auto dependency : task->getDependencies()) {
+            for (auto page : m_container->getPages()) {
+                auto res = static_cast<ResourcePage*>(page);
+                if (res->id() != ProviderCaps.name(dependency.pack->provider))
+                    continue;
+                res->addResourceToPage(dependency.pack, dependency.version, getBaseModel());
+                m_required_by.insert(dependency.pack->name, dependency.required_by);
+                break;
+            }
+        }
+        setButtonStatus();
+    }
+
+    ResourceDownloadDialog::confirm();
+}
+
 ResourcePackDownloadDialog::ResourcePackDownloadDialog(QWidget* parent,
                                                        const std::shared_ptr<ResourcePackFolderModel>& resource_packs,
                                                        BaseInstance* instance)
@@ -87,6 +87,9 @@ class ResourceDownloadDialog : public QDialog, public BasePageProvider {
     PageContainer* m_container = nullptr;
     ResourcePage* m_selectedPage = nullptr;
 
+    // the names of the resources that were selected as dependencies, with the one they are required by
+    QHash<QString, QString> m_required_by;
+
     QDialogButtonBox m_buttons;
     QVBoxLayout m_vertical_layout;
 };
@@ -104,6 +107,9 @@ class ModDownloadDialog final : public ResourceDownloadDialog {
 
     QList<BasePage*> getPages() override;
 
+   protected slots:
+    void confirm() override;
+
    private:
     BaseInstance* m_instance;
 };
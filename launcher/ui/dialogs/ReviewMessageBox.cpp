@@ -52,6 +52,13 @@ void ReviewMessageBox::appendResource(ResourceInformation&& info)
         itemTop->setToolTip(1, tr("This file will be downloaded to a folder location different from the default, possibly due to its loader requiring it."));
     }
 
+    if (!info.required_by.isEmpty()) {
+        auto requiredByItem = new QTreeWidgetItem(itemTop);
+        requiredByItem->setText(0, tr("Required by: %1").arg(info.required_by));
+
+        itemTop->addChild(requiredByItem);
+    }
+
     ui->modTreeWidget->addTopLevelItem(itemTop);
 }
 
@@ -16,6 +16,7 @@ class ReviewMessageBox : public QDialog {
         QString name;  
         QString filename;  
         QString custom_file_path {};
+        QString required_by {};
     };
 
     void appendResource(ResourceInformation&& info);
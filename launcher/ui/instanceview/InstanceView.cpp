@@ -44,6 +44,7 @@
 #include <QDrag>
 #include <QMimeData>
 #include <QCache>
+#include <QSet>
 #include <QScrollBar>
 #include <QAccessible>
 
@@ -90,25 +91,76 @@ void InstanceView::setModel(QAbstractItemModel *model)
 
 void InstanceView::dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles)
 {
-    scheduleDelayedItemsLayout();
+    // the items look different, but they take the same room as before
+    if (!roles.isEmpty() && !roles.contains(InstanceViewRoles::GroupRole) && !roles.contains(Qt::DisplayRole)
+        && !roles.contains(Qt::SizeHintRole) && !roles.contains(Qt::FontRole))
+    {
+        viewport()->update();
+        return;
+    }
+    if (m_layoutPending || roles.contains(InstanceViewRoles::GroupRole) || bottomRight.row() >= m_rowGroups.size())
+    {
+        scheduleLayout();
+        return;
+    }
+
+    // the items may have changed size, so the groups they're in have to flow again, but the others are fine
+    QSet<VisualGroup *> affected;
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++)
+    {
+        auto group = m_rowGroups[row];
+        if (model()->index(row, 0).data(InstanceViewRoles::GroupRole).toString() != group->text)
+        {
+            scheduleLayout();
+            return;
+        }
+        affected.insert(group);
+    }
+
+    bool heightChanged = false;
+    for (auto group : affected)
+    {
+        int height = group->totalHeight();
+        group->update();
+        heightChanged |= group->totalHeight() != height;
+        for (auto &item : group->items())
+        {
+            geometryCache.remove(item.row());
+        }
+    }
+    // everything below moved
+    if (heightChanged)
+    {
+        geometryCache.clear();
+        updateScrollbar();
+    }
+    viewport()->update();
 }
+
 void InstanceView::rowsInserted(const QModelIndex &parent, int start, int end)
 {
-    scheduleDelayedItemsLayout();
+    scheduleLayout();
 }
 
 void InstanceView::rowsAboutToBeRemoved(const QModelIndex &parent, int start, int end)
 {
-    scheduleDelayedItemsLayout();
+    scheduleLayout();
 }
 
 void InstanceView::modelReset()
 {
-    scheduleDelayedItemsLayout();
+    scheduleLayout();
 }
 
 void InstanceView::rowsRemoved()
 {
+    scheduleLayout();
+}
+
+void InstanceView::scheduleLayout()
+{
+    // until the layout is done, the rows don't match what the groups know about anymore
+    m_layoutPending = true;
     scheduleDelayedItemsLayout();
 }
 
@@ -182,31 +234,39 @@ void InstanceView::updateScrollbar()
 void InstanceView::updateGeometries()
 {
     geometryCache.clear();
+    geometryCache.setMaxCost(qMax(100, model()->rowCount()));
+    m_layoutPending = false;
 
     QMap<LocaleString, VisualGroup *> cats;
+    m_rowGroups.resize(model()->rowCount());
 
     for (int i = 0; i < model()->rowCount(); ++i)
     {
-        const QString groupName = model()->index(i, 0).data(InstanceViewRoles::GroupRole).toString();
-        if (!cats.contains(groupName))
+        const QModelIndex index = model()->index(i, 0);
+        const QString groupName = index.data(InstanceViewRoles::GroupRole).toString();
+        auto cat = cats.value(groupName);
+        if (!cat)
         {
             VisualGroup *old = this->category(groupName);
             if (old)
             {
-                auto cat = new VisualGroup(old);
-                cats.insert(groupName, cat);
-                cat->update();
+                cat = new VisualGroup(old);
             }
             else
             {
-                auto cat = new VisualGroup(groupName, this);
+                cat = new VisualGroup(groupName, this);
                 if(fVisibility) {
                     cat->collapsed = fVisibility(groupName);
                 }
-                cats.insert(groupName, cat);
-                cat->update();
             }
+            cats.insert(groupName, cat);
         }
+        cat->m_items.append(index);
+        m_rowGroups[i] = cat;
+    }
+    for (auto cat : cats)
+    {
+        cat->update();
     }
 
     qDeleteAll(m_groups);
@@ -215,6 +275,13 @@ void InstanceView::updateGeometries()
     viewport()->update();
 }
 
+void InstanceView::updateCollapsedGroups()
+{
+    // collapsing only moves the groups, what's in them stays the same
+    geometryCache.clear();
+    updateScrollbar();
+}
+
 bool InstanceView::isIndexHidden(const QModelIndex &index) const
 {
     VisualGroup *cat = category(index);
@@ -230,6 +297,10 @@ bool InstanceView::isIndexHidden(const QModelIndex &index) const
 
 VisualGroup *InstanceView::category(const QModelIndex &index) const
 {
+    if (!m_layoutPending && index.isValid() && index.row() < m_rowGroups.size())
+    {
+        return m_rowGroups[index.row()];
+    }
     return category(index.data(InstanceViewRoles::GroupRole).toString());
 }
 
@@ -324,7 +395,8 @@ void InstanceView::mousePressEvent(QMouseEvent *event)
 
         setAutoScroll(autoScroll);
         QRect rect(visualPos, visualPos);
-        setSelection(rect, QItemSelectionModel::ClearAndSelect);
+        // with Ctrl, instances are added to the selection, to launch them together
+        setSelection(rect, selectionCommand(index, event));
 
         // signal handlers may change the model
         emit pressed(index);
@@ -414,7 +486,7 @@ void InstanceView::mouseReleaseEvent(QMouseEvent *event)
             m_pressedCategory->collapsed = false;
             emit groupStateChanged(m_pressedCategory->text, false);
 
-            updateGeometries();
+            updateCollapsedGroups();
             viewport()->update();
             event->accept();
             m_pressedCategory = nullptr;
@@ -426,7 +498,7 @@ void InstanceView::mouseReleaseEvent(QMouseEvent *event)
             m_pressedCategory->collapsed = true;
             emit groupStateChanged(m_pressedCategory->text, true);
 
-            updateGeometries();
+            updateCollapsedGroups();
             viewport()->update();
             event->accept();
             m_pressedCategory = nullptr;
@@ -521,6 +593,10 @@ void InstanceView::paintEvent(QPaintEvent *event)
         y -= verticalOffset();
         QRect backup = option.rect;
         int height = category->totalHeight();
+        if (y + height < event->rect().top() || y > event->rect().bottom())
+        {
+            continue;
+        }
         option.rect.setTop(y);
         option.rect.setHeight(height);
         option.rect.setLeft(m_leftMargin);
@@ -537,8 +613,13 @@ void InstanceView::paintEvent(QPaintEvent *event)
         {
             continue;
         }
-        Qt::ItemFlags flags = index.flags();
         option.rect = visualRect(index);
+        // only what can be seen gets painted
+        if (!option.rect.intersects(event->rect()))
+        {
+            continue;
+        }
+        Qt::ItemFlags flags = index.flags();
         option.features |= QStyleOptionViewItem::WrapText;
         if (flags & Qt::ItemIsSelectable && selectionModel()->isSelected(index))
         {
@@ -764,9 +845,14 @@ QModelIndex InstanceView::indexAt(const QPoint &point) const
 {
     const_cast<InstanceView*>(this)->executeDelayedItemsLayout();
 
-    for (int i = 0; i < model()->rowCount(); ++i)
+    VisualGroup::HitResults hitresult;
+    auto group = categoryAt(point + offset(), hitresult);
+    if (!group || !(hitresult & VisualGroup::BodyHit))
+    {
+        return QModelIndex();
+    }
+    for (auto &index : group->items())
     {
-        QModelIndex index = model()->index(i, 0);
         if (visualRect(index).contains(point))
         {
             return index;
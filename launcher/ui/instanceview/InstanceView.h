@@ -123,6 +123,10 @@ protected:
 
     void updateScrollbar();
 
+private:
+    void scheduleLayout();
+    void updateCollapsedGroups();
+
 private:
     friend struct VisualGroup;
     QList<VisualGroup *> m_groups;
@@ -139,6 +143,9 @@ private:
     int m_currentItemsPerRow = -1;
     int m_currentCursorColumn= -1;
     mutable QCache<int, QRect> geometryCache;
+    // row -> the group it's in, as of the last layout
+    QVector<VisualGroup *> m_rowGroups;
+    bool m_layoutPending = false;
 
     // point where the currently active mouse action started in geometry coordinates
     QPoint m_pressedPosition;
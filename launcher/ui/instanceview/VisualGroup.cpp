@@ -54,11 +54,12 @@ VisualGroup::VisualGroup(const VisualGroup *other)
 
 void VisualGroup::update()
 {
-    auto temp_items = items();
+    auto &temp_items = items();
     auto itemsPerRow = view->itemsPerRow();
 
     int numRows = qMax(1, qCeil((qreal)temp_items.size() / (qreal)itemsPerRow));
     rows = QVector<VisualRow>(numRows);
+    m_positions.clear();
 
     int maxRowHeight = 0;
     int positionInRow = 0;
@@ -88,6 +89,7 @@ void VisualGroup::update()
             maxRowHeight = itemHeight;
         }
         rows[currentRow].items.append(item);
+        m_positions.insert(item.row(), qMakePair(positionInRow, currentRow));
         positionInRow++;
     }
     rows[currentRow].height = maxRowHeight;
@@ -96,17 +98,10 @@ void VisualGroup::update()
 
 QPair<int, int> VisualGroup::positionOf(const QModelIndex &index) const
 {
-    int y = 0;
-    for (auto & row: rows)
+    auto position = m_positions.constFind(index.row());
+    if (position != m_positions.constEnd())
     {
-        for(auto x = 0; x < row.items.size(); x++)
-        {
-            if(row.items[x] == index)
-            {
-                return qMakePair(x,y);
-            }
-        }
-        y++;
+        return *position;
     }
     qWarning() << "Item" << index.row() << index.data(Qt::DisplayRole).toString() << "not found in visual group" << text;
     return qMakePair(0, 0);
@@ -329,16 +324,7 @@ int VisualGroup::verticalPosition() const
     return m_verticalPosition;
 }
 
-QList<QModelIndex> VisualGroup::items() const
+const QList<QModelIndex> &VisualGroup::items() const
 {
-    QList<QModelIndex> indices;
-    for (int i = 0; i < view->model()->rowCount(); ++i)
-    {
-        const QModelIndex index = view->model()->index(i, 0);
-        if (index.data(InstanceViewRoles::GroupRole).toString() == text)
-        {
-            indices.append(index);
-        }
-    }
-    return indices;
+    return m_items;
 }
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <QString>
+#include <QHash>
 #include <QRect>
 #include <QVector>
 #include <QStyleOption>
@@ -52,9 +53,13 @@ struct VisualGroup
     QVector<VisualRow> rows;
     int firstItemIndex = 0;
     int m_verticalPosition = 0;
+    /// the items of the group, in order. kept up to date by the view.
+    QList<QModelIndex> m_items;
+    /// model row -> x/y position inside the group, as flowed by update()
+    QHash<int, QPair<int, int>> m_positions;
 
 /* logic */
-    /// update the internal list of items and flow them into the rows.
+    /// flow the items into the rows.
     void update();
 
     /// draw the header at y-position.
@@ -100,7 +105,7 @@ struct VisualGroup
     /// shoot! BANG! what did we hit?
     HitResults hitScan (const QPoint &pos) const;
 
-    QList<QModelIndex> items() const;
+    const QList<QModelIndex> &items() const;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(VisualGroup::HitResults)
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "LazyPage.h"
+
+#include <QVBoxLayout>
+
+#include "Application.h"
+#include "MemoryAccounting.h"
+
+LazyPage::LazyPage(Info info, Creator creator, QWidget* parent) : QWidget(parent), m_info(std::move(info)), m_creator(std::move(creator))
+{
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    MemoryAccounting::track(
+        this, "Instance window pages", [this] { return MemoryAccounting::Usage{ m_page ? 1 : 0, 0 }; }, [this] { unload(); });
+}
+
+QString LazyPage::displayName() const
+{
+    return m_page ? m_page->displayName() : m_info.displayName();
+}
+
+QIcon LazyPage::icon() const
+{
+    return m_page ? m_page->icon() : APPLICATION->getThemedIcon(m_info.icon);
+}
+
+QString LazyPage::helpPage() const
+{
+    return m_page ? m_page->helpPage() : m_info.helpPage;
+}
+
+bool LazyPage::shouldDisplay() const
+{
+    if (m_page)
+        return m_page->shouldDisplay();
+    return !m_info.shouldDisplay || m_info.shouldDisplay();
+}
+
+bool LazyPage::apply()
+{
+    return !m_page || m_page->apply();
+}
+
+void LazyPage::openedImpl()
+{
+    create();
+    m_page->opened();
+}
+
+void LazyPage::closedImpl()
+{
+    if (m_page)
+        m_page->closed();
+}
+
+void LazyPage::setParentContainer(BasePageContainer* container)
+{
+    BasePage::setParentContainer(container);
+    if (m_page)
+        m_page->setParentContainer(container);
+}
+
+void LazyPage::retranslate()
+{
+    if (m_page)
+        m_page->retranslate();
+}
+
+bool LazyPage::unload()
+{
+    if (!m_page || isOpened || !m_page->apply())
+        return false;
+    // the page goes with its widget
+    delete m_widget;
+    m_widget = nullptr;
+    m_page = nullptr;
+    return true;
+}
+
+void LazyPage::create()
+{
+    if (m_page)
+        return;
+    m_page = m_creator();
+    m_page->setParentContainer(m_container);
+    m_widget = dynamic_cast<QWidget*>(m_page);
+    layout()->addWidget(m_widget);
+}
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QWidget>
+
+#include <functional>
+
+#include "ui/pages/BasePage.h"
+
+/* Stands in for a page until it's first shown, and only builds it then.
+ *
+ * Until the page exists, what the page list shows of it comes from the Info it was made with, which has to say the
+ * same as the page would. Once built, the page has the say. A page that isn't shown and has nothing left to apply can
+ * be unloaded again, which the launcher does when it lets go of its caches (see MemoryAccounting).
+ */
+class LazyPage : public QWidget, public BasePage {
+   public:
+    struct Info {
+        QString id;
+        // a function, for it to be retranslated
+        std::function<QString()> displayName;
+        // the name of the themed icon
+        QString icon;
+        QString helpPage;
+        // shown always when empty
+        std::function<bool()> shouldDisplay = {};
+    };
+    using Creator = std::function<BasePage*()>;
+
+    LazyPage(Info info, Creator creator, QWidget* parent = nullptr);
+    ~LazyPage() override = default;
+
+    QString id() const override { return m_info.id; }
+    QString displayName() const override;
+    QIcon icon() const override;
+    QString helpPage() const override;
+    bool shouldDisplay() const override;
+    bool apply() override;
+    void openedImpl() override;
+    void closedImpl() override;
+    void setParentContainer(BasePageContainer* container) override;
+    void retranslate() override;
+
+    /** The page, null until it's first shown. */
+    BasePage* page() const { return m_page; }
+    /** Destroys the page, unless it's shown or can't apply what it has. Returns whether it did. */
+    bool unload();
+
+   private:
+    void create();
+
+   private:
+    Info m_info;
+    Creator m_creator;
+    BasePage* m_page = nullptr;
+    QWidget* m_widget = nullptr;
+};
@@ -50,6 +50,7 @@
 #include "settings/SettingsObject.h"
 #include "tools/BaseProfiler.h"
 #include "Application.h"
+#include "net/MirrorList.h"
 #include "net/PasteUpload.h"
 #include "BuildConfig.h"
 
@@ -86,6 +87,8 @@ APIPage::APIPage(QWidget *parent) :
     ui->flameKey->setValidator(new QRegularExpressionValidator(validFlameKey, ui->flameKey));
 
     ui->metaURL->setPlaceholderText(BuildConfig.META_URL);
+    ui->libraryMirrors->setPlaceholderText(BuildConfig.LIBRARY_BASE);
+    ui->assetMirrors->setPlaceholderText(BuildConfig.RESOURCE_BASE);
     ui->userAgentLineEdit->setPlaceholderText(BuildConfig.USER_AGENT);
 
     loadSettings();
@@ -146,6 +149,10 @@ void APIPage::loadSettings()
     ui->msaClientID->setText(msaClientID);
     QString metaURL = s->get("MetaURLOverride").toString();
     ui->metaURL->setText(metaURL);
+    ui->libraryMirrors->setText(s->get("LibraryMirrors").toString());
+    ui->assetMirrors->setText(s->get("AssetMirrors").toString());
+    ui->screenshotMaxSize->setValue(s->get("ScreenshotUploadMaxSize").toInt());
+    ui->screenshotFormat->setCurrentIndex(s->get("ScreenshotUploadFormat").toString() == "jpg" ? 1 : 0);
     QString flameKey = s->get("FlameKeyOverride").toString();
     ui->flameKey->setText(flameKey);
     QString modrinthToken = s->get("ModrinthToken").toString();
@@ -178,6 +185,11 @@ void APIPage::applySettings()
     }
 
     s->set("MetaURLOverride", metaURL.toString());
+    s->set("LibraryMirrors", Net::MirrorList::parse(ui->libraryMirrors->text()).join(", "));
+    s->set("AssetMirrors", Net::MirrorList::parse(ui->assetMirrors->text()).join(", "));
+    APPLICATION->mirrors()->loadSettings(*s);
+    s->set("ScreenshotUploadMaxSize", ui->screenshotMaxSize->value());
+    s->set("ScreenshotUploadFormat", ui->screenshotFormat->currentIndex() == 1 ? "jpg" : "png");
     QString flameKey = ui->flameKey->text();
     s->set("FlameKeyOverride", flameKey);
     QString modrinthToken = ui->modrinthToken->text();
@@ -59,6 +59,7 @@ ExternalToolsPage::ExternalToolsPage(QWidget *parent) :
     ui->mceditLink->setOpenExternalLinks(true);
     ui->jvisualvmLink->setOpenExternalLinks(true);
     ui->jprofilerLink->setOpenExternalLinks(true);
+    ui->asyncProfilerLink->setOpenExternalLinks(true);
     loadSettings();
 }
 
@@ -72,6 +73,8 @@ void ExternalToolsPage::loadSettings()
     auto s = APPLICATION->settings();
     ui->jprofilerPathEdit->setText(s->get("JProfilerPath").toString());
     ui->jvisualvmPathEdit->setText(s->get("JVisualVMPath").toString());
+    ui->asyncProfilerPathEdit->setText(s->get("AsyncProfilerPath").toString());
+    ui->profileStartupSpinBox->setValue(s->get("ProfileStartupSeconds").toInt());
     ui->mceditPathEdit->setText(s->get("MCEditPath").toString());
 
     // Editors
@@ -83,6 +86,8 @@ void ExternalToolsPage::applySettings()
 
     s->set("JProfilerPath", ui->jprofilerPathEdit->text());
     s->set("JVisualVMPath", ui->jvisualvmPathEdit->text());
+    s->set("AsyncProfilerPath", ui->asyncProfilerPathEdit->text());
+    s->set("ProfileStartupSeconds", ui->profileStartupSpinBox->value());
     s->set("MCEditPath", ui->mceditPathEdit->text());
 
     // Editors
@@ -173,6 +178,43 @@ void ExternalToolsPage::on_jvisualvmCheckBtn_clicked()
     }
 }
 
+void ExternalToolsPage::on_asyncProfilerPathBtn_clicked()
+{
+    QString raw_dir = ui->asyncProfilerPathEdit->text();
+    QString error;
+    do
+    {
+        raw_dir = QFileDialog::getExistingDirectory(this, tr("async-profiler Folder"), raw_dir);
+        if (raw_dir.isEmpty())
+        {
+            break;
+        }
+        QString cooked_dir = FS::NormalizePath(raw_dir);
+        if (!APPLICATION->profilers()["asyncprofiler"]->check(cooked_dir, &error))
+        {
+            QMessageBox::critical(this, tr("Error"), tr("Error while checking async-profiler install:\n%1").arg(error));
+            continue;
+        }
+        else
+        {
+            ui->asyncProfilerPathEdit->setText(cooked_dir);
+            break;
+        }
+    } while (1);
+}
+void ExternalToolsPage::on_asyncProfilerCheckBtn_clicked()
+{
+    QString error;
+    if (!APPLICATION->profilers()["asyncprofiler"]->check(ui->asyncProfilerPathEdit->text(), &error))
+    {
+        QMessageBox::critical(this, tr("Error"), tr("Error while checking async-profiler install:\n%1").arg(error));
+    }
+    else
+    {
+        QMessageBox::information(this, tr("OK"), tr("async-profiler setup seems to be OK"));
+    }
+}
+
 void ExternalToolsPage::on_mceditPathBtn_clicked()
 {
     QString raw_dir = ui->mceditPathEdit->text();
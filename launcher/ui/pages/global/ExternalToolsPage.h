@@ -89,6 +89,8 @@ slots:
     void on_jprofilerCheckBtn_clicked();
     void on_jvisualvmPathBtn_clicked();
     void on_jvisualvmCheckBtn_clicked();
+    void on_asyncProfilerPathBtn_clicked();
+    void on_asyncProfilerCheckBtn_clicked();
     void on_mceditPathBtn_clicked();
     void on_mceditCheckBtn_clicked();
     void on_jsonEditorBrowseBtn_clicked();
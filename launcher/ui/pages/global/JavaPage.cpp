@@ -39,14 +39,18 @@
 #include "ui_JavaPage.h"
 
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QMessageBox>
 #include <QDir>
 #include <QTabBar>
 
+#include "ui/dialogs/CustomMessageBox.h"
+#include "ui/dialogs/ProgressDialog.h"
 #include "ui/dialogs/VersionSelectDialog.h"
 
 #include "java/JavaUtils.h"
 #include "java/JavaInstallList.h"
+#include "java/ManagedRuntime.h"
 
 #include "settings/SettingsObject.h"
 #include <FileSystem.h>
@@ -58,6 +62,10 @@ JavaPage::JavaPage(QWidget *parent) : QWidget(parent), ui(new Ui::JavaPage)
     ui->setupUi(this);
     ui->tabWidget->tabBar()->hide();
 
+    connect(ui->autoMemoryCheckBox, &QCheckBox::toggled, this, [this](bool automatic) {
+        ui->minMemSpinBox->setEnabled(!automatic);
+        ui->maxMemSpinBox->setEnabled(!automatic);
+    });
     loadSettings();
     updateThresholds();
 }
@@ -91,12 +99,15 @@ void JavaPage::applySettings()
         s->set("MaxMemAlloc", min);
     }
     s->set("PermGen", ui->permGenSpinBox->value());
+    s->set("AutoMemory", ui->autoMemoryCheckBox->isChecked());
 
     // Java Settings
     s->set("JavaPath", ui->javaPathTextBox->text());
     s->set("JvmArgs", ui->jvmArgsTextBox->toPlainText().replace("\n", " "));
     s->set("IgnoreJavaCompatibility", ui->skipCompatibilityCheckbox->isChecked());
+    s->set("AutomaticJavaSelection", ui->automaticJavaCheckbox->isChecked());
     s->set("IgnoreJavaWizard", ui->skipJavaWizardCheckbox->isChecked());
+    s->set("JvmProfile", JavaCommon::selectedJvmProfile(ui->jvmProfileComboBox));
     JavaCommon::checkJVMArgs(s->get("JvmArgs").toString(), this->parentWidget());
 }
 void JavaPage::loadSettings()
@@ -116,12 +127,15 @@ void JavaPage::loadSettings()
         ui->maxMemSpinBox->setValue(min);
     }
     ui->permGenSpinBox->setValue(s->get("PermGen").toInt());
+    ui->autoMemoryCheckBox->setChecked(s->get("AutoMemory").toBool());
 
     // Java Settings
     ui->javaPathTextBox->setText(s->get("JavaPath").toString());
     ui->jvmArgsTextBox->setPlainText(s->get("JvmArgs").toString());
     ui->skipCompatibilityCheckbox->setChecked(s->get("IgnoreJavaCompatibility").toBool());
+    ui->automaticJavaCheckbox->setChecked(s->get("AutomaticJavaSelection").toBool());
     ui->skipJavaWizardCheckbox->setChecked(s->get("IgnoreJavaWizard").toBool());
+    JavaCommon::fillJvmProfiles(ui->jvmProfileComboBox, s->get("JvmProfile").toString());
 }
 
 void JavaPage::on_javaDetectBtn_clicked()
@@ -144,6 +158,34 @@ void JavaPage::on_javaDetectBtn_clicked()
     }
 }
 
+void JavaPage::on_javaDownloadBtn_clicked()
+{
+    QStringList names;
+    auto components = ManagedRuntime::knownComponents();
+    for (auto& component : components)
+        names.append(tr("Java %1 (%2)").arg(component.second, component.first));
+
+    bool ok = false;
+    auto name = QInputDialog::getItem(this, tr("Download Java"), tr("Runtime to download:"), names, 0, false, &ok);
+    if (!ok)
+        return;
+    auto component = components.at(names.indexOf(name)).first;
+
+    auto task = makeShared<ManagedRuntimeTask>(component);
+    connect(task.get(), &Task::failed, this, [this](QString reason) {
+        CustomMessageBox::selectable(this, tr("Error"), tr("Couldn't download Java: %1").arg(reason), QMessageBox::Critical)->show();
+    });
+
+    ProgressDialog progress(this);
+    progress.setSkipButton(true, tr("Abort"));
+    progress.execWithTask(task.get());
+
+    if (task->wasSuccessful()) {
+        ui->javaPathTextBox->setText(task->javaPath());
+        APPLICATION->javalist()->load();
+    }
+}
+
 void JavaPage::on_javaBrowseBtn_clicked()
 {
     QString raw_path = QFileDialog::getOpenFileName(this, tr("Find Java executable"));
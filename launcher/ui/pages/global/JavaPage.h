@@ -85,6 +85,7 @@ private:
 private
 slots:
     void on_javaDetectBtn_clicked();
+    void on_javaDownloadBtn_clicked();
     void on_javaTestBtn_clicked();
     void on_javaBrowseBtn_clicked();
     void on_maxMemSpinBox_valueChanged(int i);
@@ -51,6 +51,8 @@
 #include "DesktopServices.h"
 #include "ui/themes/ITheme.h"
 #include "updater/ExternalUpdater.h"
+#include "net/HostPool.h"
+#include "net/PeerCache.h"
 
 #include <QApplication>
 #include <QProcess>
@@ -219,6 +221,17 @@ void LauncherPage::applySettings()
     s->set("DownloadsDir", ui->downloadsDirTextBox->text());
     s->set("DownloadsDirWatchRecursive", ui->downloadsDirWatchRecursiveCheckBox->isChecked());
 
+    // Downloads
+    s->set("NumberOfConcurrentDownloads", ui->numberOfConcurrentDownloadsSpinBox->value());
+    s->set("UseHttp2", ui->useHttp2CheckBox->isChecked());
+    s->set("DownloadBandwidthLimit", ui->bandwidthLimitSpinBox->value());
+    s->set("SharedObjectStore", ui->sharedObjectStoreCheckBox->isChecked());
+    s->set("LanPeerCache", ui->lanPeerCacheCheckBox->isChecked());
+    APPLICATION->hostPool()->setMaxPerHost(ui->numberOfConcurrentDownloadsSpinBox->value());
+    APPLICATION->hostPool()->setHttp2Allowed(ui->useHttp2CheckBox->isChecked());
+    APPLICATION->hostPool()->setBandwidthLimit(qint64(ui->bandwidthLimitSpinBox->value()) * 1024);
+    APPLICATION->peerCache()->setEnabled(ui->lanPeerCacheCheckBox->isChecked());
+
     auto sortMode = (InstSortMode)ui->sortingModeGroup->checkedId();
     switch (sortMode)
     {
@@ -277,6 +290,13 @@ void LauncherPage::loadSettings()
     ui->downloadsDirTextBox->setText(s->get("DownloadsDir").toString());
     ui->downloadsDirWatchRecursiveCheckBox->setChecked(s->get("DownloadsDirWatchRecursive").toBool());
 
+    // Downloads
+    ui->numberOfConcurrentDownloadsSpinBox->setValue(s->get("NumberOfConcurrentDownloads").toInt());
+    ui->useHttp2CheckBox->setChecked(s->get("UseHttp2").toBool());
+    ui->bandwidthLimitSpinBox->setValue(s->get("DownloadBandwidthLimit").toInt());
+    ui->sharedObjectStoreCheckBox->setChecked(s->get("SharedObjectStore").toBool());
+    ui->lanPeerCacheCheckBox->setChecked(s->get("LanPeerCache").toBool());
+
     QString sortMode = s->get("InstSortMode").toString();
 
     if (sortMode == "LastLaunch")
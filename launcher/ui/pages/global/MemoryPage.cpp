@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "MemoryPage.h"
+
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "MemoryAccounting.h"
+#include "StringUtils.h"
+
+namespace {
+constexpr int s_update_interval_ms = 2000;
+}  // namespace
+
+MemoryPage::MemoryPage(QWidget* parent) : QWidget(parent)
+{
+    auto layout = new QVBoxLayout(this);
+
+    m_summary = new QLabel(this);
+    m_summary->setWordWrap(true);
+    m_summary->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(m_summary);
+
+    m_subsystems = new QTreeWidget(this);
+    m_subsystems->setRootIsDecorated(false);
+    m_subsystems->setColumnCount(5);
+    m_subsystems->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_subsystems->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    layout->addWidget(m_subsystems, 1);
+
+    auto controls = new QHBoxLayout();
+    controls->addStretch();
+    auto trimButton = new QPushButton(tr("Release Caches"), this);
+    connect(trimButton, &QPushButton::clicked, this, &MemoryPage::trim);
+    controls->addWidget(trimButton);
+    layout->addLayout(controls);
+
+    m_update_timer.setInterval(s_update_interval_ms);
+    connect(&m_update_timer, &QTimer::timeout, this, &MemoryPage::update);
+
+    retranslate();
+}
+
+void MemoryPage::retranslate()
+{
+    m_subsystems->setHeaderLabels({ tr("Part"), tr("Objects"), tr("Items"), tr("Estimated size"), tr("Cache") });
+    update();
+}
+
+void MemoryPage::openedImpl()
+{
+    m_update_timer.start();
+    update();
+}
+
+void MemoryPage::closedImpl()
+{
+    m_update_timer.stop();
+}
+
+void MemoryPage::update()
+{
+    auto subsystems = MemoryAccounting::report();
+    qint64 total = 0;
+    m_subsystems->clear();
+    for (auto& subsystem : subsystems) {
+        total += subsystem.bytes;
+        new QTreeWidgetItem(m_subsystems, { subsystem.name, QString::number(subsystem.objects), QString::number(subsystem.items),
+                                            StringUtils::humanReadableFileSize(subsystem.bytes), subsystem.trimmable ? tr("Yes") : QString() });
+    }
+
+    auto resident = MemoryAccounting::residentBytes();
+    auto text = tr("About %1 is accounted for. The sizes are estimates of what the objects hold, Qt and the allocator take more.")
+                    .arg(StringUtils::humanReadableFileSize(total));
+    if (resident >= 0)
+        text = tr("The launcher takes %1 of RAM.").arg(StringUtils::humanReadableFileSize(resident)) + " " + text;
+    m_summary->setText(text);
+}
+
+void MemoryPage::trim()
+{
+    MemoryAccounting::trim();
+    update();
+}
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QTimer>
+#include <QWidget>
+
+#include "Application.h"
+#include "ui/pages/BasePage.h"
+
+class QLabel;
+class QTreeWidget;
+
+/* What the parts of the launcher keep in memory, see MemoryAccounting. Follows along while it's open, and lets go of
+ * the caches on demand, as minimizing the main window does. */
+class MemoryPage : public QWidget, public BasePage {
+    Q_OBJECT
+
+   public:
+    explicit MemoryPage(QWidget* parent = nullptr);
+
+    QString displayName() const override { return tr("Memory"); }
+    QIcon icon() const override { return APPLICATION->getThemedIcon("status-good"); }
+    QString id() const override { return "memory"; }
+    QString helpPage() const override { return "Launcher-settings"; }
+    void retranslate() override;
+
+    void openedImpl() override;
+    void closedImpl() override;
+
+   private slots:
+    void update();
+    void trim();
+
+   private:
+    QLabel* m_summary;
+    QTreeWidget* m_subsystems;
+    QTimer m_update_timer;
+};
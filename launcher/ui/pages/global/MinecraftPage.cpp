@@ -42,6 +42,7 @@
 
 #include "settings/SettingsObject.h"
 #include "Application.h"
+#include "minecraft/PrefetchScheduler.h"
 
 MinecraftPage::MinecraftPage(QWidget *parent) : QWidget(parent), ui(new Ui::MinecraftPage)
 {
@@ -90,6 +91,8 @@ void MinecraftPage::applySettings()
     s->set("EnableFeralGamemode", ui->enableFeralGamemodeCheck->isChecked());
     s->set("EnableMangoHud", ui->enableMangoHud->isChecked());
     s->set("UseDiscreteGpu", ui->useDiscreteGpuCheck->isChecked());
+    s->set("AutoDiscreteGpu", ui->autoDiscreteGpuCheck->isChecked());
+    s->set("ShaderCachePerInstance", ui->shaderCachePerInstanceCheck->isChecked());
 
     // Game time
     s->set("ShowGameTime", ui->showGameTime->isChecked());
@@ -99,6 +102,15 @@ void MinecraftPage::applySettings()
     // Miscellaneous
     s->set("CloseAfterLaunch", ui->closeAfterLaunchCheck->isChecked());
     s->set("QuitAfterGameStop", ui->quitAfterGameStopCheck->isChecked());
+    s->set("BatchLaunchDelay", ui->batchLaunchDelaySpinBox->value());
+    s->set("BatchLaunchWaitForWindow", ui->batchLaunchWaitForWindowCheck->isChecked());
+    s->set("FastFirstLaunch", ui->fastFirstLaunchCheck->isChecked());
+    s->set("PrefetchUpdates", ui->prefetchUpdatesCheck->isChecked());
+    s->set("PrefetchWindowStart", ui->prefetchWindowStartEdit->time().toString("HH:mm"));
+    s->set("PrefetchWindowEnd", ui->prefetchWindowEndEdit->time().toString("HH:mm"));
+    s->set("PrefetchOnMetered", ui->prefetchOnMeteredCheck->isChecked());
+    if (auto scheduler = APPLICATION->prefetchScheduler())
+        scheduler->reschedule();
 }
 
 void MinecraftPage::loadSettings()
@@ -116,6 +128,8 @@ void MinecraftPage::loadSettings()
     ui->enableFeralGamemodeCheck->setChecked(s->get("EnableFeralGamemode").toBool());
     ui->enableMangoHud->setChecked(s->get("EnableMangoHud").toBool());
     ui->useDiscreteGpuCheck->setChecked(s->get("UseDiscreteGpu").toBool());
+    ui->autoDiscreteGpuCheck->setChecked(s->get("AutoDiscreteGpu").toBool());
+    ui->shaderCachePerInstanceCheck->setChecked(s->get("ShaderCachePerInstance").toBool());
 
 #if !defined(Q_OS_LINUX)
     ui->perfomanceGroupBox->setVisible(false);
@@ -137,6 +151,13 @@ void MinecraftPage::loadSettings()
 
     ui->closeAfterLaunchCheck->setChecked(s->get("CloseAfterLaunch").toBool());
     ui->quitAfterGameStopCheck->setChecked(s->get("QuitAfterGameStop").toBool());
+    ui->batchLaunchDelaySpinBox->setValue(s->get("BatchLaunchDelay").toInt());
+    ui->batchLaunchWaitForWindowCheck->setChecked(s->get("BatchLaunchWaitForWindow").toBool());
+    ui->fastFirstLaunchCheck->setChecked(s->get("FastFirstLaunch").toBool());
+    ui->prefetchUpdatesCheck->setChecked(s->get("PrefetchUpdates").toBool());
+    ui->prefetchWindowStartEdit->setTime(QTime::fromString(s->get("PrefetchWindowStart").toString(), "HH:mm"));
+    ui->prefetchWindowEndEdit->setTime(QTime::fromString(s->get("PrefetchWindowEnd").toString(), "HH:mm"));
+    ui->prefetchOnMeteredCheck->setChecked(s->get("PrefetchOnMetered").toBool());
 }
 
 void MinecraftPage::retranslate()
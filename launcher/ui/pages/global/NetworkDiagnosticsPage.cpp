@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "NetworkDiagnosticsPage.h"
+
+#include <QComboBox>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+#include "StringUtils.h"
+#include "net/Diagnostics.h"
+#include "ui/dialogs/CustomMessageBox.h"
+
+namespace {
+// more wouldn't tell more, the HAR export has all of them
+constexpr int s_shown_requests = 500;
+constexpr int s_update_interval_ms = 500;
+
+QString milliseconds(qint64 ms)
+{
+    return ms < 0 ? QString("-") : QString("%1 ms").arg(ms);
+}
+}  // namespace
+
+NetworkDiagnosticsPage::NetworkDiagnosticsPage(QWidget* parent) : QWidget(parent)
+{
+    auto layout = new QVBoxLayout(this);
+
+    m_summary = new QLabel(this);
+    m_summary->setWordWrap(true);
+    m_summary->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(m_summary);
+
+    m_hosts = new QTreeWidget(this);
+    m_hosts->setRootIsDecorated(false);
+    m_hosts->setColumnCount(9);
+    m_hosts->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    layout->addWidget(m_hosts, 1);
+
+    auto controls = new QHBoxLayout();
+    m_job = new QComboBox(this);
+    m_job->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    connect(m_job, QOverload<int>::of(&QComboBox::activated), this, &NetworkDiagnosticsPage::update);
+    controls->addWidget(m_job);
+    controls->addStretch();
+    auto exportButton = new QPushButton(tr("Export HAR..."), this);
+    connect(exportButton, &QPushButton::clicked, this, &NetworkDiagnosticsPage::exportHar);
+    controls->addWidget(exportButton);
+    auto clearButton = new QPushButton(tr("Clear"), this);
+    connect(clearButton, &QPushButton::clicked, this, &NetworkDiagnosticsPage::clear);
+    controls->addWidget(clearButton);
+    layout->addLayout(controls);
+
+    m_requests = new QTreeWidget(this);
+    m_requests->setRootIsDecorated(false);
+    m_requests->setColumnCount(10);
+    m_requests->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_requests->header()->setSectionResizeMode(1, QHeaderView::Stretch);
+    layout->addWidget(m_requests, 2);
+
+    m_update_timer.setSingleShot(true);
+    m_update_timer.setInterval(s_update_interval_ms);
+    connect(&m_update_timer, &QTimer::timeout, this, &NetworkDiagnosticsPage::update);
+
+    retranslate();
+}
+
+void NetworkDiagnosticsPage::retranslate()
+{
+    m_hosts->setHeaderLabels({ tr("Host"), tr("Requests"), tr("Cache hits"), tr("Revalidated"), tr("Retries"), tr("Failed"), tr("Data"),
+                               tr("Throughput"), tr("Average wait") });
+    m_requests->setHeaderLabels({ tr("Job"), tr("URL"), tr("Status"), tr("Cache"), tr("Try"), tr("Queued"), tr("Connect"), tr("Wait"),
+                                  tr("Receive"), tr("Size") });
+    update();
+}
+
+void NetworkDiagnosticsPage::openedImpl()
+{
+    if (auto diagnostics = APPLICATION->netDiagnostics())
+        connect(diagnostics.get(), &Net::Diagnostics::recorded, this, [this] {
+            if (!m_update_timer.isActive())
+                m_update_timer.start();
+        });
+    update();
+}
+
+void NetworkDiagnosticsPage::closedImpl()
+{
+    if (auto diagnostics = APPLICATION->netDiagnostics())
+        disconnect(diagnostics.get(), &Net::Diagnostics::recorded, this, nullptr);
+    m_update_timer.stop();
+}
+
+void NetworkDiagnosticsPage::update()
+{
+    auto diagnostics = APPLICATION->netDiagnostics();
+    if (!diagnostics)
+        return;
+
+    auto hosts = diagnostics->hosts();
+    m_hosts->clear();
+    Net::Diagnostics::HostStats total;
+    for (auto it = hosts.cbegin(); it != hosts.cend(); ++it) {
+        auto& stats = it.value();
+        total.requests += stats.requests;
+        total.hits += stats.hits;
+        total.revalidated += stats.revalidated;
+        total.retries += stats.retries;
+        total.failed += stats.failed;
+        total.bytes += stats.bytes;
+        auto network_requests = stats.requests - stats.hits;
+        new QTreeWidgetItem(m_hosts, { it.key(), QString::number(stats.requests), QString::number(stats.hits),
+                                       QString::number(stats.revalidated), QString::number(stats.retries), QString::number(stats.failed),
+                                       StringUtils::humanReadableFileSize(stats.bytes),
+                                       stats.throughput() > 0 ? tr("%1/s").arg(StringUtils::humanReadableFileSize(stats.throughput())) : QString("-"),
+                                       network_requests > 0 ? milliseconds(stats.waitTime / network_requests) : QString("-") });
+    }
+    m_hosts->sortItems(1, Qt::DescendingOrder);
+    m_summary->setText(total.requests == 0
+                           ? tr("Nothing was downloaded yet. The requests of the downloads show up here as they are made.")
+                           : tr("%1 requests this session, %2 answered by the cache, %3 revalidated, %4 retried and %5 failed, %6 in total.")
+                                 .arg(total.requests)
+                                 .arg(total.hits)
+                                 .arg(total.revalidated)
+                                 .arg(total.retries)
+                                 .arg(total.failed)
+                                 .arg(StringUtils::humanReadableFileSize(total.bytes)));
+
+    auto job = m_job->currentData().toString();
+    m_job->clear();
+    m_job->addItem(tr("All jobs"), QString());
+    for (auto& name : diagnostics->jobs())
+        m_job->addItem(name, name);
+    m_job->setCurrentIndex(qMax(0, m_job->findData(job)));
+
+    auto requests = diagnostics->requests(m_job->currentData().toString());
+    m_requests->clear();
+    // the most recent first
+    auto shown = std::min<int>(requests.size(), s_shown_requests);
+    for (int i = 0; i < shown; i++) {
+        auto& request = requests.at(requests.size() - 1 - i);
+        auto status = request.status > 0 ? QString::number(request.status) : QString("-");
+        auto item = new QTreeWidgetItem(
+            m_requests, { request.job, request.url, status, Net::Diagnostics::cacheOutcomeName(request.cache), QString::number(request.attempt),
+                          milliseconds(request.queued), milliseconds(request.connect), milliseconds(request.wait),
+                          milliseconds(request.receive), StringUtils::humanReadableFileSize(request.bytes) });
+        item->setToolTip(1, request.method + " " + request.url);
+        if (!request.error.isEmpty())
+            item->setToolTip(2, request.error);
+    }
+}
+
+void NetworkDiagnosticsPage::exportHar()
+{
+    auto diagnostics = APPLICATION->netDiagnostics();
+    if (!diagnostics)
+        return;
+    auto path = QFileDialog::getSaveFileName(this, tr("Export HAR"), "network.har", tr("HAR files (*.har)"));
+    if (path.isEmpty())
+        return;
+    if (!diagnostics->exportHar(path, m_job->currentData().toString()))
+        CustomMessageBox::selectable(this, tr("Export failed"), tr("Couldn't write %1.").arg(path), QMessageBox::Critical)->show();
+}
+
+void NetworkDiagnosticsPage::clear()
+{
+    if (auto diagnostics = APPLICATION->netDiagnostics())
+        diagnostics->clear();
+    update();
+}
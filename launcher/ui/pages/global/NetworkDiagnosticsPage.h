@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QTimer>
+#include <QWidget>
+
+#include "Application.h"
+#include "ui/pages/BasePage.h"
+
+class QComboBox;
+class QLabel;
+class QTreeWidget;
+
+/* What the downloads of the session did on the network, by host and by request, see Net::Diagnostics. Follows along
+ * while it's open, and exports the requests as a HAR file. */
+class NetworkDiagnosticsPage : public QWidget, public BasePage {
+    Q_OBJECT
+
+   public:
+    explicit NetworkDiagnosticsPage(QWidget* parent = nullptr);
+
+    QString displayName() const override { return tr("Network Diagnostics"); }
+    QIcon icon() const override { return APPLICATION->getThemedIcon("proxy"); }
+    QString id() const override { return "network-diagnostics"; }
+    QString helpPage() const override { return "Proxy-settings"; }
+    void retranslate() override;
+
+    void openedImpl() override;
+    void closedImpl() override;
+
+   private slots:
+    void update();
+    void exportHar();
+    void clear();
+
+   private:
+    QLabel* m_summary;
+    QTreeWidget* m_hosts;
+    QComboBox* m_job;
+    QTreeWidget* m_requests;
+    // a busy install records many requests a second, the page catches up with them every so often
+    QTimer m_update_timer;
+};
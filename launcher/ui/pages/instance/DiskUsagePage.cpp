@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "DiskUsagePage.h"
+
+#include <QDebug>
+#include <QFutureWatcher>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLocale>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include <QtConcurrent>
+
+#include "Executors.h"
+#include "StringUtils.h"
+
+namespace {
+// the logs of the last week are still of use for telling what went wrong
+constexpr int s_old_log_days = 7;
+}  // namespace
+
+DiskUsagePage::DiskUsagePage(InstancePtr instance, QWidget* parent)
+    : QWidget(parent), m_instance(instance), m_usage(APPLICATION->diskUsage())
+{
+    auto layout = new QVBoxLayout(this);
+
+    m_summary = new QLabel(this);
+    m_summary->setWordWrap(true);
+    m_summary->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(m_summary);
+
+    m_categories = new QTreeWidget(this);
+    m_categories->setRootIsDecorated(false);
+    m_categories->setColumnCount(2);
+    m_categories->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    layout->addWidget(m_categories, 1);
+
+    auto buttons = new QHBoxLayout();
+    m_refresh = new QPushButton(this);
+    m_oldLogs = new QPushButton(this);
+    m_crashReports = new QPushButton(this);
+    m_caches = new QPushButton(this);
+    m_shaderCache = new QPushButton(this);
+    buttons->addWidget(m_refresh);
+    buttons->addStretch();
+    buttons->addWidget(m_oldLogs);
+    buttons->addWidget(m_crashReports);
+    buttons->addWidget(m_caches);
+    buttons->addWidget(m_shaderCache);
+    layout->addLayout(buttons);
+
+    connect(m_refresh, &QPushButton::clicked, this, [this] {
+        m_usage->refresh(m_instance->id());
+        updateUsage();
+    });
+    connect(m_oldLogs, &QPushButton::clicked, this, [this] { cleanUp(DiskUsage::Cleanup::OldLogs); });
+    connect(m_crashReports, &QPushButton::clicked, this, [this] { cleanUp(DiskUsage::Cleanup::CrashReports); });
+    connect(m_caches, &QPushButton::clicked, this, [this] { cleanUp(DiskUsage::Cleanup::Caches); });
+    connect(m_shaderCache, &QPushButton::clicked, this, [this] { cleanUp(DiskUsage::Cleanup::ShaderCache); });
+
+    connect(m_usage.get(), &DiskUsage::updated, this, [this](const QString& id) {
+        if (id == m_instance->id())
+            updateUsage();
+    });
+    connect(m_instance.get(), &BaseInstance::runningStatusChanged, this, &DiskUsagePage::updateUsage);
+
+    retranslate();
+}
+
+void DiskUsagePage::retranslate()
+{
+    m_categories->setHeaderLabels({ tr("Used by"), tr("Size") });
+    m_refresh->setText(tr("Measure Again"));
+    m_oldLogs->setText(tr("Delete Old Logs"));
+    m_oldLogs->setToolTip(tr("Deletes the logs older than %1 days, and keeps the one of the last launch.").arg(s_old_log_days));
+    m_crashReports->setText(tr("Delete Crash Reports"));
+    m_caches->setText(tr("Clear Caches"));
+    m_caches->setToolTip(tr("Deletes what the mod loaders keep to start faster. They make it again on the next launch."));
+    m_shaderCache->setText(tr("Clear Shader Cache"));
+    m_shaderCache->setToolTip(tr("Deletes the shaders the drivers compiled for the instance. The next launches compile them again."));
+    updateUsage();
+}
+
+void DiskUsagePage::updateUsage()
+{
+    auto id = m_instance->id();
+    bool running = m_instance->isRunning();
+    for (auto button : { m_oldLogs, m_crashReports, m_caches, m_shaderCache })
+        button->setEnabled(!running && !m_cleaning);
+    m_refresh->setEnabled(!running && !m_usage->isMeasuring(id));
+
+    m_categories->clear();
+    auto usage = m_usage->usage(id);
+    if (!usage) {
+        m_summary->setText(running ? tr("The instance is measured once the game exits.") : tr("Measuring the instance..."));
+        return;
+    }
+
+    for (int i = 0; i < DiskUsage::s_category_count; i++) {
+        auto category = DiskUsage::Category(i);
+        auto item = new QTreeWidgetItem(m_categories, { DiskUsage::categoryName(category), StringUtils::humanReadableFileSize(usage->of(category)) });
+        item->setTextAlignment(1, Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    QString status;
+    if (m_usage->isMeasuring(id))
+        status = tr("Measuring again...");
+    else if (running)
+        status = tr("It's measured again once the game exits.");
+    m_summary->setText(tr("The instance takes %1, as of %2. %3")
+                           .arg(StringUtils::humanReadableFileSize(usage->total()),
+                                QLocale().toString(m_usage->measured(id), QLocale::ShortFormat), status)
+                           .trimmed());
+}
+
+void DiskUsagePage::cleanUp(DiskUsage::Cleanup what)
+{
+    if (m_instance->isRunning())
+        return;
+    m_cleaning = true;
+    updateUsage();
+
+    auto olderThan = QDateTime::currentDateTime();
+    if (what == DiskUsage::Cleanup::OldLogs)
+        olderThan = olderThan.addDays(-s_old_log_days);
+    auto watcher = new QFutureWatcher<qint64>(this);
+    connect(watcher, &QFutureWatcher<qint64>::finished, this, [this, watcher] {
+        watcher->deleteLater();
+        m_cleaning = false;
+        qDebug() << "Freed" << watcher->result() << "bytes in" << m_instance->id();
+        m_usage->refresh(m_instance->id());
+        updateUsage();
+    });
+    watcher->setFuture(QtConcurrent::run(Executors::io(), &DiskUsage::cleanUp, m_instance->gameRoot(), what, olderThan));
+}
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QWidget>
+
+#include "Application.h"
+#include "BaseInstance.h"
+#include "DiskUsage.h"
+#include "ui/pages/BasePage.h"
+
+class QLabel;
+class QPushButton;
+class QTreeWidget;
+
+/* What the instance takes on the disk, by what it's for, with the ways to free some of it: the old logs, the crash
+ * reports, and the caches the mod loaders make again. Nothing is deleted while the game runs. */
+class DiskUsagePage : public QWidget, public BasePage {
+    Q_OBJECT
+
+   public:
+    explicit DiskUsagePage(InstancePtr instance, QWidget* parent = nullptr);
+
+    QString displayName() const override { return tr("Disk Usage"); }
+    QIcon icon() const override { return APPLICATION->getThemedIcon("viewfolder"); }
+    QString id() const override { return "diskusage"; }
+    QString helpPage() const override { return "Instance-Disk-Usage"; }
+    void retranslate() override;
+
+   private slots:
+    void updateUsage();
+
+   private:
+    void cleanUp(DiskUsage::Cleanup what);
+
+    InstancePtr m_instance;
+    shared_qobject_ptr<DiskUsage> m_usage;
+    bool m_cleaning = false;
+
+    QLabel* m_summary;
+    QTreeWidget* m_categories;
+    QPushButton* m_refresh;
+    QPushButton* m_oldLogs;
+    QPushButton* m_crashReports;
+    QPushButton* m_caches;
+    QPushButton* m_shaderCache;
+};
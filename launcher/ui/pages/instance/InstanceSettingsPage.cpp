@@ -40,6 +40,7 @@
 #include <QFileDialog>
 #include <QDialog>
 #include <QMessageBox>
+#include <QRegularExpressionValidator>
 
 #include <sys.h>
 
@@ -52,6 +53,7 @@
 
 #include "java/JavaInstallList.h"
 #include "java/JavaUtils.h"
+#include "minecraft/launch/ProcessControls.h"
 #include "FileSystem.h"
 
 InstanceSettingsPage::InstanceSettingsPage(BaseInstance *inst, QWidget *parent)
@@ -61,6 +63,13 @@ InstanceSettingsPage::InstanceSettingsPage(BaseInstance *inst, QWidget *parent)
     ui->setupUi(this);
 
     connect(ui->openGlobalJavaSettingsButton, &QCommandLinkButton::clicked, this, &InstanceSettingsPage::globalSettingsButtonClicked);
+    connect(ui->autoMemoryCheckBox, &QCheckBox::toggled, this, [this](bool automatic) {
+        ui->minMemSpinBox->setEnabled(!automatic);
+        ui->maxMemSpinBox->setEnabled(!automatic);
+    });
+    // a CPU list like taskset takes them, "0-3,8"
+    ui->cpuAffinityEdit->setValidator(
+        new QRegularExpressionValidator(QRegularExpression("\\s*(\\d+(-\\d+)?(\\s*,\\s*\\d+(-\\d+)?)*)?\\s*"), this));
     connect(APPLICATION, &Application::globalSettingsAboutToOpen, this, &InstanceSettingsPage::applySettings);
     connect(APPLICATION, &Application::globalSettingsClosed, this, &InstanceSettingsPage::loadSettings);
     connect(ui->instanceAccountSelector, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &InstanceSettingsPage::changeInstanceAccount);
@@ -112,11 +121,13 @@ void InstanceSettingsPage::applySettings()
     {
         m_settings->set("CloseAfterLaunch", ui->closeAfterLaunchCheck->isChecked());
         m_settings->set("QuitAfterGameStop", ui->quitAfterGameStopCheck->isChecked());
+        m_settings->set("PrefetchUpdates", ui->prefetchUpdatesCheck->isChecked());
     }
     else
     {
         m_settings->reset("CloseAfterLaunch");
         m_settings->reset("QuitAfterGameStop");
+        m_settings->reset("PrefetchUpdates");
     }
 
     // Console
@@ -169,12 +180,14 @@ void InstanceSettingsPage::applySettings()
             m_settings->set("MaxMemAlloc", min);
         }
         m_settings->set("PermGen", ui->permGenSpinBox->value());
+        m_settings->set("AutoMemory", ui->autoMemoryCheckBox->isChecked());
     }
     else
     {
         m_settings->reset("MinMemAlloc");
         m_settings->reset("MaxMemAlloc");
         m_settings->reset("PermGen");
+        m_settings->reset("AutoMemory");
     }
 
     // Java Install Settings
@@ -197,11 +210,15 @@ void InstanceSettingsPage::applySettings()
     if(javaArgs)
     {
         m_settings->set("JvmArgs", ui->jvmArgsTextBox->toPlainText().replace("\n", " "));
+        m_settings->set("JvmProfile", JavaCommon::selectedJvmProfile(ui->jvmProfileComboBox));
     }
     else
     {
         m_settings->reset("JvmArgs");
+        m_settings->reset("JvmProfile");
     }
+    m_settings->set("UseClassDataSharing", ui->classDataSharingCheck->isChecked());
+    m_settings->set("KeepSpareJava", ui->keepSpareJavaCheck->isChecked());
 
     // old generic 'override both' is removed.
     m_settings->reset("OverrideJava");
@@ -244,14 +261,27 @@ void InstanceSettingsPage::applySettings()
         m_settings->set("EnableFeralGamemode", ui->enableFeralGamemodeCheck->isChecked());
         m_settings->set("EnableMangoHud", ui->enableMangoHud->isChecked());
         m_settings->set("UseDiscreteGpu", ui->useDiscreteGpuCheck->isChecked());
+        m_settings->set("AutoDiscreteGpu", ui->autoDiscreteGpuCheck->isChecked());
+        m_settings->set("ShaderCachePerInstance", ui->shaderCachePerInstanceCheck->isChecked());
     }
     else
     {
         m_settings->reset("EnableFeralGamemode");
         m_settings->reset("EnableMangoHud");
         m_settings->reset("UseDiscreteGpu");
+        m_settings->reset("AutoDiscreteGpu");
+        m_settings->reset("ShaderCachePerInstance");
     }
 
+    // Game process
+    m_settings->set("ProcessPriority", ui->processPriorityComboBox->currentData().toString());
+    if (auto cpus = ProcessControls::parseCpuList(ui->cpuAffinityEdit->text()))
+    {
+        m_settings->set("CpuAffinity", ProcessControls::formatCpuList(*cpus));
+    }
+    m_settings->set("CpuQuota", ui->cpuQuotaSpinBox->value());
+    m_settings->set("MemoryLimit", ui->memoryLimitSpinBox->value());
+
     // Game time
     bool gameTime = ui->gameTimeGroupBox->isChecked();
     m_settings->set("OverrideGameTime", gameTime);
@@ -278,6 +308,18 @@ void InstanceSettingsPage::applySettings()
         m_settings->reset("JoinServerOnLaunchAddress");
     }
 
+    // Packwiz pack to sync with
+    bool packwizSync = ui->packwizSyncGroupBox->isChecked();
+    m_settings->set("PackwizSync", packwizSync);
+    if (packwizSync)
+    {
+        m_settings->set("PackwizPackURL", ui->packwizPackURL->text().trimmed());
+    }
+    else
+    {
+        m_settings->reset("PackwizPackURL");
+    }
+
     // Use an account for this instance
     bool useAccountForInstance = ui->instanceAccountGroupBox->isChecked();
     m_settings->set("UseAccountForInstance", useAccountForInstance);
@@ -295,6 +337,7 @@ void InstanceSettingsPage::loadSettings()
     ui->miscellaneousSettingsBox->setChecked(m_settings->get("OverrideMiscellaneous").toBool());
     ui->closeAfterLaunchCheck->setChecked(m_settings->get("CloseAfterLaunch").toBool());
     ui->quitAfterGameStopCheck->setChecked(m_settings->get("QuitAfterGameStop").toBool());
+    ui->prefetchUpdatesCheck->setChecked(m_settings->get("PrefetchUpdates").toBool());
 
     // Console
     ui->consoleSettingsBox->setChecked(m_settings->get("OverrideConsole").toBool());
@@ -323,6 +366,7 @@ void InstanceSettingsPage::loadSettings()
         ui->maxMemSpinBox->setValue(min);
     }
     ui->permGenSpinBox->setValue(m_settings->get("PermGen").toInt());
+    ui->autoMemoryCheckBox->setChecked(m_settings->get("AutoMemory").toBool());
     bool permGenVisible = m_settings->get("PermGenVisible").toBool();
     ui->permGenSpinBox->setVisible(permGenVisible);
     ui->labelPermGen->setVisible(permGenVisible);
@@ -340,6 +384,9 @@ void InstanceSettingsPage::loadSettings()
 
     ui->javaArgumentsGroupBox->setChecked(overrideArgs);
     ui->jvmArgsTextBox->setPlainText(m_settings->get("JvmArgs").toString());
+    JavaCommon::fillJvmProfiles(ui->jvmProfileComboBox, m_settings->get("JvmProfile").toString());
+    ui->classDataSharingCheck->setChecked(m_settings->get("UseClassDataSharing").toBool());
+    ui->keepSpareJavaCheck->setChecked(m_settings->get("KeepSpareJava").toBool());
 
     // Custom commands
     ui->customCommands->initialize(
@@ -360,9 +407,39 @@ void InstanceSettingsPage::loadSettings()
     ui->enableFeralGamemodeCheck->setChecked(m_settings->get("EnableFeralGamemode").toBool());
     ui->enableMangoHud->setChecked(m_settings->get("EnableMangoHud").toBool());
     ui->useDiscreteGpuCheck->setChecked(m_settings->get("UseDiscreteGpu").toBool());
+    ui->autoDiscreteGpuCheck->setChecked(m_settings->get("AutoDiscreteGpu").toBool());
+    ui->shaderCachePerInstanceCheck->setChecked(m_settings->get("ShaderCachePerInstance").toBool());
+
+    // Game process
+    ui->processPriorityComboBox->clear();
+    const std::pair<ProcessControls::Priority, QString> priorities[] = {
+        { ProcessControls::Priority::Idle, tr("Idle") },
+        { ProcessControls::Priority::BelowNormal, tr("Below normal") },
+        { ProcessControls::Priority::Normal, tr("Normal") },
+        { ProcessControls::Priority::AboveNormal, tr("Above normal") },
+        { ProcessControls::Priority::High, tr("High") },
+    };
+    for (auto& priority : priorities)
+    {
+        ui->processPriorityComboBox->addItem(priority.second, ProcessControls::priorityName(priority.first));
+    }
+    auto priority = ProcessControls::priorityFromName(m_settings->get("ProcessPriority").toString());
+    ui->processPriorityComboBox->setCurrentIndex(ui->processPriorityComboBox->findData(ProcessControls::priorityName(priority)));
+    ui->cpuAffinityEdit->setText(m_settings->get("CpuAffinity").toString());
+    ui->cpuQuotaSpinBox->setValue(m_settings->get("CpuQuota").toInt());
+    ui->memoryLimitSpinBox->setValue(m_settings->get("MemoryLimit").toInt());
 
+    // the rest of the performance page is only for Linux, and so are the limits
 #if !defined(Q_OS_LINUX)
-    ui->settingsTabs->setTabVisible(ui->settingsTabs->indexOf(ui->performancePage), false);
+    ui->perfomanceGroupBox->setVisible(false);
+    ui->labelCpuQuota->setVisible(false);
+    ui->cpuQuotaSpinBox->setVisible(false);
+    ui->labelMemoryLimit->setVisible(false);
+    ui->memoryLimitSpinBox->setVisible(false);
+#endif
+#if defined(Q_OS_MACOS)
+    ui->labelCpuAffinity->setVisible(false);
+    ui->cpuAffinityEdit->setVisible(false);
 #endif
 
     if (!(APPLICATION->capabilities() & Application::SupportsGameMode)) {
@@ -383,6 +460,9 @@ void InstanceSettingsPage::loadSettings()
     ui->serverJoinGroupBox->setChecked(m_settings->get("JoinServerOnLaunch").toBool());
     ui->serverJoinAddress->setText(m_settings->get("JoinServerOnLaunchAddress").toString());
 
+    ui->packwizSyncGroupBox->setChecked(m_settings->get("PackwizSync").toBool());
+    ui->packwizPackURL->setText(m_settings->get("PackwizPackURL").toString());
+
     ui->instanceAccountGroupBox->setChecked(m_settings->get("UseAccountForInstance").toBool());
     updateAccountsMenu();
 }
@@ -45,6 +45,7 @@
 #include <QShortcut>
 
 #include "launch/LaunchTask.h"
+#include "launch/LogSearchIndex.h"
 #include "settings/Setting.h"
 
 #include "ui/GuiUtil.h"
@@ -176,6 +177,13 @@ LogPage::LogPage(InstancePtr instance, QWidget *parent)
 
     ui->text->setModel(m_proxy);
 
+    // the search goes through an index of the lines, so it neither scans the whole document on each keystroke nor
+    // each time it moves to the next match
+    m_search = new LogSearchIndex(this);
+    connect(ui->searchBar, &QLineEdit::textChanged, m_search, &LogSearchIndex::setQuery);
+    connect(m_search, &LogSearchIndex::matchesChanged, this, &LogPage::updateMatchLabel);
+    connect(ui->text, &QPlainTextEdit::cursorPositionChanged, this, &LogPage::updateMatchLabel);
+
     // set up instance and launch process recognition
     {
         auto launchTask = m_instance->getLaunchTask();
@@ -239,6 +247,7 @@ void LogPage::setInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> proc,
     {
         m_model = proc->getLogModel();
         m_proxy->setSourceModel(m_model.get());
+        m_search->setModel(m_model.get());
         if(initial)
         {
             modelStateToUI();
@@ -251,6 +260,7 @@ void LogPage::setInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> proc,
     else
     {
         m_proxy->setSourceModel(nullptr);
+        m_search->setModel(nullptr);
         m_model.reset();
     }
 }
@@ -282,7 +292,7 @@ void LogPage::on_btnPaste_clicked()
             QDateTime::currentDateTime().toString(Qt::RFC2822Date)
         )
     );
-    auto url = GuiUtil::uploadPaste(tr("Minecraft Log"), m_model->toPlainText(), this);
+    auto url = GuiUtil::uploadPaste(tr("Minecraft Log"), m_model->toPlainText(), this, m_model->levels());
     if(!url.has_value())
     {
         m_model->append(MessageLevel::Error, QString("Log upload canceled"));
@@ -337,17 +347,78 @@ void LogPage::on_findButton_clicked()
 {
     auto modifiers = QApplication::keyboardModifiers();
     bool reverse = modifiers & Qt::ShiftModifier;
-    ui->text->findNext(ui->searchBar->text(), reverse);
+    findMatch(reverse);
 }
 
 void LogPage::findNextActivated()
 {
-    ui->text->findNext(ui->searchBar->text(), false);
+    findMatch(false);
 }
 
 void LogPage::findPreviousActivated()
 {
-    ui->text->findNext(ui->searchBar->text(), true);
+    findMatch(true);
+}
+
+void LogPage::findMatch(bool reverse)
+{
+    auto cursor = ui->text->textCursor();
+    int row = cursor.blockNumber();
+    // without a selection, a match on the line of the cursor is the next one
+    if(!cursor.hasSelection())
+    {
+        row += reverse ? 1 : -1;
+    }
+    int match = m_search->nextMatch(row, reverse);
+    if(match < 0)
+    {
+        return;
+    }
+    ui->text->selectInRow(match, m_search->query());
+}
+
+void LogPage::on_levelFilter_currentIndexChanged(int index)
+{
+    switch(index)
+    {
+        case 1:
+            m_search->setLevels({ MessageLevel::Warning, MessageLevel::Error, MessageLevel::Fatal });
+            break;
+        case 2:
+            m_search->setLevels({ MessageLevel::Error, MessageLevel::Fatal });
+            break;
+        default:
+            m_search->setLevels({});
+            break;
+    }
+}
+
+void LogPage::updateMatchLabel()
+{
+    if(m_search->query().isEmpty() && ui->levelFilter->currentIndex() == 0)
+    {
+        ui->matchLabel->clear();
+        return;
+    }
+    if(m_search->isBuilding())
+    {
+        ui->matchLabel->setText(tr("Searching..."));
+        return;
+    }
+    int count = m_search->matchCount();
+    int current = m_search->matchIndex(ui->text->textCursor().blockNumber());
+    if(count == 0)
+    {
+        ui->matchLabel->setText(tr("No matches"));
+    }
+    else if(current >= 0 && ui->text->textCursor().hasSelection())
+    {
+        ui->matchLabel->setText(tr("%1 of %2").arg(current + 1).arg(count));
+    }
+    else
+    {
+        ui->matchLabel->setText(tr("%n match(es)", "", count));
+    }
 }
 
 void LogPage::findActivated()
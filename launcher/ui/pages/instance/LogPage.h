@@ -48,6 +48,7 @@ class LogPage;
 }
 class QTextCharFormat;
 class LogFormatProxyModel;
+class LogSearchIndex;
 
 class LogPage : public QWidget, public BasePage
 {
@@ -89,6 +90,8 @@ private slots:
     void findActivated();
     void findNextActivated();
     void findPreviousActivated();
+    void on_levelFilter_currentIndexChanged(int index);
+    void updateMatchLabel();
 
     void onInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> proc);
 
@@ -96,6 +99,7 @@ private:
     void modelStateToUI();
     void UIToModelState();
     void setInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> proc, bool initial);
+    void findMatch(bool reverse);
 
 private:
     Ui::LogPage *ui;
@@ -103,5 +107,6 @@ private:
     shared_qobject_ptr<LaunchTask> m_process;
 
     LogFormatProxyModel * m_proxy;
+    LogSearchIndex * m_search;
     shared_qobject_ptr <LogModel> m_model;
 };
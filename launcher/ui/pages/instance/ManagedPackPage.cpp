@@ -18,6 +18,7 @@
 #include "Markdown.h"
 
 #include "modplatform/modrinth/ModrinthPackManifest.h"
+#include "net/JsonResponse.h"
 
 #include "ui/InstanceWindow.h"
 #include "ui/dialogs/CustomMessageBox.h"
@@ -431,7 +432,19 @@ void FlameManagedPackPage::suggestVersion()
     auto index = ui->versionsComboBox->currentIndex();
     auto version = m_pack.versions.at(index);
 
-    ui->changelogTextBrowser->setHtml(m_api.getModFileChangelog(m_inst->getManagedPackID().toInt(), version.fileId));
+    if (m_changelog_job && m_changelog_job->isRunning())
+        m_changelog_job->abort();
+
+    ui->changelogTextBrowser->setHtml(tr("Loading the changelog..."));
+    auto response = new QByteArray();
+    m_changelog_job = m_api.getFileChangelog(m_inst->getManagedPackID().toInt(), version.fileId, response);
+    auto changelog = Net::processJson<QString>(m_changelog_job.get(), response, "Flame::FileChangelog",
+                                               [](const QJsonDocument& doc) { return Json::ensureString(doc.object(), "data"); });
+    QObject::connect(m_changelog_job.get(), &Task::succeeded, this,
+                     [this, changelog] { ui->changelogTextBrowser->setHtml(*changelog); });
+    QObject::connect(m_changelog_job.get(), &Task::failed, this,
+                     [this] { ui->changelogTextBrowser->setHtml(tr("Couldn't get the changelog.")); });
+    m_changelog_job->start();
 
     ManagedPackPage::suggestVersion();
 }
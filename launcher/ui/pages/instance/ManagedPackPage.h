@@ -148,6 +148,7 @@ class FlameManagedPackPage final : public ManagedPackPage {
 
    private:
     NetJob::Ptr m_fetch_job = nullptr;
+    Task::Ptr m_changelog_job = nullptr;
 
     Flame::IndexedPack m_pack;
     FlameAPI m_api;
@@ -39,6 +39,7 @@
 #include "ui_ExternalResourcesPage.h"
 
 #include <QAbstractItemModel>
+#include <QDir>
 #include <QEvent>
 #include <QKeyEvent>
 #include <QMenu>
@@ -219,7 +220,11 @@ void ModFolderPage::updateMods()
         return;
     }
 
-    if (update_dialog.exec()) {
+    // the updates found so far can be downloaded while the other mods are still checked,
+    // those found meanwhile are up for review afterwards
+    bool downloaded = false;
+    while (update_dialog.exec()) {
+        downloaded = true;
         ConcurrentTask* tasks = new ConcurrentTask(this);
         connect(tasks, &Task::failed, [this, tasks](QString reason) {
             CustomMessageBox::selectable(this, tr("Error"), reason, QMessageBox::Critical)->show();
@@ -240,13 +245,19 @@ void ModFolderPage::updateMods()
         for (auto task : update_dialog.getTasks()) {
             tasks->addTask(task);
         }
+        update_dialog.clearReviewed();
 
         ProgressDialog loadDialog(this);
         loadDialog.setSkipButton(true, tr("Abort"));
         loadDialog.execWithTask(tasks);
 
-        m_model->update();
+        if (!update_dialog.waitForChecks() || update_dialog.noUpdates())
+            break;
     }
+
+    // not before, the checks still running look at the mods
+    if (downloaded)
+        m_model->update();
 }
 
 CoreModFolderPage::CoreModFolderPage(BaseInstance* inst, std::shared_ptr<ModFolderModel> mods, QWidget* parent)
@@ -255,22 +266,25 @@ CoreModFolderPage::CoreModFolderPage(BaseInstance* inst, std::shared_ptr<ModFold
 
 bool CoreModFolderPage::shouldDisplay() const
 {
-    if (ModFolderPage::shouldDisplay()) {
-        auto inst = dynamic_cast<MinecraftInstance*>(m_instance);
-        if (!inst)
-            return true;
-
-        auto version = inst->getPackProfile();
-
-        if (!version)
-            return true;
-        if (!version->getComponent("net.minecraftforge"))
-            return false;
-        if (!version->getComponent("net.minecraft"))
-            return false;
-        if (version->getComponent("net.minecraft")->getReleaseDateTime() < g_VersionFilterData.legacyCutoffDate)
-            return true;
-    }
+    return ModFolderPage::shouldDisplay() && shouldDisplayFor(m_instance);
+}
+
+bool CoreModFolderPage::shouldDisplayFor(BaseInstance* base)
+{
+    auto inst = dynamic_cast<MinecraftInstance*>(base);
+    if (!inst)
+        return true;
+
+    auto version = inst->getPackProfile();
+
+    if (!version)
+        return true;
+    if (!version->getComponent("net.minecraftforge"))
+        return false;
+    if (!version->getComponent("net.minecraft"))
+        return false;
+    if (version->getComponent("net.minecraft")->getReleaseDateTime() < g_VersionFilterData.legacyCutoffDate)
+        return true;
     return false;
 }
 
@@ -282,3 +296,9 @@ bool NilModFolderPage::shouldDisplay() const
 {
     return m_model->dir().exists();
 }
+
+bool NilModFolderPage::shouldDisplayFor(MinecraftInstance* inst)
+{
+    // the folder of its model
+    return QDir(inst->nilModsDir()).exists();
+}
@@ -80,6 +80,8 @@ class CoreModFolderPage : public ModFolderPage {
     virtual QString helpPage() const override { return "Core-mods"; }
 
     virtual bool shouldDisplay() const override;
+    /** What shouldDisplay() says for the page of that instance, without the page. */
+    static bool shouldDisplayFor(BaseInstance* inst);
 };
 
 class NilModFolderPage : public ModFolderPage {
@@ -93,4 +95,6 @@ class NilModFolderPage : public ModFolderPage {
     virtual QString helpPage() const override { return "Nilmods"; }
 
     virtual bool shouldDisplay() const override;
+    /** What shouldDisplay() says for the page of that instance, without the page. */
+    static bool shouldDisplayFor(MinecraftInstance* inst);
 };
@@ -42,17 +42,30 @@
 #include "ui/GuiUtil.h"
 
 #include "RecursiveFileSystemWatcher.h"
-#include <GZip.h>
+#include "launch/LogSpool.h"
 #include <FileSystem.h>
 #include <QShortcut>
 
-OtherLogsPage::OtherLogsPage(QString path, IPathMatcher::Ptr fileFilter, QWidget *parent)
-    : QWidget(parent), ui(new Ui::OtherLogsPage), m_path(path), m_fileFilter(fileFilter),
+OtherLogsPage::OtherLogsPage(InstancePtr instance, QString path, IPathMatcher::Ptr fileFilter, QWidget *parent)
+    : QWidget(parent), ui(new Ui::OtherLogsPage), m_instance(instance), m_path(path), m_fileFilter(fileFilter),
       m_watcher(new RecursiveFileSystemWatcher(this))
 {
     ui->setupUi(this);
     ui->tabWidget->tabBar()->hide();
 
+    {
+        QString fontFamily = APPLICATION->settings()->get("ConsoleFont").toString();
+        bool conversionOk = false;
+        int fontSize = APPLICATION->settings()->get("ConsoleFontSize").toInt(&conversionOk);
+        if(!conversionOk)
+        {
+            fontSize = 11;
+        }
+        ui->text->setLogFont(QFont(fontFamily, fontSize));
+    }
+    // only the lines on screen get their level guessed
+    ui->text->setClassifier([instance](const QString& line) { return instance->guessLevel(line, MessageLevel::Message); });
+
     m_watcher->setMatcher(fileFilter);
     m_watcher->setRootDir(QDir::current().absoluteFilePath(m_path));
 
@@ -84,10 +97,16 @@ void OtherLogsPage::retranslate()
 void OtherLogsPage::openedImpl()
 {
     m_watcher->enable();
+    if (!m_currentFile.isEmpty() && !ui->text->spool())
+    {
+        on_btnReload_clicked();
+    }
 }
 void OtherLogsPage::closedImpl()
 {
     m_watcher->disable();
+    // don't keep the log open, the game may want to rename it
+    ui->text->setSpool(nullptr);
 }
 
 void OtherLogsPage::populateSelectLogBox()
@@ -125,7 +144,7 @@ void OtherLogsPage::on_selectLogBox_currentIndexChanged(const int index)
     if (file.isEmpty() || !QFile::exists(FS::PathCombine(m_path, file)))
     {
         m_currentFile = QString();
-        ui->text->clear();
+        ui->text->setSpool(nullptr);
         setControlsEnabled(false);
     }
     else
@@ -143,64 +162,18 @@ void OtherLogsPage::on_btnReload_clicked()
         setControlsEnabled(false);
         return;
     }
-    QFile file(FS::PathCombine(m_path, m_currentFile));
-    if (!file.open(QFile::ReadOnly))
+    // the log is read from disk as it is scrolled through, it can be as big as it wants
+    auto spool = std::make_shared<LogSpool>(QDir("cache/console").absoluteFilePath("other-logs"));
+    if (!spool->load(FS::PathCombine(m_path, m_currentFile)))
     {
+        ui->text->setSpool(nullptr);
         setControlsEnabled(false);
         ui->btnReload->setEnabled(true); // allow reload
+        QMessageBox::critical(this, tr("Error"), tr("Unable to open %1 for reading.").arg(m_currentFile));
         m_currentFile = QString();
-        QMessageBox::critical(this, tr("Error"), tr("Unable to open %1 for reading: %2")
-                                                     .arg(m_currentFile, file.errorString()));
-    }
-    else
-    {
-        auto setPlainText = [&](const QString & text)
-        {
-            QString fontFamily = APPLICATION->settings()->get("ConsoleFont").toString();
-            bool conversionOk = false;
-            int fontSize = APPLICATION->settings()->get("ConsoleFontSize").toInt(&conversionOk);
-            if(!conversionOk)
-            {
-                fontSize = 11;
-            }
-            QTextDocument *doc = ui->text->document();
-            doc->setDefaultFont(QFont(fontFamily, fontSize));
-            ui->text->setPlainText(text);
-        };
-        auto showTooBig = [&]()
-        {
-            setPlainText(
-                tr("The file (%1) is too big. You may want to open it in a viewer optimized "
-                   "for large files.").arg(file.fileName()));
-        };
-        if(file.size() > (1024ll * 1024ll * 12ll))
-        {
-            showTooBig();
-            return;
-        }
-        QString content;
-        if(file.fileName().endsWith(".gz"))
-        {
-            QByteArray temp;
-            if(!GZip::unzip(file.readAll(), temp))
-            {
-                setPlainText(
-                    tr("The file (%1) is not readable.").arg(file.fileName()));
-                return;
-            }
-            content = QString::fromUtf8(temp);
-        }
-        else
-        {
-            content = QString::fromUtf8(file.readAll());
-        }
-        if (content.size() >= 50000000ll)
-        {
-            showTooBig();
-            return;
-        }
-        setPlainText(content);
+        return;
     }
+    ui->text->setSpool(spool);
 }
 
 void OtherLogsPage::on_btnPaste_clicked()
@@ -228,6 +201,8 @@ void OtherLogsPage::on_btnDelete_clicked()
                               QMessageBox::Yes, QMessageBox::No) == QMessageBox::No) {
         return;
     }
+    // the view holds the file open, which would keep it from being deleted on Windows
+    ui->text->setSpool(nullptr);
     QFile file(FS::PathCombine(m_path, m_currentFile));
 
     if (FS::trash(file.fileName()))
@@ -272,6 +247,7 @@ void OtherLogsPage::on_btnClean_clicked()
     {
         return;
     }
+    ui->text->setSpool(nullptr);
     QStringList failed;
     for(auto item: toDelete)
     {
@@ -318,27 +294,21 @@ void OtherLogsPage::setControlsEnabled(const bool enabled)
     ui->btnClean->setEnabled(enabled);
 }
 
-// FIXME: HACK, use LogView instead?
-static void findNext(QPlainTextEdit * _this, const QString& what, bool reverse)
-{
-    _this->find(what, reverse ? QTextDocument::FindFlag::FindBackward : QTextDocument::FindFlag(0));
-}
-
 void OtherLogsPage::on_findButton_clicked()
 {
     auto modifiers = QApplication::keyboardModifiers();
     bool reverse = modifiers & Qt::ShiftModifier;
-    findNext(ui->text, ui->searchBar->text(), reverse);
+    ui->text->findNext(ui->searchBar->text(), reverse);
 }
 
 void OtherLogsPage::findNextActivated()
 {
-    findNext(ui->text, ui->searchBar->text(), false);
+    ui->text->findNext(ui->searchBar->text(), false);
 }
 
 void OtherLogsPage::findPreviousActivated()
 {
-    findNext(ui->text, ui->searchBar->text(), true);
+    ui->text->findNext(ui->searchBar->text(), true);
 }
 
 void OtherLogsPage::findActivated()
@@ -40,6 +40,7 @@
 #include "ui/pages/BasePage.h"
 #include <Application.h>
 #include <pathmatcher/IPathMatcher.h>
+#include "BaseInstance.h"
 
 namespace Ui
 {
@@ -53,7 +54,7 @@ class OtherLogsPage : public QWidget, public BasePage
     Q_OBJECT
 
 public:
-    explicit OtherLogsPage(QString path, IPathMatcher::Ptr fileFilter, QWidget *parent = 0);
+    explicit OtherLogsPage(InstancePtr instance, QString path, IPathMatcher::Ptr fileFilter, QWidget *parent = 0);
     ~OtherLogsPage();
 
     QString id() const override
@@ -96,6 +97,7 @@ private:
 
 private:
     Ui::OtherLogsPage *ui;
+    InstancePtr m_instance;
     QString m_path;
     QString m_currentFile;
     IPathMatcher::Ptr m_fileFilter;
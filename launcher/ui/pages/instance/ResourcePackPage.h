@@ -53,10 +53,12 @@ public:
     QString id() const override { return "resourcepacks"; }
     QString helpPage() const override { return "Resource-packs"; }
 
-    virtual bool shouldDisplay() const override
+    virtual bool shouldDisplay() const override { return shouldDisplayFor(m_instance); }
+    /** What shouldDisplay() says for the page of that instance, without the page. */
+    static bool shouldDisplayFor(BaseInstance *instance)
     {
-        return !m_instance->traits().contains("no-texturepacks") &&
-               !m_instance->traits().contains("texturepacks");
+        return !instance->traits().contains("no-texturepacks") &&
+               !instance->traits().contains("texturepacks");
     }
 
    public slots:
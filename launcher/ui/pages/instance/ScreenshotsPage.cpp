@@ -52,6 +52,9 @@
 #include <QKeyEvent>
 #include <QMenu>
 #include <QRegularExpression>
+#include <QCryptographicHash>
+#include <QImageReader>
+#include <QDebug>
 
 #include <Application.h>
 
@@ -63,11 +66,14 @@
 #include "screenshots/ImgurAlbumCreation.h"
 #include "tasks/SequentialTask.h"
 
-#include "RWStorage.h"
+#include "ConcurrentCache.h"
 #include <FileSystem.h>
 #include <DesktopServices.h>
 
-typedef RWStorage<QString, QIcon> SharedIconCache;
+// the thumbnails that don't fit come back from the disk cache, which is quick enough
+constexpr qint64 s_thumbnail_budget = 64 * 1024 * 1024;
+
+typedef ConcurrentCache<QString, QIcon> SharedIconCache;
 typedef std::shared_ptr<SharedIconCache> SharedIconCachePtr;
 
 class ThumbnailingResult : public QObject
@@ -84,10 +90,11 @@ signals:
 class ThumbnailRunnable : public QRunnable
 {
 public:
-    ThumbnailRunnable(QString path, SharedIconCachePtr cache)
+    ThumbnailRunnable(QString path, SharedIconCachePtr cache, QString diskCache)
     {
         m_path = path;
         m_cache = cache;
+        m_diskCache = diskCache;
     }
     void run()
     {
@@ -101,28 +108,42 @@ public:
         {
             if (!m_cache->stale(m_path))
                 return;
-            QImage image(m_path);
-            if (image.isNull())
+
+            // the same file, as long as it wasn't touched since
+            info.refresh();
+            auto key = QString("%1|%2|%3").arg(info.absoluteFilePath()).arg(info.lastModified().toMSecsSinceEpoch()).arg(info.size());
+            auto cachedPath = FS::PathCombine(m_diskCache, QString::fromLatin1(QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex()) + ".png");
+            QImage square(cachedPath);
+            if (square.isNull())
             {
-                QThread::msleep(500);
-                tries--;
-                continue;
+                // only decode as much as the thumbnail needs
+                QImageReader reader(m_path);
+                auto size = reader.size();
+                if (size.isValid())
+                    reader.setScaledSize(size.scaled(256, 256, Qt::KeepAspectRatio));
+                QImage small = reader.read();
+                if (small.isNull())
+                {
+                    QThread::msleep(500);
+                    tries--;
+                    continue;
+                }
+                if (small.width() > 256 || small.height() > 256)
+                    small = small.scaled(256, 256, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+                QPoint offset((256 - small.width()) / 2, (256 - small.height()) / 2);
+                square = QImage(QSize(256, 256), QImage::Format_ARGB32);
+                square.fill(Qt::transparent);
+
+                QPainter painter(&square);
+                painter.drawImage(offset, small);
+                painter.end();
+
+                FS::ensureFolderPathExists(m_diskCache);
+                square.save(cachedPath, "PNG");
             }
-            QImage small;
-            if (image.width() > image.height())
-                small = image.scaledToWidth(512).scaledToWidth(256, Qt::SmoothTransformation);
-            else
-                small = image.scaledToHeight(512).scaledToHeight(256, Qt::SmoothTransformation);
-            QPoint offset((256 - small.width()) / 2, (256 - small.height()) / 2);
-            QImage square(QSize(256, 256), QImage::Format_ARGB32);
-            square.fill(Qt::transparent);
-
-            QPainter painter(&square);
-            painter.drawImage(offset, small);
-            painter.end();
 
             QIcon icon(QPixmap::fromImage(square));
-            m_cache->add(m_path, icon);
+            m_cache->insert(m_path, icon, square.sizeInBytes());
             m_resultEmitter.emitResultsReady(m_path);
             return;
         }
@@ -130,6 +151,7 @@ public:
     }
     QString m_path;
     SharedIconCachePtr m_cache;
+    QString m_diskCache;
     ThumbnailingResult m_resultEmitter;
 };
 
@@ -142,12 +164,19 @@ public:
     explicit FilterModel(QObject *parent = 0) : QIdentityProxyModel(parent)
     {
         m_thumbnailingPool.setMaxThreadCount(4);
-        m_thumbnailCache = std::make_shared<SharedIconCache>();
-        m_thumbnailCache->add("placeholder", APPLICATION->getThemedIcon("screenshot-placeholder"));
+        m_thumbnailCache = std::make_shared<SharedIconCache>(s_thumbnail_budget);
+        m_diskCache = QDir("cache/screenshot_thumbnails").absolutePath();
+        m_placeholder = APPLICATION->getThemedIcon("screenshot-placeholder");
         connect(&watcher, SIGNAL(fileChanged(QString)), SLOT(fileChanged(QString)));
         // FIXME: the watched file set is not updated when files are removed
     }
-    virtual ~FilterModel() { m_thumbnailingPool.waitForDone(500); }
+    virtual ~FilterModel()
+    {
+        m_thumbnailingPool.waitForDone(500);
+        auto stats = m_thumbnailCache->stats();
+        qDebug() << "Screenshot thumbnails:" << stats.hits << "hits," << stats.misses << "misses," << stats.count << "kept in"
+                 << stats.bytes << "bytes";
+    }
     virtual QVariant data(const QModelIndex &proxyIndex, int role = Qt::DisplayRole) const
     {
         auto model = sourceModel();
@@ -169,7 +198,7 @@ public:
                 ((QFileSystemWatcher &)watcher).addPath(filePath);
                 ((QSet<QString> &)watched).insert(filePath);
             }
-            if (m_thumbnailCache->get(filePath, temp))
+            if (m_thumbnailCache->find(filePath, &temp))
             {
                 return temp;
             }
@@ -177,7 +206,7 @@ public:
             {
                 ((FilterModel *)this)->thumbnailImage(filePath);
             }
-            return (m_thumbnailCache->get("placeholder"));
+            return m_placeholder;
         }
         return sourceModel()->data(mapToSource(proxyIndex), role);
     }
@@ -201,19 +230,40 @@ public:
 private:
     void thumbnailImage(QString path)
     {
-        auto runnable = new ThumbnailRunnable(path, m_thumbnailCache);
+        // The thumbnails asked for last are the ones that get painted, after the whole list was laid out,
+        // so they go first. Asking again for one that didn't start yet moves it up.
+        int priority = m_nextPriority++;
+        auto pending = m_pending.value(path);
+        if (pending)
+        {
+            if (!m_thumbnailingPool.tryTake(pending))
+                return;
+            m_thumbnailingPool.start(pending, priority);
+            return;
+        }
+        auto runnable = new ThumbnailRunnable(path, m_thumbnailCache, m_diskCache);
         connect(&(runnable->m_resultEmitter), SIGNAL(resultsReady(QString)),
                 SLOT(thumbnailReady(QString)));
         connect(&(runnable->m_resultEmitter), SIGNAL(resultsFailed(QString)),
                 SLOT(thumbnailFailed(QString)));
-        ((QThreadPool &)m_thumbnailingPool).start(runnable);
+        m_pending.insert(path, runnable);
+        m_thumbnailingPool.start(runnable, priority);
     }
 private slots:
-    void thumbnailReady(QString path) { emit layoutChanged(); }
-    void thumbnailFailed(QString path) { m_failed.insert(path); }
+    void thumbnailReady(QString path)
+    {
+        m_pending.remove(path);
+        emit layoutChanged();
+    }
+    void thumbnailFailed(QString path)
+    {
+        m_pending.remove(path);
+        m_failed.insert(path);
+    }
     void fileChanged(QString filepath)
     {
         m_thumbnailCache->setStale(filepath);
+        m_pending.remove(filepath);
         thumbnailImage(filepath);
         // reinsert the path...
         watcher.removePath(filepath);
@@ -222,7 +272,12 @@ private slots:
 
 private:
     SharedIconCachePtr m_thumbnailCache;
+    QIcon m_placeholder;
+    QString m_diskCache;
     QThreadPool m_thumbnailingPool;
+    // path -> the thumbnail job that may still be waiting for a thread
+    QHash<QString, QRunnable *> m_pending;
+    int m_nextPriority = 0;
     QSet<QString> m_failed;
     QSet<QString> watched;
     QFileSystemWatcher watcher;
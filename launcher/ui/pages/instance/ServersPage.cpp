@@ -47,12 +47,14 @@
 #include <tag_list.h>
 #include <tag_compound.h>
 #include <minecraft/MinecraftInstance.h>
+#include <minecraft/ServerPing.h>
+#include <tasks/ConcurrentTask.h>
 
 #include <QFileSystemWatcher>
 #include <QMenu>
 #include <QTimer>
 
-static const int COLUMN_COUNT = 2; // 3 , TBD: latency and other nice things.
+static const int COLUMN_COUNT = 4;
 
 struct Server
 {
@@ -193,8 +195,18 @@ public:
         m_saveTimer.setSingleShot(true);
         m_saveTimer.setInterval(5000);
         connect(&m_saveTimer, &QTimer::timeout, this, &ServersModel::save_internal);
+        // waits for the address to be typed out before pinging it
+        m_statusTimer.setSingleShot(true);
+        m_statusTimer.setInterval(1000);
+        connect(&m_statusTimer, &QTimer::timeout, this, &ServersModel::updateStatus);
     }
-    virtual ~ServersModel() {};
+    virtual ~ServersModel()
+    {
+        if(m_pingTask && m_pingTask->isRunning())
+        {
+            m_pingTask->abort();
+        }
+    };
 
     void observe()
     {
@@ -208,6 +220,10 @@ public:
         {
             load();
         }
+        else
+        {
+            updateStatus();
+        }
 
         updateFSObserver();
     }
@@ -220,6 +236,12 @@ public:
         }
         m_observed = false;
 
+        m_statusTimer.stop();
+        if(m_pingTask && m_pingTask->isRunning())
+        {
+            m_pingTask->abort();
+        }
+
         updateFSObserver();
     }
 
@@ -338,6 +360,8 @@ public:
                     return tr("Address");
                 case 2:
                     return tr("Latency");
+                case 3:
+                    return tr("Players");
             }
         }
 
@@ -357,6 +381,12 @@ public:
         if (row < 0 || row >= m_servers.size())
             return QVariant();
 
+        auto & server = m_servers[row];
+        if(role == Qt::ToolTipRole && server.m_checked && server.m_up)
+        {
+            return server.m_motd;
+        }
+
         switch(column)
         {
             case 0:
@@ -392,7 +422,21 @@ public:
                 switch (role)
                 {
                 case Qt::DisplayRole:
-                    return m_servers[row].m_ping;
+                    if(!server.m_checked)
+                        return server.m_address.trimmed().isEmpty() ? QString() : tr("Pinging...");
+                    if(!server.m_up)
+                        return tr("Offline");
+                    return tr("%1 ms").arg(server.m_ping);
+                default:
+                    return QVariant();
+                }
+            case 3:
+                switch (role)
+                {
+                case Qt::DisplayRole:
+                    if(!server.m_checked || !server.m_up)
+                        return QVariant();
+                    return QString("%1/%2").arg(server.m_currentPlayers).arg(server.m_maxPlayers);
                 default:
                     return QVariant();
                 }
@@ -447,8 +491,10 @@ public:
             return;
         }
         server->m_address = address;
+        server->m_checked = false;
         emit dataChanged(index(row, 0), index(row, COLUMN_COUNT - 1));
         scheduleSave();
+        m_statusTimer.start();
     }
 
     void setAcceptsTextures(int row, Server::AcceptsTextures textures)
@@ -486,6 +532,7 @@ public:
         m_servers.swap(servers);
         m_loaded = true;
         endResetModel();
+        updateStatus();
     }
 
     void saveNow()
@@ -498,6 +545,43 @@ public:
 
 
 public slots:
+    /** Pings every server that wasn't pinged recently, a few at a time, and shows what the others said before. */
+    void updateStatus()
+    {
+        if(m_pingTask && m_pingTask->isRunning())
+        {
+            m_pingTask->abort();
+        }
+        m_pingTask.reset(new ConcurrentTask(nullptr, "Server pings", 8));
+
+        QSet<QString> pinging;
+        for(auto & server : m_servers)
+        {
+            auto address = server.m_address.trimmed();
+            if(address.isEmpty())
+            {
+                continue;
+            }
+            if(auto status = ServerStatusCache::status(address))
+            {
+                applyStatus(address, status);
+                continue;
+            }
+            // the same server can be in the list more than once
+            if(pinging.contains(address.toLower()))
+            {
+                continue;
+            }
+            pinging.insert(address.toLower());
+            auto ping = makeShared<ServerPing>(address);
+            // not when aborted, that says nothing about the server
+            connect(ping.get(), &Task::succeeded, this, [this, ping = ping.get()] { applyStatus(ping->address(), ping->status()); });
+            connect(ping.get(), &Task::failed, this, [this, address] { applyStatus(address, std::nullopt); });
+            m_pingTask->addTask(ping);
+        }
+        m_pingTask->start();
+    }
+
     void dirChanged(const QString& path)
     {
         qDebug() << "Changed:" << path;
@@ -533,6 +617,28 @@ private slots:
     }
 
 private:
+    void applyStatus(const QString & address, const std::optional<ServerStatus> & status)
+    {
+        for(int row = 0; row < m_servers.size(); row++)
+        {
+            auto & server = m_servers[row];
+            if(server.m_address.trimmed().compare(address, Qt::CaseInsensitive) != 0)
+            {
+                continue;
+            }
+            server.m_checked = true;
+            server.m_up = status.has_value();
+            if(status)
+            {
+                server.m_ping = status->latency;
+                server.m_currentPlayers = status->currentPlayers;
+                server.m_maxPlayers = status->maxPlayers;
+                server.m_motd = status->motd;
+            }
+            emit dataChanged(index(row, 0), index(row, COLUMN_COUNT - 1));
+        }
+    }
+
     void scheduleSave()
     {
         if(!m_loaded)
@@ -601,6 +707,8 @@ private:
     QList<Server> m_servers;
     QFileSystemWatcher *m_watcher = nullptr;
     QTimer m_saveTimer;
+    QTimer m_statusTimer;
+    ConcurrentTask::Ptr m_pingTask;
 };
 
 ServersPage::ServersPage(InstancePtr inst, QWidget* parent)
@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "TelemetryPage.h"
+
+#include <QFileInfo>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLocale>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "launch/LaunchHistory.h"
+
+namespace {
+QString mebibytes(qint64 bytes)
+{
+    return QString("%1 MiB").arg(bytes / (1024 * 1024));
+}
+
+QString seconds(qint64 ms)
+{
+    return QString::number(ms / 1000.0, 'f', 1) + " s";
+}
+}  // namespace
+
+TelemetryPage::TelemetryPage(InstancePtr instance, QWidget* parent) : QWidget(parent), m_instance(instance)
+{
+    auto layout = new QVBoxLayout(this);
+
+    m_liveLabel = new QLabel(this);
+    m_liveLabel->setWordWrap(true);
+    m_liveLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(m_liveLabel);
+
+    m_phases = new QTreeWidget(this);
+    m_phases->setRootIsDecorated(false);
+    m_phases->setColumnCount(2);
+    layout->addWidget(m_phases, 1);
+
+    m_historyLabel = new QLabel(this);
+    layout->addWidget(m_historyLabel);
+
+    m_history = new QTreeWidget(this);
+    m_history->setRootIsDecorated(false);
+    m_history->setColumnCount(9);
+    m_history->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    layout->addWidget(m_history, 2);
+
+    retranslate();
+
+    auto launchTask = m_instance->getLaunchTask();
+    if (launchTask)
+        onInstanceLaunchTaskChanged(launchTask);
+    else
+        updateLive();
+    connect(m_instance.get(), &BaseInstance::launchTaskChanged, this, &TelemetryPage::onInstanceLaunchTaskChanged);
+}
+
+bool TelemetryPage::shouldDisplay() const
+{
+    return m_instance->isRunning() || m_telemetry || QFileInfo::exists(historyFile());
+}
+
+void TelemetryPage::retranslate()
+{
+    m_phases->setHeaderLabels({ tr("Startup phase"), tr("Since the JVM started") });
+    m_history->setHeaderLabels({ tr("Started"), tr("Until Java ran"), tr("Until the window opened"), tr("Java"), tr("Mods"),
+                                 tr("Result"), tr("Peak heap"), tr("Collections"), tr("Longest average collection") });
+    updateLive();
+    updateHistory();
+}
+
+QString TelemetryPage::historyFile() const
+{
+    return LaunchHistory::file(m_instance->instanceRoot());
+}
+
+void TelemetryPage::onInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> task)
+{
+    if (m_telemetry)
+        disconnect(m_telemetry.get(), nullptr, this, nullptr);
+
+    if (task) {
+        m_telemetry = task->getTelemetry();
+        connect(m_telemetry.get(), &LaunchTelemetry::changed, this, &TelemetryPage::updateLive);
+        // the summary of the launch is in the history once it's done
+        connect(task.get(), &LaunchTask::finished, this, &TelemetryPage::updateHistory);
+    } else {
+        m_telemetry.reset();
+    }
+    updateLive();
+    updateHistory();
+}
+
+void TelemetryPage::updateLive()
+{
+    m_phases->clear();
+    if (!m_telemetry || m_telemetry->isEmpty()) {
+        m_liveLabel->setText(tr("Nothing was reported by the game yet. Its heap and collections show up here while it runs."));
+        return;
+    }
+
+    for (auto& phase : m_telemetry->phases())
+        new QTreeWidgetItem(m_phases, { phase.name, seconds(phase.uptime) });
+
+    auto& summary = m_telemetry->summary();
+    if (m_telemetry->samples().isEmpty()) {
+        m_liveLabel->setText(tr("Waiting for the first report of the heap."));
+        return;
+    }
+    auto& sample = m_telemetry->samples().last();
+    m_liveLabel->setText(tr("Heap: %1 used of %2 committed, at most %3. Peak: %4.\n"
+                            "Collections: %5, taking %6 in total, the longest %7 ms on average.")
+                             .arg(mebibytes(sample.heapUsed), mebibytes(sample.heapCommitted), mebibytes(sample.heapMax),
+                                  mebibytes(summary.peakHeap))
+                             .arg(summary.gcCount)
+                             .arg(seconds(summary.gcTime))
+                             .arg(summary.longestGcPause));
+}
+
+void TelemetryPage::updateHistory()
+{
+    m_history->clear();
+    auto records = LaunchHistory::load(historyFile());
+    // the most recent first
+    for (int i = records.size() - 1; i >= 0; i--) {
+        auto& record = records[i];
+        auto& telemetry = record.telemetry;
+        QString result;
+        if (!record.crashed)
+            result = tr("Exited");
+        else if (record.exitCode >= 0)
+            result = tr("Crashed (%1)").arg(record.exitCode);
+        else
+            result = tr("Crashed");
+
+        auto item = new QTreeWidgetItem(
+            m_history, { QLocale().toString(record.started, QLocale::ShortFormat), record.spawnTime >= 0 ? seconds(record.spawnTime) : QString("-"),
+                         record.windowTime >= 0 ? seconds(record.windowTime) : QString("-"), record.javaVersion, QString::number(record.mods), result,
+                         telemetry.peakHeap ? mebibytes(telemetry.peakHeap) : QString("-"),
+                         telemetry.gcCount ? tr("%1 in %2").arg(telemetry.gcCount).arg(seconds(telemetry.gcTime)) : QString("-"),
+                         telemetry.gcCount ? QString("%1 ms").arg(telemetry.longestGcPause) : QString("-") });
+        item->setToolTip(0, record.javaArguments.join(' '));
+    }
+
+    QStringList trends;
+    auto window = LaunchHistory::change(records, [](const LaunchHistory::Record& record) { return record.windowTime; });
+    auto heap = LaunchHistory::change(records, [](const LaunchHistory::Record& record) { return record.telemetry.peakHeap; });
+    // smaller changes are mostly noise
+    if (qAbs(window) >= 0.1)
+        trends << (window > 0 ? tr("The window took %1% longer to open than in the launches before.")
+                              : tr("The window took %1% less time to open than in the launches before."))
+                      .arg(qRound(qAbs(window) * 100));
+    if (qAbs(heap) >= 0.1)
+        trends << (heap > 0 ? tr("The game needed %1% more heap than in the launches before.")
+                            : tr("The game needed %1% less heap than in the launches before."))
+                      .arg(qRound(qAbs(heap) * 100));
+    m_historyLabel->setText(trends.isEmpty() ? tr("Earlier launches:") : tr("Earlier launches: %1").arg(trends.join(' ')));
+}
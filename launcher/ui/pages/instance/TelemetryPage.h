@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QWidget>
+
+#include "Application.h"
+#include "BaseInstance.h"
+#include "launch/LaunchTask.h"
+#include "ui/pages/BasePage.h"
+
+class QLabel;
+class QTreeWidget;
+
+/* What the launcher part tells about the game while it runs: how long the startup took, the heap and the collections,
+ * and the summaries of the earlier launches of the instance to compare with. */
+class TelemetryPage : public QWidget, public BasePage {
+    Q_OBJECT
+
+   public:
+    explicit TelemetryPage(InstancePtr instance, QWidget* parent = nullptr);
+
+    QString displayName() const override { return tr("Performance"); }
+    QIcon icon() const override { return APPLICATION->getThemedIcon("java"); }
+    QString id() const override { return "telemetry"; }
+    QString helpPage() const override { return "Minecraft-Logs"; }
+    bool shouldDisplay() const override;
+    void retranslate() override;
+
+   private slots:
+    void onInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> task);
+    void updateLive();
+
+   private:
+    void updateHistory();
+    QString historyFile() const;
+
+    InstancePtr m_instance;
+    shared_qobject_ptr<LaunchTelemetry> m_telemetry;
+
+    QLabel* m_liveLabel;
+    QTreeWidget* m_phases;
+    QLabel* m_historyLabel;
+    QTreeWidget* m_history;
+};
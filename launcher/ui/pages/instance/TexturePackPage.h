@@ -53,9 +53,11 @@ public:
     QString id() const override { return "texturepacks"; }
     QString helpPage() const override { return "Texture-packs"; }
 
-    virtual bool shouldDisplay() const override
+    virtual bool shouldDisplay() const override { return shouldDisplayFor(m_instance); }
+    /** What shouldDisplay() says for the page of that instance, without the page. */
+    static bool shouldDisplayFor(BaseInstance *instance)
     {
-        return m_instance->traits().contains("texturepacks");
+        return instance->traits().contains("texturepacks");
     }
 
    public slots:
@@ -39,6 +39,7 @@
 #include "ui/dialogs/CustomMessageBox.h"
 #include "ui_WorldListPage.h"
 #include "minecraft/WorldList.h"
+#include "minecraft/WorldSnapshots.h"
 
 #include <QEvent>
 #include <QMenu>
@@ -48,12 +49,15 @@
 #include <QSortFilterProxyModel>
 #include <QTreeView>
 #include <QInputDialog>
+#include <QLocale>
 #include <Qt>
 
 #include "tools/MCEditTool.h"
 #include "FileSystem.h"
+#include "StringUtils.h"
 
 #include "ui/GuiUtil.h"
+#include "ui/dialogs/ProgressDialog.h"
 #include "DesktopServices.h"
 
 #include "Application.h"
@@ -111,6 +115,13 @@ WorldListPage::WorldListPage(BaseInstance *inst, std::shared_ptr<WorldList> worl
 
     connect(ui->worldTreeView->selectionModel(), &QItemSelectionModel::currentChanged, this, &WorldListPage::worldChanged);
     worldChanged(QModelIndex(), QModelIndex());
+
+    auto minecraftInstance = dynamic_cast<MinecraftInstance *>(m_inst);
+    ui->actionSnapshot_On_Exit->setVisible(minecraftInstance != nullptr);
+    if (minecraftInstance)
+    {
+        ui->actionSnapshot_On_Exit->setChecked(m_inst->settings()->get("WorldSnapshotsOnExit").toBool());
+    }
 }
 
 void WorldListPage::openedImpl()
@@ -364,6 +375,9 @@ void WorldListPage::worldChanged(const QModelIndex &current, const QModelIndex &
     ui->actionDatapacks->setEnabled(enable);
     bool hasIcon = !index.data(WorldList::IconFileRole).isNull();
     ui->actionReset_Icon->setEnabled(enable && hasIcon);
+    bool canSnapshot = enable && dynamic_cast<MinecraftInstance *>(m_inst);
+    ui->actionSnapshot->setEnabled(canSnapshot);
+    ui->actionRestore_Snapshot->setEnabled(canSnapshot);
 }
 
 void WorldListPage::on_actionAdd_triggered()
@@ -447,6 +461,97 @@ void WorldListPage::on_actionRename_triggered()
     }
 }
 
+void WorldListPage::on_actionSnapshot_triggered()
+{
+    QModelIndex index = getSelectedWorld();
+    auto minecraftInstance = dynamic_cast<MinecraftInstance *>(m_inst);
+    if (!index.isValid() || !minecraftInstance)
+    {
+        return;
+    }
+
+    if(!worldSafetyNagQuestion(tr("Snapshot World")))
+        return;
+
+    auto path = m_worlds->data(index, WorldList::FolderRole).toString();
+    WorldSnapshotTask task(minecraftInstance->worldSnapshotsDir(), { path }, m_inst->settings()->get("WorldSnapshotsToKeep").toInt());
+    ProgressDialog dialog(this);
+    dialog.execWithTask(&task);
+
+    if (!task.wasSuccessful())
+    {
+        CustomMessageBox::selectable(this, tr("Snapshot failed"), task.failReason(), QMessageBox::Critical)->show();
+    }
+    else if (task.taken() == 0)
+    {
+        CustomMessageBox::selectable(this, tr("Snapshot World"), tr("The world didn't change since its last snapshot."), QMessageBox::Information)->show();
+    }
+}
+
+void WorldListPage::on_actionRestore_Snapshot_triggered()
+{
+    QModelIndex index = getSelectedWorld();
+    auto minecraftInstance = dynamic_cast<MinecraftInstance *>(m_inst);
+    if (!index.isValid() || !minecraftInstance)
+    {
+        return;
+    }
+
+    auto worldVariant = m_worlds->data(index, WorldList::ObjectRole);
+    auto world = (World *) worldVariant.value<void *>();
+    auto root = minecraftInstance->worldSnapshotsDir();
+    auto snapshots = WorldSnapshots(root).list(world->folderName());
+    if (snapshots.isEmpty())
+    {
+        CustomMessageBox::selectable(this, tr("Restore Snapshot"), tr("The world has no snapshots yet."), QMessageBox::Information)->show();
+        return;
+    }
+
+    QStringList items;
+    for (auto &snapshot : snapshots)
+    {
+        // with the seconds, so two snapshots don't read the same
+        items.append(tr("%1 (%2)").arg(QLocale().toString(snapshot.created.toLocalTime(), "yyyy-MM-dd HH:mm:ss"),
+                                      StringUtils::humanReadableFileSize(snapshot.size)));
+    }
+    bool ok = false;
+    auto item = QInputDialog::getItem(this, tr("Restore Snapshot"), tr("Choose the snapshot to put \"%1\" back to.").arg(world->name()), items, 0, false, &ok);
+    if (!ok)
+        return;
+    auto &snapshot = snapshots.at(items.indexOf(item));
+
+    auto result = CustomMessageBox::selectable(this, tr("Restore Snapshot"),
+                                               tr("\"%1\" will be put back as it was on %2.\n"
+                                                  "A snapshot of the world as it is now is taken first, so it can be restored too.\n\n"
+                                                  "Do you want to continue?")
+                                                   .arg(world->name(), QLocale().toString(snapshot.created.toLocalTime(), QLocale::ShortFormat)),
+                                               QMessageBox::Question, QMessageBox::Yes | QMessageBox::No, QMessageBox::No)
+                      ->exec();
+    if (result != QMessageBox::Yes)
+        return;
+
+    if(!worldSafetyNagQuestion(tr("Restore Snapshot")))
+        return;
+
+    auto path = m_worlds->data(index, WorldList::FolderRole).toString();
+    WorldRestoreTask task(root, path, snapshot.id, m_inst->settings()->get("WorldSnapshotsToKeep").toInt());
+    m_worlds->stopWatching();
+    ProgressDialog dialog(this);
+    dialog.execWithTask(&task);
+    m_worlds->startWatching();
+    m_worlds->update();
+
+    if (!task.wasSuccessful())
+    {
+        CustomMessageBox::selectable(this, tr("Restore failed"), task.failReason(), QMessageBox::Critical)->show();
+    }
+}
+
+void WorldListPage::on_actionSnapshot_On_Exit_toggled(bool checked)
+{
+    m_inst->settings()->set("WorldSnapshotsOnExit", checked);
+}
+
 void WorldListPage::on_actionRefresh_triggered()
 {
     m_worlds->update();
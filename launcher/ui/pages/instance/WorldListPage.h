@@ -117,6 +117,9 @@ private slots:
     void on_actionView_Folder_triggered();
     void on_actionDatapacks_triggered();
     void on_actionReset_Icon_triggered();
+    void on_actionSnapshot_triggered();
+    void on_actionRestore_Snapshot_triggered();
+    void on_actionSnapshot_On_Exit_toggled(bool checked);
     void worldChanged(const QModelIndex &current, const QModelIndex &previous);
     void mceditState(LoggedProcess::State state);
 
@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ResourceIconLoader.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QImageReader>
+#include <QPixmapCache>
+#include <QtConcurrent>
+
+#include "Application.h"
+#include "Executors.h"
+#include "FileSystem.h"
+
+namespace ResourceDownload {
+
+// the logos are shown at 48x48, this leaves some room for the scaling done by the delegate
+static const QSize s_icon_size(64, 64);
+// how many logos get downloaded or scaled at once
+static const int s_max_running = 6;
+
+ResourceIconLoader::ResourceIconLoader(QString meta_entry_base, QObject* parent)
+    : QObject(parent), m_meta_entry_base(meta_entry_base), m_thumbnail_dir(QDir("cache/resource_logos").absolutePath())
+{}
+
+std::optional<QIcon> ResourceIconLoader::icon(const QUrl& url, int row)
+{
+    QPixmap pixmap;
+    if (QPixmapCache::find(url.toString(), &pixmap))
+        return { pixmap };
+
+    if (!url.isValid() || m_failed.contains(url))
+        return {};
+
+    auto request = m_requests.find(url);
+    if (request != m_requests.end()) {
+        request->row = row;
+        if (!request->started) {
+            m_queue.removeOne(url);
+            m_queue.append(url);
+        }
+        return {};
+    }
+
+    Request new_request;
+    new_request.row = row;
+    m_requests.insert(url, new_request);
+    m_queue.append(url);
+
+    // this gets called while painting, don't start anything from there
+    QMetaObject::invokeMethod(this, &ResourceIconLoader::startNext, Qt::QueuedConnection);
+    return {};
+}
+
+void ResourceIconLoader::setVisibleRows(int first, int last)
+{
+    m_visible_known = true;
+    m_first_visible = first;
+    m_last_visible = last;
+
+    QList<NetJob::Ptr> hidden;
+    for (auto& request : m_requests) {
+        if (request.job && !isVisible(request.row))
+            hidden.append(request.job);
+    }
+    // aborting removes the requests, so it can't be done while going through them
+    for (auto& job : hidden)
+        job->abort();
+
+    startNext();
+}
+
+void ResourceIconLoader::clear()
+{
+    for (auto& request : m_requests)
+        request.row = -1;
+    for (auto& url : m_queue)
+        m_requests.remove(url);
+    m_queue.clear();
+    m_visible_known = false;
+
+    QList<NetJob::Ptr> jobs;
+    for (auto& request : m_requests) {
+        if (request.job)
+            jobs.append(request.job);
+    }
+    for (auto& job : jobs)
+        job->abort();
+}
+
+bool ResourceIconLoader::isVisible(int row) const
+{
+    if (row < 0)
+        return false;
+    return !m_visible_known || (row >= m_first_visible && row <= m_last_visible);
+}
+
+void ResourceIconLoader::startNext()
+{
+    while (m_running < s_max_running && !m_queue.isEmpty()) {
+        auto url = m_queue.takeLast();
+        auto& request = m_requests[url];
+        if (!isVisible(request.row)) {
+            // it'll be asked for again if it gets painted
+            m_requests.remove(url);
+            continue;
+        }
+
+        request.started = true;
+        m_running++;
+
+        auto thumbnail = thumbnailPath(url);
+        if (QFileInfo::exists(thumbnail))
+            scale(url, thumbnail, false);
+        else
+            download(url);
+    }
+}
+
+void ResourceIconLoader::download(const QUrl& url)
+{
+    auto entry = APPLICATION->metacache()->resolveEntry(
+        m_meta_entry_base, QString("logos/%1").arg(QString(QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1).toHex())));
+    auto path = entry->getFullPath();
+
+    auto job = makeShared<NetJob>(QString("Logo %1").arg(url.toString()), APPLICATION->network());
+    job->setPriority(Net::Priority::Interactive);
+    job->addNetAction(Net::Download::makeCached(url, entry));
+
+    connect(job.get(), &Task::succeeded, this, [this, url, path] {
+        m_requests[url].job.reset();
+        scale(url, path, true);
+    });
+    connect(job.get(), &Task::failed, this, [this, url](QString reason) {
+        if (!m_requests.contains(url))
+            return;
+        qDebug() << "Couldn't download the logo at" << url << ":" << reason;
+        m_failed.insert(url);
+        done(url);
+    });
+    connect(job.get(), &Task::aborted, this, [this, url] { done(url); });
+
+    m_requests[url].job = job;
+    job->start();
+}
+
+void ResourceIconLoader::scale(const QUrl& url, const QString& source, bool keep)
+{
+    auto thumbnail = thumbnailPath(url);
+    auto thumbnail_dir = m_thumbnail_dir;
+    auto future = QtConcurrent::run(Executors::background(), [source, thumbnail, thumbnail_dir, keep] {
+        QImageReader reader(source);
+        auto size = reader.size();
+        if (size.isValid() && (size.width() > s_icon_size.width() || size.height() > s_icon_size.height()))
+            reader.setScaledSize(size.scaled(s_icon_size, Qt::KeepAspectRatio));
+        auto image = reader.read();
+        if (image.isNull())
+            return image;
+
+        // the handler may not support reading at a smaller size
+        if (image.width() > s_icon_size.width() || image.height() > s_icon_size.height())
+            image = image.scaled(s_icon_size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+        if (keep && FS::ensureFolderPathExists(thumbnail_dir))
+            image.save(thumbnail, "PNG");
+        return image;
+    });
+
+    // goes away with this, so nothing comes back once the loader is gone
+    auto watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, url, keep] {
+        auto image = watcher->result();
+        watcher->deleteLater();
+
+        if (image.isNull()) {
+            if (keep) {
+                qDebug() << "The logo at" << url << "isn't an image we can read";
+                m_failed.insert(url);
+            } else {
+                // a broken thumbnail, get the logo again
+                QFile::remove(thumbnailPath(url));
+            }
+            done(url);
+            return;
+        }
+
+        QPixmapCache::insert(url.toString(), QPixmap::fromImage(image));
+        done(url);
+        emit iconLoaded(url);
+    });
+    watcher->setFuture(future);
+}
+
+void ResourceIconLoader::done(const QUrl& url)
+{
+    // aborting can end a job more than once
+    if (!m_requests.remove(url))
+        return;
+    m_running--;
+    startNext();
+}
+
+QString ResourceIconLoader::thumbnailPath(const QUrl& url) const
+{
+    auto hash = QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1).toHex();
+    return FS::PathCombine(m_thumbnail_dir, QString::fromLatin1(hash) + ".png");
+}
+
+}  // namespace ResourceDownload
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QIcon>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QUrl>
+#include <optional>
+
+#include "net/NetJob.h"
+
+namespace ResourceDownload {
+
+/* Fetches the logos of the projects listed by a ResourceModel.
+ *
+ * Only the logos of the rows on screen are fetched, the most recently asked for first. Requests for rows that
+ * were scrolled away are dropped, or aborted if they already started, and are made again once the rows are back.
+ * The logos are scaled down on the global thread pool, and the small versions are kept in their own cache
+ * folder, so a logo is only ever decoded at full size once.
+ */
+class ResourceIconLoader : public QObject {
+    Q_OBJECT
+   public:
+    /** `meta_entry_base` is the metacache base the full size logos are downloaded to. */
+    explicit ResourceIconLoader(QString meta_entry_base, QObject* parent = nullptr);
+    ~ResourceIconLoader() override = default;
+
+    /** The logo at the URL, for the given row. If it's not there yet, it's fetched and iconLoaded() is emitted once it is. */
+    std::optional<QIcon> icon(const QUrl& url, int row);
+
+    /** The rows the view shows right now. Until this is called, all the rows are. */
+    void setVisibleRows(int first, int last);
+
+    /** Forgets about the rows, for when the model is reset. The logos that were already fetched stay around. */
+    void clear();
+
+   signals:
+    void iconLoaded(const QUrl& url);
+
+   private:
+    struct Request {
+        int row = -1;
+        NetJob::Ptr job;
+        bool started = false;
+    };
+
+    bool isVisible(int row) const;
+    void startNext();
+    void download(const QUrl& url);
+    void scale(const QUrl& url, const QString& source, bool keep);
+    void done(const QUrl& url);
+    QString thumbnailPath(const QUrl& url) const;
+
+   private:
+    QString m_meta_entry_base;
+    QString m_thumbnail_dir;
+
+    QHash<QUrl, Request> m_requests;
+    // the requests that didn't start yet, the most recent last
+    QList<QUrl> m_queue;
+    QSet<QUrl> m_failed;
+    int m_running = 0;
+
+    bool m_visible_known = false;
+    int m_first_visible = 0;
+    int m_last_visible = 0;
+};
+
+}  // namespace ResourceDownload
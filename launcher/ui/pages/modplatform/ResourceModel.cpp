@@ -20,6 +20,8 @@
 #include "net/Download.h"
 #include "net/NetJob.h"
 
+#include "ResourceIconLoader.h"
+
 #include "modplatform/ModIndex.h"
 
 #include "ui/widgets/ProjectItem.h"
@@ -227,6 +229,8 @@ void ResourceModel::clearData()
 {
     beginResetModel();
     m_packs.clear();
+    if (m_icon_loader)
+        m_icon_loader->clear();
     endResetModel();
 }
 
@@ -263,44 +267,27 @@ std::optional<ResourceAPI::SortingMethod> ResourceModel::getCurrentSortingMethod
 
 std::optional<QIcon> ResourceModel::getIcon(QModelIndex& index, const QUrl& url)
 {
-    QPixmap pixmap;
-    if (QPixmapCache::find(url.toString(), &pixmap))
-        return { pixmap };
-
-    if (!m_current_icon_job)
-        m_current_icon_job.reset(new NetJob("IconJob", APPLICATION->network()));
-
-    if (m_currently_running_icon_actions.contains(url))
-        return {};
-    if (m_failed_icon_actions.contains(url))
-        return {};
-
-    auto cache_entry = APPLICATION->metacache()->resolveEntry(
-        metaEntryBase(),
-        QString("logos/%1").arg(QString(QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Algorithm::Sha1).toHex())));
-    auto icon_fetch_action = Net::Download::makeCached(url, cache_entry);
-
-    auto full_file_path = cache_entry->getFullPath();
-    connect(icon_fetch_action.get(), &NetAction::succeeded, this, [=] {
-        auto icon = QIcon(full_file_path);
-        QPixmapCache::insert(url.toString(), icon.pixmap(icon.actualSize({ 64, 64 })));
-
-        m_currently_running_icon_actions.remove(url);
-
-        emit dataChanged(index, index, { Qt::DecorationRole });
-    });
-    connect(icon_fetch_action.get(), &NetAction::failed, this, [=] {
-        m_currently_running_icon_actions.remove(url);
-        m_failed_icon_actions.insert(url);
-    });
+    if (!m_icon_loader) {
+        m_icon_loader.reset(new ResourceIconLoader(metaEntryBase()));
+        connect(m_icon_loader.get(), &ResourceIconLoader::iconLoaded, this, &ResourceModel::iconLoaded);
+    }
 
-    m_currently_running_icon_actions.insert(url);
+    return m_icon_loader->icon(url, index.row());
+}
 
-    m_current_icon_job->addNetAction(icon_fetch_action);
-    if (!m_current_icon_job->isRunning())
-        QMetaObject::invokeMethod(m_current_icon_job.get(), &NetJob::start);
+void ResourceModel::setVisibleRows(int first, int last)
+{
+    if (m_icon_loader)
+        m_icon_loader->setVisibleRows(first, last);
+}
 
-    return {};
+void ResourceModel::iconLoaded(const QUrl& url)
+{
+    // the rows may have moved since the logo was asked for
+    for (int row = 0; row < m_packs.size(); row++) {
+        if (QUrl(m_packs.at(row)->logoUrl) == url)
+            emit dataChanged(index(row), index(row), { Qt::DecorationRole });
+    }
 }
 
 // No 'forgor to implement' shall pass here :blobfox_knife:
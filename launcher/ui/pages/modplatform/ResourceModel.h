@@ -24,6 +24,8 @@ struct IndexedPack;
 
 namespace ResourceDownload {
 
+class ResourceIconLoader;
+
 class ResourceModel : public QAbstractListModel {
     Q_OBJECT
 
@@ -83,6 +85,9 @@ class ResourceModel : public QAbstractListModel {
     /** Gets the icon at the URL for the given index. If it's not fetched yet, fetch it and update when fisinhed. */
     std::optional<QIcon> getIcon(QModelIndex&, const QUrl&);
 
+    /** The rows the view shows. Icons are only fetched for those. */
+    void setVisibleRows(int first, int last);
+
     void addPack(ModPlatform::IndexedPack::Ptr pack,
                  ModPlatform::IndexedVersion& version,
                  const std::shared_ptr<ResourceFolderModel> packs,
@@ -130,9 +135,7 @@ class ResourceModel : public QAbstractListModel {
     // Job for fetching versions and extra info on existing entries
     ConcurrentTask m_current_info_job;
 
-    shared_qobject_ptr<NetJob> m_current_icon_job;
-    QSet<QUrl> m_currently_running_icon_actions;
-    QSet<QUrl> m_failed_icon_actions;
+    shared_qobject_ptr<ResourceIconLoader> m_icon_loader;
 
     QList<ModPlatform::IndexedPack::Ptr> m_packs;
     QList<DownloadTaskPtr> m_selected;
@@ -151,6 +154,8 @@ class ResourceModel : public QAbstractListModel {
 
     void infoRequestSucceeded(QJsonDocument&, ModPlatform::IndexedPack&, const QModelIndex&);
 
+    void iconLoaded(const QUrl& url);
+
    signals:
     void versionListUpdated();
     void projectInfoUpdated();
@@ -41,12 +41,17 @@
 #include "ui_ResourcePage.h"
 
 #include <QDesktopServices>
+#include <QFutureWatcher>
 #include <QKeyEvent>
+#include <QScrollBar>
+#include <QtConcurrent>
 
+#include "Executors.h"
 #include "Markdown.h"
 #include "ResourceDownloadTask.h"
 
 #include "minecraft/MinecraftInstance.h"
+#include "modplatform/helpers/ProjectCache.h"
 
 #include "ui/dialogs/ResourceDownloadDialog.h"
 #include "ui/pages/modplatform/ResourceModel.h"
@@ -104,10 +109,30 @@ void ResourcePage::openedImpl()
 
     updateSelectionButton();
     triggerSearch();
+
+    // the logos are only fetched for the rows on screen
+    connect(m_ui->packView->verticalScrollBar(), &QScrollBar::valueChanged, this, &ResourcePage::updateVisibleRows, Qt::UniqueConnection);
+    connect(m_model, &QAbstractItemModel::rowsInserted, this, &ResourcePage::updateVisibleRows, Qt::UniqueConnection);
+    connect(m_model, &QAbstractItemModel::modelReset, this, &ResourcePage::updateVisibleRows, Qt::UniqueConnection);
+}
+
+void ResourcePage::updateVisibleRows()
+{
+    if (!m_model)
+        return;
+
+    auto view = m_ui->packView;
+    auto area = view->viewport()->rect();
+    auto first = view->indexAt(area.topLeft());
+    auto last = view->indexAt(QPoint(area.left(), area.bottom()));
+    m_model->setVisibleRows(first.isValid() ? first.row() : 0, last.isValid() ? last.row() : m_model->rowCount({}) - 1);
 }
 
 auto ResourcePage::eventFilter(QObject* watched, QEvent* event) -> bool
 {
+    if (event->type() == QEvent::Resize && watched == m_ui->packView)
+        updateVisibleRows();
+
     if (event->type() == QEvent::KeyPress) {
         auto* keyEvent = static_cast<QKeyEvent*>(event);
         if (watched == m_ui->searchEdit) {
@@ -227,9 +252,30 @@ void ResourcePage::updateUi()
 
     text += "<hr>";
 
-    m_ui->packDescription->setHtml(
-        text + (current_pack->extraData.body.isEmpty() ? current_pack->description : markdownToHTML(current_pack->extraData.body)));
+    // what was being made for the project shown before is of no use anymore
+    auto request = ++m_description_request;
+    auto body = current_pack->extraData.body;
+    std::optional<QString> html;
+    if (!body.isEmpty())
+        html = ProjectCache::findHtml(body);
+
+    m_ui->packDescription->setHtml(text + (html ? *html : current_pack->description));
     m_ui->packDescription->flush();
+    if (body.isEmpty() || html)
+        return;
+
+    // made off the GUI thread, with the summary shown meanwhile
+    auto watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, request, body, header = text] {
+        auto html = watcher->result();
+        watcher->deleteLater();
+        ProjectCache::insertHtml(body, html);
+        if (request != m_description_request)
+            return;
+        m_ui->packDescription->setHtml(header + html);
+        m_ui->packDescription->flush();
+    });
+    watcher->setFuture(QtConcurrent::run(Executors::cpu(), [body] { return markdownToHTML(body); }));
 }
 
 void ResourcePage::updateSelectionButton()
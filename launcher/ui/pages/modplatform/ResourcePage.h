@@ -89,6 +89,7 @@ class ResourcePage : public QWidget, public BasePage {
     void onSelectionChanged(QModelIndex first, QModelIndex second);
     void onVersionSelectionChanged(QString data);
     void onResourceSelected();
+    void updateVisibleRows();
 
     // NOTE: Can't use [[nodiscard]] here because of https://bugreports.qt.io/browse/QTBUG-58628 on Qt 5.12
 
@@ -109,6 +110,8 @@ class ResourcePage : public QWidget, public BasePage {
     ResourceModel* m_model = nullptr;
 
     int m_selected_version_index = -1;
+    // of the description shown last, the HTML made for the ones before is dropped
+    int m_description_request = 0;
 
     ProgressWidget m_fetch_progress;
 
@@ -39,6 +39,7 @@
 #include <QTabBar>
 
 #include "Application.h"
+#include "minecraft/VersionPrefetcher.h"
 #include "Filter.h"
 #include "Version.h"
 #include "meta/Index.h"
@@ -232,10 +233,15 @@ void VanillaPage::setSelectedVersion(BaseVersion::Ptr version)
     m_selectedVersion = version;
     suggestCurrent();
     loaderFilterChanged();
+    if (version)
+        APPLICATION->versionPrefetcher()->prefetch("net.minecraft", version->descriptor());
 }
 
 void VanillaPage::setSelectedLoaderVersion(BaseVersion::Ptr version)
 {
     m_selectedLoaderVersion = version;
     suggestCurrent();
+    // the loader requires the Minecraft version, which gets prefetched along with it
+    if (version && !m_selectedLoader.isEmpty())
+        APPLICATION->versionPrefetcher()->prefetch(m_selectedLoader, version->descriptor());
 }
@@ -30,6 +30,8 @@ QVariant ListModel::data(const QModelIndex& index, int role) const
         return QString("INVALID INDEX %1").arg(pos);
     }
 
+    ((ListModel*)this)->fetchAhead(pos);
+
     IndexedPack pack = modpacks.at(pos);
     switch (role) {
         case Qt::ToolTipRole: {
@@ -102,6 +104,7 @@ void ListModel::requestLogo(QString logo, QString url)
 
     MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("FlamePacks", QString("logos/%1").arg(logo.section(".", 0, 0)));
     auto job = new NetJob(QString("Flame Icon Download %1").arg(logo), APPLICATION->network());
+    job->setPriority(Net::Priority::Interactive);
     job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
 
     auto fullPath = entry->getFullPath();
@@ -155,7 +158,10 @@ void ListModel::fetchMore(const QModelIndex& parent)
 
 void ListModel::performPaginatedSearch()
 {
-    auto netJob = makeShared<NetJob>("Flame::Search", APPLICATION->network());
+    // the next page is already on its way
+    if (jobPtr)
+        return;
+
     auto searchUrl = QString(
                          "https://api.curseforge.com/v1/mods/search?"
                          "gameId=432&"
@@ -169,11 +175,21 @@ void ListModel::performPaginatedSearch()
                          .arg(currentSearchTerm)
                          .arg(currentSort + 1);
 
-    netJob->addNetAction(Net::Download::makeByteArray(QUrl(searchUrl), &response));
-    jobPtr = netJob;
+    auto task = makeShared<ResourceSearchTask>(QUrl(searchUrl), "CurseForge");
+    auto raw_task = task.get();
+    QObject::connect(task.get(), &Task::succeeded, this, [this, raw_task] { searchRequestFinished(raw_task->document()); });
+    QObject::connect(task.get(), &Task::failed, this, &ListModel::searchRequestFailed);
+    QObject::connect(task.get(), &Task::aborted, this, &ListModel::searchRequestAborted);
+    jobPtr = task;
     jobPtr->start();
-    QObject::connect(netJob.get(), &NetJob::succeeded, this, &ListModel::searchRequestFinished);
-    QObject::connect(netJob.get(), &NetJob::failed, this, &ListModel::searchRequestFailed);
+}
+
+void ListModel::fetchAhead(int row)
+{
+    // start getting the next page before the view gets to the end of this one
+    if (searchState != CanPossiblyFetchMore || jobPtr || row < modpacks.size() - 12)
+        return;
+    QMetaObject::invokeMethod(this, &ListModel::performPaginatedSearch, Qt::QueuedConnection);
 }
 
 void ListModel::searchWithTerm(const QString& term, int sort)
@@ -184,8 +200,9 @@ void ListModel::searchWithTerm(const QString& term, int sort)
     currentSearchTerm = term;
     currentSort = sort;
     if (jobPtr) {
-        jobPtr->abort();
+        // the search starts again once this one is aborted
         searchState = ResetRequested;
+        jobPtr->abort();
         return;
     } else {
         beginResetModel();
@@ -197,19 +214,10 @@ void ListModel::searchWithTerm(const QString& term, int sort)
     performPaginatedSearch();
 }
 
-void Flame::ListModel::searchRequestFinished()
+void Flame::ListModel::searchRequestFinished(QJsonDocument doc)
 {
     jobPtr.reset();
 
-    QJsonParseError parse_error;
-    QJsonDocument doc = QJsonDocument::fromJson(response, &parse_error);
-    if (parse_error.error != QJsonParseError::NoError) {
-        qWarning() << "Error while parsing JSON response from CurseForge at " << parse_error.offset
-                   << " reason: " << parse_error.errorString();
-        qWarning() << response;
-        return;
-    }
-
     QList<Flame::IndexedPack> newList;
     auto packs = Json::ensureArray(doc.object(), "data");
     for (auto packRaw : packs) {
@@ -256,4 +264,20 @@ void Flame::ListModel::searchRequestFailed(QString reason)
     }
 }
 
+void Flame::ListModel::searchRequestAborted()
+{
+    jobPtr.reset();
+
+    if (searchState != ResetRequested)
+        return;
+
+    beginResetModel();
+    modpacks.clear();
+    endResetModel();
+    searchState = None;
+
+    nextSearchOffset = 0;
+    performPaginatedSearch();
+}
+
 }  // namespace Flame
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <RWStorage.h>
+#include <QMap>
 
 #include <QAbstractListModel>
 #include <QSortFilterProxyModel>
@@ -15,6 +15,8 @@
 #include <functional>
 #include <net/NetJob.h>
 
+#include "modplatform/helpers/ResourceSearchTask.h"
+
 #include <modplatform/flame/FlamePackIndex.h>
 
 namespace Flame {
@@ -48,11 +50,13 @@ private slots:
     void logoFailed(QString logo);
     void logoLoaded(QString logo, QIcon out);
 
-    void searchRequestFinished();
+    void searchRequestFinished(QJsonDocument doc);
     void searchRequestFailed(QString reason);
+    void searchRequestAborted();
 
 private:
     void requestLogo(QString file, QString url);
+    void fetchAhead(int row);
 
 private:
     QList<IndexedPack> modpacks;
@@ -70,8 +74,7 @@ private:
         ResetRequested,
         Finished
     } searchState = None;
-    NetJob::Ptr jobPtr;
-    QByteArray response;
+    ResourceSearchTask::Ptr jobPtr;
 };
 
 }
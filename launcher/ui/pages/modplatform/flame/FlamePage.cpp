@@ -39,12 +39,14 @@
 #include <QKeyEvent>
 
 #include "Application.h"
+#include "minecraft/VersionPrefetcher.h"
 #include "FlameModel.h"
 #include "InstanceImportTask.h"
 #include "Json.h"
 #include "ui/dialogs/NewInstanceDialog.h"
 #include "ui/widgets/ProjectItem.h"
 #include "modplatform/flame/FlameAPI.h"
+#include "net/JsonResponse.h"
 
 static FlameAPI api;
 
@@ -134,18 +136,12 @@ void FlamePage::onSelectionChanged(QModelIndex curr, QModelIndex prev)
         int addonId = current.addonId;
         netJob->addNetAction(Net::Download::makeByteArray(QString("https://api.curseforge.com/v1/mods/%1/files").arg(addonId), response));
 
-        QObject::connect(netJob, &NetJob::succeeded, this, [this, response, addonId, curr] {
+        auto parsed = Net::parseJson(netJob, response, "Flame::PackVersions");
+        QObject::connect(netJob, &NetJob::succeeded, this, [this, response, parsed, addonId, curr] {
             if (addonId != current.addonId) {
                 return;  // wrong request
             }
-            QJsonParseError parse_error;
-            QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-            if (parse_error.error != QJsonParseError::NoError) {
-                qWarning() << "Error while parsing JSON response from CurseForge at " << parse_error.offset
-                           << " reason: " << parse_error.errorString();
-                qWarning() << *response;
-                return;
-            }
+            auto& doc = *parsed;
             auto arr = Json::ensureArray(doc.object(), "data");
             try {
                 Flame::loadIndexedPackVersions(current, arr);
@@ -230,6 +226,7 @@ void FlamePage::onVersionSelectionChanged(QString data)
     Q_ASSERT(current.versions.at(m_selected_version_index).downloadUrl == ui->versionSelectionBox->currentData().toString());
 
     suggestCurrent();
+    APPLICATION->versionPrefetcher()->prefetch("net.minecraft", current.versions.at(m_selected_version_index).mcVersion);
 }
 
 void FlamePage::updateUi()
@@ -272,7 +269,26 @@ void FlamePage::updateUi()
 
 
     text += "<hr>";
-    text += api.getModDescription(current.addonId).toUtf8();
+    if (m_descriptions.contains(current.addonId)) {
+        text += m_descriptions.value(current.addonId);
+    } else if (!m_description_job || !m_description_job->isRunning()) {
+        auto addon_id = current.addonId;
+        auto response = new QByteArray();
+        m_description_job = api.getDescription(addon_id, response);
+        auto description = Net::processJson<QString>(m_description_job.get(), response, "Flame::ModDescription",
+                                                     [](const QJsonDocument& doc) { return Json::ensureString(doc.object(), "data"); });
+        connect(m_description_job.get(), &Task::succeeded, this, [this, addon_id, description] {
+            m_descriptions.insert(addon_id, *description);
+            if (current.addonId == addon_id)
+                updateUi();
+        });
+        connect(m_description_job.get(), &Task::finished, this, [this, addon_id] {
+            // another pack got selected while this one was being looked up
+            if (current.addonId != addon_id && !m_descriptions.contains(current.addonId))
+                updateUi();
+        });
+        m_description_job->start();
+    }
 
     ui->packDescription->setHtml(text + current.description);
     ui->packDescription->flush();
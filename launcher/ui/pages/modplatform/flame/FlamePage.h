@@ -35,6 +35,7 @@
 
 #pragma once
 
+#include <QHash>
 #include <QWidget>
 
 #include "ui/pages/BasePage.h"
@@ -100,4 +101,8 @@ private:
     Flame::IndexedPack current;
 
     int m_selected_version_index = -1;
+
+    // of the packs that were looked at, by their id
+    QHash<int, QString> m_descriptions;
+    Task::Ptr m_description_job;
 };
@@ -44,8 +44,6 @@
 #include <QtMath>
 #include <QLabel>
 
-#include <RWStorage.h>
-
 #include <BuildConfig.h>
 
 namespace LegacyFTB {
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <modplatform/legacy_ftb/PackHelpers.h>
-#include <RWStorage.h>
+#include <QMap>
 
 #include <QAbstractListModel>
 #include <QSortFilterProxyModel>
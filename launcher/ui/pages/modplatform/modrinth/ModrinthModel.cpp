@@ -73,6 +73,8 @@ auto ModpackListModel::data(const QModelIndex& index, int role) const -> QVarian
         return QString("INVALID INDEX %1").arg(pos);
     }
 
+    ((ModpackListModel*)this)->fetchAhead(pos);
+
     Modrinth::Modpack pack = modpacks.at(pos);
     switch (role) {
         case Qt::ToolTipRole: {
@@ -126,8 +128,11 @@ bool ModpackListModel::setData(const QModelIndex &index, const QVariant &value,
 
 void ModpackListModel::performPaginatedSearch()
 {
+    // the next page is already on its way
+    if (jobPtr)
+        return;
+
     // TODO: Move to standalone API
-    auto netJob = makeShared<NetJob>("Modrinth::SearchModpack", APPLICATION->network());
     auto searchAllUrl = QString(BuildConfig.MODRINTH_PROD_URL +
                             "/search?"
                             "offset=%1&"
@@ -140,32 +145,33 @@ void ModpackListModel::performPaginatedSearch()
                             .arg(currentSearchTerm)
                             .arg(currentSort);
 
-    netJob->addNetAction(Net::Download::makeByteArray(QUrl(searchAllUrl), &m_all_response));
-
-    QObject::connect(netJob.get(), &NetJob::succeeded, this, [this] {
-        QJsonParseError parse_error_all{};
-
-        QJsonDocument doc_all = QJsonDocument::fromJson(m_all_response, &parse_error_all);
-        if (parse_error_all.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from " << debugName() << " at " << parse_error_all.offset
-                       << " reason: " << parse_error_all.errorString();
-            qWarning() << m_all_response;
-            return;
-        }
-
+    auto task = makeShared<ResourceSearchTask>(QUrl(searchAllUrl), debugName());
+    auto raw_task = task.get();
+    QObject::connect(task.get(), &Task::succeeded, this, [this, raw_task] {
+        auto doc_all = raw_task->document();
         searchRequestFinished(doc_all);
     });
-    QObject::connect(netJob.get(), &NetJob::failed, this, &ModpackListModel::searchRequestFailed);
+    QObject::connect(task.get(), &Task::failed, this, &ModpackListModel::searchRequestFailed);
+    QObject::connect(task.get(), &Task::aborted, this, &ModpackListModel::searchRequestAborted);
 
-    jobPtr = netJob;
+    jobPtr = task;
     jobPtr->start();
 }
 
+void ModpackListModel::fetchAhead(int row)
+{
+    // start getting the next page before the view gets to the end of this one
+    if (searchState != CanPossiblyFetchMore || jobPtr || row < modpacks.size() - m_modpacks_per_page / 2)
+        return;
+    QMetaObject::invokeMethod(this, &ModpackListModel::performPaginatedSearch, Qt::QueuedConnection);
+}
+
 void ModpackListModel::refresh()
 {
     if (jobPtr) {
-        jobPtr->abort();
+        // the search starts again once this one is aborted
         searchState = ResetRequested;
+        jobPtr->abort();
         return;
     } else {
         beginResetModel();
@@ -233,6 +239,7 @@ void ModpackListModel::requestLogo(QString logo, QString url)
     MetaEntryPtr entry =
         APPLICATION->metacache()->resolveEntry(m_parent->metaEntryBase(), QString("logos/%1").arg(logo.section(".", 0, 0)));
     auto job = new NetJob(QString("%1 Icon Download %2").arg(m_parent->debugName()).arg(logo), APPLICATION->network());
+    job->setPriority(Net::Priority::Interactive);
     job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
 
     auto fullPath = entry->getFullPath();
@@ -310,11 +317,11 @@ void ModpackListModel::searchRequestFinished(QJsonDocument& doc_all)
 
 void ModpackListModel::searchRequestFailed(QString reason)
 {
-    auto failed_action = jobPtr->getFailedActions().at(0);
-    if (!failed_action->m_reply) {
+    auto network_error_code = jobPtr->networkErrorCode();
+    if (network_error_code == -1) {
         // Network error
         QMessageBox::critical(nullptr, tr("Error"), tr("A network error occurred. Could not load modpacks."));
-    } else if (failed_action->m_reply && failed_action->m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 409) {
+    } else if (network_error_code == 409) {
         // 409 Gone, notify user to update
         QMessageBox::critical(nullptr, tr("Error"),
                               //: %1 refers to the launcher itself
@@ -336,6 +343,22 @@ void ModpackListModel::searchRequestFailed(QString reason)
     }
 }
 
+void ModpackListModel::searchRequestAborted()
+{
+    jobPtr.reset();
+
+    if (searchState != ResetRequested)
+        return;
+
+    beginResetModel();
+    modpacks.clear();
+    endResetModel();
+    searchState = None;
+
+    nextSearchOffset = 0;
+    performPaginatedSearch();
+}
+
 }  // namespace Modrinth
 
 /******** Helpers ********/
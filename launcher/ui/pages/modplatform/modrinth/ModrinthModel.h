@@ -37,6 +37,7 @@
 
 #include <QAbstractListModel>
 
+#include "modplatform/helpers/ResourceSearchTask.h"
 #include "modplatform/modrinth/ModrinthPackManifest.h"
 #include "net/NetJob.h"
 #include "ui/pages/modplatform/modrinth/ModrinthPage.h"
@@ -66,7 +67,7 @@ class ModpackListModel : public QAbstractListModel {
     auto data(const QModelIndex& index, int role) const -> QVariant override;
     bool setData(const QModelIndex &index, const QVariant &value, int role) override;
 
-    inline void setActiveJob(NetJob::Ptr ptr) { jobPtr = ptr; }
+    inline void setActiveJob(ResourceSearchTask::Ptr ptr) { jobPtr = ptr; }
 
     /* Ask the API for more information */
     void fetchMore(const QModelIndex& parent) override;
@@ -80,6 +81,7 @@ class ModpackListModel : public QAbstractListModel {
    public slots:
     void searchRequestFinished(QJsonDocument& doc_all);
     void searchRequestFailed(QString reason);
+    void searchRequestAborted();
 
    protected slots:
 
@@ -90,6 +92,7 @@ class ModpackListModel : public QAbstractListModel {
 
    protected:
     void requestLogo(QString file, QString url);
+    void fetchAhead(int row);
 
     inline auto getMineVersions() const -> std::list<Version>;
 
@@ -108,9 +111,8 @@ class ModpackListModel : public QAbstractListModel {
     int nextSearchOffset = 0;
     enum SearchState { None, CanPossiblyFetchMore, ResetRequested, Finished } searchState = None;
 
-    NetJob::Ptr jobPtr;
+    ResourceSearchTask::Ptr jobPtr;
 
-    QByteArray m_all_response;
     QByteArray m_specific_response;
 
     int m_modpacks_per_page = 20;
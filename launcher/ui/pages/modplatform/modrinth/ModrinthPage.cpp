@@ -38,11 +38,14 @@
 #include "ui_ModrinthPage.h"
 
 #include "ModrinthModel.h"
+#include "Application.h"
 
 #include "BuildConfig.h"
 #include "InstanceImportTask.h"
 #include "Json.h"
 #include "Markdown.h"
+#include "minecraft/VersionPrefetcher.h"
+#include "net/JsonResponse.h"
 
 #include "ui/widgets/ProjectItem.h"
 
@@ -129,19 +132,13 @@ void ModrinthPage::onSelectionChanged(QModelIndex curr, QModelIndex prev)
 
         netJob->addNetAction(Net::Download::makeByteArray(QString("%1/project/%2").arg(BuildConfig.MODRINTH_PROD_URL, id), response));
 
-        QObject::connect(netJob, &NetJob::succeeded, this, [this, response, id, curr] {
+        auto parsed = Net::parseJson(netJob, response, "Modrinth::PackInformation");
+        QObject::connect(netJob, &NetJob::succeeded, this, [this, response, parsed, id, curr] {
             if (id != current.id) {
                 return;  // wrong request?
             }
 
-            QJsonParseError parse_error;
-            QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-            if (parse_error.error != QJsonParseError::NoError) {
-                qWarning() << "Error while parsing JSON response from Modrinth at " << parse_error.offset
-                           << " reason: " << parse_error.errorString();
-                qWarning() << *response;
-                return;
-            }
+            auto& doc = *parsed;
 
             auto obj = Json::requireObject(doc);
 
@@ -181,19 +178,13 @@ void ModrinthPage::onSelectionChanged(QModelIndex curr, QModelIndex prev)
         netJob->addNetAction(
             Net::Download::makeByteArray(QString("%1/project/%2/version").arg(BuildConfig.MODRINTH_PROD_URL, id), response));
 
-        QObject::connect(netJob, &NetJob::succeeded, this, [this, response, id, curr] {
+        auto parsed = Net::parseJson(netJob, response, "Modrinth::PackVersions");
+        QObject::connect(netJob, &NetJob::succeeded, this, [this, response, parsed, id, curr] {
             if (id != current.id) {
                 return;  // wrong request?
             }
 
-            QJsonParseError parse_error;
-            QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-            if (parse_error.error != QJsonParseError::NoError) {
-                qWarning() << "Error while parsing JSON response from Modrinth at " << parse_error.offset
-                           << " reason: " << parse_error.errorString();
-                qWarning() << *response;
-                return;
-            }
+            auto& doc = *parsed;
 
             try {
                 Modrinth::loadIndexedVersions(current, doc);
@@ -325,4 +316,11 @@ void ModrinthPage::onVersionSelectionChanged(QString data)
     }
     selectedVersion = ui->versionSelectionBox->currentData().toString();
     suggestCurrent();
+
+    for (auto& version : current.versions) {
+        if (version.id == selectedVersion) {
+            APPLICATION->versionPrefetcher()->prefetch("net.minecraft", version.mc_version);
+            break;
+        }
+    }
 }
@@ -35,6 +35,7 @@
 #include "CustomTheme.h"
 #include <FileSystem.h>
 #include <Json.h>
+#include "ThemeCache.h"
 #include "ThemeManager.h"
 
 const char* themeFile = "theme.json";
@@ -157,7 +158,8 @@ static bool writeThemeJson(const QString& path,
 /// @param baseTheme Base Theme
 /// @param fileInfo FileInfo object for file to load
 /// @param isManifest whether to load a theme manifest or a qss file
-CustomTheme::CustomTheme(ITheme* baseTheme, QFileInfo& fileInfo, bool isManifest)
+/// @param cache Parsed theme manifests from the last time, if any
+CustomTheme::CustomTheme(ITheme* baseTheme, QFileInfo& fileInfo, bool isManifest, ThemeCache* cache) : m_baseTheme(baseTheme)
 {
     if (isManifest) {
         m_id = fileInfo.dir().dirName();
@@ -172,35 +174,37 @@ CustomTheme::CustomTheme(ITheme* baseTheme, QFileInfo& fileInfo, bool isManifest
 
         auto themeFilePath = FS::PathCombine(path, themeFile);
 
-        bool jsonDataIncomplete = false;
-
-        m_palette = baseTheme->colorScheme();
-        if (readThemeJson(themeFilePath, m_palette, m_fadeAmount, m_fadeColor, m_name, m_widgets, m_qssFilePath, jsonDataIncomplete)) {
-            // If theme data was found, fade "Disabled" color of each role according to FadeAmount
-            m_palette = fadeInactive(m_palette, m_fadeAmount, m_fadeColor);
+        if (auto cached = cache ? cache->find(QFileInfo(themeFilePath)) : std::nullopt) {
+            m_name = cached->name;
+            m_widgets = cached->widgets;
+            m_qssFilePath = cached->qssFilePath;
+            m_palette = cached->palette;
+            m_fadeAmount = cached->fadeAmount;
+            m_fadeColor = cached->fadeColor;
         } else {
-            themeDebugLog() << "Did not read theme json file correctly, not changing theme, keeping previous.";
-            return;
-        }
+            bool jsonDataIncomplete = false;
 
-        // FIXME: This is kinda jank, it only actually checks if the qss file path is not present. It should actually check for any relevant missing data (e.g. name, colors)
-        if (jsonDataIncomplete) {
-            writeThemeJson(fileInfo.absoluteFilePath(), m_palette, m_fadeAmount, m_fadeColor, m_name, m_widgets, m_qssFilePath);
-        }
-
-        auto qssFilePath = FS::PathCombine(path, m_qssFilePath);
-        QFileInfo info(qssFilePath);
-        if (info.isFile()) {
-            try {
-                // TODO: validate qss?
-                m_styleSheet = QString::fromUtf8(FS::read(qssFilePath));
-            } catch (const Exception& e) {
-                themeWarningLog() << "Couldn't load qss:" << e.cause() << "from" << qssFilePath;
+            m_palette = baseTheme->colorScheme();
+            if (readThemeJson(themeFilePath, m_palette, m_fadeAmount, m_fadeColor, m_name, m_widgets, m_qssFilePath, jsonDataIncomplete)) {
+                // If theme data was found, fade "Disabled" color of each role according to FadeAmount
+                m_palette = fadeInactive(m_palette, m_fadeAmount, m_fadeColor);
+            } else {
+                themeDebugLog() << "Did not read theme json file correctly, not changing theme, keeping previous.";
                 return;
             }
-        } else {
-            themeDebugLog() << "No theme qss present.";
+
+            // FIXME: This is kinda jank, it only actually checks if the qss file path is not present. It should actually check for any relevant missing data (e.g. name, colors)
+            if (jsonDataIncomplete) {
+                writeThemeJson(fileInfo.absoluteFilePath(), m_palette, m_fadeAmount, m_fadeColor, m_name, m_widgets, m_qssFilePath);
+            }
+
+            if (cache) {
+                // stat it again, it might have just been rewritten
+                cache->insert(QFileInfo(themeFilePath), { m_name, m_widgets, m_qssFilePath, m_palette, m_fadeAmount, m_fadeColor });
+            }
         }
+
+        m_styleSheetPath = FS::PathCombine(path, m_qssFilePath);
     } else {
         m_id = fileInfo.fileName();
         m_name = fileInfo.baseName();
@@ -209,21 +213,37 @@ CustomTheme::CustomTheme(ITheme* baseTheme, QFileInfo& fileInfo, bool isManifest
         // themeDebugLog << "Theme Name: " << m_name;
         // themeDebugLog << "Theme Path: " << path;
 
+        m_palette = baseTheme->colorScheme();
+
         if (!FS::ensureFilePathExists(path)) {
             themeWarningLog() << m_name << " Theme file path doesn't exist!";
-            m_palette = baseTheme->colorScheme();
             m_styleSheet = baseTheme->appStyleSheet();
+            m_styleSheetLoaded = true;
             return;
         }
 
-        m_palette = baseTheme->colorScheme();
-        try {
-            // TODO: validate qss?
-            m_styleSheet = QString::fromUtf8(FS::read(path));
-        } catch (const Exception& e) {
-            themeWarningLog() << "Couldn't load qss:" << e.cause() << "from" << path;
-            m_styleSheet = baseTheme->appStyleSheet();
-        }
+        m_styleSheetPath = path;
+    }
+}
+
+void CustomTheme::loadStyleSheet()
+{
+    m_styleSheetLoaded = true;
+    if (m_styleSheetPath.isEmpty())
+        return;
+
+    if (!QFileInfo(m_styleSheetPath).isFile()) {
+        themeDebugLog() << "No theme qss present.";
+        return;
+    }
+    try {
+        // TODO: validate qss?
+        m_styleSheet = QString::fromUtf8(FS::read(m_styleSheetPath));
+    } catch (const Exception& e) {
+        themeWarningLog() << "Couldn't load qss:" << e.cause() << "from" << m_styleSheetPath;
+        // plain qss themes have nothing else to show
+        if (m_qssFilePath.isEmpty())
+            m_styleSheet = m_baseTheme->appStyleSheet();
     }
 }
 
@@ -259,6 +279,8 @@ bool CustomTheme::hasStyleSheet()
 
 QString CustomTheme::appStyleSheet()
 {
+    if (!m_styleSheetLoaded)
+        loadStyleSheet();
     return m_styleSheet;
 }
 
@@ -37,9 +37,11 @@
 #include <QFileInfo>
 #include "ITheme.h"
 
+class ThemeCache;
+
 class CustomTheme : public ITheme {
    public:
-    CustomTheme(ITheme* baseTheme, QFileInfo& file, bool isManifest);
+    CustomTheme(ITheme* baseTheme, QFileInfo& file, bool isManifest, ThemeCache* cache = nullptr);
     virtual ~CustomTheme() {}
 
     QString id() override;
@@ -53,11 +55,18 @@ class CustomTheme : public ITheme {
     QString qtTheme() override;
     QStringList searchPaths() override;
 
+   private:
+    void loadStyleSheet();
+
    private: /* data */
+    ITheme* m_baseTheme;
     QPalette m_palette;
     QColor m_fadeColor;
     double m_fadeAmount;
     QString m_styleSheet;
+    // the stylesheet is only read once the theme is applied
+    QString m_styleSheetPath;
+    bool m_styleSheetLoaded = false;
     QString m_name;
     QString m_id;
     QString m_widgets;
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ThemeCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QSaveFile>
+
+#include "FileSystem.h"
+#include "ThemeManager.h"
+
+namespace {
+
+constexpr quint32 s_magic = 0x54484d45;  // "THME"
+constexpr quint32 s_version = 1;
+constexpr auto s_stream_version = QDataStream::Qt_5_12;
+
+}  // namespace
+
+ThemeCache::ThemeCache(QString file) : m_file(std::move(file)) {}
+
+std::optional<ThemeCache::Manifest> ThemeCache::find(const QFileInfo& manifest)
+{
+    load();
+
+    auto it = m_entries.constFind(manifest.absoluteFilePath());
+    if (it == m_entries.constEnd() || it->size != manifest.size() || it->mtime != manifest.lastModified().toMSecsSinceEpoch())
+        return {};
+    return it->contents;
+}
+
+void ThemeCache::insert(const QFileInfo& manifest, const Manifest& contents)
+{
+    load();
+
+    m_entries.insert(manifest.absoluteFilePath(), { manifest.size(), manifest.lastModified().toMSecsSinceEpoch(), contents });
+    m_dirty = true;
+}
+
+void ThemeCache::retain(const QSet<QString>& paths)
+{
+    load();
+
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (paths.contains(it.key())) {
+            it++;
+        } else {
+            it = m_entries.erase(it);
+            m_dirty = true;
+        }
+    }
+}
+
+void ThemeCache::save()
+{
+    if (!m_dirty)
+        return;
+
+    QSaveFile file(m_file);
+    if (!FS::ensureFilePathExists(m_file) || !file.open(QFile::WriteOnly)) {
+        themeWarningLog() << "Could not open the theme cache for writing:" << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(s_stream_version);
+    out << s_magic << s_version << quint32(m_entries.size());
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); it++) {
+        auto& contents = it->contents;
+        out << it.key() << it->size << it->mtime << contents.name << contents.widgets << contents.qssFilePath << contents.palette
+            << contents.fadeAmount << contents.fadeColor;
+    }
+
+    if (!file.commit()) {
+        themeWarningLog() << "Could not write the theme cache:" << file.errorString();
+        return;
+    }
+    m_dirty = false;
+}
+
+void ThemeCache::load()
+{
+    if (m_loaded)
+        return;
+    m_loaded = true;
+
+    QFile file(m_file);
+    if (!file.open(QFile::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setVersion(s_stream_version);
+
+    quint32 magic, version, count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != s_magic || version != s_version)
+        return;
+
+    for (quint32 i = 0; i < count; i++) {
+        QString path;
+        Entry entry;
+        auto& contents = entry.contents;
+        in >> path >> entry.size >> entry.mtime >> contents.name >> contents.widgets >> contents.qssFilePath >> contents.palette >>
+            contents.fadeAmount >> contents.fadeColor;
+        if (in.status() != QDataStream::Ok) {
+            // just start over, the themes will be read from their own files
+            m_entries.clear();
+            m_dirty = true;
+            return;
+        }
+        m_entries.insert(path, entry);
+    }
+}
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <optional>
+
+#include <QColor>
+#include <QFileInfo>
+#include <QHash>
+#include <QPalette>
+#include <QSet>
+#include <QString>
+
+/* Cache of the parsed theme.json files of all the custom themes, in a single file.
+ *
+ * Every theme.json used to be parsed at startup, even though only one theme is ever applied.
+ * With this, only the manifests that changed since the last time (according to their size
+ * and modification time) are parsed again.
+ */
+class ThemeCache {
+   public:
+    struct Manifest {
+        QString name;
+        QString widgets;
+        QString qssFilePath;
+        QPalette palette;
+        double fadeAmount = 0.5;
+        QColor fadeColor;
+    };
+
+    explicit ThemeCache(QString file);
+
+    /** Parsed contents of the theme.json at 'manifest', if it didn't change. */
+    std::optional<Manifest> find(const QFileInfo& manifest);
+    void insert(const QFileInfo& manifest, const Manifest& contents);
+
+    /** Forgets about all the manifests not in 'paths'. */
+    void retain(const QSet<QString>& paths);
+
+    /** Writes the cache back to disk, if anything changed. */
+    void save();
+
+   private:
+    struct Entry {
+        qint64 size;
+        qint64 mtime;
+        Manifest contents;
+    };
+
+    void load();
+
+    QString m_file;
+    bool m_loaded = false;
+    bool m_dirty = false;
+    QHash<QString, Entry> m_entries;
+};
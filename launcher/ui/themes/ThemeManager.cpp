@@ -27,8 +27,9 @@
 #include "ui/themes/SystemTheme.h"
 
 #include "Application.h"
+#include "FileSystem.h"
 
-ThemeManager::ThemeManager(MainWindow* mainWindow)
+ThemeManager::ThemeManager(MainWindow* mainWindow) : m_cache(QDir("cache").absoluteFilePath("themes"))
 {
     m_mainWindow = mainWindow;
     initializeThemes();
@@ -77,6 +78,7 @@ void ThemeManager::initializeThemes()
         QString themeFolder = QDir("./themes/").absoluteFilePath("");
         themeDebugLog() << "Theme Folder Path: " << themeFolder;
 
+        QSet<QString> manifests;
         QDirIterator directoryIterator(themeFolder, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
         while (directoryIterator.hasNext()) {
             QDir dir(directoryIterator.next());
@@ -84,7 +86,8 @@ void ThemeManager::initializeThemes()
             if (themeJson.exists()) {
                 // Load "theme.json" based themes
                 themeDebugLog() << "Loading JSON Theme from:" << themeJson.absoluteFilePath();
-                addTheme(std::make_unique<CustomTheme>(getTheme(darkThemeId), themeJson, true));
+                addTheme(std::make_unique<CustomTheme>(getTheme(darkThemeId), themeJson, true, &m_cache));
+                manifests.insert(QFileInfo(FS::PathCombine("themes", dir.dirName(), "theme.json")).absoluteFilePath());
             } else {
                 // Load pure QSS Themes
                 QDirIterator stylesheetFileIterator(dir.absoluteFilePath(""), { "*.qss", "*.css" }, QDir::Files);
@@ -97,6 +100,9 @@ void ThemeManager::initializeThemes()
             }
         }
 
+        m_cache.retain(manifests);
+        m_cache.save();
+
         themeDebugLog() << "<> Widget themes initialized.";
     }
 }
@@ -129,9 +135,12 @@ void ThemeManager::setApplicationTheme(const QString& name, bool initial)
     auto systemPalette = qApp->palette();
     auto themeIter = m_themes.find(name);
     if (themeIter != m_themes.end()) {
+        if (!initial && name == m_appliedTheme)
+            return;
         auto& theme = themeIter->second;
         themeDebugLog() << "applying theme" << theme->name();
         theme->apply(initial);
+        m_appliedTheme = name;
     } else {
         themeWarningLog() << "Tried to set invalid theme:" << name;
     }
@@ -21,6 +21,7 @@
 
 #include "ui/MainWindow.h"
 #include "ui/themes/ITheme.h"
+#include "ui/themes/ThemeCache.h"
 
 inline auto themeDebugLog()
 {
@@ -50,6 +51,9 @@ class ThemeManager {
    private:
     std::map<QString, std::unique_ptr<ITheme>> m_themes;
     MainWindow* m_mainWindow;
+    ThemeCache m_cache;
+    // Qt reparses the whole stylesheet whenever it is set, so don't set the same one again
+    QString m_appliedTheme;
 
     void initializeThemes();
     QString addTheme(std::unique_ptr<ITheme> theme);
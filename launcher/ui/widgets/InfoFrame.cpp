@@ -57,6 +57,8 @@ InfoFrame::~InfoFrame()
 
 void InfoFrame::updateWithMod(Mod const& m)
 {
+    disconnect(m_image_connection);
+
     if (m.type() == ResourceType::FOLDER)
     {
         clear();
@@ -93,6 +95,7 @@ void InfoFrame::updateWithMod(Mod const& m)
 
 void InfoFrame::updateWithResource(const Resource& resource)
 {
+    disconnect(m_image_connection);
     setName(resource.name());
     setImage();
 }
@@ -162,18 +165,25 @@ void InfoFrame::updateWithResourcePack(ResourcePack& resource_pack)
 {
     setName(renderColorCodes(resource_pack.name()));
     setDescription(renderColorCodes(resource_pack.description()));
+    disconnect(m_image_connection);
     setImage(resource_pack.image({64, 64}));
+    // the image gets decoded in the background the first time it's asked for
+    m_image_connection = connect(&resource_pack, &ResourcePack::imageChanged, this, [this, &resource_pack] { setImage(resource_pack.image({ 64, 64 })); });
 }
 
 void InfoFrame::updateWithTexturePack(TexturePack& texture_pack)
 {
     setName(renderColorCodes(texture_pack.name()));
     setDescription(renderColorCodes(texture_pack.description()));
+    disconnect(m_image_connection);
     setImage(texture_pack.image({64, 64}));
+    // the image gets decoded in the background the first time it's asked for
+    m_image_connection = connect(&texture_pack, &TexturePack::imageChanged, this, [this, &texture_pack] { setImage(texture_pack.image({ 64, 64 })); });
 }
 
 void InfoFrame::clear()
 {
+    disconnect(m_image_connection);
     setName();
     setDescription();
     setImage();
@@ -57,4 +57,6 @@ class InfoFrame : public QFrame {
     Ui::InfoFrame* ui;
     QString m_description;
     class QMessageBox* m_current_box = nullptr;
+    // to the pack shown, for when its image got decoded
+    QMetaObject::Connection m_image_connection;
 };
@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "LogSpoolView.h"
+
+#include <QAbstractListModel>
+#include <QFontMetrics>
+#include <QKeyEvent>
+
+#include <algorithm>
+
+#include "launch/LogSpool.h"
+#include "ui/ColorCache.h"
+#include "ui/GuiUtil.h"
+
+namespace {
+// lines longer than this get cut off, wider widgets have trouble painting
+constexpr int s_max_width = 32000;
+}  // namespace
+
+class LogSpoolModel : public QAbstractListModel {
+   public:
+    explicit LogSpoolModel(QObject* parent) : QAbstractListModel(parent) {}
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override
+    {
+        if (parent.isValid() || !m_spool)
+            return 0;
+        return m_spool->lineCount();
+    }
+
+    QVariant data(const QModelIndex& index, int role) const override
+    {
+        if (!m_spool || index.row() < 0 || index.row() >= rowCount())
+            return {};
+
+        switch (role) {
+            case Qt::DisplayRole:
+            case Qt::EditRole:
+                return m_spool->line(index.row());
+            case Qt::FontRole:
+                return m_font;
+            case Qt::SizeHintRole: {
+                // the view takes the size of the first row for all of them, it has to fit the longest one
+                QFontMetrics metrics(m_font);
+                int width = std::min(qint64(metrics.averageCharWidth()) * m_spool->longestLine() + 2 * metrics.height(), qint64(s_max_width));
+                return QSize(int(width), metrics.height());
+            }
+            case Qt::ForegroundRole:
+                return m_colors ? QVariant(m_colors->getFront(level(index.row()))) : QVariant();
+            case Qt::BackgroundRole:
+                return m_colors ? QVariant(m_colors->getBack(level(index.row()))) : QVariant();
+            default:
+                return {};
+        }
+    }
+
+    void setSpool(std::shared_ptr<LogSpool> spool)
+    {
+        beginResetModel();
+        m_spool = std::move(spool);
+        endResetModel();
+    }
+
+    MessageLevel::Enum level(int row) const
+    {
+        auto level = m_spool->level(row);
+        if (level == MessageLevel::Unknown && m_classifier)
+            level = m_classifier(m_spool->line(row));
+        return level;
+    }
+
+    std::shared_ptr<LogSpool> m_spool;
+    LogSpoolView::Classifier m_classifier;
+    QFont m_font;
+    std::unique_ptr<LogColorCache> m_colors;
+};
+
+LogSpoolView::LogSpoolView(QWidget* parent) : QListView(parent), m_model(new LogSpoolModel(this))
+{
+    setUniformItemSizes(true);
+    setWordWrap(false);
+    setTextElideMode(Qt::ElideNone);
+    setSelectionMode(QAbstractItemView::ExtendedSelection);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+
+    m_model->m_colors = std::make_unique<LogColorCache>(palette().color(foregroundRole()), palette().color(backgroundRole()));
+    setModel(m_model);
+}
+
+LogSpoolView::~LogSpoolView() = default;
+
+void LogSpoolView::setSpool(std::shared_ptr<LogSpool> spool)
+{
+    m_model->setSpool(std::move(spool));
+}
+
+std::shared_ptr<LogSpool> LogSpoolView::spool() const
+{
+    return m_model->m_spool;
+}
+
+void LogSpoolView::setClassifier(Classifier classifier)
+{
+    m_model->m_classifier = std::move(classifier);
+    viewport()->update();
+}
+
+void LogSpoolView::setLogFont(const QFont& font)
+{
+    m_model->m_font = font;
+    // the rows are measured again with the new font
+    m_model->setSpool(m_model->m_spool);
+}
+
+QString LogSpoolView::selectedText() const
+{
+    auto rows = selectionModel()->selectedRows();
+    if (rows.isEmpty())
+        return toPlainText();
+
+    std::sort(rows.begin(), rows.end(), [](const QModelIndex& a, const QModelIndex& b) { return a.row() < b.row(); });
+    QStringList lines;
+    for (auto& row : rows)
+        lines.append(m_model->m_spool->line(row.row()));
+    return lines.join('\n');
+}
+
+QString LogSpoolView::toPlainText() const
+{
+    auto spool = m_model->m_spool;
+    if (!spool)
+        return {};
+    return spool->lines(0, spool->lineCount()).join('\n');
+}
+
+void LogSpoolView::findNext(const QString& what, bool reverse)
+{
+    auto spool = m_model->m_spool;
+    if (!spool || what.isEmpty() || spool->lineCount() == 0)
+        return;
+
+    int current = currentIndex().isValid() ? currentIndex().row() : (reverse ? spool->lineCount() : -1);
+    int found = spool->find(what, reverse ? current - 1 : current + 1, reverse);
+    if (found < 0)
+        found = spool->find(what, reverse ? spool->lineCount() - 1 : 0, reverse);
+    if (found < 0)
+        return;
+
+    auto index = m_model->index(found);
+    setCurrentIndex(index);
+    scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
+
+void LogSpoolView::keyPressEvent(QKeyEvent* event)
+{
+    if (event->matches(QKeySequence::Copy) && selectionModel()->hasSelection()) {
+        GuiUtil::setClipboardText(selectedText());
+        return;
+    }
+    QListView::keyPressEvent(event);
+}
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QListView>
+
+#include <functional>
+#include <memory>
+
+#include "MessageLevel.h"
+
+class LogSpool;
+class LogSpoolModel;
+
+/* Shows the lines of a LogSpool, however many there are.
+ *
+ * The lines all have the same height, so the view only asks for the ones on screen and the spool only reads those
+ * from disk. Their level is guessed when they are shown, for the lines the spool doesn't know it of, so only the
+ * visible window gets highlighted.
+ */
+class LogSpoolView : public QListView {
+    Q_OBJECT
+   public:
+    using Classifier = std::function<MessageLevel::Enum(const QString& line)>;
+
+    explicit LogSpoolView(QWidget* parent = nullptr);
+    ~LogSpoolView() override;
+
+    /** Shows the lines of 'spool', none when it's null. */
+    void setSpool(std::shared_ptr<LogSpool> spool);
+    std::shared_ptr<LogSpool> spool() const;
+
+    /** Guesses the level of the lines logged without one. */
+    void setClassifier(Classifier classifier);
+    void setLogFont(const QFont& font);
+
+    /** The selected lines, or all of them when none are selected. */
+    QString selectedText() const;
+    QString toPlainText() const;
+
+   public slots:
+    /** Selects the next line containing 'what' after the current one, wrapping around. */
+    void findNext(const QString& what, bool reverse);
+
+   protected:
+    void keyPressEvent(QKeyEvent* event) override;
+
+   private:
+    LogSpoolModel* m_model;
+};
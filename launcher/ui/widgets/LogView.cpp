@@ -161,10 +161,16 @@ void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
 
 void LogView::rowsRemoved(const QModelIndex& parent, int first, int last)
 {
-    // TODO: some day... maybe
     Q_UNUSED(parent)
-    Q_UNUSED(first)
-    Q_UNUSED(last)
+    if(first != 0)
+    {
+        return;
+    }
+    // the oldest lines went out of the model, so they go out of the view too
+    QTextCursor cursor(document());
+    cursor.movePosition(QTextCursor::Start);
+    cursor.movePosition(QTextCursor::NextBlock, QTextCursor::KeepAnchor, last - first + 1);
+    cursor.removeSelectedText();
 }
 
 void LogView::scrollToBottom()
@@ -177,3 +183,26 @@ void LogView::findNext(const QString& what, bool reverse)
 {
     find(what, reverse ? QTextDocument::FindFlag::FindBackward : QTextDocument::FindFlag(0));
 }
+
+void LogView::selectInRow(int row, const QString& what)
+{
+    // each row of the model is a block of the document
+    auto block = document()->findBlockByNumber(row);
+    if(!block.isValid())
+    {
+        return;
+    }
+    QTextCursor cursor(block);
+    int offset = what.isEmpty() ? -1 : block.text().indexOf(what, 0, Qt::CaseInsensitive);
+    if(offset < 0)
+    {
+        cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+    }
+    else
+    {
+        cursor.setPosition(block.position() + offset);
+        cursor.setPosition(block.position() + offset + what.size(), QTextCursor::KeepAnchor);
+    }
+    setTextCursor(cursor);
+    ensureCursorVisible();
+}
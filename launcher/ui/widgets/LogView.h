@@ -17,6 +17,8 @@ public:
 public slots:
     void setWordWrap(bool wrapping);
     void findNext(const QString & what, bool reverse);
+    /* Selects the first occurrence of what on the row (the whole row when what is empty) and scrolls to it. */
+    void selectInRow(int row, const QString & what);
     void scrollToBottom();
 
 protected slots:
@@ -24,10 +24,18 @@ ProgressWidget::ProgressWidget(QWidget* parent, bool show_label) : QWidget(paren
     layout->addWidget(m_bar);
 
     setLayout(layout);
+
+    m_refresh_timer.setSingleShot(true);
+    m_refresh_timer.setInterval(33);
+    connect(&m_refresh_timer, &QTimer::timeout, this, [this] {
+        m_bar->setMaximum(m_total);
+        m_bar->setValue(m_current);
+    });
 }
 
 void ProgressWidget::reset()
 {
+    m_refresh_timer.stop();
     m_bar->reset();
 }
 
@@ -106,8 +114,10 @@ void ProgressWidget::handleTaskStatus(const QString& status)
 }
 void ProgressWidget::handleTaskProgress(qint64 current, qint64 total)
 {
-    m_bar->setMaximum(total);
-    m_bar->setValue(current);
+    m_current = current;
+    m_total = total;
+    if (!m_refresh_timer.isActive())
+        m_refresh_timer.start();
 }
 void ProgressWidget::taskDestroyed()
 {
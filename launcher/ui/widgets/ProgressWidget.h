@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <QTimer>
 #include <QWidget>
 #include <memory>
 
@@ -53,4 +54,9 @@ class ProgressWidget : public QWidget {
     const Task* m_task = nullptr;
 
     bool m_hide_if_inactive = false;
+
+    // the bar shows the latest progress a few dozen times per second at most, however often it comes
+    QTimer m_refresh_timer;
+    qint64 m_current = 0;
+    qint64 m_total = 100;
 };
@@ -23,9 +23,11 @@
 #include <QPainter>
 #include <QTextObject>
 
-#include "Application.h"
+#include <QFutureWatcher>
+#include <QtConcurrent>
 
-#include "net/NetJob.h"
+#include "Application.h"
+#include "Executors.h"
 
 enum FormatProperties { ImageData = QTextFormat::UserProperty + 1 };
 
@@ -69,6 +71,12 @@ void VariableSizedImageObject::drawObject(QPainter* painter,
 void VariableSizedImageObject::flush()
 {
     m_fetching_images.clear();
+    auto jobs = m_image_jobs;
+    m_image_jobs.clear();
+    for (auto& job : jobs) {
+        if (job->isRunning())
+            job->abort();
+    }
 }
 
 void VariableSizedImageObject::parseImage(QTextDocument* doc, QImage image, int posInDocument)
@@ -96,32 +104,54 @@ void VariableSizedImageObject::loadImage(QTextDocument* doc, const QUrl& source,
         m_meta_entry,
         QString("images/%1").arg(QString(QCryptographicHash::hash(source.toEncoded(), QCryptographicHash::Algorithm::Sha1).toHex())));
 
-    auto job = new NetJob(QString("Load Image: %1").arg(source.fileName()), APPLICATION->network());
+    auto job = makeShared<NetJob>(QString("Load Image: %1").arg(source.fileName()), APPLICATION->network());
+    job->setPriority(Net::Priority::Interactive);
     job->addNetAction(Net::Download::makeCached(source, entry));
 
     auto full_entry_path = entry->getFullPath();
     auto source_url = source;
-    connect(job, &NetJob::succeeded, this, [this, doc, full_entry_path, source_url, posInDocument] {
+    connect(job.get(), &NetJob::succeeded, this, [this, doc, full_entry_path, source_url, posInDocument] {
         qDebug() << "Loaded resource at" << full_entry_path;
 
         // If we flushed, don't proceed.
         if (!m_fetching_images.contains(source_url))
             return;
 
-        QImage image(full_entry_path);
-        doc->addResource(QTextDocument::ImageResource, source_url, image);
+        // decoded off the GUI thread, some of them are large
+        auto watcher = new QFutureWatcher<QImage>(this);
+        connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, doc, source_url, posInDocument] {
+            auto image = watcher->result();
+            watcher->deleteLater();
+            if (!m_fetching_images.contains(source_url))
+                return;
+            addImage(doc, image, source_url, posInDocument);
+        });
+        watcher->setFuture(QtConcurrent::run(Executors::io(), [full_entry_path] { return QImage(full_entry_path); }));
+    });
+    connect(job.get(), &NetJob::finished, this, [this, job = job.get()] {
+        for (int i = 0; i < m_image_jobs.size(); i++) {
+            if (m_image_jobs[i].get() == job) {
+                m_image_jobs.removeAt(i);
+                break;
+            }
+        }
+    });
 
-        parseImage(doc, image, posInDocument);
+    m_image_jobs.append(job);
+    job->start();
+}
 
-        // This size hack is needed to prevent the content from being laid out in an area smaller
-        // than the total width available (weird).
-        auto size = doc->pageSize();
-        doc->adjustSize();
-        doc->setPageSize(size);
+void VariableSizedImageObject::addImage(QTextDocument* doc, const QImage& image, const QUrl& source_url, int posInDocument)
+{
+    doc->addResource(QTextDocument::ImageResource, source_url, image);
 
-        m_fetching_images.remove(source_url);
-    });
-    connect(job, &NetJob::finished, job, &NetJob::deleteLater);
+    parseImage(doc, image, posInDocument);
 
-    job->start();
+    // This size hack is needed to prevent the content from being laid out in an area smaller
+    // than the total width available (weird).
+    auto size = doc->pageSize();
+    doc->adjustSize();
+    doc->setPageSize(size);
+
+    m_fetching_images.remove(source_url);
 }
@@ -23,6 +23,8 @@
 #include <QTextObjectInterface>
 #include <QUrl>
 
+#include "net/NetJob.h"
+
 /** Custom image text object to be used instead of the normal one in ProjectDescriptionPage.
  *
  *  Why? Because we want to re-scale images dynamically based on the document's size, in order to
@@ -41,8 +43,7 @@ class VariableSizedImageObject final : public QObject, public QTextObjectInterfa
    public slots:
     /** Stops all currently loading images from modifying the document.
      *
-     *  This does not stop the ongoing network tasks, it only prevents their result
-     *  from impacting the document any further.
+     *  Their downloads are stopped too, the document they were for isn't shown anymore.
      */
     void flush();
 
@@ -56,9 +57,11 @@ class VariableSizedImageObject final : public QObject, public QTextObjectInterfa
      *  This uses m_meta_entry to cache the image.
      */
     void loadImage(QTextDocument* doc, const QUrl& source, int posInDocument);
+    void addImage(QTextDocument* doc, const QImage& image, const QUrl& source_url, int posInDocument);
 
    private:
     QString m_meta_entry;
 
     QSet<QUrl> m_fetching_images;
+    QList<NetJob::Ptr> m_image_jobs;
 };
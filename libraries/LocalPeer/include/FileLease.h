@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QString>
+
+#include <memory>
+
+class LockedFile;
+
+/* An advisory lock on a path, shared by all launcher processes on the machine, whatever their data directory is.
+ *
+ * LocalPeer only keeps copies with the same data directory apart, copies that share caches still write the same files.
+ * A lease is a write lock on a "<path>.lease" file next to the thing it protects, so a process can tell that another
+ * one is working on it. Within a process, a path can only be leased once at a time too.
+ *
+ * Leases go away with the process holding them, even when it crashes.
+ */
+class FileLease {
+   public:
+    explicit FileLease(QString path);
+    ~FileLease();
+
+    FileLease(const FileLease&) = delete;
+    FileLease& operator=(const FileLease&) = delete;
+
+    /** Takes the lease if nobody holds it, without waiting. */
+    bool tryAcquire();
+    /** Waits for whoever holds the lease across processes. Fails right away if this process holds it already. */
+    bool acquire();
+    /** Gives the lease back. A lease taken without waiting has its file removed, nobody can be waiting on it. */
+    void release();
+
+    bool isHeld() const { return m_file != nullptr; }
+    QString path() const { return m_path; }
+
+   private:
+    bool take(bool block);
+
+   private:
+    QString m_path;
+    std::unique_ptr<LockedFile> m_file;
+    bool m_blocking = false;
+};
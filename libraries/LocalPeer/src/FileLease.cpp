@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "FileLease.h"
+
+#include <QFileInfo>
+#include <QMutex>
+#include <QSet>
+
+#include "LockedFile.h"
+
+namespace {
+// record locks are per process, and closing any handle of a file drops them, so the process keeps track of its own
+QMutex heldLock;
+QSet<QString>& held()
+{
+    static QSet<QString> paths;
+    return paths;
+}
+}  // namespace
+
+FileLease::FileLease(QString path) : m_path(QFileInfo(path).absoluteFilePath() + ".lease") {}
+
+FileLease::~FileLease()
+{
+    release();
+}
+
+bool FileLease::tryAcquire()
+{
+    return take(false);
+}
+
+bool FileLease::acquire()
+{
+    return take(true);
+}
+
+bool FileLease::take(bool block)
+{
+    if (m_file)
+        return true;
+
+    {
+        QMutexLocker locker(&heldLock);
+        if (held().contains(m_path))
+            return false;
+        held().insert(m_path);
+    }
+
+    std::unique_ptr<LockedFile> file(new LockedFile(m_path));
+    if (!file->open(QIODevice::ReadWrite) || !file->lock(LockedFile::WriteLock, block)) {
+        QMutexLocker locker(&heldLock);
+        held().remove(m_path);
+        return false;
+    }
+    m_file = std::move(file);
+    m_blocking = block;
+    return true;
+}
+
+void FileLease::release()
+{
+    if (!m_file)
+        return;
+
+    // whoever polls for the lease creates the file again, and removing it while locked means nobody gets a lock on a
+    // file that is gone. the ones waiting for it need it to stay.
+#ifndef Q_OS_WIN
+    if (!m_blocking)
+        QFile::remove(m_path);
+#endif
+    m_file->unlock();
+    m_file->close();
+    m_file.reset();
+#ifdef Q_OS_WIN
+    // open files can't be removed there, the lock is a mutex named after the path anyway
+    if (!m_blocking)
+        QFile::remove(m_path);
+#endif
+
+    QMutexLocker locker(&heldLock);
+    held().remove(m_path);
+}
@@ -62,12 +62,19 @@ import org.prismlauncher.exception.ParseException;
 import org.prismlauncher.launcher.Launcher;
 import org.prismlauncher.launcher.impl.StandardLauncher;
 import org.prismlauncher.launcher.impl.legacy.LegacyLauncher;
+import org.prismlauncher.utils.HeapMonitor;
 import org.prismlauncher.utils.Parameters;
+import org.prismlauncher.utils.Telemetry;
 import org.prismlauncher.utils.logging.Log;
 
 public final class EntryPoint {
 
+    // before anything of the launcher part ran
+    private static long startedAt;
+
     public static void main(String[] args) {
+        startedAt = Telemetry.uptime();
+
         ExitCode code = listen();
 
         if (code != ExitCode.NORMAL) {
@@ -123,6 +130,16 @@ public final class EntryPoint {
                     throw new IllegalArgumentException("Invalid launcher type: " + type);
             }
 
+            if (Boolean.parseBoolean(params.getString("heapMonitor", "false")))
+                HeapMonitor.start();
+
+            if (Boolean.parseBoolean(params.getString("telemetry", "false"))) {
+                Telemetry.start();
+                Telemetry.phase("jvm", startedAt);
+                Telemetry.phase("script");
+            }
+
+            Telemetry.phase("game");
             launcher.launch();
 
             return ExitCode.NORMAL;
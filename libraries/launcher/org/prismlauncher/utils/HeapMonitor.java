@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+package org.prismlauncher.utils;
+
+import java.lang.management.ManagementFactory;
+import java.lang.management.MemoryPoolMXBean;
+import java.lang.management.MemoryType;
+import java.lang.management.MemoryUsage;
+
+import org.prismlauncher.utils.logging.Log;
+
+/**
+ * Keeps track of the most heap the game used, and tells the launcher when the
+ * game exits. The launcher sizes the heap of the next launches from it.
+ *
+ * What is counted is the heap that is left after the collections, so garbage
+ * that just wasn't collected yet doesn't make it look bigger than it is.
+ */
+public final class HeapMonitor {
+
+    private static final long INTERVAL = 5000;
+    private static final long MEBIBYTE = 1024 * 1024;
+
+    private static long peak;
+
+    public static void start() {
+        Thread sampler = new Thread("Heap monitor") {
+            @Override
+            public void run() {
+                try {
+                    while (true) {
+                        sample();
+                        Thread.sleep(INTERVAL);
+                    }
+                } catch (InterruptedException e) {
+                    // the game is going away
+                }
+            }
+        };
+        sampler.setDaemon(true);
+        sampler.start();
+
+        Runtime.getRuntime().addShutdownHook(new Thread("Heap report") {
+            @Override
+            public void run() {
+                long used = sample();
+                // without a single collection there is nothing to go by
+                if (used > 0)
+                    Log.launcher("Heap peak: " + (used / MEBIBYTE) + " MiB");
+            }
+        });
+    }
+
+    private static synchronized long sample() {
+        long used = 0;
+
+        for (MemoryPoolMXBean pool : ManagementFactory.getMemoryPoolMXBeans()) {
+            if (pool.getType() != MemoryType.HEAP)
+                continue;
+
+            MemoryUsage usage = pool.getCollectionUsage();
+
+            if (usage != null)
+                used += usage.getUsed();
+        }
+
+        peak = Math.max(peak, used);
+        return peak;
+    }
+
+}
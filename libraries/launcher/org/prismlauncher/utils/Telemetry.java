@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+package org.prismlauncher.utils;
+
+import java.io.PrintStream;
+import java.lang.management.GarbageCollectorMXBean;
+import java.lang.management.ManagementFactory;
+import java.lang.management.MemoryUsage;
+
+/**
+ * Tells the launcher how the game is doing, on lines of its own next to the
+ * log. The launcher takes them out of the log and shows them apart.
+ *
+ * <p>
+ * The lines are <code>!![Telemetry]!phase [name] [uptime]</code> for the steps
+ * of the startup, and <code>!![Telemetry]!sample key=value ...</code> every
+ * few seconds for the heap and the collections. Times are in milliseconds
+ * since the JVM started, sizes in bytes, and the collection counts and times
+ * add up over the whole run.
+ */
+public final class Telemetry {
+
+    private static final String PREFIX = "!![Telemetry]!";
+    private static final long INTERVAL = 5000;
+
+    // original before possibly overridden by MC
+    private static final PrintStream OUT = new PrintStream(System.out);
+
+    private static volatile boolean enabled;
+
+    public static void start() {
+        enabled = true;
+
+        Thread sampler = new Thread("Telemetry") {
+            @Override
+            public void run() {
+                try {
+                    while (true) {
+                        Thread.sleep(INTERVAL);
+                        sample();
+                    }
+                } catch (InterruptedException e) {
+                    // the game is going away
+                }
+            }
+        };
+        sampler.setDaemon(true);
+        sampler.start();
+
+        Runtime.getRuntime().addShutdownHook(new Thread("Telemetry report") {
+            @Override
+            public void run() {
+                sample();
+                phase("exit");
+            }
+        });
+    }
+
+    public static void phase(String name) {
+        phase(name, uptime());
+    }
+
+    public static void phase(String name, long uptime) {
+        if (enabled)
+            print("phase " + name + " " + uptime);
+    }
+
+    public static long uptime() {
+        return ManagementFactory.getRuntimeMXBean().getUptime();
+    }
+
+    private static void sample() {
+        MemoryUsage heap = ManagementFactory.getMemoryMXBean().getHeapMemoryUsage();
+        long count = 0;
+        long time = 0;
+
+        for (GarbageCollectorMXBean collector : ManagementFactory.getGarbageCollectorMXBeans()) {
+            // -1 when the collector doesn't know
+            count += Math.max(collector.getCollectionCount(), 0);
+            time += Math.max(collector.getCollectionTime(), 0);
+        }
+
+        print("sample uptime=" + uptime() + " used=" + heap.getUsed() + " committed=" + heap.getCommitted() + " max="
+                + heap.getMax() + " gcCount=" + count + " gcTime=" + time);
+    }
+
+    private static synchronized void print(String message) {
+        OUT.println(PREFIX + message);
+    }
+
+}
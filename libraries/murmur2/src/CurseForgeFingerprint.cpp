@@ -0,0 +1,322 @@
+//-----------------------------------------------------------------------------
+// MurmurHash2 was written by Austin Appleby, and is placed in the public
+// domain. The author hereby disclaims copyright to this source code.
+//
+// The whitespace filtering and its vectorized variants are also placed in the
+// public domain, and the author of such modifications hereby disclaims copyright
+// to this source code.
+
+#include "MurmurHash2.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MURMUR2_X86_64
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define MURMUR2_TARGET_AVX2
+#else
+#define MURMUR2_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MURMUR2_NEON
+#include <arm_neon.h>
+#endif
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+const uint32_t m = 0x5bd1e995;
+const int r = 24;
+
+// The data is compacted and hashed in chunks of this size
+const std::size_t chunk_size = 64 * KiB;
+
+inline bool isWhitespace(char c)
+{
+    return c == 9 || c == 10 || c == 13 || c == 32;
+}
+
+// Every kernel comes as a pair: one counting the whitespace, so we know the final length
+// for the seed, and one copying the non-whitespace bytes of `src` to `dst`, which must be
+// able to hold `length` bytes.
+struct Kernels {
+    std::size_t (*count)(const char* src, std::size_t length);
+    std::size_t (*compact)(const char* src, std::size_t length, char* dst);
+    const char* name;
+};
+
+std::size_t countScalar(const char* src, std::size_t length)
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < length; i++)
+        count += isWhitespace(src[i]);
+    return count;
+}
+
+std::size_t compactScalar(const char* src, std::size_t length, char* dst)
+{
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < length; i++) {
+        char c = src[i];
+        dst[written] = c;
+        written += !isWhitespace(c);
+    }
+    return written;
+}
+
+// Compacts a block for which we know which bytes are whitespace
+inline std::size_t compactMasked(const char* src, std::size_t length, uint32_t whitespace_mask, char* dst)
+{
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < length; i++) {
+        dst[written] = src[i];
+        written += !((whitespace_mask >> i) & 1);
+    }
+    return written;
+}
+
+#if defined(MURMUR2_X86_64)
+
+inline __m128i whitespaceSSE2(__m128i v)
+{
+    return _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(9)), _mm_cmpeq_epi8(v, _mm_set1_epi8(10))),
+                        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(13)), _mm_cmpeq_epi8(v, _mm_set1_epi8(32))));
+}
+
+std::size_t countSSE2(const char* src, std::size_t length)
+{
+    std::size_t count = 0;
+    std::size_t i = 0;
+    while (i + 16 <= length) {
+        // each byte lane can count up to 255 matches before overflowing
+        __m128i acc = _mm_setzero_si128();
+        for (int iter = 0; iter < 255 && i + 16 <= length; iter++, i += 16) {
+            auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            acc = _mm_sub_epi8(acc, whitespaceSSE2(v));
+        }
+        auto sums = _mm_sad_epu8(acc, _mm_setzero_si128());
+        count += static_cast<std::size_t>(_mm_cvtsi128_si64(sums)) + static_cast<std::size_t>(_mm_extract_epi16(sums, 4));
+    }
+    return count + countScalar(src + i, length - i);
+}
+
+std::size_t compactSSE2(const char* src, std::size_t length, char* dst)
+{
+    std::size_t written = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(whitespaceSSE2(v)));
+        if (mask == 0) {
+            // by far the most common case for binary data
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + written), v);
+            written += 16;
+        } else {
+            written += compactMasked(src + i, 16, mask, dst + written);
+        }
+    }
+    return written + compactScalar(src + i, length - i, dst + written);
+}
+
+MURMUR2_TARGET_AVX2 inline __m256i whitespaceAVX2(__m256i v)
+{
+    return _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(9)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(10))),
+                           _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(13)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(32))));
+}
+
+MURMUR2_TARGET_AVX2 std::size_t countAVX2(const char* src, std::size_t length)
+{
+    std::size_t count = 0;
+    std::size_t i = 0;
+    while (i + 32 <= length) {
+        __m256i acc = _mm256_setzero_si256();
+        for (int iter = 0; iter < 255 && i + 32 <= length; iter++, i += 32) {
+            auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            acc = _mm256_sub_epi8(acc, whitespaceAVX2(v));
+        }
+        auto sums = _mm256_sad_epu8(acc, _mm256_setzero_si256());
+        auto halves = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+        count += static_cast<std::size_t>(_mm_cvtsi128_si64(halves)) +
+                 static_cast<std::size_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(halves, halves)));
+    }
+    return count + countSSE2(src + i, length - i);
+}
+
+MURMUR2_TARGET_AVX2 std::size_t compactAVX2(const char* src, std::size_t length, char* dst)
+{
+    std::size_t written = 0;
+    std::size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(whitespaceAVX2(v)));
+        if (mask == 0) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + written), v);
+            written += 32;
+        } else {
+            written += compactMasked(src + i, 32, mask, dst + written);
+        }
+    }
+    return written + compactSSE2(src + i, length - i, dst + written);
+}
+
+bool cpuSupportsAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    __cpuid(info, 1);
+    bool osxsave = info[2] & (1 << 27);
+    bool avx = info[2] & (1 << 28);
+    // the OS has to save the YMM registers for us too
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 5);
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#elif defined(MURMUR2_NEON)
+
+inline uint8x16_t whitespaceNEON(uint8x16_t v)
+{
+    return vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8(9)), vceqq_u8(v, vdupq_n_u8(10))),
+                    vorrq_u8(vceqq_u8(v, vdupq_n_u8(13)), vceqq_u8(v, vdupq_n_u8(32))));
+}
+
+std::size_t countNEON(const char* src, std::size_t length)
+{
+    std::size_t count = 0;
+    std::size_t i = 0;
+    while (i + 16 <= length) {
+        uint8x16_t acc = vdupq_n_u8(0);
+        for (int iter = 0; iter < 255 && i + 16 <= length; iter++, i += 16) {
+            auto v = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+            // matches are 0xFF, so subtracting them adds one
+            acc = vsubq_u8(acc, whitespaceNEON(v));
+        }
+        count += vaddlvq_u8(acc);
+    }
+    return count + countScalar(src + i, length - i);
+}
+
+std::size_t compactNEON(const char* src, std::size_t length, char* dst)
+{
+    std::size_t written = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        auto v = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+        if (vmaxvq_u8(whitespaceNEON(v)) == 0) {
+            vst1q_u8(reinterpret_cast<uint8_t*>(dst + written), v);
+            written += 16;
+        } else {
+            written += compactScalar(src + i, 16, dst + written);
+        }
+    }
+    return written + compactScalar(src + i, length - i, dst + written);
+}
+
+#endif
+
+const Kernels& selectKernels()
+{
+    static const Kernels kernels = [] {
+#if defined(MURMUR2_X86_64)
+        if (cpuSupportsAVX2())
+            return Kernels{ countAVX2, compactAVX2, "avx2" };
+        // SSE2 is always there on x86-64
+        return Kernels{ countSSE2, compactSSE2, "sse2" };
+#elif defined(MURMUR2_NEON)
+        return Kernels{ countNEON, compactNEON, "neon" };
+#else
+        return Kernels{ countScalar, compactScalar, "scalar" };
+#endif
+    }();
+    return kernels;
+}
+
+uint32_t fingerprint(const Kernels& kernels, const char* buffer, std::size_t length)
+{
+    auto size = static_cast<uint32_t>(length - kernels.count(buffer, length));
+
+    // This forces a seed of 1.
+    uint32_t h = 1 ^ size;
+
+    // room for a whole chunk, plus the bytes left over from the previous one
+    std::vector<char> staged(chunk_size + 4);
+    std::size_t carry = 0;
+
+    for (std::size_t offset = 0; offset < length; offset += chunk_size) {
+        auto read = std::min(chunk_size, length - offset);
+        auto available = carry + kernels.compact(buffer + offset, read, staged.data() + carry);
+
+        // Mix 4 bytes at a time into the hash
+        std::size_t i = 0;
+        for (; i + 4 <= available; i += 4) {
+            uint32_t k;
+            std::memcpy(&k, staged.data() + i, 4);
+
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+
+            h *= m;
+            h ^= k;
+        }
+
+        carry = available - i;
+        std::memmove(staged.data(), staged.data() + i, carry);
+    }
+
+    // Handle the last few bytes of the input array
+    auto tail = reinterpret_cast<const unsigned char*>(staged.data());
+    switch (carry) {
+        case 3:
+            h ^= tail[2] << 16;
+            [[fallthrough]];
+        case 2:
+            h ^= tail[1] << 8;
+            [[fallthrough]];
+        case 1:
+            h ^= tail[0];
+            h *= m;
+    };
+
+    // Do a few final mixes of the hash to ensure the last few
+    // bytes are well-incorporated.
+    h ^= h >> 13;
+    h *= m;
+    h ^= h >> 15;
+
+    return h;
+}
+
+}  // namespace
+
+uint32_t CurseForgeFingerprint(const char* buffer, std::size_t length)
+{
+    return fingerprint(selectKernels(), buffer, length);
+}
+
+uint32_t CurseForgeFingerprintScalar(const char* buffer, std::size_t length)
+{
+    static const Kernels scalar{ countScalar, compactScalar, "scalar" };
+    return fingerprint(scalar, buffer, length);
+}
+
+const char* CurseForgeFingerprintImplementation()
+{
+    return selectKernels().name;
+}
+
+//-----------------------------------------------------------------------------
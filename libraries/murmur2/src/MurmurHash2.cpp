@@ -68,6 +68,42 @@ uint32_t MurmurHash2(std::ifstream&& file_stream, std::size_t buffer_size, std::
     return info.h;
 }
 
+uint32_t MurmurHash2(const char* buffer, std::size_t length, std::function<bool(char)> filter_out)
+{
+    char data[4];
+
+    // We need the size without the filtered out characters before actually calculating the hash,
+    // to setup the initial value for the hash.
+    uint32_t size = 0;
+    for (std::size_t i = 0; i < length; i++) {
+        if (!filter_out(buffer[i]))
+            size += 1;
+    }
+
+    int index = 0;
+
+    // This forces a seed of 1.
+    IncrementalHashInfo info{ (uint32_t)1 ^ size, (uint32_t)size };
+    for (std::size_t i = 0; i < length; i++) {
+        char c = buffer[i];
+
+        if (filter_out(c))
+            continue;
+
+        data[index] = c;
+        index = (index + 1) % 4;
+
+        // Mix 4 bytes at a time into the hash
+        if (index == 0)
+            FourBytes_MurmurHash2(reinterpret_cast<unsigned char*>(&data), info);
+    }
+
+    // Do one last bit shuffle in the hash
+    FourBytes_MurmurHash2(reinterpret_cast<unsigned char*>(&data), info);
+
+    return info.h;
+}
+
 void FourBytes_MurmurHash2(const unsigned char* data, IncrementalHashInfo& prev)
 {
     if (prev.len >= 4) {
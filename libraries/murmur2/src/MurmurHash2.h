@@ -23,6 +23,26 @@ uint32_t MurmurHash2(
     std::size_t buffer_size = 4*MiB,
     std::function<bool(char)> filter_out = [](char) { return false; });
 
+// Same as above, for data that is already in memory (e.g. a mapped file)
+uint32_t MurmurHash2(
+    const char* buffer,
+    std::size_t length,
+    std::function<bool(char)> filter_out = [](char) { return false; });
+
+// CurseForge's fingerprint: MurmurHash2 (with a seed of 1) over the data with all the
+// whitespace bytes (9, 10, 13 and 32) taken out.
+//
+// The whitespace is searched for and compacted out with SIMD when the CPU supports it
+// (SSE2 / AVX2 on x86-64, picked at runtime, and NEON on ARM64).
+uint32_t CurseForgeFingerprint(const char* buffer, std::size_t length);
+
+// Same as above, without any SIMD. Gives the exact same results, it is only here to test
+// and benchmark the accelerated version against it.
+uint32_t CurseForgeFingerprintScalar(const char* buffer, std::size_t length);
+
+// Name of the implementation CurseForgeFingerprint() uses on this CPU ("avx2", "sse2", "neon" or "scalar")
+const char* CurseForgeFingerprintImplementation();
+
 struct IncrementalHashInfo {
     uint32_t h;
     uint32_t len;
@@ -56,4 +56,7 @@ struct DistributionInfo
 DistributionInfo getDistributionInfo();
 
 uint64_t getSystemRam();
+
+// memory that can be used without swapping, in bytes. 0 when it can't be found out
+uint64_t getAvailableRam();
 }
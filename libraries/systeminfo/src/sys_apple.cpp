@@ -55,6 +55,21 @@ uint64_t Sys::getSystemRam()
     }
 }
 
+#include <mach/mach.h>
+
+uint64_t Sys::getAvailableRam()
+{
+    vm_statistics64_data_t stats;
+    mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+    if(host_statistics64(mach_host_self(), HOST_VM_INFO64, (host_info64_t)&stats, &count) != KERN_SUCCESS)
+    {
+        return 0;
+    }
+    // what macOS gives back right away when asked, like the "available" of Activity Monitor
+    uint64_t pages = (uint64_t)stats.free_count + stats.inactive_count + stats.purgeable_count;
+    return pages * (uint64_t)vm_page_size;
+}
+
 Sys::DistributionInfo Sys::getDistributionInfo()
 {
     DistributionInfo result;
@@ -82,6 +82,33 @@ uint64_t Sys::getSystemRam()
     return 0; // nothing found
 }
 
+uint64_t Sys::getAvailableRam()
+{
+    std::string token;
+#ifdef Q_OS_LINUX
+    std::ifstream file("/proc/meminfo");
+    while(file >> token)
+    {
+        // the estimate of the kernel, with the caches it can drop
+        if(token == "MemAvailable:")
+        {
+            uint64_t mem;
+            if(file >> mem)
+            {
+                return mem * 1024ull;
+            }
+            else
+            {
+                return 0;
+            }
+        }
+        // ignore rest of the line
+        file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+#endif
+    return 0; // nothing found
+}
+
 Sys::DistributionInfo Sys::getDistributionInfo()
 {
     DistributionInfo systemd_info = read_os_release();
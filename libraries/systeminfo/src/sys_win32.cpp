@@ -27,6 +27,16 @@ uint64_t Sys::getSystemRam()
     return (uint64_t)status.ullTotalPhys;
 }
 
+uint64_t Sys::getAvailableRam()
+{
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (!GlobalMemoryStatusEx( &status ))
+        return 0;
+    // bytes
+    return (uint64_t)status.ullAvailPhys;
+}
+
 Sys::DistributionInfo Sys::getDistributionInfo()
 {
     DistributionInfo result;
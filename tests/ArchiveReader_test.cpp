@@ -0,0 +1,182 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <quazip/quazip.h>
+#include <quazip/quazipfile.h>
+
+#include <ArchiveReader.h>
+#include <FileSystem.h>
+#include <MMCZip.h>
+
+class ArchiveReaderTest : public QObject {
+    Q_OBJECT
+
+    static void writeFile(const QString& path, const QByteArray& data)
+    {
+        QVERIFY(FS::ensureFilePathExists(path));
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    }
+
+   private slots:
+    void test_ReadMatchesQuaZip_data()
+    {
+        QTest::addColumn<QString>("archive");
+
+        QTest::newRow("stored") << QFINDTESTDATA("testdata/ShaderPackParse/shaderpack1.zip");
+        QTest::newRow("deflated") << QFINDTESTDATA("testdata/ResourcePackParse/test_resource_pack_idk.zip");
+        QTest::newRow("mixed") << QFINDTESTDATA("testdata/DataPackParse/test_data_pack_boogaloo.zip");
+        QTest::newRow("nested") << QFINDTESTDATA("testdata/WorldSaveParse/minecraft_save_2.zip");
+    }
+    void test_ReadMatchesQuaZip()
+    {
+        QFETCH(QString, archive);
+
+        MMCZip::ArchiveReader reader(archive);
+        QVERIFY(reader.open());
+
+        QuaZip zip(archive);
+        QVERIFY(zip.open(QuaZip::mdUnzip));
+        QCOMPARE(reader.fileNames(), zip.getFileNameList());
+
+        QuaZipFile file(&zip);
+        for (bool more = zip.goToFirstFile(); more; more = zip.goToNextFile()) {
+            auto name = zip.getCurrentFileName();
+            QVERIFY(reader.contains(name));
+            if (name.endsWith('/'))
+                continue;
+
+            QVERIFY(file.open(QIODevice::ReadOnly));
+            auto expected = file.readAll();
+            file.close();
+
+            auto contents = reader.read(name);
+            QVERIFY(contents.has_value());
+            QCOMPARE(*contents, expected);
+        }
+
+        QVERIFY(!reader.contains("does/not/exist"));
+        QVERIFY(!reader.read("does/not/exist").has_value());
+    }
+
+    void test_FindFolderOfFile()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto source = FS::PathCombine(tmp.path(), "source");
+        writeFile(FS::PathCombine(source, "overrides/instance.cfg"), "ignored");
+        writeFile(FS::PathCombine(source, "pack/mods/mod.jar"), "jar");
+        writeFile(FS::PathCombine(source, "pack/instance.cfg"), "cfg");
+        writeFile(FS::PathCombine(source, "pack/sub/manifest.json"), "{}");
+        writeFile(FS::PathCombine(source, "readme.txt"), "hello");
+
+        QFileInfoList files;
+        QVERIFY(MMCZip::collectFileListRecursively(source, nullptr, &files, nullptr));
+        auto archive = FS::PathCombine(tmp.path(), "pack.zip");
+        QVERIFY(MMCZip::compressDirFiles(archive, source, files));
+
+        MMCZip::ArchiveReader reader(archive);
+        QVERIFY(reader.open());
+        QuaZip zip(archive);
+        QVERIFY(zip.open(QuaZip::mdUnzip));
+
+        QStringList ignore{ "overrides/" };
+        for (auto what : { "instance.cfg", "manifest.json", "readme.txt", "missing.txt" }) {
+            QCOMPARE(MMCZip::findFolderOfFileInZip(reader, what, ignore), MMCZip::findFolderOfFileInZip(&zip, what, ignore));
+            QCOMPARE(MMCZip::findFolderOfFileInZip(reader, what), MMCZip::findFolderOfFileInZip(&zip, what));
+        }
+
+        QCOMPARE(MMCZip::findFolderOfFileInZip(reader, "instance.cfg", ignore), QString("pack/"));
+        QCOMPARE(MMCZip::findFolderOfFileInZip(reader, "readme.txt"), QString(""));
+        QVERIFY(MMCZip::findFolderOfFileInZip(reader, "missing.txt").isNull());
+
+        QStringList whats{ "instance.cfg", "manifest.json", "readme.txt", "missing.txt" };
+        auto folders = reader.findFoldersOfFiles(whats, ignore);
+        QCOMPARE(folders.size(), whats.size());
+        for (int i = 0; i < whats.size(); i++) {
+            QCOMPARE(folders[i], reader.findFolderOfFile(whats[i], ignore));
+            QCOMPARE(folders[i].isNull(), reader.findFolderOfFile(whats[i], ignore).isNull());
+        }
+
+        QVERIFY(reader.containsDir("pack/sub"));
+        QVERIFY(reader.containsDir("/pack"));
+        QVERIFY(!reader.containsDir("sub"));
+    }
+
+    void test_ExtractSubDirMatchesQuaZip_data()
+    {
+        QTest::addColumn<QString>("archive");
+        QTest::addColumn<QString>("subdir");
+
+        QTest::newRow("stored") << QFINDTESTDATA("testdata/ShaderPackParse/shaderpack1.zip") << QString("");
+        QTest::newRow("deflated") << QFINDTESTDATA("testdata/ResourcePackParse/test_resource_pack_idk.zip") << QString("");
+        QTest::newRow("nested") << QFINDTESTDATA("testdata/WorldSaveParse/minecraft_save_2.zip") << QString("");
+    }
+    void test_ExtractSubDirMatchesQuaZip()
+    {
+        QFETCH(QString, archive);
+        QFETCH(QString, subdir);
+
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+
+        MMCZip::ArchiveReader reader(archive);
+        QVERIFY(reader.open());
+        auto extracted = MMCZip::extractSubDir(reader, subdir, FS::PathCombine(tmp.path(), "parallel"));
+        QVERIFY(extracted.has_value());
+
+        // what the zip holds, read through QuaZip
+        QuaZip zip(archive);
+        QVERIFY(zip.open(QuaZip::mdUnzip));
+        QuaZipFile file(&zip);
+        int files = 0;
+        for (bool more = zip.goToFirstFile(); more; more = zip.goToNextFile()) {
+            auto name = zip.getCurrentFileName();
+            auto path = FS::PathCombine(tmp.path(), "parallel", name);
+            if (name.endsWith('/')) {
+                QVERIFY(QFileInfo(path).isDir());
+                continue;
+            }
+            files++;
+
+            QVERIFY(file.open(QIODevice::ReadOnly));
+            auto expected = file.readAll();
+            file.close();
+
+            QFile extractedFile(path);
+            QVERIFY(extractedFile.open(QIODevice::ReadOnly));
+            QCOMPARE(extractedFile.readAll(), expected);
+        }
+        QVERIFY(extracted->size() >= files);
+    }
+
+    void test_ExtractEntriesLastOneWins()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto source = FS::PathCombine(tmp.path(), "source");
+        writeFile(FS::PathCombine(source, "a.txt"), "first");
+        writeFile(FS::PathCombine(source, "b.txt"), QByteArray("second\n").repeated(10000));
+
+        QFileInfoList files;
+        QVERIFY(MMCZip::collectFileListRecursively(source, nullptr, &files, nullptr));
+        auto archive = FS::PathCombine(tmp.path(), "pack.zip");
+        QVERIFY(MMCZip::compressDirFiles(archive, source, files));
+
+        MMCZip::ArchiveReader reader(archive);
+        QVERIFY(reader.open());
+        auto target = FS::PathCombine(tmp.path(), "target", "deep", "file.txt");
+        QStringList extracted;
+        QVERIFY(MMCZip::extractEntries(reader, { { reader.entry("a.txt"), target }, { reader.entry("b.txt"), target } }, {}, &extracted));
+        QCOMPARE(extracted, QStringList{ target });
+
+        QFile file(target);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll(), QByteArray("second\n").repeated(10000));
+    }
+};
+
+QTEST_GUILESS_MAIN(ArchiveReaderTest)
+
+#include "ArchiveReader_test.moc"
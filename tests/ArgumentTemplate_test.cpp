@@ -0,0 +1,77 @@
+#include <QTest>
+
+#include <launch/ArgumentTemplate.h>
+
+class ArgumentTemplateTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_Braced_data()
+    {
+        QTest::addColumn<QString>("text");
+        QTest::addColumn<QString>("expected");
+
+        QTest::newRow("plain") << "--demo" << "--demo";
+        QTest::newRow("variable") << "${auth_player_name}" << "Steve";
+        QTest::newRow("around") << "a${auth_player_name}b" << "aSteveb";
+        QTest::newRow("several") << "${version_name}-${auth_player_name}-${version_name}" << "1.20-Steve-1.20";
+        QTest::newRow("unknown") << "x${unknown}y" << "xy";
+        QTest::newRow("not closed") << "${auth_player_name" << "${auth_player_name";
+        QTest::newRow("empty") << "${}" << "${}";
+        QTest::newRow("dollar") << "$5 and $" << "$5 and $";
+        QTest::newRow("no recursion") << "${recursive}" << "${auth_player_name}";
+        QTest::newRow("nothing") << "" << "";
+    }
+    void test_Braced()
+    {
+        QFETCH(QString, text);
+        QFETCH(QString, expected);
+
+        ArgumentTemplate::Variables variables{ { "auth_player_name", "Steve" },
+                                               { "version_name", "1.20" },
+                                               { "recursive", "${auth_player_name}" } };
+        QCOMPARE(ArgumentTemplate(text).render(variables), expected);
+    }
+
+    void test_Shell_data()
+    {
+        QTest::addColumn<QString>("text");
+        QTest::addColumn<QString>("expected");
+
+        QTest::newRow("variable") << "$INST_DIR" << "/inst";
+        QTest::newRow("path") << "$INST_DIR/mods" << "/inst/mods";
+        QTest::newRow("longest") << "$INST_DIR_MC" << "/inst/.minecraft";
+        QTest::newRow("prefix") << "$INST_DIRECTORY" << "/instECTORY";
+        QTest::newRow("unknown") << "$NOPE and $" << "$NOPE and $";
+        QTest::newRow("braces stay") << "${INST_DIR}" << "${INST_DIR}";
+        QTest::newRow("no recursion") << "$RECURSIVE" << "$INST_DIR";
+    }
+    void test_Shell()
+    {
+        QFETCH(QString, text);
+        QFETCH(QString, expected);
+
+        ArgumentTemplate::Variables variables{ { "INST_DIR", "/inst" },
+                                               { "INST_DIR_MC", "/inst/.minecraft" },
+                                               { "RECURSIVE", "$INST_DIR" } };
+        QCOMPARE(ArgumentTemplate(text, ArgumentTemplate::Syntax::Shell).render(variables), expected);
+    }
+
+    void test_Arguments()
+    {
+        auto templates = ArgumentTemplate::parseArguments("  --username ${auth_player_name}   --version ${version_name} ");
+        QCOMPARE(templates.size(), 4);
+        QCOMPARE(templates[1].variables(), QStringList({ "auth_player_name" }));
+        QCOMPARE(templates[0].variables(), QStringList());
+
+        ArgumentTemplate::Variables variables{ { "auth_player_name", "Steve" }, { "version_name", "1.20" } };
+        QCOMPARE(ArgumentTemplate::render(templates, variables), QStringList({ "--username", "Steve", "--version", "1.20" }));
+        // the same templates, other variables
+        variables["auth_player_name"] = "Alex";
+        QCOMPARE(ArgumentTemplate::render(templates, variables), QStringList({ "--username", "Alex", "--version", "1.20" }));
+    }
+};
+
+QTEST_GUILESS_MAIN(ArgumentTemplateTest)
+
+#include "ArgumentTemplate_test.moc"
@@ -0,0 +1,120 @@
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <minecraft/AssetsUtils.h>
+
+namespace {
+const QString s_hash_a = "bdf48ef6b5d0d23bbb02e17d04865216179f510a";
+const QString s_hash_b = "0123456789abcdef0123456789abcdef01234567";
+
+bool write(const QString& path, const QByteArray& contents)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size();
+}
+}  // namespace
+
+class AssetsIndexTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_tmp;
+    QString m_previous_dir;
+
+   private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_tmp.isValid());
+        m_previous_dir = QDir::currentPath();
+        // the objects are looked for under assets/objects of the current folder, like for the launcher
+        QDir::setCurrent(m_tmp.path());
+    }
+
+    void cleanupTestCase() { QDir::setCurrent(m_previous_dir); }
+
+    void test_Parse()
+    {
+        auto path = m_tmp.filePath("index.json");
+        QVERIFY(write(path, QString(R"({
+            "future": [1, 2.5e3, {"nested": null}, "x"],
+            "virtual": true,
+            "objects": {
+                "minecraft/sounds/b.ogg": { "size": 12, "hash": "%2" },
+                "minecraft/lang/é😀.json": { "hash": "%1", "size": 3665, "extra": [true] },
+                "icons/icon_16x16.png": { "hash": "%1", "size": 1 },
+                "icons\/icon_16x16.png": { "hash": "%2", "size": 2 }
+            }
+        })")
+                                .arg(s_hash_a, s_hash_b)
+                                .toUtf8()));
+
+        AssetsIndex index;
+        QVERIFY(AssetsUtils::loadAssetsIndexJson("test", path, index));
+        QCOMPARE(index.id, QString("test"));
+        QVERIFY(index.isVirtual);
+        QVERIFY(!index.mapToResources);
+
+        // sorted by path, and the last one of a path wins
+        QCOMPARE(index.size(), 3);
+        QCOMPARE(index.path(0), QString("icons/icon_16x16.png"));
+        QCOMPARE(index.object(0).hash, s_hash_b);
+        QCOMPARE(index.object(0).size, qint64(2));
+        QCOMPARE(index.path(1), QString::fromUtf8("minecraft/lang/\xc3\xa9\xf0\x9f\x98\x80.json"));
+        QCOMPARE(index.object(1).hash, s_hash_a);
+        QCOMPARE(index.object(1).getRelPath(), "bd/" + s_hash_a);
+        QCOMPARE(index.path(2), QString("minecraft/sounds/b.ogg"));
+
+        QVERIFY(index.contains("minecraft/sounds/b.ogg"));
+        QVERIFY(index.contains(QString::fromUtf8("minecraft/lang/\xc3\xa9\xf0\x9f\x98\x80.json")));
+        QVERIFY(!index.contains("minecraft/sounds"));
+        QVERIFY(!index.contains("zzz"));
+    }
+
+    void test_Invalid_data()
+    {
+        QTest::addColumn<QByteArray>("contents");
+        QTest::newRow("truncated") << QByteArray(R"({"objects": {"a": {"hash": ")");
+        QTest::newRow("not a sha1") << QByteArray(R"({"objects": {"a": {"hash": "abc", "size": 1}}})");
+        QTest::newRow("no hash") << QByteArray(R"({"objects": {"a": {"size": 1}}})");
+        QTest::newRow("garbage") << QByteArray(R"({"objects": {}} x)");
+        QTest::newRow("not an object") << QByteArray(R"([])");
+    }
+    void test_Invalid()
+    {
+        QFETCH(QByteArray, contents);
+        auto path = m_tmp.filePath("invalid.json");
+        QVERIFY(write(path, contents));
+        AssetsIndex index;
+        QVERIFY(!AssetsUtils::loadAssetsIndexJson("test", path, index));
+    }
+
+    void test_MissingObjects()
+    {
+        auto path = m_tmp.filePath("objects.json");
+        QVERIFY(write(path, QString(R"({"objects": {"a": {"hash": "%1", "size": 3}, "b": {"hash": "%2", "size": 5}}})")
+                                .arg(s_hash_a, s_hash_b)
+                                .toUtf8()));
+        AssetsIndex index;
+        QVERIFY(AssetsUtils::loadAssetsIndexJson("test", path, index));
+        QCOMPARE(index.missingObjects(), (QList<int>{ 0, 1 }));
+
+        QVERIFY(FS::ensureFolderPathExists("assets/objects/bd"));
+        QVERIFY(FS::ensureFolderPathExists("assets/objects/01"));
+        QVERIFY(write("assets/objects/bd/" + s_hash_a, "abc"));
+        // not at its size
+        QVERIFY(write("assets/objects/01/" + s_hash_b, "abc"));
+        QCOMPARE(index.missingObjects(), QList<int>{ 1 });
+        // again, from what was there the last time
+        QCOMPARE(index.missingObjects(), QList<int>{ 1 });
+
+        // a folder that changed is looked at again
+        QVERIFY(QFile::remove("assets/objects/bd/" + s_hash_a));
+        QCOMPARE(index.missingObjects(), (QList<int>{ 0, 1 }));
+    }
+};
+
+QTEST_GUILESS_MAIN(AssetsIndexTest)
+
+#include "AssetsIndex_test.moc"
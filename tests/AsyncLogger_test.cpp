@@ -0,0 +1,89 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <thread>
+#include <vector>
+
+#include <AsyncLogger.h>
+
+class AsyncLoggerTest : public QObject {
+    Q_OBJECT
+
+    QStringList readLines(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QFile::ReadOnly | QFile::Text))
+            return {};
+        auto lines = QString::fromUtf8(file.readAll()).split('\n');
+        lines.removeAll(QString());
+        return lines;
+    }
+
+   private slots:
+    void test_Threads()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("log.txt");
+        auto file = std::unique_ptr<QFile>(new QFile(path));
+        QVERIFY(file->open(QFile::WriteOnly | QFile::Text));
+
+        constexpr int threads = 4;
+        // more than fit in the queue at once
+        constexpr int lines = 5000;
+        {
+            AsyncLogger logger(std::move(file));
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&logger, t] {
+                    for (int i = 0; i < lines; i++)
+                        logger.log(QtDebugMsg, "test", QString("%1 %2\n").arg(t).arg(i));
+                });
+            }
+            for (auto& worker : workers)
+                worker.join();
+            logger.stop();
+            logger.log(QtWarningMsg, "test", "after\n");
+        }
+
+        auto written = readLines(path);
+        QCOMPARE(written.size(), threads * lines + 1);
+        QCOMPARE(written.last(), QString("after"));
+
+        // the lines of every thread stay in their order
+        std::vector<int> next(threads, 0);
+        for (int i = 0; i < written.size() - 1; i++) {
+            auto parts = written[i].split(' ');
+            auto t = parts[0].toInt();
+            QCOMPARE(parts[1].toInt(), next[t]);
+            next[t]++;
+        }
+    }
+
+    void test_RateLimit()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("log.txt");
+        auto file = std::unique_ptr<QFile>(new QFile(path));
+        QVERIFY(file->open(QFile::WriteOnly | QFile::Text));
+
+        {
+            AsyncLogger logger(std::move(file));
+            logger.setRateLimits({ { "noisy", 10 } });
+            for (int i = 0; i < 100; i++) {
+                logger.log(QtDebugMsg, "noisy", "noisy\n");
+                logger.log(QtDebugMsg, "quiet", "quiet\n");
+            }
+        }
+
+        auto written = readLines(path);
+        QCOMPARE(written.count("quiet"), 100);
+        // usually 10, but the second may have turned over in between
+        auto noisy = written.count("noisy");
+        QVERIFY(noisy >= 10 && noisy <= 20);
+        QVERIFY(!written.filter("messages dropped").isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(AsyncLoggerTest)
+
+#include "AsyncLogger_test.moc"
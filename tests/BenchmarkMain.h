@@ -0,0 +1,144 @@
+#pragma once
+
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QXmlStreamReader>
+
+#include <optional>
+
+#include <Exception.h>
+#include <FileSystem.h>
+
+/* Runs a QtTest benchmark object, optionally writing the results as JSON and comparing them to a baseline.
+ *
+ * `--json <file>` writes {"benchmarks": [{"name", "tag", "metric", "value", "iterations"}, ...]} to the file,
+ * converted from QtTest's XML output. `--baseline <file>` compares the results to such a file, kept from a run of the
+ * previous release on the same machine, and fails when one got slower by more than `--tolerance <percent>` (10 by
+ * default). Any other argument goes to QtTest (`-iterations`, `-callgrind`, a function name, ...), and the usual text
+ * output still goes to the console.
+ */
+namespace BenchmarkMain {
+
+inline std::optional<QJsonArray> readResults(const QString& xml_path)
+{
+    QFile xml_file(xml_path);
+    if (!xml_file.open(QIODevice::ReadOnly))
+        return std::nullopt;
+
+    QJsonArray benchmarks;
+    QString function;
+    QXmlStreamReader xml(&xml_file);
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement)
+            continue;
+        auto attributes = xml.attributes();
+        if (xml.name() == QLatin1String("TestFunction")) {
+            function = attributes.value("name").toString();
+        } else if (xml.name() == QLatin1String("BenchmarkResult")) {
+            benchmarks.append(QJsonObject{
+                { "name", function },
+                { "tag", attributes.value("tag").toString() },
+                { "metric", attributes.value("metric").toString() },
+                { "value", attributes.value("value").toDouble() },
+                { "iterations", attributes.value("iterations").toInt() },
+            });
+        }
+    }
+    if (xml.hasError()) {
+        qWarning() << "Couldn't read the benchmark results:" << xml.errorString();
+        return std::nullopt;
+    }
+    return benchmarks;
+}
+
+inline bool writeJson(const QJsonArray& benchmarks, const QString& json_path)
+{
+    try {
+        FS::write(json_path, QJsonDocument(QJsonObject{ { "benchmarks", benchmarks } }).toJson());
+    } catch (const Exception& e) {
+        qWarning() << e.cause();
+        return false;
+    }
+    return true;
+}
+
+/* Whether none of the benchmarks got slower than in the baseline by more than `tolerance` percent.
+ * The ones that aren't in the baseline, or in another metric, aren't compared. */
+inline bool compareToBaseline(const QJsonArray& benchmarks, const QString& baseline_path, double tolerance)
+{
+    QFile baseline_file(baseline_path);
+    if (!baseline_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Couldn't read the baseline" << baseline_path;
+        return false;
+    }
+    QHash<QString, double> baseline;
+    auto keyOf = [](const QJsonObject& result) {
+        return result["name"].toString() + '/' + result["tag"].toString() + '/' + result["metric"].toString();
+    };
+    for (auto result : QJsonDocument::fromJson(baseline_file.readAll()).object()["benchmarks"].toArray())
+        baseline.insert(keyOf(result.toObject()), result.toObject()["value"].toDouble());
+
+    bool ok = true;
+    for (auto value : benchmarks) {
+        auto result = value.toObject();
+        auto key = keyOf(result);
+        auto before = baseline.value(key, 0);
+        if (before <= 0)
+            continue;
+        auto change = (result["value"].toDouble() - before) / before * 100;
+        if (change > tolerance) {
+            qWarning().noquote() << QString("REGRESSION %1: %2 -> %3 (%4%)").arg(key).arg(before).arg(result["value"].toDouble()).arg(change, 0, 'f', 1);
+            ok = false;
+        } else {
+            qInfo().noquote() << QString("%1: %2 -> %3 (%4%)").arg(key).arg(before).arg(result["value"].toDouble()).arg(change, 0, 'f', 1);
+        }
+    }
+    return ok;
+}
+
+inline int run(QObject* benchmarks, QStringList arguments)
+{
+    auto takeOption = [&arguments](const QString& name) {
+        QString value;
+        auto arg = arguments.indexOf(name);
+        if (arg != -1 && arg + 1 < arguments.size()) {
+            value = arguments.takeAt(arg + 1);
+            arguments.removeAt(arg);
+        }
+        return value;
+    };
+    auto json_path = takeOption("--json");
+    auto baseline_path = takeOption("--baseline");
+    bool tolerance_ok = false;
+    auto tolerance = takeOption("--tolerance").toDouble(&tolerance_ok);
+    if (!tolerance_ok)
+        tolerance = 10;
+
+    QTemporaryDir tmp;
+    QString xml_path;
+    if (!json_path.isEmpty() || !baseline_path.isEmpty()) {
+        xml_path = FS::PathCombine(tmp.path(), "results.xml");
+        arguments << "-o" << "-,txt" << "-o" << xml_path + ",xml";
+    }
+
+    auto result = QTest::qExec(benchmarks, arguments);
+    if (xml_path.isEmpty())
+        return result;
+
+    auto results = readResults(xml_path);
+    if (!results)
+        return 1;
+    if (!json_path.isEmpty() && !writeJson(*results, json_path))
+        return 1;
+    if (!baseline_path.isEmpty() && !compareToBaseline(*results, baseline_path, tolerance))
+        return 1;
+    return result;
+}
+
+}  // namespace BenchmarkMain
@@ -0,0 +1,70 @@
+#include <QTest>
+
+#include <ConcurrentCache.h>
+
+class ConcurrentCacheTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_Find()
+    {
+        ConcurrentCache<QString, QString> cache(1024 * 1024);
+        QString found;
+        QVERIFY(!cache.find("a", &found));
+
+        QVERIFY(cache.insert("a", "first", 10));
+        QVERIFY(cache.find("a", &found));
+        QCOMPARE(found, QString("first"));
+        QVERIFY(cache.insert("a", "second", 10));
+        QVERIFY(cache.find("a", &found));
+        QCOMPARE(found, QString("second"));
+
+        auto stats = cache.stats();
+        QCOMPARE(stats.hits, qint64(2));
+        QCOMPARE(stats.misses, qint64(1));
+        QCOMPARE(stats.count, 1);
+
+        cache.remove("a");
+        QVERIFY(!cache.find("a", nullptr));
+    }
+
+    void test_Stale()
+    {
+        ConcurrentCache<QString, int> cache(1024 * 1024);
+        QVERIFY(cache.stale("a"));
+        cache.insert("a", 1, 10);
+        QVERIFY(!cache.stale("a"));
+
+        // still there until it's replaced
+        cache.setStale("a");
+        QVERIFY(cache.stale("a"));
+        QVERIFY(cache.find("a", nullptr));
+        cache.insert("a", 2, 10);
+        QVERIFY(!cache.stale("a"));
+    }
+
+    void test_Eviction()
+    {
+        // one shard of 64 KiB, that keeps 4 entries of 16 KiB
+        ConcurrentCache<int, int, 1> cache(64 * 1024);
+        QVERIFY(!cache.insert(100, 100, 128 * 1024));
+        for (int i = 0; i < 4; i++)
+            QVERIFY(cache.insert(i, i, 16 * 1024));
+        QCOMPARE(cache.stats().bytes, qint64(64 * 1024));
+
+        // the one used last stays, the one used the longest ago goes
+        QVERIFY(cache.find(0, nullptr));
+        QVERIFY(cache.insert(4, 4, 16 * 1024));
+        QVERIFY(cache.find(0, nullptr));
+        QVERIFY(!cache.find(1, nullptr));
+        QCOMPARE(cache.stats().count, 4);
+
+        cache.clear();
+        QCOMPARE(cache.stats().count, 0);
+        QCOMPARE(cache.stats().bytes, qint64(0));
+    }
+};
+
+QTEST_GUILESS_MAIN(ConcurrentCacheTest)
+
+#include "ConcurrentCache_test.moc"
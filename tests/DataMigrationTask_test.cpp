@@ -0,0 +1,125 @@
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <DataMigrationTask.h>
+#include <FileSystem.h>
+#include <pathmatcher/PathRuleMatcher.h>
+
+namespace {
+bool write(const QString& path, const QByteArray& contents)
+{
+    if (!FS::ensureFilePathExists(path))
+        return false;
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size();
+}
+
+QByteArray read(const QString& path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+bool run(DataMigrationTask& task)
+{
+    QSignalSpy spy(&task, &Task::finished);
+    task.start();
+    // it fails right away on a missing source
+    return (!spy.isEmpty() || spy.wait(10000)) && task.wasSuccessful();
+}
+
+IPathMatcher::Ptr matcher()
+{
+    auto matcher = std::make_shared<PathRuleMatcher>();
+    matcher->addPath("instances").addPath("accounts.json");
+    return matcher;
+}
+
+void fill(const QString& root)
+{
+    QVERIFY(write(root + "/accounts.json", "{}"));
+    QVERIFY(write(root + "/instances/a/instance.cfg", "name=a"));
+    QVERIFY(write(root + "/instances/a/.minecraft/mods/mod.jar", QByteArray(8192, 'm')));
+    QVERIFY(write(root + "/instances/b/instance.cfg", "name=b"));
+    // not migrated
+    QVERIFY(write(root + "/cache/big.bin", QByteArray(8192, 'c')));
+}
+}  // namespace
+
+class DataMigrationTaskTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_Copy()
+    {
+        QTemporaryDir tmp;
+        auto old_data = tmp.filePath("old");
+        auto new_data = tmp.filePath("new");
+        fill(old_data);
+
+        DataMigrationTask task(nullptr, old_data, new_data, matcher());
+        QVERIFY(run(task));
+        QCOMPARE(read(new_data + "/accounts.json"), QByteArray("{}"));
+        QCOMPARE(read(new_data + "/instances/a/instance.cfg"), QByteArray("name=a"));
+        QCOMPARE(read(new_data + "/instances/a/.minecraft/mods/mod.jar"), QByteArray(8192, 'm'));
+        QCOMPARE(read(new_data + "/instances/b/instance.cfg"), QByteArray("name=b"));
+        QVERIFY(!QFile::exists(new_data + "/cache/big.bin"));
+        // in bytes
+        QCOMPARE(task.getProgress(), qint64(2 + 6 + 8192 + 6));
+        QCOMPARE(task.getTotalProgress(), task.getProgress());
+
+        // and the old launcher still has everything
+        QCOMPARE(read(old_data + "/instances/a/instance.cfg"), QByteArray("name=a"));
+        QCOMPARE(FS::hardLinkCount(old_data + "/instances/a/.minecraft/mods/mod.jar"), uintmax_t(1));
+    }
+
+    void test_HardLink()
+    {
+        QTemporaryDir tmp;
+        auto old_data = tmp.filePath("old");
+        auto new_data = tmp.filePath("new");
+        fill(old_data);
+        if (!DataMigrationTask::methods(old_data, new_data).contains(DataMigrationTask::Method::HardLink))
+            QSKIP("The temporary folder can't have hard links");
+
+        DataMigrationTask task(nullptr, old_data, new_data, matcher(), DataMigrationTask::Method::HardLink);
+        QVERIFY(run(task));
+        QCOMPARE(read(new_data + "/instances/a/.minecraft/mods/mod.jar"), QByteArray(8192, 'm'));
+        QCOMPARE(FS::hardLinkCount(new_data + "/instances/a/.minecraft/mods/mod.jar"), uintmax_t(2));
+        QVERIFY(!QFile::exists(new_data + "/cache/big.bin"));
+    }
+
+    void test_Move()
+    {
+        QTemporaryDir tmp;
+        auto old_data = tmp.filePath("old");
+        auto new_data = tmp.filePath("new");
+        fill(old_data);
+        QVERIFY(DataMigrationTask::methods(old_data, new_data).contains(DataMigrationTask::Method::Move));
+
+        DataMigrationTask task(nullptr, old_data, new_data, matcher(), DataMigrationTask::Method::Move);
+        QVERIFY(run(task));
+        QCOMPARE(read(new_data + "/accounts.json"), QByteArray("{}"));
+        QCOMPARE(read(new_data + "/instances/a/.minecraft/mods/mod.jar"), QByteArray(8192, 'm'));
+        QCOMPARE(read(new_data + "/instances/b/instance.cfg"), QByteArray("name=b"));
+
+        // the folders moved out of are gone, what wasn't migrated stays
+        QVERIFY(!QFile::exists(old_data + "/accounts.json"));
+        QVERIFY(!QDir(old_data + "/instances").exists());
+        QCOMPARE(read(old_data + "/cache/big.bin"), QByteArray(8192, 'c'));
+    }
+
+    void test_MissingSource()
+    {
+        QTemporaryDir tmp;
+        DataMigrationTask task(nullptr, tmp.filePath("nothing"), tmp.filePath("new"), matcher());
+        QVERIFY(!run(task));
+    }
+};
+
+QTEST_GUILESS_MAIN(DataMigrationTaskTest)
+
+#include "DataMigrationTask_test.moc"
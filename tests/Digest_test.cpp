@@ -0,0 +1,89 @@
+#include <QBuffer>
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <digest/Digest.h>
+
+class DigestTest : public QObject {
+    Q_OBJECT
+
+    QByteArray m_data;
+
+    QList<QCryptographicHash::Algorithm> algorithms() const
+    {
+        return { QCryptographicHash::Sha1, QCryptographicHash::Sha224, QCryptographicHash::Sha256, QCryptographicHash::Sha384,
+                 QCryptographicHash::Sha512 };
+    }
+
+   private slots:
+    void initTestCase()
+    {
+        QRandomGenerator rng(3);
+        m_data = QByteArray(300 * 1024, Qt::Uninitialized);
+        for (auto& c : m_data)
+            c = static_cast<char>(rng.bounded(256));
+    }
+
+    void test_knownAnswers()
+    {
+        QCOMPARE(Digest::hash("abc", QCryptographicHash::Sha1).toHex(), QByteArray("a9993e364706816aba3e25717850c26c9cd0d89d"));
+        QCOMPARE(Digest::hash("", QCryptographicHash::Sha256).toHex(),
+                 QByteArray("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+        QCOMPARE(Digest::hash("abc", QCryptographicHash::Sha512).toHex(),
+                 QByteArray("ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+                            "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f"));
+    }
+
+    // every implementation this CPU runs, around the block and padding boundaries, added whole and in pieces
+    void test_matchesQt()
+    {
+        for (auto algorithm : algorithms()) {
+            auto implementations = Digest::implementations(algorithm);
+            QVERIFY(implementations.contains("generic"));
+            for (auto& implementation : implementations) {
+                Digest digest(algorithm, implementation);
+                for (int size : { 0, 1, 55, 56, 63, 64, 65, 111, 112, 127, 128, 129, 1000, int(m_data.size()) }) {
+                    auto data = m_data.left(size);
+                    auto expected = QCryptographicHash::hash(data, algorithm);
+
+                    digest.reset();
+                    digest.addData(data);
+                    QCOMPARE(digest.result(), expected);
+
+                    digest.reset();
+                    for (int i = 0; i < size; i += 7)
+                        digest.addData(data.constData() + i, std::min(7, size - i));
+                    QCOMPARE(digest.result(), expected);
+                }
+            }
+        }
+    }
+
+    void test_device()
+    {
+        QBuffer buffer(&m_data);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        Digest digest(QCryptographicHash::Sha1);
+        QVERIFY(digest.addData(&buffer));
+        QCOMPARE(digest.result(), QCryptographicHash::hash(m_data, QCryptographicHash::Sha1));
+    }
+
+    void test_resultTwice()
+    {
+        Digest digest(QCryptographicHash::Sha256);
+        digest.addData(m_data);
+        auto first = digest.result();
+        QCOMPARE(digest.result(), first);
+    }
+
+    // what isn't SHA-1 or SHA-2 goes to QCryptographicHash
+    void test_otherAlgorithms()
+    {
+        QVERIFY(Digest::implementations(QCryptographicHash::Md5).isEmpty());
+        QCOMPARE(Digest::hash(m_data, QCryptographicHash::Md5), QCryptographicHash::hash(m_data, QCryptographicHash::Md5));
+    }
+};
+
+QTEST_GUILESS_MAIN(DigestTest)
+
+#include "Digest_test.moc"
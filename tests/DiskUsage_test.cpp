@@ -0,0 +1,126 @@
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <DiskUsage.h>
+#include <FileSystem.h>
+#include <minecraft/ShaderCache.h>
+
+class DiskUsageTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_tmp;
+
+    void writeBytes(const QString& path, int size)
+    {
+        QVERIFY(FS::ensureFilePathExists(path));
+        FS::write(path, QByteArray(size, 'x'));
+    }
+
+    void age(const QString& path, int days)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QFile::ReadWrite));
+        QVERIFY(file.setFileTime(QDateTime::currentDateTime().addDays(-days), QFileDevice::FileModificationTime));
+    }
+
+   private slots:
+    void initTestCase() { QVERIFY(m_tmp.isValid()); }
+
+    void test_Categorize()
+    {
+        QCOMPARE(DiskUsage::categorize("saves"), DiskUsage::Category::Worlds);
+        QCOMPARE(DiskUsage::categorize("coremods"), DiskUsage::Category::Mods);
+        QCOMPARE(DiskUsage::categorize("texturepacks"), DiskUsage::Category::ResourcePacks);
+        QCOMPARE(DiskUsage::categorize("crash-reports"), DiskUsage::Category::CrashReports);
+        QCOMPARE(DiskUsage::categorize(".fabric"), DiskUsage::Category::Caches);
+        QCOMPARE(DiskUsage::categorize(".shadercache"), DiskUsage::Category::ShaderCache);
+        QCOMPARE(DiskUsage::categorize("options.txt"), DiskUsage::Category::Other);
+    }
+
+    void test_Scan()
+    {
+        auto instance = m_tmp.filePath("scan");
+        auto game = FS::PathCombine(instance, ".minecraft");
+        writeBytes(FS::PathCombine(instance, "instance.cfg"), 10);
+        writeBytes(FS::PathCombine(game, "saves/World/level.dat"), 100);
+        writeBytes(FS::PathCombine(game, "saves/World/region/r.0.0.mca"), 1000);
+        writeBytes(FS::PathCombine(game, "mods/sodium.jar"), 200);
+        writeBytes(FS::PathCombine(game, "logs/latest.log"), 30);
+        writeBytes(FS::PathCombine(game, ".cache/thing"), 40);
+        writeBytes(FS::PathCombine(game, "options.txt"), 5);
+
+        auto snapshot = DiskUsage::scan(instance, game);
+        auto usage = DiskUsage::usageOf(snapshot);
+        QCOMPARE(usage.of(DiskUsage::Category::Worlds), qint64(1100));
+        QCOMPARE(usage.of(DiskUsage::Category::Mods), qint64(200));
+        QCOMPARE(usage.of(DiskUsage::Category::Logs), qint64(30));
+        QCOMPARE(usage.of(DiskUsage::Category::Caches), qint64(40));
+        // the instance.cfg and the options
+        QCOMPARE(usage.of(DiskUsage::Category::Other), qint64(15));
+        QCOMPARE(usage.total(), qint64(1385));
+        QVERIFY(snapshot.contains("../instance.cfg"));
+
+        // what didn't change at the top is taken from before, unless measuring it all again
+        auto previous = snapshot;
+        previous["saves"].bytes = 1;
+        QCOMPARE(DiskUsage::usageOf(DiskUsage::scan(instance, game, previous, false)).of(DiskUsage::Category::Worlds), qint64(1));
+        QCOMPARE(DiskUsage::usageOf(DiskUsage::scan(instance, game, previous, true)).of(DiskUsage::Category::Worlds), qint64(1100));
+
+        // a new mod changes the folder, which is measured again
+        previous["mods"].mtime = 0;
+        QCOMPARE(DiskUsage::usageOf(DiskUsage::scan(instance, game, previous, false)).of(DiskUsage::Category::Mods), qint64(200));
+    }
+
+    void test_CleanUp()
+    {
+        auto game = m_tmp.filePath("cleanup");
+        writeBytes(FS::PathCombine(game, "logs/latest.log"), 10);
+        writeBytes(FS::PathCombine(game, "logs/2026-01-01-1.log.gz"), 20);
+        writeBytes(FS::PathCombine(game, "logs/yesterday.log.gz"), 40);
+        writeBytes(FS::PathCombine(game, "crash-reports/crash.txt"), 50);
+        writeBytes(FS::PathCombine(game, ".fabric/processedMods/a.jar"), 60);
+        writeBytes(FS::PathCombine(game, "mods/a.jar"), 70);
+        age(FS::PathCombine(game, "logs/latest.log"), 30);
+        age(FS::PathCombine(game, "logs/2026-01-01-1.log.gz"), 30);
+        age(FS::PathCombine(game, "logs/yesterday.log.gz"), 1);
+
+        auto week_ago = QDateTime::currentDateTime().addDays(-7);
+        QCOMPARE(DiskUsage::cleanUp(game, DiskUsage::Cleanup::OldLogs, week_ago), qint64(20));
+        QVERIFY(QFile::exists(FS::PathCombine(game, "logs/latest.log")));
+        QVERIFY(QFile::exists(FS::PathCombine(game, "logs/yesterday.log.gz")));
+
+        QCOMPARE(DiskUsage::cleanUp(game, DiskUsage::Cleanup::CrashReports), qint64(50));
+        QCOMPARE(DiskUsage::cleanUp(game, DiskUsage::Cleanup::Caches), qint64(60));
+        QVERIFY(!QFileInfo::exists(FS::PathCombine(game, ".fabric")));
+        QVERIFY(QFile::exists(FS::PathCombine(game, "mods/a.jar")));
+    }
+
+    void test_ShaderCache()
+    {
+        auto instance = m_tmp.filePath("shadercache");
+        auto game = FS::PathCombine(instance, ".minecraft");
+        auto cache = ShaderCache::path(game);
+        QProcessEnvironment env;
+        ShaderCache::setUp(env, cache, 512);
+        QCOMPARE(env.value("MESA_SHADER_CACHE_DIR"), FS::PathCombine(cache, "mesa"));
+        QCOMPARE(env.value("MESA_SHADER_CACHE_MAX_SIZE"), QString("512M"));
+        QCOMPARE(env.value("__GL_SHADER_DISK_CACHE_PATH"), FS::PathCombine(cache, "nvidia"));
+        QCOMPARE(env.value("__GL_SHADER_DISK_CACHE_SIZE"), QString::number(512 * 1024 * 1024));
+        // NVIDIA doesn't make the folder by itself
+        QVERIFY(QFileInfo(FS::PathCombine(cache, "nvidia")).isDir());
+
+        writeBytes(FS::PathCombine(cache, "mesa/index"), 80);
+        writeBytes(FS::PathCombine(game, ".cache/thing"), 40);
+        QCOMPARE(DiskUsage::usageOf(DiskUsage::scan(instance, game)).of(DiskUsage::Category::ShaderCache), qint64(80));
+        QCOMPARE(DiskUsage::cleanUp(game, DiskUsage::Cleanup::ShaderCache), qint64(80));
+        QVERIFY(!QFileInfo::exists(cache));
+        QVERIFY(QFile::exists(FS::PathCombine(game, ".cache/thing")));
+    }
+};
+
+QTEST_GUILESS_MAIN(DiskUsageTest)
+
+#include "DiskUsage_test.moc"
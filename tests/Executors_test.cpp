@@ -0,0 +1,70 @@
+#include <QTest>
+#include <QThread>
+
+#include <atomic>
+
+#include <Executors.h>
+
+class ExecutorsTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_WaitsForItsOwn()
+    {
+        std::atomic_bool release_other{ false };
+        std::atomic_int done{ 0 };
+
+        // someone else's long work on the same pool
+        Executors::WorkGroup other;
+        other.run(Executors::io(), [&] {
+            while (!release_other)
+                QThread::msleep(5);
+        });
+
+        {
+            Executors::WorkGroup group;
+            for (int i = 0; i < 3; i++)
+                group.run(Executors::io(), [&] { done += 1; });
+            group.waitForDone();
+            QVERIFY(!group.isBusy());
+            QCOMPARE(done.load(), 3);
+            QVERIFY(other.isBusy());
+        }
+
+        release_other = true;
+        other.waitForDone();
+        QVERIFY(!other.isBusy());
+    }
+
+    void test_CancelBeforeStart()
+    {
+        std::atomic_bool release{ false };
+        std::atomic_bool ran{ false };
+
+        // holds the only thread of the pool, so what comes next has to wait
+        Executors::WorkGroup blocker;
+        blocker.run(Executors::background(), [&] {
+            while (!release)
+                QThread::msleep(5);
+        });
+
+        struct Flag : QRunnable {
+            std::atomic_bool& ran;
+            explicit Flag(std::atomic_bool& ran) : ran(ran) { setAutoDelete(false); }
+            void run() override { ran = true; }
+        } runnable(ran);
+
+        Executors::WorkGroup group;
+        group.start(Executors::background(), &runnable);
+        group.cancel();
+        release = true;
+        group.waitForDone();
+
+        QVERIFY(group.isCanceled());
+        QVERIFY(!ran);
+    }
+};
+
+QTEST_GUILESS_MAIN(ExecutorsTest)
+
+#include "Executors_test.moc"
@@ -0,0 +1,54 @@
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileLease.h>
+#include <FileSystem.h>
+
+class FileLeaseTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_OneHolder()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = FS::PathCombine(tmp.path(), "file.jar");
+
+        FileLease first(path);
+        FileLease second(path);
+        QVERIFY(first.tryAcquire());
+        QVERIFY(first.isHeld());
+        // taking it again is fine for the holder, nobody else gets it
+        QVERIFY(first.tryAcquire());
+        QVERIFY(!second.tryAcquire());
+        QVERIFY(!second.acquire());
+        QVERIFY(QFileInfo::exists(first.path()));
+
+        first.release();
+        QVERIFY(!first.isHeld());
+        QVERIFY(!QFileInfo::exists(first.path()));
+        QVERIFY(second.tryAcquire());
+    }
+
+    void test_BlockingKeepsFile()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = FS::PathCombine(tmp.path(), "index");
+
+        {
+            FileLease lease(path);
+            QVERIFY(lease.acquire());
+        }
+        // someone could be waiting on it
+        QVERIFY(QFileInfo::exists(path + ".lease"));
+
+        FileLease lease(path);
+        QVERIFY(lease.tryAcquire());
+    }
+};
+
+QTEST_GUILESS_MAIN(FileLeaseTest)
+
+#include "FileLease_test.moc"
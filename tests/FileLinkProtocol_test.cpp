@@ -0,0 +1,74 @@
+#include <QBuffer>
+#include <QTest>
+
+#include <filelink/FileLinkProtocol.h>
+
+class FileLinkProtocolTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_Messages()
+    {
+        QByteArray stream;
+        {
+            QBuffer out(&stream);
+            out.open(QIODevice::WriteOnly);
+            FileLinkProtocol::write(&out, FileLinkProtocol::batch(7, true, { { "C:/a", "C:/b" }, { "C:/c", "C:/d" } }));
+            FileLinkProtocol::write(&out, FileLinkProtocol::result(7, { "C:/a", "C:/b", "Access is denied.", 5 }));
+            FileLinkProtocol::write(&out, FileLinkProtocol::done(7));
+        }
+
+        // the messages come in pieces over the socket
+        QByteArray received;
+        QBuffer in_device(&received);
+        in_device.open(QIODevice::ReadOnly);
+        QDataStream in(&in_device);
+        in.setVersion(QDataStream::Qt_5_6);
+        QList<QByteArray> messages;
+        for (int i = 0; i < stream.size(); i += 5) {
+            auto position = in_device.pos();
+            in_device.close();
+            received.append(stream.mid(i, 5));
+            in_device.open(QIODevice::ReadOnly);
+            in_device.seek(position);
+            QByteArray message;
+            while (FileLinkProtocol::read(in, message))
+                messages.append(message);
+        }
+        QCOMPARE(messages.size(), 3);
+
+        QDataStream batch(messages[0]);
+        batch.setVersion(QDataStream::Qt_5_6);
+        quint8 type;
+        quint32 id;
+        bool hard_links;
+        quint32 count;
+        QString src, dst;
+        batch >> type >> id >> hard_links >> count;
+        QCOMPARE(type, quint8(FileLinkProtocol::Message::Batch));
+        QCOMPARE(id, quint32(7));
+        QVERIFY(hard_links);
+        QCOMPARE(count, quint32(2));
+        batch >> src >> dst;
+        QCOMPARE(src, QString("C:/a"));
+        QCOMPARE(dst, QString("C:/b"));
+
+        QDataStream result(messages[1]);
+        result.setVersion(QDataStream::Qt_5_6);
+        QString err_msg;
+        qint32 err_value;
+        result >> type >> id >> src >> dst >> err_msg >> err_value;
+        QCOMPARE(type, quint8(FileLinkProtocol::Message::Result));
+        QCOMPARE(err_msg, QString("Access is denied."));
+        QCOMPARE(err_value, 5);
+
+        QDataStream done(messages[2]);
+        done >> type >> id;
+        QCOMPARE(type, quint8(FileLinkProtocol::Message::Done));
+        QCOMPARE(id, quint32(7));
+    }
+};
+
+QTEST_GUILESS_MAIN(FileLinkProtocolTest)
+
+#include "FileLinkProtocol_test.moc"
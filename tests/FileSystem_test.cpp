@@ -337,6 +337,34 @@ slots:
         }
     }
 
+    void test_copy_many_files()
+    {
+        QTemporaryDir tempDir;
+        tempDir.setAutoRemove(true);
+
+        auto source = FS::PathCombine(tempDir.path(), "source");
+        for (int i = 0; i < 200; i++) {
+            FS::write(FS::PathCombine(source, QString("dir%1").arg(i % 7), QString("sub%1").arg(i % 3), QString("file%1.txt").arg(i)),
+                      QByteArray::number(i));
+        }
+
+        auto target = FS::PathCombine(tempDir.path(), "target");
+        FS::copy c(source, target);
+        QVERIFY(c(true));
+        QCOMPARE(c.totalCopied(), 200);
+
+        QString lastReported;
+        QObject::connect(&c, &FS::copy::fileCopied, [&lastReported](const QString& relativeName) { lastReported = relativeName; });
+        QVERIFY(c());
+        QCOMPARE(c.totalCopied(), 200);
+        QVERIFY(!lastReported.isEmpty());
+
+        for (int i = 0; i < 200; i++) {
+            auto path = FS::PathCombine(target, QString("dir%1").arg(i % 7), QString("sub%1").arg(i % 3), QString("file%1.txt").arg(i));
+            QCOMPARE(FS::read(path), QByteArray::number(i));
+        }
+    }
+
     void test_getDesktop()
     {
         QCOMPARE(FS::getDesktopDir(), QStandardPaths::writableLocation(QStandardPaths::DesktopLocation));
@@ -782,6 +810,22 @@ slots:
         QCOMPARE(FS::pathTruncate("C:\\bar\\foo.txt", 1), QDir::toNativeSeparators("C:\\bar"));
 #endif
     }
+
+    void test_preallocate()
+    {
+        QTemporaryDir tempDir;
+        QFile file(FS::PathCombine(tempDir.path(), "big.bin"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+
+        // not every filesystem can, but the file keeps its size either way
+        FS::preallocate(file, 8 * 1024 * 1024);
+        QCOMPARE(file.size(), qint64(0));
+        QCOMPARE(file.write("data"), qint64(4));
+        file.close();
+        QCOMPARE(QFileInfo(file.fileName()).size(), qint64(4));
+
+        QVERIFY(!FS::preallocate(file, 1024));
+    }
 };
 
 QTEST_GUILESS_MAIN(FileSystemTest)
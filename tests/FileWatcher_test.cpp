@@ -0,0 +1,114 @@
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileWatcher.h>
+
+namespace {
+void touch(const QString& path, const QByteArray& contents = "x")
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(contents);
+}
+
+/* Everything the watcher reported, until it's been quiet for a bit. */
+QStringList collect(QSignalSpy& spy)
+{
+    QStringList paths;
+    do {
+        for (auto& args : spy)
+            paths.append(args.at(1).toStringList());
+        spy.clear();
+    } while (spy.wait(500));
+    return paths;
+}
+
+class SuffixMatcher : public IPathMatcher {
+   public:
+    bool matches(const QString& string) const override { return string.endsWith(".log"); }
+};
+}  // namespace
+
+class FileWatcherTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_Contents()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto root = QDir(dir.path()).absolutePath();
+        QVERIFY(QDir(root).mkdir("sub"));
+
+        FileWatcher watcher;
+        watcher.setInterval(20);
+        QSignalSpy spy(&watcher, &FileWatcher::changed);
+        QVERIFY(watcher.addPath(root));
+        QCOMPARE(watcher.directories(), QStringList{ root });
+        // once is enough
+        QVERIFY(!watcher.addPath(root));
+
+        touch(root + "/a.txt");
+        touch(root + "/sub/deep.txt");
+        QVERIFY(spy.wait(2000));
+        QCOMPARE(spy.first().at(0).toString(), root);
+        auto paths = collect(spy);
+        QVERIFY(paths.contains(root + "/a.txt") || paths.contains(root));
+        // only what's right in the folder
+        QVERIFY(!paths.contains(root + "/sub/deep.txt"));
+
+        QVERIFY(watcher.removePath(root));
+        QVERIFY(watcher.directories().isEmpty());
+        touch(root + "/b.txt");
+        QVERIFY(!spy.wait(300));
+    }
+
+    void test_Recursive()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto root = QDir(dir.path()).absolutePath();
+
+        FileWatcher watcher;
+        watcher.setInterval(20);
+        watcher.setMatcher(std::make_shared<SuffixMatcher>());
+        QSignalSpy spy(&watcher, &FileWatcher::changed);
+        QVERIFY(watcher.addPath(root, FileWatcher::Mode::Recursive));
+
+        // a folder that comes after the watch started is watched too
+        QVERIFY(QDir(root).mkpath("new/deeper"));
+        collect(spy);
+        touch(root + "/new/deeper/game.log");
+        touch(root + "/new/deeper/ignored.txt");
+        QVERIFY(spy.wait(2000));
+        auto paths = collect(spy);
+        QVERIFY(paths.contains(root + "/new/deeper/game.log") || paths.contains(root + "/new/deeper"));
+        QVERIFY(!paths.contains(root + "/new/deeper/ignored.txt"));
+    }
+
+    void test_SharedWatches()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto root = QDir(dir.path()).absolutePath();
+
+        FileWatcher first;
+        first.setInterval(20);
+        QSignalSpy spy(&first, &FileWatcher::changed);
+        QVERIFY(first.addPath(root));
+        {
+            // the watch is shared, the other one going away doesn't stop it
+            FileWatcher second;
+            QVERIFY(second.addPath(root));
+        }
+        touch(root + "/a.txt");
+        QVERIFY(spy.wait(2000));
+    }
+};
+
+QTEST_GUILESS_MAIN(FileWatcherTest)
+
+#include "FileWatcher_test.moc"
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <quazip/quazip.h>
+#include <quazip/quazipfile.h>
+
+#include <FileSystem.h>
+#include <net/HttpMetaCache.h>
+
+/* Generated launcher data, for timing things at the scale of a big setup.
+ *
+ * Everything is made up but valid: the instances load, the mods parse, the asset indexes and meta caches are
+ * in the formats the launcher writes. The same arguments always give the same data.
+ */
+namespace FleetFixture {
+
+inline QString hashOf(const QByteArray& data, QCryptographicHash::Algorithm algorithm = QCryptographicHash::Sha1)
+{
+    return QCryptographicHash::hash(data, algorithm).toHex();
+}
+
+/** A mod jar with the metadata of a Fabric mod, or of a Forge one if `forge` is set, and some classes in it. */
+inline bool writeModJar(const QString& path, const QString& id, bool forge)
+{
+    QuaZip zip(path);
+    if (!zip.open(QuaZip::mdCreate))
+        return false;
+
+    auto add = [&zip](const QString& name, const QByteArray& data) {
+        QuaZipFile file(&zip);
+        if (!file.open(QIODevice::WriteOnly, QuaZipNewInfo(name)))
+            return false;
+        return file.write(data) == data.size();
+    };
+
+    bool ok;
+    if (forge) {
+        auto toml = QString("modLoader=\"javafml\"\nloaderVersion=\"[40,)\"\nlicense=\"MIT\"\n\n"
+                            "[[mods]]\nmodId=\"%1\"\nversion=\"1.0.0\"\ndisplayName=\"%1\"\nauthors=\"Fleet\"\n"
+                            "description='''\nA generated mod.\n'''\n")
+                        .arg(id);
+        ok = add("META-INF/mods.toml", toml.toUtf8());
+    } else {
+        QJsonObject info{ { "schemaVersion", 1 },   { "id", id },
+                          { "version", "1.0.0" },   { "name", id },
+                          { "description", "A generated mod." },
+                          { "authors", QJsonArray{ "Fleet" } } };
+        ok = add("fabric.mod.json", QJsonDocument(info).toJson());
+    }
+    for (int i = 0; ok && i < 8; i++)
+        ok = add(QString("fleet/%1/Class%2.class").arg(id).arg(i), QByteArray(2048, char('a' + i)));
+
+    zip.close();
+    return ok && zip.getZipError() == ZIP_OK;
+}
+
+/** `count` mod jars in `dir`, every other one for Forge. */
+inline bool generateMods(const QString& dir, int count)
+{
+    if (!FS::ensureFolderPathExists(dir))
+        return false;
+    for (int i = 0; i < count; i++) {
+        auto id = QString("fleetmod%1").arg(i);
+        if (!writeModJar(FS::PathCombine(dir, id + ".jar"), id, i % 2))
+            return false;
+    }
+    return true;
+}
+
+/** `count` instances in `dir`, with a few mods each, in a few groups. */
+inline bool generateInstances(const QString& dir, int count, int mods_per_instance = 0)
+{
+    QJsonObject groups;
+    for (int i = 0; i < count; i++) {
+        auto id = QString("Fleet %1").arg(i);
+        auto root = FS::PathCombine(dir, id);
+        auto game_root = FS::PathCombine(root, ".minecraft");
+        if (!FS::ensureFolderPathExists(game_root))
+            return false;
+
+        auto cfg = QString("InstanceType=OneSix\nname=%1\niconKey=default\nlastLaunchTime=%2\ntotalTimePlayed=%3\n")
+                       .arg(id)
+                       .arg(1700000000000LL + i * 1000)
+                       .arg(i * 60);
+        QJsonObject pack{ { "formatVersion", 1 },
+                          { "components", QJsonArray{ QJsonObject{ { "uid", "net.minecraft" }, { "version", "1.20.1" }, { "important", true } },
+                                                      QJsonObject{ { "uid", "net.fabricmc.fabric-loader" }, { "version", "0.14.21" } } } } };
+        try {
+            FS::write(FS::PathCombine(root, "instance.cfg"), cfg.toUtf8());
+            FS::write(FS::PathCombine(root, "mmc-pack.json"), QJsonDocument(pack).toJson());
+        } catch (const Exception&) {
+            return false;
+        }
+        if (mods_per_instance && !generateMods(FS::PathCombine(game_root, "mods"), mods_per_instance))
+            return false;
+
+        auto group = QString("Group %1").arg(i % 10);
+        auto instances = groups[group].toObject()["instances"].toArray();
+        instances.append(id);
+        groups[group] = QJsonObject{ { "hidden", false }, { "instances", instances } };
+    }
+
+    try {
+        FS::write(FS::PathCombine(dir, "instgroups.json"),
+                  QJsonDocument(QJsonObject{ { "formatVersion", "1" }, { "groups", groups } }).toJson());
+    } catch (const Exception&) {
+        return false;
+    }
+    return true;
+}
+
+/** An asset index with `count` objects, a recent version has a few thousand. A virtual one gets copied into a folder of its own. */
+inline bool generateAssetsIndex(const QString& path, int count, bool is_virtual = false)
+{
+    QJsonObject objects;
+    for (int i = 0; i < count; i++) {
+        objects.insert(QString("minecraft/sounds/fleet/%1.ogg").arg(i),
+                       QJsonObject{ { "hash", hashOf(QByteArray::number(i)) }, { "size", i * 37 } });
+    }
+    QJsonObject index{ { "objects", objects } };
+    if (is_virtual)
+        index.insert("virtual", true);
+    try {
+        FS::write(path, QJsonDocument(index).toJson(QJsonDocument::Compact));
+    } catch (const Exception&) {
+        return false;
+    }
+    return true;
+}
+
+/** The objects of the asset index above in the objects folder `dir`, as the downloads leave them. */
+inline bool generateAssetObjects(const QString& dir, int count)
+{
+    try {
+        for (int i = 0; i < count; i++) {
+            auto data = QByteArray::number(i);
+            auto hash = hashOf(data);
+            FS::write(FS::PathCombine(dir, hash.left(2), hash), data);
+        }
+    } catch (const Exception&) {
+        return false;
+    }
+    return true;
+}
+
+/** A meta cache index at `path` with `count` entries of the base `base`, which is kept in `base_dir`.
+ *
+ * With `write_files`, the files of the entries are there too and the entries don't expire, so they resolve instead of
+ * going stale.
+ */
+inline bool generateMetaCache(const QString& path, const QString& base, const QString& base_dir, int count, bool write_files = false)
+{
+    HttpMetaCache cache(path);
+    cache.addBase(base, base_dir);
+    for (int i = 0; i < count; i++) {
+        if (write_files) {
+            try {
+                FS::write(FS::PathCombine(base_dir, QString("files/%1.jar").arg(i)), QByteArray::number(i));
+            } catch (const Exception&) {
+                return false;
+            }
+        }
+        auto entry = cache.resolveEntry(base, QString("files/%1.jar").arg(i));
+        entry->setETag(QString("etag-%1").arg(i));
+        entry->setMD5Sum(hashOf(QByteArray::number(i), QCryptographicHash::Md5));
+        entry->setStale(false);
+        entry->makeEternal(write_files);
+        if (!cache.updateEntry(entry))
+            return false;
+    }
+    cache.SaveNow();
+    return true;
+}
+
+}  // namespace FleetFixture
@@ -1,6 +1,7 @@
 #include <QTest>
 
 #include <GZip.h>
+#include <QBuffer>
 #include <random>
 
 void fib(int &prev, int &cur)
@@ -49,6 +50,57 @@ slots:
             fib(prev, cur);
         } while (cur < size);
     }
+
+    void test_Streaming()
+    {
+        QByteArray data;
+        for(int i = 0; i < 300000; i++)
+        {
+            data.append(QByteArray::number(i));
+        }
+        QByteArray compressed;
+        QVERIFY(GZip::zip(data, compressed));
+        QCOMPARE(GZip::uncompressedSizeHint(compressed), qint64(data.size()));
+
+        // into a device
+        QBuffer out;
+        out.open(QIODevice::WriteOnly);
+        QVERIFY(GZip::unzip(compressed, out));
+        QCOMPARE(out.data(), data);
+
+        // read in odd pieces
+        GZipReader reader(compressed);
+        QVERIFY(reader.open(QIODevice::ReadOnly));
+        QByteArray read;
+        while(!reader.atEnd())
+        {
+            auto piece = reader.read(1000 + read.size() % 777);
+            QVERIFY(!piece.isEmpty());
+            read.append(piece);
+        }
+        QVERIFY(!reader.failed());
+        QCOMPARE(read, data);
+    }
+
+    void test_Corrupt()
+    {
+        QByteArray compressed;
+        QVERIFY(GZip::zip(QByteArray(100000, 'x'), compressed));
+
+        // cut off
+        auto truncated = compressed.left(compressed.size() / 2);
+        QByteArray out;
+        QVERIFY(!GZip::unzip(truncated, out));
+        QBuffer device;
+        device.open(QIODevice::WriteOnly);
+        QVERIFY(!GZip::unzip(truncated, device));
+
+        // not gzip at all
+        GZipReader reader(QByteArray("definitely not gzip data"));
+        QVERIFY(reader.open(QIODevice::ReadOnly));
+        reader.readAll();
+        QVERIFY(reader.failed());
+    }
 };
 
 QTEST_GUILESS_MAIN(GZipTest)
@@ -60,6 +60,12 @@ slots:
         QTest::newRow("nonsense") << "I like turtles";
         QTest::newRow("empty string") << "";
         QTest::newRow("missing version") << "herp.derp:artifact";
+        QTest::newRow("empty extension") << "group.id:artifact:1.0@";
+        QTest::newRow("colon in extension") << "group.id:artifact:1.0@jar:x";
+        QTest::newRow("two extensions") << "group.id:artifact:1.0@jar@zip";
+        QTest::newRow("five parts") << "group.id:artifact:1.0:classifier:more";
+        QTest::newRow("empty part") << "group.id::1.0";
+        QTest::newRow("extension first") << "group.id@artifact:1.0:classifier";
     }
     void test_Negative()
     {
@@ -70,6 +76,45 @@ slots:
         QCOMPARE(spec.serialize(), input);
         QCOMPARE(spec.toPath(), QString());
     }
+
+    void test_Parts()
+    {
+        GradleSpecifier spec("org.gradle.test.classifiers:service:1.0:jdk15@jar.pack.xz");
+        QVERIFY(spec.valid());
+        QCOMPARE(spec.groupId(), QString("org.gradle.test.classifiers"));
+        QCOMPARE(spec.artifactId(), QString("service"));
+        QCOMPARE(spec.version(), QString("1.0"));
+        QCOMPARE(spec.classifier(), QString("jdk15"));
+        QCOMPARE(spec.extension(), QString("jar.pack.xz"));
+
+        // assigning again doesn't keep anything of what was there
+        spec = QString("group.id:artifact:2.0");
+        QCOMPARE(spec.classifier(), QString());
+        QCOMPARE(spec.extension(), QString("jar"));
+        QCOMPARE(spec.serialize(), QString("group.id:artifact:2.0"));
+    }
+
+    void test_MatchName()
+    {
+        GradleSpecifier a("group.id:artifact:1.0");
+        GradleSpecifier b("group.id:artifact:2.0");
+        GradleSpecifier natives("group.id:artifact:1.0:natives-linux");
+        GradleSpecifier other_group("group.other:artifact:1.0");
+        GradleSpecifier other_artifact("group.id:artifact2:1.0");
+        // the artifact of one can be the group of another, they're still told apart
+        GradleSpecifier swapped("artifact:group.id:1.0");
+
+        QCOMPARE(a.nameId(), b.nameId());
+        QVERIFY(a.matchName(b));
+        QVERIFY(!a.matchName(natives));
+        QVERIFY(!a.matchName(other_group));
+        QVERIFY(!a.matchName(other_artifact));
+        QVERIFY(!a.matchName(swapped));
+        QVERIFY(a.nameId() != swapped.nameId());
+        QVERIFY(!(a == b));
+        QVERIFY(a == GradleSpecifier("group.id:artifact:1.0@jar"));
+        QCOMPARE(GradleSpecifier("I like turtles").nameId(), quint64(0));
+    }
 };
 
 QTEST_GUILESS_MAIN(GradleSpecifierTest)
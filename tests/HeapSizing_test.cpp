@@ -0,0 +1,92 @@
+#include <QTest>
+
+#include <minecraft/launch/HeapSizing.h>
+
+class HeapSizingTest : public QObject {
+    Q_OBJECT
+
+    HeapSizing::Inputs inputs(int physical, int available = 0)
+    {
+        HeapSizing::Inputs out;
+        out.physicalMemory = physical;
+        out.availableMemory = available;
+        return out;
+    }
+
+   private slots:
+    void test_Unknown()
+    {
+        auto bounds = HeapSizing::compute(inputs(0));
+        QCOMPARE(bounds.max, 0);
+        QCOMPARE(bounds.min, 0);
+    }
+
+    void test_Estimate()
+    {
+        auto vanilla = HeapSizing::compute(inputs(16384));
+        QCOMPARE(vanilla.max, 1024);
+        QCOMPARE(vanilla.min, 512);
+        QVERIFY(vanilla.reason.startsWith("estimated"));
+
+        auto in = inputs(16384);
+        in.mods = 200;
+        in.modsSize = 500;
+        in.resourcePacks = 3;
+        in.resourcePacksSize = 100;
+        auto modded = HeapSizing::compute(in);
+        QCOMPARE(modded.max, 3840);
+        QCOMPARE(modded.min, 896);
+    }
+
+    void test_Peak()
+    {
+        auto in = inputs(16384);
+        in.mods = 200;
+        in.peak = 4000;
+        auto bounds = HeapSizing::compute(in);
+        QCOMPARE(bounds.max, 6144);
+        QVERIFY(bounds.reason.contains("4000 MiB"));
+    }
+
+    void test_Limits()
+    {
+        auto in = inputs(16384, 3000);
+        in.peak = 4000;
+        auto free = HeapSizing::compute(in);
+        QCOMPARE(free.max, 2304);
+        QVERIFY(free.reason.endsWith("limited by the free memory"));
+
+        in = inputs(8192);
+        in.peak = 8000;
+        auto system = HeapSizing::compute(in);
+        QCOMPARE(system.max, 6144);
+        QVERIFY(system.reason.endsWith("limited by the system memory"));
+
+        // never so big that the JVM turns compressed pointers off
+        in = inputs(131072);
+        in.peak = 40000;
+        QCOMPARE(HeapSizing::compute(in).max, 31744);
+
+        // too little memory for the reserve still gets a heap
+        auto tiny = HeapSizing::compute(inputs(1536));
+        QCOMPARE(tiny.max, 768);
+        QCOMPARE(tiny.min, 512);
+    }
+
+    void test_PeakLine()
+    {
+        int peak = 0;
+        QVERIFY(HeapSizing::parsePeakLine("!![Launcher]!Heap peak: 2048 MiB", peak));
+        QCOMPARE(peak, 2048);
+        QVERIFY(HeapSizing::parsePeakLine("Heap peak: 12 MiB\n", peak));
+        QCOMPARE(peak, 12);
+
+        QVERIFY(!HeapSizing::parsePeakLine("[Render thread/INFO]: Heap peak: 5 MiB", peak));
+        QVERIFY(!HeapSizing::parsePeakLine("!![Launcher]!Heap peak: 0 MiB", peak));
+        QVERIFY(!HeapSizing::parsePeakLine("!![Launcher]!Heap peak: lots", peak));
+    }
+};
+
+QTEST_GUILESS_MAIN(HeapSizingTest)
+
+#include "HeapSizing_test.moc"
@@ -0,0 +1,239 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <GZip.h>
+#include <net/HttpMetaCache.h>
+
+class HttpMetaCacheTest : public QObject {
+    Q_OBJECT
+
+    static void writeFile(const QString& path, const QByteArray& data)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    }
+
+    static QString md5Of(const QByteArray& data) { return QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex(); }
+
+   private slots:
+    void test_SaveLoad()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto index = FS::PathCombine(tmp.path(), "metacache");
+
+        {
+            HttpMetaCache cache(index);
+            cache.addBase("test", tmp.path());
+
+            for (auto name : { "a", "b" }) {
+                auto entry = cache.resolveEntry("test", name);
+                QVERIFY(entry->isStale());
+
+                writeFile(entry->getFullPath(), name);
+                entry->setMD5Sum(md5Of(name));
+                entry->setETag(QString("etag-%1").arg(name));
+                entry->setLocalChangedTimestamp(QFileInfo(entry->getFullPath()).lastModified().toUTC().toMSecsSinceEpoch());
+                entry->makeEternal(true);
+                entry->setStale(false);
+                QVERIFY(cache.updateEntry(entry));
+            }
+
+            // the second save appends a removal to the log
+            cache.SaveNow();
+            cache.evictEntry(cache.getEntry("test", "b"));
+        }
+
+        HttpMetaCache cache(index);
+        cache.addBase("test", tmp.path());
+        cache.Load();
+
+        auto entry = cache.resolveEntry("test", "a");
+        QVERIFY(!entry->isStale());
+        QCOMPARE(entry->getETag(), QString("etag-a"));
+        QCOMPARE(entry->getMD5Sum(), md5Of("a"));
+        QVERIFY(entry->isEternal());
+
+        QVERIFY(!cache.getEntry("test", "b"));
+    }
+
+    void test_LastUsed()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto index = FS::PathCombine(tmp.path(), "metacache");
+
+        {
+            HttpMetaCache cache(index);
+            cache.addBase("test", tmp.path());
+            cache.addBase("other", tmp.path());
+            cache.setBudget("test", 1024);
+            QCOMPARE(cache.getBudget("test"), qint64(1024));
+            QCOMPARE(cache.getBudgetedBases(), QStringList{ "test" });
+
+            auto entry = cache.resolveEntry("test", "a");
+            writeFile(entry->getFullPath(), "a");
+            entry->setMD5Sum(md5Of("a"));
+            entry->setLocalChangedTimestamp(QFileInfo(entry->getFullPath()).lastModified().toUTC().toMSecsSinceEpoch());
+            entry->makeEternal(true);
+            entry->setStale(false);
+            QVERIFY(cache.updateEntry(entry));
+            QVERIFY(entry->lastUsed() > 0);
+        }
+
+        HttpMetaCache cache(index);
+        cache.addBase("test", tmp.path());
+        cache.Load();
+
+        // nobody asked for it yet, the cleanup still needs to know about it
+        auto entries = cache.getEntries("test");
+        QCOMPARE(entries.size(), 1);
+        QCOMPARE(entries[0]->getRelativePath(), QString("a"));
+        QVERIFY(entries[0]->lastUsed() > 0);
+        QCOMPARE(entries[0]->getFullPath(), FS::PathCombine(tmp.path(), "a"));
+    }
+
+    void test_StaleWhileRevalidate()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        HttpMetaCache cache(FS::PathCombine(tmp.path(), "metacache"));
+        cache.addBase("test", tmp.path());
+
+        auto entry = cache.resolveEntry("test", "index.json");
+        writeFile(entry->getFullPath(), "{}");
+        {
+            // downloaded a while ago, and good for less than that
+            QFile file(entry->getFullPath());
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(-150), QFileDevice::FileModificationTime));
+        }
+        entry->setMD5Sum(md5Of("{}"));
+        entry->setETag("etag");
+        entry->setLocalChangedTimestamp(QFileInfo(entry->getFullPath()).lastModified().toUTC().toMSecsSinceEpoch());
+        entry->setMaximumAge(100);
+        entry->setCurrentAge(0);
+        entry->setStale(false);
+        QVERIFY(cache.updateEntry(entry));
+
+        // within the bound, it's kept to be used while it's revalidated
+        auto stale = cache.resolveEntry("test", "index.json", {}, 3600);
+        QVERIFY(stale->isStale());
+        QVERIFY(stale->isUsableWhileStale());
+        QCOMPARE(stale->getETag(), QString("etag"));
+
+        // past it, it's gone as before
+        auto expired = cache.resolveEntry("test", "index.json", {}, 10);
+        QVERIFY(expired->isStale());
+        QVERIFY(!expired->isUsableWhileStale());
+        QVERIFY(expired->getETag().isEmpty());
+    }
+
+    void test_SharedIndex()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto index = FS::PathCombine(tmp.path(), "metacache");
+
+        auto add = [&tmp](HttpMetaCache& cache, const QString& name) {
+            auto entry = cache.resolveEntry("test", name);
+            writeFile(entry->getFullPath(), name.toUtf8());
+            entry->setMD5Sum(md5Of(name.toUtf8()));
+            entry->setLocalChangedTimestamp(QFileInfo(entry->getFullPath()).lastModified().toUTC().toMSecsSinceEpoch());
+            entry->makeEternal(true);
+            entry->setStale(false);
+            QVERIFY(cache.updateEntry(entry));
+            cache.SaveNow();
+        };
+
+        // two launchers with the same data directory, each only knowing what it saved itself
+        {
+            HttpMetaCache first(index);
+            first.addBase("test", tmp.path());
+            first.Load();
+            HttpMetaCache second(index);
+            second.addBase("test", tmp.path());
+            second.Load();
+
+            add(first, "a");
+            add(second, "b");
+            add(first, "c");
+
+            // what the other one saved is read in before saving
+            QVERIFY(first.getEntry("test", "b"));
+            QVERIFY(second.getEntry("test", "a"));
+        }
+
+        HttpMetaCache cache(index);
+        cache.addBase("test", tmp.path());
+        cache.Load();
+        for (auto name : { "a", "b", "c" }) {
+            auto entry = cache.resolveEntry("test", name);
+            QVERIFY(!entry->isStale());
+            QCOMPARE(entry->getMD5Sum(), md5Of(name));
+        }
+    }
+
+    void test_MigrateJson()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto index = FS::PathCombine(tmp.path(), "metacache");
+
+        writeFile(FS::PathCombine(tmp.path(), "a"), "a");
+        writeFile(index, QString(R"({"version": "1", "entries": [{"base": "test", "path": "a", "md5sum": "%1", "etag": "etag-a",
+                                  "last_changed_timestamp": 0, "eternal": true}]})")
+                             .arg(md5Of("a"))
+                             .toUtf8());
+
+        {
+            HttpMetaCache cache(index);
+            cache.addBase("test", tmp.path());
+            cache.Load();
+            QVERIFY(!QFileInfo::exists(index));
+        }
+
+        HttpMetaCache cache(index);
+        cache.addBase("test", tmp.path());
+        cache.Load();
+
+        auto entry = cache.getEntry("test", "a");
+        QVERIFY(entry);
+        QCOMPARE(entry->getETag(), QString("etag-a"));
+    }
+
+    void test_Compressed()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+
+        HttpMetaCache cache(FS::PathCombine(tmp.path(), "metacache"));
+        cache.addBase("test", tmp.path());
+        cache.addBase("other", tmp.path());
+        cache.setCompressed("test", true);
+        QVERIFY(cache.isCompressed("test"));
+        QVERIFY(!cache.isCompressed("other"));
+        QVERIFY(!cache.isCompressed("missing"));
+
+        QByteArray json = R"({"uid": "net.minecraft", "versions": []})";
+        QByteArray compressed;
+        QVERIFY(GZip::zip(json, compressed));
+        QVERIFY(GZip::isCompressed(compressed));
+        QVERIFY(!GZip::isCompressed(json));
+
+        // the files stored before, or as they came, are read as they are
+        writeFile(FS::PathCombine(tmp.path(), "plain.json"), json);
+        writeFile(FS::PathCombine(tmp.path(), "compressed.json"), compressed);
+        QCOMPARE(HttpMetaCache::readFile(FS::PathCombine(tmp.path(), "plain.json")), json);
+        QCOMPARE(HttpMetaCache::readFile(FS::PathCombine(tmp.path(), "compressed.json")), json);
+
+        writeFile(FS::PathCombine(tmp.path(), "broken.json"), compressed.left(compressed.size() / 2));
+        QVERIFY_EXCEPTION_THROWN(HttpMetaCache::readFile(FS::PathCombine(tmp.path(), "broken.json")), FS::FileSystemException);
+    }
+};
+
+QTEST_GUILESS_MAIN(HttpMetaCacheTest)
+
+#include "HttpMetaCache_test.moc"
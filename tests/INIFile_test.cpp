@@ -79,6 +79,44 @@ slots:
         QCOMPARE(out_list_strings, list_strings);
         QCOMPARE(out_list_numbers, list_numbers);
     }
+
+    void test_SaveLoadPlain()
+    {
+        QString filename = "test_SaveLoadPlain.ini";
+
+        INIFile f;
+        f.set("JavaPath", "/usr/lib/jvm/java-17/bin/java");
+        f.set("JvmArgs", "-XX:+UseG1GC -Xss2M");
+        f.set("MaxMemAlloc", 4096);
+        f.set("ShowConsole", true);
+        f.set("Empty", "");
+        f.saveFile(filename);
+
+        INIFile f2;
+        f2.loadFile(filename);
+        QCOMPARE(f2.get("JavaPath", "NOT SET").toString(), QString("/usr/lib/jvm/java-17/bin/java"));
+        QCOMPARE(f2.get("JvmArgs", "NOT SET").toString(), QString("-XX:+UseG1GC -Xss2M"));
+        QCOMPARE(f2.get("MaxMemAlloc", 0).toInt(), 4096);
+        QCOMPARE(f2.get("ShowConsole", false).toBool(), true);
+        QCOMPARE(f2.get("Empty", "NOT SET").toString(), QString());
+    }
+
+    void test_RemovedKeys()
+    {
+        QString filename = "test_RemovedKeys.ini";
+
+        INIFile f;
+        f.set("a", "a");
+        f.set("b", "a\nb");
+        f.saveFile(filename);
+        f.remove("b");
+        f.saveFile(filename);
+
+        INIFile f2;
+        f2.loadFile(filename);
+        QCOMPARE(f2.get("a", "NOT SET").toString(), QString("a"));
+        QVERIFY(!f2.contains("b"));
+    }
 };
 
 QTEST_GUILESS_MAIN(IniFileTest)
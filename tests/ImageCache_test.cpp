@@ -0,0 +1,82 @@
+#include <QTest>
+
+#include <thread>
+#include <vector>
+
+#include <ImageCache.h>
+
+class ImageCacheTest : public QObject {
+    Q_OBJECT
+
+    QImage image(int size, QColor color)
+    {
+        QImage out(size, size, QImage::Format_ARGB32);
+        out.fill(color);
+        return out;
+    }
+
+   private slots:
+    void test_Insert()
+    {
+        ImageCache cache;
+        QImage found;
+        QVERIFY(!cache.find(0, &found));
+
+        auto key = cache.insert(image(16, Qt::red));
+        QVERIFY(key != 0);
+        QVERIFY(cache.find(key, &found));
+        QCOMPARE(found.size(), QSize(16, 16));
+        QCOMPARE(found.pixelColor(0, 0), QColor(Qt::red));
+
+        cache.remove(key);
+        QVERIFY(!cache.find(key, &found));
+    }
+
+    void test_Budget()
+    {
+        // 64 KiB for each of the shards
+        ImageCache cache(16 * 64 * 1024);
+        // 256 KiB, doesn't fit anywhere
+        QCOMPARE(cache.insert(image(256, Qt::blue)), ImageCache::Key(0));
+
+        // 16 KiB each, a shard keeps the last 4 of those put into it
+        QList<ImageCache::Key> keys;
+        for (int i = 0; i < 16 * 8; i++)
+            keys.append(cache.insert(image(64, Qt::green)));
+
+        int kept = 0;
+        for (auto key : keys)
+            kept += cache.find(key, nullptr);
+        QCOMPARE(kept, 16 * 4);
+        QVERIFY(cache.find(keys.last(), nullptr));
+        QVERIFY(!cache.find(keys.first(), nullptr));
+    }
+
+    void test_Threads()
+    {
+        ImageCache cache;
+        constexpr int threads = 8;
+        std::vector<QList<ImageCache::Key>> keys(threads);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([this, &cache, &keys, t] {
+                for (int i = 0; i < 100; i++)
+                    keys[t].append(cache.insert(image(8, QColor(t, i, 0))));
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+
+        for (int t = 0; t < threads; t++) {
+            for (int i = 0; i < 100; i++) {
+                QImage found;
+                QVERIFY(cache.find(keys[t][i], &found));
+                QCOMPARE(found.pixelColor(0, 0), QColor(t, i, 0));
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(ImageCacheTest)
+
+#include "ImageCache_test.moc"
@@ -1,5 +1,9 @@
+#include <QCryptographicHash>
+#include <QDir>
+#include <QTemporaryDir>
 #include <QTest>
 
+#include <FileSystem.h>
 #include <meta/Index.h>
 #include <meta/VersionList.h>
 
@@ -29,6 +33,63 @@ slots:
         windex.merge(std::shared_ptr<Meta::Index>(new Meta::Index({std::make_shared<Meta::VersionList>("list6")})));
         QCOMPARE(windex.lists().size(), 6);
     }
+
+    void test_snapshot()
+    {
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        auto oldCurrent = QDir::currentPath();
+        QDir::setCurrent(tempDir.path());
+
+        QByteArray list = R"({"formatVersion": 1, "uid": "list1", "name": "List 1", "versions": [
+            {"version": "1.0", "releaseTime": "2020-01-01T00:00:00+00:00", "type": "release", "sha256": "abc",
+             "requires": [{"uid": "list2", "equals": "2.0"}]},
+            {"version": "1.1", "releaseTime": "2021-01-01T00:00:00+00:00", "type": "snapshot"}]})";
+        auto listSha = QString(QCryptographicHash::hash(list, QCryptographicHash::Sha256).toHex());
+        FS::write("meta/list1/index.json", list);
+        FS::write("meta/index.json", QString(R"({"formatVersion": 1, "packages": [
+            {"uid": "list1", "name": "List 1", "sha256": "%1"}, {"uid": "list2", "name": "List 2", "sha256": "def"}]})")
+                                             .arg(listSha)
+                                             .toUtf8());
+
+        {
+            Meta::Index index;
+            index.load(Net::Mode::Offline);
+            QCOMPARE(index.lists().size(), 2);
+            index.get("list1")->load(Net::Mode::Offline);
+            QVERIFY(index.get("list1")->isVerified());
+            QVERIFY(!index.get("list1")->shouldStartRemoteUpdate());
+            index.saveSnapshot();
+        }
+
+        {
+            Meta::Index index;
+            QVERIFY(index.loadSnapshot());
+            QVERIFY(index.isLoaded());
+            QCOMPARE(index.lists().size(), 2);
+            auto list1 = index.get("list1");
+            QVERIFY(list1->isLoaded());
+            QVERIFY(list1->isVerified());
+            QCOMPARE(list1->name(), QString("List 1"));
+            QCOMPARE(list1->count(), 2);
+            auto version = list1->getVersion("1.0");
+            QCOMPARE(version->sha256(), QString("abc"));
+            QCOMPARE(version->type(), QString("release"));
+            QCOMPARE(int(version->requiredSet().size()), 1);
+            QCOMPARE(version->requiredSet().begin()->equalsVersion, QString("2.0"));
+            QVERIFY(!index.get("list2")->isLoaded());
+        }
+
+        // the list changed since, it has to be parsed again
+        FS::write("meta/list1/index.json", list + " ");
+        {
+            Meta::Index index;
+            QVERIFY(index.loadSnapshot());
+            QVERIFY(!index.get("list1")->isLoaded());
+        }
+
+        QDir::setCurrent(oldCurrent);
+    }
 };
 
 QTEST_GUILESS_MAIN(IndexTest)
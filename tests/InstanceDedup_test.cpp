@@ -0,0 +1,100 @@
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <InstanceDedupTask.h>
+
+namespace {
+bool write(const QString& path, const QByteArray& contents)
+{
+    if (!FS::ensureFilePathExists(path))
+        return false;
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size();
+}
+
+QByteArray read(const QString& path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+bool run(InstanceDedupTask& task)
+{
+    QSignalSpy spy(&task, &Task::finished);
+    task.start();
+    return spy.wait(10000) && task.wasSuccessful();
+}
+}  // namespace
+
+class InstanceDedupTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_tmp;
+    QString m_previous_dir;
+
+   private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_tmp.isValid());
+        m_previous_dir = QDir::currentPath();
+        // the hash cache is in the cache folder of the current one
+        QDir::setCurrent(m_tmp.path());
+    }
+
+    void cleanupTestCase() { QDir::setCurrent(m_previous_dir); }
+
+    void test_Deduplicate()
+    {
+        auto a = m_tmp.filePath("instances/a");
+        auto b = m_tmp.filePath("instances/b");
+        QByteArray mod(8192, 'm');
+        QByteArray other(8192, 'o');
+        QVERIFY(write(a + "/.minecraft/mods/mod.jar", mod));
+        QVERIFY(write(b + "/.minecraft/mods/renamed.jar", mod));
+        // same size, other contents
+        QVERIFY(write(b + "/.minecraft/mods/other.jar", other));
+        // not archives, or too small to bother
+        QVERIFY(write(a + "/.minecraft/config/big.txt", mod));
+        QVERIFY(write(b + "/.minecraft/config/big.txt", mod));
+        QVERIFY(write(a + "/.minecraft/mods/tiny.jar", "tiny"));
+        QVERIFY(write(b + "/.minecraft/mods/tiny.jar", "tiny"));
+
+        {
+            InstanceDedupTask dry_run(QStringList{ a, b }, true);
+            QVERIFY(run(dry_run));
+            QCOMPARE(dry_run.result().duplicates, 1);
+            QCOMPARE(dry_run.result().reclaimed, qint64(8192));
+            QCOMPARE(dry_run.result().cloned + dry_run.result().linked, 1);
+            // nothing changes
+            QCOMPARE(FS::hardLinkCount(a + "/.minecraft/mods/mod.jar"), uintmax_t(1));
+            QCOMPARE(FS::hardLinkCount(b + "/.minecraft/mods/renamed.jar"), uintmax_t(1));
+        }
+
+        {
+            InstanceDedupTask task(QStringList{ a, b }, false);
+            QVERIFY(run(task));
+            QCOMPARE(task.result().duplicates, 1);
+            QCOMPARE(task.result().left, 0);
+            QCOMPARE(read(a + "/.minecraft/mods/mod.jar"), mod);
+            QCOMPARE(read(b + "/.minecraft/mods/renamed.jar"), mod);
+            QCOMPARE(read(b + "/.minecraft/mods/other.jar"), other);
+            if (task.result().linked)
+                QCOMPARE(FS::hardLinkCount(b + "/.minecraft/mods/renamed.jar"), uintmax_t(2));
+            QCOMPARE(FS::hardLinkCount(a + "/.minecraft/config/big.txt"), uintmax_t(1));
+            QVERIFY(!QFile::exists(b + "/.minecraft/mods/renamed.jar.dedup"));
+        }
+
+        // what's shared already isn't counted again
+        InstanceDedupTask again(QStringList{ a, b }, true);
+        QVERIFY(run(again));
+        QCOMPARE(again.result().duplicates, again.result().cloned);
+    }
+};
+
+QTEST_GUILESS_MAIN(InstanceDedupTest)
+
+#include "InstanceDedup_test.moc"
@@ -0,0 +1,126 @@
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <minecraft/InstanceLayer.h>
+
+class InstanceLayerTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_tmp;
+    QString m_base;
+    QString m_layered;
+
+    void writeFile(const QString& path, const QByteArray& data)
+    {
+        QVERIFY(FS::ensureFilePathExists(path));
+        FS::write(path, data);
+    }
+
+    QByteArray readFile(const QString& path) { return FS::read(path); }
+
+    InstanceLayer::Result compose()
+    {
+        InstanceLayer layer({ m_layered, FS::PathCombine(m_layered, ".minecraft"), m_base, FS::PathCombine(m_base, ".minecraft") });
+        return layer.compose();
+    }
+
+    QString base(const QString& path) { return FS::PathCombine(m_base, path); }
+    QString layered(const QString& path) { return FS::PathCombine(m_layered, path); }
+
+   private slots:
+    void init()
+    {
+        QVERIFY(m_tmp.isValid());
+        static int count = 0;
+        m_base = FS::PathCombine(m_tmp.path(), QString("base%1").arg(count));
+        m_layered = FS::PathCombine(m_tmp.path(), QString("layered%1").arg(count));
+        count++;
+        QVERIFY(QDir().mkpath(m_layered));
+
+        writeFile(base("instance.cfg"), "name=Base\n");
+        writeFile(base("mmc-pack.json"), "{}");
+        writeFile(base("patches/net.minecraft.json"), "{}");
+        writeFile(base(".minecraft/options.txt"), "fov:0.0\n");
+        writeFile(base(".minecraft/config/mod.cfg"), "value=1\n");
+        writeFile(base(".minecraft/mods/mod.jar"), "a mod");
+        writeFile(base(".minecraft/saves/World/level.dat"), "a world");
+        writeFile(base(".minecraft/logs/latest.log"), "a log");
+    }
+
+    void test_placesTheFilesOfTheBase()
+    {
+        auto result = compose();
+        QVERIFY2(result.error.isEmpty(), qPrintable(result.error));
+        QCOMPARE(result.placed, 5);
+
+        QCOMPARE(readFile(layered("mmc-pack.json")), QByteArray("{}"));
+        QVERIFY(QFile::exists(layered("patches/net.minecraft.json")));
+        QCOMPARE(readFile(layered(".minecraft/config/mod.cfg")), QByteArray("value=1\n"));
+        QCOMPARE(readFile(layered(".minecraft/mods/mod.jar")), QByteArray("a mod"));
+        // what belongs to each instance isn't placed
+        QVERIFY(!QFile::exists(layered("instance.cfg")));
+        QVERIFY(!QFile::exists(layered(".minecraft/saves/World/level.dat")));
+        QVERIFY(!QFile::exists(layered(".minecraft/logs/latest.log")));
+        QVERIFY(QFile::exists(layered(InstanceLayer::manifestName())));
+
+        // nothing changed since
+        result = compose();
+        QCOMPARE(result.placed, 0);
+        QCOMPARE(result.removed, 0);
+        QCOMPARE(result.overridden, 0);
+    }
+
+    void test_followsTheBase()
+    {
+        QVERIFY(compose().error.isEmpty());
+
+        writeFile(base(".minecraft/config/mod.cfg"), "value=2, changed\n");
+        writeFile(base(".minecraft/mods/other.jar"), "another mod");
+        QVERIFY(QFile::remove(base(".minecraft/mods/mod.jar")));
+
+        auto result = compose();
+        QVERIFY(result.error.isEmpty());
+        QCOMPARE(result.placed, 2);
+        QCOMPARE(result.removed, 1);
+        QCOMPARE(readFile(layered(".minecraft/config/mod.cfg")), QByteArray("value=2, changed\n"));
+        QCOMPARE(readFile(layered(".minecraft/mods/other.jar")), QByteArray("another mod"));
+        QVERIFY(!QFile::exists(layered(".minecraft/mods/mod.jar")));
+    }
+
+    void test_keepsWhatTheInstanceChanged()
+    {
+        writeFile(layered(".minecraft/mods/extra.jar"), "an extra mod");
+        QVERIFY(compose().error.isEmpty());
+
+        // a changed file overrides the base from then on
+        writeFile(layered(".minecraft/options.txt"), "fov:1.0, the tester's\n");
+        auto result = compose();
+        QCOMPARE(result.overridden, 1);
+        writeFile(base(".minecraft/options.txt"), "fov:0.5\n");
+        result = compose();
+        QCOMPARE(result.placed, 0);
+        QCOMPARE(readFile(layered(".minecraft/options.txt")), QByteArray("fov:1.0, the tester's\n"));
+
+        // a deleted one stays deleted
+        QVERIFY(QFile::remove(layered(".minecraft/mods/mod.jar")));
+        result = compose();
+        QCOMPARE(result.placed, 0);
+        QVERIFY(!QFile::exists(layered(".minecraft/mods/mod.jar")));
+
+        // and what it added is left alone
+        QCOMPARE(readFile(layered(".minecraft/mods/extra.jar")), QByteArray("an extra mod"));
+    }
+
+    void test_withoutTheBase()
+    {
+        QVERIFY(FS::deletePath(m_base));
+        QVERIFY(!compose().error.isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(InstanceLayerTest)
+
+#include "InstanceLayer_test.moc"
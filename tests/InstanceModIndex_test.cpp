@@ -0,0 +1,83 @@
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <minecraft/mod/InstanceModIndex.h>
+#include <modplatform/packwiz/Packwiz.h>
+
+class InstanceModIndexTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_tmp;
+    QString m_previous_dir;
+
+   private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_tmp.isValid());
+        m_previous_dir = QDir::currentPath();
+        // the mod details cache is in the cache folder of the current one
+        QDir::setCurrent(m_tmp.path());
+    }
+
+    void cleanupTestCase() { QDir::setCurrent(m_previous_dir); }
+
+    void test_ScanFolder()
+    {
+        auto mods = m_tmp.filePath("instance/.minecraft/mods");
+        QVERIFY(FS::ensureFolderPathExists(mods));
+        // not a mod that says what it is, but one downloaded through the launcher, disabled since
+        FS::write(FS::PathCombine(mods, "borderless-mining.jar.disabled"), "not a zip");
+        FS::write(FS::PathCombine(mods, "notes.txt"), "not a mod");
+
+        QDir index_dir(FS::PathCombine(mods, ".index"));
+        QVERIFY(FS::ensureFolderPathExists(index_dir.path()));
+        Packwiz::V1::Mod metadata;
+        metadata.slug = "borderless-mining";
+        metadata.name = "Borderless Mining";
+        metadata.filename = "borderless-mining.jar";
+        metadata.provider = ModPlatform::ResourceProvider::MODRINTH;
+        metadata.project_id = "kYq5qkSL";
+        metadata.file_id = "3fGMzA7t";
+        metadata.hash_format = "sha512";
+        metadata.hash = "ABCDEF0123";
+        Packwiz::V1::updateModIndex(index_dir, metadata);
+
+        auto entries = InstanceModIndex::scanFolder(mods);
+        QCOMPARE(entries.size(), 1);
+        auto& entry = entries.first();
+        QCOMPARE(entry.fileName, QString("borderless-mining.jar.disabled"));
+        QVERIFY(!entry.enabled);
+        QVERIFY(entry.hasMetadata);
+        QCOMPARE(entry.projectId, QString("kYq5qkSL"));
+        QCOMPARE(entry.fileId, QString("3fGMzA7t"));
+        QCOMPARE(entry.hash, QString("ABCDEF0123"));
+
+        QVERIFY(InstanceModIndex::scanFolder(m_tmp.filePath("nothing")).isEmpty());
+    }
+
+    void test_Matches()
+    {
+        InstanceModIndex::Entry entry;
+        entry.fileName = "sodium-fabric-0.5.3.jar";
+        entry.modId = "sodium";
+        entry.name = "Sodium";
+        entry.projectId = "AANobbMI";
+        entry.hash = "f00dcafe";
+
+        QVERIFY(InstanceModIndex::matches(entry, ""));
+        QVERIFY(InstanceModIndex::matches(entry, "SODIUM"));
+        QVERIFY(InstanceModIndex::matches(entry, "0.5.3"));
+        QVERIFY(InstanceModIndex::matches(entry, "aanobbmi"));
+        QVERIFY(InstanceModIndex::matches(entry, "F00DCAFE"));
+        // hashes only whole
+        QVERIFY(!InstanceModIndex::matches(entry, "f00d"));
+        QVERIFY(!InstanceModIndex::matches(entry, "lithium"));
+    }
+};
+
+QTEST_GUILESS_MAIN(InstanceModIndexTest)
+
+#include "InstanceModIndex_test.moc"
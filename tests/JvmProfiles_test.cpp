@@ -0,0 +1,76 @@
+#include <QTest>
+
+#include <java/JvmProfiles.h>
+
+class JvmProfilesTest : public QObject {
+    Q_OBJECT
+
+    JvmProfiles::Jvm jvm(const QString& version, const QString& vendor = "Eclipse Adoptium", int maxMemory = 8192)
+    {
+        JvmProfiles::Jvm out;
+        out.version = JavaVersion(version);
+        out.vendor = vendor;
+        out.architecture = "64";
+        out.maxMemory = maxMemory;
+        return out;
+    }
+
+   private slots:
+    void test_Find()
+    {
+        QVERIFY(JvmProfiles::find("g1-low-pause"));
+        QVERIFY(JvmProfiles::find("zgc-generational"));
+        QVERIFY(JvmProfiles::find("shenandoah"));
+        QVERIFY(JvmProfiles::find("throughput"));
+        QVERIFY(!JvmProfiles::find("nonexistent"));
+    }
+
+    void test_Versions()
+    {
+        auto zgc = JvmProfiles::find("zgc-generational");
+        QVERIFY(!JvmProfiles::unusableReason(*zgc, jvm("17.0.8")).isEmpty());
+        QVERIFY(JvmProfiles::arguments(*zgc, jvm("17.0.8")).isEmpty());
+
+        // the flag for generational mode only goes to the versions that have both modes
+        auto java21 = JvmProfiles::arguments(*zgc, jvm("21.0.1"));
+        QVERIFY(java21.contains("-XX:+UseZGC"));
+        QVERIFY(java21.contains("-XX:+ZGenerational"));
+        auto java23 = JvmProfiles::arguments(*zgc, jvm("23"));
+        QVERIFY(java23.contains("-XX:+UseZGC"));
+        QVERIFY(!java23.contains("-XX:+ZGenerational"));
+
+        auto g1 = JvmProfiles::find("g1-low-pause");
+        QVERIFY(JvmProfiles::arguments(*g1, jvm("1.8.0_382")).contains("-XX:G1RSetUpdatingPauseTimePercent=5"));
+        QVERIFY(!JvmProfiles::arguments(*g1, jvm("21.0.1")).contains("-XX:G1RSetUpdatingPauseTimePercent=5"));
+
+        // nothing is given to a JVM that wasn't probed yet
+        QVERIFY(JvmProfiles::arguments(*g1, jvm("")).isEmpty());
+    }
+
+    void test_Conditions()
+    {
+        auto shenandoah = JvmProfiles::find("shenandoah");
+        QVERIFY(JvmProfiles::unusableReason(*shenandoah, jvm("17.0.8")).isEmpty());
+        QVERIFY(!JvmProfiles::unusableReason(*shenandoah, jvm("17.0.8", "Oracle Corporation")).isEmpty());
+
+        auto g1 = JvmProfiles::find("g1-low-pause");
+        QVERIFY(!JvmProfiles::unusableReason(*g1, jvm("17.0.8", "IBM Corporation")).isEmpty());
+
+        auto zgc = JvmProfiles::find("zgc-generational");
+        QVERIFY(!JvmProfiles::unusableReason(*zgc, jvm("21.0.1", "Eclipse Adoptium", 2048)).isEmpty());
+        auto small = jvm("21.0.1");
+        small.architecture = "32";
+        QVERIFY(!JvmProfiles::unusableReason(*zgc, small).isEmpty());
+
+        // a collector picked by the user wins
+        auto picked = jvm("21.0.1");
+        picked.userArguments = QStringList{ "-Xss2M", "-XX:+UseG1GC" };
+        QVERIFY(!JvmProfiles::unusableReason(*zgc, picked).isEmpty());
+        picked.userArguments = QStringList{ "-Xss2M" };
+        QVERIFY(JvmProfiles::unusableReason(*zgc, picked).isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(JvmProfilesTest)
+
+#include "JvmProfiles_test.moc"
@@ -0,0 +1,75 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <launch/LaunchHistory.h>
+
+class LaunchHistoryTest : public QObject {
+    Q_OBJECT
+
+    QList<LaunchHistory::Record> records(const QList<qint64>& windowTimes)
+    {
+        QList<LaunchHistory::Record> out;
+        for (auto time : windowTimes) {
+            LaunchHistory::Record record;
+            record.windowTime = time;
+            out.append(record);
+        }
+        return out;
+    }
+
+    static qint64 windowTime(const LaunchHistory::Record& record) { return record.windowTime; }
+
+   private slots:
+    void test_Store()
+    {
+        QTemporaryDir dir;
+        auto file = LaunchHistory::file(dir.path());
+        QVERIFY(LaunchHistory::load(file).isEmpty());
+
+        for (int i = 1; i <= 4; i++) {
+            LaunchHistory::Record record;
+            record.started = QDateTime::currentDateTime();
+            record.spawnTime = i * 100;
+            record.javaVersion = "17.0.8";
+            record.javaArguments = QStringList{ "-Xmx4096m", "-XX:+UseG1GC" };
+            record.mods = i;
+            record.exitCode = i == 4 ? 1 : 0;
+            record.crashed = i == 4;
+            record.telemetry.peakHeap = i * 1000;
+            LaunchHistory::append(file, record, 3);
+        }
+
+        auto history = LaunchHistory::load(file);
+        QCOMPARE(history.size(), 3);
+        QCOMPARE(history.first().mods, 2);
+
+        auto& last = history.last();
+        QVERIFY(last.started.isValid());
+        QCOMPARE(last.spawnTime, qint64(400));
+        QCOMPARE(last.windowTime, qint64(-1));
+        QCOMPARE(last.javaVersion, QString("17.0.8"));
+        QCOMPARE(last.javaArguments, QStringList({ "-Xmx4096m", "-XX:+UseG1GC" }));
+        QCOMPARE(last.exitCode, 1);
+        QVERIFY(last.crashed);
+        QCOMPARE(last.telemetry.peakHeap, qint64(4000));
+    }
+
+    void test_Change()
+    {
+        QCOMPARE(LaunchHistory::change({}, windowTime), 0.0);
+        // needs two earlier launches to compare with
+        QCOMPARE(LaunchHistory::change(records({ 1000, 2000 }), windowTime), 0.0);
+        // the last one didn't get a window
+        QCOMPARE(LaunchHistory::change(records({ 1000, 1000, -1 }), windowTime), 0.0);
+
+        QCOMPARE(LaunchHistory::change(records({ 1000, 1000, 1300 }), windowTime), 0.3);
+        // the median of the ones before, the slow one doesn't count much and the unknown one not at all
+        QCOMPARE(LaunchHistory::change(records({ 1000, 5000, -1, 1000, 500 }), windowTime), -0.5);
+        // only the window of launches right before counts
+        QCOMPARE(LaunchHistory::change(records({ 4000, 4000, 4000, 1000, 1000, 2000 }), windowTime, 2), 1.0);
+    }
+};
+
+QTEST_GUILESS_MAIN(LaunchHistoryTest)
+
+#include "LaunchHistory_test.moc"
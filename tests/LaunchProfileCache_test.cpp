@@ -0,0 +1,106 @@
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <minecraft/LaunchProfile.h>
+#include <minecraft/LaunchProfileCache.h>
+#include <minecraft/MojangVersionFormat.h>
+#include <minecraft/VersionFile.h>
+
+class LaunchProfileCacheTest : public QObject {
+    Q_OBJECT
+
+    static RuntimeContext context(const QString& system)
+    {
+        RuntimeContext context;
+        context.javaArchitecture = "64";
+        context.javaRealArchitecture = "amd64";
+        context.system = system;
+        return context;
+    }
+
+    static std::shared_ptr<LaunchProfile> compile(const RuntimeContext& context)
+    {
+        QFile file(QFINDTESTDATA("testdata/MojangVersionFormat/1.9.json"));
+        file.open(QIODevice::ReadOnly);
+        auto vfile = MojangVersionFormat::versionFileFromJson(QJsonDocument::fromJson(file.readAll()), "1.9.json");
+        auto profile = std::make_shared<LaunchProfile>();
+        vfile->applyTo(profile.get(), context);
+        return profile;
+    }
+
+    static QStringList names(const QList<LibraryPtr>& libraries)
+    {
+        QStringList names;
+        for (auto& library : libraries)
+            names.append(library->rawName().serialize());
+        return names;
+    }
+
+   private slots:
+    void test_RoundTrip_data()
+    {
+        QTest::addColumn<QString>("system");
+        QTest::newRow("linux") << "linux";
+        QTest::newRow("osx") << "osx";
+        QTest::newRow("windows") << "windows";
+    }
+
+    void test_RoundTrip()
+    {
+        QFETCH(QString, system);
+        QTemporaryDir tmp;
+        auto path = tmp.filePath(".launch_profile");
+        auto ctx = context(system);
+        auto original = compile(ctx);
+        QVERIFY(LaunchProfileCache::save(path, "key", *original));
+
+        auto loaded = LaunchProfileCache::load(path, "key", ctx);
+        QVERIFY(loaded);
+        QCOMPARE(loaded->getMinecraftVersion(), original->getMinecraftVersion());
+        QCOMPARE(loaded->getMinecraftVersionType(), original->getMinecraftVersionType());
+        QCOMPARE(loaded->getMainClass(), original->getMainClass());
+        QCOMPARE(loaded->getMinecraftArguments(), original->getMinecraftArguments());
+        QCOMPARE(loaded->getMinecraftAssets()->id, original->getMinecraftAssets()->id);
+        QCOMPARE(loaded->getMinecraftAssets()->sha1, original->getMinecraftAssets()->sha1);
+        QCOMPARE(loaded->getTraits(), original->getTraits());
+        QCOMPARE(names(loaded->getLibraries()), names(original->getLibraries()));
+        QCOMPARE(names(loaded->getNativeLibraries()), names(original->getNativeLibraries()));
+        QVERIFY(!loaded->getNativeLibraries().isEmpty());
+
+        QStringList jars, natives, loaded_jars, loaded_natives;
+        original->getLibraryFiles(ctx, jars, natives, "overrides", "tmp");
+        loaded->getLibraryFiles(ctx, loaded_jars, loaded_natives, "overrides", "tmp");
+        QCOMPARE(loaded_jars, jars);
+        QCOMPARE(loaded_natives, natives);
+    }
+
+    void test_KeyMismatch()
+    {
+        QTemporaryDir tmp;
+        auto path = tmp.filePath(".launch_profile");
+        auto ctx = context("linux");
+        QVERIFY(LaunchProfileCache::save(path, "key", *compile(ctx)));
+        QVERIFY(!LaunchProfileCache::load(path, "other", ctx));
+        QVERIFY(!LaunchProfileCache::load(path, QByteArray(), ctx));
+        QVERIFY(!LaunchProfileCache::load(tmp.filePath("missing"), "key", ctx));
+        // nothing to go by, nothing to save
+        QVERIFY(!LaunchProfileCache::save(path, QByteArray(), *compile(ctx)));
+        QVERIFY(LaunchProfileCache::key({}, ctx).isEmpty());
+    }
+
+    void test_Garbage()
+    {
+        QTemporaryDir tmp;
+        auto path = tmp.filePath(".launch_profile");
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("not a launch profile");
+        file.close();
+        QVERIFY(!LaunchProfileCache::load(path, "key", context("linux")));
+    }
+};
+
+QTEST_GUILESS_MAIN(LaunchProfileCacheTest)
+
+#include "LaunchProfileCache_test.moc"
@@ -0,0 +1,43 @@
+#include <QTest>
+
+#include <launch/LaunchTelemetry.h>
+
+class LaunchTelemetryTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_Parse()
+    {
+        LaunchTelemetry telemetry;
+        QVERIFY(telemetry.isEmpty());
+
+        QVERIFY(!LaunchTelemetry::isTelemetry("!![Launcher]!Heap peak: 20 MiB"));
+        QVERIFY(!telemetry.parseLine("[Render thread/INFO]: phase game 20"));
+        QVERIFY(!telemetry.parseLine("!![Telemetry]!phase game"));
+        QVERIFY(!telemetry.parseLine("!![Telemetry]!unknown 1 2"));
+
+        QVERIFY(telemetry.parseLine("!![Telemetry]!phase jvm 120"));
+        QVERIFY(telemetry.parseLine("!![Telemetry]!phase game 450\n"));
+        QCOMPARE(telemetry.phases().size(), 2);
+        QCOMPARE(telemetry.phases()[1].name, QString("game"));
+        QCOMPARE(telemetry.summary().startup, qint64(450));
+
+        QVERIFY(telemetry.parseLine("!![Telemetry]!sample uptime=5000 used=100 committed=200 max=400 gcCount=2 gcTime=40"));
+        QVERIFY(telemetry.parseLine("!![Telemetry]!sample uptime=10000 used=300 committed=400 max=400 gcCount=4 gcTime=140 extra=1"));
+        QVERIFY(telemetry.parseLine("!![Telemetry]!sample uptime=15000 used=150 committed=400 max=400 gcCount=5 gcTime=150"));
+        QVERIFY(!telemetry.parseLine("!![Telemetry]!sample uptime=lots"));
+
+        auto& summary = telemetry.summary();
+        QCOMPARE(telemetry.samples().size(), 3);
+        QCOMPARE(summary.duration, qint64(15000));
+        QCOMPARE(summary.peakHeap, qint64(300));
+        QCOMPARE(summary.gcCount, qint64(5));
+        QCOMPARE(summary.gcTime, qint64(150));
+        // 100 ms for two collections in the second interval
+        QCOMPARE(summary.longestGcPause, qint64(50));
+    }
+};
+
+QTEST_GUILESS_MAIN(LaunchTelemetryTest)
+
+#include "LaunchTelemetry_test.moc"
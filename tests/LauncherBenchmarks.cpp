@@ -0,0 +1,384 @@
+#include <QCoreApplication>
+#include <QDirIterator>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <FileSystem.h>
+#include <LineFramer.h>
+#include <MMCZip.h>
+#include <MurmurHash2.h>
+#include <Version.h>
+#include <digest/Digest.h>
+#include <launch/LogClassifier.h>
+#include <launch/LogModel.h>
+#include <minecraft/AssetsUtils.h>
+#include <minecraft/GradleSpecifier.h>
+#include <minecraft/MojangVersionFormat.h>
+#include <minecraft/OneSixVersionFormat.h>
+#include <minecraft/mod/Mod.h>
+#include <minecraft/mod/tasks/LocalModParseTask.h>
+#include <net/HttpMetaCache.h>
+
+#include "BenchmarkMain.h"
+#include "FleetFixture.h"
+#include "LegacyVersion.h"
+
+/* Timings of the code that runs the most, on data like the launcher sees.
+ *
+ * Not a test, nothing is checked beyond the data loading. Run it with `--json <file>` to also get the results in
+ * JSON, see BenchmarkMain.
+ */
+class LauncherBenchmarks : public QObject {
+    Q_OBJECT
+
+    static QByteArray readFile(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        return file.readAll();
+    }
+
+    // the versions of a big mod folder, from the test vectors over and over in a shuffled order
+    QStringList sortableVersions() const
+    {
+        QStringList versions;
+        for (int i = 0; i < 20; i++) {
+            for (auto& [left, right] : m_versions)
+                versions << left << right;
+        }
+        QRandomGenerator rng(2);
+        std::shuffle(versions.begin(), versions.end(), rng);
+        return versions;
+    }
+
+   private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_tmp.isValid());
+
+        // the comparisons from the FlexVer test vectors
+        auto vectors = QString::fromUtf8(readFile(QFINDTESTDATA("testdata/Version/test_vectors.txt")));
+        for (auto& line : vectors.split('\n')) {
+            if (line.isEmpty() || line.startsWith('#'))
+                continue;
+            auto parts = line.split(' ');
+            if (parts.size() == 3)
+                m_versions.append({ parts[0], parts[2] });
+        }
+        QVERIFY(!m_versions.isEmpty());
+
+        // an asset index about as big as the one of a recent version, and a meta cache after a few modpack installs
+        m_assets_index = FS::PathCombine(m_tmp.path(), "index.json");
+        QVERIFY(FleetFixture::generateAssetsIndex(m_assets_index, 4000));
+        m_meta_cache = FS::PathCombine(m_tmp.path(), "metacache");
+        QVERIFY(FleetFixture::generateMetaCache(m_meta_cache, "benchmark", m_tmp.path(), 2000, true));
+
+        // the same index as a virtual one of the old versions, with its objects downloaded
+        auto assets_dir = FS::PathCombine(m_tmp.path(), "assets");
+        QVERIFY(FleetFixture::generateAssetsIndex(FS::PathCombine(assets_dir, "indexes", "benchmark.json"), 4000, true));
+        QVERIFY(FleetFixture::generateAssetObjects(FS::PathCombine(assets_dir, "objects"), 4000));
+
+        // a jar and the jar mods of an old modpack to merge into it
+        m_vanilla_jar = FS::PathCombine(m_tmp.path(), "vanilla.jar");
+        QVERIFY(FleetFixture::writeModJar(m_vanilla_jar, "minecraft", false));
+        auto jar_mods = FS::PathCombine(m_tmp.path(), "jarmods");
+        QVERIFY(FleetFixture::generateMods(jar_mods, 30));
+        for (auto& jar : QDir(jar_mods).entryInfoList({ "*.jar" }, QDir::Files, QDir::Name))
+            m_jar_mods.append(jar.absoluteFilePath());
+
+        QRandomGenerator rng(1);
+        m_mod_data = QByteArray(4 * 1024 * 1024, Qt::Uninitialized);
+        for (auto& c : m_mod_data)
+            c = static_cast<char>(rng.bounded(256));
+
+        QDirIterator jars(QFINDTESTDATA("testdata"), { "*.jar" }, QDir::Files, QDirIterator::Subdirectories);
+        while (jars.hasNext())
+            m_mod_jars.append(jars.next());
+        QVERIFY(!m_mod_jars.isEmpty());
+
+        m_log_data = readFile(QFINDTESTDATA("testdata/LogClassifier/modpack.log"));
+        auto log = QString::fromUtf8(m_log_data);
+        m_log_lines = log.split('\n');
+        QVERIFY(!m_log_lines.isEmpty());
+    }
+
+    void bench_VersionCompare()
+    {
+        QList<QPair<Version, Version>> versions;
+        for (auto& [left, right] : m_versions)
+            versions.append({ Version(left), Version(right) });
+
+        int less = 0;
+        QBENCHMARK {
+            for (auto& [left, right] : versions)
+                less += left < right;
+        }
+        Q_UNUSED(less)
+    }
+
+    void bench_VersionParse()
+    {
+        QBENCHMARK {
+            for (auto& [left, right] : m_versions) {
+                Version parsed_left(left);
+                Version parsed_right(right);
+            }
+        }
+    }
+
+    // sorting a mod list by version, like it was done before the sections got precomputed
+    void bench_VersionSortLegacy()
+    {
+        auto versions = sortableVersions();
+        QBENCHMARK {
+            auto sorted = versions;
+            std::stable_sort(sorted.begin(), sorted.end(),
+                             [](const QString& left, const QString& right) { return LegacyVersion(left) < LegacyVersion(right); });
+        }
+    }
+
+    void bench_VersionSort()
+    {
+        auto versions = sortableVersions();
+        QBENCHMARK {
+            auto sorted = versions;
+            Version::sort(sorted, [](const QString& version) { return version; });
+        }
+    }
+
+    void bench_VersionCompareLegacy()
+    {
+        QList<QPair<LegacyVersion, LegacyVersion>> versions;
+        for (auto& [left, right] : m_versions)
+            versions.append({ LegacyVersion(left), LegacyVersion(right) });
+
+        int less = 0;
+        QBENCHMARK {
+            for (auto& [left, right] : versions)
+                less += left < right;
+        }
+        Q_UNUSED(less)
+    }
+
+    void bench_GradleSpecifierParse()
+    {
+        static const QStringList specifiers = {
+            "org.lwjgl:lwjgl:3.3.1",
+            "org.lwjgl:lwjgl:3.3.1:natives-linux",
+            "net.fabricmc:fabric-loader:0.14.21",
+            "com.mojang:minecraft:1.20.1:client@jar",
+            "de.oceanlabs.mcp:mcp_config:1.20.1-20230612.114412@zip",
+        };
+        QBENCHMARK {
+            for (auto& specifier : specifiers) {
+                GradleSpecifier parsed(specifier);
+                auto path = parsed.toPath();
+                Q_UNUSED(path)
+            }
+        }
+    }
+
+    void bench_MojangVersionFormat()
+    {
+        auto doc = QJsonDocument::fromJson(readFile(QFINDTESTDATA("testdata/MojangVersionFormat/1.9.json")));
+        QBENCHMARK {
+            MojangVersionFormat::versionFileFromJson(doc, "1.9.json");
+        }
+    }
+
+    void bench_OneSixVersionFormat()
+    {
+        auto doc = QJsonDocument::fromJson(readFile(QFINDTESTDATA("testdata/MojangVersionFormat/1.9.json")));
+        QBENCHMARK {
+            OneSixVersionFormat::versionFileFromJson(doc, "1.9.json", false);
+        }
+    }
+
+    void bench_LocalModParse()
+    {
+        QBENCHMARK {
+            for (auto& jar : m_mod_jars) {
+                Mod mod(jar);
+                ModUtils::process(mod, ModUtils::ProcessingLevel::Full);
+            }
+        }
+    }
+
+    void bench_MurmurHash2()
+    {
+        QBENCHMARK {
+            MurmurHash2(m_mod_data.constData(), m_mod_data.size(), [](char c) { return c == 9 || c == 10 || c == 13 || c == 32; });
+        }
+    }
+
+    // QCryptographicHash against each implementation of Digest this CPU can run, "qt" being QCryptographicHash
+    void bench_Digest_data()
+    {
+        QTest::addColumn<int>("algorithm");
+        QTest::addColumn<QString>("implementation");
+
+        for (auto [name, algorithm] : { qMakePair("sha1", QCryptographicHash::Sha1), qMakePair("sha256", QCryptographicHash::Sha256),
+                                        qMakePair("sha512", QCryptographicHash::Sha512) }) {
+            QTest::addRow("%s qt", name) << int(algorithm) << QString("qt");
+            for (auto& implementation : Digest::implementations(algorithm))
+                QTest::addRow("%s %s", name, qPrintable(implementation)) << int(algorithm) << implementation;
+        }
+    }
+    void bench_Digest()
+    {
+        QFETCH(int, algorithm);
+        QFETCH(QString, implementation);
+
+        if (implementation == "qt") {
+            QBENCHMARK {
+                QCryptographicHash::hash(m_mod_data, QCryptographicHash::Algorithm(algorithm));
+            }
+        } else {
+            Digest digest(QCryptographicHash::Algorithm(algorithm), implementation);
+            QBENCHMARK {
+                digest.reset();
+                digest.addData(m_mod_data);
+                digest.result();
+            }
+        }
+    }
+
+    void bench_HttpMetaCacheLoad()
+    {
+        QBENCHMARK {
+            HttpMetaCache cache(m_meta_cache);
+            cache.addBase("benchmark", m_tmp.path());
+            cache.Load();
+        }
+    }
+
+    // what every download of a cached file does first
+    void bench_HttpMetaCacheResolve()
+    {
+        HttpMetaCache cache(m_meta_cache);
+        cache.addBase("benchmark", m_tmp.path());
+        cache.Load();
+        // the first look at each file hashes it, the ones after only compare the timestamp
+        for (int i = 0; i < 2000; i++)
+            QVERIFY(!cache.resolveEntry("benchmark", QString("files/%1.jar").arg(i))->isStale());
+
+        QBENCHMARK {
+            for (int i = 0; i < 2000; i++)
+                cache.resolveEntry("benchmark", QString("files/%1.jar").arg(i));
+        }
+    }
+
+    void bench_AssetsIndexLoad()
+    {
+        QBENCHMARK {
+            AssetsIndex index;
+            AssetsUtils::loadAssetsIndexJson("benchmark", m_assets_index, index);
+        }
+    }
+
+    void bench_ReconstructAssets_data()
+    {
+        QTest::addColumn<bool>("fresh");
+        QTest::newRow("placing") << true;
+        QTest::newRow("unchanged") << false;
+    }
+
+    // what launching a version with virtual assets does, the first time and every time after
+    void bench_ReconstructAssets()
+    {
+        QFETCH(bool, fresh);
+        // it works on the assets folder of the working directory
+        auto previous_dir = QDir::currentPath();
+        QDir::setCurrent(m_tmp.path());
+        auto virtual_dir = FS::PathCombine(m_tmp.path(), "assets", "virtual", "benchmark");
+        auto resources = FS::PathCombine(m_tmp.path(), "resources");
+        QVERIFY(AssetsUtils::reconstructAssets("benchmark", resources));
+
+        QBENCHMARK {
+            if (fresh)
+                FS::deletePath(virtual_dir);
+            AssetsUtils::reconstructAssets("benchmark", resources);
+        }
+        QDir::setCurrent(previous_dir);
+    }
+
+    void bench_CreateModdedJar()
+    {
+        std::vector<std::unique_ptr<Mod>> owned;
+        QList<Mod*> mods;
+        for (auto& jar : m_jar_mods) {
+            owned.push_back(std::make_unique<Mod>(jar));
+            mods.append(owned.back().get());
+        }
+        auto target = FS::PathCombine(m_tmp.path(), "modded.jar");
+
+        QBENCHMARK {
+            QVERIFY(MMCZip::createModdedJar(m_vanilla_jar, target, mods));
+        }
+    }
+
+    // what the console does with the game's output: batches of lines into a ring buffer that is full soon
+    void bench_LogModelAppend()
+    {
+        QList<QPair<QVector<MessageLevel::Enum>, QStringList>> batches;
+        for (int i = 0; i < m_log_lines.size(); i += 64) {
+            auto lines = m_log_lines.mid(i, 64);
+            batches.append({ QVector<MessageLevel::Enum>(lines.size(), MessageLevel::Info), lines });
+        }
+
+        LogModel model;
+        model.setMaxLines(10000);
+        QBENCHMARK {
+            for (auto& [levels, lines] : batches)
+                model.append(levels, lines);
+        }
+    }
+
+    // what MinecraftInstance::guessLevel does for every line of the game's output
+    void bench_GuessLevel()
+    {
+        LogClassifier classifier;
+        QBENCHMARK {
+            for (auto& line : m_log_lines)
+                classifier.classify(line, MessageLevel::Unknown);
+        }
+    }
+
+    // what LoggedProcess does with the game's output, in the chunks a pipe gives
+    void bench_LineFraming()
+    {
+        LineFramer framer(QTextCodec::codecForName("UTF-8"));
+        QBENCHMARK {
+            for (qsizetype i = 0; i < m_log_data.size(); i += 4096)
+                framer.feed(m_log_data.constData() + i, qMin<qsizetype>(4096, m_log_data.size() - i));
+            framer.flush();
+        }
+    }
+
+   private:
+    QTemporaryDir m_tmp;
+    QList<QPair<QString, QString>> m_versions;
+    QString m_assets_index;
+    QString m_meta_cache;
+    QByteArray m_mod_data;
+    QStringList m_mod_jars;
+    QString m_vanilla_jar;
+    QStringList m_jar_mods;
+    QByteArray m_log_data;
+    QStringList m_log_lines;
+};
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    LauncherBenchmarks benchmarks;
+    return BenchmarkMain::run(&benchmarks, app.arguments());
+}
+
+#include "LauncherBenchmarks.moc"
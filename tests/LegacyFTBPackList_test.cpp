@@ -0,0 +1,69 @@
+#include <QTest>
+
+#include <modplatform/legacy_ftb/PackFetchTask.h>
+
+using namespace LegacyFTB;
+
+class LegacyFTBPackListTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_Parse()
+    {
+        QByteArray xml = R"(<?xml version="1.0" encoding="UTF-8"?>
+<modpacks>
+    <modpack name="Pack" author="Someone" version="1.2" mcVersion="1.7.10" description="A pack" mods="a, b" logo="pack.png"
+             oldVersions="1.2;1.1" dir="pack" url="pack.zip"/>
+    <modpack name="Bugged" version="2.0" oldVersions=";" dir="bugged" url="bugged.zip"/>
+    <modpack name="Broken" dir="broken" url="broken.zip"/>
+</modpacks>)";
+
+        ModpackList packs;
+        QCOMPARE(PackFetchTask::parsePacks(xml, PackType::Public, packs), QString());
+        QCOMPARE(packs.size(), 3);
+        QCOMPARE(packs[0].name, QString("Pack"));
+        QCOMPARE(packs[0].author, QString("Someone"));
+        QCOMPARE(packs[0].oldVersions, QStringList({ "1.2", "1.1" }));
+        QCOMPARE(packs[0].file, QString("pack.zip"));
+        QCOMPARE(packs[0].type, PackType::Public);
+        QVERIFY(!packs[0].bugged && !packs[0].broken);
+        QVERIFY(packs[1].bugged);
+        QCOMPARE(packs[1].oldVersions, QStringList({ "2.0" }));
+        QVERIFY(packs[2].broken);
+
+        // nothing is taken from a list that doesn't parse
+        ModpackList broken;
+        QVERIFY(!PackFetchTask::parsePacks("<modpacks><modpack name=\"a\">", PackType::Public, broken).isEmpty());
+        QVERIFY(broken.isEmpty());
+    }
+
+    void test_Cache()
+    {
+        ModpackList publicPacks;
+        PackFetchTask::parsePacks(R"(<modpacks><modpack name="Pack" version="1" oldVersions="1" url="p.zip"/></modpacks>)",
+                                  PackType::Public, publicPacks);
+        ModpackList thirdPartyPacks;
+        PackFetchTask::parsePacks(R"(<modpacks><modpack name="Other" version="2" oldVersions="2;1" url="o.zip"/></modpacks>)",
+                                  PackType::ThirdParty, thirdPartyPacks);
+
+        auto data = PackFetchTask::serializeLists("key", publicPacks, thirdPartyPacks);
+
+        ModpackList cachedPublic;
+        ModpackList cachedThirdParty;
+        QVERIFY(!PackFetchTask::deserializeLists(data, "other key", cachedPublic, cachedThirdParty));
+        QVERIFY(cachedPublic.isEmpty());
+        QVERIFY(!PackFetchTask::deserializeLists(data.left(data.size() / 2), "key", cachedPublic, cachedThirdParty));
+
+        QVERIFY(PackFetchTask::deserializeLists(data, "key", cachedPublic, cachedThirdParty));
+        QCOMPARE(cachedPublic.size(), 1);
+        QCOMPARE(cachedPublic[0].name, QString("Pack"));
+        QCOMPARE(cachedPublic[0].file, QString("p.zip"));
+        QCOMPARE(cachedThirdParty.size(), 1);
+        QCOMPARE(cachedThirdParty[0].oldVersions, QStringList({ "2", "1" }));
+        QCOMPARE(cachedThirdParty[0].type, PackType::ThirdParty);
+    }
+};
+
+QTEST_GUILESS_MAIN(LegacyFTBPackListTest)
+
+#include "LegacyFTBPackList_test.moc"
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+
+/* The Version comparison as it was before the sections got precomputed, to check the current one against and to
+ * time it. Every comparison copies the sections, and the parsing builds a string for each of them.
+ */
+class LegacyVersion {
+   public:
+    explicit LegacyVersion(QString str) : m_string(std::move(str)) { parse(); }
+
+    bool operator<(const LegacyVersion& other) const { return compare(other, true); }
+    bool operator==(const LegacyVersion& other) const { return !compare(other, false); }
+
+   private:
+    struct Section {
+        explicit Section(QString fullString) : m_fullString(std::move(fullString))
+        {
+            int cutoff = m_fullString.size();
+            for (int i = 0; i < m_fullString.size(); i++) {
+                if (!m_fullString[i].isDigit()) {
+                    cutoff = i;
+                    break;
+                }
+            }
+
+            auto numPart = m_fullString.left(cutoff);
+            if (!numPart.isEmpty()) {
+                m_isNull = false;
+                m_numPart = numPart.toInt();
+            }
+
+            auto stringPart = m_fullString.mid(cutoff);
+            if (!stringPart.isEmpty()) {
+                m_isNull = false;
+                m_stringPart = stringPart;
+            }
+        }
+
+        explicit Section() = default;
+
+        bool m_isNull = true;
+        int m_numPart = 0;
+        QString m_stringPart;
+        QString m_fullString;
+
+        bool isAppendix() const { return m_stringPart.startsWith('+'); }
+        bool isPreRelease() const { return m_stringPart.startsWith('-') && m_stringPart.length() > 1; }
+
+        bool operator==(const Section& other) const
+        {
+            if (m_isNull != other.m_isNull)
+                return false;
+            if (!m_isNull)
+                return (m_numPart == other.m_numPart) && (m_stringPart == other.m_stringPart);
+            return true;
+        }
+        bool operator!=(const Section& other) const { return !(*this == other); }
+
+        bool operator<(const Section& other) const
+        {
+            static auto unequal_is_less = [](Section const& non_null) -> bool {
+                if (non_null.m_stringPart.isEmpty())
+                    return non_null.m_numPart == 0;
+                return (non_null.m_stringPart != QLatin1Char('.')) && non_null.isPreRelease();
+            };
+
+            if (!m_isNull && other.m_isNull)
+                return unequal_is_less(*this);
+            if (m_isNull && !other.m_isNull)
+                return !unequal_is_less(other);
+
+            if (!m_isNull && !other.m_isNull) {
+                if (m_numPart < other.m_numPart)
+                    return true;
+                if (m_numPart == other.m_numPart && m_stringPart < other.m_stringPart)
+                    return true;
+                if (!m_stringPart.isEmpty() && other.m_stringPart.isEmpty())
+                    return false;
+                if (m_stringPart.isEmpty() && !other.m_stringPart.isEmpty())
+                    return true;
+                return false;
+            }
+
+            return m_fullString < other.m_fullString;
+        }
+    };
+
+    // whether the first different section is lower with `less`, whether there is one at all without it
+    bool compare(const LegacyVersion& other, bool less) const
+    {
+        bool exclude_our_sections = false;
+        bool exclude_their_sections = false;
+
+        const auto size = qMax(m_sections.size(), other.m_sections.size());
+        for (int i = 0; i < size; ++i) {
+            Section sec1 = (i >= m_sections.size()) ? Section() : m_sections.at(i);
+            Section sec2 = (i >= other.m_sections.size()) ? Section() : other.m_sections.at(i);
+
+            if (sec1.isAppendix())
+                exclude_our_sections = true;
+            if (sec2.isAppendix())
+                exclude_their_sections = true;
+
+            if (exclude_our_sections) {
+                sec1 = Section();
+                if (sec2.m_isNull)
+                    break;
+            }
+            if (exclude_their_sections) {
+                sec2 = Section();
+                if (sec1.m_isNull)
+                    break;
+            }
+
+            if (sec1 != sec2)
+                return less ? sec1 < sec2 : true;
+        }
+        return false;
+    }
+
+    void parse()
+    {
+        QString currentSection;
+        if (m_string.isEmpty())
+            return;
+
+        auto classChange = [&](QChar lastChar, QChar currentChar) {
+            if (lastChar.isNull())
+                return false;
+            if (lastChar.isDigit() != currentChar.isDigit())
+                return true;
+
+            const QList<QChar> s_separators{ '.', '-', '+' };
+            if (s_separators.contains(currentChar) && currentSection.at(0) != currentChar)
+                return true;
+
+            return false;
+        };
+
+        currentSection += m_string.at(0);
+        for (int i = 1; i < m_string.size(); ++i) {
+            const auto& current_char = m_string.at(i);
+            if (classChange(m_string.at(i - 1), current_char)) {
+                if (!currentSection.isEmpty())
+                    m_sections.append(Section(currentSection));
+                currentSection = "";
+            }
+            currentSection += current_char;
+        }
+
+        if (!currentSection.isEmpty())
+            m_sections.append(Section(currentSection));
+    }
+
+    QString m_string;
+    QList<Section> m_sections;
+};
@@ -321,6 +321,46 @@ slots:
         QCOMPARE(dls[0]->m_url, QUrl("https://libraries.minecraft.net/tv/twitch/twitch-platform/5.16/twitch-platform-5.16-natives-windows-32.jar"));
         QCOMPARE(dls[1]->m_url, QUrl("https://libraries.minecraft.net/tv/twitch/twitch-platform/5.16/twitch-platform-5.16-natives-windows-64.jar"));
     }
+    void test_checksums()
+    {
+        RuntimeContext r = dummyContext("osx");
+        auto native = readMojangJson(QFINDTESTDATA("testdata/Library/lib-native.json"));
+        using Checksums = QList<QPair<QString, QString>>;
+        QCOMPARE(native->getChecksums(r), (Checksums{
+            { "org/lwjgl/lwjgl/lwjgl-platform/2.9.4-nightly-20150209/lwjgl-platform-2.9.4-nightly-20150209-natives-osx.jar",
+              "bcab850f8f487c3f4c4dbabde778bb82bd1a40ed" } }));
+
+        r = dummyContext("windows");
+        auto arch = readMojangJson(QFINDTESTDATA("testdata/Library/lib-native-arch.json"));
+        QCOMPARE(arch->getChecksums(r), (Checksums{
+            { "tv/twitch/twitch-platform/5.16/twitch-platform-5.16-natives-windows-32.jar", "7c6affe439099806a4f552da14c42f9d643d8b23" },
+            { "tv/twitch/twitch-platform/5.16/twitch-platform-5.16-natives-windows-64.jar", "39d0c3d363735b4785598e0e7fbf8297c706a9f9" } }));
+
+        // nothing to check for the local ones, and no checksum without the Mojang metadata
+        arch->setHint("local");
+        QCOMPARE(arch->getChecksums(r), Checksums());
+        Library legacy("test.package:testname:testversion");
+        QCOMPARE(legacy.getChecksums(r), (Checksums{ { "test/package/testname/testversion/testname-testversion.jar", QString() } }));
+    }
+    void test_rules_context()
+    {
+        Library test("test.package:testname:testversion");
+        test.setRules({ImplicitRule::create(Disallow), OsRule::create(Allow, "osx", QString())});
+        RuntimeContext r = dummyContext("osx");
+        QCOMPARE(test.isActive(r), true);
+        QCOMPARE(test.isActive(r), true);
+        // a different context is evaluated again
+        r.system = "linux";
+        QCOMPARE(test.isActive(r), false);
+        r.system = "osx";
+        r.javaRealArchitecture = "aarch64";
+        QCOMPARE(test.isActive(r), false);
+        r.javaRealArchitecture = "amd64";
+        QCOMPARE(test.isActive(r), true);
+        // and so is the same one, after the rules changed
+        test.setRules({OsRule::create(Disallow, "osx", QString())});
+        QCOMPARE(test.isActive(r), false);
+    }
 private:
     std::unique_ptr<HttpMetaCache> cache;
     QString dataDir;
@@ -0,0 +1,90 @@
+#include <QBuffer>
+#include <QTest>
+
+#include <LineFramer.h>
+
+class LineFramerTest : public QObject {
+    Q_OBJECT
+
+    static QTextCodec* utf8() { return QTextCodec::codecForName("UTF-8"); }
+
+   private slots:
+    void test_completeLines()
+    {
+        LineFramer framer(utf8());
+        QCOMPARE(framer.feed(QByteArray("first\nsecond\n")), QStringList({ "first", "second" }));
+        QVERIFY(framer.flush().isEmpty());
+    }
+
+    void test_lineAcrossChunks()
+    {
+        LineFramer framer(utf8());
+        QCOMPARE(framer.feed(QByteArray("first\nsec")), QStringList({ "first" }));
+        QVERIFY(framer.feed(QByteArray("on")).isEmpty());
+        QCOMPARE(framer.feed(QByteArray("d\nthird")), QStringList({ "second" }));
+        QCOMPARE(framer.flush(), QStringList({ "third" }));
+        QVERIFY(framer.flush().isEmpty());
+    }
+
+    void test_carriageReturnsAndEmptyLines()
+    {
+        LineFramer framer(utf8());
+        QCOMPARE(framer.feed(QByteArray("one\r\n\r\n\nt\rwo\r")), QStringList({ "one" }));
+        QCOMPARE(framer.feed(QByteArray("\n")), QStringList({ "two" }));
+    }
+
+    void test_characterAcrossChunks()
+    {
+        LineFramer framer(utf8());
+        auto bytes = QString("héllo ☃\n").toUtf8();
+        // cuts into both the two and the three byte sequences
+        QVERIFY(framer.feed(bytes.left(2)).isEmpty());
+        QVERIFY(framer.feed(bytes.mid(2, 7)).isEmpty());
+        QCOMPARE(framer.feed(bytes.mid(9)), QStringList({ QString("héllo ☃") }));
+    }
+
+    void test_otherCodec()
+    {
+        LineFramer framer(QTextCodec::codecForName("ISO-8859-1"));
+        QCOMPARE(framer.feed(QByteArray("caf\xe9\n")), QStringList({ QString("café") }));
+    }
+
+    void test_readDevice()
+    {
+        QByteArray output;
+        for (int i = 0; i < 10000; i++)
+            output += "line " + QByteArray::number(i) + "\n";
+
+        QBuffer device(&output);
+        QVERIFY(device.open(QIODevice::ReadOnly));
+        LineFramer framer(utf8());
+        auto lines = framer.read(&device);
+        QCOMPARE(lines.size(), 10000);
+        QCOMPARE(lines.first(), QString("line 0"));
+        QCOMPARE(lines.last(), QString("line 9999"));
+        QVERIFY(framer.read(&device).isEmpty());
+    }
+
+    void test_manyChunks()
+    {
+        QByteArray output;
+        QStringList expected;
+        for (int i = 0; i < 5000; i++) {
+            auto line = QByteArray("a rather long line of output, number ") + QByteArray::number(i);
+            output += line + "\r\n";
+            expected.append(line);
+        }
+
+        LineFramer framer(utf8());
+        QStringList lines;
+        // chunks that never line up with the lines, nor with the buffer
+        for (qsizetype i = 0; i < output.size(); i += 4093)
+            lines += framer.feed(output.mid(i, 4093));
+        lines += framer.flush();
+        QCOMPARE(lines, expected);
+    }
+};
+
+QTEST_GUILESS_MAIN(LineFramerTest)
+
+#include "LineFramer_test.moc"
@@ -0,0 +1,107 @@
+#include <QFile>
+#include <QRegularExpression>
+#include <QTest>
+
+#include <launch/LogClassifier.h>
+
+class LogClassifierTest : public QObject {
+    Q_OBJECT
+
+    // What MinecraftInstance::guessLevel used to do, which the classifier has to agree with
+    static MessageLevel::Enum reference(const QString& line, MessageLevel::Enum level)
+    {
+        QRegularExpression re("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]");
+        auto match = re.match(line);
+        if (match.hasMatch()) {
+            QString levelStr = match.captured("level");
+            if (levelStr == "INFO")
+                level = MessageLevel::Message;
+            if (levelStr == "WARN")
+                level = MessageLevel::Warning;
+            if (levelStr == "ERROR")
+                level = MessageLevel::Error;
+            if (levelStr == "FATAL")
+                level = MessageLevel::Fatal;
+            if (levelStr == "TRACE" || levelStr == "DEBUG")
+                level = MessageLevel::Debug;
+        } else {
+            if (line.contains("[INFO]") || line.contains("[CONFIG]") || line.contains("[FINE]") || line.contains("[FINER]") ||
+                line.contains("[FINEST]"))
+                level = MessageLevel::Message;
+            if (line.contains("[SEVERE]") || line.contains("[STDERR]"))
+                level = MessageLevel::Error;
+            if (line.contains("[WARNING]"))
+                level = MessageLevel::Warning;
+            if (line.contains("[DEBUG]"))
+                level = MessageLevel::Debug;
+        }
+        if (line.contains("overwriting existing"))
+            return MessageLevel::Fatal;
+        static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
+        if (line.contains("Exception in thread") || line.contains(QRegularExpression("\\s+at " + javaSymbol)) ||
+            line.contains(QRegularExpression("Caused by: " + javaSymbol)) ||
+            line.contains(QRegularExpression("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)")) ||
+            line.contains(QRegularExpression("... \\d+ more$")))
+            return MessageLevel::Error;
+        return level;
+    }
+
+    static QStringList recordedLog()
+    {
+        QFile file(QFINDTESTDATA("testdata/LogClassifier/modpack.log"));
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        return QString::fromUtf8(file.readAll()).split('\n');
+    }
+
+   private slots:
+    void test_MatchesReference()
+    {
+        auto lines = recordedLog();
+        QVERIFY(!lines.isEmpty());
+
+        LogClassifier classifier;
+        for (auto& line : lines) {
+            for (auto level : { MessageLevel::StdOut, MessageLevel::StdErr, MessageLevel::Unknown }) {
+                if (classifier.classify(line, level) != reference(line, level))
+                    QFAIL(qPrintable(QString("Mismatch for line: %1").arg(line)));
+            }
+        }
+    }
+
+    void test_CustomRules()
+    {
+        LogClassifier classifier({ { "NOTICE", MessageLevel::Info } }, { { "<warn>", MessageLevel::Warning } },
+                                 { { { "panic" }, {}, MessageLevel::Fatal } });
+
+        QCOMPARE(classifier.classify("[10:00:00] [main/NOTICE]: hello", MessageLevel::StdOut), MessageLevel::Info);
+        QCOMPARE(classifier.classify("[10:00:00] [main/INFO]: hello", MessageLevel::StdOut), MessageLevel::StdOut);
+        QCOMPARE(classifier.classify("<warn> careful", MessageLevel::StdOut), MessageLevel::Warning);
+        QCOMPARE(classifier.classify("[10:00:00] [main/NOTICE]: panic", MessageLevel::StdOut), MessageLevel::Fatal);
+    }
+
+    void benchmark_Reference()
+    {
+        auto lines = recordedLog();
+        QBENCHMARK
+        {
+            for (auto& line : lines)
+                reference(line, MessageLevel::StdOut);
+        }
+    }
+
+    void benchmark_Classifier()
+    {
+        auto lines = recordedLog();
+        LogClassifier classifier;
+        QBENCHMARK
+        {
+            for (auto& line : lines)
+                classifier.classify(line, MessageLevel::StdOut);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(LogClassifierTest)
+
+#include "LogClassifier_test.moc"
@@ -0,0 +1,72 @@
+#include <QTest>
+
+#include <launch/LogCompactor.h>
+
+class LogCompactorTest : public QObject {
+    Q_OBJECT
+
+    static QStringList trace(const QString& frame)
+    {
+        return { "java.lang.IllegalStateException: broken", "\tat " + frame + ".first(A.java:1)", "\tat " + frame + ".second(A.java:2)",
+                 "\tat " + frame + ".third(A.java:3)" };
+    }
+
+   private slots:
+    void test_repeatedLines()
+    {
+        LogCompactor compactor;
+        QStringList lines{ "start", "spam", "spam", "spam", "end" };
+        QCOMPARE(compactor.compact(lines), QStringList({ "start", "spam", "[the line above was repeated 2 more times]", "end" }));
+    }
+
+    void test_repeatedStackTraces()
+    {
+        LogCompactor compactor;
+        QStringList lines;
+        lines << "first" << trace("a.B") << "second" << trace("a.B") << "third" << trace("c.D");
+
+        QStringList expected;
+        expected << "first" << trace("a.B") << "second" << trace("a.B").first() << "\t[same stack trace as on line 3, 3 lines]"
+                 << "third" << trace("c.D");
+        QCOMPARE(compactor.compact(lines), expected);
+    }
+
+    void test_keepsEverythingWhenShort()
+    {
+        LogCompactor compactor(100);
+        QStringList lines;
+        for (int i = 0; i < 100; i++)
+            lines << QString("line %1").arg(i);
+        QCOMPARE(compactor.compact(lines), lines);
+    }
+
+    void test_trimKeepsErrors()
+    {
+        LogCompactor compactor(40, 2);
+        QStringList lines;
+        QVector<MessageLevel::Enum> levels;
+        for (int i = 0; i < 1000; i++) {
+            lines << QString("line %1").arg(i);
+            levels << (i == 500 ? MessageLevel::Error : MessageLevel::Message);
+        }
+
+        auto out = compactor.compact(lines, levels);
+        QCOMPARE(out.first(), QString("line 0"));
+        QCOMPARE(out.last(), QString("line 999"));
+        QCOMPARE(out.at(9), QString("line 9"));
+        QCOMPARE(out.at(10), QString("[... 488 lines left out ...]"));
+        QCOMPARE(out.mid(11, 5), QStringList({ "line 498", "line 499", "line 500", "line 501", "line 502" }));
+        QCOMPARE(out.at(16), QString("[... 487 lines left out ...]"));
+        QCOMPARE(out.at(17), QString("line 990"));
+    }
+
+    void test_text()
+    {
+        LogCompactor compactor;
+        QCOMPARE(compactor.compact(QString("a\na\nb\n")), QString("a\n[the line above was repeated 1 more times]\nb\n"));
+    }
+};
+
+QTEST_GUILESS_MAIN(LogCompactorTest)
+
+#include "LogCompactor_test.moc"
@@ -0,0 +1,90 @@
+#include <QSignalSpy>
+#include <QTest>
+
+#include <launch/LogModel.h>
+
+class LogModelTest : public QObject {
+    Q_OBJECT
+
+    static QStringList numbered(int from, int count)
+    {
+        QStringList lines;
+        for (int i = from; i < from + count; i++)
+            lines.append(QString::number(i));
+        return lines;
+    }
+
+    static QVector<MessageLevel::Enum> levels(int count) { return QVector<MessageLevel::Enum>(count, MessageLevel::Message); }
+
+   private slots:
+    void test_BatchIsOneInsertion()
+    {
+        LogModel model;
+        QSignalSpy inserted(&model, &LogModel::rowsInserted);
+
+        model.append(levels(100), numbered(0, 100));
+
+        QCOMPARE(inserted.count(), 1);
+        QCOMPARE(model.rowCount(), 100);
+        QCOMPARE(model.data(model.index(42), Qt::DisplayRole).toString(), QString("42"));
+        QCOMPARE(model.data(model.index(42), LogModel::LevelRole).toInt(), int(MessageLevel::Message));
+    }
+
+    void test_Overflow()
+    {
+        LogModel model;
+        model.setMaxLines(10);
+        QSignalSpy removed(&model, &LogModel::rowsRemoved);
+
+        model.append(levels(8), numbered(0, 8));
+        model.append(levels(5), numbered(8, 5));
+
+        QCOMPARE(removed.count(), 1);
+        QCOMPARE(model.rowCount(), 10);
+        QCOMPARE(model.data(model.index(0), Qt::DisplayRole).toString(), QString("3"));
+        QCOMPARE(model.data(model.index(9), Qt::DisplayRole).toString(), QString("12"));
+
+        // a batch bigger than the whole buffer only keeps its end
+        model.append(levels(25), numbered(100, 25));
+        QCOMPARE(model.rowCount(), 10);
+        QCOMPARE(model.data(model.index(0), Qt::DisplayRole).toString(), QString("115"));
+        QCOMPARE(model.data(model.index(9), Qt::DisplayRole).toString(), QString("124"));
+
+        model.setMaxLines(4);
+        QCOMPARE(model.rowCount(), 4);
+        QCOMPARE(model.data(model.index(0), Qt::DisplayRole).toString(), QString("121"));
+    }
+
+    void test_StopOnOverflow()
+    {
+        LogModel model;
+        model.setMaxLines(10);
+        model.setStopOnOverflow(true);
+        model.setOverflowMessage("STOP");
+
+        model.append(levels(8), numbered(0, 8));
+        model.append(levels(5), numbered(8, 5));
+        model.append(MessageLevel::Message, "ignored");
+
+        QCOMPARE(model.rowCount(), 10);
+        QCOMPARE(model.data(model.index(8), Qt::DisplayRole).toString(), QString("8"));
+        QCOMPARE(model.data(model.index(9), Qt::DisplayRole).toString(), QString("STOP"));
+        QCOMPARE(model.data(model.index(9), LogModel::LevelRole).toInt(), int(MessageLevel::Fatal));
+    }
+
+    void benchmark_Append()
+    {
+        auto lines = numbered(0, 1000);
+        auto lineLevels = levels(1000);
+        LogModel model;
+        model.setMaxLines(100000);
+        QBENCHMARK
+        {
+            model.append(lineLevels, lines);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(LogModelTest)
+
+#include "LogModel_test.moc"
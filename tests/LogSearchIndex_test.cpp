@@ -0,0 +1,101 @@
+#include <QSignalSpy>
+#include <QTest>
+
+#include <launch/LogModel.h>
+#include <launch/LogSearchIndex.h>
+
+class LogSearchIndexTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_matchesAndNavigation()
+    {
+        LogModel model;
+        model.setMaxLines(100);
+        model.append({ MessageLevel::Info, MessageLevel::Error, MessageLevel::Info, MessageLevel::Warning },
+                     { "Loading mods", "Failed to load Mod A", "Done", "mod B is outdated" });
+
+        LogSearchIndex index;
+        index.setModel(&model);
+        index.setQuery("MOD");
+        QCOMPARE(index.matchCount(), 3);
+        QCOMPARE(index.matchIndex(1), 1);
+        QCOMPARE(index.matchIndex(2), -1);
+
+        QCOMPARE(index.nextMatch(1, false), 3);
+        QCOMPARE(index.nextMatch(3, false), 0);
+        QCOMPARE(index.nextMatch(0, true), 3);
+        QCOMPARE(index.nextMatch(2, true), 1);
+    }
+
+    void test_levels()
+    {
+        LogModel model;
+        model.setMaxLines(100);
+        model.append({ MessageLevel::Info, MessageLevel::Error, MessageLevel::Warning }, { "mod one", "mod two", "three" });
+
+        LogSearchIndex index;
+        index.setModel(&model);
+        index.setQuery("mod");
+        index.setLevels({ MessageLevel::Error });
+        QCOMPARE(index.matchCount(), 1);
+        QCOMPARE(index.nextMatch(0, false), 1);
+
+        // without a query, the levels alone pick the lines
+        index.setQuery("");
+        index.setLevels({ MessageLevel::Error, MessageLevel::Warning });
+        QCOMPARE(index.matchCount(), 2);
+
+        index.setLevels({});
+        QCOMPARE(index.matchCount(), 0);
+    }
+
+    void test_followsTheModel()
+    {
+        LogModel model;
+        model.setMaxLines(4);
+        LogSearchIndex index;
+        index.setModel(&model);
+        index.setQuery("hit");
+
+        QSignalSpy spy(&index, &LogSearchIndex::matchesChanged);
+        model.append(MessageLevel::Info, "hit 1");
+        model.append(MessageLevel::Info, "miss");
+        model.append(MessageLevel::Info, "hit 2");
+        QCOMPARE(index.matchCount(), 2);
+        QCOMPARE(spy.count(), 2);
+
+        // the oldest lines go away with their matches, and the rows of the others move up
+        model.append(QVector<MessageLevel::Enum>(3, MessageLevel::Info), { "miss", "hit 3", "miss" });
+        QCOMPARE(index.matchCount(), 2);
+        QCOMPARE(index.nextMatch(-1, false), 0);
+        QCOMPARE(index.nextMatch(0, false), 2);
+
+        model.clear();
+        QCOMPARE(index.matchCount(), 0);
+    }
+
+    void test_backgroundScan()
+    {
+        LogModel model;
+        model.setMaxLines(50000);
+        QStringList lines;
+        for (int i = 0; i < 20000; i++) {
+            lines << (i % 1000 == 0 ? QString("needle %1").arg(i) : QString("hay %1").arg(i));
+        }
+        model.append(QVector<MessageLevel::Enum>(lines.size(), MessageLevel::Info), lines);
+
+        LogSearchIndex index;
+        index.setModel(&model);
+        index.setQuery("Needle");
+        // lines that come in during the scan are looked at once it's done
+        model.append(MessageLevel::Info, "needle late");
+        QTRY_VERIFY(!index.isBuilding());
+        QCOMPARE(index.matchCount(), 21);
+        QCOMPARE(index.nextMatch(19999, false), 20000);
+    }
+};
+
+QTEST_GUILESS_MAIN(LogSearchIndexTest)
+
+#include "LogSearchIndex_test.moc"
@@ -0,0 +1,100 @@
+#include <QDir>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <GZip.h>
+#include <launch/LogSpool.h>
+
+class LogSpoolTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_ReadBack()
+    {
+        QTemporaryDir tmp;
+        auto dir = tmp.filePath("spool");
+        {
+            // small segments, to go over a few of them
+            LogSpool spool(dir, 256);
+            for (int i = 0; i < 200; i++)
+                spool.append(i % 10 == 0 ? MessageLevel::Error : MessageLevel::Message, QString("line %1 ünïcödé").arg(i));
+            spool.append({ MessageLevel::Warning, MessageLevel::Warning }, { "", "multi\nline" });
+
+            QCOMPARE(spool.lineCount(), 202);
+            auto folders = QDir(dir).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+            QCOMPARE(folders.size(), 1);
+            QVERIFY(QDir(dir).entryList(QDir::Files).isEmpty());
+            QVERIFY(QDir(dir + '/' + folders.first()).entryList({ "*.spool" }, QDir::Files).size() > 1);
+            QCOMPARE(spool.line(0), QString("line 0 ünïcödé"));
+            QCOMPARE(spool.line(123), QString("line 123 ünïcödé"));
+            QCOMPARE(spool.line(200), QString());
+            QCOMPARE(spool.line(201), QString("multi\nline"));
+            QCOMPARE(spool.level(201), MessageLevel::Warning);
+            QCOMPARE(spool.lines(198, 10), QStringList({ "line 198 ünïcödé", "line 199 ünïcödé", "", "multi\nline" }));
+        }
+        // the files go away with the spool
+        QVERIFY(QDir(dir).entryList(QDir::AllEntries | QDir::NoDotAndDotDot).isEmpty());
+    }
+
+    void test_Find()
+    {
+        QTemporaryDir tmp;
+        LogSpool spool(tmp.filePath("spool"), 256);
+        for (int i = 0; i < 100; i++)
+            spool.append(i % 10 == 0 ? MessageLevel::Error : MessageLevel::Message, QString("Line %1").arg(i));
+
+        QCOMPARE(spool.find("line 42", 0), 42);
+        QCOMPARE(spool.find("line 42", 0, false, LogSpool::AllLevels, Qt::CaseSensitive), -1);
+        QCOMPARE(spool.find("Line 42", 0, false, LogSpool::AllLevels, Qt::CaseSensitive), 42);
+        QCOMPARE(spool.find("Line 4", 50, true), 49);
+        QCOMPARE(spool.find("Line 4", 50, false), -1);
+        QCOMPARE(spool.find("Line", 11, false, LogSpool::levelBit(MessageLevel::Error)), 20);
+        QCOMPARE(spool.find("Line", 11, true, LogSpool::levelBit(MessageLevel::Error), Qt::CaseSensitive), 10);
+        QCOMPARE(spool.findLevel(LogSpool::levelBit(MessageLevel::Error), 91), -1);
+        QCOMPARE(spool.findLevel(LogSpool::levelBit(MessageLevel::Error), 1000, true), 90);
+    }
+
+    void test_Load()
+    {
+        QTemporaryDir tmp;
+        QByteArray contents("first\r\nsecond\n\nläst");
+        auto path = tmp.filePath("latest.log");
+        {
+            QFile file(path);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(contents);
+        }
+        QByteArray compressed;
+        QVERIFY(GZip::zip(contents, compressed));
+        auto gz_path = tmp.filePath("old.log.gz");
+        {
+            QFile file(gz_path);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(compressed);
+        }
+
+        for (auto& file : { path, gz_path }) {
+            LogSpool spool(tmp.filePath("spool"));
+            QVERIFY(spool.load(file));
+            QCOMPARE(spool.lineCount(), 4);
+            QCOMPARE(spool.lines(0, 4), QStringList({ "first", "second", "", "läst" }));
+            QCOMPARE(spool.level(0), MessageLevel::Unknown);
+            QCOMPARE(spool.find("LÄST", 0), 3);
+
+            // nothing can be added to a loaded log
+            spool.append(MessageLevel::Message, "more");
+            QCOMPARE(spool.lineCount(), 4);
+        }
+        // the loaded file stays, what was inflated goes away with the spool
+        QVERIFY(QFile::exists(path));
+        QVERIFY(QDir(tmp.filePath("spool")).entryList(QDir::AllEntries | QDir::NoDotAndDotDot).isEmpty());
+
+        LogSpool spool(tmp.filePath("spool"));
+        QVERIFY(!spool.load(tmp.filePath("missing.log")));
+        QCOMPARE(spool.lineCount(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(LogSpoolTest)
+
+#include "LogSpool_test.moc"
@@ -0,0 +1,68 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <modplatform/helpers/LookupMisses.h>
+
+class LookupMissesTest : public QObject {
+    Q_OBJECT
+
+    using Provider = ModPlatform::ResourceProvider;
+
+   private slots:
+    void test_Misses()
+    {
+        QTemporaryDir tmp;
+        qint64 now = 1000000;
+        LookupMisses misses(tmp.filePath("misses.json"), [&now] { return now; });
+
+        QVERIFY(!misses.contains(Provider::MODRINTH, "abc"));
+        misses.insert(Provider::MODRINTH, "abc");
+        QVERIFY(misses.contains(Provider::MODRINTH, "abc"));
+        // the providers don't share them
+        QVERIFY(!misses.contains(Provider::FLAME, "abc"));
+
+        misses.remove(Provider::MODRINTH, "abc");
+        QVERIFY(!misses.contains(Provider::MODRINTH, "abc"));
+    }
+
+    void test_Expiry()
+    {
+        QTemporaryDir tmp;
+        qint64 now = 1000000;
+        LookupMisses misses(tmp.filePath("misses.json"), [&now] { return now; });
+
+        misses.insert(Provider::FLAME, "12345");
+        now += 2 * 24 * 60 * 60;
+        QVERIFY(misses.contains(Provider::FLAME, "12345"));
+        now += 2 * 24 * 60 * 60;
+        QVERIFY(!misses.contains(Provider::FLAME, "12345"));
+    }
+
+    void test_Persistence()
+    {
+        QTemporaryDir tmp;
+        auto path = tmp.filePath("misses.json");
+        qint64 now = 1000000;
+        {
+            LookupMisses misses(path, [&now] { return now; });
+            misses.insert(Provider::MODRINTH, "abc");
+            misses.insert(Provider::FLAME, "12345");
+            misses.save();
+        }
+
+        now += 60;
+        LookupMisses misses(path, [&now] { return now; });
+        QVERIFY(misses.contains(Provider::MODRINTH, "abc"));
+        QVERIFY(misses.contains(Provider::FLAME, "12345"));
+        QVERIFY(!misses.contains(Provider::FLAME, "abc"));
+
+        // old ones aren't read back
+        now += 4 * 24 * 60 * 60;
+        LookupMisses later(path, [&now] { return now; });
+        QVERIFY(!later.contains(Provider::MODRINTH, "abc"));
+    }
+};
+
+QTEST_GUILESS_MAIN(LookupMissesTest)
+
+#include "LookupMisses_test.moc"
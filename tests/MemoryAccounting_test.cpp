@@ -0,0 +1,84 @@
+#include <QTest>
+
+#include <ImageCache.h>
+#include <MemoryAccounting.h>
+
+#include <memory>
+
+namespace {
+const MemoryAccounting::Subsystem* find(const QList<MemoryAccounting::Subsystem>& subsystems, const QString& name)
+{
+    for (auto& subsystem : subsystems) {
+        if (subsystem.name == name)
+            return &subsystem;
+    }
+    return nullptr;
+}
+}  // namespace
+
+class MemoryAccountingTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_Report()
+    {
+        auto a = std::make_unique<QObject>();
+        auto b = std::make_unique<QObject>();
+        MemoryAccounting::track(a.get(), "Test", [] { return MemoryAccounting::Usage{ 2, 100 }; });
+        MemoryAccounting::track(b.get(), "Test", [] { return MemoryAccounting::Usage{ 3, 1000 }; });
+
+        auto report = MemoryAccounting::report();
+        auto test = find(report, "Test");
+        QVERIFY(test);
+        QCOMPARE(test->objects, 2);
+        QCOMPARE(test->items, qint64(5));
+        QCOMPARE(test->bytes, qint64(1100));
+        QVERIFY(!test->trimmable);
+
+        // gone with their owner
+        a.reset();
+        report = MemoryAccounting::report();
+        test = find(report, "Test");
+        QVERIFY(test);
+        QCOMPARE(test->objects, 1);
+        QCOMPARE(test->bytes, qint64(1000));
+        b.reset();
+        QVERIFY(!find(MemoryAccounting::report(), "Test"));
+    }
+
+    void test_Trim()
+    {
+        ImageCache cache(1024 * 1024);
+        QImage image(64, 64, QImage::Format_ARGB32);
+        image.fill(Qt::red);
+        auto key = cache.insert(image);
+        QVERIFY(key != 0);
+        QCOMPARE(cache.count(), 1);
+        QCOMPARE(cache.size(), qint64(image.sizeInBytes()));
+
+        QObject owner;
+        MemoryAccounting::track(
+            &owner, "Test cache", [&cache] { return MemoryAccounting::Usage{ cache.count(), cache.size() }; }, [&cache] { cache.clear(); });
+        auto report = MemoryAccounting::report();
+        auto test = find(report, "Test cache");
+        QVERIFY(test);
+        QVERIFY(test->trimmable);
+
+        QVERIFY(MemoryAccounting::trim() >= image.sizeInBytes());
+        QCOMPARE(cache.count(), 0);
+        QVERIFY(!cache.find(key, nullptr));
+        QCOMPARE(find(MemoryAccounting::report(), "Test cache")->bytes, qint64(0));
+    }
+
+    void test_Resident()
+    {
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS) || defined(Q_OS_WIN)
+        QVERIFY(MemoryAccounting::residentBytes() > 0);
+#endif
+        QVERIFY(MemoryAccounting::summary().startsWith("Memory: "));
+    }
+};
+
+QTEST_GUILESS_MAIN(MemoryAccountingTest)
+
+#include "MemoryAccounting_test.moc"
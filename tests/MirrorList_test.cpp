@@ -0,0 +1,110 @@
+#include <QTest>
+
+#include <net/MirrorList.h>
+
+using Net::MirrorList;
+
+namespace {
+const QString s_official = "https://libraries.example.com/";
+const QString s_first = "https://first.example.org/maven/";
+const QString s_second = "https://second.example.org/";
+const QString s_path = "org/example/lib/1.0/lib-1.0.jar";
+}  // namespace
+
+class MirrorListTest : public QObject {
+    Q_OBJECT
+
+    qint64 m_now = 1000000;
+
+    MirrorList make()
+    {
+        MirrorList mirrors([this] { return m_now; });
+        mirrors.setMirrors(MirrorList::Kind::Libraries, s_official, { s_first, s_second, s_official });
+        return mirrors;
+    }
+
+    static QList<QUrl> urls(const QStringList& bases)
+    {
+        QList<QUrl> urls;
+        for (auto& base : bases)
+            urls.append(QUrl(base + s_path));
+        return urls;
+    }
+
+   private slots:
+    void test_Parse()
+    {
+        QCOMPARE(MirrorList::parse(" https://a.example.org/maven, http://b.example.org/\nftp://c.example.org/ garbage "),
+                 QStringList({ "https://a.example.org/maven/", "https://b.example.org/" }));
+        QCOMPARE(MirrorList::parse(""), QStringList());
+    }
+
+    void test_OnlyUnderTheOfficialBase()
+    {
+        auto mirrors = make();
+        QUrl other("https://maven.example.net/" + s_path);
+        QCOMPARE(mirrors.route(MirrorList::Kind::Libraries, other), QList<QUrl>({ other }));
+        // nothing is set up for those
+        QUrl asset(s_official + s_path);
+        QCOMPARE(mirrors.route(MirrorList::Kind::Assets, asset), QList<QUrl>({ asset }));
+    }
+
+    void test_UnmeasuredInOrder()
+    {
+        auto mirrors = make();
+        QCOMPARE(mirrors.mirrors(MirrorList::Kind::Libraries), QStringList({ s_first, s_second, s_official }));
+        QCOMPARE(mirrors.route(MirrorList::Kind::Libraries, QUrl(s_official + s_path)), urls({ s_first, s_second, s_official }));
+    }
+
+    void test_FastestFirst()
+    {
+        auto mirrors = make();
+        mirrors.reportSuccess(QUrl(s_first + s_path), 400, 1024 * 1024, 4400);
+        mirrors.reportSuccess(QUrl(s_second + "other.jar"), 50, 1024 * 1024, 550);
+        // not measured yet, so it goes first
+        QCOMPARE(mirrors.route(MirrorList::Kind::Libraries, QUrl(s_official + s_path)), urls({ s_official, s_second, s_first }));
+
+        mirrors.reportSuccess(QUrl(s_official + s_path), 100, 1024 * 1024, 2100);
+        QCOMPARE(mirrors.route(MirrorList::Kind::Libraries, QUrl(s_official + s_path)), urls({ s_second, s_official, s_first }));
+    }
+
+    void test_FailedLast()
+    {
+        auto mirrors = make();
+        QUrl first(s_first + s_path);
+        mirrors.reportFailure(first);
+        QVERIFY(!mirrors.isHealthy(first));
+        QCOMPARE(mirrors.route(MirrorList::Kind::Libraries, QUrl(s_official + s_path)), urls({ s_second, s_official, s_first }));
+
+        // the backoff grows with the failures in a row
+        m_now += 5 * 1000;
+        QVERIFY(mirrors.isHealthy(first));
+        mirrors.reportFailure(first);
+        m_now += 5 * 1000;
+        QVERIFY(!mirrors.isHealthy(first));
+        m_now += 5 * 1000;
+        QVERIFY(mirrors.isHealthy(first));
+
+        // and starts over once it works again
+        mirrors.reportSuccess(first, 50, 1024, 60);
+        mirrors.reportFailure(first);
+        m_now += 5 * 1000;
+        QVERIFY(mirrors.isHealthy(first));
+    }
+
+    void test_AllFailed()
+    {
+        auto mirrors = make();
+        mirrors.reportFailure(QUrl(s_official + s_path));
+        m_now += 1000;
+        mirrors.reportFailure(QUrl(s_second + s_path));
+        m_now += 1000;
+        mirrors.reportFailure(QUrl(s_first + s_path));
+        // still all of them, the one that comes back first first
+        QCOMPARE(mirrors.route(MirrorList::Kind::Libraries, QUrl(s_official + s_path)), urls({ s_official, s_second, s_first }));
+    }
+};
+
+QTEST_GUILESS_MAIN(MirrorListTest)
+
+#include "MirrorList_test.moc"
@@ -0,0 +1,75 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <minecraft/mod/ModDetailsCache.h>
+
+class ModDetailsCacheTest : public QObject {
+    Q_OBJECT
+
+    static void writeFile(const QString& path, const QByteArray& data)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    }
+
+   private slots:
+    void test_SaveLoad()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto cache_file = FS::PathCombine(tmp.path(), "moddetails");
+        auto mod_path = FS::PathCombine(tmp.path(), "mod.jar");
+        auto broken_path = FS::PathCombine(tmp.path(), "broken.jar");
+        writeFile(mod_path, "not really a jar");
+        writeFile(broken_path, "not a jar either");
+
+        ModDetails details;
+        details.mod_id = "examplemod";
+        details.name = "Example";
+        details.version = "1.0";
+        details.authors = QStringList{ "Alice", "Bob" };
+        details.icon_path = "assets/examplemod/icon.png";
+
+        {
+            ModDetailsCache cache(cache_file);
+            QVERIFY(!cache.find(QFileInfo(mod_path)).has_value());
+            cache.insert(QFileInfo(mod_path), true, details);
+            cache.insert(QFileInfo(broken_path), false, {});
+        }
+
+        ModDetailsCache cache(cache_file);
+        auto found = cache.find(QFileInfo(mod_path));
+        QVERIFY(found.has_value());
+        QVERIFY(found->valid);
+        QCOMPARE(found->details.mod_id, details.mod_id);
+        QCOMPARE(found->details.name, details.name);
+        QCOMPARE(found->details.version, details.version);
+        QCOMPARE(found->details.authors, details.authors);
+        QCOMPARE(found->details.icon_path, details.icon_path);
+
+        auto broken = cache.find(QFileInfo(broken_path));
+        QVERIFY(broken.has_value());
+        QVERIFY(!broken->valid);
+    }
+
+    void test_ChangedFile()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto mod_path = FS::PathCombine(tmp.path(), "mod.jar");
+        writeFile(mod_path, "first version");
+
+        ModDetailsCache cache(FS::PathCombine(tmp.path(), "moddetails"));
+        cache.insert(QFileInfo(mod_path), true, {});
+        QVERIFY(cache.find(QFileInfo(mod_path)).has_value());
+
+        writeFile(mod_path, "a newer, longer version");
+        QVERIFY(!cache.find(QFileInfo(mod_path)).has_value());
+    }
+};
+
+QTEST_GUILESS_MAIN(ModDetailsCacheTest)
+
+#include "ModDetailsCache_test.moc"
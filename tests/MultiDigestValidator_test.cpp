@@ -0,0 +1,79 @@
+#include <QCryptographicHash>
+#include <QNetworkReply>
+#include <QTest>
+
+#include <MurmurHash2.h>
+#include <net/MultiDigestValidator.h>
+
+// validators don't look at the reply, but they're given one
+class NullReply : public QNetworkReply {
+   public:
+    void abort() override {}
+
+   protected:
+    qint64 readData(char*, qint64) override { return -1; }
+};
+
+class MultiDigestValidatorTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray data()
+    {
+        QByteArray data;
+        for (int i = 0; i < 100000; i++)
+            data.append(static_cast<char>(i * 7 % 251));
+        return data;
+    }
+
+    // the validators get the data in the chunks it came in
+    static bool feed(Net::MultiDigestValidator& validator, const QByteArray& data)
+    {
+        QNetworkRequest request;
+        if (!validator.init(request))
+            return false;
+        for (int i = 0; i < data.size(); i += 4096) {
+            auto chunk = data.mid(i, 4096);
+            if (!validator.write(chunk))
+                return false;
+        }
+        NullReply reply;
+        return validator.validate(reply);
+    }
+
+   private slots:
+    void test_AllHashes()
+    {
+        auto hashes = std::make_shared<Hashing::FileHashes>();
+        Net::MultiDigestValidator validator(hashes);
+        auto contents = data();
+        QVERIFY(feed(validator, contents));
+
+        QCOMPARE(hashes->md5, QString(QCryptographicHash::hash(contents, QCryptographicHash::Md5).toHex()));
+        QCOMPARE(hashes->sha1, QString(QCryptographicHash::hash(contents, QCryptographicHash::Sha1).toHex()));
+        QCOMPARE(hashes->sha512, QString(QCryptographicHash::hash(contents, QCryptographicHash::Sha512).toHex()));
+        QCOMPARE(hashes->murmur2, QString::number(CurseForgeFingerprint(contents.constData(), contents.size())));
+        QVERIFY(hashes->isComplete());
+    }
+
+    void test_Expected()
+    {
+        auto contents = data();
+        auto hashes = std::make_shared<Hashing::FileHashes>();
+
+        Net::MultiDigestValidator good(hashes, QCryptographicHash::Sha512, QCryptographicHash::hash(contents, QCryptographicHash::Sha512));
+        QVERIFY(feed(good, contents));
+
+        // one it doesn't compute anyway
+        Net::MultiDigestValidator other(hashes, QCryptographicHash::Sha256, QCryptographicHash::hash(contents, QCryptographicHash::Sha256));
+        QVERIFY(feed(other, contents));
+
+        Net::MultiDigestValidator bad(hashes, QCryptographicHash::Sha1, QCryptographicHash::hash("something else", QCryptographicHash::Sha1));
+        QVERIFY(!feed(bad, contents));
+        // nothing to keep from a bad download
+        QVERIFY(!hashes->isValid());
+    }
+};
+
+QTEST_GUILESS_MAIN(MultiDigestValidatorTest)
+
+#include "MultiDigestValidator_test.moc"
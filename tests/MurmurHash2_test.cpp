@@ -0,0 +1,90 @@
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <MurmurHash2.h>
+
+class MurmurHash2Test : public QObject {
+    Q_OBJECT
+
+    // The original, byte by byte, implementation, which everything else has to agree with
+    static uint32_t reference(const QByteArray& data)
+    {
+        return MurmurHash2(data.constData(), data.size(), [](char c) { return c == 9 || c == 10 || c == 13 || c == 32; });
+    }
+
+    // Random data, with `whitespace_percent` percent of the bytes being whitespace
+    static QByteArray randomData(int size, int whitespace_percent, quint32 seed)
+    {
+        static const char whitespace[] = { 9, 10, 13, 32 };
+
+        QRandomGenerator rng(seed);
+        QByteArray data(size, Qt::Uninitialized);
+        for (auto& c : data) {
+            if (static_cast<int>(rng.bounded(100)) < whitespace_percent)
+                c = whitespace[rng.bounded(4)];
+            else
+                c = static_cast<char>(rng.bounded(256));
+        }
+        return data;
+    }
+
+   private slots:
+    void test_Fingerprint_data()
+    {
+        QTest::addColumn<QByteArray>("data");
+
+        QTest::newRow("empty") << QByteArray();
+        QTest::newRow("only whitespace") << QByteArray(" \t\r\n \t\r\n \t\r\n \t\r\n \t\r\n");
+        QTest::newRow("text") << QByteArray("{\n    \"modid\": \"examplemod\",\n    \"version\": \"1.0\"\r\n}\n");
+
+        // exercise every tail length and the edges of the vector blocks
+        for (int size : { 1, 2, 3, 4, 5, 15, 16, 17, 31, 32, 33, 63, 64, 65, 255, 4096, 4099 }) {
+            for (int whitespace : { 0, 3, 50 }) {
+                auto name = QString("random %1 bytes, %2% whitespace").arg(size).arg(whitespace);
+                QTest::newRow(qPrintable(name)) << randomData(size, whitespace, size * 100 + whitespace);
+            }
+        }
+
+        // bigger than the chunks the data is compacted in
+        QTest::newRow("random 1 MiB") << randomData(1024 * 1024 + 3, 3, 1);
+        QTest::newRow("random 1 MiB, lots of whitespace") << randomData(1024 * 1024 + 1, 60, 2);
+    }
+    void test_Fingerprint()
+    {
+        QFETCH(QByteArray, data);
+
+        auto expected = reference(data);
+        QCOMPARE(CurseForgeFingerprintScalar(data.constData(), data.size()), expected);
+        QCOMPARE(CurseForgeFingerprint(data.constData(), data.size()), expected);
+    }
+
+    void test_KnownValue()
+    {
+        // the whitespace must not change anything
+        QCOMPARE(CurseForgeFingerprint("hello world\n", 12), CurseForgeFingerprint("helloworld", 10));
+        QCOMPARE(CurseForgeFingerprint("helloworld", 10), reference("helloworld"));
+    }
+
+    void benchmark_Scalar()
+    {
+        auto data = randomData(4 * 1024 * 1024, 3, 3);
+        QBENCHMARK
+        {
+            CurseForgeFingerprintScalar(data.constData(), data.size());
+        }
+    }
+
+    void benchmark_Vectorized()
+    {
+        qDebug() << "Using" << CurseForgeFingerprintImplementation();
+        auto data = randomData(4 * 1024 * 1024, 3, 3);
+        QBENCHMARK
+        {
+            CurseForgeFingerprint(data.constData(), data.size());
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(MurmurHash2Test)
+
+#include "MurmurHash2_test.moc"
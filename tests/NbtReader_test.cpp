@@ -0,0 +1,166 @@
+#include <QTest>
+
+#include <QBuffer>
+#include <QDataStream>
+
+#include <GZip.h>
+#include <minecraft/NbtReader.h>
+
+// writes NBT by hand, so the reader is checked against the format and not against another reader
+class NbtWriter {
+   public:
+    NbtWriter() : m_stream(&m_data, QIODevice::WriteOnly) { m_stream.setByteOrder(QDataStream::BigEndian); }
+
+    NbtWriter& begin(const QByteArray& name) { return tag(10, name); }
+    NbtWriter& end()
+    {
+        m_stream << quint8(0);
+        return *this;
+    }
+    NbtWriter& string(const QByteArray& name, const QByteArray& value)
+    {
+        tag(8, name);
+        writeString(value);
+        return *this;
+    }
+    NbtWriter& integer(const QByteArray& name, qint32 value)
+    {
+        tag(3, name);
+        m_stream << value;
+        return *this;
+    }
+    NbtWriter& longInteger(const QByteArray& name, qint64 value)
+    {
+        tag(4, name);
+        m_stream << value;
+        return *this;
+    }
+    NbtWriter& longArray(const QByteArray& name, int length)
+    {
+        tag(12, name);
+        m_stream << qint32(length);
+        for (int i = 0; i < length; i++)
+            m_stream << qint64(i);
+        return *this;
+    }
+    NbtWriter& compoundList(const QByteArray& name, int length)
+    {
+        tag(9, name);
+        m_stream << quint8(10) << qint32(length);
+        for (int i = 0; i < length; i++) {
+            integer("x", i);
+            string("y", "z");
+            end();
+        }
+        return *this;
+    }
+
+    QByteArray data() const { return m_data; }
+
+   private:
+    NbtWriter& tag(quint8 type, const QByteArray& name)
+    {
+        m_stream << type;
+        writeString(name);
+        return *this;
+    }
+    void writeString(const QByteArray& value)
+    {
+        m_stream << quint16(value.size());
+        m_stream.writeRawData(value.constData(), value.size());
+    }
+
+    QByteArray m_data;
+    QDataStream m_stream;
+};
+
+class NbtReaderTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray levelDat()
+    {
+        return NbtWriter()
+            .begin("")
+            .begin("Data")
+            .compoundList("Players", 100)
+            .longArray("Heightmap", 5000)
+            .string("LevelName", "A world")
+            .begin("WorldGenSettings")
+            .longInteger("seed", -1234567890123LL)
+            .end()
+            .longInteger("LastPlayed", 1700000000000LL)
+            .integer("GameType", 1)
+            .string("Trailing", "never needed")
+            .end()
+            .end()
+            .data();
+    }
+
+   private slots:
+    void test_fields()
+    {
+        auto data = levelDat();
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        NbtReader reader(&buffer);
+        QVERIFY(reader.read({ "Data", "Data/LevelName", "Data/LastPlayed", "Data/GameType", "Data/WorldGenSettings/seed", "Data/Missing" }));
+        QCOMPARE(reader.rootName(), QString());
+
+        QCOMPARE(reader.field("Data")->type, NbtReader::TagType::Compound);
+        QCOMPARE(reader.field("Data/LevelName")->type, NbtReader::TagType::String);
+        QCOMPARE(reader.field("Data/LevelName")->value.toString(), QString("A world"));
+        QCOMPARE(reader.field("Data/LastPlayed")->value.toLongLong(), 1700000000000LL);
+        QCOMPARE(reader.field("Data/GameType")->type, NbtReader::TagType::Int);
+        QCOMPARE(reader.field("Data/GameType")->value.toInt(), 1);
+        QCOMPARE(reader.field("Data/WorldGenSettings/seed")->value.toLongLong(), -1234567890123LL);
+        QVERIFY(!reader.field("Data/Missing"));
+        // skipped, not kept
+        QVERIFY(!reader.field("Data/Players"));
+        QVERIFY(!reader.field("Data/Trailing"));
+    }
+
+    void test_stopsEarly()
+    {
+        // everything after the last wanted field can be garbage, it is never read
+        auto data = levelDat();
+        data.truncate(data.indexOf("Trailing") + 4);
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        NbtReader reader(&buffer);
+        QVERIFY(reader.read({ "Data/LevelName", "Data/GameType" }));
+        QCOMPARE(reader.field("Data/GameType")->value.toInt(), 1);
+    }
+
+    void test_broken()
+    {
+        auto data = levelDat();
+        data.truncate(data.indexOf("LevelName") - 1);
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        NbtReader reader(&buffer);
+        QVERIFY(!reader.read({ "Data/LevelName" }));
+        QVERIFY(!reader.errorString().isEmpty());
+
+        QByteArray notNbt("\x08\x00\x01xyz", 7);
+        QBuffer other(&notNbt);
+        other.open(QIODevice::ReadOnly);
+        NbtReader otherReader(&other);
+        QVERIFY(!otherReader.read({ "Data" }));
+    }
+
+    void test_gzipped()
+    {
+        QByteArray compressed;
+        QVERIFY(GZip::zip(levelDat(), compressed));
+        GZipReader device(compressed);
+        QVERIFY(device.open(QIODevice::ReadOnly));
+        NbtReader reader(&device);
+        QVERIFY(reader.read({ "Data/LevelName", "Data/LastPlayed" }));
+        QCOMPARE(reader.field("Data/LevelName")->value.toString(), QString("A world"));
+        QCOMPARE(reader.field("Data/LastPlayed")->value.toLongLong(), 1700000000000LL);
+    }
+};
+
+QTEST_GUILESS_MAIN(NbtReaderTest)
+
+#include "NbtReader_test.moc"
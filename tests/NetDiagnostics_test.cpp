@@ -0,0 +1,100 @@
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QTest>
+
+#include <net/Diagnostics.h>
+
+using Net::Diagnostics;
+
+class NetDiagnosticsTest : public QObject {
+    Q_OBJECT
+
+    static Diagnostics::Request request(const QString& url, const QString& job)
+    {
+        Diagnostics::Request request;
+        request.url = url;
+        request.job = job;
+        request.started = QDateTime::fromMSecsSinceEpoch(1700000000000, Qt::UTC);
+        request.queued = 5;
+        request.connect = 40;
+        request.send = 1;
+        request.wait = 100;
+        request.receive = 500;
+        request.status = 200;
+        request.bytes = 1000000;
+        request.cache = Diagnostics::CacheOutcome::Miss;
+        request.headers = { { "Content-Type", "application/java-archive" } };
+        return request;
+    }
+
+   private slots:
+    void test_Hosts()
+    {
+        Diagnostics diagnostics;
+        diagnostics.record(request("https://cdn.example.com/a.jar?x=1", "Mods"));
+        auto retried = request("https://cdn.example.com/b.jar", "Mods");
+        retried.attempt = 2;
+        retried.error = "Connection closed";
+        diagnostics.record(retried);
+        auto hit = request("https://meta.example.com/index.json", "Meta");
+        hit.cache = Diagnostics::CacheOutcome::Hit;
+        hit.bytes = 0;
+        hit.receive = -1;
+        diagnostics.record(hit);
+
+        auto hosts = diagnostics.hosts();
+        QCOMPARE(hosts.size(), 2);
+        auto cdn = hosts.value("cdn.example.com");
+        QCOMPARE(cdn.requests, 2);
+        QCOMPARE(cdn.retries, 1);
+        QCOMPARE(cdn.failed, 1);
+        QCOMPARE(cdn.bytes, qint64(2000000));
+        QCOMPARE(cdn.throughput(), 2000000.0);
+        QCOMPARE(hosts.value("meta.example.com").hits, 1);
+        QCOMPARE(hosts.value("meta.example.com").throughput(), 0.0);
+
+        QCOMPARE(diagnostics.jobs(), (QStringList{ "Mods", "Meta" }));
+        QCOMPARE(diagnostics.requests("Mods").size(), 2);
+        QCOMPARE(diagnostics.requests().size(), 3);
+        // in the order they came
+        QVERIFY(diagnostics.requests().first().id < diagnostics.requests().last().id);
+
+        diagnostics.clear();
+        QVERIFY(diagnostics.requests().isEmpty());
+        QVERIFY(diagnostics.hosts().isEmpty());
+    }
+
+    void test_Har()
+    {
+        auto with_error = request("https://cdn.example.com/a.jar?x=1", "Mods");
+        with_error.error = "Connection closed";
+        auto har = Diagnostics::toHar({ request("https://cdn.example.com/a.jar?x=1", "Mods"), with_error }).object();
+
+        auto log = har.value("log").toObject();
+        QCOMPARE(log.value("version").toString(), QString("1.2"));
+        auto entries = log.value("entries").toArray();
+        QCOMPARE(entries.size(), 2);
+
+        auto entry = entries.first().toObject();
+        QCOMPARE(entry.value("startedDateTime").toString(), QString("2023-11-14T22:13:20.000Z"));
+        QCOMPARE(entry.value("time").toInt(), 646);
+        QCOMPARE(entry.value("request").toObject().value("queryString").toArray().first().toObject().value("name").toString(), QString("x"));
+        auto response = entry.value("response").toObject();
+        QCOMPARE(response.value("status").toInt(), 200);
+        QCOMPARE(response.value("content").toObject().value("size").toInt(), 1000000);
+        QCOMPARE(response.value("headers").toArray().size(), 1);
+        auto timings = entry.value("timings").toObject();
+        QCOMPARE(timings.value("blocked").toInt(), 5);
+        QCOMPARE(timings.value("dns").toInt(), -1);
+        QCOMPARE(timings.value("connect").toInt(), 40);
+        QCOMPARE(timings.value("wait").toInt(), 100);
+        QCOMPARE(timings.value("receive").toInt(), 500);
+        QCOMPARE(entry.value("_cache").toString(), QString("miss"));
+        QVERIFY(!entry.contains("_error"));
+        QCOMPARE(entries.last().toObject().value("_error").toString(), QString("Connection closed"));
+    }
+};
+
+QTEST_GUILESS_MAIN(NetDiagnosticsTest)
+
+#include "NetDiagnostics_test.moc"
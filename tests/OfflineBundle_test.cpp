@@ -0,0 +1,46 @@
+#include <QTest>
+
+#include <OfflineBundle.h>
+
+class OfflineBundleTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_CacheBases()
+    {
+        QCOMPARE(OfflineBundle::cacheBase("libraries/org/lwjgl/lwjgl/3.3.1/lwjgl-3.3.1.jar"), QString("libraries"));
+        QCOMPARE(OfflineBundle::cachePath("libraries/org/lwjgl/lwjgl/3.3.1/lwjgl-3.3.1.jar"), QString("org/lwjgl/lwjgl/3.3.1/lwjgl-3.3.1.jar"));
+        QCOMPARE(OfflineBundle::cacheBase("assets/indexes/5.json"), QString("asset_indexes"));
+        QCOMPARE(OfflineBundle::cachePath("assets/indexes/5.json"), QString("5.json"));
+        QCOMPARE(OfflineBundle::cacheBase("assets/objects/ab/abcdef"), QString("asset_objects"));
+        QCOMPARE(OfflineBundle::cachePath("assets/objects/ab/abcdef"), QString("ab/abcdef"));
+        QCOMPARE(OfflineBundle::cacheBase("meta/net.minecraft/1.20.1.json"), QString("meta"));
+        // the cache doesn't know about those
+        QCOMPARE(OfflineBundle::cacheBase("java/runtimes/java-runtime-gamma/bin/java"), QString());
+        QCOMPARE(OfflineBundle::cacheBase("instances/abc/instance.cfg"), QString());
+    }
+
+    void test_Importable()
+    {
+        QVERIFY(OfflineBundle::isImportable("libraries/org/lwjgl/lwjgl/3.3.1/lwjgl-3.3.1.jar"));
+        QVERIFY(OfflineBundle::isImportable("assets/objects/ab/abcdef"));
+        QVERIFY(OfflineBundle::isImportable("meta/index.json"));
+        QVERIFY(OfflineBundle::isImportable("java/runtimes/java-runtime-gamma/bin/java"));
+        QVERIFY(OfflineBundle::isImportable("instances/abc/instance.cfg"));
+
+        QVERIFY(!OfflineBundle::isImportable(""));
+        QVERIFY(!OfflineBundle::isImportable("instances/abc"));
+        QVERIFY(!OfflineBundle::isImportable("instances//instance.cfg"));
+        QVERIFY(!OfflineBundle::isImportable("launcher.cfg"));
+        QVERIFY(!OfflineBundle::isImportable("accounts.json"));
+        QVERIFY(!OfflineBundle::isImportable("/etc/passwd"));
+        QVERIFY(!OfflineBundle::isImportable("libraries/../accounts.json"));
+        QVERIFY(!OfflineBundle::isImportable("instances/abc/../../accounts.json"));
+        QVERIFY(!OfflineBundle::isImportable("meta\\..\\accounts.json"));
+        QVERIFY(!OfflineBundle::isImportable("libraries/C:/Windows/evil.dll"));
+    }
+};
+
+QTEST_GUILESS_MAIN(OfflineBundleTest)
+
+#include "OfflineBundle_test.moc"
@@ -19,6 +19,7 @@ private slots:
     void test_parse();
     void test_parse_file();
     void test_inspect();
+    void test_inspect_index();
 #ifndef Q_OS_WIN32
     void test_inspect_symlinks();
 #endif
@@ -110,6 +111,25 @@ void PackageManifestTest::test_inspect() {
     QVERIFY(manifest.symlinks.size() == 0);
 }
 
+void PackageManifestTest::test_inspect_index() {
+    auto path = QFINDTESTDATA("testdata/PackageManifest/inspect_win/");
+    HashIndex index;
+    auto manifest = Package::fromInspectedFolder(path, &index);
+    QVERIFY(manifest.valid == true);
+    QVERIFY(index.entries.size() == 2);
+    QVERIFY(index.entries[Path("a/b.txt")].hash == "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+
+    // unchanged files aren't read again, whatever the index says is taken as is
+    index.entries[Path("a/b.txt")].hash = "not a hash";
+    index.entries[Path("a/missing.txt")] = { 0, 0, "da39a3ee5e6b4b0d3255bfef95601890afd80709" };
+    auto again = Package::fromInspectedFolder(path, &index);
+    QVERIFY(again.valid == true);
+    QVERIFY(again.files[Path("a/b.txt")].hash == "not a hash");
+    QVERIFY(again.files[Path("a/b/b.txt")].hash == "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    QVERIFY(index.entries.size() == 2);
+    QVERIFY(!index.entries.count(Path("a/missing.txt")));
+}
+
 #ifndef Q_OS_WIN32
 void PackageManifestTest::test_inspect_symlinks() {
     auto path = QFINDTESTDATA("testdata/PackageManifest/inspect/");
@@ -20,7 +20,10 @@
 #include <QTemporaryDir>
 #include <QTest>
 
+#include <FileSystem.h>
 #include <modplatform/packwiz/Packwiz.h>
+#include <modplatform/packwiz/PackwizIndexCache.h>
+#include <modplatform/packwiz/PackwizSync.h>
 
 class PackwizTest : public QObject {
     Q_OBJECT
@@ -80,6 +83,143 @@ class PackwizTest : public QObject {
         QCOMPARE(metadata.file_id, 3509043);
         QCOMPARE(metadata.project_id, 327154);
     }
+
+    void loadById()
+    {
+        QString source = QFINDTESTDATA("testdata/Packwiz");
+
+        QDir index_dir(source);
+        QVariant mod_id("kYq5qkSL");
+        auto metadata = Packwiz::V1::getIndexForMod(index_dir, mod_id);
+
+        QVERIFY(metadata.isValid());
+        QCOMPARE(metadata.name, "Borderless Mining");
+
+        QVariant missing("nothere");
+        QVERIFY(!Packwiz::V1::getIndexForMod(index_dir, missing).isValid());
+    }
+
+    void loadIgnoringCase()
+    {
+        QString source = QFINDTESTDATA("testdata/Packwiz");
+
+        QDir index_dir(source);
+        auto metadata = Packwiz::V1::getIndexForMod(index_dir, "Borderless-Mining");
+
+        QVERIFY(metadata.isValid());
+        QCOMPARE(metadata.filename, "borderless-mining-1.1.1+1.18.jar");
+    }
+
+    void indexCache()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto cache_file = FS::PathCombine(tmp.path(), "packwizindex");
+        auto path = FS::PathCombine(tmp.path(), "mod.pw.toml");
+        QVERIFY(QFile::copy(QFINDTESTDATA("testdata/Packwiz/borderless-mining.pw.toml"), path));
+
+        int parsed = 0;
+        auto parse = [&parsed] {
+            parsed++;
+            Packwiz::V1::Mod mod;
+            mod.slug = "mod";
+            mod.name = "Mod";
+            mod.project_id = "abc";
+            return mod;
+        };
+
+        {
+            Packwiz::IndexCache cache(cache_file);
+            QCOMPARE(cache.get(QFileInfo(path), parse).name, "Mod");
+            QCOMPARE(cache.get(QFileInfo(path), parse).name, "Mod");
+            QCOMPARE(parsed, 1);
+            QCOMPARE(cache.findName(QDir(tmp.path()), "MOD.pw.toml"), "mod.pw.toml");
+        }
+
+        // it's remembered across launches, until the file changes
+        Packwiz::IndexCache cache(cache_file);
+        QCOMPARE(cache.get(QFileInfo(path), parse).project_id, "abc");
+        QCOMPARE(parsed, 1);
+
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::Append));
+        file.write("\n");
+        file.close();
+        cache.get(QFileInfo(path), parse);
+        QCOMPARE(parsed, 2);
+    }
+
+    void syncParse()
+    {
+        using Packwiz::SyncTask;
+        QString error;
+
+        auto pack = SyncTask::parsePack(R"(
+name = "Pack"
+pack-format = "packwiz:1.1.0"
+
+[index]
+file = "index.toml"
+hash-format = "sha256"
+hash = "0123abcd"
+)",
+                                        QUrl("https://example.com/pack/pack.toml"), &error);
+        QVERIFY2(pack.isValid(), qPrintable(error));
+        QCOMPARE(pack.index_url, QUrl("https://example.com/pack/index.toml"));
+        QCOMPARE(pack.hash_format, "sha256");
+
+        QString hash_format;
+        auto entries = SyncTask::parseIndex(R"(
+hash-format = "sha256"
+
+[[files]]
+file = "config/options.txt"
+hash = "aa"
+preserve = true
+
+[[files]]
+file = "mods/borderless-mining.pw.toml"
+hash = "bb"
+metafile = true
+)",
+                                            &hash_format, &error);
+        QCOMPARE(hash_format, "sha256");
+        QCOMPARE(entries.size(), 2);
+        QVERIFY(entries[0].preserve && !entries[0].metafile);
+        QVERIFY(entries[1].metafile);
+
+        QFile metafile(QFINDTESTDATA("testdata/Packwiz/borderless-mining.pw.toml"));
+        QVERIFY(metafile.open(QFile::ReadOnly));
+        auto file = SyncTask::parseMetafile(metafile.readAll(), "mods/borderless-mining.pw.toml", &error);
+        QVERIFY2(error.isEmpty(), qPrintable(error));
+        QCOMPARE(file.path, "mods/borderless-mining-1.1.1+1.18.jar");
+        QCOMPARE(file.hash_format, "sha512");
+        QVERIFY(file.url.isValid());
+
+        // nothing to download for the client
+        auto server = SyncTask::parseMetafile("filename = \"a.jar\"\nside = \"server\"\n", "mods/a.pw.toml", &error);
+        QVERIFY(server.path.isEmpty());
+
+        error.clear();
+        SyncTask::parsePack("[index]\nfile = \"index.toml\"\nhash-format = \"crc32\"\nhash = \"00\"\n", QUrl(), &error);
+        QVERIFY(!error.isEmpty());
+    }
+
+    void syncTargetPath()
+    {
+        using Packwiz::SyncTask;
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto root = QDir::cleanPath(tmp.path());
+
+        QCOMPARE(SyncTask::targetPath(root, "mods/a.jar"), root + "/mods/a.jar");
+        QCOMPARE(SyncTask::targetPath(root, "config/../mods/a.jar"), root + "/mods/a.jar");
+        // a pack can't write outside of the game folder
+        QVERIFY(SyncTask::targetPath(root, "../a.jar").isEmpty());
+        QVERIFY(SyncTask::targetPath(root, "mods/../../a.jar").isEmpty());
+        QVERIFY(SyncTask::targetPath(root, "/etc/a.jar").isEmpty());
+        QVERIFY(SyncTask::targetPath(root, "").isEmpty());
+    }
 };
 
 QTEST_GUILESS_MAIN(PackwizTest)
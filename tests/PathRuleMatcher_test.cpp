@@ -0,0 +1,66 @@
+#include <QTest>
+
+#include <pathmatcher/PathRuleMatcher.h>
+
+class PathRuleMatcherTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_Paths()
+    {
+        PathRuleMatcher matcher;
+        matcher.addPath(".minecraft/saves").addPath("instance.cfg");
+
+        QVERIFY(matcher.matches("instance.cfg"));
+        QVERIFY(matcher.matches(".minecraft/saves"));
+        QVERIFY(matcher.matches(".minecraft/saves/world/level.dat"));
+        QVERIFY(!matcher.matches(".minecraft/saves_old/level.dat"));
+        QVERIFY(!matcher.matches(".minecraft/mods/instance.cfg"));
+        QVERIFY(!matcher.matches(".minecraft"));
+
+        QVERIFY(matcher.matchesFolder(".minecraft/saves/world"));
+        QVERIFY(!matcher.matchesFolder(".minecraft"));
+    }
+
+    void test_NamesAndGlobs()
+    {
+        PathRuleMatcher matcher;
+        matcher.addName(".DS_Store").addGlob("*.log").addGlob("crash-*.txt");
+
+        QVERIFY(matcher.matches("mods/.DS_Store"));
+        QVERIFY(matcher.matches(".DS_Store/anything"));
+        QVERIFY(matcher.matches("logs/latest.log"));
+        QVERIFY(matcher.matches("crash-reports/crash-2023-01-01.txt"));
+        QVERIFY(!matcher.matches("logs/latest.log.gz"));
+        QVERIFY(!matcher.matches("crash-reports/notes.txt"));
+
+        // a glob says nothing about what's in a folder
+        QVERIFY(!matcher.matchesFolder("logs.log"));
+    }
+
+    void test_CaseInsensitive()
+    {
+        PathRuleMatcher matcher;
+        matcher.caseSensitive(false).addPath("minecraft/Saves");
+
+        QVERIFY(matcher.matches("Minecraft/saves/world"));
+        QVERIFY(!matcher.matches("minecraft/mods"));
+    }
+
+    void test_FromTree()
+    {
+        SeparatorPrefixTree<'/'> tree;
+        tree.insert("mods/a.jar");
+        tree.insert("config");
+
+        PathRuleMatcher matcher(tree);
+        QCOMPARE(matcher.matches("mods/a.jar"), tree.covers("mods/a.jar"));
+        QCOMPARE(matcher.matches("mods/b.jar"), tree.covers("mods/b.jar"));
+        QCOMPARE(matcher.matches("config/x/y.toml"), tree.covers("config/x/y.toml"));
+        QCOMPARE(matcher.matches("mods"), tree.covers("mods"));
+    }
+};
+
+QTEST_GUILESS_MAIN(PathRuleMatcherTest)
+
+#include "PathRuleMatcher_test.moc"
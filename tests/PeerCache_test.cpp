@@ -0,0 +1,98 @@
+#include <QTest>
+
+#include <memory>
+
+#include <net/PeerCache.h>
+
+using Net::PeerCache;
+
+namespace {
+const QByteArray s_hash = QByteArray::fromHex("0123456789abcdef0123456789abcdef01234567");
+}  // namespace
+
+class PeerCacheTest : public QObject {
+    Q_OBJECT
+
+    qint64 m_now = 1000000;
+
+    std::unique_ptr<PeerCache> make()
+    {
+        auto cache = std::make_unique<PeerCache>([this] { return m_now; });
+        cache->notePeer("a", QHostAddress("192.168.1.10"), 4000);
+        cache->notePeer("b", QHostAddress("192.168.1.11"), 4000);
+        cache->notePeer("c", QHostAddress("10.0.0.5"), 4001);
+        cache->notePeer("d", QHostAddress("172.16.3.4"), 4002);
+        return cache;
+    }
+
+   private slots:
+    void test_PrivateAddresses()
+    {
+        QVERIFY(PeerCache::isPrivateAddress(QHostAddress("127.0.0.1")));
+        QVERIFY(PeerCache::isPrivateAddress(QHostAddress("10.1.2.3")));
+        QVERIFY(PeerCache::isPrivateAddress(QHostAddress("172.31.255.1")));
+        QVERIFY(PeerCache::isPrivateAddress(QHostAddress("192.168.0.1")));
+        QVERIFY(PeerCache::isPrivateAddress(QHostAddress("fe80::1")));
+        QVERIFY(!PeerCache::isPrivateAddress(QHostAddress("172.32.0.1")));
+        QVERIFY(!PeerCache::isPrivateAddress(QHostAddress("8.8.8.8")));
+        QVERIFY(!PeerCache::isPrivateAddress(QHostAddress("2001:db8::1")));
+    }
+
+    void test_PublicPeersIgnored()
+    {
+        PeerCache cache([this] { return m_now; });
+        cache.notePeer("a", QHostAddress("8.8.8.8"), 4000);
+        cache.notePeer("b", QHostAddress("192.168.1.10"), 0);
+        QCOMPARE(cache.peerCount(), 0);
+        QVERIFY(cache.routes(QCryptographicHash::Sha1, s_hash).isEmpty());
+    }
+
+    void test_Routes()
+    {
+        auto cache = make();
+        auto routes = cache->routes(QCryptographicHash::Sha1, s_hash);
+        // a few peers at most, the origin is right after them
+        QCOMPARE(routes.size(), 3);
+        for (auto& url : routes) {
+            QVERIFY(cache->isPeerUrl(url));
+            QCOMPARE(url.path(), QString("/store/sha1/") + s_hash.toHex());
+        }
+        // the same object goes to the same peers, in the same order
+        QCOMPARE(cache->routes(QCryptographicHash::Sha1, s_hash), routes);
+        QVERIFY(!cache->isPeerUrl(QUrl("https://libraries.example.com/store/sha1/" + s_hash.toHex())));
+        // nothing the store can't keep
+        QVERIFY(cache->routes(QCryptographicHash::Sha3_256, s_hash).isEmpty());
+    }
+
+    void test_FailedPeerLeftOut()
+    {
+        auto cache = make();
+        auto first = cache->routes(QCryptographicHash::Sha1, s_hash).first();
+        cache->reportFailure(first);
+        QCOMPARE(cache->peerCount(), 3);
+        QVERIFY(!cache->routes(QCryptographicHash::Sha1, s_hash).contains(first));
+
+        // it gets another chance later, as long as it still says it's there
+        m_now += 61 * 1000;
+        cache->notePeer("a", QHostAddress("192.168.1.10"), 4000);
+        cache->notePeer("b", QHostAddress("192.168.1.11"), 4000);
+        cache->notePeer("c", QHostAddress("10.0.0.5"), 4001);
+        cache->notePeer("d", QHostAddress("172.16.3.4"), 4002);
+        QCOMPARE(cache->routes(QCryptographicHash::Sha1, s_hash).first(), first);
+    }
+
+    void test_SilentPeersExpire()
+    {
+        auto cache = make();
+        QCOMPARE(cache->peerCount(), 4);
+        m_now += 20 * 1000;
+        cache->notePeer("a", QHostAddress("192.168.1.10"), 4000);
+        m_now += 20 * 1000;
+        QCOMPARE(cache->peerCount(), 1);
+        QCOMPARE(cache->routes(QCryptographicHash::Sha1, s_hash).size(), 1);
+    }
+};
+
+QTEST_GUILESS_MAIN(PeerCacheTest)
+
+#include "PeerCache_test.moc"
@@ -0,0 +1,51 @@
+#include <QDateTime>
+#include <QTest>
+
+#include <minecraft/PrefetchScheduler.h>
+
+class PrefetchSchedulerTest : public QObject {
+    Q_OBJECT
+
+    static QDateTime at(int day, int hour, int minute = 0) { return QDateTime(QDate(2024, 3, day), QTime(hour, minute)); }
+
+   private slots:
+    void test_inWindow()
+    {
+        QTime start(2, 0), end(6, 0);
+        QVERIFY(PrefetchScheduler::inWindow(QTime(2, 0), start, end));
+        QVERIFY(PrefetchScheduler::inWindow(QTime(5, 59), start, end));
+        QVERIFY(!PrefetchScheduler::inWindow(QTime(6, 0), start, end));
+        QVERIFY(!PrefetchScheduler::inWindow(QTime(1, 59), start, end));
+
+        // past midnight
+        QVERIFY(PrefetchScheduler::inWindow(QTime(23, 0), QTime(22, 0), QTime(4, 0)));
+        QVERIFY(PrefetchScheduler::inWindow(QTime(3, 0), QTime(22, 0), QTime(4, 0)));
+        QVERIFY(!PrefetchScheduler::inWindow(QTime(12, 0), QTime(22, 0), QTime(4, 0)));
+
+        QVERIFY(!PrefetchScheduler::inWindow(QTime(2, 0), start, start));
+    }
+
+    void test_nextRun()
+    {
+        QTime start(2, 0), end(6, 0);
+        // before the window, and after it
+        QCOMPARE(PrefetchScheduler::nextRun(at(10, 1), QDateTime(), start, end), at(10, 2));
+        QCOMPARE(PrefetchScheduler::nextRun(at(10, 7), QDateTime(), start, end), at(11, 2));
+        // in it, not done yet, then done
+        QCOMPARE(PrefetchScheduler::nextRun(at(10, 3), at(9, 4), start, end), at(10, 3));
+        QCOMPARE(PrefetchScheduler::nextRun(at(10, 3), at(10, 2, 30), start, end), at(11, 2));
+    }
+
+    void test_nextRunPastMidnight()
+    {
+        QTime start(22, 0), end(4, 0);
+        // the window started the day before
+        QCOMPARE(PrefetchScheduler::nextRun(at(10, 1), at(9, 1), start, end), at(10, 1));
+        QCOMPARE(PrefetchScheduler::nextRun(at(10, 1), at(9, 23), start, end), at(10, 22));
+        QCOMPARE(PrefetchScheduler::nextRun(at(10, 23), at(10, 1), start, end), at(10, 23));
+    }
+};
+
+QTEST_GUILESS_MAIN(PrefetchSchedulerTest)
+
+#include "PrefetchScheduler_test.moc"
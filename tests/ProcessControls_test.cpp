@@ -0,0 +1,85 @@
+#include <QStandardPaths>
+#include <QTest>
+
+#include <minecraft/launch/ProcessControls.h>
+
+class ProcessControlsTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_CpuList_data()
+    {
+        QTest::addColumn<QString>("text");
+        QTest::addColumn<bool>("valid");
+        QTest::addColumn<QList<int>>("cpus");
+        QTest::addColumn<QString>("formatted");
+
+        QTest::newRow("empty") << "" << true << QList<int>() << "";
+        QTest::newRow("single") << "3" << true << QList<int>{ 3 } << "3";
+        QTest::newRow("range") << "0-3" << true << QList<int>{ 0, 1, 2, 3 } << "0-3";
+        QTest::newRow("mixed") << " 8, 0-2 ,4" << true << QList<int>{ 0, 1, 2, 4, 8 } << "0-2,4,8";
+        QTest::newRow("overlapping") << "0-2,1-3" << true << QList<int>{ 0, 1, 2, 3 } << "0-3";
+        QTest::newRow("backwards") << "3-1" << false << QList<int>() << "";
+        QTest::newRow("negative") << "-1" << false << QList<int>() << "";
+        QTest::newRow("open") << "1-" << false << QList<int>() << "";
+        QTest::newRow("too many") << "0-40000" << false << QList<int>() << "";
+        QTest::newRow("garbage") << "all" << false << QList<int>() << "";
+    }
+    void test_CpuList()
+    {
+        QFETCH(QString, text);
+        QFETCH(bool, valid);
+        QFETCH(QList<int>, cpus);
+        QFETCH(QString, formatted);
+
+        auto parsed = ProcessControls::parseCpuList(text);
+        QCOMPARE(parsed.has_value(), valid);
+        if (valid) {
+            QCOMPARE(*parsed, cpus);
+            QCOMPARE(ProcessControls::formatCpuList(*parsed), formatted);
+        }
+    }
+
+    void test_Priority()
+    {
+        using ProcessControls::Priority;
+        for (auto priority : { Priority::Idle, Priority::BelowNormal, Priority::Normal, Priority::AboveNormal, Priority::High })
+            QCOMPARE(ProcessControls::priorityFromName(ProcessControls::priorityName(priority)), priority);
+        QCOMPARE(ProcessControls::priorityFromName("nonsense"), Priority::Normal);
+        QCOMPARE(ProcessControls::niceness(Priority::Normal), 0);
+        QVERIFY(ProcessControls::niceness(Priority::Idle) > ProcessControls::niceness(Priority::BelowNormal));
+        QVERIFY(ProcessControls::niceness(Priority::High) < ProcessControls::niceness(Priority::AboveNormal));
+    }
+
+    void test_WrapNothing()
+    {
+        QString program = "java";
+        QStringList arguments{ "-jar", "game.jar" };
+        QVERIFY(ProcessControls::wrap({}, program, arguments).isEmpty());
+        QCOMPARE(program, QString("java"));
+        QCOMPARE(arguments, QStringList({ "-jar", "game.jar" }));
+    }
+
+#if defined(Q_OS_LINUX)
+    void test_WrapLinux()
+    {
+        auto nice = QStandardPaths::findExecutable("nice");
+        auto taskset = QStandardPaths::findExecutable("taskset");
+        if (nice.isEmpty() || taskset.isEmpty())
+            QSKIP("nice and taskset are needed for this");
+
+        ProcessControls::Controls controls;
+        controls.priority = ProcessControls::Priority::BelowNormal;
+        controls.cpus = { 0, 1, 2, 5 };
+        QString program = "java";
+        QStringList arguments{ "-jar", "game.jar" };
+        QVERIFY(ProcessControls::wrap(controls, program, arguments).isEmpty());
+        QCOMPARE(program, taskset);
+        QCOMPARE(arguments, QStringList({ "-c", "0-2,5", nice, "-n", "10", "java", "-jar", "game.jar" }));
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(ProcessControlsTest)
+
+#include "ProcessControls_test.moc"
@@ -202,6 +202,29 @@ slots:
         model.stopWatching();
     }
 
+    void test_updateIfChanged()
+    {
+        QString file_mod = QFINDTESTDATA("testdata/ResourceFolderModel/supercoolmod.jar");
+
+        QTemporaryDir tmp;
+        ResourceFolderModel model(QDir(tmp.path()), nullptr);
+
+        QVERIFY(!model.isUpToDate());
+        {
+            EXEC_UPDATE_TASK(model.update(), QVERIFY)
+        }
+        QVERIFY(model.isUpToDate());
+        QVERIFY(!model.updateIfChanged());
+
+        QVERIFY(QFile::copy(file_mod, FS::PathCombine(tmp.path(), "supercoolmod.jar")));
+        QVERIFY(!model.isUpToDate());
+        {
+            EXEC_UPDATE_TASK(model.updateIfChanged(), QVERIFY)
+        }
+        QCOMPARE(model.size(), 1);
+        QVERIFY(model.isUpToDate());
+    }
+
     void test_enable_disable()
     {
         QString folder_resource = QFINDTESTDATA("testdata/ResourceFolderModel/test_folder");
@@ -252,6 +275,103 @@ slots:
         QVERIFY(res_2.enabled() == initial_enabled_res_2);
         QVERIFY(res_2.internal_id() == id_2);
     }
+
+    void test_batchEnable()
+    {
+        QString file_mod = QFINDTESTDATA("testdata/ResourceFolderModel/supercoolmod.jar");
+
+        QTemporaryDir tmp;
+        for (auto name : { "a.jar", "b.jar", "c.jar" })
+            QVERIFY(QFile::copy(file_mod, FS::PathCombine(tmp.path(), name)));
+
+        ResourceFolderModel model(QDir(tmp.path()), nullptr);
+        {
+            EXEC_UPDATE_TASK(model.update(), QVERIFY)
+        }
+        QCOMPARE(model.size(), 3);
+        QVERIFY(model.findByFileName("b.jar"));
+        QCOMPARE(model.findByFileName("b.jar")->fileinfo().fileName(), QString("b.jar"));
+
+        QModelIndexList indexes;
+        for (int row = 0; row < 3; row++)
+            indexes.append(model.index(row, 0));
+
+        QEventLoop loop;
+        bool batch_succeeded = false;
+        int rows_changed = 0;
+        connect(&model, &ResourceFolderModel::dataChanged, this, [&](const QModelIndex& top, const QModelIndex& bottom) {
+            rows_changed += bottom.row() - top.row() + 1;
+        });
+        connect(&model, &ResourceFolderModel::batchFinished, &loop, [&](bool succeeded) {
+            batch_succeeded = succeeded;
+            loop.quit();
+        });
+        QTimer::singleShot(4000, &loop, &QEventLoop::quit);
+
+        QVERIFY(model.setResourceEnabled(indexes, EnableAction::DISABLE));
+        QVERIFY(model.hasPendingBatches());
+        loop.exec();
+
+        QVERIFY(batch_succeeded);
+        QVERIFY(!model.hasPendingBatches());
+        // a single change for all the rows
+        QCOMPARE(rows_changed, 3);
+        for (auto const& res : model.all()) {
+            QVERIFY(!res->enabled());
+            QVERIFY(res->fileinfo().fileName().endsWith(".disabled"));
+        }
+        for (auto name : { "a.jar", "b.jar", "c.jar" }) {
+            QVERIFY(!QFile::exists(FS::PathCombine(tmp.path(), name)));
+            QVERIFY(QFile::exists(FS::PathCombine(tmp.path(), QString(name) + ".disabled")));
+            // looked up by their new names
+            QVERIFY(!model.findByFileName(name));
+            QVERIFY(model.findByFileName(QString(name) + ".disabled"));
+        }
+        // the renames made by the batch don't need another scan
+        QVERIFY(model.isUpToDate());
+    }
+
+    void test_filterGrows()
+    {
+        QString file_mod = QFINDTESTDATA("testdata/ResourceFolderModel/supercoolmod.jar");
+
+        QTemporaryDir tmp;
+        for (auto name : { "alpha.jar", "alphabet.jar", "beta.jar" })
+            QVERIFY(QFile::copy(file_mod, FS::PathCombine(tmp.path(), name)));
+
+        ResourceFolderModel model(QDir(tmp.path()), nullptr);
+        {
+            EXEC_UPDATE_TASK(model.update(), QVERIFY)
+        }
+        QCOMPARE(model.size(), 3);
+
+        std::unique_ptr<QSortFilterProxyModel> proxy(model.createFilterProxyModel(nullptr));
+        proxy->setSourceModel(&model);
+        proxy->setFilterKeyColumn(-1);
+
+        proxy->setFilterRegularExpression("al");
+        QCOMPARE(proxy->rowCount(), 2);
+        proxy->setFilterRegularExpression("alphab");
+        QCOMPARE(proxy->rowCount(), 1);
+        // growing at the front narrows too
+        proxy->setFilterRegularExpression("halphab");
+        QCOMPARE(proxy->rowCount(), 0);
+        proxy->setFilterRegularExpression("a");
+        QCOMPARE(proxy->rowCount(), 3);
+        // a regular expression that only looks longer matches more
+        proxy->setFilterRegularExpression("a|b");
+        QCOMPARE(proxy->rowCount(), 3);
+        proxy->setFilterRegularExpression("beta");
+        QCOMPARE(proxy->rowCount(), 1);
+
+        // rows that show up while filtering are tried with the filter they show up with
+        QVERIFY(QFile::copy(file_mod, FS::PathCombine(tmp.path(), "betamax.jar")));
+        {
+            EXEC_UPDATE_TASK(model.update(), QVERIFY)
+        }
+        proxy->setFilterRegularExpression("betam");
+        QCOMPARE(proxy->rowCount(), 1);
+    }
 };
 
 QTEST_GUILESS_MAIN(ResourceFolderModelTest)
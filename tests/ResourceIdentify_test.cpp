@@ -0,0 +1,53 @@
+#include <QTest>
+
+#include <FileSystem.h>
+#include <minecraft/mod/tasks/LocalResourceParse.h>
+
+Q_DECLARE_METATYPE(PackedResourceType)
+
+class ResourceIdentifyTest : public QObject {
+    Q_OBJECT
+
+    QString testFile(const QString& path) { return FS::PathCombine(QFINDTESTDATA("testdata"), path); }
+
+   private slots:
+    void test_identify_data()
+    {
+        QTest::addColumn<QString>("path");
+        QTest::addColumn<PackedResourceType>("type");
+
+        QTest::newRow("resource pack") << "ResourcePackParse/test_resource_pack_idk.zip" << PackedResourceType::ResourcePack;
+        QTest::newRow("texture pack") << "TexturePackParse/test_texture_pack_idk.zip" << PackedResourceType::TexturePack;
+        QTest::newRow("data pack") << "DataPackParse/test_data_pack_boogaloo.zip" << PackedResourceType::DataPack;
+        QTest::newRow("shader pack") << "ShaderPackParse/shaderpack1.zip" << PackedResourceType::ShaderPack;
+        QTest::newRow("world") << "WorldSaveParse/minecraft_save_1.zip" << PackedResourceType::WorldSave;
+        QTest::newRow("world in saves") << "WorldSaveParse/minecraft_save_2.zip" << PackedResourceType::WorldSave;
+        QTest::newRow("nothing known") << "ShaderPackParse/shaderpack3.zip" << PackedResourceType::UNKNOWN;
+        QTest::newRow("not an archive") << "ResourcePackParse/supercoolmod.jar" << PackedResourceType::UNKNOWN;
+    }
+
+    void test_identify()
+    {
+        QFETCH(QString, path);
+        QFETCH(PackedResourceType, type);
+
+        QCOMPARE(ResourceUtils::identify(QFileInfo(testFile(path))), type);
+    }
+
+    void test_identifyMany()
+    {
+        QList<QFileInfo> files = { QFileInfo(testFile("WorldSaveParse/minecraft_save_2.zip")),
+                                   QFileInfo(testFile("ShaderPackParse/shaderpack3.zip")),
+                                   QFileInfo(testFile("TexturePackParse/test_texture_pack_idk.zip")),
+                                   QFileInfo(testFile("ResourcePackParse/test_resource_pack_idk.zip")) };
+
+        QList<PackedResourceType> expected = { PackedResourceType::WorldSave, PackedResourceType::UNKNOWN, PackedResourceType::TexturePack,
+                                               PackedResourceType::ResourcePack };
+        QCOMPARE(ResourceUtils::identify(files), expected);
+        QVERIFY(ResourceUtils::identify(QList<QFileInfo>()).isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(ResourceIdentifyTest)
+
+#include "ResourceIdentify_test.moc"
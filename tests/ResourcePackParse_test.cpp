@@ -16,6 +16,8 @@
  *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <QImage>
+#include <QTemporaryDir>
 #include <QTest>
 #include <QTimer>
 
@@ -69,6 +71,37 @@ class ResourcePackParseTest : public QObject {
         QVERIFY(pack.description() == "o quartel pegou fogo, policia deu sinal, acode acode acode a bandeira nacional");
         QVERIFY(valid == false); // no assets dir
     }
+
+    void test_icon()
+    {
+        QTemporaryDir dir;
+        auto folder_rp = FS::PathCombine(dir.path(), "pack");
+        QVERIFY(FS::ensureFolderPathExists(FS::PathCombine(folder_rp, "assets")));
+        FS::write(FS::PathCombine(folder_rp, "pack.mcmeta"), R"({ "pack": { "pack_format": 9, "description": "icon" } })");
+
+        QImage source(128, 128, QImage::Format_ARGB32);
+        source.fill(Qt::red);
+        QVERIFY(source.save(FS::PathCombine(folder_rp, "pack.png"), "PNG"));
+
+        ResourcePack pack { QFileInfo(folder_rp) };
+        QVERIFY(ResourcePackUtils::processFolder(pack, ResourcePackUtils::ProcessingLevel::Full));
+
+        // parsing only notes where the image is
+        auto icon = pack.icon();
+        QVERIFY(icon.isValid());
+        QVERIFY(!icon.in_zip);
+
+        auto cache_dir = FS::PathCombine(dir.path(), "cache");
+        auto image = icon.load({ 64, 64 }, cache_dir);
+        QCOMPARE(image.size(), QSize(64, 64));
+        QCOMPARE(image.pixelColor(32, 32), QColor(Qt::red));
+        QVERIFY(QFileInfo::exists(icon.thumbnailPath(cache_dir, { 64, 64 })));
+
+        // another size is another thumbnail
+        QVERIFY(icon.thumbnailPath(cache_dir, { 32, 32 }) != icon.thumbnailPath(cache_dir, { 64, 64 }));
+        // and without the cache, it's read again
+        QCOMPARE(icon.load({ 32, 32 }, {}).size(), QSize(32, 32));
+    }
 };
 
 QTEST_GUILESS_MAIN(ResourcePackParseTest)
@@ -0,0 +1,204 @@
+#include <QApplication>
+#include <QEventLoop>
+#include <QHash>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTimer>
+
+#include <FileSystem.h>
+#include <InstanceList.h>
+#include <minecraft/AssetsUtils.h>
+#include <minecraft/mod/ModFolderModel.h>
+#include <net/HttpMetaCache.h>
+#include <settings/INISettingsObject.h>
+#include <ui/instanceview/InstanceDelegate.h>
+#include <ui/instanceview/InstanceView.h>
+
+#include "BenchmarkMain.h"
+#include "FleetFixture.h"
+
+/* How the launcher copes with a lot of instances and mods, on generated data.
+ *
+ * Every benchmark runs at each scale of LAUNCHER_BENCHMARK_SCALES, a comma separated list of
+ * "<instances>x<mods per instance>" (30x50,300x500 by default). The data for a scale is generated the first time
+ * it's needed: the instances, a mods folder, a meta cache with an entry for every mod of the fleet and an asset
+ * index with 20 objects per mod. Run it with `--json <file>` to also get the results in JSON, see BenchmarkMain.
+ */
+class ScaleBenchmarks : public QObject {
+    Q_OBJECT
+
+    struct Fleet {
+        QString instances;
+        QString mods;
+        QString meta_cache;
+        QString assets_index;
+    };
+
+    static QList<QPair<int, int>> scales()
+    {
+        auto setting = qEnvironmentVariable("LAUNCHER_BENCHMARK_SCALES", "30x50,300x500");
+        QList<QPair<int, int>> scales;
+        for (auto& scale : setting.split(',', Qt::SkipEmptyParts)) {
+            auto parts = scale.trimmed().split('x');
+            if (parts.size() == 2 && parts[0].toInt() > 0 && parts[1].toInt() > 0)
+                scales.append({ parts[0].toInt(), parts[1].toInt() });
+            else
+                qWarning() << "Ignoring the scale" << scale;
+        }
+        return scales;
+    }
+
+    static void addScales()
+    {
+        QTest::addColumn<int>("instances");
+        QTest::addColumn<int>("mods");
+        for (auto& [instances, mods] : scales())
+            QTest::newRow(qPrintable(QString("%1x%2").arg(instances).arg(mods))) << instances << mods;
+    }
+
+    const Fleet* fleet(int instances, int mods)
+    {
+        auto key = QString("%1x%2").arg(instances).arg(mods);
+        auto found = m_fleets.find(key);
+        if (found != m_fleets.end())
+            return &*found;
+
+        auto root = FS::PathCombine(m_tmp.path(), key);
+        Fleet fleet{ FS::PathCombine(root, "instances"), FS::PathCombine(root, "mods"), FS::PathCombine(root, "metacache"),
+                     FS::PathCombine(root, "assets.json") };
+        qDebug() << "Generating the fleet for" << key;
+        if (!FleetFixture::generateInstances(fleet.instances, instances) || !FleetFixture::generateMods(fleet.mods, mods) ||
+            !FleetFixture::generateMetaCache(fleet.meta_cache, "mods", root, instances * mods) ||
+            !FleetFixture::generateAssetsIndex(fleet.assets_index, mods * 20))
+            return nullptr;
+        return &*m_fleets.insert(key, fleet);
+    }
+
+   private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_tmp.isValid());
+        QVERIFY(!scales().isEmpty());
+        // the instance list keeps its summary cache in the working directory
+        m_previous_dir = QDir::currentPath();
+        QDir::setCurrent(m_tmp.path());
+
+        m_settings = std::make_shared<INISettingsObject>(FS::PathCombine(m_tmp.path(), "launcher.cfg"));
+        for (auto id : { "ShowGameTime", "RecordGameTime", "ShowConsole", "AutoCloseConsole", "ShowConsoleOnError", "LogPrePostOutput",
+                         "ConsoleOverflowStop" })
+            m_settings->registerSetting(id, false);
+        for (auto id : { "PreLaunchCommand", "WrapperCommand", "PostExitCommand" })
+            m_settings->registerSetting(id, "");
+        m_settings->registerSetting("ConsoleMaxLines", 100000);
+    }
+
+    void cleanupTestCase() { QDir::setCurrent(m_previous_dir); }
+
+    void bench_InstanceListLoad_data() { addScales(); }
+    void bench_InstanceListLoad()
+    {
+        QFETCH(int, instances);
+        QFETCH(int, mods);
+        auto data = fleet(instances, mods);
+        QVERIFY(data);
+
+        QBENCHMARK {
+            InstanceList list(m_settings, data->instances);
+            list.loadList();
+            QCOMPARE(list.count(), instances);
+        }
+    }
+
+    void bench_ModFolderUpdate_data() { addScales(); }
+    void bench_ModFolderUpdate()
+    {
+        QFETCH(int, instances);
+        QFETCH(int, mods);
+        auto data = fleet(instances, mods);
+        QVERIFY(data);
+
+        QBENCHMARK {
+            ModFolderModel model(data->mods, nullptr);
+            QEventLoop loop;
+            connect(&model, &ModFolderModel::updateFinished, &loop, &QEventLoop::quit);
+            QTimer expire_timer;
+            expire_timer.callOnTimeout(&loop, &QEventLoop::quit);
+            expire_timer.setSingleShot(true);
+            expire_timer.start(60000);
+
+            model.update();
+            loop.exec();
+            QVERIFY2(expire_timer.isActive(), "The update never finished.");
+            QCOMPARE(static_cast<int>(model.size()), mods);
+        }
+    }
+
+    void bench_MetaCacheLoad_data() { addScales(); }
+    void bench_MetaCacheLoad()
+    {
+        QFETCH(int, instances);
+        QFETCH(int, mods);
+        auto data = fleet(instances, mods);
+        QVERIFY(data);
+
+        QBENCHMARK {
+            HttpMetaCache cache(data->meta_cache);
+            cache.addBase("mods", QFileInfo(data->meta_cache).absolutePath());
+            cache.Load();
+        }
+    }
+
+    void bench_AssetsIndexLoad_data() { addScales(); }
+    void bench_AssetsIndexLoad()
+    {
+        QFETCH(int, instances);
+        QFETCH(int, mods);
+        auto data = fleet(instances, mods);
+        QVERIFY(data);
+
+        QBENCHMARK {
+            AssetsIndex index;
+            QVERIFY(AssetsUtils::loadAssetsIndexJson("fleet", data->assets_index, index));
+        }
+    }
+
+    void bench_InstanceViewLayout_data() { addScales(); }
+    void bench_InstanceViewLayout()
+    {
+        QFETCH(int, instances);
+        QFETCH(int, mods);
+        auto data = fleet(instances, mods);
+        QVERIFY(data);
+
+        InstanceList list(m_settings, data->instances);
+        list.loadList();
+        InstanceView view;
+        view.setItemDelegate(new ListViewDelegate(&view));
+        view.setModel(&list);
+        view.resize(1280, 800);
+
+        QBENCHMARK {
+            view.updateGeometries();
+            // the items only get placed when they are painted
+            view.viewport()->grab();
+        }
+    }
+
+   private:
+    QTemporaryDir m_tmp;
+    QString m_previous_dir;
+    SettingsObjectPtr m_settings;
+    QHash<QString, Fleet> m_fleets;
+};
+
+int main(int argc, char* argv[])
+{
+    // the view is timed without showing it
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    ScaleBenchmarks benchmarks;
+    return BenchmarkMain::run(&benchmarks, app.arguments());
+}
+
+#include "ScaleBenchmarks.moc"
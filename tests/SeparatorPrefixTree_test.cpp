@@ -0,0 +1,77 @@
+#include <QTest>
+
+#include <SeparatorPrefixTree.h>
+
+class SeparatorPrefixTreeTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_Covers()
+    {
+        SeparatorPrefixTree<'/'> tree;
+        tree.insert("mods/a.jar");
+        tree.insert("config");
+
+        QVERIFY(tree.covers("mods/a.jar"));
+        QVERIFY(tree.covers("config/forge/client.toml"));
+        QVERIFY(!tree.covers("mods"));
+        QVERIFY(!tree.covers("mods/b.jar"));
+        QVERIFY(!tree.covers("configs"));
+
+        QCOMPARE(tree.cover("config/forge/client.toml"), QString("config"));
+        QVERIFY(tree.cover("mods/b.jar").isNull());
+
+        QVERIFY(tree.exists("mods"));
+        QVERIFY(!tree.exists("mods/b.jar"));
+        QVERIFY(tree.find("mods"));
+        QVERIFY(!tree.find("mods")->contained());
+        QVERIFY(!tree.find("mods")->leaf());
+        QVERIFY(tree.find("mods/a.jar")->leaf());
+    }
+
+    void test_InsertCoversChildren()
+    {
+        SeparatorPrefixTree<'/'> tree;
+        tree.insert("mods/a.jar");
+        tree.insert("mods/b.jar");
+        tree.insert("mods");
+
+        QVERIFY(tree.find("mods")->leaf());
+        QCOMPARE(tree.toStringList(), QStringList{ "mods" });
+    }
+
+    void test_Remove()
+    {
+        SeparatorPrefixTree<'/'> tree;
+        tree.insert("a/b/c");
+        tree.insert("a/d");
+
+        QVERIFY(tree.remove("a/b/c"));
+        QVERIFY(!tree.exists("a/b"));
+        QVERIFY(tree.exists("a"));
+        QVERIFY(!tree.remove("a/x"));
+
+        // removing a prefix takes what's under it with it
+        QVERIFY(tree.remove("a"));
+        QVERIFY(tree.leaf());
+
+        // the removed nodes get reused
+        tree.insert("e/f");
+        QCOMPARE(tree.toStringList(), QStringList{ "e/f" });
+    }
+
+    void test_ToStringList()
+    {
+        SeparatorPrefixTree<'/'> tree;
+        tree.insert("b");
+        tree.insert("a/y");
+        tree.insert("a/x");
+        tree.insert("c/z");
+
+        QCOMPARE(tree.toStringList(), (QStringList{ "a/x", "a/y", "b", "c/z" }));
+    }
+};
+
+QTEST_GUILESS_MAIN(SeparatorPrefixTreeTest)
+
+#include "SeparatorPrefixTree_test.moc"
@@ -0,0 +1,124 @@
+#include <QTest>
+
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <minecraft/ServerPing.h>
+
+// answers the server list ping like a server would, `closeAfterStatus` hangs up instead of answering the ping
+class FakeServer : public QObject {
+    Q_OBJECT
+   public:
+    explicit FakeServer(QByteArray status, bool closeAfterStatus = false) : m_status(std::move(status)), m_close(closeAfterStatus)
+    {
+        m_server.listen(QHostAddress::LocalHost);
+        connect(&m_server, &QTcpServer::newConnection, this, [this] {
+            auto socket = m_server.nextPendingConnection();
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket] { answer(socket); });
+        });
+    }
+
+    QString address() const { return QString("127.0.0.1:%1").arg(m_server.serverPort()); }
+
+   private:
+    static QByteArray varInt(int value)
+    {
+        QByteArray out;
+        auto bits = static_cast<quint32>(value);
+        do {
+            char byte = bits & 0x7F;
+            bits >>= 7;
+            if (bits)
+                byte |= 0x80;
+            out.append(byte);
+        } while (bits);
+        return out;
+    }
+
+    void answer(QTcpSocket* socket)
+    {
+        m_received.append(socket->readAll());
+        // the handshake and the status request come together, the ping on its own and ends with the 8 byte payload
+        if (!m_answered) {
+            m_answered = true;
+            QByteArray body = varInt(0x00) + varInt(m_status.size()) + m_status;
+            socket->write(varInt(body.size()) + body);
+            if (m_close)
+                socket->disconnectFromHost();
+            m_received.clear();
+            return;
+        }
+        if (m_received.size() >= 10) {
+            socket->write(m_received.left(10));
+            m_received.clear();
+        }
+    }
+
+    QTcpServer m_server;
+    QByteArray m_status;
+    QByteArray m_received;
+    bool m_close;
+    bool m_answered = false;
+};
+
+class ServerPingTest : public QObject {
+    Q_OBJECT
+
+    static const QByteArray status()
+    {
+        return R"({"version":{"name":"1.20.1","protocol":763},"players":{"max":20,"online":3},
+                   "description":{"text":"A ","extra":[{"text":"test","bold":true}," server"]}})";
+    }
+
+   private slots:
+    void test_ping()
+    {
+        FakeServer server(status());
+        ServerPing ping(server.address());
+        QSignalSpy finished(&ping, &Task::finished);
+        ping.start();
+        QVERIFY(finished.wait(5000));
+        QVERIFY(ping.wasSuccessful());
+        QCOMPARE(ping.status().currentPlayers, 3);
+        QCOMPARE(ping.status().maxPlayers, 20);
+        QCOMPARE(ping.status().motd, QString("A test server"));
+
+        auto cached = ServerStatusCache::status(server.address());
+        QVERIFY(cached.has_value());
+        QCOMPARE(cached->motd, QString("A test server"));
+    }
+
+    void test_closedAfterStatus()
+    {
+        FakeServer server(R"({"players":{"max":5,"online":0},"description":"§aLegacy §lmotd"})", true);
+        ServerPing ping(server.address());
+        QSignalSpy finished(&ping, &Task::finished);
+        ping.start();
+        QVERIFY(finished.wait(5000));
+        QVERIFY(ping.wasSuccessful());
+        QCOMPARE(ping.status().maxPlayers, 5);
+        QCOMPARE(ping.status().motd, QString("Legacy motd"));
+    }
+
+    void test_down()
+    {
+        // nothing listens there anymore
+        QString address;
+        {
+            QTcpServer closed;
+            closed.listen(QHostAddress::LocalHost);
+            address = QString("127.0.0.1:%1").arg(closed.serverPort());
+        }
+        ServerPing ping(address);
+        QSignalSpy finished(&ping, &Task::finished);
+        ping.start();
+        QVERIFY(finished.wait(10000));
+        QVERIFY(!ping.wasSuccessful());
+        QVERIFY(!ServerStatusCache::status(address));
+    }
+};
+
+QTEST_GUILESS_MAIN(ServerPingTest)
+
+#include "ServerPing_test.moc"
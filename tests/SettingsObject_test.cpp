@@ -0,0 +1,73 @@
+#include <QFile>
+#include <QTest>
+
+#include <settings/INISettingsObject.h>
+#include <settings/Setting.h>
+
+class SettingsObjectTest : public QObject {
+    Q_OBJECT
+   private slots:
+    void init()
+    {
+        // the files from the last run would get in the way
+        for (auto file : { "test_Declared.cfg", "test_Override_global.cfg", "test_Override.cfg", "test_Passthrough_global.cfg",
+                           "test_Passthrough.cfg" })
+            QFile::remove(file);
+    }
+
+    void test_Declared()
+    {
+        INISettingsObject settings("test_Declared.cfg");
+        QVERIFY(settings.declareSetting("name", "Unnamed Instance"));
+        QVERIFY(!settings.declareSetting("name", "Other"));
+        QCOMPARE(settings.get("name").toString(), QString("Unnamed Instance"));
+
+        settings.set("name", "Some Instance");
+        QCOMPARE(settings.get("name").toString(), QString("Some Instance"));
+        QCOMPARE(settings.getSetting("name")->get().toString(), QString("Some Instance"));
+
+        settings.reset("name");
+        QCOMPARE(settings.get("name").toString(), QString("Unnamed Instance"));
+    }
+
+    void test_Override()
+    {
+        auto global = std::make_shared<INISettingsObject>("test_Override_global.cfg");
+        auto javaPath = global->registerSetting("JavaPath", "java");
+
+        INISettingsObject settings("test_Override.cfg");
+        auto gate = settings.registerSetting("OverrideJava", false);
+        QVERIFY(settings.registerOverride(javaPath, gate));
+        QCOMPARE(settings.get("JavaPath").toString(), QString("java"));
+
+        // not overriding, the instance value doesn't matter
+        settings.set("JavaPath", "/opt/java/bin/java");
+        QCOMPARE(settings.get("JavaPath").toString(), QString("java"));
+
+        gate->set(true);
+        QCOMPARE(settings.get("JavaPath").toString(), QString("/opt/java/bin/java"));
+        global->set("JavaPath", "/usr/bin/java");
+        QCOMPARE(settings.get("JavaPath").toString(), QString("/opt/java/bin/java"));
+        gate->set(false);
+        QCOMPARE(settings.get("JavaPath").toString(), QString("/usr/bin/java"));
+    }
+
+    void test_Passthrough()
+    {
+        auto global = std::make_shared<INISettingsObject>("test_Passthrough_global.cfg");
+        auto maxLines = global->registerSetting("ConsoleMaxLines", 100000);
+
+        INISettingsObject settings("test_Passthrough.cfg");
+        QVERIFY(settings.registerPassthrough(maxLines, nullptr));
+        QCOMPARE(settings.get("ConsoleMaxLines").toInt(), 100000);
+
+        // without a gate, changes go to the original
+        settings.set("ConsoleMaxLines", 5000);
+        QCOMPARE(global->get("ConsoleMaxLines").toInt(), 5000);
+        QCOMPARE(settings.get("ConsoleMaxLines").toInt(), 5000);
+    }
+};
+
+QTEST_GUILESS_MAIN(SettingsObjectTest)
+
+#include "SettingsObject_test.moc"
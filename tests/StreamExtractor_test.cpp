@@ -0,0 +1,118 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <MMCZip.h>
+#include <StreamExtractor.h>
+
+class StreamExtractorTest : public QObject {
+    Q_OBJECT
+
+    static void writeFile(const QString& path, const QByteArray& data)
+    {
+        QVERIFY(FS::ensureFilePathExists(path));
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    }
+
+    static QByteArray readFile(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        return file.readAll();
+    }
+
+    static void feedInChunks(MMCZip::StreamExtractor& extractor, const QByteArray& data, int chunk)
+    {
+        for (int pos = 0; pos < data.size(); pos += chunk)
+            extractor.feed(data.mid(pos, chunk));
+        extractor.finish();
+    }
+
+    // Makes `tmp`/pack.zip out of a few files, some of them big enough to be deflated
+    static QString makeArchive(const QTemporaryDir& tmp)
+    {
+        auto source = FS::PathCombine(tmp.path(), "source");
+        writeFile(FS::PathCombine(source, "modrinth.index.json"), "{}");
+        writeFile(FS::PathCombine(source, "overrides/config/big.txt"), QByteArray("some text that compresses well\n").repeated(4096));
+        writeFile(FS::PathCombine(source, "overrides/empty.txt"), {});
+
+        QFileInfoList files;
+        MMCZip::collectFileListRecursively(source, nullptr, &files, nullptr);
+        auto archive = FS::PathCombine(tmp.path(), "pack.zip");
+        MMCZip::compressDirFiles(archive, source, files);
+        return archive;
+    }
+
+   private slots:
+    void test_ExtractInChunks_data()
+    {
+        QTest::addColumn<int>("chunk");
+
+        QTest::newRow("one byte") << 1;
+        QTest::newRow("small") << 100;
+        QTest::newRow("whole") << (1 << 30);
+    }
+    void test_ExtractInChunks()
+    {
+        QFETCH(int, chunk);
+
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto archive = makeArchive(tmp);
+        auto data = readFile(archive);
+        QVERIFY(!data.isEmpty());
+
+        auto target = FS::PathCombine(tmp.path(), "target");
+        MMCZip::StreamExtractor extractor(target);
+        feedInChunks(extractor, data, chunk);
+        QVERIFY(extractor.validate(archive));
+
+        QCOMPARE(readFile(FS::PathCombine(target, "modrinth.index.json")), QByteArray("{}"));
+        QCOMPARE(readFile(FS::PathCombine(target, "overrides/config/big.txt")), QByteArray("some text that compresses well\n").repeated(4096));
+        QVERIFY(QFileInfo::exists(FS::PathCombine(target, "overrides/empty.txt")));
+    }
+
+    void test_ResetStartsOver()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto archive = makeArchive(tmp);
+        auto data = readFile(archive);
+
+        MMCZip::StreamExtractor extractor(FS::PathCombine(tmp.path(), "target"));
+        extractor.feed(data.left(data.size() / 2));
+        extractor.reset();
+        feedInChunks(extractor, data, 1000);
+        QVERIFY(extractor.validate(archive));
+    }
+
+    void test_IncompleteDataFails()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto archive = makeArchive(tmp);
+        auto data = readFile(archive);
+
+        MMCZip::StreamExtractor extractor(FS::PathCombine(tmp.path(), "target"));
+        feedInChunks(extractor, data.left(data.size() / 2), 1000);
+        QVERIFY(!extractor.validate(archive));
+    }
+
+    void test_GarbageFails()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto archive = makeArchive(tmp);
+
+        MMCZip::StreamExtractor extractor(FS::PathCombine(tmp.path(), "target"));
+        feedInChunks(extractor, QByteArray("definitely not a zip file").repeated(100), 64);
+        QVERIFY(!extractor.validate(archive));
+    }
+};
+
+QTEST_GUILESS_MAIN(StreamExtractorTest)
+
+#include "StreamExtractor_test.moc"
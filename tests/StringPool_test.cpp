@@ -0,0 +1,56 @@
+#include <QTest>
+
+#include <StringPool.h>
+#include <minecraft/mod/ModDetails.h>
+
+class StringPoolTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_Intern()
+    {
+        StringPool pool;
+        // built at runtime, so that they don't share a buffer already
+        auto a = pool.intern(QString("Some") + "Author");
+        auto b = pool.intern(QString("Some") + QString("Author"));
+        QCOMPARE(a, QString("SomeAuthor"));
+        QCOMPARE(b.constData(), a.constData());
+        QCOMPARE(pool.count(), 1);
+
+        auto list = pool.intern(QStringList{ QString("Some") + "Author", "Other" });
+        QCOMPARE(list.first().constData(), a.constData());
+        QCOMPARE(pool.count(), 2);
+
+        QCOMPARE(pool.intern(QString()), QString());
+        QCOMPARE(pool.count(), 2);
+    }
+
+    void test_Prune()
+    {
+        StringPool pool;
+        auto kept = pool.intern(QString("kept") + "1");
+        pool.intern(QString("dropped") + "1");
+        QCOMPARE(pool.count(), 2);
+        QCOMPARE(pool.prune(), 1);
+        QCOMPARE(pool.count(), 1);
+        QCOMPARE(pool.intern(QString("kept") + "1").constData(), kept.constData());
+    }
+
+    void test_ModDetails()
+    {
+        ModDetails a;
+        a.description = QString("A mod that ") + "does things";
+        a.authors = QStringList{ QString("Some") + "one" };
+        ModDetails b;
+        b.description = QString("A mod that does") + " things";
+        b.authors = QStringList{ QString("Some") + "one" };
+        a.intern();
+        b.intern();
+        QCOMPARE(b.description.constData(), a.description.constData());
+        QCOMPARE(b.authors.first().constData(), a.authors.first().constData());
+    }
+};
+
+QTEST_GUILESS_MAIN(StringPoolTest)
+
+#include "StringPool_test.moc"
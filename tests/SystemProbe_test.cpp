@@ -0,0 +1,56 @@
+#include <QTest>
+
+#include <SystemProbe.h>
+
+class SystemProbeTest : public QObject {
+    Q_OBJECT
+
+    static SystemProbe::Gpu gpu(QString slot, quint16 vendor, QString driver, bool boot_vga, qint64 vram = 0)
+    {
+        SystemProbe::Gpu gpu;
+        gpu.pci_slot = slot;
+        gpu.vendor = vendor;
+        gpu.driver = driver;
+        gpu.boot_vga = boot_vga;
+        gpu.vram = vram;
+        return gpu;
+    }
+
+   private slots:
+    void test_intelAndNvidia()
+    {
+        auto discrete = SystemProbe::discreteGpu(
+            { gpu("0000:00:02.0", 0x8086, "i915", true), gpu("0000:01:00.0", 0x10de, "nvidia", false) });
+        QVERIFY(discrete.has_value());
+        QCOMPARE(discrete->pci_slot, QString("0000:01:00.0"));
+    }
+
+    void test_amdApuAndAmd()
+    {
+        auto discrete = SystemProbe::discreteGpu(
+            { gpu("0000:05:00.0", 0x1002, "amdgpu", true, 512ll << 20), gpu("0000:03:00.0", 0x1002, "amdgpu", false, 8ll << 30) });
+        QVERIFY(discrete.has_value());
+        QCOMPARE(discrete->pci_slot, QString("0000:03:00.0"));
+
+        // the other way around it's the integrated one that isn't the boot GPU
+        QVERIFY(!SystemProbe::discreteGpu(
+                     { gpu("0000:03:00.0", 0x1002, "amdgpu", true, 8ll << 30), gpu("0000:05:00.0", 0x1002, "amdgpu", false, 512ll << 20) })
+                     .has_value());
+    }
+
+    void test_desktopWithNvidia()
+    {
+        QVERIFY(!SystemProbe::discreteGpu({ gpu("0000:01:00.0", 0x10de, "nvidia", true), gpu("0000:00:02.0", 0x8086, "i915", false) })
+                     .has_value());
+    }
+
+    void test_singleGpu()
+    {
+        QVERIFY(!SystemProbe::discreteGpu({ gpu("0000:00:02.0", 0x8086, "i915", true) }).has_value());
+        QVERIFY(!SystemProbe::discreteGpu({}).has_value());
+    }
+};
+
+QTEST_GUILESS_MAIN(SystemProbeTest)
+
+#include "SystemProbe_test.moc"
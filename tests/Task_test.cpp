@@ -6,6 +6,12 @@
 #include <tasks/MultipleOptionsTask.h>
 #include <tasks/SequentialTask.h>
 #include <tasks/Task.h>
+#include <tasks/TaskGraph.h>
+#include <tasks/TaskTrace.h>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 
 #include <array>
 
@@ -25,6 +31,28 @@ class BasicTask : public Task {
     };
 };
 
+/* Records the order tasks finish in, failing if asked to. Only used for testing. */
+class OrderedTask : public Task {
+    Q_OBJECT
+
+   public:
+    OrderedTask(QStringList& order, QString name, bool fail = false) : Task(nullptr, false), m_order(order), m_name(name), m_fail(fail) {}
+
+   private:
+    void executeTask() override
+    {
+        m_order.append(m_name);
+        if (m_fail)
+            emitFailed("failed on purpose");
+        else
+            emitSucceeded();
+    };
+
+    QStringList& m_order;
+    QString m_name;
+    bool m_fail;
+};
+
 /* Does nothing. Only used for testing. */
 class BasicTask_MultiStep : public Task {
     Q_OBJECT
@@ -203,6 +231,29 @@ class TaskTest : public QObject {
         }, 1000), "Task didn't finish as it should.");
     }
 
+    void test_adaptiveConcurrency()
+    {
+        QStringList order;
+        ConcurrentTask t(nullptr, "", 8);
+        t.setConcurrency(ConcurrentTask::Concurrency::Adaptive);
+        QCOMPARE(t.maxConcurrent(), 8);
+
+        t.addTask(makeShared<OrderedTask>(order, "fails", true));
+        t.addTask(makeShared<OrderedTask>(order, "a"));
+        t.addTask(makeShared<OrderedTask>(order, "b"));
+
+        t.start();
+        QVERIFY2(QTest::qWaitFor([&]() { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
+
+        // went down for the failure, and not enough went fine afterwards to get it back up
+        QCOMPARE(t.maxConcurrent(), 4);
+
+        t.setConcurrency(ConcurrentTask::Concurrency::CpuBound);
+        QCOMPARE(t.maxConcurrent(), qMax(1, QThread::idealThreadCount()));
+        t.setConcurrency(ConcurrentTask::Concurrency::Fixed);
+        QCOMPARE(t.maxConcurrent(), 8);
+    }
+
     void test_basicSequentialRun(){
         auto t1 = makeShared<BasicTask>();
         auto t2 = makeShared<BasicTask>();
@@ -251,6 +302,95 @@ class TaskTest : public QObject {
         }, 1000), "Task didn't finish as it should.");
     }
 
+    void test_taskGraphRunsDependenciesFirst(){
+        QStringList order;
+        auto c = makeShared<OrderedTask>(order, "c");
+        auto b = makeShared<OrderedTask>(order, "b");
+        auto a = makeShared<OrderedTask>(order, "a");
+        auto d = makeShared<OrderedTask>(order, "d");
+
+        TaskGraph t;
+
+        // added in the opposite order of what they need
+        t.addTask(d, { b, c });
+        t.addTask(c, { a });
+        t.addTask(b, { a });
+        t.addTask(a);
+
+        t.start();
+        QVERIFY2(QTest::qWaitFor([&]() {
+            return t.isFinished();
+        }, 1000), "Task didn't finish as it should.");
+
+        QVERIFY(t.wasSuccessful());
+        QCOMPARE(order.size(), 4);
+        QCOMPARE(order.first(), QString("a"));
+        QCOMPARE(order.last(), QString("d"));
+    }
+
+    void test_taskGraphFailsWithDependency(){
+        QStringList order;
+        auto a = makeShared<OrderedTask>(order, "a", true);
+        auto b = makeShared<OrderedTask>(order, "b");
+
+        TaskGraph t;
+        t.addTask(a);
+        t.addTask(b, { a });
+
+        t.start();
+        QVERIFY2(QTest::qWaitFor([&]() {
+            return t.isFinished();
+        }, 1000), "Task didn't finish as it should.");
+
+        QVERIFY(!t.wasSuccessful());
+        QCOMPARE(t.failReason(), QString("failed on purpose"));
+        QCOMPARE(order, QStringList{ "a" });
+    }
+
+    void test_taskGraphFailsWithMissingDependency(){
+        QStringList order;
+        auto missing = makeShared<OrderedTask>(order, "missing");
+        auto a = makeShared<OrderedTask>(order, "a");
+
+        TaskGraph t;
+        t.addTask(a, { missing });
+
+        t.start();
+        QVERIFY2(QTest::qWaitFor([&]() {
+            return t.isFinished();
+        }, 1000), "Task didn't finish as it should.");
+
+        QVERIFY(!t.wasSuccessful());
+        QVERIFY(order.isEmpty());
+    }
+
+    void test_traceRecordsFinishedTasks()
+    {
+        TaskTrace::setRecording(true);
+        auto from = TaskTrace::now();
+
+        QStringList order;
+        OrderedTask succeeding(order, "a");
+        OrderedTask failing(order, "b", true);
+        succeeding.start();
+        failing.start();
+        QVERIFY(succeeding.startedAt() >= from);
+        QVERIFY(succeeding.finishedAt() >= succeeding.startedAt());
+
+        auto trace = QJsonDocument::fromJson(TaskTrace::toJson(from, TaskTrace::now())).object();
+        auto events = trace.value("traceEvents").toArray();
+        QStringList outcomes;
+        for (auto event : events) {
+            auto object = event.toObject();
+            if (object.value("ph").toString() == "e")
+                outcomes.append(object.value("args").toObject().value("outcome").toString());
+        }
+        QCOMPARE(outcomes, QStringList({ "succeeded", "failed" }));
+
+        TaskTrace::setRecording(false);
+        QVERIFY(TaskTrace::toJson(from, TaskTrace::now()).count("\"ph\":\"b\"") == 0);
+    }
+
     void test_stackOverflowInConcurrentTask()
     {
         QEventLoop loop;
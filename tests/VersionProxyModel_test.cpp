@@ -0,0 +1,181 @@
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QTest>
+
+#include <BaseVersionList.h>
+#include <Filter.h>
+#include <VersionProxyModel.h>
+#include <meta/VersionList.h>
+
+class FakeVersion : public BaseVersion {
+   public:
+    FakeVersion(QString name, QString type) : m_name(std::move(name)), m_type(std::move(type)) {}
+
+    QString descriptor() override { return m_name; }
+    QString name() override { return m_name; }
+    QString typeString() const override { return m_type; }
+
+   private:
+    QString m_name;
+    QString m_type;
+};
+
+// versions "1.<n>", every third one a snapshot, sorted by n
+class FakeVersionList : public BaseVersionList {
+   public:
+    static BaseVersion::Ptr make(int n) { return std::make_shared<FakeVersion>(QString("1.%1").arg(n), n % 3 ? "release" : "snapshot"); }
+
+    Task::Ptr getLoadTask() override { return nullptr; }
+    bool isLoaded() override { return true; }
+    const BaseVersion::Ptr at(int i) const override { return m_versions.at(i); }
+    int count() const override { return m_versions.size(); }
+    void sortVersions() override {}
+
+    QVariant data(const QModelIndex& index, int role) const override
+    {
+        if (role == SortRole)
+            return m_versions.at(index.row())->descriptor().mid(2).toLongLong();
+        return BaseVersionList::data(index, role);
+    }
+    RoleList providesRoles() const override { return { VersionPointerRole, VersionRole, VersionIdRole, TypeRole, SortRole }; }
+
+    void append(int n)
+    {
+        beginInsertRows(QModelIndex(), m_versions.size(), m_versions.size());
+        m_versions.append(make(n));
+        endInsertRows();
+    }
+
+    void updateListData(QList<BaseVersion::Ptr> versions) override
+    {
+        beginResetModel();
+        m_versions = versions;
+        endResetModel();
+    }
+
+   private:
+    QList<BaseVersion::Ptr> m_versions;
+};
+
+class VersionProxyModelTest : public QObject {
+    Q_OBJECT
+
+    static QStringList shown(const VersionProxyModel& model)
+    {
+        QStringList names;
+        for (int i = 0; i < model.rowCount(); i++)
+            names.append(model.data(model.index(i, 0), BaseVersionList::VersionRole).toString());
+        return names;
+    }
+
+    // the versions up to `count` that pass the check, newest first
+    template <typename Check>
+    static QStringList expected(int count, Check check)
+    {
+        QStringList names;
+        for (int n = count - 1; n >= 0; n--) {
+            auto version = FakeVersionList::make(n);
+            if (check(version->name(), version->typeString()))
+                names.append(version->name());
+        }
+        return names;
+    }
+
+   private slots:
+    void test_filterChanges()
+    {
+        FakeVersionList list;
+        QList<BaseVersion::Ptr> versions;
+        for (int n = 0; n < 500; n++)
+            versions.append(FakeVersionList::make(n));
+        list.updateListData(versions);
+
+        VersionProxyModel model;
+        model.setSourceModel(&list);
+        QCOMPARE(shown(model), expected(500, [](auto, auto) { return true; }));
+
+        // more and more specific
+        for (auto pattern : { "1", "1.1", "1.12" }) {
+            model.setFilter(BaseVersionList::VersionRole, new ContainsFilter(pattern));
+            QCOMPARE(shown(model), expected(500, [pattern](const QString& name, auto) { return name.contains(pattern); }));
+        }
+
+        // and less again, with another filter
+        model.setFilter(BaseVersionList::VersionRole, new ContainsFilter("1.1"));
+        QCOMPARE(shown(model), expected(500, [](const QString& name, auto) { return name.contains("1.1"); }));
+        model.setFilter(BaseVersionList::TypeRole, new ExactFilter("release"));
+        auto release_check = [](const QString& name, const QString& type) { return name.contains("1.1") && type == "release"; };
+        QCOMPARE(shown(model), expected(500, release_check));
+
+        // something else entirely
+        model.setFilter(BaseVersionList::VersionRole, new ContainsFilter("2"));
+        QCOMPARE(shown(model),
+                 expected(500, [](const QString& name, const QString& type) { return name.contains("2") && type == "release"; }));
+
+        model.clearFilters();
+        QCOMPARE(shown(model), expected(500, [](auto, auto) { return true; }));
+    }
+
+    void test_sourceChanges()
+    {
+        FakeVersionList list;
+        VersionProxyModel model;
+        model.setSourceModel(&list);
+        model.setFilter(BaseVersionList::VersionRole, new ContainsFilter("1.1"));
+
+        QList<BaseVersion::Ptr> versions;
+        for (int n = 0; n < 100; n++)
+            versions.append(FakeVersionList::make(n));
+        list.updateListData(versions);
+        QCOMPARE(shown(model), expected(100, [](const QString& name, auto) { return name.contains("1.1"); }));
+
+        for (int n = 100; n < 120; n++)
+            list.append(n);
+        QCOMPARE(shown(model), expected(120, [](const QString& name, auto) { return name.contains("1.1"); }));
+
+        model.setFilter(BaseVersionList::VersionRole, new ContainsFilter("1.11"));
+        QCOMPARE(shown(model), expected(120, [](const QString& name, auto) { return name.contains("1.11"); }));
+    }
+
+    void test_metadataParents()
+    {
+        // loader versions for two versions of Minecraft, every third one for the newer
+        QJsonArray versions;
+        for (int n = 0; n < 30; n++) {
+            QJsonObject minecraft{ { "uid", "net.minecraft" }, { "equals", n % 3 ? "1.20.1" : "1.20.2" } };
+            versions.append(QJsonObject{ { "version", QString("47.%1").arg(n) },
+                                         { "releaseTime", QDateTime::fromSecsSinceEpoch(1000000 + n, Qt::UTC).toString(Qt::ISODate) },
+                                         { "type", "release" },
+                                         { "requires", QJsonArray{ minecraft } } });
+        }
+        Meta::VersionList list("net.minecraftforge");
+        list.parse(QJsonObject{ { "formatVersion", 1 }, { "uid", "net.minecraftforge" }, { "versions", versions } });
+        QCOMPARE(list.count(), 30);
+
+        auto rows = list.rowsRequiring("1.20.2");
+        QCOMPARE(rows.size(), 10);
+        for (auto row : rows)
+            QCOMPARE(list.parentVersion(row), QString("1.20.2"));
+        QVERIFY(list.rowsRequiring("1.19.4").isEmpty());
+
+        VersionProxyModel model;
+        model.setSourceModel(&list);
+        model.setFilter(BaseVersionList::ParentVersionRole, new ExactFilter("1.20.2"));
+        QStringList newer;
+        for (int n = 29; n >= 0; n--) {
+            if (n % 3 == 0)
+                newer.append(QString("47.%1").arg(n));
+        }
+        QCOMPARE(shown(model), newer);
+
+        model.setFilter(BaseVersionList::ParentVersionRole, new ExactFilter("1.20.1"));
+        QCOMPARE(model.rowCount(), 20);
+        model.setFilter(BaseVersionList::ParentVersionRole, new ExactFilter("1.19.4"));
+        QCOMPARE(model.rowCount(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(VersionProxyModelTest)
+
+#include "VersionProxyModel_test.moc"
@@ -15,8 +15,12 @@
 
 #include <QTest>
 
+#include <QRandomGenerator>
+
 #include <Version.h>
 
+#include "LegacyVersion.h"
+
 class VersionTest : public QObject {
     Q_OBJECT
 
@@ -154,6 +158,41 @@ class VersionTest : public QObject {
         QCOMPARE(v1 > v2, !lessThan && !equal);
         QCOMPARE(v1 == v2, equal);
     }
+
+    // the precomputed sections have to compare just like the sections did before
+    void test_matchesLegacy()
+    {
+        QStringList versions{ "", "1", "1.0", "1.0.0", "1.2", "1.10", "0", "00", "1.0-pre1", "1.0-", "1.0+build.5", "1.0+",
+                              "1-", "1--2", "1..2", "a", "a1", "1a", "1.0a", "1.0-rc.1", "1.0-beta", "-1", "+1", ".1",
+                              "99999999999", "1.99999999999", "1.\u0663", "1.2.3-SNAPSHOT+git.abc", "20w14a", "1.16.5-36.2.39" };
+        QRandomGenerator rng(42);
+        const QString alphabet = "0129.-+ab";
+        for (int i = 0; i < 300; i++) {
+            QString version;
+            for (int length = rng.bounded(1, 9); length > 0; length--)
+                version += alphabet.at(rng.bounded(alphabet.size()));
+            versions.append(version);
+        }
+
+        for (auto& first : versions) {
+            for (auto& second : versions) {
+                Version v1(first), v2(second);
+                LegacyVersion l1(first), l2(second);
+                if ((v1 < v2) != (l1 < l2) || (v1 == v2) != (l1 == l2))
+                    QFAIL(qPrintable(QString("%1 and %2 compare differently").arg(first, second)));
+            }
+        }
+    }
+
+    void test_sort()
+    {
+        QStringList versions{ "1.10", "1.2", "1.2+build", "1.2-pre1", "0.9", "1.2.0" };
+        Version::sort(versions, [](const QString& version) { return version; });
+        QCOMPARE(versions, (QStringList{ "0.9", "1.2-pre1", "1.2", "1.2+build", "1.2.0", "1.10" }));
+
+        Version::sort(versions, [](const QString& version) { return version; }, true);
+        QCOMPARE(versions, (QStringList{ "1.10", "1.2.0", "1.2", "1.2+build", "1.2-pre1", "0.9" }));
+    }
 };
 
 QTEST_GUILESS_MAIN(VersionTest)
@@ -0,0 +1,150 @@
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <minecraft/WorldSnapshots.h>
+
+namespace {
+constexpr int s_sector = 4096;
+
+bool write(const QString& path, const QByteArray& contents, const QDateTime& mtime)
+{
+    if (!FS::ensureFilePathExists(path))
+        return false;
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(contents) != contents.size() || !file.flush())
+        return false;
+    return file.setFileTime(mtime, QFileDevice::FileModificationTime);
+}
+
+QByteArray read(const QString& path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+void putBigEndian(QByteArray& data, int offset, quint32 value, int bytes)
+{
+    for (int i = bytes - 1; i >= 0; i--) {
+        data[offset + i] = char(value & 0xff);
+        value >>= 8;
+    }
+}
+
+/* A region file with the chunks one after the other from the third sector, one sector each. */
+QByteArray region(const QList<QPair<quint32, QByteArray>>& chunks)
+{
+    QByteArray out(2 * s_sector, '\0');
+    for (int i = 0; i < chunks.size(); i++) {
+        auto& [timestamp, data] = chunks[i];
+        putBigEndian(out, i * 4, 2 + i, 3);
+        out[i * 4 + 3] = 1;
+        putBigEndian(out, s_sector + i * 4, timestamp, 4);
+
+        QByteArray chunk(s_sector, '\0');
+        putBigEndian(chunk, 0, data.size() + 1, 4);
+        // zlib, as far as the snapshots care
+        chunk[4] = 2;
+        chunk.replace(5, data.size(), data);
+        out += chunk;
+    }
+    return out;
+}
+
+int objectCount(const QString& root)
+{
+    int count = 0;
+    QDirIterator it(FS::PathCombine(root, "objects"), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        count++;
+    }
+    return count;
+}
+}  // namespace
+
+class WorldSnapshotsTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_tmp;
+
+   private slots:
+    void test_TakeAndRestore()
+    {
+        QVERIFY(m_tmp.isValid());
+        auto root = m_tmp.filePath("snapshots");
+        auto world = m_tmp.filePath("saves/New World");
+        auto first = QDateTime::currentDateTimeUtc().addSecs(-3600);
+
+        QByteArray level(2000, 'l');
+        auto original = region({ { 100, QByteArray(1000, 'a') }, { 100, QByteArray(1000, 'b') }, { 100, QByteArray(1000, 'c') } });
+        QVERIFY(write(world + "/level.dat", level, first));
+        QVERIFY(write(world + "/region/r.0.0.mca", original, first));
+        QVERIFY(write(world + "/session.lock", "lock", first));
+        QVERIFY(QDir().mkpath(world + "/datapacks"));
+
+        WorldSnapshots snapshots(root);
+        auto taken = snapshots.take(world);
+        QVERIFY2(taken.error.isEmpty(), qPrintable(taken.error));
+        QVERIFY(taken.taken);
+        // the level and the three chunks
+        QCOMPARE(objectCount(root), 4);
+
+        // nothing changed
+        auto again = snapshots.take(world);
+        QVERIFY(again.error.isEmpty());
+        QVERIFY(!again.taken);
+
+        // one chunk saved again by the game
+        auto changed = region({ { 100, QByteArray(1000, 'a') }, { 200, QByteArray(1000, 'B') }, { 100, QByteArray(1000, 'c') } });
+        QVERIFY(write(world + "/region/r.0.0.mca", changed, first.addSecs(60)));
+        QTest::qWait(2);
+        auto second = snapshots.take(world);
+        QVERIFY2(second.error.isEmpty(), qPrintable(second.error));
+        QVERIFY(second.taken);
+        QCOMPARE(objectCount(root), 5);
+        QVERIFY(second.written < s_sector);
+
+        auto list = snapshots.list("New World");
+        QCOMPARE(list.size(), 2);
+        QCOMPARE(list.first().id, second.snapshot.id);
+        QCOMPARE(list.last().id, taken.snapshot.id);
+
+        // the world as it was the first time
+        QVERIFY(write(world + "/level.dat", "gone", first.addSecs(120)));
+        QVERIFY(write(world + "/extra.dat", "new", first.addSecs(120)));
+        QCOMPARE(snapshots.restore(world, taken.snapshot.id), QString());
+        QCOMPARE(read(world + "/level.dat"), level);
+        QCOMPARE(read(world + "/region/r.0.0.mca"), original);
+        QVERIFY(!QFile::exists(world + "/extra.dat"));
+        QVERIFY(QFileInfo(world + "/datapacks").isDir());
+        QVERIFY(!QFileInfo::exists(m_tmp.filePath("saves/.New World.restoring")));
+        QVERIFY(!QFileInfo::exists(m_tmp.filePath("saves/.New World.replaced")));
+
+        // the objects of the changed chunk go with the only snapshot that had it
+        snapshots.prune("New World", 1);
+        QCOMPARE(snapshots.list("New World").size(), 1);
+        QCOMPARE(objectCount(root), 4);
+
+        // it's gone, the world stays as it is
+        QVERIFY(!snapshots.restore(world, taken.snapshot.id).isEmpty());
+        QCOMPARE(read(world + "/region/r.0.0.mca"), original);
+    }
+
+    void test_WorldsIn()
+    {
+        auto saves = m_tmp.filePath("worlds");
+        QVERIFY(write(saves + "/A/level.dat", "a", QDateTime::currentDateTimeUtc()));
+        QVERIFY(write(saves + "/.A.restoring/level.dat", "a", QDateTime::currentDateTimeUtc()));
+        QVERIFY(QDir().mkpath(saves + "/not a world"));
+        QCOMPARE(WorldSnapshotTask::worldsIn(saves), QStringList{ QDir(saves).filePath("A") });
+    }
+};
+
+QTEST_GUILESS_MAIN(WorldSnapshotsTest)
+
+#include "WorldSnapshots_test.moc"